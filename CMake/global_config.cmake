@@ -48,6 +48,26 @@ macro(global_set_flags)
         add_definitions(-DRS2_USE_CUDA)
     endif()
 
+    if (BUILD_WITH_GLSL)
+        add_definitions(-DRS2_USE_GLSL)
+    endif()
+
+    if (BUILD_WITH_LIBJPEG)
+        add_definitions(-DRS2_USE_LIBJPEG)
+    endif()
+
+    if (BUILD_WITH_TRACY AND BUILD_WITH_ITT)
+        message(FATAL_ERROR "BUILD_WITH_TRACY and BUILD_WITH_ITT are exclusive")
+    endif()
+
+    if (BUILD_WITH_TRACY)
+        add_definitions(-DRS2_USE_TRACY -DTRACY_ENABLE)
+    endif()
+
+    if (BUILD_WITH_ITT)
+        add_definitions(-DRS2_USE_ITT)
+    endif()
+
     if (PREVENT_HID_SUSPEND)
         add_definitions(-DPREVENT_HID_SUSPEND)
     endif()
@@ -1,8 +1,12 @@
 option(ENABLE_CCACHE "Build with ccache." ON)
 option(BUILD_WITH_CUDA "Enable CUDA" OFF)
+option(BUILD_WITH_GLSL "Build the OpenGL compute shader pointcloud and align blocks (requires OpenGL 4.3 and GLFW)" OFF)
+option(BUILD_WITH_LIBJPEG "Build the MJPEG decoder block (requires libjpeg or libjpeg-turbo)" OFF)
+option(BUILD_WITH_TRACY "Add Tracy profiler zones along the frame path (requires the Tracy client package)" OFF)
+option(BUILD_WITH_ITT "Add ITT profiler zones along the frame path, for VTune and compatible tools (requires ittnotify)" OFF)
 option(BUILD_GRAPHICAL_EXAMPLES "Build graphical examples and tools." ON)
 option(BUILD_WITH_OPENMP "Use OpenMP" OFF)
-option(ENABLE_ZERO_COPY "Enable zero copy functionality" OFF)
+option(ENABLE_ZERO_COPY "Enable zero copy functionality for all backends (always enabled with V4L2)" OFF)
 option(BUILD_WITH_TM2 "Build with support for Intel TM2 tracking device" ON)
 option(BUILD_EASYLOGGINGPP "Build EasyLogging++ as a part of the build" ON)
 option(BUILD_WITH_STATIC_CRT "Build with static link CRT" ON)
@@ -12,6 +16,7 @@ option(TRACE_API "Log all C API calls" OFF)
 option(HWM_OVER_XU "Send HWM commands over UVC XU control" ON)
 option(BUILD_SHARED_LIBS "Build shared library" ON)
 option(BUILD_UNIT_TESTS "Build realsense unit tests. Note that when enabled, additional tests data set will be downloaded from a web server and stored in a temp directory" OFF)
+option(BUILD_BENCHMARKS "Build the realsense-benchmarks performance suite" OFF)
 option(BUILD_EXAMPLES "Build realsense examples and tools." ON)
 option(ENFORCE_METADATA "Require WinSDK with Metadata support during compilation. Windows OS Only" OFF)
 option(BUILD_PYTHON_BINDINGS "Build Python bindings" OFF)
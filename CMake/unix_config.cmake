@@ -49,4 +49,9 @@ macro(os_target_config)
 
     target_include_directories(${LRS_TARGET} PRIVATE ${LIBUSB1_INCLUDE_DIRS})
     target_link_libraries(${LRS_TARGET} PRIVATE ${LIBUSB1_LIBRARIES})
+
+    if(BUILD_SHARED_LIBS AND NOT APPLE)
+        # Report a missing symbol when linking the library itself, not in every application linking it
+        target_link_libraries(${LRS_TARGET} PRIVATE -Wl,--no-undefined)
+    endif()
 endmacro()
@@ -0,0 +1,181 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+// Every processing block of src/proc, fed with synthetic depth and color frames from a software device
+
+#include "benchmark.h"
+
+#include <librealsense2/rs.hpp>
+#include <librealsense2/hpp/rs_internal.hpp>
+
+#include <cmath>
+#include <memory>
+#include <random>
+
+using rs2_benchmark::state;
+using rs2_benchmark::resolution;
+
+namespace
+{
+    // Depth of a slanted wall with bumps and holes seen by a camera with a 90 degrees field of view,
+    // and a color image of the same resolution 15mm to the side
+    class scene
+    {
+    public:
+        explicit scene(resolution res)
+            : _sensor(_dev.add_sensor("Synthetic camera")),
+              _depth_pixels(res.width * res.height),
+              _color_pixels(res.width * res.height * 3)
+        {
+            auto w = res.width, h = res.height;
+            rs2_intrinsics intrinsics{ w, h, w / 2.f, h / 2.f, w / 2.f, w / 2.f, RS2_DISTORTION_NONE, { 0, 0, 0, 0, 0 } };
+            auto depth = _sensor.add_video_stream({ RS2_STREAM_DEPTH, 0, 0, w, h, 30, 2, RS2_FORMAT_Z16, intrinsics });
+            auto color = _sensor.add_video_stream({ RS2_STREAM_COLOR, 0, 1, w, h, 30, 3, RS2_FORMAT_RGB8, intrinsics });
+            depth.register_extrinsics_to(color, { { 1, 0, 0, 0, 1, 0, 0, 0, 1 }, { 0.015f, 0, 0 } });
+            _sensor.add_read_only_option(RS2_OPTION_DEPTH_UNITS, 0.001f);
+
+            std::mt19937 rng(0);
+            for (int y = 0; y < h; y++)
+                for (int x = 0; x < w; x++)
+                {
+                    auto hole = ((x / 24) * 7 + (y / 16) * 3) % 11 == 0 || rng() % 50 == 0;
+                    auto z = 1500 + 600.f * x / w + 40 * std::sin(x * 0.05f) * std::cos(y * 0.07f) + rng() % 5;
+                    _depth_pixels[y * w + x] = hole ? 0 : static_cast<uint16_t>(z);
+
+                    auto rgb = &_color_pixels[(y * w + x) * 3];
+                    rgb[0] = static_cast<uint8_t>(x * 255 / w);
+                    rgb[1] = static_cast<uint8_t>(y * 255 / h);
+                    rgb[2] = static_cast<uint8_t>(rng());
+                }
+
+            _sensor.open({ depth, color });
+            _sensor.start(_sync);
+
+            // The syncer matches the frames of the same timestamp into a frameset
+            for (int i = 0; i < 10 && !(_frames.get_depth_frame() && _frames.get_color_frame()); i++)
+            {
+                auto timestamp = i * 1000. / 30;
+                _sensor.on_video_frame({ _depth_pixels.data(), [](void*) {}, w * 2, 2, timestamp, RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, i, depth.get() });
+                _sensor.on_video_frame({ _color_pixels.data(), [](void*) {}, w * 3, 3, timestamp, RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, i, color.get() });
+                rs2::frameset fs;
+                while (_sync.poll_for_frames(&fs))
+                    _frames = fs;
+            }
+            if (!_frames.get_depth_frame() || !_frames.get_color_frame())
+                throw std::runtime_error("The software device did not produce a depth and color frameset");
+        }
+
+        ~scene()
+        {
+            _frames = rs2::frameset();
+            _sensor.stop();
+            _sensor.close();
+        }
+
+        rs2::frameset frames() const { return _frames; }
+        rs2::depth_frame depth() const { return _frames.get_depth_frame(); }
+        rs2::video_frame color() const { return _frames.get_color_frame(); }
+
+    private:
+        rs2::software_device _dev;
+        rs2::software_sensor _sensor;
+        rs2::syncer _sync;
+        std::vector<uint16_t> _depth_pixels;
+        std::vector<uint8_t> _color_pixels;
+        rs2::frameset _frames;
+    };
+
+    int64_t depth_bytes(const rs2::video_frame& f)
+    {
+        return static_cast<int64_t>(f.get_stride_in_bytes()) * f.get_height();
+    }
+
+    // Times one block on the depth frame of the scene
+    template<class Block, class... Args>
+    void register_depth_filter(const std::string& name, resolution res, Args... args)
+    {
+        rs2_benchmark::register_benchmark("proc/" + name + "/" + rs2_benchmark::to_string(res), [=](state& st)
+        {
+            scene s(res);
+            Block block(args...);
+            auto depth = s.depth();
+            while (st.keep_running())
+                block.process(depth);
+            st.set_bytes_processed(st.iterations() * depth_bytes(depth));
+            st.set_items_processed(st.iterations());
+        });
+    }
+}
+
+RS2_BENCHMARKS(register_processing_benchmarks)
+{
+    using namespace rs2_benchmark;
+
+    for (auto&& res : standard_resolutions())
+    {
+        register_depth_filter<rs2::decimation_filter>("decimation", res);
+        register_depth_filter<rs2::spatial_filter>("spatial", res);
+        register_depth_filter<rs2::temporal_filter>("temporal", res);
+        register_depth_filter<rs2::hole_filling_filter>("hole_filling", res);
+        register_depth_filter<rs2::disparity_transform>("depth_to_disparity", res, true);
+        register_depth_filter<rs2::colorizer>("colorizer", res);
+        register_depth_filter<rs2::depth_compression>("depth_compression", res);
+
+        register_benchmark("proc/disparity_to_depth/" + to_string(res), [res](state& st)
+        {
+            scene s(res);
+            rs2::disparity_transform to_disparity(true), to_depth(false);
+            auto disparity = to_disparity.process(s.depth());
+            while (st.keep_running())
+                to_depth.process(disparity);
+            st.set_items_processed(st.iterations());
+        });
+
+        register_benchmark("proc/depth_decompression/" + to_string(res), [res](state& st)
+        {
+            scene s(res);
+            rs2::depth_compression compress;
+            rs2::depth_decompression decompress;
+            auto compressed = compress.process(s.depth());
+            while (st.keep_running())
+                decompress.process(compressed);
+            st.set_bytes_processed(st.iterations() * depth_bytes(s.depth()));
+            st.set_items_processed(st.iterations());
+        });
+
+        register_benchmark("proc/pointcloud/" + to_string(res), [res](state& st)
+        {
+            scene s(res);
+            rs2::pointcloud pc;
+            auto depth = s.depth();
+            while (st.keep_running())
+                pc.calculate(depth);
+            st.set_items_processed(st.iterations());
+        });
+
+        register_benchmark("proc/pointcloud_textured/" + to_string(res), [res](state& st)
+        {
+            scene s(res);
+            rs2::pointcloud pc;
+            pc.map_to(s.color());
+            auto depth = s.depth();
+            while (st.keep_running())
+                pc.calculate(depth);
+            st.set_items_processed(st.iterations());
+        });
+
+        for (auto align_to : { RS2_STREAM_COLOR, RS2_STREAM_DEPTH })
+        {
+            register_benchmark("proc/align_to_" + std::string(align_to == RS2_STREAM_COLOR ? "color" : "depth") + "/" + to_string(res),
+                [res, align_to](state& st)
+            {
+                scene s(res);
+                rs2::align align(align_to);
+                auto frames = s.frames();
+                while (st.keep_running())
+                    align.process(frames);
+                st.set_items_processed(st.iterations());
+            });
+        }
+    }
+}
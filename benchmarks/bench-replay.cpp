@@ -0,0 +1,221 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+// Throughput of the whole host side of the library, without a camera: the USB traffic of a camera, captured
+// once with --record, is replayed by the mock backend as fast as it goes, through the sensors, the unpacking,
+// the frame archives and the syncer of the pipeline. The same recording gives the same frames on every run,
+// so the numbers of two builds can be compared on machines that have no camera
+
+#include <librealsense2/rs.hpp>
+#include <librealsense2/hpp/rs_internal.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+
+namespace
+{
+    struct options
+    {
+        std::string record;
+        std::string recording;
+        std::string section = "replay";
+        double duration = 10;
+        std::string out;
+    };
+
+    struct stream_stats
+    {
+        std::string name;
+        int64_t frames = 0;
+        int64_t bytes = 0;
+    };
+
+    struct run_stats
+    {
+        std::map<int, stream_stats> streams;
+        int64_t framesets = 0;
+        double real_seconds = 0;
+        double cpu_seconds = 0;
+    };
+
+    std::string stream_name(const rs2::stream_profile& p)
+    {
+        std::ostringstream ss;
+        ss << p.stream_name() << "/" << rs2_format_to_string(p.format());
+        if (auto video = p.as<rs2::video_stream_profile>())
+            ss << "/" << video.width() << "x" << video.height();
+        ss << "/" << p.fps();
+        return ss.str();
+    }
+
+    // Streams the default configuration of the pipeline, which the replay resolves as the recording did. The
+    // counting starts with the first frameset, so the opening of the device is left out
+    run_stats stream(rs2::context& ctx, double duration)
+    {
+        run_stats stats;
+        std::mutex mutex;
+        bool started = false, done = false;
+        std::chrono::steady_clock::time_point start;
+        std::clock_t cpu_start = 0;
+
+        auto count = [&](const rs2::frame& f)
+        {
+            auto&& s = stats.streams[f.get_profile().unique_id()];
+            if (s.name.empty())
+                s.name = stream_name(f.get_profile());
+            s.frames++;
+            if (auto video = f.as<rs2::video_frame>())
+                s.bytes += video.get_stride_in_bytes() * video.get_height();
+        };
+
+        rs2::pipeline pipe(ctx);
+        pipe.start([&](const rs2::frame& f)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (done)
+                return;
+            if (!started)
+            {
+                started = true;
+                start = std::chrono::steady_clock::now();
+                cpu_start = std::clock();
+            }
+            if (auto fs = f.as<rs2::frameset>())
+            {
+                stats.framesets++;
+                for (auto&& sub : fs)
+                    count(sub);
+            }
+            else
+                count(f);
+        });
+
+        std::this_thread::sleep_for(std::chrono::duration<double>(duration));
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (started)
+            {
+                stats.real_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                stats.cpu_seconds = double(std::clock() - cpu_start) / CLOCKS_PER_SEC;
+            }
+            done = true;
+        }
+        pipe.stop();
+        return stats;
+    }
+
+    void print(const run_stats& stats)
+    {
+        auto seconds = stats.real_seconds > 0 ? stats.real_seconds : 1;
+        std::cout << std::left << std::setw(40) << "Stream" << std::right << std::setw(12) << "frames/s" << std::setw(12) << "MB/s" << std::endl;
+        for (auto&& s : stats.streams)
+        {
+            std::cout << std::left << std::setw(40) << s.second.name << std::right << std::fixed << std::setprecision(1)
+                << std::setw(12) << s.second.frames / seconds << std::setw(12) << s.second.bytes / seconds / (1024 * 1024) << std::endl;
+        }
+        std::cout << std::fixed << std::setprecision(1) << stats.framesets / seconds << " framesets/s, CPU "
+            << 100 * stats.cpu_seconds / seconds << "% over " << stats.real_seconds << " s" << std::endl;
+    }
+
+    // In the layout of Google Benchmark, like the results of realsense-benchmarks, a benchmark per stream
+    void write_json(const std::string& file, const run_stats& stats, const char* executable)
+    {
+        auto seconds = stats.real_seconds > 0 ? stats.real_seconds : 1;
+        std::ofstream out(file);
+        out << "{\n  \"context\": {\n"
+            << "    \"executable\": \"" << executable << "\",\n"
+            << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n"
+            << "    \"library_version\": \"" << RS2_API_VERSION_STR << "\"\n"
+            << "  },\n  \"benchmarks\": [";
+
+        bool first = true;
+        auto entry = [&](const std::string& name, int64_t items, int64_t bytes)
+        {
+            out << (first ? "\n" : ",\n") << std::fixed << std::setprecision(3)
+                << "    {\n      \"name\": \"replay/" << name << "\",\n"
+                << "      \"iterations\": " << items << ",\n"
+                << "      \"real_time\": " << (items ? stats.real_seconds * 1e9 / items : 0) << ",\n"
+                << "      \"cpu_time\": " << (items ? stats.cpu_seconds * 1e9 / items : 0) << ",\n"
+                << "      \"time_unit\": \"ns\",\n";
+            if (bytes)
+                out << "      \"bytes_per_second\": " << bytes / seconds << ",\n";
+            out << "      \"items_per_second\": " << items / seconds << "\n    }";
+            first = false;
+        };
+        for (auto&& s : stats.streams)
+            entry(s.second.name, s.second.frames, s.second.bytes);
+        entry("framesets", stats.framesets, 0);
+        out << "\n  ]\n}\n";
+    }
+
+    bool parse_flag(const std::string& arg, const std::string& flag, std::string& value)
+    {
+        auto prefix = "--" + flag + "=";
+        if (arg.compare(0, prefix.size(), prefix) != 0)
+            return false;
+        value = arg.substr(prefix.size());
+        return true;
+    }
+}
+
+int main(int argc, char* argv[]) try
+{
+    options opt;
+    std::string value;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (parse_flag(arg, "record", value)) opt.record = value;
+        else if (parse_flag(arg, "recording", value)) opt.recording = value;
+        else if (parse_flag(arg, "section", value)) opt.section = value;
+        else if (parse_flag(arg, "duration", value)) opt.duration = std::stod(value);
+        else if (parse_flag(arg, "out", value)) opt.out = value;
+        else
+        {
+            opt.record.clear();
+            opt.recording.clear();
+            break;
+        }
+    }
+    if (opt.record.empty() == opt.recording.empty())
+    {
+        std::cerr << "Usage: " << argv[0] << " --record=<file> | --recording=<file> [--section=<name>]\n"
+            << "       [--duration=<seconds>] [--out=<json file>]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (!opt.record.empty())
+    {
+        // The recording is written when the context goes away
+        rs2::recording_context ctx(opt.record, opt.section);
+        auto stats = stream(ctx, opt.duration);
+        std::cout << "Recorded " << stats.streams.size() << " streams for " << opt.duration << " s into " << opt.record << std::endl;
+        return EXIT_SUCCESS;
+    }
+
+    rs2::mock_context ctx(opt.recording, opt.section);
+    auto stats = stream(ctx, opt.duration);
+    print(stats);
+    if (!opt.out.empty())
+        write_json(opt.out, stats, argv[0]);
+    return stats.framesets || !stats.streams.empty() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+catch (const rs2::error& e)
+{
+    std::cerr << "RealSense error calling " << e.get_failed_function() << "(" << e.get_failed_args() << "):\n    " << e.what() << std::endl;
+    return EXIT_FAILURE;
+}
+catch (const std::exception& e)
+{
+    std::cerr << e.what() << std::endl;
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,408 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+// How many cameras the host sustains: every camera is a software device streaming depth, color and optionally
+// IMU at the real rates through its sensors, a syncer and the processing blocks, so only the host-side cost of
+// the frames is measured. Reports the CPU per camera, the latency from injection to the end of the processing
+// and the frames dropped, as the number of cameras grows
+
+#include <librealsense2/rs.hpp>
+#include <librealsense2/hpp/rs_internal.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    struct options
+    {
+        std::vector<int> cameras = { 1, 2, 4, 8 };
+        double duration = 5;
+        int fps = 30;
+        bool imu = false;
+        bool processing = true;
+        std::string bag;
+    };
+
+    // The images every camera streams in a loop, synthetic or read from a recording
+    struct video_source
+    {
+        rs2_format format;
+        int width, height, bpp;
+        std::vector<std::vector<uint8_t>> frames;
+    };
+
+    struct frames_source
+    {
+        video_source depth, color;
+    };
+
+    frames_source synthetic_frames()
+    {
+        frames_source source;
+        source.depth = { RS2_FORMAT_Z16, 848, 480, 2, {} };
+        source.color = { RS2_FORMAT_RGB8, 1280, 720, 3, {} };
+
+        std::mt19937 rng(0);
+        for (int i = 0; i < 4; i++)
+        {
+            std::vector<uint8_t> depth(source.depth.width * source.depth.height * 2);
+            auto z = reinterpret_cast<uint16_t*>(depth.data());
+            for (int p = 0; p < source.depth.width * source.depth.height; p++)
+                z[p] = rng() % 40 == 0 ? 0 : static_cast<uint16_t>(1000 + (p % source.depth.width) + i * 10 + rng() % 5);
+            source.depth.frames.push_back(std::move(depth));
+
+            std::vector<uint8_t> color(source.color.width * source.color.height * 3);
+            for (auto&& c : color)
+                c = static_cast<uint8_t>(rng());
+            source.color.frames.push_back(std::move(color));
+        }
+        return source;
+    }
+
+    void add_frame(video_source& source, const rs2::video_frame& f)
+    {
+        if (source.frames.empty())
+            source = { f.get_profile().format(), f.get_width(), f.get_height(), f.get_bytes_per_pixel(), {} };
+        auto data = static_cast<const uint8_t*>(f.get_data());
+        std::vector<uint8_t> pixels(source.width * source.height * source.bpp);
+        for (int y = 0; y < source.height; y++)
+            std::copy(data + y * f.get_stride_in_bytes(), data + y * f.get_stride_in_bytes() + source.width * source.bpp,
+                pixels.begin() + y * source.width * source.bpp);
+        source.frames.push_back(std::move(pixels));
+    }
+
+    // The first framesets of the depth and color of a recording, kept in memory so reading the file costs nothing
+    frames_source recorded_frames(const std::string& file)
+    {
+        const size_t max_frames = 60;
+
+        rs2::config cfg;
+        cfg.enable_device_from_file(file, false);
+        cfg.enable_stream(RS2_STREAM_DEPTH);
+        cfg.enable_stream(RS2_STREAM_COLOR);
+        rs2::pipeline pipe;
+        auto profile = pipe.start(cfg);
+        profile.get_device().as<rs2::playback>().set_real_time(false);
+
+        frames_source source;
+        rs2::frameset fs;
+        while (source.depth.frames.size() < max_frames && pipe.try_wait_for_frames(&fs, 1000))
+        {
+            auto depth = fs.get_depth_frame();
+            auto color = fs.get_color_frame();
+            if (!depth || !color)
+                continue;
+            add_frame(source.depth, depth);
+            add_frame(source.color, color);
+        }
+        pipe.stop();
+
+        if (source.depth.frames.empty())
+            throw std::runtime_error("No depth and color frames in " + file);
+        return source;
+    }
+
+    double now_ms()
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+    class camera
+    {
+    public:
+        camera(int id, const frames_source& source, const options& opt)
+            : _source(source), _opt(opt),
+              _depth_sensor(_dev.add_sensor("Stereo Module")),
+              _color_sensor(_dev.add_sensor("RGB Camera")),
+              _motion_sensor(_dev.add_sensor("Motion Module"))
+        {
+            // The unique ids of the streams are kept apart from the ones the library generates and from the other cameras
+            auto uid = 1000000 + id * 8;
+            auto&& d = source.depth;
+            auto&& c = source.color;
+            rs2_intrinsics depth_intrinsics{ d.width, d.height, d.width / 2.f, d.height / 2.f, d.width / 2.f, d.width / 2.f, RS2_DISTORTION_NONE, { 0, 0, 0, 0, 0 } };
+            rs2_intrinsics color_intrinsics{ c.width, c.height, c.width / 2.f, c.height / 2.f, c.width / 2.f, c.width / 2.f, RS2_DISTORTION_NONE, { 0, 0, 0, 0, 0 } };
+            _depth = _depth_sensor.add_video_stream({ RS2_STREAM_DEPTH, 0, uid, d.width, d.height, opt.fps, d.bpp, d.format, depth_intrinsics });
+            _color = _color_sensor.add_video_stream({ RS2_STREAM_COLOR, 0, uid + 1, c.width, c.height, opt.fps, c.bpp, c.format, color_intrinsics });
+            _depth.register_extrinsics_to(_color, { { 1, 0, 0, 0, 1, 0, 0, 0, 1 }, { 0.015f, 0, 0 } });
+            _depth_sensor.add_read_only_option(RS2_OPTION_DEPTH_UNITS, 0.001f);
+
+            rs2_motion_device_intrinsic motion_intrinsics{};
+            _accel = _motion_sensor.add_motion_stream({ RS2_STREAM_ACCEL, 0, uid + 2, imu_fps, RS2_FORMAT_MOTION_XYZ32F, motion_intrinsics });
+            _gyro = _motion_sensor.add_motion_stream({ RS2_STREAM_GYRO, 0, uid + 3, imu_fps, RS2_FORMAT_MOTION_XYZ32F, motion_intrinsics });
+
+            _dev.create_matcher(RS2_MATCHER_DEFAULT);
+        }
+
+        void start()
+        {
+            for (auto&& p : profiles())
+                p.reset_statistics();
+
+            _depth_sensor.open(_depth);
+            _color_sensor.open(_color);
+            _depth_sensor.start(_sync);
+            _color_sensor.start(_sync);
+            if (_opt.imu)
+            {
+                _motion_sensor.open({ _accel, _gyro });
+                _motion_sensor.start(_sync);
+            }
+
+            _running = true;
+            _consumer = std::thread([this]() { consume(); });
+            _video = std::thread([this]() { inject_video(); });
+            if (_opt.imu)
+                _motion = std::thread([this]() { inject_motion(); });
+        }
+
+        void stop()
+        {
+            _running = false;
+            _video.join();
+            if (_motion.joinable())
+                _motion.join();
+            _consumer.join();
+
+            for (auto sensor : { &_depth_sensor, &_color_sensor })
+            {
+                sensor->stop();
+                sensor->close();
+            }
+            if (_opt.imu)
+            {
+                _motion_sensor.stop();
+                _motion_sensor.close();
+            }
+        }
+
+        std::vector<rs2::stream_profile> profiles() const
+        {
+            std::vector<rs2::stream_profile> result = { _depth, _color };
+            if (_opt.imu)
+            {
+                result.push_back(_accel);
+                result.push_back(_gyro);
+            }
+            return result;
+        }
+
+        const std::vector<double>& latencies() const { return _latencies; }
+        int injected() const { return _frame_number; }
+        uint64_t framesets() const { return _framesets; }
+
+    private:
+        static const int imu_fps = 200;
+
+        template<class F>
+        void run_at(int fps, F f)
+        {
+            auto period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1. / fps));
+            auto next = std::chrono::steady_clock::now();
+            while (_running)
+            {
+                f();
+                next += period;
+                std::this_thread::sleep_until(next);
+            }
+        }
+
+        void inject_video()
+        {
+            auto&& d = _source.depth;
+            auto&& c = _source.color;
+            run_at(_opt.fps, [&]()
+            {
+                auto i = _frame_number++;
+                auto timestamp = now_ms();
+                // The frames are only read, every frame of the loop is shared by all the frames injected from it
+                auto depth = const_cast<uint8_t*>(d.frames[i % d.frames.size()].data());
+                auto color = const_cast<uint8_t*>(c.frames[i % c.frames.size()].data());
+                _depth_sensor.on_video_frame({ depth, [](void*) {}, d.width * d.bpp, d.bpp, timestamp, RS2_TIMESTAMP_DOMAIN_SYSTEM_TIME, i, _depth.get() });
+                _color_sensor.on_video_frame({ color, [](void*) {}, c.width * c.bpp, c.bpp, timestamp, RS2_TIMESTAMP_DOMAIN_SYSTEM_TIME, i, _color.get() });
+            });
+        }
+
+        void inject_motion()
+        {
+            int i = 0;
+            float accel[3] = { 0, -9.8f, 0 };
+            float gyro[3] = { 0.01f, 0, 0 };
+            run_at(imu_fps, [&]()
+            {
+                auto timestamp = now_ms();
+                _motion_sensor.on_motion_frame({ accel, [](void*) {}, timestamp, RS2_TIMESTAMP_DOMAIN_SYSTEM_TIME, i, _accel.get() });
+                _motion_sensor.on_motion_frame({ gyro, [](void*) {}, timestamp, RS2_TIMESTAMP_DOMAIN_SYSTEM_TIME, i, _gyro.get() });
+                ++i;
+            });
+        }
+
+        // Processes the framesets as an application would, and measures how late they are at the end
+        void consume()
+        {
+            rs2::decimation_filter decimation;
+            rs2::colorizer colorizer;
+            rs2::frameset fs;
+            while (_running)
+            {
+                if (!_sync.try_wait_for_frames(&fs, 100))
+                    continue;
+                auto depth = fs.get_depth_frame();
+                if (!depth)
+                    continue;
+
+                if (_opt.processing)
+                {
+                    auto decimated = decimation.process(depth);
+                    auto colorized = colorizer.process(decimated);
+                    (void)colorized;
+                }
+                _latencies.push_back(now_ms() - depth.get_timestamp());
+                ++_framesets;
+            }
+        }
+
+        const frames_source& _source;
+        const options& _opt;
+        rs2::software_device _dev;
+        rs2::software_sensor _depth_sensor, _color_sensor, _motion_sensor;
+        rs2::stream_profile _depth, _color, _accel, _gyro;
+        rs2::syncer _sync{ 64 };
+
+        std::atomic<bool> _running{ false };
+        std::thread _video, _motion, _consumer;
+        int _frame_number = 0;
+        std::vector<double> _latencies;
+        uint64_t _framesets = 0;
+    };
+
+    double percentile(const std::vector<double>& sorted, double p)
+    {
+        if (sorted.empty())
+            return 0;
+        auto i = static_cast<size_t>(p / 100 * (sorted.size() - 1) + 0.5);
+        return sorted[std::min(i, sorted.size() - 1)];
+    }
+
+    void run(const frames_source& source, const options& opt, int count)
+    {
+        std::vector<std::unique_ptr<camera>> cameras;
+        for (int i = 0; i < count; i++)
+            cameras.emplace_back(new camera(i, source, opt));
+
+        auto cpu_start = std::clock();
+        auto start = std::chrono::steady_clock::now();
+        for (auto&& c : cameras)
+            c->start();
+        std::this_thread::sleep_for(std::chrono::duration<double>(opt.duration));
+        for (auto&& c : cameras)
+            c->stop();
+        auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        auto cpu_seconds = double(std::clock() - cpu_start) / CLOCKS_PER_SEC;
+
+        std::vector<double> latencies;
+        int64_t injected = 0, framesets = 0;
+        rs2_stream_statistics totals{};
+        for (auto&& c : cameras)
+        {
+            latencies.insert(latencies.end(), c->latencies().begin(), c->latencies().end());
+            injected += c->injected();
+            framesets += c->framesets();
+            for (auto&& p : c->profiles())
+            {
+                auto statistics = p.get_statistics();
+                totals.delivered += statistics.delivered;
+                for (int r = 0; r < RS2_FRAME_DROP_REASON_COUNT; r++)
+                    totals.dropped[r] += statistics.dropped[r];
+            }
+        }
+        std::sort(latencies.begin(), latencies.end());
+
+        std::ostringstream drops;
+        for (int r = 0; r < RS2_FRAME_DROP_REASON_COUNT; r++)
+            if (totals.dropped[r])
+                drops << " " << rs2_frame_drop_reason_to_string(static_cast<rs2_frame_drop_reason>(r)) << ":" << totals.dropped[r];
+
+        std::cout << std::fixed << std::setprecision(1)
+            << std::setw(7) << count
+            << std::setw(11) << 100 * cpu_seconds / seconds / count
+            << std::setw(9) << percentile(latencies, 50)
+            << std::setw(9) << percentile(latencies, 90)
+            << std::setw(9) << percentile(latencies, 99)
+            << std::setw(9) << (latencies.empty() ? 0 : latencies.back())
+            << std::setw(10) << injected
+            << std::setw(10) << framesets
+            << "  " << (drops.str().empty() ? " none" : drops.str()) << std::endl;
+    }
+
+    bool parse_flag(const std::string& arg, const std::string& flag, std::string& value)
+    {
+        auto prefix = "--" + flag + "=";
+        if (arg.compare(0, prefix.size(), prefix) != 0)
+            return false;
+        value = arg.substr(prefix.size());
+        return true;
+    }
+}
+
+int main(int argc, char* argv[]) try
+{
+    options opt;
+    std::string value;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (parse_flag(arg, "cameras", value))
+        {
+            opt.cameras.clear();
+            std::istringstream ss(value);
+            std::string count;
+            while (std::getline(ss, count, ','))
+                opt.cameras.push_back(std::stoi(count));
+        }
+        else if (parse_flag(arg, "duration", value)) opt.duration = std::stod(value);
+        else if (parse_flag(arg, "fps", value)) opt.fps = std::stoi(value);
+        else if (parse_flag(arg, "bag", value)) opt.bag = value;
+        else if (arg == "--imu") opt.imu = true;
+        else if (arg == "--no-processing") opt.processing = false;
+        else
+        {
+            std::cerr << "Usage: " << argv[0] << " [--cameras=<n,n,...>] [--duration=<seconds>] [--fps=<fps>]\n"
+                << "       [--bag=<recording>] [--imu] [--no-processing]" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    auto source = opt.bag.empty() ? synthetic_frames() : recorded_frames(opt.bag);
+    std::cout << "Depth " << source.depth.width << "x" << source.depth.height << ", color " << source.color.width << "x" << source.color.height
+        << " at " << opt.fps << " fps" << (opt.imu ? ", IMU at 200 Hz" : "") << (opt.processing ? ", decimation and colorizer" : "")
+        << ", " << opt.duration << " s per run" << std::endl
+        << "Cameras  CPU/cam %  p50 ms   p90 ms   p99 ms   max ms  injected  framesets  dropped" << std::endl;
+
+    for (auto count : opt.cameras)
+        run(source, opt, count);
+
+    return EXIT_SUCCESS;
+}
+catch (const rs2::error& e)
+{
+    std::cerr << "RealSense error calling " << e.get_failed_function() << "(" << e.get_failed_args() << "):\n    " << e.what() << std::endl;
+    return EXIT_FAILURE;
+}
+catch (const std::exception& e)
+{
+    std::cerr << e.what() << std::endl;
+    return EXIT_FAILURE;
+}
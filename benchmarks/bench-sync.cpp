@@ -0,0 +1,119 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+// Frame matching by the composite matchers of src/sync.cpp and frame allocation from the frame archives
+
+#include "benchmark.h"
+
+#include <librealsense2/rs.hpp>
+#include <librealsense2/hpp/rs_internal.hpp>
+
+#include "../src/source.h"
+
+using rs2_benchmark::state;
+using rs2_benchmark::resolution;
+
+namespace
+{
+    struct matcher_case
+    {
+        const char* name;
+        rs2_matchers matcher;
+        std::vector<std::pair<rs2_stream, int>> streams;
+    };
+
+    // The frame number matchers of the D400 and SR300 cameras, and the timestamp matcher of other devices
+    const matcher_case matcher_cases[] = {
+        { "di", RS2_MATCHER_DI, { { RS2_STREAM_DEPTH, 0 }, { RS2_STREAM_INFRARED, 1 } } },
+        { "di_c", RS2_MATCHER_DI_C, { { RS2_STREAM_DEPTH, 0 }, { RS2_STREAM_INFRARED, 1 }, { RS2_STREAM_COLOR, 0 } } },
+        { "dlr", RS2_MATCHER_DLR, { { RS2_STREAM_DEPTH, 0 }, { RS2_STREAM_INFRARED, 1 }, { RS2_STREAM_INFRARED, 2 } } },
+        { "dlr_c", RS2_MATCHER_DLR_C, { { RS2_STREAM_DEPTH, 0 }, { RS2_STREAM_INFRARED, 1 }, { RS2_STREAM_INFRARED, 2 }, { RS2_STREAM_COLOR, 0 } } },
+        { "timestamp", RS2_MATCHER_DEFAULT, { { RS2_STREAM_DEPTH, 0 }, { RS2_STREAM_COLOR, 0 } } },
+    };
+
+    // One frame of every stream per iteration, the framesets are counted as items
+    void run_matcher(state& st, const matcher_case& c)
+    {
+        const int w = 640, h = 480;
+        rs2::software_device dev;
+        auto sensor = dev.add_sensor("Synthetic camera");
+        rs2_intrinsics intrinsics{ w, h, w / 2.f, h / 2.f, w / 2.f, w / 2.f, RS2_DISTORTION_NONE, { 0, 0, 0, 0, 0 } };
+
+        std::vector<rs2::stream_profile> profiles;
+        for (auto&& s : c.streams)
+        {
+            auto format = s.first == RS2_STREAM_DEPTH ? RS2_FORMAT_Z16 : s.first == RS2_STREAM_COLOR ? RS2_FORMAT_RGB8 : RS2_FORMAT_Y8;
+            profiles.push_back(sensor.add_video_stream({ s.first, s.second, static_cast<int>(profiles.size()), w, h, 30, 1, format, intrinsics }));
+        }
+        dev.create_matcher(c.matcher);
+
+        std::vector<uint8_t> pixels(w * h * 3);
+        rs2::syncer sync(64);
+        sensor.open(profiles);
+        sensor.start(sync);
+
+        int64_t framesets = 0;
+        int frame_number = 0;
+        rs2::frameset fs;
+        while (st.keep_running())
+        {
+            ++frame_number;
+            for (auto&& p : profiles)
+                sensor.on_video_frame({ pixels.data(), [](void*) {}, w, 1, frame_number * 1000. / 30, RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, frame_number, p.get() });
+            while (sync.poll_for_frames(&fs))
+                ++framesets;
+        }
+        st.set_items_processed(framesets);
+
+        fs = rs2::frameset();
+        sensor.stop();
+        sensor.close();
+    }
+
+    // Allocation and release of a frame, with a few frames held like a queue of the application would
+    void run_archive(state& st, resolution res, int frames_held)
+    {
+        librealsense::frame_source source;
+        source.init(std::make_shared<librealsense::metadata_parser_map>());
+
+        auto size = static_cast<size_t>(res.width) * res.height * 2;
+        std::vector<librealsense::frame_holder> held(frames_held);
+        size_t next = 0;
+        while (st.keep_running())
+        {
+            librealsense::frame_additional_data data{};
+            librealsense::frame_holder f(source.alloc_frame(RS2_EXTENSION_DEPTH_FRAME, size, data, true));
+            if (!f)
+            {
+                st.skip_with_error("The frame archive ran out of frames");
+                break;
+            }
+            if (frames_held)
+            {
+                held[next] = std::move(f);
+                next = (next + 1) % held.size();
+            }
+        }
+        st.set_items_processed(st.iterations());
+        held.clear();
+    }
+}
+
+RS2_BENCHMARKS(register_sync_benchmarks)
+{
+    using namespace rs2_benchmark;
+
+    for (auto&& c : matcher_cases)
+    {
+        register_benchmark(std::string("sync/") + c.name, [&c](state& st) { run_matcher(st, c); });
+    }
+
+    for (auto&& res : standard_resolutions())
+    {
+        for (auto held : { 0, 4 })
+        {
+            register_benchmark("archive/alloc/" + to_string(res) + "/held:" + std::to_string(held),
+                [res, held](state& st) { run_archive(st, res, held); });
+        }
+    }
+}
@@ -0,0 +1,59 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+// Access to the internal types the processing threads share on every frame, like the lazily computed calibration
+
+#include "benchmark.h"
+
+#include "../src/types.h"
+
+#include <thread>
+
+using rs2_benchmark::state;
+
+namespace
+{
+    // Reads of an initialized lazy value while other threads read it as fast as they can, as the processing
+    // threads of several blocks do with the intrinsics and extrinsics of the streams
+    void run_lazy(state& st, int threads)
+    {
+        librealsense::lazy<rs2_extrinsics> extrinsics([]() { return librealsense::identity_matrix(); });
+        *extrinsics;
+
+        std::atomic<bool> done(false);
+        std::vector<std::thread> readers;
+        for (int i = 1; i < threads; ++i)
+        {
+            readers.emplace_back([&]()
+            {
+                float sum = 0;
+                while (!done)
+                    sum += extrinsics->translation[0];
+                volatile float keep = sum;
+                (void)keep;
+            });
+        }
+
+        float sum = 0;
+        while (st.keep_running())
+            sum += extrinsics->translation[0];
+        volatile float keep = sum;
+        (void)keep;
+
+        done = true;
+        for (auto&& t : readers)
+            t.join();
+        st.set_items_processed(st.iterations());
+    }
+}
+
+RS2_BENCHMARKS(register_types_benchmarks)
+{
+    using namespace rs2_benchmark;
+
+    for (auto threads : { 1, 2, 4, 8 })
+    {
+        register_benchmark("types/lazy/threads:" + std::to_string(threads),
+            [threads](state& st) { run_lazy(st, threads); });
+    }
+}
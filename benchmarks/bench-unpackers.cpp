@@ -0,0 +1,124 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+// Unpacking of every native pixel format from src/image.cpp, from a raw UVC or HID payload to the output frames
+
+#include "benchmark.h"
+
+#include "../src/image.h"
+
+#include <random>
+
+using namespace librealsense;
+using rs2_benchmark::state;
+
+namespace
+{
+    struct named_format
+    {
+        const char* name;
+        const native_pixel_format* format;
+    };
+
+    const named_format image_formats[] = {
+        { "fe_raw8_unpatched_kernel", &pf_fe_raw8_unpatched_kernel },
+        { "raw8", &pf_raw8 },
+        { "rw10", &pf_rw10 },
+        { "w10", &pf_w10 },
+        { "rw16", &pf_rw16 },
+        { "bayer16", &pf_bayer16 },
+        { "yuy2", &pf_yuy2 },
+        { "yuyv", &pf_yuyv },
+        { "y8", &pf_y8 },
+        { "y8i", &pf_y8i },
+        { "y16", &pf_y16 },
+        { "y12i", &pf_y12i },
+        { "z16", &pf_z16 },
+        { "invz", &pf_invz },
+        { "f200_invi", &pf_f200_invi },
+        { "f200_inzi", &pf_f200_inzi },
+        { "sr300_invi", &pf_sr300_invi },
+        { "sr300_inzi", &pf_sr300_inzi },
+        { "uyvyl", &pf_uyvyl },
+        { "rgb888", &pf_rgb888 },
+        { "confidence_l500", &pf_confidence_l500 },
+        { "z16_l500", &pf_z16_l500 },
+        { "y8_l500", &pf_y8_l500 },
+    };
+
+    // HID reports are unpacked one at a time, with the payload size passed as the width
+    const named_format motion_formats[] = {
+        { "accel_axes", &pf_accel_axes },
+        { "gyro_axes", &pf_gyro_axes },
+        { "gpio_timestamp", &pf_gpio_timestamp },
+    };
+
+    const int hid_report_size = 64;
+
+    std::string outputs_name(const pixel_format_unpacker& unpacker)
+    {
+        std::string name;
+        for (auto&& o : unpacker.outputs)
+            name += (name.empty() ? "" : "+") + std::string(get_string(o.format));
+        return name;
+    }
+
+    void run_unpacker(state& st, const pixel_format_unpacker& unpacker, size_t source_size, int width, int height)
+    {
+        std::vector<byte> source(source_size);
+        std::mt19937 rng(0);
+        std::generate(source.begin(), source.end(), [&]() { return static_cast<byte>(rng()); });
+
+        std::vector<std::vector<byte>> outputs;
+        for (auto&& o : unpacker.outputs)
+        {
+            auto res = o.stream_resolution({ static_cast<uint32_t>(width), static_cast<uint32_t>(height) });
+            // Outputs of motion formats are a report each, whatever the resolution says
+            outputs.emplace_back(std::max<size_t>(get_image_size(res.width, res.height, o.format), 1024));
+        }
+        std::vector<byte*> dest;
+        for (auto&& o : outputs)
+            dest.push_back(o.data());
+
+        while (st.keep_running())
+            unpacker.unpack(dest.data(), source.data(), width, height);
+
+        st.set_bytes_processed(st.iterations() * static_cast<int64_t>(source_size));
+        st.set_items_processed(st.iterations());
+    }
+}
+
+RS2_BENCHMARKS(register_unpacker_benchmarks)
+{
+    for (auto&& f : image_formats)
+    {
+        for (auto&& unpacker : f.format->unpackers)
+        {
+            auto resolutions = rs2_benchmark::standard_resolutions();
+            if (unpacker.outputs.front().stream_desc.type == RS2_STREAM_COLOR)
+                resolutions.push_back({ 1920, 1080 });
+
+            for (auto&& res : resolutions)
+            {
+                auto format = f.format;
+                auto name = "unpack/" + std::string(f.name) + "/" + outputs_name(unpacker) + "/" + rs2_benchmark::to_string(res);
+                rs2_benchmark::register_benchmark(name, [format, &unpacker, res](state& st)
+                {
+                    run_unpacker(st, unpacker, format->get_image_size(res.width, res.height), res.width, res.height);
+                });
+            }
+        }
+    }
+
+    for (auto&& f : motion_formats)
+    {
+        for (auto&& unpacker : f.format->unpackers)
+        {
+            auto name = "unpack/" + std::string(f.name) + "/" + outputs_name(unpacker);
+            rs2_benchmark::register_benchmark(name, [&unpacker](state& st)
+            {
+                run_unpacker(st, unpacker, hid_report_size, hid_report_size, 1);
+            });
+        }
+    }
+}
@@ -0,0 +1,220 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#include "benchmark.h"
+
+#include <librealsense2/rs.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <regex>
+#include <sstream>
+#include <thread>
+
+namespace rs2_benchmark
+{
+    std::vector<benchmark>& registry()
+    {
+        static std::vector<benchmark> benchmarks;
+        return benchmarks;
+    }
+
+    std::vector<void(*)()>& registrations()
+    {
+        static std::vector<void(*)()> functions;
+        return functions;
+    }
+
+    struct result
+    {
+        std::string name;
+        int64_t iterations;
+        double real_ns;
+        double cpu_ns;
+        double bytes_per_second;
+        double items_per_second;
+        std::string error;
+    };
+
+    static result run(const benchmark& b, double min_time)
+    {
+        int64_t iterations = 1;
+        while (true)
+        {
+            state st(iterations);
+            b.run(st);
+
+            if (!st.error().empty())
+                return { b.name, 0, 0, 0, 0, 0, st.error() };
+
+            auto real = st.real_seconds();
+            if (real >= min_time || iterations >= 1000000000)
+            {
+                return { b.name, iterations, real * 1e9 / iterations, st.cpu_seconds() * 1e9 / iterations,
+                    real > 0 ? st.bytes_processed() / real : 0, real > 0 ? st.items_processed() / real : 0, "" };
+            }
+
+            // Aim past the minimum time, without growing more than tenfold on a too short measurement
+            auto multiplier = real > 0 ? 1.4 * min_time / real : 10.;
+            iterations = std::max(iterations + 1, static_cast<int64_t>(iterations * std::min(10., multiplier)));
+        }
+    }
+
+    static std::string human_readable(double rate, const char* unit)
+    {
+        const char* prefixes[] = { "", "k", "M", "G", "T" };
+        int i = 0;
+        while (rate >= 1024 && i < 4) { rate /= 1024; ++i; }
+        std::ostringstream ss;
+        ss << std::fixed << std::setprecision(rate < 10 ? 2 : 1) << rate << prefixes[i] << unit;
+        return ss.str();
+    }
+
+    static void write_json(std::ostream& out, const std::vector<result>& results, const char* executable)
+    {
+        auto now = std::time(nullptr);
+        char date[64];
+        std::strftime(date, sizeof(date), "%Y-%m-%d %H:%M:%S", std::localtime(&now));
+
+        out << "{\n  \"context\": {\n"
+            << "    \"date\": \"" << date << "\",\n"
+            << "    \"executable\": \"" << std::regex_replace(executable, std::regex(R"(\\)"), R"(\\)") << "\",\n"
+            << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n"
+            << "    \"library_version\": \"" << RS2_API_VERSION_STR << "\"\n"
+            << "  },\n  \"benchmarks\": [";
+
+        for (size_t i = 0; i < results.size(); i++)
+        {
+            auto&& r = results[i];
+            out << (i ? ",\n" : "\n") << "    {\n      \"name\": \"" << r.name << "\",\n";
+            if (!r.error.empty())
+            {
+                out << "      \"error_occurred\": true,\n      \"error_message\": \"" << r.error << "\"\n    }";
+                continue;
+            }
+            out << std::fixed << std::setprecision(3)
+                << "      \"iterations\": " << r.iterations << ",\n"
+                << "      \"real_time\": " << r.real_ns << ",\n"
+                << "      \"cpu_time\": " << r.cpu_ns << ",\n"
+                << "      \"time_unit\": \"ns\"";
+            if (r.bytes_per_second > 0)
+                out << ",\n      \"bytes_per_second\": " << r.bytes_per_second;
+            if (r.items_per_second > 0)
+                out << ",\n      \"items_per_second\": " << r.items_per_second;
+            out << "\n    }";
+        }
+        out << "\n  ]\n}\n";
+    }
+
+    static void print_console(const result& r, size_t name_width)
+    {
+        std::cout << std::left << std::setw(name_width) << r.name << std::right;
+        if (!r.error.empty())
+        {
+            std::cout << " ERROR: " << r.error << std::endl;
+            return;
+        }
+        std::cout << std::fixed << std::setprecision(0)
+            << std::setw(13) << r.real_ns << " ns"
+            << std::setw(13) << r.cpu_ns << " ns"
+            << std::setw(12) << r.iterations;
+        if (r.bytes_per_second > 0)
+            std::cout << "  " << human_readable(r.bytes_per_second, "B/s");
+        if (r.items_per_second > 0)
+            std::cout << "  " << human_readable(r.items_per_second, " items/s");
+        std::cout << std::endl;
+    }
+}
+
+static bool parse_flag(const std::string& arg, const std::string& flag, std::string& value)
+{
+    auto prefix = "--" + flag + "=";
+    if (arg.compare(0, prefix.size(), prefix) != 0)
+        return false;
+    value = arg.substr(prefix.size());
+    return true;
+}
+
+int main(int argc, char* argv[])
+{
+    using namespace rs2_benchmark;
+
+    std::string filter = ".*", format = "console", out_file, value;
+    double min_time = 0.5;
+    bool list_only = false;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (parse_flag(arg, "benchmark_filter", value)) filter = value;
+        else if (parse_flag(arg, "benchmark_min_time", value)) min_time = std::stod(value);
+        else if (parse_flag(arg, "benchmark_format", value)) format = value;
+        else if (parse_flag(arg, "benchmark_out", value)) out_file = value;
+        else if (arg == "--benchmark_list_tests") list_only = true;
+        else
+        {
+            std::cerr << "Usage: " << argv[0] << " [--benchmark_filter=<regex>] [--benchmark_min_time=<seconds>]\n"
+                << "       [--benchmark_format=<console|json>] [--benchmark_out=<json file>] [--benchmark_list_tests]" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    for (auto&& r : registrations())
+        r();
+
+    std::regex pattern(filter);
+    std::vector<benchmark> selected;
+    for (auto&& b : registry())
+        if (std::regex_search(b.name, pattern))
+            selected.push_back(b);
+
+    if (list_only)
+    {
+        for (auto&& b : selected)
+            std::cout << b.name << std::endl;
+        return EXIT_SUCCESS;
+    }
+
+    size_t name_width = 10;
+    for (auto&& b : selected)
+        name_width = std::max(name_width, b.name.size() + 2);
+
+    bool console = format != "json";
+    if (console)
+    {
+        std::cout << std::left << std::setw(name_width) << "Benchmark" << std::right
+            << std::setw(16) << "Time" << std::setw(16) << "CPU" << std::setw(12) << "Iterations" << std::endl
+            << std::string(name_width + 44, '-') << std::endl;
+    }
+
+    std::vector<result> results;
+    bool failed = false;
+    for (auto&& b : selected)
+    {
+        try
+        {
+            results.push_back(run(b, min_time));
+        }
+        catch (const std::exception& e)
+        {
+            results.push_back({ b.name, 0, 0, 0, 0, 0, e.what() });
+        }
+        failed |= !results.back().error.empty();
+        if (console)
+            print_console(results.back(), name_width);
+    }
+
+    if (!console)
+        write_json(std::cout, results, argv[0]);
+    if (!out_file.empty())
+    {
+        std::ofstream out(out_file);
+        write_json(out, results, argv[0]);
+    }
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
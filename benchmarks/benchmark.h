@@ -0,0 +1,121 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+// Minimal harness in the manner of Google Benchmark: every benchmark is a function running a timed loop,
+// the harness repeats it with more iterations until the loop lasts long enough to be measured
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace rs2_benchmark
+{
+    class state
+    {
+    public:
+        explicit state(int64_t iterations) : _iterations(iterations) {}
+
+        // while (state.keep_running()) { ... } runs the body as many times as the harness asks for.
+        // Only the loop is timed, the setup before it and the cleanup after it are not
+        bool keep_running()
+        {
+            if (_done == 0 && !_running && _error.empty())
+            {
+                _running = true;
+                _start = std::chrono::steady_clock::now();
+                _cpu_start = std::clock();
+            }
+            if (_running && _done < _iterations)
+            {
+                ++_done;
+                return true;
+            }
+            if (_running)
+            {
+                _real_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - _start).count();
+                _cpu_seconds = double(std::clock() - _cpu_start) / CLOCKS_PER_SEC;
+                _running = false;
+            }
+            return false;
+        }
+
+        int64_t iterations() const { return _iterations; }
+
+        // Totals over all the iterations, reported as rates
+        void set_bytes_processed(int64_t bytes) { _bytes = bytes; }
+        void set_items_processed(int64_t items) { _items = items; }
+
+        // Reports the benchmark as failed, keep_running returns false from then on
+        void skip_with_error(const std::string& message) { _error = message; _running = false; }
+
+        double real_seconds() const { return _real_seconds; }
+        double cpu_seconds() const { return _cpu_seconds; }
+        int64_t bytes_processed() const { return _bytes; }
+        int64_t items_processed() const { return _items; }
+        const std::string& error() const { return _error; }
+
+    private:
+        int64_t _iterations;
+        int64_t _done = 0;
+        bool _running = false;
+        std::chrono::steady_clock::time_point _start;
+        std::clock_t _cpu_start = 0;
+        double _real_seconds = 0;
+        double _cpu_seconds = 0;
+        int64_t _bytes = 0;
+        int64_t _items = 0;
+        std::string _error;
+    };
+
+    typedef std::function<void(state&)> benchmark_function;
+
+    struct benchmark
+    {
+        std::string name;
+        benchmark_function run;
+    };
+
+    std::vector<benchmark>& registry();
+
+    inline void register_benchmark(const std::string& name, benchmark_function f)
+    {
+        registry().push_back({ name, f });
+    }
+
+    // Registration functions are collected during static initialization and called from main, when the
+    // globals of the library they describe (like the pixel formats) are known to be constructed
+    std::vector<void(*)()>& registrations();
+
+    struct registrar
+    {
+        explicit registrar(void(*f)()) { registrations().push_back(f); }
+    };
+
+    struct resolution
+    {
+        int width, height;
+    };
+
+    // Resolutions the image benchmarks run at, as streamed by the D400 and SR300 cameras
+    inline const std::vector<resolution>& standard_resolutions()
+    {
+        static const std::vector<resolution> resolutions = { { 640, 480 }, { 848, 480 }, { 1280, 720 } };
+        return resolutions;
+    }
+
+    inline std::string to_string(const resolution& res)
+    {
+        return std::to_string(res.width) + "x" + std::to_string(res.height);
+    }
+}
+
+// Defines a function registering benchmarks, called before main
+#define RS2_BENCHMARKS(name) \
+    static void name(); \
+    static rs2_benchmark::registrar name##_registrar(&name); \
+    static void name()
@@ -936,6 +936,18 @@ namespace rs2
             << "/" << (long long)this;
         populate_options(options_metadata, ss.str().c_str(), this, s, &options_invalidated, error_message);
 
+        // Options set from elsewhere in the application are picked up on the next update
+        auto changed = options_changed;
+        for (auto&& opt : options_metadata)
+        {
+            if (!opt.second.supported) continue;
+            try
+            {
+                s->set_option_changed_callback(opt.second.opt, [changed](rs2_option, float) { *changed = true; });
+            }
+            catch (const error&) {} // The sensor does not report changes, its options are refreshed when invalidated
+        }
+
         try
         {
             auto sensor_profiles = s->get_stream_profiles();
@@ -1433,7 +1445,7 @@ namespace rs2
                 else
                 {
                     auto id = f.get_profile().unique_id();
-                    viewer.ppf.frames_queue[id].enqueue(f);
+                    viewer.ppf.enqueue(id, f);
                 }
             });
             }
@@ -1449,17 +1461,52 @@ namespace rs2
 
     void subdevice_model::update(std::string& error_message, notifications_model& notifications)
     {
-        if (options_invalidated)
+        // All the options are read at once, after they were invalidated or changed and when the read-only ones are due
+        if (!options_invalidated && !read_only_options_due && !options_changed->exchange(false))
+            return;
+        options_invalidated = false;
+        read_only_options_due = false;
+
+        std::vector<rs2_option_value> snapshot;
+        try
         {
-            next_option = 0;
-            options_invalidated = false;
+            snapshot = s->get_options_snapshot();
         }
-        if (next_option < RS2_OPTION_COUNT)
+        catch (const error& e)
         {
-            auto& opt_md = options_metadata[static_cast<rs2_option>(next_option)];
-            opt_md.update_all_fields(error_message, notifications);
+            error_message = error_to_string(e);
+            return;
+        }
+        // Reading the options reports the changes it found, these are applied below
+        *options_changed = false;
 
-            if (next_option == RS2_OPTION_ENABLE_AUTO_EXPOSURE)
+        auto value = snapshot.begin();
+        for (auto&& md : options_metadata)
+        {
+            auto& opt_md = md.second;
+            while (value != snapshot.end() && value->id < opt_md.opt) ++value;
+            opt_md.supported = value != snapshot.end() && value->id == opt_md.opt;
+            if (!opt_md.supported) continue;
+
+            if (!value->has_value)
+            {
+                if (opt_md.read_only)
+                {
+                    auto timestamp = std::chrono::duration<double, std::milli>(std::chrono::system_clock::now().time_since_epoch()).count();
+                    notifications.add_notification({ to_string() << "Could not refresh read-only option " << rs2_option_to_string(opt_md.opt),
+                        timestamp,
+                        RS2_LOG_SEVERITY_WARN,
+                        RS2_NOTIFICATION_CATEGORY_UNKNOWN_ERROR });
+                }
+                else
+                    error_message = to_string() << "Could not read option " << rs2_option_to_string(opt_md.opt);
+                continue;
+            }
+            opt_md.value = value->value;
+            opt_md.range = { value->min, value->max, value->def, value->step };
+            opt_md.read_only = value->is_read_only != 0;
+
+            if (opt_md.opt == RS2_OPTION_ENABLE_AUTO_EXPOSURE)
             {
                 auto old_ae_enabled = auto_exposure_enabled;
                 auto_exposure_enabled = opt_md.value > 0;
@@ -1486,15 +1533,13 @@ namespace rs2
 
             }
 
-            if (next_option == RS2_OPTION_DEPTH_UNITS)
+            if (opt_md.opt == RS2_OPTION_DEPTH_UNITS)
             {
                 opt_md.dev->depth_units = opt_md.value;
             }
 
-            if (next_option == RS2_OPTION_STEREO_BASELINE)
+            if (opt_md.opt == RS2_OPTION_STEREO_BASELINE)
                 opt_md.dev->stereo_baseline = opt_md.value;
-
-            next_option++;
         }
     }
 
@@ -2067,6 +2112,35 @@ namespace rs2
         }
         ImGui::SameLine();
 
+        if (pointcloud_lod)
+        {
+            ImGui::PushStyleColor(ImGuiCol_Text, light_blue);
+            ImGui::PushStyleColor(ImGuiCol_TextSelectedBg, light_blue);
+            label = to_string() << textual_icons::braille << "##Level of Detail";
+            if (ImGui::Button(label.c_str(), { 24, buttons_heights }))
+            {
+                pointcloud_lod = false;
+            }
+            if (ImGui::IsItemHovered())
+            {
+                ImGui::SetTooltip("Thin out the pointcloud when viewed from afar");
+            }
+            ImGui::PopStyleColor(2);
+        }
+        else
+        {
+            label = to_string() << textual_icons::braille << "##Full Detail";
+            if (ImGui::Button(label.c_str(), { 24, buttons_heights }))
+            {
+                pointcloud_lod = true;
+            }
+            if (ImGui::IsItemHovered())
+            {
+                ImGui::SetTooltip("Draw every point of the pointcloud");
+            }
+        }
+        ImGui::SameLine();
+
         if (support_non_syncronized_mode)
         {
             if (synchronization_enable)
@@ -2220,10 +2294,7 @@ namespace rs2
                 selected_tex_source_uid = -1;
             streams.erase(i);
 
-            if(ppf.frames_queue.find(i) != ppf.frames_queue.end())
-            {
-                ppf.frames_queue.erase(i);
-            }
+            ppf.remove_stream(i);
         }
     }
 
@@ -3260,6 +3331,7 @@ namespace rs2
 
     void post_processing_filters::map_id(rs2::frame new_frame, rs2::frame old_frame)
     {
+        std::lock_guard<std::mutex> lock(map_id_mutex);
         if (auto new_set = new_frame.as<rs2::frameset>())
         {
             if (auto old_set = old_frame.as<rs2::frameset>())
@@ -3339,6 +3411,7 @@ namespace rs2
         {
             if(auto depth = viewer.get_3d_depth_source(filtered))
             {
+                std::lock_guard<std::mutex> lock(pc_mutex);
                 res.push_back(pc->calculate(depth));
             }
             if(auto texture = viewer.get_3d_texture_source(filtered))
@@ -3379,8 +3452,10 @@ namespace rs2
         {
             viewer.syncer->stop();
             render_thread.join();
+            stop_chains();
         }
     }
+
     void post_processing_filters::render_loop()
     {
         while (render_thread_active)
@@ -3389,33 +3464,85 @@ namespace rs2
             {
                 if(viewer.synchronization_enable)
                 {
+                    // A syncer per device, its framesets go to the chain of their first stream
                     auto frames = viewer.syncer->try_wait_for_frames();
-                        for(auto f:frames)
-                        {
-                            processing_block.invoke(f);
-                        }
+                    for(auto&& f : frames)
+                    {
+                        if (f.size())
+                            dispatch(f[0].get_profile().unique_id(), f);
+                    }
                 }
                 else
                 {
-                    std::map<int, rs2::frame_queue> frames_queue_local;
-                    {
-                        std::lock_guard<std::mutex> lock(viewer.streams_mutex);
-                        frames_queue_local = frames_queue;
-                    }
-                    for (auto&& q : frames_queue_local)
-                    {
-                        frame frm;
-                        if (q.second.try_wait_for_frame(&frm, 30))
-                        {
-                            processing_block.invoke(frm);
-                        }
-                    }
+                    // The frames of the streams go to their chains from the sensor callbacks
+                    std::this_thread::sleep_for(std::chrono::milliseconds(10));
                 }
             }
             catch (...) {}
         }
     }
 
+    void post_processing_filters::dispatch(int key, rs2::frame f)
+    {
+        std::lock_guard<std::mutex> lock(chains_mutex);
+        // Checked under the lock, so no chain is started once stop_chains took them
+        if (!render_thread_active)
+            return;
+
+        auto&& chain = chains[key];
+        if (!chain)
+        {
+            chain.reset(new processing_chain());
+            auto p = chain.get();
+            chain->thread = std::thread([this, p]() { chain_loop(*p); });
+        }
+        chain->queue.enqueue(std::move(f));
+    }
+
+    void post_processing_filters::chain_loop(processing_chain& chain)
+    {
+        while (chain.active)
+        {
+            frame f;
+            if (chain.queue.try_wait_for_frame(&f, 10))
+            {
+                try
+                {
+                    processing_block.invoke(f);
+                }
+                catch (...) {}
+            }
+        }
+    }
+
+    void post_processing_filters::remove_stream(int stream_id)
+    {
+        std::unique_ptr<processing_chain> chain;
+        {
+            std::lock_guard<std::mutex> lock(chains_mutex);
+            auto it = chains.find(stream_id);
+            if (it == chains.end())
+                return;
+            chain = std::move(it->second);
+            chains.erase(it);
+        }
+        chain->active = false;
+        chain->thread.join();
+    }
+
+    void post_processing_filters::stop_chains()
+    {
+        std::map<int, std::unique_ptr<processing_chain>> stopped;
+        {
+            std::lock_guard<std::mutex> lock(chains_mutex);
+            stopped.swap(chains);
+        }
+        for (auto&& c : stopped)
+            c.second->active = false;
+        for (auto&& c : stopped)
+            c.second->thread.join();
+    }
+
     void viewer_model::show_no_stream_overlay(ImFont* font_18, int min_x, int min_y, int max_x, int max_y)
     {
         auto flags = ImGuiWindowFlags_NoResize |
@@ -4138,8 +4265,13 @@ namespace rs2
         if (last_points && last_texture)
         {
             auto vf_profile = last_points.get_profile().as<video_stream_profile>();
+            // Far from the camera target neighbouring points land on the same pixels, drawing fewer but larger ones looks the same
+            auto lod_step = 1;
+            if (pointcloud_lod)
+                lod_step = std::max(1, std::min(4, static_cast<int>((pos - target).length() / 2)));
+
             // Non-linear correspondence customized for non-flat surface exploration
-            glPointSize(std::sqrt(viewer_rect.w / vf_profile.width()));
+            glPointSize(std::sqrt(viewer_rect.w / vf_profile.width()) * lod_step);
 
             auto tex = last_texture->get_gl_handle();
             glBindTexture(GL_TEXTURE_2D, tex);
@@ -4150,43 +4282,8 @@ namespace rs2
 
             //glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, tex_border_color);
 
-            auto vertices = last_points.get_vertices();
-            auto tex_coords = last_points.get_texture_coordinates();
-            if (!render_quads)
-            {
-                glBegin(GL_POINTS);
-                for (int i = 0; i < last_points.size(); i++)
-                {
-                    if (vertices[i].z)
-                    {
-                        glVertex3fv(vertices[i]);
-                        glTexCoord2fv(tex_coords[i + 1]);
-                    }
-                }
-                glEnd();
-            }
-            else
-            {
-                // Visualization with quads produces better results but requires further optimization
-                glBegin(GL_QUADS);
-
-                const auto threshold = 0.05f;
-                auto width = vf_profile.width(), height = vf_profile.height();
-                for (int x = 0; x < width - 1; ++x) {
-                    for (int y = 0; y < height - 1; ++y) {
-                        auto a = y * width + x, b = y * width + x + 1, c = (y + 1)*width + x, d = (y + 1)*width + x + 1;
-                        if (vertices[a].z && vertices[b].z && vertices[c].z && vertices[d].z
-                            && abs(vertices[a].z - vertices[b].z) < threshold && abs(vertices[a].z - vertices[c].z) < threshold
-                            && abs(vertices[b].z - vertices[d].z) < threshold && abs(vertices[c].z - vertices[d].z) < threshold) {
-                            glVertex3fv(vertices[a]); glTexCoord2fv(tex_coords[a]);
-                            glVertex3fv(vertices[b]); glTexCoord2fv(tex_coords[b]);
-                            glVertex3fv(vertices[d]); glTexCoord2fv(tex_coords[d]);
-                            glVertex3fv(vertices[c]); glTexCoord2fv(tex_coords[c]);
-                        }
-                    }
-                }
-                glEnd();
-            }
+            pointcloud_vertices.upload(last_points, vf_profile.width(), vf_profile.height(), render_quads, lod_step);
+            pointcloud_vertices.draw();
         }
 
         glDisable(GL_DEPTH_TEST);
@@ -4336,7 +4433,6 @@ namespace rs2
         // Starting post processing filter rendering thread
         ppf.start();
         streams[p.unique_id()].begin_stream(d, p);
-        ppf.frames_queue.emplace(p.unique_id(), rs2::frame_queue(5));
     }
 
     bool viewer_model::is_3d_texture_source(frame f)
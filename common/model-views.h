@@ -16,6 +16,7 @@
 #include <set>
 #include <array>
 #include <unordered_map>
+#include <atomic>
 
 #include "imgui-fonts-karla.hpp"
 #include "imgui-fonts-fontawesome.hpp"
@@ -376,7 +377,10 @@ namespace rs2
         bool draw_option(rs2_option opt, bool update_read_only_options,
             std::string& error_message, notifications_model& model)
         {
-            return options_metadata[opt].draw_option(update_read_only_options, streaming, error_message, model);
+            // The sensor's options are refreshed together by update(), rather than one query per drawn option
+            if (update_read_only_options && streaming)
+                read_only_options_due = true;
+            return options_metadata[opt].draw_option(false, streaming, error_message, model);
         }
 
         bool is_paused() const;
@@ -432,7 +436,8 @@ namespace rs2
         frame_queues queues;
         std::mutex _queue_lock;
         bool options_invalidated = false;
-        int next_option = RS2_OPTION_COUNT;
+        bool read_only_options_due = false;
+        std::shared_ptr<std::atomic<bool>> options_changed = std::make_shared<std::atomic<bool>>(false);
         bool streaming = false;
 
         rect normalized_zoom{0, 0, 1, 1};
@@ -718,7 +723,11 @@ namespace rs2
 
         ~post_processing_filters() { stop(); }
 
-        void update_texture(frame f) { pc->map_to(f); }
+        void update_texture(frame f)
+        {
+            std::lock_guard<std::mutex> lock(pc_mutex);
+            pc->map_to(f);
+        }
 
         /* Start the rendering thread in case its disabled */
         void start();
@@ -749,10 +758,15 @@ namespace rs2
             while(resulting_queue.poll_for_frame(&f));
         }
 
+        /* Hands a frame of a stream that is not synchronized to the processing chain of the stream */
+        void enqueue(int stream_id, rs2::frame f) { dispatch(stream_id, std::move(f)); }
+
+        /* Stops the processing chain of a stream that was closed */
+        void remove_stream(int stream_id);
+
         std::atomic<bool> depth_stream_active;
 
         const size_t resulting_queue_max_size;
-        std::map<int, rs2::frame_queue> frames_queue;
         rs2::frame_queue resulting_queue;
 
         std::shared_ptr<pointcloud> get_pc() const { return pc; }
@@ -778,7 +792,24 @@ namespace rs2
         /* Post processing filter rendering */
         std::atomic<bool> render_thread_active; // True when render post processing filter rendering thread is active, False otherwise
         std::thread render_thread;              // Post processing filter rendering Thread running render_loop()
-        void render_loop();                     // Post processing filter rendering function
+        void render_loop();                     // Hands the framesets of the syncers to their processing chains
+
+        /* Frames are processed on a chain per stream, and per device for the framesets of the syncers, so streams
+           don't wait for each other's filters. A chain holds only the newest frame, older ones are dropped */
+        struct processing_chain
+        {
+            processing_chain() : queue(1), active(true) {}
+            rs2::frame_queue queue;
+            std::atomic<bool> active;
+            std::thread thread;
+        };
+        void dispatch(int key, rs2::frame f);
+        void chain_loop(processing_chain& chain);
+        void stop_chains();
+        std::map<int, std::unique_ptr<processing_chain>> chains;
+        std::mutex chains_mutex;
+        std::mutex map_id_mutex;                // The chains map their streams in the viewer concurrently
+        std::mutex pc_mutex;                    // The pointcloud is shared by the chains and the texture updates
 
         int last_frame_number = 0;
         double last_timestamp = 0;
@@ -1012,6 +1043,7 @@ namespace rs2
         float3 up;
         bool fixed_up = true;
         bool render_quads = true;
+        bool pointcloud_lod = false;
 
         float view[16];
         bool texture_wrapping_on = true;
@@ -1020,6 +1052,7 @@ namespace rs2
         rs2::points last_points;
         texture_buffer* last_texture;
         texture_buffer texture;
+        pointcloud_buffer pointcloud_vertices;
 
     };
 
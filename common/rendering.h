@@ -4,6 +4,7 @@
 #pragma once
 
 #include <librealsense2/rs.hpp>
+#include <librealsense2/hpp/rs_internal.hpp>
 
 #define GLFW_INCLUDE_GLU
 #include <GLFW/glfw3.h>
@@ -11,6 +12,7 @@
 #include <vector>
 #include <algorithm>
 #include <cstring>
+#include <cstddef>
 #include <ctype.h>
 #include <memory>
 #include <string>
@@ -32,6 +34,56 @@
 #endif
 #endif
 
+// OpenGL 1.5-3.0 entry points used by the texture uploads, loaded at runtime since the system headers may only declare OpenGL 1.1
+#ifndef GL_ARRAY_BUFFER
+#define GL_ARRAY_BUFFER         0x8892
+#endif
+#ifndef GL_PIXEL_UNPACK_BUFFER
+#define GL_PIXEL_UNPACK_BUFFER  0x88EC
+#endif
+#ifndef GL_STREAM_DRAW
+#define GL_STREAM_DRAW          0x88E0
+#endif
+#ifndef GL_WRITE_ONLY
+#define GL_WRITE_ONLY           0x88B9
+#endif
+#ifndef GL_FRAGMENT_SHADER
+#define GL_FRAGMENT_SHADER      0x8B30
+#endif
+#ifndef GL_VERTEX_SHADER
+#define GL_VERTEX_SHADER        0x8B31
+#endif
+#ifndef GL_COMPILE_STATUS
+#define GL_COMPILE_STATUS       0x8B81
+#endif
+#ifndef GL_LINK_STATUS
+#define GL_LINK_STATUS          0x8B82
+#endif
+#ifndef GL_TEXTURE0
+#define GL_TEXTURE0             0x84C0
+#endif
+#ifndef GL_FRAMEBUFFER
+#define GL_FRAMEBUFFER          0x8D40
+#endif
+#ifndef GL_FRAMEBUFFER_BINDING
+#define GL_FRAMEBUFFER_BINDING  0x8CA6
+#endif
+#ifndef GL_COLOR_ATTACHMENT0
+#define GL_COLOR_ATTACHMENT0    0x8CE0
+#endif
+#ifndef GL_FRAMEBUFFER_COMPLETE
+#define GL_FRAMEBUFFER_COMPLETE 0x8CD5
+#endif
+#ifndef GL_LUMINANCE16
+#define GL_LUMINANCE16          0x8042
+#endif
+
+#ifdef _WIN32
+#define RS2_GL_APIENTRY __stdcall
+#else
+#define RS2_GL_APIENTRY
+#endif
+
 namespace rs2
 {
     class fps_calc
@@ -976,11 +1028,568 @@ namespace rs2
         timer _t;
     };
 
+    // Pixel buffer objects, shaders and framebuffer objects, available when the context provides them.
+    // Must be first called with a current context
+    struct gl_functions
+    {
+        typedef void (RS2_GL_APIENTRY *gen_t)(GLsizei, GLuint*);
+        typedef void (RS2_GL_APIENTRY *bind_t)(GLenum, GLuint);
+        typedef void (RS2_GL_APIENTRY *buffer_data_t)(GLenum, ptrdiff_t, const void*, GLenum);
+        typedef void* (RS2_GL_APIENTRY *map_buffer_t)(GLenum, GLenum);
+        typedef GLboolean (RS2_GL_APIENTRY *unmap_buffer_t)(GLenum);
+        typedef GLuint (RS2_GL_APIENTRY *create_shader_t)(GLenum);
+        typedef void (RS2_GL_APIENTRY *shader_source_t)(GLuint, GLsizei, const char* const*, const GLint*);
+        typedef void (RS2_GL_APIENTRY *uint_t)(GLuint);
+        typedef void (RS2_GL_APIENTRY *get_iv_t)(GLuint, GLenum, GLint*);
+        typedef GLuint (RS2_GL_APIENTRY *create_program_t)();
+        typedef void (RS2_GL_APIENTRY *attach_shader_t)(GLuint, GLuint);
+        typedef GLint (RS2_GL_APIENTRY *get_uniform_location_t)(GLuint, const char*);
+        typedef void (RS2_GL_APIENTRY *uniform1i_t)(GLint, GLint);
+        typedef void (RS2_GL_APIENTRY *uniform1f_t)(GLint, GLfloat);
+        typedef void (RS2_GL_APIENTRY *active_texture_t)(GLenum);
+        typedef void (RS2_GL_APIENTRY *framebuffer_texture_t)(GLenum, GLenum, GLenum, GLuint, GLint);
+        typedef GLenum (RS2_GL_APIENTRY *check_framebuffer_t)(GLenum);
+
+        gen_t gen_buffers = nullptr;
+        bind_t bind_buffer = nullptr;
+        buffer_data_t buffer_data = nullptr;
+        map_buffer_t map_buffer = nullptr;
+        unmap_buffer_t unmap_buffer = nullptr;
+
+        create_shader_t create_shader = nullptr;
+        shader_source_t shader_source = nullptr;
+        uint_t compile_shader = nullptr;
+        get_iv_t get_shader_iv = nullptr;
+        create_program_t create_program = nullptr;
+        attach_shader_t attach_shader = nullptr;
+        uint_t link_program = nullptr;
+        get_iv_t get_program_iv = nullptr;
+        uint_t use_program = nullptr;
+        get_uniform_location_t get_uniform_location = nullptr;
+        uniform1i_t uniform1i = nullptr;
+        uniform1f_t uniform1f = nullptr;
+        active_texture_t active_texture = nullptr;
+
+        gen_t gen_framebuffers = nullptr;
+        bind_t bind_framebuffer = nullptr;
+        framebuffer_texture_t framebuffer_texture_2d = nullptr;
+        check_framebuffer_t check_framebuffer_status = nullptr;
+
+        bool has_pbo = false;
+        // Vertex buffers, core since OpenGL 1.5
+        bool has_vbo = false;
+        // Shaders with render to texture, for the colorization of depth
+        bool has_shaders = false;
+
+        static const gl_functions& get()
+        {
+            static gl_functions f = load();
+            return f;
+        }
+
+    private:
+        template<class T>
+        static void load(T& f, const char* name, const char* fallback = nullptr)
+        {
+            f = reinterpret_cast<T>(glfwGetProcAddress(name));
+            if (!f && fallback) f = reinterpret_cast<T>(glfwGetProcAddress(fallback));
+        }
+
+        static gl_functions load()
+        {
+            gl_functions f;
+            load(f.gen_buffers, "glGenBuffers", "glGenBuffersARB");
+            load(f.bind_buffer, "glBindBuffer", "glBindBufferARB");
+            load(f.buffer_data, "glBufferData", "glBufferDataARB");
+            load(f.map_buffer, "glMapBuffer", "glMapBufferARB");
+            load(f.unmap_buffer, "glUnmapBuffer", "glUnmapBufferARB");
+            f.has_vbo = f.gen_buffers && f.bind_buffer && f.buffer_data && f.map_buffer && f.unmap_buffer;
+            f.has_pbo = (glfwExtensionSupported("GL_ARB_pixel_buffer_object") || glfwExtensionSupported("GL_EXT_pixel_buffer_object")) && f.has_vbo;
+
+            load(f.create_shader, "glCreateShader");
+            load(f.shader_source, "glShaderSource");
+            load(f.compile_shader, "glCompileShader");
+            load(f.get_shader_iv, "glGetShaderiv");
+            load(f.create_program, "glCreateProgram");
+            load(f.attach_shader, "glAttachShader");
+            load(f.link_program, "glLinkProgram");
+            load(f.get_program_iv, "glGetProgramiv");
+            load(f.use_program, "glUseProgram");
+            load(f.get_uniform_location, "glGetUniformLocation");
+            load(f.uniform1i, "glUniform1i");
+            load(f.uniform1f, "glUniform1f");
+            load(f.active_texture, "glActiveTexture", "glActiveTextureARB");
+            load(f.gen_framebuffers, "glGenFramebuffers", "glGenFramebuffersEXT");
+            load(f.bind_framebuffer, "glBindFramebuffer", "glBindFramebufferEXT");
+            load(f.framebuffer_texture_2d, "glFramebufferTexture2D", "glFramebufferTexture2DEXT");
+            load(f.check_framebuffer_status, "glCheckFramebufferStatus", "glCheckFramebufferStatusEXT");
+            f.has_shaders = f.create_shader && f.shader_source && f.compile_shader && f.get_shader_iv && f.create_program &&
+                f.attach_shader && f.link_program && f.get_program_iv && f.use_program && f.get_uniform_location &&
+                f.uniform1i && f.uniform1f && f.active_texture && f.gen_framebuffers && f.bind_framebuffer &&
+                f.framebuffer_texture_2d && f.check_framebuffer_status;
+            return f;
+        }
+    };
+
+    // Vertices of the 3D view's pointcloud, kept in a vertex buffer that is refilled once per points frame rather than on every
+    // redraw. Points without depth are left out, and the texture coordinates are stored next to the positions they belong to
+    class pointcloud_buffer
+    {
+        struct vertex
+        {
+            float x, y, z, u, v;
+        };
+
+        GLuint _vbo = 0;
+        GLsizei _count = 0;
+        std::vector<vertex> _vertices; // Used when the context has no vertex buffers, or the buffer cannot be mapped
+        bool _in_vbo = false;
+
+        rs2::frame _frame;
+        bool _quads = false;
+        int _step = 0;
+
+        static bool has_depth(const rs2::vertex& v) { return v.z != 0; }
+
+        static vertex* add(vertex* out, const rs2::vertex& p, const rs2::texture_coordinate& t)
+        {
+            *out = { p.x, p.y, p.z, t.u, t.v };
+            return out + 1;
+        }
+
+        // Fills the buffer with the vertices of the points, or of the quads between neighbouring points at similar depth,
+        // on a grid of one every step pixels. Returns the number of vertices written
+        static GLsizei fill(vertex* out, const rs2::points& points, int width, int height, bool quads, int step)
+        {
+            auto vertices = points.get_vertices();
+            auto tex_coords = points.get_texture_coordinates();
+            auto begin = out;
+            if (!quads)
+            {
+                for (int y = 0; y < height; y += step)
+                {
+                    for (int x = 0; x < width; x += step)
+                    {
+                        auto i = y * width + x;
+                        if (has_depth(vertices[i]))
+                            out = add(out, vertices[i], tex_coords[i]);
+                    }
+                }
+                return static_cast<GLsizei>(out - begin);
+            }
+
+            const auto threshold = 0.05f;
+            for (int y = 0; y + step < height; y += step)
+            {
+                for (int x = 0; x + step < width; x += step)
+                {
+                    auto a = y * width + x, b = a + step, c = a + step * width, d = c + step;
+                    if (has_depth(vertices[a]) && has_depth(vertices[b]) && has_depth(vertices[c]) && has_depth(vertices[d])
+                        && std::abs(vertices[a].z - vertices[b].z) < threshold && std::abs(vertices[a].z - vertices[c].z) < threshold
+                        && std::abs(vertices[b].z - vertices[d].z) < threshold && std::abs(vertices[c].z - vertices[d].z) < threshold)
+                    {
+                        out = add(out, vertices[a], tex_coords[a]);
+                        out = add(out, vertices[b], tex_coords[b]);
+                        out = add(out, vertices[d], tex_coords[d]);
+                        out = add(out, vertices[c], tex_coords[c]);
+                    }
+                }
+            }
+            return static_cast<GLsizei>(out - begin);
+        }
+
+    public:
+        void upload(const rs2::points& points, int width, int height, bool quads, int step)
+        {
+            if (_frame && points.get() == _frame.get() && points.get_frame_number() == _frame.get_frame_number() && quads == _quads && step == _step)
+                return;
+            _frame = points;
+            _quads = quads;
+            _step = step;
+
+            auto cells = static_cast<size_t>((width + step - 1) / step) * ((height + step - 1) / step);
+            auto capacity = (quads ? 4 : 1) * cells;
+            auto& gl = gl_functions::get();
+            _in_vbo = false;
+            if (gl.has_vbo)
+            {
+                if (!_vbo)
+                    gl.gen_buffers(1, &_vbo);
+
+                // Orphaning the previous storage lets the mapping return while the last frame is still being drawn
+                gl.bind_buffer(GL_ARRAY_BUFFER, _vbo);
+                gl.buffer_data(GL_ARRAY_BUFFER, static_cast<ptrdiff_t>(capacity * sizeof(vertex)), nullptr, GL_STREAM_DRAW);
+                if (auto mapped = static_cast<vertex*>(gl.map_buffer(GL_ARRAY_BUFFER, GL_WRITE_ONLY)))
+                {
+                    _count = fill(mapped, points, width, height, quads, step);
+                    _in_vbo = gl.unmap_buffer(GL_ARRAY_BUFFER) == GL_TRUE;
+                }
+                gl.bind_buffer(GL_ARRAY_BUFFER, 0);
+            }
+            if (!_in_vbo)
+            {
+                _vertices.resize(capacity);
+                _count = fill(_vertices.data(), points, width, height, quads, step);
+            }
+        }
+
+        void draw() const
+        {
+            if (!_frame || !_count)
+                return;
+
+            auto& gl = gl_functions::get();
+            const char* base = nullptr; // Offsets into the bound vertex buffer
+            if (_in_vbo)
+                gl.bind_buffer(GL_ARRAY_BUFFER, _vbo);
+            else
+                base = reinterpret_cast<const char*>(_vertices.data());
+
+            glEnableClientState(GL_VERTEX_ARRAY);
+            glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+            glVertexPointer(3, GL_FLOAT, sizeof(vertex), base + offsetof(vertex, x));
+            glTexCoordPointer(2, GL_FLOAT, sizeof(vertex), base + offsetof(vertex, u));
+            glDrawArrays(_quads ? GL_QUADS : GL_POINTS, 0, _count);
+            glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+            glDisableClientState(GL_VERTEX_ARRAY);
+
+            if (_in_vbo)
+                gl.bind_buffer(GL_ARRAY_BUFFER, 0);
+        }
+    };
+
+    // Colors Z16 depth textures on the GPU the way the colorizer does on the CPU:
+    // the depth value, or its position in the cumulative histogram when equalizing, indexes the color map.
+    // The color map is taken from the colorizer itself, by coloring a ramp of all the 16-bit values
+    class gpu_depth_colorizer
+    {
+        GLuint _program = 0;
+        GLuint _framebuffer = 0;
+        GLuint _histogram_texture = 0;
+        GLuint _map_texture = 0;
+        int _map_scheme = -1;
+        bool _failed = false;
+        std::vector<uint16_t> _histogram;
+        std::vector<uint32_t> _counts;
+        int _equalization_frames_left = 0;
+        float _depth_units = 0.001f;
+
+        // The public API exposes the units of a frame through the distance of its pixels
+        float depth_units(const depth_frame& frame, int width, int height)
+        {
+            auto data = reinterpret_cast<const uint16_t*>(frame.get_data());
+            for (int i = 0; i < width * height; i++)
+            {
+                if (data[i])
+                {
+                    _depth_units = frame.get_distance(i % width, i / width) / data[i];
+                    break;
+                }
+            }
+            return _depth_units;
+        }
+
+        static GLuint create_lookup_texture()
+        {
+            GLuint tex;
+            glGenTextures(1, &tex);
+            glBindTexture(GL_TEXTURE_2D, tex);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP);
+            return tex;
+        }
+
+        bool initialize()
+        {
+            auto& gl = gl_functions::get();
+            if (!gl.has_shaders)
+                return false;
+
+            // The 16-bit values are normalized by the texture fetch, lookup tables are 256x256 textures indexed by value
+            static const char* vertex_source =
+                "#version 110\n"
+                "void main() { gl_TexCoord[0] = gl_MultiTexCoord0; gl_Position = ftransform(); }\n";
+            static const char* fragment_source =
+                "#version 110\n"
+                "uniform sampler2D depth;\n"
+                "uniform sampler2D histogram;\n"
+                "uniform sampler2D color_map;\n"
+                "uniform float equalize;\n"
+                "uniform float scale;\n"
+                "uniform float offset;\n"
+                "vec2 lookup(float normalized)\n"
+                "{\n"
+                "    float index = floor(normalized * 65535.0 + 0.5);\n"
+                "    float row = floor(index / 256.0);\n"
+                "    return vec2((index - row * 256.0 + 0.5) / 256.0, (row + 0.5) / 256.0);\n"
+                "}\n"
+                "void main()\n"
+                "{\n"
+                "    float z = texture2D(depth, gl_TexCoord[0].st).r;\n"
+                "    float t = equalize > 0.5 ? texture2D(histogram, lookup(z)).r : clamp(z * scale + offset, 0.0, 1.0);\n"
+                "    vec3 color = texture2D(color_map, lookup(t)).rgb;\n"
+                "    // No depth is black, and so is the first pixel, which the pointcloud uses for occluded points\n"
+                "    if (z == 0.0 || all(lessThan(gl_FragCoord.xy, vec2(1.0)))) color = vec3(0.0);\n"
+                "    gl_FragColor = vec4(color, 1.0);\n"
+                "}\n";
+
+            GLint ok = 0;
+            _program = gl.create_program();
+            for (auto&& shader : { std::make_pair(GL_VERTEX_SHADER, vertex_source), std::make_pair(GL_FRAGMENT_SHADER, fragment_source) })
+            {
+                auto id = gl.create_shader(shader.first);
+                gl.shader_source(id, 1, &shader.second, nullptr);
+                gl.compile_shader(id);
+                gl.get_shader_iv(id, GL_COMPILE_STATUS, &ok);
+                if (!ok) return false;
+                gl.attach_shader(_program, id);
+            }
+            gl.link_program(_program);
+            gl.get_program_iv(_program, GL_LINK_STATUS, &ok);
+            if (!ok) return false;
+
+            gl.use_program(_program);
+            gl.uniform1i(gl.get_uniform_location(_program, "depth"), 0);
+            gl.uniform1i(gl.get_uniform_location(_program, "histogram"), 1);
+            gl.uniform1i(gl.get_uniform_location(_program, "color_map"), 2);
+            gl.use_program(0);
+
+            gl.gen_framebuffers(1, &_framebuffer);
+            _histogram_texture = create_lookup_texture();
+            _map_texture = create_lookup_texture();
+            glBindTexture(GL_TEXTURE_2D, 0);
+            return true;
+        }
+
+        // The colorizer without equalization, over depth units spanning [0,1] in 16 bits, gives the color of every position of the map
+        void update_color_map(colorizer& source, int scheme)
+        {
+            static const int size = 256;
+            std::vector<uint16_t> ramp(size * size);
+            for (size_t i = 0; i < ramp.size(); i++)
+                ramp[i] = static_cast<uint16_t>(i);
+
+            software_device dev;
+            auto sensor = dev.add_sensor("Color map");
+            rs2_intrinsics intrinsics{ size, size, 0, 0, 1, 1, RS2_DISTORTION_NONE, { 0, 0, 0, 0, 0 } };
+            auto profile = sensor.add_video_stream({ RS2_STREAM_DEPTH, 0, 0, size, size, 30, 2, RS2_FORMAT_Z16, intrinsics });
+            sensor.add_read_only_option(RS2_OPTION_DEPTH_UNITS, 1.f / 65535);
+
+            frame_queue queue(1);
+            sensor.open(profile);
+            sensor.start(queue);
+            sensor.on_video_frame({ ramp.data(), [](void*) {}, size * 2, 2, 0, RS2_TIMESTAMP_DOMAIN_SYSTEM_TIME, 0, profile.get() });
+
+            frame ramp_frame;
+            if (queue.try_wait_for_frame(&ramp_frame, 1000))
+            {
+                colorizer c;
+                c.set_option(RS2_OPTION_COLOR_SCHEME, static_cast<float>(scheme));
+                c.set_option(RS2_OPTION_HISTOGRAM_EQUALIZATION_ENABLED, 0.f);
+                c.set_option(RS2_OPTION_MIN_DISTANCE, 0.f);
+                c.set_option(RS2_OPTION_MAX_DISTANCE, 1.f);
+                auto colored = c.colorize(ramp_frame).as<video_frame>();
+
+                glBindTexture(GL_TEXTURE_2D, _map_texture);
+                glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+                glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, size, size, 0, GL_RGB, GL_UNSIGNED_BYTE, colored.get_data());
+                glBindTexture(GL_TEXTURE_2D, 0);
+            }
+            ramp_frame = frame();
+            sensor.stop();
+            sensor.close();
+            _map_scheme = scheme;
+        }
+
+        // Cumulative histogram over [1,0xFFFF] normalized to 16 bits, as the colorizer equalizes
+        void update_histogram(const uint16_t* depth, size_t size)
+        {
+            _counts.assign(0x10000, 0);
+            for (size_t i = 0; i < size; i++) ++_counts[depth[i]];
+            for (size_t i = 2; i < _counts.size(); i++) _counts[i] += _counts[i - 1];
+
+            auto total = _counts.back();
+            _histogram.resize(_counts.size());
+            _histogram[0] = 0;
+            for (size_t i = 1; i < _counts.size(); i++)
+                _histogram[i] = total ? static_cast<uint16_t>(_counts[i] * 65535.0 / total + 0.5) : 0;
+
+            glBindTexture(GL_TEXTURE_2D, _histogram_texture);
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_LUMINANCE16, 256, 256, 0, GL_LUMINANCE, GL_UNSIGNED_SHORT, _histogram.data());
+            glBindTexture(GL_TEXTURE_2D, 0);
+            _equalization_frames_left = total ? 1 : 0;
+        }
+
+    public:
+        // Renders the depth texture into the target RGB texture of the same size, already allocated, with the settings of the colorizer.
+        // Returns false when the GPU path is not available, and the frame has to be colorized on the CPU
+        bool colorize(colorizer& source, const depth_frame& frame, GLuint depth_texture, GLuint target, int width, int height)
+        {
+            if (_failed)
+                return false;
+            if (!_program && !initialize())
+            {
+                _failed = true;
+                return false;
+            }
+
+            auto& gl = gl_functions::get();
+            auto scheme = static_cast<int>(source.get_option(RS2_OPTION_COLOR_SCHEME));
+            if (scheme != _map_scheme)
+                update_color_map(source, scheme);
+
+            bool equalize = source.get_option(RS2_OPTION_HISTOGRAM_EQUALIZATION_ENABLED) > 0.f;
+            if (equalize)
+            {
+                // The colorizer keeps one equalization curve for a number of frames
+                auto interval = source.supports(RS2_OPTION_HISTOGRAM_EQUALIZATION_INTERVAL) ?
+                    static_cast<int>(source.get_option(RS2_OPTION_HISTOGRAM_EQUALIZATION_INTERVAL)) : 1;
+                if (_equalization_frames_left <= 0)
+                {
+                    update_histogram(reinterpret_cast<const uint16_t*>(frame.get_data()), size_t(width) * height);
+                    _equalization_frames_left *= interval;
+                }
+                --_equalization_frames_left;
+            }
+            else
+                _equalization_frames_left = 0;
+
+            // t = (z * 65535 * units - min) / (max - min), with z the normalized texture value
+            auto min = source.get_option(RS2_OPTION_MIN_DISTANCE), max = source.get_option(RS2_OPTION_MAX_DISTANCE);
+            auto range = max > min ? max - min : 1.f;
+            auto scale = 65535.f * depth_units(frame, width, height) / range;
+
+            GLint previous_framebuffer = 0, viewport[4];
+            glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previous_framebuffer);
+            glGetIntegerv(GL_VIEWPORT, viewport);
+            gl.bind_framebuffer(GL_FRAMEBUFFER, _framebuffer);
+            gl.framebuffer_texture_2d(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, target, 0);
+            if (gl.check_framebuffer_status(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+            {
+                gl.bind_framebuffer(GL_FRAMEBUFFER, previous_framebuffer);
+                glBindTexture(GL_TEXTURE_2D, 0);
+                _failed = true;
+                return false;
+            }
+
+            gl.use_program(_program);
+            gl.uniform1f(gl.get_uniform_location(_program, "equalize"), equalize ? 1.f : 0.f);
+            gl.uniform1f(gl.get_uniform_location(_program, "scale"), scale);
+            gl.uniform1f(gl.get_uniform_location(_program, "offset"), -min / range);
+
+            gl.active_texture(GL_TEXTURE0 + 2);
+            glBindTexture(GL_TEXTURE_2D, _map_texture);
+            gl.active_texture(GL_TEXTURE0 + 1);
+            glBindTexture(GL_TEXTURE_2D, _histogram_texture);
+            gl.active_texture(GL_TEXTURE0);
+            glBindTexture(GL_TEXTURE_2D, depth_texture);
+
+            glViewport(0, 0, width, height);
+            glMatrixMode(GL_PROJECTION);
+            glPushMatrix();
+            glLoadIdentity();
+            glOrtho(0, 1, 0, 1, -1, 1);
+            glMatrixMode(GL_MODELVIEW);
+            glPushMatrix();
+            glLoadIdentity();
+
+            // Texture row 0 is the first image row, and so is the bottom row of the framebuffer
+            glBegin(GL_QUADS);
+            glTexCoord2f(0, 0); glVertex2f(0, 0);
+            glTexCoord2f(1, 0); glVertex2f(1, 0);
+            glTexCoord2f(1, 1); glVertex2f(1, 1);
+            glTexCoord2f(0, 1); glVertex2f(0, 1);
+            glEnd();
+
+            glPopMatrix();
+            glMatrixMode(GL_PROJECTION);
+            glPopMatrix();
+            glMatrixMode(GL_MODELVIEW);
+
+            gl.use_program(0);
+            gl.active_texture(GL_TEXTURE0 + 2);
+            glBindTexture(GL_TEXTURE_2D, 0);
+            gl.active_texture(GL_TEXTURE0 + 1);
+            glBindTexture(GL_TEXTURE_2D, 0);
+            gl.active_texture(GL_TEXTURE0);
+            gl.bind_framebuffer(GL_FRAMEBUFFER, previous_framebuffer);
+            glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+
+            glBindTexture(GL_TEXTURE_2D, target);
+            return true;
+        }
+    };
+
     class texture_buffer
     {
         GLuint texture;
         rs2::frame_queue last_queue[2];
         mutable rs2::frame last[2];
+
+        // Uploads go through two pixel buffer objects in turn, the driver copies from one while the other is filled
+        GLuint pbo[2] = { 0, 0 };
+        int next_pbo = 0;
+        // Storage of the target texture, reallocated only when the frame layout changes
+        int allocated_width = 0, allocated_height = 0;
+        GLint allocated_format = 0;
+        // Raw depth texture of the GPU colorizer
+        GLuint depth_texture = 0;
+        int depth_width = 0, depth_height = 0;
+        GLint depth_format = 0;
+        std::shared_ptr<gpu_depth_colorizer> gpu_colorizer = std::make_shared<gpu_depth_colorizer>();
+        // The frame of the texture was colored on the GPU, the CPU copy is colorized on demand
+        mutable bool colorize_on_demand = false;
+
+        void upload_pixels(GLuint tex, int& tex_width, int& tex_height, GLint& tex_format,
+            GLint internal_format, int width, int height, GLenum format, GLenum type, const void* data, size_t size)
+        {
+            auto& gl = gl_functions::get();
+            glBindTexture(GL_TEXTURE_2D, tex);
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+            if (!gl.has_pbo || !size)
+            {
+                glTexImage2D(GL_TEXTURE_2D, 0, internal_format, width, height, 0, format, type, data);
+                tex_width = width; tex_height = height; tex_format = internal_format;
+                return;
+            }
+
+            if (tex_width != width || tex_height != height || tex_format != internal_format)
+            {
+                glTexImage2D(GL_TEXTURE_2D, 0, internal_format, width, height, 0, format, type, nullptr);
+                tex_width = width; tex_height = height; tex_format = internal_format;
+            }
+
+            if (!pbo[0])
+                gl.gen_buffers(2, pbo);
+
+            // Orphaning the previous storage lets the mapping return without waiting for the pending transfer
+            gl.bind_buffer(GL_PIXEL_UNPACK_BUFFER, pbo[next_pbo]);
+            gl.buffer_data(GL_PIXEL_UNPACK_BUFFER, static_cast<ptrdiff_t>(size), nullptr, GL_STREAM_DRAW);
+            if (auto mapped = gl.map_buffer(GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY))
+            {
+                memcpy(mapped, data, size);
+                gl.unmap_buffer(GL_PIXEL_UNPACK_BUFFER);
+                glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, format, type, nullptr);
+            }
+            else
+            {
+                gl.bind_buffer(GL_PIXEL_UNPACK_BUFFER, 0);
+                glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, format, type, data);
+            }
+            gl.bind_buffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            next_pbo = (next_pbo + 1) % 2;
+        }
+
+        void upload_texture(GLint internal_format, int width, int height, GLenum format, GLenum type, const void* data, size_t size)
+        {
+            upload_pixels(texture, allocated_width, allocated_height, allocated_format,
+                internal_format, width, height, format, type, data, size);
+        }
+
     public:
         std::shared_ptr<colorizer> colorize;
         bool zoom_preview = false;
@@ -994,12 +1603,28 @@ namespace rs2
         texture_buffer& operator=(const texture_buffer& other)
         {
             texture = other.texture;
+            allocated_width = allocated_height = allocated_format = 0;
             return *this;
         }
 
+        // Whether depth is colorized by a shader on the GPU when the context supports it
+        bool gpu_colorize = true;
+
         rs2::frame get_last_frame(bool with_texture = false) const {
             auto idx = with_texture ? 1 : 0;
-            last_queue[idx].poll_for_frame(&last[idx]);
+            if (last_queue[idx].poll_for_frame(&last[idx]) && with_texture)
+                colorize_on_demand = last[idx].is<depth_frame>();
+
+            // The texture was colored on the GPU, the colored copy is only made for the users of the pixels
+            if (with_texture && colorize_on_demand && last[idx])
+            {
+                if (auto colorized_frame = colorize->colorize(last[idx]).as<video_frame>())
+                {
+                    memset((void*)colorized_frame.get_data(), 0, colorized_frame.get_bytes_per_pixel());
+                    last[idx] = colorized_frame;
+                }
+                colorize_on_demand = false;
+            }
             return last[idx];
         }
 
@@ -1016,6 +1641,9 @@ namespace rs2
                 glGenTextures(1, &texture);
             glBindTexture(GL_TEXTURE_2D, texture);
             glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
+            allocated_width = w;
+            allocated_height = h;
+            allocated_format = GL_RGBA;
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP);
@@ -1048,6 +1676,7 @@ namespace rs2
 
             glBindTexture(GL_TEXTURE_2D, texture);
             stride = stride == 0 ? width : stride;
+            auto size = size_t(stride) * height;
             //glPixelStorei(GL_UNPACK_ROW_LENGTH, stride);
             switch (format)
             {
@@ -1055,44 +1684,76 @@ namespace rs2
                 throw std::runtime_error("not a valid format");
             case RS2_FORMAT_Z16:
             case RS2_FORMAT_DISPARITY16:
-                if (frame.is<depth_frame>())
+                if (auto depth = frame.as<depth_frame>())
                 {
+                    // The raw depth goes to the GPU and is colored there, the texture is then the colorized image
+                    if (gpu_colorize && gl_functions::get().has_shaders)
+                    {
+                        if (!depth_texture)
+                        {
+                            glGenTextures(1, &depth_texture);
+                            glBindTexture(GL_TEXTURE_2D, depth_texture);
+                            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+                            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+                            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP);
+                            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP);
+                        }
+                        upload_pixels(depth_texture, depth_width, depth_height, depth_format,
+                            GL_LUMINANCE16, width, height, GL_LUMINANCE, GL_UNSIGNED_SHORT, data, size);
+
+                        glBindTexture(GL_TEXTURE_2D, texture);
+                        if (allocated_width != width || allocated_height != height || allocated_format != GL_RGB)
+                        {
+                            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, nullptr);
+                            allocated_width = width;
+                            allocated_height = height;
+                            allocated_format = GL_RGB;
+                        }
+                        if (gpu_colorizer->colorize(*colorize, depth, depth_texture, texture, width, height))
+                            break;
+                        glBindTexture(GL_TEXTURE_2D, texture);
+                    }
+
                     if (auto colorized_frame = colorize->colorize(frame).as<video_frame>())
                     {
                         data = colorized_frame.get_data();
                         // Override the first pixel in the colorized image for occlusion invalidation.
                         memset((void*)data,0, colorized_frame.get_bytes_per_pixel());
-                        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB,
+                        upload_texture(GL_RGB,
                                      colorized_frame.get_width(),
                                      colorized_frame.get_height(),
-                                     0, GL_RGB, GL_UNSIGNED_BYTE,
-                                     colorized_frame.get_data());
+                                     GL_RGB, GL_UNSIGNED_BYTE,
+                                     colorized_frame.get_data(),
+                                     size_t(colorized_frame.get_stride_in_bytes()) * colorized_frame.get_height());
                         rendered_frame = colorized_frame;
                     }
                 }
-                else glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_LUMINANCE, GL_UNSIGNED_SHORT, data);
+                else upload_texture(GL_RGB, width, height, GL_LUMINANCE, GL_UNSIGNED_SHORT, data, size);
 
                 break;
             case RS2_FORMAT_DISPARITY32:
-                glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, width, height, 0, GL_DEPTH_COMPONENT, GL_FLOAT, data);
+                upload_texture(GL_DEPTH_COMPONENT, width, height, GL_DEPTH_COMPONENT, GL_FLOAT, data, size);
                 break;
             case RS2_FORMAT_XYZ32F:
-                glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_FLOAT, data);
+                upload_texture(GL_RGB, width, height, GL_RGB, GL_FLOAT, data, size);
                 break;
             case RS2_FORMAT_YUYV: // Display YUYV by showing the luminance channel and packing chrominance into ignored alpha channel
-                glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_LUMINANCE_ALPHA, GL_UNSIGNED_BYTE, data);
+                upload_texture(GL_RGB, width, height, GL_LUMINANCE_ALPHA, GL_UNSIGNED_BYTE, data, size);
+                break;
+            case RS2_FORMAT_Y8I: // Display the left image, with the right one packed into the ignored alpha channel
+                upload_texture(GL_RGB, width, height, GL_LUMINANCE_ALPHA, GL_UNSIGNED_BYTE, data, size);
                 break;
             case RS2_FORMAT_UYVY: // Use luminance component only to avoid costly UVUY->RGB conversion
-                glTexImage2D(GL_TEXTURE_2D, 0, GL_LUMINANCE, width, height, 0, GL_LUMINANCE, GL_UNSIGNED_SHORT, data);
+                upload_texture(GL_LUMINANCE, width, height, GL_LUMINANCE, GL_UNSIGNED_SHORT, data, size);
                 break;
             case RS2_FORMAT_RGB8: case RS2_FORMAT_BGR8: // Display both RGB and BGR by interpreting them RGB, to show the flipped byte ordering. Obviously, GL_BGR could be used on OpenGL 1.2+
-                glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
+                upload_texture(GL_RGB, width, height, GL_RGB, GL_UNSIGNED_BYTE, data, size);
                 break;
             case RS2_FORMAT_RGBA8: case RS2_FORMAT_BGRA8: // Display both RGBA and BGRA by interpreting them RGBA, to show the flipped byte ordering. Obviously, GL_BGRA could be used on OpenGL 1.2+
-                glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
+                upload_texture(GL_RGBA, width, height, GL_RGBA, GL_UNSIGNED_BYTE, data, size);
                 break;
             case RS2_FORMAT_Y8:
-                glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_LUMINANCE, GL_UNSIGNED_BYTE, data);
+                upload_texture(GL_RGB, width, height, GL_LUMINANCE, GL_UNSIGNED_BYTE, data, size);
                 break;
             case RS2_FORMAT_MOTION_XYZ32F:
             {
@@ -1108,12 +1769,12 @@ namespace rs2
                 break;
             }
             case RS2_FORMAT_Y16:
-                glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_LUMINANCE, GL_UNSIGNED_SHORT, data);
+                upload_texture(GL_RGB, width, height, GL_LUMINANCE, GL_UNSIGNED_SHORT, data, size);
                 break;
             case RS2_FORMAT_RAW8:
             case RS2_FORMAT_MOTION_RAW:
             case RS2_FORMAT_GPIO_RAW:
-                glTexImage2D(GL_TEXTURE_2D, 0, GL_LUMINANCE, width, height, 0, GL_LUMINANCE, GL_UNSIGNED_BYTE, data);
+                upload_texture(GL_LUMINANCE, width, height, GL_LUMINANCE, GL_UNSIGNED_BYTE, data, size);
                 break;
             case RS2_FORMAT_6DOF:
             {
@@ -0,0 +1,701 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#include <librealsense2/rs.hpp> // Include RealSense Cross Platform API
+#include <librealsense2/hpp/rs_internal.hpp>
+
+#include "tclap/CmdLine.h"
+
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <netdb.h>
+#include <unistd.h>
+#include <signal.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace TCLAP;
+
+// Wire format: every message is a message_header followed by its body.
+// A frame body is a frame_header, its metadata as (id, value) pairs, then the payload.
+// Both ends are assumed to share endianness and structure layout.
+
+const uint32_t net_magic = 0x52534e54; // "RSNT"
+
+enum message_type : uint32_t { MESSAGE_FRAME = 1, MESSAGE_OPTION = 2 };
+enum payload_codec : uint32_t { CODEC_RAW = 0, CODEC_RVL = 1 };
+
+struct message_header
+{
+    uint32_t magic;
+    uint32_t type;
+    uint32_t size;                  // bytes following this header
+};
+
+struct frame_header
+{
+    rs2_stream stream;
+    int stream_index;
+    int unique_id;
+    rs2_format format;
+    int fps;
+    int width, height, bpp, stride; // zero for motion frames
+    rs2_intrinsics intrinsics;
+
+    int frame_number;
+    double timestamp;
+    rs2_timestamp_domain domain;
+
+    uint32_t codec;
+    uint32_t raw_size;              // payload size once decoded
+    uint32_t metadata_count;
+};
+
+struct metadata_entry
+{
+    int32_t id;
+    rs2_metadata_type value;
+};
+
+struct option_message
+{
+    int unique_id;                  // stream the option belongs to, through its sensor
+    rs2_option option;
+    float value;
+};
+
+// RVL (Wilson, "Fast Lossless Depth Image Compression", 2017): depth is coded as alternating
+// runs of zeros and non-zeros, the non-zero pixels as zigzag deltas from their predecessor,
+// all written as variable length nibbles (3 value bits and a continuation bit)
+class rvl_encoder
+{
+public:
+    explicit rvl_encoder(std::vector<uint8_t>& out) : _out(out) {}
+
+    void encode(const uint16_t* input, size_t count)
+    {
+        auto end = input + count;
+        int previous = 0;
+        while (input != end)
+        {
+            auto zeros_start = input;
+            while (input != end && !*input) ++input;
+            write(static_cast<uint32_t>(input - zeros_start));
+
+            auto nonzeros_start = input;
+            while (input != end && *input) ++input;
+            write(static_cast<uint32_t>(input - nonzeros_start));
+
+            for (auto p = nonzeros_start; p < input; ++p)
+            {
+                int delta = *p - previous;
+                write(static_cast<uint32_t>((delta << 1) ^ (delta >> 31)));
+                previous = *p;
+            }
+        }
+        flush();
+    }
+
+private:
+    void write(uint32_t value)
+    {
+        do
+        {
+            uint32_t nibble = value & 0x7;
+            value >>= 3;
+            if (value) nibble |= 0x8;
+            _word = (_word << 4) | nibble;
+            if (++_nibbles == 8)
+                flush();
+        } while (value);
+    }
+
+    void flush()
+    {
+        if (!_nibbles) return;
+        _word <<= 4 * (8 - _nibbles);
+        auto offset = _out.size();
+        _out.resize(offset + sizeof(_word));
+        memcpy(_out.data() + offset, &_word, sizeof(_word));
+        _word = 0;
+        _nibbles = 0;
+    }
+
+    std::vector<uint8_t>& _out;
+    uint32_t _word = 0;
+    int _nibbles = 0;
+};
+
+class rvl_decoder
+{
+public:
+    rvl_decoder(const uint8_t* input, size_t size) : _input(input), _end(input + size) {}
+
+    bool decode(uint16_t* output, size_t count)
+    {
+        auto end = output + count;
+        int previous = 0;
+        while (output != end)
+        {
+            uint32_t zeros, nonzeros;
+            if (!read(zeros) || zeros > size_t(end - output)) return false;
+            std::fill(output, output + zeros, uint16_t(0));
+            output += zeros;
+
+            if (!read(nonzeros) || nonzeros > size_t(end - output)) return false;
+            for (uint32_t i = 0; i < nonzeros; i++)
+            {
+                uint32_t zigzag;
+                if (!read(zigzag)) return false;
+                previous += static_cast<int>(zigzag >> 1) ^ -static_cast<int>(zigzag & 1);
+                *output++ = static_cast<uint16_t>(previous);
+            }
+        }
+        return true;
+    }
+
+private:
+    bool read(uint32_t& value)
+    {
+        value = 0;
+        for (int shift = 0; shift < 32; shift += 3)
+        {
+            if (!_nibbles)
+            {
+                if (_end - _input < int(sizeof(_word))) return false;
+                memcpy(&_word, _input, sizeof(_word));
+                _input += sizeof(_word);
+                _nibbles = 8;
+            }
+            uint32_t nibble = _word >> 28;
+            _word <<= 4;
+            --_nibbles;
+            value |= (nibble & 0x7) << shift;
+            if (!(nibble & 0x8)) return true;
+        }
+        return false;
+    }
+
+    const uint8_t* _input;
+    const uint8_t* _end;
+    uint32_t _word = 0;
+    int _nibbles = 0;
+};
+
+void send_all(int fd, const void* data, size_t size)
+{
+    auto p = static_cast<const uint8_t*>(data);
+    while (size)
+    {
+        auto sent = send(fd, p, size, MSG_NOSIGNAL);
+        if (sent <= 0)
+            throw std::runtime_error(std::string("send failed: ") + strerror(errno));
+        p += sent;
+        size -= sent;
+    }
+}
+
+void recv_all(int fd, void* data, size_t size)
+{
+    auto p = static_cast<uint8_t*>(data);
+    while (size)
+    {
+        auto received = recv(fd, p, size, 0);
+        if (received <= 0)
+            throw std::runtime_error(received ? std::string("recv failed: ") + strerror(errno) : "Server closed the connection");
+        p += received;
+        size -= received;
+    }
+}
+
+typedef std::shared_ptr<const std::vector<uint8_t>> message;
+
+message make_message(message_type type, const std::vector<uint8_t>& body)
+{
+    auto msg = std::make_shared<std::vector<uint8_t>>(sizeof(message_header) + body.size());
+    message_header header{ net_magic, type, static_cast<uint32_t>(body.size()) };
+    memcpy(msg->data(), &header, sizeof(header));
+    memcpy(msg->data() + sizeof(header), body.data(), body.size());
+    return msg;
+}
+
+// Encodes each frame once and hands it to every connected client. A client that falls behind
+// has its oldest messages dropped, so capture is never held back by the network.
+class server
+{
+public:
+    server(int port, bool compress_depth) : _compress_depth(compress_depth)
+    {
+        _listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (_listen_fd < 0)
+            throw std::runtime_error(std::string("socket failed: ") + strerror(errno));
+
+        int reuse = 1;
+        setsockopt(_listen_fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_ANY);
+        addr.sin_port = htons(static_cast<uint16_t>(port));
+        if (bind(_listen_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 || listen(_listen_fd, 4) < 0)
+        {
+            close(_listen_fd);
+            throw std::runtime_error(std::string("Cannot listen on the port: ") + strerror(errno));
+        }
+    }
+
+    ~server()
+    {
+        shutdown(_listen_fd, SHUT_RDWR);
+        close(_listen_fd);
+        if (_accept_thread.joinable())
+            _accept_thread.join();
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (auto&& c : _clients)
+            c->stop();
+    }
+
+    void run(rs2::pipeline& pipe, const rs2::config& cfg)
+    {
+        auto profile = pipe.start(cfg, [this](rs2::frame f)
+        {
+            if (auto fs = f.as<rs2::frameset>())
+            {
+                for (auto&& sub : fs)
+                    publish(sub);
+            }
+            else
+                publish(f);
+        });
+
+        // Options of the sensors streaming, sent to every client when it connects
+        for (auto&& sensor : profile.get_device().query_sensors())
+        {
+            for (auto&& stream : profile.get_streams())
+            {
+                bool owned = false;
+                for (auto&& sp : sensor.get_stream_profiles())
+                    owned |= sp.unique_id() == stream.unique_id();
+                if (!owned)
+                    continue;
+
+                for (int i = 0; i < RS2_OPTION_COUNT; i++)
+                {
+                    auto option = static_cast<rs2_option>(i);
+                    if (!sensor.supports(option))
+                        continue;
+                    try
+                    {
+                        option_message opt{ stream.unique_id(), option, sensor.get_option(option) };
+                        std::vector<uint8_t> body(sizeof(opt));
+                        memcpy(body.data(), &opt, sizeof(opt));
+                        _options.push_back(make_message(MESSAGE_OPTION, body));
+                    }
+                    catch (const rs2::error&) {} // Some options cannot be read while streaming
+                }
+            }
+        }
+
+        _accept_thread = std::thread([this]() { accept_clients(); });
+
+        std::cout << "Press Enter to stop" << std::endl;
+        std::cin.get();
+        pipe.stop();
+    }
+
+private:
+    class client
+    {
+    public:
+        explicit client(int fd) : _fd(fd), _thread([this]() { send_loop(); }) {}
+        ~client() { stop(); }
+
+        void push(message msg)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (_queue.size() >= max_queued)
+                _queue.pop_front();
+            _queue.push_back(msg);
+            _cv.notify_one();
+        }
+
+        void stop()
+        {
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                if (_stopped) return;
+                _stopped = true;
+                _cv.notify_one();
+            }
+            shutdown(_fd, SHUT_RDWR);
+            if (_thread.joinable())
+                _thread.join();
+            close(_fd);
+        }
+
+        bool is_alive() const { return _alive; }
+
+    private:
+        static const size_t max_queued = 8;
+
+        void send_loop()
+        {
+            try
+            {
+                while (true)
+                {
+                    message msg;
+                    {
+                        std::unique_lock<std::mutex> lock(_mutex);
+                        _cv.wait(lock, [this]() { return _stopped || !_queue.empty(); });
+                        if (_stopped) return;
+                        msg = _queue.front();
+                        _queue.pop_front();
+                    }
+                    send_all(_fd, msg->data(), msg->size());
+                }
+            }
+            catch (const std::exception& e)
+            {
+                std::cout << "Client disconnected: " << e.what() << std::endl;
+                _alive = false;
+            }
+        }
+
+        int _fd;
+        std::mutex _mutex;
+        std::condition_variable _cv;
+        std::deque<message> _queue;
+        bool _stopped = false;
+        std::atomic<bool> _alive{ true };
+        std::thread _thread;
+    };
+
+    void accept_clients()
+    {
+        while (true)
+        {
+            auto fd = accept(_listen_fd, nullptr, nullptr);
+            if (fd < 0)
+                return;
+
+            int nodelay = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
+
+            auto c = std::make_shared<client>(fd);
+            for (auto&& opt : _options)
+                c->push(opt);
+
+            std::lock_guard<std::mutex> lock(_mutex);
+            _clients.push_back(c);
+            std::cout << "Client connected, " << _clients.size() << " in total" << std::endl;
+        }
+    }
+
+    void publish(const rs2::frame& f)
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _clients.erase(std::remove_if(_clients.begin(), _clients.end(),
+                                          [](const std::shared_ptr<client>& c) { return !c->is_alive(); }), _clients.end());
+            if (_clients.empty())
+                return;
+        }
+
+        auto msg = encode(f);
+        if (!msg) return;
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (auto&& c : _clients)
+            c->push(msg);
+    }
+
+    message encode(const rs2::frame& f)
+    {
+        frame_header header{};
+        auto profile = f.get_profile();
+        header.stream = profile.stream_type();
+        header.stream_index = profile.stream_index();
+        header.unique_id = profile.unique_id();
+        header.format = profile.format();
+        header.fps = profile.fps();
+
+        if (auto vf = f.as<rs2::video_frame>())
+        {
+            header.width = vf.get_width();
+            header.height = vf.get_height();
+            header.bpp = vf.get_bytes_per_pixel();
+            header.stride = vf.get_stride_in_bytes();
+            header.raw_size = header.stride * header.height;
+            try { header.intrinsics = profile.as<rs2::video_stream_profile>().get_intrinsics(); }
+            catch (const rs2::error&) {} // Not every stream is calibrated
+        }
+        else if (f.is<rs2::motion_frame>())
+            header.raw_size = sizeof(rs2_vector);
+        else
+            return nullptr;
+
+        header.frame_number = static_cast<int>(f.get_frame_number());
+        header.timestamp = f.get_timestamp();
+        header.domain = f.get_frame_timestamp_domain();
+
+        std::vector<bool> supported;
+        auto values = f.get_frame_metadata_all(supported);
+        std::vector<metadata_entry> metadata;
+        for (int i = 0; i < RS2_FRAME_METADATA_COUNT; i++)
+            if (supported[i])
+                metadata.push_back({ i, values[i] });
+        header.metadata_count = static_cast<uint32_t>(metadata.size());
+
+        auto pixels = static_cast<const uint8_t*>(f.get_data());
+        std::vector<uint8_t> payload;
+        if (_compress_depth && header.format == RS2_FORMAT_Z16 && header.stride == header.width * 2)
+        {
+            header.codec = CODEC_RVL;
+            payload.reserve(header.raw_size / 2);
+            rvl_encoder(payload).encode(reinterpret_cast<const uint16_t*>(pixels), header.width * header.height);
+        }
+        else
+        {
+            header.codec = CODEC_RAW;
+            payload.assign(pixels, pixels + header.raw_size);
+        }
+
+        auto metadata_size = metadata.size() * sizeof(metadata_entry);
+        std::vector<uint8_t> body(sizeof(header) + metadata_size + payload.size());
+        memcpy(body.data(), &header, sizeof(header));
+        if (metadata_size)
+            memcpy(body.data() + sizeof(header), metadata.data(), metadata_size);
+        if (!payload.empty())
+            memcpy(body.data() + sizeof(header) + metadata_size, payload.data(), payload.size());
+        return make_message(MESSAGE_FRAME, body);
+    }
+
+    bool _compress_depth;
+    int _listen_fd;
+    std::thread _accept_thread;
+    std::vector<message> _options;
+    std::mutex _mutex;
+    std::vector<std::shared_ptr<client>> _clients;
+};
+
+// Re-creates the remote streams on a software device, so the client gets regular rs2::frame objects
+class remote_device
+{
+public:
+    remote_device(std::function<void(rs2::frame)> callback) : _callback(callback) {}
+
+    void on_option(const option_message& opt)
+    {
+        _options[opt.unique_id].push_back(opt);
+    }
+
+    void on_frame(const frame_header& header, const metadata_entry* metadata, const uint8_t* payload, size_t payload_size)
+    {
+        auto pixels = new uint8_t[header.raw_size];
+        auto deleter = [](void* p) { delete[] static_cast<uint8_t*>(p); };
+
+        if (header.codec == CODEC_RVL)
+        {
+            if (!rvl_decoder(payload, payload_size).decode(reinterpret_cast<uint16_t*>(pixels), header.raw_size / 2))
+            {
+                std::cerr << "Corrupted depth frame dropped" << std::endl;
+                deleter(pixels);
+                return;
+            }
+        }
+        else if (header.codec == CODEC_RAW && payload_size == header.raw_size)
+            memcpy(pixels, payload, payload_size);
+        else
+        {
+            deleter(pixels);
+            return;
+        }
+
+        auto& stream = get_stream(header);
+        for (uint32_t i = 0; i < header.metadata_count; i++)
+            stream.sensor.set_metadata(static_cast<rs2_frame_metadata_value>(metadata[i].id), metadata[i].value);
+
+        if (header.width)
+            stream.sensor.on_video_frame({ pixels, deleter, header.stride, header.bpp, header.timestamp, header.domain, header.frame_number, stream.profile });
+        else
+            stream.sensor.on_motion_frame({ pixels, deleter, header.timestamp, header.domain, header.frame_number, stream.profile });
+    }
+
+private:
+    struct stream_state
+    {
+        rs2::software_sensor sensor;
+        rs2::stream_profile profile;
+    };
+
+    stream_state& get_stream(const frame_header& header)
+    {
+        auto it = _streams.find(header.unique_id);
+        if (it != _streams.end())
+            return it->second;
+
+        auto sensor = _dev.add_sensor(rs2_stream_to_string(header.stream));
+        rs2::stream_profile profile;
+        if (header.width)
+            profile = sensor.add_video_stream({ header.stream, header.stream_index, header.unique_id,
+                                                header.width, header.height, header.fps, header.bpp,
+                                                header.format, header.intrinsics });
+        else
+            profile = sensor.add_motion_stream({ header.stream, header.stream_index, header.unique_id,
+                                                 header.fps, header.format, {} });
+
+        for (auto&& opt : _options[header.unique_id])
+            sensor.add_read_only_option(opt.option, opt.value);
+
+        sensor.open(profile);
+        sensor.start(_callback);
+        std::cout << "Receiving " << profile.stream_name() << " " << rs2_format_to_string(header.format) << std::endl;
+        return _streams.emplace(header.unique_id, stream_state{ sensor, profile }).first->second;
+    }
+
+    std::function<void(rs2::frame)> _callback;
+    rs2::software_device _dev;
+    std::map<int, std::vector<option_message>> _options;
+    std::map<int, stream_state> _streams;
+};
+
+int run_client(const std::string& host, int port)
+{
+    addrinfo hints{};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* addresses = nullptr;
+    if (getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &addresses) || !addresses)
+        throw std::runtime_error("Cannot resolve " + host);
+
+    auto fd = socket(AF_INET, SOCK_STREAM, 0);
+    auto connected = fd >= 0 && connect(fd, addresses->ai_addr, addresses->ai_addrlen) == 0;
+    freeaddrinfo(addresses);
+    if (!connected)
+    {
+        if (fd >= 0) close(fd);
+        throw std::runtime_error("Cannot connect to " + host + ": " + strerror(errno));
+    }
+
+    std::map<std::string, int> received;
+    std::mutex mutex;
+    remote_device dev([&](rs2::frame f)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        received[f.get_profile().stream_name()]++;
+    });
+
+    size_t wire_bytes = 0, raw_bytes = 0;
+    auto last_report = std::chrono::steady_clock::now();
+    std::vector<uint8_t> body;
+    try
+    {
+        while (true)
+        {
+            message_header header;
+            recv_all(fd, &header, sizeof(header));
+            if (header.magic != net_magic)
+                throw std::runtime_error("Unexpected data from the server");
+            body.resize(header.size);
+            recv_all(fd, body.data(), body.size());
+
+            if (header.type == MESSAGE_OPTION && body.size() == sizeof(option_message))
+            {
+                option_message opt;
+                memcpy(&opt, body.data(), sizeof(opt));
+                dev.on_option(opt);
+            }
+            else if (header.type == MESSAGE_FRAME && body.size() >= sizeof(frame_header))
+            {
+                frame_header frame;
+                memcpy(&frame, body.data(), sizeof(frame));
+                auto metadata_size = frame.metadata_count * sizeof(metadata_entry);
+                if (body.size() < sizeof(frame) + metadata_size)
+                    throw std::runtime_error("Malformed frame message");
+
+                std::vector<metadata_entry> metadata(frame.metadata_count);
+                if (metadata_size)
+                    memcpy(metadata.data(), body.data() + sizeof(frame), metadata_size);
+                auto payload = body.data() + sizeof(frame) + metadata_size;
+                auto payload_size = body.size() - sizeof(frame) - metadata_size;
+                dev.on_frame(frame, metadata.data(), payload, payload_size);
+
+                wire_bytes += payload_size;
+                raw_bytes += frame.raw_size;
+            }
+
+            auto now = std::chrono::steady_clock::now();
+            if (now - last_report > std::chrono::seconds(1))
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                for (auto&& kvp : received)
+                    std::cout << kvp.first << ": " << kvp.second << " fps   ";
+                std::cout << wire_bytes * 8 / 1000000.0 << " Mbit/s";
+                if (wire_bytes)
+                    std::cout << ", " << double(raw_bytes) / wire_bytes << "x compression";
+                std::cout << std::endl;
+                received.clear();
+                wire_bytes = raw_bytes = 0;
+                last_report = now;
+            }
+        }
+    }
+    catch (...)
+    {
+        close(fd);
+        throw;
+    }
+}
+
+int main(int argc, char * argv[]) try
+{
+    CmdLine cmd("librealsense rs-net-stream example tool", ' ', RS2_API_VERSION_STR);
+
+    ValueArg<std::string> connect_arg("c", "connect", "Receive the streams of the server running on this host", false, "", "host");
+    ValueArg<int> port_arg("p", "port", "TCP port to serve on or connect to", false, 8554, "integer");
+    SwitchArg raw_depth_arg("r", "raw-depth", "Send depth uncompressed");
+    cmd.add(connect_arg);
+    cmd.add(port_arg);
+    cmd.add(raw_depth_arg);
+    cmd.parse(argc, argv);
+
+    signal(SIGPIPE, SIG_IGN);
+
+    if (!connect_arg.getValue().empty())
+        return run_client(connect_arg.getValue(), port_arg.getValue());
+
+    // YUYV is what the color sensor produces, it takes two thirds of the bandwidth of RGB8
+    rs2::config cfg;
+    cfg.enable_stream(RS2_STREAM_DEPTH, RS2_FORMAT_Z16);
+    cfg.enable_stream(RS2_STREAM_COLOR, RS2_FORMAT_YUYV);
+
+    server srv(port_arg.getValue(), !raw_depth_arg.getValue());
+    std::cout << "Serving on port " << port_arg.getValue() << std::endl;
+    rs2::pipeline pipe;
+    srv.run(pipe, cfg);
+    return EXIT_SUCCESS;
+}
+catch (const rs2::error & e)
+{
+    std::cerr << "RealSense error calling " << e.get_failed_function() << "(" << e.get_failed_args() << "):\n    " << e.what() << std::endl;
+    return EXIT_FAILURE;
+}
+catch (const std::exception& e)
+{
+    std::cerr << e.what() << std::endl;
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,397 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#include <librealsense2/rs.hpp> // Include RealSense Cross Platform API
+#include <librealsense2/hpp/rs_internal.hpp>
+
+#include "tclap/CmdLine.h"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace TCLAP;
+
+// The ring is a header followed by a fixed number of equally sized slots.
+// The publisher is the only writer, every slot is guarded by a sequence lock:
+// the counter is odd while the slot is written, and readers copy a slot out and
+// retry (or drop it) if the counter moved while they were copying.
+// Readers never block the publisher, so a slow subscriber only loses frames.
+
+const uint32_t ring_magic = 0x52534d46; // "RSMF"
+const uint32_t ring_version = 1;
+
+struct ring_header
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t slot_count;
+    uint32_t slot_size;                 // bytes of frame data each slot can hold
+    std::atomic<uint64_t> published;    // number of frames published so far
+};
+
+struct frame_header
+{
+    std::atomic<uint32_t> sequence;
+    uint32_t data_size;
+    uint64_t index;                     // publish index the slot holds, to detect a reader lapped by the writer
+
+    rs2_stream stream;
+    int stream_index;
+    int unique_id;
+    rs2_format format;
+    int fps;
+    int width, height, bpp, stride;     // zero for motion frames
+    rs2_intrinsics intrinsics;
+
+    int frame_number;
+    double timestamp;
+    rs2_timestamp_domain domain;
+    rs2_metadata_type metadata[RS2_FRAME_METADATA_COUNT];
+    int metadata_supported[RS2_FRAME_METADATA_COUNT];
+};
+
+class shared_ring
+{
+public:
+    // Creates the ring, replacing a stale one left over by a publisher that did not exit cleanly
+    static std::unique_ptr<shared_ring> create(const std::string& name, uint32_t slot_count, uint32_t slot_size)
+    {
+        shm_unlink(name.c_str());
+        auto fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+        if (fd < 0)
+            throw std::runtime_error("shm_open(" + name + ") failed: " + strerror(errno));
+
+        auto size = sizeof(ring_header) + size_t(slot_count) * slot_stride(slot_size);
+        if (ftruncate(fd, size) < 0)
+        {
+            close(fd);
+            throw std::runtime_error(std::string("ftruncate failed: ") + strerror(errno));
+        }
+
+        std::unique_ptr<shared_ring> ring(new shared_ring(name, fd, size, PROT_READ | PROT_WRITE, true));
+        auto header = ring->header();
+        header->slot_count = slot_count;
+        header->slot_size = slot_size;
+        header->version = ring_version;
+        std::atomic_thread_fence(std::memory_order_release);
+        header->magic = ring_magic;
+        return ring;
+    }
+
+    static std::unique_ptr<shared_ring> open(const std::string& name)
+    {
+        auto fd = shm_open(name.c_str(), O_RDONLY, 0);
+        if (fd < 0)
+            throw std::runtime_error("shm_open(" + name + ") failed: " + strerror(errno) + ", is the publisher running?");
+
+        struct stat st;
+        if (fstat(fd, &st) < 0 || size_t(st.st_size) < sizeof(ring_header))
+        {
+            close(fd);
+            throw std::runtime_error("Shared memory " + name + " is not a frame ring");
+        }
+
+        std::unique_ptr<shared_ring> ring(new shared_ring(name, fd, st.st_size, PROT_READ, false));
+        auto header = ring->header();
+        if (header->magic != ring_magic || header->version != ring_version ||
+            sizeof(ring_header) + size_t(header->slot_count) * slot_stride(header->slot_size) > ring->_size)
+            throw std::runtime_error("Shared memory " + name + " is not a compatible frame ring");
+        return ring;
+    }
+
+    ~shared_ring()
+    {
+        munmap(_memory, _size);
+        close(_fd);
+        if (_owner)
+            shm_unlink(_name.c_str());
+    }
+
+    ring_header* header() const { return reinterpret_cast<ring_header*>(_memory); }
+
+    frame_header* slot(uint64_t index) const
+    {
+        auto slot = index % header()->slot_count;
+        return reinterpret_cast<frame_header*>(static_cast<uint8_t*>(_memory) + sizeof(ring_header) + slot * slot_stride(header()->slot_size));
+    }
+
+    static uint8_t* data(frame_header* slot) { return reinterpret_cast<uint8_t*>(slot + 1); }
+
+private:
+    shared_ring(const std::string& name, int fd, size_t size, int protection, bool owner)
+        : _name(name), _fd(fd), _size(size), _owner(owner)
+    {
+        _memory = mmap(nullptr, size, protection, MAP_SHARED, fd, 0);
+        if (_memory == MAP_FAILED)
+        {
+            close(fd);
+            throw std::runtime_error(std::string("mmap failed: ") + strerror(errno));
+        }
+    }
+
+    // Slots are kept 64-byte aligned so neighbouring sequence counters do not share a cache line
+    static size_t slot_stride(uint32_t slot_size)
+    {
+        return (sizeof(frame_header) + slot_size + 63) / 64 * 64;
+    }
+
+    std::string _name;
+    int _fd;
+    size_t _size;
+    bool _owner;
+    void* _memory;
+};
+
+// Only video and motion frames are published
+uint32_t get_frame_size(const rs2::frame& f)
+{
+    if (auto vf = f.as<rs2::video_frame>())
+        return vf.get_stride_in_bytes() * vf.get_height();
+    if (f.is<rs2::motion_frame>())
+        return sizeof(rs2_vector);
+    return 0;
+}
+
+void publish(shared_ring& ring, const rs2::frame& f)
+{
+    auto header = ring.header();
+    auto size = get_frame_size(f);
+    if (!size)
+        return;
+    if (size > header->slot_size)
+    {
+        std::cerr << f.get_profile().stream_name() << " frame of " << size << " bytes does not fit a "
+                  << header->slot_size << " bytes slot, dropped" << std::endl;
+        return;
+    }
+
+    auto index = header->published.load(std::memory_order_relaxed);
+    auto slot = ring.slot(index);
+
+    auto sequence = slot->sequence.load(std::memory_order_relaxed);
+    slot->sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    auto profile = f.get_profile();
+    slot->data_size = size;
+    slot->index = index;
+    slot->stream = profile.stream_type();
+    slot->stream_index = profile.stream_index();
+    slot->unique_id = profile.unique_id();
+    slot->format = profile.format();
+    slot->fps = profile.fps();
+    slot->width = slot->height = slot->bpp = slot->stride = 0;
+    slot->intrinsics = {};
+    if (auto vf = f.as<rs2::video_frame>())
+    {
+        slot->width = vf.get_width();
+        slot->height = vf.get_height();
+        slot->bpp = vf.get_bytes_per_pixel();
+        slot->stride = vf.get_stride_in_bytes();
+        try { slot->intrinsics = profile.as<rs2::video_stream_profile>().get_intrinsics(); }
+        catch (const rs2::error&) {} // Not every stream is calibrated
+    }
+    slot->frame_number = static_cast<int>(f.get_frame_number());
+    slot->timestamp = f.get_timestamp();
+    slot->domain = f.get_frame_timestamp_domain();
+
+    std::vector<bool> supported;
+    auto metadata = f.get_frame_metadata_all(supported);
+    for (int i = 0; i < RS2_FRAME_METADATA_COUNT; i++)
+    {
+        slot->metadata[i] = metadata[i];
+        slot->metadata_supported[i] = supported[i];
+    }
+    memcpy(shared_ring::data(slot), f.get_data(), size);
+
+    slot->sequence.store(sequence + 2, std::memory_order_release);
+    header->published.store(index + 1, std::memory_order_release);
+}
+
+int run_publisher(const std::string& name, uint32_t slots, uint32_t slot_size)
+{
+    auto ring = shared_ring::create(name, slots, slot_size);
+    std::cout << "Publishing to /dev/shm" << name << ", " << slots << " slots of " << slot_size << " bytes" << std::endl;
+
+    // Frames are published straight from the sensor callbacks, without a syncer in between.
+    // The callbacks of different sensors may run concurrently, the ring has a single writer.
+    std::mutex mutex;
+    rs2::pipeline pipe;
+    pipe.start([&](rs2::frame f)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (auto fs = f.as<rs2::frameset>())
+        {
+            for (auto&& sub : fs)
+                publish(*ring, sub);
+        }
+        else
+            publish(*ring, f);
+    });
+
+    std::cout << "Press Enter to stop" << std::endl;
+    std::cin.get();
+    pipe.stop();
+    return EXIT_SUCCESS;
+}
+
+// Re-creates the published streams on a software device, so subscribers get regular rs2::frame objects
+class subscriber
+{
+public:
+    subscriber(std::function<void(rs2::frame)> callback) : _callback(callback) {}
+
+    void on_frame(const frame_header& header, std::vector<uint8_t> data)
+    {
+        auto& stream = get_stream(header);
+        for (int i = 0; i < RS2_FRAME_METADATA_COUNT; i++)
+            if (header.metadata_supported[i])
+                stream.sensor.set_metadata(static_cast<rs2_frame_metadata_value>(i), header.metadata[i]);
+
+        auto pixels = new uint8_t[data.size()];
+        memcpy(pixels, data.data(), data.size());
+        auto deleter = [](void* p) { delete[] static_cast<uint8_t*>(p); };
+
+        if (header.width)
+            stream.sensor.on_video_frame({ pixels, deleter, header.stride, header.bpp, header.timestamp, header.domain, header.frame_number, stream.profile });
+        else
+            stream.sensor.on_motion_frame({ pixels, deleter, header.timestamp, header.domain, header.frame_number, stream.profile });
+    }
+
+private:
+    struct stream_state
+    {
+        rs2::software_sensor sensor;
+        rs2::stream_profile profile;
+    };
+
+    stream_state& get_stream(const frame_header& header)
+    {
+        auto it = _streams.find(header.unique_id);
+        if (it != _streams.end())
+            return it->second;
+
+        auto sensor = _dev.add_sensor(rs2_stream_to_string(header.stream));
+        rs2::stream_profile profile;
+        if (header.width)
+            profile = sensor.add_video_stream({ header.stream, header.stream_index, header.unique_id,
+                                                header.width, header.height, header.fps, header.bpp,
+                                                header.format, header.intrinsics });
+        else
+            profile = sensor.add_motion_stream({ header.stream, header.stream_index, header.unique_id,
+                                                 header.fps, header.format, {} });
+
+        sensor.open(profile);
+        sensor.start(_callback);
+        std::cout << "Subscribed to " << profile.stream_name() << " " << rs2_format_to_string(header.format) << std::endl;
+        return _streams.emplace(header.unique_id, stream_state{ sensor, profile }).first->second;
+    }
+
+    std::function<void(rs2::frame)> _callback;
+    rs2::software_device _dev;
+    std::map<int, stream_state> _streams;
+};
+
+int run_subscriber(const std::string& name)
+{
+    auto ring = shared_ring::open(name);
+    auto header = ring->header();
+
+    std::map<std::string, int> received;
+    std::mutex mutex;
+    subscriber sub([&](rs2::frame f)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        received[f.get_profile().stream_name()]++;
+    });
+
+    auto next = header->published.load(std::memory_order_acquire);
+    auto lost = 0ull;
+    auto last_report = std::chrono::steady_clock::now();
+
+    frame_header copy;
+    std::vector<uint8_t> data;
+    while (true)
+    {
+        auto published = header->published.load(std::memory_order_acquire);
+        if (published - next > header->slot_count)
+        {
+            // Lapped by the publisher, the oldest slots were already overwritten
+            lost += published - next - header->slot_count;
+            next = published - header->slot_count;
+        }
+
+        for (; next < published; ++next)
+        {
+            auto slot = ring->slot(next);
+            auto sequence = slot->sequence.load(std::memory_order_acquire);
+            if (sequence % 2 == 0)
+            {
+                memcpy(static_cast<void*>(&copy), slot, sizeof(copy));
+                data.resize(std::min(copy.data_size, header->slot_size));
+                memcpy(data.data(), shared_ring::data(slot), data.size());
+                std::atomic_thread_fence(std::memory_order_acquire);
+            }
+            if (sequence % 2 || slot->sequence.load(std::memory_order_relaxed) != sequence || copy.index != next)
+            {
+                ++lost;
+                continue;
+            }
+            sub.on_frame(copy, data);
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        if (now - last_report > std::chrono::seconds(1))
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (auto&& kvp : received)
+                std::cout << kvp.first << ": " << kvp.second << " fps   ";
+            std::cout << "lost: " << lost << std::endl;
+            received.clear();
+            last_report = now;
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+int main(int argc, char * argv[]) try
+{
+    CmdLine cmd("librealsense rs-shared-memory example tool", ' ', RS2_API_VERSION_STR);
+
+    SwitchArg subscribe_arg("s", "subscribe", "Receive the frames of a running publisher instead of streaming a camera");
+    ValueArg<std::string> name_arg("n", "name", "Name of the shared memory frame ring", false, "/realsense", "string");
+    ValueArg<uint32_t> slots_arg("k", "slots", "Number of frames the ring holds", false, 16, "integer");
+    ValueArg<uint32_t> slot_size_arg("b", "slot-size", "Largest frame the ring accepts, in bytes", false, 1920 * 1080 * 4, "integer");
+    cmd.add(subscribe_arg);
+    cmd.add(name_arg);
+    cmd.add(slots_arg);
+    cmd.add(slot_size_arg);
+    cmd.parse(argc, argv);
+
+    if (subscribe_arg.getValue())
+        return run_subscriber(name_arg.getValue());
+    return run_publisher(name_arg.getValue(), slots_arg.getValue(), slot_size_arg.getValue());
+}
+catch (const rs2::error & e)
+{
+    std::cerr << "RealSense error calling " << e.get_failed_function() << "(" << e.get_failed_args() << "):\n    " << e.what() << std::endl;
+    return EXIT_FAILURE;
+}
+catch (const std::exception& e)
+{
+    std::cerr << e.what() << std::endl;
+    return EXIT_FAILURE;
+}
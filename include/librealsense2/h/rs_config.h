@@ -161,6 +161,18 @@ extern "C" {
     */
     void rs2_config_disable_all_streams(rs2_config* config, rs2_error ** error);
 
+    /**
+    * Resolve the streams within the USB bandwidth of the device. The streams may use the given fraction of the capacity
+    * of the USB link, less what the open sensors of other devices connected through the same USB root port take.
+    * Requests with wildcards are completed with the first profiles that still fit, and a device whose requested streams
+    * can't fit is not selected. Devices not connected over USB are not limited.
+    *
+    * \param[in] config       A pointer to an instance of a config
+    * \param[in] utilization  The fraction of the link capacity the streams may use, in [0, 1], 0 removes the limit
+    * \param[out] error       if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+    */
+    void rs2_config_limit_usb_bandwidth(rs2_config* config, float utilization, rs2_error ** error);
+
     /**
     * Resolve the configuration filters, to find a matching device and streams profiles.
     * The method resolves the user configuration filters for the device and streams, and combines them with the requirements of
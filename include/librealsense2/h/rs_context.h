@@ -63,6 +63,74 @@ rs2_device* rs2_context_add_device(rs2_context* ctx, const char* file, rs2_error
  */
 void rs2_context_remove_device(rs2_context* ctx, const char* file, rs2_error** error);
 
+/**
+ * Configures the worker threads that run the library's internal dispatchers (device watchers, notifications, playback and so on).
+ * The pool is shared by all contexts in the process, LRS_THREAD_POOL_THREADS and LRS_THREAD_POOL_CPUS provide its initial settings
+ * \param[in]  ctx          Object representing librealsense session
+ * \param[in]  threads      Number of workers kept for regular work, 0 selects a default based on the number of cores
+ * \param[in]  cpus         Cores the workers are pinned to round-robin, may be null when cpus_count is 0
+ * \param[in]  cpus_count   Number of entries in cpus, 0 leaves the affinity to the operating system
+ * \param[out] error        If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ */
+void rs2_context_set_thread_pool(rs2_context* ctx, int threads, const int* cpus, int cpus_count, rs2_error** error);
+
+/**
+ * Configures the threads of a category, as the library starts them: adding them to a set of cores and raising them to real-time priority.
+ * The configuration is shared by all contexts in the process. The dispatcher workers apply it right away, the other threads when the streams start
+ * \param[in]  ctx          Object representing librealsense session
+ * \param[in]  category     The threads to configure
+ * \param[in]  cpus         Cores the threads may run on, may be null when cpus_count is 0
+ * \param[in]  cpus_count   Number of entries in cpus, 0 leaves the affinity to the operating system
+ * \param[in]  priority     SCHED_FIFO priority from 1 to 99, 0 leaves the scheduling policy unchanged. Requires the matching privileges
+ * \param[out] error        If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ */
+void rs2_context_set_thread_scheduling(rs2_context* ctx, rs2_thread_category category, const int* cpus, int cpus_count, int priority, rs2_error** error);
+
+/**
+ * Configures the threads of several categories from JSON, an object keyed by category with optional "cpus" and "priority" fields,
+ * e.g. {"capture": {"cpus": [2, 3], "priority": 80}, "dispatcher": {"cpus": [0, 1]}}. LRS_THREAD_SCHEDULING may name such a file instead
+ * \param[in]  ctx          Object representing librealsense session
+ * \param[in]  json         The configuration, nothing is applied when any entry is invalid
+ * \param[out] error        If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ */
+void rs2_context_load_thread_scheduling(rs2_context* ctx, const char* json, rs2_error** error);
+
+/**
+ * Limits the frame memory of the process, shared by all contexts. Before a new frame buffer would take the memory beyond the budget, the buffers
+ * kept for reuse are freed, and only when the frames alive still take too much is the frame dropped. The budget is soft, concurrent allocations
+ * may exceed it by a few frames
+ * \param[in]  ctx          Object representing librealsense session
+ * \param[in]  bytes        The budget, 0 lifts it. Pooled buffers beyond a new budget are freed right away
+ * \param[out] error        If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ */
+void rs2_context_set_memory_budget(rs2_context* ctx, unsigned long long bytes, rs2_error** error);
+
+/**
+ * Keeps what the devices report when they're opened, such as their calibration tables and stream profiles, in a directory so that later processes
+ * don't query them again. Entries are specific to the serial and the firmware version of a device, and are discarded when its GVD changes.
+ * Shared by all contexts, takes effect for the devices created after the call. LRS_DEVICE_CACHE may name the directory instead
+ * \param[in]  ctx          Object representing librealsense session
+ * \param[in]  directory    An existing directory the process can write to, null or empty turns the cache off
+ * \param[out] error        If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ */
+void rs2_context_set_device_cache(rs2_context* ctx, const char* directory, rs2_error** error);
+
+/**
+ * Retrieves the frame memory held by the sensors of the devices of a context
+ * \param[in]  ctx          Object representing librealsense session
+ * \param[out] usage        The memory of the context
+ * \param[out] error        If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ */
+void rs2_context_get_memory_usage(rs2_context* ctx, rs2_memory_usage* usage, rs2_error** error);
+
+/**
+ * Retrieves the frame memory held by the process, of all the contexts and the processing blocks. This is the memory the budget applies to
+ * \param[in]  ctx          Object representing librealsense session
+ * \param[out] usage        The memory of the process
+ * \param[out] error        If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ */
+void rs2_context_get_total_memory_usage(rs2_context* ctx, rs2_memory_usage* usage, rs2_error** error);
+
 /**
 * create a static snapshot of all connected devices at the time of the call
 * \param context     Object representing librealsense session
@@ -86,6 +154,14 @@ rs2_device_list* rs2_query_devices(const rs2_context* context, rs2_error** error
 */
 rs2_device_list* rs2_query_devices_ex(const rs2_context* context, int product_mask, rs2_error** error);
 
+/** \brief Reconnections of a device, as seen by a device hub */
+typedef struct rs2_reconnect_stats
+{
+    int reconnects;             /**< Number of times the device was listed again after it was disconnected */
+    float last_latency_ms;      /**< Time the device was disconnected for, the last time */
+    float max_latency_ms;       /**< Longest time the device was disconnected for */
+} rs2_reconnect_stats;
+
 /**
 * \brief Creates RealSense device_hub .
 * \param[in] context The context for the device hub
@@ -119,6 +195,25 @@ rs2_device* rs2_device_hub_wait_for_device(const rs2_device_hub* hub, rs2_error*
 */
 int rs2_device_hub_is_device_connected(const rs2_device_hub* hub, const rs2_device* device, rs2_error** error);
 
+/**
+* Waits for the device of the serial number. Only the devices of the serial that connect wake the calling thread
+* \param[in] hub         The device hub object
+* \param[in] serial      Serial number of the requested device
+* \param[in] timeout_ms  Max time in milliseconds to wait for the device
+* \param[out] error  If non-null, receives any error that occurs during this call, otherwise, errors are ignored.
+* \return            device object
+*/
+rs2_device* rs2_device_hub_wait_for_device_by_serial(const rs2_device_hub* hub, const char* serial, unsigned int timeout_ms, rs2_error** error);
+
+/**
+* Retrieves the reconnections of the device of the serial number since the hub was created
+* \param[in] hub     The device hub object
+* \param[in] serial  Serial number of the device
+* \param[out] stats  Number of reconnections and their latency
+* \param[out] error  If non-null, receives any error that occurs during this call, otherwise, errors are ignored.
+*/
+void rs2_device_hub_get_reconnect_stats(const rs2_device_hub* hub, const char* serial, rs2_reconnect_stats* stats, rs2_error** error);
+
 
 #ifdef __cplusplus
 }
@@ -80,6 +80,16 @@ int rs2_supports_device_info(const rs2_device* device, rs2_camera_info info, rs2
  */
 void rs2_hardware_reset(const rs2_device * device, rs2_error ** error);
 
+/**
+ * Retrieve the USB bandwidth the device has left for new streams: the given fraction of the capacity of its link,
+ * less what the open sensors of other devices connected through the same USB root port take
+ * \param[in]  device       The RealSense device
+ * \param[in]  utilization  The fraction of the link capacity the streams may use, in [0, 1]
+ * \param[out] error        If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ * \return                  Bytes per second, or -1 when the link of the device is unknown, such as for a playback device
+ */
+long long rs2_get_available_usb_bandwidth(const rs2_device* device, float utilization, rs2_error** error);
+
 /**
 * Send raw data to device
 * \param[in]  device                    RealSense device to send data to
@@ -90,6 +100,16 @@ void rs2_hardware_reset(const rs2_device * device, rs2_error ** error);
 */
 const rs2_raw_data_buffer* rs2_send_and_receive_raw_data(rs2_device* device, void* raw_data_to_send, unsigned size_of_raw_data_to_send, rs2_error** error);
 
+/**
+* Send several raw commands to device back to back, locking and powering the device once for all of them
+* \param[in]  device                    RealSense device to send data to
+* \param[in]  raw_data_to_send          The commands, one after the other, each one preceded by its size in bytes as a 32 bit unsigned integer
+* \param[in]  size_of_raw_data_to_send  Size of raw_data_to_send in bytes
+* \param[out] error                     If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return                               Device's responses in the order of the commands, laid out as the commands are, in a rs2_raw_data_buffer which should be released by rs2_delete_raw_data
+*/
+const rs2_raw_data_buffer* rs2_send_and_receive_raw_data_batch(rs2_device* device, void* raw_data_to_send, unsigned size_of_raw_data_to_send, rs2_error** error);
+
 /**
 * Test if the given device can be extended to the requested extension.
 * \param[in]  device    Realsense device
@@ -20,6 +20,7 @@ typedef enum rs2_timestamp_domain
 {
     RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, /**< Frame timestamp was measured in relation to the camera clock */
     RS2_TIMESTAMP_DOMAIN_SYSTEM_TIME,    /**< Frame timestamp was measured in relation to the OS system clock */
+    RS2_TIMESTAMP_DOMAIN_GLOBAL_TIME,    /**< Frame timestamp was measured in relation to the camera clock and mapped onto the OS system clock */
     RS2_TIMESTAMP_DOMAIN_COUNT           /**< Number of enumeration values. Not a valid input: intended to be used in for-loops. */
 } rs2_timestamp_domain;
 const char* rs2_timestamp_domain_to_string(rs2_timestamp_domain info);
@@ -109,6 +110,26 @@ typedef struct rs2_pose
 */
 rs2_metadata_type rs2_get_frame_metadata(const rs2_frame* frame, rs2_frame_metadata_value frame_metadata, rs2_error** error);
 
+/**
+* retrieve metadata from frame handle without reporting errors, for attributes the frame may not support
+* \param[in] frame           handle returned from a callback
+* \param[in] frame_metadata  the rs2_frame_metadata whose latest frame we are interested in
+* \param[out] value          receives the metadata value when the frame supports the attribute
+* \return                    true if the frame supports the attribute and the value was retrieved
+*/
+int rs2_try_get_frame_metadata(const rs2_frame* frame, rs2_frame_metadata_value frame_metadata, rs2_metadata_type* value);
+
+/**
+* retrieve all the metadata attributes of a frame in a single call, the frame metadata is parsed only once
+* \param[in] frame      handle returned from a callback
+* \param[out] values    array of count values, indexed by rs2_frame_metadata_value, unsupported attributes are set to 0
+* \param[out] supported optional array of count flags, set to 1 for the attributes the frame supports and to 0 otherwise
+* \param[in] count      number of attributes to retrieve, up to RS2_FRAME_METADATA_COUNT
+* \param[out] error     if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return               the number of supported attributes
+*/
+int rs2_get_frame_metadata_all(const rs2_frame* frame, rs2_metadata_type* values, int* supported, int count, rs2_error** error);
+
 /**
 * determine device metadata
 * \param[in] frame             handle returned from a callback
@@ -144,6 +165,15 @@ rs2_time_t rs2_get_frame_timestamp(const rs2_frame* frame, rs2_error** error);
 */
 unsigned long long rs2_get_frame_number(const rs2_frame* frame, rs2_error** error);
 
+/**
+* retrieve the DMA buffer file descriptor backing the frame data, for zero-copy import into GPU or encoder APIs
+* The descriptor is owned by the library and remains valid for as long as the frame is not released
+* \param[in] frame      handle returned from a callback
+* \param[out] error     if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return               the DMA buffer file descriptor, or -1 if the frame data is not backed by an exported buffer
+*/
+int rs2_get_frame_dmabuf_fd(const rs2_frame* frame, rs2_error** error);
+
 /**
 * retrieve data from frame handle
 * \param[in] frame      handle returned from a callback
@@ -225,6 +255,17 @@ rs2_vertex* rs2_get_frame_vertices(const rs2_frame* frame, rs2_error** error);
 */
 void rs2_export_to_ply(const rs2_frame* frame, const char* fname, rs2_frame* texture, rs2_error** error);
 
+/**
+* When called on Points frame type, this method creates a ply file of the model with the given file name.
+* The faces joining neighbouring vertices can be left out, which makes the export of large point clouds considerably faster.
+* \param[in] frame       Points frame
+* \param[in] fname       The name for the ply file
+* \param[in] texture     Texture frame, may be null
+* \param[in] with_faces  Non-zero to write the faces along with the vertices
+* \param[out] error      If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_export_to_ply_ex(const rs2_frame* frame, const char* fname, rs2_frame* texture, int with_faces, rs2_error** error);
+
 /**
 * When called on Points frame type, this method returns a pointer to an array of texture coordinates per vertex
 * Each coordinate represent a (u,v) pair within [0,1] range, to be mapped to texture image
@@ -242,6 +283,22 @@ rs2_pixel* rs2_get_frame_texture_coordinates(const rs2_frame* frame, rs2_error**
 */
 int rs2_get_frame_points_count(const rs2_frame* frame, rs2_error** error);
 
+/**
+* When called on a sparse Points frame that records pixel indices, this method returns the index of the depth pixel each vertex was computed from
+* \param[in] frame       Points frame
+* \param[out] error      If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return                Pointer to an array of y * width + x indices, one per vertex, or null when the frame does not record them. Lifetime is managed by the frame
+*/
+const int* rs2_get_frame_pixel_indices(const rs2_frame* frame, rs2_error** error);
+
+/**
+* When called on a Points frame computed with RS2_OPTION_POINTCLOUD_COLORS, this method returns the color of each vertex, sampled from the mapped texture
+* \param[in] frame       Points frame
+* \param[out] error      If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return                Pointer to an array of R, G, B bytes, three per vertex, or null when the frame does not record them. Lifetime is managed by the frame
+*/
+const unsigned char* rs2_get_frame_vertex_colors(const rs2_frame* frame, rs2_error** error);
+
 /**
 * Returns the stream profile that was used to start the stream of this frame
 * \param[in] frame       frame reference, owned by the user
@@ -309,6 +366,16 @@ rs2_frame* rs2_allocate_composite_frame(rs2_source* source, rs2_frame** frames,
 */
 rs2_frame* rs2_extract_frame(rs2_frame* composite, int index, rs2_error** error);
 
+/**
+* Borrow a frame from within a composite frame, without adding a reference to it
+* \param[in] composite   Composite frame
+* \param[in] index       Index of the frame within the composite frame
+* \param[out] error      If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return                the frame, valid as long as the composite frame is. It must not be released,
+*                        call rs2_frame_add_ref to keep it beyond the composite frame
+*/
+rs2_frame* rs2_get_embedded_frame(const rs2_frame* composite, int index, rs2_error** error);
+
 /**
 * Get number of frames embedded within a composite frame
 * \param[in] composite   Composite input frame
@@ -194,6 +194,16 @@ void rs2_software_sensor_on_pose_frame(rs2_sensor* sensor, rs2_software_pose_fra
 */
 void rs2_software_sensor_set_metadata(rs2_sensor* sensor, rs2_frame_metadata_value value, rs2_metadata_type type, rs2_error** error);
 
+/**
+* Set several frame metadata values for the upcoming frames at once, the frames carry them without further copies per value
+* \param[in] sensor the software sensor
+* \param[in] keys metadata keys to set
+* \param[in] values metadata values, one per key
+* \param[in] count number of keys and values
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_software_sensor_set_metadata_values(rs2_sensor* sensor, const rs2_frame_metadata_value* keys, const rs2_metadata_type* values, int count, rs2_error** error);
+
 /**
  * Set the wanted matcher type that will be used by the syncer
  * \param[in] dev the software device
@@ -243,6 +253,66 @@ void rs2_software_sensor_add_read_only_option(rs2_sensor* sensor, rs2_option opt
  * \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
  */
 void rs2_software_sensor_update_read_only_option(rs2_sensor* sensor, rs2_option option, float val, rs2_error** error);
+
+/**
+* Create a serializer, turning frames into messages to send to other processes or hosts
+* A message holds the stream profile, the intrinsics, the metadata and the data of a frame, or of every frame of a frameset
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return           the serializer, to delete with rs2_delete_frame_serializer
+*/
+rs2_frame_serializer* rs2_create_frame_serializer(rs2_error** error);
+
+/**
+* Serialize a frame or a frameset, without copying the frame data
+* \param[in] serializer   the serializer
+* \param[in] frame        the frame or frameset, the serializer keeps a reference to it until the next call
+* \param[out] segments    receives the segments of the message, to send in order, such as with writev.
+*                          The headers are owned by the serializer and the data by the frames, both valid until the next call
+* \param[out] error       if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return                 the number of segments
+*/
+int rs2_serialize_frame(rs2_frame_serializer* serializer, rs2_frame* frame, const rs2_frame_segment** segments, rs2_error** error);
+
+/**
+* Delete a serializer, and release the frames of its last message
+* \param[in] serializer   the serializer
+*/
+void rs2_delete_frame_serializer(rs2_frame_serializer* serializer);
+
+/**
+* Create a deserializer, recreating the frames of serialized messages on a software device
+* A sensor of the device is created and started for each stream of the sender on its first frame, the frames of a frameset arrive one by one
+* \param[in] dev       the software device, see rs2_create_software_device
+* \param[in] on_frame  function pointer to register as per-frame callback
+* \param[in] user      auxiliary data the user wishes to receive together with every frame callback
+* \param[out] error    if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return              the deserializer, to delete with rs2_delete_frame_deserializer
+*/
+rs2_frame_deserializer* rs2_create_frame_deserializer(rs2_device* dev, rs2_frame_callback_ptr on_frame, void* user, rs2_error** error);
+
+/**
+* Create a deserializer, recreating the frames of serialized messages on a software device
+* \param[in] dev       the software device, see rs2_create_software_device
+* \param[in] callback  callback object created from c++ application. ownership over the callback object is moved into the deserializer
+* \param[out] error    if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return              the deserializer, to delete with rs2_delete_frame_deserializer
+*/
+rs2_frame_deserializer* rs2_create_frame_deserializer_cpp(rs2_device* dev, rs2_frame_callback* callback, rs2_error** error);
+
+/**
+* Recreate the frames of a message, delivered to the callback of the deserializer before the call returns
+* \param[in] deserializer the deserializer
+* \param[in] message      a whole message, as the concatenation of the segments of rs2_serialize_frame. The frame data is copied out of it
+* \param[in] size         bytes of the message
+* \param[out] error       if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_deserialize_frame(rs2_frame_deserializer* deserializer, const void* message, unsigned long long size, rs2_error** error);
+
+/**
+* Delete a deserializer, and stop the sensors it created
+* \param[in] deserializer the deserializer
+*/
+void rs2_delete_frame_deserializer(rs2_frame_deserializer* deserializer);
 #ifdef __cplusplus
 }
 #endif
@@ -68,6 +68,44 @@ extern "C" {
         RS2_OPTION_STREAM_FORMAT_FILTER, /**< Select a stream format to process */
         RS2_OPTION_STREAM_INDEX_FILTER, /**< Select a stream index to process */
         RS2_OPTION_EMITTER_ON_OFF, /**< When supported, this option make the camera to switch the emitter state every frame. 0 for disabled, 1 for enabled */
+        RS2_OPTION_FRAME_POOL_HITS, /**< Number of frames that reused a recycled frame buffer since the sensor was created */
+        RS2_OPTION_FRAME_POOL_MISSES, /**< Number of frames that required allocating a new frame buffer since the sensor was created */
+        RS2_OPTION_MAX_BORROWED_FRAMES, /**< Maximum number of frames that may reference backend buffers directly before new frames are copied, 0 to always copy */
+        RS2_OPTION_PROCESSING_THREADS, /**< Number of threads a processing block splits each frame across, 0 to use all hardware threads */
+        RS2_OPTION_SPARSE_POINTCLOUD, /**< Pointcloud output: 0 for all pixels, 1 for valid vertices only, 2 for valid vertices with the pixel index of each, 3 for all pixels of the tiles whose depth changed, with the pixel index of each */
+        RS2_OPTION_POINTCLOUD_STRIDE, /**< Subsampling step along both image axes applied to sparse pointclouds */
+        RS2_OPTION_HISTOGRAM_EQUALIZATION_INTERVAL, /**< Number of frames the colorizer reuses a histogram equalization curve for, 1 to equalize every frame */
+        RS2_OPTION_GLOBAL_TIME_ENABLED, /**< Enable / disable mapping hardware timestamps onto the host clock, reported as RS2_TIMESTAMP_DOMAIN_GLOBAL_TIME */
+        RS2_OPTION_AUTO_EXPOSURE_SAMPLE_STRIDE, /**< Subsampling step along both image axes of the pixels the software Auto-Exposure histogram counts */
+        RS2_OPTION_AUTO_EXPOSURE_SKIP_FRAMES, /**< Number of frames the software Auto-Exposure ignores between two analyzed frames */
+        RS2_OPTION_SYNC_MATCH_KEY, /**< Frame property a multi-device syncer matches frames on: 0 for the frame counters, 1 for the timestamps */
+        RS2_OPTION_FRAMES_DROPPED, /**< Number of frames dropped since the sensor was created, because the application held on to the whole frames queue */
+        RS2_OPTION_FRAMES_QUEUE_MEMORY_LIMIT, /**< Memory in MB the frames held beyond RS2_OPTION_FRAMES_QUEUE_SIZE may take before frames are dropped, 0 drops them right away */
+        RS2_OPTION_LOW_LATENCY_POSE, /**< Deliver the poses on the thread receiving them from the device, skipping the completion queue of the tracking library */
+        RS2_OPTION_DISPARITY_FIXED_POINT, /**< Output the disparity as 16-bit fixed point (RS2_FORMAT_DISPARITY16) instead of RS2_FORMAT_DISPARITY32 */
+        RS2_OPTION_LAZY_UNPACKING, /**< When frames that need a format conversion are unpacked: 0 on arrival, 1 on the first access to their data, 2 on worker threads ahead of it, 3 on worker threads before their delivery, in order */
+        RS2_OPTION_CROP_LEFT, /**< Left edge of the region a threshold-crop block keeps, as a fraction of the frame width */
+        RS2_OPTION_CROP_TOP, /**< Top edge of the region a threshold-crop block keeps, as a fraction of the frame height */
+        RS2_OPTION_CROP_RIGHT, /**< Right edge of the region a threshold-crop block keeps, as a fraction of the frame width */
+        RS2_OPTION_CROP_BOTTOM, /**< Bottom edge of the region a threshold-crop block keeps, as a fraction of the frame height */
+        RS2_OPTION_VOXEL_SIZE, /**< Edge in meters of the cells a voxel-grid filter merges the vertices of */
+        RS2_OPTION_NORMAL_MAX_DEPTH_CHANGE, /**< Largest depth difference to a neighbor used by normal estimation, as a fraction of the depth of the vertex */
+        RS2_OPTION_KERNEL_BUFFERS, /**< Number of kernel buffers each stream of the sensor captures into, applied when the streams are next opened */
+        RS2_OPTION_BUFFERING_POLICY, /**< How the kernel buffers are sized: 0 as set by RS2_OPTION_KERNEL_BUFFERS, 1 adapted favoring latency, 2 adapted favoring throughput */
+        RS2_OPTION_POINTCLOUD_COLORS, /**< Output with every vertex its RGB color, sampled bilinearly from the mapped texture */
+        RS2_OPTION_POINTCLOUD_WORLD_FRAME, /**< Output the vertices in the world frame of the pose frames passed to the pointcloud, at the pose of the depth frame timestamp */
+        RS2_OPTION_CALLBACK_QUEUE_SIZE, /**< Frames each stream may have waiting for the callback, called on worker threads in parallel for the streams, 0 to call it on the thread the frames arrive on */
+        RS2_OPTION_RATE_DIVISOR, /**< Number of frames of each stream a rate limiter keeps one of */
+        RS2_OPTION_TARGET_FPS, /**< Largest rate in Hz of the frames of each stream a rate limiter keeps, 0 for no limit */
+        RS2_OPTION_TSDF_TRUNCATION_DISTANCE, /**< Distance in meters around the surface a TSDF integrator keeps the signed distance within */
+        RS2_OPTION_TSDF_MAX_WEIGHT, /**< Number of depth frames a voxel of a TSDF integrator averages before favoring the newer ones */
+        RS2_OPTION_MESH_MAX_DEPTH_STEP, /**< Largest depth difference in meters between neighboring vertices a mesh generator joins by a face */
+        RS2_OPTION_POINTCLOUD_TILE_TOLERANCE, /**< Largest depth change, in depth units, a tile of a changed tiles pointcloud is not output for */
+        RS2_OPTION_GRID_CELL_SIZE, /**< Edge in meters of the cells of a height map */
+        RS2_OPTION_GRID_CELLS, /**< Number of cells along each side of the square grid of a height map, centered on the origin of the ground frame */
+        RS2_OPTION_GRID_OCCUPANCY, /**< Output an occupancy grid (RS2_FORMAT_OCCUPANCY_GRID) rather than the heights (RS2_FORMAT_HEIGHT_MAP) of a height map */
+        RS2_OPTION_OBSTACLE_MIN_HEIGHT, /**< Height in meters above the ground from which the points of a height map make their cell occupied */
+        RS2_OPTION_OBSTACLE_MAX_HEIGHT, /**< Height in meters above the ground beyond which a height map leaves the points out, like those of a ceiling */
         RS2_OPTION_COUNT /**< Number of enumeration values. Not a valid input: intended to be used in for-loops. */
     } rs2_option;
     const char* rs2_option_to_string(rs2_option option);
@@ -122,6 +160,15 @@ extern "C" {
     */
     float rs2_get_option(const rs2_options* options, rs2_option option, rs2_error** error);
 
+    /**
+    * read option value without reporting errors, for polling options that may not be supported
+    * \param[in] options  the options container
+    * \param[in] option   option id to be queried
+    * \param[out] value   receives the value of the option when it is supported
+    * \return true if the option is supported and was read, an unsupported option doesn't go through the error path
+    */
+    int rs2_try_get_option(const rs2_options* options, rs2_option option, float* value);
+
     /**
     * write new value to sensor option
     * \param[in] sensor     the RealSense sensor
@@ -171,6 +218,75 @@ extern "C" {
     */
     const char* rs2_get_option_value_description(const rs2_options* options, rs2_option option, float value, rs2_error ** error);
 
+    /** \brief State of one supported option, as read by rs2_get_options_snapshot */
+    typedef struct rs2_option_value
+    {
+        rs2_option id;
+        int has_value;      /**< 0 if the option could not be read, the value, range and read-only flag are then left as 0 */
+        int is_read_only;
+        float value;
+        float min;
+        float max;
+        float step;
+        float def;
+    } rs2_option_value;
+
+    /**
+    * read the value, range and read-only flag of all the supported options in a single pass, keeping the device powered up for all of them
+    * \param[in] options  the options container
+    * \param[out] values  receives the state of up to count supported options, ordered by option id
+    * \param[in] count    number of entries values can hold, RS2_OPTION_COUNT is always enough
+    * \param[out] error   if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+    * \return number of supported options
+    */
+    int rs2_get_options_snapshot(const rs2_options* options, rs2_option_value* values, int count, rs2_error** error);
+
+    typedef struct rs2_option_changed_callback rs2_option_changed_callback;
+    typedef void (*rs2_option_changed_callback_ptr)(rs2_option, float, void*);
+
+    /**
+    * serve reads of an option from its last known value instead of querying the device on every call
+    * the value is refreshed whenever the option is set, and from the frame metadata for the options it reports (exposure, gain, laser power)
+    * \param[in] options  the options container
+    * \param[in] option   option id to be cached
+    * \param[in] enable   1 to enable the cache, 0 to query the device on every read
+    * \param[out] error   if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+    */
+    void rs2_set_option_cache(const rs2_options* options, rs2_option option, int enable, rs2_error** error);
+
+    /**
+    * register a callback invoked with the new value whenever a set, a read or, for cached options, the frame metadata changes the option value
+    * \param[in] options   the options container
+    * \param[in] option    option id to be observed
+    * \param[in] callback  function pointer, may be invoked from the frame callback thread
+    * \param[in] user      custom pointer the callback will receive
+    * \param[out] error    if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+    */
+    void rs2_set_option_changed_callback(const rs2_options* options, rs2_option option, rs2_option_changed_callback_ptr callback, void* user, rs2_error** error);
+
+    /**
+    * register a callback invoked with the new value whenever a set, a read or, for cached options, the frame metadata changes the option value
+    * \param[in] options   the options container
+    * \param[in] option    option id to be observed
+    * \param[in] callback  callback object created from c++ application. ownership over the callback object is moved into the relevant subsystem
+    * \param[out] error    if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+    */
+    void rs2_set_option_changed_callback_cpp(const rs2_options* options, rs2_option option, rs2_option_changed_callback* callback, rs2_error** error);
+
+    typedef struct rs2_option_set_callback rs2_option_set_callback;
+
+    /**
+    * write option value to the device without waiting for the write. writes still pending when the option is set again are replaced by the new value,
+    * and several fields of one device control set together are sent in a single write
+    * \param[in] options   the options container
+    * \param[in] option    option id to be written
+    * \param[in] value     new value for the option
+    * \param[in] callback  callback object created from c++ application, may be null. invoked with the outcome of the write that sent the value, or of the newer
+    *                      one that replaced it, and receives the ownership of the error. ownership over the callback object is moved into the relevant subsystem
+    * \param[out] error    if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+    */
+    void rs2_set_option_async(const rs2_options* options, rs2_option option, float value, rs2_option_set_callback* callback, rs2_error** error);
+
 #ifdef __cplusplus
 }
 #endif
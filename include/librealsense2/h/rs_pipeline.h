@@ -41,6 +41,46 @@ extern "C" {
     */
     void rs2_pipeline_stop(rs2_pipeline* pipe, rs2_error ** error);
 
+    /**
+    * Pause the pipeline streaming.
+    * The pipeline stops delivering samples, but keeps the device streams configured, so that \c resume() restarts them
+    * without renegotiating the streams with the device. Frames are neither queued nor delivered to the callback while paused,
+    * and \c wait_for_frames() raises an exception. Pausing a paused pipeline has no effect.
+    * The method takes effect only after \c start() was called, otherwise an exception is raised.
+    * \param[in] pipe  pipeline
+    * \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+    */
+    void rs2_pipeline_pause(rs2_pipeline* pipe, rs2_error ** error);
+
+    /**
+    * Resume the streaming of a paused pipeline. Resuming a pipeline that is not paused has no effect.
+    * \param[in] pipe  pipeline
+    * \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+    */
+    void rs2_pipeline_resume(rs2_pipeline* pipe, rs2_error ** error);
+
+    /**
+    * Switch the streams of a started pipeline to a new configuration.
+    * When the configuration resolves on the active device, the sensors streaming the same profiles in both configurations
+    * keep streaming, and only the other sensors are reopened. Otherwise, and for playback or recording, the pipeline is
+    * stopped and started again. The frame callback provided to \c start() is kept, and a paused pipeline stays paused.
+    * \param[in] pipe    a pointer to an instance of the pipeline
+    * \param[in] config  A rs2::config with requested filters on the pipeline configuration
+    * \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+    * \return            The new pipeline device and streams profile
+    */
+    rs2_pipeline_profile* rs2_pipeline_reconfigure(rs2_pipeline* pipe, rs2_config* config, rs2_error ** error);
+
+    /**
+    * Wait until every stream of the pipeline delivered its first frame since the pipeline was started, resumed or reconfigured.
+    * The method takes effect only after \c start() was called, otherwise an exception is raised.
+    * \param[in] pipe       the pipeline
+    * \param[in] timeout_ms Max time in milliseconds to wait
+    * \param[out] error     if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+    * \return               true when all the streams delivered a frame before the timeout, false otherwise
+    */
+    int rs2_pipeline_wait_for_streams(rs2_pipeline* pipe, unsigned int timeout_ms, rs2_error ** error);
+
     /**
     * Wait until a new set of frames becomes available.
     * The frames set includes time-synchronized frames of each enabled stream in the pipeline.
@@ -198,6 +238,59 @@ extern "C" {
     */
     rs2_pipeline_profile* rs2_pipeline_start_with_config_and_callback_cpp(rs2_pipeline* pipe, rs2_config* config, rs2_frame_callback* callback, rs2_error ** error);
 
+    /**
+    * Set a user-provided allocator for the frame buffers of every sensor the pipeline streams from.
+    * The allocator is applied on the next \c start(), to the sensors that support custom frame allocation
+    *
+    * \param[in] pipe       A pointer to an instance of the pipeline
+    * \param[in] allocate   function pointer invoked to obtain a buffer of the requested size in bytes
+    * \param[in] deallocate function pointer invoked to return a buffer previously obtained from allocate
+    * \param[in] user       auxiliary data the user wishes to receive together with every allocation call
+    * \param[out] error     If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+    */
+    void rs2_pipeline_set_frame_allocator(rs2_pipeline* pipe, rs2_frame_allocate_ptr allocate, rs2_frame_deallocate_ptr deallocate, void* user, rs2_error ** error);
+
+    /**
+    * Set a user-provided allocator for the frame buffers of every sensor the pipeline streams from
+    *
+    * \param[in] pipe       A pointer to an instance of the pipeline
+    * \param[in] allocator  allocator object created from c++ application. ownership over the allocator object is moved into the pipeline
+    * \param[out] error     If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+    */
+    void rs2_pipeline_set_frame_allocator_cpp(rs2_pipeline* pipe, rs2_frame_allocator* allocator, rs2_error ** error);
+
+    /**
+    * Set how \c wait_for_frames() waits for a frameset. It spins, then yields its core, and only then sleeps until it's signaled,
+    * which shortens the wakeup at the cost of a busy core. Both durations to 0 is the default. Takes effect immediately
+    *
+    * \param[in] pipe       A pointer to an instance of the pipeline
+    * \param[in] spin_us    Time to spin before yielding, in microseconds
+    * \param[in] yield_us   Time to yield before sleeping, in microseconds
+    * \param[out] error     If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+    */
+    void rs2_pipeline_set_wait_strategy(rs2_pipeline* pipe, unsigned int spin_us, unsigned int yield_us, rs2_error ** error);
+
+    /**
+    * Set how many framesets or frames of each stream group may wait for the callback of the pipeline. With a queue size, the
+    * callback is called on worker threads: in order for each group, in parallel across groups, such as the synchronized framesets
+    * and the motion frames, and a full queue drops its oldest frames only. 0, the default, calls it on the thread the frames
+    * arrive on. Applied on the next \c start()
+    *
+    * \param[in] pipe       A pointer to an instance of the pipeline
+    * \param[in] queue_size Frames each stream group may have waiting, up to 64
+    * \param[out] error     If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+    */
+    void rs2_pipeline_set_callback_queue_size(rs2_pipeline* pipe, unsigned int queue_size, rs2_error ** error);
+
+    /**
+    * Retrieve the histogram of the time \c wait_for_frames() took to return once the frameset it waited for was ready
+    *
+    * \param[in] pipe       A pointer to an instance of the pipeline
+    * \param[out] latency   Wakeup latencies measured while a wait strategy was set, or since this function was first called
+    * \param[out] error     If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+    */
+    void rs2_pipeline_get_wait_latency(rs2_pipeline* pipe, rs2_wait_latency* latency, rs2_error ** error);
+
     /**
     * Return the active device and streams profiles, used by the pipeline.
     * The pipeline streams profiles are selected during \c start(). The method returns a valid result only when the pipeline is active -
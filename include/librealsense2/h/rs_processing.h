@@ -18,6 +18,8 @@ extern "C" {
 #include "rs_sensor.h"
 #include "rs_option.h"
 
+#include <stdint.h>
+
 /**
 * Creates Depth-Colorizer processing block that can be used to quickly visualize the depth data
 * This block will accept depth frames as input and replace them by depth frames with format RGB8
@@ -35,6 +37,15 @@ rs2_processing_block* rs2_create_colorizer(rs2_error** error);
 */
 rs2_processing_block* rs2_create_sync_processing_block(rs2_error** error);
 
+/**
+* Creates a multi-device sync processing block. The block accepts the frames and framesets of several hardware synchronized
+* devices, and outputs one composite frame per trigger, holding a frame of every stream that delivers.
+* Frames are matched on their frame counters, counted from the first frame of every stream, or on their timestamps,
+* which should be in the global time domain. See RS2_OPTION_SYNC_MATCH_KEY and RS2_OPTION_FRAMES_QUEUE_SIZE
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+rs2_processing_block* rs2_create_multi_device_sync_processing_block(rs2_error** error);
+
 /**
 * Creates Point-Cloud processing block. This block accepts depth frames and outputs Points frames
 * In addition, given non-depth frame, the block will align texture coordinate to the non-depth stream
@@ -42,6 +53,14 @@ rs2_processing_block* rs2_create_sync_processing_block(rs2_error** error);
 */
 rs2_processing_block* rs2_create_pointcloud(rs2_error** error);
 
+/**
+* Makes the next frame of a pointcloud in the changed tiles mode (RS2_OPTION_SPARSE_POINTCLOUD 3) output all of its tiles, for a receiver that
+* has to start over with the full cloud
+* \param[in] block             Pointcloud
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_pointcloud_refresh_tiles(rs2_processing_block* block, rs2_error** error);
+
 /**
 * This method creates new custom processing block. This lets the users pass frames between module boundaries for processing
 * This is an infrastructure function aimed at middleware developers, and also used by provided blocks such as sync, colorizer, etc..
@@ -108,12 +127,103 @@ void rs2_start_processing_queue(rs2_processing_block* block, rs2_frame_queue* qu
 */
 void rs2_process_frame(rs2_processing_block* block, rs2_frame* frame, rs2_error** error);
 
+/**
+* This method processes a frame on the calling thread and returns the output of the block, instead of passing it to the output callback
+* \param[in] block          Processing block
+* \param[in] frame          Frame to process, ownership is moved to the block object
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return                   The last frame the block produced, or null when it produced none. Should be released by rs2_release_frame
+*/
+rs2_frame* rs2_process_frame_direct(rs2_processing_block* block, rs2_frame* frame, rs2_error** error);
+
 /**
 * Deletes the processing block
 * \param[in] block          Processing block
 */
 void rs2_delete_processing_block(rs2_processing_block* block);
 
+/** \brief Timing of one block of a processing graph, since the graph was created */
+typedef struct rs2_processing_stage_stats
+{
+    unsigned long long frames;  /**< Frames processed by the block */
+    unsigned long long dropped; /**< Frames discarded before the block got to them, because its input queue was full or the graph stopped */
+    float average_latency_ms;   /**< Mean time the block spent on a frame, including waiting for room in the queues of its consumers */
+    float max_latency_ms;       /**< Longest time the block spent on a frame */
+    float average_wait_ms;      /**< Mean time a frame waited in the input queue of the block */
+} rs2_processing_stage_stats;
+
+/**
+* Creates a graph that runs connected processing blocks as a pipeline, each block working on a different frame concurrently
+* \param[in] queue_size     Number of frames each block can hold in its input queue
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return handle to the processing graph, must be released using rs2_delete_processing_graph
+*/
+rs2_processing_graph* rs2_create_processing_graph(int queue_size, rs2_error** error);
+
+/**
+* Adds a block to the graph. The graph takes over the output of the block until it is deleted
+* \param[in] graph          Processing graph, must not be started
+* \param[in] block          Processing block to add
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return id of the new node, used to connect it and to query its statistics
+*/
+int rs2_processing_graph_add_block(rs2_processing_graph* graph, rs2_processing_block* block, rs2_error** error);
+
+/**
+* Sends the output of one node to the input of another. Edges may not form a cycle
+* \param[in] graph          Processing graph, must not be started
+* \param[in] from           Id of the producing node
+* \param[in] to             Id of the consuming node
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_processing_graph_connect(rs2_processing_graph* graph, int from, int to, rs2_error** error);
+
+/**
+* Starts the graph. Frames produced by nodes without consumers are passed to the callback, one frame at a time
+* \param[in] graph          Processing graph
+* \param[in] on_frame       Callback object created from c++ application, ownership is moved into the graph
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_processing_graph_start(rs2_processing_graph* graph, rs2_frame_callback* on_frame, rs2_error** error);
+
+/**
+* Starts the graph, placing the frames produced by nodes without consumers in a queue
+* \param[in] graph          Processing graph
+* \param[in] queue          Queue to place the processed frames to
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_processing_graph_start_queue(rs2_processing_graph* graph, rs2_frame_queue* queue, rs2_error** error);
+
+/**
+* Passes a frame to every node without inputs. Their queues drop the oldest frame when full, so the call never blocks on processing
+* \param[in] graph          Processing graph, must be started
+* \param[in] frame          Frame to process, ownership is moved to the graph
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_processing_graph_invoke(rs2_processing_graph* graph, rs2_frame* frame, rs2_error** error);
+
+/**
+* Stops the graph, waiting for the frames in progress and discarding the queued ones
+* \param[in] graph          Processing graph
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_processing_graph_stop(rs2_processing_graph* graph, rs2_error** error);
+
+/**
+* Retrieves the timing of one node of the graph
+* \param[in] graph          Processing graph
+* \param[in] node           Id of the node
+* \param[out] stats         Receives the statistics of the node
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_processing_graph_get_stats(const rs2_processing_graph* graph, int node, rs2_processing_stage_stats* stats, rs2_error** error);
+
+/**
+* Stops and deletes the processing graph
+* \param[in] graph          Processing graph
+*/
+void rs2_delete_processing_graph(rs2_processing_graph* graph);
+
 /**
 * create frame queue. frame queues are the simplest x-platform synchronization primitive provided by librealsense
 * to help developers who are not using async APIs
@@ -123,6 +233,15 @@ void rs2_delete_processing_block(rs2_processing_block* block);
 */
 rs2_frame_queue* rs2_create_frame_queue(int capacity, rs2_error** error);
 
+/**
+* create frame queue with a specific synchronization strategy. Both policies drop the oldest frame when the queue is full
+* \param[in] capacity max number of frames to allow to be stored in the queue before older frames will start to get dropped
+* \param[in] policy   synchronization strategy of the queue
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return handle to the frame queue, must be released using rs2_delete_frame_queue
+*/
+rs2_frame_queue* rs2_create_frame_queue_with_policy(int capacity, rs2_frame_queue_policy policy, rs2_error** error);
+
 /**
 * deletes frame queue and releases all frames inside it
 * \param[in] queue queue to delete
@@ -157,6 +276,102 @@ int rs2_poll_for_frame(rs2_frame_queue* queue, rs2_frame** output_frame, rs2_err
 */
 int rs2_try_wait_for_frame(rs2_frame_queue* queue, unsigned int timeout_ms, rs2_frame** output_frame, rs2_error** error);
 
+/**
+* set how the consumers of a frame queue wait for a frame. They spin on the queue, then yield their core, and only then sleep
+* until they're signaled, which shortens the wakeup at the cost of a busy core. Both durations to 0 is the default
+* \param[in] queue    the frame queue
+* \param[in] spin_us  time to spin before yielding, in microseconds
+* \param[in] yield_us time to yield before sleeping, in microseconds
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_frame_queue_set_wait_strategy(rs2_frame_queue* queue, unsigned int spin_us, unsigned int yield_us, rs2_error** error);
+
+/**
+* retrieve the histogram of the time the consumers of a frame queue took to return once the frame they waited for arrived
+* \param[in] queue    the frame queue
+* \param[out] latency wakeup latencies measured while a wait strategy was set, or since this function was first called
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_frame_queue_get_wait_latency(rs2_frame_queue* queue, rs2_wait_latency* latency, rs2_error** error);
+
+/**
+* create a frame broadcast. Frames enqueued into a broadcast are stored once and read by every subscriber, each one at its own pace
+* \param[in] capacity number of frames kept for the subscribers
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return handle to the frame broadcast, must be released using rs2_delete_frame_broadcast
+*/
+rs2_frame_broadcast* rs2_create_frame_broadcast(int capacity, rs2_error** error);
+
+/**
+* deletes frame broadcast and releases all the frames it holds
+* \param[in] broadcast frame broadcast handle
+*/
+void rs2_delete_frame_broadcast(rs2_frame_broadcast* broadcast);
+
+/**
+* enqueue new frame into a broadcast, every subscriber receives it
+* \param[in] frame frame handle to enqueue (this operation passed ownership to the broadcast)
+* \param[in] broadcast the frame broadcast
+*/
+void rs2_frame_broadcast_enqueue(rs2_frame* frame, void* broadcast);
+
+/**
+* subscribe to a frame broadcast, the subscriber receives the frames enqueued from now on
+* \param[in] broadcast the frame broadcast
+* \param[in] policy    drop the oldest frames or hold the producer back when the subscriber is a whole broadcast behind
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return identifier of the subscriber
+*/
+int rs2_frame_broadcast_subscribe(rs2_frame_broadcast* broadcast, rs2_broadcast_policy policy, rs2_error** error);
+
+/**
+* end a subscription, pending waits of the subscriber return without a frame
+* \param[in] broadcast  the frame broadcast
+* \param[in] subscriber identifier returned by rs2_frame_broadcast_subscribe
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_frame_broadcast_unsubscribe(rs2_frame_broadcast* broadcast, int subscriber, rs2_error** error);
+
+/**
+* wait until the subscriber has a new frame and read it
+* \param[in] broadcast  the frame broadcast
+* \param[in] subscriber identifier returned by rs2_frame_broadcast_subscribe
+* \param[in] timeout_ms max time in milliseconds to wait until an exception will be thrown
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return frame handle to be released using rs2_release_frame
+*/
+rs2_frame* rs2_frame_broadcast_wait_for_frame(rs2_frame_broadcast* broadcast, int subscriber, unsigned int timeout_ms, rs2_error** error);
+
+/**
+* read the next frame of the subscriber if there is one
+* \param[in] broadcast  the frame broadcast
+* \param[in] subscriber identifier returned by rs2_frame_broadcast_subscribe
+* \param[out] output_frame frame handle to be released using rs2_release_frame
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return true if new frame was stored to output_frame
+*/
+int rs2_frame_broadcast_poll_for_frame(rs2_frame_broadcast* broadcast, int subscriber, rs2_frame** output_frame, rs2_error** error);
+
+/**
+* wait until the subscriber has a new frame and read it
+* \param[in] broadcast  the frame broadcast
+* \param[in] subscriber identifier returned by rs2_frame_broadcast_subscribe
+* \param[in] timeout_ms max time in milliseconds to wait
+* \param[out] output_frame frame handle to be released using rs2_release_frame
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return true if new frame was stored to output_frame
+*/
+int rs2_frame_broadcast_try_wait_for_frame(rs2_frame_broadcast* broadcast, int subscriber, unsigned int timeout_ms, rs2_frame** output_frame, rs2_error** error);
+
+/**
+* retrieve the frames read and lost by a subscriber
+* \param[in] broadcast  the frame broadcast
+* \param[in] subscriber identifier returned by rs2_frame_broadcast_subscribe
+* \param[out] stats     counts of the subscriber
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_frame_broadcast_get_stats(rs2_frame_broadcast* broadcast, int subscriber, rs2_broadcast_stats* stats, rs2_error** error);
+
 /**
 * enqueue new frame into a queue
 * \param[in] frame frame handle to enqueue (this operation passed ownership to the queue)
@@ -170,6 +385,40 @@ void rs2_enqueue_frame(rs2_frame* frame, void* queue);
 */
 rs2_processing_block* rs2_create_align(rs2_stream align_to, rs2_error** error);
 
+/**
+* Creates Align processing block aligning depth to several streams in a single pass over the depth image.
+* The output frameset holds one aligned depth frame per frame of the target streams, in the order of the targets
+* \param[in] align_to   Target streams, depth can't be one of them
+* \param[in] count      Number of target streams
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+rs2_processing_block* rs2_create_multi_align(const rs2_stream* align_to, int count, rs2_error** error);
+
+/**
+* Creates Pointcloud processing block computing the points in OpenGL compute shaders.
+* The points stay in GPU memory and are read back on first access of the vertices or texture coordinates.
+* Depth aligned by the GL align block is used in place. Available in libraries built with BUILD_WITH_GLSL,
+* on GPUs supporting OpenGL 4.3. The first GL block should be created on the main thread of the application
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+rs2_processing_block* rs2_create_pointcloud_gl(rs2_error** error);
+
+/**
+* Creates Align processing block aligning depth to another stream in OpenGL compute shaders.
+* The aligned depth stays in GPU memory and is read back on first access of its data.
+* Other streams aligned to depth are processed on the CPU. See rs2_create_pointcloud_gl for the requirements
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+rs2_processing_block* rs2_create_align_gl(rs2_stream align_to, rs2_error** error);
+
+/**
+* Checks whether the OpenGL processing blocks can be created
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* 
+eturn            true if the library was built with them and the GPU supports OpenGL 4.3
+*/
+int rs2_gl_is_available(rs2_error** error);
+
 /**
 * Creates Depth post-processing filter block. This block accepts depth frames, applies decimation filter and plots modified prames
 * Note that due to the modifiedframe size, the decimated frame repaces the original one
@@ -209,6 +458,182 @@ rs2_processing_block* rs2_create_hole_filling_filter_block(rs2_error** error);
 */
 rs2_processing_block* rs2_create_rates_printer_block(rs2_error** error);
 
+/**
+* Creates a rate limiter block. The block keeps one of every RS2_OPTION_RATE_DIVISOR frames of each stream, and at most RS2_OPTION_TARGET_FPS
+* frames per second by their timestamps, and drops the others. Framesets are kept or dropped as a whole. Placed first, the blocks after it
+* only process the frames kept
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+rs2_processing_block* rs2_create_rate_limiter_block(rs2_error** error);
+
+/**
+* Creates a depth compression block. The block losslessly encodes Z16 depth frames into RS2_FORMAT_Z16_RVL frames,
+* typically 3-5 times smaller, for storage or transmission
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+rs2_processing_block* rs2_create_depth_compression_block(rs2_error** error);
+
+/**
+* Creates a depth decompression block. The block restores the Z16 depth frames encoded by the depth compression block
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+rs2_processing_block* rs2_create_depth_decompression_block(rs2_error** error);
+
+/**
+* Creates a depth refinement block. The block runs the decimation, depth to disparity, spatial, temporal and disparity to depth
+* stages over Z16 frames in one pass and allocates only the output frame. Each stage is optional and is controlled by the options
+* of its own block, which is kept by the refinement block. The stages run their host implementations
+* \param[in] decimation     decimation filter block, or null to skip the stage
+* \param[in] to_disparity   disparity transform block in depth to disparity mode, or null to stay in the depth domain
+* \param[in] spatial        spatial filter block, or null to skip the stage
+* \param[in] temporal       temporal filter block, or null to skip the stage
+* \param[in] to_depth       disparity transform block in disparity to depth mode, or null to output DISPARITY32 frames.
+*                           Requires to_disparity
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+rs2_processing_block* rs2_create_depth_refine_block(rs2_processing_block* decimation, rs2_processing_block* to_disparity,
+    rs2_processing_block* spatial, rs2_processing_block* temporal, rs2_processing_block* to_depth, rs2_error** error);
+
+/**
+* Creates a YUY2 decoder block. The block converts YUY2 frames into the target format, for the consumers of streams kept
+* in YUY2 that need another format. The conversion runs on the first access to the data of the output frame
+* \param[in] target_format  RS2_FORMAT_RGB8, RS2_FORMAT_BGR8, RS2_FORMAT_RGBA8, RS2_FORMAT_BGRA8 or RS2_FORMAT_Y16
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+rs2_processing_block* rs2_create_yuy2_decoder(rs2_format target_format, rs2_error** error);
+
+/**
+* Creates an MJPEG decoder block. The block decodes Motion-JPEG color frames, such as the compressed color profiles
+* that save USB bandwidth. Available when librealsense is built with BUILD_WITH_LIBJPEG
+* \param[in] target_format  RS2_FORMAT_RGB8 or RS2_FORMAT_Y8
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+rs2_processing_block* rs2_create_mjpeg_decoder(rs2_format target_format, rs2_error** error);
+
+/**
+* Creates an IMU fusion block. The block takes the accel and gyro frames of a motion sensor, in RS2_FORMAT_MOTION_XYZ32F,
+* and outputs framesets of an accel and a gyro frame with the same timestamp, both interpolated linearly onto the timestamps of the output
+* \param[in] rate   output rate in Hz, aligned to multiples of the period on the clock of the samples. 0 outputs at the gyro timestamps
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+rs2_processing_block* rs2_create_imu_fusion_block(float rate, rs2_error** error);
+
+/**
+* Creates a threshold-crop block. The block zeroes the Z16 depth outside the band set by RS2_OPTION_MIN_DISTANCE and RS2_OPTION_MAX_DISTANCE,
+* and crops the frame to the region set by the RS2_OPTION_CROP_* options. The intrinsics of the output describe the cropped image
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+rs2_processing_block* rs2_create_threshold_crop_block(rs2_error** error);
+
+/**
+* Creates a voxel-grid filter. The filter takes a points frame and outputs a sparse points frame holding the centroid of the vertices,
+* and of their texture coordinates, in every occupied cell of a grid of RS2_OPTION_VOXEL_SIZE
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+rs2_processing_block* rs2_create_voxel_grid_filter_block(rs2_error** error);
+
+/**
+* Creates a normal estimation block. The block takes a dense points frame and outputs a video frame of RS2_FORMAT_XYZ32F of the same size,
+* holding the unit normal of every vertex, oriented toward the camera, or zero where the neighbors of the vertex have no usable depth
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+rs2_processing_block* rs2_create_normal_estimation_block(rs2_error** error);
+
+/**
+* Creates a TSDF integrator. The block fuses Z16 depth frames into a truncated signed distance field of voxels of RS2_OPTION_VOXEL_SIZE,
+* stored sparsely where surfaces were seen. The pose of a depth frame is interpolated from the pose frames passed to the block, alone or in
+* a frameset with the depth, or set with rs2_tsdf_integrator_set_pose. Without a pose the camera is taken to be static. For every depth frame
+* the block outputs a sparse points frame, in the world frame of the poses, of the surface in the part of the volume the frame updated
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+rs2_processing_block* rs2_create_tsdf_integrator_block(rs2_error** error);
+
+/**
+* Sets the pose in the world of the depth sensor for the next depth frames a TSDF integrator fuses, until the next pose frame it receives
+* \param[in] block             TSDF integrator
+* \param[in] world_from_depth  translation and rotation of the depth sensor, the other fields are ignored
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_tsdf_integrator_set_pose(rs2_processing_block* block, const rs2_pose* world_from_depth, rs2_error** error);
+
+/**
+* Clears the volume of a TSDF integrator, and the poses it kept
+* \param[in] block             TSDF integrator
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_tsdf_integrator_reset(rs2_processing_block* block, rs2_error** error);
+
+/**
+* Creates a mesh generator. The block takes a dense points frame, or a sparse one with pixel indices (RS2_OPTION_SPARSE_POINTCLOUD 2), and outputs
+* a video frame of RS2_FORMAT_MESH_INDICES: two triangles per square of neighboring depth pixels whose vertices have depth and differ in depth by
+* less than RS2_OPTION_MESH_MAX_DEPTH_STEP, as indices into the vertices of the points frame. The width of the frame is its number of faces,
+* a frame without any face holds a single degenerate one
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+rs2_processing_block* rs2_create_mesh_generator_block(rs2_error** error);
+
+/**
+* Creates a depth statistics block. The block takes Z16 depth frames and outputs a video frame of RS2_FORMAT_DEPTH_STATISTICS: a row of
+* rs2_depth_statistics, one per region of interest in the order they were added, or one of the whole frame when no region was added.
+* A depth frame passed in a frameset stays in the output frameset, next to its statistics
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+rs2_processing_block* rs2_create_depth_statistics_block(rs2_error** error);
+
+/**
+* Adds a region of interest to the ones a depth statistics block measures
+* \param[in] block             Depth statistics block
+* \param[in] min_x, min_y      Top left pixel of the region
+* \param[in] max_x, max_y      Bottom right pixel of the region, the region includes it
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_depth_statistics_add_roi(rs2_processing_block* block, int min_x, int min_y, int max_x, int max_y, rs2_error** error);
+
+/**
+* Removes all of the regions of interest of a depth statistics block, which then measures the whole frame
+* \param[in] block             Depth statistics block
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_depth_statistics_clear_rois(rs2_processing_block* block, rs2_error** error);
+
+/**
+* Creates a height map block. The block takes Z16 depth frames, deprojects them into a ground frame, x to the right, y forward and z up,
+* and outputs a square grid of RS2_OPTION_GRID_CELLS cells of RS2_OPTION_GRID_CELL_SIZE centered on the origin of the ground frame, its
+* rows starting at the far edge along y. The video frame is of RS2_FORMAT_HEIGHT_MAP, or of RS2_FORMAT_OCCUPANCY_GRID with RS2_OPTION_GRID_OCCUPANCY.
+* The points higher than RS2_OPTION_OBSTACLE_MAX_HEIGHT are left out. A depth frame passed in a frameset stays in the output frameset
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+rs2_processing_block* rs2_create_height_map_block(rs2_error** error);
+
+/**
+* Sets the pose of the depth sensor in the ground frame of a height map block. By default the sensor is at the origin, looking forward and level
+* \param[in] block             Height map block
+* \param[in] depth_to_ground   Transform from the depth sensor to the ground frame
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_height_map_set_ground(rs2_processing_block* block, const rs2_extrinsics* depth_to_ground, rs2_error** error);
+
+/**
+* Batch version of rs2_project_color_pixel_to_depth_pixel of rsutil.h, with the same results for every pixel. The frame setup is
+* shared between the pixels and their line searches run in parallel
+* \param[out] to_pixels       count depth pixels, interleaved x and y. Pixels with no depth along their line are set to (-1, -1)
+* \param[in] data             Z16 depth image
+* \param[in] depth_scale      depth units of the image, in meters
+* \param[in] depth_min        nearest depth searched, in meters
+* \param[in] depth_max        farthest depth searched, in meters
+* \param[in] from_pixels      count color pixels, interleaved x and y
+* \param[in] count            number of pixels
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_project_color_pixels_to_depth_pixels(float* to_pixels,
+    const uint16_t* data, float depth_scale,
+    float depth_min, float depth_max,
+    const rs2_intrinsics* depth_intrin,
+    const rs2_intrinsics* color_intrin,
+    const rs2_extrinsics* color_to_depth,
+    const rs2_extrinsics* depth_to_color,
+    const float* from_pixels, int count, rs2_error** error);
+
 #ifdef __cplusplus
 }
 #endif
@@ -15,6 +15,7 @@ extern "C" {
 #endif
 
 #include "rs_types.h"
+#include "rs_sensor.h"
 
 typedef enum rs2_playback_status
 {
@@ -29,6 +30,27 @@ const char* rs2_playback_status_to_string(rs2_playback_status status);
 
 typedef void (*rs2_playback_status_changed_callback_ptr)(rs2_playback_status);
 
+/** \brief Specifies what the recorder does with a stream's frames when its write queue is over the memory budget */
+typedef enum rs2_record_write_policy
+{
+    RS2_RECORD_WRITE_POLICY_DROP,  /**< New frames are dropped until the writer catches up. This is the default */
+    RS2_RECORD_WRITE_POLICY_BLOCK, /**< The sensor callback waits until there is room in the write queue */
+    RS2_RECORD_WRITE_POLICY_COUNT
+} rs2_record_write_policy;
+
+const char* rs2_record_write_policy_to_string(rs2_record_write_policy policy);
+
+/** \brief State of the recorder's write-behind queue */
+typedef struct rs2_record_stats
+{
+    unsigned long long queued_frames;  /**< Frames waiting to be written */
+    unsigned long long queued_bytes;   /**< Size of the frames waiting to be written */
+    unsigned long long frames_written; /**< Frames written to file since recording started */
+    unsigned long long frames_dropped; /**< Frames dropped because the write queue was over the memory budget */
+    unsigned long long bytes_written;  /**< Frame data written to file since recording started */
+    double bytes_per_second;           /**< Frame data write rate, measured over the last second */
+} rs2_record_stats;
+
 /**
  * Creates a recording device to record the given device and save it to the given file
  * \param[in]  device    The device to record
@@ -71,6 +93,73 @@ void rs2_record_device_resume(const rs2_device* device, rs2_error** error);
 */
 const char* rs2_record_device_filename(const rs2_device* device, rs2_error** error);
 
+/**
+* Sets the maximal size of the frames waiting to be written to file. Frames arriving over the budget are handled according to their stream's write policy
+* \param[in]  device    A recording device
+* \param[in]  bytes     Memory budget of the write queue, in bytes
+* \param[out] error     If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_record_device_set_memory_budget(const rs2_device* device, unsigned long long bytes, rs2_error** error);
+
+/**
+* Sets what the recorder does with frames of the given stream when its write queue is over the memory budget
+* \param[in]  device    A recording device
+* \param[in]  stream    Stream type
+* \param[in]  index     Stream index
+* \param[in]  policy    Drop or block new frames of the stream
+* \param[out] error     If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_record_device_set_stream_write_policy(const rs2_device* device, rs2_stream stream, int index, rs2_record_write_policy policy, rs2_error** error);
+
+/**
+* Sets the size of the chunks in which messages are batched before being written to file
+* \param[in]  device    A recording device
+* \param[in]  bytes     Chunk size, in bytes
+* \param[out] error     If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_record_device_set_chunk_size(const rs2_device* device, unsigned int bytes, rs2_error** error);
+
+/**
+* Selects how frame metadata is written. By default every metadata value of every frame is written as a separate message.
+* Columnar metadata packs the metadata of consecutive frames of each stream into a single binary block instead,
+* which keeps long recordings compact and fast to open. Files written this way need a library version that reads columnar metadata.
+* \param[in]  device    A recording device
+* \param[in]  enable    Non-zero to write columnar metadata blocks, 0 for per-frame metadata messages
+* \param[out] error     If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_record_device_set_columnar_metadata(const rs2_device* device, int enable, rs2_error** error);
+
+/**
+* Selects whether the Z16 frames of the given stream are written losslessly compressed (RVL). Compressed depth is typically
+* 3-5 times smaller than raw depth, and cheap enough to encode on the write thread. Frames of other formats are written as is.
+* Files written this way need a library version that reads compressed depth.
+* \param[in]  device    A recording device
+* \param[in]  stream    Stream type
+* \param[in]  index     Stream index
+* \param[in]  enable    Non-zero to compress the frames of the stream, 0 to write them raw
+* \param[out] error     If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_record_device_set_stream_compression(const rs2_device* device, rs2_stream stream, int index, int enable, rs2_error** error);
+
+/**
+* Splits the recording into several files, moving to the next file once the current one holds the given amount of frame data or
+* duration. Segments after the first are named after the recording file, "name.001.bag", "name.002.bag" and so on, and each of them is
+* a recording of its own. Playing the first file plays the whole set of segments next to it.
+* \param[in]  device      A recording device
+* \param[in]  bytes       Frame data per segment, in bytes, 0 for no size limit
+* \param[in]  duration_ms Duration of each segment, in milliseconds, 0 for no duration limit
+* \param[out] error       If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_record_device_set_segment_limits(const rs2_device* device, unsigned long long bytes, unsigned long long duration_ms, rs2_error** error);
+
+/**
+* Retrieves the state of the recorder's write queue
+* \param[in]  device    A recording device
+* \param[out] stats     Queue depth, drop counts and write rate
+* \param[out] error     If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_record_device_get_stats(const rs2_device* device, rs2_record_stats* stats, rs2_error** error);
+
 /**
 * Creates a playback device to play the content of the given file
 * \param[in]  file      Path to the file to play
@@ -142,6 +231,50 @@ void rs2_playback_device_pause(const rs2_device* device, rs2_error** error);
  */
 void rs2_playback_device_set_real_time(const rs2_device* device, int real_time, rs2_error** error);
 
+/**
+ * Set the number of frames that playback reads and decodes ahead of the play position.
+ * Prefetching runs on its own thread and lets non real time playback run at the speed of the disk rather than of decompression.
+ * \param[in] device A playback device
+ * \param[in] frames Number of frames to read ahead, between 0 (disabled) and 16. The default is 8
+ * \param[out] error If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ */
+void rs2_playback_device_set_prefetch_size(const rs2_device* device, int frames, rs2_error** error);
+
+/**
+ * Skip the frames that real time playback delivers later than their recorded time by more than the given lateness.
+ * When the consumer or the decompression can't keep up, playback then catches up instead of lagging further behind.
+ * Skipped frames are counted in the statistics of their stream as dropped from the queue
+ * \param[in] device A playback device
+ * \param[in] max_lateness Lateness in milliseconds, 0 (the default) delivers every frame however late
+ * \param[out] error If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ */
+void rs2_playback_device_skip_late_frames(const rs2_device* device, float max_lateness, rs2_error** error);
+
+/**
+ * Processes a recording outside of playback, in parallel. The recording is split into contiguous time ranges, one per processing block.
+ * Each range is read by its own reader on a dedicated thread and passed, in order, through its block only, so stateful blocks
+ * (such as the temporal filter) always see contiguous sequences of frames.
+ * The frames output by the blocks are delivered on the calling thread, one range after the other, which keeps the recorded order of every stream.
+ * The call returns once the whole recording was processed. The blocks' output callbacks are replaced, and the blocks must not be used meanwhile.
+ * \param[in] device   A playback device that is not playing
+ * \param[in] blocks   Processing blocks, one per range
+ * \param[in] count    Number of processing blocks, which is the number of ranges processed in parallel
+ * \param[in] on_frame Callback receiving the processed frames
+ * \param[out] error   If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ */
+void rs2_playback_device_process_ranges(const rs2_device* device, rs2_processing_block** blocks, int count, rs2_frame_callback* on_frame, rs2_error** error);
+
+/**
+ * Processes a recording outside of playback, in parallel. See rs2_playback_device_process_ranges
+ * \param[in] device   A playback device that is not playing
+ * \param[in] blocks   Processing blocks, one per range
+ * \param[in] count    Number of processing blocks, which is the number of ranges processed in parallel
+ * \param[in] on_frame Callback function receiving the processed frames
+ * \param[in] user     User data passed to the callback
+ * \param[out] error   If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ */
+void rs2_playback_device_process_ranges_fptr(const rs2_device* device, rs2_processing_block** blocks, int count, rs2_frame_callback_ptr on_frame, void* user, rs2_error** error);
+
 /**
  * Indicates if playback is in real time mode or non real time
  * \param[in] device A playback device
@@ -186,6 +319,76 @@ void rs2_playback_device_set_playback_speed(const rs2_device* device, float spee
 */
 void rs2_playback_device_stop(const rs2_device* device, rs2_error** error);
 
+/**
+* Creates a playback group, which plays several recordings together, such as the bags of the cameras of a rig. The devices of
+* the group pace their frames on one clock, so they stay aligned on the recording time, and prefetch on one pool of reader threads
+* \param[in] reader_threads  Threads of the pool reading the recordings ahead, 0 for a default based on the hardware threads
+* \param[out] error          If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return                    The playback group, to delete with rs2_delete_playback_group
+*/
+rs2_playback_group* rs2_create_playback_group(int reader_threads, rs2_error** error);
+
+/**
+* Deletes the playback group, its devices go on playing on its clock and reader threads until they are released
+* \param[in] group  A playback group
+*/
+void rs2_delete_playback_group(rs2_playback_group* group);
+
+/**
+* Adds a playback device to the group, preferably before it starts streaming
+* \param[in] group      A playback group
+* \param[in] device     A playback device
+* \param[out] error     If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_playback_group_add_device(rs2_playback_group* group, const rs2_device* device, rs2_error** error);
+
+/**
+* Pauses all the devices of the group
+* \param[in] group      A playback group
+* \param[out] error     If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_playback_group_pause(rs2_playback_group* group, rs2_error** error);
+
+/**
+* Resumes all the devices of the group, on a new common time base
+* \param[in] group      A playback group
+* \param[out] error     If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_playback_group_resume(rs2_playback_group* group, rs2_error** error);
+
+/**
+* Sets all the devices of the group to the same position in time
+* \param[in] group      A playback group
+* \param[in] time       The time in nanoseconds since the beginning of the recordings
+* \param[out] error     If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_playback_group_seek(rs2_playback_group* group, long long int time, rs2_error** error);
+
+/**
+* Sets the playing speed of all the devices of the group
+* \param[in] group      A playback group
+* \param[in] speed      Indicates a multiplication of the speed to play (e.g: 1 = normal, 0.5 twice as slow)
+* \param[out] error     If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_playback_group_set_playback_speed(rs2_playback_group* group, float speed, rs2_error** error);
+
+/**
+* Enables or disables stepping. While stepping, the devices read the recordings only up to the position the group was stepped to,
+* and deliver the frames up to it without pacing. Stepping starts at the position of the device furthest behind
+* \param[in] group      A playback group
+* \param[in] stepping   Non-zero to step the group, zero to play it on its clock again
+* \param[out] error     If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_playback_group_set_stepping(rs2_playback_group* group, int stepping, rs2_error** error);
+
+/**
+* Moves the position of a stepping group forward along the timeline of the recordings
+* \param[in] group      A playback group, stepping
+* \param[in] duration   Nanoseconds to move the position by
+* \param[out] error     If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_playback_group_step(rs2_playback_group* group, long long int duration, rs2_error** error);
+
 #ifdef __cplusplus
 }
 #endif
@@ -15,6 +15,8 @@ extern "C" {
 #endif
 
 #include "rs_types.h"
+#include "rs_frame.h"
+#include "rs_option.h"
 
 /** \brief Read-only strings that can be queried from the device.
    Not all information attributes are available on all camera types.
@@ -74,6 +76,13 @@ typedef enum rs2_format
     RS2_FORMAT_GPIO_RAW        , /**< Raw data from the external sensors hooked to one of the GPIO's */
     RS2_FORMAT_6DOF            , /**< Pose data packed as floats array, containing translation vector, rotation quaternion and prediction velocities and accelerations vectors */
     RS2_FORMAT_DISPARITY32     , /**< 32-bit float-point disparity values. Depth->Disparity conversion : Disparity = Baseline*FocalLength/Depth */
+    RS2_FORMAT_Y8I             , /**< 8-bit per-pixel interleaved stereo pair, left IR at even bytes and right IR at odd bytes of a single frame */
+    RS2_FORMAT_Z16_RVL         , /**< Losslessly compressed Z16 depth, a single row of RVL-coded bytes. The image resolution is given by the stream profile */
+    RS2_FORMAT_MJPEG           , /**< Motion-JPEG compressed color, a single row holding the JPEG bytes of the image. The image resolution is given by the stream profile */
+    RS2_FORMAT_MESH_INDICES    , /**< Triangle mesh of a points frame, a single row of faces of 3 32-bit indices into its vertices. The resolution of the points is given by the stream profile */
+    RS2_FORMAT_DEPTH_STATISTICS, /**< Statistics of regions of interest of a depth frame, a single row of rs2_depth_statistics. The resolution of the depth is given by the stream profile */
+    RS2_FORMAT_HEIGHT_MAP      , /**< 32-bit float height in meters above the ground of the highest point in each cell of a grid, NaN in the cells without any. The resolution of the depth is given by the stream profile */
+    RS2_FORMAT_OCCUPANCY_GRID  , /**< 8-bit rs2_occupancy of each cell of a grid. The resolution of the depth is given by the stream profile */
     RS2_FORMAT_COUNT             /**< Number of enumeration values. Not a valid input: intended to be used in for-loops. */
 } rs2_format;
 const char* rs2_format_to_string(rs2_format format);
@@ -154,6 +163,15 @@ int rs2_is_sensor_extendable_to(const rs2_sensor* sensor, rs2_extension extensio
 */
 float rs2_get_depth_scale(rs2_sensor* sensor, rs2_error** error);
 
+/** When called on a pose sensor, copies the most recent pose of its stream without waiting for the pose frame
+* \param[in] sensor      pose sensor
+* \param[out] pose       pointer to a user allocated struct, which contains the pose after a successful return
+* \param[out] timestamp  timestamp of the pose in milliseconds
+* \param[out] error      if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return                0 while the stream has not delivered any pose, non-zero otherwise
+*/
+int rs2_get_latest_pose(const rs2_sensor* sensor, rs2_pose* pose, rs2_time_t* timestamp, rs2_error** error);
+
 /**
 * Retrieve the stereoscopic baseline value. Applicable to stereo-based depth modules
 * \param[out] float  Stereoscopic baseline in millimeters
@@ -183,6 +201,62 @@ void rs2_set_region_of_interest(const rs2_sensor* sensor, int min_x, int min_y,
  */
 void rs2_get_region_of_interest(const rs2_sensor* sensor, int* min_x, int* min_y, int* max_x, int* max_y, rs2_error** error);
 
+/** \brief Outcome of a control queued for a frame number */
+typedef enum rs2_frame_control_state
+{
+    RS2_FRAME_CONTROL_STATE_APPLIED,       /**< The frame metadata reports the value, frame is the first frame that does */
+    RS2_FRAME_CONTROL_STATE_WRITTEN,       /**< The value was written, the frame metadata does not report it */
+    RS2_FRAME_CONTROL_STATE_SUPERSEDED,    /**< A value of the same control due by then replaced it */
+    RS2_FRAME_CONTROL_STATE_NOT_CONFIRMED, /**< The value was written, the frame metadata did not report it in time */
+    RS2_FRAME_CONTROL_STATE_FAILED,        /**< Writing the value failed */
+    RS2_FRAME_CONTROL_STATE_COUNT          /**< Number of enumeration values. Not a valid input: intended to be used in for-loops. */
+} rs2_frame_control_state;
+const char* rs2_frame_control_state_to_string(rs2_frame_control_state state);
+
+/** \brief Reports the outcome of a control queued for a frame number */
+typedef struct rs2_frame_control_status
+{
+    rs2_option option;                 /**< The option, RS2_OPTION_COUNT for the region of interest */
+    float value;                       /**< The value queued for the option */
+    unsigned long long target_frame;   /**< The frame number the control was queued for */
+    unsigned long long frame;          /**< The frame number at which the state was reached */
+    rs2_frame_control_state state;
+} rs2_frame_control_status;
+
+typedef struct rs2_frame_control_callback rs2_frame_control_callback;
+
+/**
+ * \brief queues an option value to be applied to the given frame number of the sensor. the value is written ahead of the frame,
+ * by the latency the sensor showed so far, and confirmed from the frame metadata for the options it reports (exposure, gain, laser power).
+ * of the values of one option due by the same frame, only the latest is written
+ * \param[in] sensor        the RealSense sensor
+ * \param[in] option        option id to be written
+ * \param[in] value         new value for the option
+ * \param[in] frame_number  frame number of the sensor the value is meant for
+ * \param[out] error        if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ */
+void rs2_queue_frame_option(const rs2_sensor* sensor, rs2_option option, float value, unsigned long long frame_number, rs2_error** error);
+
+/**
+ * \brief queues a region of interest of the auto-exposure algorithm to be applied to the given frame number of the sensor
+ * \param[in] sensor        the RealSense sensor
+ * \param[in] min_x         lower horizontal bound in pixels
+ * \param[in] min_y         lower vertical bound in pixels
+ * \param[in] max_x         upper horizontal bound in pixels
+ * \param[in] max_y         upper vertical bound in pixels
+ * \param[in] frame_number  frame number of the sensor the region is meant for
+ * \param[out] error        if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ */
+void rs2_queue_frame_region_of_interest(const rs2_sensor* sensor, int min_x, int min_y, int max_x, int max_y, unsigned long long frame_number, rs2_error** error);
+
+/**
+ * \brief sets the callback receiving the outcome of every queued frame control. it may be invoked from the frame callback thread
+ * \param[in] sensor    the RealSense sensor
+ * \param[in] callback  callback object created from c++ application. ownership over the callback object is moved into the relevant subsystem
+ * \param[out] error    if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ */
+void rs2_set_frame_control_callback_cpp(const rs2_sensor* sensor, rs2_frame_control_callback* callback, rs2_error** error);
+
 /**
 * open subdevice for exclusive access, by committing to a configuration
 * \param[in] device relevant RealSense device
@@ -256,6 +330,77 @@ void rs2_set_notifications_callback(const rs2_sensor* sensor, rs2_notification_c
 */
 void rs2_set_notifications_callback_cpp(const rs2_sensor* sensor, rs2_notifications_callback* callback, rs2_error** error);
 
+/**
+* set a user-provided allocator for the frame buffers of the specified sensor.
+* Frames that are produced by unpacking the raw sensor data are written directly into the buffers returned by the allocator,
+* and each buffer is handed back to the deallocator once the last reference to its frame is released.
+* When the allocator returns null the library falls back to its internal buffers. The allocator takes effect on the next sensor open
+* \param[in] sensor      RealSense sensor
+* \param[in] allocate    function pointer invoked to obtain a buffer of the requested size in bytes
+* \param[in] deallocate  function pointer invoked to return a buffer previously obtained from allocate
+* \param[in] user        auxiliary data the user wishes to receive together with every allocation call
+* \param[out] error      if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_set_frame_allocator(const rs2_sensor* sensor, rs2_frame_allocate_ptr allocate, rs2_frame_deallocate_ptr deallocate, void* user, rs2_error** error);
+
+/**
+* set a user-provided allocator for the frame buffers of the specified sensor
+* \param[in] sensor     RealSense sensor
+* \param[in] allocator  allocator object created from c++ application. ownership over the allocator object is moved into the sensor
+* \param[out] error     if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_set_frame_allocator_cpp(const rs2_sensor* sensor, rs2_frame_allocator* allocator, rs2_error** error);
+
+/** Places the frame buffers on the NUMA node the sensor is attached to */
+#define RS2_NUMA_NODE_LOCAL -1
+
+/**
+* set where the frame buffers of the specified sensor are allocated, replacing any allocator in place. The buffers are placed on a NUMA node
+* and recycled by the sensor, buffers of 2MB or more may be backed by huge pages. The threads delivering the frames can be moved to the cores
+* of the node, so that the callbacks and the processing they run read local memory. Takes effect on the next sensor open.
+* Unsupported on platforms without NUMA, where the buffers come from the heap
+* \param[in] sensor       RealSense sensor
+* \param[in] numa_node    node the buffers are placed on, RS2_NUMA_NODE_LOCAL for the node of the bus the sensor is attached to
+* \param[in] huge_pages   non-zero to back the large buffers with 2MB huge pages, or transparent huge pages when none are reserved
+* \param[in] pin_threads  non-zero to move the threads delivering the frames to the cores of the node
+* \param[out] error       if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_set_frame_allocation_policy(const rs2_sensor* sensor, int numa_node, int huge_pages, int pin_threads, rs2_error** error);
+
+/**
+* retrieve the NUMA node of the bus the specified sensor is attached to
+* \param[in] sensor      RealSense sensor
+* \param[out] error      if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return                the node, or -1 when it's unknown
+*/
+int rs2_get_sensor_numa_node(const rs2_sensor* sensor, rs2_error** error);
+
+/**
+* allocate the frame buffers of the specified sensor in page-locked memory mapped into the GPU, replacing any allocator in place.
+* On GPUs that share the memory of the CPU, like the Jetson modules, the CUDA processing blocks then read the frames in place rather
+* than copying them to the device. Takes effect on the next sensor open. Unsupported when librealsense is built without CUDA
+* \param[in] sensor      RealSense sensor
+* \param[out] error      if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_set_cuda_frame_allocation(const rs2_sensor* sensor, rs2_error** error);
+
+/**
+* retrieve the frame memory held by the specified sensor
+* \param[in] sensor      RealSense sensor
+* \param[out] usage      the memory of the sensor since it was created
+* \param[out] error      if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_get_sensor_memory_usage(const rs2_sensor* sensor, rs2_memory_usage* usage, rs2_error** error);
+
+/**
+* estimate the USB bandwidth a stream profile of the specified sensor takes, from the native format it is unpacked from
+* \param[in] sensor      RealSense sensor
+* \param[in] profile     a stream profile of the sensor
+* \param[out] error      if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return                the payload of the stream, in bytes per second
+*/
+unsigned long long rs2_get_stream_profile_bandwidth(const rs2_sensor* sensor, const rs2_stream_profile* profile, rs2_error** error);
+
 /**
 * retrieve description from notification handle
 * \param[in] notification      handle returned from a callback
@@ -387,6 +532,21 @@ void rs2_get_motion_intrinsics(const rs2_stream_profile* mode, rs2_motion_device
 */
 int rs2_is_stream_profile_default(const rs2_stream_profile* mode, rs2_error** error);
 
+/**
+* retrieve the frames of a stream delivered and dropped, by the reason they were dropped for
+* \param[in] mode        a stream profile of the stream, the statistics cover all the profiles of the stream
+* \param[out] statistics the counters of the stream
+* \param[out] error      if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_get_stream_statistics(const rs2_stream_profile* mode, rs2_stream_statistics* statistics, rs2_error** error);
+
+/**
+* clear the frame counters of a stream
+* \param[in] mode        a stream profile of the stream
+* \param[out] error      if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_reset_stream_statistics(const rs2_stream_profile* mode, rs2_error** error);
+
 /**
 * get the number of supported stream profiles
 * \param[in] list        the list of supported profiles returned by rs2_get_supported_profiles
@@ -21,6 +21,7 @@ typedef enum rs2_notification_category{
     RS2_NOTIFICATION_CATEGORY_HARDWARE_EVENT,               /**< General Hardeware notification that is not an error */
     RS2_NOTIFICATION_CATEGORY_UNKNOWN_ERROR,                /**< Received unknown error from the device */
     RS2_NOTIFICATION_CATEGORY_FIRMWARE_UPDATE_RECOMMENDED,  /**< Current firmware version installed is not the latest available */
+    RS2_NOTIFICATION_CATEGORY_FRAMES_DROPPED,               /**< Frames were dropped since the application holds on to the whole frames queue */
     RS2_NOTIFICATION_CATEGORY_COUNT                         /**< Number of enumeration values. Not a valid input: intended to be used in for-loops. */
 } rs2_notification_category;
 const char* rs2_notification_category_to_string(rs2_notification_category category);
@@ -118,6 +119,7 @@ typedef enum rs2_extension
     RS2_EXTENSION_TM2,
     RS2_EXTENSION_SOFTWARE_DEVICE,
     RS2_EXTENSION_SOFTWARE_SENSOR,
+    RS2_EXTENSION_POSE_SENSOR,
     RS2_EXTENSION_COUNT
 } rs2_extension;
 const char* rs2_extension_type_to_string(rs2_extension type);
@@ -144,12 +146,120 @@ typedef enum rs2_matchers
    RS2_MATCHER_COUNT
 }rs2_matchers;
 
+/** \brief Specifies the synchronization strategy of a frame queue */
+typedef enum rs2_frame_queue_policy
+{
+    RS2_FRAME_QUEUE_POLICY_MUTEX,     /**< Mutex protected queue, the default */
+    RS2_FRAME_QUEUE_POLICY_LOCK_FREE, /**< Bounded lock-free ring buffer, lowest latency for one consumer and few producers */
+    RS2_FRAME_QUEUE_POLICY_COUNT
+} rs2_frame_queue_policy;
+
+#define RS2_WAIT_LATENCY_BUCKETS 16
+
+/** \brief Time the consumers of frames took to return once the frame they waited for arrived */
+typedef struct rs2_wait_latency
+{
+    unsigned long long counts[RS2_WAIT_LATENCY_BUCKETS]; /**< Bucket 0 counts the waits that returned within 1us, bucket i those from 2^(i-1) to 2^i us, the last one all the longer ones */
+    unsigned long long spinning;                         /**< Waits that returned while spinning */
+    unsigned long long yielding;                         /**< Waits that returned while yielding */
+    unsigned long long sleeping;                         /**< Waits that went to sleep until they were signaled */
+} rs2_wait_latency;
+
+/** \brief Specifies what a frame broadcast does for a subscriber that fell a whole ring behind */
+typedef enum rs2_broadcast_policy
+{
+    RS2_BROADCAST_POLICY_DROP_OLDEST, /**< The oldest frames the subscriber didn't read are overwritten. This is the default */
+    RS2_BROADCAST_POLICY_BLOCK,       /**< The producer waits until the subscriber reads a frame */
+    RS2_BROADCAST_POLICY_COUNT
+} rs2_broadcast_policy;
+
+/** \brief Frames read and lost by a subscriber of a frame broadcast */
+typedef struct rs2_broadcast_stats
+{
+    unsigned long long received; /**< Frames read by the subscriber */
+    unsigned long long dropped;  /**< Frames overwritten before the subscriber read them */
+    unsigned int lag;            /**< Frames waiting for the subscriber */
+    unsigned int max_lag;        /**< Largest number of frames that waited for the subscriber */
+} rs2_broadcast_stats;
+
+/** \brief Frame memory held by the library */
+typedef struct rs2_memory_usage
+{
+    unsigned long long in_use;  /**< Bytes of the frames that are alive, including the frames held by the application and by the queues */
+    unsigned long long pooled;  /**< Bytes of the buffers kept for reuse by later frames */
+    unsigned long long dropped; /**< Frames dropped because their buffer didn't fit in the memory budget */
+} rs2_memory_usage;
+
+/** \brief Categories of the threads the library starts, each scheduled as configured by rs2_context_set_thread_scheduling */
+typedef enum rs2_thread_category
+{
+    RS2_THREAD_CATEGORY_CAPTURE,    /**< Threads reading the frames of the video devices */
+    RS2_THREAD_CATEGORY_HID,        /**< Threads reading the motion sensors, and their power management */
+    RS2_THREAD_CATEGORY_DISPATCHER, /**< Workers of the thread pool the dispatchers and the notifications run on */
+    RS2_THREAD_CATEGORY_PLAYBACK,   /**< Threads reading recorded files */
+    RS2_THREAD_CATEGORY_COUNT
+} rs2_thread_category;
+const char* rs2_thread_category_to_string(rs2_thread_category category);
+
+/** \brief Where frames of a stream were lost on their way to the application */
+typedef enum rs2_frame_drop_reason
+{
+    RS2_FRAME_DROP_REASON_CAPTURE,    /**< Missed by the capture of the host, which had no free buffer for them, usually a sign of host overload */
+    RS2_FRAME_DROP_REASON_INCOMPLETE, /**< Arrived incomplete and were discarded, usually from packets lost on the USB link */
+    RS2_FRAME_DROP_REASON_DEVICE,     /**< Missing from the frame counter of the device without the host seeing them, lost on the link or in the device */
+    RS2_FRAME_DROP_REASON_MEMORY,     /**< Found no frame memory, the application held on to too many frames or the memory budget ran out */
+    RS2_FRAME_DROP_REASON_QUEUE,      /**< Replaced by newer frames in a full frame queue, or skipped by a playback running late */
+    RS2_FRAME_DROP_REASON_SYNC,       /**< Left out of a frameset, the syncer stopped waiting for them */
+    RS2_FRAME_DROP_REASON_COUNT
+} rs2_frame_drop_reason;
+const char* rs2_frame_drop_reason_to_string(rs2_frame_drop_reason reason);
+
+/** \brief Frames of a stream delivered and dropped, since the library was loaded or the statistics of the stream were reset */
+typedef struct rs2_stream_statistics
+{
+    unsigned long long delivered;                                /**< Frames the sensor delivered */
+    unsigned long long dropped[RS2_FRAME_DROP_REASON_COUNT];     /**< Frames dropped, by reason */
+} rs2_stream_statistics;
+
+#define RS2_DEPTH_STATISTICS_HISTOGRAM_BINS 64
+
+/** \brief Statistics of the depth over a region of interest of a depth frame, a depth statistics block outputs one per region */
+typedef struct rs2_depth_statistics
+{
+    int min_x, min_y, max_x, max_y;     /**< The region in pixels, inclusive, cut to the frame */
+    unsigned int pixels;                /**< Pixels of the region */
+    unsigned int valid_pixels;          /**< Pixels of the region with depth */
+    float fill_rate;                    /**< Share of the pixels of the region with depth */
+    float min_depth;                    /**< Smallest depth in meters, 0 without any valid pixel */
+    float max_depth;                    /**< Largest depth in meters */
+    float mean_depth;                   /**< Mean depth in meters */
+    float median_depth;                 /**< Lower median of the depth in meters */
+    unsigned int histogram[RS2_DEPTH_STATISTICS_HISTOGRAM_BINS]; /**< Valid pixels by depth, in bins of equal width from RS2_OPTION_MIN_DISTANCE to RS2_OPTION_MAX_DISTANCE of the block. The first and last bins also count the depths outside of the range */
+} rs2_depth_statistics;
+
+/** \brief State of a cell of an occupancy grid, from the highest point in the cell */
+typedef enum rs2_occupancy
+{
+    RS2_OCCUPANCY_UNKNOWN,  /**< No point fell in the cell */
+    RS2_OCCUPANCY_FREE,     /**< Only points below RS2_OPTION_OBSTACLE_MIN_HEIGHT, the ground */
+    RS2_OCCUPANCY_OCCUPIED, /**< A point between RS2_OPTION_OBSTACLE_MIN_HEIGHT and RS2_OPTION_OBSTACLE_MAX_HEIGHT */
+    RS2_OCCUPANCY_COUNT     /**< Number of enumeration values. Not a valid input: intended to be used in for-loops. */
+} rs2_occupancy;
+
+/** \brief A piece of a serialized frame, a header of the wire format or frame data pointing into the frame, layed out like an iovec on 64 bit platforms */
+typedef struct rs2_frame_segment
+{
+    const void* data;           /**< Start of the segment */
+    unsigned long long size;    /**< Bytes of the segment */
+} rs2_frame_segment;
+
 typedef struct rs2_device_info rs2_device_info;
 typedef struct rs2_device rs2_device;
 typedef struct rs2_error rs2_error;
 typedef struct rs2_raw_data_buffer rs2_raw_data_buffer;
 typedef struct rs2_frame rs2_frame;
 typedef struct rs2_frame_queue rs2_frame_queue;
+typedef struct rs2_frame_broadcast rs2_frame_broadcast;
 typedef struct rs2_pipeline rs2_pipeline;
 typedef struct rs2_pipeline_profile rs2_pipeline_profile;
 typedef struct rs2_config rs2_config;
@@ -162,6 +272,8 @@ typedef struct rs2_syncer rs2_syncer;
 typedef struct rs2_device_serializer rs2_device_serializer;
 typedef struct rs2_source rs2_source;
 typedef struct rs2_processing_block rs2_processing_block;
+typedef struct rs2_processing_graph rs2_processing_graph;
+typedef struct rs2_playback_group rs2_playback_group;
 typedef struct rs2_frame_processor_callback rs2_frame_processor_callback;
 typedef struct rs2_playback_status_changed_callback rs2_playback_status_changed_callback;
 typedef struct rs2_context rs2_context;
@@ -172,10 +284,15 @@ typedef struct rs2_options rs2_options;
 typedef struct rs2_devices_changed_callback rs2_devices_changed_callback;
 typedef struct rs2_notification rs2_notification;
 typedef struct rs2_notifications_callback rs2_notifications_callback;
+typedef struct rs2_frame_allocator rs2_frame_allocator;
+typedef struct rs2_frame_serializer rs2_frame_serializer;
+typedef struct rs2_frame_deserializer rs2_frame_deserializer;
 typedef void (*rs2_notification_callback_ptr)(rs2_notification*, void*);
 typedef void (*rs2_devices_changed_callback_ptr)(rs2_device_list*, rs2_device_list*, void*);
 typedef void (*rs2_frame_callback_ptr)(rs2_frame*, void*);
 typedef void (*rs2_frame_processor_callback_ptr)(rs2_frame*, rs2_source*, void*);
+typedef void* (*rs2_frame_allocate_ptr)(int size, void* user);
+typedef void (*rs2_frame_deallocate_ptr)(void* buffer, int size, void* user);
 
 typedef double      rs2_time_t;     /**< Timestamp format. units are milliseconds */
 typedef long long   rs2_metadata_type; /**< Metadata attribute type is defined as 64 bit signed integer*/
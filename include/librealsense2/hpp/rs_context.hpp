@@ -198,6 +198,90 @@ namespace rs2
             rs2::error::handle(e);
         }
 
+        /**
+        * configure the worker threads shared by all contexts for the library's internal dispatching
+        * \param[in] threads   number of workers kept for regular work, 0 selects a default based on the number of cores
+        * \param[in] cpus      cores the workers are pinned to round-robin, empty leaves the affinity to the operating system
+        */
+        void set_thread_pool(int threads, const std::vector<int>& cpus = {})
+        {
+            rs2_error* e = nullptr;
+            rs2_context_set_thread_pool(_context.get(), threads, cpus.data(), static_cast<int>(cpus.size()), &e);
+            rs2::error::handle(e);
+        }
+
+        /**
+        * configure the threads of a category as the library starts them, shared by all contexts
+        * \param[in] category  the threads to configure
+        * \param[in] cpus      cores the threads may run on, empty leaves the affinity to the operating system
+        * \param[in] priority  SCHED_FIFO priority from 1 to 99, 0 leaves the scheduling policy unchanged
+        */
+        void set_thread_scheduling(rs2_thread_category category, const std::vector<int>& cpus, int priority = 0)
+        {
+            rs2_error* e = nullptr;
+            rs2_context_set_thread_scheduling(_context.get(), category, cpus.data(), static_cast<int>(cpus.size()), priority, &e);
+            rs2::error::handle(e);
+        }
+
+        /**
+        * configure the threads of several categories from JSON, such as {"capture": {"cpus": [2, 3], "priority": 80}}
+        * \param[in] json      the configuration, nothing is applied when any entry is invalid
+        */
+        void load_thread_scheduling(const std::string& json)
+        {
+            rs2_error* e = nullptr;
+            rs2_context_load_thread_scheduling(_context.get(), json.c_str(), &e);
+            rs2::error::handle(e);
+        }
+
+        /**
+        * limit the frame memory of the process, shared by all contexts. Pooled buffers are freed first, then frames are dropped
+        * \param[in] bytes     the budget, 0 lifts it
+        */
+        void set_memory_budget(unsigned long long bytes)
+        {
+            rs2_error* e = nullptr;
+            rs2_context_set_memory_budget(_context.get(), bytes, &e);
+            rs2::error::handle(e);
+        }
+
+        /**
+        * keep what the devices report when opened in a directory, so that later processes don't query them again
+        * \param[in] directory an existing directory, empty turns the cache off
+        */
+        void set_device_cache(const std::string& directory)
+        {
+            rs2_error* e = nullptr;
+            rs2_context_set_device_cache(_context.get(), directory.c_str(), &e);
+            rs2::error::handle(e);
+        }
+
+        /**
+        * retrieve the frame memory held by the sensors of the devices of this context
+        * \return   the memory of the context
+        */
+        rs2_memory_usage get_memory_usage() const
+        {
+            rs2_error* e = nullptr;
+            rs2_memory_usage usage;
+            rs2_context_get_memory_usage(_context.get(), &usage, &e);
+            rs2::error::handle(e);
+            return usage;
+        }
+
+        /**
+        * retrieve the frame memory held by the process, which the memory budget applies to
+        * \return   the memory of the process
+        */
+        rs2_memory_usage get_total_memory_usage() const
+        {
+            rs2_error* e = nullptr;
+            rs2_memory_usage usage;
+            rs2_context_get_total_memory_usage(_context.get(), &usage, &e);
+            rs2::error::handle(e);
+            return usage;
+        }
+
         context(std::shared_ptr<rs2_context> ctx)
             : _context(ctx)
         {}
@@ -254,6 +338,36 @@ protected:
 
         }
 
+        /**
+        * Wait until the device of the serial number is connected. Devices of other serial numbers that connect don't wake the waiting thread
+        * \param[in] serial      Serial number of the requested device
+        * \param[in] timeout_ms  Max time in milliseconds to wait until an exception will be thrown
+        */
+        device wait_for_device(const std::string& serial, unsigned int timeout_ms) const
+        {
+            rs2_error* e = nullptr;
+            std::shared_ptr<rs2_device> dev(
+                rs2_device_hub_wait_for_device_by_serial(_device_hub.get(), serial.c_str(), timeout_ms, &e),
+                rs2_delete_device);
+
+            error::handle(e);
+
+            return device(dev);
+        }
+
+        /**
+        * Retrieves the reconnections of the device of the serial number since the hub was created
+        * \param[in] serial  Serial number of the device
+        */
+        rs2_reconnect_stats get_reconnect_stats(const std::string& serial) const
+        {
+            rs2_error* e = nullptr;
+            rs2_reconnect_stats stats;
+            rs2_device_hub_get_reconnect_stats(_device_hub.get(), serial.c_str(), &stats, &e);
+            error::handle(e);
+            return stats;
+        }
+
         explicit operator std::shared_ptr<rs2_device_hub>() { return _device_hub; }
         explicit device_hub(std::shared_ptr<rs2_device_hub> hub) : _device_hub(std::move(hub)) {}
     private:
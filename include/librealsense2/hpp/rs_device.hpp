@@ -7,6 +7,7 @@
 #include "rs_types.hpp"
 #include "rs_sensor.hpp"
 #include <array>
+#include <cstring>
 
 namespace rs2
 {
@@ -95,6 +96,19 @@ namespace rs2
             error::handle(e);
         }
 
+        /**
+        * retrieve the USB bandwidth the device has left for new streams on its link
+        * \param[in] utilization   the fraction of the link capacity the streams may use
+        * \return                  bytes per second, or -1 when the link of the device is unknown
+        */
+        long long get_available_usb_bandwidth(float utilization = 1.f) const
+        {
+            rs2_error* e = nullptr;
+            auto available = rs2_get_available_usb_bandwidth(_dev.get(), utilization, &e);
+            error::handle(e);
+            return available;
+        }
+
         device& operator=(const std::shared_ptr<rs2_device> dev)
         {
             _dev.reset();
@@ -180,6 +194,46 @@ namespace rs2
 
             return results;
         }
+
+        /**
+        * Sends the commands back to back, locking and powering the device once for all of them
+        * \param[in] inputs  Raw commands to send
+        * \return            Responses of the device, in the order of the commands
+        */
+        std::vector<std::vector<uint8_t>> send_and_receive_raw_data(const std::vector<std::vector<uint8_t>>& inputs) const
+        {
+            std::vector<uint8_t> batch;
+            for (auto&& input : inputs)
+            {
+                auto size = static_cast<uint32_t>(input.size());
+                auto size_bytes = reinterpret_cast<const uint8_t*>(&size);
+                batch.insert(batch.end(), size_bytes, size_bytes + sizeof(size));
+                batch.insert(batch.end(), input.begin(), input.end());
+            }
+
+            rs2_error* e = nullptr;
+            std::shared_ptr<const rs2_raw_data_buffer> list(
+                    rs2_send_and_receive_raw_data_batch(_dev.get(), (void*)batch.data(), (uint32_t)batch.size(), &e),
+                    rs2_delete_raw_data);
+            error::handle(e);
+
+            auto size = rs2_get_raw_data_size(list.get(), &e);
+            error::handle(e);
+
+            auto start = rs2_get_raw_data(list.get(), &e);
+            error::handle(e);
+
+            std::vector<std::vector<uint8_t>> results;
+            for (int offset = 0; offset + int(sizeof(uint32_t)) <= size;)
+            {
+                uint32_t response_size;
+                std::memcpy(&response_size, start + offset, sizeof(response_size));
+                offset += sizeof(response_size);
+                results.emplace_back(start + offset, start + offset + response_size);
+                offset += response_size;
+            }
+            return results;
+        }
     };
 
     class device_list
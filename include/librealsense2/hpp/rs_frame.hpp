@@ -10,8 +10,11 @@ namespace rs2
 {
     class frame_source;
     class frame_queue;
+    class frame_broadcast;
     class syncer;
     class processing_block;
+    class processing_graph;
+    class filter;
     class pointcloud;
     class sensor;
     class frame;
@@ -123,6 +126,29 @@ namespace rs2
         */
         bool is_default() const { return _default; }
 
+        /**
+        * Retrieve the frames of the stream delivered and dropped, for all the profiles of the stream
+        * \return rs2_stream_statistics - the counters of the stream, by the reason frames were dropped for
+        */
+        rs2_stream_statistics get_statistics() const
+        {
+            rs2_error* e = nullptr;
+            rs2_stream_statistics statistics;
+            rs2_get_stream_statistics(_profile, &statistics, &e);
+            error::handle(e);
+            return statistics;
+        }
+
+        /**
+        * Clear the frame counters of the stream
+        */
+        void reset_statistics() const
+        {
+            rs2_error* e = nullptr;
+            rs2_reset_stream_statistics(_profile, &e);
+            error::handle(e);
+        }
+
         /**
         * Parenthesis operator check that the profile is valid
         * \return bool - true or false.
@@ -430,6 +456,32 @@ namespace rs2
             return r;
         }
 
+        /**
+        * retrieve the current value of metadata from frame, when the frame supports it
+        * \param[in] frame_metadata  the rs2_frame_metadata whose latest frame we are interested in
+        * \param[out] value          receives the metadata value
+        * \return                    true if the frame supports the attribute, an unsupported attribute doesn't throw
+        */
+        bool try_get_frame_metadata(rs2_frame_metadata_value frame_metadata, rs2_metadata_type& value) const
+        {
+            return rs2_try_get_frame_metadata(frame_ref, frame_metadata, &value) != 0;
+        }
+
+        /** retrieve all the frame metadata at once
+        * \param[out] supported  receives, per rs2_frame_metadata_value, whether the frame supports the attribute
+        * \return                the values of all the attributes, indexed by rs2_frame_metadata_value, 0 where unsupported
+        */
+        std::vector<rs2_metadata_type> get_frame_metadata_all(std::vector<bool>& supported) const
+        {
+            rs2_error* e = nullptr;
+            std::vector<rs2_metadata_type> values(RS2_FRAME_METADATA_COUNT);
+            std::vector<int> flags(RS2_FRAME_METADATA_COUNT);
+            rs2_get_frame_metadata_all(frame_ref, values.data(), flags.data(), RS2_FRAME_METADATA_COUNT, &e);
+            error::handle(e);
+            supported.assign(flags.begin(), flags.end());
+            return values;
+        }
+
         /** determine if the device allows a specific metadata to be queried
         * \param[in] frame_metadata  the frame_metadata to check for support
         * \return            true if the frame_metadata can be queried
@@ -454,6 +506,18 @@ namespace rs2
             return r;
         }
 
+        /**
+        * retrieve the DMA buffer file descriptor backing the frame data
+        * \return               the file descriptor, owned by the library, or -1 if not available
+        */
+        int get_dmabuf_fd() const
+        {
+            rs2_error* e = nullptr;
+            auto r = rs2_get_frame_dmabuf_fd(frame_ref, &e);
+            error::handle(e);
+            return r;
+        }
+
         /**
         * retrieve data from frame handle
         * \return               the pointer to the start of the frame data
@@ -533,11 +597,22 @@ namespace rs2
             frame_ref = nullptr;
         }
 
+        /**
+        * drop the frame handle without releasing it, for handles the frame doesn't own
+        */
+        void detach()
+        {
+            frame_ref = nullptr;
+        }
+
     private:
         friend class rs2::frame_source;
         friend class rs2::frame_queue;
+        friend class rs2::frame_broadcast;
         friend class rs2::syncer;
         friend class rs2::processing_block;
+        friend class rs2::processing_graph;
+        friend class rs2::filter;
         friend class rs2::pointcloud;
         friend class rs2::points;
 
@@ -676,13 +751,14 @@ namespace rs2
         * Export current point cloud to PLY file
         * \param[in] string fname - file name of the PLY to be saved
         * \param[in] video_frame texture - the texture for the PLY.
+        * \param[in] bool with_faces - write the faces joining neighbouring vertices, or only the vertices
         */
-        void export_to_ply(const std::string& fname, video_frame texture)
+        void export_to_ply(const std::string& fname, video_frame texture, bool with_faces = true)
         {
             rs2_frame* ptr = nullptr;
             std::swap(texture.frame_ref, ptr);
             rs2_error* e = nullptr;
-            rs2_export_to_ply(get(), fname.c_str(), ptr, &e);
+            rs2_export_to_ply_ex(get(), fname.c_str(), ptr, with_faces ? 1 : 0, &e);
             error::handle(e);
         }
         /**
@@ -697,6 +773,30 @@ namespace rs2
             return (const texture_coordinate*)res;
         }
 
+        /**
+        * return the depth pixel index (y * width + x) of every vertex, for sparse pointclouds that record them
+        * \return const int* - pointer of pixel indices, or null when the pointcloud does not record them
+        */
+        const int* get_pixel_indices() const
+        {
+            rs2_error* e = nullptr;
+            auto res = rs2_get_frame_pixel_indices(get(), &e);
+            error::handle(e);
+            return res;
+        }
+
+        /**
+        * return the R, G, B bytes of every vertex, for pointclouds computed with RS2_OPTION_POINTCLOUD_COLORS
+        * \return const uint8_t* - pointer of three bytes per vertex, or null when the pointcloud does not record them
+        */
+        const uint8_t* get_vertex_colors() const
+        {
+            rs2_error* e = nullptr;
+            auto res = rs2_get_frame_vertex_colors(get(), &e);
+            error::handle(e);
+            return res;
+        }
+
         size_t size() const
         {
             return _size;
@@ -943,8 +1043,9 @@ namespace rs2
         }
 
         /**
-        * Template function, extract internal frame handle from the frameset and invoke the action function
-        * \param[in] action - instance with () operator implemented will be invoke after frame extraction.
+        * Template function, invoke the action function on every frame of the frameset
+        * \param[in] action - instance with () operator implemented, called with each frame of the frameset.
+        *                     The frames are borrowed from the frameset, an action that keeps one copies it
         */
         template<class T>
         void foreach(T action) const
@@ -953,10 +1054,11 @@ namespace rs2
             auto count = size();
             for (size_t i = 0; i < count; i++)
             {
-                auto fref = rs2_extract_frame(get(), (int)i, &e);
+                auto fref = rs2_get_embedded_frame(get(), (int)i, &e);
                 error::handle(e);
 
-                action(frame(fref));
+                const borrowed_frame frm(fref);
+                action(static_cast<const frame&>(frm));
             }
         }
         /**
@@ -994,6 +1096,15 @@ namespace rs2
         iterator begin() const { return iterator(this); }
         iterator end() const { return iterator(this, size()); }
     private:
+        // A frame of the set used without adding a reference, copying it takes one
+        class borrowed_frame : public frame
+        {
+        public:
+            explicit borrowed_frame(rs2_frame* ref) : frame(ref) {}
+            borrowed_frame(const borrowed_frame&) = delete;
+            ~borrowed_frame() { detach(); }
+        };
+
         size_t _size;
     };
 }
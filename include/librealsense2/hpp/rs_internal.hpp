@@ -166,6 +166,19 @@ namespace rs2
             error::handle(e);
         }
 
+        /**
+        * Set several frame metadata values for the upcoming frames at once
+        * \param[in] keys metadata keys to set
+        * \param[in] values metadata values, one per key
+        * \param[in] count number of keys and values
+        */
+        void set_metadata(const rs2_frame_metadata_value* keys, const rs2_metadata_type* values, int count)
+        {
+            rs2_error* e = nullptr;
+            rs2_software_sensor_set_metadata_values(_sensor.get(), keys, values, count, &e);
+            error::handle(e);
+        }
+
         /**
         * Register option that will be supported by the sensor
         *
@@ -252,5 +265,69 @@ namespace rs2
         }
     };
 
+    class frame_serializer
+    {
+    public:
+        frame_serializer()
+        {
+            rs2_error* e = nullptr;
+            _serializer = std::shared_ptr<rs2_frame_serializer>(
+                rs2_create_frame_serializer(&e),
+                rs2_delete_frame_serializer);
+            error::handle(e);
+        }
+
+        /**
+        * Serialize a frame or a frameset into the segments of a message, without copying the frame data
+        * \param[in] f   the frame or frameset, kept by the serializer until the next call
+        * \return        the segments to send in order, valid until the next call
+        */
+        std::vector<rs2_frame_segment> serialize(const frame& f) const
+        {
+            rs2_error* e = nullptr;
+            const rs2_frame_segment* segments = nullptr;
+            auto count = rs2_serialize_frame(_serializer.get(), f.get(), &segments, &e);
+            error::handle(e);
+            return std::vector<rs2_frame_segment>(segments, segments + count);
+        }
+
+    private:
+        std::shared_ptr<rs2_frame_serializer> _serializer;
+    };
+
+    class frame_deserializer
+    {
+    public:
+        /**
+        * Recreate serialized frames on a software device, a sensor per stream of the sender
+        * \param[in] dev        the software device the sensors are added to
+        * \param[in] callback   called with every frame, the frames of a frameset arrive one by one
+        */
+        template<class T>
+        frame_deserializer(const software_device& dev, T callback)
+        {
+            rs2_error* e = nullptr;
+            _deserializer = std::shared_ptr<rs2_frame_deserializer>(
+                rs2_create_frame_deserializer_cpp(dev.get().get(), new frame_callback<T>(std::move(callback)), &e),
+                rs2_delete_frame_deserializer);
+            error::handle(e);
+        }
+
+        /**
+        * Recreate the frames of a message, delivered to the callback before the call returns
+        * \param[in] message   the whole message, its frame data is copied
+        * \param[in] size      bytes of the message
+        */
+        void deserialize(const void* message, size_t size) const
+        {
+            rs2_error* e = nullptr;
+            rs2_deserialize_frame(_deserializer.get(), message, size, &e);
+            error::handle(e);
+        }
+
+    private:
+        std::shared_ptr<rs2_frame_deserializer> _deserializer;
+    };
+
 }
 #endif // LIBREALSENSE_RS2_INTERNAL_HPP
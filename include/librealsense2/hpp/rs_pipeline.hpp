@@ -267,6 +267,19 @@ namespace rs2
             error::handle(e);
         }
 
+        /**
+        * Resolve the streams within the USB bandwidth the device has left. Requests with wildcards are completed with
+        * the first profiles that fit, and a device whose requested streams can't fit is not selected.
+        *
+        * \param[in] utilization  The fraction of the link capacity the streams may use, 0 removes the limit
+        */
+        void limit_usb_bandwidth(float utilization = 0.9f)
+        {
+            rs2_error* e = nullptr;
+            rs2_config_limit_usb_bandwidth(_config.get(), utilization, &e);
+            error::handle(e);
+        }
+
         /**
         * Resolve the configuration filters, to find a matching device and streams profiles.
         * The method resolves the user configuration filters for the device and streams, and combines them with the requirements
@@ -466,6 +479,119 @@ namespace rs2
             error::handle(e);
         }
 
+        /**
+        * Pause the pipeline streaming.
+        * The pipeline stops delivering samples but keeps the device streams configured, so that \c resume() restarts them
+        * without renegotiating the streams with the device. \c wait_for_frames() raises an exception while paused.
+        */
+        void pause()
+        {
+            rs2_error* e = nullptr;
+            rs2_pipeline_pause(_pipeline.get(), &e);
+            error::handle(e);
+        }
+
+        /**
+        * Resume the streaming of a paused pipeline.
+        */
+        void resume()
+        {
+            rs2_error* e = nullptr;
+            rs2_pipeline_resume(_pipeline.get(), &e);
+            error::handle(e);
+        }
+
+        /**
+        * Switch the streams of a started pipeline to a new configuration.
+        * The sensors streaming the same profiles in both configurations keep streaming, the others are reopened.
+        * When the configuration selects another device, a playback or a recording, the pipeline is restarted.
+        * The frame callback provided to \c start() is kept.
+        *
+        * \param[in] config     A rs2::config with requested filters on the pipeline configuration.
+        * \return               The new pipeline device and streams profile.
+        */
+        pipeline_profile reconfigure(const config& config)
+        {
+            rs2_error* e = nullptr;
+            auto p = std::shared_ptr<rs2_pipeline_profile>(
+                rs2_pipeline_reconfigure(_pipeline.get(), config.get().get(), &e),
+                rs2_delete_pipeline_profile);
+
+            error::handle(e);
+            return pipeline_profile(p);
+        }
+
+        /**
+        * Wait until every stream of the pipeline delivered its first frame since the pipeline was started, resumed or
+        * reconfigured. The frames are still delivered to the callback, or returned by \c wait_for_frames().
+        *
+        * \param[in] timeout_ms   Max time in milliseconds to wait
+        * \return                 true when all the streams delivered a frame before the timeout
+        */
+        bool wait_for_streams(unsigned int timeout_ms = 5000) const
+        {
+            rs2_error* e = nullptr;
+            auto res = rs2_pipeline_wait_for_streams(_pipeline.get(), timeout_ms, &e);
+            error::handle(e);
+            return res != 0;
+        }
+
+        /**
+        * Set a user-provided allocator for the frame buffers of the sensors the pipeline streams from.
+        * The allocator is applied on the next \c start().
+        *
+        * \param[in] allocator   allocator to obtain frame buffers from
+        */
+        void set_frame_allocator(std::shared_ptr<frame_allocator> allocator)
+        {
+            rs2_error* e = nullptr;
+            rs2_pipeline_set_frame_allocator_cpp(_pipeline.get(), new frame_allocator_adapter(std::move(allocator)), &e);
+            error::handle(e);
+        }
+
+        /**
+        * Set how many framesets or frames of each stream group may wait for the callback of the pipeline. With a queue size,
+        * the callback is called on worker threads, in parallel across the groups and in order within each, so a slow
+        * callback for the framesets does not delay the motion frames. 0, the default, calls it on the thread the frames
+        * arrive on. The size is applied on the next \c start().
+        *
+        * \param[in] queue_size   Frames each stream group may have waiting, up to 64
+        */
+        void set_callback_queue_size(unsigned int queue_size) const
+        {
+            rs2_error* e = nullptr;
+            rs2_pipeline_set_callback_queue_size(_pipeline.get(), queue_size, &e);
+            error::handle(e);
+        }
+
+        /**
+        * Set how \c wait_for_frames() waits for a frameset: it spins, then yields its core, and only then sleeps until it's signaled.
+        * Spinning shortens the wakeup at the cost of a busy core. Both durations to 0 is the default
+        *
+        * \param[in] spin   Time to spin before yielding
+        * \param[in] yield  Time to yield before sleeping
+        */
+        void set_wait_strategy(std::chrono::microseconds spin, std::chrono::microseconds yield) const
+        {
+            rs2_error* e = nullptr;
+            rs2_pipeline_set_wait_strategy(_pipeline.get(), static_cast<unsigned int>(spin.count()), static_cast<unsigned int>(yield.count()), &e);
+            error::handle(e);
+        }
+
+        /**
+        * Retrieve the histogram of the time \c wait_for_frames() took to return once the frameset it waited for was ready
+        *
+        * \return Wakeup latencies since the pipeline was created
+        */
+        rs2_wait_latency get_wait_latency() const
+        {
+            rs2_error* e = nullptr;
+            rs2_wait_latency latency;
+            rs2_pipeline_get_wait_latency(_pipeline.get(), &latency, &e);
+            error::handle(e);
+            return latency;
+        }
+
         /**
         * Wait until a new set of frames becomes available.
         * The frames set includes time-synchronized frames of each enabled stream in the pipeline.
@@ -8,6 +8,8 @@
 #include "rs_frame.hpp"
 #include "rs_context.hpp"
 
+#include <array>
+
 namespace rs2
 {
     /**
@@ -130,6 +132,20 @@ namespace rs2
 
         frame_queue() : frame_queue(1) {}
 
+        /**
+        * create frame queue with a specific synchronization strategy
+        * param[in] capacity size of the frame queue
+        * param[in] policy   mutex protected or lock-free ring buffer
+        */
+        frame_queue(unsigned int capacity, rs2_frame_queue_policy policy) : _capacity(capacity)
+        {
+            rs2_error* e = nullptr;
+            _queue = std::shared_ptr<rs2_frame_queue>(
+                rs2_create_frame_queue_with_policy(capacity, policy, &e),
+                rs2_delete_frame_queue);
+            error::handle(e);
+        }
+
         /**
         * enqueue new frame into a queue
         * \param[in] f - frame handle to enqueue (this operation passed ownership to the queue)
@@ -193,11 +209,171 @@ namespace rs2
         */
         size_t capacity() const { return _capacity; }
 
+        /**
+        * set how the consumers wait for a frame: they spin, then yield their core, and only then sleep until they're signaled
+        * \param[in] spin  time to spin before yielding
+        * \param[in] yield time to yield before sleeping
+        */
+        void set_wait_strategy(std::chrono::microseconds spin, std::chrono::microseconds yield) const
+        {
+            rs2_error* e = nullptr;
+            rs2_frame_queue_set_wait_strategy(_queue.get(), static_cast<unsigned int>(spin.count()), static_cast<unsigned int>(yield.count()), &e);
+            error::handle(e);
+        }
+
+        /**
+        * return the histogram of the time the consumers took to return once the frame they waited for arrived
+        * \return wakeup latencies since the queue was created
+        */
+        rs2_wait_latency get_wait_latency() const
+        {
+            rs2_error* e = nullptr;
+            rs2_wait_latency latency;
+            rs2_frame_queue_get_wait_latency(_queue.get(), &latency, &e);
+            error::handle(e);
+            return latency;
+        }
+
     private:
         std::shared_ptr<rs2_frame_queue> _queue;
         size_t _capacity;
     };
 
+    /**
+    * Subscription to a frame broadcast, reading the frames through its own cursor.
+    * The subscription ends with the last copy of the subscriber
+    */
+    class broadcast_subscriber
+    {
+    public:
+        /**
+        * wait until the subscriber has a new frame and read it
+        * \return frame handle to be released using rs2_release_frame
+        */
+        frame wait_for_frame(unsigned int timeout_ms = 5000) const
+        {
+            rs2_error* e = nullptr;
+            auto frame_ref = rs2_frame_broadcast_wait_for_frame(_broadcast.get(), *_id, timeout_ms, &e);
+            error::handle(e);
+            return{ frame_ref };
+        }
+
+        /**
+        * poll if the subscriber has a new frame and read it if it does
+        * \param[out] f - frame handle
+        * \return true if new frame was stored to f
+        */
+        template<typename T>
+        typename std::enable_if<std::is_base_of<rs2::frame, T>::value, bool>::type poll_for_frame(T* output) const
+        {
+            rs2_error* e = nullptr;
+            rs2_frame* frame_ref = nullptr;
+            auto res = rs2_frame_broadcast_poll_for_frame(_broadcast.get(), *_id, &frame_ref, &e);
+            error::handle(e);
+            frame f{ frame_ref };
+            if (res) *output = f;
+            return res > 0;
+        }
+
+        template<typename T>
+        typename std::enable_if<std::is_base_of<rs2::frame, T>::value, bool>::type try_wait_for_frame(T* output, unsigned int timeout_ms = 5000) const
+        {
+            rs2_error* e = nullptr;
+            rs2_frame* frame_ref = nullptr;
+            auto res = rs2_frame_broadcast_try_wait_for_frame(_broadcast.get(), *_id, timeout_ms, &frame_ref, &e);
+            error::handle(e);
+            frame f{ frame_ref };
+            if (res) *output = f;
+            return res > 0;
+        }
+
+        /**
+        * retrieve the frames read and lost by the subscriber
+        * \return Received and dropped frames, and the frames waiting to be read
+        */
+        rs2_broadcast_stats get_stats() const
+        {
+            rs2_error* e = nullptr;
+            rs2_broadcast_stats stats;
+            rs2_frame_broadcast_get_stats(_broadcast.get(), *_id, &stats, &e);
+            error::handle(e);
+            return stats;
+        }
+
+    private:
+        friend class frame_broadcast;
+        broadcast_subscriber(std::shared_ptr<rs2_frame_broadcast> broadcast, int id)
+            : _broadcast(broadcast),
+              _id(new int(id), [broadcast](int* id) { rs2_frame_broadcast_unsubscribe(broadcast.get(), *id, nullptr); delete id; })
+        {
+        }
+
+        std::shared_ptr<rs2_frame_broadcast> _broadcast;
+        std::shared_ptr<int> _id;
+    };
+
+    /**
+    * Frame queue with several consumers. Every frame is stored once and read by all the subscribers, each one at its own pace,
+    * which fans frames out to several threads without a queue and a copy of the frame handle per thread
+    */
+    class frame_broadcast
+    {
+    public:
+        /**
+        * create frame broadcast
+        * param[in] capacity number of frames kept for the subscribers
+        */
+        explicit frame_broadcast(unsigned int capacity) : _capacity(capacity)
+        {
+            rs2_error* e = nullptr;
+            _broadcast = std::shared_ptr<rs2_frame_broadcast>(
+                rs2_create_frame_broadcast(capacity, &e),
+                rs2_delete_frame_broadcast);
+            error::handle(e);
+        }
+
+        /**
+        * enqueue new frame into the broadcast, every subscriber receives it
+        * \param[in] f - frame handle to enqueue (this operation passed ownership to the broadcast)
+        */
+        void enqueue(frame f) const
+        {
+            rs2_frame_broadcast_enqueue(f.frame_ref, _broadcast.get()); // noexcept
+            f.frame_ref = nullptr; // frame has been essentially moved from
+        }
+
+        /**
+        * Does the same thing as enqueue function.
+        */
+        void operator()(frame f) const
+        {
+            enqueue(std::move(f));
+        }
+
+        /**
+        * subscribe to the broadcast, the subscriber receives the frames enqueued from now on
+        * \param[in] policy  drop the oldest frames or hold the producer back when the subscriber is a whole broadcast behind
+        * \return the subscriber
+        */
+        broadcast_subscriber subscribe(rs2_broadcast_policy policy = RS2_BROADCAST_POLICY_DROP_OLDEST) const
+        {
+            rs2_error* e = nullptr;
+            auto id = rs2_frame_broadcast_subscribe(_broadcast.get(), policy, &e);
+            error::handle(e);
+            return broadcast_subscriber(_broadcast, id);
+        }
+
+        /**
+        * return the capacity of the broadcast
+        * \return capacity size
+        */
+        size_t capacity() const { return _capacity; }
+
+    private:
+        std::shared_ptr<rs2_frame_broadcast> _broadcast;
+        size_t _capacity;
+    };
+
     /**
     * Define the processing block flow, inherit this class to generate your own processing_block. Best understanding is to refer to the viewer class in examples.hpp
     */
@@ -281,6 +457,109 @@ namespace rs2
         std::shared_ptr<rs2_processing_block> _block;
     };
 
+    /**
+    * Runs connected processing blocks as a pipeline across worker threads, so that e.g. the spatial filter of one frame
+    * overlaps with the temporal filter of the previous one. Every block sees its frames in order
+    */
+    class processing_graph
+    {
+    public:
+        /**
+        * \param[in] queue_size     number of frames each block can hold in its input queue
+        */
+        explicit processing_graph(int queue_size = 1)
+        {
+            rs2_error* e = nullptr;
+            _graph = std::shared_ptr<rs2_processing_graph>(
+                rs2_create_processing_graph(queue_size, &e),
+                rs2_delete_processing_graph);
+            error::handle(e);
+        }
+
+        /**
+        * Add a block to the graph, the graph takes over the output of the block
+        * \param[in] block      processing block to add
+        * \return id of the new node
+        */
+        int add(const processing_block& block)
+        {
+            rs2_error* e = nullptr;
+            auto id = rs2_processing_graph_add_block(_graph.get(), block.get(), &e);
+            error::handle(e);
+            return id;
+        }
+
+        /**
+        * Send the output of one node to the input of another
+        * \param[in] from       id of the producing node
+        * \param[in] to         id of the consuming node
+        */
+        void connect(int from, int to)
+        {
+            rs2_error* e = nullptr;
+            rs2_processing_graph_connect(_graph.get(), from, to, &e);
+            error::handle(e);
+        }
+
+        /**
+        * Start the graph, frames produced by nodes without consumers are passed to on_frame
+        * \param[in] on_frame   callback function for the processed frames
+        */
+        template<class S>
+        void start(S on_frame)
+        {
+            rs2_error* e = nullptr;
+            rs2_processing_graph_start(_graph.get(), new frame_callback<S>(on_frame), &e);
+            error::handle(e);
+        }
+
+        /**
+        * Stop the graph, waiting for the frames in progress
+        */
+        void stop()
+        {
+            rs2_error* e = nullptr;
+            rs2_processing_graph_stop(_graph.get(), &e);
+            error::handle(e);
+        }
+
+        /**
+        * Pass a frame to every node without inputs
+        * \param[in] f          frame to process
+        */
+        void invoke(frame f) const
+        {
+            rs2_frame* ptr = nullptr;
+            std::swap(f.frame_ref, ptr);
+
+            rs2_error* e = nullptr;
+            rs2_processing_graph_invoke(_graph.get(), ptr, &e);
+            error::handle(e);
+        }
+
+        void operator()(frame f) const
+        {
+            invoke(std::move(f));
+        }
+
+        /**
+        * Retrieve the timing of one node
+        * \param[in] node       id of the node
+        * \return statistics of the node since the graph was created
+        */
+        rs2_processing_stage_stats get_stats(int node) const
+        {
+            rs2_error* e = nullptr;
+            rs2_processing_stage_stats stats;
+            rs2_processing_graph_get_stats(_graph.get(), node, &stats, &e);
+            error::handle(e);
+            return stats;
+        }
+
+    private:
+        std::shared_ptr<rs2_processing_graph> _graph;
+    };
+
     /**
     * Define the processing block flow, inherit this class to generate your own processing_block. Best understanding is to refer to the viewer class in examples.hpp
     */
@@ -288,18 +567,22 @@ namespace rs2
     {
     public:
         /**
-        * Ask processing block to process the frame and poll the processed frame from internal queue
+        * Ask processing block to process the frame on the calling thread and return the processed frame, without
+        * passing it through the internal queue
         *
-        * \param[in] on_frame      frame to be processed.
-        * return processed frame
+        * \param[in] on_frame      frame to be processed. Depth filters that may work in place do so when this
+        *                          was the only reference to the frame, e.g. a temporary or a moved frame
+        * return processed frame, or an empty frame when the block dropped it, such as a rate_limiter does
         */
         rs2::frame process(rs2::frame frame) const override
         {
-            invoke(frame);
-            rs2::frame f;
-            if (!_queue.poll_for_frame(&f))
-                throw std::runtime_error("Error occured during execution of the processing block! See the log for more info");
-            return f;
+            rs2_frame* ptr = nullptr;
+            std::swap(frame.frame_ref, ptr);
+
+            rs2_error* e = nullptr;
+            auto res = rs2_process_frame_direct(get(), ptr, &e);
+            error::handle(e);
+            return rs2::frame(res);
         }
 
         /**
@@ -384,6 +667,18 @@ namespace rs2
             set_option(RS2_OPTION_STREAM_INDEX_FILTER, float(mapped.get_profile().stream_index()));
             invoke(mapped);
         }
+        /**
+        * Make the next pointcloud of the changed tiles mode (RS2_OPTION_SPARSE_POINTCLOUD 3) output all of its tiles
+        */
+        void refresh_tiles()
+        {
+            rs2_error* e = nullptr;
+            rs2_pointcloud_refresh_tiles(get(), &e);
+            error::handle(e);
+        }
+
+    protected:
+        pointcloud(std::shared_ptr<rs2_processing_block> block) : filter(block, 1) {}
 
     private:
         friend class context;
@@ -489,6 +784,68 @@ namespace rs2
         frame_queue _results;
     };
 
+    /**
+    Matches the frames of several hardware synchronized devices into one frameset per trigger.
+    Frames and framesets of every device, such as the output of their pipelines, are passed with operator()
+    */
+    class multi_device_syncer : public processing_block
+    {
+    public:
+        /**
+        * \param[in] queue_size   Number of matched framesets kept for wait_for_frames and poll_for_frames
+        */
+        multi_device_syncer(int queue_size = 1)
+            : processing_block(init()), _results(queue_size)
+        {
+            start(_results);
+        }
+
+        /**
+        * Wait until a frameset of all the devices becomes available
+        * \param[in] timeout_ms   Max time in milliseconds to wait until an exception will be thrown
+        * \return Set of matched frames
+        */
+        frameset wait_for_frames(unsigned int timeout_ms = 5000) const
+        {
+            return frameset(_results.wait_for_frame(timeout_ms));
+        }
+
+        /**
+        * Check if a frameset of all the devices is available
+        * \param[out] fs      New frameset
+        * \return true if new frameset was stored to result
+        */
+        bool poll_for_frames(frameset* fs) const
+        {
+            frame result;
+            if (_results.poll_for_frame(&result))
+            {
+                *fs = frameset(result);
+                return true;
+            }
+            return false;
+        }
+
+        void operator()(frame f) const
+        {
+            invoke(std::move(f));
+        }
+
+    private:
+        std::shared_ptr<rs2_processing_block> init()
+        {
+            rs2_error* e = nullptr;
+            auto block = std::shared_ptr<rs2_processing_block>(
+                rs2_create_multi_device_sync_processing_block(&e),
+                rs2_delete_processing_block);
+
+            error::handle(e);
+            return block;
+        }
+
+        frame_queue _results;
+    };
+
     /**
     Auxiliary processing block that performs image alignment using depth data and camera calibration
     */
@@ -517,6 +874,9 @@ namespace rs2
             return filter::process(frames);
         }
 
+    protected:
+        align(std::shared_ptr<rs2_processing_block> block) : filter(block, 1) {}
+
     private:
         friend class context;
         std::shared_ptr<rs2_processing_block> init(rs2_stream align_to)
@@ -531,14 +891,119 @@ namespace rs2
         }
     };
 
-    class colorizer : public filter
+    /**
+    Auxiliary processing block that aligns depth to several streams at once, such as color and infrared
+    */
+    class multi_align : public filter
     {
     public:
         /**
-        * Create colorizer processing block
-        * Colorizer generate color image base on input depth frame
+        Create multi-target align processing block
+        Each depth pixel is deprojected once and projected into all the targets, which costs less than an align block per target.
+        The output frameset holds one aligned depth frame per frame of the target streams, in the order of the targets
+
+        * \param[in] align_to      The stream types to which depth should be aligned
         */
-        colorizer() : filter(init(), 1) { }
+        multi_align(const std::vector<rs2_stream>& align_to) : filter(init(align_to), 1) {}
+
+        /**
+        * Run the alignment process on the given frames to get the depth aligned to every target
+        *
+        * \param[in] frames      A set of frames, where at least one of which is a depth frame
+        * \return Depth frames aligned to the targets
+        */
+        frameset process(frameset frames)
+        {
+            return filter::process(frames);
+        }
+
+    private:
+        std::shared_ptr<rs2_processing_block> init(const std::vector<rs2_stream>& align_to)
+        {
+            rs2_error* e = nullptr;
+            auto block = std::shared_ptr<rs2_processing_block>(
+                rs2_create_multi_align(align_to.data(), static_cast<int>(align_to.size()), &e),
+                rs2_delete_processing_block);
+            error::handle(e);
+
+            return block;
+        }
+    };
+
+    namespace gl
+    {
+        /**
+        * Check whether the OpenGL processing blocks can be created: the library was built with BUILD_WITH_GLSL
+        * and the GPU supports OpenGL 4.3
+        */
+        inline bool is_available()
+        {
+            rs2_error* e = nullptr;
+            auto res = rs2_gl_is_available(&e);
+            error::handle(e);
+            return res != 0;
+        }
+
+        /**
+        * Pointcloud computing the points in OpenGL compute shaders. The points stay in GPU memory
+        * until the vertices or the texture coordinates are read, which makes rendering them or passing them
+        * to another GL block cheap. Sparse output and occlusion removal are computed on the CPU
+        */
+        class pointcloud : public rs2::pointcloud
+        {
+        public:
+            pointcloud() : rs2::pointcloud(init()) {}
+
+            pointcloud(rs2_stream stream, int index = 0) : rs2::pointcloud(init())
+            {
+                set_option(RS2_OPTION_STREAM_FILTER, float(stream));
+                set_option(RS2_OPTION_STREAM_INDEX_FILTER, float(index));
+            }
+
+        private:
+            static std::shared_ptr<rs2_processing_block> init()
+            {
+                rs2_error* e = nullptr;
+                auto block = std::shared_ptr<rs2_processing_block>(
+                    rs2_create_pointcloud_gl(&e),
+                    rs2_delete_processing_block);
+                error::handle(e);
+
+                return block;
+            }
+        };
+
+        /**
+        * Align computing depth aligned to another stream in OpenGL compute shaders. The aligned depth stays
+        * in GPU memory until its data is read, and rs2::gl::pointcloud reads it in place
+        */
+        class align : public rs2::align
+        {
+        public:
+            align(rs2_stream align_to) : rs2::align(init(align_to)) {}
+
+        private:
+            static std::shared_ptr<rs2_processing_block> init(rs2_stream align_to)
+            {
+                rs2_error* e = nullptr;
+                auto block = std::shared_ptr<rs2_processing_block>(
+                    rs2_create_align_gl(align_to, &e),
+                    rs2_delete_processing_block);
+                error::handle(e);
+
+                return block;
+            }
+        };
+    }
+
+    class colorizer : public filter
+    {
+    public:
+        /**
+        * Create colorizer processing block
+        * Colorizer generate color image base on input depth frame
+        */
+        colorizer() : filter(init(), 1) { }
         /**
         * Create colorizer processing block
         * Colorizer generate color image base on input depth frame
@@ -807,5 +1272,518 @@ namespace rs2
             return block;
         }
     };
+
+    /**
+    Drops frames ahead of the costly blocks: keeps one of every RS2_OPTION_RATE_DIVISOR frames of each stream and at most
+    RS2_OPTION_TARGET_FPS of them per second. Framesets are kept or dropped as a whole. process() returns an empty frame
+    for the frames dropped
+    */
+    class rate_limiter : public filter
+    {
+    public:
+        rate_limiter() : filter(init(), 1) {}
+
+        /**
+        * \param[in] divisor      Keep one of every divisor frames
+        * \param[in] target_fps   Largest rate of the frames kept, 0 for no limit
+        */
+        rate_limiter(int divisor, float target_fps = 0.f) : filter(init(), 1)
+        {
+            set_option(RS2_OPTION_RATE_DIVISOR, float(divisor));
+            set_option(RS2_OPTION_TARGET_FPS, target_fps);
+        }
+
+    private:
+        std::shared_ptr<rs2_processing_block> init()
+        {
+            rs2_error* e = nullptr;
+            auto block = std::shared_ptr<rs2_processing_block>(
+                rs2_create_rate_limiter_block(&e),
+                rs2_delete_processing_block);
+            error::handle(e);
+
+            return block;
+        }
+    };
+
+    class depth_compression : public filter
+    {
+    public:
+        /**
+        * Create depth compression processing block
+        * the processing losslessly encodes Z16 depth frames into compact RS2_FORMAT_Z16_RVL frames
+        */
+        depth_compression() : filter(init(), 1) {}
+
+    private:
+        friend class context;
+
+        std::shared_ptr<rs2_processing_block> init()
+        {
+            rs2_error* e = nullptr;
+            auto block = std::shared_ptr<rs2_processing_block>(
+                rs2_create_depth_compression_block(&e),
+                rs2_delete_processing_block);
+            error::handle(e);
+
+            return block;
+        }
+    };
+
+    class depth_decompression : public filter
+    {
+    public:
+        /**
+        * Create depth decompression processing block
+        * the processing restores the Z16 depth frames encoded by depth_compression
+        */
+        depth_decompression() : filter(init(), 1) {}
+
+    private:
+        friend class context;
+
+        std::shared_ptr<rs2_processing_block> init()
+        {
+            rs2_error* e = nullptr;
+            auto block = std::shared_ptr<rs2_processing_block>(
+                rs2_create_depth_decompression_block(&e),
+                rs2_delete_processing_block);
+            error::handle(e);
+
+            return block;
+        }
+    };
+
+    class depth_refine : public filter
+    {
+    public:
+        /**
+        * Create depth refinement processing block
+        * the processing runs the given stages over Z16 frames in one pass, any of them may be null. The stages keep
+        * their options, and the block keeps the stages
+        * \param[in] to_disparity - disparity transform in depth to disparity mode, null to stay in the depth domain
+        * \param[in] to_depth     - disparity transform in disparity to depth mode, null to output disparity frames
+        */
+        depth_refine(const decimation_filter* decimation, const disparity_transform* to_disparity,
+            const spatial_filter* spatial, const temporal_filter* temporal, const disparity_transform* to_depth)
+            : filter(init(decimation, to_disparity, spatial, temporal, to_depth), 1) {}
+
+    private:
+        friend class context;
+
+        static rs2_processing_block* stage(const filter* f) { return f ? f->get() : nullptr; }
+
+        std::shared_ptr<rs2_processing_block> init(const decimation_filter* decimation, const disparity_transform* to_disparity,
+            const spatial_filter* spatial, const temporal_filter* temporal, const disparity_transform* to_depth)
+        {
+            rs2_error* e = nullptr;
+            auto block = std::shared_ptr<rs2_processing_block>(
+                rs2_create_depth_refine_block(stage(decimation), stage(to_disparity), stage(spatial), stage(temporal), stage(to_depth), &e),
+                rs2_delete_processing_block);
+            error::handle(e);
+
+            return block;
+        }
+    };
+
+    class yuy2_decoder : public filter
+    {
+    public:
+        /**
+        * Create YUY2 decoder processing block
+        * the processing converts YUY2 frames into the target format when the data of the output frame is first read
+        * \param[in] target_format - RS2_FORMAT_RGB8, RS2_FORMAT_BGR8, RS2_FORMAT_RGBA8, RS2_FORMAT_BGRA8 or RS2_FORMAT_Y16
+        */
+        yuy2_decoder(rs2_format target_format = RS2_FORMAT_RGB8) : filter(init(target_format), 1) {}
+
+    private:
+        friend class context;
+
+        std::shared_ptr<rs2_processing_block> init(rs2_format target_format)
+        {
+            rs2_error* e = nullptr;
+            auto block = std::shared_ptr<rs2_processing_block>(
+                rs2_create_yuy2_decoder(target_format, &e),
+                rs2_delete_processing_block);
+            error::handle(e);
+
+            return block;
+        }
+    };
+
+    class mjpeg_decoder : public filter
+    {
+    public:
+        /**
+        * Create MJPEG decoder processing block
+        * the processing decodes Motion-JPEG color frames, it is available when librealsense is built with BUILD_WITH_LIBJPEG
+        * \param[in] target_format - RS2_FORMAT_RGB8 or RS2_FORMAT_Y8
+        */
+        mjpeg_decoder(rs2_format target_format = RS2_FORMAT_RGB8) : filter(init(target_format), 1) {}
+
+    private:
+        friend class context;
+
+        std::shared_ptr<rs2_processing_block> init(rs2_format target_format)
+        {
+            rs2_error* e = nullptr;
+            auto block = std::shared_ptr<rs2_processing_block>(
+                rs2_create_mjpeg_decoder(target_format, &e),
+                rs2_delete_processing_block);
+            error::handle(e);
+
+            return block;
+        }
+    };
+
+    /**
+    Zeroes the depth outside a band of distances and crops the frame to a region of interest, ahead of the other filters.
+    The band is set with RS2_OPTION_MIN_DISTANCE and RS2_OPTION_MAX_DISTANCE, in meters, and the region with the RS2_OPTION_CROP_* options
+    */
+    class threshold_crop : public filter
+    {
+    public:
+        threshold_crop() : filter(init(), 1) {}
+
+        /**
+        * \param[in] min_distance   Smallest distance kept, in meters
+        * \param[in] max_distance   Largest distance kept, in meters
+        */
+        threshold_crop(float min_distance, float max_distance) : filter(init(), 1)
+        {
+            set_option(RS2_OPTION_MIN_DISTANCE, min_distance);
+            set_option(RS2_OPTION_MAX_DISTANCE, max_distance);
+        }
+
+        /**
+        * Keep the region between the given edges, as fractions of the frame width and height
+        */
+        void set_region(float left, float top, float right, float bottom)
+        {
+            set_option(RS2_OPTION_CROP_LEFT, left);
+            set_option(RS2_OPTION_CROP_TOP, top);
+            set_option(RS2_OPTION_CROP_RIGHT, right);
+            set_option(RS2_OPTION_CROP_BOTTOM, bottom);
+        }
+
+    private:
+        std::shared_ptr<rs2_processing_block> init()
+        {
+            rs2_error* e = nullptr;
+            auto block = std::shared_ptr<rs2_processing_block>(
+                rs2_create_threshold_crop_block(&e),
+                rs2_delete_processing_block);
+            error::handle(e);
+
+            return block;
+        }
+    };
+
+    /**
+    Merges the vertices of a pointcloud falling in each cell of a regular grid into their centroid.
+    The output is a sparse points frame, see points::size, with one vertex per occupied cell
+    */
+    class voxel_grid_filter : public filter
+    {
+    public:
+        voxel_grid_filter() : filter(init(), 1) {}
+
+        /**
+        * \param[in] voxel_size   Edge of a cell in meters
+        */
+        voxel_grid_filter(float voxel_size) : filter(init(), 1)
+        {
+            set_option(RS2_OPTION_VOXEL_SIZE, voxel_size);
+        }
+
+    private:
+        std::shared_ptr<rs2_processing_block> init()
+        {
+            rs2_error* e = nullptr;
+            auto block = std::shared_ptr<rs2_processing_block>(
+                rs2_create_voxel_grid_filter_block(&e),
+                rs2_delete_processing_block);
+            error::handle(e);
+
+            return block;
+        }
+    };
+
+    /**
+    Estimates the surface normal of every vertex of a dense pointcloud from its neighbors in the image.
+    The output is a video frame of RS2_FORMAT_XYZ32F with the size of the depth image, holding one unit normal per vertex
+    */
+    class normal_estimation : public filter
+    {
+    public:
+        normal_estimation() : filter(init(), 1) {}
+
+    private:
+        std::shared_ptr<rs2_processing_block> init()
+        {
+            rs2_error* e = nullptr;
+            auto block = std::shared_ptr<rs2_processing_block>(
+                rs2_create_normal_estimation_block(&e),
+                rs2_delete_processing_block);
+            error::handle(e);
+
+            return block;
+        }
+    };
+
+    /**
+    Fuses depth frames into a truncated signed distance field, using the poses passed with the depth frames or set with set_pose.
+    Every depth frame outputs a sparse points frame, see points::size, of the surface in the part of the volume the frame updated
+    */
+    class tsdf_integrator : public filter
+    {
+    public:
+        tsdf_integrator() : filter(init(), 1) {}
+
+        /**
+        * \param[in] voxel_size   Edge of a voxel in meters
+        * \param[in] truncation   Distance in meters around the surface the signed distance is kept within
+        */
+        tsdf_integrator(float voxel_size, float truncation) : filter(init(), 1)
+        {
+            set_option(RS2_OPTION_VOXEL_SIZE, voxel_size);
+            set_option(RS2_OPTION_TSDF_TRUNCATION_DISTANCE, truncation);
+        }
+
+        /**
+        * Sets the pose of the depth sensor for the next depth frames, until the next pose frame
+        * \param[in] world_from_depth  translation and rotation of the depth sensor in the world
+        */
+        void set_pose(const rs2_pose& world_from_depth)
+        {
+            rs2_error* e = nullptr;
+            rs2_tsdf_integrator_set_pose(get(), &world_from_depth, &e);
+            error::handle(e);
+        }
+
+        /**
+        * Clears the volume
+        */
+        void reset()
+        {
+            rs2_error* e = nullptr;
+            rs2_tsdf_integrator_reset(get(), &e);
+            error::handle(e);
+        }
+
+    private:
+        std::shared_ptr<rs2_processing_block> init()
+        {
+            rs2_error* e = nullptr;
+            auto block = std::shared_ptr<rs2_processing_block>(
+                rs2_create_tsdf_integrator_block(&e),
+                rs2_delete_processing_block);
+            error::handle(e);
+
+            return block;
+        }
+    };
+
+    /**
+    Joins the vertices of neighboring depth pixels of a pointcloud into triangles, leaving out the depth discontinuities.
+    The output is a video frame of RS2_FORMAT_MESH_INDICES, a single row of faces of three indices into the vertices of the points frame
+    */
+    class mesh_generator : public filter
+    {
+    public:
+        mesh_generator() : filter(init(), 1) {}
+
+        /**
+        * \param[in] max_depth_step   Largest depth difference in meters between the vertices of a face
+        */
+        mesh_generator(float max_depth_step) : filter(init(), 1)
+        {
+            set_option(RS2_OPTION_MESH_MAX_DEPTH_STEP, max_depth_step);
+        }
+
+    private:
+        std::shared_ptr<rs2_processing_block> init()
+        {
+            rs2_error* e = nullptr;
+            auto block = std::shared_ptr<rs2_processing_block>(
+                rs2_create_mesh_generator_block(&e),
+                rs2_delete_processing_block);
+            error::handle(e);
+
+            return block;
+        }
+    };
+
+    /**
+    Measures the fill rate and the distribution of the depth over regions of interest of depth frames, in a single pass over each.
+    The output is a video frame of RS2_FORMAT_DEPTH_STATISTICS, a single row of rs2_depth_statistics, one per region
+    */
+    class depth_statistics : public filter
+    {
+    public:
+        depth_statistics() : filter(init(), 1) {}
+
+        /**
+        * Adds a region to measure, in pixels, the bottom right pixel included. Without any region the whole frame is measured
+        */
+        void add_roi(const region_of_interest& roi)
+        {
+            rs2_error* e = nullptr;
+            rs2_depth_statistics_add_roi(get(), roi.min_x, roi.min_y, roi.max_x, roi.max_y, &e);
+            error::handle(e);
+        }
+
+        void clear_rois()
+        {
+            rs2_error* e = nullptr;
+            rs2_depth_statistics_clear_rois(get(), &e);
+            error::handle(e);
+        }
+
+        /**
+        * The statistics of the regions, in the order they were added, held by an output frame of the block
+        */
+        static std::vector<rs2_depth_statistics> get_statistics(const video_frame& f)
+        {
+            auto stats = static_cast<const rs2_depth_statistics*>(f.get_data());
+            return std::vector<rs2_depth_statistics>(stats, stats + f.get_width());
+        }
+
+    private:
+        std::shared_ptr<rs2_processing_block> init()
+        {
+            rs2_error* e = nullptr;
+            auto block = std::shared_ptr<rs2_processing_block>(
+                rs2_create_depth_statistics_block(&e),
+                rs2_delete_processing_block);
+            error::handle(e);
+
+            return block;
+        }
+    };
+
+    /**
+    Bins depth frames straight into a grid on the ground, without a pointcloud, in a single pass over each. The output is a video
+    frame of RS2_FORMAT_HEIGHT_MAP, the height of the highest point of each cell, or of RS2_FORMAT_OCCUPANCY_GRID with RS2_OPTION_GRID_OCCUPANCY
+    */
+    class height_map : public filter
+    {
+    public:
+        height_map() : filter(init(), 1) {}
+
+        /**
+        * Sets the pose of the depth sensor in the ground frame, x to the right, y forward and z up
+        */
+        void set_ground(const rs2_extrinsics& depth_to_ground)
+        {
+            rs2_error* e = nullptr;
+            rs2_height_map_set_ground(get(), &depth_to_ground, &e);
+            error::handle(e);
+        }
+
+    private:
+        std::shared_ptr<rs2_processing_block> init()
+        {
+            rs2_error* e = nullptr;
+            auto block = std::shared_ptr<rs2_processing_block>(
+                rs2_create_height_map_block(&e),
+                rs2_delete_processing_block);
+            error::handle(e);
+
+            return block;
+        }
+    };
+
+    /**
+    Pairs the accel and gyro samples of a motion sensor. Both streams are interpolated onto the timestamps of the output,
+    producing one frameset of an accel and a gyro frame per timestamp. Motion frames and framesets are passed with operator()
+    */
+    class imu_fusion : public processing_block
+    {
+    public:
+        /**
+        * \param[in] rate         Output rate in Hz, 0 outputs at the gyro timestamps
+        * \param[in] queue_size   Number of framesets kept for wait_for_frames and poll_for_frames
+        */
+        imu_fusion(float rate = 0.f, int queue_size = 32)
+            : processing_block(init(rate)), _results(queue_size)
+        {
+            start(_results);
+        }
+
+        /**
+        * Wait until the next pair of samples becomes available
+        * \param[in] timeout_ms   Max time in milliseconds to wait until an exception will be thrown
+        * \return Set of an accel and a gyro frame
+        */
+        frameset wait_for_frames(unsigned int timeout_ms = 5000) const
+        {
+            return frameset(_results.wait_for_frame(timeout_ms));
+        }
+
+        /**
+        * Check if a pair of samples is available
+        * \param[out] fs      New frameset
+        * \return true if new frameset was stored to result
+        */
+        bool poll_for_frames(frameset* fs) const
+        {
+            frame result;
+            if (_results.poll_for_frame(&result))
+            {
+                *fs = frameset(result);
+                return true;
+            }
+            return false;
+        }
+
+        void operator()(frame f) const
+        {
+            invoke(std::move(f));
+        }
+
+    private:
+        std::shared_ptr<rs2_processing_block> init(float rate)
+        {
+            rs2_error* e = nullptr;
+            auto block = std::shared_ptr<rs2_processing_block>(
+                rs2_create_imu_fusion_block(rate, &e),
+                rs2_delete_processing_block);
+
+            error::handle(e);
+            return block;
+        }
+
+        frame_queue _results;
+    };
+
+    /**
+    * Find the depth pixels of many color pixels, searching along their lines like rs2_project_color_pixel_to_depth_pixel
+    * \param[in] depth_scale    depth units of the depth sensor, in meters
+    * \param[in] depth_min      nearest depth searched, in meters
+    * \param[in] depth_max      farthest depth searched, in meters
+    * \return one depth pixel per color pixel, (-1, -1) for the pixels with no depth along their line
+    */
+    inline std::vector<std::array<float, 2>> project_color_pixels_to_depth_pixels(const depth_frame& depth, float depth_scale,
+        const video_stream_profile& color_profile, float depth_min, float depth_max, const std::vector<std::array<float, 2>>& color_pixels)
+    {
+        std::vector<std::array<float, 2>> depth_pixels(color_pixels.size());
+        if (color_pixels.empty())
+            return depth_pixels;
+
+        auto depth_profile = depth.get_profile().as<video_stream_profile>();
+        auto depth_intrin = depth_profile.get_intrinsics();
+        auto color_intrin = color_profile.get_intrinsics();
+        auto color_to_depth = color_profile.get_extrinsics_to(depth_profile);
+        auto depth_to_color = depth_profile.get_extrinsics_to(color_profile);
+
+        rs2_error* e = nullptr;
+        rs2_project_color_pixels_to_depth_pixels(&depth_pixels[0][0], static_cast<const uint16_t*>(depth.get_data()), depth_scale,
+            depth_min, depth_max, &depth_intrin, &color_intrin, &color_to_depth, &depth_to_color,
+            &color_pixels[0][0], static_cast<int>(color_pixels.size()), &e);
+        error::handle(e);
+
+        return depth_pixels;
+    }
 }
 #endif // LIBREALSENSE_RS2_PROCESSING_HPP
@@ -126,6 +126,49 @@ namespace rs2
             error::handle(e);
         }
 
+        /**
+        * Set the number of frames that playback reads and decodes ahead of the play position
+        * \param[in] frames  Number of frames to read ahead, between 0 (disabled) and 16
+        */
+        void set_prefetch_size(int frames) const
+        {
+            rs2_error* e = nullptr;
+            rs2_playback_device_set_prefetch_size(_dev.get(), frames, &e);
+            error::handle(e);
+        }
+
+        /**
+        * Skip the frames that real time playback delivers later than their recorded time by more than the given lateness,
+        * so a consumer that falls behind catches up instead of lagging further. Skipped frames are counted as dropped
+        * \param[in] max_lateness  Lateness in milliseconds, 0 (the default) delivers every frame
+        */
+        void skip_late_frames(float max_lateness) const
+        {
+            rs2_error* e = nullptr;
+            rs2_playback_device_skip_late_frames(_dev.get(), max_lateness, &e);
+            error::handle(e);
+        }
+
+        /**
+        * Process the recording in parallel, outside of playback. The recording is split into contiguous time ranges, one per block,
+        * each read on its own thread and passed in order through its block only.
+        * Processed frames are delivered on the calling thread one range after the other, keeping the recorded order of every stream.
+        * \param[in] blocks    Processing blocks, one per range. Their output callbacks are replaced
+        * \param[in] on_frame  Callback receiving the processed frames
+        * The type of the blocks is a template parameter, since rs_processing.hpp includes this header before it defines processing_block
+        */
+        template<class B, class S>
+        void process_ranges(const std::vector<B>& blocks, S on_frame) const
+        {
+            std::vector<rs2_processing_block*> ptrs;
+            for (auto&& block : blocks)
+                ptrs.push_back(block.get());
+
+            rs2_error* e = nullptr;
+            rs2_playback_device_process_ranges(_dev.get(), ptrs.data(), static_cast<int>(ptrs.size()), new frame_callback<S>(on_frame), &e);
+            error::handle(e);
+        }
+
         /**
         * Set the playing speed
         * \param[in] speed  Indicates a multiplication of the speed to play (e.g: 1 = normal, 0.5 twice as slow)
@@ -200,6 +243,98 @@ namespace rs2
     private:
         std::string m_file;
     };
+
+    /**
+    * Plays the recordings of a rig together: the playback devices of the group pace their frames on one clock and prefetch
+    * on one pool of reader threads. The group pauses, resumes and seeks all of them, or steps them along the timeline
+    */
+    class playback_group
+    {
+    public:
+        /**
+        * \param[in] reader_threads  Threads of the pool reading the recordings ahead, 0 for a default based on the hardware threads
+        */
+        explicit playback_group(int reader_threads = 0)
+        {
+            rs2_error* e = nullptr;
+            _group = std::shared_ptr<rs2_playback_group>(
+                rs2_create_playback_group(reader_threads, &e),
+                rs2_delete_playback_group);
+            error::handle(e);
+        }
+
+        /**
+        * Adds a playback device to the group, preferably before it starts streaming
+        */
+        void add(const playback& device)
+        {
+            rs2_error* e = nullptr;
+            rs2_playback_group_add_device(_group.get(), device.get().get(), &e);
+            error::handle(e);
+        }
+
+        void pause()
+        {
+            rs2_error* e = nullptr;
+            rs2_playback_group_pause(_group.get(), &e);
+            error::handle(e);
+        }
+
+        void resume()
+        {
+            rs2_error* e = nullptr;
+            rs2_playback_group_resume(_group.get(), &e);
+            error::handle(e);
+        }
+
+        /**
+        * Sets all the devices to the same position in time
+        * \param[in] time  The time since the beginning of the recordings
+        */
+        void seek(std::chrono::nanoseconds time)
+        {
+            rs2_error* e = nullptr;
+            rs2_playback_group_seek(_group.get(), time.count(), &e);
+            error::handle(e);
+        }
+
+        /**
+        * Sets the playing speed of all the devices
+        * \param[in] speed  Indicates a multiplication of the speed to play (e.g: 1 = normal, 0.5 twice as slow)
+        */
+        void set_playback_speed(float speed)
+        {
+            rs2_error* e = nullptr;
+            rs2_playback_group_set_playback_speed(_group.get(), speed, &e);
+            error::handle(e);
+        }
+
+        /**
+        * While stepping, the devices deliver the frames up to the position stepped to, as fast as they are consumed,
+        * and wait for the next step. Stepping starts at the position of the device furthest behind
+        */
+        void set_stepping(bool stepping)
+        {
+            rs2_error* e = nullptr;
+            rs2_playback_group_set_stepping(_group.get(), stepping, &e);
+            error::handle(e);
+        }
+
+        /**
+        * Moves the position of the stepping group forward
+        * \param[in] duration  Time to move the position by
+        */
+        void step(std::chrono::nanoseconds duration)
+        {
+            rs2_error* e = nullptr;
+            rs2_playback_group_step(_group.get(), duration.count(), &e);
+            error::handle(e);
+        }
+
+    private:
+        std::shared_ptr<rs2_playback_group> _group;
+    };
+
     class recorder : public device
     {
     public:
@@ -266,6 +401,90 @@ namespace rs2
             error::handle(e);
             return filename;
         }
+
+        /**
+        * Sets the maximal size of the frames waiting to be written to file
+        * \param[in] bytes    Memory budget of the write queue, in bytes
+        */
+        void set_memory_budget(unsigned long long bytes)
+        {
+            rs2_error* e = nullptr;
+            rs2_record_device_set_memory_budget(_dev.get(), bytes, &e);
+            error::handle(e);
+        }
+
+        /**
+        * Sets whether frames of the given stream are dropped or block the sensor when the write queue is over the memory budget
+        * \param[in] stream   Stream type
+        * \param[in] index    Stream index
+        * \param[in] policy   Drop or block new frames of the stream
+        */
+        void set_write_policy(rs2_stream stream, int index, rs2_record_write_policy policy)
+        {
+            rs2_error* e = nullptr;
+            rs2_record_device_set_stream_write_policy(_dev.get(), stream, index, policy, &e);
+            error::handle(e);
+        }
+
+        /**
+        * Sets the size of the chunks in which messages are batched before being written to file
+        * \param[in] bytes    Chunk size, in bytes
+        */
+        void set_chunk_size(unsigned int bytes)
+        {
+            rs2_error* e = nullptr;
+            rs2_record_device_set_chunk_size(_dev.get(), bytes, &e);
+            error::handle(e);
+        }
+
+        /**
+        * Selects between per-frame metadata messages (the default) and compact columnar metadata blocks
+        * \param[in] enable    Write the metadata of consecutive frames of each stream as one block
+        */
+        void set_columnar_metadata(bool enable)
+        {
+            rs2_error* e = nullptr;
+            rs2_record_device_set_columnar_metadata(_dev.get(), enable ? 1 : 0, &e);
+            error::handle(e);
+        }
+
+        /**
+        * Selects whether the Z16 frames of a stream are written losslessly compressed
+        * \param[in] stream    Stream type
+        * \param[in] index     Stream index
+        * \param[in] enable    Compress the depth frames of the stream
+        */
+        void set_stream_compression(rs2_stream stream, int index, bool enable)
+        {
+            rs2_error* e = nullptr;
+            rs2_record_device_set_stream_compression(_dev.get(), stream, index, enable ? 1 : 0, &e);
+            error::handle(e);
+        }
+
+        /**
+        * Splits the recording into files of at most the given amount of frame data or duration, 0 for no limit
+        * \param[in] bytes        Frame data per segment, in bytes
+        * \param[in] duration_ms  Duration of each segment, in milliseconds
+        */
+        void set_segment_limits(unsigned long long bytes, unsigned long long duration_ms)
+        {
+            rs2_error* e = nullptr;
+            rs2_record_device_set_segment_limits(_dev.get(), bytes, duration_ms, &e);
+            error::handle(e);
+        }
+
+        /**
+        * Retrieves the state of the recorder's write queue
+        * \return Queue depth, drop counts and write rate
+        */
+        rs2_record_stats get_stats() const
+        {
+            rs2_error* e = nullptr;
+            rs2_record_stats stats;
+            rs2_record_device_get_stats(_dev.get(), &stats, &e);
+            error::handle(e);
+            return stats;
+        }
     protected:
         explicit recorder(std::shared_ptr<rs2_device> dev) : device(dev)
         {
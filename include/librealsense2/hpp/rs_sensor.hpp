@@ -6,6 +6,7 @@
 
 #include "rs_types.hpp"
 #include "rs_frame.hpp"
+#include <future>
 
 namespace rs2
 {
@@ -97,6 +98,51 @@ namespace rs2
         void release() override { delete this; }
     };
 
+    template<class T>
+    class option_changed_callback : public rs2_option_changed_callback
+    {
+        T on_value_changed_function;
+    public:
+        explicit option_changed_callback(T on_value_changed) : on_value_changed_function(on_value_changed) {}
+
+        void on_value_changed(rs2_option option, float value) override
+        {
+            on_value_changed_function(option, value);
+        }
+
+        void release() override { delete this; }
+    };
+
+    template<class T>
+    class option_set_callback : public rs2_option_set_callback
+    {
+        T on_set_function;
+    public:
+        explicit option_set_callback(T on_set) : on_set_function(on_set) {}
+
+        void on_set(rs2_option option, float value, rs2_error* error) override
+        {
+            on_set_function(option, value, error);
+        }
+
+        void release() override { delete this; }
+    };
+
+    template<class T>
+    class frame_control_callback : public rs2_frame_control_callback
+    {
+        T on_status_function;
+    public:
+        explicit frame_control_callback(T on_status) : on_status_function(on_status) {}
+
+        void on_status(const rs2_frame_control_status* status) override
+        {
+            on_status_function(*status);
+        }
+
+        void release() override { delete this; }
+    };
+
     template<class T>
     class frame_callback : public rs2_frame_callback
     {
@@ -112,6 +158,35 @@ namespace rs2
         void release() override { delete this; }
     };
 
+    /**
+    * User-provided frame buffer allocation.
+    * Buffers are requested from the streaming threads and returned from whichever thread releases the last
+    * reference to the frame, so implementations must be thread-safe
+    */
+    class frame_allocator
+    {
+    public:
+        /**
+        * \param[in] size   requested buffer size in bytes
+        * \return           buffer to write the frame into, or nullptr to let the library allocate it internally
+        */
+        virtual void* allocate(size_t size) = 0;
+        virtual void deallocate(void* buffer, size_t size) = 0;
+        virtual ~frame_allocator() = default;
+    };
+
+    class frame_allocator_adapter : public rs2_frame_allocator
+    {
+        std::shared_ptr<frame_allocator> _allocator;
+    public:
+        explicit frame_allocator_adapter(std::shared_ptr<frame_allocator> allocator) : _allocator(std::move(allocator)) {}
+
+        void* allocate(size_t size) override { return _allocator->allocate(size); }
+        void deallocate(void* buffer, size_t size) override { _allocator->deallocate(buffer, size); }
+
+        void release() override { delete this; }
+    };
+
     class options
     {
     public:
@@ -168,6 +243,17 @@ namespace rs2
             return res;
         }
 
+        /**
+        * read option's value, when the option is supported
+        * \param[in] option   option id to be queried
+        * \param[out] value   receives the value of the option
+        * \return true if the option is supported, an unsupported option doesn't throw
+        */
+        bool try_get_option(rs2_option option, float& value) const
+        {
+            return rs2_try_get_option(_options, option, &value) != 0;
+        }
+
         /**
         * retrieve the available range of values of a supported option
         * \return option  range containing minimum and maximum values, step and default value
@@ -182,6 +268,20 @@ namespace rs2
             return result;
         }
 
+        /**
+        * read the value, range and read-only flag of all the supported options at once
+        * \return state of every supported option, ordered by option id
+        */
+        std::vector<rs2_option_value> get_options_snapshot() const
+        {
+            std::vector<rs2_option_value> values(RS2_OPTION_COUNT);
+            rs2_error* e = nullptr;
+            auto count = rs2_get_options_snapshot(_options, values.data(), static_cast<int>(values.size()), &e);
+            error::handle(e);
+            values.resize(count);
+            return values;
+        }
+
         /**
         * write new value to the option
         * \param[in] option     option id to be queried
@@ -194,6 +294,56 @@ namespace rs2
             error::handle(e);
         }
 
+        /**
+        * write new value to the option without waiting for the device. a write still pending when the option is set again
+        * only sends the newest value, and fields of one device control set together are sent in a single write
+        * \param[in] option     option id to be written
+        * \param[in] value      new value for the option
+        * \return future that becomes ready once the value, or a newer one, is written, holding the error if the write failed
+        */
+        std::future<void> set_option_async(rs2_option option, float value) const
+        {
+            auto done = std::make_shared<std::promise<void>>();
+            auto result = done->get_future();
+            auto on_set = [done](rs2_option, float, rs2_error* err)
+            {
+                if (err)
+                    done->set_exception(std::make_exception_ptr(error(err)));
+                else
+                    done->set_value();
+            };
+
+            rs2_error* e = nullptr;
+            rs2_set_option_async(_options, option, value, new option_set_callback<decltype(on_set)>(on_set), &e);
+            error::handle(e);
+            return result;
+        }
+
+        /**
+        * serve reads of the option from its last known value, refreshed on set and from frame metadata
+        * \param[in] option     option id to be cached
+        * \param[in] enable     false to query the device on every read
+        */
+        void enable_option_cache(rs2_option option, bool enable = true) const
+        {
+            rs2_error* e = nullptr;
+            rs2_set_option_cache(_options, option, enable ? 1 : 0, &e);
+            error::handle(e);
+        }
+
+        /**
+        * register a callback invoked with the option id and its new value whenever the value changes
+        * \param[in] option     option id to be observed
+        * \param[in] callback   callable object, may be invoked from the frame callback thread
+        */
+        template<class T>
+        void set_option_changed_callback(rs2_option option, T callback) const
+        {
+            rs2_error* e = nullptr;
+            rs2_set_option_changed_callback_cpp(_options, option, new option_changed_callback<T>(std::move(callback)), &e);
+            error::handle(e);
+        }
+
         /**
         * check if particular option is read-only
         * \param[in] option     option id to be checked
@@ -344,6 +494,106 @@ namespace rs2
             error::handle(e);
         }
 
+        /**
+        * queue an option value for the given frame number of the sensor. The value is written ahead of the frame,
+        * and the frame metadata confirms when it took effect, see set_frame_control_callback
+        * \param[in] option        option id to be set
+        * \param[in] value         value of the option
+        * \param[in] frame_number  frame number of the sensor the value is meant for
+        */
+        void queue_frame_option(rs2_option option, float value, unsigned long long frame_number) const
+        {
+            rs2_error* e = nullptr;
+            rs2_queue_frame_option(_sensor.get(), option, value, frame_number, &e);
+            error::handle(e);
+        }
+
+        /**
+        * register to receive the outcome of every queued frame control
+        * \param[in] callback   any callable object accepting rs2_frame_control_status
+        */
+        template<class T>
+        void set_frame_control_callback(T callback) const
+        {
+            rs2_error* e = nullptr;
+            rs2_set_frame_control_callback_cpp(_sensor.get(),
+                new frame_control_callback<T>(std::move(callback)), &e);
+            error::handle(e);
+        }
+
+
+        /**
+        * set a user-provided allocator for the frame buffers of this sensor. Takes effect on the next open
+        * \param[in] allocator   allocator to obtain frame buffers from
+        */
+        void set_frame_allocator(std::shared_ptr<frame_allocator> allocator) const
+        {
+            rs2_error* e = nullptr;
+            rs2_set_frame_allocator_cpp(_sensor.get(), new frame_allocator_adapter(std::move(allocator)), &e);
+            error::handle(e);
+        }
+
+        /**
+        * place the frame buffers of this sensor on a NUMA node, replacing any allocator. Takes effect on the next open
+        * \param[in] numa_node    node the buffers are placed on, RS2_NUMA_NODE_LOCAL for the node the sensor is attached to
+        * \param[in] huge_pages   back the buffers of 2MB or more with huge pages
+        * \param[in] pin_threads  move the threads delivering the frames to the cores of the node
+        */
+        void set_frame_allocation_policy(int numa_node = RS2_NUMA_NODE_LOCAL, bool huge_pages = true, bool pin_threads = true) const
+        {
+            rs2_error* e = nullptr;
+            rs2_set_frame_allocation_policy(_sensor.get(), numa_node, huge_pages, pin_threads, &e);
+            error::handle(e);
+        }
+
+        /**
+        * retrieve the NUMA node of the bus this sensor is attached to
+        * \return   the node, or -1 when it's unknown
+        */
+        int get_numa_node() const
+        {
+            rs2_error* e = nullptr;
+            auto node = rs2_get_sensor_numa_node(_sensor.get(), &e);
+            error::handle(e);
+            return node;
+        }
+
+        /**
+        * allocate the frame buffers of this sensor in memory mapped into the GPU, replacing any allocator, so that the CUDA
+        * processing blocks read them in place on GPUs sharing the memory of the CPU. Takes effect on the next open
+        */
+        void set_cuda_frame_allocation() const
+        {
+            rs2_error* e = nullptr;
+            rs2_set_cuda_frame_allocation(_sensor.get(), &e);
+            error::handle(e);
+        }
+
+        /**
+        * retrieve the frame memory held by this sensor
+        * \return   the memory of the sensor
+        */
+        rs2_memory_usage get_memory_usage() const
+        {
+            rs2_error* e = nullptr;
+            rs2_memory_usage usage;
+            rs2_get_sensor_memory_usage(_sensor.get(), &usage, &e);
+            error::handle(e);
+            return usage;
+        }
+
+        /**
+        * estimate the USB bandwidth a stream profile of this sensor takes
+        * \param[in] profile   a stream profile of this sensor
+        * \return              the payload of the stream, in bytes per second
+        */
+        unsigned long long get_bandwidth(const stream_profile& profile) const
+        {
+            rs2_error* e = nullptr;
+            auto bandwidth = rs2_get_stream_profile_bandwidth(_sensor.get(), profile.get(), &e);
+            error::handle(e);
+            return bandwidth;
+        }
 
         /**
         * check if physical sensor is supported
@@ -471,6 +721,18 @@ namespace rs2
             return roi;
         }
 
+        /**
+        * queue the region of interest of auto-exposure for the given frame number, see sensor::queue_frame_option
+        * \param[in] roi           region of interest
+        * \param[in] frame_number  frame number of the sensor the region is meant for
+        */
+        void queue_region_of_interest(const region_of_interest& roi, unsigned long long frame_number)
+        {
+            rs2_error* e = nullptr;
+            rs2_queue_frame_region_of_interest(_sensor.get(), roi.min_x, roi.min_y, roi.max_x, roi.max_y, frame_number, &e);
+            error::handle(e);
+        }
+
         operator bool() const { return _sensor.get() != nullptr; }
     };
 
@@ -529,5 +791,36 @@ namespace rs2
 
         operator bool() const { return _sensor.get() != nullptr; }
     };
+
+    class pose_sensor : public sensor
+    {
+    public:
+        pose_sensor(sensor s)
+            : sensor(s.get())
+        {
+            rs2_error* e = nullptr;
+            if (rs2_is_sensor_extendable_to(_sensor.get(), RS2_EXTENSION_POSE_SENSOR, &e) == 0 && !e)
+            {
+                _sensor.reset();
+            }
+            error::handle(e);
+        }
+
+        /** Copies the most recent pose of the stream without waiting for its frame, for loops polling at their own rate
+        * \param[out] pose       the most recent pose
+        * \param[out] timestamp  timestamp of the pose in milliseconds
+        * \return false while the stream has not delivered any pose
+        */
+        bool get_latest_pose(rs2_pose& pose, rs2_time_t& timestamp) const
+        {
+            rs2_error* e = nullptr;
+            auto res = rs2_get_latest_pose(_sensor.get(), &pose, &timestamp, &e);
+            error::handle(e);
+            return res != 0;
+        }
+
+        operator bool() const { return _sensor.get() != nullptr; }
+        explicit pose_sensor(std::shared_ptr<rs2_sensor> dev) : pose_sensor(sensor(dev)) {}
+    };
 }
 #endif // LIBREALSENSE_RS2_SENSOR_HPP
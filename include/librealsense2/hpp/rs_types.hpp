@@ -43,6 +43,27 @@ struct rs2_notifications_callback
     virtual                                 ~rs2_notifications_callback() {}
 };
 
+struct rs2_option_changed_callback
+{
+    virtual void                            on_value_changed(rs2_option option, float value) = 0;
+    virtual void                            release() = 0;
+    virtual                                 ~rs2_option_changed_callback() {}
+};
+
+struct rs2_option_set_callback
+{
+    virtual void                            on_set(rs2_option option, float value, rs2_error* error) = 0;
+    virtual void                            release() = 0;
+    virtual                                 ~rs2_option_set_callback() {}
+};
+
+struct rs2_frame_control_callback
+{
+    virtual void                            on_status(const rs2_frame_control_status* status) = 0;
+    virtual void                            release() = 0;
+    virtual                                 ~rs2_frame_control_callback() {}
+};
+
 struct rs2_log_callback
 {
     virtual void                            on_event(rs2_log_severity severity, const char * message) = 0;
@@ -57,6 +78,14 @@ struct rs2_devices_changed_callback
     virtual                                 ~rs2_devices_changed_callback() {}
 };
 
+struct rs2_frame_allocator
+{
+    virtual void*                           allocate(size_t size) = 0;
+    virtual void                            deallocate(void* buffer, size_t size) = 0;
+    virtual void                            release() = 0;
+    virtual                                 ~rs2_frame_allocator() {}
+};
+
 struct rs2_playback_status_changed_callback
 {
     virtual void                            on_playback_status_changed(rs2_playback_status status) = 0;
@@ -79,6 +79,77 @@ void rs2_log_to_file(rs2_log_severity min_severity, const char * file_path, rs2_
  */
 void rs2_log(rs2_log_severity severity, const char * message, rs2_error ** error);
 
+/**
+ * Write the last messages sent to the console or to the log file into a file, oldest first. The library keeps
+ * the last 1024 of them
+ * \param[in] file_path  The file to write
+ * \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ */
+void rs2_dump_log_history(const char * file_path, rs2_error ** error);
+
+/** \brief Points of the path of a frame from its arrival on the host to its release, where the library measures its latency */
+typedef enum rs2_pipeline_stage
+{
+    RS2_PIPELINE_STAGE_PUBLISHED,   /**< The frame got its buffer from the frame archive of the sensor */
+    RS2_PIPELINE_STAGE_UNPACKED,    /**< The pixels were converted or copied into the frame */
+    RS2_PIPELINE_STAGE_SYNCED,      /**< A syncer matched the frame into a frameset */
+    RS2_PIPELINE_STAGE_DISPATCHED,  /**< The frame callback of the sensor returned */
+    RS2_PIPELINE_STAGE_RELEASED,    /**< The last reference to the frame was released */
+    RS2_PIPELINE_STAGE_COUNT
+} rs2_pipeline_stage;
+
+const char* rs2_pipeline_stage_to_string(rs2_pipeline_stage stage);
+
+/** \brief Distribution of the time from the arrival of the frames of a stream to one stage, since the library was loaded or the statistics were reset */
+typedef struct rs2_pipeline_stage_stats
+{
+    unsigned long long frames;  /**< Frames of the stream that reached the stage */
+    float average_latency_ms;   /**< Mean time from arrival to the stage */
+    float p50_latency_ms;       /**< Median, histogram percentiles are accurate to about 3% */
+    float p90_latency_ms;       /**< 90th percentile */
+    float p99_latency_ms;       /**< 99th percentile */
+    float max_latency_ms;       /**< Longest time from arrival to the stage */
+} rs2_pipeline_stage_stats;
+
+/**
+* Retrieves the latency statistics of the frames of a stream type, collected for frames coming from sensors
+* \param[in] stream         Stream type, RS2_STREAM_ANY for the frames of all streams
+* \param[in] stage          Stage the latency is measured to
+* \param[out] stats         Receives the statistics of the stage
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_get_pipeline_stats(rs2_stream stream, rs2_pipeline_stage stage, rs2_pipeline_stage_stats* stats, rs2_error** error);
+
+/**
+* Clears the latency statistics of all streams and the recent trace events
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_reset_pipeline_stats(rs2_error** error);
+
+/**
+* Writes the stages of the most recent frames as a Chrome trace (JSON), viewable in chrome://tracing or Perfetto
+* \param[in] file_path      Path of the file to write
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_export_pipeline_trace(const char* file_path, rs2_error** error);
+
+/** \brief Counters of the event loop shared by the capture of all UVC devices, summed over its worker threads */
+typedef struct rs2_capture_reactor_stats
+{
+    unsigned long long wakeups;     /**< Times a worker returned from waiting on the devices */
+    unsigned long long dispatches;  /**< Batches of device events handled */
+    double total_dispatch_ms;       /**< Time spent handling the batches */
+    double max_dispatch_ms;         /**< Longest single batch */
+} rs2_capture_reactor_stats;
+
+/**
+* Retrieves the counters of the shared capture event loop. Only the V4L2 backend has one, enabled by setting LRS_V4L2_REACTOR_THREADS
+* \param[out] stats         Receives the counters, zeroed when there is no such loop
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return 1 when the loop is enabled, 0 otherwise
+*/
+int rs2_get_capture_reactor_stats(rs2_capture_reactor_stats* stats, rs2_error** error);
+
 /**
 * Given the 2D depth coordinate (x,y) provide the corresponding depth in metric units
 * \param[in] frame_ref  2D depth pixel coordinates (Left-Upper corner origin)
@@ -36,6 +36,55 @@ namespace rs2
         rs2_log(severity, message, &e);
         error::handle(e);
     }
+
+    inline void dump_log_history(const char* file_path)
+    {
+        rs2_error* e = nullptr;
+        rs2_dump_log_history(file_path, &e);
+        error::handle(e);
+    }
+
+    /**
+    * Retrieve the latency from arrival to one stage of the frames of a stream
+    * \param[in] stream     stream type, RS2_STREAM_ANY for all streams
+    * \param[in] stage      stage the latency is measured to
+    * \return statistics since the library was loaded or the last reset
+    */
+    inline rs2_pipeline_stage_stats get_pipeline_stats(rs2_stream stream, rs2_pipeline_stage stage)
+    {
+        rs2_error* e = nullptr;
+        rs2_pipeline_stage_stats stats;
+        rs2_get_pipeline_stats(stream, stage, &stats, &e);
+        error::handle(e);
+        return stats;
+    }
+
+    inline void reset_pipeline_stats()
+    {
+        rs2_error* e = nullptr;
+        rs2_reset_pipeline_stats(&e);
+        error::handle(e);
+    }
+
+    inline void export_pipeline_trace(const char* file_path)
+    {
+        rs2_error* e = nullptr;
+        rs2_export_pipeline_trace(file_path, &e);
+        error::handle(e);
+    }
+
+    /**
+    * Retrieve the counters of the event loop shared by the capture of the UVC devices
+    * \param[out] stats    receives the counters, zeroed when the backend does not use such a loop
+    * \return whether the loop is enabled
+    */
+    inline bool get_capture_reactor_stats(rs2_capture_reactor_stats& stats)
+    {
+        rs2_error* e = nullptr;
+        auto enabled = rs2_get_capture_reactor_stats(&stats, &e);
+        error::handle(e);
+        return enabled != 0;
+    }
 }
 
 inline std::ostream & operator << (std::ostream & o, rs2_stream stream) { return o << rs2_stream_to_string(stream); }
@@ -50,5 +99,8 @@ inline std::ostream & operator << (std::ostream & o, rs2_notification_category n
 inline std::ostream & operator << (std::ostream & o, rs2_sr300_visual_preset preset) { return o << rs2_sr300_visual_preset_to_string(preset); }
 inline std::ostream & operator << (std::ostream & o, rs2_exception_type exception_type) { return o << rs2_exception_type_to_string(exception_type); }
 inline std::ostream & operator << (std::ostream & o, rs2_playback_status status) { return o << rs2_playback_status_to_string(status); }
+inline std::ostream & operator << (std::ostream & o, rs2_pipeline_stage stage) { return o << rs2_pipeline_stage_to_string(stage); }
+inline std::ostream & operator << (std::ostream & o, rs2_thread_category category) { return o << rs2_thread_category_to_string(category); }
+inline std::ostream & operator << (std::ostream & o, rs2_frame_control_state state) { return o << rs2_frame_control_state_to_string(state); }
 
 #endif // LIBREALSENSE_RS2_HPP
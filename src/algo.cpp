@@ -26,6 +26,16 @@ float auto_exposure_state::get_auto_exposure_step() const
     return step;
 }
 
+unsigned auto_exposure_state::get_auto_exposure_sample_stride() const
+{
+    return sample_stride;
+}
+
+unsigned auto_exposure_state::get_auto_exposure_skip_frames() const
+{
+    return skip_frames;
+}
+
 void auto_exposure_state::set_enable_auto_exposure(bool value)
 {
     is_auto_exposure = value;
@@ -46,10 +56,20 @@ void auto_exposure_state::set_auto_exposure_step(float value)
     step = value;
 }
 
+void auto_exposure_state::set_auto_exposure_sample_stride(unsigned value)
+{
+    sample_stride = value;
+}
+
+void auto_exposure_state::set_auto_exposure_skip_frames(unsigned value)
+{
+    skip_frames = value;
+}
+
 auto_exposure_mechanism::auto_exposure_mechanism(option& gain_option, option& exposure_option, const auto_exposure_state& auto_exposure_state)
     : _auto_exposure_algo(auto_exposure_state),
       _keep_alive(true), _frames_counter(0),
-      _skip_frames(auto_exposure_state.skip_frames), _data_queue(queue_size),
+      _skip_frames(auto_exposure_state.get_auto_exposure_skip_frames()), _data_queue(queue_size),
       _gain_option(gain_option), _exposure_option(exposure_option)
 {
     _exposure_thread = std::make_shared<std::thread>(
@@ -137,7 +157,7 @@ auto_exposure_mechanism::~auto_exposure_mechanism()
 void auto_exposure_mechanism::update_auto_exposure_state(const auto_exposure_state& auto_exposure_state)
 {
     std::lock_guard<std::mutex> lk(_queue_mtx);
-    _skip_frames = auto_exposure_state.skip_frames;
+    _skip_frames = auto_exposure_state.get_auto_exposure_skip_frames();
     _auto_exposure_algo.update_options(auto_exposure_state);
 }
 
@@ -238,10 +258,11 @@ bool auto_exposure_algorithm::analyze_image(const frame_interface* image)
     }
 
     std::vector<int> H(256);
-    auto total_weight = number_of_pixels;
-
     auto cols = frame->get_width();
-    im_hist((uint8_t*)frame->get_frame_data(), image_roi, frame->get_bpp() / 8 * cols, &H[0]);
+    // The scores are relative to the pixels that were actually sampled
+    auto total_weight = im_hist((uint8_t*)frame->get_frame_data(), image_roi, frame->get_bpp() / 8 * cols, &H[0]);
+    if (total_weight == 0)
+        return false;
 
     histogram_metric score = {};
     histogram_score(H, total_weight, score);
@@ -294,17 +315,66 @@ void auto_exposure_algorithm::update_roi(const region_of_interest& ae_roi)
     is_roi_initialized = true;
 }
 
-void auto_exposure_algorithm::im_hist(const uint8_t* data, const region_of_interest& image_roi, const int rowStep, int h[])
+int auto_exposure_algorithm::im_hist(const uint8_t* data, const region_of_interest& image_roi, const int rowStep, int h[])
 {
     std::lock_guard<std::recursive_mutex> lock(state_mutex);
 
-    for (int i = 0; i < 256; ++i)
-        h[i] = 0;
+    const int stride = std::max(1, static_cast<int>(state.get_auto_exposure_sample_stride()));
+    const int min_x = image_roi.min_x, max_x = image_roi.max_x;
+    if (max_x <= min_x || image_roi.max_y <= image_roi.min_y)
+    {
+        std::fill(h, h + 256, 0);
+        return 0;
+    }
+
+    // Consecutive pixels are counted in separate tables, so that runs of equal values
+    // don't stall on the increments of a single counter
+    uint32_t tables[4][256] = {};
+    uint32_t* t0 = tables[0];
+    uint32_t* t1 = tables[1];
+    uint32_t* t2 = tables[2];
+    uint32_t* t3 = tables[3];
 
+    int rows = 0;
     const uint8_t* rowData = data + (image_roi.min_y * rowStep);
-    for (int i = image_roi.min_y; i < image_roi.max_y; ++i, rowData += rowStep)
-        for (int j = image_roi.min_x; j < image_roi.max_x; j+=state.sample_rate)
-            ++h[rowData[j]];
+    for (int i = image_roi.min_y; i < image_roi.max_y; i += stride, rowData += stride * rowStep, ++rows)
+    {
+        int j = min_x;
+        if (stride == 1)
+        {
+            // Eight pixels per load, the order of the bytes doesn't matter to the histogram
+            for (; j + 8 <= max_x; j += 8)
+            {
+                uint64_t pixels;
+                memcpy(&pixels, rowData + j, sizeof(pixels));
+                ++t0[pixels & 0xFF];
+                ++t1[(pixels >> 8) & 0xFF];
+                ++t2[(pixels >> 16) & 0xFF];
+                ++t3[(pixels >> 24) & 0xFF];
+                ++t0[(pixels >> 32) & 0xFF];
+                ++t1[(pixels >> 40) & 0xFF];
+                ++t2[(pixels >> 48) & 0xFF];
+                ++t3[pixels >> 56];
+            }
+        }
+        else
+        {
+            for (; j + 3 * stride < max_x; j += 4 * stride)
+            {
+                ++t0[rowData[j]];
+                ++t1[rowData[j + stride]];
+                ++t2[rowData[j + 2 * stride]];
+                ++t3[rowData[j + 3 * stride]];
+            }
+        }
+        for (; j < max_x; j += stride)
+            ++t0[rowData[j]];
+    }
+
+    for (int i = 0; i < 256; ++i)
+        h[i] = static_cast<int>(t0[i] + t1[i] + t2[i] + t3[i]);
+
+    return rows * ((max_x - min_x + stride - 1) / stride);
 }
 
 void auto_exposure_algorithm::increase_exposure_target(float mult, float& target_exposure)
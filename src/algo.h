@@ -30,27 +30,32 @@ namespace librealsense
             is_auto_exposure(true),
             mode(auto_exposure_modes::auto_exposure_hybrid),
             rate(60),
-            step(ae_step_default_value)
+            step(ae_step_default_value),
+            sample_stride(1),
+            skip_frames(2)
         {}
 
         bool get_enable_auto_exposure() const;
         auto_exposure_modes get_auto_exposure_mode() const;
         unsigned get_auto_exposure_antiflicker_rate() const;
         float get_auto_exposure_step() const;
+        unsigned get_auto_exposure_sample_stride() const;
+        unsigned get_auto_exposure_skip_frames() const;
 
         void set_enable_auto_exposure(bool value);
         void set_auto_exposure_mode(auto_exposure_modes value);
         void set_auto_exposure_antiflicker_rate(unsigned value);
         void set_auto_exposure_step(float value);
-
-        static const unsigned      sample_rate = 1;
-        static const unsigned      skip_frames = 2;
+        void set_auto_exposure_sample_stride(unsigned value);
+        void set_auto_exposure_skip_frames(unsigned value);
 
     private:
         bool                is_auto_exposure;
         auto_exposure_modes mode;
         unsigned            rate;
         float               step;
+        unsigned            sample_stride; // Histogram sampling step along both image axes
+        unsigned            skip_frames;   // Frames ignored between two analyzed frames
     };
 
 
@@ -66,7 +71,8 @@ namespace librealsense
         struct histogram_metric { int under_exposure_count; int over_exposure_count; int shadow_limit; int highlight_limit; int lower_q; int upper_q; float main_mean; float main_std; };
         enum class rounding_mode_type { round, ceil, floor };
 
-        inline void im_hist(const uint8_t* data, const region_of_interest& image_roi, const int rowStep, int h[]);
+        // Returns the number of sampled pixels
+        inline int im_hist(const uint8_t* data, const region_of_interest& image_roi, const int rowStep, int h[]);
         void increase_exposure_target(float mult, float& target_exposure);
         void decrease_exposure_target(float mult, float& target_exposure);
         void increase_exposure_gain(const float& target_exposure, const float& target_exposure0, float& exposure, float& gain);
@@ -107,12 +107,42 @@ namespace librealsense
         stream_args(out, names, rest...);
     }
 
+    // The last error freed on a thread is kept for its next failure, so a call failing in a loop doesn't allocate
+    inline std::unique_ptr<rs2_error>& spare_error()
+    {
+        static thread_local std::unique_ptr<rs2_error> spare;
+        return spare;
+    }
+
+    inline rs2_error* make_error(const char* message, const char* name, std::string args, rs2_exception_type type)
+    {
+        auto& spare = spare_error();
+        if (!spare)
+            return new rs2_error{ message, name, move(args), type };
+
+        auto error = spare.release();
+        error->message = message;
+        error->function = name;
+        error->args = move(args);
+        error->exception_type = type;
+        return error;
+    }
+
+    inline void recycle_error(rs2_error* error)
+    {
+        auto& spare = spare_error();
+        if (spare)
+            delete error;
+        else
+            spare.reset(error);
+    }
+
     static void translate_exception(const char * name, std::string args, rs2_error ** error)
     {
         try { throw; }
-        catch (const librealsense_exception& e) { if (error) *error = new rs2_error{ e.what(), name, move(args), e.get_exception_type() }; }
-        catch (const std::exception& e) { if (error) *error = new rs2_error{ e.what(), name, move(args) }; }
-        catch (...) { if (error) *error = new rs2_error{ "unknown error", name, move(args) }; }
+        catch (const librealsense_exception& e) { if (error) *error = make_error(e.what(), name, move(args), e.get_exception_type()); }
+        catch (const std::exception& e) { if (error) *error = make_error(e.what(), name, move(args), RS2_EXCEPTION_TYPE_UNKNOWN); }
+        catch (...) { if (error) *error = make_error("unknown error", name, move(args), RS2_EXCEPTION_TYPE_UNKNOWN); }
     }
 
 #ifdef TRACE_API
@@ -409,6 +439,15 @@ return __p.invoke(func);\
     #define VALIDATE_OPTION(OBJ, OPT_ID) if(!OBJ->options->supports_option(OPT_ID)) { std::ostringstream ss; ss << "object doesn't support option #" << std::to_string(OPT_ID); throw librealsense::invalid_value_exception(ss.str()); }
     #define VALIDATE_RANGE(ARG, MIN, MAX) if((ARG) < (MIN) || (ARG) > (MAX)) { std::ostringstream ss; ss << "out of range value for argument \"" #ARG "\""; throw librealsense::invalid_value_exception(ss.str()); }
     #define VALIDATE_LE(ARG, MAX) if((ARG) > (MAX)) { std::ostringstream ss; ss << "out of range value for argument \"" #ARG "\""; throw std::runtime_error(ss.str()); }
+    // Frame counterpart of VALIDATE_INTERFACE, checking the extension flags of the frame instead of a dynamic_cast
+    #define VALIDATE_FRAME(X, T)                                                                \
+    ([&]() -> T* {                                                                              \
+            T* p = librealsense::frame_cast<T>(X);                                              \
+            if(p == nullptr)                                                                    \
+                throw std::runtime_error("Object does not support \"" #T "\" interface! " );    \
+            return p;                                                                           \
+        })()
+
     #define VALIDATE_INTERFACE_NO_THROW(X, T)                                                   \
     ([&]() -> T* {                                                                              \
         T* p = dynamic_cast<T*>(&(*X));                                                         \
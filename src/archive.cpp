@@ -1,8 +1,14 @@
 #include "metadata-parser.h"
 #include "archive.h"
 #include <fstream>
+#include <deque>
+#include <unordered_map>
+#include <sstream>
 #include "core/processing.h"
 #include "core/video.h"
+#include "tracing.h"
+#include "profiling.h"
+#include "proc/mesh-generator.h"
 
 #define MIN_DISTANCE 1e-6
 
@@ -20,143 +26,345 @@ namespace librealsense
     }
     void frame::set_sensor(std::shared_ptr<sensor_interface> s) { sensor = s; }
 
+    // Through get_frame_data, which downloads the points a GL pointcloud left in device memory
     float3* points::get_vertices()
     {
-        auto xyz = (float3*)data.data();
+        auto xyz = (float3*)get_frame_data();
         return xyz;
     }
 
-    std::tuple<uint8_t, uint8_t, uint8_t> get_texcolor(const frame_holder& texture, float u, float v)
-    {
-        auto ptr = dynamic_cast<video_frame*>(texture.frame);
-        if (ptr == nullptr) {
-            throw librealsense::invalid_value_exception("frame must be video frame");
-        }
-        const int w = ptr->get_width(), h = ptr->get_height();
-        int x = std::min(std::max(int(u*w + .5f), 0), w - 1);
-        int y = std::min(std::max(int(v*h + .5f), 0), h - 1);
-        int idx = x * ptr->get_bpp() / 8 + y * ptr->get_stride();
-        const auto texture_data = reinterpret_cast<const uint8_t*>(ptr->get_frame_data());
-        return std::make_tuple(texture_data[idx], texture_data[idx + 1], texture_data[idx + 2]);
-    }
-
-
-    void points::export_to_ply(const std::string& fname, const frame_holder& texture)
+    void points::export_to_ply(const std::string& fname, const frame_holder& texture, bool with_faces)
     {
         auto stream_profile = get_stream().get();
         auto video_stream_profile = dynamic_cast<video_stream_profile_interface*>(stream_profile);
         if (!video_stream_profile)
             throw librealsense::invalid_value_exception("stream must be video stream");
+
+        auto tex = texture ? frame_cast<video_frame>(texture.frame) : nullptr;
+        if (texture && !tex)
+            throw librealsense::invalid_value_exception("frame must be video frame");
+
         const auto vertices = get_vertices();
         const auto texcoords = get_texture_coordinates();
-        std::vector<float3> new_vertices;
-        std::vector<std::tuple<uint8_t, uint8_t, uint8_t>> new_tex;
-        std::map<int, int> index2reducedIndex;
-
-        new_vertices.reserve(get_vertex_count());
-        new_tex.reserve(get_vertex_count());
-        assert(get_vertex_count());
-        for (size_t i = 0; i < get_vertex_count(); ++i)
-            if (fabs(vertices[i].x) >= MIN_DISTANCE || fabs(vertices[i].y) >= MIN_DISTANCE ||
-                fabs(vertices[i].z) >= MIN_DISTANCE)
+        const auto count = get_vertex_count();
+        assert(count);
+
+        // Every vertex record is written in place into one buffer, so the file is written with a few large writes
+        const size_t vertex_size = 3 * sizeof(float) + (tex ? 3 : 0);
+        const size_t face_size = sizeof(uint8_t) + 3 * sizeof(int);
+
+        parallel_executor executor(0);
+
+        // Vertices at the origin carry no depth and are dropped. The ranges are counted first, then compacted
+        // at their offset, with the dense index2reduced mapping each input vertex to its output index or -1
+        std::vector<int> index2reduced(count);
+        const size_t ranges = executor.size() * 4;
+        std::vector<size_t> range_offsets(ranges + 1, 0);
+        auto range_begin = [&](size_t r) { return count * r / ranges; };
+        auto is_valid = [](const float3& v)
+        {
+            return (fabs(v.x) >= MIN_DISTANCE) | (fabs(v.y) >= MIN_DISTANCE) | (fabs(v.z) >= MIN_DISTANCE);
+        };
+
+        executor.for_each(ranges, [&](size_t r)
+        {
+            size_t valid = 0;
+            for (size_t i = range_begin(r); i < range_begin(r + 1); ++i)
+                valid += is_valid(vertices[i]);
+            range_offsets[r + 1] = valid;
+        });
+        for (size_t r = 0; r < ranges; ++r)
+            range_offsets[r + 1] += range_offsets[r];
+        const auto valid_count = range_offsets[ranges];
+
+        std::vector<char> vertex_data(valid_count * vertex_size);
+        int tex_width = 0, tex_height = 0, tex_bpp = 0, tex_stride = 0;
+        const uint8_t* tex_data = nullptr;
+        if (tex)
+        {
+            tex_width = tex->get_width();
+            tex_height = tex->get_height();
+            tex_bpp = tex->get_bpp() / 8;
+            tex_stride = tex->get_stride();
+            tex_data = reinterpret_cast<const uint8_t*>(tex->get_frame_data());
+        }
+
+        executor.for_each(ranges, [&](size_t r)
+        {
+            auto next = range_offsets[r];
+            for (size_t i = range_begin(r); i < range_begin(r + 1); ++i)
             {
-                index2reducedIndex[i] = new_vertices.size();
-                new_vertices.push_back(vertices[i]);
-                if (texture)
+                if (!is_valid(vertices[i]))
                 {
-                    auto color = get_texcolor(texture, texcoords[i].x, texcoords[i].y);
-                    new_tex.push_back(color);
+                    index2reduced[i] = -1;
+                    continue;
                 }
-            }
 
-        const auto threshold = 0.05f;
-        auto width = video_stream_profile->get_width();
-        std::vector<std::tuple<int, int, int>> faces;
-        for (int x = 0; x < width - 1; ++x) {
-            for (int y = 0; y < video_stream_profile->get_height() - 1; ++y) {
-                auto a = y * width + x, b = y * width + x + 1, c = (y + 1)*width + x, d = (y + 1)*width + x + 1;
-                if (vertices[a].z && vertices[b].z && vertices[c].z && vertices[d].z
-                    && abs(vertices[a].z - vertices[b].z) < threshold && abs(vertices[a].z - vertices[c].z) < threshold
-                    && abs(vertices[b].z - vertices[d].z) < threshold && abs(vertices[c].z - vertices[d].z) < threshold)
+                index2reduced[i] = static_cast<int>(next);
+                // we assume little endian architecture on your device
+                auto out = vertex_data.data() + next * vertex_size;
+                memcpy(out, &vertices[i], 3 * sizeof(float));
+                if (tex_data)
                 {
-                    if (index2reducedIndex.count(a) == 0 || index2reducedIndex.count(b) == 0 || index2reducedIndex.count(c) == 0 ||
-                        index2reducedIndex.count(d) == 0)
-                        continue;
-                    faces.emplace_back(index2reducedIndex[a], index2reducedIndex[b], index2reducedIndex[d]);
-                    faces.emplace_back(index2reducedIndex[d], index2reducedIndex[c], index2reducedIndex[a]);
+                    int x = std::min(std::max(int(texcoords[i].x * tex_width + .5f), 0), tex_width - 1);
+                    int y = std::min(std::max(int(texcoords[i].y * tex_height + .5f), 0), tex_height - 1);
+                    memcpy(out + 3 * sizeof(float), tex_data + x * tex_bpp + y * tex_stride, 3);
                 }
+                ++next;
             }
-        }
+        });
 
-        std::ofstream out(fname);
-        out << "ply\n";
-        out << "format binary_little_endian 1.0\n" /*"format ascii 1.0\n"*/;
-        out << "comment pointcloud saved from Realsense Viewer\n";
-        out << "element vertex " << new_vertices.size() << "\n";
-        out << "property float" << sizeof(float) * 8 << " x\n";
-        out << "property float" << sizeof(float) * 8 << " y\n";
-        out << "property float" << sizeof(float) * 8 << " z\n";
-        if (texture)
+        const auto threshold = 0.05f;
+        auto width = video_stream_profile->get_width();
+        auto height = video_stream_profile->get_height();
+
+        // Faces join neighbouring depth pixels. A sparse pointcloud finds them through its pixel indices, and has no faces without them
+        auto pixel_indices = get_pixel_indices();
+        bool sparse = _vertex_count.has_value();
+        std::vector<int> pixel2vertex;
+        if (with_faces && sparse && pixel_indices)
         {
-            out << "property uchar red\n";
-            out << "property uchar green\n";
-            out << "property uchar blue\n";
+            pixel2vertex.assign(width * height, -1);
+            for (size_t i = 0; i < count; ++i)
+                pixel2vertex[pixel_indices[i]] = static_cast<int>(i);
         }
-        out << "element face " << faces.size() << "\n";
-        out << "property list uchar int vertex_indices\n";
-        out << "end_header\n";
-        out.close();
 
-        out.open(fname, std::ios_base::app | std::ios_base::binary);
-        for (int i = 0; i < new_vertices.size(); ++i)
+        // The faces of the mesh generator, renumbered to the vertices written and turned into face records
+        std::vector<std::vector<uint32_t>> faces;
+        if (with_faces && (!sparse || pixel_indices))
+            generate_faces(vertices, width, height, sparse ? pixel2vertex.data() : nullptr, threshold, executor, faces);
+        std::vector<std::vector<char>> face_data(faces.size());
+        executor.for_each(faces.size(), [&](size_t band)
         {
-            // we assume little endian architecture on your device
-            out.write(reinterpret_cast<const char*>(&(new_vertices[i].x)), sizeof(float));
-            out.write(reinterpret_cast<const char*>(&(new_vertices[i].y)), sizeof(float));
-            out.write(reinterpret_cast<const char*>(&(new_vertices[i].z)), sizeof(float));
-
-            if (texture)
+            auto& out = face_data[band];
+            out.reserve(faces[band].size() / 3 * face_size);
+            for (size_t i = 0; i + 2 < faces[band].size(); i += 3)
             {
-                uint8_t x, y, z;
-                std::tie(x, y, z) = new_tex[i];
-                out.write(reinterpret_cast<const char*>(&x), sizeof(uint8_t));
-                out.write(reinterpret_cast<const char*>(&y), sizeof(uint8_t));
-                out.write(reinterpret_cast<const char*>(&z), sizeof(uint8_t));
+                int indices[] = { index2reduced[faces[band][i]], index2reduced[faces[band][i + 1]], index2reduced[faces[band][i + 2]] };
+                if (indices[0] < 0 || indices[1] < 0 || indices[2] < 0)
+                    continue;
+                auto pos = out.size();
+                out.resize(pos + face_size);
+                out[pos] = 3;
+                memcpy(&out[pos + 1], indices, sizeof(indices));
             }
+        });
+
+        size_t face_count = 0;
+        for (auto&& band : face_data)
+            face_count += band.size() / face_size;
+
+        std::stringstream header;
+        header << "ply\n";
+        header << "format binary_little_endian 1.0\n" /*"format ascii 1.0\n"*/;
+        header << "comment pointcloud saved from Realsense Viewer\n";
+        header << "element vertex " << valid_count << "\n";
+        header << "property float" << sizeof(float) * 8 << " x\n";
+        header << "property float" << sizeof(float) * 8 << " y\n";
+        header << "property float" << sizeof(float) * 8 << " z\n";
+        if (tex)
+        {
+            header << "property uchar red\n";
+            header << "property uchar green\n";
+            header << "property uchar blue\n";
         }
-        auto size = faces.size();
-        for (int i = 0; i < size; ++i) {
-            int three = 3;
-            out.write(reinterpret_cast<const char*>(&three), sizeof(uint8_t));
-            out.write(reinterpret_cast<const char*>(&(std::get<0>(faces[i]))), sizeof(int));
-            out.write(reinterpret_cast<const char*>(&(std::get<1>(faces[i]))), sizeof(int));
-            out.write(reinterpret_cast<const char*>(&(std::get<2>(faces[i]))), sizeof(int));
+        if (with_faces)
+        {
+            header << "element face " << face_count << "\n";
+            header << "property list uchar int vertex_indices\n";
         }
+        header << "end_header\n";
+
+        std::ofstream out(fname, std::ios_base::binary | std::ios_base::trunc);
+        if (!out)
+            throw librealsense::io_exception(to_string() << "cannot open " << fname << " for writing");
+
+        auto header_str = header.str();
+        out.write(header_str.data(), header_str.size());
+        out.write(vertex_data.data(), vertex_data.size());
+        for (auto&& band : face_data)
+            out.write(band.data(), band.size());
+
+        if (!out)
+            throw librealsense::io_exception(to_string() << "failed writing " << fname);
+    }
+
+    size_t points::get_capacity() const
+    {
+        return data.size() / (sizeof(float3) + sizeof(int2) + (_pixel_indices ? sizeof(int) : 0) + (_colors ? 3 : 0));
     }
 
     size_t points::get_vertex_count() const
     {
-        return data.size() / (sizeof(float3) + sizeof(int2));
+        return _vertex_count ? *_vertex_count : get_capacity();
     }
 
     float2* points::get_texture_coordinates()
     {
-        auto xyz = (float3*)data.data();
-        auto ijs = (float2*)(xyz + get_vertex_count());
+        auto xyz = (float3*)get_frame_data();
+        auto ijs = (float2*)(xyz + get_capacity());
         return ijs;
     }
 
+    int* points::get_pixel_indices()
+    {
+        if (!_pixel_indices)
+            return nullptr;
+        return (int*)(get_texture_coordinates() + get_capacity());
+    }
+
+    uint8_t* points::get_vertex_colors()
+    {
+        if (!_colors)
+            return nullptr;
+        auto end = (uint8_t*)(get_texture_coordinates() + get_capacity());
+        return _pixel_indices ? (uint8_t*)(get_pixel_indices() + get_capacity()) : end;
+    }
+
+    // Recycles frame buffers between frames of the same size.
+    // Buffers are kept in per-size buckets, so finding a match does not depend on how many
+    // buffers of other sizes are parked in the pool. A recycled buffer already has the
+    // requested size, so handing it out involves no reallocation, and a new one is not zero-filled either
+    // The pooled buffers are counted by the memory account, and freed first when the memory budget runs out
+    class frame_buffer_pool : public memory_trimmer
+    {
+    public:
+        explicit frame_buffer_pool(rs2_time_t max_age_ms = 1000)
+            : _max_age(max_age_ms), _last_sweep(0), _hits(0), _misses(0), _bytes(0), _account(memory_account::global())
+        {
+            memory_budget::instance().add(this);
+        }
+
+        ~frame_buffer_pool()
+        {
+            memory_budget::instance().remove(this);
+            clear();
+        }
+
+        void set_account(std::shared_ptr<memory_account> account)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _account->update(0, -static_cast<int64_t>(_bytes));
+            _account = std::move(account);
+            _account->update(0, static_cast<int64_t>(_bytes));
+        }
+
+        const std::shared_ptr<memory_account>& get_account() const { return _account; }
+
+        bool acquire(size_t size, rs2_time_t now, frame_buffer& buffer)
+        {
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+
+                // Discard buffers that have been in the pool for longer than max age
+                if (now > _last_sweep + _max_age)
+                {
+                    sweep(now);
+                    _last_sweep = now;
+                }
+
+                auto it = _buckets.find(size);
+                if (it != _buckets.end() && !it->second.empty())
+                {
+                    // The most recently returned buffer is the most likely to still be cache-resident
+                    buffer = std::move(it->second.back().buffer);
+                    it->second.pop_back();
+                    _bytes -= size;
+                    _account->update(0, -static_cast<int64_t>(size));
+                    ++_hits;
+                    return true;
+                }
+            }
+            ++_misses;
+            return false;
+        }
+
+        void release(frame_buffer&& buffer, rs2_time_t released_at)
+        {
+            if (buffer.empty()) return;
+
+            std::lock_guard<std::mutex> lock(_mutex);
+            auto size = buffer.size();
+            _buckets[size].push_back({ std::move(buffer), released_at });
+            _bytes += size;
+            _account->update(0, static_cast<int64_t>(size));
+        }
+
+        void clear()
+        {
+            trim();
+        }
+
+        size_t trim() override
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _buckets.clear();
+            auto freed = _bytes;
+            _bytes = 0;
+            _account->update(0, -static_cast<int64_t>(freed));
+            return freed;
+        }
+
+        frame_pool_stats get_stats() const
+        {
+            frame_pool_stats stats;
+            stats.hits = _hits;
+            stats.misses = _misses;
+            return stats;
+        }
+
+    private:
+        struct pooled_buffer
+        {
+            frame_buffer buffer;
+            rs2_time_t released_at;
+        };
+
+        // Buffers are appended in release order, so the stale ones gather at the front of each bucket
+        void sweep(rs2_time_t now)
+        {
+            for (auto it = _buckets.begin(); it != _buckets.end();)
+            {
+                auto& bucket = it->second;
+                while (!bucket.empty() && now > bucket.front().released_at + _max_age)
+                {
+                    _bytes -= it->first;
+                    _account->update(0, -static_cast<int64_t>(it->first));
+                    bucket.pop_front();
+                }
+
+                if (bucket.empty()) it = _buckets.erase(it);
+                else ++it;
+            }
+        }
+
+        const rs2_time_t _max_age;
+        rs2_time_t _last_sweep;
+        std::unordered_map<size_t, std::deque<pooled_buffer>> _buckets;
+        std::mutex _mutex;
+        std::atomic<uint64_t> _hits;
+        std::atomic<uint64_t> _misses;
+        size_t _bytes; // pooled, guarded by the mutex
+        std::shared_ptr<memory_account> _account;
+    };
+
     // Defines general frames storage model
     template<class T>
     class frame_archive : public std::enable_shared_from_this<frame_archive<T>>, public archive_interface
     {
         std::atomic<uint32_t>* max_frame_queue_size;
+        std::atomic<uint32_t>* overflow_limit_mb;
         std::atomic<uint32_t> published_frames_count;
+        // Frames published beyond the queue size, with the bytes each holds, guarded by mutex
+        std::unordered_map<frame_interface*, size_t> _overflow_frames;
+        size_t _overflow_bytes = 0;
+        std::atomic<uint32_t> _overflow_count{ 0 };
         small_heap<T, RS2_USER_QUEUE_SIZE> published_frames;
         std::shared_ptr<metadata_parser_map> _metadata_parsers = nullptr;
         callbacks_heap callback_inflight;
 
-        std::vector<T> freelist; // return frames here
+        frame_buffer_pool buffer_pool; // return frame buffers here
+        frame_allocator_ptr _allocator;
         std::atomic<bool> recycle_frames;
         int pending_frames = 0;
         std::recursive_mutex mutex;
@@ -166,41 +374,42 @@ namespace librealsense
         std::shared_ptr<sensor_interface> get_sensor() const override { return _sensor.lock(); }
         void set_sensor(std::shared_ptr<sensor_interface> s) override { _sensor = s; }
 
-        T alloc_frame(const size_t size, const frame_additional_data& additional_data, bool requires_memory)
+        // Fails when the frame needs a new buffer that doesn't fit in the memory budget
+        bool alloc_frame(T& backbuffer, const size_t size, const frame_additional_data& additional_data, bool requires_memory)
         {
-            T backbuffer;
-            //const size_t size = modes[stream].get_image_size(stream);
-            {
-                std::lock_guard<std::recursive_mutex> guard(mutex);
+            LRS_PROFILE_ZONE("alloc frame");
+            LRS_PROFILE_FRAME(additional_data.frame_number);
 
-                if (requires_memory)
+            if (requires_memory)
+            {
+                // A user-provided buffer is handed back to its allocator once the frame is released
+                void* user_buffer = _allocator ? _allocator->allocate(size) : nullptr;
+                if (user_buffer)
+                {
+                    auto allocator = _allocator;
+                    backbuffer.attach_continuation(frame_continuation([allocator, user_buffer, size]() {
+                        allocator->deallocate(user_buffer, size);
+                    }, user_buffer));
+                }
+                // Otherwise attempt to obtain a buffer of the appropriate size from the pool
+                else
                 {
-                    // Attempt to obtain a buffer of the appropriate size from the freelist
-                    for (auto it = begin(freelist); it != end(freelist); ++it)
+                    if (!buffer_pool.acquire(size, additional_data.timestamp, backbuffer.data))
                     {
-                        if (it->data.size() == size)
+                        // A new buffer has to fit in the memory budget, once the pooled buffers of all the archives are freed
+                        if (!memory_budget::instance().reserve(size))
                         {
-                            backbuffer = std::move(*it);
-                            freelist.erase(it);
-                            break;
+                            buffer_pool.get_account()->drop();
+                            return false;
                         }
+                        backbuffer.data.resize(size);
                     }
+                    backbuffer.accounted_bytes = size;
+                    buffer_pool.get_account()->update(static_cast<int64_t>(size), 0);
                 }
-
-                // Discard buffers that have been in the freelist for longer than 1s
-                for (auto it = begin(freelist); it != end(freelist);)
-                {
-                    if (additional_data.timestamp > it->additional_data.timestamp + 1000) it = freelist.erase(it);
-                    else ++it;
-                }
-            }
-
-            if (requires_memory)
-            {
-                backbuffer.data.resize(size, 0); // TODO: Allow users to provide a custom allocator for frame buffers
             }
             backbuffer.additional_data = additional_data;
-            return backbuffer;
+            return true;
         }
 
         frame_interface* track_frame(T& f)
@@ -224,20 +433,29 @@ namespace librealsense
             {
                 auto f = (T*)frame;
                 log_frame_callback_end(f);
-                std::unique_lock<std::recursive_mutex> lock(mutex);
+                trace_frame_release(f);
 
                 frame->keep();
 
+                buffer_pool.get_account()->update(-static_cast<int64_t>(f->accounted_bytes), 0);
+                f->accounted_bytes = 0;
                 if (recycle_frames)
                 {
-                    freelist.push_back(std::move(*f));
+                    buffer_pool.release(std::move(f->data), f->additional_data.timestamp);
+                }
+                else
+                {
+                    // Frames of the fixed heap would otherwise hold on to their buffer until the heap slot is reused
+                    frame_buffer().swap(f->data);
                 }
-                lock.unlock();
 
                 if (f->is_fixed())
                     published_frames.deallocate(f);
                 else
+                {
+                    release_overflow(f);
                     delete f;
+                }
             }
         }
 
@@ -248,15 +466,16 @@ namespace librealsense
 
         frame_interface* publish_frame(frame_interface* frame)
         {
+            LRS_PROFILE_ZONE("publish frame");
             auto f = (T*)frame;
+            LRS_PROFILE_FRAME(f->additional_data.frame_number);
 
             unsigned int max_frames = *max_frame_queue_size;
 
             if (published_frames_count >= max_frames
                 && max_frames)
             {
-                LOG_DEBUG("User didn't release frame resource.");
-                return nullptr;
+                return publish_overflow(f);
             }
             auto new_frame = (max_frames ? published_frames.allocate() : new T());
 
@@ -275,6 +494,52 @@ namespace librealsense
             return new_frame;
         }
 
+        // The queue is widened with heap frames while the frames beyond it fit in the memory limit
+        frame_interface* publish_overflow(T* f)
+        {
+            std::lock_guard<std::recursive_mutex> lock(mutex);
+            const size_t limit = size_t(overflow_limit_mb ? overflow_limit_mb->load() : 0) << 20;
+            const size_t bytes = f->data.size();
+            if (!limit || _overflow_bytes + bytes > limit)
+            {
+                LOG_DEBUG("User didn't release frame resource.");
+                return nullptr;
+            }
+
+            auto new_frame = new T();
+            _overflow_frames[new_frame] = bytes;
+            _overflow_bytes += bytes;
+            ++_overflow_count;
+
+            ++published_frames_count;
+            *new_frame = std::move(*f);
+            return new_frame;
+        }
+
+        void release_overflow(T* f)
+        {
+            // Frames of an unlimited queue are heap allocated too, but are not accounted for
+            if (!_overflow_count)
+                return;
+
+            std::lock_guard<std::recursive_mutex> lock(mutex);
+            auto it = _overflow_frames.find(f);
+            if (it == _overflow_frames.end())
+                return;
+            _overflow_bytes -= it->second;
+            _overflow_frames.erase(it);
+            --_overflow_count;
+        }
+
+        void trace_frame_release(T* frame) const
+        {
+            if (frame->additional_data.traced && frame->get_stream() && _time_service)
+            {
+                pipeline_tracer::get().record(frame->get_stream()->get_stream_type(), RS2_PIPELINE_STAGE_RELEASED,
+                    frame->additional_data.frame_number, frame->additional_data.system_time, _time_service->get_time());
+            }
+        }
+
         void log_frame_callback_end(T* frame) const
         {
             if (frame && frame->get_stream())
@@ -298,13 +563,21 @@ namespace librealsense
 
         std::shared_ptr<metadata_parser_map> get_md_parsers() const { return _metadata_parsers; };
 
+        frame_pool_stats get_pool_stats() const override { return buffer_pool.get_stats(); }
+
+        void set_allocator(frame_allocator_ptr allocator) override { _allocator = std::move(allocator); }
+
+        void set_memory_account(std::shared_ptr<memory_account> account) override { buffer_pool.set_account(std::move(account)); }
+
         friend class frame;
 
     public:
         explicit frame_archive(std::atomic<uint32_t>* in_max_frame_queue_size,
+            std::atomic<uint32_t>* in_overflow_limit_mb,
             std::shared_ptr<platform::time_service> ts,
             std::shared_ptr<metadata_parser_map> parsers)
             : max_frame_queue_size(in_max_frame_queue_size),
+            overflow_limit_mb(in_overflow_limit_mb),
             mutex(), recycle_frames(true), _time_service(ts),
             _metadata_parsers(parsers)
         {
@@ -323,8 +596,21 @@ namespace librealsense
 
         frame_interface* alloc_and_track(const size_t size, const frame_additional_data& additional_data, bool requires_memory)
         {
-            auto frame = alloc_frame(size, additional_data, requires_memory);
-            return track_frame(frame);
+            T frame;
+            if (!alloc_frame(frame, size, additional_data, requires_memory))
+            {
+                LOG_DEBUG("Frame of " << size << " bytes is beyond the memory budget");
+                return nullptr;
+            }
+            auto published = track_frame(frame);
+            if (!published && frame.accounted_bytes)
+            {
+                // The frame was dropped, its buffer goes back to the pool
+                buffer_pool.get_account()->update(-static_cast<int64_t>(frame.accounted_bytes), 0);
+                if (recycle_frames)
+                    buffer_pool.release(std::move(frame.data), additional_data.timestamp);
+            }
+            return published;
         }
 
         void flush()
@@ -341,10 +627,7 @@ namespace librealsense
             // wait until user is done with all the stuff he chose to borrow
             callback_inflight.wait_until_empty();
 
-            {
-                std::lock_guard<std::recursive_mutex> guard(mutex);
-                freelist.clear();
-            }
+            buffer_pool.clear();
 
             pending_frames = published_frames.get_size();
             if (pending_frames > 0)
@@ -369,31 +652,32 @@ namespace librealsense
 
     std::shared_ptr<archive_interface> make_archive(rs2_extension type,
         std::atomic<uint32_t>* in_max_frame_queue_size,
+        std::atomic<uint32_t>* in_overflow_limit_mb,
         std::shared_ptr<platform::time_service> ts,
         std::shared_ptr<metadata_parser_map> parsers)
     {
         switch (type)
         {
         case RS2_EXTENSION_VIDEO_FRAME:
-            return std::make_shared<frame_archive<video_frame>>(in_max_frame_queue_size, ts, parsers);
+            return std::make_shared<frame_archive<video_frame>>(in_max_frame_queue_size, in_overflow_limit_mb, ts, parsers);
 
         case RS2_EXTENSION_COMPOSITE_FRAME:
-            return std::make_shared<frame_archive<composite_frame>>(in_max_frame_queue_size, ts, parsers);
+            return std::make_shared<frame_archive<composite_frame>>(in_max_frame_queue_size, in_overflow_limit_mb, ts, parsers);
 
         case RS2_EXTENSION_MOTION_FRAME:
-            return std::make_shared<frame_archive<motion_frame>>(in_max_frame_queue_size, ts, parsers);
+            return std::make_shared<frame_archive<motion_frame>>(in_max_frame_queue_size, in_overflow_limit_mb, ts, parsers);
 
         case RS2_EXTENSION_POINTS:
-            return std::make_shared<frame_archive<points>>(in_max_frame_queue_size, ts, parsers);
+            return std::make_shared<frame_archive<points>>(in_max_frame_queue_size, in_overflow_limit_mb, ts, parsers);
 
         case RS2_EXTENSION_DEPTH_FRAME:
-            return std::make_shared<frame_archive<depth_frame>>(in_max_frame_queue_size, ts, parsers);
+            return std::make_shared<frame_archive<depth_frame>>(in_max_frame_queue_size, in_overflow_limit_mb, ts, parsers);
 
         case RS2_EXTENSION_POSE_FRAME:
-            return std::make_shared<frame_archive<pose_frame>>(in_max_frame_queue_size, ts, parsers);
+            return std::make_shared<frame_archive<pose_frame>>(in_max_frame_queue_size, in_overflow_limit_mb, ts, parsers);
 
         case RS2_EXTENSION_DISPARITY_FRAME:
-            return std::make_shared<frame_archive<disparity_frame>>(in_max_frame_queue_size, ts, parsers);
+            return std::make_shared<frame_archive<disparity_frame>>(in_max_frame_queue_size, in_overflow_limit_mb, ts, parsers);
 
         default:
             throw std::runtime_error("Requested frame type is not supported!");
@@ -402,9 +686,11 @@ namespace librealsense
 
     void frame::release()
     {
-        if (ref_count.fetch_sub(1) == 1)
+        if (ref_count.fetch_sub(1, std::memory_order_acq_rel) == 1)
         {
             on_release();
+            _device_memory.reset();
+            _host_stale = false;
             owner->unpublish_frame(this);
         }
     }
@@ -424,12 +710,49 @@ namespace librealsense
         return owner->publish_frame(this);
     }
 
+    const frame::decoded_metadata_values* frame::get_decoded_metadata() const
+    {
+        std::lock_guard<std::recursive_mutex> lock(_metadata_mutex);
+        if (_metadata_state == metadata_state::decoded) return &_decoded_metadata;
+        if (_metadata_state == metadata_state::decoding) return nullptr;
+
+        _metadata_state = metadata_state::decoding;
+        for (auto&& md : _decoded_metadata) md = { false, 0 };
+        for (auto&& kvp : *metadata_parsers)
+        {
+            // Internal attributes beyond the public enumeration are parsed on demand. The public count is named from the
+            // global namespace, frame_metadata_internal has its own RS2_FRAME_METADATA_COUNT past the internal attributes
+            if (kvp.first < 0 || kvp.first >= static_cast<int>(::RS2_FRAME_METADATA_COUNT)) continue;
+
+            auto&& md = _decoded_metadata[kvp.first];
+            try
+            {
+                if (kvp.second->supports(*this))
+                    md = { true, kvp.second->get(*this) };
+            }
+            catch (...)
+            {
+                // Leave the attribute unsupported, querying it reports the parser error
+                md = { false, 0 };
+            }
+        }
+        _metadata_state = metadata_state::decoded;
+        return &_decoded_metadata;
+    }
+
     rs2_metadata_type frame::get_frame_metadata(const rs2_frame_metadata_value& frame_metadata) const
     {
         if (!metadata_parsers)
             throw invalid_value_exception(to_string() << "metadata not available for "
                 << get_string(get_stream()->get_stream_type()) << " stream");
 
+        auto decoded = (frame_metadata >= 0 && frame_metadata < static_cast<int>(::RS2_FRAME_METADATA_COUNT)) ? get_decoded_metadata() : nullptr;
+        if (decoded)
+        {
+            auto&& md = (*decoded)[frame_metadata];
+            if (md.supported) return md.value;
+        }
+
         auto it = metadata_parsers.get()->find(frame_metadata);
         if (it == metadata_parsers.get()->end())          // Possible user error - md attribute is not supported by this frame type
             throw invalid_value_exception(to_string() << get_string(frame_metadata)
@@ -446,6 +769,10 @@ namespace librealsense
         if (!metadata_parsers)
             return false;                         // No parsers are available or no metadata was attached
 
+        auto decoded = (frame_metadata >= 0 && frame_metadata < static_cast<int>(::RS2_FRAME_METADATA_COUNT)) ? get_decoded_metadata() : nullptr;
+        if (decoded)
+            return (*decoded)[frame_metadata].supported;
+
         auto it = metadata_parsers.get()->find(frame_metadata);
         if (it == metadata_parsers.get()->end())          // Possible user error - md attribute is not supported by this frame type
             return false;
@@ -455,6 +782,17 @@ namespace librealsense
 
     const byte* frame::get_frame_data() const
     {
+        if (_host_stale)
+        {
+            std::lock_guard<std::mutex> lock(_download_mutex);
+            if (_host_stale)
+            {
+                auto host = on_release.get_data() ? static_cast<byte*>(const_cast<void*>(on_release.get_data())) : const_cast<byte*>(data.data());
+                _device_memory->download(host);
+                _host_stale = false;
+            }
+        }
+
         const byte* frame_data = data.data();
 
         if (on_release.get_data())
@@ -5,8 +5,10 @@
 
 #include "types.h"
 #include "core/streaming.h"
+#include "memory-accounting.h"
 #include <atomic>
 #include <array>
+#include <mutex>
 #include <math.h>
 
 namespace librealsense
@@ -21,20 +23,38 @@ namespace librealsense
 {
     typedef std::map<rs2_frame_metadata_value, std::shared_ptr<md_attribute_parser_base>> metadata_parser_map;
 
+    // Leaves the elements it constructs without a value uninitialized, so that growing a frame buffer does not zero-fill it.
+    // A frame is written over before it is published, as the recycled buffers, which hold the data of earlier frames, already are
+    template<class T>
+    struct uninitialized_allocator : std::allocator<T>
+    {
+        template<class U> struct rebind { typedef uninitialized_allocator<U> other; };
+
+        uninitialized_allocator() = default;
+        template<class U> uninitialized_allocator(const uninitialized_allocator<U>&) {}
+
+        template<class U> void construct(U* p) { ::new (static_cast<void*>(p)) U; }
+        template<class U, class... Args> void construct(U* p, Args&&... args) { ::new (static_cast<void*>(p)) U(std::forward<Args>(args)...); }
+    };
+    typedef std::vector<byte, uninitialized_allocator<byte>> frame_buffer;
+
     struct frame_additional_data
     {
         rs2_time_t timestamp = 0;
         unsigned long long frame_number = 0;
-        rs2_timestamp_domain timestamp_domain = RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK;
         rs2_time_t      system_time = 0;
         rs2_time_t      frame_callback_started = 0;
-        uint32_t        metadata_size = 0;
-        bool            fisheye_ae_mode = false;
-        std::array<uint8_t, MAX_META_DATA_SIZE> metadata_blob;
         rs2_time_t      backend_timestamp = 0;
         rs2_time_t last_timestamp = 0;
         unsigned long long last_frame_number = 0;
+        rs2_timestamp_domain timestamp_domain = RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK;
+        uint32_t        metadata_size = 0;
+        int dmabuf_fd = -1;
+        bool            fisheye_ae_mode = false;
         bool is_blocking = false;
+        bool traced = false;    // the stages of the frame are recorded by the pipeline tracer
+        // Kept last, only the first metadata_size bytes are copied with the rest of the header
+        std::array<uint8_t, MAX_META_DATA_SIZE> metadata_blob;
 
         frame_additional_data() {};
 
@@ -50,16 +70,44 @@ namespace librealsense
             : timestamp(in_timestamp),
             frame_number(in_frame_number),
             system_time(in_system_time),
-            metadata_size(md_size),
             backend_timestamp(backend_time),
             last_timestamp(last_timestamp),
             last_frame_number(last_frame_number),
+            metadata_size(md_size),
             is_blocking(in_is_blocking)
         {
             // Copy up to 255 bytes to preserve metadata as raw data
             if (metadata_size)
                 std::copy(md_buf, md_buf + std::min(md_size, MAX_META_DATA_SIZE), metadata_blob.begin());
         }
+
+        frame_additional_data(const frame_additional_data& other) { *this = other; }
+
+        frame_additional_data& operator=(const frame_additional_data& other)
+        {
+            timestamp = other.timestamp;
+            frame_number = other.frame_number;
+            system_time = other.system_time;
+            frame_callback_started = other.frame_callback_started;
+            backend_timestamp = other.backend_timestamp;
+            last_timestamp = other.last_timestamp;
+            last_frame_number = other.last_frame_number;
+            timestamp_domain = other.timestamp_domain;
+            metadata_size = std::min<uint32_t>(other.metadata_size, MAX_META_DATA_SIZE);
+            dmabuf_fd = other.dmabuf_fd;
+            fisheye_ae_mode = other.fisheye_ae_mode;
+            is_blocking = other.is_blocking;
+            traced = other.traced;
+            std::copy(other.metadata_blob.begin(), other.metadata_blob.begin() + metadata_size, metadata_blob.begin());
+            return *this;
+        }
+    };
+
+    // Buffer recycling counters of a single frame archive
+    struct frame_pool_stats
+    {
+        uint64_t hits = 0;      // allocations served from a recycled buffer
+        uint64_t misses = 0;    // allocations that required a fresh heap buffer
     };
 
     class archive_interface : public sensor_part
@@ -71,6 +119,14 @@ namespace librealsense
 
         virtual std::shared_ptr<metadata_parser_map> get_md_parsers() const = 0;
 
+        virtual frame_pool_stats get_pool_stats() const = 0;
+
+        // Frames of this archive are backed by buffers from the allocator, when one is set
+        virtual void set_allocator(frame_allocator_ptr allocator) = 0;
+
+        // The buffers of this archive are counted by the account, the process-wide one unless set before the first frame
+        virtual void set_memory_account(std::shared_ptr<memory_account> account) = 0;
+
         virtual void flush() = 0;
 
         virtual frame_interface* publish_frame(frame_interface* frame) = 0;
@@ -80,8 +136,10 @@ namespace librealsense
 
     };
 
+    // Frames beyond the queue size are dropped, unless they fit in the overflow limit, in MB
     std::shared_ptr<archive_interface> make_archive(rs2_extension type,
         std::atomic<uint32_t>* in_max_frame_queue_size,
+        std::atomic<uint32_t>* in_overflow_limit_mb,
         std::shared_ptr<platform::time_service> ts,
         std::shared_ptr<metadata_parser_map> parsers);
 
@@ -89,7 +147,8 @@ namespace librealsense
     class frame : public frame_interface
     {
     public:
-        std::vector<byte> data;
+        frame_buffer data;
+        size_t accounted_bytes = 0; // bytes of data the owner counts as in use
         frame_additional_data additional_data;
         std::shared_ptr<metadata_parser_map> metadata_parsers = nullptr;
         explicit frame() : ref_count(0), _kept(false), owner(nullptr), on_release() {}
@@ -107,14 +166,19 @@ namespace librealsense
         frame& operator=(frame&& r)
         {
             data = move(r.data);
+            accounted_bytes = r.accounted_bytes;
+            r.accounted_bytes = 0;
             owner = r.owner;
             ref_count = r.ref_count.exchange(0);
             _kept = r._kept.exchange(false);
             on_release = std::move(r.on_release);
+            _device_memory = std::move(r._device_memory);
+            _host_stale = r._host_stale.exchange(false);
             additional_data = std::move(r.additional_data);
             r.owner.reset();
             if (owner) metadata_parsers = owner->get_md_parsers();
             if (r.metadata_parsers) metadata_parsers = std::move(r.metadata_parsers);
+            invalidate_metadata();
             return *this;
         }
 
@@ -124,11 +188,19 @@ namespace librealsense
         const byte* get_frame_data() const override;
         rs2_time_t get_frame_timestamp() const override;
         rs2_timestamp_domain get_frame_timestamp_domain() const override;
-        void set_timestamp(double new_ts) override { additional_data.timestamp = new_ts; }
+        void set_timestamp(double new_ts) override { additional_data.timestamp = new_ts; invalidate_metadata(); }
         unsigned long long get_frame_number() const override;
+        int get_frame_dmabuf_fd() const override { return additional_data.dmabuf_fd; }
+        std::shared_ptr<device_memory> get_device_memory() const override { return _device_memory; }
+        void attach_device_memory(std::shared_ptr<device_memory> memory, bool host_is_stale) override
+        {
+            _device_memory = std::move(memory);
+            _host_stale = host_is_stale && _device_memory;
+        }
         void set_timestamp_domain(rs2_timestamp_domain timestamp_domain) override
         {
             additional_data.timestamp_domain = timestamp_domain;
+            invalidate_metadata();
         }
 
         rs2_time_t get_frame_system_time() const override;
@@ -139,9 +211,14 @@ namespace librealsense
         rs2_time_t get_frame_callback_start_time_point() const override;
         void update_frame_callback_start_ts(rs2_time_t ts) override;
 
-        void acquire() override { ref_count.fetch_add(1); }
+        // Taking a reference needs no ordering, only dropping the last one has to see the writes of the other owners
+        void acquire() override { ref_count.fetch_add(1, std::memory_order_relaxed); }
         void release() override;
         void keep() override;
+        bool is_uniquely_owned() const override
+        {
+            return ref_count == 1 && !_kept && !on_release.get_data() && !_device_memory;
+        }
 
         frame_interface* publish(std::shared_ptr<archive_interface> new_owner) override;
         void attach_continuation(frame_continuation&& continuation) override { on_release = std::move(continuation); }
@@ -149,6 +226,11 @@ namespace librealsense
 
         archive_interface* get_owner() const override { return owner.get(); }
 
+        bool is_extendable_to(rs2_extension extension) const override
+        {
+            return extension >= 0 && extension < 64 && (_extensions & (uint64_t(1) << extension));
+        }
+
         std::shared_ptr<sensor_interface> get_sensor() const override;
         void set_sensor(std::shared_ptr<sensor_interface> s) override;
 
@@ -162,24 +244,71 @@ namespace librealsense
         void set_blocking(bool state) override { additional_data.is_blocking = state; }
         bool is_blocking() const override { return additional_data.is_blocking; }
 
+    protected:
+        // Called by the constructor of each frame type, the flags are not moved with the frame data
+        void add_extension(rs2_extension extension) { _extensions |= uint64_t(1) << extension; }
+
     private:
+        struct decoded_metadata_value
+        {
+            bool supported;
+            rs2_metadata_type value;
+        };
+        typedef std::array<decoded_metadata_value, ::RS2_FRAME_METADATA_COUNT> decoded_metadata_values;
+        enum class metadata_state { pending, decoding, decoded };
+
+        // All the attributes are parsed on the first query, instead of a parser lookup and header validation per query.
+        // Returns null while decoding, since some parsers query other attributes of the same frame
+        const decoded_metadata_values* get_decoded_metadata() const;
+        void invalidate_metadata()
+        {
+            std::lock_guard<std::recursive_mutex> lock(_metadata_mutex);
+            _metadata_state = metadata_state::pending;
+        }
+
+        mutable std::recursive_mutex _metadata_mutex;
+        mutable metadata_state _metadata_state = metadata_state::pending;
+        mutable decoded_metadata_values _decoded_metadata;
+
         // TODO: check boost::intrusive_ptr or an alternative
         std::atomic<int> ref_count; // the reference count is on how many times this placeholder has been observed (not lifetime, not content)
+        std::atomic_bool _kept;
+        mutable std::atomic_bool _host_stale{ false };
+        bool _fixed = false;
+        uint64_t _extensions = 0;
         std::shared_ptr<archive_interface> owner; // pointer to the owner to be returned to by last observe
         std::weak_ptr<sensor_interface> sensor;
         frame_continuation on_release;
-        bool _fixed = false;
-        std::atomic_bool _kept;
+        std::shared_ptr<device_memory> _device_memory;
+        mutable std::mutex _download_mutex;
         std::shared_ptr<stream_profile_interface> stream;
     };
 
     class points : public frame
     {
     public:
+        points() : frame(), _pixel_indices(false), _colors(false) { add_extension(RS2_EXTENSION_POINTS); }
+
         float3* get_vertices();
-        void export_to_ply(const std::string& fname, const frame_holder& texture);
+        void export_to_ply(const std::string& fname, const frame_holder& texture, bool with_faces = true);
         size_t get_vertex_count() const;
         float2* get_texture_coordinates();
+        // Depth pixel of each vertex, or null unless the frame was allocated with pixel indices
+        int* get_pixel_indices();
+        // RGB color of each vertex, or null unless the frame was allocated with colors
+        uint8_t* get_vertex_colors();
+
+        // A sparse pointcloud keeps the buffer sized for every depth pixel and fills only the first count vertices
+        void set_vertex_count(size_t count) { _vertex_count = count; }
+        void set_pixel_indices(bool enabled) { _pixel_indices = enabled; }
+        void set_vertex_colors(bool enabled) { _colors = enabled; }
+
+    private:
+        size_t get_capacity() const;
+
+        optional_value<size_t> _vertex_count;
+        bool _pixel_indices;
+        bool _colors;
     };
 
     MAP_EXTENSION(RS2_EXTENSION_POINTS, librealsense::points);
@@ -187,7 +316,7 @@ namespace librealsense
     class composite_frame : public frame
     {
     public:
-        composite_frame() : frame() {}
+        composite_frame() : frame() { add_extension(RS2_EXTENSION_COMPOSITE_FRAME); }
 
         frame_interface* get_frame(int i) const
         {
@@ -197,6 +326,19 @@ namespace librealsense
 
         frame_interface** get_frames() const { return (frame_interface**)data.data(); }
 
+        // The i-th frame as a holder of its own. While the caller is the only one observing the set, the set is
+        // about to be released and gives its reference away instead of adding one, leaving an empty entry behind
+        frame_holder take_frame(int i)
+        {
+            auto frames = get_frames();
+            auto f = frames[i];
+            if (is_uniquely_owned())
+                frames[i] = nullptr;
+            else
+                f->acquire();
+            return frame_holder(f);
+        }
+
         const frame_interface* first() const
         {
             return get_frame(0);
@@ -261,7 +403,9 @@ namespace librealsense
     public:
         video_frame()
             : frame(), _width(0), _height(0), _bpp(0), _stride(0)
-        {}
+        {
+            add_extension(RS2_EXTENSION_VIDEO_FRAME);
+        }
 
         int get_width() const { return _width; }
         int get_height() const { return _height; }
@@ -287,26 +431,29 @@ namespace librealsense
     public:
         depth_frame() : video_frame(), _depth_units()
         {
+            add_extension(RS2_EXTENSION_DEPTH_FRAME);
         }
 
         frame_interface* publish(std::shared_ptr<archive_interface> new_owner) override
         {
             _depth_units = optional_value<float>();
+            _disparity_scale = 0.f;
             return video_frame::publish(new_owner);
         }
 
-        void keep() override
-        {
-            if (_original) _original->keep();
-            video_frame::keep();
-        }
-
         float get_distance(int x, int y) const
         {
-            // If this frame does not itself contain Z16 depth data,
-            // fall back to the original frame it was created from
-            if (_original && get_stream()->get_format() != RS2_FORMAT_Z16)
-                return((depth_frame*)_original.frame)->get_distance(x, y);
+            auto format = get_stream()->get_format();
+            if (format == RS2_FORMAT_DISPARITY32 || format == RS2_FORMAT_DISPARITY16)
+            {
+                auto disparity = format == RS2_FORMAT_DISPARITY32 ?
+                    reinterpret_cast<const float*>(get_frame_data())[y*get_width() + x] :
+                    float(reinterpret_cast<const uint16_t*>(get_frame_data())[y*get_width() + x]);
+                return disparity > 0.f ? _disparity_scale / disparity : 0.f;
+            }
+            // Processing blocks allocate their frames with the bytes rather than the bits per pixel, the format is what counts
+            if (format == RS2_FORMAT_Z16)
+                return reinterpret_cast<const uint16_t*>(get_frame_data())[y*get_width() + x] * get_units();
 
             uint64_t pixel = 0;
             switch (get_bpp() / 8) // bits per pixel
@@ -328,28 +475,15 @@ namespace librealsense
             return _depth_units.value();
         }
 
-        const frame_interface* get_original_depth() const
+        // Processed frames take the scaling of the frame they were made from instead of keeping it alive
+        void set_scale_from(const depth_frame& original)
         {
-            auto res = _original.frame;
-            auto df = dynamic_cast<depth_frame*>(res);
-            if (df)
-            {
-                auto prev = df->get_original_depth();
-                if (prev) return prev;
-            }
-            return res;
+            _depth_units = original._depth_units;
+            _disparity_scale = original._disparity_scale;
         }
 
-        void set_original(frame_holder h)
-        {
-            _original = std::move(h);
-            attach_continuation(frame_continuation([this]() {
-                if (_original)
-                {
-                    _original = {};
-                }
-            }, get_frame_data()));
-        }
+        // Distance in meters times the disparity, for the frames holding disparity
+        void set_disparity_scale(float scale) { _disparity_scale = scale; }
 
     protected:
         static float query_units(const std::shared_ptr<sensor_interface>& sensor)
@@ -390,8 +524,8 @@ namespace librealsense
             return 0;
         }
 
-        frame_holder _original;
         mutable optional_value<float> _depth_units;
+        float _disparity_scale = 0.f;
     };
 
     MAP_EXTENSION(RS2_EXTENSION_DEPTH_FRAME, librealsense::depth_frame);
@@ -403,6 +537,7 @@ namespace librealsense
     public:
         disparity_frame() : depth_frame()
         {
+            add_extension(RS2_EXTENSION_DISPARITY_FRAME);
         }
 
         // TODO Refactor to framemetadata
@@ -455,7 +590,9 @@ namespace librealsense
     {
     public:
         motion_frame() : frame()
-        {}
+        {
+            add_extension(RS2_EXTENSION_MOTION_FRAME);
+        }
     };
 
     MAP_EXTENSION(RS2_EXTENSION_MOTION_FRAME, librealsense::motion_frame);
@@ -476,7 +613,7 @@ namespace librealsense
             uint32_t mapper_confidence;    /**< pose data confidence 0x0 - Failed, 0x1 - Low, 0x2 - Medium, 0x3 - High                                     */
         };
 
-        pose_frame() : frame() {}
+        pose_frame() : frame() { add_extension(RS2_EXTENSION_POSE_FRAME); }
 
         float3   get_translation()          const { return reinterpret_cast<const pose_info*>(get_frame_data())->translation; }
         float3   get_velocity()             const { return reinterpret_cast<const pose_info*>(get_frame_data())->velocity; }
@@ -490,4 +627,17 @@ namespace librealsense
 
     MAP_EXTENSION(RS2_EXTENSION_POSE_FRAME, librealsense::pose_frame);
 
+    // Replaces dynamic_cast<T*> on the frame path, where T is one of the frame types above
+    template<class T>
+    T* frame_cast(frame_interface* f)
+    {
+        return f && f->is_extendable_to(TypeToExtension<T>::value) ? static_cast<T*>(f) : nullptr;
+    }
+
+    template<class T>
+    const T* frame_cast(const frame_interface* f)
+    {
+        return f && f->is_extendable_to(TypeToExtension<T>::value) ? static_cast<const T*>(f) : nullptr;
+    }
+
 }
\ No newline at end of file
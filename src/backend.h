@@ -171,6 +171,9 @@ namespace librealsense
             const void *    pixels;
             const void *    metadata;
             rs2_time_t      backend_time;
+            int             dmabuf_fd;      // DMA buffer exported for the pixels, -1 when unavailable
+            uint32_t        skipped;        // frames the capture missed since the previous one, for lack of buffers
+            uint32_t        incomplete;     // frames discarded incomplete since the previous one
         };
 
         typedef std::function<void(stream_profile, frame_object, std::function<void()>)> frame_callback;
@@ -435,6 +438,9 @@ namespace librealsense
             virtual bool set_xu(const extension_unit& xu, uint8_t ctrl, const uint8_t* data, int len) = 0;
             virtual bool get_xu(const extension_unit& xu, uint8_t ctrl, uint8_t* data, int len) const = 0;
             virtual control_range get_xu_range(const extension_unit& xu, uint8_t ctrl, int len) const = 0;
+            // Invokes the callback, from the backend's thread, whenever the device reports on its status endpoint that the control changed.
+            // An empty callback cancels the reports. Returns false if the backend does not deliver status reports.
+            virtual bool set_xu_status_callback(const extension_unit& xu, uint8_t ctrl, std::function<void()> callback) { return false; }
 
             virtual bool get_pu(rs2_option opt, int32_t& value) const = 0;
             virtual bool set_pu(rs2_option opt, int32_t value) = 0;
@@ -529,6 +535,11 @@ namespace librealsense
                 return _dev->get_xu_range(xu, ctrl, len);
             }
 
+            bool set_xu_status_callback(const extension_unit& xu, uint8_t ctrl, std::function<void()> callback) override
+            {
+                return _dev->set_xu_status_callback(xu, ctrl, std::move(callback));
+            }
+
             bool get_pu(rs2_option opt, int32_t& value) const override
             {
                 for (auto i = 0; i < MAX_RETRIES; ++i)
@@ -805,6 +816,11 @@ namespace librealsense
                 return _dev.front()->get_xu_range(xu, ctrl, len);
             }
 
+            bool set_xu_status_callback(const extension_unit& xu, uint8_t ctrl, std::function<void()> callback) override
+            {
+                return _dev.front()->set_xu_status_callback(xu, ctrl, std::move(callback));
+            }
+
             bool get_pu(rs2_option opt, int32_t& value) const override
             {
                 return _dev.front()->get_pu(opt, value);
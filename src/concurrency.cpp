@@ -0,0 +1,66 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#include "concurrency.h"
+#include "types.h"
+
+#include <cstdlib>
+#include <sstream>
+
+#ifdef _WIN32
+#include <windows.h>
+#elif defined(__linux__)
+#include <sched.h>
+#endif
+
+std::shared_ptr<thread_pool> thread_pool::instance()
+{
+    static const char* threads_var_name = "LRS_THREAD_POOL_THREADS";
+    static const char* cpus_var_name = "LRS_THREAD_POOL_CPUS";
+
+    static auto pool = []()
+    {
+        unsigned int threads = 0;
+        if (auto content = getenv(threads_var_name))
+            threads = static_cast<unsigned int>(std::strtoul(content, nullptr, 10));
+
+        std::vector<int> cpus;
+        if (auto content = getenv(cpus_var_name))
+        {
+            std::stringstream ss(content);
+            std::string cpu;
+            while (std::getline(ss, cpu, ','))
+            {
+                char* end = nullptr;
+                auto id = std::strtol(cpu.c_str(), &end, 10);
+                if (end != cpu.c_str() && id >= 0)
+                    cpus.push_back(static_cast<int>(id));
+                else
+                    LOG_WARNING("Ignoring invalid core \"" << cpu << "\" in " << cpus_var_name);
+            }
+        }
+        return std::make_shared<thread_pool>(threads, std::move(cpus));
+    }();
+    return pool;
+}
+
+bool thread_pool::set_current_thread_affinity(int cpu)
+{
+#ifdef _WIN32
+    if (cpu < static_cast<int>(sizeof(DWORD_PTR) * 8) && SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << cpu))
+        return true;
+    LOG_WARNING("thread_pool: could not pin worker to core " << cpu << ", error " << GetLastError());
+    return false;
+#elif defined(__linux__)
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(cpu, &cpus);
+    if (sched_setaffinity(0, sizeof(cpus), &cpus) == 0)
+        return true;
+    LOG_WARNING("thread_pool: could not pin worker to core " << cpu << ", error " << errno);
+    return false;
+#else
+    LOG_WARNING("thread_pool: core affinity is not supported on this platform");
+    return false;
+#endif
+}
@@ -8,8 +8,103 @@
 #include <thread>
 #include <atomic>
 #include <functional>
+#include <vector>
+#include <algorithm>
+#include <exception>
+#include <memory>
+#include <type_traits>
+#include <chrono>
+#include <deque>
+#include <map>
+
+#include "thread-scheduling.h"
 
 const int QUEUE_MAX_SIZE = 10;
+// How the consumers of a queue wait for an item, and how long they took to return once it arrived. A consumer spins on
+// the queue, then yields its core, and only then sleeps until it's signaled: spinning and yielding trade a core for a
+// wakeup that doesn't go through the scheduler. Shared by a queue and its owner, and used without locking
+class wait_control
+{
+public:
+    enum phase { spinning, yielding, sleeping, phase_count };
+    // Bucket 0 counts the wakeups under 1us, bucket i those from 2^(i-1) to 2^i us, and the last one all the longer ones
+    static const int latency_buckets = 16;
+
+    wait_control() : _spin_us(0), _yield_us(0), _measured(false) { reset(); }
+
+    // Timing the wakeups reads the clock for every item, so the queues only do it while a strategy is set, or once
+    // the latencies were asked for
+    void measure() { _measured.store(true, std::memory_order_relaxed); }
+    bool measuring() const
+    {
+        return _measured.load(std::memory_order_relaxed) || _spin_us.load(std::memory_order_relaxed) ||
+               _yield_us.load(std::memory_order_relaxed);
+    }
+
+    void set_strategy(std::chrono::microseconds spin, std::chrono::microseconds yield)
+    {
+        _spin_us = spin.count();
+        _yield_us = yield.count();
+    }
+
+    std::chrono::microseconds spin() const { return std::chrono::microseconds(_spin_us.load(std::memory_order_relaxed)); }
+    std::chrono::microseconds yield() const { return std::chrono::microseconds(_yield_us.load(std::memory_order_relaxed)); }
+
+    // Polls ready() for the spin and the yield durations, returns the phase it became ready in, or sleeping if it didn't
+    template<class F>
+    phase poll(F ready, std::chrono::steady_clock::time_point deadline) const
+    {
+        auto spin_time = spin(), yield_time = yield();
+        if (!spin_time.count() && !yield_time.count())
+            return sleeping;
+
+        auto now = std::chrono::steady_clock::now();
+        auto spin_end = std::min(deadline, now + spin_time);
+        auto yield_end = std::min(deadline, spin_end + yield_time);
+        for (; now < spin_end; now = std::chrono::steady_clock::now())
+        {
+            for (int i = 0; i < 32; ++i)
+                if (ready())
+                    return spinning;
+        }
+        for (; now < yield_end; now = std::chrono::steady_clock::now())
+        {
+            if (ready())
+                return yielding;
+            std::this_thread::yield();
+        }
+        return ready() ? yielding : sleeping;
+    }
+
+    void record(phase p, std::chrono::steady_clock::duration latency)
+    {
+        auto us = std::chrono::duration_cast<std::chrono::microseconds>(latency).count();
+        int bucket = 0;
+        while (bucket < latency_buckets - 1 && us >= (1ll << bucket))
+            ++bucket;
+        _latency[bucket].fetch_add(1, std::memory_order_relaxed);
+        _wakeups[p].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    unsigned long long latency_count(int bucket) const { return _latency[bucket].load(std::memory_order_relaxed); }
+    unsigned long long wakeups(phase p) const { return _wakeups[p].load(std::memory_order_relaxed); }
+
+    void reset()
+    {
+        for (auto&& count : _latency)
+            count = 0;
+        for (auto&& count : _wakeups)
+            count = 0;
+    }
+
+private:
+    std::atomic<long long> _spin_us;
+    std::atomic<long long> _yield_us;
+    std::atomic<bool> _measured;
+    std::atomic<unsigned long long> _latency[latency_buckets];
+    std::atomic<unsigned long long> _wakeups[phase_count];
+};
+
 // Simplest implementation of a blocking concurrent queue for thread messaging
 template<class T>
 class single_consumer_queue
@@ -26,35 +121,66 @@ class single_consumer_queue
     // when need to stop
     std::atomic<bool> _need_to_flush;
     std::atomic<bool> _was_flushed;
+
+    // Items in the queue, for the consumers spinning outside of the lock
+    std::atomic<size_t> _size;
+    // Left unset while the wakeups aren't measured
+    std::chrono::steady_clock::time_point _enqueued_at;
+    std::shared_ptr<wait_control> _wait;
+    std::function<void(T&)> _on_drop;
+
+    void pushed()
+    {
+        _size = _queue.size();
+        _enqueued_at = _wait->measuring() ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+    }
 public:
-    explicit single_consumer_queue<T>(unsigned int cap = QUEUE_MAX_SIZE)
-        : _queue(), _mutex(), _deq_cv(), _enq_cv(), _cap(cap), _need_to_flush(false), _was_flushed(false), _accepting(true)
+    explicit single_consumer_queue<T>(unsigned int cap = QUEUE_MAX_SIZE, std::shared_ptr<wait_control> wait = nullptr)
+        : _queue(), _mutex(), _deq_cv(), _enq_cv(), _cap(cap), _need_to_flush(false), _was_flushed(false), _accepting(true),
+          _size(0), _wait(wait ? wait : std::make_shared<wait_control>())
     {}
 
+    wait_control& get_wait_control() { return *_wait; }
+
+    // Told about the items a full queue drops for newer ones, set before the queue is used
+    void set_on_drop(std::function<void(T&)> on_drop) { _on_drop = std::move(on_drop); }
+
     void enqueue(T&& item)
     {
+        T dropped;
+        bool was_dropped = false;
         std::unique_lock<std::mutex> lock(_mutex);
         if (_accepting)
         {
             _queue.push_back(std::move(item));
             if (_queue.size() > _cap)
             {
+                dropped = std::move(_queue.front());
+                was_dropped = true;
                 _queue.pop_front();
             }
+            pushed();
         }
         lock.unlock();
         _deq_cv.notify_one();
+        if (was_dropped && _on_drop)
+            _on_drop(dropped);
     }
 
     void blocking_enqueue(T&& item)
     {
-        auto pred = [this]()->bool { return _queue.size() <= _cap; };
+        // clear() releases the waiting producers, their items are then discarded
+        auto pred = [this]()->bool { return _queue.size() <= _cap || !_accepting; };
 
         std::unique_lock<std::mutex> lock(_mutex);
         if (_accepting)
         {
             _enq_cv.wait(lock, pred);
-            _queue.push_back(std::move(item));
+            if (_accepting)
+            {
+                _queue.push_back(std::move(item));
+                pushed();
+            }
         }
         lock.unlock();
         _deq_cv.notify_one();
@@ -63,13 +189,28 @@ public:
 
     bool dequeue(T* item ,unsigned int timeout_ms = 5000)
     {
+        // The consumer only spins when it would wait, an item already queued is taken right away, without reading the clock
+        std::chrono::steady_clock::time_point deadline;
+        bool waited = !_size && !_need_to_flush;
+        auto phase = wait_control::spinning;
+        if (waited)
+        {
+            deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+            phase = _wait->poll([this]() { return _size || _need_to_flush; }, deadline);
+        }
+
         std::unique_lock<std::mutex> lock(_mutex);
         _accepting = true;
         _was_flushed = false;
         const auto ready = [this]() { return (_queue.size() > 0) || _need_to_flush; };
-        if (!ready() && !_deq_cv.wait_for(lock, std::chrono::milliseconds(timeout_ms), ready))
+        if (!ready())
         {
-            return false;
+            if (!waited)
+                deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+            waited = true;
+            phase = wait_control::sleeping;
+            if (!_deq_cv.wait_until(lock, deadline, ready))
+                return false;
         }
 
         if (_queue.size() <= 0)
@@ -78,6 +219,9 @@ public:
         }
         *item = std::move(_queue.front());
         _queue.pop_front();
+        _size = _queue.size();
+        if (waited && _enqueued_at != std::chrono::steady_clock::time_point())
+            _wait->record(phase, std::chrono::steady_clock::now() - _enqueued_at);
         _enq_cv.notify_one();
         return true;
     }
@@ -90,6 +234,7 @@ public:
         {
             auto val = std::move(_queue.front());
             _queue.pop_front();
+            _size = _queue.size();
             *item = std::move(val);
             _enq_cv.notify_one();
             return true;
@@ -121,7 +266,9 @@ public:
             auto item = std::move(_queue.front());
             _queue.pop_front();
         }
+        _size = 0;
         _deq_cv.notify_all();
+        _enq_cv.notify_all();
     }
 
     void start()
@@ -138,13 +285,290 @@ public:
     }
 };
 
+// Bounded lock-free ring buffer with the interface and drop-oldest semantics of single_consumer_queue
+// Any thread may enqueue or dequeue; the fast path only touches atomics. A waiting thread spins briefly
+// and then sleeps on a condition variable, which producers signal only while somebody is sleeping
+template<class T>
+class lock_free_queue
+{
+    struct cell
+    {
+        std::atomic<size_t> sequence;
+        T data;
+    };
+
+    std::unique_ptr<cell[]> _cells;
+    size_t _cap;
+    std::atomic<size_t> _head; // next position to dequeue
+    std::atomic<size_t> _tail; // next position to enqueue
+
+    std::atomic<bool> _accepting;
+    std::atomic<bool> _need_to_flush;
+
+    std::atomic<int> _sleepers;
+    std::mutex _sleep_mutex;
+    std::condition_variable _sleep_cv;
+
+    std::shared_ptr<wait_control> _wait;
+    // 0 while the wakeups aren't measured
+    std::atomic<std::chrono::steady_clock::rep> _enqueued_at;
+    std::function<void(T&)> _on_drop;
+
+    void stamp()
+    {
+        _enqueued_at.store(_wait->measuring() ? std::chrono::steady_clock::now().time_since_epoch().count() : 0,
+                           std::memory_order_relaxed);
+    }
+
+    static const int spin_count = 64;
+
+    bool try_push(T& item)
+    {
+        auto pos = _tail.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            auto& c = _cells[pos % _cap];
+            auto seq = c.sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(seq - pos);
+            if (diff == 0)
+            {
+                if (_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    c.data = std::move(item);
+                    c.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0)
+                return false; // full
+            else
+                pos = _tail.load(std::memory_order_relaxed);
+        }
+    }
+
+    bool try_pop(T& item)
+    {
+        auto pos = _head.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            auto& c = _cells[pos % _cap];
+            auto seq = c.sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(seq - (pos + 1));
+            if (diff == 0)
+            {
+                if (_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    item = std::move(c.data);
+                    c.sequence.store(pos + _cap, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0)
+                return false; // empty
+            else
+                pos = _head.load(std::memory_order_relaxed);
+        }
+    }
+
+    void wake_sleepers()
+    {
+        // Pairs with the increment in sleep_until: either the sleeper sees the new state or we see the sleeper
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (_sleepers.load(std::memory_order_relaxed))
+        {
+            { std::lock_guard<std::mutex> lock(_sleep_mutex); }
+            _sleep_cv.notify_all();
+        }
+    }
+
+    // Consumers, which report the phase they were woken up in, follow the wait strategy. Producers, and consumers
+    // without a strategy, yield a few times before sleeping
+    template<class F>
+    bool wait_until(std::chrono::steady_clock::time_point deadline, F ready, wait_control::phase* phase = nullptr)
+    {
+        if (phase && (*phase = _wait->poll(ready, deadline)) != wait_control::sleeping)
+            return true;
+
+        if (!phase || (!_wait->spin().count() && !_wait->yield().count()))
+        {
+            for (int i = 0; i < spin_count; ++i)
+            {
+                if (ready())
+                {
+                    if (phase)
+                        *phase = wait_control::yielding;
+                    return true;
+                }
+                std::this_thread::yield();
+            }
+        }
+
+        std::unique_lock<std::mutex> lock(_sleep_mutex);
+        _sleepers.fetch_add(1);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        auto res = _sleep_cv.wait_until(lock, deadline, ready);
+        _sleepers.fetch_sub(1);
+        return res;
+    }
+
+public:
+    explicit lock_free_queue(unsigned int cap = QUEUE_MAX_SIZE, std::shared_ptr<wait_control> wait = nullptr)
+        : _cells(new cell[std::max(1u, cap)]), _cap(std::max(1u, cap)), _head(0), _tail(0),
+        _accepting(true), _need_to_flush(false), _sleepers(0),
+        _wait(wait ? wait : std::make_shared<wait_control>()), _enqueued_at(0)
+    {
+        for (size_t i = 0; i < _cap; ++i)
+            _cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    wait_control& get_wait_control() { return *_wait; }
+
+    // Told about the items a full queue drops for newer ones, set before the queue is used
+    void set_on_drop(std::function<void(T&)> on_drop) { _on_drop = std::move(on_drop); }
+
+    void enqueue(T&& item)
+    {
+        if (_accepting)
+        {
+            // Stamped first, so the consumer taking the item doesn't read the time of the previous one
+            stamp();
+            // When full, drop the oldest item; a consumer may take it first, then simply retry
+            while (!try_push(item))
+            {
+                T oldest;
+                if (try_pop(oldest) && _on_drop)
+                    _on_drop(oldest);
+            }
+        }
+        wake_sleepers();
+    }
+
+    void blocking_enqueue(T&& item)
+    {
+        if (_accepting)
+        {
+            stamp();
+            auto ready = [&]() { return try_push(item) || !_accepting; };
+            while (!wait_until(std::chrono::steady_clock::now() + std::chrono::seconds(1), ready));
+        }
+        wake_sleepers();
+    }
+
+    bool dequeue(T* item, unsigned int timeout_ms = 5000)
+    {
+        _accepting = true;
+        if (try_pop(*item))
+        {
+            wake_sleepers();
+            return true;
+        }
+
+        bool popped = false;
+        auto phase = wait_control::sleeping;
+        wait_until(std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms),
+            [&]() { return (popped = try_pop(*item)) || _need_to_flush; }, &phase);
+        if (popped)
+        {
+            if (auto ticks = _enqueued_at.load(std::memory_order_relaxed))
+            {
+                auto enqueued_at = std::chrono::steady_clock::time_point(std::chrono::steady_clock::duration(ticks));
+                _wait->record(phase, std::chrono::steady_clock::now() - enqueued_at);
+            }
+            wake_sleepers();
+        }
+        return popped;
+    }
+
+    bool try_dequeue(T* item)
+    {
+        _accepting = true;
+        if (!try_pop(*item))
+            return false;
+        wake_sleepers();
+        return true;
+    }
+
+    void clear()
+    {
+        _accepting = false;
+        _need_to_flush = true;
+
+        T item;
+        while (try_pop(item))
+            item = T();
+        wake_sleepers();
+    }
+
+    void start()
+    {
+        _need_to_flush = false;
+        _accepting = true;
+    }
+
+    size_t size()
+    {
+        auto head = _head.load(std::memory_order_relaxed);
+        auto tail = _tail.load(std::memory_order_relaxed);
+        return tail > head ? tail - head : 0;
+    }
+};
+
+// Latest value written by a single thread, read by any thread without locking. The sequence is odd while
+// the value is written, readers retry until they copied the value between two equal even sequences.
+// T must be trivially copyable
 template<class T>
+class seqlock
+{
+    std::atomic<uint32_t> _sequence;
+    T _value;
+
+public:
+    seqlock() : _sequence(0), _value() {}
+
+    void store(const T& value)
+    {
+        auto seq = _sequence.load(std::memory_order_relaxed);
+        _sequence.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        _value = value;
+        _sequence.store(seq + 2, std::memory_order_release);
+    }
+
+    // False while nothing was stored since the construction or the last reset
+    bool load(T& value) const
+    {
+        while (true)
+        {
+            auto before = _sequence.load(std::memory_order_acquire);
+            if (before == 0)
+                return false;
+            if (before & 1)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+            value = _value;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (_sequence.load(std::memory_order_relaxed) == before)
+                return true;
+        }
+    }
+
+    // Must not race with store
+    void reset() { _sequence.store(0, std::memory_order_release); }
+};
+
+template<class T, class Queue = single_consumer_queue<T>>
 class single_consumer_frame_queue
 {
-    single_consumer_queue<T> _queue;
+    Queue _queue;
 
 public:
-    single_consumer_frame_queue<T>(unsigned int cap = QUEUE_MAX_SIZE) : _queue(cap) {}
+    single_consumer_frame_queue(unsigned int cap = QUEUE_MAX_SIZE, std::shared_ptr<wait_control> wait = nullptr) : _queue(cap, wait) {}
+
+    wait_control& get_wait_control() { return _queue.get_wait_control(); }
+
+    void set_on_drop(std::function<void(T&)> on_drop) { _queue.set_on_drop(std::move(on_drop)); }
 
     void enqueue(T&& item)
     {
@@ -190,6 +614,477 @@ public:
     }
 };
 
+// Ring buffer read by several consumers, each one through its own cursor. An item is stored once and every subscriber
+// receives its own copy of it through T::clone(), so the ring holds on to the last capacity items until they are overwritten.
+// A subscriber falling a whole ring behind either loses the oldest items, or holds the producer back until it reads
+template<class T>
+class broadcast_queue
+{
+public:
+    struct statistics
+    {
+        unsigned long long received;    // Items read by the subscriber
+        unsigned long long dropped;     // Items overwritten before the subscriber read them
+        size_t lag;                     // Items waiting for the subscriber
+        size_t max_lag;                 // Largest lag since the subscription
+    };
+
+    explicit broadcast_queue(unsigned int cap = QUEUE_MAX_SIZE)
+        : _slots(std::max(1u, cap)), _written(0), _next_id(1)
+    {}
+
+    ~broadcast_queue()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _subscribers.clear();
+        _data_cv.notify_all();
+        _space_cv.notify_all();
+    }
+
+    // The subscriber receives the items enqueued from now on
+    int subscribe(bool blocking)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto id = _next_id++;
+        _subscribers[id] = subscriber{ _written, blocking, 0, 0, 0 };
+        return id;
+    }
+
+    // Wakes up the reads of the subscriber and releases a producer it held back
+    void unsubscribe(int id)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _subscribers.erase(id);
+        _data_cv.notify_all();
+        _space_cv.notify_all();
+    }
+
+    void enqueue(T&& item)
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _space_cv.wait(lock, [this]() { return !held_back(); });
+
+        _slots[_written % _slots.size()] = std::move(item);
+        ++_written;
+        for (auto&& s : _subscribers)
+        {
+            auto& sub = s.second;
+            if (_written - sub.cursor > _slots.size())
+            {
+                sub.dropped += _written - _slots.size() - sub.cursor;
+                sub.cursor = _written - _slots.size();
+            }
+            sub.max_lag = std::max(sub.max_lag, size_t(_written - sub.cursor));
+        }
+        lock.unlock();
+        _data_cv.notify_all();
+    }
+
+    // Returns false on timeout, or once the subscriber is gone
+    bool dequeue(int id, T* item, unsigned int timeout_ms = 5000)
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        subscriber* sub = nullptr;
+        const auto ready = [&]()
+        {
+            auto it = _subscribers.find(id);
+            sub = it == _subscribers.end() ? nullptr : &it->second;
+            return !sub || sub->cursor < _written;
+        };
+        if (!ready() && !_data_cv.wait_for(lock, std::chrono::milliseconds(timeout_ms), ready))
+            return false;
+        if (!sub)
+            return false;
+
+        read(*sub, item);
+        return true;
+    }
+
+    bool try_dequeue(int id, T* item)
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        auto it = _subscribers.find(id);
+        if (it == _subscribers.end() || it->second.cursor == _written)
+            return false;
+
+        read(it->second, item);
+        return true;
+    }
+
+    bool get_statistics(int id, statistics* stats)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto it = _subscribers.find(id);
+        if (it == _subscribers.end())
+            return false;
+
+        auto& sub = it->second;
+        *stats = { sub.received, sub.dropped, size_t(_written - sub.cursor), sub.max_lag };
+        return true;
+    }
+
+    // Releases the stored items, the subscribers skip the ones they didn't read
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (auto&& slot : _slots)
+            slot = T();
+        for (auto&& s : _subscribers)
+        {
+            s.second.dropped += _written - s.second.cursor;
+            s.second.cursor = _written;
+        }
+        _space_cv.notify_all();
+    }
+
+private:
+    struct subscriber
+    {
+        unsigned long long cursor;  // Sequence number of the next item to read
+        bool blocking;
+        unsigned long long received;
+        unsigned long long dropped;
+        size_t max_lag;
+    };
+
+    bool held_back() const
+    {
+        for (auto&& s : _subscribers)
+            if (s.second.blocking && _written - s.second.cursor >= _slots.size())
+                return true;
+        return false;
+    }
+
+    void read(subscriber& sub, T* item)
+    {
+        auto was_full = _written - sub.cursor >= _slots.size();
+        *item = _slots[sub.cursor % _slots.size()].clone();
+        ++sub.cursor;
+        ++sub.received;
+        if (sub.blocking && was_full)
+            _space_cv.notify_all();
+    }
+
+    std::mutex _mutex;
+    std::condition_variable _data_cv;   // Signals new items
+    std::condition_variable _space_cv;  // Signals blocking subscribers catching up
+    std::vector<T> _slots;
+    unsigned long long _written;        // Sequence number of the next item to write
+    std::map<int, subscriber> _subscribers;
+    int _next_id;
+};
+
+// Library-wide pool of worker threads that dispatchers and active objects are multiplexed onto.
+// Every worker owns a deque: tasks posted from a worker stay on it, idle workers steal from the others
+// and from the shared injection queue. Threads are only started once work arrives, and the pool grows past
+// its configured size only to stand in for workers that are blocked inside a task
+class thread_pool
+{
+    struct worker
+    {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+        std::thread thread;
+        unsigned int index = 0;
+        bool retired = true;
+    };
+
+    static std::pair<thread_pool*, worker*>& current()
+    {
+        static thread_local std::pair<thread_pool*, worker*> self(nullptr, nullptr);
+        return self;
+    }
+
+public:
+    static const unsigned int max_threads = 256;
+
+    // Returns the process-wide pool, sized by LRS_THREAD_POOL_THREADS and pinned to LRS_THREAD_POOL_CPUS (comma-separated core ids)
+    static std::shared_ptr<thread_pool> instance();
+
+    // Pins the calling thread to a single core, returns false when the platform refused or does not support it
+    static bool set_current_thread_affinity(int cpu);
+
+    // Marks the calling worker as blocked for the lifetime of the object, so queued work is not held back by it
+    class blocking_region
+    {
+    public:
+        blocking_region()
+            : _pool(current().first)
+        {
+            if (_pool) _pool->enter_blocking();
+        }
+        ~blocking_region()
+        {
+            if (_pool) _pool->_blocked--;
+        }
+    private:
+        thread_pool* _pool;
+    };
+
+    explicit thread_pool(unsigned int threads = 0, std::vector<int> cpus = {})
+        : _slots(0), _running(0), _idle(0), _blocked(0), _pending(0), _completed(0), _generation(0), _alive(true)
+    {
+        configure(threads, std::move(cpus));
+    }
+
+    ~thread_pool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _alive = false;
+        }
+        _wake.notify_all();
+        _wake_supervisor.notify_all();
+
+        if (_supervisor.joinable())
+            join_or_detach(_supervisor);
+        for (unsigned int i = 0; i < _slots; ++i)
+        {
+            if (_workers[i]->thread.joinable())
+                join_or_detach(_workers[i]->thread);
+        }
+    }
+
+    // 0 threads selects a default based on the number of hardware threads.
+    // Workers are pinned round-robin to the listed cores, an empty list leaves affinity to the OS
+    void configure(unsigned int threads, std::vector<int> cpus)
+    {
+        if (!threads)
+            threads = std::min(8u, std::max(2u, std::thread::hardware_concurrency()));
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        _target = std::min(threads, static_cast<unsigned int>(max_threads));
+        _cpus = std::move(cpus);
+        ++_generation;
+        // Idle workers re-pin themselves, excess ones retire once they time out
+        _wake.notify_all();
+    }
+
+    // Makes the workers apply the schedule of RS2_THREAD_CATEGORY_DISPATCHER again
+    void reschedule()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        ++_generation;
+        _wake.notify_all();
+    }
+
+    unsigned int size() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _target;
+    }
+
+    void post(std::function<void()> task)
+    {
+        auto self = current();
+        ++_pending;
+
+        std::unique_lock<std::mutex> lock(_mutex, std::defer_lock);
+        if (self.first == this)
+        {
+            {
+                std::lock_guard<std::mutex> local(self.second->mutex);
+                self.second->tasks.push_back(std::move(task));
+            }
+            lock.lock();
+        }
+        else
+        {
+            lock.lock();
+            _injected.push_back(std::move(task));
+        }
+
+        if (_idle)
+            _wake.notify_one();
+        else if (_running < _target + _blocked)
+            spawn();
+    }
+
+private:
+    void enter_blocking()
+    {
+        ++_blocked;
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_pending && !_idle && _running < _target + _blocked)
+            spawn();
+    }
+
+    static void join_or_detach(std::thread& t)
+    {
+        // The last reference may be released by a task running on the pool itself
+        if (t.get_id() == std::this_thread::get_id())
+        {
+            current() = std::make_pair(nullptr, nullptr);
+            t.detach();
+        }
+        else
+            t.join();
+    }
+
+    // Requires _mutex
+    void spawn()
+    {
+        if (!_alive)
+            return;
+
+        worker* w = nullptr;
+        for (unsigned int i = 0; i < _slots && !w; ++i)
+        {
+            if (_workers[i]->retired)
+                w = _workers[i].get();
+        }
+        if (!w)
+        {
+            if (_slots == max_threads)
+                return;
+            _workers[_slots].reset(new worker());
+            _workers[_slots]->index = _slots;
+            w = _workers[_slots].get();
+            ++_slots;
+        }
+
+        // A retired worker already left its loop, the join only reclaims the thread
+        if (w->thread.joinable())
+            w->thread.join();
+        w->retired = false;
+        ++_running;
+        w->thread = std::thread([this, w]() { run(*w); });
+
+        if (!_supervisor.joinable())
+            _supervisor = std::thread([this]() { supervise(); });
+    }
+
+    bool take(worker& w, std::function<void()>& task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(w.mutex);
+            if (!w.tasks.empty())
+            {
+                task = std::move(w.tasks.front());
+                w.tasks.pop_front();
+                --_pending;
+                return true;
+            }
+        }
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (!_injected.empty())
+            {
+                task = std::move(_injected.front());
+                _injected.pop_front();
+                --_pending;
+                return true;
+            }
+        }
+
+        unsigned int slots = _slots;
+        for (unsigned int i = 1; i < slots; ++i)
+        {
+            auto&& victim = *_workers[(w.index + i) % slots];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty())
+            {
+                task = std::move(victim.tasks.back());
+                victim.tasks.pop_back();
+                --_pending;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void run(worker& w)
+    {
+        current() = std::make_pair(this, &w);
+        unsigned int generation = 0;
+
+        while (true)
+        {
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                if (!_alive)
+                    return;
+                if (generation != _generation)
+                {
+                    generation = _generation;
+                    auto cpu = _cpus.empty() ? -1 : _cpus[w.index % _cpus.size()];
+                    lock.unlock();
+                    // The cores of the pool configuration take precedence over those of the category
+                    librealsense::thread_scheduling::apply(RS2_THREAD_CATEGORY_DISPATCHER, "rs-worker");
+                    if (cpu >= 0)
+                        set_current_thread_affinity(cpu);
+                }
+            }
+
+            std::function<void()> task;
+            if (take(w, task))
+            {
+                try
+                {
+                    task();
+                }
+                catch (...) {}
+                task = nullptr;
+
+                // The pool was released from within the task
+                if (current().first != this)
+                    return;
+                ++_completed;
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(_mutex);
+            if (_pending)
+                continue;
+
+            ++_idle;
+            auto woken = _wake.wait_for(lock, std::chrono::seconds(5), [&]() { return !_alive || _pending || generation != _generation; });
+            --_idle;
+            if (!woken && _running > _target + _blocked)
+            {
+                w.retired = true;
+                --_running;
+                return;
+            }
+        }
+    }
+
+    // Lends an extra worker when queued work makes no progress, e.g. while every worker waits inside a user callback
+    void supervise()
+    {
+        size_t completed = _completed;
+        std::unique_lock<std::mutex> lock(_mutex);
+        while (_alive)
+        {
+            _wake_supervisor.wait_for(lock, std::chrono::milliseconds(100), [this]() { return !_alive; });
+            if (_pending && !_idle && completed == _completed)
+                spawn();
+            completed = _completed;
+        }
+    }
+
+    mutable std::mutex _mutex;
+    std::condition_variable _wake;
+    std::condition_variable _wake_supervisor;
+    std::deque<std::function<void()>> _injected;
+
+    std::unique_ptr<worker> _workers[max_threads];
+    std::atomic<unsigned int> _slots;
+    std::thread _supervisor;
+
+    unsigned int _running;
+    unsigned int _idle;
+    std::atomic<unsigned int> _blocked;
+    std::atomic<size_t> _pending;
+    std::atomic<size_t> _completed;
+
+    unsigned int _target;
+    std::vector<int> _cpus;
+    unsigned int _generation;
+    bool _alive;
+};
+
+// Executes the invoked items one at a time and in order, as a strand on the shared thread_pool
 class dispatcher
 {
 public:
@@ -204,48 +1099,51 @@ public:
         {
             using namespace std::chrono;
 
+            thread_pool::blocking_region blocking;
             std::unique_lock<std::mutex> lock(_owner->_was_stopped_mutex);
             auto good = [&]() { return _owner->_was_stopped.load(); };
             return !(_owner->_was_stopped_cv.wait_for(lock, milliseconds(ms), good));
         }
 
-    private:
-        dispatcher* _owner;
-    };
-
-    dispatcher(unsigned int cap)
-        : _queue(cap),
-          _was_stopped(true),
-          _was_flushed(false),
-          _is_alive(true)
-    {
-        _thread = std::thread([&]()
+        // Waits until the deadline, sleeping up to shortly before it and spinning the rest of the way, since a sleep
+        // wakes up late by as much as the scheduler granularity. The margin follows how late this thread wakes up
+        bool try_sleep_until(std::chrono::steady_clock::time_point deadline)
         {
-            while (_is_alive)
+            using namespace std::chrono;
+
+            static thread_local nanoseconds margin = microseconds(500);
+            auto wake_up = deadline - margin;
+            if (steady_clock::now() < wake_up)
             {
-                std::function<void(cancellable_timer)> item;
+                thread_pool::blocking_region blocking;
+                std::unique_lock<std::mutex> lock(_owner->_was_stopped_mutex);
+                auto good = [&]() { return _owner->_was_stopped.load(); };
+                if (_owner->_was_stopped_cv.wait_until(lock, wake_up, good))
+                    return false;
 
-                if (_queue.dequeue(&item))
-                {
-                    cancellable_timer time(this);
+                // Grows right away with a late wake-up and shrinks slowly back
+                auto late = duration_cast<nanoseconds>(steady_clock::now() - wake_up) + microseconds(200);
+                margin = late > margin ? late : (margin * 7 + late) / 8;
+                margin = std::min<nanoseconds>(std::max<nanoseconds>(margin, microseconds(200)), milliseconds(20));
+            }
+            while (steady_clock::now() < deadline)
+            {
+                if (_owner->_was_stopped)
+                    return false;
+                std::this_thread::yield();
+            }
+            return true;
+        }
 
-                    try
-                    {
-                        item(time);
-                    }
-                    catch(...){}
-                }
+    private:
+        dispatcher* _owner;
+    };
 
-#ifndef ANDROID
-                std::unique_lock<std::mutex> lock(_was_flushed_mutex);
-#endif
-                _was_flushed = true;
-                _was_flushed_cv.notify_all();
-#ifndef ANDROID
-                lock.unlock();
-#endif
-            }
-        });
+    dispatcher(unsigned int cap, std::shared_ptr<thread_pool> pool = thread_pool::instance())
+        : _pool(std::move(pool)),
+          _strand(std::make_shared<strand>(this, _pool, cap)),
+          _was_stopped(true)
+    {
     }
 
     template<class T>
@@ -253,10 +1151,16 @@ public:
     {
         if (!_was_stopped)
         {
-            if(is_blocking)
-                _queue.blocking_enqueue(std::move(item));
+            if (is_blocking)
+            {
+                thread_pool::blocking_region blocking;
+                _strand->queue.blocking_enqueue(std::move(item));
+            }
             else
-                _queue.enqueue(std::move(item));
+                _strand->queue.enqueue(std::move(item));
+
+            if (!_strand->scheduled.exchange(true))
+                schedule(_strand);
         }
     }
 
@@ -265,36 +1169,33 @@ public:
         std::unique_lock<std::mutex> lock(_was_stopped_mutex);
         _was_stopped = false;
 
-        _queue.start();
+        _strand->queue.start();
     }
 
     void stop()
     {
         {
+            // Cancelled timers return only after the queue is cleared, so the next item cannot slip in
             std::unique_lock<std::mutex> lock(_was_stopped_mutex);
             _was_stopped = true;
+            _strand->queue.clear();
             _was_stopped_cv.notify_all();
         }
 
-        _queue.clear();
-
+        // Wait for the item in progress, unless it is the one stopping the dispatcher
         {
-            std::unique_lock<std::mutex> lock(_was_flushed_mutex);
-            _was_flushed = false;
+            thread_pool::blocking_region blocking;
+            std::unique_lock<std::mutex> lock(_strand->mutex);
+            _strand->idle_cv.wait(lock, [&]() { return !_strand->running || _strand->runner == std::this_thread::get_id(); });
         }
 
-        std::unique_lock<std::mutex> lock_was_flushed(_was_flushed_mutex);
-        _was_flushed_cv.wait_for(lock_was_flushed, std::chrono::hours(999999), [&]() { return _was_flushed.load(); });
-
-        _queue.start();
+        _strand->queue.start();
     }
 
     ~dispatcher()
     {
         stop();
-        _queue.clear();
-        _is_alive = false;
-        _thread.join();
+        _strand->queue.clear();
     }
 
     bool flush()
@@ -309,12 +1210,12 @@ public:
             if (_was_stopped || !(*wait_sucess))
                 return;
 
-            {
-                std::lock_guard<std::mutex> locker(m);
-                invoked = true;
-            }
+            // Notify under the lock, the waiter owns cv and may return as soon as it sees invoked
+            std::lock_guard<std::mutex> locker(m);
+            invoked = true;
             cv.notify_one();
         });
+        thread_pool::blocking_region blocking;
         std::unique_lock<std::mutex> locker(m);
         *wait_sucess = cv.wait_for(locker, std::chrono::seconds(10), [&]() { return invoked || _was_stopped; });
         return *wait_sucess;
@@ -322,23 +1223,86 @@ public:
 
     bool empty()
     {
-        return _queue.size() == 0;
+        return _strand->queue.size() == 0;
     }
 
 private:
     friend cancellable_timer;
-    single_consumer_queue<std::function<void(cancellable_timer)>> _queue;
-    std::thread _thread;
+
+    // Outlives the dispatcher while a drain is still queued on the pool
+    struct strand
+    {
+        strand(dispatcher* owner, const std::shared_ptr<thread_pool>& pool, unsigned int cap)
+            : owner(owner), pool(pool), queue(cap), scheduled(false), running(false)
+        {}
+
+        dispatcher* owner;
+        std::weak_ptr<thread_pool> pool;
+        single_consumer_queue<std::function<void(cancellable_timer)>> queue;
+        std::atomic<bool> scheduled;
+
+        std::mutex mutex;
+        std::condition_variable idle_cv;
+        bool running;
+        std::thread::id runner;
+    };
+
+    static void schedule(const std::shared_ptr<strand>& s)
+    {
+        if (auto pool = s->pool.lock())
+            pool->post([s]() { drain(s); });
+        else
+            s->scheduled = false;
+    }
+
+    // Runs a bounded batch of items, then yields the worker to the other strands
+    static void drain(const std::shared_ptr<strand>& s)
+    {
+        const int batch = 16;
+        for (int i = 0; i < batch; ++i)
+        {
+            {
+                std::lock_guard<std::mutex> lock(s->mutex);
+                s->running = true;
+                s->runner = std::this_thread::get_id();
+            }
+
+            std::function<void(cancellable_timer)> item;
+            auto dequeued = s->queue.try_dequeue(&item);
+            if (dequeued)
+            {
+                try
+                {
+                    item(cancellable_timer(s->owner));
+                }
+                catch (...) {}
+                item = nullptr;
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(s->mutex);
+                s->running = false;
+                s->runner = std::thread::id();
+            }
+            s->idle_cv.notify_all();
+
+            if (!dequeued)
+            {
+                // Items invoked after the queue was found empty schedule a new drain, unless this one takes them
+                s->scheduled = false;
+                if (!s->queue.size() || s->scheduled.exchange(true))
+                    return;
+            }
+        }
+        schedule(s);
+    }
+
+    std::shared_ptr<thread_pool> _pool;
+    std::shared_ptr<strand> _strand;
 
     std::atomic<bool> _was_stopped;
     std::condition_variable _was_stopped_cv;
     std::mutex _was_stopped_mutex;
-
-    std::atomic<bool> _was_flushed;
-    std::condition_variable _was_flushed_cv;
-    std::mutex _was_flushed_mutex;
-
-    std::atomic<bool> _is_alive;
 };
 
 template<class T = std::function<void(dispatcher::cancellable_timer)>>
@@ -385,3 +1349,152 @@ private:
     dispatcher _dispatcher;
     std::atomic<bool> _stopped;
 };
+
+// Runs the tiles of a data-parallel job on a fixed set of worker threads.
+// The calling thread participates, so a size of 1 executes everything inline.
+// for_each blocks until all tiles completed and rethrows the first exception raised by any of them.
+// The workers only refer to the job of the caller, so running one doesn't allocate
+class parallel_executor
+{
+public:
+    explicit parallel_executor(unsigned int threads = 1)
+        : _job(nullptr), _count(0), _next(0), _busy(0), _generation(0), _alive(true)
+    {
+        resize(threads);
+    }
+
+    ~parallel_executor()
+    {
+        stop_workers();
+    }
+
+    // 0 selects the number of hardware threads
+    void resize(unsigned int threads)
+    {
+        if (!threads)
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        if (threads == size())
+            return;
+
+        stop_workers();
+        _alive = true;
+        for (unsigned int i = 1; i < threads; ++i)
+            _workers.emplace_back([this]() { work(); });
+    }
+
+    unsigned int size() const { return static_cast<unsigned int>(_workers.size()) + 1; }
+
+    template<class F>
+    void for_each(size_t count, F&& f)
+    {
+        if (count <= 1 || _workers.empty())
+        {
+            for (size_t i = 0; i < count; ++i) f(i);
+            return;
+        }
+
+        typedef typename std::remove_reference<F>::type job_type;
+        job_ref job;
+        job.target = &f;
+        job.call = [](const void* target, size_t i) { (*static_cast<job_type*>(const_cast<void*>(target)))(i); };
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _job = &job;
+            _count = count;
+            _next = 0;
+            _busy = _workers.size();
+            _error = nullptr;
+            ++_generation;
+        }
+        _wake.notify_all();
+
+        run_tiles(job);
+
+        std::unique_lock<std::mutex> lock(_mutex);
+        _done.wait(lock, [&]() { return _busy == 0; });
+        _job = nullptr;
+        if (_error)
+            std::rethrow_exception(_error);
+    }
+
+    // Splits [0, count) into a few ranges per thread, every inner boundary a multiple of alignment, and calls f(begin, end) on each
+    template<class F>
+    void for_each_range(size_t count, size_t alignment, F&& f)
+    {
+        size_t ranges = std::max<size_t>(1, std::min<size_t>(size() > 1 ? size() * 4 : 1, count / alignment));
+        for_each(ranges, [&](size_t r)
+        {
+            size_t begin = count * r / ranges / alignment * alignment;
+            size_t end = (r + 1 == ranges) ? count : count * (r + 1) / ranges / alignment * alignment;
+            f(begin, end);
+        });
+    }
+
+private:
+    // The callable of for_each, valid until it returns
+    struct job_ref
+    {
+        const void* target;
+        void (*call)(const void*, size_t);
+    };
+
+    void run_tiles(const job_ref& job)
+    {
+        for (size_t i = _next++; i < _count; i = _next++)
+        {
+            try
+            {
+                job.call(job.target, i);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                if (!_error) _error = std::current_exception();
+            }
+        }
+    }
+
+    void work()
+    {
+        unsigned long long seen = 0;
+        std::unique_lock<std::mutex> lock(_mutex);
+        while (true)
+        {
+            _wake.wait(lock, [&]() { return !_alive || _generation != seen; });
+            if (!_alive)
+                return;
+            seen = _generation;
+
+            auto job = _job;
+            lock.unlock();
+            run_tiles(*job);
+            lock.lock();
+
+            if (--_busy == 0)
+                _done.notify_one();
+        }
+    }
+
+    void stop_workers()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _alive = false;
+        }
+        _wake.notify_all();
+        for (auto&& t : _workers)
+            t.join();
+        _workers.clear();
+    }
+
+    std::vector<std::thread> _workers;
+    std::mutex _mutex;
+    std::condition_variable _wake, _done;
+    const job_ref* _job;
+    size_t _count;
+    std::atomic<size_t> _next;
+    size_t _busy;
+    unsigned long long _generation;
+    bool _alive;
+    std::exception_ptr _error;
+};
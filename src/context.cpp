@@ -14,11 +14,12 @@
 #include "ds5/ds5-timestamp.h"
 #include "backend.h"
 #include "mock/recorder.h"
-#include <media/ros/ros_reader.h>
+#include <media/device-serializers.h>
 #include "types.h"
 #include "stream.h"
 #include "environment.h"
 #include "context.h"
+#include "shared-backend.h"
 
 #ifdef WITH_TRACKING
 #include "tm2/tm-info.h"
@@ -95,14 +96,20 @@ namespace librealsense
                      const char* section,
                      rs2_recording_mode mode,
                      std::string min_api_version)
-        : _devices_changed_callback(nullptr, [](rs2_devices_changed_callback*){})
+        : _devices_changed_callback(nullptr, [](rs2_devices_changed_callback*){}),
+          _memory(std::make_shared<memory_account>())
     {
         LOG_DEBUG("Librealsense " << std::string(std::begin(rs2_api_version),std::end(rs2_api_version)));
 
         switch(type)
         {
         case backend_type::standard:
-            _backend = platform::create_backend();
+        {
+            // The contexts of the process share the backend and a single device watcher
+            auto shared = shared_backend::get();
+            _backend = shared.backend;
+            _device_watcher = shared.watchers->create_watcher();
+        }
 #if WITH_TRACKING
             _tm2_context = std::make_shared<tm2_context>(this);
             _tm2_context->on_device_changed += [this](std::shared_ptr<tm2_info> removed, std::shared_ptr<tm2_info> added)-> void
@@ -118,7 +125,7 @@ namespace librealsense
 #endif
             break;
         case backend_type::record:
-            _backend = std::make_shared<platform::record_backend>(platform::create_backend(), filename, section, mode);
+            _backend = std::make_shared<platform::record_backend>(shared_backend::get().backend, filename, section, mode);
             break;
         case backend_type::playback:
             _backend = std::make_shared<platform::playback_backend>(filename, section, min_api_version);
@@ -129,7 +136,8 @@ namespace librealsense
 
        environment::get_instance().set_time_service(_backend->create_time_service());
 
-       _device_watcher = _backend->create_device_watcher();
+       if (!_device_watcher)
+           _device_watcher = _backend->create_device_watcher();
     }
 
 
@@ -268,6 +276,7 @@ namespace librealsense
 
             color_ep->register_pixel_format(pf_yuy2);
             color_ep->register_pixel_format(pf_yuyv);
+            color_ep->register_pixel_format(pf_mjpeg);
 
             color_ep->try_register_pu(RS2_OPTION_BACKLIGHT_COMPENSATION);
             color_ep->try_register_pu(RS2_OPTION_BRIGHTNESS);
@@ -524,7 +533,7 @@ namespace librealsense
             //Already exists
             throw librealsense::invalid_value_exception(to_string() << "File \"" << file << "\" already loaded to context");
         }
-        auto playback_dev = std::make_shared<playback_device>(shared_from_this(), std::make_shared<ros_reader>(file, shared_from_this()));
+        auto playback_dev = std::make_shared<playback_device>(shared_from_this(), create_file_reader(file, shared_from_this()));
         auto dinfo = std::make_shared<playback_device_info>(playback_dev);
         auto prev_playback_devices = _playback_devices;
         _playback_devices[file] = dinfo;
@@ -7,6 +7,7 @@
 #include "backend.h"
 #include "mock/recorder.h"
 #include "core/streaming.h"
+#include "memory-accounting.h"
 #if WITH_TRACKING
     #include "tm2/tm-context.h"
 #endif
@@ -132,6 +133,9 @@ namespace librealsense
         std::shared_ptr<device_interface> add_device(const std::string& file);
         void remove_device(const std::string& file);
 
+        // Frame memory of the sensors of the devices created by the context
+        std::shared_ptr<memory_account> get_memory_account() const { return _memory; }
+
     private:
         void on_device_changed(platform::backend_device_group old,
                                platform::backend_device_group curr,
@@ -154,6 +158,7 @@ namespace librealsense
         std::map<int, std::weak_ptr<const stream_interface>> _streams;
         std::map<int, std::map<int, std::weak_ptr<lazy<rs2_extrinsics>>>> _extrinsics;
         std::mutex _streams_mutex, _devices_changed_callbacks_mtx;
+        std::shared_ptr<memory_account> _memory;
     };
 
     class readonly_device_info : public device_info
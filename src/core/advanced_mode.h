@@ -9,6 +9,7 @@
 #define RS400_ADVANCED_MODE_HPP
 #include "ds5/advanced_mode/presets.h"
 #include "../../include/librealsense2/h/rs_advanced_mode_command.h"
+#include <cstring>
 #undef RS400_ADVANCED_MODE_HPP
 
 
@@ -204,34 +205,75 @@ namespace librealsense
         static const uint16_t HW_MONITOR_BUFFER_SIZE = 1024;
 
         preset get_all() const;
-        void set_all(const preset& p);
+        // With the current device state given, only the register groups and controls that differ from it are written
+        void set_all(const preset& p, const preset* current = nullptr);
+
+        template<class T>
+        static const T* field(const preset* p, T preset::* member)
+        {
+            return p ? &(p->*member) : nullptr;
+        }
+
+        template<class T, class V>
+        static bool changed(const T& next, const T* current, V T::* value)
+        {
+            return !current || !current->was_set || !next.was_set || next.*value != current->*value;
+        }
+
+        template<class T>
+        void queue_set(std::vector<std::vector<uint8_t>>& groups, const T& next, const T* current) const
+        {
+            if (!current || std::memcmp(&next, current, sizeof(T)) != 0)
+                groups.push_back(encode_set(next, advanced_mode_traits<T>::group));
+        }
+
+        void send_groups(std::vector<std::vector<uint8_t>>& groups) const;
 
         std::vector<uint8_t> send_receive(const std::vector<uint8_t>& input) const;
+        // Register groups are read and written in hw_monitor batches, powering and locking the device once
+        std::vector<std::vector<uint8_t>> send_receive(const std::vector<std::vector<uint8_t>>& inputs,
+                                                       std::chrono::milliseconds interval = std::chrono::milliseconds(0)) const;
+
+        // The firmware needs this pause after each register group write
+        static const int SET_ADV_INTERVAL_MS = 20;
 
         template<class T>
-        void set(const T& strct, EtAdvancedModeRegGroup cmd) const
+        std::vector<uint8_t> encode_set(const T& strct, EtAdvancedModeRegGroup cmd) const
         {
             auto ptr = (uint8_t*)(&strct);
             std::vector<uint8_t> data(ptr, ptr + sizeof(T));
+            return encode_command(ds::fw_cmd::SET_ADV, static_cast<uint32_t>(cmd), 0, 0, 0, data);
+        }
 
-            assert_no_error(ds::fw_cmd::SET_ADV,
-                send_receive(encode_command(ds::fw_cmd::SET_ADV, static_cast<uint32_t>(cmd), 0, 0, 0, data)));
-            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        template<class T>
+        std::vector<uint8_t> encode_get(int mode = 0) const
+        {
+            return encode_command(ds::fw_cmd::GET_ADV, static_cast<uint32_t>(advanced_mode_traits<T>::group), mode);
         }
 
         template<class T>
-        T get(EtAdvancedModeRegGroup cmd, T* ptr = static_cast<T*>(nullptr), int mode = 0) const
+        static T decode_get(const std::vector<uint8_t>& response)
         {
-            T res;
-            auto data = assert_no_error(ds::fw_cmd::GET_ADV,
-                send_receive(encode_command(ds::fw_cmd::GET_ADV,
-                static_cast<uint32_t>(cmd), mode)));
+            auto data = assert_no_error(ds::fw_cmd::GET_ADV, response);
             if (data.size() < sizeof(T))
             {
                 throw std::runtime_error("The camera returned invalid sized result!");
             }
-            res = *reinterpret_cast<T*>(data.data());
-            return res;
+            return *reinterpret_cast<T*>(data.data());
+        }
+
+        template<class T>
+        void set(const T& strct, EtAdvancedModeRegGroup cmd) const
+        {
+            assert_no_error(ds::fw_cmd::SET_ADV, send_receive(encode_set(strct, cmd)));
+            std::this_thread::sleep_for(std::chrono::milliseconds(SET_ADV_INTERVAL_MS));
+        }
+
+        template<class T>
+        T get(EtAdvancedModeRegGroup cmd, T* ptr = static_cast<T*>(nullptr), int mode = 0) const
+        {
+            return decode_get<T>(send_receive(encode_command(ds::fw_cmd::GET_ADV,
+                static_cast<uint32_t>(cmd), mode)));
         }
 
         static uint32_t pack(uint8_t c0, uint8_t c1, uint8_t c2, uint8_t c3);
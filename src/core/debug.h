@@ -12,6 +12,15 @@ namespace librealsense
     {
     public:
         virtual std::vector<uint8_t> send_receive_raw_data(const std::vector<uint8_t>& input) = 0;
+
+        // Sends the commands back to back, devices that can lock and power up once for all of them override it
+        virtual std::vector<std::vector<uint8_t>> send_receive_raw_data_batch(const std::vector<std::vector<uint8_t>>& inputs)
+        {
+            std::vector<std::vector<uint8_t>> results;
+            for (auto&& input : inputs)
+                results.push_back(send_receive_raw_data(input));
+            return results;
+        }
     };
 
     MAP_EXTENSION(RS2_EXTENSION_DEBUG, librealsense::debug_interface);
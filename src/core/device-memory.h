@@ -0,0 +1,21 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+#pragma once
+
+#include <cstddef>
+
+namespace librealsense
+{
+    // Frame data held in accelerator memory. Kept free of library headers, so that device
+    // compilers can implement it
+    class device_memory
+    {
+    public:
+        virtual void* get() const = 0;
+        virtual size_t size() const = 0;
+        // Copies the whole buffer into host memory of at least size() bytes
+        virtual void download(void* host) const = 0;
+
+        virtual ~device_memory() = default;
+    };
+}
@@ -35,4 +35,13 @@ namespace librealsense
         virtual ~tm2_extensions() = default;
     };
     MAP_EXTENSION(RS2_EXTENSION_TM2, librealsense::tm2_extensions);
+
+    class pose_sensor_interface
+    {
+    public:
+        // Copies the most recent pose without waiting for its frame, false until the stream delivered one
+        virtual bool get_latest_pose(rs2_pose& pose, rs2_time_t& timestamp) const = 0;
+        virtual ~pose_sensor_interface() = default;
+    };
+    MAP_EXTENSION(RS2_EXTENSION_POSE_SENSOR, librealsense::pose_sensor_interface);
 }
@@ -3,12 +3,19 @@
 #pragma once
 
 #include <map>
+#include <memory>
+#include <vector>
+#include <functional>
 #include "../include/librealsense2/h/rs_option.h"
 #include "extension.h"
 #include "types.h"
 
 namespace librealsense
 {
+    class cached_option;
+    class async_option_writer;
+    class frame_interface;
+
     struct option_range
     {
         float min;
@@ -32,6 +39,19 @@ namespace librealsense
         virtual ~option() = default;
     };
 
+    // An option that is one field of a device control holding several options.
+    // Fields staged together are sent by a single write of the control
+    class batched_option
+    {
+    public:
+        // Sets the field without writing the control
+        virtual void stage(float value) = 0;
+        // Writes the control if any of its fields was staged since the last write
+        virtual void commit() = 0;
+
+        virtual ~batched_option() = default;
+    };
+
 
     class options_interface : public recordable<options_interface>
     {
@@ -39,6 +59,8 @@ namespace librealsense
         virtual option& get_option(rs2_option id) = 0;
         virtual const option& get_option(rs2_option id) const = 0;
         virtual bool supports_option(rs2_option id) const = 0;
+        // Reads all the supported options, an option that fails to read is reported without a value
+        virtual std::vector<rs2_option_value> get_options_snapshot() const;
 
         virtual ~options_interface() = default;
     };
@@ -103,7 +125,36 @@ namespace librealsense
             }
         }
 
+        // Serve queries of the option from its last known value, refreshed on set and from frame metadata
+        void enable_option_cache(rs2_option id, bool enable);
+        // The callback is invoked with the new value whenever a set, a query or frame metadata changes the option
+        void add_option_observer(rs2_option id, std::function<void(float)> callback);
+        // Refreshes the cached options whose value the frame metadata reports
+        void update_options_from_metadata(const frame_interface& frame);
+        // The frame metadata reporting the value of the option, in its units. Some are reported only while auto exposure is off
+        static bool get_option_metadata(rs2_option id, rs2_frame_metadata_value* metadata, bool* manual_exposure_only);
+        // Writes the option from a thread of the container, done is invoked with the outcome. A pending write of the option
+        // is replaced by the newer value, and completes with it. Fields of a control written together go out in one write
+        void set_option_async(rs2_option id, float value, std::function<void(std::exception_ptr)> done);
+        // Cancels the asynchronous writes not started and waits for the one in progress. A derived class whose options
+        // refer to it calls it first in its destructor, before the container would
+        void stop_async_writes();
+
     private:
+        std::shared_ptr<cached_option> get_cached_option(rs2_option id);
+
+        struct metadata_option
+        {
+            rs2_frame_metadata_value metadata;
+            bool manual_exposure_only;
+            std::shared_ptr<cached_option> option;
+        };
+        typedef std::vector<metadata_option> metadata_options;
+        // Swapped atomically, so that frame callbacks can read it while the user enables caching
+        std::shared_ptr<const metadata_options> _metadata_options = std::make_shared<metadata_options>();
+        // Created with the first asynchronous write
+        std::shared_ptr<async_option_writer> _async_writer;
+
         std::map<rs2_option, std::shared_ptr<option>> _options;
         std::function<void(const options_interface&)> _recording_function = [](const options_interface&) {};
     };
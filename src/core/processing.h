@@ -2,6 +2,7 @@
 // Copyright(c) 2015 Intel Corporation. All Rights Reserved.
 
 #pragma once
+#include <array>
 #include "streaming.h"
 
 namespace librealsense
@@ -16,6 +17,43 @@ struct rs2_source
 
 namespace librealsense
 {
+    // Collects the frames of a composite frame. Framesets of up to inline_capacity frames are kept in place, larger
+    // ones move to the heap once, so assembling the usual framesets allocates nothing
+    class composite_frame_builder
+    {
+    public:
+        static const size_t inline_capacity = 8;
+
+        composite_frame_builder() : _size(0) {}
+
+        void push_back(frame_holder f)
+        {
+            if (_heap.empty() && _size < inline_capacity)
+            {
+                _inline[_size++] = std::move(f);
+                return;
+            }
+            if (_heap.empty())
+            {
+                _heap.reserve(inline_capacity * 2);
+                for (size_t i = 0; i < _size; i++)
+                    _heap.push_back(std::move(_inline[i]));
+            }
+            _heap.push_back(std::move(f));
+            _size++;
+        }
+
+        frame_holder* begin() { return _heap.empty() ? _inline.data() : _heap.data(); }
+        frame_holder* end() { return begin() + _size; }
+        size_t size() const { return _size; }
+        bool empty() const { return _size == 0; }
+
+    private:
+        std::array<frame_holder, inline_capacity> _inline;
+        std::vector<frame_holder> _heap; // Holds all the frames once there are more than fit in place
+        size_t _size;
+    };
+
     class synthetic_source_interface
     {
     public:
@@ -30,8 +68,10 @@ namespace librealsense
                                                       rs2_extension frame_type = RS2_EXTENSION_VIDEO_FRAME) = 0;
 
         virtual frame_interface* allocate_composite_frame(std::vector<frame_holder> frames) = 0;
+        // Takes the frames out of the builder
+        virtual frame_interface* allocate_composite_frame(composite_frame_builder& frames) = 0;
 
-        virtual frame_interface* allocate_points(std::shared_ptr<stream_profile_interface> stream, frame_interface* original) = 0;
+        virtual frame_interface* allocate_points(std::shared_ptr<stream_profile_interface> stream, frame_interface* original, bool pixel_indices = false, bool colors = false) = 0;
 
         virtual void frame_ready(frame_holder result) = 0;
         virtual rs2_source* get_c_wrapper() = 0;
@@ -43,6 +83,9 @@ namespace librealsense
         virtual void set_processing_callback(frame_processor_callback_ptr callback) = 0;
         virtual void set_output_callback(frame_callback_ptr callback) = 0;
         virtual void invoke(frame_holder frame) = 0;
+        // Processes the frame on the calling thread and returns the last frame the block produced instead of
+        // passing it to the output callback, empty when the block produced none
+        virtual frame_holder process(frame_holder frame) = 0;
         virtual synthetic_source_interface& get_source() = 0;
 
         virtual ~processing_block_interface() = default;
@@ -3,8 +3,10 @@
 
 #pragma once
 #include <chrono>
+#include <iomanip>
 #include <map>
 #include <memory>
+#include <sstream>
 #include <vector>
 #include "types.h"
 #include "extension.h"
@@ -330,6 +332,11 @@ namespace librealsense
             virtual void write_snapshot(const sensor_identifier& sensor_id, const nanoseconds& timestamp, rs2_extension type, const std::shared_ptr<extension_snapshot>& snapshot) = 0;
             virtual void write_notification(const sensor_identifier& stream_id, const nanoseconds& timestamp, const notification& n) = 0;
             virtual const std::string& get_file_name() const = 0;
+            virtual void set_chunk_size(uint32_t bytes) = 0;
+            virtual void set_columnar_metadata(bool enable) = 0;
+            virtual void set_stream_compression(rs2_stream stream, uint32_t index, bool enable) = 0;
+            //Opens a writer of the same format and compression, that continues the recording in another file
+            virtual std::shared_ptr<writer> create_segment(const std::string& file) const = 0;
             virtual ~writer() = default;
         };
 
@@ -347,5 +354,20 @@ namespace librealsense
             virtual const std::string& get_file_name() const = 0;
             virtual std::vector<std::shared_ptr<serialized_data>> fetch_last_frames(const nanoseconds& seek_time) = 0;
         };
+
+        //Recordings split into segments continue in "name.001.ext", "name.002.ext" and so on, next to the first file
+        inline std::string get_segment_file_name(const std::string& file, uint32_t segment)
+        {
+            if (segment == 0)
+                return file;
+
+            std::ostringstream suffix;
+            suffix << "." << std::setw(3) << std::setfill('0') << segment;
+            auto dot = file.find_last_of('.');
+            auto separator = file.find_last_of("/\\");
+            if (dot == std::string::npos || (separator != std::string::npos && dot < separator))
+                return file + suffix.str();
+            return file.substr(0, dot) + suffix.str() + file.substr(dot);
+        }
     }
 }
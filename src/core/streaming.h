@@ -5,6 +5,7 @@
 #include "options.h"
 #include "types.h"
 #include "info.h"
+#include "device-memory.h"
 #include <functional>
 
 namespace librealsense
@@ -89,6 +90,11 @@ namespace librealsense
         virtual rs2_timestamp_domain get_frame_timestamp_domain() const = 0;
         virtual void set_timestamp(double new_ts) = 0;
         virtual unsigned long long get_frame_number() const = 0;
+        virtual int get_frame_dmabuf_fd() const = 0;
+        // Processing blocks running on an accelerator leave their output in device memory, the host copy
+        // is then only brought up to date when the frame data is queried
+        virtual std::shared_ptr<device_memory> get_device_memory() const = 0;
+        virtual void attach_device_memory(std::shared_ptr<device_memory> memory, bool host_is_stale) = 0;
 
         virtual void set_timestamp_domain(rs2_timestamp_domain timestamp_domain) = 0;
         virtual rs2_time_t get_frame_system_time() const = 0;
@@ -100,6 +106,8 @@ namespace librealsense
 
         virtual void acquire() = 0;
         virtual void release() = 0;
+        // Only the caller references the frame, and the pixels are its own rather than a driver or user buffer
+        virtual bool is_uniquely_owned() const = 0;
         virtual frame_interface* publish(std::shared_ptr<archive_interface> new_owner) = 0;
         virtual void attach_continuation(frame_continuation&& continuation) = 0;
         virtual void disable_continuation() = 0;
@@ -109,6 +117,10 @@ namespace librealsense
 
         virtual archive_interface* get_owner() const = 0;
 
+        // Whether the frame type is, or derives from, the frame type of the extension. Answered from
+        // flags set at construction, so unlike extension checks through dynamic_cast it takes constant time
+        virtual bool is_extendable_to(rs2_extension extension) const = 0;
+
         virtual void mark_fixed() = 0;
         virtual bool is_fixed() const = 0;
         virtual void set_blocking(bool state) = 0;
@@ -185,6 +197,17 @@ namespace librealsense
     };
 
 
+    // Implemented by sensors that write frame content through frame_interface::get_frame_data,
+    // which allows their frames to be backed by user-provided memory
+    class frame_allocator_interface
+    {
+    public:
+        virtual void set_frame_allocator(frame_allocator_ptr allocator) = 0;
+        // Cores the threads that deliver the frames are moved to, along with the placement of the buffers. Empty leaves them be
+        virtual void set_callback_cpus(std::vector<int> cpus) = 0;
+        virtual ~frame_allocator_interface() = default;
+    };
+
     class matcher;
 
     class device_interface : public virtual info_interface, public std::enable_shared_from_this<device_interface>
@@ -6,6 +6,9 @@
 #include <iostream>
 #include <iomanip>
 #include "rscuda_utils.cuh"
+#include "cuda-staging.cuh"
+
+static int blocks_for(int count) { return (count + RS2_CUDA_THREADS_PER_BLOCK - 1) / RS2_CUDA_THREADS_PER_BLOCK; }
 /*
 // conversion to Y8 is currently not available in the API
 __global__ void kernel_unpack_yuy2_y8_cuda(const uint8_t * src, uint8_t *dst, int superPixCount)
@@ -83,13 +86,13 @@ __global__ void kernel_unpack_yuy2_rgb8_cuda(const uint8_t * src, uint8_t *dst,
         int odx = i * 6;
 
         dst[odx] = clamp((298 * c + 409 * e + 128) >> 8);
-        dst[odx + 1] = clamp((298 * c - 100 * d - 409 * e + 128) >> 8);
+        dst[odx + 1] = clamp((298 * c - 100 * d - 208 * e + 128) >> 8);
         dst[odx + 2] = clamp((298 * c + 516 * d + 128) >> 8);
 
         c = y1 - 16;
 
         dst[odx + 3] = clamp((298 * c + 409 * e + 128) >> 8);
-        dst[odx + 4] = clamp((298 * c - 100 * d - 409 * e + 128) >> 8);
+        dst[odx + 4] = clamp((298 * c - 100 * d - 208 * e + 128) >> 8);
         dst[odx + 5] = clamp((298 * c + 516 * d + 128) >> 8);
 
 #undef clamp
@@ -124,13 +127,13 @@ __global__ void kernel_unpack_yuy2_bgr8_cuda(const uint8_t * src, uint8_t *dst,
         int odx = i * 6;
 
         dst[odx + 2] = clamp((298 * c + 409 * e + 128) >> 8);
-        dst[odx + 1] = clamp((298 * c - 100 * d - 409 * e + 128) >> 8);
+        dst[odx + 1] = clamp((298 * c - 100 * d - 208 * e + 128) >> 8);
         dst[odx] = clamp((298 * c + 516 * d + 128) >> 8);
 
         c = y1 - 16;
 
         dst[odx + 5] = clamp((298 * c + 409 * e + 128) >> 8);
-        dst[odx + 4] = clamp((298 * c - 100 * d - 409 * e + 128) >> 8);
+        dst[odx + 4] = clamp((298 * c - 100 * d - 208 * e + 128) >> 8);
         dst[odx + 3] = clamp((298 * c + 516 * d + 128) >> 8);
 
 #undef clamp
@@ -165,14 +168,14 @@ __global__ void kernel_unpack_yuy2_rgba8_cuda(const uint8_t * src, uint8_t *dst,
         int odx = i * 8;
 
         dst[odx] = clamp((298 * c + 409 * e + 128) >> 8);
-        dst[odx + 1] = clamp((298 * c - 100 * d - 409 * e + 128) >> 8);
+        dst[odx + 1] = clamp((298 * c - 100 * d - 208 * e + 128) >> 8);
         dst[odx + 2] = clamp((298 * c + 516 * d + 128) >> 8);
         dst[odx + 3] = 255;
 
         c = y1 - 16;
 
         dst[odx + 4] = clamp((298 * c + 409 * e + 128) >> 8);
-        dst[odx + 5] = clamp((298 * c - 100 * d - 409 * e + 128) >> 8);
+        dst[odx + 5] = clamp((298 * c - 100 * d - 208 * e + 128) >> 8);
         dst[odx + 6] = clamp((298 * c + 516 * d + 128) >> 8);
         dst[odx + 7] = 255;
 
@@ -209,14 +212,14 @@ __global__ void kernel_unpack_yuy2_bgra8_cuda(const uint8_t * src, uint8_t *dst,
 
         dst[odx + 3] = 255;
         dst[odx + 2] = clamp((298 * c + 409 * e + 128) >> 8);
-        dst[odx + 1] = clamp((298 * c - 100 * d - 409 * e + 128) >> 8);
+        dst[odx + 1] = clamp((298 * c - 100 * d - 208 * e + 128) >> 8);
         dst[odx] = clamp((298 * c + 516 * d + 128) >> 8);
 
         c = y1 - 16;
 
         dst[odx + 7] = 255;
         dst[odx + 6] = clamp((298 * c + 409 * e + 128) >> 8);
-        dst[odx + 5] = clamp((298 * c - 100 * d - 409 * e + 128) >> 8);
+        dst[odx + 5] = clamp((298 * c - 100 * d - 208 * e + 128) >> 8);
         dst[odx + 4] = clamp((298 * c + 516 * d + 128) >> 8);
 
 #undef clamp
@@ -226,72 +229,37 @@ __global__ void kernel_unpack_yuy2_bgra8_cuda(const uint8_t * src, uint8_t *dst,
 
 void rscuda::unpack_yuy2_cuda_helper(const uint8_t* h_src, uint8_t* h_dst, int n, rs2_format format)
 {
-    /*    cudaEvent_t start, stop;
-        cudaEventCreate(&start);
-        cudaEventCreate(&stop);
-        cudaEventRecord(start); */
-
-        // How many super pixels do we have?
+    // How many super pixels do we have?
     int superPix = n / 2;
-    std::shared_ptr<uint8_t> d_dst;
-    std::shared_ptr<uint8_t> d_src = alloc_dev<uint8_t>(superPix * 4);
-
-    auto result = cudaMemcpy(d_src.get(), h_src, superPix * sizeof(uint8_t) * 4, cudaMemcpyHostToDevice);
-    assert(result == cudaSuccess);
-
-    int numBlocks = superPix / RS2_CUDA_THREADS_PER_BLOCK;
     int size;
 
     switch (format)
     {
         // conversion to Y8 is currently not available in the API
-        /*	case RS2_FORMAT_Y8:
-            size = 1;
-             d_dst = alloc_dev<uint8_t>(n * size);
-            kernel_unpack_yuy2_y8_cuda<<<numBlocks, RS2_CUDA_THREADS_PER_BLOCK>>>(devSrc, devDst, superPix);
-            break;
-        */
-    case RS2_FORMAT_Y16:
-        size = 2;
-        d_dst = alloc_dev<uint8_t>(n * size);
-        kernel_unpack_yuy2_y16_cuda << <numBlocks, RS2_CUDA_THREADS_PER_BLOCK >> > (d_src.get(), d_dst.get(), superPix);
-        break;
+    case RS2_FORMAT_Y16: size = 2; break;
     case RS2_FORMAT_RGB8:
-        size = 3;
-        d_dst = alloc_dev<uint8_t>(n * size);
-        kernel_unpack_yuy2_rgb8_cuda << <numBlocks, RS2_CUDA_THREADS_PER_BLOCK >> > (d_src.get(), d_dst.get(), superPix);
-        break;
-    case RS2_FORMAT_BGR8:
-        size = 3;
-        d_dst = alloc_dev<uint8_t>(n * size);
-        kernel_unpack_yuy2_bgr8_cuda << <numBlocks, RS2_CUDA_THREADS_PER_BLOCK >> > (d_src.get(), d_dst.get(), superPix);
-        break;
+    case RS2_FORMAT_BGR8: size = 3; break;
     case RS2_FORMAT_RGBA8:
-        size = 4;
-        d_dst = alloc_dev<uint8_t>(n * size);
-        kernel_unpack_yuy2_rgba8_cuda << <numBlocks, RS2_CUDA_THREADS_PER_BLOCK >> > (d_src.get(), d_dst.get(), superPix);
-        break;
-    case RS2_FORMAT_BGRA8:
-        size = 4;
-        d_dst = alloc_dev<uint8_t>(n * size);
-        kernel_unpack_yuy2_bgra8_cuda << <numBlocks, RS2_CUDA_THREADS_PER_BLOCK >> > (d_src.get(), d_dst.get(), superPix);
-        break;
+    case RS2_FORMAT_BGRA8: size = 4; break;
     default:
         assert(false);
+        return;
     }
-    result = cudaGetLastError();
-    assert(result == cudaSuccess);
 
-    cudaDeviceSynchronize();
-
-    result = cudaMemcpy(h_dst, d_dst.get(), n * sizeof(uint8_t) * size, cudaMemcpyDeviceToHost);
-    assert(result == cudaSuccess);
-
-    /*	cudaEventRecord(stop);
-        cudaEventSynchronize(stop);
-        float milliseconds = 0;
-        cudaEventElapsedTime(&milliseconds, start, stop);
-        std::cout << milliseconds << "\n"; */
+    staged_output output = { h_dst, 2 * size };
+    run_staged(h_src, 4, &output, 1, superPix, [format](const uint8_t* d_src, uint8_t* const d_dst[], int, int count, cudaStream_t stream)
+    {
+        switch (format)
+        {
+        case RS2_FORMAT_Y16: kernel_unpack_yuy2_y16_cuda <<<blocks_for(count), RS2_CUDA_THREADS_PER_BLOCK, 0, stream>>> (d_src, d_dst[0], count); break;
+        case RS2_FORMAT_RGB8: kernel_unpack_yuy2_rgb8_cuda <<<blocks_for(count), RS2_CUDA_THREADS_PER_BLOCK, 0, stream>>> (d_src, d_dst[0], count); break;
+        case RS2_FORMAT_BGR8: kernel_unpack_yuy2_bgr8_cuda <<<blocks_for(count), RS2_CUDA_THREADS_PER_BLOCK, 0, stream>>> (d_src, d_dst[0], count); break;
+        case RS2_FORMAT_RGBA8: kernel_unpack_yuy2_rgba8_cuda <<<blocks_for(count), RS2_CUDA_THREADS_PER_BLOCK, 0, stream>>> (d_src, d_dst[0], count); break;
+        case RS2_FORMAT_BGRA8: kernel_unpack_yuy2_bgra8_cuda <<<blocks_for(count), RS2_CUDA_THREADS_PER_BLOCK, 0, stream>>> (d_src, d_dst[0], count); break;
+        default: break;
+        }
+    });
+    assert(cudaGetLastError() == cudaSuccess);
 }
 
 
@@ -308,38 +276,13 @@ __global__ void kernel_split_frame_y8_y8_from_y8i_cuda(uint8_t* a, uint8_t* b, i
 
 void rscuda::y8_y8_from_y8i_cuda_helper(uint8_t* const dest[], int count, const rscuda::y8i_pixel * source)
 {
-    /*    cudaEvent_t start, stop;
-        cudaEventCreate(&start);
-        cudaEventCreate(&stop);
-        cudaEventRecord(start); */
-
-    int numBlocks = count / RS2_CUDA_THREADS_PER_BLOCK;
-    uint8_t* a = dest[0];
-    uint8_t* b = dest[1];
-
-    auto d_src = alloc_dev<rscuda::y8i_pixel>(count);
-    auto d_dst_0 = alloc_dev<uint8_t>(count);
-    auto d_dst_1 = alloc_dev<uint8_t>(count);
-
-    auto result = cudaMemcpy(d_src.get(), source, count * sizeof(rscuda::y8i_pixel), cudaMemcpyHostToDevice);
-    assert(result == cudaSuccess);
-
-    kernel_split_frame_y8_y8_from_y8i_cuda << <numBlocks, RS2_CUDA_THREADS_PER_BLOCK >> > (d_dst_0.get(), d_dst_1.get(), count, d_src.get());
-    cudaDeviceSynchronize();
-
-    result = cudaGetLastError();
-    assert(result == cudaSuccess);
-
-    result = cudaMemcpy(a, d_dst_0.get(), count * sizeof(uint8_t), cudaMemcpyDeviceToHost);
-    assert(result == cudaSuccess);
-    result = cudaMemcpy(b, d_dst_1.get(), count * sizeof(uint8_t), cudaMemcpyDeviceToHost);
-    assert(result == cudaSuccess);
-
-    /*    cudaEventRecord(stop);
-        cudaEventSynchronize(stop);
-        float milliseconds = 0;
-        cudaEventElapsedTime(&milliseconds, start, stop);
-        std::cout << milliseconds << std::endl; */
+    staged_output outputs[] = { { dest[0], 1 }, { dest[1], 1 } };
+    run_staged(source, sizeof(rscuda::y8i_pixel), outputs, 2, count, [](const uint8_t* d_src, uint8_t* const d_dst[], int, int n, cudaStream_t stream)
+    {
+        kernel_split_frame_y8_y8_from_y8i_cuda <<<blocks_for(n), RS2_CUDA_THREADS_PER_BLOCK, 0, stream>>> (d_dst[0], d_dst[1], n,
+            reinterpret_cast<const rscuda::y8i_pixel*>(d_src));
+    });
+    assert(cudaGetLastError() == cudaSuccess);
 }
 
 __global__ void kernel_split_frame_y16_y16_from_y12i_cuda(uint16_t* a, uint16_t* b, int count, const rscuda::y12i_pixel * source)
@@ -356,44 +299,13 @@ __global__ void kernel_split_frame_y16_y16_from_y12i_cuda(uint16_t* a, uint16_t*
 
 void rscuda::y16_y16_from_y12i_10_cuda_helper(uint8_t* const dest[], int count, const rscuda::y12i_pixel * source)
 {
-    /*
-        cudaEvent_t start, stop;
-        cudaEventCreate(&start);
-        cudaEventCreate(&stop);
-        cudaEventRecord(start); */
-
-    source = reinterpret_cast<const y12i_pixel*>(source);
-
-    int numBlocks = count / RS2_CUDA_THREADS_PER_BLOCK;
-    uint16_t* a = reinterpret_cast<uint16_t*>(dest[0]);
-    uint16_t* b = reinterpret_cast<uint16_t*>(dest[1]);
-
-    auto d_src = alloc_dev<rscuda::y12i_pixel>(count);
-    auto d_dst_0 = alloc_dev<uint16_t>(count);
-    auto d_dst_1 = alloc_dev<uint16_t>(count);
-
-
-    auto result = cudaMemcpy(d_src.get(), source, count * sizeof(rscuda::y12i_pixel), cudaMemcpyHostToDevice);
-    assert(result == cudaSuccess);
-
-    kernel_split_frame_y16_y16_from_y12i_cuda <<<numBlocks, RS2_CUDA_THREADS_PER_BLOCK>>> (d_dst_0.get(), d_dst_1.get(), count, d_src.get());
-    cudaDeviceSynchronize();
-
-    result = cudaGetLastError();
-    assert(result == cudaSuccess);
-
-    result = cudaMemcpy(a, d_dst_0.get(), count * sizeof(uint16_t), cudaMemcpyDeviceToHost);
-    assert(result == cudaSuccess);
-    result = cudaMemcpy(b, d_dst_1.get(), count * sizeof(uint16_t), cudaMemcpyDeviceToHost);
-    assert(result == cudaSuccess);
-
-    /*
-    cudaEventRecord(stop);
-    cudaEventSynchronize(stop);
-    float milliseconds = 0;
-    cudaEventElapsedTime(&milliseconds, start, stop);
-    std::cout << milliseconds << std::endl;
-    */
+    staged_output outputs[] = { { dest[0], sizeof(uint16_t) }, { dest[1], sizeof(uint16_t) } };
+    run_staged(source, sizeof(rscuda::y12i_pixel), outputs, 2, count, [](const uint8_t* d_src, uint8_t* const d_dst[], int, int n, cudaStream_t stream)
+    {
+        kernel_split_frame_y16_y16_from_y12i_cuda <<<blocks_for(n), RS2_CUDA_THREADS_PER_BLOCK, 0, stream>>> (
+            reinterpret_cast<uint16_t*>(d_dst[0]), reinterpret_cast<uint16_t*>(d_dst[1]), n, reinterpret_cast<const rscuda::y12i_pixel*>(d_src));
+    });
+    assert(cudaGetLastError() == cudaSuccess);
 }
 
 
@@ -409,33 +321,14 @@ __global__ void kernel_z16_y8_from_sr300_inzi_cuda(const uint16_t* source, uint8
 
 void rscuda::unpack_z16_y8_from_sr300_inzi_cuda(uint8_t * const dest, const uint16_t * source, int count)
 {
-    /*  cudaEvent_t start, stop;
-        cudaEventCreate(&start);
-        cudaEventCreate(&stop);
-        cudaEventRecord(start); */
-
-    auto d_src = alloc_dev<uint16_t>(count);
-    auto d_dst = alloc_dev<uint8_t>(count);
-
-    int numBlocks = count / RS2_CUDA_THREADS_PER_BLOCK;
-
-    auto result = cudaMemcpy(d_src.get(), source, count * sizeof(uint16_t), cudaMemcpyHostToDevice);
-    assert(result == cudaSuccess);
-
-    kernel_z16_y8_from_sr300_inzi_cuda <<<numBlocks, RS2_CUDA_THREADS_PER_BLOCK >>> (d_src.get(), d_dst.get(), count);
-    cudaDeviceSynchronize();
-
-    result = cudaMemcpy(dest, d_dst.get(), count * sizeof(uint8_t), cudaMemcpyDeviceToHost);
-    assert(result == cudaSuccess);
-
-    /*  cudaEventRecord(stop);
-        cudaEventSynchronize(stop);
-        float milliseconds = 0;
-        cudaEventElapsedTime(&milliseconds, start, stop);
-        std::cout << milliseconds << std::endl; */
+    staged_output output = { dest, sizeof(uint8_t) };
+    run_staged(source, sizeof(uint16_t), &output, 1, count, [](const uint8_t* d_src, uint8_t* const d_dst[], int, int n, cudaStream_t stream)
+    {
+        kernel_z16_y8_from_sr300_inzi_cuda <<<blocks_for(n), RS2_CUDA_THREADS_PER_BLOCK, 0, stream>>> (reinterpret_cast<const uint16_t*>(d_src), d_dst[0], n);
+    });
 }
 
-__global__ void kernel_z16_y16_from_sr300_inzi_cuda(uint16_t* const source, uint16_t* const dest, int count)
+__global__ void kernel_z16_y16_from_sr300_inzi_cuda(const uint16_t* source, uint16_t* const dest, int count)
 {
     int i = blockDim.x * blockIdx.x + threadIdx.x;
 
@@ -447,30 +340,12 @@ __global__ void kernel_z16_y16_from_sr300_inzi_cuda(uint16_t* const source, uint
 
 void rscuda::unpack_z16_y16_from_sr300_inzi_cuda(uint16_t * const dest, const uint16_t * source, int count)
 {
-    /*  cudaEvent_t start, stop;
-        cudaEventCreate(&start);
-        cudaEventCreate(&stop);
-        cudaEventRecord(start); */
-
-    auto d_src = alloc_dev<uint16_t>(count);
-    auto d_dst = alloc_dev<uint16_t>(count);
-
-    int numBlocks = count / RS2_CUDA_THREADS_PER_BLOCK;
-
-    auto result = cudaMemcpy(d_src.get(), source, count * sizeof(uint16_t), cudaMemcpyHostToDevice);
-    assert(result == cudaSuccess);
-
-    kernel_z16_y16_from_sr300_inzi_cuda << <numBlocks, RS2_CUDA_THREADS_PER_BLOCK >> > (d_src.get(), d_dst.get(), count);
-    cudaDeviceSynchronize();
-
-    result = cudaMemcpy(dest, d_dst.get(), count * sizeof(uint16_t), cudaMemcpyDeviceToHost);
-    assert(result == cudaSuccess);
-
-    /*	cudaEventRecord(stop);
-        cudaEventSynchronize(stop);
-        float milliseconds = 0;
-        cudaEventElapsedTime(&milliseconds, start, stop);
-        std::cout << milliseconds << std::endl; */
+    staged_output output = { reinterpret_cast<uint8_t*>(dest), sizeof(uint16_t) };
+    run_staged(source, sizeof(uint16_t), &output, 1, count, [](const uint8_t* d_src, uint8_t* const d_dst[], int, int n, cudaStream_t stream)
+    {
+        kernel_z16_y16_from_sr300_inzi_cuda <<<blocks_for(n), RS2_CUDA_THREADS_PER_BLOCK, 0, stream>>> (
+            reinterpret_cast<const uint16_t*>(d_src), reinterpret_cast<uint16_t*>(d_dst[0]), n);
+    });
 }
 
 #endif
@@ -0,0 +1,74 @@
+#ifdef RS2_USE_CUDA
+
+#include "cuda-device-memory.cuh"
+
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+
+// CUDA headers
+#include <cuda_runtime.h>
+
+#ifdef _MSC_VER
+// Add library dependencies if using VS
+#pragma comment(lib, "cudart_static")
+#endif
+
+namespace rscuda
+{
+    namespace
+    {
+        // Enough to cover the frames of a few streams in flight through a processing chain
+        const size_t max_pooled_buffers = 32;
+
+        std::mutex pool_mutex;
+        std::multimap<size_t, void*> pool;
+    }
+
+    cuda_device_memory::~cuda_device_memory()
+    {
+        {
+            std::lock_guard<std::mutex> lock(pool_mutex);
+            if (pool.size() < max_pooled_buffers)
+            {
+                pool.emplace(_size, _ptr);
+                return;
+            }
+        }
+        cudaFree(_ptr);
+    }
+
+    void cuda_device_memory::download(void* host) const
+    {
+        // Synchronizes with the kernels that wrote the buffer
+        cudaMemcpy(host, _ptr, _size, cudaMemcpyDeviceToHost);
+    }
+
+    void cuda_device_memory::upload(const void* host)
+    {
+        cudaMemcpy(_ptr, host, _size, cudaMemcpyHostToDevice);
+    }
+
+    std::shared_ptr<cuda_device_memory> alloc_device_memory(size_t size)
+    {
+        void* ptr = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(pool_mutex);
+            auto it = pool.find(size);
+            if (it != pool.end())
+            {
+                ptr = it->second;
+                pool.erase(it);
+            }
+        }
+        if (!ptr)
+        {
+            auto res = cudaMalloc(&ptr, size);
+            if (res != cudaSuccess)
+                throw std::runtime_error("cudaMalloc failed status: " + std::to_string(res));
+        }
+        return std::make_shared<cuda_device_memory>(ptr, size);
+    }
+}
+#endif // RS2_USE_CUDA
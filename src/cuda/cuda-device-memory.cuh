@@ -0,0 +1,30 @@
+#pragma once
+#ifdef RS2_USE_CUDA
+
+#include "../core/device-memory.h"
+#include <memory>
+
+namespace rscuda
+{
+    // Device buffer attached to frames by the CUDA processing blocks
+    class cuda_device_memory : public librealsense::device_memory
+    {
+    public:
+        cuda_device_memory(void* ptr, size_t size) : _ptr(ptr), _size(size) {}
+        ~cuda_device_memory();
+
+        void* get() const override { return _ptr; }
+        size_t size() const override { return _size; }
+        void download(void* host) const override;
+        void upload(const void* host);
+
+    private:
+        void* _ptr;
+        size_t _size;
+    };
+
+    // Buffers are recycled by size, since cudaMalloc and cudaFree synchronize the device
+    // and each frame of a stream needs a new one
+    std::shared_ptr<cuda_device_memory> alloc_device_memory(size_t size);
+}
+#endif // RS2_USE_CUDA
@@ -0,0 +1,82 @@
+#ifdef RS2_USE_CUDA
+
+#include "cuda-mapped-allocator.cuh"
+
+// CUDA headers
+#include <cuda_runtime.h>
+
+#ifdef _MSC_VER
+// Add library dependencies if using VS
+#pragma comment(lib, "cudart_static")
+#endif
+
+namespace rscuda
+{
+    cuda_mapped_frame_allocator::~cuda_mapped_frame_allocator()
+    {
+        for (auto&& buffers : _free)
+            for (auto buffer : buffers.second)
+                cudaFreeHost(buffer);
+    }
+
+    void* cuda_mapped_frame_allocator::allocate(size_t size)
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            auto it = _free.find(size);
+            if (it != _free.end() && !it->second.empty())
+            {
+                auto buffer = it->second.back();
+                it->second.pop_back();
+                return buffer;
+            }
+        }
+
+        // A null buffer has the sensor fall back to its own
+        void* buffer = nullptr;
+        if (cudaHostAlloc(&buffer, size, cudaHostAllocMapped) != cudaSuccess)
+            return nullptr;
+        return buffer;
+    }
+
+    void cuda_mapped_frame_allocator::deallocate(void* buffer, size_t size)
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            auto& buffers = _free[size];
+            if (buffers.size() < max_free_buffers)
+            {
+                buffers.push_back(buffer);
+                return;
+            }
+        }
+        cudaFreeHost(buffer);
+    }
+
+    bool is_integrated_gpu()
+    {
+        static const bool integrated = []()
+        {
+            int device = 0, value = 0;
+            if (cudaGetDevice(&device) != cudaSuccess)
+                return false;
+            return cudaDeviceGetAttribute(&value, cudaDevAttrIntegrated, device) == cudaSuccess && value != 0;
+        }();
+        return integrated;
+    }
+
+    const void* get_mapped_device_pointer(const void* host)
+    {
+        cudaPointerAttributes attributes;
+        if (cudaPointerGetAttributes(&attributes, host) != cudaSuccess)
+        {
+            // Older runtimes fail on pageable memory, which leaves an error behind for the next call to report
+            cudaGetLastError();
+            return nullptr;
+        }
+        if (attributes.type != cudaMemoryTypeHost)
+            return nullptr;
+        return attributes.devicePointer;
+    }
+}
+#endif // RS2_USE_CUDA
@@ -0,0 +1,37 @@
+#pragma once
+#ifdef RS2_USE_CUDA
+
+#include "../../include/librealsense2/hpp/rs_types.hpp"
+
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace rscuda
+{
+    // Frame buffers in page-locked host memory mapped into the address space of the GPU. On an integrated GPU,
+    // which shares the memory with the CPU, the CUDA blocks read the frames in place instead of copying them.
+    // Page-locked buffers are slow to allocate, so they are recycled by size
+    class cuda_mapped_frame_allocator : public rs2_frame_allocator
+    {
+    public:
+        ~cuda_mapped_frame_allocator();
+
+        void* allocate(size_t size) override;
+        void deallocate(void* buffer, size_t size) override;
+        void release() override { delete this; }
+
+    private:
+        static const size_t max_free_buffers = 16;
+
+        std::mutex _mutex;
+        std::unordered_map<size_t, std::vector<void*>> _free;
+    };
+
+    // Whether the GPU shares the memory of the CPU, like the Jetson modules
+    bool is_integrated_gpu();
+
+    // Device address of host memory mapped into the GPU, null when the memory isn't mapped
+    const void* get_mapped_device_pointer(const void* host);
+}
+#endif // RS2_USE_CUDA
@@ -1,6 +1,7 @@
 #ifdef RS2_USE_CUDA
 
 #include "cuda-pointcloud.cuh"
+#include "cuda-staging.cuh"
 #include <iostream>
 #include <chrono>
 
@@ -33,58 +34,43 @@ void deproject_pixel_to_point_cuda(float points[3], const struct rs2_intrinsics
 }
 
 
+// One thread per pixel of the chunk starting at 'first'; the intrinsics are passed by value, so the launch needs no device copy of them
 __global__
-//void kernel_deproject_depth_cuda(float * points, const rs2_intrinsics & intrin, const uint16_t * depth, std::function<uint16_t(float)> map_depth)
-
-void kernel_deproject_depth_cuda(float * points, const rs2_intrinsics* intrin, const uint16_t * depth, float depth_scale)
+void kernel_deproject_depth_cuda(float * points, const rs2_intrinsics intrin, const uint16_t * depth, float depth_scale, int first, int count)
 {
     int i = blockDim.x * blockIdx.x + threadIdx.x;
-    
-    if (i >= (*intrin).height * (*intrin).width) {
+    if (i >= count)
         return;
-    }
-    int stride = blockDim.x * gridDim.x;
-    int a, b;
-    
-    for (int j = i; j < (*intrin).height * (*intrin).width; j += stride) {
-        b = j / (*intrin).width;
-        a = j - b * (*intrin).width;
-        const float pixel[] = { (float)a, (float)b };
-        deproject_pixel_to_point_cuda(points + j * 3, intrin, pixel, depth_scale * depth[j]);               
-   }
+
+    int j = first + i;
+    int b = j / intrin.width;
+    int a = j - b * intrin.width;
+    const float pixel[] = { (float)a, (float)b };
+    deproject_pixel_to_point_cuda(points + i * 3, &intrin, pixel, depth_scale * depth[i]);
 }
 
+static int blocks_for(int count) { return (count + RS2_CUDA_THREADS_PER_BLOCK - 1) / RS2_CUDA_THREADS_PER_BLOCK; }
 
 void rscuda::deproject_depth_cuda(float * points, const rs2_intrinsics & intrin, const uint16_t * depth, float depth_scale)
 {
-    int count = intrin.height * intrin.width;
-    int numBlocks = count / RS2_CUDA_THREADS_PER_BLOCK;
-    
-    float *dev_points = 0;	
-    uint16_t *dev_depth = 0;
-    rs2_intrinsics* dev_intrin = 0;
-    cudaError_t result;
-
-    result = cudaMalloc(&dev_points, count * sizeof(float) * 3);
-    assert(result == cudaSuccess);
-    result = cudaMalloc(&dev_depth, count * sizeof(uint16_t));
-    assert(result == cudaSuccess);
-    result = cudaMalloc(&dev_intrin, sizeof(rs2_intrinsics));
-    assert(result == cudaSuccess);
-       
-    result = cudaMemcpy(dev_depth, depth, count * sizeof(uint16_t), cudaMemcpyHostToDevice);
-    assert(result == cudaSuccess); 
-    result = cudaMemcpy(dev_intrin, &intrin, sizeof(rs2_intrinsics), cudaMemcpyHostToDevice);
-    assert(result == cudaSuccess); 
-     
-    kernel_deproject_depth_cuda<<<numBlocks, RS2_CUDA_THREADS_PER_BLOCK>>>(dev_points, dev_intrin, dev_depth, depth_scale); 
-
-     result = cudaMemcpy(points, dev_points, count * sizeof(float) * 3, cudaMemcpyDeviceToHost);
-     assert(result == cudaSuccess);
+    staged_output output = { reinterpret_cast<uint8_t*>(points), sizeof(float) * 3 };
+    run_staged(depth, sizeof(uint16_t), &output, 1, intrin.width * intrin.height,
+        [&intrin, depth_scale](const uint8_t* d_src, uint8_t* const d_dst[], int first, int count, cudaStream_t stream)
+    {
+        kernel_deproject_depth_cuda<<<blocks_for(count), RS2_CUDA_THREADS_PER_BLOCK, 0, stream>>>(reinterpret_cast<float*>(d_dst[0]), intrin,
+            reinterpret_cast<const uint16_t*>(d_src), depth_scale, first, count);
+    });
+}
 
-    cudaFree(dev_points);
-    cudaFree(dev_depth);
-    cudaFree(dev_intrin);
+void rscuda::deproject_device_depth_cuda(float * points, const rs2_intrinsics & intrin, const uint16_t * dev_depth, float depth_scale)
+{
+    staged_output output = { reinterpret_cast<uint8_t*>(points), sizeof(float) * 3 };
+    run_staged(nullptr, 0, &output, 1, intrin.width * intrin.height,
+        [&intrin, dev_depth, depth_scale](const uint8_t*, uint8_t* const d_dst[], int first, int count, cudaStream_t stream)
+    {
+        kernel_deproject_depth_cuda<<<blocks_for(count), RS2_CUDA_THREADS_PER_BLOCK, 0, stream>>>(reinterpret_cast<float*>(d_dst[0]), intrin,
+            dev_depth + first, depth_scale, first, count);
+    });
 }
 
 #endif
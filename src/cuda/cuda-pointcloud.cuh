@@ -24,6 +24,8 @@
 namespace rscuda
 {
     void deproject_depth_cuda(float * points, const rs2_intrinsics & intrin, const uint16_t * depth, float depth_scale);
+    // Same, for depth already in device memory
+    void deproject_device_depth_cuda(float * points, const rs2_intrinsics & intrin, const uint16_t * dev_depth, float depth_scale);
 
 }
 
@@ -0,0 +1,142 @@
+#ifdef RS2_USE_CUDA
+
+#include "cuda-staging.cuh"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#ifdef _MSC_VER
+// Add library dependencies if using VS
+#pragma comment(lib, "cudart_static")
+#endif
+
+namespace rscuda
+{
+    namespace
+    {
+        // Below this a chunk costs more in launch and copy overhead than it gains in overlap
+        const int min_chunk_elements = 64 * 1024;
+    }
+
+    cuda_staging& cuda_staging::for_this_thread()
+    {
+        static thread_local cuda_staging instance;
+        return instance;
+    }
+
+    cuda_staging::cuda_staging()
+    {
+        // Blocking streams, so that they order with the default stream used by the device-resident blocks
+        for (auto& s : _streams)
+            cudaStreamCreate(&s);
+        for (auto& e : _events)
+            cudaEventCreateWithFlags(&e, cudaEventDisableTiming);
+    }
+
+    cuda_staging::~cuda_staging()
+    {
+        for (auto& b : _device)
+            cudaFree(b.ptr);
+        for (auto& b : _pinned)
+            cudaFreeHost(b.ptr);
+        for (auto& e : _events)
+            cudaEventDestroy(e);
+        for (auto& s : _streams)
+            cudaStreamDestroy(s);
+    }
+
+    uint8_t* cuda_staging::device(int slot, size_t size)
+    {
+        auto& b = _device[slot];
+        if (b.size < size)
+        {
+            cudaFree(b.ptr);
+            b = buffer();
+            auto res = cudaMalloc(&b.ptr, size);
+            if (res != cudaSuccess)
+                throw std::runtime_error("cudaMalloc failed status: " + std::to_string(res));
+            b.size = size;
+        }
+        return b.ptr;
+    }
+
+    uint8_t* cuda_staging::pinned(int slot, size_t size)
+    {
+        auto& b = _pinned[slot];
+        if (b.size < size)
+        {
+            cudaFreeHost(b.ptr);
+            b = buffer();
+            auto res = cudaMallocHost(&b.ptr, size);
+            if (res != cudaSuccess)
+                throw std::runtime_error("cudaMallocHost failed status: " + std::to_string(res));
+            b.size = size;
+        }
+        return b.ptr;
+    }
+
+    void run_staged(const void* h_src, int src_element_size, const staged_output* outputs, int output_count, int count, const staged_kernel& kernel)
+    {
+        if (count <= 0)
+            return;
+        if (output_count > cuda_staging::max_outputs)
+            throw std::runtime_error("run_staged supports up to two outputs");
+
+        auto& staging = cuda_staging::for_this_thread();
+        auto src = static_cast<const uint8_t*>(h_src);
+
+        uint8_t* p_src = src ? staging.pinned(0, size_t(count) * src_element_size) : nullptr;
+        uint8_t* d_src = src ? staging.device(0, size_t(count) * src_element_size) : nullptr;
+        uint8_t* p_dst[cuda_staging::max_outputs] = {};
+        uint8_t* d_dst[cuda_staging::max_outputs] = {};
+        for (int k = 0; k < output_count; ++k)
+        {
+            p_dst[k] = staging.pinned(1 + k, size_t(count) * outputs[k].element_size);
+            d_dst[k] = staging.device(1 + k, size_t(count) * outputs[k].element_size);
+        }
+
+        const int chunks = std::max(1, std::min(cuda_staging::max_chunks, count / min_chunk_elements));
+        auto chunk_begin = [&](int c) { return int(int64_t(count) * c / chunks); };
+
+        // Staging a chunk into page-locked memory overlaps the transfers and kernels already queued
+        for (int c = 0; c < chunks; ++c)
+        {
+            auto first = chunk_begin(c), n = chunk_begin(c + 1) - first;
+            auto stream = staging.stream(c);
+            size_t src_offset = size_t(first) * src_element_size, src_size = size_t(n) * src_element_size;
+
+            if (src)
+            {
+                memcpy(p_src + src_offset, src + src_offset, src_size);
+                cudaMemcpyAsync(d_src + src_offset, p_src + src_offset, src_size, cudaMemcpyHostToDevice, stream);
+            }
+
+            uint8_t* chunk_dst[cuda_staging::max_outputs] = {};
+            for (int k = 0; k < output_count; ++k)
+                chunk_dst[k] = d_dst[k] + size_t(first) * outputs[k].element_size;
+            kernel(src ? d_src + src_offset : nullptr, chunk_dst, first, n, stream);
+
+            for (int k = 0; k < output_count; ++k)
+            {
+                size_t offset = size_t(first) * outputs[k].element_size;
+                cudaMemcpyAsync(p_dst[k] + offset, d_dst[k] + offset, size_t(n) * outputs[k].element_size, cudaMemcpyDeviceToHost, stream);
+            }
+            cudaEventRecord(staging.chunk_done(c), stream);
+        }
+
+        // Copy the results out in order, while the later chunks are still on the device
+        for (int c = 0; c < chunks; ++c)
+        {
+            auto first = chunk_begin(c), n = chunk_begin(c + 1) - first;
+            cudaEventSynchronize(staging.chunk_done(c));
+            for (int k = 0; k < output_count; ++k)
+            {
+                size_t offset = size_t(first) * outputs[k].element_size;
+                memcpy(outputs[k].host + offset, p_dst[k] + offset, size_t(n) * outputs[k].element_size);
+            }
+        }
+    }
+}
+#endif // RS2_USE_CUDA
@@ -0,0 +1,60 @@
+#pragma once
+#ifdef RS2_USE_CUDA
+
+#include <stdint.h>
+#include <stddef.h>
+#include <functional>
+
+// CUDA headers
+#include <cuda_runtime.h>
+
+namespace rscuda
+{
+    // Device buffers, page-locked host buffers and streams reused by the host-to-host CUDA helpers.
+    // There is one set per thread: each sensor unpacks its frames on its own dispatcher thread,
+    // so the buffers of a stream are allocated once and the sensors do not share a queue.
+    class cuda_staging
+    {
+    public:
+        static const int stream_count = 3;     // Upload, kernel and download of consecutive chunks run concurrently
+        static const int max_chunks = 8;
+        static const int max_outputs = 2;
+
+        static cuda_staging& for_this_thread();
+
+        cuda_staging(const cuda_staging&) = delete;
+        cuda_staging& operator=(const cuda_staging&) = delete;
+        ~cuda_staging();
+
+        cudaStream_t stream(int index) const { return _streams[index % stream_count]; }
+        cudaEvent_t chunk_done(int chunk) const { return _events[chunk]; }
+
+        // Grow-only buffers, slot 0 holds the input and the following slots the outputs
+        uint8_t* device(int slot, size_t size);
+        uint8_t* pinned(int slot, size_t size);
+
+    private:
+        cuda_staging();
+
+        struct buffer { uint8_t* ptr = nullptr; size_t size = 0; };
+
+        cudaStream_t _streams[stream_count];
+        cudaEvent_t _events[max_chunks];
+        buffer _device[1 + max_outputs];
+        buffer _pinned[1 + max_outputs];
+    };
+
+    struct staged_output
+    {
+        uint8_t* host;
+        int element_size;
+    };
+
+    // Launches the kernel of a chunk: pointers to the chunk in device memory, the index of its first element, its size and the stream to run on
+    typedef std::function<void(const uint8_t* d_src, uint8_t* const d_dst[], int first, int count, cudaStream_t stream)> staged_kernel;
+
+    // Runs a per-element kernel over host data in chunks, so that copying one chunk overlaps computing the others.
+    // h_src may be null when the kernel reads its input from device memory, d_src is then null too
+    void run_staged(const void* h_src, int src_element_size, const staged_output* outputs, int output_count, int count, const staged_kernel& kernel);
+}
+#endif // RS2_USE_CUDA
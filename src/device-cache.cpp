@@ -0,0 +1,178 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#include "device-cache.h"
+#include "types.h"
+#include "../third-party/json.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+
+namespace librealsense
+{
+    // Bumped whenever the layout of the file changes, older files are then ignored
+    static const int cache_format = 1;
+
+    device_cache_entry::device_cache_entry(std::string path, uint32_t validation)
+        : _path(std::move(path)), _validation(validation)
+    {
+        try
+        {
+            load();
+        }
+        catch (const std::exception& e)
+        {
+            LOG_WARNING("Ignoring device cache " << _path << ": " << e.what());
+            _tables.clear();
+            _profiles.clear();
+        }
+    }
+
+    void device_cache_entry::load()
+    {
+        std::ifstream in(_path);
+        if (!in)
+            return;
+
+        nlohmann::json j;
+        in >> j;
+        if (j.value("format", 0) != cache_format || j.value("validation", 0u) != _validation)
+        {
+            LOG_INFO("Device cache " << _path << " is out of date");
+            return;
+        }
+
+        auto&& tables = j["tables"];
+        for (auto it = tables.begin(); it != tables.end(); ++it)
+            _tables[std::stoi(it.key())] = it.value().get<std::vector<uint8_t>>();
+
+        auto&& sensors = j["profiles"];
+        for (auto it = sensors.begin(); it != sensors.end(); ++it)
+        {
+            auto& profiles = _profiles[it.key()];
+            for (auto&& p : it.value())
+                profiles.push_back({ p.at(0).get<uint32_t>(), p.at(1).get<uint32_t>(), p.at(2).get<uint32_t>(), p.at(3).get<uint32_t>() });
+        }
+    }
+
+    void device_cache_entry::save() const
+    {
+        nlohmann::json j;
+        j["format"] = cache_format;
+        j["validation"] = _validation;
+        j["tables"] = nlohmann::json::object();
+        for (auto&& table : _tables)
+            j["tables"][std::to_string(table.first)] = table.second;
+        j["profiles"] = nlohmann::json::object();
+        for (auto&& sensor : _profiles)
+        {
+            auto& profiles = j["profiles"][sensor.first] = nlohmann::json::array();
+            for (auto&& p : sensor.second)
+                profiles.push_back({ p.width, p.height, p.fps, p.format });
+        }
+
+        // Written aside and renamed over the entry, so another process never reads half a file
+        auto temp = _path + ".tmp";
+        {
+            std::ofstream out(temp, std::ios::trunc);
+            out << j.dump();
+            if (!out)
+            {
+                LOG_WARNING("Could not write device cache " << temp);
+                return;
+            }
+        }
+        std::remove(_path.c_str());
+        if (std::rename(temp.c_str(), _path.c_str()) != 0)
+            LOG_WARNING("Could not replace device cache " << _path);
+    }
+
+    std::vector<uint8_t> device_cache_entry::get_table(int id, const std::function<std::vector<uint8_t>()>& fetch,
+        const std::function<bool(const std::vector<uint8_t>&)>& valid)
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            auto it = _tables.find(id);
+            if (it != _tables.end())
+            {
+                if (!valid || valid(it->second))
+                    return it->second;
+                LOG_WARNING("Calibration table " << id << " of device cache " << _path << " is corrupted");
+            }
+        }
+
+        auto table = fetch();
+        std::lock_guard<std::mutex> lock(_mutex);
+        _tables[id] = table;
+        save();
+        return table;
+    }
+
+    void device_cache_entry::invalidate_tables()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_tables.empty())
+            return;
+        _tables.clear();
+        save();
+    }
+
+    std::vector<platform::stream_profile> device_cache_entry::get_profiles(const std::string& sensor,
+        const std::function<std::vector<platform::stream_profile>()>& fetch)
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            auto it = _profiles.find(sensor);
+            if (it != _profiles.end() && !it->second.empty())
+                return it->second;
+        }
+
+        auto profiles = fetch();
+        std::lock_guard<std::mutex> lock(_mutex);
+        _profiles[sensor] = profiles;
+        save();
+        return profiles;
+    }
+
+    device_cache& device_cache::instance()
+    {
+        static device_cache instance;
+        return instance;
+    }
+
+    device_cache::device_cache()
+    {
+        if (auto directory = getenv("LRS_DEVICE_CACHE"))
+            _directory = directory;
+    }
+
+    void device_cache::set_directory(std::string directory)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _directory = std::move(directory);
+    }
+
+    std::string device_cache::get_directory() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _directory;
+    }
+
+    std::shared_ptr<device_cache_entry> device_cache::open(const std::string& serial, const std::string& firmware,
+        const std::vector<uint8_t>& validation_data)
+    {
+        auto directory = get_directory();
+        if (directory.empty() || serial.empty())
+            return nullptr;
+
+        // Serials and versions are alphanumeric with dots, anything else is kept out of the file name
+        auto name = serial + "-" + firmware;
+        std::replace_if(name.begin(), name.end(), [](char c) { return !isalnum(static_cast<unsigned char>(c)) && c != '.' && c != '-'; }, '_');
+        auto path = directory + "/" + name + ".json";
+
+        auto validation = calc_crc32(validation_data.data(), validation_data.size());
+        return std::make_shared<device_cache_entry>(path, validation);
+    }
+}
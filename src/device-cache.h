@@ -0,0 +1,68 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "backend.h"
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace librealsense
+{
+    // What a device reported the last time it was opened, kept on disk so the next process doesn't query it again.
+    // An entry is specific to a serial and a firmware version, and is discarded when the validation data it was
+    // stored with no longer matches. Failures to read or write the cache only cost the queries it would have saved
+    class device_cache_entry
+    {
+    public:
+        device_cache_entry(std::string path, uint32_t validation);
+
+        // The calibration table from the cache, or from fetch, which is then stored. A cached table that isn't
+        // valid, such as one whose checksum doesn't match, is fetched again
+        std::vector<uint8_t> get_table(int id, const std::function<std::vector<uint8_t>()>& fetch,
+            const std::function<bool(const std::vector<uint8_t>&)>& valid = nullptr);
+
+        // Drops the calibration tables, once the device may have written new ones. They are fetched again when next read
+        void invalidate_tables();
+
+        // The native profiles of a sensor, by the name of the sensor
+        std::vector<platform::stream_profile> get_profiles(const std::string& sensor,
+            const std::function<std::vector<platform::stream_profile>()>& fetch);
+
+    private:
+        void load();
+        void save() const;
+
+        std::string _path;
+        uint32_t _validation;
+        std::mutex _mutex;
+        std::map<int, std::vector<uint8_t>> _tables;
+        std::map<std::string, std::vector<platform::stream_profile>> _profiles;
+    };
+
+    // Process-wide cache of the devices, off until given a directory, initially LRS_DEVICE_CACHE if it's set
+    class device_cache
+    {
+    public:
+        static device_cache& instance();
+
+        // An empty directory turns the cache off, the entries already open keep their file
+        void set_directory(std::string directory);
+        std::string get_directory() const;
+
+        // Null while the cache is off. The validation data is cheap to read from the device, such as its GVD
+        std::shared_ptr<device_cache_entry> open(const std::string& serial, const std::string& firmware,
+            const std::vector<uint8_t>& validation_data);
+
+    private:
+        device_cache();
+
+        mutable std::mutex _mutex;
+        std::string _directory;
+    };
+}
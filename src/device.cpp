@@ -109,6 +109,30 @@ std::shared_ptr<matcher> matcher_factory::create_timestamp_matcher(std::vector<s
     return create_timestamp_composite_matcher(matchers);
 }
 
+std::shared_ptr<matcher> matcher_factory::create_per_sensor_matcher(const std::vector<std::vector<stream_interface*>>& sensors)
+{
+    std::vector<std::shared_ptr<matcher>> matchers;
+    for (auto&& profiles : sensors)
+    {
+        auto has_depth = std::any_of(profiles.begin(), profiles.end(),
+            [](stream_interface* p) { return p->get_stream_type() == RS2_STREAM_DEPTH; });
+
+        std::vector<stream_interface*> video;
+        for (auto p : profiles)
+        {
+            if (has_depth && dynamic_cast<video_stream_profile_interface*>(p))
+                video.push_back(p);
+            else
+                matchers.push_back(create_identity_matcher(p));
+        }
+        if (video.size() > 1)
+            matchers.push_back(create_frame_number_matcher(video));
+        else if (video.size() == 1)
+            matchers.push_back(create_identity_matcher(video.front()));
+    }
+    return create_timestamp_composite_matcher(matchers);
+}
+
 std::shared_ptr<matcher> matcher_factory::create_identity_matcher(stream_interface *profile)
 {
     return std::make_shared<identity_matcher>(profile->get_unique_id(), profile->get_stream_type());
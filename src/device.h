@@ -25,6 +25,9 @@ namespace librealsense
     {
     public:
         static std::shared_ptr<matcher> create(rs2_matchers matcher, std::vector<stream_interface*> profiles);
+        // Matches the video streams of every sensor with a depth stream by frame number, as they share the frame
+        // counter of the sensor, and the sensors and the other streams by timestamp. Only for frames carrying the counter
+        static std::shared_ptr<matcher> create_per_sensor_matcher(const std::vector<std::vector<stream_interface*>>& sensors);
 
     private:
         static std::shared_ptr<matcher> create_DLR_C_matcher(std::vector<stream_interface*> profiles);
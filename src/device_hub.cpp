@@ -36,47 +36,163 @@ namespace librealsense
     {
         _device_list = filter_by_vid(_ctx->query_devices(mask), _vid);
 
-        auto cb = new hub_devices_changed_callback([&](rs2::event_information& info)
+        auto cb = new hub_devices_changed_callback([this, mask](rs2::event_information& info)
                    {
-                        std::unique_lock<std::mutex> lock(_mutex);
-
-                        _device_list = filter_by_vid(_ctx->query_devices(mask), _vid);
-
-                        // Current device will point to the first available device
-                        _camera_index = 0;
-                        if (_device_list.size() > 0)
-                        {
-                           _cv.notify_all();
-                        }
+                        on_devices_changed(mask);
                     });
 
         _ctx->set_devices_changed_callback({cb,  [](rs2_devices_changed_callback* p) { p->release(); }});
     }
 
-    std::shared_ptr<device_interface> device_hub::create_device(const std::string& serial, bool cycle_devices)
+    const device_hub::listed_device* device_hub::find_listed(const device_info& info) const
     {
-        std::shared_ptr<device_interface> res = nullptr;
-        for(auto i = 0; ((i< _device_list.size()) && (nullptr == res)); i++)
+        auto it = std::find_if(_listed.begin(), _listed.end(), [&](const listed_device& d) { return *d.info == info; });
+        return it == _listed.end() ? nullptr : &*it;
+    }
+
+    std::shared_ptr<device_interface> device_hub::resolve_serial(const std::shared_ptr<device_info>& info, std::string& serial)
+    {
+        auto dev = info->create_device(_register_device_notifications);
+        serial = dev->supports_info(RS2_CAMERA_INFO_SERIAL_NUMBER) ? dev->get_info(RS2_CAMERA_INFO_SERIAL_NUMBER) : "";
+        _listed.push_back({ info, serial });
+        return dev;
+    }
+
+    void device_hub::on_devices_changed(int mask)
+    {
+        std::vector<std::pair<int, std::shared_ptr<device_interface>>> reconnected;
         {
-            // _camera_index is the curr device that the hub will expose
-            auto d = _device_list[ (_camera_index + i) % _device_list.size()];
-            auto dev = d->create_device(_register_device_notifications);
+            std::unique_lock<std::mutex> lock(_mutex);
+
+            _device_list = filter_by_vid(_ctx->query_devices(mask), _vid);
+
+            // Current device will point to the first available device
+            _camera_index = 0;
 
-            if(serial.size() > 0 )
+            auto now = clock::now();
+            for (auto it = _listed.begin(); it != _listed.end();)
             {
-                auto new_serial = dev->get_info(RS2_CAMERA_INFO_SERIAL_NUMBER);
+                if (std::any_of(_device_list.begin(), _device_list.end(), [&](const std::shared_ptr<device_info>& d) { return *d == *it->info; }))
+                {
+                    ++it;
+                    continue;
+                }
+                if (!it->serial.empty())
+                {
+                    auto&& c = _connections[it->serial];
+                    c.connected = false;
+                    c.disconnected = now;
+                }
+                it = _listed.erase(it);
+            }
+
+            // The devices that connected are created once, here, and handed to the threads that wait for them.
+            // Nothing is created while no one is waiting for a device or for a reconnection
+            bool any_waiter = std::any_of(_waiters.begin(), _waiters.end(), [](const waiter* w) { return !w->device; });
+            bool any_disconnected = std::any_of(_connections.begin(), _connections.end(),
+                [](const std::pair<const std::string, connection>& c) { return !c.second.connected; });
+            if (!any_waiter && !any_disconnected)
+                return;
 
-                if(serial == new_serial)
+            for (auto&& info : _device_list)
+            {
+                if (find_listed(*info))
+                    continue;
+
+                std::string serial;
+                std::shared_ptr<device_interface> dev;
+                try
                 {
-                    res = dev;
-                    cycle_devices = false;  // Requesting a device by its serial shall not invoke internal cycling
+                    dev = resolve_serial(info, serial);
                 }
+                catch (const std::exception& ex)
+                {
+                    LOG_WARNING("Device hub: failed to create a connected device, " << ex.what());
+                    continue;
+                }
+
+                auto c = _connections.find(serial);
+                if (c != _connections.end() && !c->second.connected)
+                {
+                    auto latency = std::chrono::duration<float, std::milli>(now - c->second.disconnected).count();
+                    auto&& stats = c->second.stats;
+                    ++stats.reconnects;
+                    stats.last_latency_ms = latency;
+                    stats.max_latency_ms = std::max(stats.max_latency_ms, latency);
+                    c->second.connected = true;
+                    LOG_INFO("Device " << serial << " reconnected after " << latency << " ms");
+
+                    for (auto&& handler : _reconnect_handlers)
+                        if (handler.second.first == serial)
+                            reconnected.emplace_back(handler.first, dev);
+                }
+
+                for (auto&& w : _waiters)
+                {
+                    if (!w->device && (w->serial.empty() || w->serial == serial))
+                    {
+                        w->device = dev;
+                        w->cv.notify_one();
+                    }
+                }
+            }
+        }
+
+        // A handler removed meanwhile is skipped, the removal waits for the handlers in progress
+        std::lock_guard<std::mutex> handlers_lock(_handlers_mutex);
+        for (auto&& r : reconnected)
+        {
+            std::function<void(std::shared_ptr<device_interface>)> handler;
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                auto it = _reconnect_handlers.find(r.first);
+                if (it == _reconnect_handlers.end())
+                    continue;
+                handler = it->second.second;
             }
-            else // Use the first selected if "any device" pattern was used
+            try
             {
-                res = dev;
+                handler(r.second);
+            }
+            catch (const std::exception& ex)
+            {
+                LOG_ERROR("Device hub: reconnect handler failed, " << ex.what());
             }
         }
+    }
+
+    std::shared_ptr<device_interface> device_hub::create_device(const std::string& serial, bool cycle_devices)
+    {
+        std::shared_ptr<device_interface> res = nullptr;
+        if (serial.size() > 0)
+        {
+            // Requesting a device by its serial shall not invoke internal cycling.
+            // The devices whose serial is known are not created again to read it
+            for (auto&& d : _device_list)
+            {
+                auto listed = find_listed(*d);
+                if (listed && listed->serial == serial)
+                    return d->create_device(_register_device_notifications);
+            }
+            for (auto&& d : _device_list)
+            {
+                if (find_listed(*d))
+                    continue;
+                std::string new_serial;
+                auto dev = resolve_serial(d, new_serial);
+                if (serial == new_serial)
+                    return dev;
+            }
+            return nullptr;
+        }
+
+        if (_device_list.empty())
+            return nullptr;
+
+        // _camera_index is the curr device that the hub will expose. Use the first selected if "any device" pattern was used
+        auto d = _device_list[_camera_index % _device_list.size()];
+        std::string new_serial;
+        res = find_listed(*d) ? d->create_device(_register_device_notifications) : resolve_serial(d, new_serial);
 
         // Advance the internal selection when appropriate
         if (res && cycle_devices)
@@ -94,30 +210,24 @@ namespace librealsense
     {
         std::unique_lock<std::mutex> lock(_mutex);
 
-        std::shared_ptr<device_interface> res = nullptr;
-
         // check if there is at least one device connected
         _device_list = filter_by_vid(_ctx->query_devices(RS2_PRODUCT_LINE_ANY), _vid);
-        if (_device_list.size() > 0)
-        {
-            res = create_device(serial, loop_through_devices);
-        }
-
+        auto res = create_device(serial, loop_through_devices);
         if (res) return res;
 
-        // block for the requested device to be connected, or till the timeout occurs
-        if (!_cv.wait_for(lock, timeout, [&]()
-        {
-            if (_device_list.size() > 0)
-            {
-                res = create_device(serial, loop_through_devices);
-            }
-            return res != nullptr;
-        }))
+        // block for the requested device to be connected, or till the timeout occurs.
+        // The devices that connect meanwhile are created by the notifications, waking up only the threads that requested them
+        waiter w;
+        w.serial = serial;
+        _waiters.push_back(&w);
+        auto found = w.cv.wait_for(lock, timeout, [&]() { return w.device != nullptr; });
+        _waiters.remove(&w);
+
+        if (!found)
         {
             throw std::runtime_error("No device connected");
         }
-        return res;
+        return w.device;
     }
 
     /**
@@ -129,9 +239,30 @@ namespace librealsense
         return dev.is_valid();
     }
 
+    int device_hub::add_reconnect_handler(const std::string& serial, std::function<void(std::shared_ptr<device_interface>)> handler)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto token = _next_token++;
+        _reconnect_handlers[token] = { serial, std::move(handler) };
+        return token;
+    }
+
+    void device_hub::remove_reconnect_handler(int token)
+    {
+        std::lock_guard<std::mutex> handlers_lock(_handlers_mutex);
+        std::lock_guard<std::mutex> lock(_mutex);
+        _reconnect_handlers.erase(token);
+    }
+
+    rs2_reconnect_stats device_hub::get_reconnect_stats(const std::string& serial)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto it = _connections.find(serial);
+        return it == _connections.end() ? rs2_reconnect_stats{} : it->second.stats;
+    }
+
     std::shared_ptr<librealsense::context> device_hub::get_context()
     {
         return _ctx;
     }
 }
-
@@ -6,6 +6,8 @@
 #include "context.h"
 #include "device.h"
 #include <limits>
+#include <list>
+#include <map>
 
 namespace librealsense
 {
@@ -41,6 +43,19 @@ namespace librealsense
         */
         bool is_connected(const device_interface& dev);
 
+        /**
+        * Registers a handler invoked with the device when a device of the serial connects again after it was disconnected.
+        * Handlers are invoked from the thread of the device notifications, and are not invoked anymore once removed
+        * \return  token for remove_reconnect_handler
+        */
+        int add_reconnect_handler(const std::string& serial, std::function<void(std::shared_ptr<device_interface>)> handler);
+        void remove_reconnect_handler(int token);
+
+        /**
+        * Time from the disconnection of the device of the serial until it was listed again
+        */
+        rs2_reconnect_stats get_reconnect_stats(const std::string& serial);
+
         std::shared_ptr<librealsense::context> get_context();
 
         ~device_hub()
@@ -49,11 +64,45 @@ namespace librealsense
         }
 
     private:
+        typedef std::chrono::steady_clock clock;
+
+        // A thread blocked in wait_for_device, woken only by a device it requested
+        struct waiter
+        {
+            std::string serial;
+            std::shared_ptr<device_interface> device;
+            std::condition_variable cv;
+        };
+
+        // Serial numbers are read from the devices, each listed device is only created once to read it
+        struct listed_device
+        {
+            std::shared_ptr<device_info> info;
+            std::string serial;
+        };
+
+        struct connection
+        {
+            bool connected = true;
+            clock::time_point disconnected;
+            rs2_reconnect_stats stats = {};
+        };
+
+        void on_devices_changed(int mask);
         std::shared_ptr<device_interface> create_device(const std::string& serial, bool cycle_devices = true);
+        // Creates the device and records its serial number
+        std::shared_ptr<device_interface> resolve_serial(const std::shared_ptr<device_info>& info, std::string& serial);
+        const listed_device* find_listed(const device_info& info) const;
+
         std::shared_ptr<librealsense::context> _ctx;
         std::mutex _mutex;
-        std::condition_variable _cv;
         std::vector<std::shared_ptr<device_info>> _device_list;
+        std::vector<listed_device> _listed;
+        std::list<waiter*> _waiters;
+        std::map<std::string, connection> _connections;
+        std::map<int, std::pair<std::string, std::function<void(std::shared_ptr<device_interface>)>>> _reconnect_handlers;
+        int _next_token = 0;
+        std::mutex _handlers_mutex;     // Held while handlers are invoked, before _mutex
         int _camera_index = 0;
         int _vid = 0;
         bool _register_device_notifications;
@@ -9,6 +9,8 @@
 
 namespace librealsense
 {
+    const int ds5_advanced_mode_base::SET_ADV_INTERVAL_MS;
+
     ds5_advanced_mode_base::ds5_advanced_mode_base(std::shared_ptr<hw_monitor> hwm,
                                                    uvc_sensor& depth_sensor)
         : _hw_monitor(hwm),
@@ -56,6 +58,7 @@ namespace librealsense
                                               const firmware_version& fw_version)
     {
         auto p = get_all();
+        auto current = p;
         auto res = get_res_type(configuration.front().width, configuration.front().height);
 
         switch (preset)
@@ -159,7 +162,7 @@ namespace librealsense
         default:
             throw invalid_value_exception(to_string() << "apply_preset(...) failed! Invalid preset! (" << preset << ")");
         }
-        set_all(p);
+        set_all(p, &current);
     }
 
     void ds5_advanced_mode_base::get_depth_control_group(STDepthControlGroup* ptr, int mode) const
@@ -655,27 +658,41 @@ namespace librealsense
         if (!is_enabled())
             throw wrong_api_call_sequence_exception(to_string() << "load_json(...) failed! Device is not in Advanced-Mode.");
 
-        auto p = get_all();
+        auto current = get_all();
+        auto p = current;
         update_structs(json_content, p);
-        set_all(p);
+        set_all(p, &current);
         _preset_opt->set(RS2_RS400_VISUAL_PRESET_CUSTOM);
     }
 
     preset ds5_advanced_mode_base::get_all() const
     {
         preset p;
-        get_depth_control_group(&p.depth_controls);
-        get_rsm(&p.rsm);
-        get_rau_support_vector_control(&p.rsvc);
-        get_color_control(&p.color_control);
-        get_rau_color_thresholds_control(&p.rctc);
-        get_slo_color_thresholds_control(&p.sctc);
-        get_slo_penalty_control(&p.spc);
-        get_hdad(&p.hdad);
-        get_color_correction(&p.cc);
-        get_depth_table_control(&p.depth_table);
-        get_ae_control(&p.ae);
-        get_census_radius(&p.census);
+        auto groups = send_receive({
+            encode_get<STDepthControlGroup>(),
+            encode_get<STRsm>(),
+            encode_get<STRauSupportVectorControl>(),
+            encode_get<STColorControl>(),
+            encode_get<STRauColorThresholdsControl>(),
+            encode_get<STSloColorThresholdsControl>(),
+            encode_get<STSloPenaltyControl>(),
+            encode_get<STHdad>(),
+            encode_get<STColorCorrection>(),
+            encode_get<STDepthTableControl>(),
+            encode_get<STAEControl>(),
+            encode_get<STCensusRadius>() });
+        p.depth_controls = decode_get<STDepthControlGroup>(groups[0]);
+        p.rsm = decode_get<STRsm>(groups[1]);
+        p.rsvc = decode_get<STRauSupportVectorControl>(groups[2]);
+        p.color_control = decode_get<STColorControl>(groups[3]);
+        p.rctc = decode_get<STRauColorThresholdsControl>(groups[4]);
+        p.sctc = decode_get<STSloColorThresholdsControl>(groups[5]);
+        p.spc = decode_get<STSloPenaltyControl>(groups[6]);
+        p.hdad = decode_get<STHdad>(groups[7]);
+        p.cc = decode_get<STColorCorrection>(groups[8]);
+        p.depth_table = decode_get<STDepthTableControl>(groups[9]);
+        p.ae = decode_get<STAEControl>(groups[10]);
+        p.census = decode_get<STCensusRadius>(groups[11]);
         get_laser_power(&p.laser_power);
         get_laser_state(&p.laser_state);
         get_depth_exposure(&p.depth_exposure);
@@ -698,57 +715,93 @@ namespace librealsense
         return p;
     }
 
-    void ds5_advanced_mode_base::set_all(const preset& p)
+    void ds5_advanced_mode_base::set_all(const preset& p, const preset* current)
     {
-        set(p.depth_controls, advanced_mode_traits<STDepthControlGroup>::group);
-        set(p.rsm           , advanced_mode_traits<STRsm>::group);
-        set(p.rsvc          , advanced_mode_traits<STRauSupportVectorControl>::group);
-        set(p.color_control , advanced_mode_traits<STColorControl>::group);
-        set(p.rctc          , advanced_mode_traits<STRauColorThresholdsControl>::group);
-        set(p.sctc          , advanced_mode_traits<STSloColorThresholdsControl>::group);
-        set(p.spc           , advanced_mode_traits<STSloPenaltyControl>::group);
-        set(p.hdad          , advanced_mode_traits<STHdad>::group);
+        std::vector<std::vector<uint8_t>> groups;
+        queue_set(groups, p.depth_controls, field(current, &preset::depth_controls));
+        queue_set(groups, p.rsm,            field(current, &preset::rsm));
+        queue_set(groups, p.rsvc,           field(current, &preset::rsvc));
+        queue_set(groups, p.color_control,  field(current, &preset::color_control));
+        queue_set(groups, p.rctc,           field(current, &preset::rctc));
+        queue_set(groups, p.sctc,           field(current, &preset::sctc));
+        queue_set(groups, p.spc,            field(current, &preset::spc));
+        queue_set(groups, p.hdad,           field(current, &preset::hdad));
+        send_groups(groups);
 
         // Setting auto-white-balance control before colorCorrection parameters
-        set_depth_auto_white_balance(p.depth_auto_white_balance);
-        set(p.cc            , advanced_mode_traits<STColorCorrection>::group);
-
-        set(p.depth_table   , advanced_mode_traits<STDepthTableControl>::group);
-        set(p.ae            , advanced_mode_traits<STAEControl>::group);
-        set(p.census        , advanced_mode_traits<STCensusRadius>::group);
-
-        set_laser_state(p.laser_state);
-        if (p.laser_state.was_set && p.laser_state.laser_state == 1) // 1 - on
+        auto depth_awb_changed = changed(p.depth_auto_white_balance, field(current, &preset::depth_auto_white_balance), &auto_white_balance_control::auto_white_balance);
+        if (depth_awb_changed)
+            set_depth_auto_white_balance(p.depth_auto_white_balance);
+
+        queue_set(groups, p.cc,             depth_awb_changed ? nullptr : field(current, &preset::cc));
+        queue_set(groups, p.depth_table,    field(current, &preset::depth_table));
+        queue_set(groups, p.ae,             field(current, &preset::ae));
+        queue_set(groups, p.census,         field(current, &preset::census));
+        send_groups(groups);
+
+        // The controls a mode depends on are rewritten whenever the mode changes
+        auto laser_state_changed = changed(p.laser_state, field(current, &preset::laser_state), &laser_state_control::laser_state);
+        if (laser_state_changed)
+            set_laser_state(p.laser_state);
+        if (p.laser_state.was_set && p.laser_state.laser_state == 1 && // 1 - on
+            (laser_state_changed || changed(p.laser_power, field(current, &preset::laser_power), &laser_power_control::laser_power)))
             set_laser_power(p.laser_power);
 
-        set_depth_auto_exposure(p.depth_auto_exposure);
+        auto depth_ae_changed = changed(p.depth_auto_exposure, field(current, &preset::depth_auto_exposure), &auto_exposure_control::auto_exposure);
+        if (depth_ae_changed)
+            set_depth_auto_exposure(p.depth_auto_exposure);
         if (p.depth_auto_exposure.was_set && p.depth_auto_exposure.auto_exposure == 0)
         {
-            set_depth_gain(p.depth_gain);
-            set_depth_exposure(p.depth_exposure);
+            if (depth_ae_changed || changed(p.depth_gain, field(current, &preset::depth_gain), &gain_control::gain))
+                set_depth_gain(p.depth_gain);
+            if (depth_ae_changed || changed(p.depth_exposure, field(current, &preset::depth_exposure), &exposure_control::exposure))
+                set_depth_exposure(p.depth_exposure);
         }
 
-        set_color_auto_exposure(p.color_auto_exposure);
-        if (p.color_auto_exposure.was_set && p.color_auto_exposure.auto_exposure == 0)
+        auto color_ae_changed = changed(p.color_auto_exposure, field(current, &preset::color_auto_exposure), &auto_exposure_control::auto_exposure);
+        if (color_ae_changed)
+            set_color_auto_exposure(p.color_auto_exposure);
+        if (p.color_auto_exposure.was_set && p.color_auto_exposure.auto_exposure == 0 &&
+            (color_ae_changed || changed(p.color_exposure, field(current, &preset::color_exposure), &exposure_control::exposure)))
             set_color_exposure(p.color_exposure);
 
-        set_color_backlight_compensation(p.color_backlight_compensation);
-        set_color_brightness(p.color_brightness);
-        set_color_contrast(p.color_contrast);
-        set_color_gain(p.color_gain);
-        set_color_gamma(p.color_gamma);
-        set_color_hue(p.color_hue);
-        set_color_saturation(p.color_saturation);
-        set_color_sharpness(p.color_sharpness);
-
-        set_color_auto_white_balance(p.color_auto_white_balance);
-        if (p.color_auto_white_balance.was_set && p.color_auto_white_balance.auto_white_balance == 0)
+        if (changed(p.color_backlight_compensation, field(current, &preset::color_backlight_compensation), &backlight_compensation_control::backlight_compensation))
+            set_color_backlight_compensation(p.color_backlight_compensation);
+        if (changed(p.color_brightness, field(current, &preset::color_brightness), &brightness_control::brightness))
+            set_color_brightness(p.color_brightness);
+        if (changed(p.color_contrast, field(current, &preset::color_contrast), &contrast_control::contrast))
+            set_color_contrast(p.color_contrast);
+        if (changed(p.color_gain, field(current, &preset::color_gain), &gain_control::gain))
+            set_color_gain(p.color_gain);
+        if (changed(p.color_gamma, field(current, &preset::color_gamma), &gamma_control::gamma))
+            set_color_gamma(p.color_gamma);
+        if (changed(p.color_hue, field(current, &preset::color_hue), &hue_control::hue))
+            set_color_hue(p.color_hue);
+        if (changed(p.color_saturation, field(current, &preset::color_saturation), &saturation_control::saturation))
+            set_color_saturation(p.color_saturation);
+        if (changed(p.color_sharpness, field(current, &preset::color_sharpness), &sharpness_control::sharpness))
+            set_color_sharpness(p.color_sharpness);
+
+        auto color_awb_changed = changed(p.color_auto_white_balance, field(current, &preset::color_auto_white_balance), &auto_white_balance_control::auto_white_balance);
+        if (color_awb_changed)
+            set_color_auto_white_balance(p.color_auto_white_balance);
+        if (p.color_auto_white_balance.was_set && p.color_auto_white_balance.auto_white_balance == 0 &&
+            (color_awb_changed || changed(p.color_white_balance, field(current, &preset::color_white_balance), &white_balance_control::white_balance)))
             set_color_white_balance(p.color_white_balance);
 
         // TODO: W/O due to a FW bug of power_line_frequency control on Windows OS
         //set_color_power_line_frequency(p.color_power_line_frequency);
     }
 
+    void ds5_advanced_mode_base::send_groups(std::vector<std::vector<uint8_t>>& groups) const
+    {
+        if (groups.empty()) return;
+
+        for (auto&& result : send_receive(groups, std::chrono::milliseconds(SET_ADV_INTERVAL_MS)))
+            assert_no_error(ds::fw_cmd::SET_ADV, result);
+        groups.clear();
+    }
+
     std::vector<uint8_t> ds5_advanced_mode_base::send_receive(const std::vector<uint8_t>& input) const
     {
         auto res = _hw_monitor->send(input);
@@ -759,6 +812,20 @@ namespace librealsense
         return res;
     }
 
+    std::vector<std::vector<uint8_t>> ds5_advanced_mode_base::send_receive(const std::vector<std::vector<uint8_t>>& inputs,
+                                                                           std::chrono::milliseconds interval) const
+    {
+        auto results = _hw_monitor->send_batch(inputs, interval);
+        for (auto&& res : results)
+        {
+            if (res.empty())
+            {
+                throw std::runtime_error("Advanced mode write failed!");
+            }
+        }
+        return results;
+    }
+
     uint32_t ds5_advanced_mode_base::pack(uint8_t c0, uint8_t c1, uint8_t c2, uint8_t c3)
     {
         return (c0 << 24) | (c1 << 16) | (c2 << 8) | c3;
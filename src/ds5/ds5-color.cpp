@@ -38,6 +38,7 @@ namespace librealsense
                 << color_devs_info.size() << " found");
 
         auto color_ep = create_color_device(ctx, color_devs_info);
+        color_ep->set_device_cache(_cache);
     }
 
     std::shared_ptr<uvc_sensor> ds5_color::create_color_device(std::shared_ptr<context> ctx,
@@ -45,15 +46,20 @@ namespace librealsense
     {
         auto&& backend = ctx->get_backend();
         std::unique_ptr<frame_timestamp_reader> ds5_timestamp_reader_backup(new ds5_timestamp_reader(backend.create_time_service()));
+        std::unique_ptr<frame_timestamp_reader> ds5_timestamp_reader_metadata(new ds5_timestamp_reader_from_metadata(move(ds5_timestamp_reader_backup)));
+        auto enable_global_time_option = std::make_shared<global_time_option>(_tf_keeper);
 
         auto color_ep = std::make_shared<ds5_color_sensor>(this, backend.create_uvc_device(color_devices_info.front()),
-            std::unique_ptr<frame_timestamp_reader>(new ds5_timestamp_reader_from_metadata(move(ds5_timestamp_reader_backup))));
+            std::unique_ptr<frame_timestamp_reader>(new global_timestamp_reader(move(ds5_timestamp_reader_metadata), _tf_keeper, enable_global_time_option)));
 
         _color_device_idx = add_sensor(color_ep);
 
+        color_ep->register_option(RS2_OPTION_GLOBAL_TIME_ENABLED, enable_global_time_option);
+
         color_ep->register_pixel_format(pf_yuyv);
         color_ep->register_pixel_format(pf_yuy2);
         color_ep->register_pixel_format(pf_bayer16);
+        color_ep->register_pixel_format(pf_mjpeg);
 
         color_ep->register_pu(RS2_OPTION_BACKLIGHT_COMPENSATION);
         color_ep->register_pu(RS2_OPTION_BRIGHTNESS);
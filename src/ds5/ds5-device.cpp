@@ -21,6 +21,7 @@
 #include "environment.h"
 #include "ds5-color.h"
 #include "ds5-rolling-shutter.h"
+#include "device-cache.h"
 
 namespace librealsense
 {
@@ -60,9 +61,55 @@ namespace librealsense
         return roi;
     }
 
+    // A raw command other than a known read may write the calibration the device cache holds
+    static bool may_write_calibration(const std::vector<uint8_t>& command)
+    {
+        using namespace ds;
+
+        // The opcode follows the length and the magic number
+        const size_t opcode_offset = 4;
+        if (command.size() < opcode_offset + sizeof(uint32_t))
+            return false;
+
+        uint32_t opcode;
+        librealsense::copy(&opcode, command.data() + opcode_offset, sizeof(opcode));
+        switch (opcode)
+        {
+        case MRD: case GLD: case GVD: case GETINTCAL: case GET_ADV: case UAMG: case GETAEROI: case MMER:
+        case GET_EXTRINSICS: case GET_CAM_SYNC: case GETRGBAEROI: case GET_PWM_ON_OFF:
+            return false;
+        default:
+            return true;
+        }
+    }
+
     std::vector<uint8_t> ds5_device::send_receive_raw_data(const std::vector<uint8_t>& input)
     {
-        return _hw_monitor->send(input);
+        auto response = _hw_monitor->send(input);
+        if (_cache && may_write_calibration(input))
+            _cache->invalidate_tables();
+        return response;
+    }
+
+    std::vector<std::vector<uint8_t>> ds5_device::send_receive_raw_data_batch(const std::vector<std::vector<uint8_t>>& inputs)
+    {
+        auto responses = _hw_monitor->send_batch(inputs);
+        if (_cache && std::any_of(inputs.begin(), inputs.end(), may_write_calibration))
+            _cache->invalidate_tables();
+        return responses;
+    }
+
+    double ds5_device::get_device_time_ms()
+    {
+        if (!_hw_monitor)
+            throw wrong_api_call_sequence_exception("_hw_monitor is not initialized yet");
+
+        command cmd(ds::MRD, ds::REGISTER_CLOCK_0, ds::REGISTER_CLOCK_0 + 4);
+        auto res = _hw_monitor->send(cmd);
+        if (res.size() < sizeof(uint32_t))
+            throw io_exception("Not enough bytes returned from the firmware!");
+
+        return *reinterpret_cast<const uint32_t*>(res.data()) * TIMESTAMP_USEC_TO_MSEC;
     }
 
     void ds5_device::hardware_reset()
@@ -80,6 +127,12 @@ namespace librealsense
             : uvc_sensor(ds::DEPTH_STEREO, uvc_device, move(timestamp_reader), owner), _owner(owner), _depth_units(0)
         {}
 
+        // The depth units option updates the depth scale of the sensor
+        ~ds5_depth_sensor()
+        {
+            stop_async_writes();
+        }
+
         rs2_intrinsics get_intrinsics(const stream_profile& profile) const override
         {
             return get_intrinsic_by_resolution(
@@ -272,15 +325,26 @@ namespace librealsense
 
     std::vector<uint8_t> ds5_device::get_raw_calibration_table(ds::calibration_table_id table_id) const
     {
-        command cmd(ds::GETINTCAL, table_id);
-        return _hw_monitor->send(cmd);
+        auto fetch = [&]()
+        {
+            command cmd(ds::GETINTCAL, table_id);
+            return _hw_monitor->send(cmd);
+        };
+        if (!_cache)
+            return fetch();
+
+        // A table read back from the cache still has to match its checksum
+        return _cache->get_table(table_id, fetch, [](const std::vector<uint8_t>& raw)
+        {
+            auto header = reinterpret_cast<const ds::table_header*>(raw.data());
+            return raw.size() >= sizeof(ds::table_header) &&
+                header->crc32 == calc_crc32(raw.data() + sizeof(ds::table_header), raw.size() - sizeof(ds::table_header));
+        });
     }
 
-    ds::d400_caps ds5_device::parse_device_capabilities() const
+    ds::d400_caps ds5_device::parse_device_capabilities(const std::vector<uint8_t>& gvd_buf) const
     {
         using namespace ds;
-        std::array<unsigned char,HW_MONITOR_BUFFER_SIZE> gvd_buf;
-        _hw_monitor->get_gvd(gvd_buf.size(), gvd_buf.data(), GVD);
 
         // Opaque retrieval
         d400_caps val{d400_caps::CAP_UNDEFINED};
@@ -308,8 +372,11 @@ namespace librealsense
             depth_devices.push_back(backend.create_uvc_device(info));
 
         std::unique_ptr<frame_timestamp_reader> ds5_timestamp_reader_backup(new ds5_timestamp_reader(backend.create_time_service()));
+        std::unique_ptr<frame_timestamp_reader> ds5_timestamp_reader_metadata(new ds5_timestamp_reader_from_metadata(std::move(ds5_timestamp_reader_backup)));
+        auto enable_global_time_option = std::make_shared<global_time_option>(_tf_keeper);
         auto depth_ep = std::make_shared<ds5_depth_sensor>(this, std::make_shared<platform::multi_pins_uvc_device>(depth_devices),
-                                                       std::unique_ptr<frame_timestamp_reader>(new ds5_timestamp_reader_from_metadata(std::move(ds5_timestamp_reader_backup))));
+                                                       std::unique_ptr<frame_timestamp_reader>(new global_timestamp_reader(std::move(ds5_timestamp_reader_metadata), _tf_keeper, enable_global_time_option)));
+        depth_ep->register_option(RS2_OPTION_GLOBAL_TIME_ENABLED, enable_global_time_option);
         depth_ep->register_xu(depth_xu); // make sure the XU is initialized every time we power the camera
 
         depth_ep->register_pixel_format(pf_z16); // Depth
@@ -326,11 +393,18 @@ namespace librealsense
           _left_ir_stream(new stream(RS2_STREAM_INFRARED, 1)),
           _right_ir_stream(new stream(RS2_STREAM_INFRARED, 2)),
           _device_capabilities(ds::d400_caps::CAP_UNDEFINED),
+          _tf_keeper(std::make_shared<time_diff_keeper>(this, 500)),
           _depth_device_idx(add_sensor(create_depth_device(ctx, group.uvc_devices)))
     {
         init(ctx, group);
     }
 
+    ds5_device::~ds5_device()
+    {
+        // The sensors outlive this object and may still hold the keeper
+        _tf_keeper->shutdown();
+    }
+
     void ds5_device::init(std::shared_ptr<context> ctx,
         const platform::backend_device_group& group)
     {
@@ -374,11 +448,13 @@ namespace librealsense
 
         auto pid = group.uvc_devices.front().pid;
         std::string device_name = (rs400_sku_names.end() != rs400_sku_names.find(pid)) ? rs400_sku_names.at(pid) : "RS4xx";
-        _fw_version = firmware_version(_hw_monitor->get_firmware_version_string(GVD, camera_fw_version_offset));
+        // The version, serial, lock state and capabilities all come from one GVD query
+        _gvd = _hw_monitor->get_gvd(GVD);
+        _fw_version = firmware_version(hw_monitor::get_firmware_version_string(_gvd, camera_fw_version_offset));
         _recommended_fw_version = firmware_version("5.10.3.0");
         if (_fw_version >= firmware_version("5.10.4.0"))
-            _device_capabilities = parse_device_capabilities();
-        auto serial = _hw_monitor->get_module_serial_string(GVD, module_serial_offset);
+            _device_capabilities = parse_device_capabilities(_gvd);
+        auto serial = hw_monitor::get_module_serial_string(_gvd, module_serial_offset);
 
         auto& depth_ep = get_depth_sensor();
         auto advanced_mode = is_camera_in_advanced_mode();
@@ -402,12 +478,18 @@ namespace librealsense
             depth_ep.register_pixel_format(pf_y12i); // L+R - Calibration not rectified
         }
 
+        // The GVD is read anyway, the profiles also depend on the USB connection
+        auto validation = _gvd;
+        validation.insert(validation.end(), usb_type_str.begin(), usb_type_str.end());
+        _cache = device_cache::instance().open(serial, _fw_version, validation);
+        depth_ep.set_device_cache(_cache);
+
         auto pid_hex_str = hexify(pid >> 8) + hexify(static_cast<uint8_t>(pid));
 
         std::string is_camera_locked{ "" };
         if (_fw_version >= firmware_version("5.6.3.0"))
         {
-            auto is_locked = _hw_monitor->is_camera_locked(GVD, is_camera_locked_offset);
+            auto is_locked = hw_monitor::is_camera_locked(_gvd, is_camera_locked_offset);
             is_camera_locked = (is_locked) ? "YES" : "NO";
 
 #ifdef HWM_OVER_XU
@@ -457,6 +539,14 @@ namespace librealsense
                     depth_ep.get_notifications_processor(),
                     std::unique_ptr<notification_decoder>(new ds5_notification_decoder())));
 
+            _polling_error_handler->set_error_reports([&depth_ep](std::function<void()> on_report)
+            {
+                return depth_ep.invoke_powered([&](platform::uvc_device& dev)
+                {
+                    return dev.set_xu_status_callback(depth_xu, DS5_ERROR_REPORTING, on_report);
+                });
+            });
+
             depth_ep.register_option(RS2_OPTION_ERROR_POLLING_ENABLED, std::make_shared<polling_errors_disable>(_polling_error_handler.get()));
 
             depth_ep.register_option(RS2_OPTION_ASIC_TEMPERATURE,
@@ -628,8 +718,11 @@ namespace librealsense
             depth_devices.push_back(backend.create_uvc_device(info));
 
         std::unique_ptr<frame_timestamp_reader> ds5_timestamp_reader_backup(new ds5_timestamp_reader(backend.create_time_service()));
+        std::unique_ptr<frame_timestamp_reader> ds5_timestamp_reader_metadata(new ds5_timestamp_reader_from_metadata(std::move(ds5_timestamp_reader_backup)));
+        auto enable_global_time_option = std::make_shared<global_time_option>(_tf_keeper);
         auto depth_ep = std::make_shared<ds5u_depth_sensor>(this, std::make_shared<platform::multi_pins_uvc_device>(depth_devices),
-                            std::unique_ptr<frame_timestamp_reader>(new ds5_timestamp_reader_from_metadata(std::move(ds5_timestamp_reader_backup))));
+                            std::unique_ptr<frame_timestamp_reader>(new global_timestamp_reader(std::move(ds5_timestamp_reader_metadata), _tf_keeper, enable_global_time_option)));
+        depth_ep->register_option(RS2_OPTION_GLOBAL_TIME_ENABLED, enable_global_time_option);
         depth_ep->register_xu(depth_xu); // make sure the XU is initialized every time we power the camera
 
         depth_ep->register_pixel_format(pf_z16); // Depth
@@ -10,6 +10,7 @@
 #include "core/debug.h"
 #include "core/advanced_mode.h"
 #include "device.h"
+#include "global_timestamp_reader.h"
 
 namespace librealsense
 {
@@ -26,7 +27,7 @@ namespace librealsense
         const hw_monitor& _hw_monitor;
     };
 
-    class ds5_device : public virtual device, public debug_interface
+    class ds5_device : public virtual device, public debug_interface, public global_time_interface
     {
     public:
         std::shared_ptr<uvc_sensor> create_depth_device(std::shared_ptr<context> ctx,
@@ -39,13 +40,16 @@ namespace librealsense
 
         ds5_device(std::shared_ptr<context> ctx,
                    const platform::backend_device_group& group);
+        ~ds5_device();
 
         std::vector<uint8_t> send_receive_raw_data(const std::vector<uint8_t>& input) override;
+        std::vector<std::vector<uint8_t>> send_receive_raw_data_batch(const std::vector<std::vector<uint8_t>>& inputs) override;
 
         void hardware_reset() override;
         void create_snapshot(std::shared_ptr<debug_interface>& snapshot) const override;
         void enable_recording(std::function<void(const debug_interface&)> record_action) override;
         platform::usb_spec get_usb_spec() const;
+        double get_device_time_ms() override;
 
     protected:
 
@@ -55,7 +59,7 @@ namespace librealsense
 
         float get_stereo_baseline_mm() const;
 
-        ds::d400_caps  parse_device_capabilities() const;
+        ds::d400_caps  parse_device_capabilities(const std::vector<uint8_t>& gvd_buf) const;
 
         void init(std::shared_ptr<context> ctx,
             const platform::backend_device_group& group);
@@ -66,11 +70,15 @@ namespace librealsense
         firmware_version            _fw_version;
         firmware_version            _recommended_fw_version;
         ds::d400_caps               _device_capabilities;
+        std::vector<uint8_t>        _gvd;                       // GVD as read when the device was constructed
+        std::shared_ptr<device_cache_entry> _cache;             // what the device reported when last opened, null while the cache is off
 
         std::shared_ptr<stream_interface> _depth_stream;
         std::shared_ptr<stream_interface> _left_ir_stream;
         std::shared_ptr<stream_interface> _right_ir_stream;
 
+        std::shared_ptr<time_diff_keeper> _tf_keeper;           // shared by the sensors that report global time, before they are created
+
         uint8_t _depth_device_idx;
 
         lazy<std::vector<uint8_t>> _coefficients_table_raw;
@@ -164,11 +164,15 @@ namespace librealsense
 
         static const char* custom_sensor_fw_ver = "5.6.0.0";
 
+        std::unique_ptr<frame_timestamp_reader> iio_hid_ts_reader(new ds5_iio_hid_timestamp_reader());
+        std::unique_ptr<frame_timestamp_reader> custom_hid_ts_reader(new ds5_custom_hid_timestamp_reader());
+        auto enable_global_time_option = std::make_shared<global_time_option>(_tf_keeper);
         auto hid_ep = std::make_shared<ds5_hid_sensor>(this, ctx->get_backend().create_hid_device(all_hid_infos.front()),
-                                                        std::unique_ptr<frame_timestamp_reader>(new ds5_iio_hid_timestamp_reader()),
-                                                        std::unique_ptr<frame_timestamp_reader>(new ds5_custom_hid_timestamp_reader()),
+                                                        std::unique_ptr<frame_timestamp_reader>(new global_timestamp_reader(std::move(iio_hid_ts_reader), _tf_keeper, enable_global_time_option)),
+                                                        std::unique_ptr<frame_timestamp_reader>(new global_timestamp_reader(std::move(custom_hid_ts_reader), _tf_keeper, enable_global_time_option)),
                                                         fps_and_sampling_frequency_per_rs2_stream,
                                                         sensor_name_and_hid_profiles);
+        hid_ep->register_option(RS2_OPTION_GLOBAL_TIME_ENABLED, enable_global_time_option);
         hid_ep->register_pixel_format(pf_accel_axes);
         hid_ep->register_pixel_format(pf_gyro_axes);
 
@@ -213,6 +217,14 @@ namespace librealsense
                                 std::make_shared<auto_exposure_step_option>(auto_exposure,
                                                                             ae_state,
                                                                             option_range{ 0.1f, 1.0f, 0.1f, ae_step_default_value }));
+        uvc_ep->register_option(RS2_OPTION_AUTO_EXPOSURE_SAMPLE_STRIDE,
+                                std::make_shared<auto_exposure_sample_stride_option>(auto_exposure,
+                                                                                     ae_state,
+                                                                                     option_range{ 1, 16, 1, 1 }));
+        uvc_ep->register_option(RS2_OPTION_AUTO_EXPOSURE_SKIP_FRAMES,
+                                std::make_shared<auto_exposure_skip_frames_option>(auto_exposure,
+                                                                                   ae_state,
+                                                                                   option_range{ 0, 30, 1, 2 }));
         uvc_ep->register_option(RS2_OPTION_POWER_LINE_FREQUENCY,
                                 std::make_shared<auto_exposure_antiflicker_rate_option>(auto_exposure,
                                                                                         ae_state,
@@ -250,7 +262,7 @@ namespace librealsense
         std::string motion_module_fw_version = "";
         if (_fw_version >= firmware_version("5.5.8.0"))
         {
-            motion_module_fw_version = _hw_monitor->get_firmware_version_string(GVD, motion_module_fw_version_offset);
+            motion_module_fw_version = hw_monitor::get_firmware_version_string(_gvd, motion_module_fw_version_offset);
         }
 
         initialize_fisheye_sensor(ctx,group);
@@ -332,8 +344,7 @@ namespace librealsense
                     std::make_shared<enable_motion_correction>(hid_ep.get(),
                         *_accel_intrinsic,
                         *_gyro_intrinsic,
-                        _depth_to_imu,
-                        align_imu_axes, // The motion correction callback also includes the axes rotation routine
+                        rotation, // The motion correction also includes the axes rotation, identity when not calibrated
                         option_range{ 0, 1, 1, 1 }));
             }
             catch (const std::exception& ex)
@@ -341,7 +352,8 @@ namespace librealsense
                 LOG_INFO("Motion Module intrinsic calibration is not available, report: " << ex.what());
 
                 // transform IMU axes if supported
-                hid_ep->register_on_before_frame_callback(align_imu_axes);
+                if (align_imu_axes)
+                    hid_ep->register_on_before_frame_callback(align_imu_axes);
             }
 
             if (!motion_module_fw_version.empty())
@@ -376,9 +388,12 @@ namespace librealsense
         };
 
         std::unique_ptr<frame_timestamp_reader> ds5_timestamp_reader_backup(new ds5_timestamp_reader(environment::get_instance().get_time_service()));
+        std::unique_ptr<frame_timestamp_reader> ds5_timestamp_reader_metadata(new ds5_timestamp_reader_from_metadata(std::move(ds5_timestamp_reader_backup)));
         auto&& backend = ctx->get_backend();
+        auto enable_global_time_option = std::make_shared<global_time_option>(_tf_keeper);
         auto fisheye_ep = std::make_shared<ds5_fisheye_sensor>(this, backend.create_uvc_device(fisheye_infos.front()),
-                                                    std::unique_ptr<frame_timestamp_reader>(new ds5_timestamp_reader_from_metadata(std::move(ds5_timestamp_reader_backup))));
+                                                    std::unique_ptr<frame_timestamp_reader>(new global_timestamp_reader(std::move(ds5_timestamp_reader_metadata), _tf_keeper, enable_global_time_option)));
+        fisheye_ep->register_option(RS2_OPTION_GLOBAL_TIME_ENABLED, enable_global_time_option);
 
         fisheye_ep->register_xu(fisheye_xu); // make sure the XU is initialized everytime we power the camera
         fisheye_ep->register_pixel_format(pf_raw8);
@@ -177,28 +177,30 @@ namespace librealsense
     enable_motion_correction::enable_motion_correction(sensor_base* mm_ep,
                                                        const ds::imu_intrinsic& accel,
                                                        const ds::imu_intrinsic& gyro,
-                                                       std::shared_ptr<librealsense::lazy<rs2_extrinsics>> depth_to_imu,
-                                                       on_before_frame_callback frame_callback,
+                                                       const float3x3& imu_to_depth_rotation,
                                                        const option_range& opt_range)
-        : option_base(opt_range), _is_enabled(true), _accel(accel), _gyro(gyro), _depth_to_imu(**depth_to_imu)
+        : option_base(opt_range), _is_enabled(true),
+          _accel(fold(imu_to_depth_rotation, accel)),
+          _gyro(fold(imu_to_depth_rotation, gyro)),
+          _aligned{ imu_to_depth_rotation, { 0, 0, 0 } }
     {
+        // The rotation applied after the correction is part of the folded transforms, so every sample is
+        // corrected and aligned to the Depth sensor CS with one matrix product instead of two passes
         mm_ep->register_on_before_frame_callback(
-            [this, frame_callback](rs2_stream stream, frame_interface* fr, callback_invocation_holder callback)
+            [this](rs2_stream stream, frame_interface* fr, callback_invocation_holder callback)
             {
-                if (_is_enabled.load() && fr->get_stream()->get_format() == RS2_FORMAT_MOTION_XYZ32F)
-                {
-                    auto xyz = (float3*)(fr->get_frame_data());
-
-                    if (stream == RS2_STREAM_ACCEL)
-                        *xyz = (_accel.sensitivity * (*xyz)) - _accel.bias;
+                if (fr->get_stream()->get_format() != RS2_FORMAT_MOTION_XYZ32F)
+                    return;
 
-                    if (stream == RS2_STREAM_GYRO)
-                        *xyz = _gyro.sensitivity * (*xyz) - _gyro.bias;
+                auto t = &_aligned;
+                if (_is_enabled.load())
+                {
+                    if (stream == RS2_STREAM_ACCEL) t = &_accel;
+                    if (stream == RS2_STREAM_GYRO) t = &_gyro;
                 }
 
-                // Align IMU axes to the established Coordinates System
-                if (frame_callback)
-                    frame_callback(stream, fr, std::move(callback));
+                auto xyz = (float3*)(fr->get_frame_data());
+                *xyz = t->transform * (*xyz) + t->offset;
             });
     }
 
@@ -313,6 +315,52 @@ namespace librealsense
         return static_cast<float>(_auto_exposure_state->get_auto_exposure_step());
     }
 
+    auto_exposure_sample_stride_option::auto_exposure_sample_stride_option(std::shared_ptr<auto_exposure_mechanism> auto_exposure,
+        std::shared_ptr<auto_exposure_state> auto_exposure_state,
+        const option_range& opt_range)
+        : option_base(opt_range),
+        _auto_exposure_state(auto_exposure_state),
+        _auto_exposure(auto_exposure)
+    {}
+
+    void auto_exposure_sample_stride_option::set(float value)
+    {
+        if (!is_valid(value))
+            throw invalid_value_exception(to_string() << "set(auto_exposure_sample_stride_option) failed! Given value " << value << " is out of range.");
+
+        _auto_exposure_state->set_auto_exposure_sample_stride(static_cast<unsigned>(value));
+        _auto_exposure->update_auto_exposure_state(*_auto_exposure_state);
+        _recording_function(*this);
+    }
+
+    float auto_exposure_sample_stride_option::query() const
+    {
+        return static_cast<float>(_auto_exposure_state->get_auto_exposure_sample_stride());
+    }
+
+    auto_exposure_skip_frames_option::auto_exposure_skip_frames_option(std::shared_ptr<auto_exposure_mechanism> auto_exposure,
+        std::shared_ptr<auto_exposure_state> auto_exposure_state,
+        const option_range& opt_range)
+        : option_base(opt_range),
+        _auto_exposure_state(auto_exposure_state),
+        _auto_exposure(auto_exposure)
+    {}
+
+    void auto_exposure_skip_frames_option::set(float value)
+    {
+        if (!is_valid(value))
+            throw invalid_value_exception(to_string() << "set(auto_exposure_skip_frames_option) failed! Given value " << value << " is out of range.");
+
+        _auto_exposure_state->set_auto_exposure_skip_frames(static_cast<unsigned>(value));
+        _auto_exposure->update_auto_exposure_state(*_auto_exposure_state);
+        _recording_function(*this);
+    }
+
+    float auto_exposure_skip_frames_option::query() const
+    {
+        return static_cast<float>(_auto_exposure_state->get_auto_exposure_skip_frames());
+    }
+
     auto_exposure_antiflicker_rate_option::auto_exposure_antiflicker_rate_option(std::shared_ptr<auto_exposure_mechanism> auto_exposure,
                                                                                  std::shared_ptr<auto_exposure_state> auto_exposure_state,
                                                                                  const option_range& opt_range,
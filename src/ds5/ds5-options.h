@@ -71,15 +71,26 @@ namespace librealsense
         enable_motion_correction(sensor_base* mm_ep,
                                  const ds::imu_intrinsic& accel,
                                  const ds::imu_intrinsic& gyro,
-                                 std::shared_ptr<librealsense::lazy<rs2_extrinsics>> depth_to_imu,
-                                 on_before_frame_callback frame_callback,
+                                 const float3x3& imu_to_depth_rotation,
                                  const option_range& opt_range);
 
     private:
+        // Correction and axes alignment of a stream folded into a single step, xyz = transform * xyz + offset
+        struct imu_transform
+        {
+            float3x3 transform;
+            float3   offset;
+        };
+
+        static imu_transform fold(const float3x3& rotation, const ds::imu_intrinsic& intrinsic)
+        {
+            return{ rotation * intrinsic.sensitivity, float3{ 0, 0, 0 } - rotation * intrinsic.bias };
+        }
+
         std::atomic<bool>   _is_enabled;
-        ds::imu_intrinsic   _accel;
-        ds::imu_intrinsic   _gyro;
-        rs2_extrinsics      _depth_to_imu;
+        imu_transform       _accel;
+        imu_transform       _gyro;
+        imu_transform       _aligned; // Axes alignment only, when the correction is disabled
     };
 
     class enable_auto_exposure_option : public option_base
@@ -157,6 +168,52 @@ namespace librealsense
         std::shared_ptr<auto_exposure_mechanism>    _auto_exposure;
     };
 
+    class auto_exposure_sample_stride_option : public option_base
+    {
+    public:
+        auto_exposure_sample_stride_option(std::shared_ptr<auto_exposure_mechanism> auto_exposure,
+                                           std::shared_ptr<auto_exposure_state> auto_exposure_state,
+                                           const option_range& opt_range);
+
+        void set(float value) override;
+
+        float query() const override;
+
+        bool is_enabled() const override { return true; }
+
+        const char* get_description() const override
+        {
+            return "Auto-Exposure histogram sampling step along both image axes";
+        }
+
+    private:
+        std::shared_ptr<auto_exposure_state>        _auto_exposure_state;
+        std::shared_ptr<auto_exposure_mechanism>    _auto_exposure;
+    };
+
+    class auto_exposure_skip_frames_option : public option_base
+    {
+    public:
+        auto_exposure_skip_frames_option(std::shared_ptr<auto_exposure_mechanism> auto_exposure,
+                                         std::shared_ptr<auto_exposure_state> auto_exposure_state,
+                                         const option_range& opt_range);
+
+        void set(float value) override;
+
+        float query() const override;
+
+        bool is_enabled() const override { return true; }
+
+        const char* get_description() const override
+        {
+            return "Number of frames Auto-Exposure skips between two analyzed frames";
+        }
+
+    private:
+        std::shared_ptr<auto_exposure_state>        _auto_exposure_state;
+        std::shared_ptr<auto_exposure_mechanism>    _auto_exposure;
+    };
+
     class auto_exposure_antiflicker_rate_option : public option_base
     {
     public:
@@ -5,9 +5,40 @@
 
 namespace librealsense
 {
+    // Incremented on every change of any graph, which invalidates the extrinsics the threads cached
+    static std::atomic<uint64_t> graph_generation(0);
+
+    // The extrinsics a thread fetched, kept per thread so that a hit takes no lock. An entry is used while no graph
+    // changed and its streams and the edges of its path are alive, the address of a live stream is its own
+    struct cached_extrinsics
+    {
+        std::weak_ptr<const stream_interface> from, to;
+        std::vector<std::weak_ptr<lazy<rs2_extrinsics>>> path;
+        rs2_extrinsics extrinsics;
+    };
+
+    struct extrinsics_cache
+    {
+        uint64_t generation = 0;
+        std::map<std::tuple<const extrinsics_graph*, const stream_interface*, const stream_interface*>, cached_extrinsics> entries;
+    };
+
+    static extrinsics_cache& thread_extrinsics_cache()
+    {
+        static thread_local extrinsics_cache cache;
+        auto generation = graph_generation.load(std::memory_order_acquire);
+        if (cache.generation != generation)
+        {
+            cache.entries.clear();
+            cache.generation = generation;
+        }
+        return cache;
+    }
+
     extrinsics_graph::extrinsics_graph()
         : _locks_count(0)
     {
+        graph_generation.fetch_add(1);
         _id = std::make_shared<lazy<rs2_extrinsics>>([]()
         {
             return identity_matrix();
@@ -43,6 +74,7 @@ namespace librealsense
 
         _extrinsics[from_idx][to_idx] = extr;
         _extrinsics[to_idx][from_idx] = std::shared_ptr<lazy<rs2_extrinsics>>(nullptr);
+        graph_generation.fetch_add(1);
     }
 
     void extrinsics_graph::register_extrinsics(const stream_interface & from, const stream_interface & to, rs2_extrinsics extr)
@@ -70,6 +102,9 @@ namespace librealsense
             }
         }
 
+        if (!invalid_ids.empty())
+            graph_generation.fetch_add(1);
+
         for (auto dead_id : invalid_ids)
         {
             _streams.erase(dead_id);
@@ -102,6 +137,21 @@ namespace librealsense
 
     bool extrinsics_graph::try_fetch_extrinsics(const stream_interface& from, const stream_interface& to, rs2_extrinsics* extr)
     {
+        auto& cache = thread_extrinsics_cache();
+        auto key = std::make_tuple(static_cast<const extrinsics_graph*>(this), &from, &to);
+        auto it = cache.entries.find(key);
+        if (it != cache.entries.end())
+        {
+            auto& entry = it->second;
+            auto expired = [](const std::weak_ptr<lazy<rs2_extrinsics>>& edge) { return edge.expired(); };
+            if (!entry.from.expired() && !entry.to.expired() && std::none_of(entry.path.begin(), entry.path.end(), expired))
+            {
+                *extr = entry.extrinsics;
+                return true;
+            }
+            cache.entries.erase(it);
+        }
+
         std::lock_guard<std::mutex> lock(_mutex);
         cleanup_extrinsics();
         auto from_idx = find_stream_profile(from);
@@ -114,10 +164,15 @@ namespace librealsense
         }
 
         std::set<int> visited;
-        return try_fetch_extrinsics(from_idx, to_idx, visited, extr);
+        extrinsics_path path;
+        if (!try_fetch_extrinsics(from_idx, to_idx, visited, extr, path))
+            return false;
+
+        cache.entries[key] = { from.shared_from_this(), to.shared_from_this(), std::move(path), *extr };
+        return true;
     }
 
-    bool extrinsics_graph::try_fetch_extrinsics(int from, int to, std::set<int>& visited, rs2_extrinsics* extr)
+    bool extrinsics_graph::try_fetch_extrinsics(int from, int to, std::set<int>& visited, rs2_extrinsics* extr, extrinsics_path& path)
     {
         if (visited.count(from)) return false;
 
@@ -135,6 +190,7 @@ namespace librealsense
                 else
                     *extr = inverse(back_edge->operator*());
 
+                path.push_back(fwd_edge.get() ? fwd_edge : back_edge);
                 return true;
             }
             else
@@ -150,7 +206,7 @@ namespace librealsense
                     fwd_edge = fetch_edge(from, new_from);
 
                     if ((back_edge.get() || fwd_edge.get()) &&
-                        try_fetch_extrinsics(new_from, to, visited, extr))
+                        try_fetch_extrinsics(new_from, to, visited, extr, path))
                     {
                         const auto local = [&]() {
                             if (fwd_edge.get())
@@ -161,6 +217,7 @@ namespace librealsense
 
                         auto pose = to_pose(local) * to_pose(*extr);
                         *extr = from_pose(pose);
+                        path.push_back(fwd_edge.get() ? fwd_edge : back_edge);
                         return true;
                     }
                 }
@@ -44,8 +44,10 @@ namespace librealsense
         extrinsics_lock lock();
 
     private:
+        typedef std::vector<std::weak_ptr<lazy<rs2_extrinsics>>> extrinsics_path;
+
         std::shared_ptr<lazy<rs2_extrinsics>> fetch_edge(int from, int to);
-        bool try_fetch_extrinsics(int from, int to, std::set<int>& visited, rs2_extrinsics* extr);
+        bool try_fetch_extrinsics(int from, int to, std::set<int>& visited, rs2_extrinsics* extr, extrinsics_path& path);
         void cleanup_extrinsics();
         int find_stream_profile(const stream_interface& p);
 
@@ -1,17 +1,154 @@
 #include "error-handling.h"
 
 #include <memory>
+#include <thread>
+#include <condition_variable>
+#include <algorithm>
 
 
 namespace librealsense
 {
+    // Reads the error controls of all the devices from a single thread, each one at its own pace.
+    // The scheduler is created with the first started handler, and stopped with the last
+    class polling_scheduler
+    {
+        typedef std::chrono::steady_clock clock;
+
+    public:
+        static std::shared_ptr<polling_scheduler> acquire()
+        {
+            std::lock_guard<std::mutex> lock(instance_mutex());
+            auto scheduler = instance().lock();
+            if (!scheduler)
+            {
+                scheduler = std::make_shared<polling_scheduler>();
+                instance() = scheduler;
+            }
+            return scheduler;
+        }
+
+        static std::shared_ptr<polling_scheduler> current()
+        {
+            std::lock_guard<std::mutex> lock(instance_mutex());
+            return instance().lock();
+        }
+
+        polling_scheduler()
+            : _thread([this]() { run(); })
+        {
+        }
+
+        ~polling_scheduler()
+        {
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _stopping = true;
+            }
+            _cv.notify_all();
+            _thread.join();
+        }
+
+        void add(polling_error_handler* handler, std::chrono::milliseconds delay)
+        {
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _due[handler] = clock::now() + delay;
+            }
+            _cv.notify_all();
+        }
+
+        // Returns once a poll of the handler in progress is over
+        void remove(polling_error_handler* handler)
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _due.erase(handler);
+            _cv.wait(lock, [&]() { return _polling != handler; });
+        }
+
+        // Polls the handler as soon as possible. Handlers that were removed are ignored, the handler is only dereferenced
+        // while it is polled, remove() waits for the lock before the handler goes away
+        void wake(polling_error_handler* handler)
+        {
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                if (_polling == handler)
+                {
+                    handler->on_report();
+                    _woken = true;
+                    return;
+                }
+                auto it = _due.find(handler);
+                if (it == _due.end()) return;
+                handler->on_report();
+                it->second = clock::now();
+            }
+            _cv.notify_all();
+        }
+
+    private:
+        static std::mutex& instance_mutex()
+        {
+            static std::mutex mutex;
+            return mutex;
+        }
+
+        static std::weak_ptr<polling_scheduler>& instance()
+        {
+            static std::weak_ptr<polling_scheduler> scheduler;
+            return scheduler;
+        }
+
+        void run()
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            while (!_stopping)
+            {
+                if (_due.empty())
+                {
+                    _cv.wait(lock);
+                    continue;
+                }
+
+                auto next = std::min_element(_due.begin(), _due.end(),
+                    [](const std::pair<polling_error_handler* const, clock::time_point>& a,
+                       const std::pair<polling_error_handler* const, clock::time_point>& b) { return a.second < b.second; });
+                if (next->second > clock::now())
+                {
+                    _cv.wait_until(lock, next->second);
+                    continue;
+                }
+
+                auto handler = next->first;
+                _polling = handler;
+                _woken = false;
+                lock.unlock();
+                auto interval = handler->poll();
+                lock.lock();
+                _polling = nullptr;
+
+                auto it = _due.find(handler);
+                if (it != _due.end())
+                    it->second = _woken ? clock::now() : clock::now() + interval;
+                _cv.notify_all();
+            }
+            LOG_DEBUG("Notification polling loop is being shut-down");
+        }
+
+        std::mutex _mutex;
+        std::condition_variable _cv;
+        std::map<polling_error_handler*, clock::time_point> _due;
+        polling_error_handler* _polling = nullptr;
+        bool _woken = false;
+        bool _stopping = false;
+        std::thread _thread;
+    };
+
     polling_error_handler::polling_error_handler(unsigned int poll_intervals_ms, std::unique_ptr<option> option,
         std::shared_ptr <notifications_processor> processor, std::unique_ptr<notification_decoder> decoder)
-        :_poll_intervals_ms(poll_intervals_ms),
-        _active_object([this](dispatcher::cancellable_timer cancellable_timer)
-        {
-            polling(cancellable_timer);
-        }),
+        :_min_interval(poll_intervals_ms),
+        _max_interval(poll_intervals_ms * 8),
+        _interval(poll_intervals_ms),
+        _reported(false),
         _option(std::move(option)),
         _notifications_processor(processor),
         _decoder(std::move(decoder))
@@ -25,54 +162,84 @@ namespace librealsense
 
     void polling_error_handler::start()
     {
-        _active_object.start();
+        std::lock_guard<std::mutex> lock(_scheduler_mutex);
+        if (_scheduler) return;
+        _interval = _min_interval;
+        _scheduler = polling_scheduler::acquire();
+        _scheduler->add(this, _reported ? _max_interval : _interval);
     }
     void polling_error_handler::stop()
     {
-        _active_object.stop();
+        std::lock_guard<std::mutex> lock(_scheduler_mutex);
+        if (!_scheduler) return;
+        _scheduler->remove(this);
+        _scheduler.reset();
+    }
+
+    void polling_error_handler::set_error_reports(std::function<bool(std::function<void()>)> subscribe)
+    {
+        try
+        {
+            // Reports may arrive after the handler is gone, the scheduler only uses it to look up handlers it still polls.
+            // Polling slows down once a report did arrive, a device may accept the subscription and never report
+            _reported = false;
+            if (!subscribe([this]()
+            {
+                if (auto scheduler = polling_scheduler::current())
+                    scheduler->wake(this);
+            }))
+                LOG_DEBUG("Error reports are not available, polling for errors");
+        }
+        catch (const std::exception& ex)
+        {
+            LOG_WARNING("Error reports are not available, polling for errors: " << ex.what());
+        }
+    }
+
+    void polling_error_handler::on_report()
+    {
+        _reported = true;
     }
 
-    void polling_error_handler::polling(dispatcher::cancellable_timer cancellable_timer)
+    std::chrono::milliseconds polling_error_handler::poll()
     {
-         if (cancellable_timer.try_sleep(_poll_intervals_ms))
-         {
-             try
-             {
-                 auto val = static_cast<uint8_t>(_option->query());
-
-                 if (val != 0 && !_silenced)
-                 {
-                     auto strong = _notifications_processor.lock();
-                     if (strong) strong->raise_notification(_decoder->decode(val));
-
-                     val = static_cast<int>(_option->query());
-                     if (val != 0)
-                     {
-                         // Reading from last-error control is supposed to set it to zero in the firmware
-                         // If this is not happening there is some issue
-                         notification postcondition_failed{
-                             RS2_NOTIFICATION_CATEGORY_HARDWARE_ERROR,
-                             0,
-                             RS2_LOG_SEVERITY_WARN,
-                             "Error polling loop is not behaving as expected!\nThis can indicate an issue with camera firmware or the underlying OS..."
-                         };
-                         if (strong) strong->raise_notification(postcondition_failed);
-                         _silenced = true;
-                     }
-                 }
-             }
-             catch (const std::exception& ex)
-             {
-                 LOG_ERROR("Error during polling error handler: " << ex.what());
-             }
-             catch (...)
-             {
-                 LOG_ERROR("Unknown error during polling error handler!");
-             }
-         }
-         else
-         {
-             LOG_DEBUG("Notification polling loop is being shut-down");
-         }
+        try
+        {
+            auto val = static_cast<uint8_t>(_option->query());
+            auto error = val != 0;
+
+            if (error && !_silenced)
+            {
+                auto strong = _notifications_processor.lock();
+                if (strong) strong->raise_notification(_decoder->decode(val));
+
+                val = static_cast<int>(_option->query());
+                if (val != 0)
+                {
+                    // Reading from last-error control is supposed to set it to zero in the firmware
+                    // If this is not happening there is some issue
+                    notification postcondition_failed{
+                        RS2_NOTIFICATION_CATEGORY_HARDWARE_ERROR,
+                        0,
+                        RS2_LOG_SEVERITY_WARN,
+                        "Error polling loop is not behaving as expected!\nThis can indicate an issue with camera firmware or the underlying OS..."
+                    };
+                    if (strong) strong->raise_notification(postcondition_failed);
+                    _silenced = true;
+                }
+            }
+
+            // Errors come in bursts: polling is back to its shortest interval after one, and slows down while there are none
+            _interval = error ? _min_interval : std::min(_interval * 2, _max_interval);
+        }
+        catch (const std::exception& ex)
+        {
+            LOG_ERROR("Error during polling error handler: " << ex.what());
+        }
+        catch (...)
+        {
+            LOG_ERROR("Unknown error during polling error handler!");
+        }
+        return _reported ? _max_interval : _interval;
     }
 }
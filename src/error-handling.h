@@ -6,6 +6,8 @@
 
 namespace librealsense
 {
+    class polling_scheduler;
+
     class polling_error_handler
     {
     public:
@@ -16,15 +18,28 @@ namespace librealsense
         void start();
         void stop();
 
+        // Lets the device tell when the error control changed, it's then read on every report and, once a report arrived, otherwise polled
+        // at the longest interval. The subscription is handed the callback to invoke on a report, and returns false if the device can't report errors
+        void set_error_reports(std::function<bool(std::function<void()>)> subscribe);
+
+        // Reads the error control, returning the time until it should be read again
+        std::chrono::milliseconds poll();
+
     private:
-        void polling(dispatcher::cancellable_timer cancellable_timer);
+        friend class polling_scheduler;
+        // Called by the scheduler for a report of the device, while the handler is known to be alive
+        void on_report();
 
-        unsigned int _poll_intervals_ms;
+        std::chrono::milliseconds _min_interval;
+        std::chrono::milliseconds _max_interval;
+        std::chrono::milliseconds _interval;
         bool _silenced = false;
+        std::atomic<bool> _reported;    // A report of the device arrived
         std::unique_ptr<option> _option;
-        active_object<> _active_object;
         std::weak_ptr<notifications_processor> _notifications_processor;
         std::unique_ptr<notification_decoder> _decoder;
+        std::mutex _scheduler_mutex;
+        std::shared_ptr<polling_scheduler> _scheduler; // Held while polling is started
     };
 
 }
@@ -0,0 +1,255 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#include "frame-control-queue.h"
+#include "archive.h"
+
+#include <cmath>
+
+namespace librealsense
+{
+    frame_control_queue::frame_control_queue(options_interface& options, roi_sensor_interface* roi)
+        : _options(options), _roi(roi), _writer(64)
+    {
+        _writer.start();
+    }
+
+    void frame_control_queue::stop()
+    {
+        _writer.stop();
+    }
+
+    void frame_control_queue::queue_option(rs2_option id, float value, unsigned long long frame_number)
+    {
+        auto& opt = _options.get_option(id);
+        if (opt.is_read_only())
+            throw invalid_value_exception(to_string() << "Option " << rs2_option_to_string(id) << " is read-only!");
+
+        auto c = std::make_shared<control>();
+        c->option = id;
+        c->value = value;
+        c->target = frame_number;
+
+        // The metadata holds the applied value, rounded by the device: a step of the option or 1% of the value is tolerated
+        c->confirmed_by_metadata = options_container::get_option_metadata(id, &c->metadata, &c->manual_exposure_only);
+        if (c->confirmed_by_metadata)
+            c->tolerance = std::max(opt.get_range().step, std::abs(value) * 0.01f);
+        queue(c);
+    }
+
+    void frame_control_queue::queue_roi(const region_of_interest& roi, unsigned long long frame_number)
+    {
+        if (!_roi)
+            throw not_implemented_exception("Region-of-interest is not implemented for this sensor!");
+        _roi->get_roi_method(); // Throws if the sensor has no method to set it
+
+        auto c = std::make_shared<control>();
+        c->option = RS2_OPTION_COUNT;
+        c->roi = roi;
+        c->target = frame_number;
+        c->confirmed_by_metadata = false;
+        queue(c);
+    }
+
+    void frame_control_queue::queue(std::shared_ptr<control> c)
+    {
+        c->written_at = 0;
+        c->state = queued;
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        // Kept in target order, a control queued for the same frame as another comes after it and supersedes it
+        auto it = std::find_if(_controls.begin(), _controls.end(),
+            [&c](const std::shared_ptr<control>& other) { return c->target < other->target; });
+        _controls.insert(it, std::move(c));
+    }
+
+    void frame_control_queue::set_callback(status_callback callback)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _callback = std::move(callback);
+    }
+
+    rs2_frame_control_status frame_control_queue::make_status(const control& c, unsigned long long frame, rs2_frame_control_state state)
+    {
+        rs2_frame_control_status status;
+        status.option = c.option;
+        status.value = c.value;
+        status.target_frame = c.target;
+        status.frame = frame;
+        status.state = state;
+        return status;
+    }
+
+    void frame_control_queue::on_frame(const frame_interface& frame)
+    {
+        auto n = static_cast<unsigned long long>(frame.get_frame_number());
+        events reports;
+        std::vector<std::shared_ptr<control>> due;
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            // The frame counter restarts with the stream: what was written is not confirmed, the queued controls wait for their numbers
+            auto restarted = n < _last_frame;
+            _last_frame = n;
+            if (_controls.empty())
+                return;
+
+            auto manual_exposure = false;
+            try
+            {
+                manual_exposure = frame.supports_frame_metadata(RS2_FRAME_METADATA_AUTO_EXPOSURE) &&
+                    frame.get_frame_metadata(RS2_FRAME_METADATA_AUTO_EXPOSURE) == 0;
+            }
+            catch (const std::exception& e)
+            {
+                LOG_DEBUG("Failed to read the auto exposure mode from frame metadata: " << e.what());
+            }
+
+            for (auto it = _controls.begin(); it != _controls.end();)
+            {
+                auto& c = **it;
+                if (restarted && c.state == written)
+                {
+                    reports.push_back(make_status(c, n, RS2_FRAME_CONTROL_STATE_NOT_CONFIRMED));
+                    it = _controls.erase(it);
+                    continue;
+                }
+                if (c.state != written || n <= c.written_at)
+                {
+                    ++it;
+                    continue;
+                }
+
+                auto applied = false;
+                try
+                {
+                    applied = (!c.manual_exposure_only || manual_exposure) && frame.supports_frame_metadata(c.metadata) &&
+                        std::abs(static_cast<float>(frame.get_frame_metadata(c.metadata)) - c.value) <= c.tolerance;
+                }
+                catch (const std::exception& e)
+                {
+                    LOG_DEBUG("Failed to read a frame control from frame metadata: " << e.what());
+                }
+                if (applied)
+                {
+                    // The frames since it was written are the lead the next controls need
+                    _latency = static_cast<int>(std::min<unsigned long long>(n - c.written_at, max_latency));
+                    reports.push_back(make_status(c, n, RS2_FRAME_CONTROL_STATE_APPLIED));
+                    it = _controls.erase(it);
+                    continue;
+                }
+
+                if (n > c.target + confirm_frames)
+                {
+                    reports.push_back(make_status(c, n, RS2_FRAME_CONTROL_STATE_NOT_CONFIRMED));
+                    it = _controls.erase(it);
+                    continue;
+                }
+                ++it;
+            }
+
+            // Controls applied with the frame n + latency are written now, the latest one of each control only
+            for (auto it = _controls.begin(); it != _controls.end() && (*it)->target <= n + _latency;)
+            {
+                auto c = *it;
+                if (c->state != queued)
+                {
+                    ++it;
+                    continue;
+                }
+
+                auto next = std::find_if(std::next(it), _controls.end(), [&](const std::shared_ptr<control>& other)
+                {
+                    return other->option == c->option && other->state == queued && other->target <= n + _latency;
+                });
+                if (next != _controls.end())
+                {
+                    reports.push_back(make_status(*c, n, RS2_FRAME_CONTROL_STATE_SUPERSEDED));
+                    it = _controls.erase(it);
+                    continue;
+                }
+
+                // A value written before and not seen yet in the metadata is replaced as well
+                for (auto&& other : _controls)
+                {
+                    if (other != c && other->option == c->option && (other->state == written || other->state == writing))
+                    {
+                        reports.push_back(make_status(*other, n, RS2_FRAME_CONTROL_STATE_SUPERSEDED));
+                        other->state = dropped;
+                    }
+                }
+
+                c->state = writing;
+                c->written_at = n;
+                due.push_back(c);
+                ++it;
+            }
+            _controls.remove_if([](const std::shared_ptr<control>& c) { return c->state == dropped; });
+        }
+
+        if (!due.empty())
+            _writer.invoke([this, due](dispatcher::cancellable_timer) { write(due); });
+        report(reports);
+    }
+
+    void frame_control_queue::write(const std::vector<std::shared_ptr<control>>& controls)
+    {
+        events reports;
+        for (auto&& c : controls)
+        {
+            auto state = RS2_FRAME_CONTROL_STATE_WRITTEN;
+            try
+            {
+                if (c->option == RS2_OPTION_COUNT)
+                    _roi->get_roi_method().set(c->roi);
+                else
+                    _options.get_option(c->option).set(c->value);
+            }
+            catch (const std::exception& e)
+            {
+                LOG_WARNING("Failed to write a frame control: " << e.what());
+                state = RS2_FRAME_CONTROL_STATE_FAILED;
+            }
+
+            std::lock_guard<std::mutex> lock(_mutex);
+            // Superseded while it was written, it was reported already
+            if (c->state == dropped)
+                continue;
+            // Controls the metadata confirms are reported once they show in a frame
+            if (state == RS2_FRAME_CONTROL_STATE_WRITTEN && c->confirmed_by_metadata)
+            {
+                c->state = written;
+                continue;
+            }
+            reports.push_back(make_status(*c, _last_frame, state));
+            _controls.remove(c);
+        }
+        report(reports);
+    }
+
+    void frame_control_queue::report(const events& reports)
+    {
+        if (reports.empty())
+            return;
+
+        status_callback callback;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            callback = _callback;
+        }
+        if (!callback)
+            return;
+
+        for (auto&& status : reports)
+        {
+            try
+            {
+                callback(status);
+            }
+            catch (...)
+            {
+                LOG_ERROR("Exception in a frame control callback");
+            }
+        }
+    }
+}
@@ -0,0 +1,71 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "core/options.h"
+#include "core/roi.h"
+#include "concurrency.h"
+
+#include <list>
+
+namespace librealsense
+{
+    // Applies option values and regions of interest to given frame numbers. Each control is written ahead of its frame
+    // by the latency the frames showed so far, and confirmed from the frame metadata when the metadata reports it.
+    // Of the values of one control due at the same time only the latest is written, the others are superseded
+    class frame_control_queue
+    {
+    public:
+        typedef std::function<void(const rs2_frame_control_status&)> status_callback;
+
+        // Frames after its target frame within which a control must show in the metadata
+        static const unsigned long long confirm_frames = 15;
+        static const int max_latency = 8;
+
+        frame_control_queue(options_interface& options, roi_sensor_interface* roi);
+
+        void queue_option(rs2_option id, float value, unsigned long long frame_number);
+        void queue_roi(const region_of_interest& roi, unsigned long long frame_number);
+        void set_callback(status_callback callback);
+        // Cancels the writes not started and waits for the one in progress, nothing is written after
+        void stop();
+
+        // Confirms the written controls the frame reports, and writes the controls due before the next frames
+        void on_frame(const frame_interface& frame);
+
+    private:
+        enum control_state { queued, writing, written, dropped };
+
+        struct control
+        {
+            rs2_option option;      // RS2_OPTION_COUNT for the region of interest
+            float value;
+            region_of_interest roi;
+            unsigned long long target;
+            unsigned long long written_at;
+            control_state state;
+            bool confirmed_by_metadata;
+            rs2_frame_metadata_value metadata;
+            bool manual_exposure_only;
+            float tolerance;
+        };
+        typedef std::vector<rs2_frame_control_status> events;
+
+        void queue(std::shared_ptr<control> c);
+        void write(const std::vector<std::shared_ptr<control>>& controls);
+        static rs2_frame_control_status make_status(const control& c, unsigned long long frame, rs2_frame_control_state state);
+        void report(const events& reports);
+
+        options_interface& _options;
+        roi_sensor_interface* _roi;
+
+        std::mutex _mutex;
+        std::list<std::shared_ptr<control>> _controls;
+        unsigned long long _last_frame = 0;
+        int _latency = 2;
+        status_callback _callback;
+
+        dispatcher _writer;
+    };
+}
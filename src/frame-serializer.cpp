@@ -0,0 +1,313 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#include "frame-serializer.h"
+#include "archive.h"
+#include "context.h"
+#include "environment.h"
+#include "software-device.h"
+#include "stream.h"
+
+#include <cstddef>
+#include <cstring>
+#include <limits>
+
+namespace librealsense
+{
+    namespace
+    {
+        template<class T>
+        void append(std::vector<uint8_t>& buffer, const T& value)
+        {
+            auto bytes = reinterpret_cast<const uint8_t*>(&value);
+            buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+        }
+
+        // The frames of the software device have no buffer of their own, their size follows from their content
+        size_t payload_size(frame_interface* frame, rs2_extension extension)
+        {
+            switch (extension)
+            {
+            case RS2_EXTENSION_MOTION_FRAME: return 3 * sizeof(float);
+            case RS2_EXTENSION_POSE_FRAME: return sizeof(rs2_pose);
+            default:
+            {
+                auto video = dynamic_cast<video_frame*>(frame);
+                return video ? size_t(video->get_stride()) * video->get_height() : 0;
+            }
+            }
+        }
+
+        rs2_extension frame_extension(frame_interface* frame)
+        {
+            for (auto extension : { RS2_EXTENSION_DISPARITY_FRAME, RS2_EXTENSION_DEPTH_FRAME, RS2_EXTENSION_VIDEO_FRAME,
+                RS2_EXTENSION_MOTION_FRAME, RS2_EXTENSION_POSE_FRAME })
+            {
+                if (frame->is_extendable_to(extension))
+                    return extension;
+            }
+            throw invalid_value_exception("Only video, depth, motion and pose frames can be serialized");
+        }
+
+        // The size of the frame data a received header describes, which its payload must hold exactly
+        uint64_t expected_payload_size(const wire::frame_header& header)
+        {
+            switch (header.extension)
+            {
+            case RS2_EXTENSION_MOTION_FRAME: return 3 * sizeof(float);
+            case RS2_EXTENSION_POSE_FRAME: return sizeof(rs2_pose);
+            default:
+                if (header.width <= 0 || header.height <= 0 || header.bpp < 0 || header.stride <= 0 ||
+                    int64_t(header.stride) < int64_t(header.width) * header.bpp)
+                    throw invalid_value_exception(to_string() << "Invalid serialized frame of " << header.width << "x" << header.height
+                        << ", stride " << header.stride << " and " << header.bpp << " bytes per pixel");
+                return uint64_t(header.stride) * uint64_t(header.height);
+            }
+        }
+
+        // Whether a header describes frames of the same layout as the first one of its stream
+        bool same_layout(const wire::frame_header& a, const wire::frame_header& b)
+        {
+            return a.extension == b.extension && a.stream_type == b.stream_type && a.stream_index == b.stream_index &&
+                a.format == b.format && a.width == b.width && a.height == b.height && a.stride == b.stride && a.bpp == b.bpp;
+        }
+    }
+
+    const std::vector<rs2_frame_segment>& frame_serializer::serialize(frame_interface* frame)
+    {
+        _headers.clear();
+        _header_ranges.clear();
+        _frames.clear();
+        _segments.clear();
+
+        wire::message_header message{ wire::magic, wire::version, 0 };
+        append(_headers, message);
+
+        if (auto composite = dynamic_cast<composite_frame*>(frame))
+        {
+            for (size_t i = 0; i < composite->get_embedded_frames_count(); ++i)
+                add_frame(composite->get_frame(int(i)));
+        }
+        else
+            add_frame(frame);
+
+        auto count = static_cast<uint16_t>(_frames.size());
+        memcpy(_headers.data() + offsetof(wire::message_header, frame_count), &count, sizeof(count));
+
+        // The headers only stop moving once all of them are written
+        for (size_t i = 0; i < _frames.size(); ++i)
+        {
+            auto begin = _header_ranges[i].first;
+            if (i == 0) begin = 0; // The message header goes with the first frame
+            _segments.push_back({ _headers.data() + begin, _header_ranges[i].first + _header_ranges[i].second - begin });
+
+            auto extension = frame_extension(_frames[i].frame);
+            _segments.push_back({ _frames[i]->get_frame_data(), payload_size(_frames[i].frame, extension) });
+        }
+        return _segments;
+    }
+
+    void frame_serializer::add_frame(frame_interface* frame)
+    {
+        if (_frames.size() == std::numeric_limits<uint16_t>::max())
+            throw invalid_value_exception("Too many frames in the frameset to serialize");
+
+        auto extension = frame_extension(frame);
+        auto profile = frame->get_stream();
+
+        wire::frame_header header{};
+        header.stream_uid = static_cast<uint32_t>(profile->get_unique_id());
+        header.extension = extension;
+        header.stream_type = profile->get_stream_type();
+        header.stream_index = profile->get_stream_index();
+        header.format = profile->get_format();
+        header.fps = static_cast<int32_t>(profile->get_framerate());
+        if (auto video = dynamic_cast<video_frame*>(frame))
+        {
+            header.width = video->get_width();
+            header.height = video->get_height();
+            header.stride = video->get_stride();
+            header.bpp = video->get_bpp() / 8;
+            if (auto video_profile = dynamic_cast<video_stream_profile_interface*>(profile.get()))
+            {
+                try
+                {
+                    header.intrinsics = video_profile->get_intrinsics();
+                }
+                catch (...)
+                {
+                    // Streams without calibration are sent without intrinsics
+                }
+            }
+        }
+        if (auto depth = dynamic_cast<depth_frame*>(frame))
+        {
+            try
+            {
+                header.depth_units = depth->get_units();
+            }
+            catch (...)
+            {
+            }
+        }
+        header.timestamp = frame->get_frame_timestamp();
+        header.timestamp_domain = frame->get_frame_timestamp_domain();
+        header.frame_number = frame->get_frame_number();
+        header.payload_size = payload_size(frame, extension);
+
+        std::vector<wire::metadata_entry> metadata;
+        for (int i = 0; i < RS2_FRAME_METADATA_COUNT; ++i)
+        {
+            auto key = static_cast<rs2_frame_metadata_value>(i);
+            if (frame->supports_frame_metadata(key))
+                metadata.push_back({ i, frame->get_frame_metadata(key) });
+        }
+        header.metadata_count = static_cast<uint32_t>(metadata.size());
+
+        auto offset = _headers.size();
+        append(_headers, header);
+        for (auto&& entry : metadata)
+            append(_headers, entry);
+        _header_ranges.emplace_back(offset, _headers.size() - offset);
+
+        frame->acquire();
+        _frames.push_back(frame_holder(frame));
+    }
+
+    frame_deserializer::frame_deserializer(std::shared_ptr<software_device> device, frame_callback_ptr callback)
+        : _device(std::move(device)), _callback(std::move(callback))
+    {
+    }
+
+    frame_deserializer::~frame_deserializer()
+    {
+        for (auto&& stream : _streams)
+        {
+            try
+            {
+                stream.second.sensor->stop();
+                stream.second.sensor->close();
+            }
+            catch (const std::exception& e)
+            {
+                LOG_WARNING("Failed to stop the sensor of a deserialized stream: " << e.what());
+            }
+        }
+    }
+
+    void frame_deserializer::deserialize(const void* message, size_t size)
+    {
+        auto data = static_cast<const uint8_t*>(message);
+        auto end = data + size;
+
+        wire::message_header message_header;
+        if (size < sizeof(message_header))
+            throw invalid_value_exception("Serialized frame message is truncated");
+        memcpy(&message_header, data, sizeof(message_header));
+        if (message_header.magic != wire::magic)
+            throw invalid_value_exception("Not a serialized frame message, or one of another byte order");
+        if (message_header.version != wire::version)
+            throw invalid_value_exception(to_string() << "Unsupported serialized frame version " << message_header.version);
+        data += sizeof(message_header);
+
+        for (int i = 0; i < message_header.frame_count; ++i)
+        {
+            wire::frame_header header;
+            if (size_t(end - data) < sizeof(header))
+                throw invalid_value_exception("Serialized frame message is truncated");
+            memcpy(&header, data, sizeof(header));
+            data += sizeof(header);
+
+            auto metadata_size = size_t(header.metadata_count) * sizeof(wire::metadata_entry);
+            if (header.metadata_count > RS2_FRAME_METADATA_COUNT || size_t(end - data) < metadata_size ||
+                size_t(end - data) - metadata_size < header.payload_size)
+                throw invalid_value_exception("Serialized frame message is truncated");
+            if (header.payload_size != expected_payload_size(header))
+                throw invalid_value_exception(to_string() << "Serialized frame payload of " << header.payload_size
+                    << " bytes does not match its header");
+
+            std::vector<wire::metadata_entry> metadata(header.metadata_count);
+            if (metadata_size)
+                memcpy(metadata.data(), data, metadata_size);
+            data += metadata_size;
+
+            inject(get_stream(header), header, metadata.data(), data);
+            data += header.payload_size;
+        }
+    }
+
+    frame_deserializer::stream_entry& frame_deserializer::get_stream(const wire::frame_header& header)
+    {
+        auto it = _streams.find(header.stream_uid);
+        if (it != _streams.end())
+        {
+            if (!same_layout(it->second.header, header))
+                throw invalid_value_exception(to_string() << "Serialized frame of stream " << header.stream_uid
+                    << " does not match the type, format or size of the first frame of the stream");
+            return it->second;
+        }
+
+        auto type = static_cast<rs2_stream>(header.stream_type);
+        auto format = static_cast<rs2_format>(header.format);
+        auto uid = environment::get_instance().generate_stream_id();
+        auto& sensor = _device->add_software_sensor(to_string() << get_string(type) << " " << header.stream_index);
+
+        std::shared_ptr<stream_profile_interface> profile;
+        switch (header.extension)
+        {
+        case RS2_EXTENSION_MOTION_FRAME:
+            profile = sensor.add_motion_stream({ type, header.stream_index, uid, header.fps, format, {} });
+            break;
+        case RS2_EXTENSION_POSE_FRAME:
+            profile = sensor.add_pose_stream({ type, header.stream_index, uid, header.fps, format });
+            break;
+        case RS2_EXTENSION_VIDEO_FRAME:
+        case RS2_EXTENSION_DEPTH_FRAME:
+        case RS2_EXTENSION_DISPARITY_FRAME:
+            profile = sensor.add_video_stream({ type, header.stream_index, uid, header.width, header.height,
+                header.fps, header.bpp, format, header.intrinsics });
+            break;
+        default:
+            throw invalid_value_exception(to_string() << "Unsupported serialized frame type " << header.extension);
+        }
+        if (header.depth_units > 0.f)
+            sensor.add_read_only_option(RS2_OPTION_DEPTH_UNITS, header.depth_units);
+
+        sensor.open({ profile });
+        sensor.start(_callback);
+        return _streams[header.stream_uid] = { &sensor, profile, header };
+    }
+
+    void frame_deserializer::inject(const stream_entry& stream, const wire::frame_header& header,
+        const wire::metadata_entry* metadata, const uint8_t* payload)
+    {
+        std::vector<rs2_frame_metadata_value> keys(header.metadata_count);
+        std::vector<rs2_metadata_type> values(header.metadata_count);
+        for (uint32_t i = 0; i < header.metadata_count; ++i)
+        {
+            keys[i] = static_cast<rs2_frame_metadata_value>(metadata[i].key);
+            values[i] = metadata[i].value;
+        }
+        stream.sensor->set_metadata(keys.data(), values.data(), keys.size());
+
+        auto buffer = new uint8_t[header.payload_size];
+        memcpy(buffer, payload, header.payload_size);
+        auto deleter = [](void* p) { delete[] static_cast<uint8_t*>(p); };
+        rs2_stream_profile profile{ stream.profile.get(), stream.profile };
+        auto domain = static_cast<rs2_timestamp_domain>(header.timestamp_domain);
+        auto number = static_cast<int>(header.frame_number);
+
+        switch (header.extension)
+        {
+        case RS2_EXTENSION_MOTION_FRAME:
+            stream.sensor->on_motion_frame({ buffer, deleter, header.timestamp, domain, number, &profile });
+            break;
+        case RS2_EXTENSION_POSE_FRAME:
+            stream.sensor->on_pose_frame({ buffer, deleter, header.timestamp, domain, number, &profile });
+            break;
+        default:
+            stream.sensor->on_video_frame({ buffer, deleter, header.stride, header.bpp, header.timestamp, domain, number, &profile });
+            break;
+        }
+    }
+}
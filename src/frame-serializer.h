@@ -0,0 +1,107 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "types.h"
+#include "core/streaming.h"
+
+#include <map>
+#include <vector>
+
+namespace librealsense
+{
+    class software_device;
+    class software_sensor;
+
+    // Wire format of serialized frames, in the byte order of the sender, receivers of the other byte order reject
+    // the messages by their magic. A message is a message_header followed by frame_count frames, a frame being a
+    // frame_header, metadata_count metadata_entry and payload_size bytes of frame data
+    namespace wire
+    {
+        const uint32_t magic = 0x31465352; // "RSF1"
+        const uint16_t version = 1;
+
+#pragma pack(push, 1)
+        struct message_header
+        {
+            uint32_t magic;
+            uint16_t version;
+            uint16_t frame_count;
+        };
+
+        struct frame_header
+        {
+            uint32_t stream_uid;    // Unique id of the stream on the sender, to tell the streams apart
+            int32_t extension;      // RS2_EXTENSION_VIDEO_FRAME, DEPTH_FRAME, DISPARITY_FRAME, MOTION_FRAME or POSE_FRAME
+            int32_t stream_type;
+            int32_t stream_index;
+            int32_t format;
+            int32_t fps;
+            int32_t width;
+            int32_t height;
+            int32_t stride;
+            int32_t bpp;            // Bytes per pixel
+            rs2_intrinsics intrinsics;
+            float depth_units;
+            double timestamp;
+            int32_t timestamp_domain;
+            uint64_t frame_number;
+            uint32_t metadata_count;
+            uint64_t payload_size;
+        };
+
+        struct metadata_entry
+        {
+            int32_t key;
+            int64_t value;
+        };
+#pragma pack(pop)
+    }
+
+    // Turns frames and framesets into the segments of a message: the headers, written by the serializer, and the
+    // payloads, pointing into the frames. Nothing of the frame data is copied, the frames are held until the next call
+    class frame_serializer
+    {
+    public:
+        const std::vector<rs2_frame_segment>& serialize(frame_interface* frame);
+
+    private:
+        void add_frame(frame_interface* frame);
+
+        std::vector<uint8_t> _headers;
+        std::vector<std::pair<size_t, size_t>> _header_ranges; // Offset and size in _headers of the headers of a frame
+        std::vector<frame_holder> _frames;
+        std::vector<rs2_frame_segment> _segments;
+    };
+
+    // Injects the frames of messages into a software device, one sensor per stream of the sender, created and
+    // started with the callback on the first frame of the stream. The frames of a frameset arrive one by one, and
+    // the depth units and intrinsics of a stream are the ones of its first frame. Payloads of another size than the
+    // header describes, and frames of a stream whose layout changed, are rejected
+    class frame_deserializer
+    {
+    public:
+        frame_deserializer(std::shared_ptr<software_device> device, frame_callback_ptr callback);
+        ~frame_deserializer();
+
+        // The payloads are copied out of the message, which the caller can reuse once the call returns
+        void deserialize(const void* message, size_t size);
+
+    private:
+        struct stream_entry
+        {
+            software_sensor* sensor;
+            std::shared_ptr<stream_profile_interface> profile;
+            wire::frame_header header; // Of the first frame, the later ones must have the same layout
+        };
+
+        stream_entry& get_stream(const wire::frame_header& header);
+        void inject(const stream_entry& stream, const wire::frame_header& header,
+            const wire::metadata_entry* metadata, const uint8_t* payload);
+
+        std::shared_ptr<software_device> _device;
+        frame_callback_ptr _callback;
+        std::map<uint32_t, stream_entry> _streams;
+    };
+}
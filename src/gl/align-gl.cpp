@@ -0,0 +1,182 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+#ifdef RS2_USE_GLSL
+
+#include "align-gl.h"
+#include "core/streaming.h"
+
+namespace librealsense
+{
+    namespace
+    {
+        const int group_size = 16;
+        const int pack_group_size = 256;
+        const GLuint no_depth = 0xFFFFFFFF;
+
+        // One invocation per depth pixel, projecting its corners on the other image like align_images does.
+        // The nearest depth of every pixel of the other image is kept with an atomic minimum
+        const char* project_shader =
+            "layout(local_size_x = 16, local_size_y = 16) in;\n"
+            "\n"
+            "layout(std430, binding = 0) readonly buffer depth_buffer { uint depth[]; };\n"
+            "layout(std430, binding = 1) buffer nearest_buffer { uint nearest[]; };\n"
+            "\n"
+            "uniform float depth_units;\n"
+            "uniform mat3 rotation;\n"
+            "uniform vec3 translation;\n"
+            "\n"
+            "ivec2 project_corner(vec2 corner, float z)\n"
+            "{\n"
+            "    vec3 ray = rotation * deproject(corner, 1.0, depth_lens, depth_model, depth_coeffs);\n"
+            "    return ivec2(project(z * ray + translation, other_lens, other_model, other_coeffs) + 0.5);\n"
+            "}\n"
+            "\n"
+            "void main()\n"
+            "{\n"
+            "    ivec2 pixel = ivec2(gl_GlobalInvocationID.xy);\n"
+            "    if (pixel.x >= depth_size.x || pixel.y >= depth_size.y)\n"
+            "        return;\n"
+            "\n"
+            "    uint i = uint(pixel.y * depth_size.x + pixel.x);\n"
+            "    uint value = (depth[i >> 1] >> ((i & 1u) * 16u)) & 0xFFFFu;\n"
+            "    if (value == 0u)\n"
+            "        return;\n"
+            "\n"
+            "    float z = float(value) * depth_units;\n"
+            "    ivec2 top_left = project_corner(vec2(pixel) - 0.5, z);\n"
+            "    ivec2 bottom_right = project_corner(vec2(pixel) + 0.5, z);\n"
+            "    if (top_left.x < 0 || top_left.y < 0 || bottom_right.x >= other_size.x || bottom_right.y >= other_size.y)\n"
+            "        return;\n"
+            "\n"
+            "    for (int y = top_left.y; y <= bottom_right.y; ++y)\n"
+            "        for (int x = top_left.x; x <= bottom_right.x; ++x)\n"
+            "            atomicMin(nearest[y * other_size.x + x], value);\n"
+            "}\n";
+
+        // Packs the nearest depths into the Z16 pixels of the aligned frame, two per invocation
+        const char* pack_shader =
+            "#version 430\n"
+            "layout(local_size_x = 256) in;\n"
+            "\n"
+            "layout(std430, binding = 0) readonly buffer nearest_buffer { uint nearest[]; };\n"
+            "layout(std430, binding = 1) writeonly buffer aligned_buffer { uint aligned[]; };\n"
+            "\n"
+            "uniform uint words;\n"
+            "\n"
+            "void main()\n"
+            "{\n"
+            "    uint i = gl_GlobalInvocationID.x;\n"
+            "    if (i >= words)\n"
+            "        return;\n"
+            "\n"
+            "    uint first = nearest[i * 2u], second = nearest[i * 2u + 1u];\n"
+            "    aligned[i] = (first == 0xFFFFFFFFu ? 0u : first) | ((second == 0xFFFFFFFFu ? 0u : second) << 16);\n"
+            "}\n";
+    }
+
+    align_gl::align_gl(rs2_stream to_stream)
+        : align(to_stream), _context(gl::gl_context::acquire())
+    {
+    }
+
+    align_gl::~align_gl()
+    {
+        auto project_program = _project_program;
+        auto pack_program = _pack_program;
+        _context->post([project_program, pack_program](const gl::gl_functions& gl)
+        {
+            if (project_program) gl.delete_program(project_program);
+            if (pack_program) gl.delete_program(pack_program);
+        });
+    }
+
+    void align_gl::align_frames(const rs2::video_frame& aligned, const rs2::video_frame& from, const rs2::video_frame& to)
+    {
+        if (to.get_profile().stream_type() == RS2_STREAM_DEPTH)
+        {
+            align::align_frames(aligned, from, to);
+            return;
+        }
+
+        auto depth_profile = from.get_profile().as<rs2::video_stream_profile>();
+        auto other_profile = to.get_profile().as<rs2::video_stream_profile>();
+
+        auto z_intrin = depth_profile.get_intrinsics();
+        auto other_intrin = other_profile.get_intrinsics();
+        auto z_to_other = depth_profile.get_extrinsics_to(other_profile);
+
+        // The packing writes two pixels per word
+        const size_t depth_pixels = size_t(z_intrin.width) * z_intrin.height;
+        const size_t other_pixels = size_t(other_intrin.width) * other_intrin.height;
+        if (!gl::can_deproject(z_intrin) || !gl::can_project(other_intrin) || other_pixels % 2 ||
+            aligned.get_stride_in_bytes() != other_intrin.width * int(sizeof(uint16_t)))
+        {
+            align::align_frames(aligned, from, to);
+            return;
+        }
+
+        auto depth_memory = std::dynamic_pointer_cast<gl::gl_buffer>(((frame_interface*)from.get())->get_device_memory());
+        if (depth_memory && depth_memory->size() < depth_pixels * sizeof(uint16_t))
+            depth_memory.reset();
+        const void* depth_data = depth_memory ? nullptr : from.get_data();
+        const size_t staging_size = (depth_pixels * sizeof(uint16_t) + 3) & ~size_t(3);
+
+        std::shared_ptr<gl::gl_buffer> out;
+        _context->invoke([&](const gl::gl_functions& gl)
+        {
+            if (!_project_program)
+            {
+                _project_program = gl::compile_compute_program(gl, ("#version 430\n" + gl::camera_model_source() +
+                    gl::intrinsics_uniforms("depth") + gl::intrinsics_uniforms("other") + project_shader).c_str());
+                _pack_program = gl::compile_compute_program(gl, pack_shader);
+            }
+
+            GLuint input;
+            if (depth_memory)
+                input = depth_memory->id();
+            else
+            {
+                if (!_staging || _staging->size() != staging_size)
+                    _staging = _context->alloc_buffer(gl, staging_size);
+                gl.bind_buffer(GL_SHADER_STORAGE_BUFFER, _staging->id());
+                gl.buffer_sub_data(GL_SHADER_STORAGE_BUFFER, 0, depth_pixels * sizeof(uint16_t), depth_data);
+                gl.bind_buffer(GL_SHADER_STORAGE_BUFFER, 0);
+                input = _staging->id();
+            }
+
+            if (!_nearest || _nearest->size() != other_pixels * sizeof(GLuint))
+                _nearest = _context->alloc_buffer(gl, other_pixels * sizeof(GLuint));
+            gl.bind_buffer(GL_SHADER_STORAGE_BUFFER, _nearest->id());
+            gl.clear_buffer_data(GL_SHADER_STORAGE_BUFFER, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, &no_depth);
+            gl.bind_buffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+            gl.use_program(_project_program);
+            gl::set_intrinsics(gl, _project_program, "depth", z_intrin);
+            gl::set_intrinsics(gl, _project_program, "other", other_intrin);
+            gl::set_extrinsics(gl, _project_program, z_to_other);
+            gl.uniform1f(gl.get_uniform_location(_project_program, "depth_units"), _depth_scale);
+            gl.bind_buffer_base(GL_SHADER_STORAGE_BUFFER, 0, input);
+            gl.bind_buffer_base(GL_SHADER_STORAGE_BUFFER, 1, _nearest->id());
+            gl.dispatch_compute((z_intrin.width + group_size - 1) / group_size, (z_intrin.height + group_size - 1) / group_size, 1);
+            gl.memory_barrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+            out = _context->alloc_buffer(gl, other_pixels * sizeof(uint16_t));
+            auto words = GLuint(other_pixels / 2);
+            gl.use_program(_pack_program);
+            gl.uniform1ui(gl.get_uniform_location(_pack_program, "words"), words);
+            gl.bind_buffer_base(GL_SHADER_STORAGE_BUFFER, 0, _nearest->id());
+            gl.bind_buffer_base(GL_SHADER_STORAGE_BUFFER, 1, out->id());
+            gl.dispatch_compute((words + pack_group_size - 1) / pack_group_size, 1, 1);
+            gl.memory_barrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
+
+            gl.bind_buffer_base(GL_SHADER_STORAGE_BUFFER, 0, 0);
+            gl.bind_buffer_base(GL_SHADER_STORAGE_BUFFER, 1, 0);
+            gl.use_program(0);
+            // Starts the dispatches without waiting for them, the readback waits when the aligned depth is read
+            glFlush();
+        });
+
+        ((frame_interface*)aligned.get())->attach_device_memory(out, true);
+    }
+}
+#endif // RS2_USE_GLSL
@@ -0,0 +1,30 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+#pragma once
+#ifdef RS2_USE_GLSL
+
+#include "proc/align.h"
+#include "gl-context.h"
+
+namespace librealsense
+{
+    // Aligns depth to the other stream in compute shaders, into a GL buffer attached to the aligned frame,
+    // so a GL pointcloud that follows reads it in place. Other streams aligned to depth use the host implementation
+    class align_gl : public align
+    {
+    public:
+        align_gl(rs2_stream to_stream);
+        ~align_gl();
+
+    protected:
+        void align_frames(const rs2::video_frame& aligned, const rs2::video_frame& from, const rs2::video_frame& to) override;
+
+    private:
+        std::shared_ptr<gl::gl_context> _context;
+        GLuint _project_program = 0;
+        GLuint _pack_program = 0;
+        std::shared_ptr<gl::gl_buffer> _staging;
+        std::shared_ptr<gl::gl_buffer> _nearest;
+    };
+}
+#endif // RS2_USE_GLSL
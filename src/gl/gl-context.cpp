@@ -0,0 +1,388 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+#ifdef RS2_USE_GLSL
+
+#include "gl-context.h"
+#include "../types.h"
+
+#include <vector>
+
+namespace librealsense
+{
+    namespace gl
+    {
+        namespace
+        {
+            // Enough to cover the frames of a few streams in flight through a processing chain
+            const size_t max_pooled_buffers = 32;
+
+            template<class T>
+            bool load_function(T& f, const char* name)
+            {
+                f = reinterpret_cast<T>(glfwGetProcAddress(name));
+                return f != nullptr;
+            }
+        }
+
+        bool gl_functions::load()
+        {
+            bool ok = true;
+            ok &= load_function(gen_buffers, "glGenBuffers");
+            ok &= load_function(delete_buffers, "glDeleteBuffers");
+            ok &= load_function(bind_buffer, "glBindBuffer");
+            ok &= load_function(bind_buffer_base, "glBindBufferBase");
+            ok &= load_function(buffer_data, "glBufferData");
+            ok &= load_function(buffer_sub_data, "glBufferSubData");
+            ok &= load_function(get_buffer_sub_data, "glGetBufferSubData");
+            ok &= load_function(clear_buffer_data, "glClearBufferData");
+
+            ok &= load_function(create_shader, "glCreateShader");
+            ok &= load_function(shader_source, "glShaderSource");
+            ok &= load_function(compile_shader, "glCompileShader");
+            ok &= load_function(get_shader_iv, "glGetShaderiv");
+            ok &= load_function(get_shader_info_log, "glGetShaderInfoLog");
+            ok &= load_function(delete_shader, "glDeleteShader");
+            ok &= load_function(create_program, "glCreateProgram");
+            ok &= load_function(attach_shader, "glAttachShader");
+            ok &= load_function(link_program, "glLinkProgram");
+            ok &= load_function(get_program_iv, "glGetProgramiv");
+            ok &= load_function(get_program_info_log, "glGetProgramInfoLog");
+            ok &= load_function(use_program, "glUseProgram");
+            ok &= load_function(delete_program, "glDeleteProgram");
+
+            ok &= load_function(get_uniform_location, "glGetUniformLocation");
+            ok &= load_function(uniform1i, "glUniform1i");
+            ok &= load_function(uniform2i, "glUniform2i");
+            ok &= load_function(uniform1ui, "glUniform1ui");
+            ok &= load_function(uniform1f, "glUniform1f");
+            ok &= load_function(uniform3f, "glUniform3f");
+            ok &= load_function(uniform4f, "glUniform4f");
+            ok &= load_function(uniform1fv, "glUniform1fv");
+            ok &= load_function(uniform_matrix3fv, "glUniformMatrix3fv");
+
+            ok &= load_function(dispatch_compute, "glDispatchCompute");
+            ok &= load_function(memory_barrier, "glMemoryBarrier");
+            return ok;
+        }
+
+        gl_buffer::~gl_buffer()
+        {
+            _context->release_buffer(_id, _size);
+        }
+
+        void gl_buffer::download(void* host) const
+        {
+            auto id = _id;
+            auto size = _size;
+            // Waits for the dispatches that wrote the buffer, the barrier was issued after each of them
+            _context->invoke([id, size, host](const gl_functions& gl)
+            {
+                gl.bind_buffer(GL_SHADER_STORAGE_BUFFER, id);
+                gl.get_buffer_sub_data(GL_SHADER_STORAGE_BUFFER, 0, size, host);
+                gl.bind_buffer(GL_SHADER_STORAGE_BUFFER, 0);
+            });
+        }
+
+        void gl_buffer::upload(const void* host)
+        {
+            auto id = _id;
+            auto size = _size;
+            _context->invoke([id, size, host](const gl_functions& gl)
+            {
+                gl.bind_buffer(GL_SHADER_STORAGE_BUFFER, id);
+                gl.buffer_sub_data(GL_SHADER_STORAGE_BUFFER, 0, size, host);
+                gl.bind_buffer(GL_SHADER_STORAGE_BUFFER, 0);
+            });
+        }
+
+        std::shared_ptr<gl_context> gl_context::acquire()
+        {
+            static std::mutex mutex;
+            static std::weak_ptr<gl_context> instance;
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if (auto context = instance.lock())
+                return context;
+
+            // Applications rendering with GLFW have already initialized it, and keep ownership of its termination
+            if (!glfwInit())
+                throw backend_exception("GLFW could not be initialized for the GL processing blocks", RS2_EXCEPTION_TYPE_BACKEND);
+
+            glfwWindowHint(GLFW_VISIBLE, GL_FALSE);
+            glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+            glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+            glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+            auto window = glfwCreateWindow(1, 1, "librealsense GL processing", nullptr, nullptr);
+            glfwDefaultWindowHints();
+            if (!window)
+                throw backend_exception("The GL processing blocks require an OpenGL 4.3 context", RS2_EXCEPTION_TYPE_BACKEND);
+
+            std::shared_ptr<gl_context> context(new gl_context(window));
+            bool loaded = false;
+            context->invoke([&loaded, &context](const gl_functions&) { loaded = context->_loaded; });
+            if (!loaded)
+                throw backend_exception("The OpenGL context has no compute shaders", RS2_EXCEPTION_TYPE_BACKEND);
+
+            instance = context;
+            return context;
+        }
+
+        bool gl_context::is_available()
+        {
+            try
+            {
+                return acquire() != nullptr;
+            }
+            catch (...)
+            {
+                return false;
+            }
+        }
+
+        gl_context::gl_context(GLFWwindow* window)
+            : _window(window)
+        {
+            _thread = std::thread([this]() { run(); });
+        }
+
+        gl_context::~gl_context()
+        {
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _stopping = true;
+            }
+            _task_available.notify_all();
+            _thread.join();
+
+            glfwDestroyWindow(_window);
+        }
+
+        void gl_context::run()
+        {
+            glfwMakeContextCurrent(_window);
+            _loaded = _gl.load();
+
+            while (true)
+            {
+                task t;
+                {
+                    std::unique_lock<std::mutex> lock(_mutex);
+                    _task_available.wait(lock, [this]() { return _stopping || !_tasks.empty(); });
+                    if (_tasks.empty())
+                        break;
+                    t = std::move(_tasks.front());
+                    _tasks.pop_front();
+                }
+
+                std::exception_ptr error;
+                try
+                {
+                    if (_loaded)
+                        t.work(_gl);
+                }
+                catch (...)
+                {
+                    error = std::current_exception();
+                }
+
+                if (t.done)
+                {
+                    std::lock_guard<std::mutex> lock(_mutex);
+                    *t.error = error;
+                    *t.done = true;
+                }
+                _task_done.notify_all();
+            }
+
+            if (_loaded)
+            {
+                std::lock_guard<std::mutex> lock(_pool_mutex);
+                for (auto&& kvp : _pool)
+                    _gl.delete_buffers(1, &kvp.second);
+                _pool.clear();
+            }
+            glfwMakeContextCurrent(nullptr);
+        }
+
+        void gl_context::invoke(std::function<void(const gl_functions&)> work)
+        {
+            std::exception_ptr error;
+            bool done = false;
+
+            std::unique_lock<std::mutex> lock(_mutex);
+            _tasks.push_back({ std::move(work), &error, &done });
+            _task_available.notify_one();
+            _task_done.wait(lock, [&done]() { return done; });
+            lock.unlock();
+
+            if (error)
+                std::rethrow_exception(error);
+        }
+
+        void gl_context::post(std::function<void(const gl_functions&)> work)
+        {
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _tasks.push_back({ std::move(work), nullptr, nullptr });
+            }
+            _task_available.notify_one();
+        }
+
+        std::shared_ptr<gl_buffer> gl_context::alloc_buffer(const gl_functions& gl, size_t size)
+        {
+            GLuint id = 0;
+            {
+                std::lock_guard<std::mutex> lock(_pool_mutex);
+                auto it = _pool.find(size);
+                if (it != _pool.end())
+                {
+                    id = it->second;
+                    _pool.erase(it);
+                }
+            }
+            if (!id)
+            {
+                gl.gen_buffers(1, &id);
+                gl.bind_buffer(GL_SHADER_STORAGE_BUFFER, id);
+                gl.buffer_data(GL_SHADER_STORAGE_BUFFER, size, nullptr, GL_DYNAMIC_COPY);
+                gl.bind_buffer(GL_SHADER_STORAGE_BUFFER, 0);
+                if (glGetError() != GL_NO_ERROR)
+                {
+                    gl.delete_buffers(1, &id);
+                    throw backend_exception(to_string() << "Could not allocate a GL buffer of " << size << " bytes", RS2_EXCEPTION_TYPE_BACKEND);
+                }
+            }
+            return std::make_shared<gl_buffer>(shared_from_this(), id, size);
+        }
+
+        void gl_context::release_buffer(GLuint id, size_t size)
+        {
+            {
+                std::lock_guard<std::mutex> lock(_pool_mutex);
+                if (_pool.size() < max_pooled_buffers)
+                {
+                    _pool.emplace(size, id);
+                    return;
+                }
+            }
+            post([id](const gl_functions& gl) { gl.delete_buffers(1, &id); });
+        }
+
+        GLuint compile_compute_program(const gl_functions& gl, const char* source)
+        {
+            auto shader = gl.create_shader(GL_COMPUTE_SHADER);
+            gl.shader_source(shader, 1, &source, nullptr);
+            gl.compile_shader(shader);
+
+            GLint status = 0, length = 0;
+            gl.get_shader_iv(shader, GL_COMPILE_STATUS, &status);
+            if (!status)
+            {
+                gl.get_shader_iv(shader, GL_INFO_LOG_LENGTH, &length);
+                std::vector<char> log(length + 1);
+                gl.get_shader_info_log(shader, length, nullptr, log.data());
+                gl.delete_shader(shader);
+                throw backend_exception(std::string("Compute shader compilation failed: ") + log.data(), RS2_EXCEPTION_TYPE_BACKEND);
+            }
+
+            auto program = gl.create_program();
+            gl.attach_shader(program, shader);
+            gl.link_program(program);
+            gl.delete_shader(shader);
+
+            gl.get_program_iv(program, GL_LINK_STATUS, &status);
+            if (!status)
+            {
+                gl.get_program_iv(program, GL_INFO_LOG_LENGTH, &length);
+                std::vector<char> log(length + 1);
+                gl.get_program_info_log(program, length, nullptr, log.data());
+                gl.delete_program(program);
+                throw backend_exception(std::string("Compute program link failed: ") + log.data(), RS2_EXCEPTION_TYPE_BACKEND);
+            }
+            return program;
+        }
+
+        std::string camera_model_source()
+        {
+            return to_string() <<
+                "#define DISTORTION_MODIFIED_BROWN_CONRADY " << RS2_DISTORTION_MODIFIED_BROWN_CONRADY << "\n"
+                "#define DISTORTION_INVERSE_BROWN_CONRADY " << RS2_DISTORTION_INVERSE_BROWN_CONRADY << "\n"
+                "#define DISTORTION_FTHETA " << RS2_DISTORTION_FTHETA << "\n"
+                "\n"
+                "vec3 deproject(vec2 pixel, float depth, vec4 lens, int model, float coeffs[5])\n"
+                "{\n"
+                "    float x = (pixel.x - lens.x) / lens.z;\n"
+                "    float y = (pixel.y - lens.y) / lens.w;\n"
+                "    if (model == DISTORTION_INVERSE_BROWN_CONRADY)\n"
+                "    {\n"
+                "        float r2 = x * x + y * y;\n"
+                "        float f = 1.0 + coeffs[0] * r2 + coeffs[1] * r2 * r2 + coeffs[4] * r2 * r2 * r2;\n"
+                "        float ux = x * f + 2.0 * coeffs[2] * x * y + coeffs[3] * (r2 + 2.0 * x * x);\n"
+                "        float uy = y * f + 2.0 * coeffs[3] * x * y + coeffs[2] * (r2 + 2.0 * y * y);\n"
+                "        x = ux;\n"
+                "        y = uy;\n"
+                "    }\n"
+                "    return vec3(depth * x, depth * y, depth);\n"
+                "}\n"
+                "\n"
+                "vec2 project(vec3 point, vec4 lens, int model, float coeffs[5])\n"
+                "{\n"
+                "    float x = point.x / point.z, y = point.y / point.z;\n"
+                "    if (model == DISTORTION_MODIFIED_BROWN_CONRADY)\n"
+                "    {\n"
+                "        float r2 = x * x + y * y;\n"
+                "        float f = 1.0 + coeffs[0] * r2 + coeffs[1] * r2 * r2 + coeffs[4] * r2 * r2 * r2;\n"
+                "        x *= f;\n"
+                "        y *= f;\n"
+                "        float dx = x + 2.0 * coeffs[2] * x * y + coeffs[3] * (r2 + 2.0 * x * x);\n"
+                "        float dy = y + 2.0 * coeffs[3] * x * y + coeffs[2] * (r2 + 2.0 * y * y);\n"
+                "        x = dx;\n"
+                "        y = dy;\n"
+                "    }\n"
+                "    if (model == DISTORTION_FTHETA)\n"
+                "    {\n"
+                "        float r = sqrt(x * x + y * y);\n"
+                "        float rd = 1.0 / coeffs[0] * atan(2.0 * r * tan(coeffs[0] / 2.0));\n"
+                "        x *= rd / r;\n"
+                "        y *= rd / r;\n"
+                "    }\n"
+                "    return vec2(x * lens.z + lens.x, y * lens.w + lens.y);\n"
+                "}\n";
+        }
+
+        std::string intrinsics_uniforms(const std::string& name)
+        {
+            return "uniform ivec2 " + name + "_size;\n"
+                "uniform vec4 " + name + "_lens;\n"
+                "uniform int " + name + "_model;\n"
+                "uniform float " + name + "_coeffs[5];\n";
+        }
+
+        void set_intrinsics(const gl_functions& gl, GLuint program, const std::string& name, const rs2_intrinsics& intrin)
+        {
+            gl.uniform2i(gl.get_uniform_location(program, (name + "_size").c_str()), intrin.width, intrin.height);
+            gl.uniform4f(gl.get_uniform_location(program, (name + "_lens").c_str()), intrin.ppx, intrin.ppy, intrin.fx, intrin.fy);
+            gl.uniform1i(gl.get_uniform_location(program, (name + "_model").c_str()), intrin.model);
+            gl.uniform1fv(gl.get_uniform_location(program, (name + "_coeffs").c_str()), 5, intrin.coeffs);
+        }
+
+        void set_extrinsics(const gl_functions& gl, GLuint program, const rs2_extrinsics& extrin)
+        {
+            // Both the extrinsics and GLSL matrices are column-major
+            gl.uniform_matrix3fv(gl.get_uniform_location(program, "rotation"), 1, GL_FALSE, extrin.rotation);
+            gl.uniform3f(gl.get_uniform_location(program, "translation"), extrin.translation[0], extrin.translation[1], extrin.translation[2]);
+        }
+
+        bool can_deproject(const rs2_intrinsics& intrin)
+        {
+            return intrin.model == RS2_DISTORTION_NONE || intrin.model == RS2_DISTORTION_INVERSE_BROWN_CONRADY;
+        }
+
+        bool can_project(const rs2_intrinsics& intrin)
+        {
+            return intrin.model == RS2_DISTORTION_NONE || intrin.model == RS2_DISTORTION_MODIFIED_BROWN_CONRADY ||
+                intrin.model == RS2_DISTORTION_FTHETA;
+        }
+    }
+}
+#endif // RS2_USE_GLSL
@@ -0,0 +1,226 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+#pragma once
+#ifdef RS2_USE_GLSL
+
+#include "../core/device-memory.h"
+#include "../../include/librealsense2/h/rs_types.h"
+#include "../../include/librealsense2/h/rs_sensor.h"
+
+#include <GLFW/glfw3.h>
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#ifdef _WIN32
+#define RS2_GL_APIENTRY __stdcall
+#else
+#define RS2_GL_APIENTRY
+#endif
+
+// OpenGL 4.3 enums, missing from the OpenGL 1.1 headers of most platforms
+#ifndef GL_SHADER_STORAGE_BUFFER
+#define GL_SHADER_STORAGE_BUFFER 0x90D2
+#endif
+#ifndef GL_COMPUTE_SHADER
+#define GL_COMPUTE_SHADER 0x91B9
+#endif
+#ifndef GL_COMPILE_STATUS
+#define GL_COMPILE_STATUS 0x8B81
+#endif
+#ifndef GL_LINK_STATUS
+#define GL_LINK_STATUS 0x8B82
+#endif
+#ifndef GL_INFO_LOG_LENGTH
+#define GL_INFO_LOG_LENGTH 0x8B84
+#endif
+#ifndef GL_DYNAMIC_COPY
+#define GL_DYNAMIC_COPY 0x88EA
+#endif
+#ifndef GL_STREAM_DRAW
+#define GL_STREAM_DRAW 0x88E0
+#endif
+#ifndef GL_R32UI
+#define GL_R32UI 0x8236
+#endif
+#ifndef GL_RED_INTEGER
+#define GL_RED_INTEGER 0x8D94
+#endif
+#ifndef GL_SHADER_STORAGE_BARRIER_BIT
+#define GL_SHADER_STORAGE_BARRIER_BIT 0x00002000
+#endif
+#ifndef GL_BUFFER_UPDATE_BARRIER_BIT
+#define GL_BUFFER_UPDATE_BARRIER_BIT 0x00000200
+#endif
+
+namespace librealsense
+{
+    namespace gl
+    {
+        // Entry points of the compute shaders and buffer objects, loaded from the context of the processing thread
+        struct gl_functions
+        {
+            typedef void (RS2_GL_APIENTRY *gen_t)(GLsizei, GLuint*);
+            typedef void (RS2_GL_APIENTRY *delete_t)(GLsizei, const GLuint*);
+            typedef void (RS2_GL_APIENTRY *bind_t)(GLenum, GLuint);
+            typedef void (RS2_GL_APIENTRY *bind_base_t)(GLenum, GLuint, GLuint);
+            typedef void (RS2_GL_APIENTRY *buffer_data_t)(GLenum, ptrdiff_t, const void*, GLenum);
+            typedef void (RS2_GL_APIENTRY *buffer_sub_data_t)(GLenum, ptrdiff_t, ptrdiff_t, const void*);
+            typedef void (RS2_GL_APIENTRY *get_buffer_sub_data_t)(GLenum, ptrdiff_t, ptrdiff_t, void*);
+            typedef void (RS2_GL_APIENTRY *clear_buffer_data_t)(GLenum, GLenum, GLenum, GLenum, const void*);
+            typedef GLuint (RS2_GL_APIENTRY *create_shader_t)(GLenum);
+            typedef void (RS2_GL_APIENTRY *shader_source_t)(GLuint, GLsizei, const char* const*, const GLint*);
+            typedef void (RS2_GL_APIENTRY *uint_t)(GLuint);
+            typedef void (RS2_GL_APIENTRY *get_iv_t)(GLuint, GLenum, GLint*);
+            typedef void (RS2_GL_APIENTRY *get_info_log_t)(GLuint, GLsizei, GLsizei*, char*);
+            typedef GLuint (RS2_GL_APIENTRY *create_program_t)();
+            typedef void (RS2_GL_APIENTRY *attach_shader_t)(GLuint, GLuint);
+            typedef GLint (RS2_GL_APIENTRY *get_uniform_location_t)(GLuint, const char*);
+            typedef void (RS2_GL_APIENTRY *uniform1i_t)(GLint, GLint);
+            typedef void (RS2_GL_APIENTRY *uniform2i_t)(GLint, GLint, GLint);
+            typedef void (RS2_GL_APIENTRY *uniform1ui_t)(GLint, GLuint);
+            typedef void (RS2_GL_APIENTRY *uniform1f_t)(GLint, GLfloat);
+            typedef void (RS2_GL_APIENTRY *uniform3f_t)(GLint, GLfloat, GLfloat, GLfloat);
+            typedef void (RS2_GL_APIENTRY *uniform4f_t)(GLint, GLfloat, GLfloat, GLfloat, GLfloat);
+            typedef void (RS2_GL_APIENTRY *uniform1fv_t)(GLint, GLsizei, const GLfloat*);
+            typedef void (RS2_GL_APIENTRY *uniform_matrix3fv_t)(GLint, GLsizei, GLboolean, const GLfloat*);
+            typedef void (RS2_GL_APIENTRY *dispatch_compute_t)(GLuint, GLuint, GLuint);
+            typedef void (RS2_GL_APIENTRY *memory_barrier_t)(GLbitfield);
+
+            gen_t gen_buffers = nullptr;
+            delete_t delete_buffers = nullptr;
+            bind_t bind_buffer = nullptr;
+            bind_base_t bind_buffer_base = nullptr;
+            buffer_data_t buffer_data = nullptr;
+            buffer_sub_data_t buffer_sub_data = nullptr;
+            get_buffer_sub_data_t get_buffer_sub_data = nullptr;
+            clear_buffer_data_t clear_buffer_data = nullptr;
+
+            create_shader_t create_shader = nullptr;
+            shader_source_t shader_source = nullptr;
+            uint_t compile_shader = nullptr;
+            get_iv_t get_shader_iv = nullptr;
+            get_info_log_t get_shader_info_log = nullptr;
+            uint_t delete_shader = nullptr;
+            create_program_t create_program = nullptr;
+            attach_shader_t attach_shader = nullptr;
+            uint_t link_program = nullptr;
+            get_iv_t get_program_iv = nullptr;
+            get_info_log_t get_program_info_log = nullptr;
+            uint_t use_program = nullptr;
+            uint_t delete_program = nullptr;
+
+            get_uniform_location_t get_uniform_location = nullptr;
+            uniform1i_t uniform1i = nullptr;
+            uniform2i_t uniform2i = nullptr;
+            uniform1ui_t uniform1ui = nullptr;
+            uniform1f_t uniform1f = nullptr;
+            uniform3f_t uniform3f = nullptr;
+            uniform4f_t uniform4f = nullptr;
+            uniform1fv_t uniform1fv = nullptr;
+            uniform_matrix3fv_t uniform_matrix3fv = nullptr;
+
+            dispatch_compute_t dispatch_compute = nullptr;
+            memory_barrier_t memory_barrier = nullptr;
+
+            // Must be called with the context current, false when the context lacks compute shaders
+            bool load();
+        };
+
+        class gl_context;
+
+        // Shader storage buffer holding the data of a frame. The host copy of the frame is only
+        // written when the application reads the frame data, see frame::get_frame_data
+        class gl_buffer : public device_memory
+        {
+        public:
+            gl_buffer(std::shared_ptr<gl_context> context, GLuint id, size_t size)
+                : _context(std::move(context)), _id(id), _size(size) {}
+            ~gl_buffer();
+
+            // The name of the buffer object, not an address
+            void* get() const override { return reinterpret_cast<void*>(static_cast<size_t>(_id)); }
+            size_t size() const override { return _size; }
+            void download(void* host) const override;
+            void upload(const void* host);
+
+            GLuint id() const { return _id; }
+
+        private:
+            std::shared_ptr<gl_context> _context;
+            GLuint _id;
+            size_t _size;
+        };
+
+        // Hidden window whose context is current on a thread of its own. GL calls of the processing blocks are
+        // serialized on that thread, since the frames are processed and read on arbitrary application threads.
+        // GLFW requires windows to be created on the main thread, so the first GL block should be created there
+        class gl_context : public std::enable_shared_from_this<gl_context>
+        {
+        public:
+            // The context shared by all the GL blocks, created on first use
+            static std::shared_ptr<gl_context> acquire();
+            static bool is_available();
+
+            ~gl_context();
+
+            // Runs the task on the GL thread and waits for it, rethrowing its failure
+            void invoke(std::function<void(const gl_functions&)> task);
+            // Runs the task on the GL thread without waiting, for the release of resources
+            void post(std::function<void(const gl_functions&)> task);
+
+            // Must be called on the GL thread. Buffers are recycled by size, since every frame needs one
+            std::shared_ptr<gl_buffer> alloc_buffer(const gl_functions& gl, size_t size);
+            void release_buffer(GLuint id, size_t size);
+
+        private:
+            gl_context(GLFWwindow* window);
+
+            void run();
+
+            struct task
+            {
+                std::function<void(const gl_functions&)> work;
+                std::exception_ptr* error;
+                bool* done;
+            };
+
+            GLFWwindow* _window;
+            gl_functions _gl;
+            bool _loaded = false;
+
+            std::mutex _mutex;
+            std::condition_variable _task_available;
+            std::condition_variable _task_done;
+            std::deque<task> _tasks;
+            bool _stopping = false;
+            std::thread _thread;
+
+            std::mutex _pool_mutex;
+            std::multimap<size_t, GLuint> _pool;
+        };
+
+        // Builds a compute program from GLSL 4.30 source, throws with the compiler log on failure
+        GLuint compile_compute_program(const gl_functions& gl, const char* source);
+
+        // GLSL of rs2_deproject_pixel_to_point and rs2_project_point_to_pixel, taking the intrinsics
+        // declared by intrinsics_uniforms and filled by set_intrinsics
+        std::string camera_model_source();
+        std::string intrinsics_uniforms(const std::string& name);
+        void set_intrinsics(const gl_functions& gl, GLuint program, const std::string& name, const rs2_intrinsics& intrin);
+        void set_extrinsics(const gl_functions& gl, GLuint program, const rs2_extrinsics& extrin);
+
+        // Models the shaders can deproject from and project to, other streams are processed on the host
+        bool can_deproject(const rs2_intrinsics& intrin);
+        bool can_project(const rs2_intrinsics& intrin);
+    }
+}
+#endif // RS2_USE_GLSL
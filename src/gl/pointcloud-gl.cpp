@@ -0,0 +1,130 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+#ifdef RS2_USE_GLSL
+
+#include "pointcloud-gl.h"
+#include "proc/occlusion-filter.h"
+#include "archive.h"
+
+namespace librealsense
+{
+    namespace
+    {
+        const int group_size = 16;
+
+        // One invocation per depth pixel. The points buffer has the layout of the points frame:
+        // the vertices of all the pixels, followed by their texture coordinates
+        const char* pointcloud_shader =
+            "layout(local_size_x = 16, local_size_y = 16) in;\n"
+            "\n"
+            "layout(std430, binding = 0) readonly buffer depth_buffer { uint depth[]; };\n"
+            "layout(std430, binding = 1) writeonly buffer points_buffer { float points[]; };\n"
+            "\n"
+            "uniform float depth_units;\n"
+            "uniform int map_texture;\n"
+            "uniform mat3 rotation;\n"
+            "uniform vec3 translation;\n"
+            "\n"
+            "void main()\n"
+            "{\n"
+            "    ivec2 pixel = ivec2(gl_GlobalInvocationID.xy);\n"
+            "    if (pixel.x >= depth_size.x || pixel.y >= depth_size.y)\n"
+            "        return;\n"
+            "\n"
+            "    uint i = uint(pixel.y * depth_size.x + pixel.x);\n"
+            "    float z = float((depth[i >> 1] >> ((i & 1u) * 16u)) & 0xFFFFu) * depth_units;\n"
+            "    vec3 point = deproject(vec2(pixel), z, depth_lens, depth_model, depth_coeffs);\n"
+            "    points[i * 3u] = point.x;\n"
+            "    points[i * 3u + 1u] = point.y;\n"
+            "    points[i * 3u + 2u] = point.z;\n"
+            "\n"
+            "    vec2 texcoord = vec2(0.0);\n"
+            "    if (map_texture != 0 && z != 0.0)\n"
+            "        texcoord = project(rotation * point + translation, other_lens, other_model, other_coeffs) / vec2(other_size);\n"
+            "    uint t = uint(depth_size.x * depth_size.y) * 3u + i * 2u;\n"
+            "    points[t] = texcoord.x;\n"
+            "    points[t + 1u] = texcoord.y;\n"
+            "}\n";
+    }
+
+    pointcloud_gl::pointcloud_gl()
+        : _context(gl::gl_context::acquire())
+    {
+    }
+
+    pointcloud_gl::~pointcloud_gl()
+    {
+        if (auto program = _program)
+            _context->post([program](const gl::gl_functions& gl) { gl.delete_program(program); });
+    }
+
+    rs2::frame pointcloud_gl::process_depth_frame(const rs2::frame_source& source, const rs2::depth_frame& depth)
+    {
+        const bool map_texture = _extrinsics && _other_intrinsics;
+        const size_t size = size_t(_depth_intrinsics->height) * _depth_intrinsics->width;
+
+        // The sparse output and the occlusion removal work on the host copy of the points
+        if (_sparse_mode != sparse_pointcloud_off || (map_texture && _occlusion_filter->active()) ||
+            !gl::can_deproject(*_depth_intrinsics) || (map_texture && !gl::can_project(*_other_intrinsics)))
+            return pointcloud::process_depth_frame(source, depth);
+
+        auto res = source.allocate_points(_output_stream, depth);
+        auto pframe = (librealsense::points*)(res.get());
+        if (pframe->get_vertex_count() != size)
+            return pointcloud::process_depth_frame(source, depth);
+
+        // Depth left in a GL buffer by an earlier block is read in place, other frames are uploaded
+        auto depth_memory = std::dynamic_pointer_cast<gl::gl_buffer>(((frame_interface*)depth.get())->get_device_memory());
+        if (depth_memory && depth_memory->size() < size * sizeof(uint16_t))
+            depth_memory.reset();
+        const void* depth_data = depth_memory ? nullptr : depth.get_data();
+        const size_t staging_size = (size * sizeof(uint16_t) + 3) & ~size_t(3);
+
+        std::shared_ptr<gl::gl_buffer> out;
+        _context->invoke([&](const gl::gl_functions& gl)
+        {
+            if (!_program)
+                _program = gl::compile_compute_program(gl, ("#version 430\n" + gl::camera_model_source() +
+                    gl::intrinsics_uniforms("depth") + gl::intrinsics_uniforms("other") + pointcloud_shader).c_str());
+
+            GLuint input;
+            if (depth_memory)
+                input = depth_memory->id();
+            else
+            {
+                if (!_staging || _staging->size() != staging_size)
+                    _staging = _context->alloc_buffer(gl, staging_size);
+                gl.bind_buffer(GL_SHADER_STORAGE_BUFFER, _staging->id());
+                gl.buffer_sub_data(GL_SHADER_STORAGE_BUFFER, 0, size * sizeof(uint16_t), depth_data);
+                gl.bind_buffer(GL_SHADER_STORAGE_BUFFER, 0);
+                input = _staging->id();
+            }
+            out = _context->alloc_buffer(gl, size * (sizeof(float3) + sizeof(float2)));
+
+            gl.use_program(_program);
+            gl::set_intrinsics(gl, _program, "depth", *_depth_intrinsics);
+            gl.uniform1f(gl.get_uniform_location(_program, "depth_units"), *_depth_units);
+            gl.uniform1i(gl.get_uniform_location(_program, "map_texture"), map_texture);
+            if (map_texture)
+            {
+                gl::set_intrinsics(gl, _program, "other", *_other_intrinsics);
+                gl::set_extrinsics(gl, _program, *_extrinsics);
+            }
+
+            gl.bind_buffer_base(GL_SHADER_STORAGE_BUFFER, 0, input);
+            gl.bind_buffer_base(GL_SHADER_STORAGE_BUFFER, 1, out->id());
+            gl.dispatch_compute((_depth_intrinsics->width + group_size - 1) / group_size,
+                (_depth_intrinsics->height + group_size - 1) / group_size, 1);
+            gl.memory_barrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
+            gl.bind_buffer_base(GL_SHADER_STORAGE_BUFFER, 0, 0);
+            gl.bind_buffer_base(GL_SHADER_STORAGE_BUFFER, 1, 0);
+            gl.use_program(0);
+            // Starts the dispatch without waiting for it, the readback waits when the points are read
+            glFlush();
+        });
+
+        pframe->attach_device_memory(out, true);
+        return res;
+    }
+}
+#endif // RS2_USE_GLSL
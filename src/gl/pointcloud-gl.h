@@ -0,0 +1,29 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+#pragma once
+#ifdef RS2_USE_GLSL
+
+#include "proc/synthetic-stream.h"
+#include "proc/pointcloud.h"
+#include "gl-context.h"
+
+namespace librealsense
+{
+    // Computes the vertices and texture coordinates in a compute shader, into a GL buffer attached to the points frame.
+    // The sparse output, the occlusion removal and the unsupported lens models go through the host implementation
+    class pointcloud_gl : public pointcloud
+    {
+    public:
+        pointcloud_gl();
+        ~pointcloud_gl();
+
+    protected:
+        rs2::frame process_depth_frame(const rs2::frame_source& source, const rs2::depth_frame& depth) override;
+
+    private:
+        std::shared_ptr<gl::gl_context> _context;
+        GLuint _program = 0;
+        std::shared_ptr<gl::gl_buffer> _staging;
+    };
+}
+#endif // RS2_USE_GLSL
@@ -0,0 +1,252 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#include "global_timestamp_reader.h"
+#include "environment.h"
+
+#include <cmath>
+#include <limits>
+
+namespace librealsense
+{
+    // The hardware timestamps are taken from a free running 32-bit microseconds counter
+    const double device_clock_period_ms = 4294967296.0 * TIMESTAMP_USEC_TO_MSEC;
+    // Sampling is faster until the first fit is available
+    const unsigned int warmup_sample_interval_ms = 50;
+    // A sample this far off the fit means the device clock was restarted
+    const double max_clock_deviation_ms = 10.0;
+
+    clock_regression::clock_regression(size_t window)
+        : _window(window)
+    {
+    }
+
+    void clock_regression::add_sample(double device_ms, double host_ms)
+    {
+        _samples.push_back({ device_ms, host_ms });
+        if (_samples.size() > _window)
+            _samples.pop_front();
+        fit();
+    }
+
+    void clock_regression::reset()
+    {
+        _samples.clear();
+        _device_mean = _host_mean = 0;
+        _slope = 1;
+    }
+
+    double clock_regression::to_host(double device_ms) const
+    {
+        return _host_mean + _slope * (device_ms - _device_mean);
+    }
+
+    void clock_regression::fit()
+    {
+        double device_sum = 0, host_sum = 0;
+        for (auto&& s : _samples)
+        {
+            device_sum += s.device_ms;
+            host_sum += s.host_ms;
+        }
+        _device_mean = device_sum / _samples.size();
+        _host_mean = host_sum / _samples.size();
+
+        double sxx = 0, sxy = 0;
+        for (auto&& s : _samples)
+        {
+            auto dx = s.device_ms - _device_mean;
+            sxx += dx * dx;
+            sxy += dx * (s.host_ms - _host_mean);
+        }
+        _slope = sxx > 0 ? sxy / sxx : 1;
+    }
+
+    time_diff_keeper::time_diff_keeper(global_time_interface* dev, unsigned int sample_interval_ms)
+        : _device(dev),
+          _sample_interval_ms(sample_interval_ms),
+          _users(0),
+          _min_rtt_ms(std::numeric_limits<double>::max()),
+          _last_device_ms(0),
+          _coefficients(32),
+          _active_object([this](dispatcher::cancellable_timer cancellable_timer)
+          {
+              polling(cancellable_timer);
+          })
+    {
+    }
+
+    time_diff_keeper::~time_diff_keeper()
+    {
+        shutdown();
+    }
+
+    void time_diff_keeper::start()
+    {
+        std::lock_guard<std::mutex> lock(_users_mtx);
+        if (_users++ == 0)
+            _active_object.start();
+    }
+
+    void time_diff_keeper::stop()
+    {
+        std::lock_guard<std::mutex> lock(_users_mtx);
+        if (_users > 0 && --_users == 0)
+            _active_object.stop();
+    }
+
+    void time_diff_keeper::shutdown()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_users_mtx);
+            _users = 0;
+            _active_object.stop();
+        }
+        std::lock_guard<std::mutex> lock(_device_mtx);
+        _device = nullptr;
+    }
+
+    bool time_diff_keeper::to_host_time(double device_ms, double& host_ms) const
+    {
+        std::lock_guard<std::mutex> lock(_mtx);
+        if (!_coefficients.is_ready())
+            return false;
+
+        host_ms = _coefficients.to_host(unwrap(device_ms));
+        return true;
+    }
+
+    void time_diff_keeper::polling(dispatcher::cancellable_timer cancellable_timer)
+    {
+        bool ready;
+        {
+            std::lock_guard<std::mutex> lock(_mtx);
+            ready = _coefficients.is_ready();
+        }
+
+        if (cancellable_timer.try_sleep(ready ? _sample_interval_ms : warmup_sample_interval_ms))
+        {
+            try
+            {
+                update_diff_time();
+            }
+            catch (const std::exception& ex)
+            {
+                LOG_DEBUG("Failed to sample the device clock: " << ex.what());
+            }
+        }
+        else
+        {
+            LOG_DEBUG("Device clock sampling is being shut-down");
+        }
+    }
+
+    bool time_diff_keeper::update_diff_time()
+    {
+        std::lock_guard<std::mutex> lock(_device_mtx);
+        if (!_device)
+            return false;
+
+        auto time_service = environment::get_instance().get_time_service();
+        auto host_before = time_service->get_time();
+        auto device_ms = _device->get_device_time_ms();
+        auto host_after = time_service->get_time();
+
+        // The device clock is read somewhere within the round trip, so only samples close to the fastest one seen are kept
+        auto rtt = host_after - host_before;
+        if (rtt > 2 * _min_rtt_ms + 1.0)
+            return false;
+        _min_rtt_ms = std::min(_min_rtt_ms, rtt);
+        auto host_ms = (host_before + host_after) / 2;
+
+        std::lock_guard<std::mutex> fit_lock(_mtx);
+        if (!_coefficients.empty())
+            device_ms = unwrap(device_ms);
+
+        if (_coefficients.is_ready() && std::abs(_coefficients.to_host(device_ms) - host_ms) > max_clock_deviation_ms)
+        {
+            LOG_DEBUG("Device clock was restarted, dropping the global time fit");
+            _coefficients.reset();
+        }
+
+        _coefficients.add_sample(device_ms, host_ms);
+        _last_device_ms = device_ms;
+        return true;
+    }
+
+    double time_diff_keeper::unwrap(double device_ms) const
+    {
+        // Counters read close to the last sample belong to the nearest period
+        return device_ms + std::round((_last_device_ms - device_ms) / device_clock_period_ms) * device_clock_period_ms;
+    }
+
+    global_time_option::~global_time_option()
+    {
+        if (_value)
+            _keeper->stop();
+    }
+
+    void global_time_option::set(float value)
+    {
+        if (!is_valid(value))
+            throw invalid_value_exception(to_string() << "set(global_time_option) failed! Given value " << value << " is out of range.");
+
+        bool enable = value != 0;
+        if (_value.exchange(enable) != enable)
+        {
+            if (enable)
+                _keeper->start();
+            else
+                _keeper->stop();
+        }
+        _recording_function(*this);
+    }
+
+    const char* global_time_option::get_value_description(float value) const
+    {
+        if (value == 0)
+            return "Hardware clock";
+        else
+            return "Global time";
+    }
+
+    global_timestamp_reader::global_timestamp_reader(std::unique_ptr<frame_timestamp_reader> device_timestamp_reader,
+                                                     std::shared_ptr<time_diff_keeper> keeper,
+                                                     std::shared_ptr<global_time_option> enabled)
+        : _device_timestamp_reader(std::move(device_timestamp_reader)),
+          _keeper(keeper),
+          _enabled(enabled),
+          _ts_is_global(false)
+    {
+    }
+
+    rs2_time_t global_timestamp_reader::get_frame_timestamp(const request_mapping& mode, const platform::frame_object& fo)
+    {
+        std::lock_guard<std::recursive_mutex> lock(_mtx);
+        auto ts = _device_timestamp_reader->get_frame_timestamp(mode, fo);
+
+        double host_ts;
+        _ts_is_global = _enabled->is_active() &&
+                        _device_timestamp_reader->get_frame_timestamp_domain(mode, fo) == RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK &&
+                        _keeper->to_host_time(ts, host_ts);
+        return _ts_is_global ? host_ts : ts;
+    }
+
+    unsigned long long global_timestamp_reader::get_frame_counter(const request_mapping& mode, const platform::frame_object& fo) const
+    {
+        return _device_timestamp_reader->get_frame_counter(mode, fo);
+    }
+
+    rs2_timestamp_domain global_timestamp_reader::get_frame_timestamp_domain(const request_mapping& mode, const platform::frame_object& fo) const
+    {
+        std::lock_guard<std::recursive_mutex> lock(_mtx);
+        return _ts_is_global ? RS2_TIMESTAMP_DOMAIN_GLOBAL_TIME : _device_timestamp_reader->get_frame_timestamp_domain(mode, fo);
+    }
+
+    void global_timestamp_reader::reset()
+    {
+        std::lock_guard<std::recursive_mutex> lock(_mtx);
+        _ts_is_global = false;
+        _device_timestamp_reader->reset();
+    }
+}
@@ -0,0 +1,126 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "sensor.h"
+#include "option.h"
+#include "concurrency.h"
+
+#include <deque>
+#include <mutex>
+
+namespace librealsense
+{
+    // Implemented by devices able to sample their own clock on request
+    class global_time_interface
+    {
+    public:
+        // Current value of the clock the hardware frame timestamps are taken from, in milliseconds
+        virtual double get_device_time_ms() = 0;
+
+        virtual ~global_time_interface() = default;
+    };
+
+    // Least-squares fit of host time as a linear function of device time over the most recent samples
+    class clock_regression
+    {
+    public:
+        explicit clock_regression(size_t window);
+
+        void add_sample(double device_ms, double host_ms);
+        void reset();
+
+        bool empty() const { return _samples.empty(); }
+        bool is_ready() const { return _samples.size() >= 2; }
+        double to_host(double device_ms) const;
+
+    private:
+        void fit();
+
+        struct sample { double device_ms, host_ms; };
+
+        size_t _window;
+        std::deque<sample> _samples;
+        // Fitted around the sample means to keep the products well inside double precision
+        double _device_mean = 0;
+        double _host_mean = 0;
+        double _slope = 1;
+    };
+
+    // Samples the device clock against the host clock while there are users, shared by all the sensors of one device
+    class time_diff_keeper
+    {
+    public:
+        time_diff_keeper(global_time_interface* dev, unsigned int sample_interval_ms);
+        ~time_diff_keeper();
+
+        void start();
+        void stop();
+        // Stops sampling for good; called by the device before its own members go away
+        void shutdown();
+
+        // Maps a device timestamp onto the host clock, false until enough samples were taken
+        bool to_host_time(double device_ms, double& host_ms) const;
+
+    private:
+        void polling(dispatcher::cancellable_timer cancellable_timer);
+        bool update_diff_time();
+        double unwrap(double device_ms) const;
+
+        global_time_interface* _device;
+        unsigned int _sample_interval_ms;
+        std::mutex _users_mtx;
+        int _users;
+        std::mutex _device_mtx;             // held while sampling, so shutdown waits for a sample in flight
+        double _min_rtt_ms;
+
+        mutable std::mutex _mtx;            // guards the fit, read on every frame
+        double _last_device_ms;
+        clock_regression _coefficients;
+
+        active_object<> _active_object;
+    };
+
+    class global_time_option : public option_base
+    {
+    public:
+        global_time_option(std::shared_ptr<time_diff_keeper> keeper)
+            : option_base({ 0, 1, 1, 0 }), _keeper(keeper), _value(false)
+        {}
+        ~global_time_option();
+
+        void set(float value) override;
+        float query() const override { return _value ? 1.f : 0.f; }
+        bool is_enabled() const override { return true; }
+        const char* get_description() const override { return "Map hardware timestamps of this sensor onto the host clock"; }
+        const char* get_value_description(float value) const override;
+
+        bool is_active() const { return _value; }
+
+    private:
+        std::shared_ptr<time_diff_keeper> _keeper;
+        std::atomic<bool> _value;
+    };
+
+    // Reports the timestamps of the wrapped reader on the host timeline once the device clock model is ready
+    class global_timestamp_reader : public frame_timestamp_reader
+    {
+    public:
+        global_timestamp_reader(std::unique_ptr<frame_timestamp_reader> device_timestamp_reader,
+                                std::shared_ptr<time_diff_keeper> keeper,
+                                std::shared_ptr<global_time_option> enabled);
+
+        rs2_time_t get_frame_timestamp(const request_mapping& mode, const platform::frame_object& fo) override;
+        unsigned long long get_frame_counter(const request_mapping& mode, const platform::frame_object& fo) const override;
+        rs2_timestamp_domain get_frame_timestamp_domain(const request_mapping& mode, const platform::frame_object& fo) const override;
+        void reset() override;
+
+    private:
+        std::unique_ptr<frame_timestamp_reader> _device_timestamp_reader;
+        std::shared_ptr<time_diff_keeper> _keeper;
+        std::shared_ptr<global_time_option> _enabled;
+        bool _ts_is_global;                 // whether the last timestamp handed out was mapped, so the domain matches it
+        mutable std::recursive_mutex _mtx;
+    };
+}
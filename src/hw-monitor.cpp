@@ -41,29 +41,6 @@ namespace librealsense
     }
 
 
-    void hw_monitor::execute_usb_command(uint8_t *out, size_t outSize, uint32_t & op, uint8_t * in, size_t & inSize) const
-    {
-        std::vector<uint8_t> out_vec(out, out + outSize);
-        auto res = _locked_transfer->send_receive(out_vec);
-
-        // read
-        if (in && inSize)
-        {
-            if (res.size() < static_cast<int>(sizeof(uint32_t)))
-                throw invalid_value_exception("Incomplete bulk usb transfer!");
-
-            if (res.size() > IVCAM_MONITOR_MAX_BUFFER_SIZE)
-                throw invalid_value_exception("Out buffer is greater than max buffer size!");
-
-            op = *reinterpret_cast<uint32_t *>(res.data());
-            if (res.size() > static_cast<int>(inSize))
-                throw invalid_value_exception("bulk transfer failed - user buffer too small");
-
-            inSize = res.size();
-            librealsense::copy(in, res.data(), inSize);
-        }
-    }
-
     void hw_monitor::update_cmd_details(hwmon_cmd_details& details, size_t receivedCmdLen, unsigned char* outputBuffer)
     {
         details.receivedCommandDataLength = receivedCmdLen;
@@ -80,15 +57,31 @@ namespace librealsense
             librealsense::copy(details.receivedCommandData.data(), outputBuffer + 4, details.receivedCommandDataLength);
     }
 
-    void hw_monitor::send_hw_monitor_command(hwmon_cmd_details& details) const
+    std::vector<uint8_t> hw_monitor::parse_response(uint32_t opcode, hwmon_cmd_details& details, std::vector<uint8_t>& response)
     {
-        unsigned char outputBuffer[HW_MONITOR_BUFFER_SIZE];
+        if (response.size() < static_cast<int>(sizeof(uint32_t)))
+            throw invalid_value_exception("Incomplete bulk usb transfer!");
 
-        uint32_t op{};
-        size_t receivedCmdLen = HW_MONITOR_BUFFER_SIZE;
+        if (response.size() > IVCAM_MONITOR_MAX_BUFFER_SIZE)
+            throw invalid_value_exception("Out buffer is greater than max buffer size!");
 
-        execute_usb_command(details.sendCommandData.data(), details.sizeOfSendCommandData, op, outputBuffer, receivedCmdLen);
-        update_cmd_details(details, receivedCmdLen, outputBuffer);
+        update_cmd_details(details, response.size(), response.data());
+
+        // Error/exit conditions
+        if (details.oneDirection)
+            return std::vector<uint8_t>();
+
+        // endian?
+        auto opCodeAsUint32 = pack(details.receivedOpcode[3], details.receivedOpcode[2],
+                                   details.receivedOpcode[1], details.receivedOpcode[0]);
+        if (opCodeAsUint32 != opcode)
+        {
+            throw invalid_value_exception(to_string() << "OpCodes do not match! Sent "
+                << opcode << " but received " << static_cast<int>(opCodeAsUint32) << "!");
+        }
+
+        return std::vector<uint8_t>(details.receivedCommandData.data(),
+            details.receivedCommandData.data() + details.receivedCommandDataLength);
     }
 
     std::vector<uint8_t> hw_monitor::send(std::vector<uint8_t> data) const
@@ -98,44 +91,48 @@ namespace librealsense
 
     std::vector<uint8_t> hw_monitor::send(command cmd) const
     {
-        hwmon_cmd newCommand(cmd);
-        auto opCodeXmit = static_cast<uint32_t>(newCommand.cmd);
-
-        hwmon_cmd_details details;
-        details.oneDirection = newCommand.oneDirection;
-        details.timeOut = newCommand.timeOut;
-
-        fill_usb_buffer(opCodeXmit,
-            newCommand.param1,
-            newCommand.param2,
-            newCommand.param3,
-            newCommand.param4,
-            newCommand.data,
-            newCommand.sizeOfSendCommandData,
-            details.sendCommandData.data(),
-            details.sizeOfSendCommandData);
-
-        send_hw_monitor_command(details);
+        return send_batch(std::vector<command>{ std::move(cmd) }).front();
+    }
 
-        // Error/exit conditions
-        if (newCommand.oneDirection)
-            return std::vector<uint8_t>();
+    std::vector<std::vector<uint8_t>> hw_monitor::send_batch(const std::vector<std::vector<uint8_t>>& data,
+        std::chrono::milliseconds interval) const
+    {
+        return _locked_transfer->send_receive(data, interval);
+    }
 
-        librealsense::copy(newCommand.receivedOpcode, details.receivedOpcode.data(), 4);
-        librealsense::copy(newCommand.receivedCommandData, details.receivedCommandData.data(), details.receivedCommandDataLength);
-        newCommand.receivedCommandDataLength = details.receivedCommandDataLength;
+    std::vector<std::vector<uint8_t>> hw_monitor::send_batch(const std::vector<command>& cmds) const
+    {
+        std::vector<hwmon_cmd_details> details(cmds.size());
+        std::vector<std::vector<uint8_t>> requests;
+        requests.reserve(cmds.size());
 
-        // endian?
-        auto opCodeAsUint32 = pack(details.receivedOpcode[3], details.receivedOpcode[2],
-                                   details.receivedOpcode[1], details.receivedOpcode[0]);
-        if (opCodeAsUint32 != opCodeXmit)
+        for (size_t i = 0; i < cmds.size(); ++i)
         {
-            throw invalid_value_exception(to_string() << "OpCodes do not match! Sent "
-                << opCodeXmit << " but received " << static_cast<int>(opCodeAsUint32) << "!");
+            hwmon_cmd newCommand(cmds[i]);
+            details[i].oneDirection = newCommand.oneDirection;
+            details[i].timeOut = newCommand.timeOut;
+
+            fill_usb_buffer(static_cast<uint32_t>(newCommand.cmd),
+                newCommand.param1,
+                newCommand.param2,
+                newCommand.param3,
+                newCommand.param4,
+                newCommand.data,
+                newCommand.sizeOfSendCommandData,
+                details[i].sendCommandData.data(),
+                details[i].sizeOfSendCommandData);
+
+            requests.emplace_back(details[i].sendCommandData.data(),
+                details[i].sendCommandData.data() + details[i].sizeOfSendCommandData);
         }
 
-        return std::vector<uint8_t>(newCommand.receivedCommandData,
-            newCommand.receivedCommandData + newCommand.receivedCommandDataLength);
+        auto responses = _locked_transfer->send_receive(requests);
+
+        std::vector<std::vector<uint8_t>> results;
+        results.reserve(cmds.size());
+        for (size_t i = 0; i < cmds.size(); ++i)
+            results.push_back(parse_response(static_cast<uint32_t>(cmds[i].cmd), details[i], responses[i]));
+        return results;
     }
 
     void hw_monitor::get_gvd(size_t sz, unsigned char* gvd, uint8_t gvd_cmd) const
@@ -146,36 +143,54 @@ namespace librealsense
         librealsense::copy(gvd, data.data(), minSize);
     }
 
-    std::string hw_monitor::get_firmware_version_string(int gvd_cmd, uint32_t offset) const
+    std::vector<uint8_t> hw_monitor::get_gvd(uint8_t gvd_cmd) const
     {
-        std::vector<unsigned char> gvd(HW_MONITOR_BUFFER_SIZE);
+        std::vector<uint8_t> gvd(HW_MONITOR_BUFFER_SIZE);
         get_gvd(gvd.size(), gvd.data(), gvd_cmd);
-        uint8_t fws[8];
-        librealsense::copy(fws, gvd.data() + offset, 8);
+        return gvd;
+    }
+
+    std::string hw_monitor::get_firmware_version_string(int gvd_cmd, uint32_t offset) const
+    {
+        return get_firmware_version_string(get_gvd(static_cast<uint8_t>(gvd_cmd)), offset);
+    }
+
+    std::string hw_monitor::get_module_serial_string(uint8_t gvd_cmd, uint32_t offset, int size) const
+    {
+        return get_module_serial_string(get_gvd(gvd_cmd), offset, size);
+    }
+
+    bool hw_monitor::is_camera_locked(uint8_t gvd_cmd, uint32_t offset) const
+    {
+        return is_camera_locked(get_gvd(gvd_cmd), offset);
+    }
+
+    std::string hw_monitor::get_firmware_version_string(const std::vector<uint8_t>& gvd, uint32_t offset)
+    {
+        if (gvd.size() < offset + 4)
+            throw invalid_value_exception("GVD buffer is too short for the firmware version");
+        uint8_t fws[4];
+        librealsense::copy(fws, gvd.data() + offset, 4);
         return to_string() << static_cast<int>(fws[3]) << "." << static_cast<int>(fws[2])
             << "." << static_cast<int>(fws[1]) << "." << static_cast<int>(fws[0]);
     }
 
-    std::string hw_monitor::get_module_serial_string(uint8_t gvd_cmd, uint32_t offset, int size) const
+    std::string hw_monitor::get_module_serial_string(const std::vector<uint8_t>& gvd, uint32_t offset, int size)
     {
-        std::vector<unsigned char> gvd(HW_MONITOR_BUFFER_SIZE);
-        get_gvd(gvd.size(), gvd.data(), gvd_cmd);
-        unsigned char ss[8];
-        librealsense::copy(ss, gvd.data() + offset, 8);
+        if (size < 0 || gvd.size() < offset + size)
+            throw invalid_value_exception("GVD buffer is too short for the module serial");
         std::stringstream formattedBuffer;
         for (auto i = 0;i < size;i++)
         {
-            formattedBuffer << std::setfill('0') << std::setw(2) << std::hex << static_cast<int>(ss[i]);
+            formattedBuffer << std::setfill('0') << std::setw(2) << std::hex << static_cast<int>(gvd[offset + i]);
         }
         return formattedBuffer.str();
     }
 
-    bool hw_monitor::is_camera_locked(uint8_t gvd_cmd, uint32_t offset) const
+    bool hw_monitor::is_camera_locked(const std::vector<uint8_t>& gvd, uint32_t offset)
     {
-        std::vector<unsigned char> gvd(HW_MONITOR_BUFFER_SIZE);
-        get_gvd(gvd.size(), gvd.data(), gvd_cmd);
-        bool value;
-        librealsense::copy(&value, gvd.data() + offset, 1);
-        return value;
+        if (gvd.size() <= offset)
+            throw invalid_value_exception("GVD buffer is too short for the camera lock state");
+        return gvd[offset] != 0;
     }
 }
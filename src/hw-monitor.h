@@ -5,6 +5,8 @@
 
 #include "sensor.h"
 #include <mutex>
+#include <chrono>
+#include <thread>
 
 const uint8_t   IV_COMMAND_FIRMWARE_UPDATE_MODE = 0x01;
 const uint8_t   IV_COMMAND_GET_CALIBRATION_DATA = 0x02;
@@ -67,6 +69,31 @@ namespace librealsense
                 });
         }
 
+        // The device is powered and locked once for the whole batch, so that no other command is interleaved.
+        // The firmware still handles one command at a time; interval is the pause required after each command
+        std::vector<std::vector<uint8_t>> send_receive(
+            const std::vector<std::vector<uint8_t>>& batch,
+            std::chrono::milliseconds interval = std::chrono::milliseconds(0),
+            int timeout_ms = 5000,
+            bool require_response = true)
+        {
+            std::lock_guard<std::recursive_mutex> lock(_local_mtx);
+            return _uvc_sensor_base.invoke_powered([&]
+                (platform::uvc_device& dev)
+                {
+                    std::lock_guard<platform::uvc_device> lock(dev);
+                    std::vector<std::vector<uint8_t>> results;
+                    results.reserve(batch.size());
+                    for (auto&& data : batch)
+                    {
+                        results.push_back(_command_transfer->send_receive(data, timeout_ms, require_response));
+                        if (interval.count() > 0)
+                            std::this_thread::sleep_for(interval);
+                    }
+                    return results;
+                });
+        }
+
     private:
         std::shared_ptr<platform::command_transfer> _command_transfer;
         uvc_sensor& _uvc_sensor_base;
@@ -152,9 +179,8 @@ namespace librealsense
         };
 
         static void fill_usb_buffer(int opCodeNumber, int p1, int p2, int p3, int p4, uint8_t* data, int dataLength, uint8_t* bufferToSend, int& length);
-        void execute_usb_command(uint8_t *out, size_t outSize, uint32_t& op, uint8_t* in, size_t& inSize) const;
         static void update_cmd_details(hwmon_cmd_details& details, size_t receivedCmdLen, unsigned char* outputBuffer);
-        void send_hw_monitor_command(hwmon_cmd_details& details) const;
+        static std::vector<uint8_t> parse_response(uint32_t opcode, hwmon_cmd_details& details, std::vector<uint8_t>& response);
 
         std::shared_ptr<locked_transfer> _locked_transfer;
     public:
@@ -164,9 +190,20 @@ namespace librealsense
 
         std::vector<uint8_t> send(std::vector<uint8_t> data) const;
         std::vector<uint8_t> send(command cmd) const;
+
+        // Sends the commands back to back under a single device lock and power-up, returning the responses in order
+        std::vector<std::vector<uint8_t>> send_batch(const std::vector<std::vector<uint8_t>>& data,
+            std::chrono::milliseconds interval = std::chrono::milliseconds(0)) const;
+        std::vector<std::vector<uint8_t>> send_batch(const std::vector<command>& cmds) const;
         void get_gvd(size_t sz, unsigned char* gvd, uint8_t gvd_cmd) const;
         std::string get_firmware_version_string(int gvd_cmd, uint32_t offset) const;
         std::string get_module_serial_string(uint8_t gvd_cmd, uint32_t offset, int size = 6) const;
         bool is_camera_locked(uint8_t gvd_cmd, uint32_t offset) const;
+
+        // Each GVD query is a round-trip to the firmware; devices parse all their fields from a single buffer
+        std::vector<uint8_t> get_gvd(uint8_t gvd_cmd) const;
+        static std::string get_firmware_version_string(const std::vector<uint8_t>& gvd, uint32_t offset);
+        static std::string get_module_serial_string(const std::vector<uint8_t>& gvd, uint32_t offset, int size = 6);
+        static bool is_camera_locked(const std::vector<uint8_t>& gvd, uint32_t offset);
     };
 }
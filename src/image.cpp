@@ -11,8 +11,12 @@
 #ifdef __SSSE3__
 #include <tmmintrin.h> // For SSSE3 intrinsics
 #endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h> // For NEON intrinsics
+#define RS2_NEON
+#endif
 
-#if defined (ANDROID) || (defined (__linux__) && !defined (__x86_64__))
+#if defined (ANDROID) || (defined (__linux__) && !defined (__x86_64__)) || defined(__arm__) || defined(__aarch64__)
 
 bool has_avx() { return false; }
 
@@ -20,20 +24,37 @@ bool has_avx() { return false; }
 
 #ifdef _WIN32
 #include <intrin.h>
+#include <immintrin.h>
 #define cpuid(info, x)    __cpuidex(info, x, 0)
+static unsigned long long xgetbv0() { return _xgetbv(0); }
 #else
 #include <cpuid.h>
 void cpuid(int info[4], int info_type){
     __cpuid_count(info_type, 0, info[0], info[1], info[2], info[3]);
 }
+static unsigned long long xgetbv0()
+{
+    unsigned int eax, edx;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return ((unsigned long long)edx << 32) | eax;
+}
 #endif
 
+// Evaluated once per unpacker on first use. Requires AVX2 support by both the CPU and the OS (YMM state saving)
 bool has_avx()
 {
+    static const int osxsave_avx = (1 << 27) | (1 << 28);
     int info[4];
     cpuid(info, 0);
-    cpuid(info, 0x80000000);
-    return (info[2] & ((int)1 << 28)) != 0;
+    if (info[0] < 7)
+        return false;
+
+    cpuid(info, 1);
+    if ((info[2] & osxsave_avx) != osxsave_avx || (xgetbv0() & 0x6) != 0x6)
+        return false;
+
+    cpuid(info, 7);
+    return (info[1] & (1 << 5)) != 0;
 }
 
 #endif
@@ -53,6 +74,12 @@ namespace librealsense
         return width * height * get_image_bpp(format) / 8;
     }
 
+    // Compressed frames are a single row of bytes, as long as the payload of each frame
+    bool is_compressed_format(rs2_format format)
+    {
+        return format == RS2_FORMAT_Z16_RVL || format == RS2_FORMAT_MJPEG;
+    }
+
     int get_image_bpp(rs2_format format)
     {
         switch (format)
@@ -60,7 +87,14 @@ namespace librealsense
         case RS2_FORMAT_Z16: return  16;
         case RS2_FORMAT_DISPARITY16: return 16;
         case RS2_FORMAT_DISPARITY32: return 32;
+        case RS2_FORMAT_Y8I: return 16;
+        case RS2_FORMAT_Z16_RVL: return 8;
+        case RS2_FORMAT_MJPEG: return 8;
         case RS2_FORMAT_XYZ32F: return 12 * 8;
+        case RS2_FORMAT_MESH_INDICES: return 12 * 8;
+        case RS2_FORMAT_DEPTH_STATISTICS: return sizeof(rs2_depth_statistics) * 8;
+        case RS2_FORMAT_HEIGHT_MAP: return 32;
+        case RS2_FORMAT_OCCUPANCY_GRID: return 8;
         case RS2_FORMAT_YUYV:  return 16;
         case RS2_FORMAT_RGB8: return 24;
         case RS2_FORMAT_BGR8: return 24;
@@ -147,42 +181,52 @@ namespace librealsense
         librealsense::copy(dest[0], source + input_reports_offset, input_reports_size);
     }
 
+    // The L500 images are rotated in square tiles, the source rows and the destination rows of a tile stay in cache
+    const int rotation_tile = 32;
+
     template<size_t SIZE>
     void rotate_270_degrees_clockwise(byte * const dest[], const byte * source, int width, int height)
     {
         auto out = dest[0];
-        for (int i = 0; i < height; ++i)
+        for (int i0 = 0; i0 < height; i0 += rotation_tile)
         {
-            auto row_offset = i * width;
-            for (int j = 0; j < width; ++j)
+            auto i1 = std::min(i0 + rotation_tile, height);
+            for (int j0 = 0; j0 < width; j0 += rotation_tile)
             {
-                auto out_index = ((((width - 1) - j) * height) + i) * SIZE;
-                librealsense::copy((void*)(&out[out_index]), &(source[(row_offset + j) * SIZE]), SIZE);
+                auto j1 = std::min(j0 + rotation_tile, width);
+                for (int j = j0; j < j1; ++j)
+                {
+                    auto dst = out + ((((width - 1) - j) * height) + i0) * SIZE;
+                    auto src = source + (i0 * width + j) * SIZE;
+                    for (int i = i0; i < i1; ++i, dst += SIZE, src += width * SIZE)
+                        memcpy(dst, src, SIZE);
+                }
             }
         }
     }
 
+    // Every byte holds two 4 bit confidence values. The rotated image has two rows per source column,
+    // the low nibbles and then the high nibbles, both scaled to 8 bits in the same pass
     void unpack_confidence(byte * const dest[], const byte * source, int width, int height)
     {
-#pragma pack (push, 1)
-        struct lsb_msb
-        {
-            unsigned lsb : 4;
-            unsigned msb : 4;
-        };
-#pragma pack(pop)
-
-        rotate_270_degrees_clockwise<1>(dest, source, width, height);
         auto out = dest[0];
-        for (int i = (width - 1), out_i = ((width - 1) * 2); i >= 0; --i, out_i-=2)
+        for (int i0 = 0; i0 < height; i0 += rotation_tile)
         {
-            auto row_offset = i * height;
-            for (int j = 0; j < height; ++j)
+            auto i1 = std::min(i0 + rotation_tile, height);
+            for (int j0 = 0; j0 < width; j0 += rotation_tile)
             {
-                auto val = *(reinterpret_cast<const lsb_msb*>(&out[(row_offset + j)]));
-                auto out_index = out_i * height + j;
-                out[out_index] = val.lsb << 4;
-                out[out_index + height] = val.msb << 4;
+                auto j1 = std::min(j0 + rotation_tile, width);
+                for (int j = j0; j < j1; ++j)
+                {
+                    auto lsb = out + ((width - 1) - j) * 2 * height;
+                    auto msb = lsb + height;
+                    auto src = source + i0 * width + j;
+                    for (int i = i0; i < i1; ++i, src += width)
+                    {
+                        lsb[i] = static_cast<byte>(*src << 4);
+                        msb[i] = *src & 0xf0;
+                    }
+                }
             }
         }
     }
@@ -205,9 +249,77 @@ namespace librealsense
         for (int i = 0; i < count; ++i) *out++ = unpack(*source++);
     }
 
-    void unpack_y16_from_y8(byte * const d[], const byte * s, int width, int height) { unpack_pixels(d, width * height, reinterpret_cast<const uint8_t *>(s), [](uint8_t  pixel) -> uint16_t { return pixel | pixel << 8; }); }
-    void unpack_y16_from_y16_10(byte * const d[], const byte * s, int width, int height) { unpack_pixels(d, width * height, reinterpret_cast<const uint16_t*>(s), [](uint16_t pixel) -> uint16_t { return pixel << 6; }); }
-    void unpack_y8_from_y16_10(byte * const d[], const byte * s, int width, int height) { unpack_pixels(d, width * height, reinterpret_cast<const uint16_t*>(s), [](uint16_t pixel) -> uint8_t  { return pixel >> 2; }); }
+#ifdef RS2_USE_AVX2
+    static const bool do_avx = has_avx();
+#endif
+
+    // The vectorized routines below handle as many pixels as their register width allows,
+    // and leave the remainder to the scalar loop that follows them
+    void y16_from_y8(uint16_t * out, const uint8_t * in, int count)
+    {
+        int i = 0;
+#ifdef RS2_USE_AVX2
+        if (do_avx) i = unpack_y16_from_y8_avx(out, in, count);
+#endif
+#if defined(__SSSE3__)
+        for (; i + 16 <= count; i += 16)
+        {
+            __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), _mm_unpacklo_epi8(y, y));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i + 8), _mm_unpackhi_epi8(y, y));
+        }
+#elif defined(RS2_NEON)
+        for (; i + 16 <= count; i += 16)
+        {
+            uint8x16_t y = vld1q_u8(in + i);
+            uint8x16x2_t yy = { { y, y } };
+            vst2q_u8(reinterpret_cast<uint8_t *>(out + i), yy);
+        }
+#endif
+        for (; i < count; ++i) out[i] = in[i] | in[i] << 8;
+    }
+
+    void y16_from_y16_10(uint16_t * out, const uint16_t * in, int count)
+    {
+        int i = 0;
+#ifdef RS2_USE_AVX2
+        if (do_avx) i = unpack_y16_from_y16_10_avx(out, in, count);
+#endif
+#if defined(__SSSE3__)
+        for (; i + 8 <= count; i += 8)
+        {
+            __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), _mm_slli_epi16(y, 6));
+        }
+#elif defined(RS2_NEON)
+        for (; i + 8 <= count; i += 8) vst1q_u16(out + i, vshlq_n_u16(vld1q_u16(in + i), 6));
+#endif
+        for (; i < count; ++i) out[i] = in[i] << 6;
+    }
+
+    void y8_from_y16_10(uint8_t * out, const uint16_t * in, int count)
+    {
+        int i = 0;
+#ifdef RS2_USE_AVX2
+        if (do_avx) i = unpack_y8_from_y16_10_avx(out, in, count);
+#endif
+#if defined(__SSSE3__)
+        const __m128i lsb = _mm_set1_epi16(0xFF);
+        for (; i + 16 <= count; i += 16)
+        {
+            __m128i lo = _mm_and_si128(_mm_srli_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i)), 2), lsb);
+            __m128i hi = _mm_and_si128(_mm_srli_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i + 8)), 2), lsb);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), _mm_packus_epi16(lo, hi));
+        }
+#elif defined(RS2_NEON)
+        for (; i + 8 <= count; i += 8) vst1_u8(out + i, vshrn_n_u16(vld1q_u16(in + i), 2));
+#endif
+        for (; i < count; ++i) out[i] = static_cast<uint8_t>(in[i] >> 2);
+    }
+
+    void unpack_y16_from_y8(byte * const d[], const byte * s, int width, int height) { y16_from_y8(reinterpret_cast<uint16_t *>(d[0]), reinterpret_cast<const uint8_t *>(s), width * height); }
+    void unpack_y16_from_y16_10(byte * const d[], const byte * s, int width, int height) { y16_from_y16_10(reinterpret_cast<uint16_t *>(d[0]), reinterpret_cast<const uint16_t *>(s), width * height); }
+    void unpack_y8_from_y16_10(byte * const d[], const byte * s, int width, int height) { y8_from_y16_10(reinterpret_cast<uint8_t *>(d[0]), reinterpret_cast<const uint16_t *>(s), width * height); }
     void unpack_rw10_from_rw8(byte *  const d[], const byte * s, int width, int height)
     {
 #ifdef __SSSE3__
@@ -225,6 +337,12 @@ namespace librealsense
             __m128i  out8 = _mm_packus_epi16(out1_16, out2_16);
             _mm_store_si128(xout, out8);
         }
+#elif defined(RS2_NEON)
+        auto from = reinterpret_cast<const uint16_t *>(s);
+        auto to = reinterpret_cast<uint8_t *>(d[0]);
+        int i = 0;
+        for (; i + 8 <= width * height; i += 8) vst1_u8(to + i, vshrn_n_u16(vld1q_u16(from + i), 2));
+        for (; i < width * height; ++i) to[i] = static_cast<uint8_t>(from[i] >> 2);
 #else  // Generic code for when SSSE3 is not available.
         unsigned short* from = (unsigned short*)s;
         byte * to = d[0];
@@ -303,6 +421,228 @@ namespace librealsense
     /////////////////////////////
     // YUY2 unpacking routines //
     /////////////////////////////
+#ifdef RS2_NEON
+    // Saturates ((x + 128) >> 8) to [0, 255], as the generic clamp() does
+    inline uint8x8_t yuv_clamp_neon(int32x4_t lo, int32x4_t hi)
+    {
+        const int32x4_t n128 = vdupq_n_s32(128);
+        return vqmovn_u16(vcombine_u16(vqmovun_s32(vshrq_n_s32(vaddq_s32(lo, n128), 8)),
+                                       vqmovun_s32(vshrq_n_s32(vaddq_s32(hi, n128), 8))));
+    }
+
+    // Converts 16 pixels sharing the same chroma, using the exact integer arithmetic of the generic code
+    inline void yuv_to_rgb_neon(uint8x16_t y, uint8x16_t u, uint8x16_t v, uint8x16_t& r, uint8x16_t& g, uint8x16_t& b)
+    {
+        int16x8_t c[2], d[2], e[2];
+        c[0] = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(vget_low_u8(y))), vdupq_n_s16(16));
+        c[1] = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(vget_high_u8(y))), vdupq_n_s16(16));
+        d[0] = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(vget_low_u8(u))), vdupq_n_s16(128));
+        d[1] = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(vget_high_u8(u))), vdupq_n_s16(128));
+        e[0] = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(vget_low_u8(v))), vdupq_n_s16(128));
+        e[1] = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(vget_high_u8(v))), vdupq_n_s16(128));
+
+        uint8x8_t rr[2], gg[2], bb[2];
+        for (int i = 0; i < 2; i++)
+        {
+            auto c_lo = vmull_n_s16(vget_low_s16(c[i]), 298), c_hi = vmull_n_s16(vget_high_s16(c[i]), 298);
+            rr[i] = yuv_clamp_neon(vmlal_n_s16(c_lo, vget_low_s16(e[i]), 409), vmlal_n_s16(c_hi, vget_high_s16(e[i]), 409));
+            gg[i] = yuv_clamp_neon(vmlsl_n_s16(vmlsl_n_s16(c_lo, vget_low_s16(d[i]), 100), vget_low_s16(e[i]), 208),
+                                   vmlsl_n_s16(vmlsl_n_s16(c_hi, vget_high_s16(d[i]), 100), vget_high_s16(e[i]), 208));
+            bb[i] = yuv_clamp_neon(vmlal_n_s16(c_lo, vget_low_s16(d[i]), 516), vmlal_n_s16(c_hi, vget_high_s16(d[i]), 516));
+        }
+        r = vcombine_u8(rr[0], rr[1]);
+        g = vcombine_u8(gg[0], gg[1]);
+        b = vcombine_u8(bb[0], bb[1]);
+    }
+
+    // Unpacks 32 YUV 4:2:2 pixels, given as de-interleaved even/odd luma and shared chroma components
+    template<rs2_format FORMAT> void unpack_yuv422_neon(uint8_t * dst, uint8x16_t y_even, uint8x16_t y_odd, uint8x16_t u, uint8x16_t v)
+    {
+        auto y = vzipq_u8(y_even, y_odd);
+        if (FORMAT == RS2_FORMAT_Y8)
+        {
+            vst1q_u8(dst, y.val[0]);
+            vst1q_u8(dst + 16, y.val[1]);
+            return;
+        }
+
+        if (FORMAT == RS2_FORMAT_Y16)
+        {
+            // Y16 is little-endian.  We output Y << 8.
+            uint8x16x2_t lo = { { vdupq_n_u8(0), y.val[0] } };
+            uint8x16x2_t hi = { { vdupq_n_u8(0), y.val[1] } };
+            vst2q_u8(dst, lo);
+            vst2q_u8(dst + 32, hi);
+            return;
+        }
+
+        uint8x16_t r_even, g_even, b_even, r_odd, g_odd, b_odd;
+        yuv_to_rgb_neon(y_even, u, v, r_even, g_even, b_even);
+        yuv_to_rgb_neon(y_odd, u, v, r_odd, g_odd, b_odd);
+        auto r = vzipq_u8(r_even, r_odd);
+        auto g = vzipq_u8(g_even, g_odd);
+        auto b = vzipq_u8(b_even, b_odd);
+
+        for (int i = 0; i < 2; i++)
+        {
+            if (FORMAT == RS2_FORMAT_RGB8)
+            {
+                uint8x16x3_t out = { { r.val[i], g.val[i], b.val[i] } };
+                vst3q_u8(dst + i * 48, out);
+            }
+            if (FORMAT == RS2_FORMAT_BGR8)
+            {
+                uint8x16x3_t out = { { b.val[i], g.val[i], r.val[i] } };
+                vst3q_u8(dst + i * 48, out);
+            }
+            if (FORMAT == RS2_FORMAT_RGBA8)
+            {
+                uint8x16x4_t out = { { r.val[i], g.val[i], b.val[i], vdupq_n_u8(255) } };
+                vst4q_u8(dst + i * 64, out);
+            }
+            if (FORMAT == RS2_FORMAT_BGRA8)
+            {
+                uint8x16x4_t out = { { b.val[i], g.val[i], r.val[i], vdupq_n_u8(255) } };
+                vst4q_u8(dst + i * 64, out);
+            }
+        }
+    }
+#endif
+
+    // Reference implementation, also used for the pixels left over by the vectorized paths
+    template<rs2_format FORMAT> void unpack_yuy2_generic(uint8_t * dst, const uint8_t * src, int n)
+    {
+        for (; n; n -= 16, src += 32)
+        {
+            if (FORMAT == RS2_FORMAT_Y8)
+            {
+                uint8_t out[16] = {
+                    src[0], src[2], src[4], src[6],
+                    src[8], src[10], src[12], src[14],
+                    src[16], src[18], src[20], src[22],
+                    src[24], src[26], src[28], src[30],
+                };
+                librealsense::copy(dst, out, sizeof out);
+                dst += sizeof out;
+                continue;
+            }
+
+            if (FORMAT == RS2_FORMAT_Y16)
+            {
+                // Y16 is little-endian.  We output Y << 8.
+                uint8_t out[32] = {
+                    0, src[0], 0, src[2], 0, src[4], 0, src[6],
+                    0, src[8], 0, src[10], 0, src[12], 0, src[14],
+                    0, src[16], 0, src[18], 0, src[20], 0, src[22],
+                    0, src[24], 0, src[26], 0, src[28], 0, src[30],
+                };
+                librealsense::copy(dst, out, sizeof out);
+                dst += sizeof out;
+                continue;
+            }
+
+            int16_t y[16] = {
+                src[0], src[2], src[4], src[6],
+                src[8], src[10], src[12], src[14],
+                src[16], src[18], src[20], src[22],
+                src[24], src[26], src[28], src[30],
+            }, u[16] = {
+                src[1], src[1], src[5], src[5],
+                src[9], src[9], src[13], src[13],
+                src[17], src[17], src[21], src[21],
+                src[25], src[25], src[29], src[29],
+            }, v[16] = {
+                src[3], src[3], src[7], src[7],
+                src[11], src[11], src[15], src[15],
+                src[19], src[19], src[23], src[23],
+                src[27], src[27], src[31], src[31],
+            };
+
+            uint8_t r[16], g[16], b[16];
+            for (int i = 0; i < 16; i++)
+            {
+                int32_t c = y[i] - 16;
+                int32_t d = u[i] - 128;
+                int32_t e = v[i] - 128;
+
+                int32_t t;
+                #define clamp(x)  ((t=(x)) > 255 ? 255 : t < 0 ? 0 : t)
+                r[i] = clamp((298 * c + 409 * e + 128) >> 8);
+                g[i] = clamp((298 * c - 100 * d - 208 * e + 128) >> 8);
+                b[i] = clamp((298 * c + 516 * d + 128) >> 8);
+                #undef clamp
+            }
+
+            if (FORMAT == RS2_FORMAT_RGB8)
+            {
+                uint8_t out[16 * 3] = {
+                    r[0], g[0], b[0], r[1], g[1], b[1],
+                    r[2], g[2], b[2], r[3], g[3], b[3],
+                    r[4], g[4], b[4], r[5], g[5], b[5],
+                    r[6], g[6], b[6], r[7], g[7], b[7],
+                    r[8], g[8], b[8], r[9], g[9], b[9],
+                    r[10], g[10], b[10], r[11], g[11], b[11],
+                    r[12], g[12], b[12], r[13], g[13], b[13],
+                    r[14], g[14], b[14], r[15], g[15], b[15],
+                };
+                librealsense::copy(dst, out, sizeof out);
+                dst += sizeof out;
+                continue;
+            }
+
+            if (FORMAT == RS2_FORMAT_BGR8)
+            {
+                uint8_t out[16 * 3] = {
+                    b[0], g[0], r[0], b[1], g[1], r[1],
+                    b[2], g[2], r[2], b[3], g[3], r[3],
+                    b[4], g[4], r[4], b[5], g[5], r[5],
+                    b[6], g[6], r[6], b[7], g[7], r[7],
+                    b[8], g[8], r[8], b[9], g[9], r[9],
+                    b[10], g[10], r[10], b[11], g[11], r[11],
+                    b[12], g[12], r[12], b[13], g[13], r[13],
+                    b[14], g[14], r[14], b[15], g[15], r[15],
+                };
+                librealsense::copy(dst, out, sizeof out);
+                dst += sizeof out;
+                continue;
+            }
+
+            if (FORMAT == RS2_FORMAT_RGBA8)
+            {
+                uint8_t out[16 * 4] = {
+                    r[0], g[0], b[0], 255, r[1], g[1], b[1], 255,
+                    r[2], g[2], b[2], 255, r[3], g[3], b[3], 255,
+                    r[4], g[4], b[4], 255, r[5], g[5], b[5], 255,
+                    r[6], g[6], b[6], 255, r[7], g[7], b[7], 255,
+                    r[8], g[8], b[8], 255, r[9], g[9], b[9], 255,
+                    r[10], g[10], b[10], 255, r[11], g[11], b[11], 255,
+                    r[12], g[12], b[12], 255, r[13], g[13], b[13], 255,
+                    r[14], g[14], b[14], 255, r[15], g[15], b[15], 255,
+                };
+                librealsense::copy(dst, out, sizeof out);
+                dst += sizeof out;
+                continue;
+            }
+
+            if (FORMAT == RS2_FORMAT_BGRA8)
+            {
+                uint8_t out[16 * 4] = {
+                    b[0], g[0], r[0], 255, b[1], g[1], r[1], 255,
+                    b[2], g[2], r[2], 255, b[3], g[3], r[3], 255,
+                    b[4], g[4], r[4], 255, b[5], g[5], r[5], 255,
+                    b[6], g[6], r[6], 255, b[7], g[7], r[7], 255,
+                    b[8], g[8], r[8], 255, b[9], g[9], r[9], 255,
+                    b[10], g[10], r[10], 255, b[11], g[11], r[11], 255,
+                    b[12], g[12], r[12], 255, b[13], g[13], r[13], 255,
+                    b[14], g[14], r[14], 255, b[15], g[15], r[15], 255,
+                };
+                librealsense::copy(dst, out, sizeof out);
+                dst += sizeof out;
+                continue;
+            }
+        }
+    }
+
     // This templated function unpacks YUY2 into Y8/Y16/RGB8/RGBA8/BGR8/BGRA8, depending on the compile-time parameter FORMAT.
     // It is expected that all branching outside of the loop control variable will be removed due to constant-folding.
     template<rs2_format FORMAT> void unpack_yuy2(byte * const d[], const byte * s, int width, int height)
@@ -310,23 +650,26 @@ namespace librealsense
         auto n = width * height;
         assert(n % 16 == 0); // All currently supported color resolutions are multiples of 16 pixels. Could easily extend support to other resolutions by copying final n<16 pixels into a zero-padded buffer and recursively calling self for final iteration.
 #ifdef RS2_USE_CUDA
-        rscuda::unpack_yuy2_cuda<FORMAT>(d, s, n);
+        // The device has no Y8 kernel
+        if (FORMAT != RS2_FORMAT_Y8)
+        {
+            rscuda::unpack_yuy2_cuda<FORMAT>(d, s, n);
+            return;
+        }
+#endif
+#ifdef RS2_USE_AVX2
+        if (do_avx && !(n % 32))
+        {
+            if (FORMAT == RS2_FORMAT_Y8) unpack_yuy2_avx_y8(d, s, n);
+            if (FORMAT == RS2_FORMAT_Y16) unpack_yuy2_avx_y16(d, s, n);
+            if (FORMAT == RS2_FORMAT_RGB8) unpack_yuy2_avx_rgb8(d, s, n);
+            if (FORMAT == RS2_FORMAT_RGBA8) unpack_yuy2_avx_rgba8(d, s, n);
+            if (FORMAT == RS2_FORMAT_BGR8) unpack_yuy2_avx_bgr8(d, s, n);
+            if (FORMAT == RS2_FORMAT_BGRA8) unpack_yuy2_avx_bgra8(d, s, n);
+            return;
+        }
 #endif
 #if defined __SSSE3__ && ! defined ANDROID
-        static bool do_avx = has_avx();
-        #ifdef __AVX2__
-
-                if (do_avx)
-                {
-                    if (FORMAT == RS2_FORMAT_Y8) unpack_yuy2_avx_y8(d, s, n);
-                    if (FORMAT == RS2_FORMAT_Y16) unpack_yuy2_avx_y16(d, s, n);
-                    if (FORMAT == RS2_FORMAT_RGB8) unpack_yuy2_avx_rgb8(d, s, n);
-                    if (FORMAT == RS2_FORMAT_RGBA8) unpack_yuy2_avx_rgba8(d, s, n);
-                    if (FORMAT == RS2_FORMAT_BGR8) unpack_yuy2_avx_bgr8(d, s, n);
-                    if (FORMAT == RS2_FORMAT_BGRA8) unpack_yuy2_avx_bgra8(d, s, n);
-                }
-                else
-        #endif
         {
             auto src = reinterpret_cast<const __m128i *>(s);
             auto dst = reinterpret_cast<__m128i *>(d[0]);
@@ -472,53 +815,40 @@ namespace librealsense
                 }
             }
         }
-#else  // Generic code for when SSSE3 is not available.
+#elif defined(RS2_NEON)
         auto src = reinterpret_cast<const uint8_t *>(s);
         auto dst = reinterpret_cast<uint8_t *>(d[0]);
-        for (; n; n -= 16, src += 32)
+        for (; n >= 32; n -= 32, src += 64, dst += 32 * get_image_bpp(FORMAT) / 8)
         {
-            if (FORMAT == RS2_FORMAT_Y8)
-            {
-                uint8_t out[16] = {
-                    src[0], src[2], src[4], src[6],
-                    src[8], src[10], src[12], src[14],
-                    src[16], src[18], src[20], src[22],
-                    src[24], src[26], src[28], src[30],
-                };
-                librealsense::copy(dst, out, sizeof out);
-                dst += sizeof out;
-                continue;
-            }
-
-            if (FORMAT == RS2_FORMAT_Y16)
-            {
-                // Y16 is little-endian.  We output Y << 8.
-                uint8_t out[32] = {
-                    0, src[0], 0, src[2], 0, src[4], 0, src[6],
-                    0, src[8], 0, src[10], 0, src[12], 0, src[14],
-                    0, src[16], 0, src[18], 0, src[20], 0, src[22],
-                    0, src[24], 0, src[26], 0, src[28], 0, src[30],
-                };
-                librealsense::copy(dst, out, sizeof out);
-                dst += sizeof out;
-                continue;
-            }
+            // De-interleave 32 pixels into even Y, U, odd Y and V components
+            auto yuyv = vld4q_u8(src);
+            unpack_yuv422_neon<FORMAT>(dst, yuyv.val[0], yuyv.val[2], yuyv.val[1], yuyv.val[3]);
+        }
+        unpack_yuy2_generic<FORMAT>(dst, src, n);
+#else
+        unpack_yuy2_generic<FORMAT>(reinterpret_cast<uint8_t *>(d[0]), reinterpret_cast<const uint8_t *>(s), n);
+#endif
+    }
 
+    template<rs2_format FORMAT> void unpack_uyvy_generic(uint8_t * dst, const uint8_t * src, int n)
+    {
+        for (; n; n -= 16, src += 32)
+        {
             int16_t y[16] = {
-                src[0], src[2], src[4], src[6],
-                src[8], src[10], src[12], src[14],
-                src[16], src[18], src[20], src[22],
-                src[24], src[26], src[28], src[30],
+                src[1], src[3], src[5], src[7],
+                src[9], src[11], src[13], src[15],
+                src[17], src[19], src[21], src[23],
+                src[25], src[27], src[29], src[31],
             }, u[16] = {
-                src[1], src[1], src[5], src[5],
-                src[9], src[9], src[13], src[13],
-                src[17], src[17], src[21], src[21],
-                src[25], src[25], src[29], src[29],
+                src[0], src[0], src[4], src[4],
+                src[8], src[8], src[12], src[12],
+                src[16], src[16], src[20], src[20],
+                src[24], src[24], src[28], src[28],
             }, v[16] = {
-                src[3], src[3], src[7], src[7],
-                src[11], src[11], src[15], src[15],
-                src[19], src[19], src[23], src[23],
-                src[27], src[27], src[31], src[31],
+                src[2], src[2], src[6], src[6],
+                src[10], src[10], src[14], src[14],
+                src[18], src[18], src[22], src[22],
+                src[26], src[26], src[30], src[30],
             };
 
             uint8_t r[16], g[16], b[16];
@@ -529,11 +859,11 @@ namespace librealsense
                 int32_t e = v[i] - 128;
 
                 int32_t t;
-                #define clamp(x)  ((t=(x)) > 255 ? 255 : t < 0 ? 0 : t)
+#define clamp(x)  ((t=(x)) > 255 ? 255 : t < 0 ? 0 : t)
                 r[i] = clamp((298 * c + 409 * e + 128) >> 8);
                 g[i] = clamp((298 * c - 100 * d - 208 * e + 128) >> 8);
                 b[i] = clamp((298 * c + 516 * d + 128) >> 8);
-                #undef clamp
+#undef clamp
             }
 
             if (FORMAT == RS2_FORMAT_RGB8)
@@ -604,7 +934,6 @@ namespace librealsense
                 continue;
             }
         }
-    #endif
     }
 
     // This templated function unpacks UYVY into RGB8/RGBA8/BGR8/BGRA8, depending on the compile-time parameter FORMAT.
@@ -613,6 +942,16 @@ namespace librealsense
     {
         auto n = width * height;
         assert(n % 16 == 0); // All currently supported color resolutions are multiples of 16 pixels. Could easily extend support to other resolutions by copying final n<16 pixels into a zero-padded buffer and recursively calling self for final iteration.
+#ifdef RS2_USE_AVX2
+        if (do_avx && !(n % 32))
+        {
+            if (FORMAT == RS2_FORMAT_RGB8) unpack_uyvy_avx_rgb8(d, s, n);
+            if (FORMAT == RS2_FORMAT_RGBA8) unpack_uyvy_avx_rgba8(d, s, n);
+            if (FORMAT == RS2_FORMAT_BGR8) unpack_uyvy_avx_bgr8(d, s, n);
+            if (FORMAT == RS2_FORMAT_BGRA8) unpack_uyvy_avx_bgra8(d, s, n);
+            return;
+        }
+#endif
 #ifdef __SSSE3__
         auto src = reinterpret_cast<const __m128i *>(s);
         auto dst = reinterpret_cast<__m128i *>(d[0]);
@@ -740,111 +1079,18 @@ namespace librealsense
                 }
             }
         }
-#else  // Generic code for when SSSE3 is not available.
+#elif defined(RS2_NEON)
         auto src = reinterpret_cast<const uint8_t *>(s);
         auto dst = reinterpret_cast<uint8_t *>(d[0]);
-        for (; n; n -= 16, src += 32)
+        for (; n >= 32; n -= 32, src += 64, dst += 32 * get_image_bpp(FORMAT) / 8)
         {
-            int16_t y[16] = {
-                src[1], src[3], src[5], src[7],
-                src[9], src[11], src[13], src[15],
-                src[17], src[19], src[21], src[23],
-                src[25], src[27], src[29], src[31],
-            }, u[16] = {
-                src[0], src[0], src[4], src[4],
-                src[8], src[8], src[12], src[12],
-                src[16], src[16], src[20], src[20],
-                src[24], src[24], src[28], src[28],
-            }, v[16] = {
-                src[2], src[2], src[6], src[6],
-                src[10], src[10], src[14], src[14],
-                src[18], src[18], src[22], src[22],
-                src[26], src[26], src[30], src[30],
-            };
-
-            uint8_t r[16], g[16], b[16];
-            for (int i = 0; i < 16; i++)
-            {
-                int32_t c = y[i] - 16;
-                int32_t d = u[i] - 128;
-                int32_t e = v[i] - 128;
-
-                int32_t t;
-#define clamp(x)  ((t=(x)) > 255 ? 255 : t < 0 ? 0 : t)
-                r[i] = clamp((298 * c + 409 * e + 128) >> 8);
-                g[i] = clamp((298 * c - 100 * d - 208 * e + 128) >> 8);
-                b[i] = clamp((298 * c + 516 * d + 128) >> 8);
-#undef clamp
-            }
-
-            if (FORMAT == RS2_FORMAT_RGB8)
-            {
-                uint8_t out[16 * 3] = {
-                    r[0], g[0], b[0], r[1], g[1], b[1],
-                    r[2], g[2], b[2], r[3], g[3], b[3],
-                    r[4], g[4], b[4], r[5], g[5], b[5],
-                    r[6], g[6], b[6], r[7], g[7], b[7],
-                    r[8], g[8], b[8], r[9], g[9], b[9],
-                    r[10], g[10], b[10], r[11], g[11], b[11],
-                    r[12], g[12], b[12], r[13], g[13], b[13],
-                    r[14], g[14], b[14], r[15], g[15], b[15],
-                };
-                librealsense::copy(dst, out, sizeof out);
-                dst += sizeof out;
-                continue;
-            }
-
-            if (FORMAT == RS2_FORMAT_BGR8)
-            {
-                uint8_t out[16 * 3] = {
-                    b[0], g[0], r[0], b[1], g[1], r[1],
-                    b[2], g[2], r[2], b[3], g[3], r[3],
-                    b[4], g[4], r[4], b[5], g[5], r[5],
-                    b[6], g[6], r[6], b[7], g[7], r[7],
-                    b[8], g[8], r[8], b[9], g[9], r[9],
-                    b[10], g[10], r[10], b[11], g[11], r[11],
-                    b[12], g[12], r[12], b[13], g[13], r[13],
-                    b[14], g[14], r[14], b[15], g[15], r[15],
-                };
-                librealsense::copy(dst, out, sizeof out);
-                dst += sizeof out;
-                continue;
-            }
-
-            if (FORMAT == RS2_FORMAT_RGBA8)
-            {
-                uint8_t out[16 * 4] = {
-                    r[0], g[0], b[0], 255, r[1], g[1], b[1], 255,
-                    r[2], g[2], b[2], 255, r[3], g[3], b[3], 255,
-                    r[4], g[4], b[4], 255, r[5], g[5], b[5], 255,
-                    r[6], g[6], b[6], 255, r[7], g[7], b[7], 255,
-                    r[8], g[8], b[8], 255, r[9], g[9], b[9], 255,
-                    r[10], g[10], b[10], 255, r[11], g[11], b[11], 255,
-                    r[12], g[12], b[12], 255, r[13], g[13], b[13], 255,
-                    r[14], g[14], b[14], 255, r[15], g[15], b[15], 255,
-                };
-                librealsense::copy(dst, out, sizeof out);
-                dst += sizeof out;
-                continue;
-            }
-
-            if (FORMAT == RS2_FORMAT_BGRA8)
-            {
-                uint8_t out[16 * 4] = {
-                    b[0], g[0], r[0], 255, b[1], g[1], r[1], 255,
-                    b[2], g[2], r[2], 255, b[3], g[3], r[3], 255,
-                    b[4], g[4], r[4], 255, b[5], g[5], r[5], 255,
-                    b[6], g[6], r[6], 255, b[7], g[7], r[7], 255,
-                    b[8], g[8], r[8], 255, b[9], g[9], r[9], 255,
-                    b[10], g[10], r[10], 255, b[11], g[11], r[11], 255,
-                    b[12], g[12], r[12], 255, b[13], g[13], r[13], 255,
-                    b[14], g[14], r[14], 255, b[15], g[15], r[15], 255,
-                };
-                librealsense::copy(dst, out, sizeof out);
-                dst += sizeof out;
-                continue;
-            }
+            // De-interleave 32 pixels into U, even Y, V and odd Y components
+            auto uyvy = vld4q_u8(src);
+            unpack_yuv422_neon<FORMAT>(dst, uyvy.val[1], uyvy.val[3], uyvy.val[0], uyvy.val[2]);
         }
+        unpack_uyvy_generic<FORMAT>(dst, src, n);
+#else
+        unpack_uyvy_generic<FORMAT>(reinterpret_cast<uint8_t *>(d[0]), reinterpret_cast<const uint8_t *>(s), n);
 #endif
     }
 
@@ -870,9 +1116,35 @@ namespace librealsense
 #ifdef RS2_USE_CUDA
         rscuda::split_frame_y8_y8_from_y8i_cuda(dest, count, reinterpret_cast<const y8i_pixel *>(source));
 #else
-        split_frame(dest, count, reinterpret_cast<const y8i_pixel*>(source),
-            [](const y8i_pixel & p) -> uint8_t { return p.l; },
-            [](const y8i_pixel & p) -> uint8_t { return p.r; });
+        auto in = reinterpret_cast<const uint8_t *>(source);
+        auto l = reinterpret_cast<uint8_t *>(dest[0]);
+        auto r = reinterpret_cast<uint8_t *>(dest[1]);
+        int i = 0;
+#ifdef RS2_USE_AVX2
+        if (do_avx) i = unpack_y8_y8_from_y8i_avx(l, r, in, count);
+#endif
+#if defined(__SSSE3__)
+        const __m128i evens_odds = _mm_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15);
+        for (; i + 16 <= count; i += 16)
+        {
+            __m128i lr0 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i * 2)), evens_odds);
+            __m128i lr1 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i * 2 + 16)), evens_odds);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(l + i), _mm_unpacklo_epi64(lr0, lr1));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(r + i), _mm_unpackhi_epi64(lr0, lr1));
+        }
+#elif defined(RS2_NEON)
+        for (; i + 16 <= count; i += 16)
+        {
+            uint8x16x2_t lr = vld2q_u8(in + i * 2);
+            vst1q_u8(l + i, lr.val[0]);
+            vst1q_u8(r + i, lr.val[1]);
+        }
+#endif
+        for (; i < count; ++i)
+        {
+            l[i] = in[i * 2];
+            r[i] = in[i * 2 + 1];
+        }
 #endif
     }
 
@@ -883,9 +1155,40 @@ namespace librealsense
 #ifdef RS2_USE_CUDA
     rscuda::split_frame_y16_y16_from_y12i_cuda(dest, count, reinterpret_cast<const y12i_pixel *>(source));
 #else
-        split_frame(dest, count, reinterpret_cast<const y12i_pixel*>(source),
-        [](const y12i_pixel & p) -> uint16_t { return p.l() << 6 | p.l() >> 4; },  // We want to convert 10-bit data to 16-bit data
-        [](const y12i_pixel & p) -> uint16_t { return p.r() << 6 | p.r() >> 4; }); // Multiply by 64 1/16 to efficiently approximate 65535/1023
+        auto in = reinterpret_cast<const uint8_t *>(source);
+        auto l = reinterpret_cast<uint16_t *>(dest[0]);
+        auto r = reinterpret_cast<uint16_t *>(dest[1]);
+        int i = 0;
+#if defined(__SSSE3__)
+        // Each 16-byte load covers five pixels; gather four of them into 16-bit lanes holding (r, l) sharing the middle byte
+        const __m128i r_mask = _mm_setr_epi8(0, 1, 3, 4, 6, 7, 9, 10, -1, -1, -1, -1, -1, -1, -1, -1);
+        const __m128i l_mask = _mm_setr_epi8(1, 2, 4, 5, 7, 8, 10, 11, -1, -1, -1, -1, -1, -1, -1, -1);
+        const __m128i r_bits = _mm_set1_epi16(0x0FFF);
+        for (; i + 10 <= count; i += 8)
+        {
+            __m128i p0 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i * 3));
+            __m128i p1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i * 3 + 12));
+            __m128i rv = _mm_and_si128(_mm_unpacklo_epi64(_mm_shuffle_epi8(p0, r_mask), _mm_shuffle_epi8(p1, r_mask)), r_bits);
+            __m128i lv = _mm_srli_epi16(_mm_unpacklo_epi64(_mm_shuffle_epi8(p0, l_mask), _mm_shuffle_epi8(p1, l_mask)), 4);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(l + i), _mm_or_si128(_mm_slli_epi16(lv, 6), _mm_srli_epi16(lv, 4)));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(r + i), _mm_or_si128(_mm_slli_epi16(rv, 6), _mm_srli_epi16(rv, 4)));
+        }
+#elif defined(RS2_NEON)
+        for (; i + 8 <= count; i += 8)
+        {
+            uint8x8x3_t p = vld3_u8(in + i * 3);
+            uint16x8_t rv = vorrq_u16(vmovl_u8(p.val[0]), vshlq_n_u16(vmovl_u8(vand_u8(p.val[1], vdup_n_u8(0x0F))), 8));
+            uint16x8_t lv = vorrq_u16(vshlq_n_u16(vmovl_u8(p.val[2]), 4), vmovl_u8(vshr_n_u8(p.val[1], 4)));
+            vst1q_u16(l + i, vorrq_u16(vshlq_n_u16(lv, 6), vshrq_n_u16(lv, 4)));
+            vst1q_u16(r + i, vorrq_u16(vshlq_n_u16(rv, 6), vshrq_n_u16(rv, 4)));
+        }
+#endif
+        auto px = reinterpret_cast<const y12i_pixel *>(in) + i;
+        for (; i < count; ++i, ++px)
+        {
+            l[i] = px->l() << 6 | px->l() >> 4;  // We want to convert 10-bit data to 16-bit data
+            r[i] = px->r() << 6 | px->r() >> 4;  // Multiply by 64 1/16 to efficiently approximate 65535/1023
+        }
 #endif
     }
 
@@ -914,9 +1217,9 @@ namespace librealsense
 #ifdef RS2_USE_CUDA
         rscuda::unpack_z16_y8_from_sr300_inzi_cuda(out_ir, in, count);
 #else
-        for (int i = 0; i < count; ++i) *out_ir++ = *in++ >> 2;
+        y8_from_y16_10(out_ir, in, count);
 #endif
-        librealsense::copy(dest[0], in, count * 2);
+        librealsense::copy(dest[0], in + count, count * 2);
     }
 
     void unpack_z16_y16_from_sr300_inzi (byte * const dest[], const byte * source, int width, int height)
@@ -927,9 +1230,9 @@ namespace librealsense
 #ifdef RS2_USE_CUDA
         rscuda::unpack_z16_y16_from_sr300_inzi_cuda(out_ir, in, count);
 #else
-        for (int i = 0; i < count; ++i) *out_ir++ = *in++ << 6;
+        y16_from_y16_10(out_ir, in, count);
 #endif
-        librealsense::copy(dest[0], in, count * 2);
+        librealsense::copy(dest[0], in + count, count * 2);
     }
 
     void unpack_rgb_from_bgr(byte * const dest[], const byte * source, int width, int height)
@@ -938,14 +1241,31 @@ namespace librealsense
         auto in = reinterpret_cast<const uint8_t *>(source);
         auto out = reinterpret_cast<uint8_t *>(dest[0]);
 
-        librealsense::copy(out, in, count * 3);
-        for (auto i = 0; i < count; i++)
+        int i = 0;
+#if defined(__SSSE3__)
+        // Five pixels per 16-byte load, the last byte belongs to the next pixel and is rewritten by the following store
+        const __m128i swap_rb = _mm_setr_epi8(2, 1, 0, 5, 4, 3, 8, 7, 6, 11, 10, 9, 14, 13, 12, 15);
+        for (; i + 6 <= count; i += 5)
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i * 3), _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i * 3)), swap_rb));
+#elif defined(RS2_NEON)
+        for (; i + 16 <= count; i += 16)
+        {
+            uint8x16x3_t bgr = vld3q_u8(in + i * 3);
+            uint8x16x3_t rgb = { { bgr.val[2], bgr.val[1], bgr.val[0] } };
+            vst3q_u8(out + i * 3, rgb);
+        }
+#endif
+        for (; i < count; i++)
         {
-            std::swap(out[i * 3], out[i * 3 + 2]);
+            out[i * 3] = in[i * 3 + 2];
+            out[i * 3 + 1] = in[i * 3 + 1];
+            out[i * 3 + 2] = in[i * 3];
         }
     }
 
-#ifdef ZERO_COPY
+    // The V4L2 backend re-queues kernel buffers only once the frames referencing them are released,
+    // so natively-formatted streams can be published without copying (bounded by uvc_sensor)
+#if defined(ZERO_COPY) || defined(RS2_USE_V4L2_BACKEND)
     constexpr bool requires_processing = false;
 #else
     constexpr bool requires_processing = true;
@@ -979,6 +1299,9 @@ namespace librealsense
                                                                                { true,                &unpack_yuy2<RS2_FORMAT_BGR8 >,                { { RS2_STREAM_COLOR,          RS2_FORMAT_BGR8 } } },
                                                                                { true,                &unpack_yuy2<RS2_FORMAT_BGRA8>,                { { RS2_STREAM_COLOR,          RS2_FORMAT_BGRA8 } } } } };
 
+    // Motion-JPEG frames keep their compressed size, the backend buffer is handed out as a single row of bytes
+    const native_pixel_format pf_mjpeg                    = { 'MJPG', 1, 1, {  { false,               &copy_pixels<1>,                               { { RS2_STREAM_COLOR,          RS2_FORMAT_MJPEG } } } } };
+
     const native_pixel_format pf_confidence_l500          = { 'C   ', 1, 1, {  { true,                &unpack_confidence,                            { { RS2_STREAM_CONFIDENCE,     RS2_FORMAT_RAW8, l500_confidence_resolution } } },
                                                                                { requires_processing, &copy_pixels<1>,                               { { RS2_STREAM_CONFIDENCE,     RS2_FORMAT_RAW8 } } } } };
     const native_pixel_format pf_z16_l500                 = { 'Z16 ', 1, 2, {  { true,                &rotate_270_degrees_clockwise<2>,              { { RS2_STREAM_DEPTH,          RS2_FORMAT_Z16,  rotate_resolution } } },
@@ -988,7 +1311,9 @@ namespace librealsense
     const native_pixel_format pf_y8                       = { 'GREY', 1, 1, {  { requires_processing, &copy_pixels<1>,                             { { { RS2_STREAM_INFRARED, 1 },  RS2_FORMAT_Y8  } } } } };
     const native_pixel_format pf_y16                      = { 'Y16 ', 1, 2, {  { true,                &unpack_y16_from_y16_10,                     { { { RS2_STREAM_INFRARED, 1 },  RS2_FORMAT_Y16 } } } } };
     const native_pixel_format pf_y8i                      = { 'Y8I ', 1, 2, {  { true,                &unpack_y8_y8_from_y8i,                      { { { RS2_STREAM_INFRARED, 1 },  RS2_FORMAT_Y8  },
-                                                                                                                                                     { { RS2_STREAM_INFRARED, 2 },  RS2_FORMAT_Y8 } } } } };
+                                                                                                                                                     { { RS2_STREAM_INFRARED, 2 },  RS2_FORMAT_Y8 } } },
+                                                                               // Opt-in passthrough: both images in a single frame, exposed as the left infrared stream
+                                                                               { requires_processing, &copy_pixels<2>,                             { { { RS2_STREAM_INFRARED, 1 },  RS2_FORMAT_Y8I } } } } };
     const native_pixel_format pf_y12i                     = { 'Y12I', 1, 3, {  { true,                &unpack_y16_y16_from_y12i_10,                { { { RS2_STREAM_INFRARED, 1 },  RS2_FORMAT_Y16 },
                                                                                                                                                      { { RS2_STREAM_INFRARED, 2 },  RS2_FORMAT_Y16 } } } } };
     const native_pixel_format pf_z16                      = { 'Z16 ', 1, 2, {  { requires_processing, &copy_pixels<2>,                               { { RS2_STREAM_DEPTH,          RS2_FORMAT_Z16 } } },
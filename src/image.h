@@ -6,12 +6,14 @@
 #define LIBREALSENSE_IMAGE_H
 
 #include "types.h"
+#include "core/device-memory.h"
 
 namespace librealsense
 {
 
     size_t           get_image_size                 (int width, int height, rs2_format format);
     int              get_image_bpp                  (rs2_format format);
+    bool             is_compressed_format           (rs2_format format);
     void             deproject_z                    (float * points, const rs2_intrinsics & z_intrin, const uint16_t * z_pixels, float z_scale);
     void             deproject_disparity            (float * points, const rs2_intrinsics & disparity_intrin, const uint16_t * disparity_pixels, float disparity_scale);
 
@@ -35,6 +37,7 @@ namespace librealsense
     extern const native_pixel_format pf_bayer16;    // 16-bit Bayer raw
     extern const native_pixel_format pf_yuy2;       // Y0 U Y1 V ordered chroma subsampled macropixel
     extern const native_pixel_format pf_yuyv;       // Y0 U Y1 V ordered chroma subsampled macropixel
+    extern const native_pixel_format pf_mjpeg;      // Motion-JPEG compressed color image
     extern const native_pixel_format pf_y8;         // 8 bit IR/Luminosity (left) imager
     extern const native_pixel_format pf_y8i;        // 8 bits left IR + 8 bits right IR per pixel
     extern const native_pixel_format pf_y16;        // 16 bit (left) IR image
@@ -53,6 +56,31 @@ namespace librealsense
     extern const native_pixel_format pf_confidence_l500;
     extern const native_pixel_format pf_z16_l500;
     extern const native_pixel_format pf_y8_l500;
+
+    // The packed image of a frame, attached as its stale device memory so that the single output unpacker runs
+    // the first time the frame data is read. The owner keeps the packed image alive
+    class deferred_unpack : public device_memory
+    {
+    public:
+        deferred_unpack(void(*unpack)(byte * const dest[], const byte * source, int width, int height),
+            const byte* source, int width, int height, size_t size, std::shared_ptr<const void> owner = nullptr)
+            : _unpack(unpack), _source(source), _width(width), _height(height), _size(size), _owner(std::move(owner)) {}
+
+        void* get() const override { return const_cast<byte*>(_source); }
+        size_t size() const override { return _size; }
+        void download(void* host) const override
+        {
+            byte* const dest[] = { static_cast<byte*>(host) };
+            _unpack(dest, _source, _width, _height);
+        }
+
+    private:
+        void(*_unpack)(byte * const dest[], const byte * source, int width, int height);
+        const byte* _source;
+        int _width, _height;
+        size_t _size;
+        std::shared_ptr<const void> _owner;
+    };
 }
 
 #endif
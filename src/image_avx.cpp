@@ -8,14 +8,15 @@
 //#include "../include/librealsense2/rsutil.h" // For projection/deprojection logic
 
 #ifndef ANDROID
-    #if defined(__SSSE3__) && defined(__AVX2__)
+    #if defined(__AVX2__)
     #include <tmmintrin.h> // For SSE3 intrinsic used in unpack_yuy2_sse
     #include <immintrin.h>
 
     #pragma pack(push, 1) // All structs in this file are assumed to be byte-packed
     namespace librealsense
     {
-        template<rs2_format FORMAT> void unpack_yuy2(byte * const d[], const byte * s, int n)
+        // UYVY is handled by swapping every byte pair into YUY2 order right after loading
+        template<rs2_format FORMAT, bool UYVY = false> void unpack_yuy2(byte * const d[], const byte * s, int n)
         {
             assert(n % 16 == 0); // All currently supported color resolutions are multiples of 16 pixels. Could easily extend support to other resolutions by copying final n<16 pixels into a zero-padded buffer and recursively calling self for final iteration.
 
@@ -38,6 +39,13 @@
                 // Load 16 YUY2 pixels each into two 32-byte registers
                 __m256i s0 = _mm256_loadu_si256(&src[i * 2]);
                 __m256i s1 = _mm256_loadu_si256(&src[i * 2 + 1]);
+                if (UYVY)
+                {
+                    const __m256i swap_pairs = _mm256_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14,
+                        1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+                    s0 = _mm256_shuffle_epi8(s0, swap_pairs);
+                    s1 = _mm256_shuffle_epi8(s1, swap_pairs);
+                }
 
                 if (FORMAT == RS2_FORMAT_Y8)
                 {
@@ -218,11 +226,11 @@
                         // Shuffle rgb triples to the start and end of each register
                         __m128i bgr0 = _mm_shuffle_epi8(rgba0, _mm_setr_epi8(3, 7, 11, 15, 0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14));
                         __m128i bgr1 = _mm_shuffle_epi8(rgba1, _mm_setr_epi8(0, 1, 2, 4, 3, 7, 11, 15, 5, 6, 8, 9, 10, 12, 13, 14));
-                        __m128i bgr2 = _mm_shuffle_epi8(rgba2, _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 3, 7, 11, 15, 10, 12, 13, 1));
+                        __m128i bgr2 = _mm_shuffle_epi8(rgba2, _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 3, 7, 11, 15, 10, 12, 13, 14));
                         __m128i bgr3 = _mm_shuffle_epi8(rgba3, _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, 3, 7, 11, 15));
                         __m128i bgr4 = _mm_shuffle_epi8(rgba4, _mm_setr_epi8(3, 7, 11, 15, 0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14));
                         __m128i bgr5 = _mm_shuffle_epi8(rgba5, _mm_setr_epi8(0, 1, 2, 4, 3, 7, 11, 15, 5, 6, 8, 9, 10, 12, 13, 14));
-                        __m128i bgr6 = _mm_shuffle_epi8(rgba6, _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 3, 7, 11, 15, 10, 12, 13, 1));
+                        __m128i bgr6 = _mm_shuffle_epi8(rgba6, _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 3, 7, 11, 15, 10, 12, 13, 14));
                         __m128i bgr7 = _mm_shuffle_epi8(rgba7, _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, 3, 7, 11, 15));
 
                         __m128i a1 = _mm_alignr_epi8(bgr1, bgr0, 4);
@@ -274,6 +282,79 @@
         {
             unpack_yuy2<RS2_FORMAT_BGRA8>(d, s, n);
         }
+
+        void unpack_uyvy_avx_rgb8(byte * const d[], const byte * s, int n)
+        {
+            unpack_yuy2<RS2_FORMAT_RGB8, true>(d, s, n);
+        }
+        void unpack_uyvy_avx_rgba8(byte * const d[], const byte * s, int n)
+        {
+            unpack_yuy2<RS2_FORMAT_RGBA8, true>(d, s, n);
+        }
+        void unpack_uyvy_avx_bgr8(byte * const d[], const byte * s, int n)
+        {
+            unpack_yuy2<RS2_FORMAT_BGR8, true>(d, s, n);
+        }
+        void unpack_uyvy_avx_bgra8(byte * const d[], const byte * s, int n)
+        {
+            unpack_yuy2<RS2_FORMAT_BGRA8, true>(d, s, n);
+        }
+
+        int unpack_y16_from_y8_avx(uint16_t * out, const uint8_t * in, int count)
+        {
+            int i = 0;
+            for (; i + 32 <= count; i += 32)
+            {
+                // Reorder the 64-bit quarters so the per-lane unpacks produce contiguous output
+                __m256i y = _mm256_permute4x64_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + i)), 0xD8);
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), _mm256_unpacklo_epi8(y, y));
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i + 16), _mm256_unpackhi_epi8(y, y));
+            }
+            return i;
+        }
+
+        int unpack_y16_from_y16_10_avx(uint16_t * out, const uint16_t * in, int count)
+        {
+            int i = 0;
+            for (; i + 32 <= count; i += 32)
+            {
+                __m256i y0 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + i));
+                __m256i y1 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + i + 16));
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), _mm256_slli_epi16(y0, 6));
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i + 16), _mm256_slli_epi16(y1, 6));
+            }
+            return i;
+        }
+
+        int unpack_y8_from_y16_10_avx(uint8_t * out, const uint16_t * in, int count)
+        {
+            const __m256i lsb = _mm256_set1_epi16(0xFF);
+            int i = 0;
+            for (; i + 32 <= count; i += 32)
+            {
+                __m256i y0 = _mm256_and_si256(_mm256_srli_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + i)), 2), lsb);
+                __m256i y1 = _mm256_and_si256(_mm256_srli_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + i + 16)), 2), lsb);
+                // packus interleaves the 128-bit lanes of its operands, restore the pixel order
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), _mm256_permute4x64_epi64(_mm256_packus_epi16(y0, y1), 0xD8));
+            }
+            return i;
+        }
+
+        int unpack_y8_y8_from_y8i_avx(uint8_t * l, uint8_t * r, const uint8_t * in, int count)
+        {
+            const __m256i evens_odds = _mm256_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15,
+                0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15);
+            int i = 0;
+            for (; i + 32 <= count; i += 32)
+            {
+                // Each register becomes 16 left pixels followed by the 16 matching right pixels
+                __m256i lr0 = _mm256_permute4x64_epi64(_mm256_shuffle_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + i * 2)), evens_odds), 0xD8);
+                __m256i lr1 = _mm256_permute4x64_epi64(_mm256_shuffle_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + i * 2 + 32)), evens_odds), 0xD8);
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(l + i), _mm256_permute2x128_si256(lr0, lr1, 0x20));
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(r + i), _mm256_permute2x128_si256(lr0, lr1, 0x31));
+            }
+            return i;
+        }
     }
 
     #pragma pack(pop)
@@ -10,13 +10,27 @@
 namespace librealsense
 {
 #ifndef ANDROID
-    #if defined(__SSSE3__) && defined(__AVX2__)
+    // Implemented in image_avx.cpp, the only translation unit built with AVX2 code generation (RS2_USE_AVX2).
+    // Callers must check has_avx() before using any of them
+    #if defined(RS2_USE_AVX2) || defined(__AVX2__)
     void unpack_yuy2_avx_y8(byte * const d[], const byte * s, int n);
     void unpack_yuy2_avx_y16(byte * const d[], const byte * s, int n);
     void unpack_yuy2_avx_rgb8(byte * const d[], const byte * s, int n);
     void unpack_yuy2_avx_rgba8(byte * const d[], const byte * s, int n);
     void unpack_yuy2_avx_bgr8(byte * const d[], const byte * s, int n);
     void unpack_yuy2_avx_bgra8(byte * const d[], const byte * s, int n);
+
+    void unpack_uyvy_avx_rgb8(byte * const d[], const byte * s, int n);
+    void unpack_uyvy_avx_rgba8(byte * const d[], const byte * s, int n);
+    void unpack_uyvy_avx_bgr8(byte * const d[], const byte * s, int n);
+    void unpack_uyvy_avx_bgra8(byte * const d[], const byte * s, int n);
+
+    // The following convert whole multiples of 32 pixels and return the number of pixels processed,
+    // leaving the remainder to the caller
+    int unpack_y16_from_y8_avx(uint16_t * out, const uint8_t * in, int count);
+    int unpack_y16_from_y16_10_avx(uint16_t * out, const uint16_t * in, int count);
+    int unpack_y8_from_y16_10_avx(uint8_t * out, const uint16_t * in, int count);
+    int unpack_y8_y8_from_y8i_avx(uint8_t * l, uint8_t * r, const uint8_t * in, int count);
     #endif
 #endif
 }
@@ -197,8 +197,9 @@ namespace librealsense
         using namespace ivcam;
         static auto device_name = "Intel RealSense SR300";
 
-        auto fw_version = _hw_monitor->get_firmware_version_string(GVD, fw_version_offset);
-        auto serial = _hw_monitor->get_module_serial_string(GVD, module_serial_offset);
+        auto gvd = _hw_monitor->get_gvd(GVD);
+        auto fw_version = hw_monitor::get_firmware_version_string(gvd, fw_version_offset);
+        auto serial = hw_monitor::get_module_serial_string(gvd, module_serial_offset);
         _camer_calib_params = [this]() { return get_calibration(); };
         enable_timestamp(true, true);
 
@@ -423,6 +423,11 @@ namespace librealsense
             return _hw_monitor->send(input);
         }
 
+        std::vector<std::vector<uint8_t>> send_receive_raw_data_batch(const std::vector<std::vector<uint8_t>>& inputs) override
+        {
+            return _hw_monitor->send_batch(inputs);
+        }
+
         void hardware_reset() override
         {
             force_hardware_reset();
@@ -1609,6 +1609,7 @@ void uvc_process_control_status(uvc_device_handle_t *devh, unsigned char *data,
   int found_entity = 0;
   struct uvc_input_terminal *input_terminal;
   struct uvc_processing_unit *processing_unit;
+  struct uvc_extension_unit *extension_unit;
 
   UVC_ENTER();
 
@@ -1654,6 +1655,16 @@ void uvc_process_control_status(uvc_device_handle_t *devh, unsigned char *data,
     }
   }
 
+  if (!found_entity) {
+    DL_FOREACH(devh->info->ctrl_if.extension_unit_descs, extension_unit) {
+      if (extension_unit->bUnitID == originator) {
+        status_class = UVC_STATUS_CLASS_CONTROL;
+        found_entity = 1;
+        break;
+      }
+    }
+  }
+
   if (!found_entity) {
     UVC_DEBUG("Got status update for unknown VideoControl entity %d",
               (int) originator);
@@ -1671,6 +1682,7 @@ void uvc_process_control_status(uvc_device_handle_t *devh, unsigned char *data,
   if(devh->status_cb) {
     UVC_DEBUG("Running user-supplied status callback");
     devh->status_cb(status_class,
+                    originator,
                     event,
                     selector,
                     attribute,
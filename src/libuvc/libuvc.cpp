@@ -407,6 +407,8 @@ namespace librealsense
                     _extension_unit = eu->bUnitID;
                 }
 
+                uvc_set_status_callback(_device_handle, internal_uvc_status_callback, this);
+
                 _real_state = D0;
             }
 
@@ -468,6 +470,29 @@ namespace librealsense
                 }
                 return false;
             }
+            bool set_xu_status_callback(const extension_unit& xu, uint8_t control, std::function<void()> callback) override
+            {
+                std::lock_guard<std::mutex> lock(_status_mutex);
+                auto key = std::make_pair(static_cast<uint8_t>(xu.unit), control);
+                if (!callback)
+                {
+                    _xu_status_callbacks.erase(key);
+                    return true;
+                }
+
+                // The reports come from the status interrupt endpoint, which not every device has
+                if (!_device_handle || !_device_handle->status_xfer)
+                    return false;
+                auto eu = uvc_get_extension_units(_device_handle);
+                while (eu && eu->bUnitID != xu.unit)
+                    eu = eu->next;
+                if (!eu)
+                    return false;
+
+                _xu_status_callbacks[key] = std::move(callback);
+                return true;
+            }
+
             control_range get_xu_range(const extension_unit& xu, uint8_t control, int len) const override
             {
                 int status;
@@ -767,7 +792,8 @@ namespace librealsense
                 frame_object fo{ frame->data_bytes,
                                  frame->metadata_bytes,
                                  frame->data,
-                                 frame->metadata };
+                                 frame->metadata,
+                                 0, -1 };
 
                 callback(profile, fo,
                           []() mutable {} );
@@ -798,8 +824,24 @@ namespace librealsense
           }
 
         private:
+            // Called on the libusb event thread for the reports of the status interrupt endpoint. Extension units report with the generic
+            // control class, by their unit and the selector of the control that changed
+            static void internal_uvc_status_callback(enum uvc_status_class status_class, int originator, int event, int selector,
+                enum uvc_status_attribute status_attribute, void* data, size_t data_len, void* ptr)
+            {
+                if (status_class != UVC_STATUS_CLASS_CONTROL || status_attribute != UVC_STATUS_ATTRIBUTE_VALUE_CHANGE)
+                    return;
+
+                auto device = static_cast<libuvc_uvc_device*>(ptr);
+                std::lock_guard<std::mutex> lock(device->_status_mutex);
+                auto it = device->_xu_status_callbacks.find(std::make_pair(static_cast<uint8_t>(originator), static_cast<uint8_t>(selector)));
+                if (it != device->_xu_status_callbacks.end())
+                    it->second();
+            }
 
             std::mutex _power_mutex;
+            std::mutex _status_mutex;
+            std::map<std::pair<uint8_t, uint8_t>, std::function<void()>> _xu_status_callbacks;  // By unit and selector
             std::thread _thread_handle;
             std::atomic<bool> _is_power_thread_alive;
             power_state _real_state = D3;
@@ -820,7 +862,7 @@ namespace librealsense
             std::atomic<bool> _is_started;
             uvc_context_t *_ctx;
             uvc_device_t *_device;
-            uvc_device_handle_t *_device_handle;
+            uvc_device_handle_t *_device_handle = NULL;
             int _input_terminal;
             int _processing_unit;
             int _extension_unit;
@@ -390,10 +390,11 @@ enum uvc_status_attribute {
     UVC_STATUS_ATTRIBUTE_UNKNOWN = 0xff
 };
 
-/** A callback function to accept status updates
+/** A callback function to accept status updates, from the unit or terminal originator
  * @ingroup device
  */
 typedef void(uvc_status_callback_t)(enum uvc_status_class status_class,
+                                    int originator,
                                     int event,
                                     int selector,
                                     enum uvc_status_attribute status_attribute,
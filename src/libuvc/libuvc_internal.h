@@ -14,6 +14,7 @@
 #include <thread>
 #include <mutex>
 #include <condition_variable>
+#include <vector>
 #include <signal.h>
 #include "utlist.h"
 
@@ -236,15 +237,15 @@ typedef struct uvc_device_info {
 } uvc_device_info_t;
 
 /*
-  set a high number of transfer buffers. This uses a lot of ram, but
-  avoids problems with scheduling delays on slow boards causing missed
-  transfers. A better approach may be to make the transfer thread FIFO
-  scheduled (if we have root).
-  We could/should change this to allow reduce it to, say, 5 by default
-  and then allow the user to change the number of buffers as required.
+  Number of bulk transfers kept in flight per stream. Several transfers avoid
+  missing payloads while a completed one is being processed or resubmitted,
+  at the cost of one payload buffer each. LRS_LIBUVC_TRANSFERS overrides the
+  default, up to LIBUVC_MAX_TRANSFER_BUFS.
  */
-#define LIBUVC_NUM_TRANSFER_BUFS 1
+#define LIBUVC_NUM_TRANSFER_BUFS 4
+#define LIBUVC_MAX_TRANSFER_BUFS 32
 
+/* Frame buffer size of the streams that report no dwMaxVideoFrameSize */
 #define LIBUVC_XFER_BUF_SIZE	( 16 * 1024 * 1024 )
 
 struct uvc_stream_handle {
@@ -266,16 +267,20 @@ struct uvc_stream_handle {
     uint8_t *metadata_buf;
     size_t metadata_bytes,metadata_size;
     size_t got_bytes, hold_bytes;
+    /* outbuf is being assembled, holdbuf is the last complete frame and
+     * frame.data is the frame handed to the user. All three have frame_buf_size
+     * bytes and are rotated instead of copied */
     uint8_t *outbuf, *holdbuf;
+    size_t frame_buf_size;
     std::mutex cb_mutex;
     std::condition_variable cb_cond;
     std::thread cb_thread;
     uint32_t last_polled_seq;
     uvc_frame_callback_t *user_cb;
     void *user_ptr;
-    struct libusb_transfer *transfers[LIBUVC_NUM_TRANSFER_BUFS];
-    uint8_t *transfer_bufs[LIBUVC_NUM_TRANSFER_BUFS];
-    std::condition_variable transfer_cancel[LIBUVC_NUM_TRANSFER_BUFS];
+    std::vector<struct libusb_transfer *> transfers;
+    std::vector<uint8_t *> transfer_bufs;
+    std::condition_variable transfer_cancel;
     struct uvc_frame frame;
     enum uvc_frame_format frame_format;
 };
@@ -40,6 +40,7 @@
 #include "libuvc_internal.h"
 #include "errno.h"
 #include <chrono>
+#include <algorithm>
 
 #ifdef _MSC_VER
 
@@ -811,6 +812,11 @@ void _uvc_process_payload(uvc_stream_handle_t *strmh, uint8_t *payload, size_t p
   }
 
   if (data_len > 0) {
+    if (strmh->got_bytes + data_len > strmh->frame_buf_size) {
+      UVC_DEBUG("frame overflow: got_bytes=%zd, data_len=%zd\n", strmh->got_bytes, data_len);
+      strmh->got_bytes = 0;
+      return;
+    }
     memcpy(strmh->outbuf + strmh->got_bytes, payload + header_len, data_len);
     strmh->got_bytes += data_len;
 
@@ -876,17 +882,17 @@ void LIBUSB_CALL _uvc_stream_callback(struct libusb_transfer *transfer) {
     UVC_DEBUG("not retrying transfer, status = %d", transfer->status);    
     {
         /* Mark transfer as deleted. */
-        for (i = 0; i < LIBUVC_NUM_TRANSFER_BUFS; i++) {
+        for (i = 0; i < (int)strmh->transfers.size(); i++) {
             if (strmh->transfers[i] == transfer) {
                 UVC_DEBUG("Freeing transfer %d (%p)", i, transfer);
                 free(transfer->buffer);
                 libusb_free_transfer(transfer);
                 strmh->transfers[i] = NULL;
-                strmh->transfer_cancel[i].notify_all();
+                strmh->transfer_cancel.notify_all();
                 break;
             }
         }
-        if (i == LIBUVC_NUM_TRANSFER_BUFS) {
+        if (i == (int)strmh->transfers.size()) {
             UVC_DEBUG("transfer %p not found; not freeing!", transfer);
         }
         resubmit = 0;
@@ -912,17 +918,17 @@ void LIBUSB_CALL _uvc_stream_callback(struct libusb_transfer *transfer) {
         {
             int i;
             /* Mark transfer as deleted. */
-            for(i=0; i < LIBUVC_NUM_TRANSFER_BUFS; i++) {
+            for(i=0; i < (int)strmh->transfers.size(); i++) {
                 if(strmh->transfers[i] == transfer) {
                     UVC_DEBUG("Freeing orphan transfer %d (%p)", i, transfer);
                     free(transfer->buffer);
                     libusb_free_transfer(transfer);
                     strmh->transfers[i] = NULL;
-                    strmh->transfer_cancel[i].notify_all();
-
+                    strmh->transfer_cancel.notify_all();
+                    break;
                 }
             }
-            if(i == LIBUVC_NUM_TRANSFER_BUFS ) {
+            if(i == (int)strmh->transfers.size() ) {
                 UVC_DEBUG("orphan transfer %p not found; not freeing!", transfer);
             }
         }
@@ -1052,9 +1058,18 @@ uvc_error_t uvc_stream_open_ctrl(uvc_device_handle_t *devh, uvc_stream_handle_t
 
     // Set up the streaming status and data space
     strmh->running = 0;
-    /** @todo take only what we need */
-    strmh->outbuf = (uint8_t *)malloc( LIBUVC_XFER_BUF_SIZE );
-    strmh->holdbuf = (uint8_t *)malloc( LIBUVC_XFER_BUF_SIZE );
+    strmh->frame_buf_size = strmh->cur_ctrl.dwMaxVideoFrameSize ?
+        strmh->cur_ctrl.dwMaxVideoFrameSize : LIBUVC_XFER_BUF_SIZE;
+    strmh->outbuf = (uint8_t *)malloc( strmh->frame_buf_size );
+    strmh->holdbuf = (uint8_t *)malloc( strmh->frame_buf_size );
+    strmh->frame.data = malloc( strmh->frame_buf_size );
+    if (!strmh->outbuf || !strmh->holdbuf || !strmh->frame.data) {
+      free(strmh->outbuf);
+      free(strmh->holdbuf);
+      free(strmh->frame.data);
+      ret = UVC_ERROR_NO_MEM;
+      goto fail;
+    }
 
     strmh->metadata_buf = (uint8_t *)malloc( 2048 );
     strmh->metadata_size = 2048;
@@ -1073,6 +1088,20 @@ fail:
   return ret;
 }
 
+/** @internal
+ * @brief Number of transfers to keep in flight, LIBUVC_NUM_TRANSFER_BUFS unless
+ * LRS_LIBUVC_TRANSFERS asks for another number
+ */
+static int _uvc_num_transfer_bufs() {
+  static const char* transfers_var_name = "LRS_LIBUVC_TRANSFERS";
+  const char* content = getenv(transfers_var_name);
+  if (!content)
+    return LIBUVC_NUM_TRANSFER_BUFS;
+
+  long count = strtol(content, NULL, 10);
+  return (int)std::max(1L, std::min(count, (long)LIBUVC_MAX_TRANSFER_BUFS));
+}
+
 /** Begin streaming video from the stream into the callback function.
  * @ingroup streaming
  *
@@ -1132,7 +1161,12 @@ uvc_error_t uvc_stream_start(
    * (UVC 1.5: 2.4.3. VideoStreaming Interface) */
   isochronous = interface->num_altsetting > 1;
 
-  for (transfer_id = 0; transfer_id < LIBUVC_NUM_TRANSFER_BUFS;
+  /* Each bulk transfer holds one payload, so the transfers are sized to the
+   * negotiated payload and their number decides how many payloads can be
+   * received while the callback is busy */
+  strmh->transfers.assign(_uvc_num_transfer_bufs(), NULL);
+  strmh->transfer_bufs.assign(strmh->transfers.size(), NULL);
+  for (transfer_id = 0; transfer_id < (int)strmh->transfers.size();
       ++transfer_id) {
     transfer = libusb_alloc_transfer(0);
     strmh->transfers[transfer_id] = transfer;
@@ -1155,7 +1189,7 @@ uvc_error_t uvc_stream_start(
       strmh->cb_thread = std::thread([&]() {_uvc_user_caller((void*)strmh); });
   }
 
-  for (transfer_id = 0; transfer_id < LIBUVC_NUM_TRANSFER_BUFS;
+  for (transfer_id = 0; transfer_id < (int)strmh->transfers.size();
       transfer_id++) {
     ret = libusb_submit_transfer(strmh->transfers[transfer_id]);
     if (ret != UVC_SUCCESS) {
@@ -1262,12 +1296,13 @@ void _uvc_populate_frame(uvc_stream_handle_t *strmh) {
   /** @todo set the frame time */
   // frame->capture_time
 
-  /* copy the image data from the hold buffer to the frame (unnecessary extra buf?) */
-  if (frame->data_bytes < strmh->hold_bytes) {
-    frame->data = realloc(frame->data, strmh->hold_bytes);
-  }
+  /* hand the hold buffer to the frame instead of copying it, the buffer the
+   * user is done with becomes the next hold buffer. The hold sequence is not
+   * advanced, so the stale content is never presented again */
+  uint8_t *presented = strmh->holdbuf;
+  strmh->holdbuf = (uint8_t *)frame->data;
+  frame->data = presented;
   frame->data_bytes = strmh->hold_bytes;
-  memcpy(frame->data, strmh->holdbuf, frame->data_bytes);
 
     /* copy the header data from the buffer to the frame */
 
@@ -1407,7 +1442,7 @@ uvc_error_t uvc_stream_stop(uvc_stream_handle_t *strmh) {
   {
     std::unique_lock<std::mutex> lock(strmh->cb_mutex);
     strmh->running = 0;
-    for (i = 0; i < LIBUVC_NUM_TRANSFER_BUFS; i++)
+    for (i = 0; i < (int)strmh->transfers.size(); i++)
     {
         if (strmh->transfers[i] != NULL)
         {
@@ -1421,11 +1456,10 @@ uvc_error_t uvc_stream_stop(uvc_stream_handle_t *strmh) {
         }
     }
       
-    for (i = 0; i < LIBUVC_NUM_TRANSFER_BUFS; i++)
-    {
-        if (strmh->transfers[i] != NULL)
-            strmh->transfer_cancel[i].wait(lock);
-    }
+    strmh->transfer_cancel.wait(lock, [strmh]() {
+        return std::all_of(strmh->transfers.begin(), strmh->transfers.end(),
+                           [](struct libusb_transfer *t) { return t == NULL; });
+    });
   
     
    // Kick the user thread awake
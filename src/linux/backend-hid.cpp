@@ -6,6 +6,7 @@
 #include "backend-hid.h"
 #include "backend.h"
 #include "types.h"
+#include "thread-scheduling.h"
 
 #include <cassert>
 #include <cstdlib>
@@ -33,6 +34,7 @@
 #include <sys/stat.h>
 #include <sys/mman.h>
 #include <sys/ioctl.h>
+#include <poll.h>
 #include <linux/usb/video.h>
 #include <linux/uvcvideo.h>
 #include <linux/videodev2.h>
@@ -54,10 +56,37 @@ const std::string IIO_DEVICE_PREFIX("iio:device");
 const std::string IIO_ROOT_PATH("/sys/bus/iio/devices");
 const std::string HID_CUSTOM_PATH("/sys/bus/platform/drivers/hid_sensor_custom");
 
+const uint32_t HID_BATCH_PERIOD_MS = 10; // samples are delivered by the kernel in batches of about this long
+
 namespace librealsense
 {
     namespace platform
     {
+        // Writes an integer sysfs attribute, unless it already holds the value.
+        // Every write of a HID sensor attribute is a report sent to the device, the values left from the previous stream are reused
+        // Returns false if the attribute can't be opened
+        static bool write_sysfs_integer(const std::string& path, int value)
+        {
+            auto fd = ::open(path.c_str(), O_RDWR);
+            if (fd < 0)
+                return false;
+
+            char buffer[32] = {};
+            auto size = ::read(fd, buffer, sizeof(buffer) - 1);
+            if (size > 0 && std::strtol(buffer, nullptr, 10) == value)
+            {
+                ::close(fd);
+                return true;
+            }
+
+            auto str = std::to_string(value);
+            auto res = ::pwrite(fd, str.c_str(), str.size(), 0);
+            ::close(fd);
+            if (res != static_cast<ssize_t>(str.size()))
+                throw linux_backend_exception(to_string() << "Failed to write " << value << " to " << path);
+            return true;
+        }
+
         hid_input::hid_input(const std::string& iio_device_path, const std::string& input_name)
         {
             info.device_path = iio_device_path;
@@ -86,14 +115,10 @@ namespace librealsense
             auto input_data = is_enable ? 1 : 0;
             // open the element requested and enable and disable.
             auto element_path = info.device_path + "/scan_elements/" + "in_" + info.input + "_en";
-            std::ofstream iio_device_file(element_path);
-
-            if (!iio_device_file.is_open())
+            if (!write_sysfs_integer(element_path, input_data))
             {
                 throw linux_backend_exception(to_string() << "Failed to open scan_element " << element_path);
             }
-            iio_device_file << input_data;
-            iio_device_file.close();
 
             info.enabled = is_enable;
         }
@@ -268,10 +293,15 @@ namespace librealsense
             _callback = sensor_callback;
             _is_capturing = true;
             _hid_thread = std::unique_ptr<std::thread>(new std::thread([this, read_device_path_str](){
+                thread_scheduling::apply(RS2_THREAD_CATEGORY_HID, "rs-hid");
                 static const uint32_t buf_len = 128;
                 const uint32_t channel_size = 24; // TODO: why 24?
                 std::vector<uint8_t> raw_data(channel_size * buf_len);
 
+                // All the samples of one read are reported with the same descriptor, only the payload pointers change
+                sensor_data sens_data{};
+                sens_data.sensor = hid_sensor{get_sensor_name()};
+
                 do {
                     fd_set fds;
                     FD_ZERO(&fds);
@@ -313,12 +343,7 @@ namespace librealsense
                         for (auto i = 0; i < read_size / channel_size; ++i)
                         {
                             auto p_raw_data = raw_data.data() + channel_size * i;
-
-                            // TODO: code refactoring to reduce latency
-                            sensor_data sens_data{};
-                            sens_data.sensor = hid_sensor{get_sensor_name()};
-
-                            sens_data.fo = {channel_size, channel_size, p_raw_data, p_raw_data};
+                            sens_data.fo = {channel_size, channel_size, p_raw_data, p_raw_data, 0, -1};
                             this->_callback(sens_data);
                         }
                     }
@@ -532,23 +557,22 @@ namespace librealsense
             _callback = sensor_callback;
             _is_capturing = true;
             _hid_thread = std::unique_ptr<std::thread>(new std::thread([this](){
+                thread_scheduling::apply(RS2_THREAD_CATEGORY_HID, "rs-hid");
                 const uint32_t channel_size = get_channel_size();
                 auto raw_data_size = channel_size*buf_len;
 
                 std::vector<uint8_t> raw_data(raw_data_size);
                 auto metadata = has_metadata();
+                auto hid_data_size = channel_size - HID_METADATA_SIZE;
 
-                do {
-                    fd_set fds;
-                    FD_ZERO(&fds);
-                    FD_SET(_fd, &fds);
-                    FD_SET(_stop_pipe_fd[0], &fds);
+                sensor_data sens_data{};
+                sens_data.sensor = hid_sensor{get_sensor_name()};
 
-                    int max_fd = std::max(_stop_pipe_fd[0], _fd);
-                    auto read_size = 0;
+                do {
+                    pollfd fds[2] = { { _fd, POLLIN, 0 }, { _stop_pipe_fd[0], POLLIN, 0 } };
+                    ssize_t read_size = 0;
 
-                    struct timeval tv = {5, 0};
-                    auto val = select(max_fd + 1, &fds, NULL, NULL, &tv);
+                    auto val = poll(fds, 2, 5000);
                     if (val < 0)
                     {
                         // TODO: write to log?
@@ -556,7 +580,7 @@ namespace librealsense
                     }
                     else if (val > 0)
                     {
-                        if(FD_ISSET(_stop_pipe_fd[0], &fds))
+                        if (fds[1].revents & POLLIN)
                         {
                             if(!_is_capturing)
                             {
@@ -564,8 +588,9 @@ namespace librealsense
                                 return;
                             }
                         }
-                        else if (FD_ISSET(_fd, &fds))
+                        else if (fds[0].revents & POLLIN)
                         {
+                            // Takes all the samples the kernel holds, up to the size of the buffer
                             read_size = read(_fd, raw_data.data(), raw_data_size);
                             if (read_size < 0 )
                                 continue;
@@ -576,16 +601,10 @@ namespace librealsense
                             continue;
                         }
 
-                        // TODO: code refactoring to reduce latency
-                        for (auto i = 0; i < read_size / channel_size; ++i)
+                        auto p_raw_data = raw_data.data();
+                        for (auto end = p_raw_data + read_size - read_size % channel_size; p_raw_data != end; p_raw_data += channel_size)
                         {
-                            auto p_raw_data = raw_data.data() + channel_size * i;
-                            sensor_data sens_data{};
-                            sens_data.sensor = hid_sensor{get_sensor_name()};
-
-                            auto hid_data_size = channel_size - HID_METADATA_SIZE;
-
-                            sens_data.fo = {hid_data_size, metadata?HID_METADATA_SIZE: uint8_t(0),  p_raw_data,  metadata?p_raw_data + hid_data_size:nullptr};
+                            sens_data.fo = {hid_data_size, metadata?HID_METADATA_SIZE: uint8_t(0),  p_raw_data,  metadata?p_raw_data + hid_data_size:nullptr, 0, -1};
 
                             this->_callback(sens_data);
                         }
@@ -662,15 +681,11 @@ namespace librealsense
         void iio_hid_sensor::set_frequency(uint32_t frequency)
         {
             auto sampling_frequency_path = _iio_device_path + "/" + _sampling_frequency_name;
-            std::ofstream iio_device_file(sampling_frequency_path);
-
-            if (!iio_device_file.is_open())
+            if (!write_sysfs_integer(sampling_frequency_path, frequency))
             {
                  throw linux_backend_exception(to_string() << "Failed to set frequency " << frequency <<
                                                ". device path: " << sampling_frequency_path);
             }
-            iio_device_file << frequency;
-            iio_device_file.close();
         }
 
         // Zero -delay will suspend immedeately, Negaive - prevent suspend/resume
@@ -783,6 +798,13 @@ namespace librealsense
 
             set_frequency(frequency);
             write_integer_to_param("buffer/length", buf_len);
+
+            // The poll wakes up once the watermark is reached, letting each read return a batch of samples
+            // Kernels older than 4.2 have no watermark, and wake up on every sample
+            auto watermark = std::min(std::max(frequency * HID_BATCH_PERIOD_MS / 1000, 1u), buf_len / 2);
+            if (!write_sysfs_integer(_iio_device_path + "/buffer/watermark", static_cast<int>(watermark)))
+                LOG_DEBUG("iio_hid_sensor: " << _iio_device_path << " has no buffer watermark");
+
             write_integer_to_param("buffer/enable", 1);
 
 #ifdef PREVENT_HID_SUSPEND
@@ -792,6 +814,7 @@ namespace librealsense
             // Note that this setting applies for non-HID sensors as well
             std::string path = _iio_device_path + "/../power/autosuspend_delay_ms";
             _pm_thread = std::unique_ptr<std::thread>(new std::thread([path](){
+                thread_scheduling::apply(RS2_THREAD_CATEGORY_HID, "rs-hid-pm");
                 while (true)
                 {
                     try{
@@ -923,19 +946,10 @@ namespace librealsense
         // configure hid device via fd
         void iio_hid_sensor::write_integer_to_param(const std::string& param,int value)
         {
-            std::ostringstream device_path;
-            device_path << _iio_device_path << "/" << param;
-
-            std::ofstream iio_device_file(device_path.str());
-
-            if (!iio_device_file.good())
+            if (!write_sysfs_integer(_iio_device_path + "/" + param, value))
             {
                 throw linux_backend_exception(to_string() << "write_integer_to_param failed! device path: " << _iio_device_path);
             }
-
-            iio_device_file << value;
-
-            iio_device_file.close();
         }
 
         v4l_hid_device::v4l_hid_device(const hid_device_info& info)
@@ -7,6 +7,8 @@
 #include "backend-hid.h"
 #include "backend.h"
 #include "types.h"
+#include "thread-scheduling.h"
+#include "profiling.h"
 
 #include <cassert>
 #include <cstdlib>
@@ -43,6 +45,12 @@
 #include <list>
 
 #include <sys/signalfd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <linux/netlink.h>
+#include <poll.h>
+#include <sched.h>
 #include <signal.h>
 #pragma GCC diagnostic ignored "-Woverflow"
 
@@ -201,6 +209,19 @@ namespace librealsense
                                                     fd, buf.m.offset));
                 if(_start == MAP_FAILED)
                     throw linux_backend_exception("mmap failed");
+
+                // Export the video buffers so that frames can be imported by GPU/encoder APIs without a CPU copy
+                if (V4L2_BUF_TYPE_VIDEO_CAPTURE == type)
+                {
+                    v4l2_exportbuffer expbuf = {};
+                    expbuf.type = _type;
+                    expbuf.index = index;
+                    expbuf.flags = O_RDONLY | O_CLOEXEC;
+                    if (xioctl(fd, VIDIOC_EXPBUF, &expbuf) < 0)
+                        LOG_WARNING("xioctl(VIDIOC_EXPBUF) failed for buffer " << index << ", error: " << strerror(errno));
+                    else
+                        _dmabuf_fd = expbuf.fd;
+                }
             }
             else
             {
@@ -229,9 +250,12 @@ namespace librealsense
 
         buffer::~buffer()
         {
+            if (_dmabuf_fd >= 0)
+                ::close(_dmabuf_fd);
+
             if (_use_memory_map)
             {
-               if(munmap(_start, _length) < 0)
+               if(munmap(_start, _original_length) < 0)
                    linux_backend_exception("munmap");
             }
             else
@@ -307,6 +331,25 @@ namespace librealsense
             };
         }
 
+        void buffers_mgr::reset()
+        {
+            for (auto& buf : buffers)
+                buf = kernel_buf_guard();
+            set_md_attributes(0, nullptr);
+        }
+
+        void buffers_mgr::release()
+        {
+            for (auto& buf : buffers)
+            {
+                if (!buf._managed)
+                {
+                    buf.requeue();
+                    buf = kernel_buf_guard();
+                }
+            }
+        }
+
 
         static std::tuple<std::string,uint16_t>  get_usb_descriptors(libusb_device* usb_device)
         {
@@ -682,6 +725,275 @@ namespace librealsense
             }
         }
 
+        v4l_reactor* v4l_reactor::instance()
+        {
+            static const char* threads_var_name = "LRS_V4L2_REACTOR_THREADS";
+            static const char* cpus_var_name = "LRS_V4L2_REACTOR_CPUS";
+
+            auto threads = getenv(threads_var_name);
+            if (!threads || !std::strtoul(threads, nullptr, 10))
+                return nullptr;
+
+            static v4l_reactor reactor([]()
+            {
+                std::vector<int> cpus;
+                if (auto content = getenv(cpus_var_name))
+                {
+                    std::stringstream ss(content);
+                    std::string cpu;
+                    while (std::getline(ss, cpu, ','))
+                    {
+                        char* end = nullptr;
+                        auto id = std::strtol(cpu.c_str(), &end, 10);
+                        if (end != cpu.c_str() && id >= 0)
+                            cpus.push_back(static_cast<int>(id));
+                        else
+                            LOG_WARNING("Ignoring invalid core \"" << cpu << "\" in " << cpus_var_name);
+                    }
+                }
+                return cpus;
+            }(), std::strtoul(threads, nullptr, 10));
+
+            return &reactor;
+        }
+
+        v4l_reactor::v4l_reactor(const std::vector<int>& cpus, size_t threads)
+            : _running(true)
+        {
+            for (size_t i = 0; i < threads; ++i)
+            {
+                std::unique_ptr<worker> w(new worker());
+                w->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+                w->wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+                epoll_event ev{};
+                ev.events = EPOLLIN;
+                ev.data.fd = w->wake_fd;
+                if (w->epoll_fd < 0 || w->wake_fd < 0 || epoll_ctl(w->epoll_fd, EPOLL_CTL_ADD, w->wake_fd, &ev) < 0)
+                {
+                    if (w->epoll_fd >= 0) ::close(w->epoll_fd);
+                    if (w->wake_fd >= 0) ::close(w->wake_fd);
+                    LOG_ERROR("v4l_reactor: could not create epoll descriptors for worker " << i << ", error " << errno);
+                    break;
+                }
+
+                if (cpus.size())
+                    w->cpu = cpus[i % cpus.size()];
+                _workers.push_back(std::move(w));
+            }
+
+            for (auto&& w : _workers)
+            {
+                auto p = w.get();
+                w->thread = std::thread([this, p]()
+                {
+                    thread_scheduling::apply(RS2_THREAD_CATEGORY_CAPTURE, "rs-capture");
+                    run(*p);
+                });
+            }
+        }
+
+        v4l_reactor::~v4l_reactor()
+        {
+            _running = false;
+            for (auto&& w : _workers)
+            {
+                uint64_t wake = 1;
+                if (write(w->wake_fd, &wake, sizeof(wake)) < 0) {} // The worker exits on the next timeout anyway
+            }
+            for (auto&& w : _workers)
+            {
+                if (w->thread.joinable())
+                    w->thread.join();
+                ::close(w->epoll_fd);
+                ::close(w->wake_fd);
+            }
+        }
+
+        std::unique_lock<std::mutex> v4l_reactor::lock(worker& w) const
+        {
+            // Handlers running on the worker already hold its lock, e.g. when a frame callback stops a sensor
+            if (w.thread.get_id() == std::this_thread::get_id())
+                return std::unique_lock<std::mutex>(w.mutex, std::defer_lock);
+            return std::unique_lock<std::mutex>(w.mutex);
+        }
+
+        void v4l_reactor::add(v4l_uvc_device* dev, const std::vector<int>& fds)
+        {
+            if (_workers.empty())
+                throw linux_backend_exception("v4l_reactor: no worker threads available");
+
+            // Prefer the least loaded worker
+            worker* target = nullptr;
+            for (auto&& w : _workers)
+            {
+                if (!target || w->load < target->load)
+                    target = w.get();
+            }
+
+            auto l = lock(*target);
+            for (auto fd : fds)
+            {
+                epoll_event ev{};
+                ev.events = EPOLLIN;
+                ev.data.fd = fd;
+                if (epoll_ctl(target->epoll_fd, EPOLL_CTL_ADD, fd, &ev) < 0)
+                {
+                    for (auto added : fds)
+                    {
+                        if (added == fd) break;
+                        epoll_ctl(target->epoll_fd, EPOLL_CTL_DEL, added, nullptr);
+                        target->fd_to_device.erase(added);
+                    }
+                    throw linux_backend_exception(to_string() << "v4l_reactor: epoll_ctl(EPOLL_CTL_ADD) failed for fd " << fd);
+                }
+                target->fd_to_device[fd] = dev;
+            }
+            target->devices[dev] = { fds, std::chrono::steady_clock::now() };
+            target->load = target->devices.size();
+        }
+
+        void v4l_reactor::remove(v4l_uvc_device* dev)
+        {
+            // One worker is locked at a time, so that removals running on different workers never wait on each other
+            for (auto&& w : _workers)
+            {
+                auto l = lock(*w);
+                if (remove(*w, dev))
+                    return;
+            }
+        }
+
+        bool v4l_reactor::remove(worker& w, v4l_uvc_device* dev)
+        {
+            auto it = w.devices.find(dev);
+            if (it == w.devices.end())
+                return false;
+
+            for (auto fd : it->second.fds)
+            {
+                epoll_ctl(w.epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+                w.fd_to_device.erase(fd);
+            }
+            w.devices.erase(it);
+            w.load = w.devices.size();
+
+            LOG_DEBUG("v4l_reactor: worker " << w.thread.get_id() << " wakeups " << w.stats.wakeups.load()
+                << ", dispatches " << w.stats.dispatches.load() << ", max dispatch " << w.stats.max_dispatch_ms.load() << " ms");
+            return true;
+        }
+
+        v4l_reactor::statistics v4l_reactor::get_statistics() const
+        {
+            statistics res;
+            for (auto&& w : _workers)
+            {
+                res.wakeups += w->stats.wakeups;
+                res.dispatches += w->stats.dispatches;
+                res.total_dispatch_ms += w->stats.total_dispatch_ms;
+                res.max_dispatch_ms = std::max(res.max_dispatch_ms, w->stats.max_dispatch_ms.load());
+            }
+            return res;
+        }
+
+        void v4l_reactor::run(worker& w)
+        {
+            if (w.cpu >= 0)
+            {
+                cpu_set_t cpus;
+                CPU_ZERO(&cpus);
+                CPU_SET(w.cpu, &cpus);
+                if (sched_setaffinity(0, sizeof(cpus), &cpus) < 0)
+                    LOG_WARNING("v4l_reactor: could not pin worker to core " << w.cpu << ", error " << errno);
+            }
+
+            static const int max_events = 32;
+            static const auto frames_timeout = std::chrono::seconds(5);
+            epoll_event events[max_events];
+
+            while (_running)
+            {
+                int timeout_ms = -1;
+                {
+                    std::lock_guard<std::mutex> l(w.mutex);
+                    if (w.devices.size())
+                        timeout_ms = 1000;
+                }
+
+                auto val = epoll_wait(w.epoll_fd, events, max_events, timeout_ms);
+                if (val < 0)
+                {
+                    if (errno == EINTR)
+                        continue;
+                    LOG_ERROR("v4l_reactor: epoll_wait failed, error " << errno);
+                    return;
+                }
+
+                std::lock_guard<std::mutex> l(w.mutex);
+                ++w.stats.wakeups;
+
+                // Group the ready descriptors per device, matching the select-based dispatch
+                std::map<v4l_uvc_device*, std::pair<fd_set, int>> ready;
+                for (int i = 0; i < val; ++i)
+                {
+                    if (events[i].data.fd == w.wake_fd)
+                    {
+                        uint64_t wake;
+                        if (read(w.wake_fd, &wake, sizeof(wake)) < 0) {}
+                        continue;
+                    }
+
+                    auto it = w.fd_to_device.find(events[i].data.fd);
+                    if (it == w.fd_to_device.end())
+                        continue;
+
+                    auto& entry = ready[it->second];
+                    if (!entry.second)
+                        FD_ZERO(&entry.first);
+                    FD_SET(events[i].data.fd, &entry.first);
+                    ++entry.second;
+                }
+
+                auto now = std::chrono::steady_clock::now();
+                for (auto&& r : ready)
+                {
+                    // The device may have been removed by a previous handler in this batch
+                    auto dev = w.devices.find(r.first);
+                    if (dev == w.devices.end())
+                        continue;
+                    dev->second.last_event = now;
+
+                    auto start = std::chrono::steady_clock::now();
+                    try
+                    {
+                        r.first->dispatch(r.second.first, r.second.second);
+                    }
+                    catch (const std::exception& ex)
+                    {
+                        // Stop servicing the device, as the dedicated capture thread would have. The device is on this
+                        // worker, whose lock is held: the other workers are not locked, they may be failing the same way
+                        r.first->raise_error(ex);
+                        remove(w, r.first);
+                    }
+                    auto dispatch_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+                    ++w.stats.dispatches;
+                    w.stats.total_dispatch_ms = w.stats.total_dispatch_ms + dispatch_ms;
+                    w.stats.max_dispatch_ms = std::max(w.stats.max_dispatch_ms.load(), dispatch_ms);
+                }
+
+                now = std::chrono::steady_clock::now();
+                for (auto&& dev : w.devices)
+                {
+                    if (now - dev.second.last_event > frames_timeout)
+                    {
+                        dev.second.last_event = now;
+                        dev.first->raise_frames_timeout();
+                    }
+                }
+            }
+        }
+
         v4l_uvc_device::v4l_uvc_device(const uvc_device_info& info, bool use_memory_map)
             : _name(""), _info(),
               _is_capturing(false),
@@ -713,6 +1025,7 @@ namespace librealsense
         {
             _is_capturing = false;
             if (_thread) _thread->join();
+            if (_reactor) _reactor->remove(this);
             _fds.clear();
         }
 
@@ -806,8 +1119,27 @@ namespace librealsense
                 // Synchronise stream requests for meta and video data.
                 streamon();
 
+                _last_sequence = -1;
+                _skipped = _incomplete = 0;
                 _is_capturing = true;
-                _thread = std::unique_ptr<std::thread>(new std::thread([this](){ capture_loop(); }));
+
+                _reactor = v4l_reactor::instance();
+                if (_reactor)
+                {
+                    // The reactor is stopped per device, so the stop pipe is not monitored
+                    std::vector<int> fds;
+                    std::copy_if(_fds.begin(), _fds.end(), std::back_inserter(fds),
+                        [this](int fd) { return fd != _stop_pipe_fd[0] && fd != _stop_pipe_fd[1]; });
+                    _reactor->add(this, fds);
+                }
+                else
+                {
+                    _thread = std::unique_ptr<std::thread>(new std::thread([this]()
+                    {
+                        thread_scheduling::apply(RS2_THREAD_CATEGORY_CAPTURE, "rs-capture");
+                        capture_loop();
+                    }));
+                }
             }
         }
 
@@ -821,11 +1153,19 @@ namespace librealsense
             _is_capturing = false;
             _is_started = false;
 
-            // Stop nn-demand frames polling
-            signal_stop();
+            if (_reactor)
+            {
+                _reactor->remove(this);
+                _reactor = nullptr;
+            }
+            else
+            {
+                // Stop nn-demand frames polling
+                signal_stop();
 
-            _thread->join();
-            _thread.reset();
+                _thread->join();
+                _thread.reset();
+            }
 
             // Notify kernel
             streamoff();
@@ -931,91 +1271,134 @@ namespace librealsense
                     }
                     else // Check and acquire data buffers from kernel
                     {
-                        buffers_mgr buf_mgr(_use_memory_map);
-                        // Read metadata from a node
-                        acquire_metadata(buf_mgr,fds);
+                        dispatch(fds, val);
+                    }
+                }
+                else // (val==0)
+                {
+                    raise_frames_timeout();
+                }
+            }
+        }
 
-                        if(FD_ISSET(_fd, &fds))
-                        {
-                            FD_CLR(_fd,&fds);
-                            v4l2_buffer buf = {};
-                            buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
-                            buf.memory = _use_memory_map ? V4L2_MEMORY_MMAP : V4L2_MEMORY_USERPTR;
-                            if(xioctl(_fd, VIDIOC_DQBUF, &buf) < 0)
-                            {
-                                LOG_DEBUG("Dequeued empty buf for fd " << _fd);
-                                if(errno == EAGAIN)
-                                    return;
+        void v4l_uvc_device::dispatch(fd_set& fds, int ready)
+        {
+            LRS_PROFILE_ZONE("v4l2 dequeue");
 
-                                throw linux_backend_exception(to_string() << "xioctl(VIDIOC_DQBUF) failed for fd: " << _fd);
-                            }
-                            //LOG_DEBUG("Dequeued buf " << buf.index << " for fd " << _fd);
+            // Metadata that arrives ahead of its frame waits in the pairing table
+            dequeue_metadata(fds);
 
-                            auto buffer = _buffers[buf.index];
-                            buf_mgr.handle_buffer(e_video_buf,_fd, buf,buffer);
+            if(FD_ISSET(_fd, &fds))
+            {
+                FD_CLR(_fd,&fds);
+                v4l2_buffer buf = {};
+                buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+                buf.memory = _use_memory_map ? V4L2_MEMORY_MMAP : V4L2_MEMORY_USERPTR;
+                if(xioctl(_fd, VIDIOC_DQBUF, &buf) < 0)
+                {
+                    LOG_DEBUG("Dequeued empty buf for fd " << _fd);
+                    if(errno == EAGAIN)
+                        return;
 
-                            if (_is_started)
-                            {
-                                if((buf.bytesused < buffer->get_full_length() - MAX_META_DATA_SIZE) &&
-                                        buf.bytesused > 0)
-                                {
-                                    auto percentage = (100 * buf.bytesused) / buffer->get_full_length();
-                                    std::stringstream s;
-                                    s << "Incomplete video frame detected!\nSize " << buf.bytesused
-                                      << " out of " << buffer->get_full_length() << " bytes (" << percentage << "%)";
-                                    librealsense::notification n = { RS2_NOTIFICATION_CATEGORY_FRAME_CORRUPTED, 0, RS2_LOG_SEVERITY_WARN, s.str()};
+                    throw linux_backend_exception(to_string() << "xioctl(VIDIOC_DQBUF) failed for fd: " << _fd);
+                }
+                //LOG_DEBUG("Dequeued buf " << buf.index << " for fd " << _fd);
+                LRS_PROFILE_FRAME(buf.sequence);
 
-                                    _error_handler(n);
-                                }
-                                else
-                                {
-                                    if (buf.bytesused > 0)
-                                    {
-                                        auto timestamp = (double)buf.timestamp.tv_sec*1000.f + (double)buf.timestamp.tv_usec/1000.f;
-                                        timestamp = monotonic_to_realtime(timestamp);
-
-                                        // read metadata from the frame appendix
-                                        acquire_metadata(buf_mgr,fds);
-
-                                        if (val > 1)
-                                            LOG_INFO("Frame buf ready, md size: " << std::dec << (int)buf_mgr.metadata_size() << " seq. id: " << buf.sequence);
-                                        frame_object fo{ buffer->get_length_frame_only(), buf_mgr.metadata_size(),
-                                            buffer->get_frame_start(), buf_mgr.metadata_start(), timestamp };
-
-                                         buffer->attach_buffer(buf);
-                                         buf_mgr.handle_buffer(e_video_buf,-1); // transfer new buffer request to the frame callback
-
-                                         //Invoke user callback and enqueue next frame
-                                         _callback(_profile, fo,
-                                                   [buf_mgr]() mutable {
-                                             buf_mgr.request_next_frame();
-                                         });
-                                    }
-                                    else
-                                    {
-                                        LOG_INFO("Empty video frame arrived");
-                                    }
-                                }
-                            }
-                            else
-                            {
-                                LOG_INFO("Video frame arrived in idle mode."); // TODO - verification
-                            }
+                auto buffer = _buffers[buf.index];
+
+                // The kernel returns a buffer only once its previous frame was released, so its manager is free again
+                auto buf_mgr = _buf_mgrs[buf.index];
+                buf_mgr->reset();
+                buf_mgr->handle_buffer(e_video_buf,_fd, buf,buffer);
+
+                // Whatever isn't handed over to the frame callback goes back to the kernel
+                struct release_guard
+                {
+                    buffers_mgr& mgr;
+                    ~release_guard() { mgr.release(); }
+                } release{ *buf_mgr };
+
+                // The driver numbers every frame it captures, a gap is frames it had no queued buffer for
+                if (_last_sequence >= 0 && buf.sequence > _last_sequence)
+                    _skipped += static_cast<uint32_t>(buf.sequence - _last_sequence - 1);
+                _last_sequence = buf.sequence;
+
+                if (_is_started)
+                {
+                    // Compressed frames are shorter than the buffer by design, they are as long as their payload
+                    auto compressed = _profile.format == 'MJPG';
+                    if(!compressed && (buf.bytesused < buffer->get_full_length() - MAX_META_DATA_SIZE) &&
+                            buf.bytesused > 0)
+                    {
+                        auto percentage = (100 * buf.bytesused) / buffer->get_full_length();
+                        std::stringstream s;
+                        s << "Incomplete video frame detected!\nSize " << buf.bytesused
+                          << " out of " << buffer->get_full_length() << " bytes (" << percentage << "%)";
+                        librealsense::notification n = { RS2_NOTIFICATION_CATEGORY_FRAME_CORRUPTED, 0, RS2_LOG_SEVERITY_WARN, s.str()};
+
+                        _error_handler(n);
+                        ++_incomplete;
+                    }
+                    else
+                    {
+                        if (buf.bytesused > 0)
+                        {
+                            auto timestamp = (double)buf.timestamp.tv_sec*1000.f + (double)buf.timestamp.tv_usec/1000.f;
+                            timestamp = monotonic_to_realtime(timestamp);
+
+                            // read metadata from the frame appendix, or pair it from the metadata node
+                            acquire_metadata(*buf_mgr,fds);
+
+                            if (ready > 1)
+                                LOG_INFO("Frame buf ready, md size: " << std::dec << (int)buf_mgr->metadata_size() << " seq. id: " << buf.sequence);
+                            auto frame_size = compressed ? std::min<size_t>(buf.bytesused, buffer->get_length_frame_only()) : buffer->get_length_frame_only();
+                            frame_object fo{ frame_size, buf_mgr->metadata_size(),
+                                buffer->get_frame_start(), buf_mgr->metadata_start(), timestamp, buffer->get_dmabuf_fd(),
+                                _skipped, _incomplete };
+                            _skipped = _incomplete = 0;
+
+                             buffer->attach_buffer(buf);
+                             buf_mgr->handle_buffer(e_video_buf,-1); // transfer new buffer request to the frame callback
+
+                             //Invoke user callback and enqueue next frame
+                             _callback(_profile, fo,
+                                       [buf_mgr]() {
+                                 buf_mgr->request_next_frame();
+                             });
                         }
                         else
                         {
-                            LOG_WARNING("FD_ISSET returned false - video node is not signalled (md only)");
+                            LOG_INFO("Empty video frame arrived");
                         }
                     }
                 }
-                else // (val==0)
+                else
                 {
-                    LOG_WARNING("Frames didn't arrived within 5 seconds");
-                        librealsense::notification n = {RS2_NOTIFICATION_CATEGORY_FRAMES_TIMEOUT, 0, RS2_LOG_SEVERITY_WARN,  "Frames didn't arrived within 5 seconds"};
-
-                        _error_handler(n);
+                    LOG_INFO("Video frame arrived in idle mode."); // TODO - verification
                 }
             }
+            else
+            {
+                LOG_WARNING("FD_ISSET returned false - video node is not signalled (md only)");
+            }
+        }
+
+        void v4l_uvc_device::raise_error(const std::exception& ex)
+        {
+            LOG_ERROR(ex.what());
+
+            librealsense::notification n = {RS2_NOTIFICATION_CATEGORY_UNKNOWN_ERROR, 0, RS2_LOG_SEVERITY_ERROR, ex.what()};
+
+            _error_handler(n);
+        }
+
+        void v4l_uvc_device::raise_frames_timeout()
+        {
+            LOG_WARNING("Frames didn't arrived within 5 seconds");
+            librealsense::notification n = {RS2_NOTIFICATION_CATEGORY_FRAMES_TIMEOUT, 0, RS2_LOG_SEVERITY_WARN,  "Frames didn't arrived within 5 seconds"};
+
+            _error_handler(n);
         }
 
         void v4l_uvc_device::acquire_metadata(buffers_mgr & buf_mgr,fd_set &fds)
@@ -1332,11 +1715,7 @@ namespace librealsense
             }
             catch (const std::exception& ex)
             {
-                LOG_ERROR(ex.what());
-
-                librealsense::notification n = {RS2_NOTIFICATION_CATEGORY_UNKNOWN_ERROR, 0, RS2_LOG_SEVERITY_ERROR, ex.what()};
-
-                _error_handler(n);
+                raise_error(ex);
             }
         }
 
@@ -1369,6 +1748,7 @@ namespace librealsense
                 for(size_t i = 0; i < buffers; ++i)
                 {
                     _buffers.push_back(std::make_shared<buffer>(_fd, V4L2_BUF_TYPE_VIDEO_CAPTURE, _use_memory_map, i));
+                    _buf_mgrs.push_back(std::make_shared<buffers_mgr>(_use_memory_map));
                 }
             }
             else
@@ -1378,6 +1758,8 @@ namespace librealsense
                     _buffers[i]->detach_buffer();
                 }
                 _buffers.resize(0);
+                // Frames still alive keep their manager until they are released
+                _buf_mgrs.resize(0);
             }
         }
 
@@ -1509,14 +1891,16 @@ namespace librealsense
                 {
                     _md_buffers.push_back(std::make_shared<buffer>(_md_fd, LOCAL_V4L2_BUF_TYPE_META_CAPTURE, _use_memory_map, i));
                 }
+                _md_pending.assign(buffers, pending_metadata{ v4l2_buffer{}, false });
             }
             else
             {
-                for(size_t i = 0; i < _buffers.size(); i++)
+                for(size_t i = 0; i < _md_buffers.size(); i++)
                 {
                     _md_buffers[i]->detach_buffer();
                 }
                 _md_buffers.resize(0);
+                _md_pending.clear();
             }
         }
 
@@ -1603,21 +1987,24 @@ namespace librealsense
         {
             // Meta node to be initialized first to enforce initial sync
             for (auto&& buf : _md_buffers) buf->prepare_for_streaming(_md_fd);
+            for (auto&& md : _md_pending) md.valid = false;
 
             // Request streaming for video node
             v4l_uvc_device::prepare_capture_buffers();
         }
 
-        // retrieve metadata from a dedicated UVC node
-        void v4l_uvc_meta_device::acquire_metadata(buffers_mgr & buf_mgr,fd_set &fds)
+        void v4l_uvc_meta_device::requeue_metadata(v4l2_buffer& buf)
         {
-            // Metadata is calculated once per frame
-            if (buf_mgr.metadata_size())
-                return;
+            if (xioctl(_md_fd, VIDIOC_QBUF, &buf) < 0)
+                LOG_ERROR("xioctl(VIDIOC_QBUF) failed for metadata fd: " << _md_fd << " error: " << strerror(errno));
+        }
 
-            if(FD_ISSET(_md_fd, &fds))
+        void v4l_uvc_meta_device::drain_metadata()
+        {
+            static const size_t uvc_md_start_offset = sizeof(uvc_meta_buffer::ns) + sizeof(uvc_meta_buffer::sof);
+
+            while (true)
             {
-                FD_CLR(_md_fd,&fds);
                 v4l2_buffer buf{};
                 buf.type = LOCAL_V4L2_BUF_TYPE_META_CAPTURE;
                 buf.memory = _use_memory_map ? V4L2_MEMORY_MMAP : V4L2_MEMORY_USERPTR;
@@ -1631,45 +2018,123 @@ namespace librealsense
                 }
                 //LOG_DEBUG("Dequeued buf " << buf.index << " for fd " << _md_fd);
 
-                auto buffer = _md_buffers[buf.index];
-                buf_mgr.handle_buffer(e_metadata_buf,_md_fd, buf,buffer);
-
-                if (_is_started)
+                if (!_is_started)
                 {
-                    static const size_t uvc_md_start_offset = sizeof(uvc_meta_buffer::ns) + sizeof(uvc_meta_buffer::sof);
-
-                    if(buf.bytesused > uvc_md_start_offset )
+                    LOG_WARNING("Metadata frame arrived in idle mode.");
+                    requeue_metadata(buf);
+                }
+                else if (buf.bytesused <= uvc_md_start_offset)
+                {
+                    // Zero-size buffers generate empty md. Non-zero partial bufs handled as errors
+                    if(buf.bytesused > 0)
                     {
-                        // The first uvc_md_start_offset bytes of metadata buffer are generated by host driver
-                        buf_mgr.set_md_attributes(buf.bytesused - uvc_md_start_offset,
-                                                    buffer->get_frame_start() + uvc_md_start_offset);
-
-                        buffer->attach_buffer(buf);
-                        buf_mgr.handle_buffer(e_metadata_buf,-1); // transfer new buffer request to the frame callback
+                        std::stringstream s;
+                        s << "Invalid metadata payload, size " << buf.bytesused;
+                        LOG_INFO(s.str());
+                        _error_handler({ RS2_NOTIFICATION_CATEGORY_FRAME_CORRUPTED, 0, RS2_LOG_SEVERITY_WARN, s.str()});
                     }
-                    else
+                    requeue_metadata(buf);
+                }
+                else
+                {
+                    auto& md = _md_pending.at(buf.index);
+                    md.buf = buf;
+                    md.valid = true;
+                }
+            }
+        }
+
+        void v4l_uvc_meta_device::dequeue_metadata(fd_set &fds)
+        {
+            if(FD_ISSET(_md_fd, &fds))
+            {
+                FD_CLR(_md_fd,&fds);
+                drain_metadata();
+            }
+        }
+
+        // retrieve metadata from a dedicated UVC node
+        void v4l_uvc_meta_device::acquire_metadata(buffers_mgr & buf_mgr,fd_set &fds)
+        {
+            // How long a frame waits for metadata lagging behind it, the frame goes without it after that
+            static const long md_pairing_timeout_us = 2000;
+            static const size_t uvc_md_start_offset = sizeof(uvc_meta_buffer::ns) + sizeof(uvc_meta_buffer::sof);
+
+            auto sequence = buf_mgr.get_sequence(e_video_buf);
+            if (sequence < 0)
+                return;
+
+            // The driver gives the metadata of a frame the sequence number of the frame
+            pending_metadata* match = nullptr;
+            auto find_match = [&]() {
+                bool later = false;
+                for (auto&& md : _md_pending)
+                {
+                    if (!md.valid)
+                        continue;
+                    auto distance = static_cast<int32_t>(md.buf.sequence - static_cast<uint32_t>(sequence));
+                    if (distance == 0)
+                        match = &md;
+                    else if (distance < 0)
                     {
-                        // Zero-size buffers generate empty md. Non-zero partial bufs handled as errors
-                        if(buf.bytesused > 0)
-                        {
-                            std::stringstream s;
-                            s << "Invalid metadata payload, size " << buf.bytesused;
-                            LOG_INFO(s.str());
-                            _error_handler({ RS2_NOTIFICATION_CATEGORY_FRAME_CORRUPTED, 0, RS2_LOG_SEVERITY_WARN, s.str()});
-                        }
+                        // Its frame was lost or discarded
+                        requeue_metadata(md.buf);
+                        md.valid = false;
                     }
+                    else
+                        later = true;
                 }
-                else
+                return later;
+            };
+
+            // Metadata of later frames means this frame's was lost, otherwise it may still be in flight
+            auto later = find_match();
+            if (!match && !later)
+            {
+                fd_set md_fds;
+                FD_ZERO(&md_fds);
+                FD_SET(_md_fd, &md_fds);
+                timeval timeout = { 0, md_pairing_timeout_us };
+                int val = 0;
+                do {
+                    val = select(_md_fd + 1, &md_fds, NULL, NULL, &timeout);
+                } while (val < 0 && errno == EINTR);
+
+                if (val > 0)
                 {
-                    LOG_WARNING("Metadata frame arrived in idle mode.");
+                    drain_metadata();
+                    find_match();
                 }
             }
+
+            if (!match)
+            {
+                LOG_DEBUG("No metadata for frame seq. id: " << sequence);
+                return;
+            }
+
+            auto buf = match->buf;
+            match->valid = false;
+            auto buffer = _md_buffers[buf.index];
+            buf_mgr.handle_buffer(e_metadata_buf,_md_fd, buf,buffer);
+
+            // The first uvc_md_start_offset bytes of metadata buffer are generated by host driver
+            buf_mgr.set_md_attributes(buf.bytesused - uvc_md_start_offset,
+                                        buffer->get_frame_start() + uvc_md_start_offset);
+
+            buffer->attach_buffer(buf);
+            buf_mgr.handle_buffer(e_metadata_buf,-1); // transfer new buffer request to the frame callback
         }
 
         std::shared_ptr<uvc_device> v4l_backend::create_uvc_device(uvc_device_info info) const
         {
-            auto v4l_uvc_dev = (!info.has_metadata_node) ? std::make_shared<v4l_uvc_device>(info) :
-                                                           std::make_shared<v4l_uvc_meta_device>(info);
+            // Memory-mapped capture allows the kernel buffers to be exported as DMA buffers
+            static const char* dmabuf_var_name = "LRS_V4L2_DMABUF";
+            auto dmabuf = getenv(dmabuf_var_name);
+            bool use_memory_map = dmabuf && std::strtoul(dmabuf, nullptr, 10);
+
+            auto v4l_uvc_dev = (!info.has_metadata_node) ? std::make_shared<v4l_uvc_device>(info, use_memory_map) :
+                                                           std::make_shared<v4l_uvc_meta_device>(info, use_memory_map);
 
             return std::make_shared<platform::retry_controls_work_around>(v4l_uvc_dev);
         }
@@ -1727,9 +2192,158 @@ namespace librealsense
             return std::make_shared<os_time_service>();
         }
 
+        // Listens to the kernel uevents instead of polling, and re-queries the backend once a burst of
+        // usb / video4linux / iio events has settled, so that reconnects are reported within milliseconds
+        class uevent_device_watcher : public device_watcher
+        {
+        public:
+            uevent_device_watcher(const backend* backend_ref)
+                : _backend(backend_ref)
+            {
+                _socket = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_KOBJECT_UEVENT);
+                if (_socket < 0)
+                    throw linux_backend_exception("netlink uevent socket failed");
+
+                sockaddr_nl addr = {};
+                addr.nl_family = AF_NETLINK;
+                addr.nl_groups = 1; // Kernel events
+                if (bind(_socket, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0)
+                {
+                    ::close(_socket);
+                    throw linux_backend_exception("netlink uevent bind failed");
+                }
+
+                _stop_fd = eventfd(0, EFD_CLOEXEC);
+                if (_stop_fd < 0)
+                {
+                    ::close(_socket);
+                    throw linux_backend_exception("eventfd failed");
+                }
+            }
+
+            ~uevent_device_watcher()
+            {
+                stop();
+                ::close(_stop_fd);
+                ::close(_socket);
+            }
+
+            void start(device_changed_callback callback) override
+            {
+                stop();
+                _callback = std::move(callback);
+                _devices_data = { _backend->query_uvc_devices(),
+                                  _backend->query_usb_devices(),
+                                  _backend->query_hid_devices() };
+
+                _thread = std::thread([this]() { run(); });
+            }
+
+            void stop() override
+            {
+                if (!_thread.joinable()) return;
+
+                uint64_t signal = 1;
+                if (write(_stop_fd, &signal, sizeof(signal)) != sizeof(signal))
+                    LOG_ERROR("Failed to signal the device watcher to stop");
+                _thread.join();
+                if (read(_stop_fd, &signal, sizeof(signal)) != sizeof(signal))
+                    LOG_WARNING("Failed to reset the device watcher stop signal");
+            }
+
+        private:
+            // A device shows up as a series of interface events, the backend is queried once they stop arriving
+            static const int settle_time_ms = 100;
+
+            void run()
+            {
+                pollfd fds[] = { { _socket, POLLIN, 0 }, { _stop_fd, POLLIN, 0 } };
+                bool pending = false;
+
+                while (true)
+                {
+                    auto ready = poll(fds, 2, pending ? settle_time_ms : -1);
+                    if (ready < 0)
+                    {
+                        if (errno == EINTR) continue;
+                        LOG_ERROR("Device watcher poll failed, error " << errno);
+                        return;
+                    }
+
+                    if (fds[1].revents) return;
+
+                    if (ready == 0)
+                    {
+                        pending = !refresh();
+                        continue;
+                    }
+
+                    if ((fds[0].revents & POLLIN) && is_relevant_uevent())
+                        pending = true;
+                }
+            }
+
+            bool is_relevant_uevent()
+            {
+                char buffer[4096];
+                auto length = recv(_socket, buffer, sizeof(buffer) - 1, MSG_DONTWAIT);
+                if (length <= 0) return false;
+                buffer[length] = 0;
+
+                // The payload is "action@devpath" followed by NUL separated KEY=value pairs
+                std::string action, subsystem;
+                for (auto field = buffer; field < buffer + length; field += strlen(field) + 1)
+                {
+                    if (!strncmp(field, "ACTION=", 7)) action = field + 7;
+                    else if (!strncmp(field, "SUBSYSTEM=", 10)) subsystem = field + 10;
+                }
+
+                if (action != "add" && action != "remove") return false;
+                return subsystem == "usb" || subsystem == "video4linux" || subsystem == "iio" || subsystem == "hidraw";
+            }
+
+            // Returns false if the backend could not be queried and the refresh should be retried
+            bool refresh()
+            {
+                try
+                {
+                    backend_device_group curr(_backend->query_uvc_devices(), _backend->query_usb_devices(), _backend->query_hid_devices());
+                    if (list_changed(_devices_data.uvc_devices, curr.uvc_devices) ||
+                        list_changed(_devices_data.usb_devices, curr.usb_devices) ||
+                        list_changed(_devices_data.hid_devices, curr.hid_devices))
+                    {
+                        _callback(_devices_data, curr);
+                        _devices_data = curr;
+                    }
+                    return true;
+                }
+                catch (const std::exception& e)
+                {
+                    LOG_WARNING("Device watcher failed to query the devices: " << e.what());
+                    return false;
+                }
+            }
+
+            const backend* _backend;
+            int _socket = -1;
+            int _stop_fd = -1;
+            std::thread _thread;
+
+            backend_device_group _devices_data;
+            device_changed_callback _callback;
+        };
+
         std::shared_ptr<device_watcher> v4l_backend::create_device_watcher() const
         {
-            return std::make_shared<polling_device_watcher>(this);
+            try
+            {
+                return std::make_shared<uevent_device_watcher>(this);
+            }
+            catch (const linux_backend_exception& e)
+            {
+                LOG_WARNING("Kernel uevents are not available (" << e.what() << "), polling for devices instead");
+                return std::make_shared<polling_device_watcher>(this);
+            }
         }
 
         std::shared_ptr<backend> create_backend()
@@ -38,6 +38,8 @@
 #include <fts.h>
 #include <regex>
 #include <list>
+#include <map>
+#include <mutex>
 
 #pragma GCC diagnostic ignored "-Wpedantic"
 #ifdef USE_SYSTEM_LIBUSB
@@ -135,6 +137,9 @@ namespace librealsense
 
             bool use_memory_map() const { return _use_memory_map; }
 
+            // DMA buffer file descriptor of a memory-mapped video buffer, -1 when not exported
+            int get_dmabuf_fd() const { return _dmabuf_fd; }
+
         private:
             v4l2_buf_type _type;
             uint8_t* _start;
@@ -145,6 +150,7 @@ namespace librealsense
             v4l2_buffer _buf;
             std::mutex _mutex;
             bool _must_enqueue = false;
+            int _dmabuf_fd = -1;
         };
 
         enum supported_kernel_buf_types : uint8_t
@@ -168,6 +174,19 @@ namespace librealsense
             ~buffers_mgr(){};
 
             void    request_next_frame();
+
+            // Forgets the buffers of the previous frame, without returning them to the kernel
+            void    reset();
+            // Returns to the kernel the buffers that weren't handed over to a frame
+            void    release();
+
+            // V4L2 sequence number of the buffer held, -1 when there is none
+            int64_t get_sequence(supported_kernel_buf_types buf_type) const
+                    {
+                        auto&& buf = buffers.at(buf_type);
+                        return buf._data_buf ? buf._dq_buf.sequence : -1;
+                    }
+
             void    handle_buffer(supported_kernel_buf_types buf_type, int file_desc,
                                    v4l2_buffer buf= v4l2_buffer(),
                                    std::shared_ptr<platform::buffer> data_buf=nullptr);
@@ -200,7 +219,9 @@ namespace librealsense
             // RAII for buffer exchange with kernel
             struct kernel_buf_guard
             {
-                ~kernel_buf_guard()
+                ~kernel_buf_guard() { requeue(); }
+
+                void requeue()
                 {
                     if (_data_buf && (!_managed))
                     {
@@ -243,6 +264,73 @@ namespace librealsense
             int _mi;
         };
 
+        class v4l_uvc_device;
+
+        // Optional epoll-based event loop servicing the video and metadata nodes of all streaming UVC devices
+        // from a small, shared pool of threads instead of a capture thread per device.
+        // Enabled by setting LRS_V4L2_REACTOR_THREADS to the number of worker threads.
+        // LRS_V4L2_REACTOR_CPUS may list the cores (e.g. "2,3") the workers are pinned to, in order
+        class v4l_reactor
+        {
+        public:
+            struct statistics
+            {
+                uint64_t wakeups = 0;           // Number of times a worker returned from epoll_wait
+                uint64_t dispatches = 0;        // Number of per-device event batches handled
+                double total_dispatch_ms = 0;   // Accumulated time spent handling the batches
+                double max_dispatch_ms = 0;     // Longest single batch
+            };
+
+            // Returns the process-wide reactor, or nullptr when the reactor is not enabled.
+            // The worker threads are started on first use and live until the library is unloaded
+            static v4l_reactor* instance();
+
+            v4l_reactor(const std::vector<int>& cpus, size_t threads);
+            ~v4l_reactor();
+
+            void add(v4l_uvc_device* dev, const std::vector<int>& fds);
+            void remove(v4l_uvc_device* dev);
+
+            statistics get_statistics() const;
+
+        private:
+            struct registration
+            {
+                std::vector<int> fds;
+                std::chrono::steady_clock::time_point last_event;
+            };
+
+            // Written by the worker only, and read without its lock so that readers never wait for a dispatch
+            struct counters
+            {
+                std::atomic<uint64_t> wakeups{ 0 };
+                std::atomic<uint64_t> dispatches{ 0 };
+                std::atomic<double> total_dispatch_ms{ 0 };
+                std::atomic<double> max_dispatch_ms{ 0 };
+            };
+
+            struct worker
+            {
+                int epoll_fd = -1;
+                int wake_fd = -1;
+                int cpu = -1;
+                std::thread thread;
+                std::mutex mutex;   // Held while dispatching, so that remove() never races a running handler
+                std::map<v4l_uvc_device*, registration> devices;
+                std::map<int, v4l_uvc_device*> fd_to_device;
+                std::atomic<size_t> load{ 0 };  // Number of devices, for add() to pick a worker without locking all
+                counters stats;
+            };
+
+            void run(worker& w);
+            std::unique_lock<std::mutex> lock(worker& w) const;
+            // Removes the device if the worker services it, the caller holds the lock of the worker
+            bool remove(worker& w, v4l_uvc_device* dev);
+
+            std::vector<std::unique_ptr<worker>> _workers;
+            std::atomic<bool> _running;
+        };
+
         class v4l_uvc_interface
         {
             virtual void capture_loop() = 0;
@@ -259,11 +347,13 @@ namespace librealsense
             virtual void set_format(stream_profile profile) = 0;
             virtual void prepare_capture_buffers() = 0;
             virtual void stop_data_capture() = 0;
+            virtual void dequeue_metadata(fd_set &fds) = 0;
             virtual void acquire_metadata(buffers_mgr & buf_mgr,fd_set &fds) = 0;
         };
 
         class v4l_uvc_device : public uvc_device, public v4l_uvc_interface
         {
+            friend class v4l_reactor;
         public:
             static void foreach_uvc_device(
                     std::function<void(const uvc_device_info&,
@@ -328,8 +418,14 @@ namespace librealsense
             virtual void set_format(stream_profile profile);
             virtual void prepare_capture_buffers();
             virtual void stop_data_capture();
+            virtual void dequeue_metadata(fd_set &fds) {}
             virtual void acquire_metadata(buffers_mgr & buf_mgr,fd_set &fds);
 
+            // Handles the descriptors reported ready by select/epoll
+            void dispatch(fd_set& fds, int ready);
+            void raise_error(const std::exception& ex);
+            void raise_frames_timeout();
+
             power_state _state = D3;
             std::string _name = "";
             std::string _device_path = "";
@@ -337,16 +433,21 @@ namespace librealsense
             uvc_device_info _info;
 
             std::vector<std::shared_ptr<buffer>> _buffers;
+            std::vector<std::shared_ptr<buffers_mgr>> _buf_mgrs;   // per video buffer, reused by each frame it carries
             stream_profile _profile;
             frame_callback _callback;
             std::atomic<bool> _is_capturing;
             std::atomic<bool> _is_alive;
             std::atomic<bool> _is_started;
             std::unique_ptr<std::thread> _thread;
+            v4l_reactor* _reactor = nullptr;
             std::unique_ptr<named_mutex> _named_mtx;
             bool _use_memory_map;
             int _max_fd = 0;                    // specifies the maximal pipe number the polling process will monitor
             std::vector<int>  _fds;             // list the file descriptors to be monitored during frames polling
+            int64_t _last_sequence = -1;        // of the previous frame dequeued, for the gaps in the capture sequence
+            uint32_t _skipped = 0;              // frames missed since the last one delivered
+            uint32_t _incomplete = 0;           // frames discarded incomplete since the last one delivered
 
         private:
             int _fd = 0;          // prevent unintentional abuse in derived class
@@ -372,12 +473,24 @@ namespace librealsense
             void unmap_device_descriptor();
             void set_format(stream_profile profile);
             void prepare_capture_buffers();
+            virtual void dequeue_metadata(fd_set &fds);
             virtual void acquire_metadata(buffers_mgr & buf_mgr,fd_set &fds);
 
+            // Dequeues every metadata buffer that is ready into the pairing table
+            void drain_metadata();
+            void requeue_metadata(v4l2_buffer& buf);
+
             int _md_fd = -1;
             std::string _md_name = "";
 
             std::vector<std::shared_ptr<buffer>> _md_buffers;
+            // Metadata dequeued ahead of its frame, by buffer index, matched to the frames by V4L2 sequence number
+            struct pending_metadata
+            {
+                v4l2_buffer buf;
+                bool valid;
+            };
+            std::vector<pending_metadata> _md_pending;
             stream_profile _md_profile;
         };
 
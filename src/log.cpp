@@ -1,12 +1,88 @@
 #include "types.h"
 
 #include <fstream>
+#include <deque>
+#include <iomanip>
 
 #if BUILD_EASYLOGGINGPP
 INITIALIZE_EASYLOGGINGPP
 
 namespace librealsense
 {
+    // Lowest severity accepted by some destination, constant initialized so that logging from static
+    // constructors sees everything disabled
+    static std::atomic<int> minimum_enabled_severity(RS2_LOG_SEVERITY_NONE);
+
+    struct log_record
+    {
+        rs2_log_severity severity;
+        const char* file;
+        int line;
+        std::thread::id thread;
+        std::chrono::system_clock::time_point time;
+        std::string message;
+    };
+
+    // Bounded ring of records written from any thread and read by one consumer at a time. A producer claims
+    // the next slot with a compare-exchange and never waits, a full ring rejects the record
+    class log_ring
+    {
+        struct slot
+        {
+            std::atomic<size_t> sequence;
+            log_record record;
+        };
+
+        std::unique_ptr<slot[]> _slots;
+        const size_t _mask;
+        std::atomic<size_t> _head;
+        size_t _tail;
+
+    public:
+        explicit log_ring(size_t size_pow2)
+            : _slots(new slot[size_pow2]), _mask(size_pow2 - 1), _head(0), _tail(0)
+        {
+            for (size_t i = 0; i < size_pow2; i++)
+                _slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+
+        bool push(log_record&& record)
+        {
+            auto pos = _head.load(std::memory_order_relaxed);
+            while (true)
+            {
+                auto& s = _slots[pos & _mask];
+                auto seq = s.sequence.load(std::memory_order_acquire);
+                auto diff = static_cast<std::ptrdiff_t>(seq - pos);
+                if (diff == 0)
+                {
+                    if (_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    {
+                        s.record = std::move(record);
+                        s.sequence.store(pos + 1, std::memory_order_release);
+                        return true;
+                    }
+                }
+                else if (diff < 0)
+                    return false; // the consumer did not free this slot yet
+                else
+                    pos = _head.load(std::memory_order_relaxed);
+            }
+        }
+
+        // Callers serialize the consumption
+        bool pop(log_record& record)
+        {
+            auto& s = _slots[_tail & _mask];
+            if (s.sequence.load(std::memory_order_acquire) != _tail + 1)
+                return false;
+            record = std::move(s.record);
+            s.sequence.store(_tail + _mask + 1, std::memory_order_release);
+            ++_tail;
+            return true;
+        }
+    };
+
     class logger_type
     {
         rs2_log_severity minimum_log_severity = RS2_LOG_SEVERITY_NONE;
@@ -21,6 +97,89 @@ namespace librealsense
         std::string filename;
         const std::string log_id = "librealsense";
 
+        // The callers queue their messages, the logging thread writes them to easylogging
+        static const size_t ring_size = 4096;
+        static const size_t history_size = 1024;
+        log_ring ring;
+        std::atomic<uint64_t> dropped;
+        std::mutex write_mutex;             // Serializes the draining of the ring and guards the history
+        std::deque<std::string> history;    // The last lines written, for dump_log_history
+        std::mutex wake_mutex;
+        std::condition_variable wake_cv;
+        std::atomic<bool> sleeping;
+        std::atomic<bool> active;
+        std::thread worker;
+
+        static const char* level_name(rs2_log_severity severity)
+        {
+            switch (severity)
+            {
+            case RS2_LOG_SEVERITY_DEBUG: return "DEBUG";
+            case RS2_LOG_SEVERITY_INFO: return "INFO";
+            case RS2_LOG_SEVERITY_WARN: return "WARNING";
+            case RS2_LOG_SEVERITY_ERROR: return "ERROR";
+            case RS2_LOG_SEVERITY_FATAL: return "FATAL";
+            default: return "UNKNOWN";
+            }
+        }
+
+        // Same layout as the easylogging format the library used, with the time and the thread of the caller
+        static std::string format(const log_record& r)
+        {
+            auto t = std::chrono::system_clock::to_time_t(r.time);
+            auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(r.time.time_since_epoch()).count() % 1000;
+            char buffer[20] = {};
+            if (const tm* time = localtime(&t))
+                strftime(buffer, sizeof(buffer), "%d/%m %H:%M:%S", time);
+
+            std::string file(r.file);
+            auto slash = file.find_last_of("/\\");
+            if (slash != std::string::npos)
+                file = file.substr(slash + 1);
+
+            std::ostringstream ss;
+            ss << " " << buffer << "," << std::setw(3) << std::setfill('0') << ms << std::setfill(' ')
+               << " " << level_name(r.severity) << " [" << r.thread << "] (" << file << ":" << r.line << ") " << r.message;
+            return ss.str();
+        }
+
+        // Called with write_mutex held
+        void write(const log_record& r)
+        {
+            auto line = format(r);
+            el::base::Writer(severity_to_level(r.severity), r.file, r.line, "").construct(1, log_id.c_str()) << line;
+            history.push_back(std::move(line));
+            if (history.size() > history_size)
+                history.pop_front();
+        }
+
+        void drain()
+        {
+            std::lock_guard<std::mutex> lock(write_mutex);
+            log_record r;
+            while (ring.pop(r))
+                write(r);
+
+            if (auto count = dropped.exchange(0))
+                write({ RS2_LOG_SEVERITY_WARN, __FILE__, __LINE__, std::this_thread::get_id(), std::chrono::system_clock::now(),
+                        to_string() << count << " log messages were dropped, the logging thread fell behind" });
+        }
+
+        void run()
+        {
+            while (active)
+            {
+                drain();
+
+                // The producers only notify a sleeping thread, a notification missed while falling asleep
+                // delays the messages by the wait timeout at most
+                std::unique_lock<std::mutex> lock(wake_mutex);
+                sleeping = true;
+                wake_cv.wait_for(lock, std::chrono::milliseconds(100));
+                sleeping = false;
+            }
+        }
+
     public:
         static el::Level severity_to_level(rs2_log_severity severity)
         {
@@ -35,7 +194,7 @@ namespace librealsense
             }
         }
 
-        void open() const
+        void open()
         {
             el::Configurations defaultConf;
             defaultConf.setToDefault();
@@ -45,7 +204,8 @@ namespace librealsense
             defaultConf.setGlobally(el::ConfigurationType::ToStandardOutput, "false");
             defaultConf.setGlobally(el::ConfigurationType::MaxLogFileSize, "2097152");
             defaultConf.setGlobally(el::ConfigurationType::LogFlushThreshold, "10");
-            defaultConf.setGlobally(el::ConfigurationType::Format, " %datetime{%d/%M %H:%m:%s,%g} %level [%thread] (%fbase:%line) %msg");
+            // The lines are formatted by format(), with the time and the thread of the caller
+            defaultConf.setGlobally(el::ConfigurationType::Format, "%msg");
 
             for (int i = minimum_console_severity; i < RS2_LOG_SEVERITY_NONE; i++)
             {
@@ -60,10 +220,12 @@ namespace librealsense
                     el::ConfigurationType::ToFile, "true");
             }
 
+            std::lock_guard<std::mutex> lock(write_mutex);
             el::Loggers::reconfigureLogger(log_id, defaultConf);
+            minimum_enabled_severity = std::min(minimum_console_severity, minimum_file_severity);
         }
 
-        void open_def() const
+        void open_def()
         {
             el::Configurations defaultConf;
             defaultConf.setToDefault();
@@ -72,13 +234,16 @@ namespace librealsense
             defaultConf.setGlobally(el::ConfigurationType::ToFile, "false");
             defaultConf.setGlobally(el::ConfigurationType::ToStandardOutput, "false");
 
+            std::lock_guard<std::mutex> lock(write_mutex);
             el::Loggers::reconfigureLogger(log_id, defaultConf);
+            minimum_enabled_severity = RS2_LOG_SEVERITY_NONE;
         }
 
 
         logger_type()
             : callback(nullptr, [](rs2_log_callback*) {}),
-              filename(to_string() << datetime_string() << ".log")
+              filename(to_string() << datetime_string() << ".log"),
+              ring(ring_size), dropped(0), sleeping(false), active(true)
         {
             rs2_log_severity severity;
             if (try_get_log_severity(severity))
@@ -89,6 +254,16 @@ namespace librealsense
             {
                 open_def();
             }
+            worker = std::thread([this]() { run(); });
+        }
+
+        ~logger_type()
+        {
+            minimum_enabled_severity = RS2_LOG_SEVERITY_NONE;
+            active = false;
+            wake_cv.notify_one();
+            worker.join();
+            drain();
         }
 
         static bool try_get_log_severity(rs2_log_severity& severity)
@@ -133,6 +308,35 @@ namespace librealsense
 
             open();
         }
+
+        void log(log_record&& record)
+        {
+            // Fatal messages abort the application, they are written with everything queued before them
+            if (record.severity == RS2_LOG_SEVERITY_FATAL)
+            {
+                drain();
+                std::lock_guard<std::mutex> lock(write_mutex);
+                write(record);
+                return;
+            }
+
+            if (!ring.push(std::move(record)))
+                dropped++;
+            else if (sleeping.load(std::memory_order_relaxed))
+                wake_cv.notify_one();
+        }
+
+        void dump_history(const char* file_path)
+        {
+            drain();
+            std::ofstream out(file_path);
+            if (!out)
+                throw invalid_value_exception(to_string() << "Could not open " << file_path << " for writing");
+
+            std::lock_guard<std::mutex> lock(write_mutex);
+            for (auto&& line : history)
+                out << line << "\n";
+        }
     };
 
     static logger_type logger;
@@ -148,6 +352,26 @@ void librealsense::log_to_file(rs2_log_severity min_severity, const char * file_
     logger.log_to_file(min_severity, file_path);
 }
 
+void librealsense::dump_log_history(const char * file_path)
+{
+    logger.dump_history(file_path);
+}
+
+bool librealsense::is_log_enabled(rs2_log_severity severity)
+{
+    return severity >= minimum_enabled_severity.load(std::memory_order_relaxed) || severity == RS2_LOG_SEVERITY_FATAL;
+}
+
+bool librealsense::is_debug_log_enabled()
+{
+    return is_log_enabled(RS2_LOG_SEVERITY_DEBUG);
+}
+
+void librealsense::log_message(rs2_log_severity severity, const char * file, int line, std::string&& message)
+{
+    logger.log({ severity, file, line, std::this_thread::get_id(), std::chrono::system_clock::now(), std::move(message) });
+}
+
 #else // BUILD_EASYLOGGINGPP
 
 void librealsense::log_to_console(rs2_log_severity min_severity)
@@ -158,5 +382,23 @@ void librealsense::log_to_file(rs2_log_severity min_severity, const char * file_
 {
 }
 
+void librealsense::dump_log_history(const char * file_path)
+{
+}
+
+bool librealsense::is_log_enabled(rs2_log_severity severity)
+{
+    return false;
+}
+
+bool librealsense::is_debug_log_enabled()
+{
+    return false;
+}
+
+void librealsense::log_message(rs2_log_severity severity, const char * file, int line, std::string&& message)
+{
+}
+
 #endif // BUILD_EASYLOGGINGPP
 
@@ -0,0 +1,41 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "media/ros/ros_writer.h"
+#include "media/ros/ros_reader.h"
+#include "media/native/native_writer.h"
+#include "media/native/native_reader.h"
+#include "media/playback/segmented_reader.h"
+
+namespace librealsense
+{
+    // Files named with the native extension are recorded in the native format, all others as rosbag
+    inline std::shared_ptr<device_serializer::writer> create_file_writer(const std::string& file, bool compress_while_record)
+    {
+        if (native_file_format::is_native_file_name(file))
+            return std::make_shared<native_writer>(file, compress_while_record);
+        return std::make_shared<ros_writer>(file, compress_while_record);
+    }
+
+    // The format of a recording is told by its content, regardless of the file name
+    inline std::shared_ptr<device_serializer::reader> create_segment_reader(const std::string& file, const std::shared_ptr<context>& ctx)
+    {
+        if (native_file_format::is_native_file(file))
+            return std::make_shared<native_reader>(file, ctx);
+        return std::make_shared<ros_reader>(file, ctx);
+    }
+
+    // Recordings that were split into segments are played as a whole, from their first file
+    inline std::shared_ptr<device_serializer::reader> create_file_reader(const std::string& file, const std::shared_ptr<context>& ctx)
+    {
+        std::vector<std::string> files{ file };
+        while (std::ifstream(device_serializer::get_segment_file_name(file, static_cast<uint32_t>(files.size()))).good())
+            files.push_back(device_serializer::get_segment_file_name(file, static_cast<uint32_t>(files.size())));
+
+        if (files.size() == 1)
+            return create_segment_reader(file, ctx);
+        return std::make_shared<segmented_reader>(files, [ctx](const std::string& segment) { return create_segment_reader(segment, ctx); });
+    }
+}
@@ -0,0 +1,212 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "core/serialization.h"
+#include "media/ros/ros_file_format.h"
+
+namespace librealsense
+{
+    /**
+    * The native recording format is an append-only sequence of chunks, followed by an index once the file is closed:
+    *
+    *   file_header | chunk ... chunk | index_entry ... index_entry | file_footer
+    *
+    * A chunk is a chunk_header and its records, each a record_header and its payload. Chunks are written whole, so
+    * a file that is still being recorded can be read up to its last complete chunk. The index lists every record,
+    * sorted by time, and is aligned so that readers use it straight from the file mapping. Files that have no footer
+    * (still recording, or not closed properly) are indexed by scanning their chunks.
+    */
+    namespace native_file_format
+    {
+        constexpr uint32_t FILE_MAGIC = 0x464e5352;     // "RSNF"
+        constexpr uint32_t CHUNK_MAGIC = 0x434e5352;    // "RSNC"
+        constexpr uint32_t FOOTER_MAGIC = 0x454e5352;   // "RSNE"
+        constexpr uint32_t NO_SENSOR = 0xffffffff;
+
+        constexpr uint32_t get_file_version()
+        {
+            return 1u;
+        }
+
+        // Recording to a file of this extension selects the native format
+        constexpr const char* FILE_EXTENSION = ".rsn";
+
+        enum record_type : uint32_t
+        {
+            device_info_record = 1,
+            sensor_info_record,
+            stream_profile_record,
+            option_record,
+            extrinsics_record,
+            frame_record,
+            metadata_record,    // Columnar metadata of the frames of one stream in the chunk
+            notification_record
+        };
+
+        // How the image of a frame record is stored
+        enum frame_codec : uint32_t
+        {
+            raw_codec,
+            lz4_codec,
+            rvl_codec,          // Z16 depth, see rvl-codec.h
+            jpeg_codec          // RGB8 and Y8, lossy, see jpeg-codec.h
+        };
+
+        enum frame_kind : uint32_t
+        {
+            video_frame_kind,
+            motion_frame_kind,
+            pose_frame_kind
+        };
+
+        struct file_header
+        {
+            uint32_t magic;
+            uint32_t version;
+        };
+
+        struct chunk_header
+        {
+            uint32_t magic;
+            uint32_t records;
+            uint64_t size;      // Bytes of the records that follow
+        };
+
+        struct record_header
+        {
+            uint32_t type;
+            uint32_t sensor_index;
+            uint32_t stream_type;
+            uint32_t stream_index;
+            uint64_t time;      // Nanoseconds since the start of the recording
+            uint32_t size;      // Bytes of the payload that follows
+            uint32_t reserved;
+        };
+
+        struct index_entry
+        {
+            uint64_t offset;    // Of the record_header in the file
+            uint64_t time;
+            uint64_t metadata;  // Offset of the metadata record of a frame, 0 if it has none
+            uint32_t type;
+            uint32_t sensor_index;
+            uint32_t stream_type;
+            uint32_t stream_index;
+        };
+
+        struct file_footer
+        {
+            uint64_t index_offset;
+            uint64_t entries;
+            uint32_t magic;
+            uint32_t version;
+        };
+
+        // Leading fields of the payload of a frame record, followed by the stored image
+        struct frame_header
+        {
+            uint32_t kind;
+            uint32_t codec;
+            uint32_t format;
+            uint32_t width;
+            uint32_t height;
+            uint32_t stride;
+            uint32_t bpp;
+            uint32_t raw_size;  // Bytes of the image once decoded
+            uint64_t frame_number;
+            double timestamp;
+        };
+
+        inline device_serializer::stream_identifier get_stream_identifier(const index_entry& entry)
+        {
+            return { get_device_index(), entry.sensor_index, static_cast<rs2_stream>(entry.stream_type), entry.stream_index };
+        }
+
+        inline bool is_native_file_name(const std::string& file)
+        {
+            std::string extension(FILE_EXTENSION);
+            return file.size() >= extension.size() && file.compare(file.size() - extension.size(), extension.size(), extension) == 0;
+        }
+
+        // Tells native recordings apart from rosbag files by their leading bytes
+        inline bool is_native_file(const std::string& file)
+        {
+            std::ifstream in(file, std::ios::binary);
+            file_header header{};
+            return in.read(reinterpret_cast<char*>(&header), sizeof(header)) && header.magic == FILE_MAGIC;
+        }
+
+        // Appends the fields of a record payload
+        class payload_writer
+        {
+        public:
+            explicit payload_writer(std::vector<uint8_t>& out) : _out(out) {}
+
+            template<class T>
+            void write(const T& value)
+            {
+                write_bytes(&value, sizeof(T));
+            }
+
+            void write_string(const std::string& value)
+            {
+                write(static_cast<uint32_t>(value.size()));
+                write_bytes(value.data(), value.size());
+            }
+
+            void write_bytes(const void* data, size_t size)
+            {
+                auto bytes = static_cast<const uint8_t*>(data);
+                _out.insert(_out.end(), bytes, bytes + size);
+            }
+
+        private:
+            std::vector<uint8_t>& _out;
+        };
+
+        // Reads the fields of a record payload, throws if the payload is truncated
+        class payload_reader
+        {
+        public:
+            payload_reader(const uint8_t* data, size_t size) : _data(data), _size(size), _offset(0) {}
+
+            template<class T>
+            T read()
+            {
+                T value;
+                memcpy(&value, read_bytes(sizeof(T)), sizeof(T));
+                return value;
+            }
+
+            std::string read_string()
+            {
+                auto size = read<uint32_t>();
+                auto data = reinterpret_cast<const char*>(read_bytes(size));
+                return std::string(data, data + size);
+            }
+
+            const uint8_t* read_bytes(size_t size)
+            {
+                if (size > _size - _offset)
+                    throw io_exception("Invalid file format, record is truncated");
+                auto data = _data + _offset;
+                _offset += size;
+                return data;
+            }
+
+            size_t remaining() const { return _size - _offset; }
+
+        private:
+            const uint8_t* _data;
+            size_t _size;
+            size_t _offset;
+        };
+    }
+}
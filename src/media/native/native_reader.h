@@ -0,0 +1,598 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include <algorithm>
+#include <map>
+#include <set>
+#include <string>
+#include <lz4.h>
+#include "core/serialization.h"
+#include "archive.h"
+#include "metadata-parser.h"
+#include "option.h"
+#include "source.h"
+#include "stream.h"
+#include "native_file_format.h"
+#include "media/ros/mapped_file.h"
+#include "proc/rvl-codec.h"
+#ifdef RS2_USE_LIBJPEG
+#include "proc/jpeg-codec.h"
+#endif
+
+namespace librealsense
+{
+    using namespace device_serializer;
+
+    class native_reader : public device_serializer::reader
+    {
+    public:
+        native_reader(const std::string& file, const std::shared_ptr<context>& ctx) :
+            m_file_path(file),
+            m_context(ctx),
+            m_metadata_parser_map(md_constant_parser::create_metadata_parser_map())
+        {
+            try
+            {
+                reset(); //Note: calling a virtual function inside c'tor, safe while base function is pure virtual
+            }
+            catch (const std::exception& e)
+            {
+                //Rethrowing with better clearer message
+                throw io_exception(to_string() << "Failed to create native reader: " << e.what());
+            }
+        }
+
+        device_snapshot query_device_description(const nanoseconds& time) override
+        {
+            if (time == get_static_file_info_timestamp())
+                return m_initial_device_description;
+
+            //update only:
+            auto device_snapshot = m_initial_device_description;
+            for (auto& sensor : device_snapshot.get_sensors_snapshots())
+            {
+                update_sensor_options(sensor.get_sensor_index(), time, sensor.get_sensor_extensions_snapshots());
+            }
+            return device_snapshot;
+        }
+
+        std::shared_ptr<serialized_data> read_next_data() override
+        {
+            if (!m_streaming)
+            {
+                LOG_DEBUG("End of file reached");
+                return std::make_shared<serialized_end_of_file>();
+            }
+
+            //Files that are still being recorded are read up to their last complete chunk
+            while (m_cursor < entries_count() || refresh())
+            {
+                auto entry = entries()[m_cursor++];
+                nanoseconds timestamp(entry.time);
+                switch (entry.type)
+                {
+                case native_file_format::frame_record:
+                    if (m_enabled_streams.count(native_file_format::get_stream_identifier(entry)))
+                        return create_frame(entry);
+                    break;
+                case native_file_format::option_record:
+                    if (timestamp != get_static_file_info_timestamp())
+                    {
+                        auto option = create_option(entry);
+                        return std::make_shared<serialized_option>(timestamp, sensor_identifier{ get_device_index(), entry.sensor_index }, option.first, option.second);
+                    }
+                    break;
+                case native_file_format::notification_record:
+                    if (timestamp != get_static_file_info_timestamp())
+                        return std::make_shared<serialized_notification>(timestamp, sensor_identifier{ get_device_index(), entry.sensor_index }, create_notification(entry));
+                    break;
+                default:
+                    break;
+                }
+            }
+
+            LOG_DEBUG("End of file reached");
+            return std::make_shared<serialized_end_of_file>();
+        }
+
+        void seek_to_time(const nanoseconds& seek_time) override
+        {
+            if (seek_time > query_duration())
+            {
+                throw invalid_value_exception(to_string() << "Requested time is out of playback length. (Requested = " << seek_time.count() << ", Duration = " << query_duration().count() << ")");
+            }
+            m_cursor = lower_bound(seek_time.count());
+            m_streaming = true;
+        }
+
+        std::vector<std::shared_ptr<serialized_data>> fetch_last_frames(const nanoseconds& seek_time) override
+        {
+            std::vector<std::shared_ptr<serialized_data>> result;
+            auto remaining = m_enabled_streams;
+            //Walking the index back from the seek time, up to the last frame of every stream
+            for (auto i = upper_bound(seek_time.count()); i > 0 && !remaining.empty(); --i)
+            {
+                auto& entry = entries()[i - 1];
+                if (entry.type != native_file_format::frame_record || entry.stream_type == RS2_STREAM_POSE)
+                    continue;
+                if (remaining.erase(native_file_format::get_stream_identifier(entry)))
+                    result.push_back(create_frame(entry));
+            }
+            return result;
+        }
+
+        nanoseconds query_duration() const override
+        {
+            return nanoseconds(m_last_frame_time - m_first_frame_time);
+        }
+
+        void reset() override
+        {
+            m_mapping = std::make_shared<mapped_file>(m_file_path);
+            native_file_format::file_header header{};
+            if (m_mapping->size() < sizeof(header))
+                throw io_exception("Invalid file format, file header is truncated");
+            memcpy(&header, m_mapping->data(), sizeof(header));
+            if (header.magic != native_file_format::FILE_MAGIC)
+                throw io_exception("Invalid file format, not a native recording");
+            if (header.version > native_file_format::get_file_version())
+                throw io_exception(to_string() << "Unsupported native file version " << header.version);
+
+            m_index = nullptr;
+            m_index_size = 0;
+            m_scanned.clear();
+            m_scan_offset = sizeof(header);
+            m_first_frame_time = m_last_frame_time = 0;
+            if (!map_index())
+            {
+                LOG_INFO(m_file_path << " has no index, it is still being recorded or was not closed");
+                scan_chunks();
+            }
+            update_duration();
+
+            m_metadata_blocks.clear();
+            m_cursor = 0;
+            m_streaming = false;
+            m_frame_source = std::make_shared<frame_source>(32);
+            m_frame_source->init(m_metadata_parser_map);
+            m_initial_device_description = read_device_description();
+        }
+
+        void enable_stream(const std::vector<device_serializer::stream_identifier>& stream_ids) override
+        {
+            if (!m_streaming) //Starting to stream
+            {
+                m_cursor = 0;
+                m_streaming = true;
+            }
+            m_enabled_streams.insert(stream_ids.begin(), stream_ids.end());
+        }
+
+        void disable_stream(const std::vector<device_serializer::stream_identifier>& stream_ids) override
+        {
+            for (auto&& id : stream_ids)
+                m_enabled_streams.erase(id);
+        }
+
+        const std::string& get_file_name() const override
+        {
+            return m_file_path;
+        }
+
+    private:
+        const native_file_format::index_entry* entries() const
+        {
+            return m_index ? m_index : m_scanned.data();
+        }
+
+        size_t entries_count() const
+        {
+            return m_index ? m_index_size : m_scanned.size();
+        }
+
+        size_t lower_bound(uint64_t time) const
+        {
+            return std::lower_bound(entries(), entries() + entries_count(), time, [](const native_file_format::index_entry& e, uint64_t t) { return e.time < t; }) - entries();
+        }
+
+        size_t upper_bound(uint64_t time) const
+        {
+            return std::upper_bound(entries(), entries() + entries_count(), time, [](uint64_t t, const native_file_format::index_entry& e) { return t < e.time; }) - entries();
+        }
+
+        // Uses the index of a closed file in place, false if the file has none
+        bool map_index()
+        {
+            native_file_format::file_footer footer{};
+            auto size = m_mapping->size();
+            if (size < sizeof(native_file_format::file_header) + sizeof(footer))
+                return false;
+            memcpy(&footer, m_mapping->data() + size - sizeof(footer), sizeof(footer));
+            if (footer.magic != native_file_format::FOOTER_MAGIC || footer.index_offset % sizeof(uint64_t) != 0 ||
+                footer.index_offset > size - sizeof(footer) ||
+                footer.entries != (size - sizeof(footer) - footer.index_offset) / sizeof(native_file_format::index_entry))
+                return false;
+
+            m_index = reinterpret_cast<const native_file_format::index_entry*>(m_mapping->data() + footer.index_offset);
+            m_index_size = static_cast<size_t>(footer.entries);
+            return true;
+        }
+
+        // Indexes the complete chunks past the ones already scanned
+        void scan_chunks()
+        {
+            auto data = m_mapping->data();
+            auto size = m_mapping->size();
+            native_file_format::chunk_header chunk{};
+            while (m_scan_offset + sizeof(chunk) <= size)
+            {
+                memcpy(&chunk, data + m_scan_offset, sizeof(chunk));
+                if (chunk.magic != native_file_format::CHUNK_MAGIC || chunk.size > size - m_scan_offset - sizeof(chunk))
+                    break;
+
+                auto first = m_scanned.size();
+                auto offset = m_scan_offset + sizeof(chunk);
+                auto end = offset + chunk.size;
+                while (offset + sizeof(native_file_format::record_header) <= end)
+                {
+                    native_file_format::record_header record{};
+                    memcpy(&record, data + offset, sizeof(record));
+                    if (record.size > end - offset - sizeof(record))
+                        throw io_exception(to_string() << "Invalid file format, truncated record at " << offset);
+
+                    if (record.type == native_file_format::metadata_record)
+                    {
+                        for (auto i = first; i < m_scanned.size(); ++i)
+                        {
+                            auto& entry = m_scanned[i];
+                            if (entry.type == native_file_format::frame_record && entry.sensor_index == record.sensor_index &&
+                                entry.stream_type == record.stream_type && entry.stream_index == record.stream_index)
+                                entry.metadata = offset;
+                        }
+                    }
+                    m_scanned.push_back({ offset, record.time, 0, record.type, record.sensor_index, record.stream_type, record.stream_index });
+                    offset += sizeof(record) + record.size;
+                }
+
+                auto by_time = [](const native_file_format::index_entry& a, const native_file_format::index_entry& b) { return a.time < b.time; };
+                std::stable_sort(m_scanned.begin() + first, m_scanned.end(), by_time);
+                std::inplace_merge(m_scanned.begin(), m_scanned.begin() + first, m_scanned.end(), by_time);
+                m_scan_offset = end;
+            }
+        }
+
+        // Picks up the chunks written since the file was last mapped, false if there are none
+        bool refresh()
+        {
+            if (m_index)
+                return false;
+
+            auto count = m_scanned.size();
+            m_mapping = std::make_shared<mapped_file>(m_file_path);
+            scan_chunks();
+            update_duration();
+            return m_scanned.size() > count;
+        }
+
+        void update_duration()
+        {
+            auto begin = entries(), end = entries() + entries_count();
+            auto is_frame = [](const native_file_format::index_entry& e) { return e.type == native_file_format::frame_record; };
+            auto first = std::find_if(begin, end, is_frame);
+            if (first == end)
+                return;
+            auto last = std::find_if(std::reverse_iterator<const native_file_format::index_entry*>(end),
+                std::reverse_iterator<const native_file_format::index_entry*>(begin), is_frame);
+            m_first_frame_time = first->time;
+            m_last_frame_time = last->time;
+        }
+
+        native_file_format::payload_reader read_record(uint64_t offset) const
+        {
+            native_file_format::record_header record{};
+            if (offset + sizeof(record) > m_mapping->size())
+                throw io_exception(to_string() << "Invalid file format, record at " << offset << " is out of the file");
+            memcpy(&record, m_mapping->data() + offset, sizeof(record));
+            if (record.size > m_mapping->size() - offset - sizeof(record))
+                throw io_exception(to_string() << "Invalid file format, truncated record at " << offset);
+            return native_file_format::payload_reader(m_mapping->data() + offset + sizeof(record), record.size);
+        }
+
+        device_snapshot read_device_description() const
+        {
+            snapshot_collection device_extensions;
+            auto device_info = std::make_shared<info_container>();
+            device_extensions[RS2_EXTENSION_INFO] = device_info;
+
+            std::map<uint32_t, std::shared_ptr<info_container>> sensor_infos;
+            std::map<uint32_t, stream_profiles> sensor_streams;
+            std::map<stream_identifier, std::pair<uint32_t, rs2_extrinsics>> extrinsics_map;
+            for (size_t i = 0; i < entries_count(); ++i)
+            {
+                auto& entry = entries()[i];
+                switch (entry.type)
+                {
+                case native_file_format::device_info_record:
+                    read_info(entry, *device_info);
+                    break;
+                case native_file_format::sensor_info_record:
+                {
+                    auto& info = sensor_infos[entry.sensor_index];
+                    if (!info)
+                        info = std::make_shared<info_container>();
+                    read_info(entry, *info);
+                    break;
+                }
+                case native_file_format::stream_profile_record:
+                    sensor_streams[entry.sensor_index].push_back(create_stream_profile(entry));
+                    break;
+                case native_file_format::extrinsics_record:
+                {
+                    auto payload = read_record(entry.offset);
+                    auto reference_id = payload.read<uint32_t>();
+                    extrinsics_map[native_file_format::get_stream_identifier(entry)] = std::make_pair(reference_id, payload.read<rs2_extrinsics>());
+                    break;
+                }
+                default:
+                    break;
+                }
+            }
+
+            std::vector<sensor_snapshot> sensor_descriptions;
+            for (auto&& info : sensor_infos)
+            {
+                snapshot_collection sensor_extensions;
+                sensor_extensions[RS2_EXTENSION_INFO] = info.second;
+                update_sensor_options(info.first, get_static_file_info_timestamp(), sensor_extensions);
+                sensor_descriptions.emplace_back(info.first, sensor_extensions, sensor_streams[info.first]);
+            }
+            return device_snapshot(device_extensions, sensor_descriptions, extrinsics_map);
+        }
+
+        void read_info(const native_file_format::index_entry& entry, info_container& infos) const
+        {
+            auto payload = read_record(entry.offset);
+            while (payload.remaining() > 0)
+            {
+                auto info = payload.read<uint32_t>();
+                auto value = payload.read_string();
+                if (info < static_cast<uint32_t>(RS2_CAMERA_INFO_COUNT))
+                    infos.register_info(static_cast<rs2_camera_info>(info), value);
+            }
+        }
+
+        std::shared_ptr<stream_profile_interface> create_stream_profile(const native_file_format::index_entry& entry) const
+        {
+            auto payload = read_record(entry.offset);
+            auto kind = payload.read<uint32_t>();
+            auto format = static_cast<rs2_format>(payload.read<uint32_t>());
+            auto fps = payload.read<uint32_t>();
+            payload.read<uint32_t>(); //All the recorded streams are marked as default by the playback device
+
+            std::shared_ptr<stream_profile_interface> profile;
+            switch (kind)
+            {
+            case native_file_format::video_frame_kind:
+            {
+                auto width = payload.read<uint32_t>();
+                auto height = payload.read<uint32_t>();
+                auto intrinsics = payload.read<rs2_intrinsics>();
+                auto video = std::make_shared<video_stream_profile>(platform::stream_profile{ width, height, fps, static_cast<uint32_t>(format) });
+                video->set_intrinsics([intrinsics]() { return intrinsics; });
+                video->set_dims(width, height);
+                profile = video;
+                break;
+            }
+            case native_file_format::motion_frame_kind:
+            {
+                auto intrinsics = payload.read<rs2_motion_device_intrinsic>();
+                auto motion = std::make_shared<motion_stream_profile>(platform::stream_profile{ 0, 0, fps, static_cast<uint32_t>(format) });
+                motion->set_intrinsics([intrinsics]() { return intrinsics; });
+                profile = motion;
+                break;
+            }
+            case native_file_format::pose_frame_kind:
+                profile = std::make_shared<stream_profile_base>(platform::stream_profile{ 0, 0, fps, static_cast<uint32_t>(format) });
+                break;
+            default:
+                throw io_exception(to_string() << "Invalid file format, unknown stream kind " << kind);
+            }
+            profile->set_stream_index(entry.stream_index);
+            profile->set_stream_type(static_cast<rs2_stream>(entry.stream_type));
+            profile->set_format(format);
+            profile->set_framerate(fps);
+            return profile;
+        }
+
+        std::pair<rs2_option, std::shared_ptr<librealsense::option>> create_option(const native_file_format::index_entry& entry) const
+        {
+            auto payload = read_record(entry.offset);
+            auto id = static_cast<rs2_option>(payload.read<uint32_t>());
+            auto value = payload.read<float>();
+            auto description = payload.read_string();
+            return std::make_pair(id, std::make_shared<const_value_option>(description, value));
+        }
+
+        notification create_notification(const native_file_format::index_entry& entry) const
+        {
+            auto payload = read_record(entry.offset);
+            auto category = static_cast<rs2_notification_category>(payload.read<uint32_t>());
+            auto severity = static_cast<rs2_log_severity>(payload.read<uint32_t>());
+            auto type = payload.read<int32_t>();
+            auto timestamp = payload.read<double>();
+            notification n(category, type, severity, payload.read_string());
+            n.timestamp = timestamp;
+            n.serialized_data = payload.read_string();
+            return n;
+        }
+
+        //Options keep the last value recorded up to the requested time
+        void update_sensor_options(uint32_t sensor_index, const nanoseconds& time, snapshot_collection& sensor_extensions) const
+        {
+            std::map<rs2_option, std::shared_ptr<librealsense::option>> values;
+            for (size_t i = 0; i < entries_count() && entries()[i].time <= static_cast<uint64_t>(time.count()); ++i)
+            {
+                auto& entry = entries()[i];
+                if (entry.type == native_file_format::option_record && entry.sensor_index == sensor_index)
+                {
+                    auto option = create_option(entry);
+                    values[option.first] = option.second;
+                }
+            }
+
+            auto sensor_options = std::make_shared<options_container>();
+            for (auto&& value : values)
+                sensor_options->register_option(value.first, value.second);
+            sensor_extensions[RS2_EXTENSION_OPTIONS] = sensor_options;
+
+            if (sensor_options->supports_option(RS2_OPTION_DEPTH_UNITS))
+            {
+                auto&& dpt_opt = sensor_options->get_option(RS2_OPTION_DEPTH_UNITS);
+                sensor_extensions[RS2_EXTENSION_DEPTH_SENSOR] = std::make_shared<depth_sensor_snapshot>(dpt_opt.query());
+
+                if (sensor_options->supports_option(RS2_OPTION_STEREO_BASELINE))
+                {
+                    auto&& bl_opt = sensor_options->get_option(RS2_OPTION_STEREO_BASELINE);
+                    sensor_extensions[RS2_EXTENSION_DEPTH_STEREO_SENSOR] = std::make_shared<depth_stereo_sensor_snapshot>(dpt_opt.query(), bl_opt.query());
+                }
+            }
+        }
+
+        //Looks the frame up in the metadata of its chunk, the last block read of every stream is kept
+        void read_frame_metadata(const native_file_format::index_entry& entry, frame_additional_data& additional_data) const
+        {
+            if (entry.metadata == 0)
+                return;
+
+            auto& cached = m_metadata_blocks[native_file_format::get_stream_identifier(entry)];
+            if (!cached.second || cached.first != entry.metadata)
+            {
+                auto payload = read_record(entry.metadata);
+                auto size = payload.remaining();
+                auto data = payload.read_bytes(size);
+                cached.first = entry.metadata;
+                cached.second = std::make_shared<metadata_block>(metadata_block::deserialize(std::vector<uint8_t>(data, data + size)));
+            }
+            cached.second->find(entry.time, additional_data);
+        }
+
+        void decode_image(native_file_format::frame_codec codec, const native_file_format::frame_header& header, const uint8_t* data, size_t size, uint8_t* out) const
+        {
+            bool decoded = false;
+            switch (codec)
+            {
+            case native_file_format::raw_codec:
+                decoded = size == header.raw_size;
+                if (decoded)
+                    memcpy(out, data, size);
+                break;
+            case native_file_format::lz4_codec:
+                decoded = LZ4_decompress_safe(reinterpret_cast<const char*>(data), reinterpret_cast<char*>(out),
+                    static_cast<int>(size), static_cast<int>(header.raw_size)) == static_cast<int>(header.raw_size);
+                break;
+            case native_file_format::rvl_codec:
+                decoded = rvl_decode(data, size, reinterpret_cast<uint16_t*>(out), size_t(header.width) * header.height);
+                break;
+            case native_file_format::jpeg_codec:
+#ifdef RS2_USE_LIBJPEG
+                decoded = jpeg_decode(data, size, out, header.width, header.height, header.format == RS2_FORMAT_Y8 ? 1 : 3);
+                break;
+#else
+                throw io_exception("The recording holds JPEG frames, librealsense was built without BUILD_WITH_LIBJPEG");
+#endif
+            default:
+                throw io_exception(to_string() << "Invalid file format, unknown frame codec " << codec);
+            }
+            if (!decoded)
+                throw io_exception(to_string() << "Failed to decode frame " << header.frame_number);
+        }
+
+        std::shared_ptr<serialized_frame> create_frame(const native_file_format::index_entry& entry) const
+        {
+            auto stream_id = native_file_format::get_stream_identifier(entry);
+            nanoseconds timestamp(entry.time);
+
+            auto payload = read_record(entry.offset);
+            auto header = payload.read<native_file_format::frame_header>();
+            auto size = payload.remaining();
+            auto data = payload.read_bytes(size);
+            auto codec = static_cast<native_file_format::frame_codec>(header.codec);
+
+            frame_additional_data additional_data{};
+            additional_data.timestamp = header.timestamp;
+            additional_data.frame_number = header.frame_number;
+            additional_data.fisheye_ae_mode = false;
+            read_frame_metadata(entry, additional_data);
+
+            rs2_extension type;
+            std::shared_ptr<stream_profile_interface> profile;
+            switch (header.kind)
+            {
+            case native_file_format::video_frame_kind:
+                type = stream_id.stream_type == RS2_STREAM_DEPTH ? RS2_EXTENSION_DEPTH_FRAME : RS2_EXTENSION_VIDEO_FRAME;
+                profile = std::make_shared<video_stream_profile>(platform::stream_profile{});
+                break;
+            case native_file_format::motion_frame_kind:
+                type = RS2_EXTENSION_MOTION_FRAME;
+                profile = std::make_shared<motion_stream_profile>(platform::stream_profile{});
+                break;
+            case native_file_format::pose_frame_kind:
+                type = RS2_EXTENSION_POSE_FRAME;
+                profile = std::make_shared<stream_profile_base>(platform::stream_profile{});
+                break;
+            default:
+                throw io_exception(to_string() << "Invalid file format, unknown frame kind " << header.kind);
+            }
+
+            //Images stored as they are reference the mapped file instead of being copied out of it
+            auto in_place = header.kind == native_file_format::video_frame_kind && codec == native_file_format::raw_codec && size == header.raw_size;
+            frame_interface* frame = m_frame_source->alloc_frame(type, in_place ? 0 : header.raw_size, additional_data, true);
+            if (frame == nullptr)
+            {
+                LOG_WARNING("Failed to allocate new frame");
+                return std::make_shared<serialized_invalid_frame>(timestamp, stream_id);
+            }
+            frame_holder fh{ frame };
+            if (header.kind == native_file_format::video_frame_kind)
+                static_cast<librealsense::video_frame*>(frame)->assign(header.width, header.height, header.stride, header.bpp);
+
+            //attaching a temp stream to the frame. Playback sensor should assign the real stream
+            frame->set_stream(profile);
+            frame->get_stream()->set_format(static_cast<rs2_format>(header.format));
+            frame->get_stream()->set_stream_index(stream_id.stream_index);
+            frame->get_stream()->set_stream_type(stream_id.stream_type);
+
+            if (in_place)
+            {
+                auto mapping = m_mapping;
+                frame->attach_continuation(frame_continuation([mapping]() {}, data));
+            }
+            else
+            {
+                decode_image(codec, header, data, size, const_cast<uint8_t*>(frame->get_frame_data()));
+            }
+            LOG_DEBUG("Created frame: " << stream_id << " " << header.frame_number);
+
+            return std::make_shared<serialized_frame>(timestamp, stream_id, std::move(fh));
+        }
+
+        device_snapshot                         m_initial_device_description;
+        std::string                             m_file_path;
+        std::shared_ptr<mapped_file>            m_mapping;
+        const native_file_format::index_entry*  m_index;            //Index of a closed file, in the mapping
+        size_t                                  m_index_size;
+        std::vector<native_file_format::index_entry> m_scanned;     //Index of a file that has none, built from its chunks
+        uint64_t                                m_scan_offset;
+        uint64_t                                m_first_frame_time;
+        uint64_t                                m_last_frame_time;
+        size_t                                  m_cursor;
+        bool                                    m_streaming;
+        std::set<stream_identifier>             m_enabled_streams;
+        std::shared_ptr<frame_source>           m_frame_source;
+        mutable std::map<stream_identifier, std::pair<uint64_t, std::shared_ptr<metadata_block>>> m_metadata_blocks; //Last block read of each stream
+        std::shared_ptr<metadata_parser_map>    m_metadata_parser_map;
+        std::shared_ptr<context>                m_context;
+    };
+}
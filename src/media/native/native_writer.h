@@ -0,0 +1,497 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <set>
+#include <string>
+#include <lz4.h>
+#include "core/debug.h"
+#include "core/serialization.h"
+#include "archive.h"
+#include "image.h"
+#include "stream.h"
+#include "types.h"
+#include "native_file_format.h"
+#include "proc/rvl-codec.h"
+#ifdef RS2_USE_LIBJPEG
+#include "proc/jpeg-codec.h"
+#endif
+
+namespace librealsense
+{
+    using namespace device_serializer;
+
+    class native_writer : public writer
+    {
+    public:
+        native_writer(const std::string& file, bool compress_while_record) :
+            m_file_path(file),
+            m_compress_all(compress_while_record),
+            m_chunk_size(DEFAULT_CHUNK_SIZE),
+            m_offset(0)
+        {
+            LOG_INFO("Compression while record is set to " << (compress_while_record ? "ON" : "OFF"));
+            m_file.open(file, std::ios::binary | std::ios::trunc);
+            if (!m_file)
+                throw io_exception(to_string() << "Failed to create recording file " << file);
+
+            native_file_format::file_header header{ native_file_format::FILE_MAGIC, native_file_format::get_file_version() };
+            write_to_file(&header, sizeof(header));
+        }
+
+        ~native_writer()
+        {
+            try
+            {
+                flush_chunk();
+                write_index();
+            }
+            catch (const std::exception& e)
+            {
+                LOG_ERROR("Failed to write the index of " << m_file_path << ". Exception: " << e.what());
+            }
+        }
+
+        void write_device_description(const librealsense::device_snapshot& device_description) override
+        {
+            for (auto&& device_extension_snapshot : device_description.get_device_extensions_snapshots().get_snapshots())
+            {
+                write_extension_snapshot(native_file_format::NO_SENSOR, get_static_file_info_timestamp(), device_extension_snapshot.first, device_extension_snapshot.second);
+            }
+
+            for (auto&& sensors_snapshot : device_description.get_sensors_snapshots())
+            {
+                for (auto&& sensor_extension_snapshot : sensors_snapshot.get_sensor_extensions_snapshots().get_snapshots())
+                {
+                    write_extension_snapshot(sensors_snapshot.get_sensor_index(), get_static_file_info_timestamp(), sensor_extension_snapshot.first, sensor_extension_snapshot.second);
+                }
+            }
+        }
+
+        void write_frame(const stream_identifier& stream_id, const nanoseconds& timestamp, frame_holder&& frame) override
+        {
+            if (Is<video_frame>(frame.frame))
+            {
+                auto vid_frame = dynamic_cast<librealsense::video_frame*>(frame.frame);
+                auto size = static_cast<size_t>(vid_frame->get_stride()) * vid_frame->get_height();
+                write_frame_record(stream_id, timestamp, frame.frame, native_file_format::video_frame_kind, vid_frame->get_width(), vid_frame->get_height(),
+                    vid_frame->get_stride(), vid_frame->get_bpp(), vid_frame->get_frame_data(), size);
+                return;
+            }
+
+            if (Is<motion_frame>(frame.frame))
+            {
+                write_frame_record(stream_id, timestamp, frame.frame, native_file_format::motion_frame_kind, 0, 0, 0, 0,
+                    frame.frame->get_frame_data(), 3 * sizeof(float));
+                return;
+            }
+
+            if (Is<pose_frame>(frame.frame))
+            {
+                write_frame_record(stream_id, timestamp, frame.frame, native_file_format::pose_frame_kind, 0, 0, 0, 0,
+                    frame.frame->get_frame_data(), sizeof(pose_frame::pose_info));
+                return;
+            }
+        }
+
+        void write_snapshot(uint32_t device_index, const nanoseconds& timestamp, rs2_extension type, const std::shared_ptr<extension_snapshot>& snapshot) override
+        {
+            write_extension_snapshot(native_file_format::NO_SENSOR, timestamp, type, snapshot);
+        }
+
+        void write_snapshot(const sensor_identifier& sensor_id, const nanoseconds& timestamp, rs2_extension type, const std::shared_ptr<extension_snapshot>& snapshot) override
+        {
+            write_extension_snapshot(sensor_id.sensor_index, timestamp, type, snapshot);
+        }
+
+        void write_notification(const sensor_identifier& sensor_id, const nanoseconds& timestamp, const notification& n) override
+        {
+            auto record = begin_record(native_file_format::notification_record, sensor_id.sensor_index, 0, 0, timestamp);
+            native_file_format::payload_writer payload(m_chunk);
+            payload.write(static_cast<uint32_t>(n.category));
+            payload.write(static_cast<uint32_t>(n.severity));
+            payload.write(static_cast<int32_t>(n.type));
+            payload.write(n.timestamp);
+            payload.write_string(n.description);
+            payload.write_string(n.serialized_data);
+            end_record(record);
+        }
+
+        const std::string& get_file_name() const override
+        {
+            return m_file_path;
+        }
+
+        void set_chunk_size(uint32_t bytes) override
+        {
+            //Records are buffered in the open chunk and written to the file once it reaches this size
+            m_chunk_size = bytes;
+        }
+
+        void set_columnar_metadata(bool enable) override
+        {
+            //The metadata of every chunk is always stored by column
+        }
+
+        void set_stream_compression(rs2_stream stream, uint32_t index, bool enable) override
+        {
+            //Takes effect from the next frame of the stream, frames of one stream may be stored both ways
+            if (enable)
+                m_compressed_streams.insert({ stream, index });
+            else
+                m_compressed_streams.erase({ stream, index });
+        }
+
+        std::shared_ptr<writer> create_segment(const std::string& file) const override
+        {
+            return std::make_shared<native_writer>(file, m_compress_all);
+        }
+
+    private:
+        static const uint32_t DEFAULT_CHUNK_SIZE = 1 << 20;
+        static const int JPEG_QUALITY = 95;
+
+        void write_to_file(const void* data, size_t size)
+        {
+            m_file.write(static_cast<const char*>(data), size);
+            if (!m_file)
+                throw io_exception(to_string() << "Failed to write to " << m_file_path);
+            m_offset += size;
+        }
+
+        // Starts a record in the open chunk, its payload is appended to m_chunk until end_record
+        size_t begin_record(uint32_t type, uint32_t sensor_index, uint32_t stream_type, uint32_t stream_index, const nanoseconds& time)
+        {
+            native_file_format::record_header header{ type, sensor_index, stream_type, stream_index, time.count(), 0, 0 };
+            auto position = m_chunk.size();
+            m_chunk_entries.push_back({ m_offset + sizeof(native_file_format::chunk_header) + position, header.time, 0,
+                type, sensor_index, stream_type, stream_index });
+            native_file_format::payload_writer(m_chunk).write(header);
+            return position;
+        }
+
+        void end_record(size_t position)
+        {
+            auto size = static_cast<uint32_t>(m_chunk.size() - position - sizeof(native_file_format::record_header));
+            memcpy(m_chunk.data() + position + offsetof(native_file_format::record_header, size), &size, sizeof(size));
+            if (m_chunk.size() >= m_chunk_size)
+                flush_chunk();
+        }
+
+        void flush_chunk()
+        {
+            if (m_chunk_entries.empty())
+                return;
+
+            //The metadata of the chunk's frames closes the chunk, one record per stream
+            for (auto&& block : m_chunk_metadata)
+            {
+                auto& id = block.first;
+                auto record = begin_record(native_file_format::metadata_record, id.sensor_index, id.stream_type, id.stream_index, get_static_file_info_timestamp());
+                auto offset = m_chunk_entries.back().offset;
+                auto data = block.second.serialize();
+                native_file_format::payload_writer(m_chunk).write_bytes(data.data(), data.size());
+                auto size = static_cast<uint32_t>(m_chunk.size() - record - sizeof(native_file_format::record_header));
+                memcpy(m_chunk.data() + record + offsetof(native_file_format::record_header, size), &size, sizeof(size));
+
+                for (auto&& entry : m_chunk_entries)
+                {
+                    if (entry.type == native_file_format::frame_record && id == native_file_format::get_stream_identifier(entry))
+                        entry.metadata = offset;
+                }
+            }
+            m_chunk_metadata.clear();
+
+            native_file_format::chunk_header header{ native_file_format::CHUNK_MAGIC, static_cast<uint32_t>(m_chunk_entries.size()), m_chunk.size() };
+            write_to_file(&header, sizeof(header));
+            write_to_file(m_chunk.data(), m_chunk.size());
+            //Readers of the file while it is recorded see whole chunks only
+            m_file.flush();
+
+            m_index.insert(m_index.end(), m_chunk_entries.begin(), m_chunk_entries.end());
+            m_chunk_entries.clear();
+            m_chunk.clear();
+        }
+
+        void write_index()
+        {
+            //The entries are aligned for readers to use them in place
+            static const uint8_t padding[sizeof(uint64_t)] = {};
+            write_to_file(padding, (sizeof(uint64_t) - m_offset % sizeof(uint64_t)) % sizeof(uint64_t));
+
+            std::stable_sort(m_index.begin(), m_index.end(), [](const native_file_format::index_entry& a, const native_file_format::index_entry& b)
+            {
+                return a.time < b.time;
+            });
+            native_file_format::file_footer footer{ m_offset, m_index.size(), native_file_format::FOOTER_MAGIC, native_file_format::get_file_version() };
+            write_to_file(m_index.data(), m_index.size() * sizeof(native_file_format::index_entry));
+            write_to_file(&footer, sizeof(footer));
+            m_file.flush();
+        }
+
+        native_file_format::frame_codec select_codec(const stream_identifier& stream_id, rs2_format format, uint32_t width, uint32_t stride) const
+        {
+            //Compressed formats are stored as they are
+            if (is_compressed_format(format))
+                return native_file_format::raw_codec;
+
+            auto compressed = m_compressed_streams.count({ stream_id.stream_type, stream_id.stream_index }) > 0;
+            if (compressed && format == RS2_FORMAT_Z16 && stride == width * sizeof(uint16_t))
+                return native_file_format::rvl_codec;
+#ifdef RS2_USE_LIBJPEG
+            //Lossy, only for the streams compression was requested for
+            if (compressed && ((format == RS2_FORMAT_RGB8 && stride == width * 3) || (format == RS2_FORMAT_Y8 && stride == width)))
+                return native_file_format::jpeg_codec;
+#endif
+            return (compressed || m_compress_all) ? native_file_format::lz4_codec : native_file_format::raw_codec;
+        }
+
+        const uint8_t* encode(native_file_format::frame_codec& codec, rs2_format format, uint32_t width, uint32_t height, const uint8_t* data, size_t& size)
+        {
+            switch (codec)
+            {
+            case native_file_format::rvl_codec:
+                rvl_encode(reinterpret_cast<const uint16_t*>(data), size_t(width) * height, m_encoded);
+                break;
+#ifdef RS2_USE_LIBJPEG
+            case native_file_format::jpeg_codec:
+                jpeg_encode(data, width, height, format == RS2_FORMAT_Y8 ? 1 : 3, JPEG_QUALITY, m_encoded);
+                break;
+#endif
+            case native_file_format::lz4_codec:
+            {
+                m_encoded.resize(LZ4_compressBound(static_cast<int>(size)));
+                auto compressed = LZ4_compress_default(reinterpret_cast<const char*>(data), reinterpret_cast<char*>(m_encoded.data()),
+                    static_cast<int>(size), static_cast<int>(m_encoded.size()));
+                //Images that do not compress are stored as they are
+                if (compressed <= 0 || static_cast<size_t>(compressed) >= size)
+                {
+                    codec = native_file_format::raw_codec;
+                    return data;
+                }
+                m_encoded.resize(compressed);
+                break;
+            }
+            default:
+                return data;
+            }
+            size = m_encoded.size();
+            return m_encoded.data();
+        }
+
+        void write_frame_record(const stream_identifier& stream_id, const nanoseconds& timestamp, frame_interface* frame, native_file_format::frame_kind kind,
+            int width, int height, int stride, int bpp, const uint8_t* data, size_t size)
+        {
+            auto format = frame->get_stream()->get_format();
+            auto codec = (kind == native_file_format::video_frame_kind) ? select_codec(stream_id, format, width, stride) : native_file_format::raw_codec;
+            auto raw_size = size;
+            data = encode(codec, format, width, height, data, size);
+
+            auto& metadata = m_chunk_metadata[stream_id];
+            if (metadata.size() > 0 && static_cast<uint64_t>(timestamp.count()) < metadata.last_time())
+                flush_chunk(); //Metadata blocks hold frames in ascending time order
+            add_to_metadata_block(stream_id, timestamp, frame);
+
+            write_extrinsics(stream_id, frame);
+
+            auto record = begin_record(native_file_format::frame_record, stream_id.sensor_index, stream_id.stream_type, stream_id.stream_index, timestamp);
+            native_file_format::frame_header header{ kind, codec, static_cast<uint32_t>(format), static_cast<uint32_t>(width), static_cast<uint32_t>(height),
+                static_cast<uint32_t>(stride), static_cast<uint32_t>(bpp), static_cast<uint32_t>(raw_size),
+                static_cast<uint64_t>(frame->get_frame_number()), frame->get_frame_timestamp() };
+            native_file_format::payload_writer payload(m_chunk);
+            payload.write(header);
+            payload.write_bytes(data, size);
+            end_record(record);
+        }
+
+        void add_to_metadata_block(const stream_identifier& stream_id, const nanoseconds& timestamp, frame_interface* frame)
+        {
+            std::vector<std::pair<rs2_frame_metadata_value, rs2_metadata_type>> values;
+            for (int i = 0; i < static_cast<int>(RS2_FRAME_METADATA_COUNT); i++)
+            {
+                rs2_frame_metadata_value type = static_cast<rs2_frame_metadata_value>(i);
+                if (frame->supports_frame_metadata(type))
+                {
+                    values.emplace_back(type, frame->get_frame_metadata(type));
+                }
+            }
+            m_chunk_metadata[stream_id].add(timestamp.count(), frame->get_frame_system_time(), frame->get_frame_timestamp_domain(), values);
+        }
+
+        void write_extrinsics(const stream_identifier& stream_id, frame_interface* frame)
+        {
+            if (m_written_extrinsics.count(stream_id))
+            {
+                return; //already wrote it
+            }
+            m_written_extrinsics.insert(stream_id);
+            try
+            {
+                auto& dev = frame->get_sensor()->get_device();
+                uint32_t reference_id = 0;
+                rs2_extrinsics ext;
+                std::tie(reference_id, ext) = dev.get_extrinsics(*frame->get_stream());
+
+                auto record = begin_record(native_file_format::extrinsics_record, stream_id.sensor_index, stream_id.stream_type, stream_id.stream_index, get_static_file_info_timestamp());
+                native_file_format::payload_writer payload(m_chunk);
+                payload.write(reference_id);
+                payload.write(ext);
+                end_record(record);
+            }
+            catch (std::exception const& e)
+            {
+                LOG_WARNING("Failed to write stream extrinsics for " << stream_id << ". Exception: " << e.what());
+            }
+        }
+
+        template <rs2_extension E>
+        std::shared_ptr<typename ExtensionToType<E>::type> SnapshotAs(std::shared_ptr<librealsense::extension_snapshot> snapshot)
+        {
+            auto as_type = As<typename ExtensionToType<E>::type>(snapshot);
+            if (as_type == nullptr)
+            {
+                throw invalid_value_exception(to_string() << "Failed to cast snapshot to \"" << E << "\" (as \"" << ExtensionToType<E>::to_string() << "\")");
+            }
+            return as_type;
+        }
+
+        void write_extension_snapshot(uint32_t sensor_index, const nanoseconds& timestamp, rs2_extension type, std::shared_ptr<librealsense::extension_snapshot> snapshot)
+        {
+            switch (type)
+            {
+            case RS2_EXTENSION_INFO:
+                write_info(sensor_index, timestamp, SnapshotAs<RS2_EXTENSION_INFO>(snapshot));
+                break;
+            case RS2_EXTENSION_DEBUG:
+                break;
+            case RS2_EXTENSION_OPTIONS:
+                write_options(sensor_index, timestamp, SnapshotAs<RS2_EXTENSION_OPTIONS>(snapshot));
+                break;
+            case RS2_EXTENSION_VIDEO:
+            case RS2_EXTENSION_ROI:
+            case RS2_EXTENSION_DEPTH_SENSOR:
+            case RS2_EXTENSION_DEPTH_STEREO_SENSOR:
+                break;
+            case RS2_EXTENSION_VIDEO_PROFILE:
+            {
+                auto profile = SnapshotAs<RS2_EXTENSION_VIDEO_PROFILE>(snapshot);
+                rs2_intrinsics intrinsics{};
+                try
+                {
+                    intrinsics = profile->get_intrinsics();
+                }
+                catch (...)
+                {
+                    LOG_ERROR("Error trying to get intrinsc data for stream " << profile->get_stream_type() << ", " << profile->get_stream_index());
+                }
+                auto record = begin_stream_profile(sensor_index, timestamp, native_file_format::video_frame_kind, profile);
+                native_file_format::payload_writer payload(m_chunk);
+                payload.write(static_cast<uint32_t>(profile->get_width()));
+                payload.write(static_cast<uint32_t>(profile->get_height()));
+                payload.write(intrinsics);
+                end_record(record);
+                break;
+            }
+            case RS2_EXTENSION_MOTION_PROFILE:
+            {
+                auto profile = SnapshotAs<RS2_EXTENSION_MOTION_PROFILE>(snapshot);
+                rs2_motion_device_intrinsic intrinsics{};
+                try
+                {
+                    intrinsics = profile->get_intrinsics();
+                }
+                catch (...)
+                {
+                    LOG_ERROR("Error trying to get intrinsc data for stream " << profile->get_stream_type() << ", " << profile->get_stream_index());
+                }
+                auto record = begin_stream_profile(sensor_index, timestamp, native_file_format::motion_frame_kind, profile);
+                native_file_format::payload_writer(m_chunk).write(intrinsics);
+                end_record(record);
+                break;
+            }
+            case RS2_EXTENSION_POSE_PROFILE:
+            {
+                auto profile = SnapshotAs<RS2_EXTENSION_POSE_PROFILE>(snapshot);
+                end_record(begin_stream_profile(sensor_index, timestamp, native_file_format::pose_frame_kind, profile));
+                break;
+            }
+            default:
+                throw invalid_value_exception(to_string() << "Failed to Write Extension Snapshot: Unsupported extension \"" << librealsense::get_string(type) << "\"");
+            }
+        }
+
+        size_t begin_stream_profile(uint32_t sensor_index, const nanoseconds& timestamp, native_file_format::frame_kind kind, std::shared_ptr<stream_profile_interface> profile)
+        {
+            auto record = begin_record(native_file_format::stream_profile_record, sensor_index, profile->get_stream_type(), profile->get_stream_index(), timestamp);
+            native_file_format::payload_writer payload(m_chunk);
+            payload.write(static_cast<uint32_t>(kind));
+            payload.write(static_cast<uint32_t>(profile->get_format()));
+            payload.write(static_cast<uint32_t>(profile->get_framerate()));
+            payload.write(static_cast<uint32_t>(profile->get_tag() & profile_tag::PROFILE_TAG_DEFAULT));
+            return record;
+        }
+
+        void write_info(uint32_t sensor_index, const nanoseconds& timestamp, std::shared_ptr<info_interface> info_snapshot)
+        {
+            auto type = sensor_index == native_file_format::NO_SENSOR ? native_file_format::device_info_record : native_file_format::sensor_info_record;
+            auto record = begin_record(type, sensor_index, 0, 0, timestamp);
+            native_file_format::payload_writer payload(m_chunk);
+            for (uint32_t i = 0; i < static_cast<uint32_t>(RS2_CAMERA_INFO_COUNT); i++)
+            {
+                auto camera_info = static_cast<rs2_camera_info>(i);
+                if (info_snapshot->supports_info(camera_info))
+                {
+                    payload.write(i);
+                    payload.write_string(info_snapshot->get_info(camera_info));
+                }
+            }
+            end_record(record);
+        }
+
+        void write_options(uint32_t sensor_index, const nanoseconds& timestamp, std::shared_ptr<options_interface> options)
+        {
+            for (int i = 0; i < static_cast<int>(RS2_OPTION_COUNT); i++)
+            {
+                auto option_id = static_cast<rs2_option>(i);
+                try
+                {
+                    if (options->supports_option(option_id))
+                    {
+                        auto& option = options->get_option(option_id);
+                        auto value = option.query();
+                        const char* str = option.get_description();
+                        std::string description = str ? std::string(str) : (to_string() << "Read only option of " << librealsense::get_string(option_id));
+
+                        auto record = begin_record(native_file_format::option_record, sensor_index, 0, 0, timestamp);
+                        native_file_format::payload_writer payload(m_chunk);
+                        payload.write(static_cast<uint32_t>(option_id));
+                        payload.write(value);
+                        payload.write_string(description);
+                        end_record(record);
+                    }
+                }
+                catch (std::exception& e)
+                {
+                    LOG_WARNING("Failed to get or write option " << option_id << " for sensor " << sensor_index << ". Exception: " << e.what());
+                }
+            }
+        }
+
+        std::string m_file_path;
+        std::ofstream m_file;
+        bool m_compress_all;
+        uint32_t m_chunk_size;
+        uint64_t m_offset;                                              //Bytes written to the file
+        std::vector<uint8_t> m_chunk;                                   //Records of the open chunk
+        std::vector<native_file_format::index_entry> m_chunk_entries;   //Index entries of the open chunk
+        std::map<stream_identifier, metadata_block> m_chunk_metadata;   //Metadata of the open chunk's frames, per stream
+        std::vector<native_file_format::index_entry> m_index;
+        std::vector<uint8_t> m_encoded;
+        std::set<std::pair<rs2_stream, uint32_t>> m_compressed_streams;
+        std::set<stream_identifier> m_written_extrinsics;
+    };
+}
@@ -0,0 +1,112 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#include "playback_clock.h"
+#include "concurrency.h"
+#include "types.h"
+
+using namespace librealsense;
+using namespace device_serializer;
+
+playback_clock::playback_clock()
+    : _base_timestamp(0), _stepping(false), _position(0)
+{
+}
+
+void playback_clock::start(nanoseconds timestamp)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    //As long as the base timestamp is 0, update it to object's timestamp.
+    //Once a streaming object arrive, the base will change from 0
+    if (_base_timestamp.count() == 0)
+    {
+        _base_sys_time = std::chrono::steady_clock::now();
+        _base_timestamp = timestamp;
+    }
+}
+
+void playback_clock::rebase(nanoseconds timestamp)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _base_sys_time = std::chrono::steady_clock::now();
+    _base_timestamp = timestamp;
+    LOG_DEBUG("Updating Time Base... base sys time " << _base_sys_time.time_since_epoch().count() << " base timestamp " << _base_timestamp.count());
+}
+
+void playback_clock::reset()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _base_timestamp = std::chrono::microseconds(0);
+}
+
+std::chrono::steady_clock::time_point playback_clock::deadline(nanoseconds timestamp, double rate)
+{
+    //The deadline is the system time of the time base plus the recording time since it, the frames are
+    // paced against it rather than against each other so delays don't accumulate
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (rate <= 0 || _stepping)
+        return std::chrono::steady_clock::now();
+
+    //Sometimes the first stream skip the first frame on the ros reader
+    //and the second stream go back to the first frame so its timestamp is smaller then the base timestamp
+    //in this case we need to restart the base timestamp again
+    if (timestamp < _base_timestamp)
+    {
+        _base_sys_time = std::chrono::steady_clock::now();
+        _base_timestamp = timestamp;
+    }
+    auto time_diff = timestamp - _base_timestamp;
+    auto recorded_time = std::chrono::duration_cast<nanoseconds>(time_diff / rate);
+
+    LOG_DEBUG("Original Recording Delta: " << time_diff.count() << " == " << (time_diff.count() * 1e-6) << "ms");
+    LOG_DEBUG("Frame Time: " << timestamp.count() << "  , First Frame: " << _base_timestamp.count() << " ,  Diff: " << recorded_time.count() << " == " << (recorded_time.count() * 1e-6) << "ms");
+    return _base_sys_time + std::chrono::duration_cast<std::chrono::steady_clock::duration>(recorded_time);
+}
+
+void playback_clock::set_stepping(bool stepping, nanoseconds position)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stepping = stepping;
+        _position = position;
+        //Pacing starts over from the position once stepping ends
+        _base_timestamp = std::chrono::microseconds(0);
+    }
+    _cv.notify_all();
+}
+
+bool playback_clock::is_stepping() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _stepping;
+}
+
+void playback_clock::step(nanoseconds duration)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _position += duration;
+    }
+    _cv.notify_all();
+}
+
+void playback_clock::set_position(nanoseconds position)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _position = position;
+    }
+    _cv.notify_all();
+}
+
+bool playback_clock::wait_for(nanoseconds timestamp, std::chrono::milliseconds timeout)
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    auto readable = [&]() { return !_stepping || timestamp <= _position; };
+    if (readable())
+        return true;
+
+    //The read strands of the group wait here, the shared pool goes on with the other work meanwhile
+    thread_pool::blocking_region blocking;
+    return _cv.wait_for(lock, timeout, readable);
+}
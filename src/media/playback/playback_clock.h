@@ -0,0 +1,46 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <core/serialization.h>
+
+namespace librealsense
+{
+    /**
+    * The timeline a playback paces its frames on, mapping recording timestamps to system time. The devices of a
+    * playback group share one, so the recordings of a rig play on the same time base and don't drift apart.
+    * While stepping, data is only read up to the position stepped to, and the frames are delivered unpaced
+    */
+    class playback_clock
+    {
+    public:
+        playback_clock();
+
+        // Sets the time base on the first timestamp since the last reset, timestamps of 0 don't belong to streams
+        void start(device_serializer::nanoseconds timestamp);
+        // Maps the timestamp to now
+        void rebase(device_serializer::nanoseconds timestamp);
+        // The next timestamp sets the time base again
+        void reset();
+        // System time to deliver the frame of the timestamp at, now when stepping or with a rate of 0
+        std::chrono::steady_clock::time_point deadline(device_serializer::nanoseconds timestamp, double rate);
+
+        void set_stepping(bool stepping, device_serializer::nanoseconds position);
+        bool is_stepping() const;
+        void step(device_serializer::nanoseconds duration);
+        void set_position(device_serializer::nanoseconds position);
+        // Whether data of the timestamp may be read, waiting up to the timeout for a step to reach it
+        bool wait_for(device_serializer::nanoseconds timestamp, std::chrono::milliseconds timeout);
+
+    private:
+        mutable std::mutex _mutex;
+        std::condition_variable _cv;
+        std::chrono::steady_clock::time_point _base_sys_time; // !< System time when reading began (first frame was read)
+        device_serializer::nanoseconds _base_timestamp; // !< Timestamp of the first frame that has a real timestamp (different than 0)
+        bool _stepping;
+        device_serializer::nanoseconds _position; // !< Latest timestamp readable while stepping
+    };
+}
@@ -2,12 +2,17 @@
 // Copyright(c) 2017 Intel Corporation. All Rights Reserved.
 
 #include <cmath>
+#include <condition_variable>
+#include <deque>
+#include <thread>
 #include "playback_device.h"
 #include "core/motion.h"
+#include "device.h"
 #include "stream.h"
-#include "media/ros/ros_reader.h"
+#include "media/device-serializers.h"
 #include "environment.h"
 #include "sync.h"
+#include "thread-scheduling.h"
 
 using namespace librealsense;
 
@@ -16,9 +21,11 @@ playback_device::playback_device(std::shared_ptr<context> ctx, std::shared_ptr<d
     m_is_started(false),
     m_is_paused(false),
     m_sample_rate(1),
+    m_max_lateness(0),
     m_real_time(true),
     m_prev_timestamp(0),
     m_last_published_timestamp(0),
+    m_clock(std::make_shared<playback_clock>()),
     m_read_thread([]() {return std::make_shared<dispatcher>(std::numeric_limits<unsigned int>::max()); })
 {
     if (serializer == nullptr)
@@ -26,7 +33,9 @@ playback_device::playback_device(std::shared_ptr<context> ctx, std::shared_ptr<d
         throw invalid_value_exception("null serializer");
     }
 
-    m_reader = serializer;
+    //Frames are read and decoded ahead of the playback cursor, so dispatching is not held back by decompression
+    m_prefetch_reader = std::make_shared<prefetch_reader>(serializer);
+    m_reader = m_prefetch_reader;
     (*m_read_thread)->start();
 
     //Read header and build device from recorded device snapshot
@@ -194,8 +203,21 @@ bool playback_device::extend_to(rs2_extension extension_type, void** ext)
 
 std::shared_ptr<matcher> playback_device::create_matcher(const frame_holder& frame) const
 {
-    //TOOD: Use future implementation of matcher factory with the device's name (or other unique identifier)
-    LOG_WARNING("Playback device does not provide a matcher");
+    // The recorded frame numbers are the ones of the device, so the streams of a sensor that were matched on its
+    // frame counter are matched the same way, without the tolerance windows of the timestamps
+    if (frame.frame->supports_frame_metadata(RS2_FRAME_METADATA_FRAME_COUNTER))
+    {
+        std::vector<std::vector<stream_interface*>> sensors;
+        for (auto&& sensor : m_sensors)
+        {
+            std::vector<stream_interface*> profiles;
+            for (auto&& p : sensor.second->get_stream_profiles())
+                profiles.push_back(p.get());
+            sensors.push_back(profiles);
+        }
+        return matcher_factory::create_per_sensor_matcher(sensors);
+    }
+
     auto s = frame.frame->get_stream();
     return std::make_shared<identity_matcher>(s->get_unique_id(), s->get_stream_type());
 }
@@ -211,7 +233,7 @@ void playback_device::set_frame_rate(double rate)
     {
         LOG_INFO("Changing playback frame rate to: " << rate);
         m_sample_rate = rate;
-        update_time_base(m_prev_timestamp);
+        m_clock->rebase(m_prev_timestamp);
     });
 }
 
@@ -221,6 +243,7 @@ void playback_device::seek_to_time(std::chrono::nanoseconds time)
     (*m_read_thread)->invoke([this, time](dispatcher::cancellable_timer t)
     {
         LOG_INFO("Seek to time: " << time.count());
+        m_held_data.reset();
         m_reader->seek_to_time(time);
         m_device_description = m_reader->query_device_description(time);
         update_extensions(m_device_description);
@@ -241,7 +264,8 @@ void playback_device::seek_to_time(std::chrono::nanoseconds time)
                     }
                     //push frame to the sensor (see handle_frame definition for more details)
                     m_sensors.at(frame->stream_id.sensor_index)->handle_frame(std::move(frame->frame), m_real_time,
-                        []() { return device_serializer::nanoseconds(0); },
+                        []() { return std::chrono::steady_clock::now(); },
+                        device_serializer::nanoseconds(0),
                         []() { return false; },
                         [this, time]()
                         {
@@ -320,6 +344,7 @@ void playback_device::resume()
         auto total_duration = m_reader->query_duration();
         if (m_last_published_timestamp >= total_duration)
             m_last_published_timestamp = device_serializer::nanoseconds(0);
+        m_held_data.reset();
         m_reader->reset();
         m_reader->seek_to_time(m_last_published_timestamp);
         while (m_last_published_timestamp != device_serializer::nanoseconds(0) && !m_reader->read_next_data()->is<serialized_frame>());
@@ -348,6 +373,172 @@ bool playback_device::is_real_time() const
     return m_real_time;
 }
 
+void playback_device::set_prefetch_size(size_t frames)
+{
+    if (frames > prefetch_reader::MAX_CACHE_SIZE)
+        throw invalid_value_exception(to_string() << "Prefetch size " << frames << " is out of range [0, " << prefetch_reader::MAX_CACHE_SIZE << "]");
+
+    LOG_INFO("Set prefetch size to " << frames);
+    (*m_read_thread)->invoke([this, frames](dispatcher::cancellable_timer t)
+    {
+        m_prefetch_reader->set_cache_size(frames);
+    });
+    if ((*m_read_thread)->flush() == false)
+    {
+        LOG_ERROR("Error - timeout waiting for set_prefetch_size, possible deadlock detected");
+        assert(0); //Detect this immediately in debug
+    }
+}
+
+void playback_device::skip_late_frames(device_serializer::nanoseconds max_lateness)
+{
+    if (max_lateness.count() < 0)
+        throw invalid_value_exception(to_string() << "Maximal lateness " << max_lateness.count() << " must not be negative");
+
+    LOG_INFO("Set maximal lateness of played frames to " << max_lateness.count() * 1e-6 << " ms");
+    m_max_lateness = max_lateness.count();
+}
+
+void playback_device::process_ranges(const std::vector<std::shared_ptr<processing_block_interface>>& blocks, frame_callback_ptr on_frame)
+{
+    if (m_is_started)
+        throw wrong_api_call_sequence_exception("Recording ranges can only be processed while playback is stopped");
+    if (blocks.empty())
+        throw invalid_value_exception("At least one processing block is required to process recording ranges");
+
+    std::vector<device_serializer::stream_identifier> streams;
+    for (auto&& sensor : m_sensors)
+    {
+        auto recorded = sensor.second->get_recorded_streams();
+        streams.insert(streams.end(), recorded.begin(), recorded.end());
+    }
+
+    // Shared with the blocks' output callbacks, which may outlive this call
+    struct ranges_state
+    {
+        explicit ranges_state(size_t count) : outputs(count), done(count, false) {}
+
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::vector<std::deque<frame_holder>> outputs;
+        std::vector<bool> done;
+        bool aborted = false;
+        std::exception_ptr error;
+    };
+    auto state = std::make_shared<ranges_state>(blocks.size());
+
+    // Ranges that are not being delivered yet hold at most this many output frames,
+    // well below the frame pool sizes of the readers and of the blocks' sources
+    const size_t max_pending_frames = 8;
+
+    auto file = get_file_name();
+    auto count = blocks.size();
+    auto duration = get_duration();
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < count; ++i)
+    {
+        device_serializer::nanoseconds begin(duration / count * i);
+        device_serializer::nanoseconds end(duration / count * (i + 1));
+        auto last = (i + 1 == count);
+
+        blocks[i]->set_output_callback({ new internal_frame_callback<std::function<void(frame_interface*)>>([state, i, max_pending_frames](frame_interface* f)
+        {
+            frame_holder frame(f);
+            std::unique_lock<std::mutex> lock(state->mutex);
+            state->cv.wait(lock, [&]() { return state->aborted || state->outputs[i].size() < max_pending_frames; });
+            if (state->aborted)
+                return;
+            state->outputs[i].push_back(std::move(frame));
+            state->cv.notify_all();
+        }), [](rs2_frame_callback* p) { p->release(); } });
+
+        workers.emplace_back([this, state, i, begin, end, last, file, streams, &blocks]()
+        {
+            thread_scheduling::apply(RS2_THREAD_CATEGORY_PLAYBACK, "rs-playback");
+            try
+            {
+                // Every range is read by its own reader, as neither the file nor the reader's frame pool are shared between threads
+                auto reader = create_file_reader(file, m_context);
+                reader->enable_stream(streams);
+                reader->seek_to_time(begin);
+                while (true)
+                {
+                    {
+                        std::lock_guard<std::mutex> lock(state->mutex);
+                        if (state->aborted)
+                            break;
+                    }
+                    auto data = reader->read_next_data();
+                    if (data->is<serialized_end_of_file>() || (!last && data->get_timestamp() >= end))
+                        break;
+
+                    auto frame = data->as<serialized_frame>();
+                    if (frame == nullptr || frame->stream_id.sensor_index >= m_sensors.size())
+                        continue;
+                    m_sensors.at(frame->stream_id.sensor_index)->bind_frame(frame->frame.frame);
+                    blocks[i]->invoke(std::move(frame->frame));
+                }
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                if (!state->error)
+                    state->error = std::current_exception();
+                state->aborted = true;
+            }
+            std::lock_guard<std::mutex> lock(state->mutex);
+            state->done[i] = true;
+            state->cv.notify_all();
+        });
+    }
+
+    // Ranges are delivered one after the other on the calling thread, which keeps the recorded order of every stream
+    try
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            while (true)
+            {
+                frame_holder frame;
+                {
+                    std::unique_lock<std::mutex> lock(state->mutex);
+                    state->cv.wait(lock, [&]() { return state->aborted || !state->outputs[i].empty() || state->done[i]; });
+                    if (state->aborted || state->outputs[i].empty())
+                        break;
+                    frame = std::move(state->outputs[i].front());
+                    state->outputs[i].pop_front();
+                    state->cv.notify_all();
+                }
+                frame_interface* ptr = nullptr;
+                std::swap(frame.frame, ptr);
+                on_frame->on_frame((rs2_frame*)ptr);
+            }
+        }
+    }
+    catch (...)
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        if (!state->error)
+            state->error = std::current_exception();
+        state->aborted = true;
+        state->cv.notify_all();
+    }
+
+    for (auto&& worker : workers)
+        worker.join();
+
+    std::exception_ptr error;
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        state->aborted = true;
+        for (auto&& output : state->outputs)
+            output.clear();
+        error = state->error;
+    }
+    if (error)
+        std::rethrow_exception(error);
+}
+
 platform::backend_device_group playback_device::get_device_data() const
 {
     return platform::backend_device_group({ platform::playback_device_info{ m_reader->get_file_name() } });
@@ -363,11 +554,9 @@ bool playback_device::is_valid() const
     return true;
 }
 
-void playback_device::update_time_base(device_serializer::nanoseconds base_timestamp)
+std::chrono::steady_clock::time_point playback_device::calc_deadline(device_serializer::nanoseconds timestamp)
 {
-    m_base_sys_time = std::chrono::high_resolution_clock::now();
-    m_base_timestamp = base_timestamp;
-    LOG_DEBUG("Updating Time Base... m_base_sys_time " << m_base_sys_time.time_since_epoch().count() << " m_base_timestamp " << m_base_timestamp.count());
+    return m_clock->deadline(timestamp, m_sample_rate.load());
 }
 
 device_serializer::nanoseconds playback_device::calc_sleep_time(device_serializer::nanoseconds timestamp)
@@ -376,29 +565,12 @@ device_serializer::nanoseconds playback_device::calc_sleep_time(device_serialize
         return device_serializer::nanoseconds(0);
     //The time to sleep returned here equals to the difference between the file recording time
     // and the playback time.
-    auto now = std::chrono::high_resolution_clock::now();
-    auto play_time = now - m_base_sys_time;
-
-    //Sometimes the first stream skip the first frame on the ros reader
-    //and the second stream go back to the first frame so its timestamp is smaller then the base timestamp
-    //in this case we need to restart the m_base_timestamp again
-    if(timestamp < m_base_timestamp)
-    {
-        update_time_base(timestamp);
-    }
-    auto time_diff = timestamp - m_base_timestamp;
-    auto recorded_time = std::chrono::duration_cast<device_serializer::nanoseconds>(time_diff / m_sample_rate.load());
-
-    LOG_DEBUG("Time Now  : " << now.time_since_epoch().count() << " ,    Time When Started: " << m_base_sys_time.time_since_epoch().count() << " , Diff: " << play_time.count() << " == " << (play_time.count() * 1e-6) << "ms");
-    LOG_DEBUG("Original Recording Delta: " << time_diff.count() << " == " << (time_diff.count() * 1e-6) << "ms");
-    LOG_DEBUG("Frame Time: " << timestamp.count() << "  , First Frame: " << m_base_timestamp.count() << " ,  Diff: " << recorded_time.count() << " == " << (recorded_time.count() * 1e-6) << "ms");
-
-    if(recorded_time < play_time)
+    auto sleep_time = std::chrono::duration_cast<device_serializer::nanoseconds>(calc_deadline(timestamp) - std::chrono::steady_clock::now());
+    if (sleep_time.count() <= 0)
     {
         LOG_DEBUG("Recorded Time < Playing Time  (not sleeping)");
         return device_serializer::nanoseconds(0);
     }
-    auto sleep_time = (recorded_time - play_time);
     LOG_DEBUG("Sleep Time: " << sleep_time.count() << " == " << (sleep_time.count() * 1e-6) << " ms");
     return sleep_time;
 }
@@ -453,6 +625,7 @@ void playback_device::stop_internal()
     {
         //sensor.second->flush_pending_frames();
     }
+    m_held_data.reset();
     m_reader->reset();
     m_prev_timestamp = std::chrono::nanoseconds(0);
     catch_up();
@@ -539,7 +712,10 @@ void playback_device::try_looping()
 
         //Read next data from the serializer, on success: 'obj' will be a valid object that came from
         // sensor number 'sensor_index' with a timestamp equal to 'timestamp'
-        std::shared_ptr<serialized_data> data = m_reader->read_next_data();
+        std::shared_ptr<serialized_data> data;
+        std::swap(data, m_held_data);
+        if (!data)
+            data = m_reader->read_next_data();
         if (data->as<serialized_end_of_file>())
         {
             LOG_INFO("End of file reached");
@@ -547,19 +723,21 @@ void playback_device::try_looping()
         }
 
         auto timestamp = data->get_timestamp();
-        m_prev_timestamp = timestamp;
-        //Objects with timestamp of 0 are non streams.
-        if (m_base_timestamp.count() == 0)
+        //A stepping clock holds the data beyond its position, the loop lets the other calls in between the waits
+        if (!m_clock->wait_for(timestamp, std::chrono::milliseconds(10)))
         {
-            //As long as m_base_timestamp is 0, update it to object's timestamp.
-            //Once a streaming object arrive, the base will change from 0
-            update_time_base(timestamp);
+            m_held_data = data;
+            return true;
         }
+        m_prev_timestamp = timestamp;
+        //Objects with timestamp of 0 are non streams.
+        m_clock->start(timestamp);
 
         //Calculate the duration for the reader to sleep (i.e wait for next frame)
         if (m_real_time && prefetch_done())
         {
-            auto sleep_time = calc_sleep_time(timestamp);
+            //The reader wakes up a little early and leaves the exact wait to the sensor, which spins the last stretch
+            auto sleep_time = calc_sleep_time(timestamp) - std::chrono::milliseconds(2);
             if (sleep_time.count() > 0)
             {
                 if (m_sample_rate > 0)
@@ -587,8 +765,11 @@ void playback_device::try_looping()
                 return true;
             }
             //Dispatch frame to the relevant sensor (see handle_frame definition for more details)
+            //The clock is held by the frame, a group may replace it meanwhile
+            auto clock = m_clock;
             m_active_sensors.at(frame->stream_id.sensor_index)->handle_frame(std::move(frame->frame), m_real_time,
-                [this, timestamp]() { return calc_sleep_time(timestamp); },
+                [this, clock, timestamp]() { return clock->deadline(timestamp, m_sample_rate.load()); },
+                device_serializer::nanoseconds(m_max_lateness.load()),
                 [this]() { return m_is_paused == true; },
                 [this, timestamp]()
                 {
@@ -625,10 +806,25 @@ uint64_t playback_device::get_position() const
 }
 void playback_device::catch_up()
 {
-    m_base_timestamp = std::chrono::microseconds(0);
+    m_clock->reset();
     LOG_DEBUG("Catching up");
 }
 
+void playback_device::join_group(std::shared_ptr<playback_clock> clock, std::shared_ptr<thread_pool> readers)
+{
+    (*m_read_thread)->invoke([this, clock, readers](dispatcher::cancellable_timer t)
+    {
+        m_prefetch_reader->set_pool(readers);
+        m_clock = clock;
+        catch_up();
+    });
+    if ((*m_read_thread)->flush() == false)
+    {
+        LOG_ERROR("Error - timeout waiting for join_group, possible deadlock detected");
+        assert(0); //Detect this immediately in debug
+    }
+}
+
 void playback_device::register_device_info(const device_serializer::device_snapshot& device_description)
 {
     auto info_snapshot = device_description.get_device_extensions_snapshots().find(RS2_EXTENSION_INFO);
@@ -11,6 +11,9 @@
 #include "concurrency.h"
 #include "sensor.h"
 #include "playback_sensor.h"
+#include "prefetch_reader.h"
+#include "playback_clock.h"
+#include "core/processing.h"
 
 namespace librealsense
 {
@@ -40,6 +43,11 @@ namespace librealsense
         void stop();
         void set_real_time(bool real_time);
         bool is_real_time() const;
+        void set_prefetch_size(size_t frames);
+        void skip_late_frames(device_serializer::nanoseconds max_lateness);
+        void process_ranges(const std::vector<std::shared_ptr<processing_block_interface>>& blocks, frame_callback_ptr on_frame);
+        // Paces the playback on the clock and prefetches on the pool from now on, see playback_group
+        void join_group(std::shared_ptr<playback_clock> clock, std::shared_ptr<thread_pool> readers);
         const std::string& get_file_name() const;
         uint64_t get_position() const;
         signal<playback_device, rs2_playback_status> playback_status_changed;
@@ -58,7 +66,7 @@ namespace librealsense
         bool compress_while_record() const override { return true; }
 
     private:
-        void update_time_base(device_serializer::nanoseconds base_timestamp);
+        std::chrono::steady_clock::time_point calc_deadline(device_serializer::nanoseconds timestamp);
         device_serializer::nanoseconds calc_sleep_time(device_serializer::nanoseconds  timestamp);
         void start();
         void stop_internal();
@@ -76,14 +84,16 @@ namespace librealsense
     private:
         lazy<std::shared_ptr<dispatcher>> m_read_thread;
         std::shared_ptr<device_serializer::reader> m_reader;
+        std::shared_ptr<prefetch_reader> m_prefetch_reader;
         device_serializer::device_snapshot m_device_description;
         std::atomic_bool m_is_started;
         std::atomic_bool m_is_paused;
-        std::chrono::high_resolution_clock::time_point m_base_sys_time; // !< System time when reading began (first frame was read)
-        device_serializer::nanoseconds m_base_timestamp; // !< Timestamp of the first frame that has a real timestamp (different than 0)
+        std::shared_ptr<playback_clock> m_clock;
+        std::shared_ptr<device_serializer::serialized_data> m_held_data; // !< Read beyond the position of a stepping clock
         std::map<uint32_t, std::shared_ptr<playback_sensor>> m_sensors;
         std::map<uint32_t, std::shared_ptr<playback_sensor>> m_active_sensors;
         std::atomic<double> m_sample_rate;
+        std::atomic<int64_t> m_max_lateness; // !< Nanoseconds a frame may be late before it's skipped, 0 never skips
         std::atomic_bool m_real_time;
         device_serializer::nanoseconds m_prev_timestamp;
         std::shared_ptr<context> m_context;
@@ -0,0 +1,80 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#include "playback_group.h"
+#include <algorithm>
+
+using namespace librealsense;
+
+playback_group::playback_group(unsigned int reader_threads)
+    : _clock(std::make_shared<playback_clock>()),
+      _readers(std::make_shared<thread_pool>(reader_threads))
+{
+}
+
+void playback_group::add(std::shared_ptr<playback_device> device)
+{
+    if (!device)
+        throw invalid_value_exception("null playback device");
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (std::find(_devices.begin(), _devices.end(), device) != _devices.end())
+        throw invalid_value_exception(to_string() << "Playback of \"" << device->get_file_name() << "\" is already in the group");
+    device->join_group(_clock, _readers);
+    _devices.push_back(device);
+}
+
+std::vector<std::shared_ptr<playback_device>> playback_group::get_devices() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _devices;
+}
+
+void playback_group::pause()
+{
+    for (auto&& device : get_devices())
+        device->pause();
+}
+
+void playback_group::resume()
+{
+    for (auto&& device : get_devices())
+        device->resume();
+    //The first frame read by any of them sets the time base of all
+    _clock->reset();
+}
+
+void playback_group::seek(device_serializer::nanoseconds time)
+{
+    for (auto&& device : get_devices())
+        device->seek_to_time(time);
+    if (_clock->is_stepping())
+        _clock->set_position(time);
+    _clock->reset();
+}
+
+void playback_group::set_frame_rate(double rate)
+{
+    for (auto&& device : get_devices())
+        device->set_frame_rate(rate);
+}
+
+void playback_group::set_stepping(bool stepping)
+{
+    auto devices = get_devices();
+    device_serializer::nanoseconds position(0);
+    if (!devices.empty())
+    {
+        position = device_serializer::nanoseconds(devices.front()->get_position());
+        for (auto&& device : devices)
+            position = std::min(position, device_serializer::nanoseconds(device->get_position()));
+    }
+    _clock->set_stepping(stepping, position);
+}
+
+void playback_group::step(device_serializer::nanoseconds duration)
+{
+    if (!_clock->is_stepping())
+        throw wrong_api_call_sequence_exception("The playback group steps only once stepping is set");
+    _clock->step(duration);
+}
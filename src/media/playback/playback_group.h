@@ -0,0 +1,44 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "playback_device.h"
+
+namespace librealsense
+{
+    /**
+    * Plays the recordings of a rig together: its devices pace their frames on one clock, so they stay aligned on
+    * the recording time, and prefetch on one pool of reader threads rather than a thread each. The group pauses,
+    * resumes and seeks all of them, or steps them along the timeline for offline processing
+    */
+    class playback_group
+    {
+    public:
+        // 0 reader threads selects a default based on the number of hardware threads
+        explicit playback_group(unsigned int reader_threads);
+
+        // Best added before the devices start streaming
+        void add(std::shared_ptr<playback_device> device);
+
+        void pause();
+        void resume();
+        void seek(device_serializer::nanoseconds time);
+        void set_frame_rate(double rate);
+
+        // While stepping, the devices deliver the frames up to the position as fast as they are consumed and
+        // wait for the next step. Stepping starts at the position of the device furthest behind
+        void set_stepping(bool stepping);
+        void step(device_serializer::nanoseconds duration);
+
+    private:
+        std::vector<std::shared_ptr<playback_device>> get_devices() const;
+
+        mutable std::mutex _mutex;
+        std::shared_ptr<playback_clock> _clock;
+        std::shared_ptr<thread_pool> _readers;
+        std::vector<std::shared_ptr<playback_device>> _devices;
+    };
+}
@@ -185,6 +185,28 @@ void playback_sensor::flush_pending_frames()
     }
 }
 
+std::vector<device_serializer::stream_identifier> playback_sensor::get_recorded_streams() const
+{
+    std::vector<device_serializer::stream_identifier> streams;
+    for (auto&& profile : m_available_profiles)
+    {
+        streams.push_back({ get_device_index(), m_sensor_id, profile->get_stream_type(), static_cast<uint32_t>(profile->get_stream_index()) });
+    }
+    return streams;
+}
+
+//Replaces the temporary stream the reader attached to the frame with the recorded stream profile.
+//May be called from several threads at once (see playback_device::process_ranges)
+void playback_sensor::bind_frame(frame_interface* frame)
+{
+    frame->get_owner()->set_sensor(shared_from_this());
+    auto type = frame->get_stream()->get_stream_type();
+    auto index = static_cast<uint32_t>(frame->get_stream()->get_stream_index());
+    auto it = m_streams.find(std::make_pair(type, index));
+    frame->set_stream(it != m_streams.end() ? it->second : nullptr);
+    frame->set_sensor(shared_from_this());
+}
+
 void playback_sensor::register_sensor_streams(const stream_profiles& profiles)
 {
     for (auto profile : profiles)
@@ -9,6 +9,7 @@
 #include "archive.h"
 #include "concurrency.h"
 #include "sensor.h"
+#include "stream-statistics.h"
 #include "types.h"
 
 namespace librealsense
@@ -50,6 +51,8 @@ namespace librealsense
         void unregister_before_start_callback(int token) override;
         void raise_notification(const notification& n);
         bool streams_contains_one_frame_or_more();
+        std::vector<device_serializer::stream_identifier> get_recorded_streams() const;
+        void bind_frame(frame_interface* frame);
     private:
         void register_sensor_streams(const stream_profiles& vector);
         void register_sensor_infos(const device_serializer::sensor_snapshot& sensor_snapshot);
@@ -71,13 +74,15 @@ namespace librealsense
 
     public:
         //handle frame use 3 lambda functions that determines if and when a frame should be published.
-        //calc_sleep - calculates the duration that the sensor should wait before publishing the frame,
-        // the start point for this calculation is the last playback resume.
+        //calc_deadline - calculates the time at which the sensor should publish the frame,
+        // relative to the last playback resume. A frame published later than the deadline by more than
+        // max_lateness is skipped, unless max_lateness is 0.
         //is_paused - check if the playback was paused while waiting for the frame publish time.
         //update_last_pushed_frame - lets the playback device know that a specific frame was published,
         // the playback device will use this info to determine which frames should be played next in a pause/resume scenario.
         template <class T, class K, class P>
-        void handle_frame(frame_holder frame, bool is_real_time, T calc_sleep, K is_paused, P update_last_pushed_frame)
+        void handle_frame(frame_holder frame, bool is_real_time, T calc_deadline, device_serializer::nanoseconds max_lateness,
+            K is_paused, P update_last_pushed_frame)
         {
             if (frame == nullptr)
             {
@@ -85,20 +90,26 @@ namespace librealsense
             }
             if (m_is_started)
             {
-                frame->get_owner()->set_sensor(shared_from_this());
-                auto type = frame->get_stream()->get_stream_type();
-                auto index = static_cast<uint32_t>(frame->get_stream()->get_stream_index());
-                frame->set_stream(m_streams[std::make_pair(type, index)]);
-                frame->set_sensor(shared_from_this());
+                bind_frame(frame.frame);
                 auto stream_id = frame.frame->get_stream()->get_unique_id();
                 //TODO: Ziv, remove usage of shared_ptr when frame_holder is cpoyable
                 auto pf = std::make_shared<frame_holder>(std::move(frame));
 
-                auto callback = [this, is_real_time, stream_id, pf, calc_sleep, is_paused, update_last_pushed_frame](dispatcher::cancellable_timer t)
+                auto callback = [this, is_real_time, stream_id, pf, calc_deadline, max_lateness, is_paused, update_last_pushed_frame](dispatcher::cancellable_timer t)
                 {
-                    device_serializer::nanoseconds sleep_for = calc_sleep();
-                    if (sleep_for.count() > 0)
-                        t.try_sleep(sleep_for.count() * 1e-6);
+                    if (is_real_time)
+                    {
+                        // The deadline is absolute, so the time spent on earlier frames doesn't add up
+                        auto deadline = calc_deadline();
+                        t.try_sleep_until(deadline);
+                        if (max_lateness.count() > 0 && std::chrono::steady_clock::now() - deadline > max_lateness)
+                        {
+                            LOG_DEBUG("Skipping a late frame of stream " << stream_id);
+                            stream_statistics::instance().dropped(stream_id, RS2_FRAME_DROP_REASON_QUEUE);
+                            update_last_pushed_frame();
+                            return;
+                        }
+                    }
                     if(is_paused())
                         return;
 
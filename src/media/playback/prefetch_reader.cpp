@@ -0,0 +1,224 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#include "prefetch_reader.h"
+#include <algorithm>
+#include "types.h"
+#include "thread-scheduling.h"
+
+using namespace librealsense;
+using namespace device_serializer;
+
+const size_t prefetch_reader::DEFAULT_CACHE_SIZE;
+const size_t prefetch_reader::MAX_CACHE_SIZE;
+
+prefetch_reader::prefetch_reader(std::shared_ptr<reader> reader, size_t cache_size)
+    : _reader(reader), _cache_size(0), _prefetching(false), _running(false), _end_of_file(false)
+{
+    if (_reader == nullptr)
+        throw invalid_value_exception("null reader");
+    set_cache_size(cache_size);
+}
+
+prefetch_reader::~prefetch_reader()
+{
+    stop_prefetch();
+}
+
+void prefetch_reader::prefetch()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (_prefetching)
+    {
+        // A pooled reader doesn't hold the worker while its cache is full
+        if (_pool && _cache.size() >= _cache_size)
+            break;
+        _cv.wait(lock, [this]() { return !_prefetching || _cache.size() < _cache_size; });
+        if (!_prefetching)
+            break;
+
+        std::shared_ptr<serialized_data> data;
+        lock.unlock();
+        try
+        {
+            data = _reader->read_next_data();
+        }
+        catch (...)
+        {
+            lock.lock();
+            _error = std::current_exception();
+            _prefetching = false;
+            _cv.notify_all();
+            break;
+        }
+        lock.lock();
+
+        _cache.push_back(data);
+        if (data->is<serialized_end_of_file>())
+        {
+            //Nothing left to read until the reader is moved
+            _end_of_file = true;
+            _prefetching = false;
+        }
+        _cv.notify_all();
+    }
+    _running = false;
+    _cv.notify_all();
+}
+
+// Requires _mutex
+void prefetch_reader::schedule(std::unique_lock<std::mutex>& lock)
+{
+    if (_running || !_prefetching)
+        return;
+
+    _running = true;
+    if (_pool)
+    {
+        _pool->post([this]() { prefetch(); });
+        return;
+    }
+
+    //The previous worker is done with the lock once it cleared _running
+    if (_worker.joinable())
+        _worker.join();
+    _worker = std::thread([this]()
+    {
+        thread_scheduling::apply(RS2_THREAD_CATEGORY_PLAYBACK, "rs-playback");
+        prefetch();
+    });
+}
+
+void prefetch_reader::stop_prefetch()
+{
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _prefetching = false;
+        _cv.notify_all();
+        _cv.wait(lock, [this]() { return !_running; });
+    }
+    if (_worker.joinable())
+        _worker.join();
+}
+
+void prefetch_reader::clear_cache()
+{
+    _cache.clear();
+    _error = nullptr;
+    _end_of_file = false;
+}
+
+void prefetch_reader::rewind_to_cursor()
+{
+    //The reader is ahead of the playback cursor by the cached data, move it back so that
+    //calls that depend on its position (enabling or disabling streams) see the cursor's position
+    if (!_cache.empty() && !_cache.front()->is<serialized_end_of_file>())
+    {
+        auto cursor = std::min(_cache.front()->get_timestamp(), _reader->query_duration());
+        clear_cache();
+        _reader->seek_to_time(cursor);
+    }
+    else
+    {
+        clear_cache();
+    }
+}
+
+std::shared_ptr<serialized_data> prefetch_reader::read_next_data()
+{
+    if (_cache_size == 0)
+        return _reader->read_next_data();
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    if (!_prefetching && !_end_of_file && !_error && !_running)
+        _prefetching = true;
+    schedule(lock);
+
+    _cv.wait(lock, [this]() { return !_cache.empty() || _error; });
+    if (_cache.empty())
+    {
+        auto error = _error;
+        _error = nullptr;
+        std::rethrow_exception(error);
+    }
+
+    auto data = _cache.front();
+    //End of file stays at the head of the cache, the reader keeps returning it as well
+    if (!data->is<serialized_end_of_file>())
+        _cache.pop_front();
+    _cv.notify_all();
+    schedule(lock);
+    return data;
+}
+
+device_snapshot prefetch_reader::query_device_description(const nanoseconds& time)
+{
+    stop_prefetch();
+    return _reader->query_device_description(time);
+}
+
+void prefetch_reader::seek_to_time(const nanoseconds& time)
+{
+    stop_prefetch();
+    clear_cache();
+    _reader->seek_to_time(time);
+}
+
+nanoseconds prefetch_reader::query_duration() const
+{
+    return _reader->query_duration();
+}
+
+void prefetch_reader::reset()
+{
+    stop_prefetch();
+    clear_cache();
+    _reader->reset();
+}
+
+void prefetch_reader::enable_stream(const std::vector<stream_identifier>& stream_ids)
+{
+    stop_prefetch();
+    rewind_to_cursor();
+    _reader->enable_stream(stream_ids);
+}
+
+void prefetch_reader::disable_stream(const std::vector<stream_identifier>& stream_ids)
+{
+    stop_prefetch();
+    rewind_to_cursor();
+    _reader->disable_stream(stream_ids);
+}
+
+const std::string& prefetch_reader::get_file_name() const
+{
+    return _reader->get_file_name();
+}
+
+std::vector<std::shared_ptr<serialized_data>> prefetch_reader::fetch_last_frames(const nanoseconds& seek_time)
+{
+    stop_prefetch();
+    return _reader->fetch_last_frames(seek_time);
+}
+
+void prefetch_reader::set_cache_size(size_t cache_size)
+{
+    if (cache_size > MAX_CACHE_SIZE)
+        throw invalid_value_exception(to_string() << "Prefetch cache size " << cache_size << " is out of range [0, " << MAX_CACHE_SIZE << "]");
+
+    stop_prefetch();
+    if (cache_size == 0)
+        rewind_to_cursor();
+    _cache_size = cache_size;
+}
+
+size_t prefetch_reader::get_cache_size() const
+{
+    return _cache_size;
+}
+
+void prefetch_reader::set_pool(std::shared_ptr<thread_pool> pool)
+{
+    stop_prefetch();
+    _pool = std::move(pool);
+}
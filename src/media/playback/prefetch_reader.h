@@ -0,0 +1,67 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <core/serialization.h>
+#include "concurrency.h"
+
+namespace librealsense
+{
+    /**
+    * Reads and decodes data ahead of the playback cursor on a dedicated thread, or on the threads of a pool shared by
+    * several readers, into a bounded cache.
+    * All calls are expected to come from a single thread (the playback read thread). Calls that touch
+    * the underlying reader first stop the prefetching, and calls that move the reader also drop the cache.
+    */
+    class prefetch_reader : public device_serializer::reader
+    {
+    public:
+        static const size_t DEFAULT_CACHE_SIZE = 8;
+        static const size_t MAX_CACHE_SIZE = 16; // Must stay well below the reader's frame pool size, cached frames are allocated from it
+
+        prefetch_reader(std::shared_ptr<device_serializer::reader> reader, size_t cache_size = DEFAULT_CACHE_SIZE);
+        ~prefetch_reader();
+
+        device_serializer::device_snapshot query_device_description(const device_serializer::nanoseconds& time) override;
+        std::shared_ptr<device_serializer::serialized_data> read_next_data() override;
+        void seek_to_time(const device_serializer::nanoseconds& time) override;
+        device_serializer::nanoseconds query_duration() const override;
+        void reset() override;
+        void enable_stream(const std::vector<device_serializer::stream_identifier>& stream_ids) override;
+        void disable_stream(const std::vector<device_serializer::stream_identifier>& stream_ids) override;
+        const std::string& get_file_name() const override;
+        std::vector<std::shared_ptr<device_serializer::serialized_data>> fetch_last_frames(const device_serializer::nanoseconds& seek_time) override;
+
+        // 0 disables prefetching, data is then read on the calling thread
+        void set_cache_size(size_t cache_size);
+        size_t get_cache_size() const;
+
+        // Prefetches on the pool from now on, null for a dedicated thread. A pooled reader fills its cache and
+        // leaves the pool worker, the next read schedules it again
+        void set_pool(std::shared_ptr<thread_pool> pool);
+
+    private:
+        void prefetch();
+        void schedule(std::unique_lock<std::mutex>& lock);
+        void stop_prefetch();
+        void clear_cache();
+        void rewind_to_cursor();
+
+        std::shared_ptr<device_serializer::reader> _reader;
+        size_t _cache_size;
+
+        std::thread _worker;
+        std::shared_ptr<thread_pool> _pool;
+        mutable std::mutex _mutex;
+        std::condition_variable _cv;
+        std::deque<std::shared_ptr<device_serializer::serialized_data>> _cache;
+        std::exception_ptr _error;
+        bool _prefetching;
+        bool _running;      // prefetch() is running, on the worker or on the pool
+        bool _end_of_file;
+    };
+}
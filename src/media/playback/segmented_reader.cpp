@@ -0,0 +1,217 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#include "segmented_reader.h"
+#include <algorithm>
+#include "types.h"
+
+using namespace librealsense;
+using namespace device_serializer;
+
+static std::vector<stream_identifier> get_recorded_streams(reader& r)
+{
+    const uint32_t device_index = 0;
+    std::vector<stream_identifier> streams;
+    for (auto&& sensor : r.query_device_description(nanoseconds(0)).get_sensors_snapshots())
+    {
+        for (auto&& profile : sensor.get_stream_profiles())
+        {
+            streams.push_back({ device_index, sensor.get_sensor_index(), profile->get_stream_type(), static_cast<uint32_t>(profile->get_stream_index()) });
+        }
+    }
+    return streams;
+}
+
+segmented_reader::segmented_reader(const std::vector<std::string>& files, reader_factory open_file)
+    : _open_file(open_file), _first_frame(0), _current(0), _streaming(false), _seek_time(0)
+{
+    nanoseconds base(0);
+    for (auto&& file : files)
+    {
+        //The first frame of every segment places the next one on the recording's timeline
+        auto r = _open_file(file);
+        r->enable_stream(get_recorded_streams(*r));
+        std::shared_ptr<serialized_data> data;
+        do
+        {
+            data = r->read_next_data();
+        } while (!data->is<serialized_end_of_file>() && !data->is<serialized_frame>() && !data->is<serialized_invalid_frame>());
+
+        if (data->is<serialized_end_of_file>())
+        {
+            //Segments are opened ahead of time, the last one may have been left empty
+            LOG_WARNING("Recording segment " << file << " has no frames, skipped");
+            continue;
+        }
+        if (_segments.empty())
+            _first_frame = data->get_timestamp();
+
+        auto last_frame = data->get_timestamp() + r->query_duration();
+        _segments.push_back({ file, base, last_frame });
+        base += last_frame;
+    }
+    if (_segments.empty())
+        throw io_exception(to_string() << "Recording " << files.front() << " has no frames");
+
+    _reader = open_segment(0);
+}
+
+size_t segmented_reader::find_segment(const nanoseconds& time) const
+{
+    auto it = std::upper_bound(_segments.begin() + 1, _segments.end(), time, [](const nanoseconds& t, const segment& s) { return t < s.base; });
+    return (it - _segments.begin()) - 1;
+}
+
+std::shared_ptr<reader> segmented_reader::open_segment(size_t index) const
+{
+    auto r = _open_file(_segments[index].file);
+    if (!_enabled_streams.empty())
+        r->enable_stream({ _enabled_streams.begin(), _enabled_streams.end() });
+    return r;
+}
+
+void segmented_reader::move_to_segment(size_t index)
+{
+    _reader = nullptr; //Closing the previous segment first
+    _reader = open_segment(index);
+    _current = index;
+}
+
+std::shared_ptr<serialized_data> segmented_reader::rebase(const std::shared_ptr<serialized_data>& data, const nanoseconds& base)
+{
+    if (base.count() == 0)
+        return data;
+
+    auto timestamp = data->get_timestamp() + base;
+    if (auto frame = data->as<serialized_frame>())
+        return std::make_shared<serialized_frame>(timestamp, frame->stream_id, std::move(frame->frame));
+    if (data->is<serialized_invalid_frame>())
+        return std::make_shared<serialized_invalid_frame>(timestamp, std::static_pointer_cast<serialized_invalid_frame>(data)->stream_id);
+    if (auto option = data->as<serialized_option>())
+        return std::make_shared<serialized_option>(timestamp, option->sensor_id, option->option_id, option->option);
+    if (auto notification = data->as<serialized_notification>())
+        return std::make_shared<serialized_notification>(timestamp, notification->sensor_id, notification->notif);
+    return data;
+}
+
+device_snapshot segmented_reader::query_device_description(const nanoseconds& time)
+{
+    auto index = find_segment(time);
+    auto& s = _segments[index];
+    auto r = index == _current ? _reader : open_segment(index);
+    return r->query_device_description(time > s.base ? time - s.base : nanoseconds(0));
+}
+
+std::shared_ptr<serialized_data> segmented_reader::read_next_data()
+{
+    if (!_streaming)
+    {
+        LOG_DEBUG("End of file reached");
+        return std::make_shared<serialized_end_of_file>();
+    }
+
+    while (true)
+    {
+        auto data = _reader->read_next_data();
+        if (data->is<serialized_end_of_file>())
+        {
+            if (_current + 1 == _segments.size())
+                return data;
+            LOG_INFO("Playing recording segment " << _segments[_current + 1].file);
+            move_to_segment(_current + 1);
+            continue;
+        }
+
+        data = rebase(data, _segments[_current].base);
+        if (data->get_timestamp() >= _seek_time)
+            return data;
+    }
+}
+
+void segmented_reader::seek_to_time(const nanoseconds& time)
+{
+    if (time > query_duration())
+    {
+        throw invalid_value_exception(to_string() << "Requested time is out of playback length. (Requested = " << time.count() << ", Duration = " << query_duration().count() << ")");
+    }
+
+    auto index = find_segment(time);
+    if (index != _current)
+        move_to_segment(index);
+    else if (!_streaming && !_enabled_streams.empty())
+        _reader->enable_stream({ _enabled_streams.begin(), _enabled_streams.end() });
+
+    //Segments index times from their first frame, later times within the segment are reached by skipping
+    auto& s = _segments[index];
+    auto relative = time - s.base;
+    _reader->seek_to_time(std::min(relative, _reader->query_duration()));
+    _seek_time = time;
+    _streaming = true;
+}
+
+nanoseconds segmented_reader::query_duration() const
+{
+    auto& last = _segments.back();
+    return last.base + last.last_frame - _first_frame;
+}
+
+void segmented_reader::reset()
+{
+    if (_current == 0)
+        _reader->reset();
+    else
+    {
+        _reader = nullptr;
+        _reader = _open_file(_segments[0].file);
+        _current = 0;
+    }
+    _streaming = false;
+    _seek_time = nanoseconds(0);
+}
+
+void segmented_reader::enable_stream(const std::vector<stream_identifier>& stream_ids)
+{
+    _enabled_streams.insert(stream_ids.begin(), stream_ids.end());
+    if (!_streaming) //Starting to stream
+    {
+        if (_current != 0)
+            move_to_segment(0);
+        else
+            _reader->enable_stream({ _enabled_streams.begin(), _enabled_streams.end() });
+        _seek_time = nanoseconds(0);
+        _streaming = true;
+        return;
+    }
+    _reader->enable_stream(stream_ids);
+}
+
+void segmented_reader::disable_stream(const std::vector<stream_identifier>& stream_ids)
+{
+    for (auto&& id : stream_ids)
+        _enabled_streams.erase(id);
+    _reader->disable_stream(stream_ids);
+}
+
+const std::string& segmented_reader::get_file_name() const
+{
+    return _segments.front().file;
+}
+
+std::vector<std::shared_ptr<serialized_data>> segmented_reader::fetch_last_frames(const nanoseconds& seek_time)
+{
+    //Streams that have no frame in the segment of the seek time get theirs from the segments before it
+    std::vector<std::shared_ptr<serialized_data>> result;
+    auto missing = _enabled_streams;
+    for (auto index = find_segment(seek_time) + 1; index > 0 && !missing.empty(); --index)
+    {
+        auto& s = _segments[index - 1];
+        auto r = index - 1 == _current ? _reader : open_segment(index - 1);
+        for (auto&& data : r->fetch_last_frames(seek_time > s.base ? seek_time - s.base : nanoseconds(0)))
+        {
+            auto frame = data->as<serialized_frame>();
+            if (frame && missing.erase(frame->stream_id))
+                result.push_back(rebase(data, s.base));
+        }
+    }
+    return result;
+}
@@ -0,0 +1,57 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <functional>
+#include <set>
+#include <core/serialization.h>
+
+namespace librealsense
+{
+    /**
+    * Plays the segments of a recording that was split into several files as a single recording.
+    * Every segment is a recording of its own, with times relative to the last frame of the previous segment,
+    * so the reader places each segment on the recording's timeline by the frames of the segments before it.
+    * Only the segment under the cursor is kept open.
+    */
+    class segmented_reader : public device_serializer::reader
+    {
+    public:
+        using reader_factory = std::function<std::shared_ptr<device_serializer::reader>(const std::string& file)>;
+
+        segmented_reader(const std::vector<std::string>& files, reader_factory open_file);
+
+        device_serializer::device_snapshot query_device_description(const device_serializer::nanoseconds& time) override;
+        std::shared_ptr<device_serializer::serialized_data> read_next_data() override;
+        void seek_to_time(const device_serializer::nanoseconds& time) override;
+        device_serializer::nanoseconds query_duration() const override;
+        void reset() override;
+        void enable_stream(const std::vector<device_serializer::stream_identifier>& stream_ids) override;
+        void disable_stream(const std::vector<device_serializer::stream_identifier>& stream_ids) override;
+        const std::string& get_file_name() const override;
+        std::vector<std::shared_ptr<device_serializer::serialized_data>> fetch_last_frames(const device_serializer::nanoseconds& seek_time) override;
+
+    private:
+        struct segment
+        {
+            std::string file;
+            device_serializer::nanoseconds base;        // Time of the recording the segment's times are relative to
+            device_serializer::nanoseconds last_frame;  // Relative to base
+        };
+
+        size_t find_segment(const device_serializer::nanoseconds& time) const;
+        std::shared_ptr<device_serializer::reader> open_segment(size_t index) const;
+        void move_to_segment(size_t index);
+        static std::shared_ptr<device_serializer::serialized_data> rebase(const std::shared_ptr<device_serializer::serialized_data>& data,
+            const device_serializer::nanoseconds& base);
+
+        reader_factory _open_file;
+        std::vector<segment> _segments;
+        device_serializer::nanoseconds _first_frame;
+        std::set<device_serializer::stream_identifier> _enabled_streams;
+        std::shared_ptr<device_serializer::reader> _reader;
+        size_t _current;
+        bool _streaming;
+        device_serializer::nanoseconds _seek_time;              // Data before it is skipped, when a seek lands past the indexed part of a segment
+    };
+}
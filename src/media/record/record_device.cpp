@@ -8,11 +8,42 @@
 
 using namespace librealsense;
 
+static uint64_t get_frame_data_size(const frame_holder& f)
+{
+    if (auto vf = frame_cast<video_frame>(f.frame))
+        return static_cast<uint64_t>(vf->get_height()) * vf->get_stride();
+    if (auto fr = dynamic_cast<frame*>(f.frame))
+        return fr->data.size();
+    return 0;
+}
+
 librealsense::record_device::record_device(std::shared_ptr<librealsense::device_interface> device,
                                       std::shared_ptr<librealsense::device_serializer::writer> serializer):
-    m_write_thread([](){return std::make_shared<dispatcher>(std::numeric_limits<unsigned int>::max());}),
+    m_write_thread([](){return std::make_shared<dispatcher>(std::numeric_limits<unsigned int>::max(), std::make_shared<thread_pool>(1));}),
     m_is_recording(true),
-    m_record_pause_time(0)
+    m_record_pause_time(0),
+    m_cached_data_size(0),
+    m_frame_queue(MAX_CACHED_FRAMES),
+    m_drain_scheduled(false),
+    m_memory_budget(MAX_CACHED_DATA_SIZE),
+    m_cached_frames(0),
+    m_accepting(true),
+    m_frames_written(0),
+    m_frames_dropped(0),
+    m_bytes_written(0),
+    m_rate_window_start(std::chrono::steady_clock::now()),
+    m_rate_window_bytes(0),
+    m_bytes_per_second(0),
+    m_chunk_size(0),
+    m_columnar_metadata(false),
+    m_segment_max_bytes(0),
+    m_segment_max_duration(0),
+    m_segment_index(0),
+    m_segment_bytes(0),
+    m_segment_frames(0),
+    m_segment_start(0),
+    m_segment_time_base(0),
+    m_last_frame_time(0)
 {
     if (device == nullptr)
     {
@@ -26,6 +57,7 @@ librealsense::record_device::record_device(std::shared_ptr<librealsense::device_
 
     m_device = device;
     m_ros_writer = serializer;
+    m_file_name = serializer->get_file_name();
     (*m_write_thread)->start(); //Start thread before creating the sensors (since they might write right away)
     m_sensors = create_record_sensors(m_device);
     LOG_DEBUG("Created record_device");
@@ -40,7 +72,8 @@ std::vector<std::shared_ptr<librealsense::record_sensor>> librealsense::record_d
         auto recording_sensor = std::make_shared<librealsense::record_sensor>(*this, live_sensor);
         m_on_notification_token = recording_sensor->on_notification += [this, recording_sensor, sensor_index](const notification& n) { write_notification(sensor_index, n); };
         auto on_error = [recording_sensor](const std::string& s) {recording_sensor->stop_with_error(s); };
-        m_on_frame_token = recording_sensor->on_frame += [this, recording_sensor, sensor_index, on_error](frame_holder f) { write_data(sensor_index, std::move(f), on_error); };
+        m_on_error.push_back(on_error);
+        m_on_frame_token = recording_sensor->on_frame += [this, recording_sensor, sensor_index](frame_holder f) { write_data(sensor_index, std::move(f)); };
         m_on_extension_change_token = recording_sensor->on_extension_change += [this, recording_sensor, sensor_index, on_error](rs2_extension ext, std::shared_ptr<extension_snapshot> snapshot) { write_sensor_extension_snapshot(sensor_index, ext, snapshot, on_error); };
         recording_sensor->init(); //Calling init AFTER register to the above events
         record_sensors.emplace_back(recording_sensor);
@@ -57,11 +90,20 @@ librealsense::record_device::~record_device()
         s->on_extension_change -= m_on_extension_change_token;
         s->disable_recording();
     }
+    {
+        //Release sensor callbacks that are still waiting for room in the cache
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_accepting = false;
+    }
+    m_cache_cv.notify_all();
     if ((*m_write_thread)->flush() == false)
     {
         LOG_ERROR("Error - timeout waiting for flush, possible deadlock detected");
     }
     (*m_write_thread)->stop();
+    discard_next_segment();
+    if (m_closed_segment.valid())
+        m_closed_segment.wait();
     //Just in case someone still holds a reference to the sensors,
     // we make sure that they will not try to record anything
     m_sensors.clear();
@@ -110,9 +152,9 @@ std::chrono::nanoseconds librealsense::record_device::get_capture_time() const
     return (now - m_capture_time_base) - m_record_pause_time;
 }
 
-void librealsense::record_device::write_data(size_t sensor_index, librealsense::frame_holder frame, std::function<void(std::string const&)> on_error)
+void librealsense::record_device::write_data(size_t sensor_index, librealsense::frame_holder frame)
 {
-    //write_data is called from the sensors, when the live sensor raises a frame
+    //write_data is called from the sensors, after the live sensor raised the frame to the user
 
     LOG_DEBUG("write frame " << (frame ? std::to_string(frame.frame->get_frame_number()) : "") <<  " from sensor " << sensor_index);
 
@@ -121,25 +163,37 @@ void librealsense::record_device::write_data(size_t sensor_index, librealsense::
         initialize_recording();
     });
 
-    //TODO: restore: uint64_t data_size = frame.frame->get_frame_data_size();
-    uint64_t cached_data_size = m_cached_data_size; //TODO: restore: (+ data_size)
-    if (cached_data_size > MAX_CACHED_DATA_SIZE)
+    auto data_size = get_frame_data_size(frame);
+    if (!reserve_cache(frame, data_size))
     {
-        LOG_WARNING("Recorder reached maximum cache size, frame dropped");
-        on_error("Recorder reached maximum cache size, frame dropped");
         return;
     }
 
-    m_cached_data_size = cached_data_size;
-    auto capture_time = get_capture_time();
-    //TODO: remove usage of shared pointer when frame_holder is copyable
-    auto frame_holder_ptr = std::make_shared<frame_holder>();
-    *frame_holder_ptr = std::move(frame);
-    (*m_write_thread)->invoke([this, frame_holder_ptr, sensor_index, capture_time/*, data_size*/, on_error](dispatcher::cancellable_timer t) {
+    m_frame_queue.enqueue({ std::move(frame), sensor_index, get_capture_time(), data_size });
+    if (!m_drain_scheduled.exchange(true))
+    {
+        (*m_write_thread)->invoke([this](dispatcher::cancellable_timer t) { write_pending_frames(); });
+    }
+}
+
+void librealsense::record_device::write_pending_frames()
+{
+    //Cleared before draining, so that a frame queued after the last one taken here schedules another drain
+    m_drain_scheduled.exchange(false);
+
+    pending_frame pending;
+    while (m_frame_queue.try_dequeue(&pending))
+    {
+        auto data_size = pending.data_size;
+        auto sensor_index = pending.sensor_index;
+        auto capture_time = pending.capture_time;
+        auto frame = std::move(pending.frame);
         if (m_is_recording == false)
         {
-            return; //Recording is paused
+            release_cache(data_size, false);
+            continue; //Recording is paused
         }
+        auto& on_error = m_on_error[sensor_index];
         std::call_once(m_first_frame_flag, [&]()
         {
             try
@@ -156,16 +210,246 @@ void librealsense::record_device::write_data(size_t sensor_index, librealsense::
         try
         {
             const uint32_t device_index = 0;
-            auto stream_type = frame_holder_ptr->frame->get_stream()->get_stream_type();
-            auto stream_index = static_cast<uint32_t>(frame_holder_ptr->frame->get_stream()->get_stream_index());
-            m_ros_writer->write_frame({ device_index, static_cast<uint32_t>(sensor_index), stream_type, stream_index }, capture_time, std::move(*frame_holder_ptr));
-            //TODO: restore: std::lock_guard<std::mutex> locker(m_mutex);  m_cached_data_size -= data_size;
+            auto stream_type = frame.frame->get_stream()->get_stream_type();
+            auto stream_index = static_cast<uint32_t>(frame.frame->get_stream()->get_stream_index());
+            if (segment_limit_reached(capture_time))
+                switch_segment();
+            m_ros_writer->write_frame({ device_index, static_cast<uint32_t>(sensor_index), stream_type, stream_index }, get_segment_time(capture_time), std::move(frame));
+            if (m_segment_frames++ == 0)
+                m_segment_start = capture_time;
+            m_segment_bytes += data_size;
+            m_last_frame_time = capture_time;
+            release_cache(data_size, true);
         }
         catch(std::exception& e)
         {
+            release_cache(data_size, false);
             on_error(to_string() << "Failed to write frame. " << e.what());
         }
+    }
+}
+
+bool librealsense::record_device::reserve_cache(const frame_holder& frame, uint64_t data_size)
+{
+    auto stream = frame.frame->get_stream();
+    std::unique_lock<std::mutex> lock(m_mutex);
+    auto it = m_write_policies.find({ stream->get_stream_type(), stream->get_stream_index() });
+    auto policy = it != m_write_policies.end() ? it->second : RS2_RECORD_WRITE_POLICY_DROP;
+
+    //A single frame is always admitted into an empty cache, so frames larger than the budget are still recorded
+    auto fits = [&]() { return m_cached_frames == 0 || (m_cached_data_size + data_size <= m_memory_budget && m_cached_frames < MAX_CACHED_FRAMES); };
+    if (policy == RS2_RECORD_WRITE_POLICY_BLOCK && !fits())
+    {
+        thread_pool::blocking_region blocking;
+        m_cache_cv.wait(lock, [&]() { return !m_accepting || fits(); });
+    }
+
+    if (!m_accepting)
+    {
+        return false;
+    }
+
+    if (!fits())
+    {
+        m_frames_dropped++;
+        LOG_WARNING("Recorder reached maximum cache size, frame " << frame.frame->get_frame_number() << " of " << stream->get_stream_type() << " dropped");
+        return false;
+    }
+
+    m_cached_data_size += data_size;
+    m_cached_frames++;
+    return true;
+}
+
+void librealsense::record_device::release_cache(uint64_t data_size, bool written)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_cached_data_size -= data_size;
+        m_cached_frames--;
+        if (written)
+        {
+            m_frames_written++;
+            m_bytes_written += data_size;
+            m_rate_window_bytes += data_size;
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        auto window = std::chrono::duration<double>(now - m_rate_window_start).count();
+        if (window >= 1.0)
+        {
+            m_bytes_per_second = m_rate_window_bytes / window;
+            m_rate_window_bytes = 0;
+            m_rate_window_start = now;
+        }
+    }
+    m_cache_cv.notify_all();
+}
+
+void librealsense::record_device::set_memory_budget(uint64_t bytes)
+{
+    if (bytes == 0)
+        throw invalid_value_exception("Recorder memory budget must be positive");
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_memory_budget = bytes;
+    }
+    m_cache_cv.notify_all();
+}
+
+void librealsense::record_device::set_write_policy(rs2_stream stream, int index, rs2_record_write_policy policy)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_write_policies[{ stream, index }] = policy;
+}
+
+void librealsense::record_device::set_chunk_size(uint32_t bytes)
+{
+    if (bytes == 0)
+        throw invalid_value_exception("Recorder chunk size must be positive");
+    //The file is only accessed from the write thread
+    (*m_write_thread)->invoke([this, bytes](dispatcher::cancellable_timer t)
+    {
+        m_chunk_size = bytes;
+        m_ros_writer->set_chunk_size(bytes);
+    });
+    (*m_write_thread)->flush();
+}
+
+void librealsense::record_device::set_columnar_metadata(bool enable)
+{
+    (*m_write_thread)->invoke([this, enable](dispatcher::cancellable_timer t)
+    {
+        m_columnar_metadata = enable;
+        m_ros_writer->set_columnar_metadata(enable);
+    });
+    (*m_write_thread)->flush();
+}
+
+void librealsense::record_device::set_stream_compression(rs2_stream stream, int index, bool enable)
+{
+    if (index < 0)
+        throw invalid_value_exception(to_string() << "Invalid stream index " << index << " for recorder compression");
+    //Frames are encoded on the write thread, so the sensor callbacks are not slowed down
+    (*m_write_thread)->invoke([this, stream, index, enable](dispatcher::cancellable_timer t)
+    {
+        if (enable)
+            m_compressed_streams.insert({ stream, static_cast<uint32_t>(index) });
+        else
+            m_compressed_streams.erase({ stream, static_cast<uint32_t>(index) });
+        m_ros_writer->set_stream_compression(stream, static_cast<uint32_t>(index), enable);
     });
+    (*m_write_thread)->flush();
+}
+
+void librealsense::record_device::set_segment_limits(uint64_t bytes, std::chrono::nanoseconds duration)
+{
+    if (duration.count() < 0)
+        throw invalid_value_exception("Recorder segment duration must not be negative");
+    (*m_write_thread)->invoke([this, bytes, duration](dispatcher::cancellable_timer t)
+    {
+        m_segment_max_bytes = bytes;
+        m_segment_max_duration = duration;
+        if (bytes == 0 && duration.count() == 0)
+            discard_next_segment();
+        else if (!m_next_segment.valid())
+            open_next_segment();
+    });
+    (*m_write_thread)->flush();
+}
+
+//Times within a segment are relative to the last frame of the previous segment, time 0 holds its description
+std::chrono::nanoseconds librealsense::record_device::get_segment_time(std::chrono::nanoseconds capture_time) const
+{
+    if (m_segment_index == 0)
+        return capture_time;
+    return std::max(capture_time - m_segment_time_base, std::chrono::nanoseconds(1));
+}
+
+bool librealsense::record_device::segment_limit_reached(std::chrono::nanoseconds capture_time) const
+{
+    if (m_segment_frames == 0)
+        return false;
+    return (m_segment_max_bytes > 0 && m_segment_bytes >= m_segment_max_bytes) ||
+        (m_segment_max_duration.count() > 0 && capture_time - m_segment_start >= m_segment_max_duration);
+}
+
+void librealsense::record_device::switch_segment()
+{
+    auto next = m_next_segment.valid() ? m_next_segment.get() :
+        m_ros_writer->create_segment(device_serializer::get_segment_file_name(m_file_name, m_segment_index + 1));
+    m_next_segment = {};
+    apply_writer_settings(*next);
+
+    //Closing a segment writes its index, which is left to a background thread as well
+    if (m_closed_segment.valid())
+        m_closed_segment.wait();
+    m_closed_segment = std::async(std::launch::async, [](std::shared_ptr<device_serializer::writer> segment) { segment.reset(); }, std::move(m_ros_writer));
+    m_ros_writer = next;
+
+    m_segment_index++;
+    m_segment_time_base = m_last_frame_time;
+    m_segment_bytes = 0;
+    m_segment_frames = 0;
+    write_header();
+    //The streams are described once, when they start, so every segment repeats their description
+    for (auto&& stream : m_stream_snapshots)
+    {
+        const uint32_t device_index = 0;
+        m_ros_writer->write_snapshot({ device_index, static_cast<uint32_t>(std::get<0>(stream)) }, std::chrono::nanoseconds(0), std::get<1>(stream), std::get<2>(stream));
+    }
+    LOG_INFO("Recording continues in " << m_ros_writer->get_file_name());
+    open_next_segment();
+}
+
+void librealsense::record_device::open_next_segment()
+{
+    auto current = m_ros_writer;
+    auto file = device_serializer::get_segment_file_name(m_file_name, m_segment_index + 1);
+    m_next_segment = std::async(std::launch::async, [current, file]() { return current->create_segment(file); }).share();
+}
+
+void librealsense::record_device::discard_next_segment()
+{
+    if (!m_next_segment.valid())
+        return;
+
+    try
+    {
+        auto next = m_next_segment.get();
+        std::string file = next->get_file_name();
+        m_next_segment = {};
+        next.reset();
+        std::remove(file.c_str());
+    }
+    catch (const std::exception& e)
+    {
+        m_next_segment = {};
+        LOG_WARNING("Failed to open the next recording segment. " << e.what());
+    }
+}
+
+void librealsense::record_device::apply_writer_settings(device_serializer::writer& writer) const
+{
+    if (m_chunk_size > 0)
+        writer.set_chunk_size(m_chunk_size);
+    if (m_columnar_metadata)
+        writer.set_columnar_metadata(true);
+    for (auto&& stream : m_compressed_streams)
+        writer.set_stream_compression(stream.first, stream.second, true);
+}
+
+rs2_record_stats librealsense::record_device::get_stats()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    rs2_record_stats stats{};
+    stats.queued_frames = m_cached_frames;
+    stats.queued_bytes = m_cached_data_size;
+    stats.frames_written = m_frames_written;
+    stats.frames_dropped = m_frames_dropped;
+    stats.bytes_written = m_bytes_written;
+    stats.bytes_per_second = m_bytes_per_second;
+    return stats;
 }
 
 const std::string& librealsense::record_device::get_info(rs2_camera_info info) const
@@ -272,7 +556,7 @@ void librealsense::record_device::write_device_extension_changes(const T& ext)
         try
         {
             const uint32_t device_index = 0;
-            m_ros_writer->write_snapshot(device_index, capture_time, TypeToExtension<T>::value, ext_snapshot);
+            m_ros_writer->write_snapshot(device_index, get_segment_time(capture_time), TypeToExtension<T>::value, ext_snapshot);
         }
         catch (const std::exception& e)
         {
@@ -292,7 +576,9 @@ void record_device::write_sensor_extension_snapshot(size_t sensor_index,
         try
         {
             const uint32_t device_index = 0;
-            m_ros_writer->write_snapshot({ device_index, static_cast<uint32_t>(sensor_index) }, capture_time, ext, snapshot);
+            m_ros_writer->write_snapshot({ device_index, static_cast<uint32_t>(sensor_index) }, get_segment_time(capture_time), ext, snapshot);
+            if (ext == RS2_EXTENSION_VIDEO_PROFILE || ext == RS2_EXTENSION_MOTION_PROFILE || ext == RS2_EXTENSION_POSE_PROFILE)
+                m_stream_snapshots.emplace_back(sensor_index, ext, snapshot);
         }
         catch (const std::exception& e)
         {
@@ -309,7 +595,7 @@ void librealsense::record_device::write_notification(size_t sensor_index, const
         try
         {
             const uint32_t device_index = 0;
-            m_ros_writer->write_notification({ device_index, static_cast<uint32_t>(sensor_index) }, capture_time, n);
+            m_ros_writer->write_notification({ device_index, static_cast<uint32_t>(sensor_index) }, get_segment_time(capture_time), n);
         }
         catch (const std::exception& e)
         {
@@ -401,7 +687,7 @@ void librealsense::record_device::resume_recording()
 
 const std::string& librealsense::record_device::get_filename() const
 {
-    return m_ros_writer->get_file_name();
+    return m_file_name;
 }
 platform::backend_device_group record_device::get_device_data() const
 {
@@ -416,7 +702,6 @@ void record_device::initialize_recording()
 {
     //Expected to be called once when recording to file actually starts
     m_capture_time_base = std::chrono::high_resolution_clock::now();
-    m_cached_data_size = 0;
 }
 void record_device::stop_gracefully(to_string error_msg)
 {
@@ -2,6 +2,8 @@
 // Copyright(c) 2017 Intel Corporation. All Rights Reserved.
 
 #pragma once
+#include <future>
+#include <set>
 #include <core/roi.h>
 #include <core/extension.h>
 #include <core/serialization.h>
@@ -19,6 +21,7 @@ namespace librealsense
     {
     public:
         static const uint64_t MAX_CACHED_DATA_SIZE = 1920 * 1080 * 4 * 30; // ~1 sec of HD video @ 30 FPS
+        static const unsigned int MAX_CACHED_FRAMES = 4096; // Several seconds of IMU samples
 
         record_device(std::shared_ptr<device_interface> device, std::shared_ptr<device_serializer::writer> serializer);
         virtual ~record_device();
@@ -39,6 +42,26 @@ namespace librealsense
         void pause_recording();
         void resume_recording();
         const std::string& get_filename() const;
+
+        /**
+        * Frames are written to file by a dedicated write-behind thread, after the user callback got them. The memory budget
+        * bounds the size of the frames waiting in its queue, and the queue holds a bounded number of frames; once either is
+        * reached, each stream either drops new frames or blocks the sensor callback until the writer catches up, according to
+        * its write policy.
+        */
+        void set_memory_budget(uint64_t bytes);
+        void set_write_policy(rs2_stream stream, int index, rs2_record_write_policy policy);
+        void set_chunk_size(uint32_t bytes);
+        void set_columnar_metadata(bool enable);
+        void set_stream_compression(rs2_stream stream, int index, bool enable);
+
+        /**
+        * Splits the recording into segments with at most the given amount of frame data or duration, 0 for no limit.
+        * The next segment is opened on a background thread, the recording moves to it between two frames and the
+        * previous one is closed in the background as well, so frames keep being written during the switch.
+        */
+        void set_segment_limits(uint64_t bytes, std::chrono::nanoseconds duration);
+        rs2_record_stats get_stats();
         platform::backend_device_group get_device_data() const override;
         std::pair<uint32_t, rs2_extrinsics> get_extrinsics(const stream_interface& stream) const override;
         bool is_valid() const override;
@@ -52,9 +75,16 @@ namespace librealsense
 
         void write_header();
         std::chrono::nanoseconds get_capture_time() const;
-        void write_data(size_t sensor_index, frame_holder f, std::function<void(std::string const&)> on_error);
+        void write_data(size_t sensor_index, frame_holder f);
+        void write_pending_frames();
         void write_sensor_extension_snapshot(size_t sensor_index, rs2_extension ext, std::shared_ptr<extension_snapshot> snapshot, std::function<void(std::string const&)> on_error);
         void write_notification(size_t sensor_index, const notification& n);
+        std::chrono::nanoseconds get_segment_time(std::chrono::nanoseconds capture_time) const;
+        bool segment_limit_reached(std::chrono::nanoseconds capture_time) const;
+        void switch_segment();
+        void open_next_segment();
+        void discard_next_segment();
+        void apply_writer_settings(device_serializer::writer& writer) const;
         std::vector<std::shared_ptr<record_sensor>> create_record_sensors(std::shared_ptr<device_interface> m_device);
         template <typename T> device_serializer::snapshot_collection get_extensions_snapshots(T* extendable);
         template <typename T, typename Ext> void try_add_snapshot(T* extendable, device_serializer::snapshot_collection& snapshots);
@@ -63,6 +93,7 @@ namespace librealsense
 
         lazy<std::shared_ptr<dispatcher>> m_write_thread;
         std::shared_ptr<device_serializer::writer> m_ros_writer;
+        std::string m_file_name;
 
         std::chrono::high_resolution_clock::time_point m_capture_time_base;
         std::chrono::high_resolution_clock::duration m_record_pause_time;
@@ -78,6 +109,50 @@ namespace librealsense
         std::once_flag m_first_call_flag;
         void initialize_recording();
         void stop_gracefully(to_string error_msg);
+        bool reserve_cache(const frame_holder& frame, uint64_t data_size);
+        void release_cache(uint64_t data_size, bool written);
+
+        struct pending_frame
+        {
+            frame_holder frame;
+            size_t sensor_index;
+            std::chrono::nanoseconds capture_time;
+            uint64_t data_size;
+        };
+        //Frames on their way from the sensor callbacks to the write thread, which drains the queue in one task for all the
+        //frames that arrived since the previous one. Reserving the cache keeps the queue from ever filling up
+        lock_free_queue<pending_frame> m_frame_queue;
+        std::atomic<bool> m_drain_scheduled;
+        std::vector<std::function<void(std::string const&)>> m_on_error; //Per sensor
+
+        std::condition_variable m_cache_cv;
+        uint64_t m_memory_budget;
+        uint64_t m_cached_frames;
+        bool m_accepting;
+        std::map<std::pair<rs2_stream, int>, rs2_record_write_policy> m_write_policies;
+        uint64_t m_frames_written;
+        uint64_t m_frames_dropped;
+        uint64_t m_bytes_written;
+        std::chrono::steady_clock::time_point m_rate_window_start;
+        uint64_t m_rate_window_bytes;
+        double m_bytes_per_second;
+
+        //Writer settings, applied again to every new segment. Accessed from the write thread only, like the rest of the segment state
+        uint32_t m_chunk_size;
+        bool m_columnar_metadata;
+        std::set<std::pair<rs2_stream, uint32_t>> m_compressed_streams;
+        std::vector<std::tuple<size_t, rs2_extension, std::shared_ptr<extension_snapshot>>> m_stream_snapshots;
+
+        uint64_t m_segment_max_bytes;
+        std::chrono::nanoseconds m_segment_max_duration;
+        uint32_t m_segment_index;
+        uint64_t m_segment_bytes;
+        uint64_t m_segment_frames;
+        std::chrono::nanoseconds m_segment_start;       //Capture time of the first frame of the segment
+        std::chrono::nanoseconds m_segment_time_base;   //Capture time the times of the segment are relative to
+        std::chrono::nanoseconds m_last_frame_time;
+        std::shared_future<std::shared_ptr<device_serializer::writer>> m_next_segment;
+        std::future<void> m_closed_segment;
     };
 
     MAP_EXTENSION(RS2_EXTENSION_RECORD, record_device);
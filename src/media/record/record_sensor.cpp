@@ -270,12 +270,15 @@ frame_callback_ptr librealsense::record_sensor::wrap_frame_callback(frame_callba
 {
     auto record_cb = [this, callback](frame_holder frame)
     {
-        record_frame(frame.clone());
+        //The recorder keeps its own reference, the user gets the frame before it is queued for writing
+        auto recorded = frame.clone();
 
         //Raise to user callback
         frame_interface* ref = nullptr;
         std::swap(frame.frame, ref);
         callback->on_frame((rs2_frame*)ref);
+
+        record_frame(std::move(recorded));
     };
 
     return std::make_shared<frame_holder_callback>(record_cb);
@@ -0,0 +1,85 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#include "mapped_file.h"
+#include "types.h"
+#include <cerrno>
+#include <cstdint>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace librealsense;
+
+#ifdef _WIN32
+mapped_file::mapped_file(const std::string& path)
+    : _data(nullptr), _size(0), _mapping(nullptr)
+{
+    auto file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        throw io_exception(to_string() << "Failed to open " << path << " for mapping, error " << GetLastError());
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0 || static_cast<uint64_t>(size.QuadPart) > SIZE_MAX)
+    {
+        CloseHandle(file);
+        throw io_exception(to_string() << "Cannot map " << path << " into the address space");
+    }
+
+    // The mapping object keeps its own reference to the file
+    _mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (!_mapping)
+        throw io_exception(to_string() << "Failed to map " << path << ", error " << GetLastError());
+
+    _data = static_cast<const uint8_t*>(MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0));
+    if (!_data)
+    {
+        auto error = GetLastError();
+        CloseHandle(_mapping);
+        throw io_exception(to_string() << "Failed to map " << path << ", error " << error);
+    }
+    _size = static_cast<uint64_t>(size.QuadPart);
+}
+
+mapped_file::~mapped_file()
+{
+    UnmapViewOfFile(_data);
+    CloseHandle(_mapping);
+}
+#else
+mapped_file::mapped_file(const std::string& path)
+    : _data(nullptr), _size(0)
+{
+    auto fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw io_exception(to_string() << "Failed to open " << path << " for mapping, error " << errno);
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0 || static_cast<uint64_t>(st.st_size) > SIZE_MAX)
+    {
+        close(fd);
+        throw io_exception(to_string() << "Cannot map " << path << " into the address space");
+    }
+
+    // The mapping stays valid after the descriptor is closed
+    auto data = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+        throw io_exception(to_string() << "Failed to map " << path << ", error " << errno);
+
+    _data = static_cast<const uint8_t*>(data);
+    _size = static_cast<uint64_t>(st.st_size);
+}
+
+mapped_file::~mapped_file()
+{
+    munmap(const_cast<uint8_t*>(_data), static_cast<size_t>(_size));
+}
+#endif
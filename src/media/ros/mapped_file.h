@@ -0,0 +1,33 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <cstdint>
+#include <string>
+
+namespace librealsense
+{
+    /**
+    * Read-only memory mapping of an entire file, unmapped on destruction.
+    * Frames that reference the mapped bytes keep it alive by holding a shared_ptr to it.
+    */
+    class mapped_file
+    {
+    public:
+        explicit mapped_file(const std::string& path);
+        ~mapped_file();
+
+        mapped_file(const mapped_file&) = delete;
+        mapped_file& operator=(const mapped_file&) = delete;
+
+        const uint8_t* data() const { return _data; }
+        uint64_t size() const { return _size; }
+
+    private:
+        const uint8_t* _data;
+        uint64_t _size;
+#ifdef _WIN32
+        void* _mapping;
+#endif
+    };
+}
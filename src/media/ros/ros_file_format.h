@@ -12,6 +12,7 @@
 #include "std_msgs/UInt32.h"
 #include "std_msgs/Float32.h"
 #include "std_msgs/String.h"
+#include "std_msgs/UInt8MultiArray.h"
 #include "realsense_msgs/StreamInfo.h"
 #include "realsense_msgs/ImuIntrinsic.h"
 #include "realsense_msgs/Notification.h"
@@ -27,9 +28,16 @@
 #include "stream.h"
 #include "types.h"
 #include <vector>
+#include <set>
+#include <map>
+#include <algorithm>
+#include <cstring>
 
 namespace librealsense
 {
+    //Encoding of Z16 images stored RVL-compressed, see rvl-codec.h
+    constexpr const char* RVL_ENCODING = "rvl";
+
     inline void convert(rs2_format source, std::string& target)
     {
         switch (source)
@@ -58,6 +66,7 @@ namespace librealsense
         if (source == sensor_msgs::image_encodings::TYPE_16UC1) { target = RS2_FORMAT_Y16; return; }
         if (source == sensor_msgs::image_encodings::MONO8) { target = RS2_FORMAT_RAW8; return; }
         if (source == sensor_msgs::image_encodings::YUV422) { target = RS2_FORMAT_UYVY; return; }
+        if (source == RVL_ENCODING) { target = RS2_FORMAT_Z16; return; }
         if (!try_parse(source, target))
         {
             throw std::runtime_error(to_string() << "Failed to convert source: \"" << "\" to matching rs2_format");
@@ -313,6 +322,11 @@ namespace librealsense
             return create_from({ stream_full_prefix(stream_id), stream_to_ros_type(stream_id.stream_type), "metadata" });
         }
 
+        static std::string frame_metadata_block_topic(const device_serializer::stream_identifier& stream_id)
+        {
+            return create_from({ stream_full_prefix(stream_id), stream_to_ros_type(stream_id.stream_type), "metadata_block" });
+        }
+
         static std::string stream_extrinsic_topic(const device_serializer::stream_identifier& stream_id, uint32_t ref_id)
         {
             return create_from({ stream_full_prefix(stream_id), "tf", std::to_string(ref_id) });
@@ -420,6 +434,20 @@ namespace librealsense
         bool operator()(rosbag::ConnectionInfo const* info) const { return false; }
     };
 
+    class TopicsQuery
+    {
+    public:
+        TopicsQuery(const std::vector<std::string>& topics) : _topics(topics.begin(), topics.end()) {}
+
+        bool operator()(rosbag::ConnectionInfo const* info) const
+        {
+            return _topics.count(info->topic) > 0;
+        }
+
+    private:
+        std::set<std::string> _topics;
+    };
+
     class MultipleRegexTopicQuery
     {
     public:
@@ -550,6 +578,162 @@ namespace librealsense
         return rs2rosinternal::Time(secs.count());
     }
 
+    //Appends a metadata value to the frame's metadata blob, returns false once the blob is full
+    inline bool add_frame_metadata(frame_additional_data& additional_data, rs2_frame_metadata_value type, rs2_metadata_type value)
+    {
+        auto size_of_enum = sizeof(rs2_frame_metadata_value);
+        auto size_of_data = sizeof(rs2_metadata_type);
+        if (additional_data.metadata_size + size_of_enum + size_of_data > 255)
+        {
+            return false;
+        }
+        memcpy(additional_data.metadata_blob.data() + additional_data.metadata_size, &type, size_of_enum);
+        additional_data.metadata_size += static_cast<uint32_t>(size_of_enum);
+        memcpy(additional_data.metadata_blob.data() + additional_data.metadata_size, &value, size_of_data);
+        additional_data.metadata_size += static_cast<uint32_t>(size_of_data);
+        return true;
+    }
+
+    constexpr uint32_t get_metadata_block_version()
+    {
+        return 1u;
+    }
+
+    /**
+    * Metadata of consecutive frames of a stream, stored column by column in a single message instead of one
+    * KeyValue message per value and frame.
+    * Layout, in host byte order: version, frame count N and column count C (uint32 each), then N frame times
+    * (uint64, ROS time of the frame message in nanoseconds), N system times (double), N timestamp domains (uint8),
+    * followed by C columns of metadata type (uint32), N presence flags (uint8) and N values (rs2_metadata_type)
+    */
+    class metadata_block
+    {
+    public:
+        size_t size() const { return _times.size(); }
+        uint64_t last_time() const { return _times.back(); }
+
+        //Frames are expected in ascending time order
+        void add(uint64_t time, rs2_time_t system_time, rs2_timestamp_domain domain,
+            const std::vector<std::pair<rs2_frame_metadata_value, rs2_metadata_type>>& values)
+        {
+            auto index = _times.size();
+            _times.push_back(time);
+            _system_times.push_back(system_time);
+            _domains.push_back(static_cast<uint8_t>(domain));
+            for (auto&& value : values)
+            {
+                auto& c = _columns[value.first];
+                c.present.resize(index + 1, 0);
+                c.values.resize(index + 1, 0);
+                c.present[index] = 1;
+                c.values[index] = value.second;
+            }
+            for (auto&& c : _columns)
+            {
+                c.second.present.resize(index + 1, 0);
+                c.second.values.resize(index + 1, 0);
+            }
+        }
+
+        //Fills the metadata of the frame at the given time, returns false if the block does not hold it
+        bool find(uint64_t time, frame_additional_data& additional_data) const
+        {
+            auto it = std::lower_bound(_times.begin(), _times.end(), time);
+            if (it == _times.end() || *it != time)
+                return false;
+
+            auto index = it - _times.begin();
+            additional_data.system_time = _system_times[index];
+            additional_data.timestamp_domain = static_cast<rs2_timestamp_domain>(_domains[index]);
+            additional_data.metadata_size = 0;
+            for (auto&& c : _columns)
+            {
+                if (c.second.present[index] && !add_frame_metadata(additional_data, c.first, c.second.values[index]))
+                    break; //stop adding metadata to frame
+            }
+            return true;
+        }
+
+        std::vector<uint8_t> serialize() const
+        {
+            std::vector<uint8_t> data;
+            auto write = [&data](const void* src, size_t size)
+            {
+                auto bytes = static_cast<const uint8_t*>(src);
+                data.insert(data.end(), bytes, bytes + size);
+            };
+            auto version = get_metadata_block_version();
+            auto count = static_cast<uint32_t>(_times.size());
+            auto columns = static_cast<uint32_t>(_columns.size());
+            write(&version, sizeof(version));
+            write(&count, sizeof(count));
+            write(&columns, sizeof(columns));
+            write(_times.data(), _times.size() * sizeof(uint64_t));
+            write(_system_times.data(), _system_times.size() * sizeof(rs2_time_t));
+            write(_domains.data(), _domains.size());
+            for (auto&& c : _columns)
+            {
+                auto type = static_cast<uint32_t>(c.first);
+                write(&type, sizeof(type));
+                write(c.second.present.data(), c.second.present.size());
+                write(c.second.values.data(), c.second.values.size() * sizeof(rs2_metadata_type));
+            }
+            return data;
+        }
+
+        static metadata_block deserialize(const std::vector<uint8_t>& data)
+        {
+            size_t offset = 0;
+            auto read = [&data, &offset](void* dst, size_t size)
+            {
+                if (size > data.size() - offset)
+                    throw io_exception("Invalid file format, frame metadata block is truncated");
+                memcpy(dst, data.data() + offset, size);
+                offset += size;
+            };
+
+            uint32_t version, count, columns;
+            read(&version, sizeof(version));
+            if (version != get_metadata_block_version())
+                throw io_exception(to_string() << "Unsupported frame metadata block version " << version);
+            read(&count, sizeof(count));
+            read(&columns, sizeof(columns));
+            if (count > data.size())
+                throw io_exception("Invalid file format, frame metadata block is truncated");
+
+            metadata_block block;
+            block._times.resize(count);
+            block._system_times.resize(count);
+            block._domains.resize(count);
+            read(block._times.data(), count * sizeof(uint64_t));
+            read(block._system_times.data(), count * sizeof(rs2_time_t));
+            read(block._domains.data(), count);
+            for (uint32_t i = 0; i < columns; i++)
+            {
+                uint32_t type;
+                read(&type, sizeof(type));
+                auto& c = block._columns[static_cast<rs2_frame_metadata_value>(type)];
+                c.present.resize(count);
+                c.values.resize(count);
+                read(c.present.data(), count);
+                read(c.values.data(), count * sizeof(rs2_metadata_type));
+            }
+            return block;
+        }
+
+    private:
+        struct column
+        {
+            std::vector<uint8_t> present;
+            std::vector<rs2_metadata_type> values;
+        };
+
+        std::vector<uint64_t> _times;
+        std::vector<rs2_time_t> _system_times;
+        std::vector<uint8_t> _domains;
+        std::map<rs2_frame_metadata_value, column> _columns;
+    };
+
     namespace legacy_file_format
     {
         constexpr const char* USB_DESCRIPTOR = "{ 0x94b5fb99, 0x79f2, 0x4d66,{ 0x85, 0x06, 0xb1, 0x5e, 0x8b, 0x8c, 0x9d, 0xa1 } }";
@@ -8,7 +8,10 @@
 #include <ios>      //For std::hexfloat
 #include <core/serialization.h>
 #include "rosbag/view.h"
+#include "rosbag/topic_index.h"
 #include "ros_file_format.h"
+#include "mapped_file.h"
+#include "proc/rvl-codec.h"
 
 namespace librealsense
 {
@@ -96,46 +99,29 @@ namespace librealsense
             auto seek_time_as_secs = std::chrono::duration_cast<std::chrono::duration<double>>(seek_time);
             auto seek_time_as_rostime = rs2rosinternal::Time(seek_time_as_secs.count());
 
-            m_samples_view.reset(new rosbag::View(m_file, FalseQuery()));
-            
             //Using cached topics here and not querying them (before reseting) since a previous call to seek
             // could have changed the view and some streams that should be streaming were dropped.
             //E.g:  Recording Depth+Color, stopping Depth, starting IR, stopping IR and Color. Play IR+Depth: will play only depth, then only IR, then we seek to a point only IR was streaming, and then to 0.
-            for (auto topic : m_enabled_streams_topics)
-            {
-                m_samples_view->addQuery(m_file, rosbag::TopicQuery(topic), seek_time_as_rostime);
-            }
+            //A single query over all the topics matches the bag's connections once, instead of once per topic
+            m_samples_view.reset(new rosbag::View(m_file, TopicsQuery(m_enabled_streams_topics), seek_time_as_rostime));
             m_samples_itrator = m_samples_view->begin();
         }
 
         std::vector<std::shared_ptr<serialized_data>> fetch_last_frames(const nanoseconds& seek_time) override
         {
             std::vector<std::shared_ptr<serialized_data>> result;
-            rosbag::View view(m_file, FalseQuery());
             auto as_rostime = to_rostime(seek_time);
             auto start_time = to_rostime(get_static_file_info_timestamp());
-            
-            for (auto topic : m_enabled_streams_topics)
-            {
-                view.addQuery(m_file, rosbag::TopicQuery(topic), start_time, as_rostime);
-            }
-            std::map<device_serializer::stream_identifier, rs2rosinternal::Time> last_frames;
-            for (auto&& m : view)
+
+            //Looking up the last frame of each stream directly in its index, instead of scanning every message up to the seek time
+            for (auto&& topic : m_enabled_streams_topics)
             {
-                if (m.isType<sensor_msgs::Image>() || m.isType<sensor_msgs::Imu>())
+                auto msg = get_topic_index(topic).getLastMessage(start_time, as_rostime);
+                if (msg && (msg->isType<sensor_msgs::Image>() || msg->isType<sensor_msgs::Imu>()))
                 {
-                    auto id = ros_topic::get_stream_identifier(m.getTopic());
-                    last_frames[id] = m.getTime();
+                    result.push_back(create_frame(*msg));
                 }
             }
-            for (auto&& kvp : last_frames)
-            {
-                auto topic = ros_topic::frame_data_topic(kvp.first);
-                rosbag::View view(m_file, rosbag::TopicQuery(topic), kvp.second, kvp.second);
-                auto msg = view.begin();
-                auto new_frame = create_frame(*msg);
-                result.push_back(new_frame);
-            }
             return result;
         }
         nanoseconds query_duration() const override
@@ -148,6 +134,9 @@ namespace librealsense
             m_file.close();
             m_file.open(m_file_path, rosbag::BagMode::Read);
             m_version = read_file_version(m_file);
+            m_topic_indexes = rosbag::TopicIndex::build(m_file);
+            m_mapped_file = map_file(m_file_path);
+            m_metadata_blocks.clear();
             m_samples_view = nullptr;
             m_frame_source = std::make_shared<frame_source>(m_version == 1 ? 128 : 32);
             m_frame_source->init(m_metadata_parser_map);
@@ -356,6 +345,7 @@ namespace librealsense
                     LOG_WARNING("Failed to get timestamp_domain. Error: " << e.what());
                 }
             }
+            additional_data.metadata_size = total_md_size;
         }
         
         template <typename T>
@@ -373,17 +363,14 @@ namespace librealsense
             return true;
         }
 
-        static std::map<std::string, std::string> get_frame_metadata(const rosbag::Bag& bag, 
-            const std::string& topic,
+        static std::map<std::string, std::string> get_frame_metadata(const rosbag::TopicIndex& index,
             const device_serializer::stream_identifier& stream_id, 
             const rosbag::MessageInstance &msg, 
             frame_additional_data& additional_data)
         {
-            uint32_t total_md_size = 0;
             std::map<std::string, std::string> remaining;
-            rosbag::View frame_metadata_view(bag, rosbag::TopicQuery(topic), msg.getTime(), msg.getTime());
-
-            for (auto message_instance : frame_metadata_view)
+            additional_data.metadata_size = 0;
+            for (auto&& message_instance : index.getMessages(msg.getTime()))
             {
                 auto key_val_msg = instantiate_msg<diagnostic_msgs::KeyValue>(message_instance);
                 if (key_val_msg->key == TIMESTAMP_DOMAIN_MD_STR)
@@ -414,26 +401,25 @@ namespace librealsense
                         remaining[key_val_msg->key] = key_val_msg->value;
                         continue;
                     }
-                    auto size_of_enum = sizeof(rs2_frame_metadata_value);
-                    auto size_of_data = sizeof(rs2_metadata_type);
-                    if (total_md_size + size_of_enum + size_of_data > 255)
-                    {
-                        continue; //stop adding metadata to frame
-                    }
-                    memcpy(additional_data.metadata_blob.data() + total_md_size, &type, size_of_enum);
-                    total_md_size += static_cast<uint32_t>(size_of_enum);
-                    memcpy(additional_data.metadata_blob.data() + total_md_size, &md, size_of_data);
-                    total_md_size += static_cast<uint32_t>(size_of_data);
+                    add_frame_metadata(additional_data, type, md);
                 }
             }
-            additional_data.metadata_size = total_md_size;
             return remaining;
         }
 
         frame_holder create_image_from_message(const rosbag::MessageInstance &image_data) const
         {
             LOG_DEBUG("Trying to create an image frame from message");
-            auto msg = instantiate_msg<sensor_msgs::Image>(image_data);
+
+            // Images of uncompressed chunks are referenced in the mapped file instead of being copied out of it
+            sensor_msgs::ImagePtr mapped_msg = std::make_shared<sensor_msgs::Image>();
+            uint32_t mapped_size = 0;
+            auto mapped_pixels = map_image_message(image_data, *mapped_msg, mapped_size);
+            auto msg = mapped_pixels ? mapped_msg : instantiate_msg<sensor_msgs::Image>(image_data);
+            // Compressed depth is decoded into the frame, straight from the mapping when there is one
+            const bool compressed = msg->encoding == RVL_ENCODING;
+            const byte* pixels = mapped_pixels ? mapped_pixels : msg->data.data();
+            const size_t pixels_size = mapped_pixels ? mapped_size : msg->data.size();
             frame_additional_data additional_data{};
             std::chrono::duration<double, std::milli> timestamp_ms(std::chrono::duration<double>(msg->header.stamp.toSec()));
             additional_data.timestamp = timestamp_ms.count();
@@ -451,18 +437,22 @@ namespace librealsense
             {
                 //Version 2 and above
                 stream_id = ros_topic::get_stream_identifier(image_data.getTopic());
-                auto info_topic = ros_topic::frame_metadata_topic(stream_id);
-                get_frame_metadata(m_file, info_topic, stream_id, image_data, additional_data);
+                if (!get_block_frame_metadata(stream_id, image_data, additional_data))
+                {
+                    auto info_topic = ros_topic::frame_metadata_topic(stream_id);
+                    get_frame_metadata(get_topic_index(info_topic), stream_id, image_data, additional_data);
+                }
             }
 
             frame_interface* frame = m_frame_source->alloc_frame((stream_id.stream_type == RS2_STREAM_DEPTH) ? RS2_EXTENSION_DEPTH_FRAME : RS2_EXTENSION_VIDEO_FRAME,
-                msg->data.size(), additional_data, true);
+                compressed ? msg->step * msg->height : 0, additional_data, true);
             if (frame == nullptr)
             {
                 LOG_WARNING("Failed to allocate new frame");
                 return nullptr;
             }
             librealsense::video_frame* video_frame = static_cast<librealsense::video_frame*>(frame);
+            librealsense::frame_holder fh{ video_frame };
             video_frame->assign(msg->width, msg->height, msg->step, msg->step / msg->width * 8);
             rs2_format stream_format;
             convert(msg->encoding, stream_format);
@@ -471,13 +461,60 @@ namespace librealsense
             frame->get_stream()->set_format(stream_format);
             frame->get_stream()->set_stream_index(stream_id.stream_index);
             frame->get_stream()->set_stream_type(stream_id.stream_type);
-            video_frame->data = std::move(msg->data);
-            librealsense::frame_holder fh{ video_frame };
+            if (compressed)
+            {
+                if (!rvl_decode(pixels, pixels_size, reinterpret_cast<uint16_t*>(const_cast<byte*>(video_frame->get_frame_data())), msg->width * msg->height))
+                {
+                    throw io_exception(to_string() << "Failed to decode compressed depth frame " << msg->header.seq << " of " << stream_id);
+                }
+            }
+            else if (mapped_pixels)
+            {
+                auto mapping = m_mapped_file;
+                video_frame->attach_continuation(frame_continuation([mapping]() {}, mapped_pixels));
+            }
+            else
+            {
+                // The frame references the pixels of the message it keeps, as it does those of the mapped file
+                video_frame->attach_continuation(frame_continuation([msg]() {}, msg->data.data()));
+            }
             LOG_DEBUG("Created image frame: " << stream_id << " " << video_frame->get_width() << "x" << video_frame->get_height() << " " << stream_format);
 
             return std::move(fh);
         }
 
+        static std::shared_ptr<mapped_file> map_file(const std::string& path)
+        {
+            try
+            {
+                return std::make_shared<mapped_file>(path);
+            }
+            catch (const std::exception& e)
+            {
+                LOG_WARNING("Playback frames will be copied from the file: " << e.what());
+                return nullptr;
+            }
+        }
+
+        /**
+        * Deserializes all but the pixels of an image message stored verbatim in the mapped file
+        * Returns a pointer to the pixels within the mapping and their size, or nullptr if the message must be read from the file
+        */
+        const byte* map_image_message(const rosbag::MessageInstance& image_data, sensor_msgs::Image& msg, uint32_t& pixels_size) const
+        {
+            uint64_t offset;
+            uint32_t size;
+            if (!m_mapped_file || !image_data.getFileRange(offset, size) || offset + size > m_mapped_file->size())
+                return nullptr;
+
+            rs2rosinternal::serialization::IStream stream(const_cast<uint8_t*>(m_mapped_file->data() + offset), size);
+            stream >> msg.header >> msg.height >> msg.width >> msg.encoding >> msg.is_bigendian >> msg.step;
+            stream >> pixels_size;
+            if (pixels_size == 0 || pixels_size != stream.getLength())
+                return nullptr;
+            return stream.getData();
+        }
+
         frame_holder create_motion_sample(const rosbag::MessageInstance &motion_data) const
         {
             LOG_DEBUG("Trying to create a motion frame from message");
@@ -501,8 +538,11 @@ namespace librealsense
             {
                 //Version 2 and above
                 stream_id = ros_topic::get_stream_identifier(motion_data.getTopic());
-                auto info_topic = ros_topic::frame_metadata_topic(stream_id);
-                get_frame_metadata(m_file, info_topic, stream_id, motion_data, additional_data);
+                if (!get_block_frame_metadata(stream_id, motion_data, additional_data))
+                {
+                    auto info_topic = ros_topic::frame_metadata_topic(stream_id);
+                    get_frame_metadata(get_topic_index(info_topic), stream_id, motion_data, additional_data);
+                }
             }
 
             frame_interface* frame = m_frame_source->alloc_frame(RS2_EXTENSION_MOTION_FRAME, 3 * sizeof(float), additional_data, true);
@@ -586,14 +626,16 @@ namespace librealsense
 
                 auto stream_id = ros_topic::get_stream_identifier(msg.getTopic());
                 std::string accel_topic = ros_topic::pose_accel_topic(stream_id);
-                rosbag::View accel_view(m_file, rosbag::TopicQuery(accel_topic), msg.getTime(), msg.getTime());
-                assert(accel_view.size() == 1);
-                auto accel_msg = instantiate_msg<geometry_msgs::Accel>(*accel_view.begin());
-                
+                auto accel_msgs = get_topic_index(accel_topic).getMessages(msg.getTime());
+                if (accel_msgs.size() != 1)
+                    throw io_exception(to_string() << "Invalid file format, expected a single message at " << msg.getTime() << " (Topic: " << accel_topic << ")");
+                auto accel_msg = instantiate_msg<geometry_msgs::Accel>(accel_msgs.front());
+
                 std::string twist_topic = ros_topic::pose_twist_topic(stream_id);
-                rosbag::View twist_view(m_file, rosbag::TopicQuery(twist_topic), msg.getTime(), msg.getTime());
-                assert(twist_view.size() == 1);
-                auto twist_msg = instantiate_msg<geometry_msgs::Twist>(*twist_view.begin());
+                auto twist_msgs = get_topic_index(twist_topic).getMessages(msg.getTime());
+                if (twist_msgs.size() != 1)
+                    throw io_exception(to_string() << "Invalid file format, expected a single message at " << msg.getTime() << " (Topic: " << twist_topic << ")");
+                auto twist_msg = instantiate_msg<geometry_msgs::Twist>(twist_msgs.front());
 
                 pose.rotation             = to_float4(transform_msg->rotation);
                 pose.translation          = to_float3(transform_msg->translation);
@@ -621,7 +663,9 @@ namespace librealsense
                 //Version 2 and above
                 stream_id = ros_topic::get_stream_identifier(msg.getTopic());
                 auto info_topic = ros_topic::frame_metadata_topic(stream_id);
-                auto remaining = get_frame_metadata(m_file, info_topic, stream_id, msg, additional_data);
+                auto remaining = get_frame_metadata(get_topic_index(info_topic), stream_id, msg, additional_data);
+                //Pose specific values are always written as KeyValue messages, next to the metadata block if there is one
+                get_block_frame_metadata(stream_id, msg, additional_data);
                 for (auto&& kvp : remaining)
                 {
                     if (kvp.first == MAPPER_CONFIDENCE_MD_STR)
@@ -1044,10 +1088,11 @@ namespace librealsense
                         << "(Topic: " << infos_msg.getTopic() << ")");
                 }
             }
-            std::unique_ptr<rosbag::View> entire_bag = std::unique_ptr<rosbag::View>(new rosbag::View(m_file, rosbag::View::TrueQuery()));
+            // The topics are known from the index, the bag is not read
             std::vector<uint32_t> indices;
-            for (auto&& topic : get_topics(entire_bag))
+            for (auto&& topic_index : m_topic_indexes)
             {
+                auto& topic = topic_index.first;
                 std::regex r(R"RRR(/camera/rs_6DoF(\d+)/\d+)RRR");
                 std::smatch sm;
                 if(std::regex_search(topic, sm, r))
@@ -1221,6 +1266,35 @@ namespace librealsense
             return options;
         }
 
+        //Looks the frame up in the stream's columnar metadata, returns false if the stream has none for it
+        bool get_block_frame_metadata(const stream_identifier& stream_id, const rosbag::MessageInstance& msg, frame_additional_data& additional_data) const
+        {
+            auto& index = get_topic_index(ros_topic::frame_metadata_block_topic(stream_id));
+            if (index.size() == 0)
+                return false;
+
+            //Each block is written at the time of its first frame
+            auto block_msg = index.getLastMessage(rs2rosinternal::TIME_MIN, msg.getTime());
+            if (!block_msg)
+                return false;
+
+            auto& cached = m_metadata_blocks[stream_id];
+            if (!cached.second || cached.first != block_msg->getTime())
+            {
+                auto data = instantiate_msg<std_msgs::UInt8MultiArray>(*block_msg);
+                cached.first = block_msg->getTime();
+                cached.second = std::make_shared<metadata_block>(metadata_block::deserialize(data->data));
+            }
+            return cached.second->find(msg.getTime().toNSec(), additional_data);
+        }
+
+        const rosbag::TopicIndex& get_topic_index(const std::string& topic) const
+        {
+            static const rosbag::TopicIndex empty_index;
+            auto it = m_topic_indexes.find(topic);
+            return it != m_topic_indexes.end() ? it->second : empty_index;
+        }
+
         static std::vector<std::string> get_topics(std::unique_ptr<rosbag::View>& view)
         {
             std::vector<std::string> topics;
@@ -1240,6 +1314,9 @@ namespace librealsense
         std::unique_ptr<rosbag::View>           m_samples_view;
         rosbag::View::iterator                  m_samples_itrator;
         std::vector<std::string>                m_enabled_streams_topics;
+        std::map<std::string, rosbag::TopicIndex> m_topic_indexes;
+        std::shared_ptr<mapped_file>            m_mapped_file;
+        mutable std::map<stream_identifier, std::pair<rs2rosinternal::Time, std::shared_ptr<metadata_block>>> m_metadata_blocks; //Last block read of each stream
         std::shared_ptr<metadata_parser_map>    m_metadata_parser_map;
         std::shared_ptr<context>                m_context;
         uint32_t                                m_version;
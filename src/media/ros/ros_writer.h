@@ -7,6 +7,7 @@
 #include <memory>
 #include <iomanip>
 #include <ios>      //For std::hexfloat
+#include <thread>
 #include "core/debug.h"
 #include "core/serialization.h"
 #include "archive.h"
@@ -14,6 +15,77 @@
 #include "stream.h"
 #include "rosbag/bag.h"
 #include "ros_file_format.h"
+#include "proc/rvl-codec.h"
+
+namespace librealsense
+{
+    // A sensor_msgs::Image whose data stays in the frame, serialized the same way so the recorded messages are
+    // sensor_msgs/Image, without copying the pixels into the message first
+    struct image_view
+    {
+        std_msgs::Header header;
+        uint32_t height = 0;
+        uint32_t width = 0;
+        std::string encoding;
+        uint8_t is_bigendian = 0;
+        uint32_t step = 0;
+        const uint8_t* data = nullptr;
+        uint32_t size = 0;
+    };
+}
+
+namespace rs2rosinternal
+{
+    namespace message_traits
+    {
+        template<> struct IsMessage<librealsense::image_view> : TrueType {};
+        template<> struct HasHeader<librealsense::image_view> : TrueType {};
+
+        template<> struct MD5Sum<librealsense::image_view>
+        {
+            static const char* value() { return MD5Sum<sensor_msgs::Image>::value(); }
+            static const char* value(const librealsense::image_view&) { return value(); }
+        };
+
+        template<> struct DataType<librealsense::image_view>
+        {
+            static const char* value() { return DataType<sensor_msgs::Image>::value(); }
+            static const char* value(const librealsense::image_view&) { return value(); }
+        };
+
+        template<> struct Definition<librealsense::image_view>
+        {
+            static const char* value() { return Definition<sensor_msgs::Image>::value(); }
+            static const char* value(const librealsense::image_view&) { return value(); }
+        };
+    }
+
+    namespace serialization
+    {
+        // Only written, the reader gets back a sensor_msgs::Image
+        template<> struct Serializer<librealsense::image_view>
+        {
+            template<typename Stream> inline static void write(Stream& stream, const librealsense::image_view& m)
+            {
+                stream.next(m.header);
+                stream.next(m.height);
+                stream.next(m.width);
+                stream.next(m.encoding);
+                stream.next(m.is_bigendian);
+                stream.next(m.step);
+                stream.next(m.size);
+                if (m.size)
+                    memcpy(stream.advance(m.size), m.data, m.size);
+            }
+
+            inline static uint32_t serializedLength(const librealsense::image_view& m)
+            {
+                return serializationLength(m.header) + serializationLength(m.encoding) +
+                    4 * sizeof(uint32_t) + sizeof(uint8_t) + m.size;
+            }
+        };
+    }
+}
 
 namespace librealsense
 {
@@ -22,17 +94,31 @@ namespace librealsense
     class ros_writer: public writer
     {
     public:
-        explicit ros_writer(const std::string& file, bool compress_while_record) : m_file_path(file)
+        explicit ros_writer(const std::string& file, bool compress_while_record) : m_file_path(file), m_compress_while_record(compress_while_record), m_columnar_metadata(false)
         {
             LOG_INFO("Compression while record is set to " << (compress_while_record ? "ON" : "OFF"));
             m_bag.open(file, rosbag::BagMode::Write);
             if (compress_while_record)
             {
                 m_bag.setCompression(rosbag::CompressionType::LZ4);
+                //Chunks are compressed by a pool of workers and written in order, so the write thread only does the I/O
+                m_bag.setCompressionThreads(std::max(1u, std::min(8u, std::thread::hardware_concurrency() / 2)));
             }
             write_file_version();
         }
 
+        ~ros_writer()
+        {
+            try
+            {
+                write_metadata_blocks();
+            }
+            catch (const std::exception& e)
+            {
+                LOG_ERROR("Failed to write frame metadata to file. Exception: " << e.what());
+            }
+        }
+
         void write_device_description(const librealsense::device_snapshot& device_description) override
         {
             for (auto&& device_extension_snapshot : device_description.get_device_extensions_snapshots().get_snapshots())
@@ -85,6 +171,36 @@ namespace librealsense
             return m_file_path;
         }
 
+        void set_chunk_size(uint32_t bytes) override
+        {
+            //Messages are buffered in the open chunk and flushed to disk (and compressed) once it reaches this size
+            m_bag.setChunkThreshold(bytes);
+        }
+
+        void set_columnar_metadata(bool enable) override
+        {
+            //Frames keep the format their metadata was written in, readers look for both
+            if (!enable)
+            {
+                write_metadata_blocks();
+            }
+            m_columnar_metadata = enable;
+        }
+
+        void set_stream_compression(rs2_stream stream, uint32_t index, bool enable) override
+        {
+            //Takes effect from the next frame of the stream, frames of one stream may be stored both ways
+            if (enable)
+                m_compressed_streams.insert({ stream, index });
+            else
+                m_compressed_streams.erase({ stream, index });
+        }
+
+        std::shared_ptr<writer> create_segment(const std::string& file) const override
+        {
+            return std::make_shared<ros_writer>(file, m_compress_while_record);
+        }
+
     private:
         void write_file_version()
         {
@@ -96,6 +212,12 @@ namespace librealsense
 
         void write_frame_metadata(const stream_identifier& stream_id, const nanoseconds& timestamp, frame_interface* frame)
         {
+            if (m_columnar_metadata)
+            {
+                add_to_metadata_block(stream_id, timestamp, frame);
+                return;
+            }
+
             auto metadata_topic = ros_topic::frame_metadata_topic(stream_id);
             diagnostic_msgs::KeyValue system_time;
             system_time.key = SYSTEM_TIME_MD_STR;
@@ -121,6 +243,56 @@ namespace librealsense
             }
         }
 
+        void add_to_metadata_block(const stream_identifier& stream_id, const nanoseconds& timestamp, frame_interface* frame)
+        {
+            std::vector<std::pair<rs2_frame_metadata_value, rs2_metadata_type>> values;
+            for (int i = 0; i < static_cast<rs2_frame_metadata_value>(rs2_frame_metadata_value::RS2_FRAME_METADATA_COUNT); i++)
+            {
+                rs2_frame_metadata_value type = static_cast<rs2_frame_metadata_value>(i);
+                if (frame->supports_frame_metadata(type))
+                {
+                    values.emplace_back(type, frame->get_frame_metadata(type));
+                }
+            }
+
+            //Blocks are looked up by the time of their first frame, and hold frames in ascending time order
+            auto time = to_rostime(timestamp).toNSec();
+            auto& block = m_metadata_blocks[stream_id];
+            if (block.second.size() > 0 && time < block.second.last_time())
+            {
+                write_metadata_block(stream_id);
+            }
+            if (block.second.size() == 0)
+            {
+                block.first = timestamp;
+            }
+            block.second.add(time, frame->get_frame_system_time(), frame->get_frame_timestamp_domain(), values);
+            if (block.second.size() >= FRAMES_PER_METADATA_BLOCK)
+            {
+                write_metadata_block(stream_id);
+            }
+        }
+
+        void write_metadata_block(const stream_identifier& stream_id)
+        {
+            auto& block = m_metadata_blocks[stream_id];
+            std_msgs::UInt8MultiArray msg;
+            msg.data = block.second.serialize();
+            block.second = metadata_block();
+            write_message(ros_topic::frame_metadata_block_topic(stream_id), block.first, msg);
+        }
+
+        void write_metadata_blocks()
+        {
+            for (auto&& block : m_metadata_blocks)
+            {
+                if (block.second.second.size() > 0)
+                {
+                    write_metadata_block(block.first);
+                }
+            }
+        }
+
         void write_extrinsics(const stream_identifier& stream_id, frame_interface* frame)
         {
             if (m_extrinsics_msgs.find(stream_id) != m_extrinsics_msgs.end())
@@ -178,18 +350,34 @@ namespace librealsense
 
         void write_video_frame(const stream_identifier& stream_id, const nanoseconds& timestamp, frame_holder&& frame)
         {
-            sensor_msgs::Image image;
+            image_view image;
+            std::vector<uint8_t> compressed;
             auto vid_frame = dynamic_cast<librealsense::video_frame*>(frame.frame);
             assert(vid_frame != nullptr);
 
             image.width = static_cast<uint32_t>(vid_frame->get_width());
             image.height = static_cast<uint32_t>(vid_frame->get_height());
             image.step = static_cast<uint32_t>(vid_frame->get_stride());
-            convert(vid_frame->get_stream()->get_format(), image.encoding);
+            auto format = vid_frame->get_stream()->get_format();
+            convert(format, image.encoding);
             image.is_bigendian = is_big_endian();
             auto size = vid_frame->get_stride() * vid_frame->get_height();
             auto p_data = vid_frame->get_frame_data();
-            image.data.assign(p_data, p_data + size);
+            if (format == RS2_FORMAT_Z16 && image.step == image.width * sizeof(uint16_t) &&
+                m_compressed_streams.count({ stream_id.stream_type, stream_id.stream_index }))
+            {
+                //Only the encoding tells the message apart, the image keeps its dimensions and step
+                image.encoding = RVL_ENCODING;
+                rvl_encode(reinterpret_cast<const uint16_t*>(p_data), image.width * image.height, compressed);
+                image.data = compressed.data();
+                image.size = static_cast<uint32_t>(compressed.size());
+            }
+            else
+            {
+                // Serialized straight from the frame, which is held until the message is written
+                image.data = p_data;
+                image.size = static_cast<uint32_t>(size);
+            }
             image.header.seq = static_cast<uint32_t>(vid_frame->get_frame_number());
             std::chrono::duration<double, std::milli> timestamp_ms(vid_frame->get_frame_timestamp());
             image.header.stamp = rs2rosinternal::Time(std::chrono::duration<double>(timestamp_ms).count());
@@ -524,7 +712,12 @@ namespace librealsense
         }
 
         std::map<stream_identifier, geometry_msgs::Transform> m_extrinsics_msgs;
+        static const size_t FRAMES_PER_METADATA_BLOCK = 64;
+        bool m_columnar_metadata;
+        std::set<std::pair<rs2_stream, uint32_t>> m_compressed_streams;
+        std::map<stream_identifier, std::pair<nanoseconds, metadata_block>> m_metadata_blocks; //Metadata of the frames not written yet, per stream
         std::string m_file_path;
+        bool m_compress_while_record;
         rosbag::Bag m_bag;
         std::map<uint32_t, std::set<rs2_option>> m_written_options_descriptions;
     };
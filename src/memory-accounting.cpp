@@ -0,0 +1,104 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#include "memory-accounting.h"
+#include "types.h"
+
+#include <algorithm>
+
+namespace librealsense
+{
+    memory_account::memory_account(std::shared_ptr<memory_account> parent)
+        : _parent(std::move(parent))
+    {
+    }
+
+    std::shared_ptr<memory_account> memory_account::global()
+    {
+        static auto root = std::shared_ptr<memory_account>(new memory_account(root_tag{}));
+        return root;
+    }
+
+    void memory_account::update(int64_t in_use, int64_t pooled)
+    {
+        for (auto account = this; account; account = account->_parent.get())
+        {
+            if (in_use) account->_in_use.fetch_add(in_use, std::memory_order_relaxed);
+            if (pooled) account->_pooled.fetch_add(pooled, std::memory_order_relaxed);
+        }
+    }
+
+    void memory_account::drop()
+    {
+        for (auto account = this; account; account = account->_parent.get())
+            account->_dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    memory_account::usage memory_account::get_usage() const
+    {
+        // The counters are updated one after the other, a reading may briefly count a buffer in neither or both
+        usage result;
+        result.in_use = static_cast<uint64_t>(std::max<int64_t>(0, _in_use.load(std::memory_order_relaxed)));
+        result.pooled = static_cast<uint64_t>(std::max<int64_t>(0, _pooled.load(std::memory_order_relaxed)));
+        result.dropped = _dropped.load(std::memory_order_relaxed);
+        return result;
+    }
+
+    memory_budget& memory_budget::instance()
+    {
+        static memory_budget budget;
+        return budget;
+    }
+
+    void memory_budget::set_limit(uint64_t bytes)
+    {
+        _limit = bytes;
+        if (bytes && !fits(0))
+        {
+            // Frees what it can right away, the frames alive are only released by their owners
+            reserve(0);
+        }
+    }
+
+    bool memory_budget::fits(size_t bytes) const
+    {
+        auto limit = _limit.load();
+        if (!limit)
+            return true;
+        auto usage = memory_account::global()->get_usage();
+        return usage.in_use + usage.pooled + bytes <= limit;
+    }
+
+    bool memory_budget::reserve(size_t bytes)
+    {
+        if (fits(bytes))
+            return true;
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (fits(bytes))
+            return true;
+
+        size_t freed = 0;
+        for (auto trimmer : _trimmers)
+        {
+            freed += trimmer->trim();
+            if (fits(bytes))
+                break;
+        }
+        if (freed)
+            LOG_DEBUG("Memory budget: freed " << freed << " bytes of pooled frame buffers");
+        return fits(bytes);
+    }
+
+    void memory_budget::add(memory_trimmer* trimmer)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _trimmers.push_back(trimmer);
+    }
+
+    void memory_budget::remove(memory_trimmer* trimmer)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _trimmers.erase(std::remove(_trimmers.begin(), _trimmers.end(), trimmer), _trimmers.end());
+    }
+}
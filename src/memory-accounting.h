@@ -0,0 +1,82 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace librealsense
+{
+    // Frame memory held by part of the library, such as a sensor or a context. Every change is added to the
+    // parent account as well, up to the process-wide account the memory budget applies to
+    class memory_account
+    {
+    public:
+        struct usage
+        {
+            uint64_t in_use = 0;    // bytes of the frames that are alive
+            uint64_t pooled = 0;    // bytes of the buffers kept for reuse
+            uint64_t dropped = 0;   // frames dropped because the budget ran out
+        };
+
+        explicit memory_account(std::shared_ptr<memory_account> parent = global());
+
+        // The root of all the accounts
+        static std::shared_ptr<memory_account> global();
+
+        void update(int64_t in_use, int64_t pooled);
+        void drop();
+
+        usage get_usage() const;
+
+    private:
+        struct root_tag {};
+        explicit memory_account(root_tag) {}
+
+        std::shared_ptr<memory_account> _parent;
+        std::atomic<int64_t> _in_use{ 0 };
+        std::atomic<int64_t> _pooled{ 0 };
+        std::atomic<uint64_t> _dropped{ 0 };
+    };
+
+    // Memory a holder of reusable buffers can give back
+    class memory_trimmer
+    {
+    public:
+        // Frees what it can, returns the bytes freed
+        virtual size_t trim() = 0;
+        virtual ~memory_trimmer() = default;
+    };
+
+    // Process-wide limit of the frame memory. Before a new buffer would take the usage beyond the limit, the buffers
+    // kept for reuse are freed, and the frame is dropped only when that wasn't enough. The limit is soft, concurrent
+    // allocations may exceed it by the size of a few frames
+    class memory_budget
+    {
+    public:
+        static memory_budget& instance();
+
+        // 0 lifts the limit
+        void set_limit(uint64_t bytes);
+        uint64_t get_limit() const { return _limit; }
+
+        // Whether a new buffer of the size fits, trimming the registered holders when it doesn't
+        bool reserve(size_t bytes);
+
+        void add(memory_trimmer* trimmer);
+        void remove(memory_trimmer* trimmer);
+
+    private:
+        memory_budget() : _limit(0) {}
+
+        bool fits(size_t bytes) const;
+
+        std::atomic<uint64_t> _limit;
+        std::mutex _mutex;
+        std::vector<memory_trimmer*> _trimmers;
+    };
+}
@@ -7,6 +7,7 @@
 #include <algorithm>
 #include "types.h"
 #include <iostream>
+#include <lz4.h>
 
 using namespace std;
 using namespace sql;
@@ -17,6 +18,8 @@ const char* CONFIG_CREATE = "CREATE TABLE rs_config(section NUMBER, key TEXT, va
 const char* CONFIG_INSERT = "INSERT OR REPLACE INTO rs_config(section, key, value) VALUES(?, ?, ?)";
 const char* API_VERSION_KEY = "api_version";
 const char* CREATED_AT_KEY = "created_at";
+const char* BLOB_COMPRESSION_KEY = "blob_compression";
+const char* BLOB_COMPRESSION_LZ4 = "lz4";
 
 const char* SECTIONS_TABLE = "rs_sections";
 const char* SECTIONS_SELECT_MAX_ID = "SELECT max(key) from rs_sections";
@@ -145,6 +148,48 @@ namespace librealsense
             return results;
         }
 
+        // Blobs of sections saved with blob compression are stored as their size (uint32_t) followed by the LZ4 compressed data.
+        // Unlike compression_algorithm, which approximates frame pixels, this is lossless and applies to every blob
+        static vector<uint8_t> compress_blob(const vector<uint8_t>& blob)
+        {
+            auto size = static_cast<uint32_t>(blob.size());
+            vector<uint8_t> result(sizeof(size) + LZ4_compressBound(static_cast<int>(size)));
+            librealsense::copy(result.data(), &size, sizeof(size));
+            auto compressed = LZ4_compress_default(reinterpret_cast<const char*>(blob.data()), reinterpret_cast<char*>(result.data() + sizeof(size)),
+                static_cast<int>(size), static_cast<int>(result.size() - sizeof(size)));
+            if (size > 0 && compressed <= 0)
+                throw runtime_error("Failed to compress recording blob");
+            result.resize(sizeof(size) + compressed);
+            return result;
+        }
+
+        static vector<uint8_t> decompress_blob(const vector<uint8_t>& blob)
+        {
+            uint32_t size = 0;
+            if (blob.size() < sizeof(size))
+                throw runtime_error("Invalid recording, truncated blob");
+            librealsense::copy(&size, blob.data(), sizeof(size));
+            vector<uint8_t> result(size);
+            auto decompressed = LZ4_decompress_safe(reinterpret_cast<const char*>(blob.data() + sizeof(size)), reinterpret_cast<char*>(result.data()),
+                static_cast<int>(blob.size() - sizeof(size)), static_cast<int>(size));
+            if (decompressed != static_cast<int>(size))
+                throw runtime_error("Invalid recording, corrupted blob");
+            return result;
+        }
+
+        static string get_config_value(const connection& c, int section_id, const char* key)
+        {
+            auto&& query = c.cached_statement(CONFIG_QUERY);
+            query.bind(1, section_id);
+            query.bind(2, key);
+            string value;
+            for (auto&& row : query)
+            {
+                value = row[0].get_string();
+            }
+            return value;
+        }
+
         recording::recording(std::shared_ptr<time_service> ts, std::shared_ptr<playback_device_watcher> watcher)
             :_ts(ts), _watcher(watcher)
         {
@@ -173,87 +218,102 @@ namespace librealsense
             connection c(filename);
             LOG_WARNING("Saving recording to file, don't close the application");
 
-            if (!c.table_exists(CONFIG_TABLE))
+            // The whole recording is written in a single transaction, with the write-ahead log sparing most of the syncs
+            c.execute("PRAGMA journal_mode=WAL");
+            c.execute("PRAGMA synchronous=NORMAL");
+
+            c.transaction([&]()
             {
-                c.execute(SECTIONS_CREATE);
-                c.execute(CONFIG_CREATE);
-                c.execute(CALLS_CREATE);
-                c.execute(DEVICE_INFO_CREATE);
-                c.execute(BLOBS_CREATE);
-                c.execute(PROFILES_CREATE);
-            }
+                if (!c.table_exists(CONFIG_TABLE))
+                {
+                    c.execute(SECTIONS_CREATE);
+                    c.execute(CONFIG_CREATE);
+                    c.execute(CALLS_CREATE);
+                    c.execute(DEVICE_INFO_CREATE);
+                    c.execute(BLOBS_CREATE);
+                    c.execute(PROFILES_CREATE);
+                }
 
-            auto section_id = 0;
+                auto section_id = 0;
 
-            if (!append)
-            {
+                if (!append)
                 {
-                    statement check_section_unique(c, SECTIONS_COUNT_BY_NAME);
-                    check_section_unique.bind(1, section);
-                    auto result = check_section_unique();
-                    if (result[0].get_int() > 0)
                     {
-                        throw runtime_error(to_string() << "Append record - can't save over existing section in file " << filename << "!");
+                        statement check_section_unique(c, SECTIONS_COUNT_BY_NAME);
+                        check_section_unique.bind(1, section);
+                        auto result = check_section_unique();
+                        if (result[0].get_int() > 0)
+                        {
+                            throw runtime_error(to_string() << "Append record - can't save over existing section in file " << filename << "!");
+                        }
                     }
-                }
 
-                {
-                    statement max_section_id(c, SECTIONS_COUNT_ALL);
-                    auto result = max_section_id();
-                    section_id = result[0].get_int() + 1;
-                }
+                    {
+                        statement max_section_id(c, SECTIONS_COUNT_ALL);
+                        auto result = max_section_id();
+                        section_id = result[0].get_int() + 1;
+                    }
 
-                {
-                    statement create_section(c, SECTIONS_INSERT);
-                    create_section.bind(1, section_id);
-                    create_section.bind(2, section);
-                    create_section();
-                }
-            }
-            else
-            {
-                {
-                    statement check_section_exists(c, SECTIONS_COUNT_BY_NAME);
-                    check_section_exists.bind(1, section);
-                    auto result = check_section_exists();
-                    if (result[0].get_int() == 0)
                     {
-                        throw runtime_error(to_string() << "Append record - Could not find section " << section << " in file " << filename << "!");
+                        statement create_section(c, SECTIONS_INSERT);
+                        create_section.bind(1, section_id);
+                        create_section.bind(2, section);
+                        create_section();
                     }
                 }
+                else
                 {
-                    statement find_section_id(c, SECTIONS_FIND_BY_NAME);
-                    find_section_id.bind(1, section);
-                    auto result = find_section_id();
-                    section_id = result[0].get_int();
+                    {
+                        statement check_section_exists(c, SECTIONS_COUNT_BY_NAME);
+                        check_section_exists.bind(1, section);
+                        auto result = check_section_exists();
+                        if (result[0].get_int() == 0)
+                        {
+                            throw runtime_error(to_string() << "Append record - Could not find section " << section << " in file " << filename << "!");
+                        }
+                    }
+                    {
+                        statement find_section_id(c, SECTIONS_FIND_BY_NAME);
+                        find_section_id.bind(1, section);
+                        auto result = find_section_id();
+                        section_id = result[0].get_int();
+                    }
                 }
-            }
 
-            if (!append)
-            {
+                if (!append)
                 {
-                    statement insert(c, CONFIG_INSERT);
-                    insert.bind(1, section_id);
-                    insert.bind(2, API_VERSION_KEY);
-                    insert.bind(3, RS2_API_VERSION_STR);
-                    insert();
-                }
+                    {
+                        statement insert(c, CONFIG_INSERT);
+                        insert.bind(1, section_id);
+                        insert.bind(2, API_VERSION_KEY);
+                        insert.bind(3, RS2_API_VERSION_STR);
+                        insert();
+                    }
 
-                {
-                    statement insert(c, CONFIG_INSERT);
-                    insert.bind(1, section_id);
-                    insert.bind(2, CREATED_AT_KEY);
-                    auto datetime = datetime_string();
-                    insert.bind(3, datetime.c_str());
-                    insert();
+                    {
+                        statement insert(c, CONFIG_INSERT);
+                        insert.bind(1, section_id);
+                        insert.bind(2, CREATED_AT_KEY);
+                        auto datetime = datetime_string();
+                        insert.bind(3, datetime.c_str());
+                        insert();
+                    }
+
+                    {
+                        statement insert(c, CONFIG_INSERT);
+                        insert.bind(1, section_id);
+                        insert.bind(2, BLOB_COMPRESSION_KEY);
+                        insert.bind(3, BLOB_COMPRESSION_LZ4);
+                        insert();
+                    }
                 }
-            }
 
-            c.transaction([&]()
-            {
+                // Appending keeps the blob format the section was created with
+                auto compress_blobs = get_config_value(c, section_id, BLOB_COMPRESSION_KEY) == BLOB_COMPRESSION_LZ4;
+
                 for (auto&& cl : calls)
                 {
-                    statement insert(c, CALLS_INSERT);
+                    auto&& insert = c.cached_statement(CALLS_INSERT);
                     insert.bind(1, section_id);
                     insert.bind(2, static_cast<int>(cl.type));
                     insert.bind(3, cl.timestamp);
@@ -278,7 +338,7 @@ namespace librealsense
 
                 for (auto&& uvc_info : uvc_device_infos)
                 {
-                    statement insert(c, DEVICE_INFO_INSERT);
+                    auto&& insert = c.cached_statement(DEVICE_INFO_INSERT);
                     insert.bind(1, section_id);
                     insert.bind(2, (int)device_type::uvc);
                     insert.bind(3, "");
@@ -291,7 +351,7 @@ namespace librealsense
 
                 for (auto&& usb_info : usb_device_infos)
                 {
-                    statement insert(c, DEVICE_INFO_INSERT);
+                    auto&& insert = c.cached_statement(DEVICE_INFO_INSERT);
                     insert.bind(1, section_id);
                     insert.bind(2, (int)device_type::usb);
                     string id(usb_info.id.begin(), usb_info.id.end());
@@ -305,7 +365,7 @@ namespace librealsense
 
                 for (auto&& hid_info : hid_device_infos)
                 {
-                    statement insert(c, DEVICE_INFO_INSERT);
+                    auto&& insert = c.cached_statement(DEVICE_INFO_INSERT);
                     insert.bind(1, section_id);
                     insert.bind(2, (int)device_type::hid);
                     insert.bind(3, hid_info.id.c_str());
@@ -325,7 +385,7 @@ namespace librealsense
 
                 for (auto&& hid_info : hid_sensors)
                 {
-                    statement insert(c, DEVICE_INFO_INSERT);
+                    auto&& insert = c.cached_statement(DEVICE_INFO_INSERT);
                     insert.bind(1, section_id);
                     insert.bind(2, (int)device_type::hid_sensor);
                     insert.bind(3, hid_info.name.c_str());
@@ -335,7 +395,7 @@ namespace librealsense
 
                 for (auto&& hid_info : hid_sensor_inputs)
                 {
-                    statement insert(c, DEVICE_INFO_INSERT);
+                    auto&& insert = c.cached_statement(DEVICE_INFO_INSERT);
                     insert.bind(1, section_id);
                     insert.bind(2, (int)device_type::hid_input);
                     insert.bind(3, hid_info.name.c_str());
@@ -345,7 +405,7 @@ namespace librealsense
 
                 for (auto&& profile : this->stream_profiles)
                 {
-                    statement insert(c, PROFILES_INSERT);
+                    auto&& insert = c.cached_statement(PROFILES_INSERT);
                     insert.bind(1, section_id);
                     insert.bind(2, (int)profile.width);
                     insert.bind(3, (int)profile.height);
@@ -356,10 +416,19 @@ namespace librealsense
 
                 for (auto&& blob : blobs)
                 {
-                    statement insert(c, BLOBS_INSERT);
+                    auto&& insert = c.cached_statement(BLOBS_INSERT);
                     insert.bind(1, section_id);
-                    insert.bind(2, blob);
-                    insert();
+                    if (compress_blobs)
+                    {
+                        auto compressed = compress_blob(blob);
+                        insert.bind(2, compressed);
+                        insert();
+                    }
+                    else
+                    {
+                        insert.bind(2, blob);
+                        insert();
+                    }
                 }
             });
         }
@@ -521,17 +590,34 @@ namespace librealsense
                 result->stream_profiles.push_back(p);
             }
 
+            auto compressed_blobs = get_config_value(c, section_id, BLOB_COMPRESSION_KEY) == BLOB_COMPRESSION_LZ4;
+
             statement select_blobs(c, BLOBS_SELECT_ALL);
             select_blobs.bind(1, section_id);
 
             for (auto&& row : select_blobs)
             {
-                result->blobs.push_back(row[1].get_blob());
+                if (compressed_blobs)
+                    result->blobs.push_back(decompress_blob(row[1].get_blob()));
+                else
+                    result->blobs.push_back(row[1].get_blob());
             }
 
+            result->build_index();
             return result;
         }
 
+        void recording::build_index()
+        {
+            _entity_calls.clear();
+            _typed_calls.clear();
+            for (size_t i = 0; i < calls.size(); i++)
+            {
+                _entity_calls[calls[i].entity_id].push_back(i);
+                _typed_calls[{ calls[i].entity_id, calls[i].type }].push_back(i);
+            }
+        }
+
         int recording::save_blob(const void* ptr, size_t size)
         {
             lock_guard<recursive_mutex> lock(_mutex);
@@ -539,7 +625,7 @@ namespace librealsense
             holder.resize(size);
             librealsense::copy(holder.data(), ptr, size);
             auto id = static_cast<int>(blobs.size());
-            blobs.push_back(holder);
+            blobs.push_back(move(holder));
             return id;
         }
 
@@ -552,32 +638,32 @@ namespace librealsense
         {
             lock_guard<recursive_mutex> lock(_mutex);
 
-
-            for (size_t i = 1; i <= calls.size(); i++)
+            // The first call of the type after the cursor, wrapping around to the start of the recording
+            auto typed = _typed_calls.find({ entity_id, t });
+            if (typed != _typed_calls.end())
             {
-                const auto idx = (_cursors[entity_id] + i) % static_cast<int>(calls.size());
-                if (calls[idx].type == t && calls[idx].entity_id == entity_id)
+                auto&& indexes = typed->second;
+                auto it = std::upper_bound(indexes.begin(), indexes.end(), _cursors[entity_id]);
+                const auto idx = it != indexes.end() ? *it : indexes.front();
+                if (calls[idx].had_error)
                 {
-                    if (calls[idx].had_error)
-                    {
-                        throw runtime_error(calls[idx].inline_string);
-                    }
-                    _curr_time = calls[idx].timestamp;
+                    throw runtime_error(calls[idx].inline_string);
+                }
+                _curr_time = calls[idx].timestamp;
 
-                    if (!history_match_validation(calls[idx]))
-                    {
-                        throw playback_backend_exception("Recording history mismatch!", t, entity_id);
-                    }
+                if (!history_match_validation(calls[idx]))
+                {
+                    throw playback_backend_exception("Recording history mismatch!", t, entity_id);
+                }
 
-                    _cursors[entity_id] = _cycles[entity_id] = idx;
+                _cursors[entity_id] = _cycles[entity_id] = idx;
 
-                    auto next = pick_next_call();
-                    if (next && t != call_type::device_watcher_event && next->type == call_type::device_watcher_event)
-                    {
-                        invoke_device_changed_event();
-                    }
-                    return calls[idx];
+                auto next = pick_next_call();
+                if (next && t != call_type::device_watcher_event && next->type == call_type::device_watcher_event)
+                {
+                    invoke_device_changed_event();
                 }
+                return calls[idx];
             }
             throw runtime_error("The recording is missing the part you are trying to playback!");
         }
@@ -599,28 +685,26 @@ namespace librealsense
                 invoke_device_changed_event();
             }
 
-            for (size_t i = 1; i <= calls.size(); i++)
+            // The next call of the entity, the cycle starts over from the cursor at the end of the recording or
+            // on a call of another type
+            auto entity = _entity_calls.find(id);
+            if (entity == _entity_calls.end())
             {
-                const auto idx = (_cycles[id] + i);
-                 if (idx >= calls.size())
-                 {
-                     _cycles[id] = _cursors[id];
-                     return nullptr;
-                 }
-
-                if (calls[idx].type == t && calls[idx].entity_id == id)
-                {
-                    _cycles[id] = idx;
-                    _curr_time = calls[idx].timestamp;
-                    return &calls[idx];
-                }
-                if (calls[idx].type != t && calls[idx].entity_id == id)
-                {
-                    _cycles[id] = _cursors[id];
-                    return nullptr;
-                }
+                _cycles[id] = _cursors[id];
+                return nullptr;
+            }
+            auto&& indexes = entity->second;
+            auto it = std::upper_bound(indexes.begin(), indexes.end(), _cycles[id]);
+            if (it == indexes.end() || calls[*it].type != t)
+            {
+                _cycles[id] = _cursors[id];
+                return nullptr;
             }
-            return nullptr;
+
+            const auto idx = *it;
+            _cycles[id] = idx;
+            _curr_time = calls[idx].timestamp;
+            return &calls[idx];
         }
 
         void record_device_watcher::start(device_changed_callback callback)
@@ -1461,14 +1545,14 @@ namespace librealsense
                 auto c_ptr = _rec->cycle_calls(call_type::hid_frame, _entity_id);
                 if (c_ptr)
                 {
-                    auto sd_data = _rec->load_blob(c_ptr->param1);
+                    auto&& sd_data = _rec->load_blob(c_ptr->param1);
                     auto sensor_name = c_ptr->inline_string;
 
                     sensor_data sd;
                     sd.fo.pixels = (void*)sd_data.data();
                     sd.fo.frame_size = sd_data.size();
 
-                    auto metadata = _rec->load_blob(c_ptr->param2);
+                    auto&& metadata = _rec->load_blob(c_ptr->param2);
                     sd.fo.metadata = (void*)metadata.data();
                     sd.fo.metadata_size = static_cast<uint8_t>(metadata.size());
 
@@ -1506,7 +1590,7 @@ namespace librealsense
 
         stream_profile playback_uvc_device::get_profile(call* frame) const
         {
-            auto profile_blob = _rec->load_blob(frame->param1);
+            auto&& profile_blob = _rec->load_blob(frame->param1);
 
             stream_profile p;
             librealsense::copy(&p, profile_blob.data(), sizeof(p));
@@ -1538,8 +1622,9 @@ namespace librealsense
                                 auto p = get_profile(c_ptr);
                                 if(p == pair.first)
                                 {
-                                    vector<uint8_t> frame_blob;
-                                    vector<uint8_t> metadata_blob;
+                                    // Saved frames are handed over from the recording, only the others are made up
+                                    vector<uint8_t> frame_buffer;
+                                    const vector<uint8_t>* frame_blob = &frame_buffer;
 
                                     if (prev_frame_ts > 0 &&
                                         c_ptr->timestamp > prev_frame_ts &&
@@ -1552,21 +1637,21 @@ namespace librealsense
 
                                     if (c_ptr->param3 == 0) // frame was not saved
                                     {
-                                        frame_blob = vector<uint8_t>(c_ptr->param4, 0);
+                                        frame_buffer.assign(c_ptr->param4, 0);
                                     }
                                     else if (c_ptr->param3 == 1)// frame was saved
                                     {
-                                        frame_blob = _rec->load_blob(c_ptr->param2);
+                                        frame_blob = &_rec->load_blob(c_ptr->param2);
                                     }
                                     else
                                     {
-                                        frame_blob = _compression.decode(_rec->load_blob(c_ptr->param2));
+                                        frame_buffer = _compression.decode(_rec->load_blob(c_ptr->param2));
                                     }
 
-                                    metadata_blob = _rec->load_blob(c_ptr->param5);
-                                    frame_object fo{ frame_blob.size(),
+                                    auto&& metadata_blob = _rec->load_blob(c_ptr->param5);
+                                    frame_object fo{ frame_blob->size(),
                                                 static_cast<uint8_t>(metadata_blob.size()), // Metadata is limited to 0xff bytes by design
-                                                frame_blob.data(),metadata_blob.data() };
+                                                frame_blob->data(), metadata_blob.data(), 0, -1 };
 
 
                                     pair.second(p, fo, []() {});
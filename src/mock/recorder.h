@@ -286,7 +286,8 @@ namespace librealsense
                 return load_list(hid_sensors, c);
             }
 
-            std::vector<uint8_t> load_blob(int id) const
+            // The blobs of a loaded recording are not modified, the reference stays valid while it is played back
+            const std::vector<uint8_t>& load_blob(int id) const
             {
                 return blobs[id];
             }
@@ -297,6 +298,10 @@ namespace librealsense
             size_t size() const { return calls.size(); }
 
         private:
+            // Indexes of the calls of every entity, and of every entity and type, in the order of the recording.
+            // Playback looks the calls up there instead of scanning through the calls of all the entities
+            void build_index();
+
             std::vector<call> calls;
             std::vector<std::vector<uint8_t>> blobs;
             std::vector<uvc_device_info> uvc_device_infos;
@@ -313,6 +318,9 @@ namespace librealsense
             std::map<size_t, size_t> _cursors;
             std::map<size_t, size_t> _cycles;
 
+            std::map<int, std::vector<size_t>> _entity_calls;
+            std::map<std::pair<int, call_type>, std::vector<size_t>> _typed_calls;
+
             double get_current_time();
 
             void invoke_device_changed_event();
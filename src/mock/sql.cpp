@@ -72,14 +72,33 @@ namespace sql
         return stmt()[0].get_bool();
     }
 
-    void connection::transaction(std::function<void()> transaction) const
+    statement& connection::cached_statement(const char * sql) const
     {
-        char* errorMessage;
-        sqlite3_exec(m_handle.get(), "BEGIN TRANSACTION", NULL, NULL, &errorMessage);
-
-        transaction();
+        auto&& stmt = m_statements[sql];
+        if (!stmt)
+        {
+            stmt.reset(new statement(*this, sql));
+        }
+        else
+        {
+            stmt->reset();
+        }
+        return *stmt;
+    }
 
-        sqlite3_exec(m_handle.get(), "COMMIT TRANSACTION", NULL, NULL, &errorMessage);
+    void connection::transaction(std::function<void()> transaction) const
+    {
+        execute("BEGIN TRANSACTION");
+        try
+        {
+            transaction();
+        }
+        catch (...)
+        {
+            sqlite3_exec(m_handle.get(), "ROLLBACK TRANSACTION", nullptr, nullptr, nullptr);
+            throw;
+        }
+        execute("COMMIT TRANSACTION");
     }
 
     statement::statement(const connection& conn, const char * sql)
@@ -105,6 +124,12 @@ namespace sql
         throw runtime_error(sqlite3_errmsg(sqlite3_db_handle(m_handle.get())));
     }
 
+    void statement::reset() const
+    {
+        sqlite3_reset(m_handle.get());
+        sqlite3_clear_bindings(m_handle.get());
+    }
+
     int statement::get_int(int const column) const
     {
         return sqlite3_column_int(m_handle.get(), column);
@@ -4,6 +4,8 @@
 #include <vector>
 #include <stdint.h>
 #include <functional>
+#include <map>
+#include <memory>
 
 struct sqlite3;
 struct sqlite3_stmt;
@@ -74,6 +76,7 @@ namespace sql
         statement(const connection& conn, const char * sql);
 
         bool step() const;
+        void reset() const;
 
         int get_int(int column = 0) const;
         double get_double(int column = 0) const;
@@ -148,6 +151,8 @@ namespace sql
     class connection
     {
         connection_handle m_handle;
+        // Declared after the handle, so statements are finalized before the connection is closed
+        mutable std::map<std::string, std::unique_ptr<statement>> m_statements;
 
         friend class statement;
     public:
@@ -157,6 +162,10 @@ namespace sql
 
         bool table_exists(const char* name) const;
 
+        // Statements are prepared once per connection, and returned reset with no parameters bound
+        statement& cached_statement(const char * sql) const;
+
+        // Rolls back and rethrows if the transaction function throws
         void transaction(std::function<void()> transaction) const;
     };
 }
@@ -0,0 +1,200 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#include "numa-allocator.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+#ifdef __linux__
+#include <climits>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace librealsense
+{
+#ifdef __linux__
+    namespace
+    {
+        // From numaif.h, which comes with libnuma rather than with the kernel headers
+        const int mpol_preferred = 1;
+
+        // Single mapping preferring the node, falls back to other nodes rather than failing when it's full
+        void bind_to_node(void* buffer, size_t size, int node)
+        {
+#ifdef SYS_mbind
+            const size_t bits = sizeof(unsigned long) * 8;
+            std::vector<unsigned long> mask(node / bits + 1, 0);
+            mask[node / bits] |= 1ul << (node % bits);
+            if (syscall(SYS_mbind, buffer, size, mpol_preferred, mask.data(), mask.size() * bits + 1, 0) != 0)
+                LOG_WARNING("Could not bind frame buffer to NUMA node " << node << ", error " << errno);
+#else
+            (void)buffer; (void)size; (void)node;
+#endif
+        }
+    }
+
+    int get_numa_node(const std::string& device_path)
+    {
+        char real_path[PATH_MAX];
+        if (!realpath(device_path.c_str(), real_path))
+            return -1;
+
+        // The node is reported by the PCI device of the USB controller, up the tree from the device nodes
+        std::string path(real_path);
+        while (path.size() > 1)
+        {
+            int node = -1;
+            std::ifstream in(path + "/numa_node");
+            if (in >> node)
+                return node;
+            path = path.substr(0, path.find_last_of('/'));
+        }
+        return -1;
+    }
+
+    std::vector<int> get_numa_node_cpus(int node)
+    {
+        std::vector<int> cpus;
+        if (node < 0)
+            return cpus;
+
+        // A list of ranges, e.g. 0-7,16-23
+        std::ifstream in(to_string() << "/sys/devices/system/node/node" << node << "/cpulist");
+        std::string range;
+        while (std::getline(in, range, ','))
+        {
+            int first = 0, last = 0;
+            char dash = 0;
+            std::istringstream ss(range);
+            if (!(ss >> first))
+                continue;
+            if (!(ss >> dash >> last) || dash != '-')
+                last = first;
+            for (int cpu = first; cpu <= last; ++cpu)
+                cpus.push_back(cpu);
+        }
+        return cpus;
+    }
+
+    numa_frame_allocator::numa_frame_allocator(int node, bool huge_pages)
+        : _node(node), _huge_pages(huge_pages), _page_size(static_cast<size_t>(sysconf(_SC_PAGESIZE)))
+    {
+    }
+
+    size_t numa_frame_allocator::mapped_size(size_t size) const
+    {
+        auto page = _huge_pages && size >= huge_page_size ? huge_page_size : _page_size;
+        return (size + page - 1) / page * page;
+    }
+
+    void* numa_frame_allocator::map(size_t size)
+    {
+        void* buffer = MAP_FAILED;
+        if (_huge_pages && size >= huge_page_size)
+        {
+#ifdef MAP_HUGETLB
+            buffer = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+#endif
+            if (buffer == MAP_FAILED)
+            {
+                // No huge pages are reserved, transparent huge pages may still back the buffer
+                buffer = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+#ifdef MADV_HUGEPAGE
+                if (buffer != MAP_FAILED)
+                    madvise(buffer, size, MADV_HUGEPAGE);
+#endif
+            }
+        }
+        else
+            buffer = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+        if (buffer == MAP_FAILED)
+        {
+            LOG_ERROR("Could not map a frame buffer of " << size << " bytes, error " << errno);
+            return nullptr;
+        }
+        if (_node >= 0)
+            bind_to_node(buffer, size, _node);
+        return buffer;
+    }
+
+    void numa_frame_allocator::unmap(void* buffer, size_t size)
+    {
+        munmap(buffer, size);
+    }
+#else
+    int get_numa_node(const std::string&)
+    {
+        return -1;
+    }
+
+    std::vector<int> get_numa_node_cpus(int)
+    {
+        return {};
+    }
+
+    numa_frame_allocator::numa_frame_allocator(int node, bool huge_pages)
+        : _node(node), _huge_pages(huge_pages), _page_size(1)
+    {
+        if (node >= 0 || huge_pages)
+            LOG_WARNING("NUMA placement and huge pages are not supported on this platform, frame buffers come from the heap");
+    }
+
+    size_t numa_frame_allocator::mapped_size(size_t size) const
+    {
+        return size;
+    }
+
+    void* numa_frame_allocator::map(size_t size)
+    {
+        return std::malloc(size);
+    }
+
+    void numa_frame_allocator::unmap(void* buffer, size_t)
+    {
+        std::free(buffer);
+    }
+#endif
+
+    numa_frame_allocator::~numa_frame_allocator()
+    {
+        for (auto&& buffers : _free)
+            for (auto buffer : buffers.second)
+                unmap(buffer, buffers.first);
+    }
+
+    void* numa_frame_allocator::allocate(size_t size)
+    {
+        auto mapped = mapped_size(size);
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            auto it = _free.find(mapped);
+            if (it != _free.end() && !it->second.empty())
+            {
+                auto buffer = it->second.back();
+                it->second.pop_back();
+                return buffer;
+            }
+        }
+        return map(mapped);
+    }
+
+    void numa_frame_allocator::deallocate(void* buffer, size_t size)
+    {
+        auto mapped = mapped_size(size);
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            auto& buffers = _free[mapped];
+            if (buffers.size() < max_free_buffers)
+            {
+                buffers.push_back(buffer);
+                return;
+            }
+        }
+        unmap(buffer, mapped);
+    }
+}
@@ -0,0 +1,51 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "types.h"
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace librealsense
+{
+    // NUMA node of the bus a device sits on, looked up from its sysfs path. -1 when unknown or not applicable
+    int get_numa_node(const std::string& device_path);
+
+    // Cores of a NUMA node, empty when the node is unknown
+    std::vector<int> get_numa_node_cpus(int node);
+
+    // Frame buffers placed on a NUMA node, and backed by 2MB huge pages when they're at least that large.
+    // Buffers are mapped once and recycled by size, the kernel only places their pages on the first write.
+    // Without NUMA support in the platform the buffers come from the heap
+    class numa_frame_allocator : public rs2_frame_allocator
+    {
+    public:
+        static const size_t huge_page_size = 2 << 20;
+
+        // A negative node leaves the placement to the operating system
+        numa_frame_allocator(int node, bool huge_pages);
+        ~numa_frame_allocator();
+
+        void* allocate(size_t size) override;
+        void deallocate(void* buffer, size_t size) override;
+        void release() override { delete this; }
+
+    private:
+        // Mapped buffers kept for reuse, per mapped size
+        static const size_t max_free_buffers = 16;
+
+        size_t mapped_size(size_t size) const;
+        void* map(size_t size);
+        static void unmap(void* buffer, size_t size);
+
+        int _node;
+        bool _huge_pages;
+        size_t _page_size;
+        std::mutex _mutex;
+        std::unordered_map<size_t, std::vector<void*>> _free;
+    };
+}
@@ -34,6 +34,38 @@ void librealsense::option::create_snapshot(std::shared_ptr<option>& snapshot) co
     snapshot = std::make_shared<const_value_option>(get_description(), query());
 }
 
+std::vector<rs2_option_value> librealsense::options_interface::get_options_snapshot() const
+{
+    std::vector<rs2_option_value> values;
+    for (auto i = 0; i < RS2_OPTION_COUNT; i++)
+    {
+        auto id = static_cast<rs2_option>(i);
+        if (!supports_option(id)) continue;
+
+        rs2_option_value value = {};
+        value.id = id;
+        try
+        {
+            auto& opt = get_option(id);
+            auto range = opt.get_range();
+            auto read_only = opt.is_read_only();
+            value.value = opt.query();
+            value.is_read_only = read_only;
+            value.min = range.min;
+            value.max = range.max;
+            value.step = range.step;
+            value.def = range.def;
+            value.has_value = 1;
+        }
+        catch (const std::exception& e)
+        {
+            LOG_DEBUG("Failed to read option " << rs2_option_to_string(id) << ": " << e.what());
+        }
+        values.push_back(value);
+    }
+    return values;
+}
+
 void librealsense::float_option::set(float value)
 {
     if (!is_valid(value))
@@ -191,3 +223,224 @@ const char * librealsense::polling_errors_disable::get_value_description(float v
         return "Enable error polling";
     }
 }
+
+std::shared_ptr<librealsense::cached_option> librealsense::options_container::get_cached_option(rs2_option id)
+{
+    auto it = _options.find(id);
+    if (it == _options.end())
+        throw invalid_value_exception(to_string() << "Device does not support option " << rs2_option_to_string(id) << "!");
+
+    if (auto cached = std::dynamic_pointer_cast<cached_option>(it->second))
+        return cached;
+
+    auto cached = std::make_shared<cached_option>(it->second);
+    it->second = cached;
+    return cached;
+}
+
+bool librealsense::options_container::get_option_metadata(rs2_option id, rs2_frame_metadata_value* metadata, bool* manual_exposure_only)
+{
+    // The options the depth and color metadata report in the units of the option. While auto exposure is on,
+    // the metadata holds the exposure and gain the camera chose rather than the option value
+    static const std::map<rs2_option, std::pair<rs2_frame_metadata_value, bool>> metadata_values = {
+        { RS2_OPTION_EXPOSURE, { RS2_FRAME_METADATA_ACTUAL_EXPOSURE, true } },
+        { RS2_OPTION_GAIN, { RS2_FRAME_METADATA_GAIN_LEVEL, true } },
+        { RS2_OPTION_LASER_POWER, { RS2_FRAME_METADATA_FRAME_LASER_POWER, false } },
+    };
+    auto it = metadata_values.find(id);
+    if (it == metadata_values.end()) return false;
+
+    *metadata = it->second.first;
+    *manual_exposure_only = it->second.second;
+    return true;
+}
+
+void librealsense::options_container::enable_option_cache(rs2_option id, bool enable)
+{
+    auto cached = get_cached_option(id);
+    cached->enable_cache(enable);
+
+    rs2_frame_metadata_value metadata;
+    bool manual_exposure_only;
+    if (!get_option_metadata(id, &metadata, &manual_exposure_only)) return;
+
+    auto options = std::make_shared<metadata_options>(*std::atomic_load(&_metadata_options));
+    options->erase(std::remove_if(options->begin(), options->end(),
+        [&cached](const metadata_option& opt) { return opt.option == cached; }), options->end());
+    if (enable) options->push_back({ metadata, manual_exposure_only, cached });
+    std::atomic_store(&_metadata_options, std::shared_ptr<const metadata_options>(options));
+}
+
+void librealsense::options_container::add_option_observer(rs2_option id, std::function<void(float)> callback)
+{
+    get_cached_option(id)->add_observer(std::move(callback));
+}
+
+void librealsense::options_container::update_options_from_metadata(const frame_interface& frame)
+{
+    auto options = std::atomic_load(&_metadata_options);
+    if (options->empty()) return;
+
+    auto manual_exposure = false;
+    try
+    {
+        manual_exposure = frame.supports_frame_metadata(RS2_FRAME_METADATA_AUTO_EXPOSURE) &&
+            frame.get_frame_metadata(RS2_FRAME_METADATA_AUTO_EXPOSURE) == 0;
+    }
+    catch (const std::exception& e)
+    {
+        LOG_DEBUG("Failed to read the auto exposure mode from frame metadata: " << e.what());
+    }
+
+    for (auto&& opt : *options)
+    {
+        if (opt.manual_exposure_only && !manual_exposure) continue;
+        try
+        {
+            if (frame.supports_frame_metadata(opt.metadata))
+                opt.option->update(static_cast<float>(frame.get_frame_metadata(opt.metadata)));
+        }
+        catch (const std::exception& e)
+        {
+            LOG_DEBUG("Failed to refresh an option from frame metadata: " << e.what());
+        }
+    }
+}
+
+void librealsense::options_container::set_option_async(rs2_option id, float value, std::function<void(std::exception_ptr)> done)
+{
+    auto it = _options.find(id);
+    if (it == _options.end())
+        throw invalid_value_exception(to_string() << "Device does not support option " << rs2_option_to_string(id) << "!");
+
+    auto writer = std::atomic_load(&_async_writer);
+    if (!writer)
+    {
+        auto created = std::make_shared<async_option_writer>();
+        writer = std::atomic_compare_exchange_strong(&_async_writer, &writer, created) ? created : writer;
+    }
+    writer->set(it->second, value, std::move(done));
+}
+
+void librealsense::options_container::stop_async_writes()
+{
+    std::atomic_exchange(&_async_writer, std::shared_ptr<async_option_writer>());
+}
+
+librealsense::async_option_writer::async_option_writer()
+    : _thread([this]() { run(); })
+{
+}
+
+librealsense::async_option_writer::~async_option_writer()
+{
+    std::vector<pending_write> cancelled;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stopping = true;
+        cancelled.swap(_pending);
+    }
+    _cv.notify_one();
+    _thread.join();
+
+    auto error = std::make_exception_ptr(wrong_api_call_sequence_exception("The option write was cancelled, its sensor is being destroyed"));
+    for (auto&& write : cancelled)
+        for (auto&& done : write.done)
+            if (done) done(error);
+}
+
+void librealsense::async_option_writer::set(std::shared_ptr<option> opt, float value, done_callback done)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto it = std::find_if(_pending.begin(), _pending.end(), [&opt](const pending_write& w) { return w.opt == opt; });
+        if (it == _pending.end())
+            it = _pending.insert(_pending.end(), pending_write{ std::move(opt), value, {} });
+        it->value = value;
+        it->done.push_back(std::move(done));
+    }
+    _cv.notify_one();
+}
+
+void librealsense::async_option_writer::run()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (true)
+    {
+        _cv.wait(lock, [this]() { return _stopping || !_pending.empty(); });
+        if (_stopping)
+            return;
+
+        std::vector<pending_write> batch;
+        batch.swap(_pending);
+        lock.unlock();
+
+        std::vector<std::exception_ptr> errors(batch.size());
+        write(batch, errors);
+        for (size_t i = 0; i < batch.size(); ++i)
+        {
+            for (auto&& done : batch[i].done)
+            {
+                try
+                {
+                    if (done) done(errors[i]);
+                }
+                catch (const std::exception& e)
+                {
+                    LOG_ERROR("Exception in an option write callback: " << e.what());
+                }
+                catch (...)
+                {
+                    LOG_ERROR("Unknown exception in an option write callback");
+                }
+            }
+        }
+        batch.clear();
+
+        lock.lock();
+    }
+}
+
+void librealsense::async_option_writer::write(std::vector<pending_write>& batch, std::vector<std::exception_ptr>& errors)
+{
+    // Cached options are written through their proxy, and updated once it's written
+    auto target = [](const std::shared_ptr<option>& opt)
+    {
+        auto cached = std::dynamic_pointer_cast<cached_option>(opt);
+        return cached ? cached->get_proxy() : opt;
+    };
+
+    std::vector<size_t> staged;
+    for (size_t i = 0; i < batch.size(); ++i)
+    {
+        try
+        {
+            if (auto field = dynamic_cast<batched_option*>(target(batch[i].opt).get()))
+            {
+                field->stage(batch[i].value);
+                staged.push_back(i);
+            }
+            else
+                batch[i].opt->set(batch[i].value);
+        }
+        catch (...)
+        {
+            errors[i] = std::current_exception();
+        }
+    }
+
+    // The first commit of a control writes all its staged fields, the following ones only record their option
+    for (auto i : staged)
+    {
+        try
+        {
+            dynamic_cast<batched_option*>(target(batch[i].opt).get())->commit();
+            if (auto cached = std::dynamic_pointer_cast<cached_option>(batch[i].opt))
+                cached->update(batch[i].value);
+        }
+        catch (...)
+        {
+            errors[i] = std::current_exception();
+        }
+    }
+}
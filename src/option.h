@@ -14,27 +14,41 @@
 #include <vector>
 #include <cmath>
 #include <type_traits>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
 
 namespace librealsense
 {
+    // Observers are added to a copy of the list, notifying reads the current one without a lock
     class observable_option
     {
+        typedef std::vector<std::function<void(float)>> callbacks;
     public:
+        observable_option()
+            : _callbacks(std::make_shared<const callbacks>())
+        {}
+
         void add_observer(std::function<void(float)> callback)
         {
-            _callbacks.push_back(callback);
+            std::lock_guard<std::mutex> lock(_callbacks_mutex);
+            auto next = std::make_shared<callbacks>(*std::atomic_load(&_callbacks));
+            next->push_back(std::move(callback));
+            std::atomic_store(&_callbacks, std::shared_ptr<const callbacks>(std::move(next)));
         }
 
         void notify(float val)
         {
-            for (auto callback : _callbacks)
+            auto current = std::atomic_load(&_callbacks);
+            for (auto&& callback : *current)
             {
                 callback(val);
             }
         }
 
     private:
-        std::vector<std::function<void(float)>> _callbacks;
+        std::mutex _callbacks_mutex;
+        std::shared_ptr<const callbacks> _callbacks;
     };
 
     class readonly_option : public option
@@ -308,12 +322,19 @@ namespace librealsense
     }
 
     template<class T, class R, class W, class U>
-    class struct_field_option : public option
+    class struct_field_option : public option, public batched_option
     {
     public:
         void set(float value) override
         {
-            _struct_interface->set(_field, value);
+            stage(value);
+            commit();
+        }
+
+        void stage(float value) override { _struct_interface->set(_field, value); }
+        void commit() override
+        {
+            _struct_interface->commit();
             _recording_function(*this);
         }
         float query() const override
@@ -479,4 +500,104 @@ namespace librealsense
        float                   _manual_value;
        std::function<void(const option&)> _recording_function = [](const option&) {};
    };
+
+    /** \brief cached_option wraps an option to serve queries from the last known value instead of the device.
+    * The cache is refreshed by set and by frame metadata, and observers are notified whenever the value changes */
+    class cached_option : public option, public observable_option
+    {
+    public:
+        explicit cached_option(std::shared_ptr<option> proxy)
+            : _proxy(std::move(proxy))
+        {}
+
+        void set(float value) override
+        {
+            _proxy->set(value);
+            update(value);
+        }
+
+        float query() const override
+        {
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                if (_cache_enabled && _valid) return _value;
+            }
+            auto value = _proxy->query();
+            const_cast<cached_option*>(this)->update(value);
+            return value;
+        }
+
+        // Records a value read elsewhere, e.g. from frame metadata, notifying the observers if it changed
+        void update(float value)
+        {
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                auto changed = !_valid || _value != value;
+                _value = value;
+                _valid = true;
+                if (!changed) return;
+            }
+            notify(value);
+        }
+
+        void enable_cache(bool enable)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _cache_enabled = enable;
+            _valid = false;
+        }
+
+        bool is_cache_enabled() const
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            return _cache_enabled;
+        }
+
+        option_range get_range() const override { return _proxy->get_range(); }
+        bool is_enabled() const override { return _proxy->is_enabled(); }
+        bool is_read_only() const override { return _proxy->is_read_only(); }
+        const char* get_description() const override { return _proxy->get_description(); }
+        const char* get_value_description(float val) const override { return _proxy->get_value_description(val); }
+        void enable_recording(std::function<void(const option&)> record_action) override { _proxy->enable_recording(record_action); }
+
+        std::shared_ptr<option> get_proxy() const { return _proxy; }
+
+    private:
+        std::shared_ptr<option> _proxy;
+        mutable std::mutex _mutex;
+        bool _cache_enabled = false;
+        bool _valid = false;
+        float _value = 0.f;
+    };
+
+    // Sends asynchronous option writes from a thread of its own. Writes queued while the thread is busy are coalesced,
+    // only the latest value of an option is sent, and the staged fields of a control are committed once per batch
+    class async_option_writer
+    {
+    public:
+        typedef std::function<void(std::exception_ptr)> done_callback;
+
+        async_option_writer();
+        // Writes that did not start are completed with an error
+        ~async_option_writer();
+
+        void set(std::shared_ptr<option> opt, float value, done_callback done);
+
+    private:
+        struct pending_write
+        {
+            std::shared_ptr<option> opt;
+            float value;
+            std::vector<done_callback> done;
+        };
+
+        void run();
+        static void write(std::vector<pending_write>& batch, std::vector<std::exception_ptr>& errors);
+
+        std::mutex _mutex;
+        std::condition_variable _cv;
+        std::vector<pending_write> _pending;
+        bool _stopping = false;
+        std::thread _thread;
+    };
 }
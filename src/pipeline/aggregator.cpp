@@ -4,16 +4,29 @@
 #include <algorithm>
 #include "stream.h"
 #include "aggregator.h"
+#include "stream-statistics.h"
 
 namespace librealsense
 {
     namespace pipeline
     {
-        aggregator::aggregator(const std::vector<int>& streams_to_aggregate, const std::vector<int>& streams_to_sync) :
-            _queue(new single_consumer_frame_queue<frame_holder>(1)),
+        aggregator::aggregator(const std::vector<int>& streams_to_aggregate, const std::vector<int>& streams_to_sync,
+            std::shared_ptr<wait_control> wait) :
+            _last_set(streams_to_aggregate.size()),
+            _queue(new single_consumer_frame_queue<frame_holder>(1, wait)),
             _streams_to_aggregate_ids(streams_to_aggregate),
-            _streams_to_sync_ids(streams_to_sync)
+            _streams_to_sync_ids(streams_to_sync),
+            _callback_mode(false)
         {
+            for (int s : _streams_to_aggregate_ids)
+                _slot_synced.push_back(std::find(_streams_to_sync_ids.begin(), _streams_to_sync_ids.end(), s) != _streams_to_sync_ids.end());
+
+            // The pipeline keeps the latest frameset only, the ones the application didn't wait for in time are dropped
+            _queue->set_on_drop([](frame_holder& f)
+            {
+                stream_statistics::instance().dropped(f.frame, RS2_FRAME_DROP_REASON_QUEUE);
+            });
+
             auto processing_callback = [&](frame_holder frame, synthetic_source_interface* source)
             {
                 handle_frame(std::move(frame), source);
@@ -23,74 +36,90 @@ namespace librealsense
                 new internal_frame_processor_callback<decltype(processing_callback)>(processing_callback)));
         }
 
-        void aggregator::handle_frame(frame_holder frame, synthetic_source_interface* source)
+        void aggregator::set_output_callback(frame_callback_ptr callback)
         {
-            std::lock_guard<std::mutex> lock(_mutex);
-            auto comp = dynamic_cast<composite_frame*>(frame.frame);
-            if (comp)
-            {
-                for (auto i = 0; i < comp->get_embedded_frames_count(); i++)
-                {
-                    auto f = comp->get_frame(i);
-                    f->acquire();
-                    _last_set[f->get_stream()->get_unique_id()] = f;
-                }
-
-                // in case not all required streams were aggregated don't publish the frame set
-                for (int s : _streams_to_aggregate_ids)
-                {
-                    if (!_last_set[s])
-                        return;
-                }
+            processing_block::set_output_callback(callback);
+            _callback_mode = true;
+        }
 
-                // prepare the output frame set for wait_for_frames/poll_frames calls
-                std::vector<frame_holder> sync_set;
-                // prepare the output frame set for the callbacks
-                std::vector<frame_holder> async_set;
-                for (auto&& s : _last_set)
-                {
-                    sync_set.push_back(s.second.clone());
-                    // send only the synchronized frames to the user callback
-                    if (std::find(_streams_to_sync_ids.begin(), _streams_to_sync_ids.end(),
-                        s.second->get_stream()->get_unique_id()) != _streams_to_sync_ids.end())
-                        async_set.push_back(s.second.clone());
-                }
+        int aggregator::find_slot(int stream_id) const
+        {
+            for (size_t i = 0; i < _streams_to_aggregate_ids.size(); ++i)
+                if (_streams_to_aggregate_ids[i] == stream_id)
+                    return static_cast<int>(i);
+            return -1;
+        }
 
-                frame_holder sync_fref = source->allocate_composite_frame(std::move(sync_set));
-                frame_holder async_fref = source->allocate_composite_frame(std::move(async_set));
+        bool aggregator::store(frame_holder frame)
+        {
+            auto slot = find_slot(frame->get_stream()->get_unique_id());
+            if (slot < 0)
+                return false;
 
-                if (!sync_fref || !async_fref)
-                {
-                    LOG_ERROR("Failed to allocate composite frame");
-                    return;
-                }
-                // for async pipeline usage - provide only the synchronized frames to the user via callback
-                source->frame_ready(async_fref.clone());
+            if (!_last_set[slot])
+                ++_filled_slots;
+            _last_set[slot] = std::move(frame);
+            return true;
+        }
 
-                // for sync pipeline usage - push the aggregated to the output queue
-                _queue->enqueue(sync_fref.clone());
+        frame_holder aggregator::allocate_set(synthetic_source_interface* source, bool synced_only) const
+        {
+            composite_frame_builder set;
+            for (size_t i = 0; i < _last_set.size(); ++i)
+            {
+                if (_last_set[i] && (!synced_only || _slot_synced[i]))
+                    set.push_back(_last_set[i].clone());
             }
-            else
+
+            frame_holder fref = source->allocate_composite_frame(set);
+            if (!fref)
+                LOG_ERROR("Failed to allocate composite frame");
+            return fref;
+        }
+
+        void aggregator::handle_frame(frame_holder frame, synthetic_source_interface* source)
+        {
+            // The callback is called once the lock is released, so a slow callback for a stream doesn't hold
+            // back the frames of the other streams arriving on other threads
+            frame_holder ready;
             {
-                source->frame_ready(frame.clone());
-                _last_set[frame->get_stream()->get_unique_id()] = frame.clone();
-                if (_streams_to_sync_ids.empty() && _last_set.size() == _streams_to_aggregate_ids.size())
+                std::lock_guard<std::mutex> lock(_mutex);
+                auto comp = frame_cast<composite_frame>(frame.frame);
+                if (comp)
                 {
-                    // prepare the output frame set for wait_for_frames/poll_frames calls
-                    std::vector<frame_holder> sync_set;
-                    for (auto&& s : _last_set)
-                        sync_set.push_back(s.second.clone());
+                    for (auto i = 0; i < comp->get_embedded_frames_count(); i++)
+                        store(comp->take_frame(i));
 
-                    frame_holder sync_fref = source->allocate_composite_frame(std::move(sync_set));
-                    if (!sync_fref)
-                    {
-                        LOG_ERROR("Failed to allocate composite frame");
+                    // in case not all required streams were aggregated don't publish the frame set
+                    if (_filled_slots < _last_set.size())
                         return;
+
+                    // for async pipeline usage - provide only the synchronized frames to the user via callback,
+                    // for sync pipeline usage - push the aggregated set to the output queue
+                    if (auto fref = allocate_set(source, _callback_mode))
+                    {
+                        if (_callback_mode)
+                            ready = std::move(fref);
+                        else
+                            _queue->enqueue(std::move(fref));
+                    }
+                }
+                else
+                {
+                    // the unsynchronized frames are kept as well, the published sets of the callback wait for them
+                    if (_callback_mode)
+                        ready = frame.clone();
+                    store(std::move(frame));
+                    if (!_callback_mode && _streams_to_sync_ids.empty() && _filled_slots == _last_set.size())
+                    {
+                        // for sync pipeline usage - push the aggregated to the output queue
+                        if (auto fref = allocate_set(source, false))
+                            _queue->enqueue(std::move(fref));
                     }
-                    // for sync pipeline usage - push the aggregated to the output queue
-                    _queue->enqueue(sync_fref.clone());
                 }
             }
+            if (ready)
+                source->frame_ready(std::move(ready));
         }
 
         bool aggregator::dequeue(frame_holder* item, unsigned int timeout_ms)
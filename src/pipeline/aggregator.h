@@ -14,13 +14,25 @@ namespace librealsense
         class aggregator : public processing_block
         {
             std::mutex _mutex;
-            std::map<stream_id, frame_holder> _last_set;
+            // One slot per aggregated stream, in the order of _streams_to_aggregate_ids
+            std::vector<frame_holder> _last_set;
+            std::vector<bool> _slot_synced;
+            size_t _filled_slots = 0;
             std::unique_ptr<single_consumer_frame_queue<frame_holder>> _queue;
             std::vector<int> _streams_to_aggregate_ids;
             std::vector<int> _streams_to_sync_ids;
+            // The pipeline either delivers the frames to a callback or queues them for wait_for_frames, never both
+            std::atomic<bool> _callback_mode;
+            int find_slot(int stream_id) const;
+            bool store(frame_holder frame);
+            frame_holder allocate_set(synthetic_source_interface* source, bool synced_only) const;
             void handle_frame(frame_holder frame, synthetic_source_interface* source);
         public:
-            aggregator(const std::vector<int>& streams_to_aggregate, const std::vector<int>& streams_to_sync);
+            aggregator(const std::vector<int>& streams_to_aggregate, const std::vector<int>& streams_to_sync,
+                std::shared_ptr<wait_control> wait = nullptr);
+            void set_output_callback(frame_callback_ptr callback) override;
+            // Drops the frames waiting for the callback and waits for the callback in progress
+            void stop_callbacks() { _source.stop_callback_queues(); }
             bool dequeue(frame_holder* item, unsigned int timeout_ms = 5000);
             bool try_dequeue(frame_holder* item);
         };
@@ -57,6 +57,15 @@ namespace librealsense
             _device_request.record_output = file;
         }
 
+        void config::limit_usb_bandwidth(float utilization)
+        {
+            if (utilization < 0.f || utilization > 1.f)
+                throw invalid_value_exception(to_string() << "USB link utilization " << utilization << " is out of [0, 1]");
+            std::lock_guard<std::mutex> lock(_mtx);
+            _resolved_profile.reset();
+            _usb_utilization = utilization;
+        }
+
         std::shared_ptr<profile> config::get_cached_resolved_profile()
         {
             std::lock_guard<std::mutex> lock(_mtx);
@@ -94,6 +103,13 @@ namespace librealsense
         {
             util::config config;
 
+            uint64_t available = 0;
+            if (_usb_utilization > 0.f && usb_bandwidth_planner::instance().get_available(*dev, _usb_utilization, available))
+            {
+                LOG_DEBUG("Resolving within " << available / 1000000 << " MB/s of USB bandwidth");
+                config.set_bandwidth_limit(std::max<uint64_t>(available, 1)); // none left is still a limit
+            }
+
             //if the user requested all streams
             if (_enable_all_streams)
             {
@@ -165,6 +181,21 @@ namespace librealsense
             assert(0); //Unreachable code
         }
 
+        std::shared_ptr<profile> config::resolve_on_device(std::shared_ptr<device_interface> dev)
+        {
+            std::lock_guard<std::mutex> lock(_mtx);
+            _resolved_profile.reset();
+
+            if (!_device_request.filename.empty() || !_device_request.record_output.empty())
+                return nullptr;
+            if (!_device_request.serial.empty() && (!dev->supports_info(RS2_CAMERA_INFO_SERIAL_NUMBER) ||
+                dev->get_info(RS2_CAMERA_INFO_SERIAL_NUMBER) != _device_request.serial))
+                return nullptr;
+
+            _resolved_profile = resolve(dev);
+            return _resolved_profile;
+        }
+
         bool config::can_resolve(std::shared_ptr<pipeline> pipe)
         {
             try
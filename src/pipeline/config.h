@@ -26,8 +26,13 @@ namespace librealsense
             void enable_record_to_file(const std::string& file);
             void disable_stream(rs2_stream stream, int index = -1);
             void disable_all_streams();
+            // Fits the streams into the fraction of the USB link of the device that the other cameras on it leave,
+            // 0 resolves them regardless of the bandwidth
+            void limit_usb_bandwidth(float utilization);
             std::shared_ptr<profile> resolve(std::shared_ptr<pipeline> pipe, const std::chrono::milliseconds& timeout = std::chrono::milliseconds(0));
             bool can_resolve(std::shared_ptr<pipeline> pipe);
+            // Resolves the streams on a device that is already selected, null when the device requests of the config select another one
+            std::shared_ptr<profile> resolve_on_device(std::shared_ptr<device_interface> dev);
             bool get_repeat_playback();
 
             //Non top level API
@@ -41,6 +46,7 @@ namespace librealsense
                 _stream_requests = other._stream_requests;
                 _resolved_profile = nullptr;
                 _playback_loop = other._playback_loop;
+                _usb_utilization = other._usb_utilization;
             }
         private:
             struct device_request
@@ -60,6 +66,7 @@ namespace librealsense
             bool _enable_all_streams = false;
             std::shared_ptr<profile> _resolved_profile;
             bool _playback_loop;
+            float _usb_utilization = 0.f;
         };
     }
 }
@@ -11,11 +11,22 @@ namespace librealsense
 {
     namespace pipeline
     {
+        namespace
+        {
+            // The sensors of a live device negotiate their streams independently, so they are opened concurrently.
+            // Playback and recording sensors share their reader or writer
+            bool open_concurrently(std::shared_ptr<device_interface> dev)
+            {
+                return !As<librealsense::playback_device>(dev) && !As<librealsense::record_device>(dev);
+            }
+        }
+
         pipeline::pipeline(std::shared_ptr<librealsense::context> ctx) :
             _ctx(ctx),
             _dispatcher(10),
             _hub(ctx, RS2_PRODUCT_LINE_ANY_INTEL),
-            _synced_streams({ RS2_STREAM_COLOR, RS2_STREAM_DEPTH, RS2_STREAM_INFRARED, RS2_STREAM_FISHEYE })
+            _synced_streams({ RS2_STREAM_COLOR, RS2_STREAM_DEPTH, RS2_STREAM_INFRARED, RS2_STREAM_FISHEYE }),
+            _wait(std::make_shared<wait_control>())
         {}
 
         pipeline::~pipeline()
@@ -98,7 +109,7 @@ namespace librealsense
                         {
                             //If the pipeline holds a playback device, and it reached the end of file (stopped)
                             //Then we restart it
-                            if (_active_profile && _prev_conf->get_repeat_playback())
+                            if (_active_profile && !_paused && _prev_conf->get_repeat_playback())
                             {
                                 _active_profile->_multistream.open();
                                 _active_profile->_multistream.start(callbacks);
@@ -108,10 +119,27 @@ namespace librealsense
                 };
             }
 
+            else if (open_concurrently(dev) && dev->supports_info(RS2_CAMERA_INFO_SERIAL_NUMBER))
+            {
+                // The streams are not restarted from the notifications thread, the dispatcher is not stopped by it
+                auto serial = dev->get_info(RS2_CAMERA_INFO_SERIAL_NUMBER);
+                _reconnect_token = _hub.add_reconnect_handler(serial, [this, serial](std::shared_ptr<device_interface>)
+                {
+                    _dispatcher.invoke([this, serial](dispatcher::cancellable_timer t)
+                    {
+                        on_reconnect(serial, t);
+                    });
+                });
+            }
+
             _dispatcher.start();
-            profile->_multistream.open();
-            profile->_multistream.start(callbacks);
+            if (_allocator)
+                profile->_multistream.set_frame_allocator(_allocator);
+            profile->_multistream.open(open_concurrently(dev));
+            profile->_multistream.start(callbacks, open_concurrently(dev));
+            _sensors_callback = callbacks;
             _active_profile = profile;
+            _paused = false;
             _prev_conf = std::make_shared<config>(*conf);
         }
 
@@ -136,8 +164,16 @@ namespace librealsense
                     {
                         playback->playback_status_changed -= _playback_stopped_token;
                     }
-                    _active_profile->_multistream.stop();
+                    if (_reconnect_token >= 0)
+                    {
+                        _hub.remove_reconnect_handler(_reconnect_token);
+                        _reconnect_token = -1;
+                    }
+                    if (!_paused)
+                        _active_profile->_multistream.stop();
                     _active_profile->_multistream.close();
+                    if (_aggregator)
+                        _aggregator->stop_callbacks();
                     _dispatcher.stop();
                 }
                 catch (...)
@@ -147,6 +183,162 @@ namespace librealsense
             _active_profile.reset();
             _prev_conf.reset();
             _streams_callback.reset();
+            _sensors_callback.reset();
+            _paused = false;
+        }
+
+        void pipeline::pause()
+        {
+            std::lock_guard<std::mutex> lock(_mtx);
+            if (!_active_profile)
+            {
+                throw librealsense::wrong_api_call_sequence_exception("pause() cannot be called before start()");
+            }
+            if (_paused)
+                return;
+
+            _active_profile->_multistream.stop();
+            _paused = true;
+        }
+
+        void pipeline::resume()
+        {
+            std::lock_guard<std::mutex> lock(_mtx);
+            if (!_active_profile)
+            {
+                throw librealsense::wrong_api_call_sequence_exception("resume() cannot be called before start()");
+            }
+            if (!_paused)
+                return;
+
+            // the frames left from before the pause are not matched with the new ones
+            _sensors_callback = get_callback(on_start(_active_profile));
+            _active_profile->_multistream.start(_sensors_callback, open_concurrently(_active_profile->get_device()));
+            _paused = false;
+        }
+
+        std::shared_ptr<profile> pipeline::reconfigure(std::shared_ptr<config> conf)
+        {
+            std::lock_guard<std::mutex> lock(_mtx);
+            if (!_active_profile)
+            {
+                throw librealsense::wrong_api_call_sequence_exception("reconfigure() cannot be called before start()");
+            }
+
+            auto dev = _active_profile->get_device();
+            std::shared_ptr<profile> profile;
+            if (open_concurrently(dev))
+                profile = conf->resolve_on_device(dev);
+
+            // another device, playback and recording need a full restart
+            if (!profile)
+            {
+                auto callback = _streams_callback;
+                unsafe_stop();
+                _streams_callback = callback;
+                unsafe_start(conf);
+                return unsafe_get_active_profile();
+            }
+
+            try
+            {
+                if (!_paused)
+                    _active_profile->_multistream.stop();
+                if (_allocator)
+                    profile->_multistream.set_frame_allocator(_allocator);
+                profile->_multistream.open_from(_active_profile->_multistream, true);
+                _active_profile = profile;
+                if (!_paused)
+                {
+                    _sensors_callback = get_callback(on_start(profile));
+                    profile->_multistream.start(_sensors_callback, true);
+                }
+            }
+            catch (...)
+            {
+                // the sensors are left between both configurations, release all of them
+                profile->_multistream.release();
+                _active_profile->_multistream.release();
+                _paused = true;
+                _dispatcher.stop();
+                unsafe_stop();
+                throw;
+            }
+            _prev_conf = std::make_shared<config>(*conf);
+            return profile;
+        }
+
+        bool pipeline::wait_for_streams(unsigned int timeout_ms)
+        {
+            std::lock_guard<std::mutex> lock(_mtx);
+            if (!_active_profile)
+            {
+                throw librealsense::wrong_api_call_sequence_exception("wait_for_streams cannot be called before start()");
+            }
+            if (_paused)
+            {
+                throw librealsense::wrong_api_call_sequence_exception("wait_for_streams cannot be called while the pipeline is paused");
+            }
+
+            std::unique_lock<std::mutex> lk(_first_frames_mutex);
+            return _first_frames_cv.wait_for(lk, std::chrono::milliseconds(timeout_ms), [&]() { return _first_frames_pending.empty(); });
+        }
+
+        void pipeline::on_first_frame(int unique_id)
+        {
+            std::lock_guard<std::mutex> lock(_first_frames_mutex);
+            auto it = std::find(_first_frames_pending.begin(), _first_frames_pending.end(), unique_id);
+            if (it == _first_frames_pending.end())
+                return;
+
+            _first_frames_pending.erase(it);
+            if (_first_frames_pending.empty())
+            {
+                _awaiting_first_frames = false;
+                _first_frames_cv.notify_all();
+            }
+        }
+
+        void pipeline::set_frame_allocator(frame_allocator_ptr allocator)
+        {
+            std::lock_guard<std::mutex> lock(_mtx);
+            _allocator = std::move(allocator);
+        }
+
+        void pipeline::set_callback_queue_size(unsigned int queue_size)
+        {
+            std::lock_guard<std::mutex> lock(_mtx);
+            _callback_queue_size = queue_size;
+        }
+
+        void pipeline::on_reconnect(const std::string& serial, dispatcher::cancellable_timer& t)
+        {
+            // stop() holds the lock while it waits for the dispatcher, the restart gives up once the dispatcher is stopped
+            std::unique_lock<std::mutex> lock(_mtx, std::defer_lock);
+            while (!lock.try_lock())
+            {
+                if (!t.try_sleep(1))
+                    return;
+            }
+
+            //hub returns true even if device already reconnected
+            if (!_active_profile || _hub.is_connected(*_active_profile->get_device()))
+                return;
+
+            try
+            {
+                auto conf = std::make_shared<config>(*_prev_conf);
+                conf->enable_device(serial);
+                auto callback = _streams_callback;
+                unsafe_stop();
+                _streams_callback = callback;
+                unsafe_start(conf);
+                LOG_INFO("Pipeline restarted on reconnected device " << serial);
+            }
+            catch (const std::exception& e)
+            {
+                LOG_ERROR("Device " << serial << " reconnected. Failed to restart the pipeline: " << e.what());
+            }
         }
 
         std::shared_ptr<device_interface> pipeline::wait_for_device(const std::chrono::milliseconds& timeout, const std::string& serial)
@@ -179,10 +371,19 @@ namespace librealsense
             }
 
             _syncer = std::unique_ptr<syncer_process_unit>(new syncer_process_unit());
-            _aggregator = std::unique_ptr<aggregator>(new aggregator(_streams_to_aggregate_ids, _streams_to_sync_ids));
+            _aggregator = std::unique_ptr<aggregator>(new aggregator(_streams_to_aggregate_ids, _streams_to_sync_ids, _wait));
 
             if (_streams_callback)
+            {
+                _aggregator->get_option(RS2_OPTION_CALLBACK_QUEUE_SIZE).set(static_cast<float>(_callback_queue_size));
                 _aggregator->set_output_callback(_streams_callback);
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(_first_frames_mutex);
+                _first_frames_pending = _streams_to_aggregate_ids;
+                _awaiting_first_frames = !_first_frames_pending.empty();
+            }
 
             return _streams_to_sync_ids;
         }
@@ -203,6 +404,9 @@ namespace librealsense
 
             auto to_syncer = [&, synced_streams_ids](frame_holder fref)
             {
+                if (_awaiting_first_frames)
+                    on_first_frame(fref->get_stream()->get_unique_id());
+
                 // if the user requested to sync the frame push it to the syncer, otherwise push it to the aggregator
                 if (std::find(synced_streams_ids.begin(), synced_streams_ids.end(), fref->get_stream()->get_unique_id()) != synced_streams_ids.end())
                     _syncer->invoke(std::move(fref));
@@ -229,6 +433,10 @@ namespace librealsense
             {
                 throw librealsense::wrong_api_call_sequence_exception("wait_for_frames cannot be called if a callback was provided");
             }
+            if (_paused)
+            {
+                throw librealsense::wrong_api_call_sequence_exception("wait_for_frames cannot be called while the pipeline is paused");
+            }
 
             frame_holder f;
             if (_aggregator->dequeue(&f, timeout_ms))
@@ -25,10 +25,21 @@ namespace librealsense
             virtual ~pipeline();
             std::shared_ptr<profile> start(std::shared_ptr<config> conf, frame_callback_ptr callback = nullptr);
             void stop();
+            // Stops the frame callbacks, leaving the sensors opened so that resume() doesn't renegotiate the streams
+            void pause();
+            void resume();
+            // Switches the streams of a started pipeline. The sensors whose streams don't change stay opened
+            std::shared_ptr<profile> reconfigure(std::shared_ptr<config> conf);
+            // Waits until every active stream delivered a frame since the streaming started, resumed or was reconfigured
+            bool wait_for_streams(unsigned int timeout_ms = 5000);
             std::shared_ptr<profile> get_active_profile() const;
             frame_holder wait_for_frames(unsigned int timeout_ms = 5000);
             bool poll_for_frames(frame_holder* frame);
             bool try_wait_for_frames(frame_holder* frame, unsigned int timeout_ms);
+            void set_frame_allocator(frame_allocator_ptr allocator);
+            void set_callback_queue_size(unsigned int queue_size);
+            // How wait_for_frames waits, and its wakeup latencies. Used without the lock of the pipeline, which a wait holds
+            wait_control& get_wait_control() { return *_wait; }
 
             //Non top level API
             std::shared_ptr<device_interface> wait_for_device(const std::chrono::milliseconds& timeout = std::chrono::hours::max(),
@@ -37,6 +48,7 @@ namespace librealsense
 
         protected:
             frame_callback_ptr get_callback(std::vector<int> unique_ids);
+            void on_first_frame(int unique_id);
             std::vector<int> on_start(std::shared_ptr<profile> profile);
 
             void unsafe_start(std::shared_ptr<config> conf);
@@ -49,16 +61,29 @@ namespace librealsense
 
         private:
             std::shared_ptr<profile> unsafe_get_active_profile() const;
+            // Restarts the streams of the previous configuration on the device that was disconnected, once it's back
+            void on_reconnect(const std::string& serial, dispatcher::cancellable_timer& t);
 
             std::shared_ptr<librealsense::context> _ctx;
             int _playback_stopped_token = -1;
+            int _reconnect_token = -1;
             dispatcher _dispatcher;
 
             std::unique_ptr<syncer_process_unit> _syncer;
             std::unique_ptr<aggregator> _aggregator;
 
             frame_callback_ptr _streams_callback;
+            frame_callback_ptr _sensors_callback;
+            bool _paused = false;
+
+            std::mutex _first_frames_mutex;
+            std::condition_variable _first_frames_cv;
+            std::vector<int> _first_frames_pending;
+            std::atomic<bool> _awaiting_first_frames{ false };
+            frame_allocator_ptr _allocator;
+            unsigned int _callback_queue_size = 0;
             std::vector<rs2_stream> _synced_streams;
+            std::shared_ptr<wait_control> _wait;
         };
     }
 }
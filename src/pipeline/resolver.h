@@ -9,9 +9,15 @@
 #include <algorithm>
 #include <cmath>
 #include <set>
+#include <tuple>
+#include <unordered_map>
+#include <thread>
+#include <exception>
+#include <functional>
 #include "sensor.h"
 #include "types.h"
 #include "stream.h"
+#include "usb-bandwidth.h"
 
 namespace librealsense
 {
@@ -191,19 +197,28 @@ namespace librealsense
                             _results(std::move(results))
                 {}
 
-                void open()
+                // The sensors negotiate their streams one after the other, or all at once when concurrent
+                void open(bool concurrent = false)
                 {
+                    std::vector<std::function<void()>> tasks;
                     for (auto && kvp : _dev_to_profiles) {
                         auto&& sub = _results.at(kvp.first);
-                        sub->open(kvp.second);
+                        auto profiles = kvp.second;
+                        tasks.push_back([sub, profiles]() { sub->open(profiles); });
                     }
+                    run(tasks, concurrent);
                 }
 
                 template<class T>
-                void start(T callback)
+                void start(T callback, bool concurrent = false)
                 {
+                    std::vector<std::function<void()>> tasks;
                     for (auto&& sensor : _results)
-                        sensor.second->start(callback);
+                    {
+                        auto sub = sensor.second;
+                        tasks.push_back([sub, callback]() { sub->start(callback); });
+                    }
+                    run(tasks, concurrent);
                 }
 
                 void stop()
@@ -212,11 +227,57 @@ namespace librealsense
                         sensor.second->stop();
                 }
 
+                // Applied to the sensors supporting custom frame allocation, the rest are left unchanged
+                void set_frame_allocator(frame_allocator_ptr allocator)
+                {
+                    for (auto&& sensor : _results)
+                        if (auto alloc_sensor = dynamic_cast<frame_allocator_interface*>(sensor.second))
+                            alloc_sensor->set_frame_allocator(allocator);
+                }
+
                 void close()
                 {
                     for (auto&& sensor : _results)
                         sensor.second->close();
                 }
+
+                // Opens the sensors of this set, taking over the sensors of the previous set that stream the same
+                // profiles as they are, without renegotiating their streams. The other sensors of the previous set are
+                // closed. All the sensors must be stopped
+                void open_from(const multistream& previous, bool concurrent = false)
+                {
+                    for (auto&& kvp : previous._dev_to_profiles)
+                    {
+                        if (!same_profiles(kvp.first, kvp.second))
+                            previous._results.at(kvp.first)->close();
+                    }
+
+                    std::vector<std::function<void()>> tasks;
+                    for (auto&& kvp : _dev_to_profiles)
+                    {
+                        if (!previous.same_profiles(kvp.first, kvp.second))
+                        {
+                            auto sub = _results.at(kvp.first);
+                            auto profiles = kvp.second;
+                            tasks.push_back([sub, profiles]() { sub->open(profiles); });
+                        }
+                    }
+                    run(tasks, concurrent);
+                }
+
+                // Closes every sensor of the set that is still opened, for the recovery of failed reconfigurations
+                void release()
+                {
+                    for (auto&& sensor : _results)
+                    {
+                        try
+                        {
+                            sensor.second->close();
+                        }
+                        catch (...) {}
+                    }
+                }
+
                 std::map<index_type, std::shared_ptr<stream_profile_interface>> get_profiles() const
                 {
                     return _profiles;
@@ -229,13 +290,64 @@ namespace librealsense
             private:
                 friend class config;
 
+                // Concurrent tasks run on a thread each, besides the first that runs on the calling thread.
+                // All the tasks complete before the first failure is rethrown
+                static void run(const std::vector<std::function<void()>>& tasks, bool concurrent)
+                {
+                    if (!concurrent || tasks.size() < 2)
+                    {
+                        for (auto&& task : tasks)
+                            task();
+                        return;
+                    }
+
+                    std::vector<std::exception_ptr> errors(tasks.size());
+                    std::vector<std::thread> threads;
+                    for (size_t i = 1; i < tasks.size(); ++i)
+                    {
+                        threads.emplace_back([&tasks, &errors, i]()
+                        {
+                            try { tasks[i](); }
+                            catch (...) { errors[i] = std::current_exception(); }
+                        });
+                    }
+                    try { tasks[0](); }
+                    catch (...) { errors[0] = std::current_exception(); }
+
+                    for (auto&& thread : threads)
+                        thread.join();
+                    for (auto&& error : errors)
+                        if (error)
+                            std::rethrow_exception(error);
+                }
+
+                // The sensors share their profile objects, so the profiles of two sets compare by identity
+                bool same_profiles(int sensor, stream_profiles profiles) const
+                {
+                    auto it = _dev_to_profiles.find(sensor);
+                    if (it == _dev_to_profiles.end() || it->second.size() != profiles.size())
+                        return false;
+
+                    auto current = it->second;
+                    std::sort(current.begin(), current.end());
+                    std::sort(profiles.begin(), profiles.end());
+                    return current == profiles;
+                }
+
                 std::map<index_type, std::shared_ptr<stream_profile_interface>> _profiles;
                 std::map<index_type, sensor_interface*> _devices;
                 std::map<int, sensor_interface*> _results;
                 std::map<int, stream_profiles> _dev_to_profiles;
             };
 
-            config() : require_all(true) {}
+            config() : require_all(true), _bandwidth_limit(0) {}
+
+            // Bandwidth the streams of the device may take together, bytes per second, 0 for no limit. Requests with
+            // wildcards are completed with the first profiles that still fit, a resolution that can't fit fails
+            void set_bandwidth_limit(uint64_t bytes_per_second)
+            {
+                _bandwidth_limit = bytes_per_second;
+            }
 
             void enable_streams(stream_profiles profiles)
             {
@@ -442,7 +554,210 @@ namespace librealsense
                 return r;
             }
 
-            stream_profiles map_sub_device(stream_profiles profiles, std::set<index_type> satisfied_streams) const
+            // The matching fields of a profile, read once instead of through virtual calls and casts on every comparison
+            struct profile_entry
+            {
+                std::shared_ptr<stream_profile_interface> profile;
+                request_type fields;
+                bool video;
+            };
+
+            typedef std::tuple<int, int, int, uint32_t, uint32_t, uint32_t> profile_key;
+
+            struct profile_key_hash
+            {
+                size_t operator()(const profile_key& k) const
+                {
+                    size_t h = std::hash<int>()(std::get<0>(k));
+                    h = h * 31 + std::hash<int>()(std::get<1>(k));
+                    h = h * 31 + std::hash<int>()(std::get<2>(k));
+                    h = h * 31 + std::hash<uint32_t>()(std::get<3>(k));
+                    h = h * 31 + std::hash<uint32_t>()(std::get<4>(k));
+                    h = h * 31 + std::hash<uint32_t>()(std::get<5>(k));
+                    return h;
+                }
+            };
+
+            // The profiles of a sensor, in the order of the sensor. Fully specified requests are a lookup, the others
+            // only scan the profiles of their stream type. Both return the first profile a linear search would
+            class profile_index
+            {
+            public:
+                explicit profile_index(const stream_profiles& profiles)
+                    : _has_wildcards(false)
+                {
+                    for (auto&& p : profiles)
+                    {
+                        auto vid = dynamic_cast<video_stream_profile_interface*>(p.get());
+                        request_type fields{ p->get_stream_type(), p->get_stream_index(),
+                            vid ? vid->get_width() : 0, vid ? vid->get_height() : 0, p->get_format(), p->get_framerate() };
+                        _has_wildcards = _has_wildcards || has_wildcards(p.get());
+
+                        auto position = _entries.size();
+                        _entries.push_back({ p, fields, vid != nullptr });
+                        _by_stream[fields.stream].push_back(position);
+                        _exact.emplace(key(fields), position); // keeps the first position of equal profiles
+                    }
+                }
+
+                const std::vector<profile_entry>& entries() const { return _entries; }
+
+                const profile_entry* find(const request_type& request) const
+                {
+                    if (_has_wildcards || has_wildcards(request))
+                        return find_if(request, [](const profile_entry&) { return true; });
+
+                    // motion profiles have no resolution, so they are keyed without one
+                    auto first = _entries.size();
+                    auto it = _exact.find(key(request));
+                    if (it != _exact.end())
+                        first = it->second;
+                    auto unsized = request;
+                    unsized.width = unsized.height = 0;
+                    it = _exact.find(key(unsized));
+                    if (it != _exact.end() && !_entries[it->second].video)
+                        first = std::min(first, it->second);
+                    return first < _entries.size() ? &_entries[first] : nullptr;
+                }
+
+                template<class Predicate>
+                const profile_entry* find_if(const request_type& request, Predicate pred) const
+                {
+                    if (_has_wildcards || request.stream == RS2_STREAM_ANY)
+                    {
+                        for (auto&& e : _entries)
+                            if (matches(e, request) && pred(e))
+                                return &e;
+                        return nullptr;
+                    }
+
+                    auto bucket = _by_stream.find(request.stream);
+                    if (bucket == _by_stream.end())
+                        return nullptr;
+                    for (auto position : bucket->second)
+                    {
+                        auto&& e = _entries[position];
+                        if (matches(e, request) && pred(e))
+                            return &e;
+                    }
+                    return nullptr;
+                }
+
+                // Same as match(stream_profile_interface*, const request_type&)
+                static bool matches(const profile_entry& e, const request_type& b)
+                {
+                    auto&& a = e.fields;
+                    if (a.stream != RS2_STREAM_ANY && b.stream != RS2_STREAM_ANY && (a.stream != b.stream))
+                        return false;
+                    if (a.stream_index != -1 && b.stream_index != -1 && (a.stream_index != b.stream_index))
+                        return false;
+                    if (a.format != RS2_FORMAT_ANY && b.format != RS2_FORMAT_ANY && (a.format != b.format))
+                        return false;
+                    if (a.fps != 0 && b.fps != 0 && (a.fps != b.fps))
+                        return false;
+                    if (e.video)
+                    {
+                        if (a.width != 0 && b.width != 0 && (a.width != b.width))
+                            return false;
+                        if (a.height != 0 && b.height != 0 && (a.height != b.height))
+                            return false;
+                    }
+                    return true;
+                }
+
+                // Same as contradicts(stream_profile_interface*, const std::vector<request_type>&)
+                static bool contradicts(const profile_entry& e, const std::vector<request_type>& others)
+                {
+                    if (!e.video)
+                        return false;
+
+                    auto&& a = e.fields;
+                    for (auto&& request : others)
+                    {
+                        if (a.fps != 0 && request.fps != 0 && (a.fps != request.fps))
+                            return true;
+                    }
+                    for (auto&& request : others)
+                    {
+                        // Patch for DS5U_S that allows different resolutions on multi-pin device
+                        if ((a.height == a.width) && (request.height == request.width))
+                            return false;
+                        if (a.width != 0 && request.width != 0 && (a.width != request.width))
+                            return true;
+                        if (a.height != 0 && request.height != 0 && (a.height != request.height))
+                            return true;
+                    }
+                    return false;
+                }
+
+            private:
+                static profile_key key(const request_type& r)
+                {
+                    return profile_key(r.stream, r.stream_index, r.format, r.fps, r.width, r.height);
+                }
+
+                std::vector<profile_entry> _entries;
+                std::unordered_map<profile_key, size_t, profile_key_hash> _exact;
+                std::map<rs2_stream, std::vector<size_t>> _by_stream;
+                bool _has_wildcards;
+            };
+
+            typedef std::vector<std::tuple<int, int, uint32_t, uint32_t, int, uint32_t>> requests_key;
+            typedef std::multimap<int, std::shared_ptr<stream_profile_interface>> streams_mapping;
+
+            // The profile indexes of the sensors of a device, and the mappings already resolved on it
+            struct device_index
+            {
+                std::vector<std::pair<profile_index, profile_index>> sensors; // superset and all the profiles
+                std::mutex mutex;
+                std::map<requests_key, streams_mapping> resolved;
+            };
+
+            // The profiles of a sensor don't change once listed, so the indexes are built once per device
+            static std::shared_ptr<device_index> get_device_index(device_interface* dev)
+            {
+                static std::mutex mutex;
+                static std::map<const device_interface*, std::pair<std::weak_ptr<device_interface>, std::shared_ptr<device_index>>> indexes;
+
+                std::weak_ptr<device_interface> owner;
+                try
+                {
+                    owner = dev->shared_from_this();
+                }
+                catch (const std::bad_weak_ptr&) {}
+
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    auto it = indexes.find(dev);
+                    if (it != indexes.end() && !it->second.first.expired() && it->second.first.lock().get() == dev)
+                        return it->second.second;
+                }
+
+                auto index = std::make_shared<device_index>();
+                for (size_t i = 0; i < dev->get_sensors_count(); ++i)
+                {
+                    auto&& sub = dev->get_sensor(i);
+                    index->sensors.emplace_back(profile_index(sub.get_stream_profiles(profile_tag::PROFILE_TAG_SUPERSET)),
+                                                profile_index(sub.get_stream_profiles(profile_tag::PROFILE_TAG_ANY)));
+                }
+
+                if (!owner.expired())
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    for (auto it = indexes.begin(); it != indexes.end();)
+                    {
+                        if (it->second.first.expired())
+                            it = indexes.erase(it);
+                        else
+                            ++it;
+                    }
+                    indexes[dev] = std::make_pair(owner, index);
+                }
+                return index;
+            }
+
+            stream_profiles map_sub_device(const profile_index& profiles, const sensor_interface& sensor,
+                                           std::set<index_type> satisfied_streams, uint64_t used) const
             {
                 stream_profiles rv;
                 try
@@ -455,11 +770,7 @@ namespace librealsense
                         if (satisfied_streams.count(kvp.first)) continue; // skip satisfied requests
 
                          // if any profile on the subdevice can supply this request, consider it satisfiable
-                        auto it = std::find_if(begin(profiles), end(profiles), [&kvp](const std::shared_ptr<stream_profile_interface>& profile)
-                        {
-                            return match(profile.get(), kvp.second);
-                        });
-                        if (it != end(profiles))
+                        if (profiles.find(kvp.second))
                         {
                             targets.push_back(kvp.second); // store that this request is going to this subdevice
                             satisfied_streams.insert(kvp.first); // mark stream as satisfied
@@ -468,19 +779,51 @@ namespace librealsense
 
                     if (targets.size() > 0) // if subdevice is handling any streams
                     {
-                        auto_complete(targets, profiles);
+                        // Under a bandwidth limit, the explicit requests are counted first and every completed
+                        // request adds to them
+                        stream_profiles chosen;
+                        if (_bandwidth_limit)
+                        {
+                            for (auto && t : targets)
+                            {
+                                if (has_wildcards(t)) continue;
+                                if (auto p = profiles.find(t))
+                                    chosen.push_back(p->profile);
+                            }
+                        }
 
-                        for (auto && t : targets)
+                        for (auto & request : targets)
                         {
-                            for (auto && p : profiles)
+                            if (!has_wildcards(request)) continue;
+                            auto candidate = profiles.find_if(request, [&](const profile_entry& e)
+                            {
+                                if (profile_index::contradicts(e, targets))
+                                    return false;
+                                if (!_bandwidth_limit)
+                                    return true;
+                                auto with = chosen;
+                                with.push_back(e.profile);
+                                return used + estimate_bandwidth(sensor, with) <= _bandwidth_limit;
+                            });
+                            if (candidate)
                             {
-                                if (match(p.get(), t))
-                                {
-                                    rv.push_back(p);
-                                    break;
-                                }
+                                request = to_request(candidate->profile.get());
+                                if (_bandwidth_limit)
+                                    chosen.push_back(candidate->profile);
                             }
+                            if (has_wildcards(request))
+                                throw std::runtime_error(std::string("Couldn't autocomplete request for subdevice"));
                         }
+
+                        for (auto && t : targets)
+                        {
+                            if (auto p = profiles.find(t))
+                                rv.push_back(p->profile);
+                        }
+
+                        if (_bandwidth_limit && used + estimate_bandwidth(sensor, rv) > _bandwidth_limit)
+                            throw std::runtime_error(to_string() << "Requests for " << sensor.get_info(RS2_CAMERA_INFO_NAME)
+                                << " exceed the " << _bandwidth_limit / 1000000 << " MB/s of USB bandwidth available");
                     }
                 }
                 catch (std::exception e)
@@ -490,35 +833,64 @@ namespace librealsense
                 return rv;
             }
 
-            std::multimap<int, std::shared_ptr<stream_profile_interface>> map_streams(device_interface* dev) const
+            streams_mapping map_streams(device_interface* dev) const
             {
-                std::multimap<int, std::shared_ptr<stream_profile_interface>> out;
+                auto index = get_device_index(dev);
+
+                requests_key key;
+                for (auto&& kvp : _requests)
+                {
+                    auto&& r = kvp.second;
+                    key.emplace_back(r.stream, r.stream_index, r.width, r.height, r.format, r.fps);
+                }
+                // What a limit lets through changes as other sensors on the link open and close, so it isn't cached
+                if (!_bandwidth_limit)
+                {
+                    std::lock_guard<std::mutex> lock(index->mutex);
+                    auto it = index->resolved.find(key);
+                    if (it != index->resolved.end())
+                        return it->second;
+                }
+
+                streams_mapping out;
                 std::set<index_type> satisfied_streams;
+                uint64_t used = 0;
 
                 // Algorithm assumes get_adjacent_devices always
                 // returns the devices in the same order
-                for (size_t i = 0; i < dev->get_sensors_count(); ++i)
+                for (size_t i = 0; i < index->sensors.size(); ++i)
                 {
-                    auto&& sub = dev->get_sensor(i);
-
-                    auto default_profiles = map_sub_device(sub.get_stream_profiles(profile_tag::PROFILE_TAG_SUPERSET), satisfied_streams);
-                    auto any_profiles = map_sub_device(sub.get_stream_profiles(profile_tag::PROFILE_TAG_ANY), satisfied_streams);
+                    auto&& sensor = dev->get_sensor(i);
+                    auto default_profiles = map_sub_device(index->sensors[i].first, sensor, satisfied_streams, used);
+                    auto any_profiles = map_sub_device(index->sensors[i].second, sensor, satisfied_streams, used);
 
                     //use any streams if default streams wasn't satisfy
                     auto profiles = default_profiles.size() == any_profiles.size() ? default_profiles : any_profiles;
 
                     for (auto p : profiles)
                         out.emplace((int)i, p);
+                    if (_bandwidth_limit)
+                        used += estimate_bandwidth(sensor, profiles);
                 }
 
                 if(_requests.size() != out.size())
                     throw std::runtime_error(std::string("Couldn't resolve requests"));
 
+                if (_bandwidth_limit)
+                    return out;
+
+                std::lock_guard<std::mutex> lock(index->mutex);
+                if (index->resolved.size() >= max_resolved_per_device)
+                    index->resolved.clear();
+                index->resolved[key] = out;
                 return out;
             }
 
+            static const size_t max_resolved_per_device = 64;
+
             std::map<index_type, request_type> _requests;
             bool require_all;
+            uint64_t _bandwidth_limit;
         };
     }
 }
@@ -7,18 +7,99 @@
 
 #include "core/video.h"
 #include "proc/synthetic-stream.h"
+#include "option.h"
 #include "environment.h"
 #include "align.h"
 #include "stream.h"
+#include "proc/projection.h"
 
 namespace librealsense
 {
     template<int N> struct bytes { byte b[N]; };
 
-    template<class GET_DEPTH, class TRANSFER_PIXEL>
-    void align_images(const rs2_intrinsics& depth_intrin, const rs2_extrinsics& depth_to_other,
-        const rs2_intrinsics& other_intrin, GET_DEPTH get_depth, TRANSFER_PIXEL transfer_pixel)
+    // Per-pixel tables for one (depth intrinsics, depth-to-other extrinsics) pair. Each entry holds the ray of a
+    // depth pixel corner already rotated into the other stream, so a point at depth z lands on z * ray + translation
+    struct align_lut
+    {
+        rs2_intrinsics depth_intrin;
+        rs2_extrinsics depth_to_other;
+        std::vector<float3> top_left;
+        std::vector<float3> bottom_right;
+    };
+
+    static bool same_lut_key(const align_lut& lut, const rs2_intrinsics& depth_intrin, const rs2_extrinsics& depth_to_other)
+    {
+        return !memcmp(&lut.depth_intrin, &depth_intrin, sizeof(depth_intrin)) &&
+            !memcmp(&lut.depth_to_other, &depth_to_other, sizeof(depth_to_other));
+    }
+
+    static void fill_lut_rays(std::vector<float3>& rays, const rs2_intrinsics& depth_intrin, const rs2_extrinsics& depth_to_other, float offset)
+    {
+        auto r = depth_to_other.rotation;
+        rays.resize(depth_intrin.width * depth_intrin.height);
+        for (int y = 0; y < depth_intrin.height; ++y)
+        {
+            for (int x = 0; x < depth_intrin.width; ++x)
+            {
+                float pixel[2] = { x + offset, y + offset }, ray[3];
+                rs2_deproject_pixel_to_point(ray, &depth_intrin, pixel, 1.f);
+                rays[y * depth_intrin.width + x] = { r[0] * ray[0] + r[3] * ray[1] + r[6],
+                                                     r[1] * ray[0] + r[4] * ray[1] + r[7],
+                                                     r[2] * ray[0] + r[5] * ray[1] + r[8] };
+            }
+        }
+    }
+
+    // The tables only depend on calibration, so they are shared between all align blocks
+    // processing the same pair of streams and released once the last user is gone
+    static std::shared_ptr<const align_lut> acquire_lut(const rs2_intrinsics& depth_intrin, const rs2_extrinsics& depth_to_other)
+    {
+        static std::mutex cache_mutex;
+        static std::vector<std::weak_ptr<const align_lut>> cache;
+
+        std::lock_guard<std::mutex> lock(cache_mutex);
+        cache.erase(std::remove_if(cache.begin(), cache.end(),
+            [](const std::weak_ptr<const align_lut>& entry) { return entry.expired(); }), cache.end());
+
+        for (auto&& entry : cache)
+        {
+            auto lut = entry.lock();
+            if (lut && same_lut_key(*lut, depth_intrin, depth_to_other))
+                return lut;
+        }
+
+        auto lut = std::make_shared<align_lut>();
+        lut->depth_intrin = depth_intrin;
+        lut->depth_to_other = depth_to_other;
+        fill_lut_rays(lut->top_left, depth_intrin, depth_to_other, -0.5f);
+        fill_lut_rays(lut->bottom_right, depth_intrin, depth_to_other, 0.5f);
+        cache.push_back(lut);
+        return lut;
+    }
+
+    align::align(rs2_stream to_stream)
+        : _to_stream_type(to_stream),
+          _depth_scale(0),
+          _processing_threads(processing_threads_default),
+          _executor(processing_threads_default)
+    {
+        register_processing_threads_option(*this, _processing_threads, _executor, _mutex,
+            "Number of threads used to align each frame of another stream to depth, 0 for all hardware threads", "align");
+    }
+
+    const align_lut& align::get_lut(const rs2_intrinsics& depth_intrin, const rs2_extrinsics& depth_to_other)
     {
+        if (!_lut || !same_lut_key(*_lut, depth_intrin, depth_to_other))
+            _lut = acquire_lut(depth_intrin, depth_to_other);
+        return *_lut;
+    }
+
+    template<rs2_distortion MODEL, class GET_DEPTH, class TRANSFER_PIXEL>
+    void align_images_with(const align_lut& lut, const rs2_intrinsics& other_intrin, GET_DEPTH get_depth, TRANSFER_PIXEL transfer_pixel)
+    {
+        auto& depth_intrin = lut.depth_intrin;
+        auto t = lut.depth_to_other.translation;
+
         // Iterate over the pixels of the depth image
 #pragma omp parallel for schedule(dynamic)
         for (int depth_y = 0; depth_y < depth_intrin.height; ++depth_y)
@@ -30,18 +111,18 @@ namespace librealsense
                 if (float depth = get_depth(depth_pixel_index))
                 {
                     // Map the top-left corner of the depth pixel onto the other image
-                    float depth_pixel[2] = { depth_x - 0.5f, depth_y - 0.5f }, depth_point[3], other_point[3], other_pixel[2];
-                    rs2_deproject_pixel_to_point(depth_point, &depth_intrin, depth_pixel, depth);
-                    rs2_transform_point_to_point(other_point, &depth_to_other, depth_point);
-                    rs2_project_point_to_pixel(other_pixel, &other_intrin, other_point);
+                    auto& top_left = lut.top_left[depth_pixel_index];
+                    float other_point[3] = { depth * top_left.x + t[0], depth * top_left.y + t[1], depth * top_left.z + t[2] }, other_pixel[2];
+                    project_point<MODEL>(other_pixel, other_intrin, other_point);
                     const int other_x0 = static_cast<int>(other_pixel[0] + 0.5f);
                     const int other_y0 = static_cast<int>(other_pixel[1] + 0.5f);
 
                     // Map the bottom-right corner of the depth pixel onto the other image
-                    depth_pixel[0] = depth_x + 0.5f; depth_pixel[1] = depth_y + 0.5f;
-                    rs2_deproject_pixel_to_point(depth_point, &depth_intrin, depth_pixel, depth);
-                    rs2_transform_point_to_point(other_point, &depth_to_other, depth_point);
-                    rs2_project_point_to_pixel(other_pixel, &other_intrin, other_point);
+                    auto& bottom_right = lut.bottom_right[depth_pixel_index];
+                    other_point[0] = depth * bottom_right.x + t[0];
+                    other_point[1] = depth * bottom_right.y + t[1];
+                    other_point[2] = depth * bottom_right.z + t[2];
+                    project_point<MODEL>(other_pixel, other_intrin, other_point);
                     const int other_x1 = static_cast<int>(other_pixel[0] + 0.5f);
                     const int other_y1 = static_cast<int>(other_pixel[1] + 0.5f);
 
@@ -61,6 +142,24 @@ namespace librealsense
         }
     }
 
+    // The projection onto the other image is specialized for its distortion model, chosen here once per frame
+    template<class GET_DEPTH, class TRANSFER_PIXEL>
+    void align_images(const align_lut& lut, const rs2_intrinsics& other_intrin, GET_DEPTH get_depth, TRANSFER_PIXEL transfer_pixel)
+    {
+        switch (projection_model(other_intrin.model))
+        {
+        case RS2_DISTORTION_MODIFIED_BROWN_CONRADY:
+            align_images_with<RS2_DISTORTION_MODIFIED_BROWN_CONRADY>(lut, other_intrin, get_depth, transfer_pixel);
+            break;
+        case RS2_DISTORTION_FTHETA:
+            align_images_with<RS2_DISTORTION_FTHETA>(lut, other_intrin, get_depth, transfer_pixel);
+            break;
+        default:
+            align_images_with<RS2_DISTORTION_NONE>(lut, other_intrin, get_depth, transfer_pixel);
+            break;
+        }
+    }
+
     void align::align_z_to_other(byte* aligned_data, const rs2::video_frame& depth, const rs2::video_stream_profile& other_profile, float z_scale)
     {
         auto depth_profile = depth.get_profile().as<rs2::video_stream_profile>();
@@ -72,7 +171,7 @@ namespace librealsense
         auto z_pixels = reinterpret_cast<const uint16_t*>(depth.get_data());
         auto out_z = (uint16_t *)(aligned_data);
 
-        align_images(z_intrin, z_to_other, other_intrin,
+        align_images(get_lut(z_intrin, z_to_other), other_intrin,
             [z_pixels, z_scale](int z_pixel_index) { return z_scale * z_pixels[z_pixel_index]; },
             [out_z, z_pixels](int z_pixel_index, int other_pixel_index)
         {
@@ -82,37 +181,84 @@ namespace librealsense
         });
     }
 
-    template<int N, class GET_DEPTH>
-    void align_other_to_depth_bytes(byte* other_aligned_to_depth, GET_DEPTH get_depth, const rs2_intrinsics& depth_intrin, const rs2_extrinsics& depth_to_other, const rs2_intrinsics& other_intrin, const byte* other_pixels)
+    // Index of the pixel of the other image each depth pixel of a row takes its value from, -1 where there is none.
+    // It's the bottom-right pixel of the rectangle covered by the depth pixel, the one a copy of the whole rectangle ends with
+    template<rs2_distortion MODEL>
+    void other_indices_with(const align_lut& lut, const rs2_intrinsics& other_intrin, const uint16_t* z_pixels, float z_scale, int depth_y, int* indices)
+    {
+        auto t = lut.depth_to_other.translation;
+        const int width = lut.depth_intrin.width;
+        int depth_pixel_index = depth_y * width;
+        for (int depth_x = 0; depth_x < width; ++depth_x, ++depth_pixel_index)
+        {
+            indices[depth_x] = -1;
+            float depth = z_scale * z_pixels[depth_pixel_index];
+            if (!depth)
+                continue;
+
+            auto& top_left = lut.top_left[depth_pixel_index];
+            float other_point[3] = { depth * top_left.x + t[0], depth * top_left.y + t[1], depth * top_left.z + t[2] }, other_pixel[2];
+            project_point<MODEL>(other_pixel, other_intrin, other_point);
+            const int other_x0 = static_cast<int>(other_pixel[0] + 0.5f);
+            const int other_y0 = static_cast<int>(other_pixel[1] + 0.5f);
+
+            auto& bottom_right = lut.bottom_right[depth_pixel_index];
+            other_point[0] = depth * bottom_right.x + t[0];
+            other_point[1] = depth * bottom_right.y + t[1];
+            other_point[2] = depth * bottom_right.z + t[2];
+            project_point<MODEL>(other_pixel, other_intrin, other_point);
+            const int other_x1 = static_cast<int>(other_pixel[0] + 0.5f);
+            const int other_y1 = static_cast<int>(other_pixel[1] + 0.5f);
+
+            if (other_x0 < 0 || other_y0 < 0 || other_x1 >= other_intrin.width || other_y1 >= other_intrin.height ||
+                other_x1 < other_x0 || other_y1 < other_y0)
+                continue;
+
+            indices[depth_x] = other_y1 * other_intrin.width + other_x1;
+        }
+    }
+
+    typedef void(*other_indices_function)(const align_lut&, const rs2_intrinsics&, const uint16_t*, float, int, int*);
+
+    static other_indices_function other_indices_for(const rs2_intrinsics& other_intrin)
+    {
+        switch (projection_model(other_intrin.model))
+        {
+        case RS2_DISTORTION_MODIFIED_BROWN_CONRADY: return &other_indices_with<RS2_DISTORTION_MODIFIED_BROWN_CONRADY>;
+        case RS2_DISTORTION_FTHETA: return &other_indices_with<RS2_DISTORTION_FTHETA>;
+        default: return &other_indices_with<RS2_DISTORTION_NONE>;
+        }
+    }
+
+    // Copies the pixels of the other image at the indices of a row, pixels with no index keep their value
+    template<int N>
+    void gather_row(const byte* other_pixels, const int* indices, int count, byte* aligned_row)
     {
-        auto in_other = (const bytes<N> *)(other_pixels);
-        auto out_other = (bytes<N> *)(other_aligned_to_depth);
-        align_images(depth_intrin, depth_to_other, other_intrin, get_depth,
-            [out_other, in_other](int depth_pixel_index, int other_pixel_index) { out_other[depth_pixel_index] = in_other[other_pixel_index]; });
+        auto in = reinterpret_cast<const bytes<N>*>(other_pixels);
+        auto out = reinterpret_cast<bytes<N>*>(aligned_row);
+        for (int x = 0; x < count; ++x)
+        {
+            auto index = indices[x];
+            if (index >= 0)
+                out[x] = in[index];
+        }
     }
 
-    template<class GET_DEPTH>
-    void align_other_to_depth(byte* other_aligned_to_depth, GET_DEPTH get_depth, const rs2_intrinsics& depth_intrin, const rs2_extrinsics & depth_to_other, const rs2_intrinsics& other_intrin, const byte* other_pixels, rs2_format other_format)
+    typedef void(*gather_function)(const byte*, const int*, int, byte*);
+
+    // NOTE: gather_row<2> is not appropriate for RS2_FORMAT_YUYV/RS2_FORMAT_RAW10 images, no logic prevents U/V channels from being written to one another
+    static gather_function gather_for(rs2_format other_format)
     {
         switch (other_format)
         {
-        case RS2_FORMAT_Y8:
-            align_other_to_depth_bytes<1>(other_aligned_to_depth, get_depth, depth_intrin, depth_to_other, other_intrin, other_pixels);
-            break;
+        case RS2_FORMAT_Y8: return &gather_row<1>;
         case RS2_FORMAT_Y16:
-        case RS2_FORMAT_Z16:
-            align_other_to_depth_bytes<2>(other_aligned_to_depth, get_depth, depth_intrin, depth_to_other, other_intrin, other_pixels);
-            break;
+        case RS2_FORMAT_Z16: return &gather_row<2>;
         case RS2_FORMAT_RGB8:
-        case RS2_FORMAT_BGR8:
-            align_other_to_depth_bytes<3>(other_aligned_to_depth, get_depth, depth_intrin, depth_to_other, other_intrin, other_pixels);
-            break;
+        case RS2_FORMAT_BGR8: return &gather_row<3>;
         case RS2_FORMAT_RGBA8:
-        case RS2_FORMAT_BGRA8:
-            align_other_to_depth_bytes<4>(other_aligned_to_depth, get_depth, depth_intrin, depth_to_other, other_intrin, other_pixels);
-            break;
-        default:
-            assert(false); // NOTE: rs2_align_other_to_depth_bytes<2>(...) is not appropriate for RS2_FORMAT_YUYV/RS2_FORMAT_RAW10 images, no logic prevents U/V channels from being written to one another
+        case RS2_FORMAT_BGRA8: return &gather_row<4>;
+        default: return nullptr;
         }
     }
 
@@ -128,8 +274,27 @@ namespace librealsense
         auto z_pixels = reinterpret_cast<const uint16_t*>(depth.get_data());
         auto other_pixels = reinterpret_cast<const byte*>(other.get_data());
 
-        align_other_to_depth(aligned_data, [z_pixels, z_scale](int z_pixel_index) { return z_scale * z_pixels[z_pixel_index]; },
-            z_intrin, z_to_other, other_intrin, other_pixels, other_profile.format());
+        auto gather = gather_for(other_profile.format());
+        if (!gather)
+        {
+            assert(false);
+            return;
+        }
+        auto other_indices = other_indices_for(other_intrin);
+        auto& lut = get_lut(z_intrin, z_to_other);
+        const int width = z_intrin.width;
+        const size_t row_size = size_t(width) * other.get_bytes_per_pixel();
+
+        // Rows are split between the threads, each one computes the indices of a row before copying its pixels
+        _executor.for_each_range(size_t(z_intrin.height), 1, [&](size_t begin, size_t end)
+        {
+            std::vector<int> indices(width);
+            for (size_t y = begin; y < end; ++y)
+            {
+                other_indices(lut, other_intrin, z_pixels, z_scale, int(y), indices.data());
+                gather(other_pixels, indices.data(), width, aligned_data + y * row_size);
+            }
+        });
     }
 
     std::shared_ptr<rs2::video_stream_profile> align::create_aligned_profile(
@@ -268,4 +433,159 @@ namespace librealsense
         auto new_composite = source.allocate_composite_frame(std::move(output_frames));
         return new_composite;
     }
+
+    // A depth pixel with data, its corners deprojected into the depth stream
+    struct depth_corners
+    {
+        int index;
+        float3 top_left;
+        float3 bottom_right;
+    };
+
+    struct align_target
+    {
+        rs2_intrinsics intrin;
+        pose depth_to_target;
+        uint16_t* out_z;
+    };
+
+    template<rs2_distortion MODEL>
+    void align_corners_with(const std::vector<depth_corners>& corners, const uint16_t* z_pixels, const align_target& target)
+    {
+        auto& intrin = target.intrin;
+        for (auto&& c : corners)
+        {
+            auto top_left = target.depth_to_target * c.top_left;
+            auto bottom_right = target.depth_to_target * c.bottom_right;
+            float pixel0[2], pixel1[2];
+            project_point<MODEL>(pixel0, intrin, &top_left.x);
+            project_point<MODEL>(pixel1, intrin, &bottom_right.x);
+            const int x0 = static_cast<int>(pixel0[0] + 0.5f), y0 = static_cast<int>(pixel0[1] + 0.5f);
+            const int x1 = static_cast<int>(pixel1[0] + 0.5f), y1 = static_cast<int>(pixel1[1] + 0.5f);
+
+            if (x0 < 0 || y0 < 0 || x1 >= intrin.width || y1 >= intrin.height)
+                continue;
+
+            auto z = z_pixels[c.index];
+            for (int y = y0; y <= y1; ++y)
+            {
+                for (int x = x0; x <= x1; ++x)
+                {
+                    auto& out = target.out_z[y * intrin.width + x];
+                    out = out ? std::min(out, z) : z;
+                }
+            }
+        }
+    }
+
+    static void align_corners(const std::vector<depth_corners>& corners, const uint16_t* z_pixels, const align_target& target)
+    {
+        switch (projection_model(target.intrin.model))
+        {
+        case RS2_DISTORTION_MODIFIED_BROWN_CONRADY:
+            align_corners_with<RS2_DISTORTION_MODIFIED_BROWN_CONRADY>(corners, z_pixels, target);
+            break;
+        case RS2_DISTORTION_FTHETA:
+            align_corners_with<RS2_DISTORTION_FTHETA>(corners, z_pixels, target);
+            break;
+        default:
+            align_corners_with<RS2_DISTORTION_NONE>(corners, z_pixels, target);
+            break;
+        }
+    }
+
+    multi_align::multi_align(std::vector<rs2_stream> to_streams)
+        : align(to_streams.empty() ? RS2_STREAM_ANY : to_streams.front()), _to_streams(std::move(to_streams))
+    {
+        if (_to_streams.empty())
+            throw invalid_value_exception("Multi-target align requires at least one target stream");
+        for (auto stream : _to_streams)
+            if (stream == RS2_STREAM_DEPTH || stream == RS2_STREAM_ANY)
+                throw invalid_value_exception(to_string() << "Multi-target align can't align depth to " << stream);
+    }
+
+    bool multi_align::should_process(const rs2::frame& frame)
+    {
+        if (!frame)
+            return false;
+
+        auto set = frame.as<rs2::frameset>();
+        if (!set)
+            return false;
+
+        //process composite frame only if it contains a depth frame and at least one of the targets
+        bool has_target = false, has_depth = false;
+        set.foreach([&](const rs2::frame& f)
+        {
+            auto profile = f.get_profile();
+            if (profile.stream_type() == RS2_STREAM_DEPTH && profile.format() == RS2_FORMAT_Z16)
+                has_depth = true;
+            else if (std::find(_to_streams.begin(), _to_streams.end(), profile.stream_type()) != _to_streams.end())
+                has_target = true;
+        });
+        return has_target && has_depth;
+    }
+
+    rs2::frame multi_align::process_frame(const rs2::frame_source& source, const rs2::frame& f)
+    {
+        std::vector<rs2::frame> output_frames;
+        std::vector<align_target> targets;
+
+        auto frames = f.as<rs2::frameset>();
+        auto depth = frames.first_or_default(RS2_STREAM_DEPTH, RS2_FORMAT_Z16).as<rs2::depth_frame>();
+        auto depth_profile = depth.get_profile().as<rs2::video_stream_profile>();
+
+        _depth_scale = ((librealsense::depth_frame*)depth.get())->get_units();
+
+        // Every frame of a target stream gets its aligned depth, in the order of the targets
+        for (auto stream : _to_streams)
+        {
+            frames.foreach([&](const rs2::frame& to)
+            {
+                if (to.get_profile().stream_type() != stream || !to.is<rs2::video_frame>())
+                    return;
+
+                auto aligned = allocate_aligned_frame(source, depth, to).as<rs2::video_frame>();
+                if (!aligned)
+                    return;
+
+                auto to_profile = to.get_profile().as<rs2::video_stream_profile>();
+                auto out_z = reinterpret_cast<uint16_t*>(const_cast<void*>(aligned.get_data()));
+                memset(out_z, 0, aligned.get_height() * aligned.get_stride_in_bytes());
+                targets.push_back({ to_profile.get_intrinsics(), to_pose(depth_profile.get_extrinsics_to(to_profile)), out_z });
+                output_frames.push_back(aligned);
+            });
+        }
+
+        if (targets.empty())
+            return rs2::frame();
+
+        // The corners are deprojected into the depth stream itself, that table is shared by all the targets
+        const rs2_extrinsics identity = { { 1, 0, 0, 0, 1, 0, 0, 0, 1 }, { 0, 0, 0 } };
+        auto& lut = get_lut(depth_profile.get_intrinsics(), identity);
+        auto z_pixels = reinterpret_cast<const uint16_t*>(depth.get_data());
+        const float z_scale = _depth_scale;
+        const int width = lut.depth_intrin.width, height = lut.depth_intrin.height;
+
+        _executor.for_each_range(size_t(height), 1, [&](size_t begin, size_t end)
+        {
+            std::vector<depth_corners> corners;
+            corners.reserve(width);
+            for (int y = int(begin); y < int(end); ++y)
+            {
+                // The row is deprojected once, skipping the pixels without depth, then projected into each target
+                corners.clear();
+                for (int i = y * width; i < (y + 1) * width; ++i)
+                {
+                    if (float z = z_scale * z_pixels[i])
+                        corners.push_back({ i, lut.top_left[i] * z, lut.bottom_right[i] * z });
+                }
+
+                for (auto&& target : targets)
+                    align_corners(corners, z_pixels, target);
+            }
+        });
+
+        return source.allocate_composite_frame(std::move(output_frames));
+    }
 }
@@ -5,17 +5,21 @@
 
 #include <map>
 #include <utility>
+#include <vector>
 #include "core/processing.h"
 #include "proc/synthetic-stream.h"
 #include "image.h"
 #include "source.h"
+#include "concurrency.h"
 
 namespace librealsense
 {
+    struct align_lut;
+
     class align : public generic_processing_block
     {
     public:
-        align(rs2_stream to_stream) : _to_stream_type(to_stream), _depth_scale(0){}
+        align(rs2_stream to_stream);
 
     protected:
         bool should_process(const rs2::frame& frame) override;
@@ -27,6 +31,9 @@ namespace librealsense
 
         virtual void align_other_to_z(byte* aligned_data, const rs2::video_frame& depth, const rs2::video_frame& other, float z_scale);
 
+        // Fills the allocated aligned frame, overridden by implementations that keep the output in device memory
+        virtual void align_frames(const rs2::video_frame& aligned, const rs2::video_frame& from, const rs2::video_frame& to);
+
         std::shared_ptr<rs2::video_stream_profile> create_aligned_profile(
             rs2::video_stream_profile& original_profile,
             rs2::video_stream_profile& to_profile);
@@ -35,9 +42,29 @@ namespace librealsense
         std::map<std::pair<stream_profile_interface*, stream_profile_interface*>, std::shared_ptr<rs2::video_stream_profile>> _align_stream_unique_ids;
         rs2::stream_profile _source_stream_profile;
         float _depth_scale;
+        uint8_t _processing_threads;
+        parallel_executor _executor;
+
+        const align_lut& get_lut(const rs2_intrinsics& depth_intrin, const rs2_extrinsics& depth_to_other);
 
-    private:
         rs2::frame allocate_aligned_frame(const rs2::frame_source& source, const rs2::video_frame& from, const rs2::video_frame& to);
-        void align_frames(const rs2::video_frame& aligned, const rs2::video_frame& from, const rs2::video_frame& to);
+
+    private:
+        std::shared_ptr<const align_lut> _lut;
+    };
+
+    // Aligns depth to several streams at once. Each depth pixel is read and deprojected once, then projected into every
+    // target, and the aligned depths are published in the order of the targets
+    class multi_align : public align
+    {
+    public:
+        multi_align(std::vector<rs2_stream> to_streams);
+
+    protected:
+        bool should_process(const rs2::frame& frame) override;
+        rs2::frame process_frame(const rs2::frame_source& source, const rs2::frame& f) override;
+
+    private:
+        std::vector<rs2_stream> _to_streams;
     };
 }
@@ -0,0 +1,108 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#include "../include/librealsense2/rsutil.h"
+
+#include "concurrency.h"
+#include "proc/projection.h"
+#include "proc/color-to-depth.h"
+
+namespace librealsense
+{
+    template<rs2_distortion DEPTH_MODEL, rs2_distortion COLOR_MODEL>
+    static void search_depth_pixel(const color_to_depth_search& search, const float from_pixel[2], float to_pixel[2])
+    {
+        auto& depth_intrin = search.depth_intrin;
+
+        // The ends of the line are found like in rsutil.h, only the steps along it use the specialized kernels
+        float start_pixel[2] = { 0 }, min_point[3] = { 0 }, min_transformed_point[3] = { 0 };
+        rs2_deproject_pixel_to_point(min_point, &search.color_intrin, from_pixel, search.depth_min);
+        rs2_transform_point_to_point(min_transformed_point, &search.color_to_depth, min_point);
+        rs2_project_point_to_pixel(start_pixel, &depth_intrin, min_transformed_point);
+        adjust_2D_point_to_boundary(start_pixel, depth_intrin.width, depth_intrin.height);
+
+        float end_pixel[2] = { 0 }, max_point[3] = { 0 }, max_transformed_point[3] = { 0 };
+        rs2_deproject_pixel_to_point(max_point, &search.color_intrin, from_pixel, search.depth_max);
+        rs2_transform_point_to_point(max_transformed_point, &search.color_to_depth, max_point);
+        rs2_project_point_to_pixel(end_pixel, &depth_intrin, max_transformed_point);
+        adjust_2D_point_to_boundary(end_pixel, depth_intrin.width, depth_intrin.height);
+
+        to_pixel[0] = to_pixel[1] = -1.f;
+        float min_dist = -1;
+        for (float p[2] = { start_pixel[0], start_pixel[1] }; is_pixel_in_line(p, start_pixel, end_pixel); next_pixel_in_line(p, start_pixel, end_pixel))
+        {
+            float depth = search.depth_scale * search.data[(int)p[1] * depth_intrin.width + (int)p[0]];
+            if (depth == 0)
+                continue;
+
+            float projected_pixel[2] = { 0 }, point[3] = { 0 }, transformed_point[3] = { 0 };
+            deproject_pixel<DEPTH_MODEL>(point, depth_intrin, p, depth);
+            rs2_transform_point_to_point(transformed_point, &search.depth_to_color, point);
+            project_point<COLOR_MODEL>(projected_pixel, search.color_intrin, transformed_point);
+
+            float new_dist = pow((projected_pixel[1] - from_pixel[1]), 2) + pow((projected_pixel[0] - from_pixel[0]), 2);
+            if (new_dist < min_dist || min_dist < 0)
+            {
+                min_dist = new_dist;
+                to_pixel[0] = p[0];
+                to_pixel[1] = p[1];
+            }
+        }
+    }
+
+    template<rs2_distortion DEPTH_MODEL, rs2_distortion COLOR_MODEL>
+    static void search_depth_pixels(const color_to_depth_search& search, const float* from_pixels, float* to_pixels,
+        size_t count, parallel_executor& executor)
+    {
+        executor.for_each_range(count, 1, [&](size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; ++i)
+                search_depth_pixel<DEPTH_MODEL, COLOR_MODEL>(search, from_pixels + 2 * i, to_pixels + 2 * i);
+        });
+    }
+
+    template<rs2_distortion DEPTH_MODEL>
+    static void search_depth_pixels(const color_to_depth_search& search, const float* from_pixels, float* to_pixels,
+        size_t count, parallel_executor& executor)
+    {
+        switch (projection_model(search.color_intrin.model))
+        {
+        case RS2_DISTORTION_MODIFIED_BROWN_CONRADY:
+            search_depth_pixels<DEPTH_MODEL, RS2_DISTORTION_MODIFIED_BROWN_CONRADY>(search, from_pixels, to_pixels, count, executor);
+            break;
+        case RS2_DISTORTION_FTHETA:
+            search_depth_pixels<DEPTH_MODEL, RS2_DISTORTION_FTHETA>(search, from_pixels, to_pixels, count, executor);
+            break;
+        default:
+            search_depth_pixels<DEPTH_MODEL, RS2_DISTORTION_NONE>(search, from_pixels, to_pixels, count, executor);
+            break;
+        }
+    }
+
+    void project_color_pixels_to_depth_pixels(const color_to_depth_search& search, const float* from_pixels, float* to_pixels,
+        size_t count, parallel_executor& executor)
+    {
+        if (deprojection_model(search.depth_intrin.model) == RS2_DISTORTION_INVERSE_BROWN_CONRADY)
+            search_depth_pixels<RS2_DISTORTION_INVERSE_BROWN_CONRADY>(search, from_pixels, to_pixels, count, executor);
+        else
+            search_depth_pixels<RS2_DISTORTION_NONE>(search, from_pixels, to_pixels, count, executor);
+    }
+
+    void project_color_pixels_to_depth_pixels(const color_to_depth_search& search, const float* from_pixels, float* to_pixels,
+        size_t count)
+    {
+        static std::mutex shared_mutex;
+        static parallel_executor shared_executor(0);
+
+        std::unique_lock<std::mutex> lock(shared_mutex, std::try_to_lock);
+        if (lock.owns_lock())
+        {
+            project_color_pixels_to_depth_pixels(search, from_pixels, to_pixels, count, shared_executor);
+        }
+        else
+        {
+            parallel_executor caller_thread(1);
+            project_color_pixels_to_depth_pixels(search, from_pixels, to_pixels, count, caller_thread);
+        }
+    }
+}
@@ -0,0 +1,37 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "../include/librealsense2/h/rs_types.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+class parallel_executor;
+
+namespace librealsense
+{
+    // What rs2_project_color_pixel_to_depth_pixel needs besides the pixel, shared by all the pixels of a frame
+    struct color_to_depth_search
+    {
+        const uint16_t*     data;
+        float               depth_scale;
+        float               depth_min;
+        float               depth_max;
+        rs2_intrinsics      depth_intrin;
+        rs2_intrinsics      color_intrin;
+        rs2_extrinsics      color_to_depth;
+        rs2_extrinsics      depth_to_color;
+    };
+
+    // Runs the line search of rs2_project_color_pixel_to_depth_pixel for count pixels, interleaved x and y, with the
+    // same results. The pixels are split between the threads of the executor. Pixels with no depth along their line
+    // are set to (-1, -1)
+    void project_color_pixels_to_depth_pixels(const color_to_depth_search& search, const float* from_pixels, float* to_pixels,
+        size_t count, parallel_executor& executor);
+
+    // Same as above, over an executor shared by the library. Concurrent callers that find it busy search on their own thread
+    void project_color_pixels_to_depth_pixels(const color_to_depth_search& search, const float* from_pixels, float* to_pixels,
+        size_t count);
+}
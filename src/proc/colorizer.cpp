@@ -12,6 +12,14 @@
 
 namespace librealsense
 {
+    // Frames sharing one histogram equalization curve
+    const uint8_t equalization_interval_min = 1;
+    const uint8_t equalization_interval_max = 60;
+    const uint8_t equalization_interval_step = 1;
+    const uint8_t equalization_interval_def = 1;
+
+    const size_t max_depth = 0x10000;
+
     static color_map jet{ {
         { 0, 0, 255 },
         { 0, 255, 255 },
@@ -124,7 +132,11 @@ namespace librealsense
         } };
 
     colorizer::colorizer()
-        : _min(0.f), _max(6.f), _equalize(true), _target_stream_profile()
+        : _min(0.f), _max(6.f), _equalize(true),
+        _histogram(max_depth), _lut(max_depth), _lut_valid(false), _lut_equalized(false),
+        _lut_map_index(0), _lut_min(0.f), _lut_max(0.f), _lut_units(0.f),
+        _equalization_interval(equalization_interval_def), _equalization_frames_left(0),
+        _processing_threads(processing_threads_default), _executor(processing_threads_default), _target_stream_profile()
     {
         _stream_filter.stream = RS2_STREAM_DEPTH;
         _stream_filter.format = RS2_FORMAT_Z16;
@@ -192,92 +204,156 @@ namespace librealsense
 
         auto hist_opt = std::make_shared<ptr_option<bool>>(false, true, true, true, &_equalize, "Perform histogram equalization");
         register_option(RS2_OPTION_HISTOGRAM_EQUALIZATION_ENABLED, hist_opt);
+
+        auto interval_opt = std::make_shared<ptr_option<uint8_t>>(
+            equalization_interval_min,
+            equalization_interval_max,
+            equalization_interval_step,
+            equalization_interval_def,
+            &_equalization_interval, "Number of frames colorized with the same histogram equalization");
+        interval_opt->on_set([this, interval_opt](float val)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+
+            if (!interval_opt->is_valid(val))
+                throw invalid_value_exception(to_string()
+                    << "Unsupported histogram equalization interval: " << val << " is out of range.");
+
+            _equalization_interval = static_cast<uint8_t>(val);
+            _equalization_frames_left = 0;
+        });
+        register_option(RS2_OPTION_HISTOGRAM_EQUALIZATION_INTERVAL, interval_opt);
+
+        register_processing_threads_option(*this, _processing_threads, _executor, _mutex,
+            "Number of threads used to colorize each frame, 0 for all hardware threads", "colorizer");
     }
 
-    rs2::frame colorizer::process_frame(const rs2::frame_source& source, const rs2::frame& f)
+    void colorizer::update_histogram(const uint16_t* depth_data, size_t size)
     {
-        if (f.get_profile().get() != _source_stream_profile.get())
+        // Each worker counts its share of the pixels into a private histogram, the partial counts are then summed per bin
+        auto parts = std::max<size_t>(1, std::min<size_t>(_executor.size(), size / max_depth));
+        _partial_histograms.resize(parts - 1);
+        _executor.for_each(parts, [&](size_t part)
         {
-            _source_stream_profile = f.get_profile();
-            _target_stream_profile = f.get_profile().clone(RS2_STREAM_DEPTH, 0, RS2_FORMAT_RGB8);
-        }
-        auto make_equalized_histogram = [this](const rs2::video_frame& depth, rs2::video_frame rgb)
+            auto& histogram = part ? _partial_histograms[part - 1] : _histogram;
+            histogram.assign(max_depth, 0);
+            auto begin = size * part / parts, end = size * (part + 1) / parts;
+            for (auto i = begin; i < end; ++i) ++histogram[depth_data[i]];
+        });
+        if (parts > 1)
         {
-            const auto max_depth = 0x10000;
-            static uint32_t histogram[max_depth];
-            memset(histogram, 0, sizeof(histogram));
-
-            const auto w = depth.get_width(), h = depth.get_height();
-            const auto depth_data = reinterpret_cast<const uint16_t*>(depth.get_data());
-            auto rgb_data = reinterpret_cast<uint8_t*>(const_cast<void *>(rgb.get_data()));
-
-            for (auto i = 0; i < w*h; ++i) ++histogram[depth_data[i]];
-            for (auto i = 2; i < max_depth; ++i) histogram[i] += histogram[i - 1]; // Build a cumulative histogram for the indices in [1,0xFFFF]
-            auto cm = _maps[_map_index];
-            for (auto i = 0; i < w*h; ++i)
+            _executor.for_each_range(max_depth, 1024, [&](size_t begin, size_t end)
             {
-                auto d = depth_data[i];
-
-                if (d)
-                {
-                    auto f = histogram[d] / (float)histogram[0xFFFF]; // 0-255 based on histogram location
-
-                    auto c = cm->get(f);
-                    rgb_data[i * 3 + 0] = (uint8_t)c.x;
-                    rgb_data[i * 3 + 1] = (uint8_t)c.y;
-                    rgb_data[i * 3 + 2] = (uint8_t)c.z;
-                }
-                else
-                {
-                    rgb_data[i * 3 + 0] = 0;
-                    rgb_data[i * 3 + 1] = 0;
-                    rgb_data[i * 3 + 2] = 0;
-                }
-            }
+                for (auto&& partial : _partial_histograms)
+                    for (auto i = begin; i < end; ++i) _histogram[i] += partial[i];
+            });
+        }
+
+        for (size_t i = 2; i < max_depth; ++i) _histogram[i] += _histogram[i - 1]; // Build a cumulative histogram for the indices in [1,0xFFFF]
+    }
+
+    void colorizer::update_lut(float depth_units)
+    {
+        auto cm = _maps[_map_index];
+        auto pack = [](const float3& c)
+        {
+            return uint32_t((uint8_t)c.x) | uint32_t((uint8_t)c.y) << 8 | uint32_t((uint8_t)c.z) << 16;
         };
 
-        auto make_value_cropped_frame = [this](const rs2::video_frame& depth, rs2::video_frame rgb)
+        _lut[0] = 0;
+        if (_equalize)
         {
-            const auto max_depth = 0x10000;
-            const auto w = depth.get_width(), h = depth.get_height();
-            const auto depth_data = reinterpret_cast<const uint16_t*>(depth.get_data());
-            auto rgb_data = reinterpret_cast<uint8_t*>(const_cast<void *>(rgb.get_data()));
+            auto total = _histogram[max_depth - 1];
+            _executor.for_each_range(max_depth - 1, 1024, [&](size_t begin, size_t end)
+            {
+                for (auto d = begin + 1; d <= end; ++d)
+                    _lut[d] = total ? pack(cm->get(_histogram[d] / (float)total)) : 0; // 0-255 based on histogram location
+            });
+        }
+        else
+        {
+            _executor.for_each_range(max_depth - 1, 1024, [&](size_t begin, size_t end)
+            {
+                for (auto d = begin + 1; d <= end; ++d)
+                    _lut[d] = pack(cm->get((d * depth_units - _min) / (_max - _min)));
+            });
+        }
 
-            auto fi = (frame_interface*)depth.get();
-            auto df = dynamic_cast<librealsense::depth_frame*>(fi);
-            auto depth_units = df->get_units();
+        _lut_valid = true;
+        _lut_equalized = _equalize;
+        _lut_map_index = _map_index;
+        _lut_min = _min;
+        _lut_max = _max;
+        _lut_units = depth_units;
+    }
 
-            for (auto i = 0; i < w*h; ++i)
+    void colorizer::apply_lut(const uint16_t* depth_data, uint8_t* rgb_data, size_t size)
+    {
+        auto lut = _lut.data();
+        _executor.for_each_range(size, 4, [&](size_t begin, size_t end)
+        {
+            auto i = begin;
+            // Four packed colors fill three little-endian words of RGB8 output
+            for (; i + 4 <= end; i += 4)
             {
-                auto d = depth_data[i];
-
-                if (d)
-                {
-                    auto f = (d * depth_units - _min) / (_max - _min);
-
-                    auto c = _maps[_map_index]->get(f);
-                    rgb_data[i * 3 + 0] = (uint8_t)c.x;
-                    rgb_data[i * 3 + 1] = (uint8_t)c.y;
-                    rgb_data[i * 3 + 2] = (uint8_t)c.z;
-                }
-                else
-                {
-                    rgb_data[i * 3 + 0] = 0;
-                    rgb_data[i * 3 + 1] = 0;
-                    rgb_data[i * 3 + 2] = 0;
-                }
+                auto c0 = lut[depth_data[i]], c1 = lut[depth_data[i + 1]], c2 = lut[depth_data[i + 2]], c3 = lut[depth_data[i + 3]];
+                uint32_t words[3] = { c0 | c1 << 24, c1 >> 8 | c2 << 16, c2 >> 16 | c3 << 8 };
+                memcpy(rgb_data + i * 3, words, sizeof(words));
             }
-        };
+            for (; i < end; ++i)
+            {
+                auto c = lut[depth_data[i]];
+                rgb_data[i * 3 + 0] = (uint8_t)c;
+                rgb_data[i * 3 + 1] = (uint8_t)(c >> 8);
+                rgb_data[i * 3 + 2] = (uint8_t)(c >> 16);
+            }
+        });
+    }
+
+    rs2::frame colorizer::process_frame(const rs2::frame_source& source, const rs2::frame& f)
+    {
+        if (frame_profile(f) != _source_stream_profile.get())
+        {
+            _source_stream_profile = f.get_profile();
+            _target_stream_profile = f.get_profile().clone(RS2_STREAM_DEPTH, 0, RS2_FORMAT_RGB8);
+        }
         rs2::frame ret;
 
         auto vf = f.as<rs2::video_frame>();
         //rs2_extension ext = f.is<rs2::disparity_frame>() ? RS2_EXTENSION_DISPARITY_FRAME : RS2_EXTENSION_DEPTH_FRAME;
         ret = source.allocate_video_frame(_target_stream_profile, f, 3, vf.get_width(), vf.get_height(), vf.get_width() * 3, RS2_EXTENSION_VIDEO_FRAME);
 
+        const size_t size = size_t(vf.get_width()) * vf.get_height();
+        const auto depth_data = reinterpret_cast<const uint16_t*>(vf.get_data());
+        auto rgb_data = reinterpret_cast<uint8_t*>(const_cast<void *>(ret.get_data()));
+
+        // Every depth value is colored through the lookup table, which only has to follow the settings
+        // and, when equalizing, the histogram of the frames
         if (_equalize)
-            make_equalized_histogram(f, ret);
+        {
+            bool stale = !_lut_valid || !_lut_equalized || _lut_map_index != _map_index;
+            if (stale || !_equalization_frames_left)
+            {
+                update_histogram(depth_data, size);
+                update_lut(0.f);
+                // A curve of an empty frame would color the next frames black
+                _equalization_frames_left = _histogram[max_depth - 1] ? _equalization_interval : 0;
+            }
+            if (_equalization_frames_left)
+                --_equalization_frames_left;
+        }
         else
-            make_value_cropped_frame(f, ret);
+        {
+            auto fi = (frame_interface*)f.get();
+            auto df = frame_cast<librealsense::depth_frame>(fi);
+            auto depth_units = df->get_units();
+
+            if (!_lut_valid || _lut_equalized || _lut_map_index != _map_index ||
+                _lut_min != _min || _lut_max != _max || _lut_units != depth_units)
+                update_lut(depth_units);
+        }
+
+        apply_lut(depth_data, rgb_data, size);
 
         return ret;
     }
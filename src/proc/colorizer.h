@@ -5,6 +5,7 @@
 
 #include <map>
 #include <vector>
+#include "concurrency.h"
 
 namespace rs2
 {
@@ -102,11 +103,31 @@ namespace librealsense {
         rs2::frame process_frame(const rs2::frame_source& source, const rs2::frame& f) override;
 
     private:
+        void update_histogram(const uint16_t* depth_data, size_t size);
+        void update_lut(float depth_units);
+        void apply_lut(const uint16_t* depth_data, uint8_t* rgb_data, size_t size);
+
         float _min, _max;
         bool _equalize;
         std::vector<color_map*> _maps;
         int _map_index = 0;
         int _preset = 0;
+
+        // Cumulative histogram of the last equalized frame, and the partial histograms of the worker threads
+        std::vector<uint32_t> _histogram;
+        std::vector<std::vector<uint32_t>> _partial_histograms;
+
+        // Packed RGB8 color of every 16-bit depth value, with the settings it was built for
+        std::vector<uint32_t> _lut;
+        bool _lut_valid;
+        bool _lut_equalized;
+        int _lut_map_index;
+        float _lut_min, _lut_max, _lut_units;
+        uint8_t _equalization_interval;
+        uint8_t _equalization_frames_left;
+
+        uint8_t _processing_threads;
+        parallel_executor _executor;
         rs2::stream_profile _target_stream_profile;
         rs2::stream_profile _source_stream_profile;
     };
@@ -3,6 +3,10 @@
 #include "cuda-align.cuh"
 #include "../../../include/librealsense2/rsutil.h"
 #include "../../cuda/rscuda_utils.cuh"
+#include "../../cuda/cuda-mapped-allocator.cuh"
+
+#include <stdexcept>
+#include <string>
 
 // CUDA headers
 #include <cuda_runtime.h>
@@ -24,6 +28,9 @@ int calc_block_size(int pixel_count, int thread_count)
     return ((pixel_count % thread_count) == 0) ? (pixel_count / thread_count) : (pixel_count / thread_count + 1);
 }
 
+// The intrinsics and the extrinsics are passed by value, in the parameters of the kernels, so a change of the
+// calibration or of the resolution needs no copy to the device
+
 __device__ void kernel_transfer_pixels(int2* mapped_pixels, const rs2_intrinsics* depth_intrin,
     const rs2_intrinsics* other_intrin, const rs2_extrinsics* depth_to_other, float depth_val, int depth_x, int depth_y, int block_index)
 {
@@ -50,35 +57,36 @@ __device__ void kernel_transfer_pixels(int2* mapped_pixels, const rs2_intrinsics
     mapped_pixels[mapped_index].y = static_cast<int>(other_pixel[1] + 0.5f);
 }
 
-__global__  void kernel_map_depth_to_other(int2* mapped_pixels, const uint16_t* depth_in, const rs2_intrinsics* depth_intrin, const rs2_intrinsics* other_intrin,
-    const rs2_extrinsics* depth_to_other, float depth_scale)
+__global__  void kernel_map_depth_to_other(int2* mapped_pixels, const uint16_t* depth_in, const rs2_intrinsics depth_intrin, const rs2_intrinsics other_intrin,
+    const rs2_extrinsics depth_to_other, float depth_scale)
 {
     int depth_x = blockIdx.x * blockDim.x + threadIdx.x;
     int depth_y = blockIdx.y * blockDim.y + threadIdx.y;
 
-    int depth_pixel_index = depth_y * depth_intrin->width + depth_x;
-    if (depth_pixel_index >= depth_intrin->width * depth_intrin->height)
+    if (depth_x >= depth_intrin.width || depth_y >= depth_intrin.height)
         return;
+
+    int depth_pixel_index = depth_y * depth_intrin.width + depth_x;
     float depth_val = depth_in[depth_pixel_index] * depth_scale;
-    kernel_transfer_pixels(mapped_pixels, depth_intrin, other_intrin, depth_to_other, depth_val, depth_x, depth_y, blockIdx.z);
+    kernel_transfer_pixels(mapped_pixels, &depth_intrin, &other_intrin, &depth_to_other, depth_val, depth_x, depth_y, blockIdx.z);
 }
 
 template<int BPP>
-__global__  void kernel_other_to_depth(unsigned char* aligned, const unsigned char* other, const int2* mapped_pixels, const rs2_intrinsics* depth_intrin, const rs2_intrinsics* other_intrin)
+__global__  void kernel_other_to_depth(unsigned char* aligned, const unsigned char* other, const int2* mapped_pixels, const rs2_intrinsics depth_intrin, const rs2_intrinsics other_intrin)
 {
     int depth_x = blockIdx.x * blockDim.x + threadIdx.x;
     int depth_y = blockIdx.y * blockDim.y + threadIdx.y;
 
-    auto depth_size = depth_intrin->width * depth_intrin->height;
-    int depth_pixel_index = depth_y * depth_intrin->width + depth_x;
-
-    if (depth_pixel_index >= depth_intrin->width * depth_intrin->height)
+    if (depth_x >= depth_intrin.width || depth_y >= depth_intrin.height)
         return;
 
+    auto depth_size = depth_intrin.width * depth_intrin.height;
+    int depth_pixel_index = depth_y * depth_intrin.width + depth_x;
+
     int2 p0 = mapped_pixels[depth_pixel_index];
     int2 p1 = mapped_pixels[depth_size + depth_pixel_index];
 
-    if (p0.x < 0 || p0.y < 0 || p1.x >= other_intrin->width || p1.y >= other_intrin->height)
+    if (p0.x < 0 || p0.y < 0 || p1.x >= other_intrin.width || p1.y >= other_intrin.height)
         return;
 
     // Transfer between the depth pixels and the pixels inside the rectangle on the other image
@@ -88,27 +96,27 @@ __global__  void kernel_other_to_depth(unsigned char* aligned, const unsigned ch
     {
         for (int x = p0.x; x <= p1.x; ++x)
         {
-            auto other_pixel_index = y * other_intrin->width + x;
+            auto other_pixel_index = y * other_intrin.width + x;
             out_other[depth_pixel_index] = in_other[other_pixel_index];
         }
     }
 }
 
-__global__  void kernel_depth_to_other(uint16_t* aligned_out, const uint16_t* depth_in, const int2* mapped_pixels, const rs2_intrinsics* depth_intrin, const rs2_intrinsics* other_intrin)
+__global__  void kernel_depth_to_other(uint16_t* aligned_out, const uint16_t* depth_in, const int2* mapped_pixels, const rs2_intrinsics depth_intrin, const rs2_intrinsics other_intrin)
 {
     int depth_x = blockIdx.x * blockDim.x + threadIdx.x;
     int depth_y = blockIdx.y * blockDim.y + threadIdx.y;
 
-    auto depth_size = depth_intrin->width * depth_intrin->height;
-    int depth_pixel_index = depth_y * depth_intrin->width + depth_x;
-
-    if (depth_pixel_index >= depth_intrin->width * depth_intrin->height)
+    if (depth_x >= depth_intrin.width || depth_y >= depth_intrin.height)
         return;
 
+    auto depth_size = depth_intrin.width * depth_intrin.height;
+    int depth_pixel_index = depth_y * depth_intrin.width + depth_x;
+
     int2 p0 = mapped_pixels[depth_pixel_index];
     int2 p1 = mapped_pixels[depth_size + depth_pixel_index];
 
-    if (p0.x < 0 || p0.y < 0 || p1.x >= other_intrin->width || p1.y >= other_intrin->height)
+    if (p0.x < 0 || p0.y < 0 || p1.x >= other_intrin.width || p1.y >= other_intrin.height)
         return;
 
     // Transfer between the depth pixels and the pixels inside the rectangle on the other image
@@ -118,70 +126,103 @@ __global__  void kernel_depth_to_other(uint16_t* aligned_out, const uint16_t* de
     {
         for (int x = p0.x; x <= p1.x; ++x)
         {
-            auto other_pixel_index = y * other_intrin->width + x;
+            auto other_pixel_index = y * other_intrin.width + x;
             new_val = new_val << 16 | new_val;
             atomicMin(&arr[other_pixel_index / 2], new_val);
         }
     }
 }
 
-__global__  void kernel_replace_to_zero(uint16_t* aligned_out, const rs2_intrinsics* other_intrin)
+__global__  void kernel_replace_to_zero(uint16_t* aligned_out, const rs2_intrinsics other_intrin)
 {
     int x = blockIdx.x * blockDim.x + threadIdx.x;
     int y = blockIdx.y * blockDim.y + threadIdx.y;
 
-    auto other_pixel_index = y * other_intrin->width + x;
+    if (x >= other_intrin.width || y >= other_intrin.height)
+        return;
+
+    auto other_pixel_index = y * other_intrin.width + x;
     if (aligned_out[other_pixel_index] == 0xffff)
         aligned_out[other_pixel_index] = 0;
 }
 
+template<class T>
+T* align_cuda_helper::device_buffer<T>::get(int count)
+{
+    if (count > elements)
+    {
+        ptr.reset();
+        ptr = alloc_dev<T>(count);
+        elements = count;
+    }
+    return ptr.get();
+}
+
+cudaStream_t align_cuda_helper::stream()
+{
+    if (!_stream)
+    {
+        cudaStream_t stream;
+        auto res = cudaStreamCreate(&stream);
+        if (res != cudaSuccess)
+            throw std::runtime_error(std::string("cudaStreamCreate failed: ") + cudaGetErrorString(res));
+        _stream = std::shared_ptr<CUstream_st>(stream, [](cudaStream_t s) { cudaStreamDestroy(s); });
+    }
+    return _stream.get();
+}
+
+template<class T>
+const T* align_cuda_helper::upload(const T* host, int elements, device_buffer<T>& buffer)
+{
+    // Reading mapped memory crosses the bus on a discrete GPU, where a copy is faster
+    if (is_integrated_gpu())
+    {
+        if (auto mapped = get_mapped_device_pointer(host))
+            return static_cast<const T*>(mapped);
+    }
+
+    auto d_data = buffer.get(elements);
+    cudaMemcpyAsync(d_data, host, sizeof(T) * elements, cudaMemcpyHostToDevice, stream());
+    return d_data;
+}
+
 void align_cuda_helper::align_other_to_depth(unsigned char* h_aligned_out, const uint16_t* h_depth_in,
     float depth_scale, const rs2_intrinsics& h_depth_intrin, const rs2_extrinsics& h_depth_to_other,
     const rs2_intrinsics& h_other_intrin, const unsigned char* h_other_in, rs2_format other_format, int other_bytes_per_pixel)
 {
     int depth_pixel_count = h_depth_intrin.width * h_depth_intrin.height;
     int other_pixel_count = h_other_intrin.width * h_other_intrin.height;
-    int depth_size = depth_pixel_count * 2;
     int other_size = other_pixel_count * other_bytes_per_pixel;
     int aligned_pixel_count = depth_pixel_count;
     int aligned_size = aligned_pixel_count * other_bytes_per_pixel;
-
-    // allocate and copy objects to cuda device memory
-    if (!_d_depth_intrinsics) _d_depth_intrinsics = make_device_copy(h_depth_intrin);
-    if (!_d_other_intrinsics) _d_other_intrinsics = make_device_copy(h_other_intrin);
-    if (!_d_depth_other_extrinsics) _d_depth_other_extrinsics = make_device_copy(h_depth_to_other);
-
-    if (!_d_depth_in) _d_depth_in = alloc_dev<uint16_t>(aligned_pixel_count);
-    cudaMemcpy(_d_depth_in.get(), h_depth_in, depth_size, cudaMemcpyHostToDevice);
-
-    if (!_d_other_in) _d_other_in = alloc_dev<unsigned char>(other_size);
-    cudaMemcpy(_d_other_in.get(), h_other_in, other_size, cudaMemcpyHostToDevice);
-
-    if (!_d_aligned_out)
-        _d_aligned_out = alloc_dev<unsigned char>(aligned_size);
-    cudaMemset(_d_aligned_out.get(), 0, aligned_size);
-
-    if (!_d_pixel_map) _d_pixel_map = alloc_dev<int2>(depth_pixel_count * 2);
+    auto s = stream();
 
     // config threads
     dim3 threads(RS2_CUDA_THREADS_PER_BLOCK, RS2_CUDA_THREADS_PER_BLOCK);
     dim3 depth_blocks(calc_block_size(h_depth_intrin.width, threads.x), calc_block_size(h_depth_intrin.height, threads.y));
     dim3 mapping_blocks(depth_blocks.x, depth_blocks.y, 2);
 
-    kernel_map_depth_to_other <<<mapping_blocks,threads>>> (_d_pixel_map.get(), _d_depth_in.get(), _d_depth_intrinsics.get(), _d_other_intrinsics.get(),
-        _d_depth_other_extrinsics.get(), depth_scale);
+    auto d_depth_in = upload(h_depth_in, depth_pixel_count, _d_depth_in);
+    auto d_pixel_map = _d_pixel_map.get(depth_pixel_count * 2);
+
+    kernel_map_depth_to_other <<<mapping_blocks, threads, 0, s>>> (d_pixel_map, d_depth_in, h_depth_intrin, h_other_intrin,
+        h_depth_to_other, depth_scale);
+
+    // Copying the other image overlaps the mapping of the depth
+    auto d_other_in = upload(h_other_in, other_size, _d_other_in);
+    auto d_aligned_out = _d_aligned_out.get(aligned_size);
+    cudaMemsetAsync(d_aligned_out, 0, aligned_size, s);
 
     switch (other_bytes_per_pixel)
     {
-    case 1: kernel_other_to_depth<1> <<<depth_blocks,threads>>> (_d_aligned_out.get(), _d_other_in.get(), _d_pixel_map.get(), _d_depth_intrinsics.get(), _d_other_intrinsics.get()); break;
-    case 2: kernel_other_to_depth<2> <<<depth_blocks,threads>>> (_d_aligned_out.get(), _d_other_in.get(), _d_pixel_map.get(), _d_depth_intrinsics.get(), _d_other_intrinsics.get()); break;
-    case 3: kernel_other_to_depth<3> <<<depth_blocks,threads>>> (_d_aligned_out.get(), _d_other_in.get(), _d_pixel_map.get(), _d_depth_intrinsics.get(), _d_other_intrinsics.get()); break;
-    case 4: kernel_other_to_depth<4> <<<depth_blocks,threads>>> (_d_aligned_out.get(), _d_other_in.get(), _d_pixel_map.get(), _d_depth_intrinsics.get(), _d_other_intrinsics.get()); break;
+    case 1: kernel_other_to_depth<1> <<<depth_blocks, threads, 0, s>>> (d_aligned_out, d_other_in, d_pixel_map, h_depth_intrin, h_other_intrin); break;
+    case 2: kernel_other_to_depth<2> <<<depth_blocks, threads, 0, s>>> (d_aligned_out, d_other_in, d_pixel_map, h_depth_intrin, h_other_intrin); break;
+    case 3: kernel_other_to_depth<3> <<<depth_blocks, threads, 0, s>>> (d_aligned_out, d_other_in, d_pixel_map, h_depth_intrin, h_other_intrin); break;
+    case 4: kernel_other_to_depth<4> <<<depth_blocks, threads, 0, s>>> (d_aligned_out, d_other_in, d_pixel_map, h_depth_intrin, h_other_intrin); break;
     }
 
-    cudaDeviceSynchronize();
-
-    cudaMemcpy(h_aligned_out, _d_aligned_out.get(), aligned_size, cudaMemcpyDeviceToHost);
+    cudaMemcpyAsync(h_aligned_out, d_aligned_out, aligned_size, cudaMemcpyDeviceToHost, s);
+    cudaStreamSynchronize(s);
 }
 
 void align_cuda_helper::align_depth_to_other(unsigned char* h_aligned_out, const uint16_t* h_depth_in,
@@ -190,23 +231,30 @@ void align_cuda_helper::align_depth_to_other(unsigned char* h_aligned_out, const
 {
     int depth_pixel_count = h_depth_intrin.width * h_depth_intrin.height;
     int other_pixel_count = h_other_intrin.width * h_other_intrin.height;
-    int aligned_pixel_count = other_pixel_count;
+    int aligned_byte_size = other_pixel_count * 2;
+    auto s = stream();
 
-    int depth_byte_size = depth_pixel_count * 2;
-    int aligned_byte_size = aligned_pixel_count * 2;
+    auto d_depth_in = upload(h_depth_in, depth_pixel_count, _d_depth_in);
+    auto d_aligned_out = reinterpret_cast<uint16_t*>(_d_aligned_out.get(aligned_byte_size));
 
-    // allocate and copy objects to cuda device memory
-    if (!_d_depth_intrinsics) _d_depth_intrinsics = make_device_copy(h_depth_intrin);
-    if (!_d_other_intrinsics) _d_other_intrinsics = make_device_copy(h_other_intrin);
-    if (!_d_depth_other_extrinsics) _d_depth_other_extrinsics = make_device_copy(h_depth_to_other);
+    align_depth_to_other_device(d_aligned_out, d_depth_in, depth_scale, h_depth_intrin, h_depth_to_other, h_other_intrin);
 
-    if (!_d_depth_in) _d_depth_in = alloc_dev<uint16_t>(depth_pixel_count);
-    cudaMemcpy(_d_depth_in.get(), h_depth_in, depth_byte_size, cudaMemcpyHostToDevice);
+    cudaMemcpyAsync(h_aligned_out, d_aligned_out, aligned_byte_size, cudaMemcpyDeviceToHost, s);
+    cudaStreamSynchronize(s);
+}
 
-    if (!_d_aligned_out) _d_aligned_out = alloc_dev<unsigned char>(aligned_byte_size);
-    cudaMemset(_d_aligned_out.get(), 0xff, aligned_byte_size);
+void align_cuda_helper::align_depth_to_other_device(uint16_t* d_aligned_out, const uint16_t* d_depth_in,
+    float depth_scale, const rs2_intrinsics& h_depth_intrin, const rs2_extrinsics& h_depth_to_other,
+    const rs2_intrinsics& h_other_intrin)
+{
+    int depth_pixel_count = h_depth_intrin.width * h_depth_intrin.height;
+    int other_pixel_count = h_other_intrin.width * h_other_intrin.height;
+    int aligned_byte_size = other_pixel_count * 2;
+    auto s = stream();
+
+    cudaMemsetAsync(d_aligned_out, 0xff, aligned_byte_size, s);
 
-    if (!_d_pixel_map) _d_pixel_map = alloc_dev<int2>(depth_pixel_count * 2);
+    auto d_pixel_map = _d_pixel_map.get(depth_pixel_count * 2);
 
     // config threads
     dim3 threads(RS2_CUDA_THREADS_PER_BLOCK, RS2_CUDA_THREADS_PER_BLOCK);
@@ -214,17 +262,13 @@ void align_cuda_helper::align_depth_to_other(unsigned char* h_aligned_out, const
     dim3 other_blocks(calc_block_size(h_other_intrin.width, threads.x), calc_block_size(h_other_intrin.height, threads.y));
     dim3 mapping_blocks(depth_blocks.x, depth_blocks.y, 2);
 
-    kernel_map_depth_to_other <<<mapping_blocks,threads>>> (_d_pixel_map.get(), _d_depth_in.get(), _d_depth_intrinsics.get(),
-        _d_other_intrinsics.get(), _d_depth_other_extrinsics.get(), depth_scale);
-
-    kernel_depth_to_other <<<depth_blocks,threads>>> ((uint16_t*)_d_aligned_out.get(), _d_depth_in.get(), _d_pixel_map.get(),
-        _d_depth_intrinsics.get(), _d_other_intrinsics.get());
-
-    kernel_replace_to_zero <<<other_blocks, threads>>> ((uint16_t*)_d_aligned_out.get(), _d_other_intrinsics.get());
+    kernel_map_depth_to_other <<<mapping_blocks, threads, 0, s>>> (d_pixel_map, d_depth_in, h_depth_intrin,
+        h_other_intrin, h_depth_to_other, depth_scale);
 
-    cudaDeviceSynchronize();
+    kernel_depth_to_other <<<depth_blocks, threads, 0, s>>> (d_aligned_out, d_depth_in, d_pixel_map,
+        h_depth_intrin, h_other_intrin);
 
-    cudaMemcpy(h_aligned_out, _d_aligned_out.get(), aligned_pixel_count * 2, cudaMemcpyDeviceToHost);
+    kernel_replace_to_zero <<<other_blocks, threads, 0, s>>> (d_aligned_out, h_other_intrin);
 }
 
 #endif //RS2_USE_CUDA
@@ -5,15 +5,15 @@
 #include <memory>
 #include <stdint.h>
 
+// CUDA headers
+#include <cuda_runtime.h>
+
 namespace librealsense
 {
     class align_cuda_helper
     {
     public:
-        align_cuda_helper() :
-            _d_depth_in(nullptr),
-            _d_other_in(nullptr),
-            _d_aligned_out(nullptr) {}
+        align_cuda_helper() = default;
 
         void align_other_to_depth(unsigned char* h_aligned_out, const uint16_t* h_depth_in,
             float depth_scale, const rs2_intrinsics& h_depth_intrin, const rs2_extrinsics& h_depth_to_other,
@@ -23,15 +23,37 @@ namespace librealsense
             float depth_scale, const rs2_intrinsics& h_depth_intrin, const rs2_extrinsics& h_depth_to_other,
             const rs2_intrinsics& h_other_intrin);
 
+        // Same, with the depth and the aligned output in device memory
+        void align_depth_to_other_device(uint16_t* d_aligned_out, const uint16_t* d_depth_in,
+            float depth_scale, const rs2_intrinsics& h_depth_intrin, const rs2_extrinsics& h_depth_to_other,
+            const rs2_intrinsics& h_other_intrin);
+
     private:
-        std::shared_ptr<uint16_t>       _d_depth_in;
-        std::shared_ptr<unsigned char>  _d_other_in;
-        std::shared_ptr<unsigned char>  _d_aligned_out;
-        std::shared_ptr<int2>           _d_pixel_map;
-
-        std::shared_ptr<rs2_intrinsics> _d_other_intrinsics;
-        std::shared_ptr<rs2_intrinsics> _d_depth_intrinsics;
-        std::shared_ptr<rs2_extrinsics> _d_depth_other_extrinsics;
+        // Kept across the frames and only reallocated when a larger resolution comes in
+        template<class T>
+        struct device_buffer
+        {
+            std::shared_ptr<T> ptr;
+            int elements = 0;
+
+            T* get(int count);
+        };
+
+        cudaStream_t stream();
+
+        // The device address of host memory, from the mapping of a frame allocated by cuda_mapped_frame_allocator on an integrated GPU,
+        // or else from a copy into the buffer
+        template<class T>
+        const T* upload(const T* host, int elements, device_buffer<T>& buffer);
+
+        device_buffer<uint16_t>         _d_depth_in;
+        device_buffer<unsigned char>    _d_other_in;
+        device_buffer<unsigned char>    _d_aligned_out;
+        device_buffer<int2>             _d_pixel_map;
+
+        // Blocking with the legacy default stream, so the CUDA blocks reading the aligned depth in device memory
+        // wait for the kernels without a synchronization here
+        std::shared_ptr<CUstream_st>    _stream;
     };
 }
 #endif // RS2_USE_CUDA
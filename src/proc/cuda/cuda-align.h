@@ -3,6 +3,7 @@
 
 #include "proc/align.h"
 #include "cuda-align.cuh"
+#include "cuda-frame-memory.h"
 #include <memory>
 #include <stdint.h>
 
@@ -49,8 +50,34 @@ namespace librealsense
                 aligned_data, z_pixels, z_scale, z_intrin, z_to_other, other_intrin, other_pixels, other_profile.format(), other.get_bytes_per_pixel());
         }
 
+        // Aligned depth stays in device memory for the CUDA filters and the point cloud that follow
+        void align_frames(const rs2::video_frame& aligned, const rs2::video_frame& from, const rs2::video_frame& to) override
+        {
+            if (to.get_profile().stream_type() == RS2_STREAM_DEPTH)
+            {
+                align::align_frames(aligned, from, to);
+                return;
+            }
+
+            auto depth_profile = from.get_profile().as<rs2::video_stream_profile>();
+            auto other_profile = to.get_profile().as<rs2::video_stream_profile>();
+
+            auto z_intrin = depth_profile.get_intrinsics();
+            auto other_intrin = other_profile.get_intrinsics();
+            auto z_to_other = depth_profile.get_extrinsics_to(other_profile);
+
+            auto depth_size = size_t(z_intrin.width) * z_intrin.height * sizeof(uint16_t);
+            auto z_pixels = static_cast<const uint16_t*>(get_device_data(from, depth_size, _d_depth_in));
+            auto out = rscuda::alloc_device_memory(size_t(other_intrin.width) * other_intrin.height * sizeof(uint16_t));
+
+            auto& aligner = aligners[std::tuple<rs2_stream, rs2_stream>(RS2_STREAM_DEPTH, other_profile.stream_type())];
+            aligner.align_depth_to_other_device(static_cast<uint16_t*>(out->get()), z_pixels, _depth_scale, z_intrin, z_to_other, other_intrin);
+            set_device_data(aligned, out);
+        }
+
     private:
         std::map<std::tuple<rs2_stream, rs2_stream>, align_cuda_helper> aligners;
+        std::shared_ptr<rscuda::cuda_device_memory> _d_depth_in;
     };
 }
 #endif // RS2_USE_CUDA
@@ -0,0 +1,358 @@
+#ifdef RS2_USE_CUDA
+
+#include "cuda-filters.cuh"
+#include "../../cuda/rscuda_utils.cuh"
+
+// CUDA headers
+#include <cuda_runtime.h>
+
+#ifdef _MSC_VER
+// Add library dependencies if using VS
+#pragma comment(lib, "cudart_static")
+#endif
+
+#define RS2_CUDA_THREADS_PER_BLOCK 256
+#define RS2_CUDA_SCAN_THREADS 1024
+
+using namespace librealsense;
+using namespace rscuda;
+
+namespace
+{
+    int blocks_for(int count, int threads) { return (count + threads - 1) / threads; }
+
+    // The blends are written as separate roundings of the host expressions, so that the device does not contract them into fused multiply-adds
+    __device__ float blend(float a, float alpha, float b, float one_minus_alpha)
+    {
+        return __fadd_rn(__fmul_rn(a, alpha), __fmul_rn(b, one_minus_alpha));
+    }
+
+    __device__ uint16_t abs_diff(uint16_t a, uint16_t b) { return a > b ? a - b : b - a; }
+
+    // Decimation: one thread per output pixel, median of the valid values for 2x2 and 3x3 patches, their mean for the larger ones
+    __global__ void kernel_decimate_depth(uint16_t* out, const uint16_t* in, int width_in, int scale,
+        int real_width, int real_height, int padded_width, int padded_height)
+    {
+        int i = blockIdx.x * blockDim.x + threadIdx.x;
+        int j = blockIdx.y * blockDim.y + threadIdx.y;
+        if (i >= padded_width || j >= padded_height)
+            return;
+
+        uint16_t result = 0;
+        if (i < real_width && j < real_height)
+        {
+            const uint16_t* p = in + size_t(j) * scale * width_in + size_t(i) * scale;
+            if (scale == 2 || scale == 3)
+            {
+                uint16_t values[9];
+                int count = 0;
+                for (int n = 0; n < scale; ++n, p += width_in)
+                    for (int m = 0; m < scale; ++m)
+                    {
+                        uint16_t v = p[m];
+                        if (!v) continue;
+                        // Insertion sort, the patch holds at most nine values
+                        int k = count++;
+                        for (; k > 0 && values[k - 1] > v; --k)
+                            values[k] = values[k - 1];
+                        values[k] = v;
+                    }
+                // For even-size kernels pick the member one below the middle
+                result = count ? values[(count - 1) / 2] : 0;
+            }
+            else
+            {
+                int sum = 0, count = 0;
+                for (int n = 0; n < scale; ++n, p += width_in)
+                    for (int m = 0; m < scale; ++m)
+                        if (p[m])
+                        {
+                            sum += p[m];
+                            ++count;
+                        }
+                result = count ? uint16_t(sum / count) : 0;
+            }
+        }
+        out[size_t(j) * padded_width + i] = result;
+    }
+
+    // Spatial filter passes are recursive along their direction, one thread runs each row, then each column
+    __global__ void kernel_spatial_horizontal(uint16_t* image, int width, int height, float alpha, uint16_t delta_z, int radius)
+    {
+        int v = blockIdx.x * blockDim.x + threadIdx.x;
+        if (v >= height)
+            return;
+
+        const float one_minus_alpha = 1.f - alpha;
+        uint16_t* im = image + size_t(v) * width;
+
+        // left to right
+        uint16_t val0 = im[0];
+        int cur_fill = 0;
+        for (int u = 1; u < width - 1; u++)
+        {
+            uint16_t val1 = im[u];
+            if (val0)
+            {
+                if (val1)
+                {
+                    cur_fill = 0;
+                    uint16_t diff = abs_diff(val1, val0);
+                    if (diff >= 1 && diff <= delta_z)
+                    {
+                        val1 = uint16_t(__fadd_rn(blend(val1, alpha, val0, one_minus_alpha), 0.5f));
+                        im[u] = val1;
+                    }
+                }
+                else if (radius && ++cur_fill < radius)
+                    im[u] = val1 = val0;
+            }
+            val0 = val1;
+        }
+
+        // right to left
+        uint16_t val1 = im[width - 1];
+        cur_fill = 0;
+        for (int u = width - 2; u >= 0; u--)
+        {
+            uint16_t val0 = im[u];
+            if (val1)
+            {
+                if (val0 > 1)
+                {
+                    cur_fill = 0;
+                    if (abs_diff(val1, val0) <= delta_z)
+                    {
+                        val0 = uint16_t(__fadd_rn(blend(val0, alpha, val1, one_minus_alpha), 0.5f));
+                        im[u] = val0;
+                    }
+                }
+                else if (radius && ++cur_fill < radius)
+                    im[u] = val0 = val1;
+            }
+            val1 = val0;
+        }
+    }
+
+    __global__ void kernel_spatial_vertical(uint16_t* image, int width, int height, float alpha, uint16_t delta_z)
+    {
+        int u = blockIdx.x * blockDim.x + threadIdx.x;
+        if (u >= width)
+            return;
+
+        const float one_minus_alpha = 1.f - alpha;
+        uint16_t* col = image + u;
+
+        // top to bottom
+        for (int v = 1; v < height; v++)
+        {
+            uint16_t cur = col[size_t(v) * width], other = col[size_t(v - 1) * width];
+            if (abs_diff(cur, other) < delta_z)
+                col[size_t(v) * width] = uint16_t(__fadd_rn(blend(cur, alpha, other, one_minus_alpha), 0.5f));
+        }
+
+        // bottom to top
+        for (int v = height - 2; v >= 0; v--)
+        {
+            uint16_t cur = col[size_t(v) * width], other = col[size_t(v + 1) * width];
+            if (cur && other && abs_diff(cur, other) < delta_z)
+                col[size_t(v) * width] = uint16_t(__fadd_rn(blend(cur, alpha, other, one_minus_alpha), 0.5f));
+        }
+    }
+
+    // Temporal filter: pixels are independent, the history is a shift register with the newest frame in the msb
+    __global__ void kernel_temporal(uint16_t* frame, uint16_t* last_frame, uint8_t* history, int pixels,
+        float alpha, float one_minus_alpha, uint16_t delta_z, const uint8_t* persistence_map)
+    {
+        int i = blockIdx.x * blockDim.x + threadIdx.x;
+        if (i >= pixels)
+            return;
+
+        uint16_t cur_val = frame[i];
+        uint16_t prev_val = last_frame[i];
+        uint8_t hist = history[i];
+
+        if (cur_val)
+        {
+            if (prev_val && abs_diff(cur_val, prev_val) < delta_z)
+            {
+                history[i] = (hist >> 1) | 0x80;
+                uint16_t result = uint16_t(blend(cur_val, alpha, prev_val, one_minus_alpha));
+                frame[i] = result;
+                last_frame[i] = result;
+            }
+            else
+            {
+                last_frame[i] = cur_val;
+                history[i] = 0x80;
+            }
+        }
+        else
+        {
+            if (prev_val && persistence_map[hist])
+                frame[i] = prev_val;
+            history[i] = hist >> 1;
+        }
+    }
+
+    // Hole filling: each filled pixel depends on the filled pixel to its left, so a row is a segmented scan
+    // where holes combine their candidate with the running value and valid pixels restart the run.
+    // The modes follow holes_filling_types
+    enum { fill_from_left = 0, farest_from_around = 1, nearest_from_around = 2 };
+
+    template<int Mode>
+    __device__ uint16_t scan_op(uint16_t left, uint16_t right)
+    {
+        if (Mode == fill_from_left) return left;
+        if (Mode == farest_from_around) return left > right ? left : right;
+        return left < right ? left : right;
+    }
+
+    // The nearest scan runs on values minus one, so that empty neighbours wrap around to the largest value and drop out of the minimum
+    template<int Mode> __device__ uint16_t to_key(uint16_t v) { return Mode == nearest_from_around ? uint16_t(v - 1) : v; }
+    template<int Mode> __device__ uint16_t from_key(uint16_t k) { return Mode == nearest_from_around ? uint16_t(k + 1) : k; }
+
+    // Fills one row with the whole block, in chunks of blockDim.x pixels. 'up' is the filled row above, unused by fill from left
+    template<int Mode>
+    __device__ void fill_row(uint16_t* out, const uint16_t* up, const uint16_t* cur, const uint16_t* down, int width,
+        uint16_t* values, bool* starts)
+    {
+        const int t = threadIdx.x;
+        uint16_t carry = to_key<Mode>(cur[0]);
+        for (int chunk = 1; chunk < width; chunk += blockDim.x)
+        {
+            int i = chunk + t;
+            uint16_t value = 0;
+            bool start = true;
+            if (i < width)
+            {
+                uint16_t c = cur[i];
+                if (Mode == fill_from_left)
+                {
+                    start = c != 0;
+                    value = c;
+                }
+                else if (Mode == farest_from_around)
+                {
+                    start = c != 0;
+                    value = start ? c : scan_op<Mode>(scan_op<Mode>(up[i], up[i - 1]), scan_op<Mode>(down[i - 1], down[i]));
+                }
+                else
+                {
+                    // A hole below a hole stays empty
+                    start = c != 0 || up[i] == 0;
+                    value = start ? to_key<Mode>(c) : scan_op<Mode>(scan_op<Mode>(to_key<Mode>(up[i]), to_key<Mode>(up[i - 1])),
+                        scan_op<Mode>(to_key<Mode>(down[i - 1]), to_key<Mode>(down[i])));
+                }
+            }
+
+            // Inclusive segmented scan of the chunk
+            values[t] = value;
+            starts[t] = start;
+            __syncthreads();
+            for (int offset = 1; offset < blockDim.x; offset <<= 1)
+            {
+                if (t >= offset && !start)
+                {
+                    value = scan_op<Mode>(values[t - offset], value);
+                    start = starts[t - offset];
+                }
+                __syncthreads();
+                values[t] = value;
+                starts[t] = start;
+                __syncthreads();
+            }
+
+            if (!start)
+                value = scan_op<Mode>(carry, value);
+            if (i < width)
+                out[i] = from_key<Mode>(value);
+            __syncthreads();
+            values[t] = value;
+            __syncthreads();
+            carry = values[blockDim.x - 1];
+            __syncthreads();
+        }
+    }
+
+    // Fill from left: one block per row
+    __global__ void kernel_fill_from_left(uint16_t* out, const uint16_t* src, int width)
+    {
+        __shared__ uint16_t values[RS2_CUDA_SCAN_THREADS];
+        __shared__ bool starts[RS2_CUDA_SCAN_THREADS];
+
+        size_t row = size_t(blockIdx.x) * width;
+        fill_row<fill_from_left>(out + row, nullptr, src + row, nullptr, width, values, starts);
+    }
+
+    // The around modes read the filled row above, a single block walks the rows top to bottom, skipping the first and last
+    template<int Mode>
+    __global__ void kernel_fill_around(uint16_t* out, const uint16_t* src, int width, int height)
+    {
+        __shared__ uint16_t values[RS2_CUDA_SCAN_THREADS];
+        __shared__ bool starts[RS2_CUDA_SCAN_THREADS];
+
+        for (int j = 1; j < height - 1; ++j)
+        {
+            size_t row = size_t(j) * width;
+            fill_row<Mode>(out + row, out + row - width, src + row, src + row + width, width, values, starts);
+            __syncthreads();
+        }
+    }
+}
+
+void librealsense::decimate_depth_cuda(uint16_t* d_out, const uint16_t* d_in, int width_in, int scale,
+    int real_width, int real_height, int padded_width, int padded_height)
+{
+    dim3 threads(32, 8);
+    dim3 blocks(blocks_for(padded_width, threads.x), blocks_for(padded_height, threads.y));
+    kernel_decimate_depth<<<blocks, threads>>>(d_out, d_in, width_in, scale, real_width, real_height, padded_width, padded_height);
+}
+
+void librealsense::spatial_smooth_cuda(uint16_t* d_image, int width, int height, float alpha, uint16_t delta_z,
+    int iterations, int holes_filling_radius)
+{
+    for (int i = 0; i < iterations; i++)
+    {
+        kernel_spatial_horizontal<<<blocks_for(height, RS2_CUDA_THREADS_PER_BLOCK), RS2_CUDA_THREADS_PER_BLOCK>>>(
+            d_image, width, height, alpha, delta_z, holes_filling_radius);
+        kernel_spatial_vertical<<<blocks_for(width, RS2_CUDA_THREADS_PER_BLOCK), RS2_CUDA_THREADS_PER_BLOCK>>>(
+            d_image, width, height, alpha, delta_z);
+    }
+}
+
+void librealsense::hole_filling_cuda(uint16_t* d_out, const uint16_t* d_src, int width, int height, uint8_t mode)
+{
+    switch (mode)
+    {
+    case fill_from_left:
+        kernel_fill_from_left<<<height, RS2_CUDA_SCAN_THREADS>>>(d_out, d_src, width);
+        break;
+    case farest_from_around:
+        if (height >= 3) kernel_fill_around<farest_from_around><<<1, RS2_CUDA_SCAN_THREADS>>>(d_out, d_src, width, height);
+        break;
+    case nearest_from_around:
+        if (height >= 3) kernel_fill_around<nearest_from_around><<<1, RS2_CUDA_SCAN_THREADS>>>(d_out, d_src, width, height);
+        break;
+    }
+}
+
+void temporal_filter_cuda_helper::smooth(uint16_t* d_frame, int pixels, float alpha, float one_minus_alpha, uint16_t delta_z,
+    const uint8_t* h_persistence_map)
+{
+    // The history restarts empty after every reset
+    if (!_d_history)
+    {
+        _d_last_frame = alloc_dev<uint16_t>(pixels);
+        _d_history = alloc_dev<uint8_t>(pixels);
+        _d_persistence_map = alloc_dev<uint8_t>(256);
+        cudaMemset(_d_last_frame.get(), 0, pixels * sizeof(uint16_t));
+        cudaMemset(_d_history.get(), 0, pixels);
+        cudaMemcpy(_d_persistence_map.get(), h_persistence_map, 256, cudaMemcpyHostToDevice);
+    }
+
+    kernel_temporal<<<blocks_for(pixels, RS2_CUDA_THREADS_PER_BLOCK), RS2_CUDA_THREADS_PER_BLOCK>>>(
+        d_frame, _d_last_frame.get(), _d_history.get(), pixels, alpha, one_minus_alpha, delta_z, _d_persistence_map.get());
+}
+
+#endif //RS2_USE_CUDA
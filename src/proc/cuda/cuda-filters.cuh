@@ -0,0 +1,38 @@
+#pragma once
+#ifdef RS2_USE_CUDA
+
+#include <memory>
+#include <stdint.h>
+
+namespace librealsense
+{
+    // Device implementations of the depth (Z16) paths of the post-processing filters.
+    // All the image pointers are device memory; the results match the host implementations bit for bit
+
+    void decimate_depth_cuda(uint16_t* d_out, const uint16_t* d_in, int width_in, int scale,
+        int real_width, int real_height, int padded_width, int padded_height);
+
+    // Filters the image in place
+    void spatial_smooth_cuda(uint16_t* d_image, int width, int height, float alpha, uint16_t delta_z,
+        int iterations, int holes_filling_radius);
+
+    // d_out starts as a copy of d_src
+    void hole_filling_cuda(uint16_t* d_out, const uint16_t* d_src, int width, int height, uint8_t mode);
+
+    // The temporal filter keeps the last frame and the per-pixel history on the device
+    class temporal_filter_cuda_helper
+    {
+    public:
+        void reset() { _d_last_frame.reset(); _d_history.reset(); _d_persistence_map.reset(); }
+
+        // Filters the frame in place
+        void smooth(uint16_t* d_frame, int pixels, float alpha, float one_minus_alpha, uint16_t delta_z,
+            const uint8_t* h_persistence_map);
+
+    private:
+        std::shared_ptr<uint16_t> _d_last_frame;
+        std::shared_ptr<uint8_t>  _d_history;
+        std::shared_ptr<uint8_t>  _d_persistence_map;
+    };
+}
+#endif // RS2_USE_CUDA
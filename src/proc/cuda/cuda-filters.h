@@ -0,0 +1,115 @@
+#pragma once
+#ifdef RS2_USE_CUDA
+
+#include "proc/decimation-filter.h"
+#include "proc/spatial-filter.h"
+#include "proc/temporal-filter.h"
+#include "proc/hole-filling-filter.h"
+#include "cuda-filters.cuh"
+#include "cuda-frame-memory.h"
+#include <cuda_runtime.h>
+#include <memory>
+#include <stdint.h>
+
+namespace librealsense
+{
+    // The CUDA filters take their input from the device when the previous block ran on the GPU
+    // and leave their output there, so a chain of them only copies to the host what is read.
+    // Disparity frames and the other formats go through the host implementations
+
+    class decimation_filter_cuda : public decimation_filter
+    {
+    protected:
+        void decimate_depth_frame(const rs2::video_frame& source, const rs2::frame& target) override
+        {
+            auto in_size = size_t(source.get_width()) * source.get_height() * sizeof(uint16_t);
+            auto d_in = static_cast<const uint16_t*>(get_device_data(source, in_size, _d_input));
+
+            auto out = rscuda::alloc_device_memory(size_t(_padded_width) * _padded_height * sizeof(uint16_t));
+            decimate_depth_cuda(static_cast<uint16_t*>(out->get()), d_in, source.get_width(), _patch_size,
+                _real_width, _real_height, _padded_width, _padded_height);
+            set_device_data(target, out);
+        }
+
+    private:
+        std::shared_ptr<rscuda::cuda_device_memory> _d_input;
+    };
+
+    class spatial_filter_cuda : public spatial_filter
+    {
+    protected:
+        rs2::frame smooth_depth_frame(const rs2::frame& f, const rs2::frame_source& source) override
+        {
+            auto tgt = source.allocate_video_frame(_target_stream_profile, f, int(_bpp), int(_width), int(_height), int(_stride), _extension_type);
+            if (!tgt)
+                return tgt;
+
+            auto size = _current_frm_size_pixels * _bpp;
+            auto out = rscuda::alloc_device_memory(size);
+            cudaMemcpy(out->get(), get_device_data(f, size, _d_input), size, cudaMemcpyDeviceToDevice);
+            spatial_smooth_cuda(static_cast<uint16_t*>(out->get()), int(_width), int(_height), _spatial_alpha_param,
+                static_cast<uint16_t>(_spatial_edge_threshold), _spatial_iterations, _holes_filling_radius);
+            set_device_data(tgt, out);
+            return tgt;
+        }
+
+    private:
+        std::shared_ptr<rscuda::cuda_device_memory> _d_input;
+    };
+
+    class temporal_filter_cuda : public temporal_filter
+    {
+    protected:
+        rs2::frame smooth_depth_frame(const rs2::frame& f, const rs2::frame_source& source) override
+        {
+            auto tgt = source.allocate_video_frame(_target_stream_profile, f, int(_bpp), int(_width), int(_height), int(_stride), _extension_type);
+            if (!tgt)
+                return tgt;
+
+            auto size = _current_frm_size_pixels * _bpp;
+            auto out = rscuda::alloc_device_memory(size);
+            cudaMemcpy(out->get(), get_device_data(f, size, _d_input), size, cudaMemcpyDeviceToDevice);
+            _helper.smooth(static_cast<uint16_t*>(out->get()), int(_current_frm_size_pixels), _alpha_param, _one_minus_alpha,
+                static_cast<uint16_t>(_delta_param), _persistence_map.data());
+            set_device_data(tgt, out);
+            return tgt;
+        }
+
+        void reset_history() override
+        {
+            temporal_filter::reset_history();
+            _helper.reset();
+        }
+
+    private:
+        std::shared_ptr<rscuda::cuda_device_memory> _d_input;
+        temporal_filter_cuda_helper _helper;
+    };
+
+    class hole_filling_filter_cuda : public hole_filling_filter
+    {
+    protected:
+        rs2::frame fill_depth_frame(const rs2::frame& f, const rs2::frame_source& source) override
+        {
+            auto tgt = source.allocate_video_frame(_target_stream_profile, f, int(_bpp), int(_width), int(_height), int(_stride), _extension_type);
+            if (!tgt)
+                return tgt;
+
+            if (_hole_filling_mode >= hf_max_value)
+                throw invalid_value_exception(to_string()
+                    << "Unsupported hole filling mode: " << _hole_filling_mode << " is out of range.");
+
+            auto size = _current_frm_size_pixels * _bpp;
+            auto d_src = static_cast<const uint16_t*>(get_device_data(f, size, _d_input));
+            auto out = rscuda::alloc_device_memory(size);
+            cudaMemcpy(out->get(), d_src, size, cudaMemcpyDeviceToDevice);
+            hole_filling_cuda(static_cast<uint16_t*>(out->get()), d_src, int(_width), int(_height), _hole_filling_mode);
+            set_device_data(tgt, out);
+            return tgt;
+        }
+
+    private:
+        std::shared_ptr<rscuda::cuda_device_memory> _d_input;
+    };
+}
+#endif // RS2_USE_CUDA
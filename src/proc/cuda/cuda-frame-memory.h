@@ -0,0 +1,32 @@
+#pragma once
+#ifdef RS2_USE_CUDA
+
+#include "core/streaming.h"
+#include "../../cuda/cuda-device-memory.cuh"
+#include "../../../include/librealsense2/hpp/rs_frame.hpp"
+#include <memory>
+
+namespace librealsense
+{
+    // Device copy of the frame data: the buffer an earlier CUDA block left the frame in,
+    // otherwise an upload of the host data through the given staging buffer
+    inline const void* get_device_data(const rs2::frame& f, size_t size, std::shared_ptr<rscuda::cuda_device_memory>& staging)
+    {
+        // Buffers of other accelerators are uploaded from the (downloaded) host copy
+        if (auto memory = std::dynamic_pointer_cast<rscuda::cuda_device_memory>(((frame_interface*)f.get())->get_device_memory()))
+            if (memory->size() == size)
+                return memory->get();
+
+        if (!staging || staging->size() != size)
+            staging = rscuda::alloc_device_memory(size);
+        staging->upload(f.get_data());
+        return staging->get();
+    }
+
+    // Makes the device buffer the content of the frame, the host copy is only written when the frame data is read
+    inline void set_device_data(const rs2::frame& f, std::shared_ptr<rscuda::cuda_device_memory> memory)
+    {
+        ((frame_interface*)f.get())->attach_device_memory(std::move(memory), true);
+    }
+}
+#endif // RS2_USE_CUDA
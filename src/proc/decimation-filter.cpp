@@ -13,6 +13,14 @@
 #include "proc/synthetic-stream.h"
 #include "proc/decimation-filter.h"
 
+#ifdef __SSSE3__
+#include <tmmintrin.h> // For SSSE3 intrinsics
+#endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h> // For NEON intrinsics
+#define RS2_NEON
+#endif
+
 
 #define PIX_SORT(a,b) { if ((a)>(b)) PIX_SWAP((a),(b)); }
 #define PIX_SWAP(a,b) { pixelvalue temp=(a);(a)=(b);(b)=temp; }
@@ -194,22 +202,417 @@ namespace librealsense
         return PIX_MIN(p[4], p[2]);
     }
 
+    // Sorting networks for the all-valid 2x2 and 3x3 patches, written against pix_min/pix_max
+    // so the same code serves scalar values and vector registers
+    inline uint16_t pix_min(uint16_t a, uint16_t b) { return a < b ? a : b; }
+    inline uint16_t pix_max(uint16_t a, uint16_t b) { return a < b ? b : a; }
+
+    template <class T>
+    inline void pix_sort(T& a, T& b)
+    {
+        T t = pix_min(a, b);
+        b = pix_max(a, b);
+        a = t;
+    }
+
+    // The member one below the middle of four values, as picked by opt_med4
+    template <class T>
+    inline T net_med4(T a, T b, T c, T d)
+    {
+        pix_sort(a, b);
+        pix_sort(c, d);
+        return pix_min(pix_max(a, c), pix_min(b, d));
+    }
+
+    // Same network as opt_med9
+    template <class T>
+    inline T net_med9(T * p)
+    {
+        pix_sort(p[1], p[2]);
+        pix_sort(p[4], p[5]);
+        pix_sort(p[7], p[8]);
+        pix_sort(p[0], p[1]);
+        pix_sort(p[3], p[4]);
+        pix_sort(p[6], p[7]);
+        pix_sort(p[1], p[2]);
+        pix_sort(p[4], p[5]);
+        pix_sort(p[7], p[8]);
+        p[3] = pix_max(p[0], p[3]);
+        p[5] = pix_min(p[5], p[8]);
+        pix_sort(p[4], p[7]);
+        p[6] = pix_max(p[3], p[6]);
+        p[4] = pix_max(p[1], p[4]);
+        p[2] = pix_min(p[2], p[5]);
+        p[4] = pix_min(p[4], p[7]);
+        pix_sort(p[4], p[2]);
+        p[4] = pix_max(p[6], p[4]);
+        return pix_min(p[4], p[2]);
+    }
+
+#if defined(__SSSE3__)
+    // Eight depth values, biased by 0x8000 so that the SSE2 signed comparisons order them as unsigned
+    struct pixels8 { __m128i v; };
+    inline pixels8 pix_min(pixels8 a, pixels8 b) { return{ _mm_min_epi16(a.v, b.v) }; }
+    inline pixels8 pix_max(pixels8 a, pixels8 b) { return{ _mm_max_epi16(a.v, b.v) }; }
+
+    inline pixels8 load_pixels8(const uint16_t * p)
+    {
+        return{ _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p)), _mm_set1_epi16(-32768)) };
+    }
+
+    inline void store_pixels8(uint16_t * p, pixels8 x)
+    {
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(p), _mm_xor_si128(x.v, _mm_set1_epi16(-32768)));
+    }
+
+    // Bit i is set when lane i holds a zero (invalid) value
+    inline int zero_lanes(pixels8 x)
+    {
+        int bytes = _mm_movemask_epi8(_mm_cmpeq_epi16(x.v, _mm_set1_epi16(-32768)));
+        int lanes = 0;
+        for (int i = 0; i < 8; i++)
+            lanes |= ((bytes >> (i * 2)) & 1) << i;
+        return lanes;
+    }
+
+    // Splits 16 consecutive values into the even and odd columns
+    inline void load_pixels8_x2(const uint16_t * p, pixels8& even, pixels8& odd)
+    {
+        const __m128i evens_odds = _mm_setr_epi8(0, 1, 4, 5, 8, 9, 12, 13, 2, 3, 6, 7, 10, 11, 14, 15);
+        __m128i lo = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p)), evens_odds);
+        __m128i hi = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p + 8)), evens_odds);
+        const __m128i bias = _mm_set1_epi16(-32768);
+        even.v = _mm_xor_si128(_mm_unpacklo_epi64(lo, hi), bias);
+        odd.v = _mm_xor_si128(_mm_unpackhi_epi64(lo, hi), bias);
+    }
+
+    // Splits 24 consecutive values into the three columns of each patch
+    inline void load_pixels8_x3(const uint16_t * p, pixels8 * cols)
+    {
+        uint16_t split[3][8];
+        for (int i = 0; i < 8; i++)
+            for (int c = 0; c < 3; c++)
+                split[c][i] = p[i * 3 + c];
+        for (int c = 0; c < 3; c++)
+            cols[c] = load_pixels8(split[c]);
+    }
+#define RS2_DECIMATION_SIMD
+#elif defined(RS2_NEON)
+    struct pixels8 { uint16x8_t v; };
+    inline pixels8 pix_min(pixels8 a, pixels8 b) { return{ vminq_u16(a.v, b.v) }; }
+    inline pixels8 pix_max(pixels8 a, pixels8 b) { return{ vmaxq_u16(a.v, b.v) }; }
+    inline void store_pixels8(uint16_t * p, pixels8 x) { vst1q_u16(p, x.v); }
+
+    inline int zero_lanes(pixels8 x)
+    {
+        uint16_t zeros[8];
+        vst1q_u16(zeros, vceqq_u16(x.v, vdupq_n_u16(0)));
+        int lanes = 0;
+        for (int i = 0; i < 8; i++)
+            lanes |= (zeros[i] & 1) << i;
+        return lanes;
+    }
+
+    inline void load_pixels8_x2(const uint16_t * p, pixels8& even, pixels8& odd)
+    {
+        uint16x8x2_t v = vld2q_u16(p);
+        even.v = v.val[0];
+        odd.v = v.val[1];
+    }
+
+    inline void load_pixels8_x3(const uint16_t * p, pixels8 * cols)
+    {
+        uint16x8x3_t v = vld3q_u16(p);
+        for (int c = 0; c < 3; c++)
+            cols[c].v = v.val[c];
+    }
+#define RS2_DECIMATION_SIMD
+#endif
+
+    // Median of the valid (non-zero) values of a single patch
+    static uint16_t decimate_patch_median(const uint16_t * p, size_t width_in, size_t scale, uint16_t * working_kernel)
+    {
+        auto wk_itr = working_kernel;
+        // extract data the kernel to process
+        for (size_t n = 0; n < scale; ++n, p += width_in)
+        {
+            for (size_t m = 0; m < scale; ++m)
+            {
+                if (*(p + m))
+                    *wk_itr++ = *(p + m);
+            }
+        }
+
+        // For even-size kernels pick the member one below the middle
+        auto ks = (int)(wk_itr - working_kernel);
+        switch (ks)
+        {
+        case 0: return 0;
+        case 1: return working_kernel[0];
+        case 2: return PIX_MIN(working_kernel[0], working_kernel[1]);
+        case 3: return opt_med3<uint16_t>(working_kernel);
+        case 4: return opt_med4<uint16_t>(working_kernel);
+        case 5: return opt_med5<uint16_t>(working_kernel);
+        case 6: return opt_med6<uint16_t>(working_kernel);
+        case 7: return opt_med7<uint16_t>(working_kernel);
+        case 8: return opt_med8<uint16_t>(working_kernel);
+        case 9: return opt_med9<uint16_t>(working_kernel);
+        }
+        return 0;
+    }
+
+    // Decimates output columns [0, count) of one output row with 2x2 or 3x3 median patches, eight outputs at a time.
+    // Patches with invalid values fall back to the scalar median of the valid ones. Returns the number of columns done
+    static size_t decimate_row_median_simd(const uint16_t * in, size_t width_in, size_t scale, size_t count, uint16_t * out, uint16_t * working_kernel)
+    {
+        size_t i = 0;
+#ifdef RS2_DECIMATION_SIMD
+        if (scale == 2)
+        {
+            for (; i + 8 <= count; i += 8)
+            {
+                pixels8 a, b, c, d;
+                load_pixels8_x2(in + i * 2, a, b);
+                load_pixels8_x2(in + width_in + i * 2, c, d);
+
+                store_pixels8(out + i, net_med4(a, b, c, d));
+                if (int invalid = zero_lanes(pix_min(pix_min(a, b), pix_min(c, d))))
+                {
+                    for (int l = 0; l < 8; l++)
+                        if (invalid & (1 << l))
+                            out[i + l] = decimate_patch_median(in + (i + l) * 2, width_in, scale, working_kernel);
+                }
+            }
+        }
+        else if (scale == 3)
+        {
+            for (; i + 8 <= count; i += 8)
+            {
+                pixels8 p[9];
+                load_pixels8_x3(in + i * 3, p);
+                load_pixels8_x3(in + width_in + i * 3, p + 3);
+                load_pixels8_x3(in + width_in * 2 + i * 3, p + 6);
+
+                pixels8 all_min = p[0];
+                for (int k = 1; k < 9; k++)
+                    all_min = pix_min(all_min, p[k]);
+
+                store_pixels8(out + i, net_med9(p));
+                if (int invalid = zero_lanes(all_min))
+                {
+                    for (int l = 0; l < 8; l++)
+                        if (invalid & (1 << l))
+                            out[i + l] = decimate_patch_median(in + (i + l) * 3, width_in, scale, working_kernel);
+                }
+            }
+        }
+#endif
+        return i;
+    }
+
+    // Box filtering of the color formats. The S input rows of an output row are first summed into column sums, 16 bytes
+    // at a time where the instruction set allows, then S columns of each channel are summed and divided by S*S. The
+    // kernels are instantiated per channel count and decimation factor, so the inner loops have constant bounds
+
+    // Sums [0, count) of the rows of in, stride apart, up to 8 rows of 8-bit values fit in 16 bits
+    static void sum_rows(const uint8_t * in, size_t stride, size_t rows, size_t count, uint16_t * sums)
+    {
+        size_t i = 0;
+#if defined(__SSSE3__)
+        const __m128i zero = _mm_setzero_si128();
+        for (; i + 16 <= count; i += 16)
+        {
+            __m128i lo = zero, hi = zero;
+            const uint8_t* p = in + i;
+            for (size_t n = 0; n < rows; ++n, p += stride)
+            {
+                __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+                lo = _mm_add_epi16(lo, _mm_unpacklo_epi8(v, zero));
+                hi = _mm_add_epi16(hi, _mm_unpackhi_epi8(v, zero));
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(sums + i), lo);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(sums + i + 8), hi);
+        }
+#elif defined(RS2_NEON)
+        for (; i + 16 <= count; i += 16)
+        {
+            uint16x8_t lo = vdupq_n_u16(0), hi = vdupq_n_u16(0);
+            const uint8_t* p = in + i;
+            for (size_t n = 0; n < rows; ++n, p += stride)
+            {
+                uint8x16_t v = vld1q_u8(p);
+                lo = vaddw_u8(lo, vget_low_u8(v));
+                hi = vaddw_u8(hi, vget_high_u8(v));
+            }
+            vst1q_u16(sums + i, lo);
+            vst1q_u16(sums + i + 8, hi);
+        }
+#endif
+        for (; i < count; ++i)
+        {
+            uint16_t sum = 0;
+            for (size_t n = 0; n < rows; ++n)
+                sum += in[i + n * stride];
+            sums[i] = sum;
+        }
+    }
+
+    static void sum_rows(const uint16_t * in, size_t stride, size_t rows, size_t count, uint32_t * sums)
+    {
+        std::fill(sums, sums + count, 0u);
+        for (size_t n = 0; n < rows; ++n, in += stride)
+            for (size_t i = 0; i < count; ++i)
+                sums[i] += in[i];
+    }
+
+    // C interleaved channels per pixel, such as RGB8 or Y16
+    template<int C, int S, class T, class Sum>
+    static void box_rows(const T * in, size_t width_in, T * out, size_t real_width, size_t padded_width,
+        size_t row_begin, size_t row_end)
+    {
+        std::vector<Sum> sums(real_width * S * C);
+        for (size_t j = row_begin; j < row_end; ++j)
+        {
+            sum_rows(in + j * S * width_in * C, width_in * C, S, sums.size(), sums.data());
+
+            T* q = out + j * padded_width * C;
+            const Sum* p = sums.data();
+            for (size_t i = 0; i < real_width; ++i, p += S * C)
+            {
+                for (int c = 0; c < C; ++c)
+                {
+                    uint32_t sum = 0;
+                    for (int m = 0; m < S; ++m)
+                        sum += p[m * C + c];
+                    *q++ = static_cast<T>(sum / (S * S));
+                }
+            }
+
+            // Fill-in the padded colums with zeros
+            std::fill(q, out + (j + 1) * padded_width * C, T(0));
+        }
+    }
+
+    // YUYV, or UYVY with luma_first false, decimated without unpacking. An output pair is made of 2*S input pixels,
+    // the lumas of the first and second S of them, and the chroma of the first S, where each chroma sample covers two pixels
+    template<int S, bool luma_first>
+    static void box_rows_422(const uint8_t * in, size_t width_in, uint8_t * out, size_t real_width, size_t padded_width,
+        size_t row_begin, size_t row_end)
+    {
+        const int y = luma_first ? 0 : 1;
+        const int c = luma_first ? 1 : 0;
+        const int s2 = S / 2;
+        const bool odd = (S & 1) != 0;
+
+        auto pairs = real_width / 2;
+        std::vector<uint16_t> sums(pairs * 4 * S);
+        for (size_t j = row_begin; j < row_end; ++j)
+        {
+            sum_rows(in + j * S * width_in * 2, width_in * 2, S, sums.size(), sums.data());
+
+            uint8_t* q = out + j * padded_width * 2;
+            const uint16_t* p = sums.data();
+            for (size_t i = 0; i < pairs; ++i, p += 4 * S)
+            {
+                uint32_t y0 = 0, y1 = 0, u = 0, v = 0;
+                for (int m = 0; m < S; ++m)
+                {
+                    y0 += p[y + 2 * m];
+                    y1 += p[2 * S + y + 2 * m];
+                }
+                for (int m = 0; m < s2; ++m)
+                {
+                    u += 2 * p[c + 4 * m];
+                    v += 2 * p[c + 2 + 4 * m];
+                }
+                if (odd)
+                {
+                    u += p[c + 4 * s2];
+                    v += p[c + 2 + 4 * s2];
+                }
+
+                q[y] = static_cast<uint8_t>(y0 / (S * S));
+                q[c] = static_cast<uint8_t>(u / (S * S));
+                q[y + 2] = static_cast<uint8_t>(y1 / (S * S));
+                q[c + 2] = static_cast<uint8_t>(v / (S * S));
+                q += 4;
+            }
+
+            // Fill-in the padded colums with zeros
+            std::fill(q, out + (j + 1) * padded_width * 2, uint8_t(0));
+        }
+    }
+
+    typedef void(*decimate_color_rows_fn)(rs2_format format, const uint8_t * in, size_t width_in, uint8_t * out,
+        size_t real_width, size_t padded_width, size_t row_begin, size_t row_end);
+
+    template<int S>
+    static void decimate_color_rows(rs2_format format, const uint8_t * in, size_t width_in, uint8_t * out,
+        size_t real_width, size_t padded_width, size_t row_begin, size_t row_end)
+    {
+        switch (format)
+        {
+        case RS2_FORMAT_YUYV:
+            box_rows_422<S, true>(in, width_in, out, real_width, padded_width, row_begin, row_end);
+            break;
+        case RS2_FORMAT_UYVY:
+            box_rows_422<S, false>(in, width_in, out, real_width, padded_width, row_begin, row_end);
+            break;
+        case RS2_FORMAT_RGB8:
+        case RS2_FORMAT_BGR8:
+            box_rows<3, S, uint8_t, uint16_t>(in, width_in, out, real_width, padded_width, row_begin, row_end);
+            break;
+        case RS2_FORMAT_RGBA8:
+        case RS2_FORMAT_BGRA8:
+            box_rows<4, S, uint8_t, uint16_t>(in, width_in, out, real_width, padded_width, row_begin, row_end);
+            break;
+        case RS2_FORMAT_Y8:
+            box_rows<1, S, uint8_t, uint16_t>(in, width_in, out, real_width, padded_width, row_begin, row_end);
+            break;
+        case RS2_FORMAT_Y16:
+            box_rows<1, S, uint16_t, uint32_t>(reinterpret_cast<const uint16_t*>(in), width_in,
+                reinterpret_cast<uint16_t*>(out), real_width, padded_width, row_begin, row_end);
+            break;
+        default:
+            break;
+        }
+    }
+
+    // Of the formats decimate_others supports, 0 for the others
+    static size_t color_bytes_per_pixel(rs2_format format)
+    {
+        switch (format)
+        {
+        case RS2_FORMAT_Y8: return 1;
+        case RS2_FORMAT_YUYV:
+        case RS2_FORMAT_UYVY:
+        case RS2_FORMAT_Y16: return 2;
+        case RS2_FORMAT_RGB8:
+        case RS2_FORMAT_BGR8: return 3;
+        case RS2_FORMAT_RGBA8:
+        case RS2_FORMAT_BGRA8: return 4;
+        default: return 0;
+        }
+    }
+
     const uint8_t decimation_min_val = 1;
     const uint8_t decimation_max_val = 8;    // Decimation levels according to the reference design
     const uint8_t decimation_default_val = 2;
     const uint8_t decimation_step = 1;    // Linear decimation
 
     decimation_filter::decimation_filter() :
-        _decimation_factor(decimation_default_val),
-        _control_val(decimation_default_val),
         _patch_size(decimation_default_val),
-        _kernel_size(_patch_size*_patch_size),
         _real_width(),
         _real_height(0),
         _padded_width(0),
         _padded_height(0),
+        _decimation_factor(decimation_default_val),
+        _control_val(decimation_default_val),
+        _kernel_size(_patch_size*_patch_size),
         _recalc_profile(false),
-        _options_changed(false)
+        _options_changed(false),
+        _processing_threads(processing_threads_default),
+        _executor(processing_threads_default)
     {
         _stream_filter.stream = RS2_STREAM_DEPTH;
         _stream_filter.format = RS2_FORMAT_Z16;
@@ -237,6 +640,9 @@ namespace librealsense
             }
         });
 
+        register_processing_threads_option(*this, _processing_threads, _executor, _mutex,
+            "Number of threads used to decimate each frame, 0 for all hardware threads", "decimation");
+
         register_option(RS2_OPTION_FILTER_MAGNITUDE, decimation_control);
     }
 
@@ -259,9 +665,7 @@ namespace librealsense
         {
             if (format == RS2_FORMAT_Z16)
             {
-                decimate_depth(static_cast<const uint16_t*>(src.get_data()),
-                    static_cast<uint16_t*>(const_cast<void*>(tgt.get_data())),
-                    src.get_width(), src.get_height(), this->_patch_size);
+                decimate_depth_frame(src, tgt);
             }
             else
             {
@@ -273,9 +677,16 @@ namespace librealsense
         }
     }
 
+    void decimation_filter::decimate_depth_frame(const rs2::video_frame& source, const rs2::frame& target)
+    {
+        decimate_depth(static_cast<const uint16_t*>(source.get_data()),
+            static_cast<uint16_t*>(const_cast<void*>(target.get_data())),
+            source.get_width(), source.get_height(), this->_patch_size);
+    }
+
     void  decimation_filter::update_output_profile(const rs2::frame& f)
     {
-        if (_options_changed || f.get_profile().get() != _source_stream_profile.get())
+        if (_options_changed || frame_profile(f) != _source_stream_profile.get())
         {
             _options_changed = false;
             _source_stream_profile = f.get_profile();
@@ -355,94 +766,38 @@ namespace librealsense
     void decimation_filter::decimate_depth(const uint16_t * frame_data_in, uint16_t * frame_data_out,
         size_t width_in, size_t height_in, size_t scale)
     {
-        // Use median filtering
-        std::vector<uint16_t> working_kernel(_kernel_size);
-        auto wk_begin = working_kernel.data();
-        auto wk_itr = wk_begin;
-        std::vector<uint16_t*> pixel_raws(scale);
-        uint16_t* block_start = const_cast<uint16_t*>(frame_data_in);
-
-        if (scale == 2 || scale == 3)
+        // Output rows are independent and are processed in bands on the worker threads
+        size_t bands = std::max<size_t>(1, std::min<size_t>(_executor.size() > 1 ? _executor.size() * 4 : 1, _real_height));
+        _executor.for_each(bands, [&](size_t b)
         {
-            for (int j = 0; j < _real_height; j++)
-            {
-                uint16_t *p{};
-                // Mark the beginning of each of the N lines that the filter will run upon
-                for (size_t i = 0; i < pixel_raws.size(); i++)
-                    pixel_raws[i] = block_start + (width_in*i);
-
-                for (size_t i = 0, chunk_offset = 0; i < _real_width; i++)
-                {
-                    wk_itr = wk_begin;
-                    // extract data the kernel to process
-                    for (size_t n = 0; n < scale; ++n)
-                    {
-                        p = pixel_raws[n] + chunk_offset;
-                        for (size_t m = 0; m < scale; ++m)
-                        {
-                            if (*(p + m))
-                                *wk_itr++ = *(p + m);
-                        }
-                    }
+            decimate_depth_rows(frame_data_in, frame_data_out, width_in, scale,
+                _real_height * b / bands, _real_height * (b + 1) / bands);
+        });
 
-                    // For even-size kernels pick the member one below the middle
-                    auto ks = (int)(wk_itr - wk_begin);
-                    if (ks == 0)
-                        *frame_data_out++ = 0;
-                    else
-                    {
-                        switch (ks)
-                        {
-                        case 1:
-                            *frame_data_out++ = working_kernel[0];
-                            break;
-                        case 2:
-                            *frame_data_out++ = PIX_MIN(working_kernel[0], working_kernel[1]);
-                            break;
-                        case 3:
-                            *frame_data_out++ = opt_med3<uint16_t>(working_kernel.data());
-                            break;
-                        case 4:
-                            *frame_data_out++ = opt_med4<uint16_t>(working_kernel.data());
-                            break;
-                        case 5:
-                            *frame_data_out++ = opt_med5<uint16_t>(working_kernel.data());
-                            break;
-                        case 6:
-                            *frame_data_out++ = opt_med6<uint16_t>(working_kernel.data());
-                            break;
-                        case 7:
-                            *frame_data_out++ = opt_med7<uint16_t>(working_kernel.data());
-                            break;
-                        case 8:
-                            *frame_data_out++ = opt_med8<uint16_t>(working_kernel.data());
-                            break;
-                        case 9:
-                            *frame_data_out++ = opt_med9<uint16_t>(working_kernel.data());
-                            break;
-                        }
-                    }
+        // Fill-in the padded rows with zeros
+        std::fill(frame_data_out + size_t(_real_height) * _padded_width, frame_data_out + size_t(_padded_height) * _padded_width, uint16_t(0));
+    }
 
-                    chunk_offset += scale;
-                }
+    void decimation_filter::decimate_depth_rows(const uint16_t * frame_data_in, uint16_t * frame_data_out,
+        size_t width_in, size_t scale, size_t row_begin, size_t row_end)
+    {
+        // Use median filtering, on patches of up to 3x3
+        uint16_t working_kernel[9];
 
-                // Fill-in the padded colums with zeros
-                for (int j = _real_width; j < _padded_width; j++)
-                    *frame_data_out++ = 0;
+        for (size_t j = row_begin; j < row_end; j++)
+        {
+            // The beginning of the N lines that the filter will run upon
+            const uint16_t* block_start = frame_data_in + j * width_in * scale;
+            uint16_t* out = frame_data_out + j * _padded_width;
 
-                // Skip N lines to the beginnig of the next processing segment
-                block_start += width_in * scale;
+            if (scale == 2 || scale == 3)
+            {
+                size_t i = decimate_row_median_simd(block_start, width_in, scale, _real_width, out, working_kernel);
+                for (; i < _real_width; i++)
+                    out[i] = decimate_patch_median(block_start + i * scale, width_in, scale, working_kernel);
             }
-        }
-        else
-        {
-            for (int j = 0; j < _real_height; j++)
+            else
             {
-                uint16_t *p{};
-                // Mark the beginning of each of the N lines that the filter will run upon
-                for (size_t i = 0; i < pixel_raws.size(); i++)
-                    pixel_raws[i] = block_start + (width_in*i);
-
                 for (size_t i = 0, chunk_offset = 0; i < _real_width; i++)
                 {
                     int sum = 0;
@@ -451,7 +806,7 @@ namespace librealsense
                     // extract data the kernel to process
                     for (size_t n = 0; n < scale; ++n)
                     {
-                        p = pixel_raws[n] + chunk_offset;
+                        const uint16_t* p = block_start + width_in * n + chunk_offset;
                         for (size_t m = 0; m < scale; ++m)
                         {
                             if (*(p + m))
@@ -462,376 +817,41 @@ namespace librealsense
                         }
                     }
 
-                    *frame_data_out++ = (counter == 0 ? 0 : sum / counter);
+                    out[i] = (counter == 0 ? 0 : sum / counter);
                     chunk_offset += scale;
                 }
-
-                // Fill-in the padded colums with zeros
-                for (int j = _real_width; j < _padded_width; j++)
-                    *frame_data_out++ = 0;
-
-                // Skip N lines to the beginnig of the next processing segment
-                block_start += width_in * scale;
             }
-        }
 
-        // Fill-in the padded rows with zeros
-        for (auto v = _real_height; v < _padded_height; ++v)
-        {
-            for (auto u = 0; u < _padded_width; ++u)
-                *frame_data_out++ = 0;
+            // Fill-in the padded colums with zeros
+            std::fill(out + _real_width, out + _padded_width, uint16_t(0));
         }
     }
 
     void decimation_filter::decimate_others(rs2_format format, const void * frame_data_in, void * frame_data_out,
         size_t width_in, size_t height_in, size_t scale)
     {
-        int sum = 0;
-        auto patch_size = scale * scale;
-
-        switch (format)
-        {
-        case RS2_FORMAT_YUYV:
-        {
-            uint8_t* from = (uint8_t*)frame_data_in;
-            uint8_t* p = nullptr;
-            uint8_t* q = (uint8_t*)frame_data_out;
-
-            auto w_2 = width_in >> 1;
-            auto rw_2 = _real_width >> 1;
-            auto pw_2 = _padded_width >> 1;
-            auto s2 = scale >> 1;
-            bool odd = (scale & 1);
-            for (int j = 0; j < _real_height; ++j)
-            {
-                for (int i = 0; i < rw_2; ++i)
-                {
-                    p = from + scale * (j * w_2 + i) * 4;
-                    sum = 0;
-                    for (int n = 0; n < scale; ++n)
-                    {
-                        for (int m = 0; m < scale; ++m)
-                            sum += p[m * 2];
-
-                        p += w_2 * 4;
-                    }
-                    *q++ = (uint8_t)(sum / patch_size);
-
-                    p = from + scale * (j * w_2 + i) * 4 + 1;
-                    sum = 0;
-                    for (int n = 0; n < scale; ++n)
-                    {
-                        for (int m = 0; m < s2; ++m)
-                            sum += 2 * p[m * 4];
-
-                        if (odd)
-                            sum += p[s2 * 4];
-
-                        p += w_2 * 4;
-                    }
-                    *q++ = (uint8_t)(sum / patch_size);
-
-                    p = from + scale * (j * w_2 + i) * 4 + s2 * 4 + (odd ? 2 : 0);
-                    sum = 0;
-                    for (int n = 0; n < scale; ++n)
-                    {
-                        for (int m = 0; m < scale; ++m)
-                            sum += p[m * 2];
-
-                        p += w_2 * 4;
-                    }
-                    *q++ = (uint8_t)(sum / patch_size);
-
-                    p = from + scale * (j * w_2 + i) * 4 + 3;
-                    sum = 0;
-                    for (int n = 0; n < scale; ++n)
-                    {
-                        for (int m = 0; m < s2; ++m)
-                            sum += 2 * p[m * 4];
-
-                        if (odd)
-                            sum += p[s2 * 4];
-
-                        p += w_2 * 4;
-                    }
-                    *q++ = (uint8_t)(sum / patch_size);
-                }
-
-                for (int i = rw_2; i < pw_2; ++i)
-                {
-                    *q++ = 0;
-                    *q++ = 0;
-                    *q++ = 0;
-                    *q++ = 0;
-                }
-            }
-
-            for (int j = _real_height; j < _padded_height; ++j)
-            {
-                for (int i = 0; i < _padded_width; ++i)
-                {
-                    *q++ = 0;
-                    *q++ = 0;
-                }
-            }
-        }
-        break;
-
-        case RS2_FORMAT_UYVY:
-        {
-            uint8_t* from = (uint8_t*)frame_data_in;
-            uint8_t* p = nullptr;
-            uint8_t* q = (uint8_t*)frame_data_out;
-
-            auto w_2 = width_in >> 1;
-            auto rw_2 = _real_width >> 1;
-            auto pw_2 = _padded_width >> 1;
-            auto s2 = scale >> 1;
-            bool odd = (scale & 1);
-            for (int j = 0; j < _real_height; ++j)
-            {
-                for (int i = 0; i < rw_2; ++i)
-                {
-                    p = from + scale * (j * w_2 + i) * 4;
-                    sum = 0;
-                    for (int n = 0; n < scale; ++n)
-                    {
-                        for (int m = 0; m < s2; ++m)
-                            sum += 2 * p[m * 4];
-
-                        if (odd)
-                            sum += p[s2 * 4];
-
-                        p += w_2 * 4;
-                    }
-                    *q++ = (uint8_t)(sum / patch_size);
-
-                    p = from + scale * (j * w_2 + i) * 4 + 1;
-                    sum = 0;
-                    for (int n = 0; n < scale; ++n)
-                    {
-                        for (int m = 0; m < scale; ++m)
-                            sum += p[m * 2];
-
-                        p += w_2 * 4;
-                    }
-                    *q++ = (uint8_t)(sum / patch_size);
-
-                    p = from + scale * (j * w_2 + i) * 4 + 2;
-                    sum = 0;
-                    for (int n = 0; n < scale; ++n)
-                    {
-                        for (int m = 0; m < s2; ++m)
-                            sum += 2 * p[m * 4];
-
-                        if (odd)
-                            sum += p[s2 * 4];
-
-                        p += w_2 * 4;
-                    }
-                    *q++ = (uint8_t)(sum / patch_size);
-
-                    p = from + scale * (j * w_2 + i) * 4 + s2 * 4 + (odd ? 3 : 1);
-                    sum = 0;
-                    for (int n = 0; n < scale; ++n)
-                    {
-                        for (int m = 0; m < scale; ++m)
-                            sum += p[m * 2];
-
-                        p += w_2 * 4;
-                    }
-                    *q++ = (uint8_t)(sum / patch_size);
-                }
-
-                for (int i = rw_2; i < pw_2; ++i)
-                {
-                    *q++ = 0;
-                    *q++ = 0;
-                    *q++ = 0;
-                    *q++ = 0;
-                }
-            }
-
-            for (int j = _real_height; j < _padded_height; ++j)
-            {
-                for (int i = 0; i < _padded_width; ++i)
-                {
-                    *q++ = 0;
-                    *q++ = 0;
-                }
-            }
-        }
-        break;
-
-        case RS2_FORMAT_RGB8:
-        case RS2_FORMAT_BGR8:
-        {
-            uint8_t* from = (uint8_t*)frame_data_in;
-            uint8_t* p = nullptr;
-            uint8_t* q = (uint8_t*)frame_data_out;;
-
-            for (int j = 0; j < _real_height; ++j)
-            {
-                for (int i = 0; i < _real_width; ++i)
-                {
-                    for (int k = 0; k < 3; ++k)
-                    {
-                        p = from + scale * (j * width_in + i) * 3 + k;
-                        sum = 0;
-                        for (int n = 0; n < scale; ++n)
-                        {
-                            for (int m = 0; m < scale; ++m)
-                                sum += p[m * 3];
-
-                            p += width_in * 3;
-                        }
-
-                        *q++ = (uint8_t)(sum / patch_size);
-                    }
-                }
-
-                for (int i = _real_width; i < _padded_width; ++i)
-                {
-                    *q++ = 0;
-                    *q++ = 0;
-                    *q++ = 0;
-                }
-            }
-
-            for (int j = _real_height; j < _padded_height; ++j)
-            {
-                for (int i = 0; i < _padded_width; ++i)
-                {
-                    *q++ = 0;
-                    *q++ = 0;
-                    *q++ = 0;
-                }
-            }
-        }
-        break;
-
-        case RS2_FORMAT_RGBA8:
-        case RS2_FORMAT_BGRA8:
-        {
-            uint8_t* from = (uint8_t*)frame_data_in;
-            uint8_t* p = nullptr;
-            uint8_t* q = (uint8_t*)frame_data_out;
-
-            for (int j = 0; j < _real_height; ++j)
-            {
-                for (int i = 0; i < _real_width; ++i)
-                {
-                    for (int k = 0; k < 4; ++k)
-                    {
-                        p = from + scale * (j * width_in + i) * 4 + k;
-                        sum = 0;
-                        for (int n = 0; n < scale; ++n)
-                        {
-                            for (int m = 0; m < scale; ++m)
-                                sum += p[m * 4];
-
-                            p += width_in * 4;
-                        }
-
-                        *q++ = (uint8_t)(sum / patch_size);
-                    }
-                }
-
-                for (int i = _real_width; i < _padded_width; ++i)
-                {
-                    *q++ = 0;
-                    *q++ = 0;
-                    *q++ = 0;
-                    *q++ = 0;
-                }
-            }
+        static const decimate_color_rows_fn by_scale[] = { nullptr,
+            decimate_color_rows<1>, decimate_color_rows<2>, decimate_color_rows<3>, decimate_color_rows<4>,
+            decimate_color_rows<5>, decimate_color_rows<6>, decimate_color_rows<7>, decimate_color_rows<8> };
 
-            for (int j = _real_height; j < _padded_height; ++j)
-            {
-                for (int i = 0; i < _padded_width; ++i)
-                {
-                    *q++ = 0;
-                    *q++ = 0;
-                    *q++ = 0;
-                    *q++ = 0;
-                }
-            }
-        }
-        break;
+        auto bpp = color_bytes_per_pixel(format);
+        if (!bpp || scale < 1 || scale > decimation_max_val)
+            return;
 
-        case RS2_FORMAT_Y8:
-        {
-            uint8_t* from = (uint8_t*)frame_data_in;
-            uint8_t* p = nullptr;
-            uint8_t* q = (uint8_t*)frame_data_out;
-
-            for (int j = 0; j < _real_height; ++j)
-            {
-                for (int i = 0; i < _real_width; ++i)
-                {
-                    p = from + scale * (j * width_in + i);
-                    sum = 0;
-                    for (int n = 0; n < scale; ++n)
-                    {
-                        for (int m = 0; m < scale; ++m)
-                            sum += p[m];
-
-                        p += width_in;
-                    }
-
-                    *q++ = (uint8_t)(sum / patch_size);
-                }
-
-                for (int i = _real_width; i < _padded_width; ++i)
-                    *q++ = 0;
-            }
-
-            for (int j = _real_height; j < _padded_height; ++j)
-            {
-                for (int i = 0; i < _padded_width; ++i)
-                    *q++ = 0;
-            }
-        }
-        break;
+        auto in = static_cast<const uint8_t*>(frame_data_in);
+        auto out = static_cast<uint8_t*>(frame_data_out);
+        auto decimate_rows = by_scale[scale];
 
-        case RS2_FORMAT_Y16:
+        // Output rows are independent and are processed in bands on the worker threads
+        size_t bands = std::max<size_t>(1, std::min<size_t>(_executor.size() > 1 ? _executor.size() * 4 : 1, _real_height));
+        _executor.for_each(bands, [&](size_t b)
         {
-            uint16_t* from = (uint16_t*)frame_data_in;
-            uint16_t* p = nullptr;
-            uint16_t* q = (uint16_t*)frame_data_out;
-
-            for (int j = 0; j < _real_height; ++j)
-            {
-                for (int i = 0; i < _real_width; ++i)
-                {
-                    p = from + scale * (j * width_in + i);
-                    sum = 0;
-                    for (int n = 0; n < scale; ++n)
-                    {
-                        for (int m = 0; m < scale; ++m)
-                            sum += p[m];
-
-                        p += width_in;
-                    }
-
-                    *q++ = (uint16_t)(sum / patch_size);
-                }
-
-                for (int i = _real_width; i < _padded_width; ++i)
-                    *q++ = 0;
-            }
-
-            for (int j = _real_height; j < _padded_height; ++j)
-            {
-                for (int i = 0; i < _padded_width; ++i)
-                    *q++ = 0;
-            }
-        }
-        break;
+            decimate_rows(format, in, width_in, out, _real_width, _padded_width,
+                _real_height * b / bands, _real_height * (b + 1) / bands);
+        });
 
-        default:
-            break;
-        }
+        // Fill-in the padded rows with zeros
+        std::fill(out + size_t(_real_height) * _padded_width * bpp, out + size_t(_padded_height) * _padded_width * bpp, uint8_t(0));
     }
 }
 
@@ -0,0 +1,92 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#include "../include/librealsense2/hpp/rs_sensor.hpp"
+#include "../include/librealsense2/hpp/rs_processing.hpp"
+
+#include "option.h"
+#include "context.h"
+#include "core/video.h"
+#include "proc/synthetic-stream.h"
+#include "proc/depth-compression.h"
+#include "proc/rvl-codec.h"
+
+namespace librealsense
+{
+    // The target profile keeps the image geometry of the source, whatever the layout of the frames is
+    static rs2::stream_profile clone_image_profile(const rs2::stream_profile& source, rs2_format format)
+    {
+        auto target = source.clone(source.stream_type(), source.stream_index(), format);
+        auto src_vspi = dynamic_cast<video_stream_profile_interface*>(source.get()->profile);
+        auto tgt_vspi = dynamic_cast<video_stream_profile_interface*>(target.get()->profile);
+        rs2_intrinsics src_intrin = src_vspi->get_intrinsics();
+
+        tgt_vspi->set_intrinsics([src_intrin]() { return src_intrin; });
+        tgt_vspi->set_dims(src_vspi->get_width(), src_vspi->get_height());
+        return target;
+    }
+
+    depth_compression::depth_compression()
+    {
+        _stream_filter.stream = RS2_STREAM_DEPTH;
+        _stream_filter.format = RS2_FORMAT_Z16;
+    }
+
+    void depth_compression::update_output_profile(const rs2::frame& f)
+    {
+        if (frame_profile(f) != _source_stream_profile.get())
+        {
+            _source_stream_profile = f.get_profile();
+            _target_stream_profile = clone_image_profile(_source_stream_profile, RS2_FORMAT_Z16_RVL);
+        }
+    }
+
+    rs2::frame depth_compression::process_frame(const rs2::frame_source& source, const rs2::frame& f)
+    {
+        update_output_profile(f);
+
+        auto vf = f.as<rs2::video_frame>();
+        rvl_encode(static_cast<const uint16_t*>(vf.get_data()), vf.get_width() * vf.get_height(), _buffer);
+
+        auto size = static_cast<int>(_buffer.size());
+        auto tgt = source.allocate_video_frame(_target_stream_profile, f, 1, size, 1, size, RS2_EXTENSION_VIDEO_FRAME);
+        if (tgt)
+            memcpy(const_cast<void*>(tgt.get_data()), _buffer.data(), _buffer.size());
+        return tgt;
+    }
+
+    depth_decompression::depth_decompression()
+    {
+        _stream_filter.stream = RS2_STREAM_DEPTH;
+        _stream_filter.format = RS2_FORMAT_Z16_RVL;
+    }
+
+    void depth_decompression::update_output_profile(const rs2::frame& f)
+    {
+        if (frame_profile(f) != _source_stream_profile.get())
+        {
+            _source_stream_profile = f.get_profile();
+            _target_stream_profile = clone_image_profile(_source_stream_profile, RS2_FORMAT_Z16);
+        }
+    }
+
+    rs2::frame depth_decompression::process_frame(const rs2::frame_source& source, const rs2::frame& f)
+    {
+        update_output_profile(f);
+
+        auto vp = _target_stream_profile.as<rs2::video_stream_profile>();
+        auto width = vp.width(), height = vp.height();
+        auto tgt = source.allocate_video_frame(_target_stream_profile, f, 2, width, height, width * 2, RS2_EXTENSION_DEPTH_FRAME);
+        if (!tgt)
+            return tgt;
+
+        auto vf = f.as<rs2::video_frame>();
+        if (!rvl_decode(static_cast<const uint8_t*>(vf.get_data()), vf.get_stride_in_bytes() * vf.get_height(),
+                        static_cast<uint16_t*>(const_cast<void*>(tgt.get_data())), width * height))
+        {
+            LOG_WARNING("Compressed depth frame " << f.get_frame_number() << " does not match a " << width << "x" << height << " image");
+            return rs2::frame{};
+        }
+        return tgt;
+    }
+}
@@ -0,0 +1,46 @@
+// Depth compression blocks pack Z16 depth into RVL-coded frames and restore it losslessly
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "../include/librealsense2/hpp/rs_frame.hpp"
+#include "../include/librealsense2/hpp/rs_processing.hpp"
+
+#include <vector>
+
+namespace librealsense
+{
+    // Z16 frames are encoded into RS2_FORMAT_Z16_RVL frames holding the compressed payload as a single row of bytes,
+    // the resolution and intrinsics of the image are kept by the stream profile
+    class depth_compression : public stream_filter_processing_block
+    {
+    public:
+        depth_compression();
+
+    protected:
+        rs2::frame process_frame(const rs2::frame_source& source, const rs2::frame& f) override;
+
+    private:
+        void update_output_profile(const rs2::frame& f);
+
+        rs2::stream_profile     _source_stream_profile;
+        rs2::stream_profile     _target_stream_profile;
+        std::vector<uint8_t>    _buffer;
+    };
+
+    class depth_decompression : public stream_filter_processing_block
+    {
+    public:
+        depth_decompression();
+
+    protected:
+        rs2::frame process_frame(const rs2::frame_source& source, const rs2::frame& f) override;
+
+    private:
+        void update_output_profile(const rs2::frame& f);
+
+        rs2::stream_profile     _source_stream_profile;
+        rs2::stream_profile     _target_stream_profile;
+    };
+}
@@ -0,0 +1,210 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#include "../include/librealsense2/hpp/rs_sensor.hpp"
+#include "../include/librealsense2/hpp/rs_processing.hpp"
+
+#include "option.h"
+#include "core/video.h"
+#include "proc/synthetic-stream.h"
+#include "proc/decimation-filter.h"
+#include "proc/disparity-transform.h"
+#include "proc/spatial-filter.h"
+#include "proc/temporal-filter.h"
+#include "proc/depth-refine.h"
+
+namespace librealsense
+{
+    depth_refine::depth_refine(std::shared_ptr<decimation_filter> decimation,
+        std::shared_ptr<disparity_transform> to_disparity,
+        std::shared_ptr<spatial_filter> spatial,
+        std::shared_ptr<temporal_filter> temporal,
+        std::shared_ptr<disparity_transform> to_depth) :
+        _decimation(decimation),
+        _to_disparity(to_disparity),
+        _spatial(spatial),
+        _temporal(temporal),
+        _to_depth(to_depth),
+        _disparity_domain(false),
+        _target_type(RS2_EXTENSION_DEPTH_FRAME),
+        _width(0), _height(0),
+        _processing_threads(processing_threads_default),
+        _executor(processing_threads_default)
+    {
+        if (_to_depth && !_to_disparity)
+            throw invalid_value_exception("Depth refinement: a disparity to depth stage requires a depth to disparity stage");
+        if (_to_disparity && _to_disparity == _to_depth)
+            throw invalid_value_exception("Depth refinement: the two disparity stages must be different blocks");
+
+        _stream_filter.stream = RS2_STREAM_DEPTH;
+        _stream_filter.format = RS2_FORMAT_Z16;
+
+        // The spatial filter runs on its own threads
+        register_processing_threads_option(*this, _processing_threads, _executor, _mutex,
+            "Number of threads used to refine each frame, 0 for all hardware threads", "depth refinement");
+    }
+
+    rs2::frame depth_refine::process_frame(const rs2::frame_source& source, const rs2::frame& f)
+    {
+        // The options of the stages take the same locks
+        std::vector<std::unique_lock<std::mutex>> locks;
+        if (_decimation) locks.emplace_back(_decimation->_mutex);
+        if (_to_disparity) locks.emplace_back(_to_disparity->_mutex);
+        if (_spatial) locks.emplace_back(_spatial->_mutex);
+        if (_temporal) locks.emplace_back(_temporal->_mutex);
+        if (_to_depth) locks.emplace_back(_to_depth->_mutex);
+
+        update_configuration(f, source);
+
+        const int bpp = (_target_type == RS2_EXTENSION_DISPARITY_FRAME) ? sizeof(float) : sizeof(uint16_t);
+        auto tgt = source.allocate_video_frame(_target_stream_profile, f, bpp, int(_width), int(_height), int(_width) * bpp, _target_type);
+        if (tgt)
+        {
+            auto out = const_cast<void*>(tgt.get_data());
+            auto vf = f.as<rs2::video_frame>();
+
+            if (!_disparity_domain)
+                refine_depth(vf, static_cast<uint16_t*>(out));
+            else if (_to_depth)
+                refine_disparity(vf, _disparity.data(), static_cast<uint16_t*>(out));
+            else
+                refine_disparity(vf, static_cast<float*>(out), nullptr);
+        }
+        return tgt;
+    }
+
+    rs2::stream_profile depth_refine::input_profile(const rs2::frame& f)
+    {
+        if (!_decimation)
+            return f.get_profile();
+
+        _decimation->update_output_profile(f);
+        return _decimation->_target_stream_profile;
+    }
+
+    void depth_refine::update_configuration(const rs2::frame& f, const rs2::frame_source& source)
+    {
+        if ((_to_disparity && !_to_disparity->_transform_to_disparity) || (_to_depth && _to_depth->_transform_to_disparity))
+            throw invalid_value_exception("Depth refinement: a disparity stage is set to the wrong transformation mode");
+
+        auto profile = input_profile(f);
+        if (profile.get() != _source_stream_profile.get())
+        {
+            _source_stream_profile = profile;
+            auto vp = profile.as<rs2::video_stream_profile>();
+            _width = vp.width();
+            _height = vp.height();
+            _source_probe = source.allocate_video_frame(profile, f, sizeof(uint16_t), 1, 1, sizeof(uint16_t), RS2_EXTENSION_VIDEO_FRAME);
+
+            // Depth from sensors that are not stereoscopic is refined in the depth domain
+            _disparity_domain = false;
+            if (_to_disparity)
+            {
+                _to_disparity->update_transformation_profile(_source_probe);
+                _disparity_domain = _to_disparity->_stereoscopic_depth;
+            }
+
+            if (_disparity_domain)
+            {
+                _work_stream_profile = profile.clone(RS2_STREAM_DEPTH, 0, RS2_FORMAT_DISPARITY32);
+                _work_probe = source.allocate_video_frame(_work_stream_profile, f, sizeof(float), 1, 1, sizeof(float), RS2_EXTENSION_DISPARITY_FRAME);
+                if (_to_depth)
+                {
+                    _to_depth->update_transformation_profile(_work_probe);
+                    _target_stream_profile = _to_depth->_target_stream_profile;
+                    _target_type = RS2_EXTENSION_DEPTH_FRAME;
+                }
+                else
+                {
+                    _target_stream_profile = _work_stream_profile;
+                    _target_type = RS2_EXTENSION_DISPARITY_FRAME;
+                }
+            }
+            else
+            {
+                _work_stream_profile = _decimation ? profile : profile.clone(RS2_STREAM_DEPTH, 0, RS2_FORMAT_Z16);
+                _work_probe = _source_probe;
+                _target_stream_profile = _work_stream_profile;
+                _target_type = RS2_EXTENSION_DEPTH_FRAME;
+            }
+
+            _decimated.resize((_disparity_domain && _decimation) ? _width * _height : 0);
+            _disparity.resize((_disparity_domain && _to_depth) ? _width * _height : 0);
+        }
+
+        // The stages compare the profile of the probe with their own, the temporal filter restarts its history here
+        if (_spatial)
+            _spatial->update_configuration(_work_probe);
+        if (_temporal)
+            _temporal->update_configuration(_work_probe);
+    }
+
+    void depth_refine::convert_to_disparity(const rs2::video_frame& f, const float* table, float* disparity, size_t row_begin, size_t row_end)
+    {
+        auto depth = static_cast<const uint16_t*>(f.get_data());
+        size_t valid_end = row_end;
+        if (_decimation)
+        {
+            // The rows are decimated just before they are converted, while they are still in cache
+            valid_end = std::min<size_t>(row_end, _decimation->_real_height);
+            if (row_begin < valid_end)
+                _decimation->decimate_depth_rows(depth, _decimated.data(), f.get_width(), _decimation->_patch_size, row_begin, valid_end);
+            depth = _decimated.data();
+        }
+
+        for (size_t i = row_begin * _width; i < valid_end * _width; i++)
+            disparity[i] = table[depth[i]];
+
+        // Padding rows of the decimated image
+        if (valid_end < row_end)
+            std::fill(disparity + std::max(row_begin, valid_end) * _width, disparity + row_end * _width, 0.f);
+    }
+
+    void depth_refine::refine_depth(const rs2::video_frame& f, uint16_t* depth)
+    {
+        auto in = static_cast<const uint16_t*>(f.get_data());
+        if (_decimation)
+            _decimation->decimate_depth(in, depth, f.get_width(), f.get_height(), _decimation->_patch_size);
+        else
+            memcpy(depth, in, _width * _height * sizeof(uint16_t));
+
+        if (_spatial)
+            _spatial->dxf_smooth<uint16_t>(depth, _spatial->_spatial_alpha_param, _spatial->_spatial_edge_threshold, _spatial->_spatial_iterations);
+
+        if (_temporal)
+        {
+            auto last_frame = reinterpret_cast<uint16_t*>(_temporal->_last_frame.data());
+            auto history = _temporal->_history.data();
+            _executor.for_each_range(_width * _height, 16, [&](size_t begin, size_t end)
+            {
+                _temporal->temp_jw_smooth_range(depth, last_frame, history, begin, end);
+            });
+        }
+    }
+
+    void depth_refine::refine_disparity(const rs2::video_frame& f, float* disparity, uint16_t* depth)
+    {
+        // Built before the threads start, the table changes with the conversion factor only
+        auto table = _to_disparity->lookup_table(_to_disparity->_disparity32_table, _to_disparity->_disparity32_factor, 0.f).data();
+        _executor.for_each_range(_height, 1, [&](size_t begin, size_t end)
+        {
+            convert_to_disparity(f, table, disparity, begin, end);
+        });
+
+        if (_spatial)
+            _spatial->dxf_smooth<float>(disparity, _spatial->_spatial_alpha_param, _spatial->_spatial_edge_threshold, _spatial->_spatial_iterations);
+
+        if (!_temporal && !depth)
+            return;
+
+        auto last_frame = _temporal ? reinterpret_cast<float*>(_temporal->_last_frame.data()) : nullptr;
+        auto history = _temporal ? _temporal->_history.data() : nullptr;
+        _executor.for_each_range(_width * _height, 16, [&](size_t begin, size_t end)
+        {
+            if (_temporal)
+                _temporal->temp_jw_smooth_range(disparity, last_frame, history, begin, end);
+            if (depth)
+                _to_depth->convert(disparity + begin, depth + begin, end - begin);
+        });
+    }
+}
@@ -0,0 +1,69 @@
+// Depth refinement block runs the recommended post-processing chain in a single block
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "../include/librealsense2/hpp/rs_frame.hpp"
+#include "../include/librealsense2/hpp/rs_processing.hpp"
+#include "concurrency.h"
+
+#include <vector>
+
+namespace librealsense
+{
+    class decimation_filter;
+    class disparity_transform;
+    class spatial_filter;
+    class temporal_filter;
+
+    // Runs decimation, depth to disparity, spatial, temporal and disparity to depth over a Z16 frame
+    // and allocates only the output frame. Every stage is optional and is configured through its own block,
+    // whose options are read on each frame. The stages run their host implementations, and the disparity
+    // domain is always DISPARITY32, the fixed point option of the transform is not used.
+    // The decimated rows are converted to disparity while they are in cache, and the temporal filter and
+    // the conversion back to depth run together over each part of the image. The spatial filter needs
+    // whole columns for its vertical pass and runs in between on the disparity image
+    class depth_refine : public stream_filter_processing_block
+    {
+    public:
+        depth_refine(std::shared_ptr<decimation_filter> decimation,
+            std::shared_ptr<disparity_transform> to_disparity,
+            std::shared_ptr<spatial_filter> spatial,
+            std::shared_ptr<temporal_filter> temporal,
+            std::shared_ptr<disparity_transform> to_depth);
+
+    protected:
+        rs2::frame process_frame(const rs2::frame_source& source, const rs2::frame& f) override;
+
+    private:
+        void    update_configuration(const rs2::frame& f, const rs2::frame_source& source);
+
+        // Profile of the decimated image, or of the input when there is no decimation
+        rs2::stream_profile input_profile(const rs2::frame& f);
+
+        void    convert_to_disparity(const rs2::video_frame& f, const float* table, float* disparity, size_t row_begin, size_t row_end);
+        void    refine_depth(const rs2::video_frame& f, uint16_t* depth);
+        void    refine_disparity(const rs2::video_frame& f, float* disparity, uint16_t* depth);
+
+        std::shared_ptr<decimation_filter>      _decimation;
+        std::shared_ptr<disparity_transform>    _to_disparity;
+        std::shared_ptr<spatial_filter>         _spatial;
+        std::shared_ptr<temporal_filter>        _temporal;
+        std::shared_ptr<disparity_transform>    _to_depth;
+
+        rs2::stream_profile     _source_stream_profile;     // After decimation
+        rs2::stream_profile     _work_stream_profile;       // Seen by the spatial and temporal filters
+        rs2::stream_profile     _target_stream_profile;
+        rs2::frame              _source_probe;              // Single pixel frames carrying the profiles and the sensor
+        rs2::frame              _work_probe;                // of each stage input, for the stages to configure from
+        bool                    _disparity_domain;
+        rs2_extension           _target_type;
+        size_t                  _width, _height;
+
+        std::vector<uint16_t>   _decimated;
+        std::vector<float>      _disparity;                 // Unused when the output is the disparity itself
+        uint8_t                 _processing_threads;
+        parallel_executor       _executor;
+    };
+}
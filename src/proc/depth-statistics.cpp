@@ -0,0 +1,332 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#include "../include/librealsense2/hpp/rs_sensor.hpp"
+#include "../include/librealsense2/hpp/rs_processing.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include "option.h"
+#include "context.h"
+#include "core/video.h"
+#include "proc/synthetic-stream.h"
+#include "proc/depth-statistics.h"
+
+#ifdef __SSSE3__
+#include <tmmintrin.h> // For SSSE3 intrinsics
+#endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h> // For NEON intrinsics
+#define RS2_NEON
+#endif
+
+namespace librealsense
+{
+    const float distance_min = 0.f;
+    const float distance_max = 16.f;
+    const float distance_step = 0.1f;
+    const float min_distance_default = 0.f;
+    const float max_distance_default = 10.f;
+
+    // Adds the count, sum, min and max of the pixels with depth of the start of a row, eight at a time. The 16 bit
+    // lane counters hold rows of up to 2^16 pixels. Returns the number of pixels done
+    static size_t row_statistics_simd(const uint16_t* row, size_t count, uint64_t& sum, uint32_t& valid, uint16_t& min, uint16_t& max)
+    {
+        size_t i = 0;
+#if defined(__SSSE3__)
+        // The SSE2 min and max are signed, the values are biased by 0x8000 to order them as unsigned
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i bias = _mm_set1_epi16(-32768);
+        __m128i lo = _mm_set1_epi16(32767);
+        __m128i hi = bias;
+        __m128i holes = zero;
+        __m128i sums = zero;
+        for (; i + 8 <= count; i += 8)
+        {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i));
+            __m128i hole = _mm_cmpeq_epi16(v, zero);
+            holes = _mm_sub_epi16(holes, hole);
+            // Holes become the largest value for the min, and are already the smallest for the max
+            lo = _mm_min_epi16(lo, _mm_xor_si128(_mm_or_si128(v, hole), bias));
+            hi = _mm_max_epi16(hi, _mm_xor_si128(v, bias));
+            sums = _mm_add_epi32(sums, _mm_add_epi32(_mm_unpacklo_epi16(v, zero), _mm_unpackhi_epi16(v, zero)));
+        }
+
+        uint16_t lo_lanes[8], hi_lanes[8], hole_lanes[8];
+        uint32_t sum_lanes[4];
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(lo_lanes), _mm_xor_si128(lo, bias));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(hi_lanes), _mm_xor_si128(hi, bias));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(hole_lanes), holes);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(sum_lanes), sums);
+#elif defined(RS2_NEON)
+        uint16x8_t lo = vdupq_n_u16(0xffff);
+        uint16x8_t hi = vdupq_n_u16(0);
+        uint16x8_t holes = vdupq_n_u16(0);
+        uint32x4_t sums = vdupq_n_u32(0);
+        for (; i + 8 <= count; i += 8)
+        {
+            uint16x8_t v = vld1q_u16(row + i);
+            uint16x8_t hole = vceqq_u16(v, vdupq_n_u16(0));
+            holes = vsubq_u16(holes, hole);
+            lo = vminq_u16(lo, vorrq_u16(v, hole));
+            hi = vmaxq_u16(hi, v);
+            sums = vpadalq_u16(sums, v);
+        }
+
+        uint16_t lo_lanes[8], hi_lanes[8], hole_lanes[8];
+        uint32_t sum_lanes[4];
+        vst1q_u16(lo_lanes, lo);
+        vst1q_u16(hi_lanes, hi);
+        vst1q_u16(hole_lanes, holes);
+        vst1q_u32(sum_lanes, sums);
+#endif
+#if defined(__SSSE3__) || defined(RS2_NEON)
+        uint32_t holes_count = 0;
+        for (int k = 0; k < 8; ++k)
+        {
+            holes_count += hole_lanes[k];
+            min = std::min(min, lo_lanes[k]);
+            max = std::max(max, hi_lanes[k]);
+        }
+        for (int k = 0; k < 4; ++k)
+            sum += sum_lanes[k];
+        valid += static_cast<uint32_t>(i) - holes_count;
+#endif
+        return i;
+    }
+
+    void depth_statistics::accumulator::clear()
+    {
+        sum = 0;
+        valid = 0;
+        min = 0xffff;
+        max = 0;
+        coarse.fill(0);
+        histogram.fill(0);
+    }
+
+    void depth_statistics::accumulator::merge(const accumulator& other)
+    {
+        sum += other.sum;
+        valid += other.valid;
+        min = std::min(min, other.min);
+        max = std::max(max, other.max);
+        for (size_t i = 0; i < coarse.size(); ++i)
+            coarse[i] += other.coarse[i];
+        for (size_t i = 0; i < histogram.size(); ++i)
+            histogram[i] += other.histogram[i];
+    }
+
+    depth_statistics::depth_statistics()
+        : _min_distance(min_distance_default),
+          _max_distance(max_distance_default),
+          _width(0), _height(0),
+          _bins_units(0.f), _bins_min(0.f), _bins_max(0.f),
+          _processing_threads(processing_threads_default),
+          _executor(processing_threads_default)
+    {
+        _stream_filter.stream = RS2_STREAM_DEPTH;
+        _stream_filter.format = RS2_FORMAT_Z16;
+
+        auto min_distance = std::make_shared<ptr_option<float>>(distance_min, distance_max, distance_step, min_distance_default,
+            &_min_distance, "Depth of the start of the first histogram bin, in meters");
+        auto max_distance = std::make_shared<ptr_option<float>>(distance_min, distance_max, distance_step, max_distance_default,
+            &_max_distance, "Depth of the end of the last histogram bin, in meters");
+        register_option(RS2_OPTION_MIN_DISTANCE, min_distance);
+        register_option(RS2_OPTION_MAX_DISTANCE, max_distance);
+
+        register_processing_threads_option(*this, _processing_threads, _executor, _mutex,
+            "Number of threads used to measure each frame, 0 for all hardware threads", "depth statistics");
+    }
+
+    void depth_statistics::add_roi(const region_of_interest& roi)
+    {
+        if (roi.min_x > roi.max_x || roi.min_y > roi.max_y)
+            throw invalid_value_exception(to_string() << "Invalid region of interest: (" << roi.min_x << ", " << roi.min_y
+                << ") to (" << roi.max_x << ", " << roi.max_y << ")");
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        _rois.push_back(roi);
+    }
+
+    void depth_statistics::clear_rois()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _rois.clear();
+    }
+
+    void depth_statistics::update_output_profile(const rs2::frame& f)
+    {
+        if (frame_profile(f) == _source_stream_profile.get())
+            return;
+
+        _source_stream_profile = f.get_profile();
+        _target_stream_profile = _source_stream_profile.clone(_source_stream_profile.stream_type(),
+            _source_stream_profile.stream_index(), RS2_FORMAT_DEPTH_STATISTICS);
+        auto vp = _source_stream_profile.as<rs2::video_stream_profile>();
+        _width = vp.width();
+        _height = vp.height();
+    }
+
+    void depth_statistics::update_bins(float units)
+    {
+        if (units == _bins_units && _min_distance == _bins_min && _max_distance == _bins_max && !_bins.empty())
+            return;
+
+        _bins_units = units;
+        _bins_min = _min_distance;
+        _bins_max = _max_distance;
+
+        // The first and the last bins also count the depths below and beyond the range
+        const int last = RS2_DEPTH_STATISTICS_HISTOGRAM_BINS - 1;
+        const float scale = _max_distance > _min_distance ? RS2_DEPTH_STATISTICS_HISTOGRAM_BINS / (_max_distance - _min_distance) : 0.f;
+        _bins.resize(UINT16_MAX + 1);
+        for (size_t d = 0; d <= UINT16_MAX; ++d)
+        {
+            auto bin = std::floor((d * units - _min_distance) * scale);
+            _bins[d] = static_cast<uint8_t>(std::min(std::max(bin, 0.f), float(last)));
+        }
+    }
+
+    void depth_statistics::accumulate(const uint16_t* depth, size_t stride, const region_of_interest& roi, int y0, int y1, accumulator& acc) const
+    {
+        const size_t count = size_t(roi.max_x - roi.min_x + 1);
+        for (int y = y0; y < y1; ++y)
+        {
+            auto row = depth + y * stride + roi.min_x;
+            size_t i = row_statistics_simd(row, count, acc.sum, acc.valid, acc.min, acc.max);
+            for (; i < count; ++i)
+            {
+                auto d = row[i];
+                if (!d)
+                    continue;
+                acc.sum += d;
+                acc.valid++;
+                acc.min = std::min(acc.min, d);
+                acc.max = std::max(acc.max, d);
+            }
+
+            // The histograms are scalar, the row is still in cache from the pass above
+            for (i = 0; i < count; ++i)
+            {
+                auto d = row[i];
+                if (!d)
+                    continue;
+                acc.coarse[d >> 8]++;
+                acc.histogram[_bins[d]]++;
+            }
+        }
+    }
+
+    uint16_t depth_statistics::find_median(const uint16_t* depth, size_t stride, const region_of_interest& roi, const accumulator& acc) const
+    {
+        if (!acc.valid)
+            return 0;
+
+        // The lower median: finds its high byte in the coarse histogram, then its low byte among the pixels of that byte
+        uint32_t rank = (acc.valid - 1) / 2;
+        int high = 0;
+        while (rank >= acc.coarse[high])
+            rank -= acc.coarse[high++];
+
+        std::array<uint32_t, 256> fine{};
+        for (int y = roi.min_y; y <= roi.max_y; ++y)
+        {
+            auto row = depth + y * stride;
+            for (int x = roi.min_x; x <= roi.max_x; ++x)
+            {
+                if (row[x] && (row[x] >> 8) == high)
+                    fine[row[x] & 0xff]++;
+            }
+        }
+
+        int low = 0;
+        while (rank >= fine[low])
+            rank -= fine[low++];
+        return static_cast<uint16_t>((high << 8) | low);
+    }
+
+    rs2::frame depth_statistics::process_frame(const rs2::frame_source& source, const rs2::frame& f)
+    {
+        update_output_profile(f);
+
+        auto src = f.as<rs2::video_frame>();
+        auto units = static_cast<depth_frame*>((frame_interface*)f.get())->get_units();
+        update_bins(units);
+
+        // Without any region the whole frame is measured
+        std::vector<region_of_interest> rois = _rois;
+        if (rois.empty())
+            rois.push_back({ 0, 0, _width - 1, _height - 1 });
+        for (auto&& roi : rois)
+        {
+            roi.min_x = std::max(roi.min_x, 0);
+            roi.min_y = std::max(roi.min_y, 0);
+            roi.max_x = std::min(roi.max_x, _width - 1);
+            roi.max_y = std::min(roi.max_y, _height - 1);
+        }
+
+        // Each region is split into bands of rows, so that a single large region still runs on all of the threads
+        struct job { size_t roi; int y0, y1; };
+        std::vector<job> jobs;
+        for (size_t r = 0; r < rois.size(); ++r)
+        {
+            auto&& roi = rois[r];
+            if (roi.min_x > roi.max_x || roi.min_y > roi.max_y)
+                continue;
+            const int rows = roi.max_y - roi.min_y + 1;
+            const int bands = std::max(1, std::min(rows, int(_executor.size())));
+            for (int b = 0; b < bands; ++b)
+                jobs.push_back({ r, roi.min_y + rows * b / bands, roi.min_y + rows * (b + 1) / bands });
+        }
+
+        auto depth = static_cast<const uint16_t*>(src.get_data());
+        const size_t stride = src.get_stride_in_bytes() / sizeof(uint16_t);
+        _accumulators.resize(jobs.size());
+        _executor.for_each(jobs.size(), [&](size_t j)
+        {
+            _accumulators[j].clear();
+            accumulate(depth, stride, rois[jobs[j].roi], jobs[j].y0, jobs[j].y1, _accumulators[j]);
+        });
+
+        std::vector<accumulator> totals(rois.size());
+        for (auto&& total : totals)
+            total.clear();
+        for (size_t j = 0; j < jobs.size(); ++j)
+            totals[jobs[j].roi].merge(_accumulators[j]);
+
+        const int count = int(rois.size());
+        const int size = sizeof(rs2_depth_statistics);
+        auto tgt = source.allocate_video_frame(_target_stream_profile, f, size, count, 1, count * size, RS2_EXTENSION_VIDEO_FRAME);
+        if (!tgt)
+            return tgt;
+
+        auto out = static_cast<rs2_depth_statistics*>(const_cast<void*>(tgt.get_data()));
+        _executor.for_each(rois.size(), [&](size_t r)
+        {
+            auto&& roi = rois[r];
+            auto&& total = totals[r];
+            auto&& stats = out[r];
+            stats = {};
+            stats.min_x = roi.min_x;
+            stats.min_y = roi.min_y;
+            stats.max_x = roi.max_x;
+            stats.max_y = roi.max_y;
+            if (roi.min_x > roi.max_x || roi.min_y > roi.max_y)
+                return;
+
+            stats.pixels = unsigned(roi.max_x - roi.min_x + 1) * unsigned(roi.max_y - roi.min_y + 1);
+            stats.valid_pixels = total.valid;
+            stats.fill_rate = float(total.valid) / stats.pixels;
+            if (total.valid)
+            {
+                stats.min_depth = total.min * units;
+                stats.max_depth = total.max * units;
+                stats.mean_depth = float(double(total.sum) / total.valid * units);
+                stats.median_depth = find_median(depth, stride, roi, total) * units;
+            }
+            std::copy(total.histogram.begin(), total.histogram.end(), stats.histogram);
+        });
+        return tgt;
+    }
+}
@@ -0,0 +1,66 @@
+// Depth statistics block measures the fill rate and the distribution of the depth over regions of interest
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "../include/librealsense2/hpp/rs_frame.hpp"
+#include "../include/librealsense2/hpp/rs_processing.hpp"
+#include "core/roi.h"
+#include "concurrency.h"
+
+#include <array>
+#include <vector>
+
+namespace librealsense
+{
+    // Outputs a video frame of RS2_FORMAT_DEPTH_STATISTICS holding a row of rs2_depth_statistics, one per region of
+    // interest in the order they were added, or a single one of the whole frame when none was. Regions are given in
+    // pixels, inclusive, and cut to the frame. A depth frame passed in a frameset stays in the output frameset
+    class depth_statistics : public stream_filter_processing_block
+    {
+    public:
+        depth_statistics();
+
+        void add_roi(const region_of_interest& roi);
+        void clear_rois();
+
+    protected:
+        rs2::frame process_frame(const rs2::frame_source& source, const rs2::frame& f) override;
+
+    private:
+        // Sums of a part of the rows of a region, merged into the statistics of the region
+        struct accumulator
+        {
+            uint64_t sum;
+            uint32_t valid;
+            uint16_t min, max;
+            std::array<uint32_t, 256> coarse;   // By the high byte of the depth, to search the median in
+            std::array<uint32_t, RS2_DEPTH_STATISTICS_HISTOGRAM_BINS> histogram;
+
+            void clear();
+            void merge(const accumulator& other);
+        };
+
+        void    update_output_profile(const rs2::frame& f);
+        void    update_bins(float units);
+        void    accumulate(const uint16_t* depth, size_t stride, const region_of_interest& roi, int y0, int y1, accumulator& acc) const;
+        uint16_t find_median(const uint16_t* depth, size_t stride, const region_of_interest& roi, const accumulator& acc) const;
+
+        float                   _min_distance;      // In meters, the range of the histogram
+        float                   _max_distance;
+        std::vector<region_of_interest> _rois;
+        rs2::stream_profile     _source_stream_profile;
+        rs2::stream_profile     _target_stream_profile;
+        int                     _width, _height;
+
+        // Histogram bin of every depth value, rebuilt when the range or the depth units change
+        std::vector<uint8_t>    _bins;
+        float                   _bins_units;
+        float                   _bins_min, _bins_max;
+
+        std::vector<accumulator> _accumulators;
+        uint8_t                 _processing_threads;
+        parallel_executor       _executor;
+    };
+}
@@ -17,13 +17,16 @@ namespace librealsense
 {
     disparity_transform::disparity_transform(bool transform_to_disparity):
         _transform_to_disparity(transform_to_disparity),
+        _fixed_point_disparity(false),
         _update_target(false),
         _stereoscopic_depth(false),
         _focal_lenght_mm(0.f),
         _stereo_baseline(0.f),
         _depth_units(0.f),
         _d2d_convert_factor(0.f),
-        _width(0), _height(0), _bpp(0)
+        _width(0), _height(0), _bpp(0),
+        _disparity32_factor(0.f),
+        _uint16_factor(0.f)
     {
         auto transform_opt = std::make_shared<ptr_option<bool>>(
             false,true,true,true,
@@ -40,6 +43,20 @@ namespace librealsense
             on_set_mode(static_cast<bool>(!!int(val)));
         });
 
+        auto fixed_point_opt = std::make_shared<ptr_option<bool>>(
+            false, true, true, false,
+            &_fixed_point_disparity,
+            "Disparity output format");
+        fixed_point_opt->set_description(false, "DISPARITY32");
+        fixed_point_opt->set_description(true, "DISPARITY16");
+        fixed_point_opt->on_set([this](float val)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _fixed_point_disparity = !!int(val);
+            on_set_mode(_transform_to_disparity);
+        });
+        register_option(RS2_OPTION_DISPARITY_FIXED_POINT, fixed_point_opt);
+
         unregister_option(RS2_OPTION_FRAMES_QUEUE_SIZE);
 
         on_set_mode(_transform_to_disparity);
@@ -74,27 +91,49 @@ namespace librealsense
 
         if (_stereoscopic_depth && (tgt = prepare_target_frame(f, source)))
         {
-            auto src = f.as<rs2::video_frame>();
+            auto in = f.get_data();
+            auto out = const_cast<void*>(tgt.get_data());
 
+            // A disparity d is factor / d in depth units, the frame needs no depth frame to measure distances
             if (_transform_to_disparity)
-                convert<uint16_t, float>(src.get_data(), const_cast<void*>(tgt.get_data()));
+                static_cast<librealsense::depth_frame*>((frame_interface*)tgt.get())->set_disparity_scale(_d2d_convert_factor * _depth_units);
+
+            if (_transform_to_disparity && _fixed_point_disparity)
+                convert((const uint16_t*)in, (uint16_t*)out, lookup_table(_uint16_table, _uint16_factor, 0.5f));
+            else if (_transform_to_disparity)
+                convert((const uint16_t*)in, (float*)out, lookup_table(_disparity32_table, _disparity32_factor, 0.f));
+            else if (f.get_profile().format() == RS2_FORMAT_DISPARITY16)
+                convert((const uint16_t*)in, (uint16_t*)out, lookup_table(_uint16_table, _uint16_factor, 0.5f));
             else
-                convert<float, uint16_t>(src.get_data(), const_cast<void*>(tgt.get_data()));
+                convert((const float*)in, (uint16_t*)out, _width * _height);
         }
 
         return tgt;
     }
 
+    void disparity_transform::convert(const float* in, uint16_t* out, size_t count) const
+    {
+        // Written without branches for the compiler to vectorize, zero and non-finite disparities give no depth
+        const float factor = _d2d_convert_factor;
+        for (size_t i = 0; i < count; i++)
+        {
+            const float input = in[i];
+            const bool valid = input >= std::numeric_limits<float>::min() && input <= std::numeric_limits<float>::max();
+            const float depth = factor / (valid ? input : 1.f) + 0.5f;
+            out[i] = valid ? static_cast<uint16_t>(std::min(depth, float(UINT16_MAX))) : 0;
+        }
+    }
+
     void disparity_transform::on_set_mode(bool to_disparity)
     {
         _transform_to_disparity = to_disparity;
-        _bpp = _transform_to_disparity ? sizeof(float) : sizeof(uint16_t);
+        _bpp = (_transform_to_disparity && !_fixed_point_disparity) ? sizeof(float) : sizeof(uint16_t);
         _update_target = true;
     }
 
     void  disparity_transform::update_transformation_profile(const rs2::frame& f)
     {
-        if(f.get_profile().get() != _source_stream_profile.get())
+        if(frame_profile(f) != _source_stream_profile.get())
         {
             _source_stream_profile = f.get_profile();
 
@@ -150,7 +189,8 @@ namespace librealsense
         // Adjust the target profile
         if (_update_target)
         {
-            auto tgt_format = _transform_to_disparity ? RS2_FORMAT_DISPARITY32 : RS2_FORMAT_Z16;
+            auto tgt_format = !_transform_to_disparity ? RS2_FORMAT_Z16 :
+                _fixed_point_disparity ? RS2_FORMAT_DISPARITY16 : RS2_FORMAT_DISPARITY32;
             _target_stream_profile = _source_stream_profile.clone(RS2_STREAM_DEPTH, 0, tgt_format);
             auto src_vspi = dynamic_cast<video_stream_profile_interface*>(_source_stream_profile.get()->profile);
             auto tgt_vspi = dynamic_cast<video_stream_profile_interface*>(_target_stream_profile.get()->profile);
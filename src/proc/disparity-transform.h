@@ -8,6 +8,9 @@
 #include "../include/librealsense2/hpp/rs_frame.hpp"
 #include "../include/librealsense2/hpp/rs_processing.hpp"
 
+#include <limits>
+#include <vector>
+
 namespace librealsense
 {
 
@@ -21,38 +24,44 @@ namespace librealsense
     protected:
         rs2::frame prepare_target_frame(const rs2::frame& f, const rs2::frame_source& source);
 
-        template<typename Tin, typename Tout>
-        void convert(const void* in_data, void* out_data)
+        // Z16 and DISPARITY16 take 64K values, they are converted through a table of the current conversion factor
+        template<typename Tout>
+        void convert(const uint16_t* in, Tout* out, const std::vector<Tout>& table) const
         {
-            static_assert((std::is_arithmetic<Tin>::value), "disparity transform requires numeric type for input data");
-            static_assert((std::is_arithmetic<Tout>::value), "disparity transform requires numeric type for output data");
-
-            auto in = reinterpret_cast<const Tin*>(in_data);
-            auto out = reinterpret_cast<Tout*>(out_data);
+            const size_t count = _width * _height;
+            const Tout* lut = table.data();
+            for (size_t i = 0; i < count; i++)
+                out[i] = lut[in[i]];
+        }
 
-            bool fp = (std::is_floating_point<Tin>::value);
-            const float round = fp ? 0.5f : 0.f;
+        void convert(const float* in, uint16_t* out, size_t count) const;
 
-            float input{};
-            //TODO SSE optimize
-            for (auto i = 0; i < _height; i++)
-                for (auto j = 0; j < _width; j++)
+        template<typename T>
+        const std::vector<T>& lookup_table(std::vector<T>& table, float& table_factor, float round)
+        {
+            if (table.empty() || table_factor != _d2d_convert_factor)
+            {
+                table.resize(UINT16_MAX + 1);
+                table[0] = 0;
+                for (size_t value = 1; value <= UINT16_MAX; value++)
                 {
-                    input = *in;
-                    if (std::isnormal(input))
-                        *out++ = static_cast<Tout>((_d2d_convert_factor / input)+round);
-                    else
-                        *out++ = 0;
-                    in++;
+                    auto converted = _d2d_convert_factor / value + round;
+                    table[value] = converted < std::numeric_limits<T>::max() ? static_cast<T>(converted) : std::numeric_limits<T>::max();
                 }
+                table_factor = _d2d_convert_factor;
+            }
+            return table;
         }
 
     private:
+        friend class depth_refine;
+
         void    update_transformation_profile(const rs2::frame& f);
 
         void    on_set_mode(bool to_disparity);
 
         bool                    _transform_to_disparity;
+        bool                    _fixed_point_disparity;
         rs2::stream_profile     _source_stream_profile;
         rs2::stream_profile     _target_stream_profile;
         bool                    _update_target;
@@ -63,5 +72,10 @@ namespace librealsense
         float                   _d2d_convert_factor;
         size_t                  _width, _height;
         size_t                  _bpp;
+
+        std::vector<float>      _disparity32_table;
+        float                   _disparity32_factor;
+        std::vector<uint16_t>   _uint16_table; // depth to DISPARITY16 and back use the same table
+        float                   _uint16_factor;
     };
 }
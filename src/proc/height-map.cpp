@@ -0,0 +1,302 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#include "../include/librealsense2/hpp/rs_sensor.hpp"
+#include "../include/librealsense2/hpp/rs_processing.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "option.h"
+#include "context.h"
+#include "core/video.h"
+#include "proc/synthetic-stream.h"
+#include "proc/pointcloud.h"
+#include "proc/height-map.h"
+
+#ifdef __SSSE3__
+#include <tmmintrin.h> // For SSSE3 intrinsics
+#endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h> // For NEON intrinsics
+#define RS2_NEON
+#endif
+
+namespace librealsense
+{
+    const float cell_size_min = 0.01f;
+    const float cell_size_max = 1.f;
+    const float cell_size_step = 0.01f;
+    const float cell_size_default = 0.05f;
+
+    // The cell index of a pixel is computed in 16 bit lanes, the grid stays well below
+    const int cells_min = 16;
+    const int cells_max = 1024;
+    const int cells_step = 1;
+    const int cells_default = 200;
+
+    const float height_min = 0.f;
+    const float height_max = 10.f;
+    const float height_step = 0.01f;
+    const float obstacle_min_height_default = 0.1f;
+    const float obstacle_max_height_default = 2.f;
+
+    // Where the pixels of a frame land on the grid: u and v count the cells from the left and the far edges
+    struct grid_projection
+    {
+        float units;
+        float tx, ty, tz;
+        float left, top;
+        float inv_cell_size;
+        float max_height;
+        int cells;
+    };
+
+    static inline int32_t project_pixel(uint16_t d, float rx, float ry, float rz, const grid_projection& p, float& height)
+    {
+        float z = d * p.units;
+        float gx = rx * z + p.tx;
+        float gy = ry * z + p.ty;
+        height = rz * z + p.tz;
+        float u = (gx - p.left) * p.inv_cell_size;
+        float v = (p.top - gy) * p.inv_cell_size;
+        if (!d || !(height <= p.max_height) || !(u >= 0.f && u < p.cells && v >= 0.f && v < p.cells))
+            return -1;
+        return int32_t(v) * p.cells + int32_t(u);
+    }
+
+    // The cell and the height of the start of a row, four pixels at a time, as project_pixel. Returns the number of pixels done
+    static size_t project_row_simd(const uint16_t* depth, const float* rx, const float* ry, const float* rz, size_t count,
+        const grid_projection& p, int32_t* cells, float* heights)
+    {
+        size_t i = 0;
+#if defined(__SSSE3__)
+        const __m128 units = _mm_set1_ps(p.units);
+        const __m128 tx = _mm_set1_ps(p.tx), ty = _mm_set1_ps(p.ty), tz = _mm_set1_ps(p.tz);
+        const __m128 left = _mm_set1_ps(p.left), top = _mm_set1_ps(p.top);
+        const __m128 inv = _mm_set1_ps(p.inv_cell_size);
+        const __m128 max_height = _mm_set1_ps(p.max_height);
+        const __m128 size = _mm_set1_ps(float(p.cells));
+        const __m128 zero = _mm_setzero_ps();
+        const __m128i zeroi = _mm_setzero_si128();
+        const __m128i stride = _mm_set1_epi32(p.cells);
+        const __m128i none = _mm_set1_epi32(-1);
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128i d = _mm_unpacklo_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(depth + i)), zeroi);
+            __m128 z = _mm_mul_ps(_mm_cvtepi32_ps(d), units);
+            __m128 gx = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(rx + i), z), tx);
+            __m128 gy = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(ry + i), z), ty);
+            __m128 gz = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(rz + i), z), tz);
+            __m128 u = _mm_mul_ps(_mm_sub_ps(gx, left), inv);
+            __m128 v = _mm_mul_ps(_mm_sub_ps(top, gy), inv);
+
+            __m128 in = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(u, zero), _mm_cmplt_ps(u, size)),
+                _mm_and_ps(_mm_cmpge_ps(v, zero), _mm_cmplt_ps(v, size)));
+            in = _mm_and_ps(in, _mm_cmple_ps(gz, max_height));
+            __m128i valid = _mm_andnot_si128(_mm_cmpeq_epi32(d, zeroi), _mm_castps_si128(in));
+
+            // Rows and columns of the valid pixels are positive and fit 16 bits, the high halves of the lanes are zero
+            __m128i index = _mm_add_epi32(_mm_madd_epi16(_mm_cvttps_epi32(v), stride), _mm_cvttps_epi32(u));
+            index = _mm_or_si128(_mm_and_si128(valid, index), _mm_andnot_si128(valid, none));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(cells + i), index);
+            _mm_storeu_ps(heights + i, gz);
+        }
+#elif defined(RS2_NEON)
+        const float32x4_t units = vdupq_n_f32(p.units);
+        const float32x4_t tx = vdupq_n_f32(p.tx), ty = vdupq_n_f32(p.ty), tz = vdupq_n_f32(p.tz);
+        const float32x4_t left = vdupq_n_f32(p.left), top = vdupq_n_f32(p.top);
+        const float32x4_t inv = vdupq_n_f32(p.inv_cell_size);
+        const float32x4_t max_height = vdupq_n_f32(p.max_height);
+        const float32x4_t size = vdupq_n_f32(float(p.cells));
+        const float32x4_t zero = vdupq_n_f32(0.f);
+        const int32x4_t stride = vdupq_n_s32(p.cells);
+        const int32x4_t none = vdupq_n_s32(-1);
+        for (; i + 4 <= count; i += 4)
+        {
+            uint32x4_t d = vmovl_u16(vld1_u16(depth + i));
+            float32x4_t z = vmulq_f32(vcvtq_f32_u32(d), units);
+            float32x4_t gx = vaddq_f32(vmulq_f32(vld1q_f32(rx + i), z), tx);
+            float32x4_t gy = vaddq_f32(vmulq_f32(vld1q_f32(ry + i), z), ty);
+            float32x4_t gz = vaddq_f32(vmulq_f32(vld1q_f32(rz + i), z), tz);
+            float32x4_t u = vmulq_f32(vsubq_f32(gx, left), inv);
+            float32x4_t v = vmulq_f32(vsubq_f32(top, gy), inv);
+
+            uint32x4_t in = vandq_u32(vandq_u32(vcgeq_f32(u, zero), vcltq_f32(u, size)),
+                vandq_u32(vcgeq_f32(v, zero), vcltq_f32(v, size)));
+            in = vandq_u32(in, vcleq_f32(gz, max_height));
+            in = vandq_u32(in, vtstq_u32(d, d));
+
+            int32x4_t index = vaddq_s32(vmulq_s32(vcvtq_s32_f32(v), stride), vcvtq_s32_f32(u));
+            vst1q_s32(cells + i, vbslq_s32(in, index, none));
+            vst1q_f32(heights + i, gz);
+        }
+#endif
+        return i;
+    }
+
+    height_map::height_map()
+        : _cell_size(cell_size_default),
+          _cells(cells_default),
+          _occupancy(0),
+          _obstacle_min_height(obstacle_min_height_default),
+          _obstacle_max_height(obstacle_max_height_default),
+          _depth_to_ground({ { 1, 0, 0, 0, 0, -1, 0, 1, 0 }, { 0, 0, 0 } }),
+          _intrinsics(),
+          _rays_valid(false),
+          _processing_threads(processing_threads_default),
+          _executor(processing_threads_default)
+    {
+        _stream_filter.stream = RS2_STREAM_DEPTH;
+        _stream_filter.format = RS2_FORMAT_Z16;
+
+        auto cell_size = std::make_shared<ptr_option<float>>(cell_size_min, cell_size_max, cell_size_step, cell_size_default,
+            &_cell_size, "Edge of the cells of the grid, in meters");
+        register_option(RS2_OPTION_GRID_CELL_SIZE, cell_size);
+
+        auto cells = std::make_shared<ptr_option<int>>(cells_min, cells_max, cells_step, cells_default,
+            &_cells, "Number of cells along each side of the grid");
+        register_option(RS2_OPTION_GRID_CELLS, cells);
+
+        auto occupancy = std::make_shared<ptr_option<uint8_t>>(0, 1, 1, 0,
+            &_occupancy, "Output the occupancy of the cells rather than their heights");
+        register_option(RS2_OPTION_GRID_OCCUPANCY, occupancy);
+
+        auto obstacle_min_height = std::make_shared<ptr_option<float>>(height_min, height_max, height_step, obstacle_min_height_default,
+            &_obstacle_min_height, "Height above the ground from which a point makes its cell occupied, in meters");
+        auto obstacle_max_height = std::make_shared<ptr_option<float>>(height_min, height_max, height_step, obstacle_max_height_default,
+            &_obstacle_max_height, "Height above the ground beyond which the points are left out, in meters");
+        register_option(RS2_OPTION_OBSTACLE_MIN_HEIGHT, obstacle_min_height);
+        register_option(RS2_OPTION_OBSTACLE_MAX_HEIGHT, obstacle_max_height);
+
+        register_processing_threads_option(*this, _processing_threads, _executor, _mutex,
+            "Number of threads used to bin each frame, 0 for all hardware threads", "height map");
+    }
+
+    void height_map::set_ground(const rs2_extrinsics& depth_to_ground)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _depth_to_ground = depth_to_ground;
+        _rays_valid = false;
+    }
+
+    void height_map::update_output_profile(const rs2::frame& f)
+    {
+        if (frame_profile(f) == _source_stream_profile.get())
+            return;
+
+        _source_stream_profile = f.get_profile();
+        _height_stream_profile = _source_stream_profile.clone(_source_stream_profile.stream_type(),
+            _source_stream_profile.stream_index(), RS2_FORMAT_HEIGHT_MAP);
+        _occupancy_stream_profile = _source_stream_profile.clone(_source_stream_profile.stream_type(),
+            _source_stream_profile.stream_index(), RS2_FORMAT_OCCUPANCY_GRID);
+        _intrinsics = _source_stream_profile.as<rs2::video_stream_profile>().get_intrinsics();
+        _rays_valid = false;
+    }
+
+    void height_map::update_rays()
+    {
+        if (_rays_valid)
+            return;
+
+        // The rays of the pointcloud, rotated into the ground frame: a pixel at depth z lands at ray * z + translation
+        std::vector<float> map_x, map_y;
+        compute_ray_map(_intrinsics, map_x, map_y);
+
+        auto&& r = _depth_to_ground.rotation;
+        _rays_x.resize(map_x.size());
+        _rays_y.resize(map_x.size());
+        _rays_z.resize(map_x.size());
+        for (size_t i = 0; i < map_x.size(); ++i)
+        {
+            _rays_x[i] = r[0] * map_x[i] + r[3] * map_y[i] + r[6];
+            _rays_y[i] = r[1] * map_x[i] + r[4] * map_y[i] + r[7];
+            _rays_z[i] = r[2] * map_x[i] + r[5] * map_y[i] + r[8];
+        }
+        _rays_valid = true;
+    }
+
+    void height_map::bin_rows(const uint16_t* depth, size_t stride, float units, int y0, int y1, float* grid, int32_t* cells, float* heights) const
+    {
+        grid_projection p;
+        p.units = units;
+        p.tx = _depth_to_ground.translation[0];
+        p.ty = _depth_to_ground.translation[1];
+        p.tz = _depth_to_ground.translation[2];
+        p.left = -_cells * _cell_size / 2;
+        p.top = _cells * _cell_size / 2;
+        p.inv_cell_size = 1.f / _cell_size;
+        p.max_height = _obstacle_max_height;
+        p.cells = _cells;
+
+        const size_t width = size_t(_intrinsics.width);
+        for (int y = y0; y < y1; ++y)
+        {
+            auto row = depth + y * stride;
+            auto base = y * width;
+            auto rx = _rays_x.data() + base, ry = _rays_y.data() + base, rz = _rays_z.data() + base;
+            size_t i = project_row_simd(row, rx, ry, rz, width, p, cells, heights);
+            for (; i < width; ++i)
+                cells[i] = project_pixel(row[i], rx[i], ry[i], rz[i], p, heights[i]);
+
+            // The scatter stays scalar, the cells of a row are mostly runs of the same cell
+            for (i = 0; i < width; ++i)
+            {
+                auto c = cells[i];
+                if (c >= 0 && heights[i] > grid[c])
+                    grid[c] = heights[i];
+            }
+        }
+    }
+
+    rs2::frame height_map::process_frame(const rs2::frame_source& source, const rs2::frame& f)
+    {
+        update_output_profile(f);
+        update_rays();
+
+        auto src = f.as<rs2::video_frame>();
+        auto units = static_cast<depth_frame*>((frame_interface*)f.get())->get_units();
+        auto depth = static_cast<const uint16_t*>(src.get_data());
+        const size_t stride = src.get_stride_in_bytes() / sizeof(uint16_t);
+        const int width = _intrinsics.width, height = _intrinsics.height;
+
+        // A grid per band of rows, so the bands bin without sharing any cell
+        const size_t cells = size_t(_cells) * _cells;
+        const int bands = std::max(1, std::min(height, int(_executor.size())));
+        _band_grids.resize(bands * cells);
+        _band_cells.resize(size_t(bands) * width);
+        _band_heights.resize(size_t(bands) * width);
+        _executor.for_each(size_t(bands), [&](size_t b)
+        {
+            auto grid = _band_grids.data() + b * cells;
+            std::fill(grid, grid + cells, -std::numeric_limits<float>::infinity());
+            bin_rows(depth, stride, units, int(height * b / bands), int(height * (b + 1) / bands), grid,
+                _band_cells.data() + b * width, _band_heights.data() + b * width);
+        });
+
+        const int bpp = _occupancy ? 1 : sizeof(float);
+        auto tgt = source.allocate_video_frame(_occupancy ? _occupancy_stream_profile : _height_stream_profile, f,
+            bpp, _cells, _cells, _cells * bpp, RS2_EXTENSION_VIDEO_FRAME);
+        if (!tgt)
+            return tgt;
+
+        auto out = const_cast<void*>(tgt.get_data());
+        _executor.for_each_range(cells, 64, [&](size_t begin, size_t end)
+        {
+            for (size_t c = begin; c < end; ++c)
+            {
+                float h = _band_grids[c];
+                for (int b = 1; b < bands; ++b)
+                    h = std::max(h, _band_grids[b * cells + c]);
+
+                const bool seen = h != -std::numeric_limits<float>::infinity();
+                if (_occupancy)
+                    static_cast<uint8_t*>(out)[c] = static_cast<uint8_t>(!seen ? RS2_OCCUPANCY_UNKNOWN
+                        : h >= _obstacle_min_height ? RS2_OCCUPANCY_OCCUPIED : RS2_OCCUPANCY_FREE);
+                else
+                    static_cast<float*>(out)[c] = seen ? h : std::numeric_limits<float>::quiet_NaN();
+            }
+        });
+        return tgt;
+    }
+}
@@ -0,0 +1,58 @@
+// Height map block bins depth frames into a grid on the ground, of the heights or of the occupancy of its cells
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "../include/librealsense2/hpp/rs_frame.hpp"
+#include "../include/librealsense2/hpp/rs_processing.hpp"
+#include "concurrency.h"
+#include "types.h"
+
+#include <vector>
+
+namespace librealsense
+{
+    // Deprojects the pixels of Z16 depth frames into a ground frame, x to the right, y forward and z up, and keeps the
+    // highest point of each cell of a square grid centered on its origin. The grid is output as a video frame, the rows
+    // from the far edge along y, of RS2_FORMAT_HEIGHT_MAP or of RS2_FORMAT_OCCUPANCY_GRID. The rays of the pixels are
+    // rotated into the ground frame once per resolution, so a frame takes a single pass: bands of rows bin into grids
+    // of their own, merged by the maximum. A depth frame passed in a frameset stays in the output frameset
+    class height_map : public stream_filter_processing_block
+    {
+    public:
+        height_map();
+
+        // The pose of the depth sensor on the ground. By default the sensor is at the origin and looks forward, level
+        void set_ground(const rs2_extrinsics& depth_to_ground);
+
+    protected:
+        rs2::frame process_frame(const rs2::frame_source& source, const rs2::frame& f) override;
+
+    private:
+        void    update_output_profile(const rs2::frame& f);
+        void    update_rays();
+        void    bin_rows(const uint16_t* depth, size_t stride, float units, int y0, int y1, float* grid, int32_t* cells, float* heights) const;
+
+        float                   _cell_size;         // In meters
+        int                     _cells;
+        uint8_t                 _occupancy;
+        float                   _obstacle_min_height;   // In meters
+        float                   _obstacle_max_height;
+        rs2_extrinsics          _depth_to_ground;
+        rs2::stream_profile     _source_stream_profile;
+        rs2::stream_profile     _height_stream_profile;
+        rs2::stream_profile     _occupancy_stream_profile;
+
+        // The direction in the ground frame of the ray of every pixel, at a depth of 1. Rebuilt when the resolution or the ground change
+        rs2_intrinsics          _intrinsics;
+        std::vector<float>      _rays_x, _rays_y, _rays_z;
+        bool                    _rays_valid;
+
+        std::vector<float>      _band_grids;        // The highest point in each cell, for every band of rows
+        std::vector<int32_t>    _band_cells;        // The cell of every pixel of a row, -1 when it's left out
+        std::vector<float>      _band_heights;
+        uint8_t                 _processing_threads;
+        parallel_executor       _executor;
+    };
+}
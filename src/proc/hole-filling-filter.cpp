@@ -11,6 +11,14 @@
 #include "proc/synthetic-stream.h"
 #include "proc/hole-filling-filter.h"
 
+#ifdef __SSSE3__
+#include <tmmintrin.h> // For SSSE3 intrinsics
+#endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h> // For NEON intrinsics
+#define RS2_NEON
+#endif
+
 namespace librealsense
 {
     // The holes filling mode
@@ -19,11 +27,216 @@ namespace librealsense
     const uint8_t hole_fill_step = 1;
     const uint8_t hole_fill_def = hf_farest_from_around;
 
+    // Disparity holes are tested on the bit pattern, so that negative zero counts as valid
+    template<typename T>
+    inline bool is_hole(const T* p) { return !*p; }
+    inline bool is_hole(const float* p) { return !*reinterpret_cast<const int*>(p); }
+
+    // Each filled pixel depends on the filled pixel to its left, which makes a row a segmented scan:
+    // a hole combines its candidate with the running value and a valid pixel restarts the run.
+    // The vectorized kernels scan eight lanes in three steps, then merge the run carried in from the previous lanes.
+    // Only the depth kernels are vectorized; disparity rows go through the scalar loops.
+#if defined(__SSSE3__)
+    inline __m128i select_si128(__m128i mask, __m128i a, __m128i b)
+    {
+        return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+    }
+
+    inline __m128i last_lane(__m128i v)
+    {
+        return _mm_shuffle_epi8(v, _mm_set1_epi16(0x0F0E));
+    }
+
+    // On return pass marks the lanes whose run reaches back past lane 0
+    template<class Op>
+    inline __m128i scan_runs(__m128i v, __m128i& pass, __m128i identity, Op op)
+    {
+        const __m128i ones = _mm_cmpeq_epi16(v, v);
+        v = select_si128(pass, op(v, _mm_alignr_epi8(v, identity, 14)), v);
+        pass = _mm_and_si128(pass, _mm_alignr_epi8(pass, ones, 14));
+        v = select_si128(pass, op(v, _mm_alignr_epi8(v, identity, 12)), v);
+        pass = _mm_and_si128(pass, _mm_alignr_epi8(pass, ones, 12));
+        v = select_si128(pass, op(v, _mm_alignr_epi8(v, identity, 8)), v);
+        pass = _mm_and_si128(pass, _mm_alignr_epi8(pass, ones, 8));
+        return v;
+    }
+
+    static size_t holes_fill_left_simd(uint16_t* row, size_t width)
+    {
+        auto take_left = [](__m128i, __m128i left) { return left; };
+        const __m128i zero = _mm_setzero_si128();
+        __m128i carry = _mm_set1_epi16(static_cast<short>(row[0]));
+
+        size_t i = 1;
+        for (; i + 8 <= width; i += 8)
+        {
+            __m128i cur = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i));
+            __m128i pass = _mm_cmpeq_epi16(cur, zero);
+            __m128i v = scan_runs(cur, pass, zero, take_left);
+            v = select_si128(pass, carry, v);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(row + i), v);
+            carry = last_lane(v);
+        }
+        return i;
+    }
+
+    // The farest kernel works on values biased by 0x8000, SSSE3 has only signed 16 bit min/max
+    static size_t holes_fill_farest_simd(uint16_t* out, const uint16_t* up, const uint16_t* cur, const uint16_t* down, size_t width)
+    {
+        auto max = [](__m128i a, __m128i b) { return _mm_max_epi16(a, b); };
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i bias = _mm_set1_epi16(-32768);
+        __m128i carry = _mm_xor_si128(_mm_set1_epi16(static_cast<short>(out[0])), bias);
+
+        size_t i = 1;
+        for (; i + 8 <= width; i += 8)
+        {
+            __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cur + i));
+            __m128i around = _mm_max_epi16(
+                _mm_max_epi16(_mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(up + i)), bias),
+                    _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(up + i - 1)), bias)),
+                _mm_max_epi16(_mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(down + i - 1)), bias),
+                    _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(down + i)), bias)));
+
+            __m128i pass = _mm_cmpeq_epi16(c, zero);
+            __m128i v = scan_runs(select_si128(pass, around, _mm_xor_si128(c, bias)), pass, bias, max);
+            v = select_si128(pass, _mm_max_epi16(v, carry), v);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_xor_si128(v, bias));
+            carry = last_lane(v);
+        }
+        return i;
+    }
+
+    // The nearest kernel works on values minus one, so that holes wrap around to the largest value and drop out of the minimum
+    static size_t holes_fill_nearest_simd(uint16_t* out, const uint16_t* up, const uint16_t* cur, const uint16_t* down, size_t width)
+    {
+        auto min = [](__m128i a, __m128i b) { return _mm_min_epi16(a, b); };
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i one = _mm_set1_epi16(1);
+        const __m128i bias = _mm_set1_epi16(-32768);
+        const __m128i none = _mm_set1_epi16(0x7FFF);
+        auto key = [&](__m128i v) { return _mm_xor_si128(_mm_sub_epi16(v, one), bias); };
+        __m128i carry = key(_mm_set1_epi16(static_cast<short>(out[0])));
+
+        size_t i = 1;
+        for (; i + 8 <= width; i += 8)
+        {
+            __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cur + i));
+            __m128i u = _mm_loadu_si128(reinterpret_cast<const __m128i*>(up + i));
+            __m128i around = _mm_min_epi16(
+                _mm_min_epi16(key(u), key(_mm_loadu_si128(reinterpret_cast<const __m128i*>(up + i - 1)))),
+                _mm_min_epi16(key(_mm_loadu_si128(reinterpret_cast<const __m128i*>(down + i - 1))),
+                    key(_mm_loadu_si128(reinterpret_cast<const __m128i*>(down + i)))));
+
+            // A hole below an empty pixel stays empty
+            __m128i hole = _mm_cmpeq_epi16(c, zero);
+            __m128i up_empty = _mm_cmpeq_epi16(u, zero);
+            __m128i pass = _mm_andnot_si128(up_empty, hole);
+            __m128i v = scan_runs(select_si128(hole, select_si128(up_empty, none, around), key(c)), pass, none, min);
+            v = select_si128(pass, _mm_min_epi16(v, carry), v);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_add_epi16(_mm_xor_si128(v, bias), one));
+            carry = last_lane(v);
+        }
+        return i;
+    }
+#elif defined(RS2_NEON)
+    template<class Op>
+    inline uint16x8_t scan_runs(uint16x8_t v, uint16x8_t& pass, uint16x8_t identity, Op op)
+    {
+        const uint16x8_t ones = vdupq_n_u16(0xFFFF);
+        v = vbslq_u16(pass, op(v, vextq_u16(identity, v, 7)), v);
+        pass = vandq_u16(pass, vextq_u16(ones, pass, 7));
+        v = vbslq_u16(pass, op(v, vextq_u16(identity, v, 6)), v);
+        pass = vandq_u16(pass, vextq_u16(ones, pass, 6));
+        v = vbslq_u16(pass, op(v, vextq_u16(identity, v, 4)), v);
+        pass = vandq_u16(pass, vextq_u16(ones, pass, 4));
+        return v;
+    }
+
+    static size_t holes_fill_left_simd(uint16_t* row, size_t width)
+    {
+        auto take_left = [](uint16x8_t, uint16x8_t left) { return left; };
+        const uint16x8_t zero = vdupq_n_u16(0);
+        uint16x8_t carry = vdupq_n_u16(row[0]);
+
+        size_t i = 1;
+        for (; i + 8 <= width; i += 8)
+        {
+            uint16x8_t cur = vld1q_u16(row + i);
+            uint16x8_t pass = vceqq_u16(cur, zero);
+            uint16x8_t v = scan_runs(cur, pass, zero, take_left);
+            v = vbslq_u16(pass, carry, v);
+            vst1q_u16(row + i, v);
+            carry = vdupq_n_u16(vgetq_lane_u16(v, 7));
+        }
+        return i;
+    }
+
+    static size_t holes_fill_farest_simd(uint16_t* out, const uint16_t* up, const uint16_t* cur, const uint16_t* down, size_t width)
+    {
+        auto max = [](uint16x8_t a, uint16x8_t b) { return vmaxq_u16(a, b); };
+        const uint16x8_t zero = vdupq_n_u16(0);
+        uint16x8_t carry = vdupq_n_u16(out[0]);
+
+        size_t i = 1;
+        for (; i + 8 <= width; i += 8)
+        {
+            uint16x8_t c = vld1q_u16(cur + i);
+            uint16x8_t around = vmaxq_u16(vmaxq_u16(vld1q_u16(up + i), vld1q_u16(up + i - 1)),
+                vmaxq_u16(vld1q_u16(down + i - 1), vld1q_u16(down + i)));
+
+            uint16x8_t pass = vceqq_u16(c, zero);
+            uint16x8_t v = scan_runs(vbslq_u16(pass, around, c), pass, zero, max);
+            v = vbslq_u16(pass, vmaxq_u16(v, carry), v);
+            vst1q_u16(out + i, v);
+            carry = vdupq_n_u16(vgetq_lane_u16(v, 7));
+        }
+        return i;
+    }
+
+    static size_t holes_fill_nearest_simd(uint16_t* out, const uint16_t* up, const uint16_t* cur, const uint16_t* down, size_t width)
+    {
+        auto min = [](uint16x8_t a, uint16x8_t b) { return vminq_u16(a, b); };
+        const uint16x8_t zero = vdupq_n_u16(0);
+        const uint16x8_t one = vdupq_n_u16(1);
+        const uint16x8_t none = vdupq_n_u16(0xFFFF);
+        auto key = [&](uint16x8_t v) { return vsubq_u16(v, one); };
+        uint16x8_t carry = key(vdupq_n_u16(out[0]));
+
+        size_t i = 1;
+        for (; i + 8 <= width; i += 8)
+        {
+            uint16x8_t c = vld1q_u16(cur + i);
+            uint16x8_t u = vld1q_u16(up + i);
+            uint16x8_t around = vminq_u16(vminq_u16(key(u), key(vld1q_u16(up + i - 1))),
+                vminq_u16(key(vld1q_u16(down + i - 1)), key(vld1q_u16(down + i))));
+
+            uint16x8_t hole = vceqq_u16(c, zero);
+            uint16x8_t up_empty = vceqq_u16(u, zero);
+            uint16x8_t pass = vbicq_u16(hole, up_empty);
+            uint16x8_t v = scan_runs(vbslq_u16(hole, vbslq_u16(up_empty, none, around), key(c)), pass, none, min);
+            v = vbslq_u16(pass, vminq_u16(v, carry), v);
+            vst1q_u16(out + i, vaddq_u16(v, one));
+            carry = vdupq_n_u16(vgetq_lane_u16(v, 7));
+        }
+        return i;
+    }
+#else
+    static size_t holes_fill_left_simd(uint16_t*, size_t) { return 1; }
+    static size_t holes_fill_farest_simd(uint16_t*, const uint16_t*, const uint16_t*, const uint16_t*, size_t) { return 1; }
+    static size_t holes_fill_nearest_simd(uint16_t*, const uint16_t*, const uint16_t*, const uint16_t*, size_t) { return 1; }
+#endif
+    static size_t holes_fill_left_simd(float*, size_t) { return 1; }
+    static size_t holes_fill_farest_simd(float*, const float*, const float*, const float*, size_t) { return 1; }
+    static size_t holes_fill_nearest_simd(float*, const float*, const float*, const float*, size_t) { return 1; }
+
     hole_filling_filter::hole_filling_filter() :
         _width(0), _height(0), _stride(0), _bpp(0),
         _extension_type(RS2_EXTENSION_DEPTH_FRAME),
         _current_frm_size_pixels(0),
-        _hole_filling_mode(hole_fill_def)
+        _hole_filling_mode(hole_fill_def),
+        _processing_threads(processing_threads_default),
+        _executor(processing_threads_default)
     {
         _stream_filter.stream = RS2_STREAM_DEPTH;
         _stream_filter.format = RS2_FORMAT_Z16;
@@ -52,25 +265,157 @@ namespace librealsense
 
         register_option(RS2_OPTION_HOLES_FILL, hole_filling_mode);
 
+        register_processing_threads_option(*this, _processing_threads, _executor, _mutex,
+            "Number of threads used to fill each frame, 0 for all hardware threads", "hole filling");
+
     }
 
     rs2::frame hole_filling_filter::process_frame(const rs2::frame_source& source, const rs2::frame& f)
     {
         update_configuration(f);
-        auto tgt = prepare_target_frame(f, source);
 
         // Hole filling pass
-        if (_extension_type == RS2_EXTENSION_DISPARITY_FRAME)
-            apply_hole_filling<float>(const_cast<void*>(tgt.get_data()));
-        else
-            apply_hole_filling<uint16_t>(const_cast<void*>(tgt.get_data()));
+        if (_extension_type != RS2_EXTENSION_DISPARITY_FRAME)
+            return fill_depth_frame(f, source);
 
+        auto tgt = prepare_target_frame(f, source);
+        apply_hole_filling<float>(f.get_data(), const_cast<void*>(tgt.get_data()));
         return tgt;
     }
 
+    rs2::frame hole_filling_filter::fill_depth_frame(const rs2::frame& f, const rs2::frame_source& source)
+    {
+        auto tgt = prepare_target_frame(f, source);
+        apply_hole_filling<uint16_t>(f.get_data(), const_cast<void*>(tgt.get_data()));
+        return tgt;
+    }
+
+    template<typename T>
+    void hole_filling_filter::apply_hole_filling(const void * source_data, void * image_data)
+    {
+        const T* src = reinterpret_cast<const T*>(source_data);
+        T* data = reinterpret_cast<T*>(image_data);
+        const size_t width = _width;
+
+        if (_hole_filling_mode >= hf_max_value)
+            throw invalid_value_exception(to_string()
+                << "Unsupported hole filling mode: " << _hole_filling_mode << " is out of range.");
+
+        // Fill from left only looks along the row, every row is independent
+        if (_hole_filling_mode == hf_fill_from_left)
+        {
+            size_t bands = std::max<size_t>(1, std::min<size_t>(_executor.size() > 1 ? _executor.size() * 4 : 1, _height));
+            _executor.for_each(bands, [&](size_t b)
+            {
+                for (size_t j = _height * b / bands; j < _height * (b + 1) / bands; ++j)
+                    holes_fill_left(data + j * width, width);
+            });
+            return;
+        }
+
+        // The around methods skip the first and last rows
+        if (_height < 3)
+            return;
+
+        // Each row reads the filled row above it. Bands after the first start from the unfilled source row instead,
+        // then are reconciled in order: the leading rows of a band are refilled until one comes out unchanged,
+        // after which the rest of the band already matches a top to bottom pass
+        const size_t rows = _height - 2;
+        size_t bands = std::max<size_t>(1, std::min<size_t>(_executor.size() > 1 ? _executor.size() * 4 : 1, rows));
+        auto band_begin = [&](size_t b) { return 1 + rows * b / bands; };
+
+        _executor.for_each(bands, [&](size_t b)
+        {
+            for (size_t j = band_begin(b); j < band_begin(b + 1); ++j)
+            {
+                const T* up = (j == band_begin(b) ? src : data) + (j - 1) * width;
+                holes_fill_around(data + j * width, up, src + j * width, src + (j + 1) * width, width);
+            }
+        });
+
+        std::vector<T> row(width);
+        for (size_t b = 1; b < bands; ++b)
+        {
+            for (size_t j = band_begin(b); j < band_begin(b + 1); ++j)
+            {
+                row[0] = src[j * width];
+                holes_fill_around(row.data(), data + (j - 1) * width, src + j * width, src + (j + 1) * width, width);
+                if (std::equal(row.begin(), row.end(), data + j * width, [](const T& a, const T& b) { return !memcmp(&a, &b, sizeof(T)); }))
+                    break;
+                std::copy(row.begin(), row.end(), data + j * width);
+            }
+        }
+    }
+
+    template<typename T>
+    void hole_filling_filter::holes_fill_left(T* row, size_t width)
+    {
+        for (size_t i = holes_fill_left_simd(row, width); i < width; ++i)
+        {
+            if (is_hole(row + i))
+                row[i] = row[i - 1];
+        }
+    }
+
+    template<typename T>
+    void hole_filling_filter::holes_fill_farest(T* out, const T* up, const T* cur, const T* down, size_t width)
+    {
+        for (size_t i = holes_fill_farest_simd(out, up, cur, down, width); i < width; ++i)
+        {
+            if (is_hole(cur + i))
+            {
+                T tmp = up[i];
+
+                if (up[i - 1] > tmp)
+                    tmp = up[i - 1];
+
+                if (out[i - 1] > tmp)
+                    tmp = out[i - 1];
+
+                if (down[i - 1] > tmp)
+                    tmp = down[i - 1];
+
+                if (down[i] > tmp)
+                    tmp = down[i];
+
+                out[i] = tmp;
+            }
+            else
+                out[i] = cur[i];
+        }
+    }
+
+    template<typename T>
+    void hole_filling_filter::holes_fill_nearest(T* out, const T* up, const T* cur, const T* down, size_t width)
+    {
+        for (size_t i = holes_fill_nearest_simd(out, up, cur, down, width); i < width; ++i)
+        {
+            if (is_hole(cur + i))
+            {
+                T tmp = up[i];
+
+                if (!is_hole(up + i - 1) && (up[i - 1] < tmp))
+                    tmp = up[i - 1];
+
+                if (!is_hole(out + i - 1) && (out[i - 1] < tmp))
+                    tmp = out[i - 1];
+
+                if (!is_hole(down + i - 1) && (down[i - 1] < tmp))
+                    tmp = down[i - 1];
+
+                if (!is_hole(down + i) && (down[i] < tmp))
+                    tmp = down[i];
+
+                out[i] = tmp;
+            }
+            else
+                out[i] = cur[i];
+        }
+    }
+
     void  hole_filling_filter::update_configuration(const rs2::frame& f)
     {
-        if (f.get_profile().get() != _source_stream_profile.get())
+        if (frame_profile(f) != _source_stream_profile.get())
         {
             _source_stream_profile = f.get_profile();
             _target_stream_profile = _source_stream_profile.clone(RS2_STREAM_DEPTH, 0, _source_stream_profile.format());
@@ -88,6 +433,12 @@ namespace librealsense
 
     rs2::frame hole_filling_filter::prepare_target_frame(const rs2::frame& f, const rs2::frame_source& source)
     {
+        // Filling from the left runs in place, on the input itself when nothing else references it.
+        // The other modes read the unfilled rows around each row and always fill a copy
+        if (_hole_filling_mode == hf_fill_from_left && f.as<rs2::video_frame>().get_stride_in_bytes() == int(_stride))
+            if (auto tgt = reuse_frame(f, _target_stream_profile))
+                return tgt;
+
         // Allocate and copy the content of the input data to the target
         rs2::frame tgt = source.allocate_video_frame(_target_stream_profile, f, int(_bpp), int(_width), int(_height), int(_stride), _extension_type);
 
@@ -2,6 +2,7 @@
 // Copyright(c) 2018 Intel Corporation. All Rights Reserved
 // Enhancing the input video frame by filling missing data.
 #pragma once
+#include "concurrency.h"
 
 namespace librealsense
 {
@@ -24,140 +25,32 @@ namespace librealsense
 
         rs2::frame prepare_target_frame(const rs2::frame& f, const rs2::frame_source& source);
 
-        template<typename T>
-        void apply_hole_filling(void * image_data)
-        {
-            bool fp = (std::is_floating_point<T>::value);
-            T* data = reinterpret_cast<T*>(image_data);
-
-            // Select and apply the appropriate hole filling method
-            switch (_hole_filling_mode)
-            {
-            case hf_fill_from_left:
-                holes_fill_left(data, _width, _height, _stride);
-                break;
-            case hf_farest_from_around:
-                holes_fill_farest(data, _width, _height, _stride);
-                break;
-            case hf_nearest_from_around:
-                holes_fill_nearest(data, _width, _height, _stride);
-                break;
-            default:
-                throw invalid_value_exception(to_string()
-                    << "Unsupported hole filling mode: " << _hole_filling_mode << " is out of range.");
-            }
-        }
+        // Fills the holes of a depth frame into a new target, overridden by the accelerated implementations
+        virtual rs2::frame fill_depth_frame(const rs2::frame& f, const rs2::frame_source& source);
 
-        // Implementations of the hole-filling methods
         template<typename T>
-        inline void holes_fill_left(T* image_data, size_t width, size_t height, size_t stride)
-        {
-            std::function<bool(T*)> fp_oper = [](T* ptr) { return !*((int *)ptr); };
-            std::function<bool(T*)> uint_oper = [](T* ptr) { return !(*ptr); };
-            auto empty = (std::is_floating_point<T>::value) ? fp_oper : uint_oper;
-
-            T* p = image_data;
-
-            for (int j = 0; j < height; ++j)
-            {
-                ++p;
-                for (int i = 1; i < width; ++i)
-                {
-                    if (empty(p))
-                        *p = *(p - 1);
-                    ++p;
-                }
-            }
-        }
+        void apply_hole_filling(const void * source_data, void * image_data);
 
+        // Implementations of the hole-filling methods, one row at a time.
+        // The around methods read the filled row above and the source rows at and below the target
         template<typename T>
-        inline void holes_fill_farest(T* image_data, size_t width, size_t height, size_t stride)
-        {
-            std::function<bool(T*)> fp_oper = [](T* ptr) { return !*((int *)ptr); };
-            std::function<bool(T*)> uint_oper = [](T* ptr) { return !(*ptr); };
-            auto empty = (std::is_floating_point<T>::value) ? fp_oper : uint_oper;
-
-            T tmp = 0;
-            T * p = image_data + width;
-            T * q = nullptr;
-            for (int j = 1; j < height - 1; ++j)
-            {
-                ++p;
-                for (int i = 1; i < width; ++i)
-                {
-                    if (empty(p))
-                    {
-                        tmp = *(p - width);
-
-                        q = p - width - 1;
-                        if (*q > tmp)
-                            tmp = *q;
-
-                        q = p - 1;
-                        if (*q > tmp)
-                            tmp = *q;
-
-                        q = p + width - 1;
-                        if (*q > tmp)
-                            tmp = *q;
+        void holes_fill_left(T* row, size_t width);
 
-                        q = p + width;
-                        if (*q > tmp)
-                            tmp = *q;
-
-                        *p = tmp;
-                    }
+        template<typename T>
+        void holes_fill_farest(T* out, const T* up, const T* cur, const T* down, size_t width);
 
-                    p++;
-                }
-            }
-        }
+        template<typename T>
+        void holes_fill_nearest(T* out, const T* up, const T* cur, const T* down, size_t width);
 
         template<typename T>
-        inline void holes_fill_nearest(T* image_data, size_t width, size_t height, size_t stride)
+        void holes_fill_around(T* out, const T* up, const T* cur, const T* down, size_t width)
         {
-            std::function<bool(T*)> fp_oper = [](T* ptr) { return !*((int *)ptr); };
-            std::function<bool(T*)> uint_oper = [](T* ptr) { return !(*ptr); };
-            auto empty = (std::is_floating_point<T>::value) ? fp_oper : uint_oper;
-
-            T tmp = 0;
-            T * p = image_data + width;
-            T * q = nullptr;
-            for (int j = 1; j < height - 1; ++j)
-            {
-                ++p;
-                for (int i = 1; i < width; ++i)
-                {
-                    if (empty(p))
-                    {
-                        tmp = *(p - width);
-
-                        q = p - width - 1;
-                        if (!empty(q) && (*q < tmp))
-                            tmp = *q;
-
-                        q = p - 1;
-                        if (!empty(q) && (*q < tmp))
-                            tmp = *q;
-
-                        q = p + width - 1;
-                        if (!empty(q) && (*q < tmp))
-                            tmp = *q;
-
-                        q = p + width;
-                        if (!empty(q) && (*q < tmp))
-                            tmp = *q;
-
-                        *p = tmp;
-                    }
-
-                    p++;
-                }
-            }
+            if (_hole_filling_mode == hf_farest_from_around)
+                holes_fill_farest(out, up, cur, down, width);
+            else
+                holes_fill_nearest(out, up, cur, down, width);
         }
 
-    private:
-
         size_t                  _width, _height, _stride;
         size_t                  _bpp;
         rs2_extension           _extension_type;            // Strictly Depth/Disparity
@@ -165,5 +58,7 @@ namespace librealsense
         rs2::stream_profile     _source_stream_profile;
         rs2::stream_profile     _target_stream_profile;
         uint8_t                 _hole_filling_mode;
+        uint8_t                 _processing_threads;
+        parallel_executor       _executor;
     };
 }
@@ -0,0 +1,228 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#include "proc/imu-fusion.h"
+#include "stream.h"
+#include "environment.h"
+
+#include <cmath>
+
+namespace librealsense
+{
+    void imu_fusion::sample_ring::push_back(const sample& s)
+    {
+        if (count == capacity)
+        {
+            first = (first + 1) % capacity;
+            --count;
+        }
+        samples[(first + count) % capacity] = s;
+        ++count;
+    }
+
+    void imu_fusion::sample_ring::drop_before(double time)
+    {
+        while (count > 1 && (*this)[1].timestamp <= time)
+        {
+            first = (first + 1) % capacity;
+            --count;
+        }
+    }
+
+    imu_fusion::imu_fusion(float rate)
+        : _rate(rate)
+    {
+        if (!(rate >= 0.f))
+            throw invalid_value_exception(to_string() << "IMU fusion: invalid output rate " << rate);
+
+        auto f = [this](frame_holder frame, synthetic_source_interface* source)
+        {
+            std::array<double, max_batch> times;
+            float accel[max_batch][3], gyro[max_batch][3];
+
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (auto composite = frame_cast<composite_frame>(frame.frame))
+            {
+                for (size_t i = 0; i < composite->get_embedded_frames_count(); i++)
+                {
+                    auto embedded = composite->get_frame(int(i));
+                    embedded->acquire();
+                    add_sample(frame_holder(embedded));
+                }
+            }
+            else
+                add_sample(std::move(frame));
+
+            // Samples that arrive in a burst make several outputs ready at once, they are interpolated together
+            while (auto n = next_times(times))
+            {
+                interpolate(_accel, times.data(), n, accel);
+                interpolate(_gyro, times.data(), n, gyro);
+
+                for (size_t i = 0; i < n; ++i)
+                {
+                    ++_frame_number;
+                    auto accel_frame = allocate_sample(_accel, _last_accel.frame, times[i], accel[i]);
+                    auto gyro_frame = allocate_sample(_gyro, _last_gyro.frame, times[i], gyro[i]);
+                    if (!accel_frame || !gyro_frame)
+                    {
+                        LOG_ERROR("IMU fusion: failed to allocate motion frame");
+                        continue;
+                    }
+
+                    composite_frame_builder set;
+                    set.push_back(std::move(accel_frame));
+                    set.push_back(std::move(gyro_frame));
+                    frame_holder composite = source->allocate_composite_frame(set);
+                    if (!composite)
+                    {
+                        LOG_ERROR("Failed to allocate composite frame");
+                        continue;
+                    }
+                    source->frame_ready(std::move(composite));
+                }
+
+                _last = times[n - 1];
+                _started = true;
+                _accel.drop_before(_last);
+                _gyro.drop_before(_last);
+            }
+        };
+        set_processing_callback(std::shared_ptr<rs2_frame_processor_callback>(
+            new internal_frame_processor_callback<decltype(f)>(f)));
+    }
+
+    void imu_fusion::add_sample(frame_holder f)
+    {
+        if (!f || !f->is_extendable_to(RS2_EXTENSION_MOTION_FRAME))
+            return;
+
+        auto stream = f->get_stream();
+        if (stream->get_format() != RS2_FORMAT_MOTION_XYZ32F)
+            return;
+
+        auto type = stream->get_stream_type();
+        if (type != RS2_STREAM_ACCEL && type != RS2_STREAM_GYRO)
+            return;
+
+        auto& ring = type == RS2_STREAM_ACCEL ? _accel : _gyro;
+        auto timestamp = f->get_frame_timestamp();
+        if (ring.count && timestamp <= ring.back().timestamp)
+        {
+            if (timestamp == ring.back().timestamp)
+                return;
+
+            // The streams were restarted or seeked, the output starts over from the new samples
+            _accel.clear();
+            _gyro.clear();
+            _started = false;
+        }
+
+        sample s;
+        s.timestamp = timestamp;
+        std::memcpy(s.xyz, f->get_frame_data(), sizeof(s.xyz));
+        ring.push_back(s);
+
+        if (stream != ring.input_profile)
+        {
+            ring.input_profile = stream;
+            update_output_profiles();
+        }
+        (type == RS2_STREAM_ACCEL ? _last_accel : _last_gyro) = std::move(f);
+    }
+
+    size_t imu_fusion::next_times(std::array<double, max_batch>& times) const
+    {
+        if (!_accel.count || !_gyro.count)
+            return 0;
+
+        // Both streams are interpolated, never extrapolated
+        auto lower = std::max(_accel[0].timestamp, _gyro[0].timestamp);
+        auto upper = std::min(_accel.back().timestamp, _gyro.back().timestamp);
+
+        size_t n = 0;
+        if (_rate > 0.f)
+        {
+            // The output times are multiples of the period, on the clock of the samples
+            auto period = 1000. / _rate;
+            auto t = _started ? _last + period : lower;
+            if (!_started || t < lower)
+                t = std::ceil(lower / period) * period;
+            for (; n < max_batch && t <= upper; t += period)
+                times[n++] = t;
+        }
+        else
+        {
+            for (size_t i = 0; i < _gyro.count && n < max_batch; ++i)
+            {
+                auto t = _gyro[i].timestamp;
+                if ((!_started || t > _last) && t >= lower && t <= upper)
+                    times[n++] = t;
+            }
+        }
+        return n;
+    }
+
+    void imu_fusion::interpolate(const sample_ring& ring, const double* times, size_t count, float(*xyz)[3])
+    {
+        size_t j = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            auto t = times[i];
+            while (j + 2 < ring.count && ring[j + 1].timestamp < t)
+                ++j;
+
+            auto& a = ring[j];
+            auto& b = ring[std::min(j + 1, ring.count - 1)];
+            auto w = b.timestamp > a.timestamp ? static_cast<float>((t - a.timestamp) / (b.timestamp - a.timestamp)) : 0.f;
+            w = std::min(std::max(w, 0.f), 1.f);
+            for (int c = 0; c < 3; ++c)
+                xyz[i][c] = a.xyz[c] + w * (b.xyz[c] - a.xyz[c]);
+        }
+    }
+
+    frame_holder imu_fusion::allocate_sample(sample_ring& ring, frame_interface* original, double timestamp, const float* xyz)
+    {
+        auto of = dynamic_cast<frame*>(original);
+        frame_additional_data data = of->additional_data;
+        data.timestamp = timestamp;
+        data.frame_number = _frame_number;
+        data.metadata_size = 0;
+        // Only the frames of the sensors are traced
+        data.traced = false;
+
+        auto res = _source.alloc_frame(RS2_EXTENSION_MOTION_FRAME, sizeof(float) * 3, data, true);
+        if (!res)
+            return frame_holder();
+
+        std::memcpy(static_cast<frame*>(res)->data.data(), xyz, sizeof(float) * 3);
+        res->set_sensor(original->get_sensor());
+        res->set_stream(ring.output_profile);
+        return frame_holder(res);
+    }
+
+    void imu_fusion::update_output_profiles()
+    {
+        // Without a rate of its own, the output follows the gyro
+        uint32_t fps = _rate > 0.f ? static_cast<uint32_t>(std::round(_rate))
+            : _gyro.input_profile ? _gyro.input_profile->get_framerate() : 0;
+
+        for (auto ring : { &_accel, &_gyro })
+        {
+            auto input = ring->input_profile;
+            if (!input)
+                continue;
+
+            auto profile = std::make_shared<motion_stream_profile>(platform::stream_profile{ 0, 0, fps, 0 });
+            profile->set_format(input->get_format());
+            profile->set_framerate(fps);
+            profile->set_stream_index(input->get_stream_index());
+            profile->set_stream_type(input->get_stream_type());
+            profile->set_unique_id(environment::get_instance().generate_stream_id());
+            if (auto motion = std::dynamic_pointer_cast<motion_stream_profile_interface>(input))
+                profile->set_intrinsics([motion]() { return motion->get_intrinsics(); });
+            environment::get_instance().get_extrinsics_graph().register_same_extrinsics(*profile, *input);
+            ring->output_profile = profile;
+        }
+    }
+}
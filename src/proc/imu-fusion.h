@@ -0,0 +1,67 @@
+// IMU fusion block pairs the accel and gyro samples of a motion sensor on a common clock
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "synthetic-stream.h"
+
+#include <array>
+
+namespace librealsense
+{
+    // Accel and gyro samples arrive as separate frames, at different rates. The block interpolates both streams linearly
+    // at the timestamps of the chosen rate, or at the gyro timestamps, and publishes one frameset of an accel and a gyro
+    // frame per timestamp. The samples are kept in fixed rings and the frames come from the pool of the block
+    class imu_fusion : public processing_block
+    {
+    public:
+        // Rate of the output in Hz, 0 follows the gyro samples
+        explicit imu_fusion(float rate);
+
+    private:
+        struct sample
+        {
+            double timestamp;
+            float xyz[3];
+        };
+
+        // The last samples of a stream, oldest first
+        struct sample_ring
+        {
+            static const size_t capacity = 64;
+
+            std::array<sample, capacity> samples;
+            size_t first = 0;
+            size_t count = 0;
+            std::shared_ptr<stream_profile_interface> input_profile;
+            std::shared_ptr<stream_profile_interface> output_profile;
+
+            const sample& operator[](size_t i) const { return samples[(first + i) % capacity]; }
+            const sample& back() const { return (*this)[count - 1]; }
+            void push_back(const sample& s);
+            // Drops the samples older than the last one at or before the time, it's still needed to interpolate at the time
+            void drop_before(double time);
+            void clear() { first = count = 0; }
+        };
+
+        // Timestamps at which the output can be interpolated, at most one batch at a time
+        static const size_t max_batch = 32;
+
+        void add_sample(frame_holder f);
+        size_t next_times(std::array<double, max_batch>& times) const;
+        // Interpolates the stream at every time of the batch, the times are in increasing order
+        static void interpolate(const sample_ring& ring, const double* times, size_t count, float (*xyz)[3]);
+        frame_holder allocate_sample(sample_ring& ring, frame_interface* original, double timestamp, const float* xyz);
+        void update_output_profiles();
+
+        float _rate;
+        sample_ring _accel;
+        sample_ring _gyro;
+        double _last = 0;           // Time of the last output
+        bool _started = false;      // The output starts once both streams have samples
+        unsigned long long _frame_number = 0;
+        frame_holder _last_accel;
+        frame_holder _last_gyro;
+    };
+}
@@ -0,0 +1,125 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#include "proc/jpeg-codec.h"
+#include "types.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <csetjmp>
+#include <memory>
+#include <jpeglib.h>
+
+namespace librealsense
+{
+    namespace
+    {
+        struct jpeg_error_handler
+        {
+            jpeg_error_mgr  mgr;
+            jmp_buf         jump;
+        };
+
+        // libjpeg terminates the process on errors unless the handler does not return
+        void on_jpeg_error(j_common_ptr info)
+        {
+            longjmp(reinterpret_cast<jpeg_error_handler*>(info->err)->jump, 1);
+        }
+
+        // Corrupted frames are reported by the callers, warnings are not printed
+        void on_jpeg_message(j_common_ptr)
+        {
+        }
+
+        J_COLOR_SPACE color_space(int components)
+        {
+            return components == 1 ? JCS_GRAYSCALE : JCS_RGB;
+        }
+    }
+
+    void jpeg_encode(const uint8_t* in, int width, int height, int components, int quality, std::vector<uint8_t>& out)
+    {
+        // The output buffer lives on the heap, automatic variables that change between setjmp and longjmp are indeterminate
+        struct destination
+        {
+            unsigned char* buffer = nullptr;
+            unsigned long size = 0;
+        };
+        std::unique_ptr<destination> dest(new destination());
+
+        jpeg_compress_struct info;
+        jpeg_error_handler error;
+        info.err = jpeg_std_error(&error.mgr);
+        error.mgr.error_exit = on_jpeg_error;
+        error.mgr.output_message = on_jpeg_message;
+        if (setjmp(error.jump))
+        {
+            jpeg_destroy_compress(&info);
+            free(dest->buffer);
+            throw invalid_value_exception(to_string() << "Failed to encode a " << width << "x" << height << " JPEG image");
+        }
+
+        jpeg_create_compress(&info);
+        jpeg_mem_dest(&info, &dest->buffer, &dest->size);
+        info.image_width = width;
+        info.image_height = height;
+        info.input_components = components;
+        info.in_color_space = color_space(components);
+        jpeg_set_defaults(&info);
+        jpeg_set_quality(&info, quality, TRUE);
+        jpeg_start_compress(&info, TRUE);
+
+        auto stride = width * components;
+        while (info.next_scanline < info.image_height)
+        {
+            JSAMPROW row = const_cast<uint8_t*>(in) + info.next_scanline * stride;
+            jpeg_write_scanlines(&info, &row, 1);
+        }
+        jpeg_finish_compress(&info);
+        jpeg_destroy_compress(&info);
+
+        out.assign(dest->buffer, dest->buffer + dest->size);
+        free(dest->buffer);
+    }
+
+    bool jpeg_decode(const uint8_t* in, size_t size, uint8_t* out, int width, int height, int components)
+    {
+        jpeg_decompress_struct info;
+        jpeg_error_handler error;
+        info.err = jpeg_std_error(&error.mgr);
+        error.mgr.error_exit = on_jpeg_error;
+        error.mgr.output_message = on_jpeg_message;
+        if (setjmp(error.jump))
+        {
+            jpeg_destroy_decompress(&info);
+            return false;
+        }
+
+        jpeg_create_decompress(&info);
+        jpeg_mem_src(&info, const_cast<uint8_t*>(in), static_cast<unsigned long>(size));
+        if (jpeg_read_header(&info, TRUE) != JPEG_HEADER_OK)
+        {
+            jpeg_destroy_decompress(&info);
+            return false;
+        }
+
+        info.out_color_space = color_space(components);
+        jpeg_start_decompress(&info);
+        if (info.output_width != static_cast<JDIMENSION>(width) || info.output_height != static_cast<JDIMENSION>(height) ||
+            info.output_components != components)
+        {
+            jpeg_destroy_decompress(&info);
+            return false;
+        }
+
+        auto stride = width * components;
+        while (info.output_scanline < info.output_height)
+        {
+            JSAMPROW row = out + info.output_scanline * stride;
+            jpeg_read_scanlines(&info, &row, 1);
+        }
+        jpeg_finish_decompress(&info);
+        jpeg_destroy_decompress(&info);
+        return true;
+    }
+}
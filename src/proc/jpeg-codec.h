@@ -0,0 +1,20 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+namespace librealsense
+{
+    // Baseline JPEG coding of 8-bit grayscale (1 component) and RGB (3 components) images with libjpeg,
+    // or libjpeg-turbo built with its libjpeg interface. Only built with BUILD_WITH_LIBJPEG
+
+    // Replaces the content of out with the image coded at the given quality, 1 to 100
+    void jpeg_encode(const uint8_t* in, int width, int height, int components, int quality, std::vector<uint8_t>& out);
+
+    // Decodes the image into out, false if the input is corrupted or does not match the size and components
+    bool jpeg_decode(const uint8_t* in, size_t size, uint8_t* out, int width, int height, int components);
+}
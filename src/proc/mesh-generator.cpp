@@ -0,0 +1,137 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#include "../include/librealsense2/hpp/rs_sensor.hpp"
+#include "../include/librealsense2/hpp/rs_processing.hpp"
+
+#include <cmath>
+#include <cstring>
+#include "option.h"
+#include "context.h"
+#include "core/video.h"
+#include "proc/synthetic-stream.h"
+#include "proc/mesh-generator.h"
+
+namespace librealsense
+{
+    const float depth_step_min = 0.f;
+    const float depth_step_max = 1.f;
+    const float depth_step_step = 0.001f;
+    const float depth_step_default = 0.05f;
+
+    void generate_faces(const float3* vertices, int width, int height, const int* pixel2vertex, float max_step,
+        parallel_executor& executor, std::vector<std::vector<uint32_t>>& bands)
+    {
+        const int rows = std::max(height - 1, 0);
+        bands.resize(std::max<size_t>(1, std::min<size_t>(executor.size() > 1 ? executor.size() * 4 : 1, size_t(rows))));
+        const size_t count = bands.size();
+
+        // Rows only read the vertices, each band appends to its own faces
+        executor.for_each(count, [&](size_t band)
+        {
+            auto& out = bands[band];
+            out.clear();
+            for (int y = int(rows * band / count); y < int(rows * (band + 1) / count); ++y)
+            {
+                for (int x = 0; x < width - 1; ++x)
+                {
+                    int a = y * width + x, b = a + 1, c = a + width, d = c + 1;
+                    if (pixel2vertex)
+                    {
+                        a = pixel2vertex[a]; b = pixel2vertex[b]; c = pixel2vertex[c]; d = pixel2vertex[d];
+                        if (a < 0 || b < 0 || c < 0 || d < 0)
+                            continue;
+                    }
+                    if (vertices[a].z && vertices[b].z && vertices[c].z && vertices[d].z
+                        && std::abs(vertices[a].z - vertices[b].z) < max_step && std::abs(vertices[a].z - vertices[c].z) < max_step
+                        && std::abs(vertices[b].z - vertices[d].z) < max_step && std::abs(vertices[c].z - vertices[d].z) < max_step)
+                    {
+                        const uint32_t faces[] = { uint32_t(a), uint32_t(b), uint32_t(d), uint32_t(d), uint32_t(c), uint32_t(a) };
+                        out.insert(out.end(), faces, faces + 6);
+                    }
+                }
+            }
+        });
+    }
+
+    mesh_generator::mesh_generator()
+        : _max_depth_step(depth_step_default),
+          _width(0), _height(0),
+          _processing_threads(processing_threads_default),
+          _executor(processing_threads_default)
+    {
+        auto depth_step = std::make_shared<ptr_option<float>>(depth_step_min, depth_step_max, depth_step_step, depth_step_default,
+            &_max_depth_step, "Largest depth difference in meters between neighboring vertices joined by a face");
+        register_option(RS2_OPTION_MESH_MAX_DEPTH_STEP, depth_step);
+
+        register_processing_threads_option(*this, _processing_threads, _executor, _mutex,
+            "Number of threads used to build the faces of each pointcloud, 0 for all hardware threads", "mesh generator");
+    }
+
+    bool mesh_generator::should_process(const rs2::frame& frame)
+    {
+        if (!frame || !frame.is<rs2::points>())
+            return false;
+
+        // The faces follow the layout of the image, which a sparse pointcloud only keeps through its pixel indices
+        auto vsp = dynamic_cast<video_stream_profile_interface*>(((frame_interface*)frame.get())->get_stream().get());
+        if (!vsp)
+            return false;
+        return frame.as<rs2::points>().size() == size_t(vsp->get_width()) * vsp->get_height() ||
+            static_cast<points*>((frame_interface*)frame.get())->get_pixel_indices();
+    }
+
+    void mesh_generator::update_output_profile(const rs2::frame& f)
+    {
+        if (frame_profile(f) == _source_stream_profile.get())
+            return;
+
+        _source_stream_profile = f.get_profile();
+        _target_stream_profile = _source_stream_profile.clone(_source_stream_profile.stream_type(),
+            _source_stream_profile.stream_index(), RS2_FORMAT_MESH_INDICES);
+        auto vp = _source_stream_profile.as<rs2::video_stream_profile>();
+        _width = vp.width();
+        _height = vp.height();
+    }
+
+    rs2::frame mesh_generator::process_frame(const rs2::frame_source& source, const rs2::frame& f)
+    {
+        update_output_profile(f);
+
+        auto input = static_cast<points*>((frame_interface*)f.get());
+        auto vertices = input->get_vertices();
+        const size_t count = input->get_vertex_count();
+        const int* pixel2vertex = nullptr;
+        if (count != size_t(_width) * _height)
+        {
+            auto pixel_indices = input->get_pixel_indices();
+            _pixel2vertex.assign(size_t(_width) * _height, -1);
+            for (size_t i = 0; i < count; ++i)
+                _pixel2vertex[pixel_indices[i]] = static_cast<int>(i);
+            pixel2vertex = _pixel2vertex.data();
+        }
+
+        generate_faces(vertices, _width, _height, pixel2vertex, _max_depth_step, _executor, _bands);
+
+        size_t indices = 0;
+        for (auto&& band : _bands)
+            indices += band.size();
+        const int faces = std::max(1, int(indices / 3));
+        const int face_size = 3 * sizeof(uint32_t);
+
+        auto tgt = source.allocate_video_frame(_target_stream_profile, f, face_size, faces, 1, faces * face_size, RS2_EXTENSION_VIDEO_FRAME);
+        if (!tgt)
+            return tgt;
+
+        auto out = static_cast<uint32_t*>(const_cast<void*>(tgt.get_data()));
+        if (!indices)
+            out[0] = out[1] = out[2] = 0;
+        for (auto&& band : _bands)
+        {
+            if (!band.empty())
+                memcpy(out, band.data(), band.size() * sizeof(uint32_t));
+            out += band.size();
+        }
+        return tgt;
+    }
+}
@@ -0,0 +1,48 @@
+// Mesh generator joins the vertices of an organized pointcloud into triangles, output as an index buffer
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "../include/librealsense2/hpp/rs_frame.hpp"
+#include "../include/librealsense2/hpp/rs_processing.hpp"
+#include "synthetic-stream.h"
+#include "concurrency.h"
+#include "types.h"
+
+#include <vector>
+
+namespace librealsense
+{
+    // Two triangles per square of neighboring depth pixels whose four vertices have depth, and differ in depth along the
+    // edges of the square by less than max_step meters. The faces hold three vertex indices each, listed in bands of rows
+    // built in parallel and in raster order once the bands are concatenated. A sparse pointcloud passes the vertex of every
+    // pixel, or -1, in pixel2vertex, a dense one passes null and the vertices are the pixels
+    void generate_faces(const float3* vertices, int width, int height, const int* pixel2vertex, float max_step,
+        parallel_executor& executor, std::vector<std::vector<uint32_t>>& bands);
+
+    // Takes a dense points frame, or a sparse one allocated with pixel indices, and outputs a video frame of
+    // RS2_FORMAT_MESH_INDICES: a single row of faces indexing the vertices of the points frame, so a renderer can
+    // upload both buffers as they are. A frame without any face holds one degenerate face, drawing nothing
+    class mesh_generator : public generic_processing_block
+    {
+    public:
+        mesh_generator();
+
+    protected:
+        bool should_process(const rs2::frame& frame) override;
+        rs2::frame process_frame(const rs2::frame_source& source, const rs2::frame& f) override;
+
+    private:
+        void    update_output_profile(const rs2::frame& f);
+
+        float                   _max_depth_step;    // In meters
+        rs2::stream_profile     _source_stream_profile;
+        rs2::stream_profile     _target_stream_profile;
+        int                     _width, _height;
+        std::vector<int>        _pixel2vertex;
+        std::vector<std::vector<uint32_t>> _bands;
+        uint8_t                 _processing_threads;
+        parallel_executor       _executor;
+    };
+}
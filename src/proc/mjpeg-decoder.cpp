@@ -0,0 +1,52 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#include "../include/librealsense2/hpp/rs_sensor.hpp"
+#include "../include/librealsense2/hpp/rs_processing.hpp"
+
+#include "image.h"
+#include "proc/synthetic-stream.h"
+#include "proc/mjpeg-decoder.h"
+#include "proc/jpeg-codec.h"
+
+namespace librealsense
+{
+    mjpeg_decoder::mjpeg_decoder(rs2_format target_format)
+        : _target_format(target_format),
+          _target_bpp(get_image_bpp(target_format) / 8)
+    {
+        if (target_format != RS2_FORMAT_RGB8 && target_format != RS2_FORMAT_Y8)
+            throw invalid_value_exception(to_string() << "MJPEG decoder: unsupported target format " << get_string(target_format));
+
+        _stream_filter.format = RS2_FORMAT_MJPEG;
+    }
+
+    void mjpeg_decoder::update_output_profile(const rs2::frame& f)
+    {
+        if (frame_profile(f) != _source_stream_profile.get())
+        {
+            _source_stream_profile = f.get_profile();
+            _target_stream_profile = _source_stream_profile.clone(_source_stream_profile.stream_type(), _source_stream_profile.stream_index(), _target_format);
+        }
+    }
+
+    rs2::frame mjpeg_decoder::process_frame(const rs2::frame_source& source, const rs2::frame& f)
+    {
+        update_output_profile(f);
+
+        auto vp = _target_stream_profile.as<rs2::video_stream_profile>();
+        auto width = vp.width(), height = vp.height();
+        auto tgt = source.allocate_video_frame(_target_stream_profile, f, _target_bpp, width, height, width * _target_bpp, RS2_EXTENSION_VIDEO_FRAME);
+        if (!tgt)
+            return tgt;
+
+        auto vf = f.as<rs2::video_frame>();
+        if (!jpeg_decode(static_cast<const uint8_t*>(vf.get_data()), vf.get_stride_in_bytes() * vf.get_height(),
+                         static_cast<uint8_t*>(const_cast<void*>(tgt.get_data())), width, height, _target_bpp))
+        {
+            LOG_WARNING("MJPEG frame " << f.get_frame_number() << " could not be decoded into a " << width << "x" << height << " image");
+            return rs2::frame{};
+        }
+        return tgt;
+    }
+}
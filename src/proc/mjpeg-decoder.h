@@ -0,0 +1,28 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "../include/librealsense2/hpp/rs_frame.hpp"
+#include "../include/librealsense2/hpp/rs_processing.hpp"
+
+namespace librealsense
+{
+    // Decodes Motion-JPEG color frames, see jpeg-codec.h. Only built with BUILD_WITH_LIBJPEG
+    class mjpeg_decoder : public stream_filter_processing_block
+    {
+    public:
+        explicit mjpeg_decoder(rs2_format target_format);
+
+    protected:
+        rs2::frame process_frame(const rs2::frame_source& source, const rs2::frame& f) override;
+
+    private:
+        void update_output_profile(const rs2::frame& f);
+
+        rs2_format              _target_format;
+        int                     _target_bpp;
+        rs2::stream_profile     _source_stream_profile;
+        rs2::stream_profile     _target_stream_profile;
+    };
+}
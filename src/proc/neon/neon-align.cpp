@@ -0,0 +1,404 @@
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+
+#include "neon-align.h"
+#include <arm_neon.h> // For NEON intrinsics
+#include "../include/librealsense2/hpp/rs_sensor.hpp"
+#include "../include/librealsense2/hpp/rs_processing.hpp"
+#include "../include/librealsense2/rsutil.h"
+
+#include "core/video.h"
+#include "proc/synthetic-stream.h"
+#include "environment.h"
+#include "stream.h"
+
+using namespace librealsense;
+
+template<int N> struct bytes { byte b[N]; };
+
+static bool is_special_resolution(const rs2_intrinsics& depth, const rs2_intrinsics& to)
+{
+    if ((depth.width == 640 && depth.height == 240 && to.width == 320 && to.height == 180) ||
+        (depth.width == 640 && depth.height == 480 && to.width == 640 && to.height == 360))
+        return true;
+    return false;
+}
+
+// ARMv7 has no vector division, refine the reciprocal estimate to full float precision instead
+static inline float32x4_t div_f32(float32x4_t a, float32x4_t b)
+{
+#if defined(__aarch64__)
+    return vdivq_f32(a, b);
+#else
+    auto inv = vrecpeq_f32(b);
+    inv = vmulq_f32(inv, vrecpsq_f32(b, inv));
+    inv = vmulq_f32(inv, vrecpsq_f32(b, inv));
+    return vmulq_f32(a, inv);
+#endif
+}
+
+// Rounds half to even, like _mm_cvtps_epi32 under the default rounding mode
+static inline int32x4_t round_s32(float32x4_t v)
+{
+#if defined(__aarch64__)
+    return vcvtnq_s32_f32(v);
+#else
+    // Adding 1.5 * 2^23 leaves no fraction bits, valid for the |v| < 2^22 range of pixel coordinates
+    const auto magic = vdupq_n_f32(12582912.f);
+    return vcvtq_s32_f32(vsubq_f32(vaddq_f32(v, magic), magic));
+#endif
+}
+
+static inline float32x4_t and_mask(float32x4_t v, uint32x4_t mask)
+{
+    return vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(v), mask));
+}
+
+template<rs2_distortion dist>
+inline void distorte_x_y(const float32x4_t& x, const float32x4_t& y, float32x4_t* distorted_x, float32x4_t* distorted_y, const rs2_intrinsics& to)
+{
+    *distorted_x = x;
+    *distorted_y = y;
+}
+template<>
+inline void distorte_x_y<RS2_DISTORTION_MODIFIED_BROWN_CONRADY>(const float32x4_t& x, const float32x4_t& y, float32x4_t* distorted_x, float32x4_t* distorted_y, const rs2_intrinsics& to)
+{
+    float32x4_t c[5];
+    auto one = vdupq_n_f32(1);
+    auto two = vdupq_n_f32(2);
+
+    for (int i = 0; i < 5; ++i)
+    {
+        c[i] = vdupq_n_f32(to.coeffs[i]);
+    }
+    auto r2_0 = vaddq_f32(vmulq_f32(x, x), vmulq_f32(y, y));
+    auto r3_0 = vaddq_f32(vmulq_f32(c[1], vmulq_f32(r2_0, r2_0)), vmulq_f32(c[4], vmulq_f32(r2_0, vmulq_f32(r2_0, r2_0))));
+    auto f_0 = vaddq_f32(one, vaddq_f32(vmulq_f32(c[0], r2_0), r3_0));
+
+    auto x_f0 = vmulq_f32(x, f_0);
+    auto y_f0 = vmulq_f32(y, f_0);
+
+    auto r4_0 = vmulq_f32(c[3], vaddq_f32(r2_0, vmulq_f32(two, vmulq_f32(x_f0, x_f0))));
+    auto d_x0 = vaddq_f32(x_f0, vaddq_f32(vmulq_f32(two, vmulq_f32(c[2], vmulq_f32(x_f0, y_f0))), r4_0));
+
+    auto r5_0 = vmulq_f32(c[2], vaddq_f32(r2_0, vmulq_f32(two, vmulq_f32(y_f0, y_f0))));
+    auto d_y0 = vaddq_f32(y_f0, vaddq_f32(vmulq_f32(two, vmulq_f32(c[3], vmulq_f32(x_f0, y_f0))), r5_0));
+
+    *distorted_x = d_x0;
+    *distorted_y = d_y0;
+}
+
+template<rs2_distortion dist>
+inline void get_texture_map_neon(const uint16_t * depth,
+    float depth_scale,
+    const unsigned int size,
+    const float * pre_compute_x, const float * pre_compute_y,
+    byte * pixels_ptr_int,
+    const rs2_intrinsics& to,
+    const rs2_extrinsics& from_to_other)
+{
+    auto scale = vdupq_n_f32(depth_scale);
+
+    auto mapx = pre_compute_x;
+    auto mapy = pre_compute_y;
+
+    auto res = reinterpret_cast<int32_t*>(pixels_ptr_int);
+
+    float32x4_t r[9];
+    float32x4_t t[3];
+
+    for (int i = 0; i < 9; ++i)
+    {
+        r[i] = vdupq_n_f32(from_to_other.rotation[i]);
+    }
+    for (int i = 0; i < 3; ++i)
+    {
+        t[i] = vdupq_n_f32(from_to_other.translation[i]);
+    }
+    auto zero = vdupq_n_f32(0);
+    auto half = vdupq_n_f32(0.5);
+    auto fx = vdupq_n_f32(to.fx);
+    auto fy = vdupq_n_f32(to.fy);
+    auto ppx = vdupq_n_f32(to.ppx);
+    auto ppy = vdupq_n_f32(to.ppy);
+
+    for (unsigned int i = 0; i < size; i += 4)
+    {
+        auto x = vld1q_f32(mapx + i);
+        auto y = vld1q_f32(mapy + i);
+
+        //widen 4 depth pixels to float
+        auto z = vmulq_f32(vcvtq_f32_u32(vmovl_u16(vld1_u16(depth + i))), scale);
+
+        auto px = vmulq_f32(z, x);
+        auto py = vmulq_f32(z, y);
+
+        auto p_x = vaddq_f32(vmulq_f32(r[0], px), vaddq_f32(vmulq_f32(r[3], py), vaddq_f32(vmulq_f32(r[6], z), t[0])));
+        auto p_y = vaddq_f32(vmulq_f32(r[1], px), vaddq_f32(vmulq_f32(r[4], py), vaddq_f32(vmulq_f32(r[7], z), t[1])));
+        auto p_z = vaddq_f32(vmulq_f32(r[2], px), vaddq_f32(vmulq_f32(r[5], py), vaddq_f32(vmulq_f32(r[8], z), t[2])));
+
+        p_x = div_f32(p_x, p_z);
+        p_y = div_f32(p_y, p_z);
+
+        distorte_x_y<dist>(p_x, p_y, &p_x, &p_y, to);
+
+        p_x = vaddq_f32(vmulq_f32(p_x, fx), ppx);
+        p_y = vaddq_f32(vmulq_f32(p_y, fy), ppy);
+
+        //zero the x and y if z is zero
+        auto cmp = vmvnq_u32(vceqq_f32(z, zero));
+        int32x4x2_t uv;
+        uv.val[0] = round_s32(and_mask(vaddq_f32(p_x, half), cmp));
+        uv.val[1] = round_s32(and_mask(vaddq_f32(p_y, half), cmp));
+
+        //interleave to (u, v) pairs
+        vst2q_s32(res, uv);
+        res += 8;
+    }
+}
+
+image_transform_neon::image_transform_neon(const rs2_intrinsics& from, float depth_scale)
+    :_depth(from),
+    _depth_scale(depth_scale),
+    _pixel_top_left_int(from.width*from.height),
+    _pixel_bottom_right_int(from.width*from.height)
+{
+}
+
+void image_transform_neon::pre_compute_x_y_map_corners()
+{
+    pre_compute_x_y_map(_pre_compute_map_x_top_left, _pre_compute_map_y_top_left, -0.5f);
+    pre_compute_x_y_map(_pre_compute_map_x_bottom_right, _pre_compute_map_y_bottom_right, 0.5f);
+}
+
+void image_transform_neon::pre_compute_x_y_map(std::vector<float>& pre_compute_map_x,
+    std::vector<float>& pre_compute_map_y,
+    float offset)
+{
+    pre_compute_map_x.resize(_depth.width*_depth.height);
+    pre_compute_map_y.resize(_depth.width*_depth.height);
+
+    for (int h = 0; h < _depth.height; ++h)
+    {
+        for (int w = 0; w < _depth.width; ++w)
+        {
+            const float pixel[] = { (float)w + offset, (float)h + offset };
+
+            float x = (pixel[0] - _depth.ppx) / _depth.fx;
+            float y = (pixel[1] - _depth.ppy) / _depth.fy;
+
+            if (_depth.model == RS2_DISTORTION_INVERSE_BROWN_CONRADY)
+            {
+                float r2 = x * x + y * y;
+                float f = 1 + _depth.coeffs[0] * r2 + _depth.coeffs[1] * r2*r2 + _depth.coeffs[4] * r2*r2*r2;
+                float ux = x * f + 2 * _depth.coeffs[2] * x*y + _depth.coeffs[3] * (r2 + 2 * x*x);
+                float uy = y * f + 2 * _depth.coeffs[3] * x*y + _depth.coeffs[2] * (r2 + 2 * y*y);
+                x = ux;
+                y = uy;
+            }
+
+            pre_compute_map_x[h*_depth.width + w] = x;
+            pre_compute_map_y[h*_depth.width + w] = y;
+        }
+    }
+}
+
+void image_transform_neon::align_depth_to_other(const uint16_t* z_pixels, uint16_t* dest, int bpp, const rs2_intrinsics& depth, const rs2_intrinsics& to,
+    const rs2_extrinsics& from_to_other)
+{
+    switch (to.model)
+    {
+    case RS2_DISTORTION_MODIFIED_BROWN_CONRADY:
+        align_depth_to_other_neon<RS2_DISTORTION_MODIFIED_BROWN_CONRADY>(z_pixels, dest, depth, to, from_to_other);
+        break;
+    default:
+        align_depth_to_other_neon(z_pixels, dest, depth, to, from_to_other);
+        break;
+    }
+}
+
+inline void image_transform_neon::move_depth_to_other(const uint16_t* z_pixels, uint16_t* dest, const rs2_intrinsics& to,
+    const std::vector<librealsense::int2>& pixel_top_left_int,
+    const std::vector<librealsense::int2>& pixel_bottom_right_int)
+{
+    for (int y = 0; y < _depth.height; ++y)
+    {
+        for (int x = 0; x < _depth.width; ++x)
+        {
+            auto depth_pixel_index = y * _depth.width + x;
+            // Skip over depth pixels with the value of zero, we have no depth data so we will not write anything into our aligned images
+            if (z_pixels[depth_pixel_index])
+            {
+                for (int other_y = pixel_top_left_int[depth_pixel_index].y; other_y <= pixel_bottom_right_int[depth_pixel_index].y; ++other_y)
+                {
+                    for (int other_x = pixel_top_left_int[depth_pixel_index].x; other_x <= pixel_bottom_right_int[depth_pixel_index].x; ++other_x)
+                    {
+                        if (other_x < 0 || other_y < 0 || other_x >= to.width || other_y >= to.height)
+                            continue;
+                        auto other_ind = other_y * to.width + other_x;
+
+                        dest[other_ind] = dest[other_ind] ? std::min(dest[other_ind], z_pixels[depth_pixel_index]) : z_pixels[depth_pixel_index];
+                    }
+                }
+            }
+        }
+    }
+}
+
+void image_transform_neon::align_other_to_depth(const uint16_t* z_pixels, const byte* source, byte* dest, int bpp, const rs2_intrinsics& to,
+    const rs2_extrinsics& from_to_other)
+{
+    switch (to.model)
+    {
+    case RS2_DISTORTION_MODIFIED_BROWN_CONRADY:
+        align_other_to_depth_neon<RS2_DISTORTION_MODIFIED_BROWN_CONRADY>(z_pixels, source, dest, bpp, to, from_to_other);
+        break;
+    default:
+        align_other_to_depth_neon(z_pixels, source, dest, bpp, to, from_to_other);
+        break;
+    }
+}
+
+
+template<rs2_distortion dist>
+inline void image_transform_neon::align_depth_to_other_neon(const uint16_t * z_pixels, uint16_t * dest, const rs2_intrinsics& depth, const rs2_intrinsics& to,
+    const rs2_extrinsics& from_to_other)
+{
+    get_texture_map_neon<dist>(z_pixels, _depth_scale, _depth.height*_depth.width, _pre_compute_map_x_top_left.data(),
+        _pre_compute_map_y_top_left.data(), (byte*)_pixel_top_left_int.data(), to, from_to_other);
+
+    float fov[2];
+    rs2_fov(&depth, fov);
+    float2 pixels_per_angle_depth = { (float)depth.width / fov[0], (float)depth.height / fov[1] };
+
+    rs2_fov(&to, fov);
+    float2 pixels_per_angle_target = { (float)to.width / fov[0], (float)to.height / fov[1] };
+
+    if (pixels_per_angle_depth.x < pixels_per_angle_target.x || pixels_per_angle_depth.y < pixels_per_angle_target.y || is_special_resolution(depth, to))
+    {
+        get_texture_map_neon<dist>(z_pixels, _depth_scale, _depth.height*_depth.width, _pre_compute_map_x_bottom_right.data(),
+            _pre_compute_map_y_bottom_right.data(), (byte*)_pixel_bottom_right_int.data(), to, from_to_other);
+
+        move_depth_to_other(z_pixels, dest, to, _pixel_top_left_int, _pixel_bottom_right_int);
+    }
+    else
+    {
+        move_depth_to_other(z_pixels, dest, to, _pixel_top_left_int, _pixel_top_left_int);
+    }
+
+}
+
+template<rs2_distortion dist>
+inline void image_transform_neon::align_other_to_depth_neon(const uint16_t * z_pixels, const byte * source, byte * dest, int bpp, const rs2_intrinsics& to,
+    const rs2_extrinsics& from_to_other)
+{
+    get_texture_map_neon<dist>(z_pixels, _depth_scale, _depth.height*_depth.width, _pre_compute_map_x_top_left.data(),
+        _pre_compute_map_y_top_left.data(), (byte*)_pixel_top_left_int.data(), to, from_to_other);
+
+    auto bottom_right = &_pixel_top_left_int;
+    if (to.height < _depth.height && to.width < _depth.width)
+    {
+        get_texture_map_neon<dist>(z_pixels, _depth_scale, _depth.height*_depth.width, _pre_compute_map_x_bottom_right.data(),
+            _pre_compute_map_y_bottom_right.data(), (byte*)_pixel_bottom_right_int.data(), to, from_to_other);
+
+        bottom_right = &_pixel_bottom_right_int;
+    }
+
+    switch (bpp)
+    {
+    case 1:
+        move_other_to_depth(z_pixels, reinterpret_cast<const bytes<1>*>(source), reinterpret_cast<bytes<1>*>(dest), to,
+            _pixel_top_left_int, *bottom_right);
+        break;
+    case 2:
+        move_other_to_depth(z_pixels, reinterpret_cast<const bytes<2>*>(source), reinterpret_cast<bytes<2>*>(dest), to,
+            _pixel_top_left_int, *bottom_right);
+        break;
+    case 3:
+        move_other_to_depth(z_pixels, reinterpret_cast<const bytes<3>*>(source), reinterpret_cast<bytes<3>*>(dest), to,
+            _pixel_top_left_int, *bottom_right);
+        break;
+    case 4:
+        move_other_to_depth(z_pixels, reinterpret_cast<const bytes<4>*>(source), reinterpret_cast<bytes<4>*>(dest), to,
+            _pixel_top_left_int, *bottom_right);
+        break;
+    default:
+        break;
+    }
+}
+
+template<class T >
+void image_transform_neon::move_other_to_depth(const uint16_t* z_pixels,
+    const T* source,
+    T* dest, const rs2_intrinsics& to,
+    const std::vector<librealsense::int2>& pixel_top_left_int,
+    const std::vector<librealsense::int2>& pixel_bottom_right_int)
+{
+    // Iterate over the pixels of the depth image
+    for (int y = 0; y < _depth.height; ++y)
+    {
+        for (int x = 0; x < _depth.width; ++x)
+        {
+            auto depth_pixel_index = y * _depth.width + x;
+            // Skip over depth pixels with the value of zero, we have no depth data so we will not write anything into our aligned images
+            if (z_pixels[depth_pixel_index])
+            {
+                for (int other_y = pixel_top_left_int[depth_pixel_index].y; other_y <= pixel_bottom_right_int[depth_pixel_index].y; ++other_y)
+                {
+                    for (int other_x = pixel_top_left_int[depth_pixel_index].x; other_x <= pixel_bottom_right_int[depth_pixel_index].x; ++other_x)
+                    {
+                        if (other_x < 0 || other_y < 0 || other_x >= to.width || other_y >= to.height)
+                            continue;
+                        auto other_ind = other_y * to.width + other_x;
+
+                        dest[depth_pixel_index] = source[other_ind];
+                    }
+                }
+            }
+        }
+    }
+}
+
+void align_neon::reset_cache(rs2_stream from, rs2_stream to)
+{
+    _stream_transform = nullptr;
+}
+
+void align_neon::align_z_to_other(byte* aligned_data, const rs2::video_frame& depth, const rs2::video_stream_profile& other_profile, float z_scale)
+{
+    auto depth_profile = depth.get_profile().as<rs2::video_stream_profile>();
+
+    auto z_intrin = depth_profile.get_intrinsics();
+    auto other_intrin = other_profile.get_intrinsics();
+    auto z_to_other = depth_profile.get_extrinsics_to(other_profile);
+
+    auto z_pixels = reinterpret_cast<const uint16_t*>(depth.get_data());
+
+    if (_stream_transform == nullptr)
+    {
+        _stream_transform = std::make_shared<image_transform_neon>(z_intrin, z_scale);
+        _stream_transform->pre_compute_x_y_map_corners();
+    }
+    _stream_transform->align_depth_to_other(z_pixels, reinterpret_cast<uint16_t*>(aligned_data), 2, z_intrin, other_intrin, z_to_other);
+}
+
+void align_neon::align_other_to_z(byte* aligned_data, const rs2::video_frame& depth, const rs2::video_frame& other, float z_scale)
+{
+    auto depth_profile = depth.get_profile().as<rs2::video_stream_profile>();
+    auto other_profile = other.get_profile().as<rs2::video_stream_profile>();
+
+    auto z_intrin = depth_profile.get_intrinsics();
+    auto other_intrin = other_profile.get_intrinsics();
+    auto z_to_other = depth_profile.get_extrinsics_to(other_profile);
+
+    auto z_pixels = reinterpret_cast<const uint16_t*>(depth.get_data());
+    auto other_pixels = reinterpret_cast<const byte*>(other.get_data());
+
+    if (_stream_transform == nullptr)
+    {
+        _stream_transform = std::make_shared<image_transform_neon>(z_intrin, z_scale);
+        _stream_transform->pre_compute_x_y_map_corners();
+    }
+
+    _stream_transform->align_other_to_depth(z_pixels, other_pixels, aligned_data, other.get_bytes_per_pixel(), other_intrin, z_to_other);
+}
+#endif // __ARM_NEON
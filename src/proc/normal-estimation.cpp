@@ -0,0 +1,125 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#include "../include/librealsense2/hpp/rs_sensor.hpp"
+#include "../include/librealsense2/hpp/rs_processing.hpp"
+
+#include <cmath>
+#include "option.h"
+#include "context.h"
+#include "core/video.h"
+#include "proc/synthetic-stream.h"
+#include "proc/normal-estimation.h"
+
+namespace librealsense
+{
+    const float depth_change_min = 0.f;
+    const float depth_change_max = 1.f;
+    const float depth_change_step = 0.01f;
+    const float depth_change_default = 0.05f;
+
+    inline float3 difference(const float3& a, const float3& b) { return{ a.x - b.x, a.y - b.y, a.z - b.z }; }
+
+    // Difference across the vertex along one axis, from both neighbors when they are usable and from one of them otherwise
+    inline bool axis_difference(const float3& p, const float3* before, const float3* after, float max_change, float3& d)
+    {
+        auto usable = [&](const float3* n) { return n && n->z && std::abs(n->z - p.z) <= max_change * p.z; };
+        auto b = usable(before), a = usable(after);
+        if (a && b) d = difference(*after, *before);
+        else if (a) d = difference(*after, p);
+        else if (b) d = difference(p, *before);
+        return a || b;
+    }
+
+    static void estimate_normals_row(const float3* vertices, int width, int height, int y, float max_change, float3* out)
+    {
+        const float3* row = vertices + size_t(y) * width;
+        const float3* up = y > 0 ? row - width : nullptr;
+        const float3* down = y + 1 < height ? row + width : nullptr;
+
+        for (int x = 0; x < width; ++x)
+        {
+            const float3& p = row[x];
+            out[x] = { 0.f, 0.f, 0.f };
+            if (!p.z)
+                continue;
+
+            float3 dx, dy;
+            if (!axis_difference(p, x > 0 ? row + x - 1 : nullptr, x + 1 < width ? row + x + 1 : nullptr, max_change, dx) ||
+                !axis_difference(p, up ? up + x : nullptr, down ? down + x : nullptr, max_change, dy))
+                continue;
+
+            float3 n = { dx.y * dy.z - dx.z * dy.y, dx.z * dy.x - dx.x * dy.z, dx.x * dy.y - dx.y * dy.x };
+            float length = std::sqrt(n.x * n.x + n.y * n.y + n.z * n.z);
+            if (!(length > 0.f))
+                continue;
+
+            // The camera looks along +z, a normal facing it points against the ray to the vertex
+            if (n.x * p.x + n.y * p.y + n.z * p.z > 0.f)
+                length = -length;
+            out[x] = { n.x / length, n.y / length, n.z / length };
+        }
+    }
+
+    normal_estimation::normal_estimation()
+        : _max_depth_change(depth_change_default),
+          _width(0), _height(0),
+          _processing_threads(processing_threads_default),
+          _executor(processing_threads_default)
+    {
+        auto depth_change = std::make_shared<ptr_option<float>>(depth_change_min, depth_change_max, depth_change_step, depth_change_default,
+            &_max_depth_change, "Largest depth difference to a neighbor used for the normal, as a fraction of the depth of the vertex");
+        register_option(RS2_OPTION_NORMAL_MAX_DEPTH_CHANGE, depth_change);
+
+        register_processing_threads_option(*this, _processing_threads, _executor, _mutex,
+            "Number of threads used to estimate the normals of each pointcloud, 0 for all hardware threads", "normal estimation");
+    }
+
+    bool normal_estimation::should_process(const rs2::frame& frame)
+    {
+        if (!frame || !frame.is<rs2::points>())
+            return false;
+
+        // Only a dense pointcloud keeps the layout of the image
+        auto vsp = dynamic_cast<video_stream_profile_interface*>(((frame_interface*)frame.get())->get_stream().get());
+        return vsp && frame.as<rs2::points>().size() == size_t(vsp->get_width()) * vsp->get_height();
+    }
+
+    void normal_estimation::update_output_profile(const rs2::frame& f)
+    {
+        if (frame_profile(f) == _source_stream_profile.get())
+            return;
+
+        _source_stream_profile = f.get_profile();
+        _target_stream_profile = _source_stream_profile.clone(_source_stream_profile.stream_type(),
+            _source_stream_profile.stream_index(), RS2_FORMAT_XYZ32F);
+        auto vp = _source_stream_profile.as<rs2::video_stream_profile>();
+        _width = vp.width();
+        _height = vp.height();
+    }
+
+    rs2::frame normal_estimation::process_frame(const rs2::frame_source& source, const rs2::frame& f)
+    {
+        update_output_profile(f);
+
+        auto tgt = source.allocate_video_frame(_target_stream_profile, f, int(sizeof(float3)), _width, _height,
+            _width * int(sizeof(float3)), RS2_EXTENSION_VIDEO_FRAME);
+        if (!tgt)
+            return tgt;
+
+        auto vertices = static_cast<points*>((frame_interface*)f.get())->get_vertices();
+        auto normals = static_cast<float3*>(const_cast<void*>(tgt.get_data()));
+        const float max_change = _max_depth_change;
+        const int width = _width, height = _height;
+
+        // Rows only read the vertices, they are processed in bands on the worker threads
+        size_t bands = std::max<size_t>(1, std::min<size_t>(_executor.size() > 1 ? _executor.size() * 4 : 1, size_t(height)));
+        _executor.for_each(bands, [&](size_t b)
+        {
+            for (int y = int(height * b / bands); y < int(height * (b + 1) / bands); ++y)
+                estimate_normals_row(vertices, width, height, y, max_change, normals + size_t(y) * width);
+        });
+
+        return tgt;
+    }
+}
@@ -0,0 +1,36 @@
+// Normal estimation block computes the surface normal of every vertex of an organized pointcloud
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "../include/librealsense2/hpp/rs_frame.hpp"
+#include "../include/librealsense2/hpp/rs_processing.hpp"
+#include "concurrency.h"
+
+namespace librealsense
+{
+    // A dense points frame keeps the layout of the depth image, so the neighbors of a vertex are its neighbors in the image.
+    // The normal is the cross product of the horizontal and vertical differences around the vertex, oriented toward the camera.
+    // Neighbors without depth, or farther in depth than the allowed fraction of the vertex depth, are left out, and vertices
+    // with no usable neighbor on an axis get a zero normal. The output is a video frame of RS2_FORMAT_XYZ32F, one normal per vertex
+    class normal_estimation : public generic_processing_block
+    {
+    public:
+        normal_estimation();
+
+    protected:
+        bool should_process(const rs2::frame& frame) override;
+        rs2::frame process_frame(const rs2::frame_source& source, const rs2::frame& f) override;
+
+    private:
+        void    update_output_profile(const rs2::frame& f);
+
+        float                   _max_depth_change;  // Fraction of the depth of a vertex
+        rs2::stream_profile     _source_stream_profile;
+        rs2::stream_profile     _target_stream_profile;
+        int                     _width, _height;
+        uint8_t                 _processing_threads;
+        parallel_executor       _executor;
+    };
+}
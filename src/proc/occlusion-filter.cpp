@@ -16,20 +16,21 @@ namespace librealsense
     void occlusion_filter::set_texel_intrinsics(const rs2_intrinsics& in)
     {
         _texels_intrinsics = in;
-        _texels_depth.resize(_texels_intrinsics.value().width*_texels_intrinsics.value().height);
+        _texels_count = size_t(in.width) * in.height;
+        _texels_depth.get(_texels_count);
     }
 
-    void occlusion_filter::process(float3* points, float2* uv_map, const std::vector<float2> & pix_coord) const
+    void occlusion_filter::process(float3* points, float2* uv_map, const std::vector<float2> & pix_coord, parallel_executor& executor) const
     {
         switch (_occlusion_filter)
         {
         case occlusion_none:
             break;
         case occlusion_monotonic_scan:
-            monotonic_heuristic_invalidation(points, uv_map, pix_coord);
+            monotonic_heuristic_invalidation(points, uv_map, pix_coord, executor);
             break;
         case occlusion_exhaustic_search:
-            comprehensive_invalidation(points, uv_map, pix_coord);
+            comprehensive_invalidation(points, uv_map, pix_coord, executor);
             break;
         default:
             throw std::runtime_error(to_string() << "Unsupported occlusion filter type " << _occlusion_filter << " requested");
@@ -45,48 +46,75 @@ namespace librealsense
     // -  The occlusion is designated as U coordinate for a given pixel is less than the U coordinate of the predecessing pixel.
     // -  The UV mapping for the occluded pixel is reset to (0,0). Later on the (0,0) coordinate in the texture map is overwritten
     //    with a invalidation color such as black/magenta according to the purpose (production/debugging)
-    void occlusion_filter::monotonic_heuristic_invalidation(float3* points, float2* uv_map, const std::vector<float2> & pix_coord) const
+    // -  Lines are scanned independently and are split among the executor threads
+    void occlusion_filter::monotonic_heuristic_invalidation(float3* points, float2* uv_map, const std::vector<float2> & pix_coord, parallel_executor& executor) const
     {
         float occZTh = 0.1f; //meters
         int occDilationSz = 1;
-        auto pixels_ptr = pix_coord.data();
-        auto points_width = _depth_intrinsics->width;
-        auto points_height = _depth_intrinsics->height;
+        size_t points_width = _depth_intrinsics->width;
+        size_t points_height = _depth_intrinsics->height;
 
-        for (size_t y = 0; y < points_height; ++y)
+        executor.for_each_range(points_height, 1, [&](size_t line_begin, size_t line_end)
         {
-            float maxInLine = -1;
-            float maxZ = 0;
-            int occDilationLeft = 0;
+            auto points_ptr = points + line_begin * points_width;
+            auto uv_ptr = uv_map + line_begin * points_width;
+            auto pixels_ptr = pix_coord.data() + line_begin * points_width;
 
-            for (size_t x = 0; x < points_width; ++x)
+            for (size_t y = line_begin; y < line_end; ++y)
             {
-                if (points->z)
+                float maxInLine = -1;
+                float maxZ = 0;
+                int occDilationLeft = 0;
+
+                for (size_t x = 0; x < points_width; ++x)
                 {
-                    // Occlusion detection
-                    if (pixels_ptr->x < maxInLine || (pixels_ptr->x == maxInLine && (points->z - maxZ) > occZTh))
-                    {
-                        uv_map->x = 0.f;
-                        uv_map->y = 0.f;
-                        occDilationLeft = occDilationSz;
-                    }
-                    else
+                    if (points_ptr->z)
                     {
-                        maxInLine = pixels_ptr->x;
-                        maxZ = points->z;
-                        if (occDilationLeft > 0)
+                        // Occlusion detection
+                        if (pixels_ptr->x < maxInLine || (pixels_ptr->x == maxInLine && (points_ptr->z - maxZ) > occZTh))
                         {
-                            uv_map->x = 0.f;
-                            uv_map->y = 0.f;
-                            occDilationLeft--;
+                            uv_ptr->x = 0.f;
+                            uv_ptr->y = 0.f;
+                            occDilationLeft = occDilationSz;
+                        }
+                        else
+                        {
+                            maxInLine = pixels_ptr->x;
+                            maxZ = points_ptr->z;
+                            if (occDilationLeft > 0)
+                            {
+                                uv_ptr->x = 0.f;
+                                uv_ptr->y = 0.f;
+                                occDilationLeft--;
+                            }
                         }
                     }
-                }
 
-                ++points;
-                ++uv_map;
-                ++pixels_ptr;
+                    ++points_ptr;
+                    ++uv_ptr;
+                    ++pixels_ptr;
+                }
             }
+        });
+    }
+
+    namespace
+    {
+        const uint32_t no_texel_depth = 0xFFFFFFFF;
+
+        // Non-negative floats order like their bits
+        inline uint32_t depth_bits(float z)
+        {
+            uint32_t bits;
+            memcpy(&bits, &z, sizeof(bits));
+            return bits;
+        }
+
+        inline float bits_depth(uint32_t bits)
+        {
+            float z;
+            memcpy(&z, &bits, sizeof(z));
+            return z;
         }
     }
 
@@ -96,69 +124,65 @@ namespace librealsense
     // Vector of 3D [xyz] coordinates of depth_width*depth_height size
     // Vector of 2D [i,j] coordinates where the val[i,j] stores the texture coordinate (s,t) for the corresponding (i,j) pixel in depth frame
     // Algo intermediate data:
-    // Vector of depth values (floats) in size of the mapped texture (different from depth width*height) where
-    // each (i,j) cell holds the minimal Z among all the depth pixels that are mapped to the specific texel
-    void occlusion_filter::comprehensive_invalidation(float3* points, float2* uv_map, const std::vector<float2> & pix_coord) const
+    // Z-buffer in size of the mapped texture (different from depth width*height) where each (i,j) cell holds
+    // the minimal Z among all the depth pixels that are mapped to the specific texel. The minimum does not depend on
+    // the order the points are splatted in, so both passes are split among the executor threads
+    void occlusion_filter::comprehensive_invalidation(float3* points, float2* uv_map, const std::vector<float2> & pix_coord, parallel_executor& executor) const
     {
-        auto depth_points = points;
-        auto mapped_pix = pix_coord.data();
-        size_t mapped_tex_width = _texels_intrinsics->width;
-        size_t mapped_tex_height = _texels_intrinsics->height;
-        size_t points_width = _depth_intrinsics->width;
-        size_t points_height = _depth_intrinsics->height;
+        const size_t mapped_tex_width = _texels_intrinsics->width;
+        const size_t mapped_tex_height = _texels_intrinsics->height;
+        const size_t points_count = size_t(_depth_intrinsics->width) * _depth_intrinsics->height;
+        const float tex_width = float(mapped_tex_width);
+        const float tex_height = float(mapped_tex_height);
+        auto texels_depth = _texels_depth.data();
 
         static const float z_threshold = 0.05f; // Compensate for temporal noise when comparing Z values
 
+        // Index of the texel the point is mapped to, or -1 for points without depth or outside the texture
+        auto texel_of = [&](size_t i) -> ptrdiff_t
+        {
+            auto pix = pix_coord[i];
+            if (points[i].z > 0.0001f && pix.x > 0.f && pix.x < tex_width && pix.y > 0.f && pix.y < tex_height)
+                return ptrdiff_t(size_t(pix.y) * mapped_tex_width + size_t(pix.x));
+            return -1;
+        };
+
         // Clear previous data
-        memset((void*)(_texels_depth.data()), 0, _texels_depth.size() * sizeof(float));
+        executor.for_each_range(_texels_count, 1024, [&](size_t begin, size_t end)
+        {
+            for (size_t t = begin; t < end; t++)
+                texels_depth[t].store(no_texel_depth, std::memory_order_relaxed);
+        });
 
-        // Pass1 -generate texels mapping with minimal depth for each texel involved
-        for (size_t i = 0; i < points_height; i++)
+        // Pass1 - splat every point to its texel, keeping the minimal depth
+        executor.for_each_range(points_count, 1, [&](size_t begin, size_t end)
         {
-            for (size_t j = 0; j < points_width; j++)
+            for (size_t i = begin; i < end; i++)
             {
-                if ((depth_points->z > 0.0001f) &&
-                    (mapped_pix->x > 0.f) && (mapped_pix->x < mapped_tex_width) &&
-                    (mapped_pix->y > 0.f) && (mapped_pix->y < mapped_tex_height))
-                {
-                    size_t texel_index = (size_t)(mapped_pix->y)*mapped_tex_width + (size_t)(mapped_pix->x);
-
-                    if ((_texels_depth[texel_index] < 0.0001f) || ((_texels_depth[texel_index] + z_threshold) > depth_points->z))
-                    {
-                        _texels_depth[texel_index] = depth_points->z;
-                    }
-                }
-
-                ++depth_points;
-                ++mapped_pix;
+                auto texel = texel_of(i);
+                if (texel < 0)
+                    continue;
+
+                auto z = depth_bits(points[i].z);
+                auto& cell = texels_depth[texel];
+                auto current = cell.load(std::memory_order_relaxed);
+                while (z < current && !cell.compare_exchange_weak(current, z, std::memory_order_relaxed));
             }
-        }
-
-        mapped_pix = pix_coord.data();
-        depth_points = points;
-        auto uv_ptr = uv_map;
+        });
 
-        // Pass2 -invalidate depth texels with occlusion traits
-        for (size_t i = 0; i < points_height; i++)
+        // Pass2 - invalidate the points farther than the nearest point of their texel
+        executor.for_each_range(points_count, 1, [&](size_t begin, size_t end)
         {
-            for (size_t j = 0; j < points_width; j++)
+            for (size_t i = begin; i < end; i++)
             {
-                if ((depth_points->z > 0.0001f) &&
-                    (mapped_pix->x > 0.f) && (mapped_pix->x < mapped_tex_width) &&
-                    (mapped_pix->y > 0.f) && (mapped_pix->y < mapped_tex_height))
-                {
-                    size_t texel_index = (size_t)(mapped_pix->y)*mapped_tex_width + (size_t)(mapped_pix->x);
+                auto texel = texel_of(i);
+                if (texel < 0)
+                    continue;
 
-                    if ((_texels_depth[texel_index] > 0.0001f) && ((_texels_depth[texel_index] + z_threshold) < depth_points->z))
-                    {
-                        *uv_ptr = { 0.f, 0.f };
-                    }
-                }
-
-                ++depth_points;
-                ++mapped_pix;
-                ++uv_ptr;
+                auto nearest = texels_depth[texel].load(std::memory_order_relaxed);
+                if (nearest != no_texel_depth && (bits_depth(nearest) + z_threshold) < points[i].z)
+                    uv_map[i] = { 0.f, 0.f };
             }
-        }
+        });
     }
 }
@@ -3,6 +3,8 @@
 
 #pragma once
 #include "../include/librealsense2/hpp/rs_frame.hpp"
+#include "concurrency.h"
+#include "scratch-buffer.h"
 namespace librealsense
 {
     enum occlusion_rect_type : uint8_t {
@@ -20,7 +22,7 @@ namespace librealsense
 
         bool active(void) const { return (occlusion_none != _occlusion_filter); };
 
-        void process(float3* points, float2* uv_map, const std::vector<float2> & pix_coord) const;
+        void process(float3* points, float2* uv_map, const std::vector<float2> & pix_coord, parallel_executor& executor) const;
 
         void set_mode(uint8_t filter_type) { _occlusion_filter = (occlusion_rect_type)filter_type; }
 
@@ -30,13 +32,16 @@ namespace librealsense
 
         friend class pointcloud;
 
-        void monotonic_heuristic_invalidation(float3* points, float2* uv_map, const std::vector<float2> & pix_coord) const;
+        void monotonic_heuristic_invalidation(float3* points, float2* uv_map, const std::vector<float2> & pix_coord, parallel_executor& executor) const;
 
-        void comprehensive_invalidation(float3* points, float2* uv_map, const std::vector<float2> & pix_coord) const;
+        void comprehensive_invalidation(float3* points, float2* uv_map, const std::vector<float2> & pix_coord, parallel_executor& executor) const;
 
         optional_value<rs2_intrinsics>              _depth_intrinsics;
         optional_value<rs2_intrinsics>              _texels_intrinsics;
-        mutable std::vector<float>                  _texels_depth; // Temporal translation table of (mapped_x*mapped_y) holds the minimal depth value among all depth pixels mapped to that texel
+        // Z-buffer of (mapped_x*mapped_y) texels holding the minimal depth among the depth pixels mapped to each texel,
+        // as the bits of the float so the rows can take the minimum concurrently. Kept across frames
+        mutable scratch_buffer<std::atomic<uint32_t>> _texels_depth;
+        size_t                                      _texels_count = 0;
         occlusion_rect_type                         _occlusion_filter;
     };
 }
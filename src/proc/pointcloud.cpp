@@ -11,29 +11,70 @@
 #include "option.h"
 #include "environment.h"
 #include "context.h"
+#include "proc/projection.h"
 
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 
 #ifdef RS2_USE_CUDA
 #include "../cuda/cuda-pointcloud.cuh"
+#include "../cuda/cuda-device-memory.cuh"
 #endif
 #ifdef __SSSE3__
 #include <tmmintrin.h> // For SSSE3 intrinsics
 #endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h> // For NEON intrinsics
+#define RS2_NEON
+#endif
 
 
 namespace librealsense
 {
-    template<class MAP_DEPTH> void deproject_depth(float * points, const rs2_intrinsics & intrin, const uint16_t * depth, MAP_DEPTH map_depth)
+    // Subsampling of sparse pointclouds along both axes
+    const uint8_t sparse_stride_min = 1;
+    const uint8_t sparse_stride_max = 16;
+    const uint8_t sparse_stride_step = 1;
+    const uint8_t sparse_stride_def = 1;
+
+    // Changed tiles pointclouds compare the depth in square tiles of this many pixels, a multiple of the vector step
+    const size_t tile_size = 16;
+    const int tile_tolerance_min = 0;
+    const int tile_tolerance_max = 1000;
+    const int tile_tolerance_def = 10;
+
+    struct tile_rect
+    {
+        size_t x0, x1, y0, y1;
+    };
+
+    // Tiles are numbered in raster order, the ones on the right and bottom edges are cut to the image
+    tile_rect get_tile(size_t tile, size_t width, size_t height)
     {
-        for (int y = 0; y < intrin.height; ++y)
+        const size_t tiles_x = (width + tile_size - 1) / tile_size;
+        const size_t x0 = tile % tiles_x * tile_size, y0 = tile / tiles_x * tile_size;
+        return{ x0, std::min(x0 + tile_size, width), y0, std::min(y0 + tile_size, height) };
+    }
+
+    // The first multiple of the stride in [begin, end), and the number of them
+    size_t first_multiple(size_t begin, size_t stride) { return (begin + stride - 1) / stride * stride; }
+    size_t count_multiples(size_t begin, size_t end, size_t stride) { return (end + stride - 1) / stride - (begin + stride - 1) / stride; }
+
+    // Poses kept to interpolate the pose of the depth frames, a second of a 200Hz pose stream
+    const size_t max_poses = 200;
+
+    // Deprojects the pixels [begin, end) of the frame, in raster order
+    template<rs2_distortion MODEL, class MAP_DEPTH> void deproject_depth(float * points, const rs2_intrinsics & intrin, const uint16_t * depth, MAP_DEPTH map_depth,
+        size_t begin, size_t end)
+    {
+        points += begin * 3;
+        depth += begin;
+        for (size_t i = begin; i < end; ++i)
         {
-            for (int x = 0; x < intrin.width; ++x)
-            {
-                const float pixel[] = { (float)x, (float)y };
-                rs2_deproject_pixel_to_point(points, &intrin, pixel, map_depth(*depth++));
-                points += 3;
-            }
+            const float pixel[] = { (float)(i % intrin.width), (float)(i / intrin.width) };
+            deproject_pixel<MODEL>(points, intrin, pixel, map_depth(*depth++));
+            points += 3;
         }
     }
 
@@ -42,15 +83,20 @@ namespace librealsense
 #ifdef RS2_USE_CUDA
         rscuda::deproject_depth_cuda(reinterpret_cast<float *>(image), depth_intrinsics, depth_image, depth_scale);
 #else
-        deproject_depth(reinterpret_cast<float *>(image), depth_intrinsics, depth_image, [depth_scale](uint16_t z) { return depth_scale * z; });
+        auto map_depth = [depth_scale](uint16_t z) { return depth_scale * z; };
+        const size_t size = size_t(depth_intrinsics.width) * depth_intrinsics.height;
+        if (deprojection_model(depth_intrinsics.model) == RS2_DISTORTION_INVERSE_BROWN_CONRADY)
+            deproject_depth<RS2_DISTORTION_INVERSE_BROWN_CONRADY>(reinterpret_cast<float *>(image), depth_intrinsics, depth_image, map_depth, 0, size);
+        else
+            deproject_depth<RS2_DISTORTION_NONE>(reinterpret_cast<float *>(image), depth_intrinsics, depth_image, map_depth, 0, size);
 #endif
         return reinterpret_cast<float3 *>(image);
     }
 
     float3 transform(const rs2_extrinsics *extrin, const float3 &point) { float3 p = {}; rs2_transform_point_to_point(&p.x, extrin, &point.x); return p; }
-    float2 project(const rs2_intrinsics *intrin, const float3 & point) { float2 pixel = {}; rs2_project_point_to_pixel(&pixel.x, intrin, &point.x); return pixel; }
+    template<rs2_distortion MODEL>
+    float2 project(const rs2_intrinsics *intrin, const float3 & point) { float2 pixel = {}; project_point<MODEL>(&pixel.x, *intrin, &point.x); return pixel; }
     float2 pixel_to_texcoord(const rs2_intrinsics *intrin, const float2 & pixel) { return{ pixel.x / (intrin->width), pixel.y / (intrin->height) }; }
-    float2 project_to_texcoord(const rs2_intrinsics *intrin, const float3 & point) { return pixel_to_texcoord(intrin, project(intrin, point)); }
 
     void pointcloud::set_extrinsics()
     {
@@ -69,7 +115,7 @@ namespace librealsense
 
     void pointcloud::inspect_depth_frame(const rs2::frame& depth)
     {
-        if (!_output_stream || _depth_stream.get_profile().get() != depth.get_profile().get())
+        if (!_output_stream || frame_profile(_depth_stream) != frame_profile(depth))
         {
             _output_stream = depth.get_profile().as<rs2::video_stream_profile>().clone(
                 RS2_STREAM_DEPTH, depth.get_profile().stream_index(), RS2_FORMAT_XYZ32F);
@@ -77,6 +123,7 @@ namespace librealsense
             _depth_intrinsics = optional_value<rs2_intrinsics>();
             _depth_units = optional_value<float>();
             _extrinsics = optional_value<rs2_extrinsics>();
+            _depth_to_pose = optional_value<rs2_extrinsics>();
         }
 
         bool found_depth_intrinsics = false;
@@ -90,7 +137,7 @@ namespace librealsense
                 _depth_intrinsics = video.get_intrinsics();
                 _pixels_map.resize(_depth_intrinsics->height*_depth_intrinsics->width);
                 _occlusion_filter->set_depth_intrinsics(_depth_intrinsics.value());
-#ifdef __SSSE3__
+#if defined(__SSSE3__) || !defined(RS2_USE_CUDA)
                 pre_compute_x_y_map(); //compute the x and y map once for optimization
 #endif
                 found_depth_intrinsics = true;
@@ -109,12 +156,14 @@ namespace librealsense
 
     void pointcloud::inspect_other_frame(const rs2::frame& other)
     {
+        _texture = other;
+
         if (_stream_filter != _prev_stream_filter)
         {
             _prev_stream_filter = _stream_filter;
         }
 
-        if (_extrinsics.has_value() && other.get_profile().get() == _other_stream.get_profile().get())
+        if (_extrinsics.has_value() && frame_profile(other) == frame_profile(_other_stream))
             return;
 
         _other_stream = other;
@@ -134,37 +183,130 @@ namespace librealsense
         set_extrinsics();
     }
 
-    void pointcloud::pre_compute_x_y_map()
+    void pointcloud::inspect_pose_frame(const rs2::frame& pose)
+    {
+        if (!_pose_stream || frame_profile(pose) != (const rs2_stream_profile*)_pose_stream)
+        {
+            _pose_stream = pose.get_profile();
+            _depth_to_pose = optional_value<rs2_extrinsics>();
+            _poses.clear();
+        }
+
+        // Poses arriving out of order are dropped, the interpolation relies on increasing timestamps
+        auto timestamp = pose.get_timestamp();
+        if (!_poses.empty() && timestamp <= _poses.back().timestamp)
+            return;
+
+        auto data = pose.as<rs2::pose_frame>().get_pose_data();
+        _poses.push_back({ timestamp,
+            { data.translation.x, data.translation.y, data.translation.z },
+            { data.rotation.x, data.rotation.y, data.rotation.z, data.rotation.w } });
+        if (_poses.size() > max_poses)
+            _poses.pop_front();
+    }
+
+    float4 slerp(const float4& a, float4 b, float t)
+    {
+        float dot = a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
+        if (dot < 0) // q and -q are the same rotation, take the shorter way
+        {
+            b = float4{ 0, 0, 0, 0 } - b;
+            dot = -dot;
+        }
+
+        float wa = 1 - t, wb = t;
+        if (dot < 0.9995f) // Close rotations are blended linearly, the division below would lose precision
+        {
+            auto angle = std::acos(dot);
+            auto s = std::sin(angle);
+            wa = std::sin(wa * angle) / s;
+            wb = std::sin(wb * angle) / s;
+        }
+        float4 q{ a.x * wa + b.x * wb, a.y * wa + b.y * wb, a.z * wa + b.z * wb, a.w * wa + b.w * wb };
+        auto norm = std::sqrt(q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w);
+        return{ q.x / norm, q.y / norm, q.z / norm, q.w / norm };
+    }
+
+    float3x3 rotation_matrix(const float4& q)
+    {
+        return{ { 1 - 2 * (q.y * q.y + q.z * q.z), 2 * (q.x * q.y + q.z * q.w), 2 * (q.x * q.z - q.y * q.w) },
+                { 2 * (q.x * q.y - q.z * q.w), 1 - 2 * (q.x * q.x + q.z * q.z), 2 * (q.y * q.z + q.x * q.w) },
+                { 2 * (q.x * q.z + q.y * q.w), 2 * (q.y * q.z - q.x * q.w), 1 - 2 * (q.x * q.x + q.y * q.y) } };
+    }
+
+    bool pointcloud::get_world_pose(double timestamp, pose& world_from_depth)
+    {
+        if (_poses.empty())
+            return false;
+
+        // The depth and pose sensors are rigidly attached, by the calibration of the device or as registered by
+        // the application. Without extrinsics the pose sensor is taken to be the depth sensor
+        if (!_depth_to_pose)
+        {
+            rs2_extrinsics ex = identity_matrix();
+            const rs2_stream_profile* ds = _output_stream;
+            const rs2_stream_profile* ps = _pose_stream;
+            environment::get_instance().get_extrinsics_graph().try_fetch_extrinsics(*ds->profile, *ps->profile, &ex);
+            _depth_to_pose = ex;
+        }
+
+        // Depth frames outside of the poses kept take the nearest pose, poses are not extrapolated
+        auto next = std::lower_bound(_poses.begin(), _poses.end(), timestamp,
+            [](const pose_sample& p, double t) { return p.timestamp < t; });
+        pose_sample sample;
+        if (next == _poses.begin())
+            sample = _poses.front();
+        else if (next == _poses.end())
+            sample = _poses.back();
+        else
+        {
+            auto& a = *(next - 1);
+            auto& b = *next;
+            auto t = static_cast<float>((timestamp - a.timestamp) / (b.timestamp - a.timestamp));
+            sample = { timestamp, a.translation + (b.translation - a.translation) * t, slerp(a.rotation, b.rotation, t) };
+        }
+
+        pose world_from_sensor{ rotation_matrix(sample.rotation), sample.translation };
+        world_from_depth = world_from_sensor * to_pose(*_depth_to_pose);
+        return true;
+    }
+
+    void compute_ray_map(const rs2_intrinsics& intrinsics, std::vector<float>& map_x, std::vector<float>& map_y)
     {
-        _pre_compute_map_x.resize(_depth_intrinsics->width*_depth_intrinsics->height);
-        _pre_compute_map_y.resize(_depth_intrinsics->width*_depth_intrinsics->height);
+        map_x.resize(intrinsics.width*intrinsics.height);
+        map_y.resize(intrinsics.width*intrinsics.height);
 
-        for (int h = 0; h < _depth_intrinsics->height; ++h)
+        for (int h = 0; h < intrinsics.height; ++h)
         {
-            for (int w = 0; w < _depth_intrinsics->width; ++w)
+            for (int w = 0; w < intrinsics.width; ++w)
             {
                 const float pixel[] = { (float)w, (float)h };
 
-                float x = (pixel[0] - _depth_intrinsics->ppx) / _depth_intrinsics->fx;
-                float y = (pixel[1] - _depth_intrinsics->ppy) / _depth_intrinsics->fy;
+                float x = (pixel[0] - intrinsics.ppx) / intrinsics.fx;
+                float y = (pixel[1] - intrinsics.ppy) / intrinsics.fy;
 
 
-                if (_depth_intrinsics->model == RS2_DISTORTION_INVERSE_BROWN_CONRADY)
+                if (intrinsics.model == RS2_DISTORTION_INVERSE_BROWN_CONRADY)
                 {
                     float r2 = x * x + y * y;
-                    float f = 1 + _depth_intrinsics->coeffs[0] * r2 + _depth_intrinsics->coeffs[1] * r2*r2 + _depth_intrinsics->coeffs[4] * r2*r2*r2;
-                    float ux = x * f + 2 * _depth_intrinsics->coeffs[2] * x*y + _depth_intrinsics->coeffs[3] * (r2 + 2 * x*x);
-                    float uy = y * f + 2 * _depth_intrinsics->coeffs[3] * x*y + _depth_intrinsics->coeffs[2] * (r2 + 2 * y*y);
+                    float f = 1 + intrinsics.coeffs[0] * r2 + intrinsics.coeffs[1] * r2*r2 + intrinsics.coeffs[4] * r2*r2*r2;
+                    float ux = x * f + 2 * intrinsics.coeffs[2] * x*y + intrinsics.coeffs[3] * (r2 + 2 * x*x);
+                    float uy = y * f + 2 * intrinsics.coeffs[3] * x*y + intrinsics.coeffs[2] * (r2 + 2 * y*y);
                     x = ux;
                     y = uy;
                 }
 
-                _pre_compute_map_x[h*_depth_intrinsics->width + w] = x;
-                _pre_compute_map_y[h*_depth_intrinsics->width + w] = y;
+                map_x[h*intrinsics.width + w] = x;
+                map_y[h*intrinsics.width + w] = y;
             }
         }
     }
 
+    void pointcloud::pre_compute_x_y_map()
+    {
+        compute_ray_map(*_depth_intrinsics, _pre_compute_map_x, _pre_compute_map_y);
+    }
+
 #ifdef __SSSE3__
     const float3* get_points_sse(const uint16_t* depth,
         const unsigned int size,
@@ -239,12 +381,13 @@ namespace librealsense
             _mm_stream_ps(&point[20], xyz13);
             point += 24;
         }
+        // The streaming stores are weakly ordered, publish them before the range is handed back
+        _mm_sfence();
         return points;
     }
 
     void get_texture_map_sse(const float3* points,
-        const unsigned int width,
-        const unsigned int height,
+        const size_t size,
         const rs2_intrinsics &other_intrinsics,
         const rs2_extrinsics& extr,
         float2* tex_ptr,
@@ -282,7 +425,7 @@ namespace librealsense
         auto one = _mm_set_ps1(1);
         auto two = _mm_set_ps1(2);
 
-        for (auto i = 0UL; i < height*width * 3; i += 12)
+        for (size_t i = 0; i < size * 3; i += 12)
         {
             //load 4 points (x,y,z)
             auto xyz1 = _mm_load_ps(point + i);
@@ -319,7 +462,7 @@ namespace librealsense
             auto d_x = _mm_add_ps(x_f, _mm_add_ps(_mm_mul_ps(two, _mm_mul_ps(c[2], _mm_mul_ps(x_f, y_f))), r4));
 
             auto r5 = _mm_mul_ps(c[2], _mm_add_ps(r2, _mm_mul_ps(two, _mm_mul_ps(y_f, y_f))));
-            auto d_y = _mm_add_ps(y_f, _mm_add_ps(_mm_mul_ps(two, _mm_mul_ps(c[3], _mm_mul_ps(x_f, y_f))), r4));
+            auto d_y = _mm_add_ps(y_f, _mm_add_ps(_mm_mul_ps(two, _mm_mul_ps(c[3], _mm_mul_ps(x_f, y_f))), r5));
 
             auto cmp = _mm_cmpeq_ps(mask_brown_conrady, dist);
 
@@ -359,62 +502,296 @@ namespace librealsense
             _mm_stream_ps(res + 4, xyxy2);
             res += 8;
         }
+        _mm_sfence();
+    }
+
+#elif defined(RS2_NEON)
+    // ARMv7 has no vector division, refine the reciprocal estimate to full float precision instead
+    static inline float32x4_t div_f32(float32x4_t a, float32x4_t b)
+    {
+#if defined(__aarch64__)
+        return vdivq_f32(a, b);
+#else
+        auto inv = vrecpeq_f32(b);
+        inv = vmulq_f32(inv, vrecpsq_f32(b, inv));
+        inv = vmulq_f32(inv, vrecpsq_f32(b, inv));
+        return vmulq_f32(a, inv);
+#endif
+    }
+
+    const float3* get_points_neon(const uint16_t* depth,
+        const unsigned int size,
+        float* pre_compute_x,
+        float* pre_compute_y,
+        float depth_scale,
+        float3* points)
+    {
+        auto point = reinterpret_cast<float*>(points);
+
+        auto scale = vdupq_n_f32(depth_scale);
+
+        auto mapx = pre_compute_x;
+        auto mapy = pre_compute_y;
+
+        for (unsigned int i = 0; i < size; i += 8)
+        {
+            auto x0 = vld1q_f32(mapx + i);
+            auto x1 = vld1q_f32(mapx + i + 4);
+
+            auto y0 = vld1q_f32(mapy + i);
+            auto y1 = vld1q_f32(mapy + i + 4);
+
+            //split the depth pixels to 2 registers of 4 floats each
+            auto d = vld1q_u16(depth + i);
+            auto depth0 = vmulq_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(d))), scale);
+            auto depth1 = vmulq_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(d))), scale);
+
+            //interleave and store 8 points of x y z
+            float32x4x3_t xyz0 = { { vmulq_f32(depth0, x0), vmulq_f32(depth0, y0), depth0 } };
+            float32x4x3_t xyz1 = { { vmulq_f32(depth1, x1), vmulq_f32(depth1, y1), depth1 } };
+            vst3q_f32(&point[0], xyz0);
+            vst3q_f32(&point[12], xyz1);
+            point += 24;
+        }
+        return points;
     }
 
+    void get_texture_map_neon(const float3* points,
+        const size_t size,
+        const rs2_intrinsics &other_intrinsics,
+        const rs2_extrinsics& extr,
+        float2* tex_ptr,
+        float2* pixels_ptr)
+    {
+        auto point = reinterpret_cast<const float*>(points);
+        auto res = reinterpret_cast<float*>(tex_ptr);
+        auto res1 = reinterpret_cast<float*>(pixels_ptr);
+
+        float32x4_t r[9];
+        float32x4_t t[3];
+        float32x4_t c[5];
+
+        for (int i = 0; i < 9; ++i)
+        {
+            r[i] = vdupq_n_f32(extr.rotation[i]);
+        }
+        for (int i = 0; i < 3; ++i)
+        {
+            t[i] = vdupq_n_f32(extr.translation[i]);
+        }
+        for (int i = 0; i < 5; ++i)
+        {
+            c[i] = vdupq_n_f32(other_intrinsics.coeffs[i]);
+        }
+
+        auto fx = vdupq_n_f32(other_intrinsics.fx);
+        auto fy = vdupq_n_f32(other_intrinsics.fy);
+        auto ppx = vdupq_n_f32(other_intrinsics.ppx);
+        auto ppy = vdupq_n_f32(other_intrinsics.ppy);
+        auto w = vdupq_n_f32(other_intrinsics.width);
+        auto h = vdupq_n_f32(other_intrinsics.height);
+        auto zero = vdupq_n_f32(0);
+        auto one = vdupq_n_f32(1);
+        auto two = vdupq_n_f32(2);
+        bool brown_conrady = other_intrinsics.model == RS2_DISTORTION_MODIFIED_BROWN_CONRADY;
+
+        for (size_t i = 0; i < size * 3; i += 12)
+        {
+            //load and gather 4 points (x,y,z)
+            auto xyz = vld3q_f32(point + i);
+            auto x = xyz.val[0];
+            auto y = xyz.val[1];
+            auto z = xyz.val[2];
+
+            auto p_x = vaddq_f32(vmulq_f32(r[0], x), vaddq_f32(vmulq_f32(r[3], y), vaddq_f32(vmulq_f32(r[6], z), t[0])));
+            auto p_y = vaddq_f32(vmulq_f32(r[1], x), vaddq_f32(vmulq_f32(r[4], y), vaddq_f32(vmulq_f32(r[7], z), t[1])));
+            auto p_z = vaddq_f32(vmulq_f32(r[2], x), vaddq_f32(vmulq_f32(r[5], y), vaddq_f32(vmulq_f32(r[8], z), t[2])));
+
+            p_x = div_f32(p_x, p_z);
+            p_y = div_f32(p_y, p_z);
+
+            if (brown_conrady)
+            {
+                auto r2 = vaddq_f32(vmulq_f32(p_x, p_x), vmulq_f32(p_y, p_y));
+                auto r3 = vaddq_f32(vmulq_f32(c[1], vmulq_f32(r2, r2)), vmulq_f32(c[4], vmulq_f32(r2, vmulq_f32(r2, r2))));
+                auto f = vaddq_f32(one, vaddq_f32(vmulq_f32(c[0], r2), r3));
+
+                auto x_f = vmulq_f32(p_x, f);
+                auto y_f = vmulq_f32(p_y, f);
+
+                auto r4 = vmulq_f32(c[3], vaddq_f32(r2, vmulq_f32(two, vmulq_f32(x_f, x_f))));
+                p_x = vaddq_f32(x_f, vaddq_f32(vmulq_f32(two, vmulq_f32(c[2], vmulq_f32(x_f, y_f))), r4));
+
+                auto r5 = vmulq_f32(c[2], vaddq_f32(r2, vmulq_f32(two, vmulq_f32(y_f, y_f))));
+                p_y = vaddq_f32(y_f, vaddq_f32(vmulq_f32(two, vmulq_f32(c[3], vmulq_f32(x_f, y_f))), r5));
+            }
+
+            //TODO: add handle to RS2_DISTORTION_FTHETA
+
+            //zero the x and y if z is zero
+            auto cmp = vmvnq_u32(vceqq_f32(z, zero));
+            float32x4x2_t uv;
+            uv.val[0] = vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(vaddq_f32(vmulq_f32(p_x, fx), ppx)), cmp));
+            uv.val[1] = vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(vaddq_f32(vmulq_f32(p_y, fy), ppy)), cmp));
+
+            //interleave the x y before normalize and store in pixels_ptr
+            vst2q_f32(res1, uv);
+            res1 += 8;
+
+            //normalize x and y, then store in tex_ptr
+            uv.val[0] = div_f32(uv.val[0], w);
+            uv.val[1] = div_f32(uv.val[1], h);
+            vst2q_f32(res, uv);
+            res += 8;
+        }
+    }
 #endif
 
+    // Same as the vector versions, for builds without them
+    void get_points(const uint16_t* depth,
+        const size_t size,
+        const float* pre_compute_x,
+        const float* pre_compute_y,
+        float depth_scale,
+        float3* points)
+    {
+        for (size_t i = 0; i < size; ++i)
+        {
+            const float z = depth_scale * depth[i];
+            points[i] = { z * pre_compute_x[i], z * pre_compute_y[i], z };
+        }
+    }
+
+    template<rs2_distortion MODEL>
     void get_texture_map(const float3* points,
-        const unsigned int width,
-        const unsigned int height,
+        const size_t size,
         const rs2_intrinsics &other_intrinsics,
         const rs2_extrinsics& extr,
         float2* tex_ptr,
         float2* pixels_ptr)
     {
-        for (unsigned int y = 0; y < height; ++y)
+        for (size_t i = 0; i < size; ++i)
         {
-            for (unsigned int x = 0; x < width; ++x)
+            if (points->z)
             {
-                if (points->z)
-                {
-                    auto trans = transform(&extr, *points);
-                    //auto tex_xy = project_to_texcoord(&mapped_intr, trans);
-                    // Store intermediate results for poincloud filters
-                    *pixels_ptr = project(&other_intrinsics, trans);
-                    auto tex_xy = pixel_to_texcoord(&other_intrinsics, *pixels_ptr);
+                auto trans = transform(&extr, *points);
+                // Store intermediate results for poincloud filters
+                *pixels_ptr = project<MODEL>(&other_intrinsics, trans);
+                auto tex_xy = pixel_to_texcoord(&other_intrinsics, *pixels_ptr);
 
-                    *tex_ptr = tex_xy;
-                }
-                else
-                {
-                    *tex_ptr = { 0.f, 0.f };
-                    *pixels_ptr = { 0.f, 0.f };
-                }
-                ++points;
-                ++tex_ptr;
-                ++pixels_ptr;
+                *tex_ptr = tex_xy;
             }
+            else
+            {
+                *tex_ptr = { 0.f, 0.f };
+                *pixels_ptr = { 0.f, 0.f };
+            }
+            ++points;
+            ++tex_ptr;
+            ++pixels_ptr;
         }
     }
 
-    rs2::frame pointcloud::process_depth_frame(const rs2::frame_source& source, const rs2::depth_frame& depth)
+    // The texture distortion model is tested once per range instead of once per point
+    void get_texture_map(const float3* points,
+        const size_t size,
+        const rs2_intrinsics &other_intrinsics,
+        const rs2_extrinsics& extr,
+        float2* tex_ptr,
+        float2* pixels_ptr)
     {
-        auto res = source.allocate_points(_output_stream, depth);
-        auto pframe = (librealsense::points*)(res.get());
+        switch (projection_model(other_intrinsics.model))
+        {
+        case RS2_DISTORTION_MODIFIED_BROWN_CONRADY:
+            get_texture_map<RS2_DISTORTION_MODIFIED_BROWN_CONRADY>(points, size, other_intrinsics, extr, tex_ptr, pixels_ptr);
+            break;
+        case RS2_DISTORTION_FTHETA:
+            get_texture_map<RS2_DISTORTION_FTHETA>(points, size, other_intrinsics, extr, tex_ptr, pixels_ptr);
+            break;
+        default:
+            get_texture_map<RS2_DISTORTION_NONE>(points, size, other_intrinsics, extr, tex_ptr, pixels_ptr);
+            break;
+        }
+    }
 
-        auto depth_data = (const uint16_t*)depth.get_data();
+    // A texture of 8 bits per channel, the offsets of the channels of each pixel follow from its format
+    struct color_texture
+    {
+        const uint8_t* data;
+        int width, height, stride, bpp;
+        int r, g, b;
+    };
 
-        const float3* points;
-#ifdef __SSSE3__
-        points = get_points_sse(depth_data, _depth_intrinsics->height*_depth_intrinsics->width, _pre_compute_map_x.data(), _pre_compute_map_y.data(), *_depth_units, pframe->get_vertices());
-#else
-        points = depth_to_points((uint8_t*)pframe->get_vertices(), *_depth_intrinsics, depth_data, *_depth_units);
-#endif
+    bool get_color_texture(const rs2::frame& frame, color_texture& texture)
+    {
+        auto video = frame.as<rs2::video_frame>();
+        if (!video)
+            return false;
+        switch (video.get_profile().format())
+        {
+        case RS2_FORMAT_RGB8:  texture = { nullptr, 0, 0, 0, 3, 0, 1, 2 }; break;
+        case RS2_FORMAT_BGR8:  texture = { nullptr, 0, 0, 0, 3, 2, 1, 0 }; break;
+        case RS2_FORMAT_RGBA8: texture = { nullptr, 0, 0, 0, 4, 0, 1, 2 }; break;
+        case RS2_FORMAT_BGRA8: texture = { nullptr, 0, 0, 0, 4, 2, 1, 0 }; break;
+        case RS2_FORMAT_Y8:    texture = { nullptr, 0, 0, 0, 1, 0, 0, 0 }; break;
+        default: return false;
+        }
+        texture.data = static_cast<const uint8_t*>(video.get_data());
+        texture.width = video.get_width();
+        texture.height = video.get_height();
+        texture.stride = video.get_stride_in_bytes();
+        return texture.width > 0 && texture.height > 0;
+    }
 
-        auto vid_frame = depth.as<rs2::video_frame>();
-        float2* tex_ptr = pframe->get_texture_coordinates();
-        // Pixels calculated in the mapped texture. Used in post-processing filters
-        float2* pixels_ptr = _pixels_map.data();
+    // Blends the four texture pixels around the texture coordinate of each vertex. Vertices without depth or
+    // outside of the texture are black. Texture coordinates span the pixel edges, the pixels sit at their centers
+    void get_vertex_colors(const float3* points, const float2* tex_ptr, size_t size, const color_texture& texture, uint8_t* rgb)
+    {
+        const float max_x = float(texture.width - 1), max_y = float(texture.height - 1);
+        for (size_t i = 0; i < size; ++i, rgb += 3)
+        {
+            float x = tex_ptr[i].x * texture.width - 0.5f;
+            float y = tex_ptr[i].y * texture.height - 0.5f;
+            // Written so that NaN coordinates fail the test as well
+            if (!points[i].z || !(x >= -0.5f && x <= max_x + 0.5f && y >= -0.5f && y <= max_y + 0.5f))
+            {
+                rgb[0] = rgb[1] = rgb[2] = 0;
+                continue;
+            }
+            x = std::min(std::max(x, 0.f), max_x);
+            y = std::min(std::max(y, 0.f), max_y);
+
+            const int x0 = int(x), y0 = int(y);
+            const int x1 = std::min(x0 + 1, texture.width - 1), y1 = std::min(y0 + 1, texture.height - 1);
+            const float fx = x - x0, fy = y - y0;
+            const float w00 = (1 - fx) * (1 - fy), w01 = fx * (1 - fy), w10 = (1 - fx) * fy, w11 = fx * fy;
+
+            auto top = texture.data + size_t(y0) * texture.stride;
+            auto bottom = texture.data + size_t(y1) * texture.stride;
+            auto p00 = top + x0 * texture.bpp, p01 = top + x1 * texture.bpp;
+            auto p10 = bottom + x0 * texture.bpp, p11 = bottom + x1 * texture.bpp;
+
+            const int channels[] = { texture.r, texture.g, texture.b };
+            for (int c = 0; c < 3; ++c)
+            {
+                auto k = channels[c];
+                rgb[c] = uint8_t(w00 * p00[k] + w01 * p01[k] + w10 * p10[k] + w11 * p11[k] + 0.5f);
+            }
+        }
+    }
+
+    // Moves the vertices with depth to the world frame, the vertices without depth stay at the origin
+    void transform_points(float3* points, size_t size, const pose& world)
+    {
+        for (size_t i = 0; i < size; ++i)
+        {
+            if (points[i].z)
+                points[i] = world * points[i];
+        }
+    }
+
+    rs2::frame pointcloud::process_depth_frame(const rs2::frame_source& source, const rs2::depth_frame& depth)
+    {
         rs2_intrinsics mapped_intr;
         rs2_extrinsics extr;
         bool map_texture = false;
@@ -427,26 +804,283 @@ namespace librealsense
             }
         }
 
-        if (map_texture)
+        // Colors are only sampled from textures of the size the texture coordinates were mapped in
+        color_texture texture;
+        const bool colored = _vertex_colors && map_texture && get_color_texture(_texture, texture) &&
+            texture.width == mapped_intr.width && texture.height == mapped_intr.height;
+
+        const bool sparse = _sparse_mode != sparse_pointcloud_off;
+        const bool tiled = _sparse_mode == sparse_pointcloud_changed_tiles;
+        rs2::frame res;
+        if (sparse || colored)
+        {
+            // The public allocation has no room for the pixel indices or colors, go through the internal source
+            auto profile = std::dynamic_pointer_cast<stream_profile_interface>(_output_stream.get()->profile->shared_from_this());
+            res = rs2::frame((rs2_frame*)source._source->source->allocate_points(profile, (frame_interface*)depth.get(),
+                _sparse_mode == sparse_pointcloud_valid_with_indices || tiled, colored));
+        }
+        else
+            res = source.allocate_points(_output_stream, depth);
+        auto pframe = (librealsense::points*)(res.get());
+
+        const size_t size = size_t(_depth_intrinsics->height) * _depth_intrinsics->width;
+        float3* points = sparse ? _dense_vertices.get(size) : pframe->get_vertices();
+        float2* tex_ptr = sparse ? _dense_texcoords.get(size) : pframe->get_texture_coordinates();
+        uint8_t* colors = !colored ? nullptr : sparse ? _dense_colors.get(size * 3) : pframe->get_vertex_colors();
+        // Pixels calculated in the mapped texture. Used in post-processing filters
+        float2* pixels_ptr = _pixels_map.data();
+        // The occlusion filter invalidates texture coordinates of the whole frame, the colors then wait for it
+        const bool occlusion = map_texture && _occlusion_filter->active();
+
+        // Dense vertices move to the world frame as soon as they are textured, sparse ones as they are compacted
+        pose world_pose;
+        const bool world = _world_frame && get_world_pose(depth.get_timestamp(), world_pose);
+
+#if !defined(__SSSE3__) && defined(RS2_USE_CUDA)
+        // The GPU deprojects the whole frame at once, from the device copy when the depth was produced on the GPU
+        if (auto depth_memory = std::dynamic_pointer_cast<rscuda::cuda_device_memory>(((frame_interface*)depth.get())->get_device_memory()))
+            rscuda::deproject_device_depth_cuda(reinterpret_cast<float*>(points), *_depth_intrinsics,
+                static_cast<const uint16_t*>(depth_memory->get()), *_depth_units);
+        else
+            depth_to_points((uint8_t*)points, *_depth_intrinsics, (const uint16_t*)depth.get_data(), *_depth_units);
+#else
+        auto depth_data = (const uint16_t*)depth.get_data();
+#endif
+
+        if (tiled)
+            find_changed_tiles((const uint16_t*)depth.get_data());
+
+        auto compute = [&](size_t begin, size_t end)
         {
-            auto height = vid_frame.get_height();
-            auto width = vid_frame.get_width();
+#if defined(__SSSE3__)
+            get_points_sse(depth_data + begin, unsigned(end - begin), _pre_compute_map_x.data() + begin, _pre_compute_map_y.data() + begin,
+                *_depth_units, points + begin);
+#elif defined(RS2_NEON) && !defined(RS2_USE_CUDA)
+            get_points_neon(depth_data + begin, unsigned(end - begin), _pre_compute_map_x.data() + begin, _pre_compute_map_y.data() + begin,
+                *_depth_units, points + begin);
+#elif !defined(RS2_USE_CUDA)
+            get_points(depth_data + begin, end - begin, _pre_compute_map_x.data() + begin, _pre_compute_map_y.data() + begin,
+                *_depth_units, points + begin);
+#endif
 
+            if (map_texture)
+            {
 #ifdef __SSSE3__
-            get_texture_map_sse(points, width, height, mapped_intr, extr, tex_ptr, pixels_ptr);
+                get_texture_map_sse(points + begin, end - begin, mapped_intr, extr, tex_ptr + begin, pixels_ptr + begin);
+#elif defined(RS2_NEON)
+                get_texture_map_neon(points + begin, end - begin, mapped_intr, extr, tex_ptr + begin, pixels_ptr + begin);
 #else
-            get_texture_map(points, width, height, mapped_intr, extr, tex_ptr, pixels_ptr);
+                get_texture_map(points + begin, end - begin, mapped_intr, extr, tex_ptr + begin, pixels_ptr + begin);
 #endif
+                // Sampled while the range is still in cache, instead of a second pass over the frame
+                if (colors && !occlusion)
+                    get_vertex_colors(points + begin, tex_ptr + begin, end - begin, texture, colors + begin * 3);
+            }
+
+            if (world && !sparse && !occlusion)
+                transform_points(points + begin, end - begin, world_pose);
+        };
 
-            if (_occlusion_filter->active())
+        // Only the changed tiles are computed, by rows of a tile, when the rows of every tile start on a vector
+        // step. The occlusion filter needs the texture coordinates of the whole frame
+        const size_t width = _depth_intrinsics->width;
+        if (tiled && !occlusion && width % 8 == 0)
+        {
+            _executor.for_each(_changed_tiles.size(), [&](size_t t)
             {
-                _occlusion_filter->process(pframe->get_vertices(), pframe->get_texture_coordinates(), _pixels_map);
+                auto tile = get_tile(_changed_tiles[t], width, _depth_intrinsics->height);
+                for (size_t y = tile.y0; y < tile.y1; ++y)
+                    compute(y * width + tile.x0, y * width + tile.x1);
+            });
+        }
+        else
+        {
+            // Every pixel is independent; the ranges are kept multiples of the 8-pixel vector step
+            _executor.for_each_range(size, 8, compute);
+        }
+
+        if (occlusion)
+        {
+            _occlusion_filter->process(points, tex_ptr, _pixels_map, _executor);
+            if (colors || (world && !sparse))
+            {
+                _executor.for_each_range(size, 8, [&](size_t begin, size_t end)
+                {
+                    if (colors)
+                        get_vertex_colors(points + begin, tex_ptr + begin, end - begin, texture, colors + begin * 3);
+                    if (world && !sparse)
+                        transform_points(points + begin, end - begin, world_pose);
+                });
             }
         }
+
+        if (tiled)
+            compact_tiles(pframe, points, tex_ptr, colors, map_texture, world ? &world_pose : nullptr);
+        else if (sparse)
+            compact_points(pframe, points, tex_ptr, colors, map_texture, world ? &world_pose : nullptr);
         return res;
     }
 
+    void pointcloud::find_changed_tiles(const uint16_t* depth)
+    {
+        const size_t width = _depth_intrinsics->width, height = _depth_intrinsics->height;
+        const size_t tiles = ((width + tile_size - 1) / tile_size) * ((height + tile_size - 1) / tile_size);
+
+        // A new resolution starts over with all of the tiles
+        if (_tile_reference.size() != width * height)
+        {
+            _tile_reference.assign(width * height, 0);
+            _refresh_tiles = true;
+        }
+        _tile_changed.resize(tiles);
+        const bool all = _refresh_tiles;
+        _refresh_tiles = false;
+
+        // A tile changes when a pixel gains or loses depth, or moves by more than the tolerance. The depth it is
+        // compared to is the one of the last output of the tile, so that slow drifts are output as well
+        _executor.for_each(tiles, [&](size_t t)
+        {
+            auto tile = get_tile(t, width, height);
+            bool changed = all;
+            for (size_t y = tile.y0; y < tile.y1 && !changed; ++y)
+            {
+                const uint16_t* cur = depth + y * width;
+                const uint16_t* ref = _tile_reference.data() + y * width;
+                for (size_t x = tile.x0; x < tile.x1; ++x)
+                {
+                    if (!cur[x] != !ref[x] || std::abs(int(cur[x]) - int(ref[x])) > _tile_tolerance)
+                    {
+                        changed = true;
+                        break;
+                    }
+                }
+            }
+            if (changed)
+            {
+                for (size_t y = tile.y0; y < tile.y1; ++y)
+                    memcpy(_tile_reference.data() + y * width + tile.x0, depth + y * width + tile.x0, (tile.x1 - tile.x0) * sizeof(uint16_t));
+            }
+            _tile_changed[t] = changed;
+        });
+
+        _changed_tiles.clear();
+        for (size_t t = 0; t < tiles; ++t)
+        {
+            if (_tile_changed[t])
+                _changed_tiles.push_back(t);
+        }
+    }
+
+    // Outputs every sampled pixel of the changed tiles, tile after tile, with its pixel index. The pixels without
+    // depth stay at the origin, so that the receiver knows to erase the vertices it had for them
+    void pointcloud::compact_tiles(librealsense::points* pframe, const float3* vertices, const float2* texcoords,
+        const uint8_t* colors, bool textured, const pose* world)
+    {
+        const size_t width = _depth_intrinsics->width, height = _depth_intrinsics->height;
+        const size_t stride = _sparse_stride;
+        const size_t tiles = _changed_tiles.size();
+
+        auto tile_offsets = _sparse_row_offsets.get(tiles + 1);
+        tile_offsets[0] = 0;
+        for (size_t t = 0; t < tiles; ++t)
+        {
+            auto tile = get_tile(_changed_tiles[t], width, height);
+            tile_offsets[t + 1] = tile_offsets[t] + count_multiples(tile.x0, tile.x1, stride) * count_multiples(tile.y0, tile.y1, stride);
+        }
+
+        auto out_vertices = pframe->get_vertices();
+        auto out_texcoords = pframe->get_texture_coordinates();
+        auto out_indices = pframe->get_pixel_indices();
+        auto out_colors = pframe->get_vertex_colors();
+        _executor.for_each(tiles, [&](size_t t)
+        {
+            auto tile = get_tile(_changed_tiles[t], width, height);
+            size_t out = tile_offsets[t];
+            for (size_t y = first_multiple(tile.y0, stride); y < tile.y1; y += stride)
+            {
+                for (size_t x = first_multiple(tile.x0, stride); x < tile.x1; x += stride)
+                {
+                    const size_t i = y * width + x;
+                    out_vertices[out] = world && vertices[i].z ? *world * vertices[i] : vertices[i];
+                    out_texcoords[out] = textured ? texcoords[i] : float2{ 0.f, 0.f };
+                    out_indices[out] = static_cast<int>(i);
+                    if (out_colors)
+                        memcpy(out_colors + out * 3, colors + i * 3, 3);
+                    ++out;
+                }
+            }
+        });
+
+        pframe->set_vertex_count(tile_offsets[tiles]);
+    }
+
+    void pointcloud::refresh_tiles()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _refresh_tiles = true;
+    }
+
+    void pointcloud::compact_points(librealsense::points* pframe, const float3* vertices, const float2* texcoords,
+        const uint8_t* colors, bool textured, const pose* world)
+    {
+        const size_t width = _depth_intrinsics->width;
+        const size_t stride = _sparse_stride;
+        const size_t rows = (_depth_intrinsics->height + stride - 1) / stride;
+
+        // Count the valid vertices of each sampled row, then every row knows where its output starts
+        auto row_offsets = _sparse_row_offsets.get(rows + 1);
+        row_offsets[0] = 0;
+        _executor.for_each_range(rows, 1, [&](size_t begin, size_t end)
+        {
+            for (size_t r = begin; r < end; ++r)
+            {
+                size_t count = 0;
+                auto row = vertices + r * stride * width;
+                for (size_t x = 0; x < width; x += stride)
+                    count += (row[x].z != 0);
+                row_offsets[r + 1] = count;
+            }
+        });
+        for (size_t r = 0; r < rows; ++r)
+            row_offsets[r + 1] += row_offsets[r];
+
+        auto out_vertices = pframe->get_vertices();
+        auto out_texcoords = pframe->get_texture_coordinates();
+        auto out_indices = pframe->get_pixel_indices();
+        auto out_colors = pframe->get_vertex_colors();
+        _executor.for_each_range(rows, 1, [&](size_t begin, size_t end)
+        {
+            for (size_t r = begin; r < end; ++r)
+            {
+                size_t out = row_offsets[r];
+                size_t first = r * stride * width;
+                for (size_t i = first; i < first + width; i += stride)
+                {
+                    if (!vertices[i].z)
+                        continue;
+                    out_vertices[out] = world ? *world * vertices[i] : vertices[i];
+                    out_texcoords[out] = textured ? texcoords[i] : float2{ 0.f, 0.f };
+                    if (out_indices)
+                        out_indices[out] = static_cast<int>(i);
+                    if (out_colors)
+                        memcpy(out_colors + out * 3, colors + i * 3, 3);
+                    ++out;
+                }
+            }
+        });
+
+        pframe->set_vertex_count(row_offsets[rows]);
+    }
+
     pointcloud::pointcloud()
+        : _sparse_mode(sparse_pointcloud_off),
+        _vertex_colors(0),
+        _world_frame(0),
+        _processing_threads(processing_threads_default),
+        _executor(processing_threads_default),
+        _sparse_stride(sparse_stride_def),
+        _tile_tolerance(tile_tolerance_def),
+        _refresh_tiles(true)
     {
         _occlusion_filter = std::make_shared<occlusion_filter>();
 
@@ -470,6 +1104,100 @@ namespace librealsense
         occlusion_invalidation->set_description(1.f, "Heuristic");
         occlusion_invalidation->set_description(2.f, "Exhaustive");
         register_option(RS2_OPTION_FILTER_MAGNITUDE, occlusion_invalidation);
+
+        register_processing_threads_option(*this, _processing_threads, _executor, _mutex,
+            "Number of threads used to compute each pointcloud, 0 for all hardware threads", "pointcloud");
+
+        auto sparse_mode = std::make_shared<ptr_option<uint8_t>>(
+            sparse_pointcloud_off,
+            sparse_pointcloud_max - 1, 1,
+            sparse_pointcloud_off,
+            &_sparse_mode, "Emit only the valid vertices");
+        sparse_mode->set_description(sparse_pointcloud_off, "Off");
+        sparse_mode->set_description(sparse_pointcloud_valid, "Valid vertices");
+        sparse_mode->set_description(sparse_pointcloud_valid_with_indices, "Valid vertices with pixel indices");
+        sparse_mode->set_description(sparse_pointcloud_changed_tiles, "Changed tiles with pixel indices");
+        sparse_mode->on_set([this, sparse_mode](float val)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+
+            if (!sparse_mode->is_valid(val))
+                throw invalid_value_exception(to_string()
+                    << "Unsupported sparse pointcloud mode " << val << " is out of range.");
+
+            _sparse_mode = static_cast<uint8_t>(val);
+            _refresh_tiles = true;
+        });
+        register_option(RS2_OPTION_SPARSE_POINTCLOUD, sparse_mode);
+
+        auto sparse_stride = std::make_shared<ptr_option<uint8_t>>(
+            sparse_stride_min,
+            sparse_stride_max,
+            sparse_stride_step,
+            sparse_stride_def,
+            &_sparse_stride, "Keep one pixel in this many along each axis of a sparse pointcloud");
+        sparse_stride->on_set([this, sparse_stride](float val)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+
+            if (!sparse_stride->is_valid(val))
+                throw invalid_value_exception(to_string()
+                    << "Unsupported sparse pointcloud stride " << val << " is out of range.");
+
+            _sparse_stride = static_cast<uint8_t>(val);
+            _refresh_tiles = true;
+        });
+        register_option(RS2_OPTION_POINTCLOUD_STRIDE, sparse_stride);
+
+        auto tile_tolerance = std::make_shared<ptr_option<int>>(
+            tile_tolerance_min,
+            tile_tolerance_max,
+            1,
+            tile_tolerance_def,
+            &_tile_tolerance, "Largest depth change in depth units a tile of a changed tiles pointcloud is not output for");
+        tile_tolerance->on_set([this, tile_tolerance](float val)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+
+            if (!tile_tolerance->is_valid(val))
+                throw invalid_value_exception(to_string()
+                    << "Unsupported pointcloud tile tolerance " << val << " is out of range.");
+
+            _tile_tolerance = static_cast<int>(val);
+        });
+        register_option(RS2_OPTION_POINTCLOUD_TILE_TOLERANCE, tile_tolerance);
+
+        auto vertex_colors = std::make_shared<ptr_option<uint8_t>>(0, 1, 1, 0,
+            &_vertex_colors, "Sample the color of every vertex from the mapped texture");
+        vertex_colors->on_set([this, vertex_colors](float val)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+
+            if (!vertex_colors->is_valid(val))
+                throw invalid_value_exception(to_string()
+                    << "Unsupported pointcloud colors mode " << val << " is out of range.");
+
+            _vertex_colors = static_cast<uint8_t>(val);
+            _refresh_tiles = true;
+        });
+        register_option(RS2_OPTION_POINTCLOUD_COLORS, vertex_colors);
+
+        auto world_frame = std::make_shared<ptr_option<uint8_t>>(0, 1, 1, 0,
+            &_world_frame, "Output the vertices in the world frame of the pose frames passed to the pointcloud");
+        world_frame->on_set([this, world_frame](float val)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+
+            if (!world_frame->is_valid(val))
+                throw invalid_value_exception(to_string()
+                    << "Unsupported pointcloud world frame mode " << val << " is out of range.");
+
+            _world_frame = static_cast<uint8_t>(val);
+            _refresh_tiles = true;
+            if (!_world_frame)
+                _poses.clear();
+        });
+        register_option(RS2_OPTION_POINTCLOUD_WORLD_FRAME, world_frame);
     }
 
     bool pointcloud::should_process(const rs2::frame& frame)
@@ -497,6 +1225,9 @@ namespace librealsense
             if (frame.get_profile().stream_type() == RS2_STREAM_DEPTH && frame.get_profile().format() == RS2_FORMAT_Z16)
                 return true;
 
+            if (_world_frame && frame.is<rs2::pose_frame>())
+                return true;
+
             auto p = frame.get_profile();
             if (p.stream_type() == _stream_filter.stream && p.format() == _stream_filter.format && p.stream_index() == _stream_filter.index)
                 return true;
@@ -521,12 +1252,23 @@ namespace librealsense
             auto texture = composite.first(_stream_filter.stream);
             inspect_other_frame(texture);
 
+            if (_world_frame)
+            {
+                if (auto pose = composite.first_or_default(RS2_STREAM_POSE))
+                    inspect_pose_frame(pose);
+            }
+
             auto depth = composite.first(RS2_STREAM_DEPTH, RS2_FORMAT_Z16);
             inspect_depth_frame(depth);
             rv = process_depth_frame(source, depth);
         }
         else
         {
+            if (f.is<rs2::pose_frame>())
+            {
+                inspect_pose_frame(f);
+                return rv;
+            }
             if (f.is<rs2::depth_frame>())
             {
                 inspect_depth_frame(f);
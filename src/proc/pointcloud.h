@@ -3,18 +3,46 @@
 
 #pragma once
 #include "../include/librealsense2/hpp/rs_frame.hpp"
+#include "concurrency.h"
+#include "scratch-buffer.h"
+
+#include <deque>
+
 namespace librealsense
 {
     class occlusion_filter;
+    class points;
+
+    // Spherical interpolation of unit quaternions, and the rotation of a unit quaternion, shared with the TSDF integrator
+    float4 slerp(const float4& a, float4 b, float t);
+    float3x3 rotation_matrix(const float4& q);
+
+    // The ray of every depth pixel at a depth of 1, undistorted, as the x and y it deprojects to. Shared with the height map
+    void compute_ray_map(const rs2_intrinsics& intrinsics, std::vector<float>& map_x, std::vector<float>& map_y);
+
+    enum sparse_pointcloud_types : uint8_t
+    {
+        sparse_pointcloud_off,
+        sparse_pointcloud_valid,
+        sparse_pointcloud_valid_with_indices,
+        sparse_pointcloud_changed_tiles,
+        sparse_pointcloud_max
+    };
 
     class pointcloud : public stream_filter_processing_block
     {
     public:
         pointcloud();
+
+        // The next frame of a changed tiles pointcloud outputs all of its tiles
+        void refresh_tiles();
     protected:
         bool should_process(const rs2::frame& frame) override;
         rs2::frame process_frame(const rs2::frame_source& source, const rs2::frame& f) override;
-    private:
+
+        // Overridden by implementations that compute the points outside of the host
+        virtual rs2::frame process_depth_frame(const rs2::frame_source& source, const rs2::depth_frame& depth);
+
         optional_value<rs2_intrinsics>         _depth_intrinsics;
         optional_value<rs2_intrinsics>         _other_intrinsics;
         optional_value<float>                  _depth_units;
@@ -27,16 +55,59 @@ namespace librealsense
         rs2::stream_profile _output_stream;
         rs2::frame _other_stream;
         rs2::frame _depth_stream;
+        rs2::frame _texture; // The newest frame of the mapped stream, the colors are sampled from
+
+        uint8_t _sparse_mode; // sparse_pointcloud_types
+        uint8_t _vertex_colors;
+        uint8_t _world_frame;
 
+    private:
         void inspect_depth_frame(const rs2::frame& depth);
         void inspect_other_frame(const rs2::frame& other);
-        rs2::frame process_depth_frame(const rs2::frame_source& source, const rs2::depth_frame& depth);
+        void inspect_pose_frame(const rs2::frame& pose);
         void set_extrinsics();
+        // The transform from the depth sensor to the world frame at the timestamp, false before the first pose
+        bool get_world_pose(double timestamp, pose& world_from_depth);
+
+        // The newest poses in arrival order, the pose of a depth frame is interpolated between the two around it
+        struct pose_sample
+        {
+            double timestamp;
+            float3 translation;
+            float4 rotation;
+        };
+        std::deque<pose_sample> _poses;
+        rs2::stream_profile _pose_stream;
+        optional_value<rs2_extrinsics> _depth_to_pose;
 
         std::vector<float> _pre_compute_map_x;
         std::vector<float> _pre_compute_map_y;
 
         void pre_compute_x_y_map();
         stream_filter _prev_stream_filter;
+
+        uint8_t _processing_threads;
+        parallel_executor _executor;
+
+        // Sparse output is computed densely into these buffers, then the valid vertices are compacted into the frame
+        uint8_t _sparse_stride;
+        scratch_buffer<float3> _dense_vertices;
+        scratch_buffer<float2> _dense_texcoords;
+        scratch_buffer<uint8_t> _dense_colors;
+        scratch_buffer<size_t> _sparse_row_offsets;
+
+        void compact_points(points* pframe, const float3* vertices, const float2* texcoords, const uint8_t* colors,
+            bool textured, const pose* world);
+
+        // Changed tiles output: the depth of each tile is compared to the depth it was last output with
+        int _tile_tolerance;
+        bool _refresh_tiles;
+        std::vector<uint16_t> _tile_reference;
+        std::vector<uint8_t> _tile_changed;
+        std::vector<size_t> _changed_tiles;
+
+        void find_changed_tiles(const uint16_t* depth);
+        void compact_tiles(points* pframe, const float3* vertices, const float2* texcoords, const uint8_t* colors,
+            bool textured, const pose* world);
     };
 }
@@ -3,7 +3,9 @@
 
 #include "processing-blocks-factory.h"
 #include "sse/sse-align.h"
+#include "neon/neon-align.h"
 #include "cuda/cuda-align.h"
+#include "cuda/cuda-filters.h"
 
 namespace librealsense
 {
@@ -18,6 +20,11 @@ namespace librealsense
     {
         return std::make_shared<librealsense::align_sse>(align_to);
     }
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    std::shared_ptr<librealsense::align> create_align(rs2_stream align_to)
+    {
+        return std::make_shared<librealsense::align_neon>(align_to);
+    }
 #else // No optimizations
     std::shared_ptr<librealsense::align> create_align(rs2_stream align_to)
     {
@@ -25,4 +32,46 @@ namespace librealsense
     }
 #endif // __SSSE3__
 #endif // RS2_USE_CUDA
+
+#ifdef RS2_USE_CUDA
+    std::shared_ptr<librealsense::decimation_filter> create_decimation_filter()
+    {
+        return std::make_shared<librealsense::decimation_filter_cuda>();
+    }
+
+    std::shared_ptr<librealsense::spatial_filter> create_spatial_filter()
+    {
+        return std::make_shared<librealsense::spatial_filter_cuda>();
+    }
+
+    std::shared_ptr<librealsense::temporal_filter> create_temporal_filter()
+    {
+        return std::make_shared<librealsense::temporal_filter_cuda>();
+    }
+
+    std::shared_ptr<librealsense::hole_filling_filter> create_hole_filling_filter()
+    {
+        return std::make_shared<librealsense::hole_filling_filter_cuda>();
+    }
+#else
+    std::shared_ptr<librealsense::decimation_filter> create_decimation_filter()
+    {
+        return std::make_shared<librealsense::decimation_filter>();
+    }
+
+    std::shared_ptr<librealsense::spatial_filter> create_spatial_filter()
+    {
+        return std::make_shared<librealsense::spatial_filter>();
+    }
+
+    std::shared_ptr<librealsense::temporal_filter> create_temporal_filter()
+    {
+        return std::make_shared<librealsense::temporal_filter>();
+    }
+
+    std::shared_ptr<librealsense::hole_filling_filter> create_hole_filling_filter()
+    {
+        return std::make_shared<librealsense::hole_filling_filter>();
+    }
+#endif // RS2_USE_CUDA
 }
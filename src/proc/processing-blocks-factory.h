@@ -4,8 +4,18 @@
 #pragma once
 
 #include "align.h"
+#include "decimation-filter.h"
+#include "spatial-filter.h"
+#include "temporal-filter.h"
+#include "hole-filling-filter.h"
 
 namespace librealsense
 {
     std::shared_ptr<librealsense::align> create_align(rs2_stream align_to);
+
+    // The depth filters run on the GPU in CUDA builds, keeping the frames resident in device memory between blocks
+    std::shared_ptr<librealsense::decimation_filter> create_decimation_filter();
+    std::shared_ptr<librealsense::spatial_filter> create_spatial_filter();
+    std::shared_ptr<librealsense::temporal_filter> create_temporal_filter();
+    std::shared_ptr<librealsense::hole_filling_filter> create_hole_filling_filter();
 }
@@ -0,0 +1,218 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#include "proc/processing-graph.h"
+#include "types.h"
+
+#include <chrono>
+
+namespace librealsense
+{
+    // Counts the frame as dropped unless the stage got to process it
+    struct processing_graph::pending_frame
+    {
+        pending_frame(node& n, frame_holder f)
+            : owner(n), frame(std::move(f)), queued(std::chrono::steady_clock::now()), processed(false)
+        {}
+
+        ~pending_frame()
+        {
+            if (!processed)
+                owner.dropped++;
+        }
+
+        node& owner;
+        frame_holder frame;
+        std::chrono::steady_clock::time_point queued;
+        bool processed;
+    };
+
+    processing_graph::processing_graph(unsigned int queue_size)
+        : _queue_size(queue_size), _started(false)
+    {
+    }
+
+    processing_graph::~processing_graph()
+    {
+        stop();
+    }
+
+    int processing_graph::add_block(std::shared_ptr<processing_block_interface> block)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_started)
+            throw wrong_api_call_sequence_exception("Blocks cannot be added to a running processing graph");
+
+        std::unique_ptr<node> n(new node());
+        n->block = std::move(block);
+        _nodes.push_back(std::move(n));
+        return static_cast<int>(_nodes.size() - 1);
+    }
+
+    bool processing_graph::reaches(int from, int to) const
+    {
+        if (from == to)
+            return true;
+        for (auto child : _nodes[from]->children)
+            if (reaches(child, to))
+                return true;
+        return false;
+    }
+
+    void processing_graph::connect(int from, int to)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_started)
+            throw wrong_api_call_sequence_exception("Blocks cannot be connected in a running processing graph");
+
+        auto count = static_cast<int>(_nodes.size());
+        if (from < 0 || from >= count || to < 0 || to >= count)
+            throw invalid_value_exception(to_string() << "Invalid processing graph edge " << from << " -> " << to);
+        auto&& children = _nodes[from]->children;
+        if (std::find(children.begin(), children.end(), to) != children.end())
+            return;
+        if (reaches(to, from))
+            throw invalid_value_exception(to_string() << "Edge " << from << " -> " << to << " would make the processing graph cyclic");
+
+        children.push_back(to);
+        _nodes[to]->parents++;
+    }
+
+    void processing_graph::start(frame_callback_ptr callback)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_started)
+            throw wrong_api_call_sequence_exception("Processing graph is already started");
+
+        // Topological order, so stop() can quiesce the producers before their consumers
+        _order.clear();
+        std::vector<int> parents;
+        for (auto&& n : _nodes)
+            parents.push_back(n->parents);
+        for (int i = 0; i < static_cast<int>(_nodes.size()); ++i)
+            if (!parents[i]) _order.push_back(i);
+        for (size_t i = 0; i < _order.size(); ++i)
+            for (auto child : _nodes[_order[i]]->children)
+                if (!--parents[child]) _order.push_back(child);
+
+        {
+            std::lock_guard<std::mutex> callback_lock(_callback_mutex);
+            _callback = std::move(callback);
+        }
+
+        for (auto&& n : _nodes)
+        {
+            auto p = n.get();
+            auto on_frame = [this, p](frame_interface* f) { route(*p, frame_holder(f)); };
+            n->block->set_output_callback({ new internal_frame_callback<decltype(on_frame)>(on_frame),
+                [](rs2_frame_callback* c) { c->release(); } });
+
+            n->stage.reset(new dispatcher(_queue_size));
+            n->stage->start();
+        }
+        _started = true;
+    }
+
+    void processing_graph::stop()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_started)
+            return;
+
+        for (auto i : _order)
+            _nodes[i]->stage->stop();
+        for (auto&& n : _nodes)
+        {
+            n->stage.reset();
+            n->block->set_output_callback(nullptr);
+        }
+
+        std::lock_guard<std::mutex> callback_lock(_callback_mutex);
+        _callback.reset();
+        _started = false;
+    }
+
+    void processing_graph::invoke(frame_holder frame)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_started)
+            throw wrong_api_call_sequence_exception("Processing graph was not started");
+
+        // The graph inputs drop their oldest frame rather than stall the caller
+        std::vector<node*> roots;
+        for (auto&& n : _nodes)
+            if (!n->parents) roots.push_back(n.get());
+        for (size_t i = 0; i < roots.size(); ++i)
+            enqueue(*roots[i], i + 1 < roots.size() ? frame.clone() : std::move(frame), false);
+    }
+
+    void processing_graph::enqueue(node& n, frame_holder frame, bool is_blocking)
+    {
+        auto pending = std::make_shared<pending_frame>(n, std::move(frame));
+
+        auto& pf = *pending;
+        n.stage->invoke([&pf, pending](dispatcher::cancellable_timer)
+        {
+            auto&& n = pf.owner;
+            auto start = std::chrono::steady_clock::now();
+            pf.processed = true;
+            n.block->invoke(std::move(pf.frame));
+            auto end = std::chrono::steady_clock::now();
+
+            std::lock_guard<std::mutex> lock(n.stats_mutex);
+            auto latency = std::chrono::duration<double, std::milli>(end - start).count();
+            n.frames++;
+            n.total_latency_ms += latency;
+            n.max_latency_ms = std::max(n.max_latency_ms, latency);
+            n.total_wait_ms += std::chrono::duration<double, std::milli>(start - pf.queued).count();
+        }, is_blocking);
+    }
+
+    void processing_graph::route(node& n, frame_holder frame)
+    {
+        if (n.children.empty())
+        {
+            // Called without the lock, stop() quiesces the stages before it drops the callback
+            frame_callback_ptr callback;
+            {
+                std::lock_guard<std::mutex> lock(_callback_mutex);
+                callback = _callback;
+            }
+            if (callback)
+            {
+                frame_interface* ptr = nullptr;
+                std::swap(frame.frame, ptr);
+                callback->on_frame((rs2_frame*)ptr);
+            }
+            return;
+        }
+
+        // Edges inside the graph block when full, so a slow stage holds back its producers instead of wasting their work
+        for (size_t i = 0; i < n.children.size(); ++i)
+        {
+            auto&& child = *_nodes[n.children[i]];
+            enqueue(child, i + 1 < n.children.size() ? frame.clone() : std::move(frame), true);
+        }
+    }
+
+    rs2_processing_stage_stats processing_graph::get_stats(int node) const
+    {
+        // Blocks may be added meanwhile, growing the nodes
+        std::lock_guard<std::mutex> graph_lock(_mutex);
+        if (node < 0 || node >= static_cast<int>(_nodes.size()))
+            throw invalid_value_exception(to_string() << "Invalid processing graph node " << node);
+
+        auto&& n = *_nodes[node];
+        std::lock_guard<std::mutex> lock(n.stats_mutex);
+        rs2_processing_stage_stats stats{};
+        stats.frames = n.frames;
+        stats.dropped = n.dropped;
+        if (n.frames)
+        {
+            stats.average_latency_ms = static_cast<float>(n.total_latency_ms / n.frames);
+            stats.average_wait_ms = static_cast<float>(n.total_wait_ms / n.frames);
+        }
+        stats.max_latency_ms = static_cast<float>(n.max_latency_ms);
+        return stats;
+    }
+}
@@ -0,0 +1,63 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include "core/processing.h"
+#include "concurrency.h"
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace librealsense
+{
+    // Runs a DAG of processing blocks as a pipeline: every block is a strand on the shared thread pool,
+    // so different blocks work on different frames at the same time while each block sees its frames in order.
+    // Frames fed to the graph go to the blocks without inputs, outputs of blocks without consumers go to the callback
+    class processing_graph
+    {
+    public:
+        explicit processing_graph(unsigned int queue_size);
+        ~processing_graph();
+
+        // Returns the id of the new node. The graph takes over the output callback of the block
+        int add_block(std::shared_ptr<processing_block_interface> block);
+        void connect(int from, int to);
+
+        void start(frame_callback_ptr callback);
+        void stop();
+        void invoke(frame_holder frame);
+
+        rs2_processing_stage_stats get_stats(int node) const;
+
+    private:
+        struct node
+        {
+            std::shared_ptr<processing_block_interface> block;
+            std::vector<int> children;
+            int parents = 0;
+
+            std::atomic<unsigned long long> dropped{ 0 };
+            mutable std::mutex stats_mutex;
+            unsigned long long frames = 0;
+            double total_latency_ms = 0, max_latency_ms = 0, total_wait_ms = 0;
+
+            // Declared last, so queued frames are counted as dropped while the counters are still alive
+            std::unique_ptr<dispatcher> stage;
+        };
+        struct pending_frame;
+
+        void enqueue(node& n, frame_holder frame, bool is_blocking);
+        void route(node& n, frame_holder frame);
+        bool reaches(int from, int to) const;
+
+        unsigned int _queue_size;
+        std::vector<std::unique_ptr<node>> _nodes;
+        std::vector<int> _order;
+
+        mutable std::mutex _mutex;
+        std::mutex _callback_mutex;
+        frame_callback_ptr _callback;
+        bool _started;
+    };
+}
@@ -0,0 +1,81 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "../include/librealsense2/h/rs_types.h"
+
+#include <math.h>
+
+namespace librealsense
+{
+    // rs2_project_point_to_pixel and rs2_deproject_pixel_to_point with the distortion model as a template argument,
+    // so the loops over whole images select the model once per frame instead of testing it for every pixel.
+    // The arithmetic is the one of rsutil.h, the results are the same to the bit
+    template<rs2_distortion MODEL>
+    inline void project_point(float pixel[2], const rs2_intrinsics& intrin, const float point[3])
+    {
+        float x = point[0] / point[2], y = point[1] / point[2];
+
+        if (MODEL == RS2_DISTORTION_MODIFIED_BROWN_CONRADY)
+        {
+            float r2 = x*x + y*y;
+            float f = 1 + intrin.coeffs[0]*r2 + intrin.coeffs[1]*r2*r2 + intrin.coeffs[4]*r2*r2*r2;
+            x *= f;
+            y *= f;
+            float dx = x + 2*intrin.coeffs[2]*x*y + intrin.coeffs[3]*(r2 + 2*x*x);
+            float dy = y + 2*intrin.coeffs[3]*x*y + intrin.coeffs[2]*(r2 + 2*y*y);
+            x = dx;
+            y = dy;
+        }
+        if (MODEL == RS2_DISTORTION_FTHETA)
+        {
+            float r = sqrtf(x*x + y*y);
+            float rd = (float)(1.0f / intrin.coeffs[0] * atan(2 * r* tan(intrin.coeffs[0] / 2.0f)));
+            x *= rd / r;
+            y *= rd / r;
+        }
+
+        pixel[0] = x * intrin.fx + intrin.ppx;
+        pixel[1] = y * intrin.fy + intrin.ppy;
+    }
+
+    template<rs2_distortion MODEL>
+    inline void deproject_pixel(float point[3], const rs2_intrinsics& intrin, const float pixel[2], float depth)
+    {
+        float x = (pixel[0] - intrin.ppx) / intrin.fx;
+        float y = (pixel[1] - intrin.ppy) / intrin.fy;
+
+        if (MODEL == RS2_DISTORTION_INVERSE_BROWN_CONRADY)
+        {
+            float r2 = x*x + y*y;
+            float f = 1 + intrin.coeffs[0]*r2 + intrin.coeffs[1]*r2*r2 + intrin.coeffs[4]*r2*r2*r2;
+            float ux = x*f + 2*intrin.coeffs[2]*x*y + intrin.coeffs[3]*(r2 + 2*x*x);
+            float uy = y*f + 2*intrin.coeffs[3]*x*y + intrin.coeffs[2]*(r2 + 2*y*y);
+            x = ux;
+            y = uy;
+        }
+
+        point[0] = depth * x;
+        point[1] = depth * y;
+        point[2] = depth;
+    }
+
+    // The kernel to instantiate for a model: the models rsutil.h has no case for map like no distortion
+    inline rs2_distortion projection_model(rs2_distortion model)
+    {
+        switch (model)
+        {
+        case RS2_DISTORTION_MODIFIED_BROWN_CONRADY:
+        case RS2_DISTORTION_FTHETA:
+            return model;
+        default:
+            return RS2_DISTORTION_NONE;
+        }
+    }
+
+    inline rs2_distortion deprojection_model(rs2_distortion model)
+    {
+        return model == RS2_DISTORTION_INVERSE_BROWN_CONRADY ? model : RS2_DISTORTION_NONE;
+    }
+}
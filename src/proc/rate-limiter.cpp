@@ -0,0 +1,71 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#include "option.h"
+#include "proc/rate-limiter.h"
+
+namespace librealsense
+{
+    const int divisor_max = 30;
+    const float target_fps_max = 300.f;
+
+    rate_limiter::rate_limiter()
+        : _divisor(1), _target_fps(0.f)
+    {
+        auto divisor = std::make_shared<ptr_option<int>>(1, divisor_max, 1, 1, &_divisor, "Keep one of every N frames");
+        auto target_fps = std::make_shared<ptr_option<float>>(0.f, target_fps_max, 1.f, 0.f, &_target_fps,
+            "Largest rate in Hz of the frames kept, 0 for no limit");
+        // The counts restart with the new settings
+        divisor->on_set([this](float) { std::lock_guard<std::mutex> lock(_mutex); _streams.clear(); });
+        target_fps->on_set([this](float) { std::lock_guard<std::mutex> lock(_mutex); _streams.clear(); });
+        register_option(RS2_OPTION_RATE_DIVISOR, divisor);
+        register_option(RS2_OPTION_TARGET_FPS, target_fps);
+
+        auto on_frame = [this](rs2::frame f, const rs2::frame_source& source)
+        {
+            bool kept;
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                kept = keep(f);
+            }
+            if (kept)
+                source.frame_ready(std::move(f));
+        };
+
+        auto callback = new rs2::frame_processor_callback<decltype(on_frame)>(on_frame);
+        processing_block::set_processing_callback(std::shared_ptr<rs2_frame_processor_callback>(callback));
+    }
+
+    bool rate_limiter::keep(const rs2::frame& f)
+    {
+        if (!f)
+            return false;
+
+        // A frameset is limited by the stream of its first frame, which is the one of the composite frame
+        auto& s = _streams[((frame_interface*)f.get())->get_stream().get()];
+        auto timestamp = f.get_timestamp();
+
+        // Playback looping or a restarted stream, the rate is measured anew
+        if (s.kept_any && timestamp < s.last_seen)
+            s = stream_state();
+        if (s.count > 0)
+            s.interval = timestamp - s.last_seen;
+        s.last_seen = timestamp;
+
+        if (s.count++ % _divisor != 0)
+            return false;
+
+        if (_target_fps > 0.f && s.kept_any)
+        {
+            // Half the interval of the input is allowed off the period, so the timestamps jitter doesn't make it
+            // skip one frame more, e.g. 90fps limited to 15fps keeps every 6th frame
+            auto period = 1000. / _target_fps;
+            if (timestamp - s.last_kept < period - s.interval * _divisor / 2.)
+                return false;
+        }
+
+        s.last_kept = timestamp;
+        s.kept_any = true;
+        return true;
+    }
+}
@@ -0,0 +1,35 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include "synthetic-stream.h"
+#include <map>
+
+namespace librealsense
+{
+    // Drops frames ahead of the other blocks: it keeps one of every RS2_OPTION_RATE_DIVISOR frames and, with
+    // RS2_OPTION_TARGET_FPS set, no more frames than the target rate. Each stream is limited on its own, and a
+    // frameset is kept or dropped as a whole, so the frames matched by the syncer stay matched. Dropped frames
+    // are released right away, with nothing allocated for them
+    class rate_limiter : public processing_block
+    {
+    public:
+        rate_limiter();
+
+    private:
+        struct stream_state
+        {
+            unsigned long long count = 0;
+            double last_kept = 0;       // Timestamp of the last frame kept, in ms
+            double last_seen = 0;       // Timestamp of the last frame, kept or not
+            double interval = 0;        // Between the last two frames, in ms
+            bool kept_any = false;
+        };
+
+        bool keep(const rs2::frame& f);
+
+        int _divisor;
+        float _target_fps;
+        std::map<const stream_profile_interface*, stream_state> _streams;
+    };
+}
@@ -0,0 +1,147 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#include "rvl-codec.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace librealsense
+{
+    namespace
+    {
+        class nibble_writer
+        {
+        public:
+            explicit nibble_writer(uint8_t* out) : _begin(out), _out(out) {}
+
+            void write(uint32_t value)
+            {
+                do
+                {
+                    uint32_t nibble = value & 0x7;
+                    value >>= 3;
+                    if (value) nibble |= 0x8;
+                    _word = (_word << 4) | nibble;
+                    if (++_nibbles == 8)
+                        flush();
+                } while (value);
+            }
+
+            size_t finish()
+            {
+                if (_nibbles)
+                {
+                    _word <<= 4 * (8 - _nibbles);
+                    flush();
+                }
+                return _out - _begin;
+            }
+
+        private:
+            void flush()
+            {
+                memcpy(_out, &_word, sizeof(_word));
+                _out += sizeof(_word);
+                _word = 0;
+                _nibbles = 0;
+            }
+
+            uint8_t* _begin;
+            uint8_t* _out;
+            uint32_t _word = 0;
+            int _nibbles = 0;
+        };
+
+        class nibble_reader
+        {
+        public:
+            nibble_reader(const uint8_t* in, size_t size) : _in(in), _end(in + size) {}
+
+            bool read(uint32_t& value)
+            {
+                value = 0;
+                for (int shift = 0; shift < 32; shift += 3)
+                {
+                    if (!_nibbles)
+                    {
+                        if (size_t(_end - _in) < sizeof(_word)) return false;
+                        memcpy(&_word, _in, sizeof(_word));
+                        _in += sizeof(_word);
+                        _nibbles = 8;
+                    }
+                    uint32_t nibble = _word >> 28;
+                    _word <<= 4;
+                    --_nibbles;
+                    value |= (nibble & 0x7) << shift;
+                    if (!(nibble & 0x8)) return true;
+                }
+                return false;
+            }
+
+        private:
+            const uint8_t* _in;
+            const uint8_t* _end;
+            uint32_t _word = 0;
+            int _nibbles = 0;
+        };
+    }
+
+    size_t rvl_max_encoded_size(size_t pixels)
+    {
+        // At most 6 nibbles per delta and, amortized over a run pair, 3 nibbles per pixel for the run lengths
+        return pixels * 9 / 2 + 2 * sizeof(uint32_t);
+    }
+
+    void rvl_encode(const uint16_t* in, size_t pixels, std::vector<uint8_t>& out)
+    {
+        out.resize(rvl_max_encoded_size(pixels));
+        nibble_writer writer(out.data());
+
+        auto end = in + pixels;
+        int previous = 0;
+        while (in != end)
+        {
+            auto zeros_start = in;
+            while (in != end && !*in) ++in;
+            writer.write(static_cast<uint32_t>(in - zeros_start));
+
+            auto nonzeros_start = in;
+            while (in != end && *in) ++in;
+            writer.write(static_cast<uint32_t>(in - nonzeros_start));
+
+            for (auto p = nonzeros_start; p != in; ++p)
+            {
+                int delta = *p - previous;
+                writer.write(static_cast<uint32_t>((delta << 1) ^ (delta >> 31)));
+                previous = *p;
+            }
+        }
+        out.resize(writer.finish());
+    }
+
+    bool rvl_decode(const uint8_t* in, size_t size, uint16_t* out, size_t pixels)
+    {
+        nibble_reader reader(in, size);
+
+        auto end = out + pixels;
+        int previous = 0;
+        while (out != end)
+        {
+            uint32_t zeros, nonzeros;
+            if (!reader.read(zeros) || zeros > size_t(end - out)) return false;
+            std::fill(out, out + zeros, uint16_t(0));
+            out += zeros;
+
+            if (!reader.read(nonzeros) || nonzeros > size_t(end - out)) return false;
+            for (uint32_t i = 0; i < nonzeros; i++)
+            {
+                uint32_t zigzag;
+                if (!reader.read(zigzag)) return false;
+                previous += static_cast<int>(zigzag >> 1) ^ -static_cast<int>(zigzag & 1);
+                *out++ = static_cast<uint16_t>(previous);
+            }
+        }
+        return true;
+    }
+}
@@ -0,0 +1,25 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+namespace librealsense
+{
+    // Lossless depth compression after Wilson, "Fast Lossless Depth Image Compression" (2017).
+    // The image is coded as alternating runs of zero and non-zero pixels, the non-zero pixels
+    // as zigzag deltas from their predecessor. All values are written as variable length nibbles,
+    // three value bits and a continuation bit, packed most significant first into 32-bit words.
+
+    // Upper bound of the encoded size of an image of the given number of pixels
+    size_t rvl_max_encoded_size(size_t pixels);
+
+    // Replaces the content of out with the encoded image
+    void rvl_encode(const uint16_t* in, size_t pixels, std::vector<uint8_t>& out);
+
+    // Decodes exactly the given number of pixels, false if the input is truncated or does not match the size
+    bool rvl_decode(const uint8_t* in, size_t size, uint16_t* out, size_t pixels);
+}
@@ -0,0 +1,45 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace librealsense
+{
+    // Number of times a scratch buffer of any processing block had to allocate. Constant once the blocks process
+    // frames of a steady size, which is what the tests check
+    inline std::atomic<uint64_t>& scratch_allocations()
+    {
+        static std::atomic<uint64_t> count(0);
+        return count;
+    }
+
+    // Temporaries a processing block keeps from frame to frame. The buffer only grows, to the largest size asked
+    // for so far, so switching between resolutions doesn't allocate either. The contents are left from the last use
+    template<class T>
+    class scratch_buffer
+    {
+    public:
+        T* get(size_t count)
+        {
+            if (count > _capacity)
+            {
+                _data.reset(new T[count]);
+                _capacity = count;
+                scratch_allocations().fetch_add(1, std::memory_order_relaxed);
+            }
+            return _data.get();
+        }
+
+        T* data() const { return _data.get(); }
+        size_t capacity() const { return _capacity; }
+
+    private:
+        std::unique_ptr<T[]> _data;
+        size_t _capacity = 0;
+    };
+}
@@ -11,6 +11,14 @@
 #include "proc/hole-filling-filter.h"
 #include "proc/spatial-filter.h"
 
+#ifdef __SSSE3__
+#include <tmmintrin.h> // For SSSE3 intrinsics
+#endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h> // For NEON intrinsics
+#define RS2_NEON
+#endif
+
 namespace librealsense
 {
     enum spatial_holes_filling_types : uint8_t
@@ -59,7 +67,9 @@ namespace librealsense
         _focal_lenght_mm(0.f),
         _stereo_baseline_mm(0.f),
         _holes_filling_mode(holes_fill_def),
-        _holes_filling_radius(0)
+        _holes_filling_radius(0),
+        _processing_threads(processing_threads_default),
+        _executor(processing_threads_default)
     {
         _stream_filter.stream = RS2_STREAM_DEPTH;
         _stream_filter.format = RS2_FORMAT_Z16;
@@ -140,6 +150,9 @@ namespace librealsense
             }
         });
 
+        register_processing_threads_option(*this, _processing_threads, _executor, _mutex,
+            "Number of threads used to filter each frame, 0 for all hardware threads", "spatial filter");
+
         register_option(RS2_OPTION_FILTER_SMOOTH_ALPHA, spatial_filter_alpha);
         register_option(RS2_OPTION_FILTER_SMOOTH_DELTA, spatial_filter_delta);
         register_option(RS2_OPTION_FILTER_MAGNITUDE, spatial_filter_iterations);
@@ -151,20 +164,29 @@ namespace librealsense
         rs2::frame tgt;
 
         update_configuration(f);
-        tgt = prepare_target_frame(f, source);
 
         // Spatial domain transform edge-preserving filter
         if (_extension_type == RS2_EXTENSION_DISPARITY_FRAME)
+        {
+            tgt = prepare_target_frame(f, source);
             dxf_smooth<float>(const_cast<void*>(tgt.get_data()), _spatial_alpha_param, _spatial_edge_threshold, _spatial_iterations);
+        }
         else
-            dxf_smooth<uint16_t>(const_cast<void*>(tgt.get_data()), _spatial_alpha_param, _spatial_edge_threshold, _spatial_iterations);
+            tgt = smooth_depth_frame(f, source);
 
         return tgt;
     }
 
+    rs2::frame spatial_filter::smooth_depth_frame(const rs2::frame& f, const rs2::frame_source& source)
+    {
+        auto tgt = prepare_target_frame(f, source);
+        dxf_smooth<uint16_t>(const_cast<void*>(tgt.get_data()), _spatial_alpha_param, _spatial_edge_threshold, _spatial_iterations);
+        return tgt;
+    }
+
     void  spatial_filter::update_configuration(const rs2::frame& f)
     {
-        if (f.get_profile().get() != _source_stream_profile.get())
+        if (frame_profile(f) != _source_stream_profile.get())
         {
             _source_stream_profile = f.get_profile();
             _target_stream_profile = _source_stream_profile.clone(RS2_STREAM_DEPTH, 0, _source_stream_profile.format());
@@ -218,6 +240,11 @@ namespace librealsense
 
     rs2::frame spatial_filter::prepare_target_frame(const rs2::frame& f, const rs2::frame_source& source)
     {
+        // The filter runs in place, on the input itself when nothing else references it
+        if (f.as<rs2::video_frame>().get_stride_in_bytes() == int(_stride))
+            if (auto tgt = reuse_frame(f, _target_stream_profile))
+                return tgt;
+
         // Allocate and copy the content of the original Depth data to the target
         rs2::frame tgt = source.allocate_video_frame(_target_stream_profile, f, int(_bpp), int(_width), int(_height), int(_stride), _extension_type);
 
@@ -225,13 +252,88 @@ namespace librealsense
         return tgt;
     }
 
-    void spatial_filter::recursive_filter_horizontal_fp(void * image_data, float alpha, float deltaZ)
+    std::vector<size_t> spatial_filter::get_bands(size_t size, size_t alignment) const
+    {
+        // A few bands per thread balance the load when some bands hold more valid pixels than others
+        size_t bands = std::max<size_t>(1, std::min<size_t>(_executor.size() > 1 ? _executor.size() * 4 : 1, size / alignment));
+
+        std::vector<size_t> bounds(1, 0);
+        for (size_t b = 1; b < bands; b++)
+            bounds.push_back(size * b / bands / alignment * alignment);
+        bounds.push_back(size);
+        return bounds;
+    }
+
+    size_t spatial_filter::blend_rows_simd(uint16_t * tgt, const uint16_t * ref, size_t count, float alpha, uint16_t delta_z, bool check_valid)
+    {
+        size_t u = 0;
+#if defined(__SSSE3__)
+        const __m128 a = _mm_set1_ps(alpha);
+        const __m128 one_minus_a = _mm_set1_ps(1.f - alpha);
+        const __m128 round = _mm_set1_ps(0.5f);
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i bias = _mm_set1_epi16(-32768);
+        const __m128i bias32 = _mm_set1_epi32(32768);
+        // Unsigned 16-bit comparisons are done on biased signed values
+        const __m128i delta = _mm_xor_si128(_mm_set1_epi16(static_cast<short>(delta_z)), bias);
+        for (; u + 8 <= count; u += 8)
+        {
+            __m128i cur = _mm_loadu_si128(reinterpret_cast<const __m128i *>(tgt + u));
+            __m128i other = _mm_loadu_si128(reinterpret_cast<const __m128i *>(ref + u));
+
+            __m128i diff = _mm_or_si128(_mm_subs_epu16(cur, other), _mm_subs_epu16(other, cur));
+            __m128i mask = _mm_cmplt_epi16(_mm_xor_si128(diff, bias), delta);
+            if (check_valid)
+                mask = _mm_andnot_si128(_mm_or_si128(_mm_cmpeq_epi16(cur, zero), _mm_cmpeq_epi16(other, zero)), mask);
+            if (_mm_movemask_epi8(mask) == 0)
+                continue;
+
+            // Same operation order as the scalar code, so the results are identical
+            __m128 lo = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(cur, zero)), a),
+                                              _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(other, zero)), one_minus_a)), round);
+            __m128 hi = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(cur, zero)), a),
+                                              _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(other, zero)), one_minus_a)), round);
+            // Truncate, then pack to unsigned 16-bit through the signed range (SSE4.1 packus_epi32 is not available)
+            __m128i filtered = _mm_xor_si128(_mm_packs_epi32(_mm_sub_epi32(_mm_cvttps_epi32(lo), bias32),
+                                                             _mm_sub_epi32(_mm_cvttps_epi32(hi), bias32)), bias);
+
+            __m128i result = _mm_or_si128(_mm_and_si128(mask, filtered), _mm_andnot_si128(mask, cur));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(tgt + u), result);
+        }
+#elif defined(RS2_NEON)
+        const float32x4_t a = vdupq_n_f32(alpha);
+        const float32x4_t one_minus_a = vdupq_n_f32(1.f - alpha);
+        const float32x4_t round = vdupq_n_f32(0.5f);
+        const uint16x8_t delta = vdupq_n_u16(delta_z);
+        for (; u + 8 <= count; u += 8)
+        {
+            uint16x8_t cur = vld1q_u16(tgt + u);
+            uint16x8_t other = vld1q_u16(ref + u);
+
+            uint16x8_t mask = vcltq_u16(vabdq_u16(cur, other), delta);
+            if (check_valid)
+                mask = vandq_u16(mask, vandq_u16(vtstq_u16(cur, cur), vtstq_u16(other, other)));
+
+            // Separate multiply and add, in the order of the scalar code
+            float32x4_t lo = vaddq_f32(vaddq_f32(vmulq_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(cur))), a),
+                                                 vmulq_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(other))), one_minus_a)), round);
+            float32x4_t hi = vaddq_f32(vaddq_f32(vmulq_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(cur))), a),
+                                                 vmulq_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(other))), one_minus_a)), round);
+            uint16x8_t filtered = vcombine_u16(vmovn_u32(vcvtq_u32_f32(lo)), vmovn_u32(vcvtq_u32_f32(hi)));
+
+            vst1q_u16(tgt + u, vbslq_u16(mask, filtered, cur));
+        }
+#endif
+        return u;
+    }
+
+    void spatial_filter::recursive_filter_horizontal_fp(void * image_data, float alpha, float deltaZ, size_t v_begin, size_t v_end)
     {
         float *image = reinterpret_cast<float*>(image_data);
 
         int v, u;
 
-        for (v = 0; v < _height;) {
+        for (v = int(v_begin); v < int(v_end);) {
             // left to right
             float *im = image + v * _width;
             float state = *im;
@@ -353,7 +455,7 @@ namespace librealsense
         }
     }
 
-    void spatial_filter::recursive_filter_vertical_fp(void * image_data, float alpha, float deltaZ)
+    void spatial_filter::recursive_filter_vertical_fp(void * image_data, float alpha, float deltaZ, size_t u_begin, size_t u_end)
     {
         float *image = reinterpret_cast<float*>(image_data);
 
@@ -361,7 +463,7 @@ namespace librealsense
 
         // we'll do one column at a time, top to bottom, bottom to top, left to right,
 
-        for (u = 0; u < _width;) {
+        for (u = int(u_begin); u < int(u_end);) {
 
             float *im = image + u;
             float state = im[0];
@@ -12,6 +12,7 @@
 
 #include "../include/librealsense2/hpp/rs_frame.hpp"
 #include "../include/librealsense2/hpp/rs_processing.hpp"
+#include "concurrency.h"
 
 namespace librealsense
 {
@@ -21,47 +22,112 @@ namespace librealsense
         spatial_filter();
 
     protected:
+        friend class depth_refine;
+
         void    update_configuration(const rs2::frame& f);
 
         rs2::frame prepare_target_frame(const rs2::frame& f, const rs2::frame_source& source);
         rs2::frame process_frame(const rs2::frame_source& source, const rs2::frame& f) override;
 
+        // Filters a depth frame into a new target, overridden by the accelerated implementations
+        virtual rs2::frame smooth_depth_frame(const rs2::frame& f, const rs2::frame_source& source);
+
         template <typename T>
         void dxf_smooth(void *frame_data, float alpha, float delta, int iterations)
         {
             static_assert((std::is_arithmetic<T>::value), "Spatial filter assumes numeric types");
-            bool fp = (std::is_floating_point<T>::value);
+
+            // The kernels of the data type and hole filling mode are picked once, not per row or per pixel
+            auto horizontal = horizontal_kernel<T>(std::is_floating_point<T>());
+            auto vertical = vertical_kernel<T>(std::is_floating_point<T>());
+
+            // Rows are independent in the horizontal pass and columns in the vertical one,
+            // so each pass is split into bands that run on the block's worker threads
+            auto row_bands = get_bands(_height, 1);
+            auto column_bands = get_bands(_width, column_band_alignment);
 
             for (int i = 0; i < iterations; i++)
             {
-                if (fp)
+                _executor.for_each(row_bands.size() - 1, [&](size_t b)
                 {
-                    recursive_filter_horizontal_fp(frame_data, alpha, delta);
-                    recursive_filter_vertical_fp(frame_data, alpha, delta);
-                }
-                else
+                    (this->*horizontal)(frame_data, alpha, delta, row_bands[b], row_bands[b + 1]);
+                });
+                _executor.for_each(column_bands.size() - 1, [&](size_t b)
                 {
-                    recursive_filter_horizontal<T>(frame_data, alpha, delta);
-                    recursive_filter_vertical<T>(frame_data, alpha, delta);
-                }
+                    (this->*vertical)(frame_data, alpha, delta, column_bands[b], column_bands[b + 1]);
+                });
             }
 
             // Disparity domain hole filling requires a second pass over the frame data
             // For depth domain a more efficient in-place hole filling is performed
-            if (_holes_filling_mode && fp)
-                intertial_holes_fill<T>(static_cast<T*>(frame_data));
+            if (std::is_floating_point<T>::value && _holes_filling_mode)
+            {
+                _executor.for_each(row_bands.size() - 1, [&](size_t b)
+                {
+                    intertial_holes_fill<T>(static_cast<T*>(frame_data), row_bands[b], row_bands[b + 1]);
+                });
+            }
         }
 
-        void recursive_filter_horizontal_fp(void * image_data, float alpha, float deltaZ);
-        void recursive_filter_vertical_fp(void * image_data, float alpha, float deltaZ);
+        typedef void (spatial_filter::*band_kernel)(void * image_data, float alpha, float deltaZ, size_t begin, size_t end);
 
         template <typename T>
-        void  recursive_filter_horizontal(void * image_data, float alpha, float deltaZ)
+        band_kernel horizontal_kernel(std::true_type /* floating point */) const { return &spatial_filter::recursive_filter_horizontal_fp; }
+        template <typename T>
+        band_kernel horizontal_kernel(std::false_type) const
+        {
+            return _holes_filling_radius ? &spatial_filter::recursive_filter_horizontal<T, true> : &spatial_filter::recursive_filter_horizontal<T, false>;
+        }
+        template <typename T>
+        band_kernel vertical_kernel(std::true_type /* floating point */) const { return &spatial_filter::recursive_filter_vertical_fp; }
+        template <typename T>
+        band_kernel vertical_kernel(std::false_type) const { return &spatial_filter::recursive_filter_vertical<T>; }
+
+        // Splits [0, size) into up to a few bands per worker thread, with inner boundaries on multiples of 'alignment'
+        std::vector<size_t> get_bands(size_t size, size_t alignment) const;
+
+        void recursive_filter_horizontal_fp(void * image_data, float alpha, float deltaZ, size_t v_begin, size_t v_end);
+        void recursive_filter_vertical_fp(void * image_data, float alpha, float deltaZ, size_t u_begin, size_t u_end);
+
+        // Moves each 'tgt' pixel towards the matching 'ref' pixel when they differ by less than delta_z:
+        // tgt = tgt * alpha + ref * (1 - alpha). With CHECK_VALID set, pixels where either value is invalid are kept
+        template <bool CHECK_VALID, typename T>
+        static void blend_rows(T * tgt, const T * ref, size_t count, float alpha, T delta_z)
+        {
+            const bool fp = (std::is_floating_point<T>::value);
+            const float round = fp ? 0.f : 0.5f;
+            const T valid_threshold = fp ? static_cast<T>(std::numeric_limits<T>::epsilon()) : static_cast<T>(1);
+
+            for (size_t u = blend_rows_simd(tgt, ref, count, alpha, delta_z, CHECK_VALID); u < count; u++)
+            {
+                T cur = tgt[u];
+                T other = ref[u];
+
+                if (!CHECK_VALID || ((fabs(cur) >= valid_threshold) && (fabs(other) >= valid_threshold)))
+                {
+                    T diff = static_cast<T>(fabs(cur - other));
+                    if (diff < delta_z)
+                    {
+                        float filtered = cur * alpha + other * (1.f - alpha);
+                        tgt[u] = static_cast<T>(filtered + round);
+                    }
+                }
+            }
+        }
+
+        // Vectorized head of blend_rows for depth data, see spatial-filter.cpp. Returns the number of pixels done
+        static size_t blend_rows_simd(uint16_t * tgt, const uint16_t * ref, size_t count, float alpha, uint16_t delta_z, bool check_valid);
+        template <typename T>
+        static size_t blend_rows_simd(T *, const T *, size_t, float, T, bool) { return 0; }
+
+        // FILL_HOLES is set when the holes filling radius is, so the rows with hole filling disabled never test it
+        template <typename T, bool FILL_HOLES>
+        void  recursive_filter_horizontal(void * image_data, float alpha, float deltaZ, size_t v_begin, size_t v_end)
         {
             size_t v{}, u{};
 
             // Handle conversions for invalid input data
-            bool fp = (std::is_floating_point<T>::value);
+            const bool fp = (std::is_floating_point<T>::value);
 
             // Filtering integer values requires round-up to the nearest discrete value
             const float round = fp ? 0.f : 0.5f;
@@ -72,7 +138,7 @@ namespace librealsense
             auto image = reinterpret_cast<T*>(image_data);
             size_t cur_fill = 0;
 
-            for (v = 0; v < _height; v++)
+            for (v = v_begin; v < v_end; v++)
             {
                 // left to right
                 T *im = image + v * _width;
@@ -99,7 +165,7 @@ namespace librealsense
                         }
                         else // Only the old value is valid - appy holes filling
                         {
-                            if (_holes_filling_radius)
+                            if (FILL_HOLES)
                             {
                                 if (++cur_fill <_holes_filling_radius)
                                     im[1] = val1 = val0;
@@ -136,7 +202,7 @@ namespace librealsense
                         }
                         else // 'inertial' hole filling
                         {
-                            if (_holes_filling_radius)
+                            if (FILL_HOLES)
                             {
                                 if (++cur_fill <_holes_filling_radius)
                                     im[0] = val0 = val1;
@@ -151,82 +217,39 @@ namespace librealsense
         }
 
         template <typename T>
-        void recursive_filter_vertical(void * image_data, float alpha, float deltaZ)
+        void recursive_filter_vertical(void * image_data, float alpha, float deltaZ, size_t u_begin, size_t u_end)
         {
-            size_t v{}, u{};
-
-            // Handle conversions for invalid input data
-            bool fp = (std::is_floating_point<T>::value);
-
-            // Filtering integer values requires round-up to the nearest discrete value
-            const float round = fp ? 0.f : 0.5f;
-            // define invalid range
-            const T valid_threshold = fp ? static_cast<T>(std::numeric_limits<T>::epsilon()) : static_cast<T>(1);
             const T delta_z = static_cast<T>(deltaZ);
+            const size_t count = u_end - u_begin;
 
-            auto image = reinterpret_cast<T*>(image_data);
+            auto image = reinterpret_cast<T*>(image_data) + u_begin;
 
             // we'll do one row at a time, top to bottom, then bottom to top
+            // Only the [u_begin, u_end) strip of each row is touched
 
             // top to bottom
-
             T *im = image;
-            T im0{};
-            T imw{};
-            for (v = 1; v < _height; v++)
-            {
-                for (u = 0; u < _width; u++)
-                {
-                    im0 = im[0];
-                    imw = im[_width];
-
-                    //if ((fabs(im0) >= valid_threshold) && (fabs(imw) >= valid_threshold))
-                    {
-                        T diff = static_cast<T>(fabs(im0 - imw));
-                        if (diff < delta_z)
-                        {
-                            float filtered = imw * alpha + im0 * (1.f - alpha);
-                            im[_width] = static_cast<T>(filtered + round);
-                        }
-                    }
-                    im += 1;
-                }
-            }
+            for (size_t v = 1; v < _height; v++, im += _width)
+                blend_rows<false>(im + _width, im, count, alpha, delta_z);
 
             // bottom to top
             im = image + (_height - 2) * _width;
-            for (v = 1; v < _height; v++, im -= (_width * 2))
-            {
-                for (u = 0; u < _width; u++)
-                {
-                    im0 = im[0];
-                    imw = im[_width];
-
-                    if ((fabs(im0) >= valid_threshold) && (fabs(imw) >= valid_threshold))
-                    {
-                        T diff = static_cast<T>(fabs(im0 - imw));
-                        if (diff < delta_z)
-                        {
-                            float filtered = im0 * alpha + imw * (1.f - alpha);
-                            im[0] = static_cast<T>(filtered + round);
-                        }
-                    }
-                    im += 1;
-                }
-            }
+            for (size_t v = 1; v < _height; v++, im -= _width)
+                blend_rows<true>(im, im + _width, count, alpha, delta_z);
         }
 
+        // Disparity holes are told by their bits, so that the test stays an integer compare
+        static bool is_hole(const float* ptr) { return !*reinterpret_cast<const int*>(ptr); }
         template<typename T>
-        inline void intertial_holes_fill(T* image_data)
-        {
-            std::function<bool(T*)> fp_oper = [](T* ptr) { return !*((int *)ptr); };
-            std::function<bool(T*)> uint_oper = [](T* ptr) { return !(*ptr); };
-            auto empty = (std::is_floating_point<T>::value) ? fp_oper : uint_oper;
+        static bool is_hole(const T* ptr) { return !(*ptr); }
 
+        template<typename T>
+        inline void intertial_holes_fill(T* image_data, size_t v_begin, size_t v_end)
+        {
             size_t cur_fill = 0;
 
-            T* p = image_data;
-            for (int j = 0; j < _height; ++j)
+            T* p = image_data + v_begin * _width;
+            for (size_t j = v_begin; j < v_end; ++j)
             {
                 ++p;
                 cur_fill = 0;
@@ -234,7 +257,7 @@ namespace librealsense
                 //Left to Right
                 for (size_t i = 1; i < _width; ++i)
                 {
-                    if (empty(p))
+                    if (is_hole(p))
                     {
                         if (++cur_fill < _holes_filling_radius)
                             *p = *(p - 1);
@@ -250,7 +273,7 @@ namespace librealsense
                 //Right to left
                 for (size_t i = 1; i < _width; ++i)
                 {
-                    if (empty(p))
+                    if (is_hole(p))
                     {
                         if (++cur_fill < _holes_filling_radius)
                             *p = *(p + 1);
@@ -263,8 +286,6 @@ namespace librealsense
             }
         }
 
-    private:
-
         float                   _spatial_alpha_param;
         uint8_t                 _spatial_delta_param;
         uint8_t                 _spatial_iterations;
@@ -280,5 +301,10 @@ namespace librealsense
         float                   _stereo_baseline_mm;
         uint8_t                 _holes_filling_mode;
         uint8_t                 _holes_filling_radius;
+        uint8_t                 _processing_threads;
+        parallel_executor       _executor;
+
+        // Column bands start on cache line boundaries, so that threads never write to the same line
+        static const size_t     column_band_alignment = 32;
     };
 }
@@ -6,6 +6,9 @@
 #include "sync.h"
 #include "proc/synthetic-stream.h"
 #include "proc/syncer-processing-block.h"
+#include "environment.h"
+#include "tracing.h"
+#include "option.h"
 
 
 namespace librealsense
@@ -18,10 +21,15 @@ namespace librealsense
 
             std::stringstream ss;
             ss << "SYNCED: ";
-            auto composite = dynamic_cast<composite_frame*>(f.frame);
+            auto composite = frame_cast<composite_frame>(f.frame);
+            auto synced = environment::get_instance().get_time_service()->get_time();
             for (int i = 0; i < composite->get_embedded_frames_count(); i++)
             {
                 auto matched = composite->get_frame(i);
+                auto matched_frame = dynamic_cast<frame*>(matched);
+                if (matched_frame && matched_frame->additional_data.traced)
+                    pipeline_tracer::get().record(matched->get_stream()->get_stream_type(), RS2_PIPELINE_STAGE_SYNCED,
+                        matched->get_frame_number(), matched->get_frame_system_time(), synced);
                 ss << matched->get_stream()->get_stream_type() << " " << matched->get_frame_number() << ", "<<std::fixed<< matched->get_frame_timestamp()<<" ";
             }
 
@@ -45,4 +53,192 @@ namespace librealsense
         set_processing_callback(std::shared_ptr<rs2_frame_processor_callback>(
             new internal_frame_processor_callback<decltype(f)>(f)));
     }
+
+    multi_device_syncer::multi_device_syncer()
+    {
+        auto match_key = std::make_shared<ptr_option<uint8_t>>(
+            sync_by_frame_counter,
+            sync_match_key_count - 1, 1,
+            sync_by_frame_counter,
+            &_match_key, "Frame property the frames of the devices are matched on. Setting it restarts the matching");
+        match_key->set_description(sync_by_frame_counter, "Frame counter");
+        match_key->set_description(sync_by_timestamp, "Timestamp");
+        match_key->on_set([this, match_key](float val)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+
+            if (!match_key->is_valid(val))
+                throw invalid_value_exception(to_string()
+                    << "Unsupported sync match key " << val << " is out of range.");
+
+            _match_key = static_cast<uint8_t>(val);
+            _slots.clear();
+        });
+        register_option(RS2_OPTION_SYNC_MATCH_KEY, match_key);
+
+        auto queue_size = std::make_shared<ptr_option<uint8_t>>(
+            1, 32, 1, 4,
+            &_queue_size, "Number of frames kept per stream while waiting for the other devices");
+        queue_size->on_set([this, queue_size](float val)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+
+            if (!queue_size->is_valid(val))
+                throw invalid_value_exception(to_string()
+                    << "Unsupported sync queue size " << val << " is out of range.");
+
+            _queue_size = static_cast<uint8_t>(val);
+        });
+        register_option(RS2_OPTION_FRAMES_QUEUE_SIZE, queue_size);
+
+        auto f = [&](frame_holder frame, synthetic_source_interface* source)
+        {
+            std::vector<frame_holder> sets;
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                auto now = environment::get_instance().get_time_service()->get_time();
+
+                if (auto composite = frame_cast<composite_frame>(frame.frame))
+                {
+                    for (size_t i = 0; i < composite->get_embedded_frames_count(); i++)
+                        enqueue(composite->take_frame(int(i)), now);
+                }
+                else
+                    enqueue(std::move(frame), now);
+
+                // streams that stopped delivering are no longer waited for
+                for (auto&& slot : _slots)
+                {
+                    auto timeout = std::max(100.0, slot.fps ? 5000.0 / slot.fps : 0.0);
+                    if (slot.active && now - slot.last_arrived > timeout)
+                    {
+                        slot.active = false;
+                        slot.frames.clear();
+                    }
+                }
+
+                match(source, sets);
+            }
+
+            for (auto&& set : sets)
+                get_source().frame_ready(std::move(set));
+        };
+        set_processing_callback(std::shared_ptr<rs2_frame_processor_callback>(
+            new internal_frame_processor_callback<decltype(f)>(f)));
+    }
+
+    void multi_device_syncer::enqueue(frame_holder f, double now)
+    {
+        auto stream = f->get_stream();
+        auto id = stream->get_unique_id();
+        auto it = std::find_if(_slots.begin(), _slots.end(), [id](const stream_slot& s) { return s.stream == id; });
+        if (it == _slots.end())
+        {
+            _slots.emplace_back(id);
+            it = _slots.end() - 1;
+        }
+
+        auto&& slot = *it;
+        if (!slot.active)
+        {
+            // a stream that restarts counts its frames anew
+            slot.active = true;
+            slot.has_base = false;
+        }
+        if (!slot.has_base)
+        {
+            slot.base = f->get_frame_number();
+            slot.has_base = true;
+        }
+        slot.fps = stream->get_framerate();
+        slot.last_arrived = now;
+
+        if (_match_key == sync_by_timestamp)
+        {
+            auto domain = f->get_frame_timestamp_domain();
+            if (_domain != domain && _domain != RS2_TIMESTAMP_DOMAIN_COUNT && !_domain_warned)
+            {
+                _domain_warned = true;
+                LOG_WARNING("Matching timestamps of the " << get_string(domain) << " and " << get_string(_domain)
+                    << " domains, the frames of different devices are only comparable in the global time domain");
+            }
+            _domain = domain;
+        }
+
+        slot.frames.push_back(std::move(f));
+        if (slot.frames.size() > _queue_size)
+            slot.frames.pop_front();
+    }
+
+    double multi_device_syncer::key(const stream_slot& slot, frame_holder& f) const
+    {
+        if (_match_key == sync_by_timestamp)
+            return f->get_frame_timestamp();
+        return static_cast<double>(static_cast<long long>(f->get_frame_number() - slot.base));
+    }
+
+    bool multi_device_syncer::are_equivalent(double a, double b) const
+    {
+        if (_match_key == sync_by_timestamp)
+            return std::fabs(a - b) < _tolerance;
+        return a == b;
+    }
+
+    void multi_device_syncer::match(synthetic_source_interface* source, std::vector<frame_holder>& sets)
+    {
+        // half the period of the fastest stream
+        unsigned int fps = 0;
+        for (auto&& slot : _slots)
+            if (slot.active)
+                fps = std::max(fps, slot.fps);
+        _tolerance = fps ? 500.0 / fps : 0.5;
+
+        while (true)
+        {
+            double latest = 0;
+            bool any = false;
+            for (auto&& slot : _slots)
+            {
+                if (!slot.active)
+                    continue;
+                if (slot.frames.empty())
+                    return;
+                auto k = key(slot, slot.frames.front());
+                latest = any ? std::max(latest, k) : k;
+                any = true;
+            }
+            if (!any)
+                return;
+
+            // frames older than the latest head can't be matched anymore, the later frames of their stream are newer
+            bool complete = true;
+            for (auto&& slot : _slots)
+            {
+                if (!slot.active)
+                    continue;
+                while (!slot.frames.empty() && !are_equivalent(key(slot, slot.frames.front()), latest))
+                    slot.frames.pop_front();
+                complete = complete && !slot.frames.empty();
+            }
+            if (!complete)
+                return;
+
+            composite_frame_builder set;
+            for (auto&& slot : _slots)
+            {
+                if (!slot.active)
+                    continue;
+                set.push_back(std::move(slot.frames.front()));
+                slot.frames.pop_front();
+            }
+
+            frame_holder composite = source->allocate_composite_frame(set);
+            if (!composite)
+            {
+                LOG_ERROR("Failed to allocate composite frame");
+                return;
+            }
+            sets.push_back(std::move(composite));
+        }
+    }
 }
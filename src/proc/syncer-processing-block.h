@@ -7,6 +7,7 @@
 
 #include <stdint.h>
 #include <vector>
+#include <deque>
 #include <mutex>
 #include <memory>
 
@@ -26,4 +27,48 @@ namespace librealsense
     private:
         std::unique_ptr<timestamp_composite_matcher> _matcher;
     };
+
+    enum sync_match_key : uint8_t
+    {
+        sync_by_frame_counter,
+        sync_by_timestamp,
+        sync_match_key_count
+    };
+
+    // Matches the frames of several devices into one frameset per trigger. Framesets that arrive are split into their
+    // frames, every stream has a bounded queue, and a set is published once the head frames of all the streams that
+    // are delivering have the same key. Frame counters are counted from the first frame of every stream, so the cameras
+    // should start on the same trigger. Timestamps need a domain the devices share, the global time domain
+    class multi_device_syncer : public processing_block
+    {
+    public:
+        multi_device_syncer();
+
+    private:
+        struct stream_slot
+        {
+            explicit stream_slot(int stream) : stream(stream) {}
+
+            int stream;
+            std::deque<frame_holder> frames;
+            bool active = true;
+            bool has_base = false;
+            unsigned long long base = 0;
+            double last_arrived = 0;
+            unsigned int fps = 0;
+        };
+
+        void enqueue(frame_holder f, double now);
+        double key(const stream_slot& slot, frame_holder& f) const;
+        bool are_equivalent(double a, double b) const;
+        // Moves every complete set to the output, dropping the frames no set can have anymore
+        void match(synthetic_source_interface* source, std::vector<frame_holder>& sets);
+
+        uint8_t _match_key = sync_by_frame_counter;
+        uint8_t _queue_size = 4;
+        double _tolerance = 0;
+        std::deque<stream_slot> _slots;
+        rs2_timestamp_domain _domain = RS2_TIMESTAMP_DOMAIN_COUNT;
+        bool _domain_warned = false;
+    };
 }
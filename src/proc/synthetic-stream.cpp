@@ -2,11 +2,32 @@
 // Copyright(c) 2017 Intel Corporation. All Rights Reserved.
 
 #include "core/video.h"
+#include "context.h"
 #include "proc/synthetic-stream.h"
 #include "option.h"
+#include "profiling.h"
 
 namespace librealsense
 {
+    void register_processing_threads_option(options_container& block, uint8_t& threads, parallel_executor& executor,
+        std::mutex& mutex, const std::string& description, const std::string& name)
+    {
+        auto processing_threads = std::make_shared<ptr_option<uint8_t>>(0, 64, 1, processing_threads_default,
+            &threads, description);
+        processing_threads->on_set([&threads, &executor, &mutex, processing_threads, name](float val)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            if (!processing_threads->is_valid(val))
+                throw invalid_value_exception(to_string()
+                    << "Unsupported " << name << " threads count: " << val << " is out of range.");
+
+            threads = static_cast<uint8_t>(val);
+            executor.resize(threads);
+        });
+        block.register_option(RS2_OPTION_PROCESSING_THREADS, processing_threads);
+    }
+
     void processing_block::set_processing_callback(frame_processor_callback_ptr callback)
     {
         std::lock_guard<std::mutex> lock(_mutex);
@@ -22,11 +43,15 @@ namespace librealsense
         _source_wrapper(_source)
     {
         register_option(RS2_OPTION_FRAMES_QUEUE_SIZE, _source.get_published_size_option());
+        register_option(RS2_OPTION_CALLBACK_QUEUE_SIZE, _source.get_callback_queue_size_option());
         _source.init(std::shared_ptr<metadata_parser_map>());
     }
 
     void processing_block::invoke(frame_holder f)
     {
+        LRS_PROFILE_ZONE("processing block");
+        LRS_PROFILE_ZONE_NAME(profiling::type_name(typeid(*this)));
+        if (f) LRS_PROFILE_FRAME(f->get_frame_number());
         auto callback = _source.begin_callback();
         try
         {
@@ -44,6 +69,16 @@ namespace librealsense
         }
     }
 
+    frame_holder processing_block::process(frame_holder f)
+    {
+        frame_holder result;
+        {
+            synthetic_source::capture_guard capture(&_source_wrapper, &result);
+            invoke(std::move(f));
+        }
+        return result;
+    }
+
     generic_processing_block::generic_processing_block()
     {
         auto on_frame = [this](rs2::frame f, const rs2::frame_source& source)
@@ -52,13 +87,18 @@ namespace librealsense
 
             std::vector<rs2::frame> frames_to_process;
 
-            frames_to_process.push_back(f);
+            // A single frame is moved rather than copied, keeping its reference count at one for reuse_frame
             if (auto composite = f.as<rs2::frameset>())
+            {
+                frames_to_process.push_back(f);
                 for (auto f : composite)
                     frames_to_process.push_back(f);
+            }
+            else
+                frames_to_process.push_back(std::move(f));
 
             std::vector<rs2::frame> results;
-            for (auto f : frames_to_process)
+            for (auto&& f : frames_to_process)
             {
                 if (should_process(f))
                 {
@@ -80,7 +120,7 @@ namespace librealsense
                 }
             }
 
-            auto out = prepare_output(source, f, results);
+            auto out = prepare_output(source, frames_to_process.front(), results);
             if(out)
                 source.frame_ready(out);
         };
@@ -89,6 +129,16 @@ namespace librealsense
         processing_block::set_processing_callback(std::shared_ptr<rs2_frame_processor_callback>(callback));
     }
 
+    rs2::frame generic_processing_block::reuse_frame(const rs2::frame& f, const rs2::stream_profile& target) const
+    {
+        auto fi = (frame_interface*)f.get();
+        if (!fi || !fi->is_uniquely_owned())
+            return rs2::frame();
+
+        fi->set_stream(std::dynamic_pointer_cast<stream_profile_interface>(target.get()->profile->shared_from_this()));
+        return f;
+    }
+
     rs2::frame generic_processing_block::prepare_output(const rs2::frame_source& source, rs2::frame input, std::vector<rs2::frame> results)
     {
         // this function prepares the processing block output frame(s) by the following heuristic:
@@ -97,7 +147,7 @@ namespace librealsense
         // if one of the input frames has the same stream type and format as the processed frame,
         //     remove the input frame from the output frameset (i.e. temporal filter), otherwise kepp the input frame (i.e. colorizer).
         // the only exception is in case one of the input frames is z16 or disparity and the result frame is disparity or z16 respectively,
-        // in this case the the input frmae will be removed.
+        // in this case the the input frmae will be removed. The same goes for z16 and its compressed form.
 
         if (results.empty())
         {
@@ -106,6 +156,7 @@ namespace librealsense
 
         bool disparity_result_frame = false;
         bool depth_result_frame = false;
+        bool compressed_result_frame = false;
 
         for (auto f : results)
         {
@@ -114,6 +165,8 @@ namespace librealsense
                 disparity_result_frame = true;
             if (format == RS2_FORMAT_Z16)
                 depth_result_frame = true;
+            if (format == RS2_FORMAT_Z16_RVL)
+                compressed_result_frame = true;
         }
 
         std::vector<rs2::frame> original_set;
@@ -121,9 +174,9 @@ namespace librealsense
             composite.foreach([&](const rs2::frame& frame)
             {
                 auto format = frame.get_profile().format();
-                if (depth_result_frame && (format == RS2_FORMAT_DISPARITY32 || format == RS2_FORMAT_DISPARITY16))
+                if (depth_result_frame && (format == RS2_FORMAT_DISPARITY32 || format == RS2_FORMAT_DISPARITY16 || format == RS2_FORMAT_Z16_RVL))
                     return;
-                if (disparity_result_frame && format == RS2_FORMAT_Z16)
+                if ((disparity_result_frame || compressed_result_frame) && format == RS2_FORMAT_Z16)
                     return;
                 original_set.push_back(frame);
             });
@@ -214,43 +267,70 @@ namespace librealsense
     {
         if (!frame || frame.is<rs2::frameset>())
             return false;
-        auto profile = frame.get_profile();
-        rs2_stream stream = profile.stream_type();
-        rs2_format format = profile.format();
-        int index = profile.stream_index();
-
-        if (_stream_filter.stream != RS2_STREAM_ANY && _stream_filter.stream != stream)
-            return false;
-        if (is_z_or_disparity(_stream_filter.format))
+        return match_profile(frame, [this](const rs2::stream_profile& profile)
         {
-            if (_stream_filter.format != RS2_FORMAT_ANY && !is_z_or_disparity(format))
-                return false;
-        }
-        else
-        {
-            if (_stream_filter.format != RS2_FORMAT_ANY && _stream_filter.format != format)
+            rs2_stream stream = profile.stream_type();
+            rs2_format format = profile.format();
+            int index = profile.stream_index();
+
+            if (_stream_filter.stream != RS2_STREAM_ANY && _stream_filter.stream != stream)
                 return false;
-        }
+            if (is_z_or_disparity(_stream_filter.format))
+            {
+                if (_stream_filter.format != RS2_FORMAT_ANY && !is_z_or_disparity(format))
+                    return false;
+            }
+            else
+            {
+                if (_stream_filter.format != RS2_FORMAT_ANY && _stream_filter.format != format)
+                    return false;
+            }
 
-        if (_stream_filter.index != -1 && _stream_filter.index != index)
-            return false;
-        return true;
+            if (_stream_filter.index != -1 && _stream_filter.index != index)
+                return false;
+            return true;
+        });
     }
 
     bool stream_filter_processing_block::should_process(const rs2::frame& frame)
     {
         if (!frame || frame.is<rs2::frameset>())
             return false;
-        auto profile = frame.get_profile();
-        return _stream_filter.match(frame);
+        return match_profile(frame, [this](const rs2::stream_profile& profile)
+        {
+            stream_filter filter(profile.stream_type(), profile.format(), profile.stream_index());
+            return _stream_filter.match(filter);
+        });
+    }
+
+    namespace
+    {
+        // The source capturing the frames made ready on this thread, and where to
+        thread_local std::pair<const synthetic_source*, frame_holder*> captured_source(nullptr, nullptr);
+    }
+
+    synthetic_source::capture_guard::capture_guard(const synthetic_source* source, frame_holder* output)
+        : _previous(captured_source)
+    {
+        captured_source = { source, output };
+    }
+
+    synthetic_source::capture_guard::~capture_guard()
+    {
+        captured_source = _previous;
     }
 
     void synthetic_source::frame_ready(frame_holder result)
     {
+        if (captured_source.first == this)
+        {
+            *captured_source.second = std::move(result);
+            return;
+        }
         _actual_source.invoke_callback(std::move(result));
     }
 
-    frame_interface* synthetic_source::allocate_points(std::shared_ptr<stream_profile_interface> stream, frame_interface* original)
+    frame_interface* synthetic_source::allocate_points(std::shared_ptr<stream_profile_interface> stream, frame_interface* original, bool pixel_indices, bool colors)
     {
         auto vid_stream = dynamic_cast<video_stream_profile_interface*>(stream.get());
         if (vid_stream)
@@ -263,8 +343,14 @@ namespace librealsense
             data.system_time = _actual_source.get_time();
             data.is_blocking = original->is_blocking();
 
-            auto res = _actual_source.alloc_frame(RS2_EXTENSION_POINTS, vid_stream->get_width() * vid_stream->get_height() * sizeof(float) * 5, data, true);
+            auto vertex_size = sizeof(float) * 5 + (pixel_indices ? sizeof(int) : 0) + (colors ? 3 : 0);
+            auto res = _actual_source.alloc_frame(RS2_EXTENSION_POINTS, vid_stream->get_width() * vid_stream->get_height() * vertex_size, data, true);
             if (!res) throw wrong_api_call_sequence_exception("Out of frame resources!");
+            if (auto pts = frame_cast<points>(res))
+            {
+                pts->set_pixel_indices(pixel_indices);
+                pts->set_vertex_colors(colors);
+            }
             res->set_sensor(original->get_sensor());
             res->set_stream(stream);
             return res;
@@ -324,6 +410,8 @@ namespace librealsense
 
         auto of = dynamic_cast<frame*>(original);
         frame_additional_data data = of->additional_data;
+        // Only the frames of the sensors are traced, the processed frames would be counted as their inputs
+        data.traced = false;
         auto res = _actual_source.alloc_frame(frame_type, stride * height, data, true);
         if (!res) throw wrong_api_call_sequence_exception("Out of frame resources!");
         vf = static_cast<video_frame*>(res);
@@ -332,10 +420,10 @@ namespace librealsense
         vf->set_sensor(original->get_sensor());
         res->set_stream(stream);
 
-        if (frame_type == RS2_EXTENSION_DEPTH_FRAME)
+        if (frame_type == RS2_EXTENSION_DEPTH_FRAME || frame_type == RS2_EXTENSION_DISPARITY_FRAME)
         {
-            original->acquire();
-            (dynamic_cast<depth_frame*>(res))->set_original(original);
+            if (auto df = dynamic_cast<depth_frame*>(original))
+                static_cast<depth_frame*>(res)->set_scale_from(*df);
         }
 
         return res;
@@ -344,19 +432,21 @@ namespace librealsense
     int get_embeded_frames_size(frame_interface* f)
     {
         if (f == nullptr) return 0;
-        if (auto c = dynamic_cast<composite_frame*>(f))
+        if (auto c = frame_cast<composite_frame>(f))
             return static_cast<int>(c->get_embedded_frames_count());
         return 1;
     }
 
     void copy_frames(frame_holder from, frame_interface**& target)
     {
-        if (auto comp = dynamic_cast<composite_frame*>(from.frame))
+        if (auto comp = frame_cast<composite_frame>(from.frame))
         {
             auto frame_buff = comp->get_frames();
+            // The storage of a new set isn't zero-filled, so the entries are moved rather than swapped with it
             for (size_t i = 0; i < comp->get_embedded_frames_count(); i++)
             {
-                std::swap(*target, frame_buff[i]);
+                *target = frame_buff[i];
+                frame_buff[i] = nullptr;
                 target++;
             }
             from.frame->disable_continuation();
@@ -370,23 +460,32 @@ namespace librealsense
     }
 
     frame_interface* synthetic_source::allocate_composite_frame(std::vector<frame_holder> holders)
+    {
+        composite_frame_builder builder;
+        for (auto&& f : holders)
+            builder.push_back(std::move(f));
+        return allocate_composite_frame(builder);
+    }
+
+    frame_interface* synthetic_source::allocate_composite_frame(composite_frame_builder& holders)
     {
         frame_additional_data d{};
 
         auto req_size = 0;
+        auto blocking = false;
         for (auto&& f : holders)
+        {
             req_size += get_embeded_frames_size(f.frame);
+            blocking = blocking || f.is_blocking();
+        }
 
+        // The composite archive recycles the storage of released framesets, which has the same size for the same streams
         auto res = _actual_source.alloc_frame(RS2_EXTENSION_COMPOSITE_FRAME, req_size * sizeof(rs2_frame*), d, true);
         if (!res) return nullptr;
 
         auto cf = static_cast<composite_frame*>(res);
-
-        for (auto&& f : holders)
-        {
-            if (f.is_blocking())
-                res->set_blocking(true);
-        }
+        if (blocking)
+            res->set_blocking(true);
 
         auto frames = cf->get_frames();
         for (auto&& f : holders)
@@ -395,9 +494,10 @@ namespace librealsense
 
         auto releaser = [frames, req_size]()
         {
+            // Frames taken out of the set already gave their reference away
             for (auto i = 0; i < req_size; i++)
             {
-                frames[i]->release();
+                if (frames[i]) frames[i]->release();
                 frames[i] = nullptr;
             }
         };
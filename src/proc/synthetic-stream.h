@@ -11,6 +11,13 @@
 
 namespace librealsense
 {
+    // The profile object of a frame, for the blocks to compare by address. Unlike rs2::frame::get_profile
+    // it does not query the profile data
+    inline const rs2_stream_profile* frame_profile(const rs2::frame& f)
+    {
+        return ((frame_interface*)f.get())->get_stream()->get_c_wrapper();
+    }
+
     class synthetic_source : public synthetic_source_interface
     {
     public:
@@ -28,18 +35,39 @@ namespace librealsense
             rs2_extension frame_type = RS2_EXTENSION_VIDEO_FRAME) override;
 
         frame_interface* allocate_composite_frame(std::vector<frame_holder> frames) override;
+        frame_interface* allocate_composite_frame(composite_frame_builder& frames) override;
 
-        frame_interface* allocate_points(std::shared_ptr<stream_profile_interface> stream, frame_interface* original) override;
+        frame_interface* allocate_points(std::shared_ptr<stream_profile_interface> stream, frame_interface* original, bool pixel_indices = false, bool colors = false) override;
 
         void frame_ready(frame_holder result) override;
 
         rs2_source* get_c_wrapper() override { return _c_wrapper.get(); }
 
+        // While alive, the frames the source makes ready on the calling thread are moved into the holder instead
+        // of being passed to the output callback. Guards of other sources may be nested inside
+        class capture_guard
+        {
+        public:
+            capture_guard(const synthetic_source* source, frame_holder* output);
+            ~capture_guard();
+
+        private:
+            std::pair<const synthetic_source*, frame_holder*> _previous;
+        };
+
     private:
         frame_source & _actual_source;
         std::shared_ptr<rs2_source> _c_wrapper;
     };
 
+    // Worker threads per frame of the blocks that split their frames between threads, 0 selects all hardware threads
+    const uint8_t processing_threads_default = 1;
+
+    // Registers RS2_OPTION_PROCESSING_THREADS on a block, resizing its executor under its lock. The description tells
+    // what the threads do, and the name of the block is reported when the value is out of range
+    void register_processing_threads_option(options_container& block, uint8_t& threads, parallel_executor& executor,
+        std::mutex& mutex, const std::string& description, const std::string& name);
+
     class processing_block : public processing_block_interface, public options_container
     {
     public:
@@ -48,6 +76,7 @@ namespace librealsense
         void set_processing_callback(frame_processor_callback_ptr callback) override;
         void set_output_callback(frame_callback_ptr callback) override;
         void invoke(frame_holder frames) override;
+        frame_holder process(frame_holder frame) override;
         synthetic_source_interface& get_source() override { return _source_wrapper; }
 
         virtual ~processing_block() { _source.flush(); }
@@ -69,6 +98,10 @@ namespace librealsense
 
         virtual bool should_process(const rs2::frame& frame) = 0;
         virtual rs2::frame process_frame(const rs2::frame_source& source, const rs2::frame& f) = 0;
+
+        // Returns f relabeled with the target profile when the block holds the only reference to it, so filters
+        // that transform the pixels in place can skip the new frame and the copy. Returns an empty frame otherwise
+        rs2::frame reuse_frame(const rs2::frame& f, const rs2::stream_profile& target) const;
     };
 
     struct stream_filter
@@ -131,6 +164,26 @@ namespace librealsense
         stream_filter _stream_filter;
 
         bool should_process(const rs2::frame& frame) override;
+
+        // The frames of a stream share its profile, a check is evaluated again only when the profile or the
+        // filter changed. The last profile is held so that its address is not reused meanwhile
+        template<class T>
+        bool match_profile(const rs2::frame& frame, T match)
+        {
+            auto stream = ((frame_interface*)frame.get())->get_stream();
+            if (stream != _matched_stream || _stream_filter != _matched_filter)
+            {
+                _matched = match(frame.get_profile());
+                _matched_stream = stream;
+                _matched_filter = _stream_filter;
+            }
+            return _matched;
+        }
+
+    private:
+        std::shared_ptr<stream_profile_interface> _matched_stream;
+        stream_filter _matched_filter;
+        bool _matched = false;
     };
 
     class depth_processing_block : public stream_filter_processing_block
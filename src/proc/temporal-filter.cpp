@@ -10,6 +10,14 @@
 #include "proc/synthetic-stream.h"
 #include "proc/temporal-filter.h"
 
+#ifdef __SSSE3__
+#include <tmmintrin.h> // For SSSE3 intrinsics
+#endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h> // For NEON intrinsics
+#define RS2_NEON
+#endif
+
 namespace librealsense
 {
     const size_t PERSISTENCE_MAP_NUM = 9;
@@ -32,13 +40,233 @@ namespace librealsense
     const uint8_t temp_delta_default = 20;
     const uint8_t temp_delta_step = 1;
 
+    // The vectorized paths below process eight pixels per step and produce the same output as temp_jw_smooth_range.
+    // Each lane evaluates every case of the per-pixel logic and the results are merged with the lane masks:
+    // a valid pixel that agrees with the history is blended, a valid one that does not restarts the history,
+    // and a hole is filled from the last frame when the persistence map deems its history credible.
+#if defined(__SSSE3__)
+    inline __m128i select_si128(__m128i mask, __m128i a, __m128i b)
+    {
+        return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+    }
+
+    inline __m128 select_ps(__m128 mask, __m128 a, __m128 b)
+    {
+        return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+    }
+
+    // Looks up eight history bytes in the packed persistence map, yielding 0xFF for credible histories
+    inline __m128i credible_histories(__m128i hist, __m128i bits_lo, __m128i bits_hi)
+    {
+        const __m128i bit_of = _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+        __m128i idx = _mm_and_si128(_mm_srli_epi16(hist, 3), _mm_set1_epi8(0x1F));
+        __m128i bytes = select_si128(_mm_cmpgt_epi8(idx, _mm_set1_epi8(15)),
+            _mm_shuffle_epi8(bits_hi, idx), _mm_shuffle_epi8(bits_lo, idx));
+        __m128i bit = _mm_shuffle_epi8(bit_of, _mm_and_si128(hist, _mm_set1_epi8(7)));
+        return _mm_cmpeq_epi8(_mm_and_si128(bytes, bit), bit);
+    }
+
+    // Shifts the current frame into the history: restarted for valid pixels that disagree, extended otherwise
+    inline __m128i update_histories(__m128i hist, __m128i cur_valid, __m128i agree)
+    {
+        __m128i shifted = _mm_and_si128(_mm_srli_epi16(hist, 1), _mm_set1_epi8(0x7F));
+        return select_si128(cur_valid, _mm_or_si128(_mm_and_si128(agree, shifted), _mm_set1_epi8(-128)), shifted);
+    }
+
+    static size_t temp_jw_smooth_simd(uint16_t* frame, uint16_t* last_frame, uint8_t* history, size_t count,
+        float alpha, float one_minus_alpha, uint16_t delta_z, const uint8_t* persistence_bits)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i bias = _mm_set1_epi16(-32768);
+        const __m128i max_diff = _mm_set1_epi16(static_cast<short>(delta_z - 1));
+        const __m128 a = _mm_set1_ps(alpha), oma = _mm_set1_ps(one_minus_alpha);
+        const __m128i bits_lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(persistence_bits));
+        const __m128i bits_hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(persistence_bits + 16));
+
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            __m128i cur = _mm_loadu_si128(reinterpret_cast<const __m128i*>(frame + i));
+            __m128i prev = _mm_loadu_si128(reinterpret_cast<const __m128i*>(last_frame + i));
+            __m128i hist = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(history + i));
+
+            __m128i cur_valid = _mm_xor_si128(_mm_cmpeq_epi16(cur, zero), _mm_cmpeq_epi16(zero, zero));
+            __m128i prev_valid = _mm_xor_si128(_mm_cmpeq_epi16(prev, zero), _mm_cmpeq_epi16(zero, zero));
+            __m128i diff = _mm_or_si128(_mm_subs_epu16(cur, prev), _mm_subs_epu16(prev, cur));
+            __m128i agree = _mm_and_si128(_mm_and_si128(cur_valid, prev_valid),
+                _mm_cmpeq_epi16(_mm_subs_epu16(diff, max_diff), zero));
+
+            __m128 lo = _mm_add_ps(_mm_mul_ps(a, _mm_cvtepi32_ps(_mm_unpacklo_epi16(cur, zero))),
+                _mm_mul_ps(oma, _mm_cvtepi32_ps(_mm_unpacklo_epi16(prev, zero))));
+            __m128 hi = _mm_add_ps(_mm_mul_ps(a, _mm_cvtepi32_ps(_mm_unpackhi_epi16(cur, zero))),
+                _mm_mul_ps(oma, _mm_cvtepi32_ps(_mm_unpackhi_epi16(prev, zero))));
+            // Truncate to 16 bit through the signed pack, SSSE3 has no unsigned one
+            __m128i result = _mm_xor_si128(_mm_packs_epi32(
+                _mm_sub_epi32(_mm_cvttps_epi32(lo), _mm_set1_epi32(32768)),
+                _mm_sub_epi32(_mm_cvttps_epi32(hi), _mm_set1_epi32(32768))), bias);
+
+            __m128i credible = credible_histories(hist, bits_lo, bits_hi);
+            __m128i fill = _mm_andnot_si128(cur_valid, _mm_and_si128(prev_valid, _mm_unpacklo_epi8(credible, credible)));
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(frame + i), select_si128(agree, result, select_si128(fill, prev, cur)));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(last_frame + i), select_si128(agree, result, select_si128(cur_valid, cur, prev)));
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(history + i),
+                update_histories(hist, _mm_packs_epi16(cur_valid, cur_valid), _mm_packs_epi16(agree, agree)));
+        }
+        return i;
+    }
+
+    static size_t temp_jw_smooth_simd(float* frame, float* last_frame, uint8_t* history, size_t count,
+        float alpha, float one_minus_alpha, float delta_z, const uint8_t* persistence_bits)
+    {
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 sign = _mm_set1_ps(-0.f);
+        const __m128 delta = _mm_set1_ps(delta_z);
+        const __m128 a = _mm_set1_ps(alpha), oma = _mm_set1_ps(one_minus_alpha);
+        const __m128i bits_lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(persistence_bits));
+        const __m128i bits_hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(persistence_bits + 16));
+
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            __m128i hist = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(history + i));
+            __m128i credible = credible_histories(hist, bits_lo, bits_hi);
+            credible = _mm_unpacklo_epi8(credible, credible);
+
+            __m128i cur_valid[2], agree[2];
+            for (int h = 0; h < 2; h++)
+            {
+                __m128 cur = _mm_loadu_ps(frame + i + h * 4);
+                __m128 prev = _mm_loadu_ps(last_frame + i + h * 4);
+
+                __m128 cv = _mm_cmpneq_ps(cur, zero);
+                __m128 pv = _mm_cmpneq_ps(prev, zero);
+                __m128 ag = _mm_and_ps(_mm_and_ps(cv, pv), _mm_cmplt_ps(_mm_andnot_ps(sign, _mm_sub_ps(cur, prev)), delta));
+                __m128 result = _mm_add_ps(_mm_mul_ps(a, cur), _mm_mul_ps(oma, prev));
+                __m128 cred = _mm_castsi128_ps(h ? _mm_unpackhi_epi16(credible, credible) : _mm_unpacklo_epi16(credible, credible));
+                __m128 fill = _mm_andnot_ps(cv, _mm_and_ps(pv, cred));
+
+                _mm_storeu_ps(frame + i + h * 4, select_ps(ag, result, select_ps(fill, prev, cur)));
+                _mm_storeu_ps(last_frame + i + h * 4, select_ps(ag, result, select_ps(cv, cur, prev)));
+                cur_valid[h] = _mm_castps_si128(cv);
+                agree[h] = _mm_castps_si128(ag);
+            }
+
+            __m128i cv16 = _mm_packs_epi32(cur_valid[0], cur_valid[1]);
+            __m128i ag16 = _mm_packs_epi32(agree[0], agree[1]);
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(history + i),
+                update_histories(hist, _mm_packs_epi16(cv16, cv16), _mm_packs_epi16(ag16, ag16)));
+        }
+        return i;
+    }
+#elif defined(RS2_NEON)
+    inline uint8x8_t credible_histories(uint8x8_t hist, const uint8x8x4_t& bits)
+    {
+        uint8x8_t bytes = vtbl4_u8(bits, vshr_n_u8(hist, 3));
+        uint8x8_t bit = vtbl1_u8(vcreate_u8(0x8040201008040201ULL), vand_u8(hist, vdup_n_u8(7)));
+        return vtst_u8(bytes, bit);
+    }
+
+    inline uint8x8_t update_histories(uint8x8_t hist, uint8x8_t cur_valid, uint8x8_t agree)
+    {
+        uint8x8_t shifted = vshr_n_u8(hist, 1);
+        return vbsl_u8(cur_valid, vorr_u8(vand_u8(agree, shifted), vdup_n_u8(0x80)), shifted);
+    }
+
+    inline uint8x8x4_t load_persistence_bits(const uint8_t* persistence_bits)
+    {
+        uint8x8x4_t bits;
+        for (int k = 0; k < 4; k++)
+            bits.val[k] = vld1_u8(persistence_bits + k * 8);
+        return bits;
+    }
+
+    static size_t temp_jw_smooth_simd(uint16_t* frame, uint16_t* last_frame, uint8_t* history, size_t count,
+        float alpha, float one_minus_alpha, uint16_t delta_z, const uint8_t* persistence_bits)
+    {
+        const uint8x8x4_t bits = load_persistence_bits(persistence_bits);
+
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            uint16x8_t cur = vld1q_u16(frame + i);
+            uint16x8_t prev = vld1q_u16(last_frame + i);
+            uint8x8_t hist = vld1_u8(history + i);
+
+            uint16x8_t cur_valid = vtstq_u16(cur, cur);
+            uint16x8_t prev_valid = vtstq_u16(prev, prev);
+            uint16x8_t agree = vandq_u16(vandq_u16(cur_valid, prev_valid), vcltq_u16(vabdq_u16(cur, prev), vdupq_n_u16(delta_z)));
+
+            float32x4_t lo = vaddq_f32(vmulq_n_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(cur))), alpha),
+                vmulq_n_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(prev))), one_minus_alpha));
+            float32x4_t hi = vaddq_f32(vmulq_n_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(cur))), alpha),
+                vmulq_n_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(prev))), one_minus_alpha));
+            uint16x8_t result = vcombine_u16(vmovn_u32(vcvtq_u32_f32(lo)), vmovn_u32(vcvtq_u32_f32(hi)));
+
+            uint16x8_t credible = vreinterpretq_u16_s16(vmovl_s8(vreinterpret_s8_u8(credible_histories(hist, bits))));
+            uint16x8_t fill = vbicq_u16(vandq_u16(prev_valid, credible), cur_valid);
+
+            vst1q_u16(frame + i, vbslq_u16(agree, result, vbslq_u16(fill, prev, cur)));
+            vst1q_u16(last_frame + i, vbslq_u16(agree, result, vbslq_u16(cur_valid, cur, prev)));
+            vst1_u8(history + i, update_histories(hist, vmovn_u16(cur_valid), vmovn_u16(agree)));
+        }
+        return i;
+    }
+
+    static size_t temp_jw_smooth_simd(float* frame, float* last_frame, uint8_t* history, size_t count,
+        float alpha, float one_minus_alpha, float delta_z, const uint8_t* persistence_bits)
+    {
+        const uint8x8x4_t bits = load_persistence_bits(persistence_bits);
+        const float32x4_t zero = vdupq_n_f32(0.f);
+
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            uint8x8_t hist = vld1_u8(history + i);
+            int16x8_t credible = vmovl_s8(vreinterpret_s8_u8(credible_histories(hist, bits)));
+
+            uint32x4_t cur_valid[2], agree[2];
+            for (int h = 0; h < 2; h++)
+            {
+                float32x4_t cur = vld1q_f32(frame + i + h * 4);
+                float32x4_t prev = vld1q_f32(last_frame + i + h * 4);
+
+                uint32x4_t cv = vmvnq_u32(vceqq_f32(cur, zero));
+                uint32x4_t pv = vmvnq_u32(vceqq_f32(prev, zero));
+                uint32x4_t ag = vandq_u32(vandq_u32(cv, pv), vcltq_f32(vabdq_f32(cur, prev), vdupq_n_f32(delta_z)));
+                float32x4_t result = vaddq_f32(vmulq_n_f32(cur, alpha), vmulq_n_f32(prev, one_minus_alpha));
+                uint32x4_t cred = vreinterpretq_u32_s32(vmovl_s16(h ? vget_high_s16(credible) : vget_low_s16(credible)));
+                uint32x4_t fill = vbicq_u32(vandq_u32(pv, cred), cv);
+
+                vst1q_f32(frame + i + h * 4, vbslq_f32(ag, result, vbslq_f32(fill, prev, cur)));
+                vst1q_f32(last_frame + i + h * 4, vbslq_f32(ag, result, vbslq_f32(cv, cur, prev)));
+                cur_valid[h] = cv;
+                agree[h] = ag;
+            }
+
+            vst1_u8(history + i, update_histories(hist,
+                vmovn_u16(vcombine_u16(vmovn_u32(cur_valid[0]), vmovn_u32(cur_valid[1]))),
+                vmovn_u16(vcombine_u16(vmovn_u32(agree[0]), vmovn_u32(agree[1])))));
+        }
+        return i;
+    }
+#else
+    template<typename T>
+    static size_t temp_jw_smooth_simd(T*, T*, uint8_t*, size_t, float, float, T, const uint8_t*)
+    {
+        return 0;
+    }
+#endif
+
     temporal_filter::temporal_filter() : _persistence_param(persistence_default),
         _alpha_param(temp_alpha_default),
         _one_minus_alpha(1- _alpha_param),
         _delta_param(temp_delta_default),
         _width(0), _height(0), _stride(0), _bpp(0),
         _extension_type(RS2_EXTENSION_DEPTH_FRAME),
-        _current_frm_size_pixels(0)
+        _current_frm_size_pixels(0),
+        _processing_threads(processing_threads_default),
+        _executor(processing_threads_default)
     {
         _stream_filter.stream = RS2_STREAM_DEPTH;
         _stream_filter.format = RS2_FORMAT_Z16;
@@ -101,6 +329,9 @@ namespace librealsense
         register_option(RS2_OPTION_FILTER_SMOOTH_ALPHA, temporal_filter_alpha);
         register_option(RS2_OPTION_FILTER_SMOOTH_DELTA, temporal_filter_delta);
 
+        register_processing_threads_option(*this, _processing_threads, _executor, _mutex,
+            "Number of threads used to filter each frame, 0 for all hardware threads", "temporal");
+
         on_set_persistence_control(_persistence_param);
         on_set_delta(_delta_param);
         on_set_alpha(_alpha_param);
@@ -109,25 +340,116 @@ namespace librealsense
     rs2::frame temporal_filter::process_frame(const rs2::frame_source& source, const rs2::frame& f)
     {
         update_configuration(f);
-        auto tgt = prepare_target_frame(f, source);
 
         // Temporal filter execution
-        if (_extension_type == RS2_EXTENSION_DISPARITY_FRAME)
-            temp_jw_smooth<float>(const_cast<void*>(tgt.get_data()), _last_frame.data(), _history.data());
-        else
-            temp_jw_smooth<uint16_t>(const_cast<void*>(tgt.get_data()), _last_frame.data(), _history.data());
+        if (_extension_type != RS2_EXTENSION_DISPARITY_FRAME)
+            return smooth_depth_frame(f, source);
 
+        auto tgt = prepare_target_frame(f, source);
+        temp_jw_smooth<float>(const_cast<void*>(tgt.get_data()), _last_frame.data(), _history.data());
         return tgt;
     }
 
+    rs2::frame temporal_filter::smooth_depth_frame(const rs2::frame& f, const rs2::frame_source& source)
+    {
+        auto tgt = prepare_target_frame(f, source);
+        temp_jw_smooth<uint16_t>(const_cast<void*>(tgt.get_data()), _last_frame.data(), _history.data());
+        return tgt;
+    }
+
+    template<typename T>
+    void temporal_filter::temp_jw_smooth(void* frame_data, void * _last_frame_data, uint8_t *history)
+    {
+        static_assert((std::is_arithmetic<T>::value), "temporal filter assumes numeric types");
+
+        auto frame          = reinterpret_cast<T*>(frame_data);
+        auto _last_frame    = reinterpret_cast<T*>(_last_frame_data);
+
+        // Pixels are independent of each other, split the image into chunks of whole vector steps
+        const size_t alignment = 16;
+        size_t chunks = std::max<size_t>(1, std::min<size_t>(_executor.size() > 1 ? _executor.size() * 4 : 1, _current_frm_size_pixels / alignment));
+        _executor.for_each(chunks, [&](size_t c)
+        {
+            size_t begin = _current_frm_size_pixels * c / chunks / alignment * alignment;
+            size_t end = (c + 1 == chunks) ? _current_frm_size_pixels : _current_frm_size_pixels * (c + 1) / chunks / alignment * alignment;
+            temp_jw_smooth_range(frame, _last_frame, history, begin, end);
+        });
+    }
+
+    // Distance of two pixels in their own type, without the round trip through double of fabs
+    static inline uint16_t abs_diff(uint16_t a, uint16_t b) { return a > b ? a - b : b - a; }
+    static inline float abs_diff(float a, float b) { return std::fabs(a - b); }
+
+    template<typename T>
+    void temporal_filter::temp_jw_smooth_range(T* frame, T* _last_frame, uint8_t *history, size_t begin, size_t end)
+    {
+        // Parameters are read once, disparity stores could otherwise alias the float members and force reloads
+        const T delta_z = static_cast<T>(_delta_param);
+        const float alpha = _alpha_param;
+        const float one_minus_alpha = _one_minus_alpha;
+        const uint8_t* persistence_map = _persistence_map.data();
+
+        size_t i = begin + temp_jw_smooth_simd(frame + begin, _last_frame + begin, history + begin, end - begin,
+            alpha, one_minus_alpha, delta_z, _persistence_bits.data());
+
+        // The history is a shift register: each frame moves it one bit down and the current pixel state enters at the msb
+        for (; i < end; i++)
+        {
+            T cur_val = frame[i];
+            T prev_val = _last_frame[i];
+            uint8_t hist = history[i];
+
+            if (cur_val)
+            {
+                if (!prev_val)
+                {
+                    _last_frame[i] = cur_val;
+                    history[i] = 0x80;
+                }
+                else
+                {  // old and new val
+                    T diff = abs_diff(cur_val, prev_val);
+
+                    if (diff < delta_z)
+                    {  // old and new val agree
+                        history[i] = (hist >> 1) | 0x80;
+                        float filtered = alpha * cur_val + one_minus_alpha * prev_val;
+                        T result = static_cast<T>(filtered);
+                        frame[i] = result;
+                        _last_frame[i] = result;
+                    }
+                    else
+                    {
+                        _last_frame[i] = cur_val;
+                        history[i] = 0x80;
+                    }
+                }
+            }
+            else
+            {  // no cur_val
+                if (prev_val)
+                { // only case we can help
+                    if (persistence_map[hist])
+                    { // we have had enough samples lately
+                        frame[i] = prev_val;
+                    }
+                }
+                history[i] = hist >> 1;
+            }
+        }
+    }
+
+    // Also run over parts of the image by the depth refinement block
+    template void temporal_filter::temp_jw_smooth_range<uint16_t>(uint16_t*, uint16_t*, uint8_t*, size_t, size_t);
+    template void temporal_filter::temp_jw_smooth_range<float>(float*, float*, uint8_t*, size_t, size_t);
+
 
     void temporal_filter::on_set_persistence_control(uint8_t val)
     {
         std::lock_guard<std::mutex> lock(_mutex);
         _persistence_param = val;
         recalc_persistence_map();
-        _last_frame.clear();
-        _history.clear();
+        reset_history();
     }
 
     void temporal_filter::on_set_alpha(float val)
@@ -135,23 +457,19 @@ namespace librealsense
         std::lock_guard<std::mutex> lock(_mutex);
         _alpha_param = val;
         _one_minus_alpha = 1.f - _alpha_param;
-        _cur_frame_index = 0;
-        _last_frame.clear();
-        _history.clear();
+        reset_history();
     }
 
     void temporal_filter::on_set_delta(float val)
     {
         std::lock_guard<std::mutex> lock(_mutex);
         _delta_param = static_cast<uint8_t>(val);
-        _cur_frame_index = 0;
-        _last_frame.clear();
-        _history.clear();
+        reset_history();
     }
 
     void  temporal_filter::update_configuration(const rs2::frame& f)
     {
-        if (f.get_profile().get() != _source_stream_profile.get())
+        if (frame_profile(f) != _source_stream_profile.get())
         {
             _source_stream_profile = f.get_profile();
             _target_stream_profile = _source_stream_profile.clone(RS2_STREAM_DEPTH, 0, _source_stream_profile.format());
@@ -165,17 +483,30 @@ namespace librealsense
             _stride = _width*_bpp;
             _current_frm_size_pixels = _width * _height;
 
-            _last_frame.clear();
-            _last_frame.resize(_current_frm_size_pixels*_bpp);
-
-            _history.clear();
-            _history.resize(_current_frm_size_pixels*_bpp);
+            reset_history();
+        }
 
+        if (_history.size() != _current_frm_size_pixels)
+        {
+            // The history was cleared by a profile or option change, restart it rather than reusing the released storage
+            _last_frame.resize(_current_frm_size_pixels*_bpp);
+            _history.resize(_current_frm_size_pixels);
         }
     }
 
+    void temporal_filter::reset_history()
+    {
+        _last_frame.clear();
+        _history.clear();
+    }
+
     rs2::frame temporal_filter::prepare_target_frame(const rs2::frame& f, const rs2::frame_source& source)
     {
+        // The filter runs in place, on the input itself when nothing else references it
+        if (f.as<rs2::video_frame>().get_stride_in_bytes() == int(_stride))
+            if (auto tgt = reuse_frame(f, _target_stream_profile))
+                return tgt;
+
         // Allocate and copy the content of the original Depth data to the target
         rs2::frame tgt = source.allocate_video_frame(_target_stream_profile, f, (int)_bpp, (int)_width, (int)_height, (int)_stride, _extension_type);
 
@@ -249,24 +580,9 @@ namespace librealsense
             }
         }
 
-        // Convert to credible enough
-        std::array<uint8_t, PRESISTENCY_LUT_SIZE> credible_threshold;
-        credible_threshold.fill(0);
-
-        for (auto phase = 0; phase < 8; phase++)
-        {
-            // evaluating last phase
-            //int ephase = (phase + 7) % 8;
-            unsigned char mask = 1 << phase;
-            int i;
-
-            for (i = 0; i < 256; i++) {
-                unsigned char pos = (unsigned char)((i << (8 - phase)) | (i >> phase));
-                if (_persistence_map[pos])
-                    credible_threshold[i] |= mask;
-            }
-        }
-        // Store results
-        _persistence_map = credible_threshold;
+        // Pack for the vectorized lookups
+        _persistence_bits.fill(0);
+        for (size_t i = 0; i < _persistence_map.size(); i++)
+            _persistence_bits[i / 8] |= _persistence_map[i] << (i % 8);
     }
 }
@@ -0,0 +1,163 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#include "../include/librealsense2/hpp/rs_sensor.hpp"
+#include "../include/librealsense2/hpp/rs_processing.hpp"
+
+#include <cmath>
+#include "option.h"
+#include "context.h"
+#include "core/video.h"
+#include "proc/synthetic-stream.h"
+#include "proc/threshold-crop.h"
+
+#ifdef __SSSE3__
+#include <tmmintrin.h> // For SSSE3 intrinsics
+#endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h> // For NEON intrinsics
+#define RS2_NEON
+#endif
+
+namespace librealsense
+{
+    const float distance_min = 0.f;
+    const float distance_max = 16.f;
+    const float distance_step = 0.1f;
+    const float min_distance_default = 0.1f;
+    const float max_distance_default = 4.f;
+
+    // Keeps the values in [min, max] and zeroes the others, eight at a time where the instruction set allows
+    static void threshold_row(const uint16_t* in, uint16_t* out, size_t count, uint16_t min, uint16_t max)
+    {
+        size_t i = 0;
+#if defined(__SSSE3__)
+        // The SSE2 comparisons are signed, the values are biased by 0x8000 to order them as unsigned
+        const __m128i bias = _mm_set1_epi16(-32768);
+        const __m128i lo = _mm_xor_si128(_mm_set1_epi16(static_cast<short>(min)), bias);
+        const __m128i hi = _mm_xor_si128(_mm_set1_epi16(static_cast<short>(max)), bias);
+        for (; i + 8 <= count; i += 8)
+        {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+            __m128i b = _mm_xor_si128(v, bias);
+            __m128i outside = _mm_or_si128(_mm_cmplt_epi16(b, lo), _mm_cmpgt_epi16(b, hi));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_andnot_si128(outside, v));
+        }
+#elif defined(RS2_NEON)
+        const uint16x8_t lo = vdupq_n_u16(min);
+        const uint16x8_t hi = vdupq_n_u16(max);
+        for (; i + 8 <= count; i += 8)
+        {
+            uint16x8_t v = vld1q_u16(in + i);
+            uint16x8_t inside = vandq_u16(vcgeq_u16(v, lo), vcleq_u16(v, hi));
+            vst1q_u16(out + i, vandq_u16(v, inside));
+        }
+#endif
+        for (; i < count; ++i)
+        {
+            auto v = in[i];
+            out[i] = (v >= min && v <= max) ? v : 0;
+        }
+    }
+
+    threshold_crop::threshold_crop()
+        : _min_distance(min_distance_default),
+          _max_distance(max_distance_default),
+          _left(0.f), _top(0.f), _right(1.f), _bottom(1.f),
+          _options_changed(false),
+          _x(0), _y(0), _width(0), _height(0),
+          _cropped(false)
+    {
+        _stream_filter.stream = RS2_STREAM_DEPTH;
+        _stream_filter.format = RS2_FORMAT_Z16;
+
+        auto min_distance = std::make_shared<ptr_option<float>>(distance_min, distance_max, distance_step, min_distance_default,
+            &_min_distance, "Min range in meters");
+        auto max_distance = std::make_shared<ptr_option<float>>(distance_min, distance_max, distance_step, max_distance_default,
+            &_max_distance, "Max range in meters");
+        register_option(RS2_OPTION_MIN_DISTANCE, min_distance);
+        register_option(RS2_OPTION_MAX_DISTANCE, max_distance);
+
+        auto crop_option = [this](rs2_option id, float* value, float def, const char* desc)
+        {
+            auto opt = std::make_shared<ptr_option<float>>(0.f, 1.f, 0.01f, def, value, desc);
+            opt->on_set([this](float) { std::lock_guard<std::mutex> lock(_mutex); _options_changed = true; });
+            register_option(id, opt);
+        };
+        crop_option(RS2_OPTION_CROP_LEFT, &_left, 0.f, "Left edge of the region kept, as a fraction of the frame width");
+        crop_option(RS2_OPTION_CROP_TOP, &_top, 0.f, "Top edge of the region kept, as a fraction of the frame height");
+        crop_option(RS2_OPTION_CROP_RIGHT, &_right, 1.f, "Right edge of the region kept, as a fraction of the frame width");
+        crop_option(RS2_OPTION_CROP_BOTTOM, &_bottom, 1.f, "Bottom edge of the region kept, as a fraction of the frame height");
+    }
+
+    void threshold_crop::update_output_profile(const rs2::frame& f)
+    {
+        if (!_options_changed && frame_profile(f) == _source_stream_profile.get())
+            return;
+
+        _options_changed = false;
+        _source_stream_profile = f.get_profile();
+
+        auto src_vspi = dynamic_cast<video_stream_profile_interface*>(_source_stream_profile.get()->profile);
+        rs2_intrinsics src_intrin = src_vspi->get_intrinsics();
+        size_t width = src_vspi->get_width(), height = src_vspi->get_height();
+
+        // Edges given out of order keep at least a pixel
+        _x = std::min(static_cast<size_t>(std::floor(_left * width)), width - 1);
+        _y = std::min(static_cast<size_t>(std::floor(_top * height)), height - 1);
+        _width = std::max<size_t>(std::min(static_cast<size_t>(std::ceil(_right * width)), width), _x + 1) - _x;
+        _height = std::max<size_t>(std::min(static_cast<size_t>(std::ceil(_bottom * height)), height), _y + 1) - _y;
+
+        _cropped = !(_x == 0 && _y == 0 && _width == width && _height == height);
+        if (!_cropped)
+        {
+            _target_stream_profile = _source_stream_profile;
+            return;
+        }
+
+        _target_stream_profile = _source_stream_profile.clone(_source_stream_profile.stream_type(),
+            _source_stream_profile.stream_index(), _source_stream_profile.format());
+        auto tgt_vspi = dynamic_cast<video_stream_profile_interface*>(_target_stream_profile.get()->profile);
+
+        // Cropping moves the principal point, the focal lengths and distortion are unchanged
+        rs2_intrinsics tgt_intrin = src_intrin;
+        tgt_intrin.width = static_cast<int>(_width);
+        tgt_intrin.height = static_cast<int>(_height);
+        tgt_intrin.ppx = src_intrin.ppx - _x;
+        tgt_intrin.ppy = src_intrin.ppy - _y;
+
+        tgt_vspi->set_intrinsics([tgt_intrin]() { return tgt_intrin; });
+        tgt_vspi->set_dims(tgt_intrin.width, tgt_intrin.height);
+    }
+
+    rs2::frame threshold_crop::process_frame(const rs2::frame_source& source, const rs2::frame& f)
+    {
+        update_output_profile(f);
+
+        auto src = f.as<rs2::video_frame>();
+        auto units = static_cast<depth_frame*>((frame_interface*)f.get())->get_units();
+        if (!(units > 0.f))
+            return f;
+
+        // Distances are compared in depth units, a band narrower than a unit keeps nothing
+        auto min = std::min(std::ceil(std::max(_min_distance, 0.f) / units), float(UINT16_MAX));
+        auto max = std::min(std::floor(_max_distance / units), float(UINT16_MAX));
+        auto lo = static_cast<uint16_t>(std::max(min, 1.f));
+        auto hi = static_cast<uint16_t>(std::max(max, 0.f));
+
+        // Without a crop the values are thresholded in place when the block holds the only reference to the frame
+        rs2::frame tgt = _cropped ? rs2::frame() : reuse_frame(f, _target_stream_profile);
+        if (!tgt)
+            tgt = source.allocate_video_frame(_target_stream_profile, f, 2, int(_width), int(_height), int(_width * 2), RS2_EXTENSION_DEPTH_FRAME);
+        if (!tgt)
+            return tgt;
+
+        auto in = static_cast<const uint16_t*>(src.get_data());
+        auto out = static_cast<uint16_t*>(const_cast<void*>(tgt.get_data()));
+        size_t in_stride = src.get_stride_in_bytes() / sizeof(uint16_t);
+        for (size_t y = 0; y < _height; ++y)
+            threshold_row(in + (_y + y) * in_stride + _x, out + y * _width, _width, lo, hi);
+
+        return tgt;
+    }
+}
@@ -0,0 +1,35 @@
+// Threshold-crop block zeroes the depth outside a band of distances and crops the frame to a region of interest
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "../include/librealsense2/hpp/rs_frame.hpp"
+#include "../include/librealsense2/hpp/rs_processing.hpp"
+
+namespace librealsense
+{
+    // Placed ahead of the other filters, they only see the pixels that are kept. The region is given in fractions of the
+    // frame size so that it holds for any resolution, and the intrinsics of the output are those of the cropped image
+    class threshold_crop : public stream_filter_processing_block
+    {
+    public:
+        threshold_crop();
+
+    protected:
+        rs2::frame process_frame(const rs2::frame_source& source, const rs2::frame& f) override;
+
+    private:
+        void    update_output_profile(const rs2::frame& f);
+
+        float                   _min_distance;      // In meters
+        float                   _max_distance;
+        float                   _left, _top, _right, _bottom;
+        bool                    _options_changed;
+        rs2::stream_profile     _source_stream_profile;
+        rs2::stream_profile     _target_stream_profile;
+        size_t                  _x, _y;             // Region of the input kept in the output
+        size_t                  _width, _height;
+        bool                    _cropped;
+    };
+}
@@ -0,0 +1,431 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#include "../include/librealsense2/hpp/rs_sensor.hpp"
+#include "../include/librealsense2/hpp/rs_processing.hpp"
+#include "../include/librealsense2/rsutil.h"
+
+#include <algorithm>
+#include <cmath>
+#include "option.h"
+#include "context.h"
+#include "environment.h"
+#include "proc/synthetic-stream.h"
+#include "proc/pointcloud.h"
+#include "proc/projection.h"
+#include "proc/tsdf-integrator.h"
+
+namespace librealsense
+{
+    const float voxel_size_min = 0.001f;
+    const float voxel_size_max = 0.5f;
+    const float voxel_size_step = 0.001f;
+    const float voxel_size_default = 0.01f;
+
+    const float truncation_min = 0.002f;
+    const float truncation_max = 2.f;
+    const float truncation_step = 0.001f;
+    const float truncation_default = 0.04f;
+
+    const float max_distance_min = 0.1f;
+    const float max_distance_max = 16.f;
+    const float max_distance_step = 0.1f;
+    const float max_distance_default = 4.f;
+
+    // Depth frames a voxel averages, past it the voxel follows the newer frames as a running average
+    const float max_weight_min = 1.f;
+    const float max_weight_max = 1000.f;
+    const float max_weight_step = 1.f;
+    const float max_weight_default = 64.f;
+
+    // Poses kept to interpolate the pose of the depth frames, a second of a 200Hz pose stream
+    const size_t max_tsdf_poses = 200;
+
+    // Pixels sampled along both axes to find the blocks in view. A block spans several samples at any range the
+    // depth is integrated at, the voxels of the block are then updated from all the pixels
+    const int allocation_stride = 4;
+
+    // Blocks are addressed with 21 bits per axis, like the cells of the voxel-grid filter
+    static const int64_t block_bias = 1 << 20;
+    static const int64_t block_mask = (1 << 21) - 1;
+
+    inline uint64_t block_key(int64_t x, int64_t y, int64_t z)
+    {
+        return (uint64_t((x + block_bias) & block_mask) << 42) | (uint64_t((y + block_bias) & block_mask) << 21) |
+            uint64_t((z + block_bias) & block_mask);
+    }
+
+    inline void block_coordinates(uint64_t key, int64_t& x, int64_t& y, int64_t& z)
+    {
+        x = int64_t((key >> 42) & block_mask) - block_bias;
+        y = int64_t((key >> 21) & block_mask) - block_bias;
+        z = int64_t(key & block_mask) - block_bias;
+    }
+
+    inline int64_t floor_div(int64_t a, int64_t b)
+    {
+        return a >= 0 ? a / b : -((-a + b - 1) / b);
+    }
+
+    tsdf_integrator::tsdf_integrator()
+        : _voxel_size(voxel_size_default),
+          _truncation(truncation_default),
+          _max_distance(max_distance_default),
+          _max_weight(max_weight_default),
+          _processing_threads(processing_threads_default),
+          _executor(processing_threads_default)
+    {
+        auto voxel_size = std::make_shared<ptr_option<float>>(voxel_size_min, voxel_size_max, voxel_size_step, voxel_size_default,
+            &_voxel_size, "Edge of a voxel in meters, changing it clears the volume");
+        // The blocks hold voxels of the old size
+        voxel_size->on_set([this](float) { std::lock_guard<std::mutex> lock(_mutex); _blocks.clear(); });
+        register_option(RS2_OPTION_VOXEL_SIZE, voxel_size);
+
+        auto truncation = std::make_shared<ptr_option<float>>(truncation_min, truncation_max, truncation_step, truncation_default,
+            &_truncation, "Distance in meters around the surface the signed distance is kept within");
+        register_option(RS2_OPTION_TSDF_TRUNCATION_DISTANCE, truncation);
+
+        auto max_distance = std::make_shared<ptr_option<float>>(max_distance_min, max_distance_max, max_distance_step, max_distance_default,
+            &_max_distance, "Farthest depth integrated, in meters");
+        register_option(RS2_OPTION_MAX_DISTANCE, max_distance);
+
+        auto max_weight = std::make_shared<ptr_option<float>>(max_weight_min, max_weight_max, max_weight_step, max_weight_default,
+            &_max_weight, "Number of depth frames a voxel averages before favoring the newer ones");
+        register_option(RS2_OPTION_TSDF_MAX_WEIGHT, max_weight);
+
+        register_processing_threads_option(*this, _processing_threads, _executor, _mutex,
+            "Number of threads used to integrate each depth frame, 0 for all hardware threads", "TSDF integrator");
+    }
+
+    void tsdf_integrator::set_pose(const rs2_pose& world_from_depth)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        float4 q{ world_from_depth.rotation.x, world_from_depth.rotation.y, world_from_depth.rotation.z, world_from_depth.rotation.w };
+        auto norm = std::sqrt(q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w);
+        if (!(norm > 0.f))
+            throw invalid_value_exception("The rotation of the pose is not a quaternion");
+        q = { q.x / norm, q.y / norm, q.z / norm, q.w / norm };
+        _external_pose = pose{ rotation_matrix(q),
+            { world_from_depth.translation.x, world_from_depth.translation.y, world_from_depth.translation.z } };
+    }
+
+    void tsdf_integrator::reset()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _blocks.clear();
+        _poses.clear();
+        _external_pose = optional_value<pose>();
+    }
+
+    bool tsdf_integrator::should_process(const rs2::frame& frame)
+    {
+        if (!frame)
+            return false;
+
+        if (auto set = frame.as<rs2::frameset>())
+            return bool(set.first_or_default(RS2_STREAM_DEPTH, RS2_FORMAT_Z16));
+
+        if (frame.is<rs2::pose_frame>())
+            return true;
+        auto p = frame.get_profile();
+        return p.stream_type() == RS2_STREAM_DEPTH && p.format() == RS2_FORMAT_Z16;
+    }
+
+    rs2::frame tsdf_integrator::process_frame(const rs2::frame_source& source, const rs2::frame& f)
+    {
+        if (auto composite = f.as<rs2::frameset>())
+        {
+            // The pose of the frameset is taken before its depth is integrated
+            if (auto pose = composite.first_or_default(RS2_STREAM_POSE))
+                inspect_pose_frame(pose);
+            return integrate(source, composite.first(RS2_STREAM_DEPTH, RS2_FORMAT_Z16));
+        }
+
+        if (f.is<rs2::pose_frame>())
+        {
+            inspect_pose_frame(f);
+            return rs2::frame{};
+        }
+        return integrate(source, f);
+    }
+
+    void tsdf_integrator::inspect_pose_frame(const rs2::frame& pose)
+    {
+        _external_pose = optional_value<librealsense::pose>();
+        if (!_pose_stream || frame_profile(pose) != (const rs2_stream_profile*)_pose_stream)
+        {
+            _pose_stream = pose.get_profile();
+            _depth_to_pose = optional_value<rs2_extrinsics>();
+            _poses.clear();
+        }
+
+        // Poses arriving out of order are dropped, the interpolation relies on increasing timestamps
+        auto timestamp = pose.get_timestamp();
+        if (!_poses.empty() && timestamp <= _poses.back().timestamp)
+            return;
+
+        auto data = pose.as<rs2::pose_frame>().get_pose_data();
+        _poses.push_back({ timestamp,
+            { data.translation.x, data.translation.y, data.translation.z },
+            { data.rotation.x, data.rotation.y, data.rotation.z, data.rotation.w } });
+        if (_poses.size() > max_tsdf_poses)
+            _poses.pop_front();
+    }
+
+    bool tsdf_integrator::get_world_pose(const rs2::frame& depth, pose& world_from_depth)
+    {
+        if (_external_pose)
+        {
+            world_from_depth = *_external_pose;
+            return true;
+        }
+        if (_poses.empty())
+            return false;
+
+        // Without extrinsics between the depth and pose sensors the pose sensor is taken to be the depth sensor
+        if (!_depth_to_pose)
+        {
+            rs2_extrinsics ex = identity_matrix();
+            const rs2_stream_profile* ds = frame_profile(depth);
+            const rs2_stream_profile* ps = _pose_stream;
+            environment::get_instance().get_extrinsics_graph().try_fetch_extrinsics(*ds->profile, *ps->profile, &ex);
+            _depth_to_pose = ex;
+        }
+
+        // Depth frames outside of the poses kept take the nearest pose, poses are not extrapolated
+        auto timestamp = depth.get_timestamp();
+        auto next = std::lower_bound(_poses.begin(), _poses.end(), timestamp,
+            [](const pose_sample& p, double t) { return p.timestamp < t; });
+        pose_sample sample;
+        if (next == _poses.begin())
+            sample = _poses.front();
+        else if (next == _poses.end())
+            sample = _poses.back();
+        else
+        {
+            auto& a = *(next - 1);
+            auto& b = *next;
+            auto t = static_cast<float>((timestamp - a.timestamp) / (b.timestamp - a.timestamp));
+            sample = { timestamp, a.translation + (b.translation - a.translation) * t, slerp(a.rotation, b.rotation, t) };
+        }
+
+        pose world_from_sensor{ rotation_matrix(sample.rotation), sample.translation };
+        world_from_depth = world_from_sensor * to_pose(*_depth_to_pose);
+        return true;
+    }
+
+    void tsdf_integrator::allocate_blocks(const uint16_t* pixels, float units, const rs2_intrinsics& intrinsics, const pose& world_from_depth)
+    {
+        const float inverse_block = 1.f / (_voxel_size * block_edge);
+        // Half a block between the samples along a ray, no block of the truncation band is stepped over
+        const float step = 0.5f * _voxel_size * block_edge;
+        const int rows = (intrinsics.height + allocation_stride - 1) / allocation_stride;
+
+        _updated.clear();
+        _executor.for_each_range(rows, 4, [&](size_t begin, size_t end)
+        {
+            std::vector<uint64_t> keys;
+            for (size_t row = begin; row < end; ++row)
+            {
+                const int y = int(row) * allocation_stride;
+                for (int x = 0; x < intrinsics.width; x += allocation_stride)
+                {
+                    const float z = pixels[y * intrinsics.width + x] * units;
+                    if (z <= 0.f || z > _max_distance)
+                        continue;
+
+                    const float pixel[] = { float(x), float(y) };
+                    float3 point;
+                    rs2_deproject_pixel_to_point(&point.x, &intrinsics, pixel, 1.f);
+                    const float first = std::max(z - _truncation, 0.f), last = z + _truncation;
+                    for (float d = first;; d += step)
+                    {
+                        d = std::min(d, last);
+                        auto p = world_from_depth * (point * d);
+                        auto key = block_key(int64_t(std::floor(p.x * inverse_block)), int64_t(std::floor(p.y * inverse_block)),
+                            int64_t(std::floor(p.z * inverse_block)));
+                        if (keys.empty() || keys.back() != key)
+                            keys.push_back(key);
+                        if (d >= last)
+                            break;
+                    }
+                }
+            }
+            std::sort(keys.begin(), keys.end());
+            keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+            std::lock_guard<std::mutex> lock(_keys_mutex);
+            _updated.insert(_updated.end(), keys.begin(), keys.end());
+        });
+        std::sort(_updated.begin(), _updated.end());
+        _updated.erase(std::unique(_updated.begin(), _updated.end()), _updated.end());
+
+        _updated_blocks.resize(_updated.size());
+        for (size_t i = 0; i < _updated.size(); ++i)
+        {
+            auto& block = _blocks[_updated[i]];
+            if (!block)
+                block.reset(new voxel_block());
+            _updated_blocks[i] = block.get();
+        }
+    }
+
+    const tsdf_integrator::voxel* tsdf_integrator::find_voxel(int64_t x, int64_t y, int64_t z) const
+    {
+        auto bx = floor_div(x, block_edge), by = floor_div(y, block_edge), bz = floor_div(z, block_edge);
+        auto it = _blocks.find(block_key(bx, by, bz));
+        if (it == _blocks.end())
+            return nullptr;
+        auto i = ((z - bz * block_edge) * block_edge + (y - by * block_edge)) * block_edge + (x - bx * block_edge);
+        return &it->second->voxels[i];
+    }
+
+    void tsdf_integrator::extract_surface(size_t block, std::vector<float3>& points) const
+    {
+        int64_t bx, by, bz;
+        block_coordinates(_updated[block], bx, by, bz);
+        auto& voxels = _updated_blocks[block]->voxels;
+        points.clear();
+
+        // A point where the distance changes sign between a voxel and its next voxel along each axis. Voxels
+        // truncated on either side lie away from the surface, their sign changes at the edge of the band
+        for (int z = 0; z < block_edge; ++z)
+            for (int y = 0; y < block_edge; ++y)
+                for (int x = 0; x < block_edge; ++x)
+                {
+                    auto& v = voxels[(z * block_edge + y) * block_edge + x];
+                    if (v.weight <= 0.f || std::abs(v.tsdf) >= 1.f)
+                        continue;
+
+                    const int64_t gx = bx * block_edge + x, gy = by * block_edge + y, gz = bz * block_edge + z;
+                    const int64_t neighbors[3][3] = { { gx + 1, gy, gz }, { gx, gy + 1, gz }, { gx, gy, gz + 1 } };
+                    for (int axis = 0; axis < 3; ++axis)
+                    {
+                        const voxel* n;
+                        if ((axis == 0 && x + 1 < block_edge) || (axis == 1 && y + 1 < block_edge) || (axis == 2 && z + 1 < block_edge))
+                            n = &voxels[(z + (axis == 2)) * block_edge * block_edge + (y + (axis == 1)) * block_edge + x + (axis == 0)];
+                        else
+                            n = find_voxel(neighbors[axis][0], neighbors[axis][1], neighbors[axis][2]);
+                        if (!n || n->weight <= 0.f || std::abs(n->tsdf) >= 1.f || (v.tsdf >= 0.f) == (n->tsdf >= 0.f))
+                            continue;
+
+                        const float t = v.tsdf / (v.tsdf - n->tsdf);
+                        float3 p{ (gx + 0.5f) * _voxel_size, (gy + 0.5f) * _voxel_size, (gz + 0.5f) * _voxel_size };
+                        (&p.x)[axis] += t * _voxel_size;
+                        points.push_back(p);
+                    }
+                }
+    }
+
+    template<rs2_distortion MODEL>
+    void tsdf_integrator::integrate_blocks(const rs2_intrinsics& intrinsics, const uint16_t* depth, float depth_units,
+        const pose& depth_from_world)
+    {
+        // The voxels are updated with the projective distance, along the ray of the pixel they project to
+        _executor.for_each_range(_updated.size(), 1, [&](size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; ++i)
+            {
+                int64_t bx, by, bz;
+                block_coordinates(_updated[i], bx, by, bz);
+                auto& voxels = _updated_blocks[i]->voxels;
+                for (int z = 0; z < block_edge; ++z)
+                    for (int y = 0; y < block_edge; ++y)
+                        for (int x = 0; x < block_edge; ++x)
+                        {
+                            const float3 world{ (bx * block_edge + x + 0.5f) * _voxel_size, (by * block_edge + y + 0.5f) * _voxel_size,
+                                (bz * block_edge + z + 0.5f) * _voxel_size };
+                            const float3 p = depth_from_world * world;
+                            if (p.z <= 0.f)
+                                continue;
+
+                            float pixel[2];
+                            project_point<MODEL>(pixel, intrinsics, &p.x);
+                            const int u = int(std::floor(pixel[0] + 0.5f)), v = int(std::floor(pixel[1] + 0.5f));
+                            if (u < 0 || v < 0 || u >= intrinsics.width || v >= intrinsics.height)
+                                continue;
+
+                            const float d = depth[v * intrinsics.width + u] * depth_units;
+                            if (d <= 0.f || d > _max_distance)
+                                continue;
+
+                            // Voxels behind the surface by more than the truncation distance are occluded, nothing is known of them
+                            const float distance = d - p.z;
+                            if (distance < -_truncation)
+                                continue;
+
+                            auto& voxel = voxels[(z * block_edge + y) * block_edge + x];
+                            const float tsdf = std::min(1.f, distance / _truncation);
+                            voxel.tsdf = (voxel.tsdf * voxel.weight + tsdf) / (voxel.weight + 1.f);
+                            voxel.weight = std::min(voxel.weight + 1.f, _max_weight);
+                        }
+            }
+        });
+    }
+
+    rs2::frame tsdf_integrator::integrate(const rs2::frame_source& source, const rs2::frame& f)
+    {
+        auto depth = f.as<rs2::depth_frame>();
+        if (!depth)
+            return rs2::frame{};
+
+        if (!_output_stream || frame_profile(_depth_stream) != frame_profile(f))
+        {
+            _output_stream = f.get_profile().as<rs2::video_stream_profile>().clone(
+                RS2_STREAM_DEPTH, f.get_profile().stream_index(), RS2_FORMAT_XYZ32F);
+            _depth_stream = f;
+            _depth_to_pose = optional_value<rs2_extrinsics>();
+        }
+
+        // Without any pose the depth sensor stays at the origin of the world, for a static camera
+        pose world_from_depth{ { { 1, 0, 0 }, { 0, 1, 0 }, { 0, 0, 1 } }, { 0, 0, 0 } };
+        get_world_pose(f, world_from_depth);
+        const auto depth_from_world = inverse(world_from_depth);
+
+        const auto intrinsics = f.get_profile().as<rs2::video_stream_profile>().get_intrinsics();
+        auto pixels = static_cast<const uint16_t*>(depth.get_data());
+        auto units = static_cast<depth_frame*>((frame_interface*)f.get())->get_units();
+        allocate_blocks(pixels, units, intrinsics, world_from_depth);
+
+        switch (projection_model(intrinsics.model))
+        {
+        case RS2_DISTORTION_MODIFIED_BROWN_CONRADY:
+            integrate_blocks<RS2_DISTORTION_MODIFIED_BROWN_CONRADY>(intrinsics, pixels, units, depth_from_world);
+            break;
+        case RS2_DISTORTION_FTHETA:
+            integrate_blocks<RS2_DISTORTION_FTHETA>(intrinsics, pixels, units, depth_from_world);
+            break;
+        default:
+            integrate_blocks<RS2_DISTORTION_NONE>(intrinsics, pixels, units, depth_from_world);
+            break;
+        }
+
+        _block_points.resize(std::max(_block_points.size(), _updated.size()));
+        _executor.for_each_range(_updated.size(), 1, [&](size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; ++i)
+                extract_surface(i, _block_points[i]);
+        });
+
+        auto res = source.allocate_points(_output_stream, f);
+        if (!res)
+            return res;
+
+        // The points of the blocks come in the order of the blocks, the surface is cut where it outgrows the frame
+        auto output = static_cast<points*>((frame_interface*)res.get());
+        auto vertices = output->get_vertices();
+        auto texcoords = output->get_texture_coordinates();
+        const size_t capacity = output->get_vertex_count();
+        size_t count = 0;
+        for (size_t i = 0; i < _updated.size() && count < capacity; ++i)
+        {
+            auto n = std::min(_block_points[i].size(), capacity - count);
+            std::copy(_block_points[i].begin(), _block_points[i].begin() + n, vertices + count);
+            count += n;
+        }
+        std::fill(texcoords, texcoords + count, float2{ 0.f, 0.f });
+        output->set_vertex_count(count);
+
+        return res;
+    }
+}
@@ -0,0 +1,89 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "../include/librealsense2/hpp/rs_frame.hpp"
+#include "../include/librealsense2/hpp/rs_processing.hpp"
+#include "concurrency.h"
+#include "types.h"
+
+#include <deque>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace librealsense
+{
+    // Fuses depth frames into a truncated signed distance field, stored sparsely in blocks of 8x8x8 voxels that are
+    // allocated in a hash map where a depth frame sees a surface. The pose of a depth frame is interpolated from
+    // the pose frames passed with it or before it, like the world frame of the pointcloud, or set by the application
+    // with set_pose. Each depth frame outputs a sparse points frame, in the world frame, of the surface crossing the
+    // blocks it updated, so the output grows with the part of the scene in view rather than with the whole volume
+    class tsdf_integrator : public generic_processing_block
+    {
+    public:
+        tsdf_integrator();
+
+        // The pose of the depth sensor in the world, used for the depth frames until the next pose frame
+        void set_pose(const rs2_pose& world_from_depth);
+        void reset();
+
+    protected:
+        bool should_process(const rs2::frame& frame) override;
+        rs2::frame process_frame(const rs2::frame_source& source, const rs2::frame& f) override;
+
+    private:
+        static const int block_edge = 8;
+
+        struct voxel
+        {
+            float tsdf = 1.f;       // Signed distance to the surface along the rays, in units of the truncation distance
+            float weight = 0.f;
+        };
+
+        struct voxel_block
+        {
+            voxel voxels[block_edge * block_edge * block_edge];
+        };
+
+        struct pose_sample
+        {
+            double timestamp;
+            float3 translation;
+            float4 rotation;
+        };
+
+        void inspect_pose_frame(const rs2::frame& pose);
+        bool get_world_pose(const rs2::frame& depth, pose& world_from_depth);
+        rs2::frame integrate(const rs2::frame_source& source, const rs2::frame& depth);
+
+        // Finds the blocks within the truncation distance of the depth of the pixels, and allocates the new ones
+        void allocate_blocks(const uint16_t* depth, float depth_units, const rs2_intrinsics& intrinsics, const pose& world_from_depth);
+        template<rs2_distortion MODEL>
+        void integrate_blocks(const rs2_intrinsics& intrinsics, const uint16_t* depth, float depth_units, const pose& depth_from_world);
+        void extract_surface(size_t block, std::vector<float3>& points) const;
+        const voxel* find_voxel(int64_t x, int64_t y, int64_t z) const;
+
+        float                   _voxel_size;        // In meters
+        float                   _truncation;        // In meters
+        float                   _max_distance;      // Farthest depth integrated, in meters
+        float                   _max_weight;
+        uint8_t                 _processing_threads;
+        parallel_executor       _executor;
+
+        std::unordered_map<uint64_t, std::unique_ptr<voxel_block>> _blocks;
+        std::vector<uint64_t>   _updated;           // Blocks of the current depth frame, sorted
+        std::vector<voxel_block*> _updated_blocks;
+        std::vector<std::vector<float3>> _block_points;
+        std::mutex              _keys_mutex;
+
+        std::deque<pose_sample> _poses;
+        rs2::stream_profile     _pose_stream;
+        optional_value<rs2_extrinsics> _depth_to_pose;
+        optional_value<pose>    _external_pose;
+
+        rs2::stream_profile     _output_stream;
+        rs2::frame              _depth_stream;
+    };
+}
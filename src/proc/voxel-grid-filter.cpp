@@ -0,0 +1,141 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#include "../include/librealsense2/hpp/rs_sensor.hpp"
+#include "../include/librealsense2/hpp/rs_processing.hpp"
+
+#include <cmath>
+#include "option.h"
+#include "context.h"
+#include "proc/synthetic-stream.h"
+#include "proc/voxel-grid-filter.h"
+
+namespace librealsense
+{
+    const float voxel_size_min = 0.001f;
+    const float voxel_size_max = 1.f;
+    const float voxel_size_step = 0.001f;
+    const float voxel_size_default = 0.01f;
+
+    const uint64_t voxel_grid_filter::no_voxel;
+
+    // Cells are addressed with 21 bits per axis, a range of a million voxels on both sides of the camera
+    static const int64_t cell_bias = 1 << 20;
+    static const int64_t cell_mask = (1 << 21) - 1;
+
+    inline uint64_t voxel_key(const float3& v, float inverse_size)
+    {
+        auto cell = [inverse_size](float c) { return (static_cast<int64_t>(std::floor(c * inverse_size)) + cell_bias) & cell_mask; };
+        return (uint64_t(cell(v.x)) << 42) | (uint64_t(cell(v.y)) << 21) | uint64_t(cell(v.z));
+    }
+
+    inline size_t voxel_hash(uint64_t key)
+    {
+        key ^= key >> 33;
+        key *= 0xff51afd7ed558ccdull;
+        key ^= key >> 33;
+        return static_cast<size_t>(key);
+    }
+
+    voxel_grid_filter::voxel_grid_filter()
+        : _voxel_size(voxel_size_default),
+          _processing_threads(processing_threads_default),
+          _executor(processing_threads_default)
+    {
+        auto voxel_size = std::make_shared<ptr_option<float>>(voxel_size_min, voxel_size_max, voxel_size_step, voxel_size_default,
+            &_voxel_size, "Edge of a voxel in meters");
+        register_option(RS2_OPTION_VOXEL_SIZE, voxel_size);
+
+        register_processing_threads_option(*this, _processing_threads, _executor, _mutex,
+            "Number of threads used to find the voxels of each pointcloud, 0 for all hardware threads", "voxel grid");
+    }
+
+    bool voxel_grid_filter::should_process(const rs2::frame& frame)
+    {
+        return frame && frame.is<rs2::points>();
+    }
+
+    void voxel_grid_filter::reset_grid(size_t vertices)
+    {
+        size_t slots = 16;
+        while (slots < vertices * 2)
+            slots <<= 1;
+        if (_slot_keys.size() != slots)
+        {
+            _slot_keys.resize(slots);
+            _slot_voxels.resize(slots);
+        }
+        std::fill(_slot_keys.begin(), _slot_keys.end(), no_voxel);
+        _voxels.clear();
+    }
+
+    uint32_t voxel_grid_filter::find_or_add(uint64_t key)
+    {
+        const size_t mask = _slot_keys.size() - 1;
+        for (size_t slot = voxel_hash(key) & mask;; slot = (slot + 1) & mask)
+        {
+            if (_slot_keys[slot] == key)
+                return _slot_voxels[slot];
+            if (_slot_keys[slot] == no_voxel)
+            {
+                _slot_keys[slot] = key;
+                _slot_voxels[slot] = static_cast<uint32_t>(_voxels.size());
+                _voxels.push_back({ { 0.f, 0.f, 0.f }, { 0.f, 0.f }, 0 });
+                return _slot_voxels[slot];
+            }
+        }
+    }
+
+    rs2::frame voxel_grid_filter::process_frame(const rs2::frame_source& source, const rs2::frame& f)
+    {
+        auto input = static_cast<points*>((frame_interface*)f.get());
+        const size_t count = input->get_vertex_count();
+        const float3* vertices = input->get_vertices();
+        const float2* texcoords = input->get_texture_coordinates();
+        const float inverse_size = 1.f / _voxel_size;
+
+        // Vertices at the origin carry no depth and belong to no voxel
+        _keys.resize(count);
+        _executor.for_each_range(count, 8, [&](size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; ++i)
+                _keys[i] = vertices[i].z ? voxel_key(vertices[i], inverse_size) : no_voxel;
+        });
+
+        reset_grid(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (_keys[i] == no_voxel)
+                continue;
+            auto& v = _voxels[find_or_add(_keys[i])];
+            v.sum.x += vertices[i].x;
+            v.sum.y += vertices[i].y;
+            v.sum.z += vertices[i].z;
+            v.texcoords.x += texcoords[i].x;
+            v.texcoords.y += texcoords[i].y;
+            ++v.count;
+        }
+
+        auto res = source.allocate_points(f.get_profile(), f);
+        if (!res)
+            return res;
+
+        auto output = static_cast<points*>((frame_interface*)res.get());
+        auto out_vertices = output->get_vertices();
+        auto out_texcoords = output->get_texture_coordinates();
+        const size_t voxels = std::min(_voxels.size(), output->get_vertex_count());
+        _executor.for_each_range(voxels, 8, [&](size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; ++i)
+            {
+                auto& v = _voxels[i];
+                const float weight = 1.f / v.count;
+                out_vertices[i] = { v.sum.x * weight, v.sum.y * weight, v.sum.z * weight };
+                out_texcoords[i] = { v.texcoords.x * weight, v.texcoords.y * weight };
+            }
+        });
+        output->set_vertex_count(voxels);
+
+        return res;
+    }
+}
@@ -0,0 +1,50 @@
+// Voxel-grid filter replaces the vertices of a pointcloud falling in each cell of a regular grid by their centroid
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "../include/librealsense2/hpp/rs_frame.hpp"
+#include "../include/librealsense2/hpp/rs_processing.hpp"
+#include "concurrency.h"
+#include "types.h"
+
+#include <vector>
+
+namespace librealsense
+{
+    // Takes a points frame, dense or sparse, and outputs a sparse points frame with one vertex per occupied voxel.
+    // The voxel of every vertex is computed in parallel, then the vertices are gathered in a hash grid that is kept
+    // between frames. The voxels come out in the order of their first vertex, so the output is stable for a static scene
+    class voxel_grid_filter : public generic_processing_block
+    {
+    public:
+        voxel_grid_filter();
+
+    protected:
+        bool should_process(const rs2::frame& frame) override;
+        rs2::frame process_frame(const rs2::frame_source& source, const rs2::frame& f) override;
+
+    private:
+        struct voxel
+        {
+            float3 sum;
+            float2 texcoords;
+            uint32_t count;
+        };
+
+        static const uint64_t no_voxel = ~0ull;
+
+        // Sizes the hash grid for the given number of vertices, the load stays under one half
+        void reset_grid(size_t vertices);
+        uint32_t find_or_add(uint64_t key);
+
+        float                   _voxel_size;        // In meters
+        std::vector<uint64_t>   _keys;              // Voxel of each input vertex
+        std::vector<uint64_t>   _slot_keys;         // Open addressing table of the occupied voxels
+        std::vector<uint32_t>   _slot_voxels;
+        std::vector<voxel>      _voxels;
+        uint8_t                 _processing_threads;
+        parallel_executor       _executor;
+    };
+}
@@ -0,0 +1,57 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#include "../include/librealsense2/hpp/rs_sensor.hpp"
+#include "../include/librealsense2/hpp/rs_processing.hpp"
+
+#include "image.h"
+#include "proc/synthetic-stream.h"
+#include "proc/yuy2-decoder.h"
+
+namespace librealsense
+{
+    // The YUY2 pixel format carries the converting unpacker of every supported output
+    static void(*find_yuy2_unpacker(rs2_format format))(byte * const dest[], const byte * source, int width, int height)
+    {
+        for (auto&& unpacker : pf_yuy2.unpackers)
+        {
+            if (unpacker.requires_processing && unpacker.outputs.size() == 1 && unpacker.outputs.front().format == format)
+                return unpacker.unpack;
+        }
+        throw invalid_value_exception(to_string() << "YUY2 decoder: unsupported target format " << get_string(format));
+    }
+
+    yuy2_decoder::yuy2_decoder(rs2_format target_format)
+        : _target_format(target_format),
+          _target_bpp(get_image_bpp(target_format) / 8),
+          _unpack(find_yuy2_unpacker(target_format))
+    {
+        _stream_filter.format = RS2_FORMAT_YUYV;
+    }
+
+    void yuy2_decoder::update_output_profile(const rs2::frame& f)
+    {
+        if (frame_profile(f) != _source_stream_profile.get())
+        {
+            _source_stream_profile = f.get_profile();
+            _target_stream_profile = _source_stream_profile.clone(_source_stream_profile.stream_type(), _source_stream_profile.stream_index(), _target_format);
+        }
+    }
+
+    rs2::frame yuy2_decoder::process_frame(const rs2::frame_source& source, const rs2::frame& f)
+    {
+        update_output_profile(f);
+
+        auto vf = f.as<rs2::video_frame>();
+        auto width = vf.get_width(), height = vf.get_height();
+        auto tgt = source.allocate_video_frame(_target_stream_profile, f, _target_bpp, width, height, width * _target_bpp, RS2_EXTENSION_VIDEO_FRAME);
+        if (tgt)
+        {
+            // The output holds on to the YUY2 frame until it is released
+            auto packed = std::make_shared<rs2::frame>(f);
+            ((frame_interface*)tgt.get())->attach_device_memory(std::make_shared<deferred_unpack>(_unpack,
+                static_cast<const byte*>(vf.get_data()), width, height, size_t(height) * width * _target_bpp, packed), true);
+        }
+        return tgt;
+    }
+}
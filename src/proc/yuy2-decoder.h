@@ -0,0 +1,32 @@
+// YUY2 decoder converts YUY2 color frames into RGB formats when their data is first read
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "../include/librealsense2/hpp/rs_frame.hpp"
+#include "../include/librealsense2/hpp/rs_processing.hpp"
+
+namespace librealsense
+{
+    // Streams kept in YUY2 are converted by the consumers that need another format. The output frame references
+    // the YUY2 frame, and the conversion runs once, on the first access to its data, so that frames dropped
+    // before being read are never converted. The conversion uses the CUDA and AVX unpackers when they are built
+    class yuy2_decoder : public stream_filter_processing_block
+    {
+    public:
+        explicit yuy2_decoder(rs2_format target_format);
+
+    protected:
+        rs2::frame process_frame(const rs2::frame_source& source, const rs2::frame& f) override;
+
+    private:
+        void update_output_profile(const rs2::frame& f);
+
+        rs2_format              _target_format;
+        int                     _target_bpp;
+        void(*_unpack)(byte * const dest[], const byte * source, int width, int height);
+        rs2::stream_profile     _source_stream_profile;
+        rs2::stream_profile     _target_stream_profile;
+    };
+}
@@ -0,0 +1,111 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+// Profiler zones at the hot spots of the frame path, for builds with BUILD_WITH_TRACY or BUILD_WITH_ITT.
+// LRS_PROFILE_ZONE opens a zone until the end of the scope, LRS_PROFILE_ZONE_NAME renames the zone of the scope,
+// and LRS_PROFILE_FRAME tags it with a frame number, so a frame can be followed from thread to thread.
+// Everything compiles to nothing otherwise
+
+#if defined(RS2_USE_TRACY) || defined(RS2_USE_ITT)
+#include <string>
+#include <typeindex>
+#include <typeinfo>
+#include <mutex>
+#include <unordered_map>
+#ifdef __GNUC__
+#include <cxxabi.h>
+#include <cstdlib>
+#endif
+
+namespace librealsense
+{
+    namespace profiling
+    {
+        // Readable name of a type, such as the class of a processing block
+        inline const std::string& type_name(const std::type_info& type)
+        {
+            static std::mutex mutex;
+            static std::unordered_map<std::type_index, std::string> names;
+            std::lock_guard<std::mutex> lock(mutex);
+            auto it = names.find(type);
+            if (it != names.end())
+                return it->second;
+
+            std::string name = type.name();
+#ifdef __GNUC__
+            int status = 0;
+            if (auto demangled = abi::__cxa_demangle(type.name(), nullptr, nullptr, &status))
+            {
+                name = demangled;
+                std::free(demangled);
+            }
+#endif
+            return names[type] = name;
+        }
+    }
+}
+#endif
+
+#define LRS_PROFILE_CONCAT_INNER(a, b) a##b
+#define LRS_PROFILE_CONCAT(a, b) LRS_PROFILE_CONCAT_INNER(a, b)
+
+#if defined(RS2_USE_TRACY)
+#include <tracy/Tracy.hpp>
+
+#define LRS_PROFILE_ZONE(name) ZoneScopedN(name)
+#define LRS_PROFILE_ZONE_NAME(name) do { auto&& lrs_zone_name = (name); ZoneName(lrs_zone_name.c_str(), lrs_zone_name.size()); } while (0)
+#define LRS_PROFILE_FRAME(number) ZoneValue(static_cast<uint64_t>(number))
+
+#elif defined(RS2_USE_ITT)
+#include <ittnotify.h>
+
+namespace librealsense
+{
+    namespace profiling
+    {
+        inline __itt_domain* domain()
+        {
+            static auto domain = __itt_domain_create("librealsense");
+            return domain;
+        }
+
+        class itt_zone
+        {
+        public:
+            explicit itt_zone(__itt_string_handle* name) { __itt_task_begin(domain(), __itt_null, __itt_null, name); }
+            ~itt_zone() { __itt_task_end(domain()); }
+
+            itt_zone(const itt_zone&) = delete;
+            itt_zone& operator=(const itt_zone&) = delete;
+        };
+
+        // ITT tasks are named when they begin, a renamed zone is a nested task spanning the rest of the scope
+        inline __itt_string_handle* name_handle(const std::string& name)
+        {
+            return __itt_string_handle_create(name.c_str());
+        }
+
+        inline void frame_number(uint64_t number)
+        {
+            static auto key = __itt_string_handle_create("frame");
+            __itt_metadata_add(domain(), __itt_null, key, __itt_metadata_u64, 1, &number);
+        }
+    }
+}
+
+#define LRS_PROFILE_ZONE(name) \
+    static __itt_string_handle* LRS_PROFILE_CONCAT(lrs_zone_handle_, __LINE__) = __itt_string_handle_create(name); \
+    librealsense::profiling::itt_zone LRS_PROFILE_CONCAT(lrs_zone_, __LINE__)(LRS_PROFILE_CONCAT(lrs_zone_handle_, __LINE__))
+#define LRS_PROFILE_ZONE_NAME(name) \
+    librealsense::profiling::itt_zone LRS_PROFILE_CONCAT(lrs_named_zone_, __LINE__)(librealsense::profiling::name_handle(name))
+#define LRS_PROFILE_FRAME(number) librealsense::profiling::frame_number(static_cast<uint64_t>(number))
+
+#else
+
+#define LRS_PROFILE_ZONE(name) do {} while (0)
+#define LRS_PROFILE_ZONE_NAME(name) do {} while (0)
+#define LRS_PROFILE_FRAME(number) do {} while (0)
+
+#endif
@@ -11,13 +11,14 @@
 #include "core/motion.h"
 #include "core/extension.h"
 #include "media/record/record_device.h"
-#include <media/ros/ros_writer.h>
-#include <media/ros/ros_reader.h>
+#include <media/device-serializers.h>
 #include "core/advanced_mode.h"
 #include "source.h"
 #include "core/processing.h"
 #include "proc/synthetic-stream.h"
 #include "proc/processing-blocks-factory.h"
+#include "gl/pointcloud-gl.h"
+#include "gl/align-gl.h"
 #include "proc/colorizer.h"
 #include "proc/pointcloud.h"
 #include "proc/disparity-transform.h"
@@ -26,13 +27,44 @@
 #include "proc/spatial-filter.h"
 #include "proc/hole-filling-filter.h"
 #include "proc/rates_printer.h"
+#include "proc/rate-limiter.h"
+#include "proc/depth-compression.h"
+#include "proc/depth-refine.h"
+#include "proc/color-to-depth.h"
+#include "proc/yuy2-decoder.h"
+#include "proc/imu-fusion.h"
+#include "proc/threshold-crop.h"
+#include "proc/voxel-grid-filter.h"
+#include "proc/normal-estimation.h"
+#include "proc/tsdf-integrator.h"
+#include "proc/mesh-generator.h"
+#include "proc/depth-statistics.h"
+#include "proc/height-map.h"
+#include "frame-control-queue.h"
+#include "numa-allocator.h"
+#ifdef RS2_USE_CUDA
+#include "cuda/cuda-mapped-allocator.cuh"
+#endif
+#include "device-cache.h"
+#include "usb-bandwidth.h"
+#include "stream-statistics.h"
+#ifdef RS2_USE_LIBJPEG
+#include "proc/mjpeg-decoder.h"
+#endif
+#include "proc/processing-graph.h"
 #include "media/playback/playback_device.h"
+#include "media/playback/playback_group.h"
 #include "stream.h"
 #include "../include/librealsense2/h/rs_types.h"
 #include "pipeline/pipeline.h"
 #include "environment.h"
 #include "proc/temporal-filter.h"
 #include "software-device.h"
+#include "frame-serializer.h"
+#include "tracing.h"
+#ifdef RS2_USE_V4L2_BACKEND
+#include "linux/backend-v4l2.h"
+#endif
 
 ////////////////////////
 // API implementation //
@@ -100,12 +132,72 @@ struct rs2_pipeline_profile
 
 struct rs2_frame_queue
 {
-    explicit rs2_frame_queue(int cap)
-        : queue(cap)
+    explicit rs2_frame_queue(int cap, rs2_frame_queue_policy policy = RS2_FRAME_QUEUE_POLICY_MUTEX)
+        : wait(std::make_shared<wait_control>()),
+        queue(policy == RS2_FRAME_QUEUE_POLICY_MUTEX ? cap : 0, wait),
+        lock_free(policy == RS2_FRAME_QUEUE_POLICY_LOCK_FREE ? new lock_free_frame_queue(cap, wait) : nullptr)
     {
+        auto on_drop = [](librealsense::frame_holder& f)
+        {
+            librealsense::stream_statistics::instance().dropped(f.frame, RS2_FRAME_DROP_REASON_QUEUE);
+        };
+        if (lock_free) lock_free->set_on_drop(on_drop);
+        else queue.set_on_drop(on_drop);
+    }
+
+    void enqueue(librealsense::frame_holder&& fh)
+    {
+        if (lock_free) lock_free->enqueue(std::move(fh));
+        else queue.enqueue(std::move(fh));
+    }
+
+    bool dequeue(librealsense::frame_holder* fh, unsigned int timeout_ms)
+    {
+        return lock_free ? lock_free->dequeue(fh, timeout_ms) : queue.dequeue(fh, timeout_ms);
+    }
+
+    bool try_dequeue(librealsense::frame_holder* fh)
+    {
+        return lock_free ? lock_free->try_dequeue(fh) : queue.try_dequeue(fh);
+    }
+
+    void clear()
+    {
+        if (lock_free) lock_free->clear();
+        else queue.clear();
     }
 
+    typedef single_consumer_frame_queue<librealsense::frame_holder, lock_free_queue<librealsense::frame_holder>> lock_free_frame_queue;
+    std::shared_ptr<wait_control> wait;
     single_consumer_frame_queue<librealsense::frame_holder> queue;
+    std::unique_ptr<lock_free_frame_queue> lock_free;
+};
+
+struct rs2_frame_broadcast
+{
+    explicit rs2_frame_broadcast(int cap) : broadcast(cap) {}
+
+    broadcast_queue<librealsense::frame_holder> broadcast;
+};
+
+struct rs2_processing_graph
+{
+    std::shared_ptr<librealsense::processing_graph> graph;
+};
+
+struct rs2_playback_group
+{
+    std::shared_ptr<librealsense::playback_group> group;
+};
+
+struct rs2_frame_serializer
+{
+    librealsense::frame_serializer serializer;
+};
+
+struct rs2_frame_deserializer
+{
+    std::unique_ptr<librealsense::frame_deserializer> deserializer;
 };
 
 struct rs2_processing_block : public rs2_options
@@ -183,11 +275,15 @@ void verify_version_compatibility(int api_version)
 
 void notifications_processor::raise_notification(const notification n)
 {
+    // Nothing is queued until a callback is set
+    if (!std::atomic_load(&_callback))
+        return;
+
     _dispatcher.invoke([this, n](dispatcher::cancellable_timer ct)
     {
-        std::lock_guard<std::mutex> lock(_callback_mutex);
         rs2_notification noti(&n);
-        if (_callback)_callback->on_notification(&noti);
+        if (auto callback = std::atomic_load(&_callback))
+            callback->on_notification(&noti);
     });
 }
 
@@ -236,6 +332,24 @@ int rs2_device_hub_is_device_connected(const rs2_device_hub* hub, const rs2_devi
 }
 HANDLE_EXCEPTIONS_AND_RETURN(0, hub, device)
 
+rs2_device* rs2_device_hub_wait_for_device_by_serial(const rs2_device_hub* hub, const char* serial, unsigned int timeout_ms, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(hub);
+    VALIDATE_NOT_NULL(serial);
+    auto dev = hub->hub->wait_for_device(std::chrono::milliseconds(timeout_ms), false, serial);
+    return new rs2_device{ hub->hub->get_context(), std::make_shared<readonly_device_info>(dev), dev };
+}
+HANDLE_EXCEPTIONS_AND_RETURN(nullptr, hub, serial, timeout_ms)
+
+void rs2_device_hub_get_reconnect_stats(const rs2_device_hub* hub, const char* serial, rs2_reconnect_stats* stats, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(hub);
+    VALIDATE_NOT_NULL(serial);
+    VALIDATE_NOT_NULL(stats);
+    *stats = hub->hub->get_reconnect_stats(serial);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, hub, serial, stats)
+
 rs2_device_list* rs2_query_devices(const rs2_context* context, rs2_error** error)
 {
     return rs2_query_devices_ex(context, RS2_PRODUCT_LINE_ANY_INTEL, error);
@@ -424,6 +538,22 @@ int rs2_is_stream_profile_default(const rs2_stream_profile* profile, rs2_error**
 }
 HANDLE_EXCEPTIONS_AND_RETURN(0, profile)
 
+void rs2_get_stream_statistics(const rs2_stream_profile* mode, rs2_stream_statistics* statistics, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(mode);
+    VALIDATE_NOT_NULL(statistics);
+    static_assert(sizeof(statistics->dropped) / sizeof(statistics->dropped[0]) == RS2_FRAME_DROP_REASON_COUNT, "a counter per drop reason");
+    *statistics = librealsense::stream_statistics::instance().get(mode->profile->get_unique_id());
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, mode, statistics)
+
+void rs2_reset_stream_statistics(const rs2_stream_profile* mode, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(mode);
+    librealsense::stream_statistics::instance().reset(mode->profile->get_unique_id());
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, mode)
+
 void rs2_get_stream_profile_data(const rs2_stream_profile* mode, rs2_stream* stream, rs2_format* format, int* index, int* unique_id, int* framerate, rs2_error** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(mode);
@@ -487,6 +617,40 @@ const rs2_raw_data_buffer* rs2_send_and_receive_raw_data(rs2_device* device, voi
 }
 HANDLE_EXCEPTIONS_AND_RETURN(nullptr, device)
 
+const rs2_raw_data_buffer* rs2_send_and_receive_raw_data_batch(rs2_device* device, void* raw_data_to_send, unsigned size_of_raw_data_to_send, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(device);
+    VALIDATE_NOT_NULL(raw_data_to_send);
+
+    auto debug_interface = VALIDATE_INTERFACE(device->device, librealsense::debug_interface);
+
+    auto raw_data_buffer = static_cast<const uint8_t*>(raw_data_to_send);
+    std::vector<std::vector<uint8_t>> commands;
+    for (size_t offset = 0; offset < size_of_raw_data_to_send;)
+    {
+        uint32_t size;
+        if (size_of_raw_data_to_send - offset < sizeof(size))
+            throw invalid_value_exception("rs2_send_and_receive_raw_data_batch: truncated command size");
+        std::memcpy(&size, raw_data_buffer + offset, sizeof(size));
+        offset += sizeof(size);
+        if (size_of_raw_data_to_send - offset < size)
+            throw invalid_value_exception("rs2_send_and_receive_raw_data_batch: truncated command");
+        commands.emplace_back(raw_data_buffer + offset, raw_data_buffer + offset + size);
+        offset += size;
+    }
+
+    std::vector<uint8_t> ret_data;
+    for (auto&& response : debug_interface->send_receive_raw_data_batch(commands))
+    {
+        auto size = static_cast<uint32_t>(response.size());
+        auto size_bytes = reinterpret_cast<const uint8_t*>(&size);
+        ret_data.insert(ret_data.end(), size_bytes, size_bytes + sizeof(size));
+        ret_data.insert(ret_data.end(), response.begin(), response.end());
+    }
+    return new rs2_raw_data_buffer{ ret_data };
+}
+HANDLE_EXCEPTIONS_AND_RETURN(nullptr, device, size_of_raw_data_to_send)
+
 const unsigned char* rs2_get_raw_data(const rs2_raw_data_buffer* buffer, rs2_error** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(buffer);
@@ -566,6 +730,65 @@ void rs2_set_option(const rs2_options* options, rs2_option option, float value,
 HANDLE_EXCEPTIONS_AND_RETURN(, options, option, value)
 
 
+static librealsense::options_container& get_options_container(const rs2_options* options)
+{
+    auto container = dynamic_cast<librealsense::options_container*>(options->options);
+    if (!container)
+        throw librealsense::invalid_value_exception("Option caching and change callbacks are not supported by these options");
+    return *container;
+}
+
+void rs2_set_option_cache(const rs2_options* options, rs2_option option, int enable, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(options);
+    VALIDATE_OPTION(options, option);
+    get_options_container(options).enable_option_cache(option, enable != 0);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, options, option, enable)
+
+void rs2_set_option_changed_callback(const rs2_options* options, rs2_option option, rs2_option_changed_callback_ptr callback, void* user, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(options);
+    VALIDATE_OPTION(options, option);
+    VALIDATE_NOT_NULL(callback);
+    get_options_container(options).add_option_observer(option, [option, callback, user](float value) { callback(option, value, user); });
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, options, option, callback, user)
+
+void rs2_set_option_changed_callback_cpp(const rs2_options* options, rs2_option option, rs2_option_changed_callback* callback, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(callback);
+    std::shared_ptr<rs2_option_changed_callback> owner(callback, [](rs2_option_changed_callback* p) { p->release(); });
+    VALIDATE_NOT_NULL(options);
+    VALIDATE_OPTION(options, option);
+    get_options_container(options).add_option_observer(option, [option, owner](float value) { owner->on_value_changed(option, value); });
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, options, option, callback)
+
+void rs2_set_option_async(const rs2_options* options, rs2_option option, float value, rs2_option_set_callback* callback, rs2_error** error) BEGIN_API_CALL
+{
+    std::shared_ptr<rs2_option_set_callback> owner(callback, [](rs2_option_set_callback* p) { if (p) p->release(); });
+    VALIDATE_NOT_NULL(options);
+    VALIDATE_OPTION(options, option);
+
+    auto container = dynamic_cast<librealsense::options_container*>(options->options);
+    if (!container)
+        throw librealsense::invalid_value_exception("Asynchronous writes are not supported by these options");
+
+    container->set_option_async(option, value, [option, value, owner](std::exception_ptr ex)
+    {
+        if (!owner) return;
+        rs2_error* e = nullptr;
+        if (ex)
+        {
+            try { std::rethrow_exception(ex); }
+            catch (...) { librealsense::translate_exception("rs2_set_option_async", "", &e); }
+        }
+        owner->on_set(option, value, e);
+    });
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, options, option, value, callback)
+
 int rs2_supports_option(const rs2_options* options, rs2_option option, rs2_error** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(options);
@@ -573,6 +796,15 @@ int rs2_supports_option(const rs2_options* options, rs2_option option, rs2_error
 }
 HANDLE_EXCEPTIONS_AND_RETURN(0, options, option)
 
+int rs2_try_get_option(const rs2_options* options, rs2_option option, float* value) BEGIN_API_CALL
+{
+    if (!options || !value || !options->options->supports_option(option))
+        return 0;
+    *value = options->options->get_option(option).query();
+    return 1;
+}
+NOEXCEPT_RETURN(0, options, option)
+
 void rs2_get_option_range(const rs2_options* options, rs2_option option,
     float* min, float* max, float* step, float* def, rs2_error** error) BEGIN_API_CALL
 {
@@ -590,6 +822,16 @@ void rs2_get_option_range(const rs2_options* options, rs2_option option,
 }
 HANDLE_EXCEPTIONS_AND_RETURN(, options, option, min, max, step, def)
 
+int rs2_get_options_snapshot(const rs2_options* options, rs2_option_value* values, int count, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(options);
+    VALIDATE_NOT_NULL(values);
+    auto snapshot = options->options->get_options_snapshot();
+    std::copy_n(snapshot.begin(), std::min(snapshot.size(), static_cast<size_t>(std::max(count, 0))), values);
+    return static_cast<int>(snapshot.size());
+}
+HANDLE_EXCEPTIONS_AND_RETURN(0, options, values, count)
+
 const char* rs2_get_device_info(const rs2_device* dev, rs2_camera_info info, rs2_error** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(dev);
@@ -688,6 +930,115 @@ void rs2_set_notifications_callback_cpp(const rs2_sensor* sensor, rs2_notificati
 }
 HANDLE_EXCEPTIONS_AND_RETURN(, sensor, callback)
 
+void rs2_set_frame_allocator(const rs2_sensor* sensor, rs2_frame_allocate_ptr allocate, rs2_frame_deallocate_ptr deallocate, void* user, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(sensor);
+    VALIDATE_NOT_NULL(allocate);
+    VALIDATE_NOT_NULL(deallocate);
+    auto alloc_sensor = dynamic_cast<librealsense::frame_allocator_interface*>(sensor->sensor);
+    if (!alloc_sensor)
+        throw librealsense::invalid_value_exception("This sensor does not support custom frame allocation!");
+
+    librealsense::frame_allocator_ptr allocator(
+        new librealsense::frame_allocator(allocate, deallocate, user),
+        [](rs2_frame_allocator* p) { delete p; });
+    alloc_sensor->set_frame_allocator(std::move(allocator));
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, sensor, allocate, deallocate, user)
+
+void rs2_set_frame_allocator_cpp(const rs2_sensor* sensor, rs2_frame_allocator* allocator, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(sensor);
+    VALIDATE_NOT_NULL(allocator);
+    auto alloc_sensor = dynamic_cast<librealsense::frame_allocator_interface*>(sensor->sensor);
+    if (!alloc_sensor)
+        throw librealsense::invalid_value_exception("This sensor does not support custom frame allocation!");
+    alloc_sensor->set_frame_allocator({ allocator, [](rs2_frame_allocator* p) { p->release(); } });
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, sensor, allocator)
+
+static int get_sensor_numa_node(const rs2_sensor* sensor)
+{
+    auto& device = sensor->sensor->get_device();
+    if (!device.supports_info(RS2_CAMERA_INFO_PHYSICAL_PORT))
+        return -1;
+    return librealsense::get_numa_node(device.get_info(RS2_CAMERA_INFO_PHYSICAL_PORT));
+}
+
+void rs2_set_frame_allocation_policy(const rs2_sensor* sensor, int numa_node, int huge_pages, int pin_threads, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(sensor);
+    VALIDATE_RANGE(numa_node, RS2_NUMA_NODE_LOCAL, 1023);
+    auto alloc_sensor = dynamic_cast<librealsense::frame_allocator_interface*>(sensor->sensor);
+    if (!alloc_sensor)
+        throw librealsense::invalid_value_exception("This sensor does not support custom frame allocation!");
+
+    auto node = numa_node == RS2_NUMA_NODE_LOCAL ? get_sensor_numa_node(sensor) : numa_node;
+    if (numa_node == RS2_NUMA_NODE_LOCAL && node < 0)
+        LOG_WARNING("The NUMA node of the sensor is unknown, frame buffers are not bound to a node");
+
+    librealsense::frame_allocator_ptr allocator(
+        new librealsense::numa_frame_allocator(node, huge_pages != 0),
+        [](rs2_frame_allocator* p) { p->release(); });
+    alloc_sensor->set_frame_allocator(std::move(allocator));
+    alloc_sensor->set_callback_cpus(pin_threads ? librealsense::get_numa_node_cpus(node) : std::vector<int>());
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, sensor, numa_node, huge_pages, pin_threads)
+
+int rs2_get_sensor_numa_node(const rs2_sensor* sensor, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(sensor);
+    return get_sensor_numa_node(sensor);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(-1, sensor)
+
+void rs2_set_cuda_frame_allocation(const rs2_sensor* sensor, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(sensor);
+#ifdef RS2_USE_CUDA
+    auto alloc_sensor = dynamic_cast<librealsense::frame_allocator_interface*>(sensor->sensor);
+    if (!alloc_sensor)
+        throw librealsense::invalid_value_exception("This sensor does not support custom frame allocation!");
+
+    librealsense::frame_allocator_ptr allocator(
+        new rscuda::cuda_mapped_frame_allocator(),
+        [](rs2_frame_allocator* p) { p->release(); });
+    alloc_sensor->set_frame_allocator(std::move(allocator));
+#else
+    throw not_implemented_exception("librealsense was built without CUDA, see BUILD_WITH_CUDA");
+#endif
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, sensor)
+
+static void get_memory_usage(const memory_account::usage& usage, rs2_memory_usage* result)
+{
+    result->in_use = usage.in_use;
+    result->pooled = usage.pooled;
+    result->dropped = usage.dropped;
+}
+
+void rs2_get_sensor_memory_usage(const rs2_sensor* sensor, rs2_memory_usage* usage, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(sensor);
+    VALIDATE_NOT_NULL(usage);
+    auto base = dynamic_cast<librealsense::sensor_base*>(sensor->sensor);
+    if (!base)
+        throw librealsense::invalid_value_exception("This sensor does not account for its frame memory!");
+    get_memory_usage(base->get_memory_usage(), usage);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, sensor, usage)
+
+unsigned long long rs2_get_stream_profile_bandwidth(const rs2_sensor* sensor, const rs2_stream_profile* profile, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(sensor);
+    VALIDATE_NOT_NULL(profile);
+    VALIDATE_NOT_NULL(profile->profile);
+    // Not owned, the profile outlives the call
+    std::shared_ptr<librealsense::stream_profile_interface> p(std::shared_ptr<void>(), profile->profile);
+    return librealsense::estimate_bandwidth(*sensor->sensor, { p });
+}
+HANDLE_EXCEPTIONS_AND_RETURN(0, sensor, profile)
+
 void rs2_set_devices_changed_callback_cpp(rs2_context* context, rs2_devices_changed_callback* callback, rs2_error** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(context);
@@ -719,6 +1070,37 @@ rs2_metadata_type rs2_get_frame_metadata(const rs2_frame* frame, rs2_frame_metad
 }
 HANDLE_EXCEPTIONS_AND_RETURN(0, frame, frame_metadata)
 
+int rs2_try_get_frame_metadata(const rs2_frame* frame, rs2_frame_metadata_value frame_metadata, rs2_metadata_type* value) BEGIN_API_CALL
+{
+    if (!frame || !value || !librealsense::is_valid(frame_metadata))
+        return 0;
+    auto f = (frame_interface*)frame;
+    if (!f->supports_frame_metadata(frame_metadata))
+        return 0;
+    *value = f->get_frame_metadata(frame_metadata);
+    return 1;
+}
+NOEXCEPT_RETURN(0, frame, frame_metadata)
+
+int rs2_get_frame_metadata_all(const rs2_frame* frame, rs2_metadata_type* values, int* supported, int count, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(frame);
+    VALIDATE_NOT_NULL(values);
+    VALIDATE_RANGE(count, 0, ::RS2_FRAME_METADATA_COUNT);
+    auto f = (frame_interface*)frame;
+    auto supported_count = 0;
+    for (auto i = 0; i < count; ++i)
+    {
+        auto md = static_cast<rs2_frame_metadata_value>(i);
+        auto is_supported = f->supports_frame_metadata(md);
+        values[i] = is_supported ? f->get_frame_metadata(md) : 0;
+        if (supported) supported[i] = is_supported ? 1 : 0;
+        if (is_supported) ++supported_count;
+    }
+    return supported_count;
+}
+HANDLE_EXCEPTIONS_AND_RETURN(0, frame, values, supported, count)
+
 const char* rs2_get_notification_description(rs2_notification* notification, rs2_error** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(notification);
@@ -780,6 +1162,13 @@ rs2_time_t rs2_get_frame_timestamp(const rs2_frame* frame_ref, rs2_error** error
 }
 HANDLE_EXCEPTIONS_AND_RETURN(0, frame_ref)
 
+int rs2_get_frame_dmabuf_fd(const rs2_frame* frame_ref, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(frame_ref);
+    return ((frame_interface*)frame_ref)->get_frame_dmabuf_fd();
+}
+HANDLE_EXCEPTIONS_AND_RETURN(-1, frame_ref)
+
 rs2_timestamp_domain rs2_get_frame_timestamp_domain(const rs2_frame* frame_ref, rs2_error** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(frame_ref);
@@ -797,7 +1186,7 @@ HANDLE_EXCEPTIONS_AND_RETURN(nullptr, frame_ref)
 int rs2_get_frame_width(const rs2_frame* frame_ref, rs2_error** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(frame_ref);
-    auto vf = VALIDATE_INTERFACE(((frame_interface*)frame_ref), librealsense::video_frame);
+    auto vf = VALIDATE_FRAME(((frame_interface*)frame_ref), librealsense::video_frame);
     return vf->get_width();
 }
 HANDLE_EXCEPTIONS_AND_RETURN(0, frame_ref)
@@ -805,7 +1194,7 @@ HANDLE_EXCEPTIONS_AND_RETURN(0, frame_ref)
 int rs2_get_frame_height(const rs2_frame* frame_ref, rs2_error** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(frame_ref);
-    auto vf = VALIDATE_INTERFACE(((frame_interface*)frame_ref), librealsense::video_frame);
+    auto vf = VALIDATE_FRAME(((frame_interface*)frame_ref), librealsense::video_frame);
     return vf->get_height();
 }
 HANDLE_EXCEPTIONS_AND_RETURN(0, frame_ref)
@@ -813,7 +1202,7 @@ HANDLE_EXCEPTIONS_AND_RETURN(0, frame_ref)
 int rs2_get_frame_stride_in_bytes(const rs2_frame* frame_ref, rs2_error** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(frame_ref);
-    auto vf = VALIDATE_INTERFACE(((frame_interface*)frame_ref), librealsense::video_frame);
+    auto vf = VALIDATE_FRAME(((frame_interface*)frame_ref), librealsense::video_frame);
     return vf->get_stride();
 }
 HANDLE_EXCEPTIONS_AND_RETURN(0, frame_ref)
@@ -828,7 +1217,7 @@ HANDLE_EXCEPTIONS_AND_RETURN(nullptr, frame_ref)
 int rs2_get_frame_bits_per_pixel(const rs2_frame* frame_ref, rs2_error** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(frame_ref);
-    auto vf = VALIDATE_INTERFACE(((frame_interface*)frame_ref), librealsense::video_frame);
+    auto vf = VALIDATE_FRAME(((frame_interface*)frame_ref), librealsense::video_frame);
     return vf->get_bpp();
 }
 HANDLE_EXCEPTIONS_AND_RETURN(0, frame_ref)
@@ -883,6 +1272,14 @@ rs2_frame_queue* rs2_create_frame_queue(int capacity, rs2_error** error) BEGIN_A
 }
 HANDLE_EXCEPTIONS_AND_RETURN(nullptr, capacity)
 
+rs2_frame_queue* rs2_create_frame_queue_with_policy(int capacity, rs2_frame_queue_policy policy, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_ENUM(policy);
+    VALIDATE_RANGE(capacity, 1, std::numeric_limits<int>::max());
+    return new rs2_frame_queue(capacity, policy);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(nullptr, capacity, policy)
+
 void rs2_delete_frame_queue(rs2_frame_queue* queue) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(queue);
@@ -894,7 +1291,7 @@ rs2_frame* rs2_wait_for_frame(rs2_frame_queue* queue, unsigned int timeout_ms, r
 {
     VALIDATE_NOT_NULL(queue);
     librealsense::frame_holder fh;
-    if (!queue->queue.dequeue(&fh, timeout_ms))
+    if (!queue->dequeue(&fh, timeout_ms))
     {
         throw std::runtime_error("Frame did not arrive in time!");
     }
@@ -910,7 +1307,7 @@ int rs2_poll_for_frame(rs2_frame_queue* queue, rs2_frame** output_frame, rs2_err
     VALIDATE_NOT_NULL(queue);
     VALIDATE_NOT_NULL(output_frame);
     librealsense::frame_holder fh;
-    if (queue->queue.try_dequeue(&fh))
+    if (queue->try_dequeue(&fh))
     {
         frame_interface* result = nullptr;
         std::swap(result, fh.frame);
@@ -927,7 +1324,7 @@ int rs2_try_wait_for_frame(rs2_frame_queue* queue, unsigned int timeout_ms, rs2_
     VALIDATE_NOT_NULL(queue);
     VALIDATE_NOT_NULL(output_frame);
     librealsense::frame_holder fh;
-    if (!queue->queue.dequeue(&fh, timeout_ms))
+    if (!queue->dequeue(&fh, timeout_ms))
     {
         return false;
     }
@@ -946,17 +1343,147 @@ void rs2_enqueue_frame(rs2_frame* frame, void* queue) BEGIN_API_CALL
     auto q = reinterpret_cast<rs2_frame_queue*>(queue);
     librealsense::frame_holder fh;
     fh.frame = (frame_interface*)frame;
-    q->queue.enqueue(std::move(fh));
+    q->enqueue(std::move(fh));
 }
 NOEXCEPT_RETURN(, frame, queue)
 
 void rs2_flush_queue(rs2_frame_queue* queue, rs2_error** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(queue);
-    queue->queue.clear();
+    queue->clear();
 }
 HANDLE_EXCEPTIONS_AND_RETURN(, queue)
 
+static void get_wait_latency(wait_control& wait, rs2_wait_latency* latency)
+{
+    static_assert(RS2_WAIT_LATENCY_BUCKETS == wait_control::latency_buckets, "Wait latency buckets don't match");
+    wait.measure();
+    for (int i = 0; i < RS2_WAIT_LATENCY_BUCKETS; ++i)
+        latency->counts[i] = wait.latency_count(i);
+    latency->spinning = wait.wakeups(wait_control::spinning);
+    latency->yielding = wait.wakeups(wait_control::yielding);
+    latency->sleeping = wait.wakeups(wait_control::sleeping);
+}
+
+void rs2_frame_queue_set_wait_strategy(rs2_frame_queue* queue, unsigned int spin_us, unsigned int yield_us, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(queue);
+    queue->wait->set_strategy(std::chrono::microseconds(spin_us), std::chrono::microseconds(yield_us));
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, queue, spin_us, yield_us)
+
+void rs2_frame_queue_get_wait_latency(rs2_frame_queue* queue, rs2_wait_latency* latency, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(queue);
+    VALIDATE_NOT_NULL(latency);
+    get_wait_latency(*queue->wait, latency);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, queue, latency)
+
+rs2_frame_broadcast* rs2_create_frame_broadcast(int capacity, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_RANGE(capacity, 1, std::numeric_limits<int>::max());
+    return new rs2_frame_broadcast(capacity);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(nullptr, capacity)
+
+void rs2_delete_frame_broadcast(rs2_frame_broadcast* broadcast) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(broadcast);
+    delete broadcast;
+}
+NOEXCEPT_RETURN(, broadcast)
+
+void rs2_frame_broadcast_enqueue(rs2_frame* frame, void* broadcast) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(frame);
+    VALIDATE_NOT_NULL(broadcast);
+    auto b = reinterpret_cast<rs2_frame_broadcast*>(broadcast);
+    librealsense::frame_holder fh;
+    fh.frame = (frame_interface*)frame;
+    b->broadcast.enqueue(std::move(fh));
+}
+NOEXCEPT_RETURN(, frame, broadcast)
+
+int rs2_frame_broadcast_subscribe(rs2_frame_broadcast* broadcast, rs2_broadcast_policy policy, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(broadcast);
+    VALIDATE_ENUM(policy);
+    return broadcast->broadcast.subscribe(policy == RS2_BROADCAST_POLICY_BLOCK);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(0, broadcast, policy)
+
+void rs2_frame_broadcast_unsubscribe(rs2_frame_broadcast* broadcast, int subscriber, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(broadcast);
+    broadcast->broadcast.unsubscribe(subscriber);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, broadcast, subscriber)
+
+rs2_frame* rs2_frame_broadcast_wait_for_frame(rs2_frame_broadcast* broadcast, int subscriber, unsigned int timeout_ms, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(broadcast);
+    librealsense::frame_holder fh;
+    if (!broadcast->broadcast.dequeue(subscriber, &fh, timeout_ms))
+    {
+        throw std::runtime_error("Frame did not arrive in time!");
+    }
+
+    frame_interface* result = nullptr;
+    std::swap(result, fh.frame);
+    return (rs2_frame*)result;
+}
+HANDLE_EXCEPTIONS_AND_RETURN(nullptr, broadcast, subscriber, timeout_ms)
+
+int rs2_frame_broadcast_poll_for_frame(rs2_frame_broadcast* broadcast, int subscriber, rs2_frame** output_frame, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(broadcast);
+    VALIDATE_NOT_NULL(output_frame);
+    librealsense::frame_holder fh;
+    if (broadcast->broadcast.try_dequeue(subscriber, &fh))
+    {
+        frame_interface* result = nullptr;
+        std::swap(result, fh.frame);
+        *output_frame = (rs2_frame*)result;
+        return true;
+    }
+
+    return false;
+}
+HANDLE_EXCEPTIONS_AND_RETURN(0, broadcast, subscriber, output_frame)
+
+int rs2_frame_broadcast_try_wait_for_frame(rs2_frame_broadcast* broadcast, int subscriber, unsigned int timeout_ms, rs2_frame** output_frame, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(broadcast);
+    VALIDATE_NOT_NULL(output_frame);
+    librealsense::frame_holder fh;
+    if (!broadcast->broadcast.dequeue(subscriber, &fh, timeout_ms))
+    {
+        return false;
+    }
+
+    frame_interface* result = nullptr;
+    std::swap(result, fh.frame);
+    *output_frame = (rs2_frame*)result;
+    return true;
+}
+HANDLE_EXCEPTIONS_AND_RETURN(0, broadcast, subscriber, timeout_ms, output_frame)
+
+void rs2_frame_broadcast_get_stats(rs2_frame_broadcast* broadcast, int subscriber, rs2_broadcast_stats* stats, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(broadcast);
+    VALIDATE_NOT_NULL(stats);
+    broadcast_queue<librealsense::frame_holder>::statistics s;
+    if (!broadcast->broadcast.get_statistics(subscriber, &s))
+        throw librealsense::invalid_value_exception(librealsense::to_string() << "No subscriber " << subscriber << " to the frame broadcast");
+
+    stats->received = s.received;
+    stats->dropped = s.dropped;
+    stats->lag = static_cast<unsigned int>(s.lag);
+    stats->max_lag = static_cast<unsigned int>(s.max_lag);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, broadcast, subscriber, stats)
+
 void rs2_get_extrinsics(const rs2_stream_profile* from,
     const rs2_stream_profile* to,
     rs2_extrinsics* extrin, rs2_error** error) BEGIN_API_CALL
@@ -990,6 +1517,17 @@ void rs2_hardware_reset(const rs2_device* device, rs2_error** error) BEGIN_API_C
 }
 HANDLE_EXCEPTIONS_AND_RETURN(, device)
 
+long long rs2_get_available_usb_bandwidth(const rs2_device* device, float utilization, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(device);
+    VALIDATE_RANGE(utilization, 0.f, 1.f);
+    uint64_t available = 0;
+    if (!librealsense::usb_bandwidth_planner::instance().get_available(*device->device, utilization, available))
+        return -1;
+    return static_cast<long long>(available);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(-1, device, utilization)
+
 // Verify  and provide API version encoded as integer value
 int rs2_get_api_version(rs2_error** error) BEGIN_API_CALL
 {
@@ -1063,7 +1601,45 @@ void rs2_get_region_of_interest(const rs2_sensor* sensor, int* min_x, int* min_y
 }
 HANDLE_EXCEPTIONS_AND_RETURN(, sensor, min_x, min_y, max_x, max_y)
 
-void rs2_free_error(rs2_error* error) { if (error) delete error; }
+static librealsense::frame_control_queue& get_frame_controls(const rs2_sensor* sensor)
+{
+    auto base = dynamic_cast<librealsense::sensor_base*>(sensor->sensor);
+    if (!base)
+        throw librealsense::invalid_value_exception("Frame controls are not supported by this sensor");
+    return base->get_frame_controls();
+}
+
+void rs2_queue_frame_option(const rs2_sensor* sensor, rs2_option option, float value, unsigned long long frame_number, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(sensor);
+    VALIDATE_ENUM(option);
+    get_frame_controls(sensor).queue_option(option, value, frame_number);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, sensor, option, value, frame_number)
+
+void rs2_queue_frame_region_of_interest(const rs2_sensor* sensor, int min_x, int min_y, int max_x, int max_y, unsigned long long frame_number, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(sensor);
+
+    VALIDATE_LE(min_x, max_x);
+    VALIDATE_LE(min_y, max_y);
+    VALIDATE_LE(0, min_x);
+    VALIDATE_LE(0, min_y);
+
+    get_frame_controls(sensor).queue_roi({ min_x, min_y, max_x, max_y }, frame_number);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, sensor, min_x, min_y, max_x, max_y, frame_number)
+
+void rs2_set_frame_control_callback_cpp(const rs2_sensor* sensor, rs2_frame_control_callback* callback, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(callback);
+    std::shared_ptr<rs2_frame_control_callback> owner(callback, [](rs2_frame_control_callback* p) { p->release(); });
+    VALIDATE_NOT_NULL(sensor);
+    get_frame_controls(sensor).set_callback([owner](const rs2_frame_control_status& status) { owner->on_status(&status); });
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, sensor, callback)
+
+void rs2_free_error(rs2_error* error) { if (error) librealsense::recycle_error(error); }
 const char* rs2_get_failed_function(const rs2_error* error) { return error ? error->function : nullptr; }
 const char* rs2_get_failed_args(const rs2_error* error) { return error ? error->args.c_str() : nullptr; }
 const char* rs2_get_error_message(const rs2_error* error) { return error ? error->message.c_str() : nullptr; }
@@ -1080,6 +1656,11 @@ const char* rs2_sr300_visual_preset_to_string(rs2_sr300_visual_preset preset)
 const char* rs2_log_severity_to_string(rs2_log_severity severity)                         { return librealsense::get_string(severity);     }
 const char* rs2_exception_type_to_string(rs2_exception_type type)                         { return librealsense::get_string(type);         }
 const char* rs2_playback_status_to_string(rs2_playback_status status)                     { return librealsense::get_string(status);       }
+const char* rs2_record_write_policy_to_string(rs2_record_write_policy policy)               { return librealsense::get_string(policy);       }
+const char* rs2_frame_control_state_to_string(rs2_frame_control_state state)               { return librealsense::get_string(state);        }
+const char* rs2_pipeline_stage_to_string(rs2_pipeline_stage stage)                       { return librealsense::get_string(stage);        }
+const char* rs2_thread_category_to_string(rs2_thread_category category)                { return librealsense::get_string(category);     }
+const char* rs2_frame_drop_reason_to_string(rs2_frame_drop_reason reason)              { return librealsense::get_string(reason);       }
 const char* rs2_extension_type_to_string(rs2_extension type)                              { return librealsense::get_string(type);         }
 const char* rs2_frame_metadata_to_string(rs2_frame_metadata_value metadata)               { return librealsense::get_string(metadata);     }
 const char* rs2_extension_to_string(rs2_extension type)                                   { return rs2_extension_type_to_string(type);     }
@@ -1112,6 +1693,7 @@ int rs2_is_sensor_extendable_to(const rs2_sensor* sensor, rs2_extension extensio
     case RS2_EXTENSION_DEPTH_SENSOR        : return VALIDATE_INTERFACE_NO_THROW(sensor->sensor, librealsense::depth_sensor)           != nullptr;
     case RS2_EXTENSION_DEPTH_STEREO_SENSOR : return VALIDATE_INTERFACE_NO_THROW(sensor->sensor, librealsense::depth_stereo_sensor)    != nullptr;
     case RS2_EXTENSION_SOFTWARE_SENSOR:  return VALIDATE_INTERFACE_NO_THROW(sensor->sensor, librealsense::software_sensor) != nullptr;
+    case RS2_EXTENSION_POSE_SENSOR     : return VALIDATE_INTERFACE_NO_THROW(sensor->sensor, librealsense::pose_sensor_interface) != nullptr;
     default:
         return false;
     }
@@ -1146,19 +1728,8 @@ int rs2_is_frame_extendable_to(const rs2_frame* f, rs2_extension extension_type,
 {
     VALIDATE_NOT_NULL(f);
     VALIDATE_ENUM(extension_type);
-    switch (extension_type)
-    {
-    case RS2_EXTENSION_VIDEO_FRAME     : return VALIDATE_INTERFACE_NO_THROW((frame_interface*)f, librealsense::video_frame)     != nullptr;
-    case RS2_EXTENSION_COMPOSITE_FRAME : return VALIDATE_INTERFACE_NO_THROW((frame_interface*)f, librealsense::composite_frame) != nullptr;
-    case RS2_EXTENSION_POINTS          : return VALIDATE_INTERFACE_NO_THROW((frame_interface*)f, librealsense::points)          != nullptr;
-    case RS2_EXTENSION_DEPTH_FRAME     : return VALIDATE_INTERFACE_NO_THROW((frame_interface*)f, librealsense::depth_frame)     != nullptr;
-    case RS2_EXTENSION_DISPARITY_FRAME : return VALIDATE_INTERFACE_NO_THROW((frame_interface*)f, librealsense::disparity_frame) != nullptr;
-    case RS2_EXTENSION_MOTION_FRAME    : return VALIDATE_INTERFACE_NO_THROW((frame_interface*)f, librealsense::motion_frame)    != nullptr;
-    case RS2_EXTENSION_POSE_FRAME      : return VALIDATE_INTERFACE_NO_THROW((frame_interface*)f, librealsense::pose_frame)      != nullptr;
-
-    default:
-        return false;
-    }
+    // Only the frame extensions are ever set on a frame
+    return ((frame_interface*)f)->is_extendable_to(extension_type);
 }
 HANDLE_EXCEPTIONS_AND_RETURN(0, f, extension_type)
 
@@ -1194,6 +1765,73 @@ void rs2_context_remove_device(rs2_context* ctx, const char* file, rs2_error** e
 }
 HANDLE_EXCEPTIONS_AND_RETURN(, ctx, file)
 
+void rs2_context_set_thread_pool(rs2_context* ctx, int threads, const int* cpus, int cpus_count, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(ctx);
+    VALIDATE_RANGE(threads, 0, (int)thread_pool::max_threads);
+    VALIDATE_RANGE(cpus_count, 0, std::numeric_limits<int>::max());
+    if (cpus_count) VALIDATE_NOT_NULL(cpus);
+
+    std::vector<int> cores(cpus, cpus + cpus_count);
+    for (auto&& cpu : cores)
+        VALIDATE_RANGE(cpu, 0, std::numeric_limits<int>::max());
+    thread_pool::instance()->configure(threads, std::move(cores));
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, ctx, threads, cpus, cpus_count)
+
+void rs2_context_set_thread_scheduling(rs2_context* ctx, rs2_thread_category category, const int* cpus, int cpus_count, int priority, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(ctx);
+    VALIDATE_ENUM(category);
+    VALIDATE_RANGE(cpus_count, 0, std::numeric_limits<int>::max());
+    VALIDATE_RANGE(priority, 0, 99);
+    if (cpus_count) VALIDATE_NOT_NULL(cpus);
+
+    thread_schedule schedule;
+    schedule.cpus.assign(cpus, cpus + cpus_count);
+    schedule.priority = priority;
+    thread_scheduling::instance().configure(category, std::move(schedule));
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, ctx, category, cpus, cpus_count, priority)
+
+void rs2_context_load_thread_scheduling(rs2_context* ctx, const char* json, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(ctx);
+    VALIDATE_NOT_NULL(json);
+    thread_scheduling::instance().load(json);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, ctx, json)
+
+void rs2_context_set_memory_budget(rs2_context* ctx, unsigned long long bytes, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(ctx);
+    memory_budget::instance().set_limit(bytes);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, ctx, bytes)
+
+void rs2_context_set_device_cache(rs2_context* ctx, const char* directory, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(ctx);
+    device_cache::instance().set_directory(directory ? directory : "");
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, ctx, directory)
+
+void rs2_context_get_memory_usage(rs2_context* ctx, rs2_memory_usage* usage, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(ctx);
+    VALIDATE_NOT_NULL(usage);
+    get_memory_usage(ctx->ctx->get_memory_account()->get_usage(), usage);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, ctx, usage)
+
+void rs2_context_get_total_memory_usage(rs2_context* ctx, rs2_memory_usage* usage, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(ctx);
+    VALIDATE_NOT_NULL(usage);
+    get_memory_usage(memory_account::global()->get_usage(), usage);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, ctx, usage)
+
 const char* rs2_playback_device_get_file_path(const rs2_device* device, rs2_error** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(device);
@@ -1251,6 +1889,54 @@ void rs2_playback_device_set_real_time(const rs2_device* device, int real_time,
 }
 HANDLE_EXCEPTIONS_AND_RETURN(, device)
 
+void rs2_playback_device_set_prefetch_size(const rs2_device* device, int frames, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(device);
+    VALIDATE_RANGE(frames, 0, static_cast<int>(librealsense::prefetch_reader::MAX_CACHE_SIZE));
+    auto playback = VALIDATE_INTERFACE(device->device, librealsense::playback_device);
+    playback->set_prefetch_size(frames);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, device, frames)
+
+void rs2_playback_device_skip_late_frames(const rs2_device* device, float max_lateness, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(device);
+    VALIDATE_RANGE(max_lateness, 0.f, std::numeric_limits<float>::max());
+    auto playback = VALIDATE_INTERFACE(device->device, librealsense::playback_device);
+    playback->skip_late_frames(std::chrono::duration_cast<librealsense::device_serializer::nanoseconds>(std::chrono::duration<double, std::milli>(max_lateness)));
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, device, max_lateness)
+
+static void process_playback_ranges(const rs2_device* device, rs2_processing_block** blocks, int count, librealsense::frame_callback_ptr on_frame)
+{
+    VALIDATE_NOT_NULL(device);
+    VALIDATE_NOT_NULL(blocks);
+    VALIDATE_RANGE(count, 1, std::numeric_limits<int>::max());
+    auto playback = VALIDATE_INTERFACE(device->device, librealsense::playback_device);
+
+    std::vector<std::shared_ptr<librealsense::processing_block_interface>> ranges_blocks;
+    for (int i = 0; i < count; ++i)
+    {
+        VALIDATE_NOT_NULL(blocks[i]);
+        ranges_blocks.push_back(blocks[i]->block);
+    }
+    playback->process_ranges(ranges_blocks, on_frame);
+}
+
+void rs2_playback_device_process_ranges(const rs2_device* device, rs2_processing_block** blocks, int count, rs2_frame_callback* on_frame, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(on_frame);
+    process_playback_ranges(device, blocks, count, { on_frame, [](rs2_frame_callback* p) { p->release(); } });
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, device, blocks, count, on_frame)
+
+void rs2_playback_device_process_ranges_fptr(const rs2_device* device, rs2_processing_block** blocks, int count, rs2_frame_callback_ptr on_frame, void* user, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(on_frame);
+    process_playback_ranges(device, blocks, count, { new frame_callback(on_frame, user), [](rs2_frame_callback* p) { p->release(); } });
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, device, blocks, count, on_frame, user)
+
 int rs2_playback_device_is_real_time(const rs2_device* device, rs2_error** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(device);
@@ -1294,6 +1980,75 @@ void rs2_playback_device_stop(const rs2_device* device, rs2_error** error) BEGIN
 }
 HANDLE_EXCEPTIONS_AND_RETURN(, device)
 
+rs2_playback_group* rs2_create_playback_group(int reader_threads, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_RANGE(reader_threads, 0, thread_pool::max_threads);
+    return new rs2_playback_group{ std::make_shared<librealsense::playback_group>(reader_threads) };
+}
+HANDLE_EXCEPTIONS_AND_RETURN(nullptr, reader_threads)
+
+void rs2_delete_playback_group(rs2_playback_group* group) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(group);
+    delete group;
+}
+NOEXCEPT_RETURN(, group)
+
+void rs2_playback_group_add_device(rs2_playback_group* group, const rs2_device* device, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(group);
+    VALIDATE_NOT_NULL(device);
+    auto playback = std::dynamic_pointer_cast<librealsense::playback_device>(device->device);
+    if (!playback)
+        throw std::runtime_error("Device is not a playback device");
+    group->group->add(playback);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, group, device)
+
+void rs2_playback_group_pause(rs2_playback_group* group, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(group);
+    group->group->pause();
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, group)
+
+void rs2_playback_group_resume(rs2_playback_group* group, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(group);
+    group->group->resume();
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, group)
+
+void rs2_playback_group_seek(rs2_playback_group* group, long long int time, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(group);
+    VALIDATE_RANGE(time, 0, std::numeric_limits<long long int>::max());
+    group->group->seek(std::chrono::nanoseconds(time));
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, group, time)
+
+void rs2_playback_group_set_playback_speed(rs2_playback_group* group, float speed, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(group);
+    group->group->set_frame_rate(speed);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, group, speed)
+
+void rs2_playback_group_set_stepping(rs2_playback_group* group, int stepping, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(group);
+    group->group->set_stepping(stepping != 0);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, group, stepping)
+
+void rs2_playback_group_step(rs2_playback_group* group, long long int duration, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(group);
+    VALIDATE_RANGE(duration, 0, std::numeric_limits<long long int>::max());
+    group->group->step(std::chrono::nanoseconds(duration));
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, group, duration)
+
 rs2_device* rs2_create_record_device(const rs2_device* device, const char* file, rs2_error** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(device);
@@ -1312,7 +2067,7 @@ rs2_device* rs2_create_record_device_ex(const rs2_device* device, const char* fi
     return new rs2_device({
         device->ctx,
         device->info,
-        std::make_shared<record_device>(device->device, std::make_shared<ros_writer>(file, compression_enabled))
+        std::make_shared<record_device>(device->device, create_file_writer(file, compression_enabled))
         });
 }
 HANDLE_EXCEPTIONS_AND_RETURN(nullptr, device, file)
@@ -1341,6 +2096,66 @@ const char* rs2_record_device_filename(const rs2_device* device, rs2_error** err
 }
 HANDLE_EXCEPTIONS_AND_RETURN(nullptr, device)
 
+void rs2_record_device_set_memory_budget(const rs2_device* device, unsigned long long bytes, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(device);
+    auto record_device = VALIDATE_INTERFACE(device->device, librealsense::record_device);
+    record_device->set_memory_budget(bytes);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, device, bytes)
+
+void rs2_record_device_set_stream_write_policy(const rs2_device* device, rs2_stream stream, int index, rs2_record_write_policy policy, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(device);
+    VALIDATE_ENUM(stream);
+    VALIDATE_ENUM(policy);
+    auto record_device = VALIDATE_INTERFACE(device->device, librealsense::record_device);
+    record_device->set_write_policy(stream, index, policy);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, device, stream, index, policy)
+
+void rs2_record_device_set_chunk_size(const rs2_device* device, unsigned int bytes, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(device);
+    auto record_device = VALIDATE_INTERFACE(device->device, librealsense::record_device);
+    record_device->set_chunk_size(bytes);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, device, bytes)
+
+void rs2_record_device_set_columnar_metadata(const rs2_device* device, int enable, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(device);
+    auto record_device = VALIDATE_INTERFACE(device->device, librealsense::record_device);
+    record_device->set_columnar_metadata(enable != 0);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, device, enable)
+
+void rs2_record_device_set_stream_compression(const rs2_device* device, rs2_stream stream, int index, int enable, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(device);
+    VALIDATE_ENUM(stream);
+    auto record_device = VALIDATE_INTERFACE(device->device, librealsense::record_device);
+    record_device->set_stream_compression(stream, index, enable != 0);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, device, stream, index, enable)
+
+void rs2_record_device_set_segment_limits(const rs2_device* device, unsigned long long bytes, unsigned long long duration_ms, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(device);
+    auto record_device = VALIDATE_INTERFACE(device->device, librealsense::record_device);
+    record_device->set_segment_limits(bytes, std::chrono::milliseconds(duration_ms));
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, device, bytes, duration_ms)
+
+void rs2_record_device_get_stats(const rs2_device* device, rs2_record_stats* stats, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(device);
+    VALIDATE_NOT_NULL(stats);
+    auto record_device = VALIDATE_INTERFACE(device->device, librealsense::record_device);
+    *stats = record_device->get_stats();
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, device, stats)
+
 
 rs2_frame* rs2_allocate_synthetic_video_frame(rs2_source* source, const rs2_stream_profile* new_stream, rs2_frame* original,
     int new_bpp, int new_width, int new_height, int new_stride, rs2_extension frame_type, rs2_error** error) BEGIN_API_CALL
@@ -1398,6 +2213,38 @@ void rs2_pipeline_stop(rs2_pipeline* pipe, rs2_error ** error) BEGIN_API_CALL
 }
 HANDLE_EXCEPTIONS_AND_RETURN(, pipe)
 
+void rs2_pipeline_pause(rs2_pipeline* pipe, rs2_error ** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(pipe);
+
+    pipe->pipeline->pause();
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, pipe)
+
+void rs2_pipeline_resume(rs2_pipeline* pipe, rs2_error ** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(pipe);
+
+    pipe->pipeline->resume();
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, pipe)
+
+rs2_pipeline_profile* rs2_pipeline_reconfigure(rs2_pipeline* pipe, rs2_config* config, rs2_error ** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(pipe);
+    VALIDATE_NOT_NULL(config);
+    return new rs2_pipeline_profile{ pipe->pipeline->reconfigure(config->config) };
+}
+HANDLE_EXCEPTIONS_AND_RETURN(nullptr, pipe, config)
+
+int rs2_pipeline_wait_for_streams(rs2_pipeline* pipe, unsigned int timeout_ms, rs2_error ** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(pipe);
+
+    return pipe->pipeline->wait_for_streams(timeout_ms) ? 1 : 0;
+}
+HANDLE_EXCEPTIONS_AND_RETURN(0, pipe, timeout_ms)
+
 rs2_frame* rs2_pipeline_wait_for_frames(rs2_pipeline* pipe, unsigned int timeout_ms, rs2_error ** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(pipe);
@@ -1504,6 +2351,51 @@ rs2_pipeline_profile* rs2_pipeline_start_with_config_and_callback_cpp(rs2_pipeli
 }
 HANDLE_EXCEPTIONS_AND_RETURN(nullptr, pipe, config, callback)
 
+void rs2_pipeline_set_frame_allocator(rs2_pipeline* pipe, rs2_frame_allocate_ptr allocate, rs2_frame_deallocate_ptr deallocate, void* user, rs2_error ** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(pipe);
+    VALIDATE_NOT_NULL(allocate);
+    VALIDATE_NOT_NULL(deallocate);
+
+    librealsense::frame_allocator_ptr allocator(
+        new librealsense::frame_allocator(allocate, deallocate, user),
+        [](rs2_frame_allocator* p) { delete p; });
+    pipe->pipeline->set_frame_allocator(std::move(allocator));
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, pipe, allocate, deallocate, user)
+
+void rs2_pipeline_set_frame_allocator_cpp(rs2_pipeline* pipe, rs2_frame_allocator* allocator, rs2_error ** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(pipe);
+    VALIDATE_NOT_NULL(allocator);
+
+    pipe->pipeline->set_frame_allocator({ allocator, [](rs2_frame_allocator* p) { p->release(); } });
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, pipe, allocator)
+
+void rs2_pipeline_set_callback_queue_size(rs2_pipeline* pipe, unsigned int queue_size, rs2_error ** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(pipe);
+    VALIDATE_RANGE(queue_size, 0, 64);
+    pipe->pipeline->set_callback_queue_size(queue_size);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, pipe, queue_size)
+
+void rs2_pipeline_set_wait_strategy(rs2_pipeline* pipe, unsigned int spin_us, unsigned int yield_us, rs2_error ** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(pipe);
+    pipe->pipeline->get_wait_control().set_strategy(std::chrono::microseconds(spin_us), std::chrono::microseconds(yield_us));
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, pipe, spin_us, yield_us)
+
+void rs2_pipeline_get_wait_latency(rs2_pipeline* pipe, rs2_wait_latency* latency, rs2_error ** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(pipe);
+    VALIDATE_NOT_NULL(latency);
+    get_wait_latency(pipe->pipeline->get_wait_control(), latency);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, pipe, latency)
+
 rs2_pipeline_profile* rs2_pipeline_get_active_profile(rs2_pipeline* pipe, rs2_error ** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(pipe);
@@ -1631,6 +2523,14 @@ void rs2_config_disable_all_streams(rs2_config* config, rs2_error ** error) BEGI
 }
 HANDLE_EXCEPTIONS_AND_RETURN(, config)
 
+void rs2_config_limit_usb_bandwidth(rs2_config* config, float utilization, rs2_error ** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(config);
+    VALIDATE_RANGE(utilization, 0.f, 1.f);
+    config->config->limit_usb_bandwidth(utilization);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, config, utilization)
+
 rs2_pipeline_profile* rs2_config_resolve(rs2_config* config, rs2_pipeline* pipe, rs2_error ** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(config);
@@ -1694,6 +2594,14 @@ rs2_processing_block* rs2_create_sync_processing_block(rs2_error** error) BEGIN_
 }
 NOARGS_HANDLE_EXCEPTIONS_AND_RETURN(nullptr)
 
+rs2_processing_block* rs2_create_multi_device_sync_processing_block(rs2_error** error) BEGIN_API_CALL
+{
+    auto block = std::make_shared<librealsense::multi_device_syncer>();
+
+    return new rs2_processing_block{ block };
+}
+NOARGS_HANDLE_EXCEPTIONS_AND_RETURN(nullptr)
+
 void rs2_start_processing(rs2_processing_block* block, rs2_frame_callback* on_frame, rs2_error** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(block);
@@ -1730,6 +2638,88 @@ void rs2_process_frame(rs2_processing_block* block, rs2_frame* frame, rs2_error*
 }
 HANDLE_EXCEPTIONS_AND_RETURN(, block, frame)
 
+rs2_frame* rs2_process_frame_direct(rs2_processing_block* block, rs2_frame* frame, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(block);
+    VALIDATE_NOT_NULL(frame);
+
+    auto res = block->block->process(frame_holder((frame_interface*)frame));
+    frame_interface* ptr = nullptr;
+    std::swap(res.frame, ptr);
+    return (rs2_frame*)ptr;
+}
+HANDLE_EXCEPTIONS_AND_RETURN(nullptr, block, frame)
+
+rs2_processing_graph* rs2_create_processing_graph(int queue_size, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_RANGE(queue_size, 1, std::numeric_limits<int>::max());
+    return new rs2_processing_graph{ std::make_shared<librealsense::processing_graph>(queue_size) };
+}
+HANDLE_EXCEPTIONS_AND_RETURN(nullptr, queue_size)
+
+int rs2_processing_graph_add_block(rs2_processing_graph* graph, rs2_processing_block* block, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(graph);
+    VALIDATE_NOT_NULL(block);
+    return graph->graph->add_block(block->block);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(-1, graph, block)
+
+void rs2_processing_graph_connect(rs2_processing_graph* graph, int from, int to, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(graph);
+    graph->graph->connect(from, to);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, graph, from, to)
+
+void rs2_processing_graph_start(rs2_processing_graph* graph, rs2_frame_callback* on_frame, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(graph);
+    VALIDATE_NOT_NULL(on_frame);
+    graph->graph->start({ on_frame, [](rs2_frame_callback* p) { p->release(); } });
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, graph, on_frame)
+
+void rs2_processing_graph_start_queue(rs2_processing_graph* graph, rs2_frame_queue* queue, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(graph);
+    VALIDATE_NOT_NULL(queue);
+    librealsense::frame_callback_ptr callback(
+        new librealsense::frame_callback(rs2_enqueue_frame, queue));
+    graph->graph->start(move(callback));
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, graph, queue)
+
+void rs2_processing_graph_invoke(rs2_processing_graph* graph, rs2_frame* frame, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(graph);
+    VALIDATE_NOT_NULL(frame);
+    graph->graph->invoke(frame_holder((frame_interface*)frame));
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, graph, frame)
+
+void rs2_processing_graph_stop(rs2_processing_graph* graph, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(graph);
+    graph->graph->stop();
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, graph)
+
+void rs2_processing_graph_get_stats(const rs2_processing_graph* graph, int node, rs2_processing_stage_stats* stats, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(graph);
+    VALIDATE_NOT_NULL(stats);
+    *stats = graph->graph->get_stats(node);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, graph, node, stats)
+
+void rs2_delete_processing_graph(rs2_processing_graph* graph) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(graph);
+    delete graph;
+}
+NOEXCEPT_RETURN(, graph)
+
 void rs2_delete_processing_block(rs2_processing_block* block) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(block);
@@ -1742,7 +2732,7 @@ rs2_frame* rs2_extract_frame(rs2_frame* composite, int index, rs2_error** error)
 {
     VALIDATE_NOT_NULL(composite);
 
-    auto cf = VALIDATE_INTERFACE((frame_interface*)composite, librealsense::composite_frame);
+    auto cf = VALIDATE_FRAME((frame_interface*)composite, librealsense::composite_frame);
 
     VALIDATE_RANGE(index, 0, (int)cf->get_embedded_frames_count() - 1);
     auto res = cf->get_frame(index);
@@ -1751,18 +2741,29 @@ rs2_frame* rs2_extract_frame(rs2_frame* composite, int index, rs2_error** error)
 }
 HANDLE_EXCEPTIONS_AND_RETURN(nullptr, composite)
 
+rs2_frame* rs2_get_embedded_frame(const rs2_frame* composite, int index, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(composite);
+
+    auto cf = VALIDATE_FRAME((frame_interface*)composite, librealsense::composite_frame);
+
+    VALIDATE_RANGE(index, 0, (int)cf->get_embedded_frames_count() - 1);
+    return (rs2_frame*)cf->get_frame(index);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(nullptr, composite, index)
+
 rs2_frame* rs2_allocate_composite_frame(rs2_source* source, rs2_frame** frames, int count, rs2_error** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(source)
         VALIDATE_NOT_NULL(frames)
         VALIDATE_RANGE(count, 1, 128);
 
-    std::vector<frame_holder> holders(count);
+    composite_frame_builder holders;
     for (int i = 0; i < count; i++)
     {
-        holders[i] = std::move(frame_holder((frame_interface*)frames[i]));
+        holders.push_back(frame_holder((frame_interface*)frames[i]));
     }
-    auto res = source->source->allocate_composite_frame(std::move(holders));
+    auto res = source->source->allocate_composite_frame(holders);
 
     return (rs2_frame*)res;
 }
@@ -1772,7 +2773,7 @@ int rs2_embedded_frames_count(rs2_frame* composite, rs2_error** error) BEGIN_API
 {
     VALIDATE_NOT_NULL(composite)
 
-    auto cf = VALIDATE_INTERFACE((frame_interface*)composite, librealsense::composite_frame);
+    auto cf = VALIDATE_FRAME((frame_interface*)composite, librealsense::composite_frame);
 
     return static_cast<int>(cf->get_embedded_frames_count());
 }
@@ -1781,7 +2782,7 @@ HANDLE_EXCEPTIONS_AND_RETURN(0, composite)
 rs2_vertex* rs2_get_frame_vertices(const rs2_frame* frame, rs2_error** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(frame);
-    auto points = VALIDATE_INTERFACE((frame_interface*)frame, librealsense::points);
+    auto points = VALIDATE_FRAME((frame_interface*)frame, librealsense::points);
     return (rs2_vertex*)points->get_vertices();
 }
 HANDLE_EXCEPTIONS_AND_RETURN(nullptr, frame)
@@ -1790,15 +2791,24 @@ void rs2_export_to_ply(const rs2_frame* frame, const char* fname, rs2_frame* tex
 {
     VALIDATE_NOT_NULL(frame);
     VALIDATE_NOT_NULL(fname);
-    auto points = VALIDATE_INTERFACE((frame_interface*)frame, librealsense::points);
+    auto points = VALIDATE_FRAME((frame_interface*)frame, librealsense::points);
     points->export_to_ply(fname, (frame_interface*)texture);
 }
 HANDLE_EXCEPTIONS_AND_RETURN(, frame, fname)
 
+void rs2_export_to_ply_ex(const rs2_frame* frame, const char* fname, rs2_frame* texture, int with_faces, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(frame);
+    VALIDATE_NOT_NULL(fname);
+    auto points = VALIDATE_FRAME((frame_interface*)frame, librealsense::points);
+    points->export_to_ply(fname, (frame_interface*)texture, with_faces != 0);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, frame, fname, texture, with_faces)
+
 rs2_pixel* rs2_get_frame_texture_coordinates(const rs2_frame* frame, rs2_error** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(frame);
-    auto points = VALIDATE_INTERFACE((frame_interface*)frame, librealsense::points);
+    auto points = VALIDATE_FRAME((frame_interface*)frame, librealsense::points);
     return (rs2_pixel*)points->get_texture_coordinates();
 }
 HANDLE_EXCEPTIONS_AND_RETURN(nullptr, frame)
@@ -1806,11 +2816,27 @@ HANDLE_EXCEPTIONS_AND_RETURN(nullptr, frame)
 int rs2_get_frame_points_count(const rs2_frame* frame, rs2_error** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(frame);
-    auto points = VALIDATE_INTERFACE((frame_interface*)frame, librealsense::points);
+    auto points = VALIDATE_FRAME((frame_interface*)frame, librealsense::points);
     return static_cast<int>(points->get_vertex_count());
 }
 HANDLE_EXCEPTIONS_AND_RETURN(0, frame)
 
+const int* rs2_get_frame_pixel_indices(const rs2_frame* frame, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(frame);
+    auto points = VALIDATE_FRAME((frame_interface*)frame, librealsense::points);
+    return points->get_pixel_indices();
+}
+HANDLE_EXCEPTIONS_AND_RETURN(nullptr, frame)
+
+const unsigned char* rs2_get_frame_vertex_colors(const rs2_frame* frame, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(frame);
+    auto points = VALIDATE_FRAME((frame_interface*)frame, librealsense::points);
+    return points->get_vertex_colors();
+}
+HANDLE_EXCEPTIONS_AND_RETURN(nullptr, frame)
+
 rs2_processing_block* rs2_create_pointcloud(rs2_error** error) BEGIN_API_CALL
 {
     auto block = std::make_shared<librealsense::pointcloud>();
@@ -1819,6 +2845,17 @@ rs2_processing_block* rs2_create_pointcloud(rs2_error** error) BEGIN_API_CALL
 }
 NOARGS_HANDLE_EXCEPTIONS_AND_RETURN(nullptr)
 
+void rs2_pointcloud_refresh_tiles(rs2_processing_block* block, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(block);
+
+    auto pc = dynamic_cast<librealsense::pointcloud*>(block->block.get());
+    if (!pc)
+        throw librealsense::invalid_value_exception("The processing block is not a pointcloud");
+    pc->refresh_tiles();
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, block)
+
 rs2_processing_block* rs2_create_align(rs2_stream align_to, rs2_error** error) BEGIN_API_CALL
 {
     VALIDATE_ENUM(align_to);
@@ -1829,6 +2866,57 @@ rs2_processing_block* rs2_create_align(rs2_stream align_to, rs2_error** error) B
 }
 HANDLE_EXCEPTIONS_AND_RETURN(nullptr, align_to)
 
+rs2_processing_block* rs2_create_multi_align(const rs2_stream* align_to, int count, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(align_to);
+    VALIDATE_RANGE(count, 1, RS2_STREAM_COUNT);
+
+    std::vector<rs2_stream> streams(align_to, align_to + count);
+    for (auto stream : streams)
+        VALIDATE_ENUM(stream);
+
+    auto block = std::make_shared<librealsense::multi_align>(streams);
+
+    return new rs2_processing_block{ block };
+}
+HANDLE_EXCEPTIONS_AND_RETURN(nullptr, align_to, count)
+
+rs2_processing_block* rs2_create_pointcloud_gl(rs2_error** error) BEGIN_API_CALL
+{
+#ifdef RS2_USE_GLSL
+    auto block = std::make_shared<librealsense::pointcloud_gl>();
+
+    return new rs2_processing_block { block };
+#else
+    throw not_implemented_exception("librealsense was built without the GL processing blocks, see BUILD_WITH_GLSL");
+#endif
+}
+NOARGS_HANDLE_EXCEPTIONS_AND_RETURN(nullptr)
+
+rs2_processing_block* rs2_create_align_gl(rs2_stream align_to, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_ENUM(align_to);
+
+#ifdef RS2_USE_GLSL
+    auto block = std::make_shared<librealsense::align_gl>(align_to);
+
+    return new rs2_processing_block { block };
+#else
+    throw not_implemented_exception("librealsense was built without the GL processing blocks, see BUILD_WITH_GLSL");
+#endif
+}
+HANDLE_EXCEPTIONS_AND_RETURN(nullptr, align_to)
+
+int rs2_gl_is_available(rs2_error** error) BEGIN_API_CALL
+{
+#ifdef RS2_USE_GLSL
+    return librealsense::gl::gl_context::is_available() ? 1 : 0;
+#else
+    return 0;
+#endif
+}
+NOARGS_HANDLE_EXCEPTIONS_AND_RETURN(0)
+
 rs2_processing_block* rs2_create_colorizer(rs2_error** error) BEGIN_API_CALL
 {
     auto block = std::make_shared<librealsense::colorizer>();
@@ -1844,7 +2932,7 @@ NOARGS_HANDLE_EXCEPTIONS_AND_RETURN(nullptr)
 
 rs2_processing_block* rs2_create_decimation_filter_block(rs2_error** error) BEGIN_API_CALL
 {
-    auto block = std::make_shared<librealsense::decimation_filter>();
+    auto block = create_decimation_filter();
 
     return new rs2_processing_block{ block };
 }
@@ -1852,7 +2940,7 @@ NOARGS_HANDLE_EXCEPTIONS_AND_RETURN(nullptr)
 
 rs2_processing_block* rs2_create_temporal_filter_block(rs2_error** error) BEGIN_API_CALL
 {
-    auto block = std::make_shared<librealsense::temporal_filter>();
+    auto block = create_temporal_filter();
 
     return new rs2_processing_block{ block };
 }
@@ -1860,7 +2948,7 @@ NOARGS_HANDLE_EXCEPTIONS_AND_RETURN(nullptr)
 
 rs2_processing_block* rs2_create_spatial_filter_block(rs2_error** error) BEGIN_API_CALL
 {
-    auto block = std::make_shared<librealsense::spatial_filter>();
+    auto block = create_spatial_filter();
 
     return new rs2_processing_block{ block };
 }
@@ -1876,7 +2964,7 @@ HANDLE_EXCEPTIONS_AND_RETURN(nullptr, transform_to_disparity)
 
 rs2_processing_block* rs2_create_hole_filling_filter_block(rs2_error** error) BEGIN_API_CALL
 {
-    auto block = std::make_shared<librealsense::hole_filling_filter>();
+    auto block = create_hole_filling_filter();
 
     return new rs2_processing_block{ block };
 }
@@ -1890,6 +2978,224 @@ rs2_processing_block* rs2_create_rates_printer_block(rs2_error** error) BEGIN_AP
 }
 NOARGS_HANDLE_EXCEPTIONS_AND_RETURN(nullptr)
 
+rs2_processing_block* rs2_create_rate_limiter_block(rs2_error** error) BEGIN_API_CALL
+{
+    auto block = std::make_shared<librealsense::rate_limiter>();
+
+    return new rs2_processing_block{ block };
+}
+NOARGS_HANDLE_EXCEPTIONS_AND_RETURN(nullptr)
+
+rs2_processing_block* rs2_create_depth_compression_block(rs2_error** error) BEGIN_API_CALL
+{
+    auto block = std::make_shared<librealsense::depth_compression>();
+
+    return new rs2_processing_block{ block };
+}
+NOARGS_HANDLE_EXCEPTIONS_AND_RETURN(nullptr)
+
+rs2_processing_block* rs2_create_depth_decompression_block(rs2_error** error) BEGIN_API_CALL
+{
+    auto block = std::make_shared<librealsense::depth_decompression>();
+
+    return new rs2_processing_block{ block };
+}
+NOARGS_HANDLE_EXCEPTIONS_AND_RETURN(nullptr)
+
+// Null stays null, a block of another kind is rejected
+template<class T>
+std::shared_ptr<T> depth_refine_stage(rs2_processing_block* stage, const char* name)
+{
+    if (!stage)
+        return nullptr;
+    auto block = std::dynamic_pointer_cast<T>(stage->block);
+    if (!block)
+        throw librealsense::invalid_value_exception(librealsense::to_string() << "The " << name << " stage of the depth refinement is a different kind of block");
+    return block;
+}
+
+rs2_processing_block* rs2_create_depth_refine_block(rs2_processing_block* decimation, rs2_processing_block* to_disparity,
+    rs2_processing_block* spatial, rs2_processing_block* temporal, rs2_processing_block* to_depth, rs2_error** error) BEGIN_API_CALL
+{
+    auto block = std::make_shared<librealsense::depth_refine>(
+        depth_refine_stage<librealsense::decimation_filter>(decimation, "decimation"),
+        depth_refine_stage<librealsense::disparity_transform>(to_disparity, "depth to disparity"),
+        depth_refine_stage<librealsense::spatial_filter>(spatial, "spatial"),
+        depth_refine_stage<librealsense::temporal_filter>(temporal, "temporal"),
+        depth_refine_stage<librealsense::disparity_transform>(to_depth, "disparity to depth"));
+
+    return new rs2_processing_block{ block };
+}
+HANDLE_EXCEPTIONS_AND_RETURN(nullptr, decimation, to_disparity, spatial, temporal, to_depth)
+
+rs2_processing_block* rs2_create_yuy2_decoder(rs2_format target_format, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_ENUM(target_format);
+    auto block = std::make_shared<librealsense::yuy2_decoder>(target_format);
+
+    return new rs2_processing_block{ block };
+}
+HANDLE_EXCEPTIONS_AND_RETURN(nullptr, target_format)
+
+rs2_processing_block* rs2_create_mjpeg_decoder(rs2_format target_format, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_ENUM(target_format);
+
+#ifdef RS2_USE_LIBJPEG
+    auto block = std::make_shared<librealsense::mjpeg_decoder>(target_format);
+
+    return new rs2_processing_block{ block };
+#else
+    throw not_implemented_exception("librealsense was built without the MJPEG decoder, see BUILD_WITH_LIBJPEG");
+#endif
+}
+HANDLE_EXCEPTIONS_AND_RETURN(nullptr, target_format)
+
+rs2_processing_block* rs2_create_imu_fusion_block(float rate, rs2_error** error) BEGIN_API_CALL
+{
+    auto block = std::make_shared<librealsense::imu_fusion>(rate);
+
+    return new rs2_processing_block{ block };
+}
+HANDLE_EXCEPTIONS_AND_RETURN(nullptr, rate)
+
+rs2_processing_block* rs2_create_threshold_crop_block(rs2_error** error) BEGIN_API_CALL
+{
+    auto block = std::make_shared<librealsense::threshold_crop>();
+
+    return new rs2_processing_block{ block };
+}
+NOARGS_HANDLE_EXCEPTIONS_AND_RETURN(nullptr)
+
+rs2_processing_block* rs2_create_voxel_grid_filter_block(rs2_error** error) BEGIN_API_CALL
+{
+    auto block = std::make_shared<librealsense::voxel_grid_filter>();
+
+    return new rs2_processing_block{ block };
+}
+NOARGS_HANDLE_EXCEPTIONS_AND_RETURN(nullptr)
+
+rs2_processing_block* rs2_create_normal_estimation_block(rs2_error** error) BEGIN_API_CALL
+{
+    auto block = std::make_shared<librealsense::normal_estimation>();
+
+    return new rs2_processing_block{ block };
+}
+NOARGS_HANDLE_EXCEPTIONS_AND_RETURN(nullptr)
+
+rs2_processing_block* rs2_create_tsdf_integrator_block(rs2_error** error) BEGIN_API_CALL
+{
+    auto block = std::make_shared<librealsense::tsdf_integrator>();
+
+    return new rs2_processing_block{ block };
+}
+NOARGS_HANDLE_EXCEPTIONS_AND_RETURN(nullptr)
+
+void rs2_tsdf_integrator_set_pose(rs2_processing_block* block, const rs2_pose* world_from_depth, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(block);
+    VALIDATE_NOT_NULL(world_from_depth);
+
+    auto integrator = dynamic_cast<librealsense::tsdf_integrator*>(block->block.get());
+    if (!integrator)
+        throw librealsense::invalid_value_exception("The processing block is not a TSDF integrator");
+    integrator->set_pose(*world_from_depth);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, block, world_from_depth)
+
+void rs2_tsdf_integrator_reset(rs2_processing_block* block, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(block);
+
+    auto integrator = dynamic_cast<librealsense::tsdf_integrator*>(block->block.get());
+    if (!integrator)
+        throw librealsense::invalid_value_exception("The processing block is not a TSDF integrator");
+    integrator->reset();
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, block)
+
+rs2_processing_block* rs2_create_mesh_generator_block(rs2_error** error) BEGIN_API_CALL
+{
+    auto block = std::make_shared<librealsense::mesh_generator>();
+
+    return new rs2_processing_block{ block };
+}
+NOARGS_HANDLE_EXCEPTIONS_AND_RETURN(nullptr)
+
+rs2_processing_block* rs2_create_depth_statistics_block(rs2_error** error) BEGIN_API_CALL
+{
+    auto block = std::make_shared<librealsense::depth_statistics>();
+
+    return new rs2_processing_block{ block };
+}
+NOARGS_HANDLE_EXCEPTIONS_AND_RETURN(nullptr)
+
+void rs2_depth_statistics_add_roi(rs2_processing_block* block, int min_x, int min_y, int max_x, int max_y, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(block);
+
+    auto statistics = dynamic_cast<librealsense::depth_statistics*>(block->block.get());
+    if (!statistics)
+        throw librealsense::invalid_value_exception("The processing block is not a depth statistics block");
+    statistics->add_roi({ min_x, min_y, max_x, max_y });
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, block, min_x, min_y, max_x, max_y)
+
+void rs2_depth_statistics_clear_rois(rs2_processing_block* block, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(block);
+
+    auto statistics = dynamic_cast<librealsense::depth_statistics*>(block->block.get());
+    if (!statistics)
+        throw librealsense::invalid_value_exception("The processing block is not a depth statistics block");
+    statistics->clear_rois();
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, block)
+
+rs2_processing_block* rs2_create_height_map_block(rs2_error** error) BEGIN_API_CALL
+{
+    auto block = std::make_shared<librealsense::height_map>();
+
+    return new rs2_processing_block{ block };
+}
+NOARGS_HANDLE_EXCEPTIONS_AND_RETURN(nullptr)
+
+void rs2_height_map_set_ground(rs2_processing_block* block, const rs2_extrinsics* depth_to_ground, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(block);
+    VALIDATE_NOT_NULL(depth_to_ground);
+
+    auto map = dynamic_cast<librealsense::height_map*>(block->block.get());
+    if (!map)
+        throw librealsense::invalid_value_exception("The processing block is not a height map block");
+    map->set_ground(*depth_to_ground);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, block, depth_to_ground)
+
+void rs2_project_color_pixels_to_depth_pixels(float* to_pixels,
+    const uint16_t* data, float depth_scale,
+    float depth_min, float depth_max,
+    const rs2_intrinsics* depth_intrin,
+    const rs2_intrinsics* color_intrin,
+    const rs2_extrinsics* color_to_depth,
+    const rs2_extrinsics* depth_to_color,
+    const float* from_pixels, int count, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(to_pixels);
+    VALIDATE_NOT_NULL(data);
+    VALIDATE_NOT_NULL(depth_intrin);
+    VALIDATE_NOT_NULL(color_intrin);
+    VALIDATE_NOT_NULL(color_to_depth);
+    VALIDATE_NOT_NULL(depth_to_color);
+    VALIDATE_NOT_NULL(from_pixels);
+    VALIDATE_RANGE(count, 0, std::numeric_limits<int>::max());
+
+    librealsense::color_to_depth_search search{ data, depth_scale, depth_min, depth_max,
+        *depth_intrin, *color_intrin, *color_to_depth, *depth_to_color };
+    librealsense::project_color_pixels_to_depth_pixels(search, from_pixels, to_pixels, size_t(count));
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, to_pixels, data, depth_scale, depth_min, depth_max, depth_intrin, color_intrin, color_to_depth, depth_to_color, from_pixels, count)
+
 float rs2_get_depth_scale(rs2_sensor* sensor, rs2_error** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(sensor);
@@ -1898,6 +3204,16 @@ float rs2_get_depth_scale(rs2_sensor* sensor, rs2_error** error) BEGIN_API_CALL
 }
 HANDLE_EXCEPTIONS_AND_RETURN(0.f, sensor)
 
+int rs2_get_latest_pose(const rs2_sensor* sensor, rs2_pose* pose, rs2_time_t* timestamp, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(sensor);
+    VALIDATE_NOT_NULL(pose);
+    VALIDATE_NOT_NULL(timestamp);
+    auto ps = VALIDATE_INTERFACE(sensor->sensor, librealsense::pose_sensor_interface);
+    return ps->get_latest_pose(*pose, *timestamp) ? 1 : 0;
+}
+HANDLE_EXCEPTIONS_AND_RETURN(0, sensor, pose, timestamp)
+
 float rs2_get_stereo_baseline(rs2_sensor* sensor, rs2_error** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(sensor);
@@ -1916,7 +3232,7 @@ HANDLE_EXCEPTIONS_AND_RETURN(nullptr, sensor)
 float rs2_depth_frame_get_distance(const rs2_frame* frame_ref, int x, int y, rs2_error** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(frame_ref);
-    auto df = VALIDATE_INTERFACE(((frame_interface*)frame_ref), librealsense::depth_frame);
+    auto df = VALIDATE_FRAME(((frame_interface*)frame_ref), librealsense::depth_frame);
     return df->get_distance(x, y);
 }
 HANDLE_EXCEPTIONS_AND_RETURN(0, frame_ref, x, y)
@@ -1924,7 +3240,7 @@ HANDLE_EXCEPTIONS_AND_RETURN(0, frame_ref, x, y)
 float rs2_depth_stereo_frame_get_baseline(const rs2_frame* frame_ref, rs2_error** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(frame_ref);
-    auto df = VALIDATE_INTERFACE(((frame_interface*)frame_ref), librealsense::disparity_frame);
+    auto df = VALIDATE_FRAME(((frame_interface*)frame_ref), librealsense::disparity_frame);
     return df->get_stereo_baseline();
 }
 HANDLE_EXCEPTIONS_AND_RETURN(0, frame_ref)
@@ -1934,7 +3250,7 @@ void rs2_pose_frame_get_pose_data(const rs2_frame* frame, rs2_pose* pose, rs2_er
     VALIDATE_NOT_NULL(frame);
     VALIDATE_NOT_NULL(pose);
 
-    auto pf = VALIDATE_INTERFACE((frame_interface*)frame, librealsense::pose_frame);
+    auto pf = VALIDATE_FRAME((frame_interface*)frame, librealsense::pose_frame);
 
     const float3 t = pf->get_translation();
     pose->translation = { t.x, t.y, t.z };
@@ -2024,6 +3340,20 @@ void rs2_software_sensor_set_metadata(rs2_sensor* sensor, rs2_frame_metadata_val
 }
 HANDLE_EXCEPTIONS_AND_RETURN(, sensor, key, value)
 
+void rs2_software_sensor_set_metadata_values(rs2_sensor* sensor, const rs2_frame_metadata_value* keys, const rs2_metadata_type* values, int count, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(sensor);
+    VALIDATE_RANGE(count, 0, std::numeric_limits<int>::max());
+    if (count)
+    {
+        VALIDATE_NOT_NULL(keys);
+        VALIDATE_NOT_NULL(values);
+    }
+    auto bs = VALIDATE_INTERFACE(sensor->sensor, librealsense::software_sensor);
+    return bs->set_metadata(keys, values, count);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, sensor, keys, values, count)
+
 rs2_stream_profile* rs2_software_sensor_add_video_stream(rs2_sensor* sensor, rs2_video_stream video_stream, rs2_error** error) BEGIN_API_CALL
 {
     auto bs = VALIDATE_INTERFACE(sensor->sensor, librealsense::software_sensor);
@@ -2059,6 +3389,69 @@ void rs2_software_sensor_update_read_only_option(rs2_sensor* sensor, rs2_option
 }
 HANDLE_EXCEPTIONS_AND_RETURN(, sensor, option, val)
 
+rs2_frame_serializer* rs2_create_frame_serializer(rs2_error** error) BEGIN_API_CALL
+{
+    return new rs2_frame_serializer();
+}
+NOARGS_HANDLE_EXCEPTIONS_AND_RETURN(nullptr)
+
+int rs2_serialize_frame(rs2_frame_serializer* serializer, rs2_frame* frame, const rs2_frame_segment** segments, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(serializer);
+    VALIDATE_NOT_NULL(frame);
+    VALIDATE_NOT_NULL(segments);
+    auto&& result = serializer->serializer.serialize((frame_interface*)frame);
+    *segments = result.data();
+    return static_cast<int>(result.size());
+}
+HANDLE_EXCEPTIONS_AND_RETURN(0, serializer, frame, segments)
+
+void rs2_delete_frame_serializer(rs2_frame_serializer* serializer) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(serializer);
+    delete serializer;
+}
+NOEXCEPT_RETURN(, serializer)
+
+rs2_frame_deserializer* rs2_create_frame_deserializer(rs2_device* dev, rs2_frame_callback_ptr on_frame, void* user, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(dev);
+    VALIDATE_NOT_NULL(on_frame);
+    auto sd = std::dynamic_pointer_cast<software_device>(dev->device);
+    if (!sd)
+        throw std::runtime_error("Frames can only be deserialized on a software device");
+    librealsense::frame_callback_ptr callback(new librealsense::frame_callback(on_frame, user));
+    return new rs2_frame_deserializer{ std::unique_ptr<frame_deserializer>(new frame_deserializer(sd, std::move(callback))) };
+}
+HANDLE_EXCEPTIONS_AND_RETURN(nullptr, dev, on_frame, user)
+
+rs2_frame_deserializer* rs2_create_frame_deserializer_cpp(rs2_device* dev, rs2_frame_callback* callback, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(dev);
+    VALIDATE_NOT_NULL(callback);
+    librealsense::frame_callback_ptr callback_ptr(callback, [](rs2_frame_callback* p) { p->release(); });
+    auto sd = std::dynamic_pointer_cast<software_device>(dev->device);
+    if (!sd)
+        throw std::runtime_error("Frames can only be deserialized on a software device");
+    return new rs2_frame_deserializer{ std::unique_ptr<frame_deserializer>(new frame_deserializer(sd, std::move(callback_ptr))) };
+}
+HANDLE_EXCEPTIONS_AND_RETURN(nullptr, dev, callback)
+
+void rs2_deserialize_frame(rs2_frame_deserializer* deserializer, const void* message, unsigned long long size, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(deserializer);
+    VALIDATE_NOT_NULL(message);
+    deserializer->deserializer->deserialize(message, static_cast<size_t>(size));
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, deserializer, message, size)
+
+void rs2_delete_frame_deserializer(rs2_frame_deserializer* deserializer) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(deserializer);
+    delete deserializer;
+}
+NOEXCEPT_RETURN(, deserializer)
+
 void rs2_log(rs2_log_severity severity, const char * message, rs2_error ** error) BEGIN_API_CALL
 {
     VALIDATE_ENUM(severity);
@@ -2088,6 +3481,51 @@ void rs2_log(rs2_log_severity severity, const char * message, rs2_error ** error
 }
 HANDLE_EXCEPTIONS_AND_RETURN(, severity, message)
 
+void rs2_dump_log_history(const char* file_path, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(file_path);
+    librealsense::dump_log_history(file_path);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, file_path)
+
+void rs2_get_pipeline_stats(rs2_stream stream, rs2_pipeline_stage stage, rs2_pipeline_stage_stats* stats, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_ENUM(stream);
+    VALIDATE_ENUM(stage);
+    VALIDATE_NOT_NULL(stats);
+    *stats = librealsense::pipeline_tracer::get().get_stats(stream, stage);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, stream, stage, stats)
+
+void rs2_reset_pipeline_stats(rs2_error** error) BEGIN_API_CALL
+{
+    librealsense::pipeline_tracer::get().reset();
+}
+NOARGS_HANDLE_EXCEPTIONS_AND_RETURN()
+
+void rs2_export_pipeline_trace(const char* file_path, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(file_path);
+    librealsense::pipeline_tracer::get().export_trace(file_path);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, file_path)
+
+int rs2_get_capture_reactor_stats(rs2_capture_reactor_stats* stats, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(stats);
+    *stats = {};
+#ifdef RS2_USE_V4L2_BACKEND
+    if (auto reactor = librealsense::platform::v4l_reactor::instance())
+    {
+        auto s = reactor->get_statistics();
+        *stats = { s.wakeups, s.dispatches, s.total_dispatch_ms, s.max_dispatch_ms };
+        return 1;
+    }
+#endif
+    return 0;
+}
+HANDLE_EXCEPTIONS_AND_RETURN(0, stats)
+
 void rs2_loopback_enable(const rs2_device* device, const char* from_file, rs2_error** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(device);
@@ -11,9 +11,18 @@
 #include "device.h"
 #include "stream.h"
 #include "sensor.h"
+#include "tracing.h"
+#include "device-cache.h"
+#include "frame-control-queue.h"
+#include "usb-bandwidth.h"
+#include "stream-statistics.h"
+#include "profiling.h"
 
 namespace librealsense
 {
+    static const int min_kernel_buffers = 2;
+    static const int max_kernel_buffers = 32;
+
     sensor_base::sensor_base(std::string name, device* dev)
         : _is_streaming(false),
           _is_opened(false),
@@ -29,10 +38,57 @@ namespace librealsense
           })
     {
         register_option(RS2_OPTION_FRAMES_QUEUE_SIZE, _source.get_published_size_option());
+        register_option(RS2_OPTION_FRAME_POOL_HITS, _source.get_pool_hits_option());
+        register_option(RS2_OPTION_FRAME_POOL_MISSES, _source.get_pool_misses_option());
+        register_option(RS2_OPTION_FRAMES_DROPPED, _source.get_dropped_frames_option());
+        register_option(RS2_OPTION_FRAMES_QUEUE_MEMORY_LIMIT, _source.get_overflow_limit_option());
+        register_option(RS2_OPTION_CALLBACK_QUEUE_SIZE, _source.get_callback_queue_size_option());
 
         register_metadata(RS2_FRAME_METADATA_TIME_OF_ARRIVAL, std::make_shared<librealsense::md_time_of_arrival_parser>());
 
         register_info(RS2_CAMERA_INFO_NAME, name);
+
+        // The frames of the sensor count towards its context
+        if (auto ctx = dev ? dev->get_context() : nullptr)
+            _source.set_memory_account(std::make_shared<memory_account>(ctx->get_memory_account()));
+    }
+
+    memory_account::usage sensor_base::get_memory_usage() const
+    {
+        return _source.get_memory_usage();
+    }
+
+    uint64_t sensor_base::get_bandwidth(const stream_profiles& profiles) const
+    {
+        std::set<std::tuple<uint32_t, uint32_t, uint32_t, uint32_t>> carried;
+        uint64_t total = 0;
+        for (auto&& p : profiles)
+        {
+            auto vid = dynamic_cast<video_stream_profile_interface*>(p.get());
+            auto carry = [&](const platform::stream_profile& native)
+            {
+                native_pixel_format pf{};
+                if (!vid || native.fps != p->get_framerate() || !try_get_pf(native, pf))
+                    return false;
+                for (auto&& unpacker : pf.unpackers)
+                {
+                    for (auto&& output : unpacker.outputs)
+                    {
+                        auto res = output.stream_resolution({ native.width, native.height });
+                        if (output.stream_desc.type != p->get_stream_type() || output.stream_desc.index != p->get_stream_index() ||
+                            output.format != p->get_format() || res.width != vid->get_width() || res.height != vid->get_height())
+                            continue;
+                        if (carried.insert(std::make_tuple(native.width, native.height, native.fps, native.format)).second)
+                            total += static_cast<uint64_t>(pf.get_image_size(native.width, native.height)) * native.fps;
+                        return true;
+                    }
+                }
+                return false;
+            };
+            if (std::none_of(_uvc_profiles.begin(), _uvc_profiles.end(), carry))
+                total += estimate_bandwidth(*p);
+        }
+        return total;
     }
 
     const std::string& sensor_base::get_info(rs2_camera_info info) const
@@ -46,6 +102,36 @@ namespace librealsense
         return info_container::supports_info(info) || _owner->supports_info(info);
     }
 
+    void sensor_base::report_dropped_frame(const stream_profile_interface& profile)
+    {
+        stream_statistics::instance().dropped(profile.get_unique_id(), RS2_FRAME_DROP_REASON_MEMORY);
+
+        auto stream = profile.get_stream_type();
+        auto index = profile.get_stream_index();
+        auto now = std::chrono::steady_clock::now();
+        uint64_t unreported, total;
+        {
+            std::lock_guard<std::mutex> lock(_dropped_mutex);
+            auto& dropped = _dropped[std::make_pair(stream, index)];
+            ++dropped.total;
+            ++dropped.unreported;
+            if (dropped.total > 1 && now - dropped.reported_at < std::chrono::seconds(1))
+                return;
+
+            unreported = dropped.unreported;
+            total = dropped.total;
+            dropped.unreported = 0;
+            dropped.reported_at = now;
+        }
+
+        notification n(RS2_NOTIFICATION_CATEGORY_FRAMES_DROPPED, 0, RS2_LOG_SEVERITY_WARN,
+            to_string() << unreported << " " << get_string(stream) << " frames dropped, the application holds on to "
+                        << _source.get_published_size_option()->query() << " frames");
+        n.serialized_data = to_string() << "{\"stream\":\"" << get_string(stream) << "\",\"index\":" << index
+                                        << ",\"dropped\":" << unreported << ",\"total\":" << total << "}";
+        _notifications_processor->raise_notification(n);
+    }
+
     stream_profiles sensor_base::get_active_streams() const
     {
         return _active_profiles;
@@ -125,50 +211,95 @@ namespace librealsense
         target->set_unique_id(stream->get_unique_id());
     }
 
+    void sensor_base::index_unpackers()
+    {
+        _unpackers_by_output.clear();
+        for (auto&& pf : _pixel_formats)
+            for (auto&& unpacker : pf.unpackers)
+                for (auto&& o : unpacker.outputs)
+                {
+                    auto& candidates = _unpackers_by_output[unpacker_key(o.stream_desc.type, o.stream_desc.index, o.format)];
+                    if (std::find(candidates.begin(), candidates.end(), std::make_pair(&pf, &unpacker)) == candidates.end())
+                        candidates.emplace_back(&pf, &unpacker);
+                }
+    }
+
     std::vector<request_mapping> sensor_base::resolve_requests(stream_profiles requests)
     {
         // per requested profile, find all 4ccs that support that request.
+        std::map<std::tuple<uint32_t, uint32_t, uint32_t>, std::set<uint32_t>> fourccs_by_mode;
+        for (auto&& mode : get_stream_profiles())
+        {
+            if (auto backend_profile = dynamic_cast<backend_stream_profile*>(mode.get()))
+            {
+                auto m = to_profile(mode.get());
+                fourccs_by_mode[std::make_tuple(m.width, m.height, m.fps)].insert(backend_profile->get_backend_profile().format);
+            }
+        }
         std::map<int, std::set<uint32_t>> legal_fourccs;
-        auto profiles = get_stream_profiles();
         for (auto&& r : requests)
         {
             auto sp = to_profile(r.get());
-            for (auto&& mode : profiles)
-            {
-                if (auto backend_profile = dynamic_cast<backend_stream_profile*>(mode.get()))
-                {
-                    auto m = to_profile(mode.get());
+            auto it = fourccs_by_mode.find(std::make_tuple(sp.width, sp.height, sp.fps));
+            if (it != fourccs_by_mode.end())
+                legal_fourccs[sp.index].insert(it->second.begin(), it->second.end()); // TODO: Stread ID???
+        }
 
-                    if (m.fps == sp.fps && m.height == sp.height && m.width == sp.width)
-                        legal_fourccs[sp.index].insert(backend_profile->get_backend_profile().format); // TODO: Stread ID???
-                }
+        // The unpackers able to supply each request, only the ones indexed for its stream and format are tried
+        struct candidate
+        {
+            const pixel_format_unpacker* unpacker;
+            platform::stream_profile uvc_profile;
+        };
+        std::map<stream_profile_interface*, std::vector<candidate>> satisfied_by;
+        for (auto&& r : requests)
+        {
+            auto sp = to_profile(r.get());
+            auto& candidates = satisfied_by[r.get()];
+            auto it = _unpackers_by_output.find(unpacker_key(sp.stream, sp.index, sp.format));
+            if (it == _unpackers_by_output.end())
+                continue;
+            auto&& fourccs = legal_fourccs[sp.index];
+            for (auto&& c : it->second)
+            {
+                // only count if the 4cc can be unpacked into the relevant stream/format
+                // and also, the pixel format can be streamed in the requested dimensions/fps.
+                if (!fourccs.count(c.first->fourcc))
+                    continue;
+                auto uvc_profile = c.second->get_uvc_profile(sp, c.first->fourcc, _uvc_profiles);
+                if (c.second->provides_stream(sp, c.first->fourcc, uvc_profile))
+                    candidates.push_back({ c.second, uvc_profile });
             }
         }
+        auto find_candidate = [&satisfied_by](const std::shared_ptr<stream_profile_interface>& r, const pixel_format_unpacker* unpacker) -> const candidate*
+        {
+            for (auto&& c : satisfied_by[r.get()])
+                if (c.unpacker == unpacker)
+                    return &c;
+            return nullptr;
+        };
 
         //if you want more efficient data structure use std::unordered_set
         //with well-defined hash function
         std::set<request_mapping> results;
+        std::map<const pixel_format_unpacker*, int> counts;
         while (!requests.empty() && !_pixel_formats.empty())
         {
+            counts.clear();
+            for (auto&& r : requests)
+                for (auto&& c : satisfied_by[r.get()])
+                    ++counts[c.unpacker];
+
             auto max = 0;
             size_t best_size = 0;
             auto best_pf = &_pixel_formats.front();
             auto best_unpacker = &_pixel_formats.front().unpackers.front();
-            platform::stream_profile uvc_profile{};
             for (auto&& pf : _pixel_formats)
             {
-                // Speeds up algorithm by skipping obviously useless 4ccs
-                // if (std::none_of(begin(legal_fourccs), end(legal_fourccs), [&](const uint32_t fourcc) {return fourcc == pf.fourcc; })) continue;
-
                 for (auto&& unpacker : pf.unpackers)
                 {
-                    auto count = static_cast<int>(std::count_if(begin(requests), end(requests),
-                        [&pf, &legal_fourccs, &unpacker, this](const std::shared_ptr<stream_profile_interface>& r)
-                    {
-                        // only count if the 4cc can be unpacked into the relevant stream/format
-                        // and also, the pixel format can be streamed in the requested dimensions/fps.
-                        return unpacker.satisfies(to_profile(r.get()), pf.fourcc, _uvc_profiles) && legal_fourccs[r->get_stream_index()].count(pf.fourcc);
-                    }));
+                    auto it = counts.find(&unpacker);
+                    auto count = it == counts.end() ? 0 : it->second;
 
                     // Here we check if the current pixel format / unpacker combination is better than the current best.
                     // We judge on two criteria. A: how many of the requested streams can we supply? B: how many total streams do we open?
@@ -190,16 +321,16 @@ namespace librealsense
             if (max == 0) break;
 
             requests.erase(std::remove_if(begin(requests), end(requests),
-                [best_unpacker, best_pf, &results, &legal_fourccs, this](const std::shared_ptr<stream_profile_interface>& r)
+                [best_unpacker, best_pf, &results, &find_candidate, this](const std::shared_ptr<stream_profile_interface>& r)
             {
-                if (best_unpacker->satisfies(to_profile(r.get()), best_pf->fourcc, _uvc_profiles) && legal_fourccs[r->get_stream_index()].count(best_pf->fourcc))
+                if (auto c = find_candidate(r, best_unpacker))
                 {
                     auto request = dynamic_cast<const video_stream_profile*>(r.get());
 
                     request_mapping mapping;
                     mapping.unpacker = best_unpacker;
                     mapping.pf = best_pf;
-                    auto uvc_profile = best_unpacker->get_uvc_profile(to_profile(r.get()), best_pf->fourcc, _uvc_profiles);
+                    auto uvc_profile = c->uvc_profile;
                     if (!request) {
                         mapping.profile = { 0, 0, r->get_framerate(), best_pf->fourcc };
                     }
@@ -227,6 +358,7 @@ namespace librealsense
         throw invalid_value_exception("Subdevice unable to satisfy stream requests!");
     }
 
+
     std::shared_ptr<stream_profile_interface> sensor_base::map_requests(std::shared_ptr<stream_profile_interface> request)
     {
         stream_profiles results;
@@ -244,6 +376,7 @@ namespace librealsense
 
     uvc_sensor::~uvc_sensor()
     {
+        stop_async_writes();
         try
         {
             if (_is_streaming)
@@ -281,9 +414,16 @@ namespace librealsense
         std::set<uint32_t> supported_formats;
         std::set<uint32_t> registered_formats;
 
-        power on(std::dynamic_pointer_cast<uvc_sensor>(shared_from_this()));
-        if (_uvc_profiles.empty()){}
-            _uvc_profiles = _device->get_profiles();
+        if (_uvc_profiles.empty())
+        {
+            auto fetch = [this]()
+            {
+                power on(std::dynamic_pointer_cast<uvc_sensor>(shared_from_this()));
+                return _device->get_profiles();
+            };
+            // The sensor is only powered up to list its profiles when the device cache doesn't have them
+            _uvc_profiles = _cache ? _cache->get_profiles(get_info(RS2_CAMERA_INFO_NAME), fetch) : fetch();
+        }
 
         for (auto&& p : _uvc_profiles)
         {
@@ -372,11 +512,32 @@ namespace librealsense
         return *_owner;
     }
 
+    void sensor_base::stop_async_writes()
+    {
+        if (auto controls = std::atomic_load(&_frame_controls))
+            controls->stop();
+        options_container::stop_async_writes();
+    }
+
+    frame_control_queue& sensor_base::get_frame_controls()
+    {
+        auto controls = std::atomic_load(&_frame_controls);
+        if (!controls)
+        {
+            auto created = std::make_shared<frame_control_queue>(*this, dynamic_cast<roi_sensor_interface*>(this));
+            controls = std::atomic_compare_exchange_strong(&_frame_controls, &controls, created) ? created : controls;
+        }
+        return *controls;
+    }
+
     void sensor_base::register_pixel_format(native_pixel_format pf)
     {
         if (_pixel_formats.end() == std::find_if(_pixel_formats.begin(), _pixel_formats.end(),
             [&pf](const native_pixel_format& cur) { return cur.fourcc == pf.fourcc; }))
+        {
             _pixel_formats.push_back(pf);
+            index_unpackers();
+        }
         else
             throw invalid_value_exception(to_string()
                 << "Pixel format " << std::hex << std::setw(8) << std::setfill('0') << pf.fourcc
@@ -387,7 +548,10 @@ namespace librealsense
     {
         auto it = std::find_if(_pixel_formats.begin(), _pixel_formats.end(), [&pf](const native_pixel_format& cur) { return cur.fourcc == pf.fourcc; });
         if (it != _pixel_formats.end())
+        {
             _pixel_formats.erase(it);
+            index_unpackers();
+        }
     }
 
     void uvc_sensor::open(const stream_profiles& requests)
@@ -406,16 +570,32 @@ namespace librealsense
 
         auto timestamp_reader = _timestamp_reader.get();
 
+        // With a user allocator in place, natively-formatted frames are copied into user memory
+        // rather than referencing the backend buffer
+        auto copy_to_allocated = _source.has_allocator();
+        auto borrowed_frames = _borrowed_frames;
+        auto peak_borrowed = _peak_borrowed;
+        auto missed_frames = _missed_frames;
+
+        // At least one kernel buffer must always remain available to the backend
+        auto kernel_buffers = _kernel_buffers;
+        auto max_borrowed = kernel_buffers - 1;
+
         std::vector<platform::stream_profile> commited;
 
         for (auto&& mode : mapping)
         {
             try
             {
+                // The frames of a mode are unpacked one after the other, so they are delivered in the order they arrived
+                auto unpack_queue = std::make_shared<dispatcher>(max_borrowed);
+                _unpack_queues.push_back(unpack_queue);
+
                 unsigned long long last_frame_number = 0;
                 rs2_time_t last_timestamp = 0;
                 _device->probe_and_commit(mode.profile,
-                [this, mode, timestamp_reader, requests, last_frame_number, last_timestamp](platform::stream_profile p, platform::frame_object f, std::function<void()> continuation) mutable
+                [this, mode, timestamp_reader, requests, last_frame_number, last_timestamp, copy_to_allocated, borrowed_frames,
+                 peak_borrowed, missed_frames, max_borrowed, unpack_queue](platform::stream_profile p, platform::frame_object f, std::function<void()> continuation) mutable
                 {
                     auto system_time = environment::get_instance().get_time_service()->get_time();
                     if (!this->is_streaming())
@@ -427,18 +607,62 @@ namespace librealsense
                         return;
                     }
 
-                    frame_continuation release_and_enqueue(continuation, f.pixels);
-
                     // Ignore any frames which appear corrupted or invalid
                     // Determine the timestamp for this frame
                     auto timestamp = timestamp_reader->get_frame_timestamp(mode, f);
                     auto timestamp_domain = timestamp_reader->get_frame_timestamp_domain(mode, f);
                     auto frame_counter = timestamp_reader->get_frame_counter(mode, f);
 
+                    // Frames the device counted that the host never saw were lost on the link or in the device, the
+                    // backend tells the ones its capture missed or discarded apart
+                    uint64_t host_lost = uint64_t(f.skipped) + f.incomplete;
+                    uint64_t counter_gap = last_frame_number && frame_counter > last_frame_number + 1 ? frame_counter - last_frame_number - 1 : 0;
+                    uint64_t device_lost = counter_gap > host_lost ? counter_gap - host_lost : 0;
+
                     auto requires_processing = mode.requires_processing();
+                    auto requires_memory = requires_processing || copy_to_allocated;
+
+                    // A deferred frame is unpacked from the backend buffer on the first access to its data, which it
+                    // borrows the same way. Unpackers with several outputs are not deferred, since each output frame
+                    // may be released on its own
+                    auto lazy_unpacking = _lazy_unpacking;
+                    auto deferred = requires_processing && mode.unpacker->outputs.size() == 1 &&
+                        (lazy_unpacking == lazy_unpacking_on_access || lazy_unpacking == lazy_unpacking_ahead);
+                    // An offloaded frame borrows the backend buffer only until a worker unpacked it, the capture thread
+                    // then goes back to the backend right away
+                    auto offloaded = requires_processing && lazy_unpacking == lazy_unpacking_offloaded;
+                    auto borrows = !requires_memory || deferred || offloaded;
+
+                    // Natively-formatted frames borrow the backend buffer until released by the user.
+                    // Once too many are held, copy instead so the backend is not starved of buffers
+                    if (borrows)
+                    {
+                        auto borrowed = ++(*borrowed_frames);
+                        if (borrowed > std::min(_max_borrowed_frames, max_borrowed))
+                        {
+                            --(*borrowed_frames);
+                            requires_memory = true;
+                            deferred = offloaded = borrows = false;
+                        }
+                        else
+                        {
+                            auto peak = peak_borrowed->load();
+                            while (borrowed > peak && !peak_borrowed->compare_exchange_weak(peak, borrowed));
+                        }
+                    }
+                    if (f.skipped)
+                        *missed_frames += f.skipped;
+
+                    frame_continuation release_and_enqueue(borrows ? [continuation, borrowed_frames]()
+                    {
+                        --(*borrowed_frames);
+                        continuation();
+                    } : continuation, requires_memory ? nullptr : f.pixels);
 
                     std::vector<byte *> dest;
                     std::vector<frame_holder> refs;
+                    auto&& tracer = pipeline_tracer::get();
+                    auto time_service = environment::get_instance().get_time_service();
 
                     auto&& unpacker = *mode.unpacker;
                     for (auto&& output : unpacker.outputs)
@@ -460,6 +684,14 @@ namespace librealsense
                             }
                         }
 
+                        if (request && (host_lost || device_lost))
+                        {
+                            auto&& statistics = stream_statistics::instance();
+                            statistics.dropped(request->get_unique_id(), RS2_FRAME_DROP_REASON_CAPTURE, f.skipped);
+                            statistics.dropped(request->get_unique_id(), RS2_FRAME_DROP_REASON_INCOMPLETE, f.incomplete);
+                            statistics.dropped(request->get_unique_id(), RS2_FRAME_DROP_REASON_DEVICE, device_lost);
+                        }
+
                         auto bpp = get_image_bpp(output.format);
                         frame_additional_data additional_data(timestamp,
                             frame_counter,
@@ -471,14 +703,24 @@ namespace librealsense
                             last_frame_number,
                             false);
 
+                        // The backend DMA buffer is only meaningful while the frame references it
+                        if (!requires_memory)
+                            additional_data.dmabuf_fd = f.dmabuf_fd;
+                        additional_data.traced = true;
+
                         last_frame_number = frame_counter;
                         last_timestamp = timestamp;
 
                         auto res = output.stream_resolution({ mode.profile.width, mode.profile.height });
                         auto width = res.width;
                         auto height = res.height;
+                        if (is_compressed_format(output.format))
+                        {
+                            width = static_cast<uint32_t>(f.frame_size);
+                            height = 1;
+                        }
 
-                        frame_holder frame = _source.alloc_frame(stream_to_frame_types(output.stream_desc.type), width * height * bpp / 8, additional_data, requires_processing);
+                        frame_holder frame = _source.alloc_frame(stream_to_frame_types(output.stream_desc.type), width * height * bpp / 8, additional_data, requires_memory);
                         if (frame.frame)
                         {
                             auto video = (video_frame*)frame.frame;
@@ -486,11 +728,14 @@ namespace librealsense
                             video->set_timestamp_domain(timestamp_domain);
                             dest.push_back(const_cast<byte*>(video->get_frame_data()));
                             frame->set_stream(request);
+                            tracer.record(output.stream_desc.type, RS2_PIPELINE_STAGE_PUBLISHED, frame_counter, system_time, time_service->get_time());
                             refs.push_back(std::move(frame));
                         }
                         else
                         {
                             LOG_INFO("Dropped frame. alloc_frame(...) returned nullptr");
+                            if (request)
+                                report_dropped_frame(*request);
                             return;
                         }
 
@@ -499,33 +744,79 @@ namespace librealsense
                     }
 
                     // Unpack the frame
-                    if (requires_processing && (dest.size() > 0))
+                    if (deferred && (dest.size() > 0))
+                    {
+                        auto video = (video_frame*)refs.front().frame;
+                        video->attach_device_memory(std::make_shared<deferred_unpack>(unpacker.unpack, reinterpret_cast<const byte *>(f.pixels),
+                            mode.profile.width, mode.profile.height, size_t(video->get_height()) * video->get_stride()), true);
+                    }
+                    else if (offloaded && (dest.size() > 0))
                     {
+                        // The outputs and the backend buffer go to the queue of the mode, a frame dropped from it or
+                        // left in it at stop gives the backend buffer back as it is destroyed
+                        struct pending_frames
+                        {
+                            std::vector<frame_holder> refs;
+                            std::vector<byte*> dest;
+                            frame_continuation release;
+                        };
+                        auto pending = std::make_shared<pending_frames>();
+                        pending->refs = std::move(refs);
+                        pending->dest = std::move(dest);
+                        pending->release = std::move(release_and_enqueue);
+
+                        auto pixels = reinterpret_cast<const byte *>(f.pixels);
+                        auto width = mode.profile.width, height = mode.profile.height;
+                        auto unpacker_ptr = mode.unpacker;
+                        unpack_queue->invoke([this, pending, pixels, width, height, unpacker_ptr, frame_counter, system_time](dispatcher::cancellable_timer)
+                        {
+                            {
+                                LRS_PROFILE_ZONE("unpack");
+                                LRS_PROFILE_FRAME(frame_counter);
+                                unpacker_ptr->unpack(pending->dest.data(), pixels, width, height);
+                            }
+                            pending->release();
+                            deliver_frames(pending->refs, *unpacker_ptr, frame_counter, system_time);
+                        });
+                        return;
+                    }
+                    else if (requires_processing && (dest.size() > 0))
+                    {
+                        LRS_PROFILE_ZONE("unpack");
+                        LRS_PROFILE_FRAME(frame_counter);
                         unpacker.unpack(dest.data(), reinterpret_cast<const byte *>(f.pixels), mode.profile.width, mode.profile.height);
                     }
-
-                    // If any frame callbacks were specified, dispatch them now
-                    for (auto&& pref : refs)
+                    else if (requires_memory)
                     {
-                        if (!requires_processing)
+                        for (size_t i = 0; i < dest.size(); i++)
                         {
-                            pref->attach_continuation(std::move(release_and_enqueue));
+                            auto video = (video_frame*)refs[i].frame;
+                            librealsense::copy(dest[i], f.pixels, std::min<size_t>(f.frame_size, video->get_height() * video->get_stride()));
                         }
+                    }
+
+                    if (borrows)
+                    {
+                        for (auto&& pref : refs)
+                            pref->attach_continuation(std::move(release_and_enqueue));
+                    }
 
-                        if (_on_before_frame_callback)
+                    // The worker keeps its own reference, the frame is unpacked even if it is dropped before
+                    if (deferred && lazy_unpacking == lazy_unpacking_ahead)
+                    {
+                        for (auto&& pref : refs)
                         {
-                            auto callback = _source.begin_callback();
-                            auto stream_type = pref->get_stream()->get_stream_type();
-                            _on_before_frame_callback(stream_type, pref, std::move(callback));
+                            auto held = std::make_shared<frame_holder>(pref.clone());
+                            thread_pool::instance()->post([held]() { (*held)->get_frame_data(); });
                         }
-
-                        if (pref->get_stream().get())
-                            _source.invoke_callback(std::move(pref));
                     }
-                });
+
+                    deliver_frames(refs, unpacker, frame_counter, system_time);
+                }, kernel_buffers);
             }
             catch(...)
             {
+                _unpack_queues.clear();
                 for (auto&& commited_profile : commited)
                 {
                     _device->close(commited_profile);
@@ -563,9 +854,31 @@ namespace librealsense
             _is_opened = false;
             throw;
         }
+        reserve_bandwidth();
         set_active_streams(requests);
     }
 
+    void uvc_sensor::reserve_bandwidth()
+    {
+        uint64_t bandwidth = 0;
+        for (auto&& profile : _internal_config)
+        {
+            native_pixel_format pf{};
+            if (try_get_pf(profile, pf))
+                bandwidth += static_cast<uint64_t>(pf.get_image_size(profile.width, profile.height)) * profile.fps;
+        }
+
+        auto port = get_usb_root_port(get_device_path());
+        auto&& planner = usb_bandwidth_planner::instance();
+        planner.reserve(static_cast<sensor_interface*>(this), port, bandwidth);
+
+        // Other sensors may stream on the link too, opening goes ahead but the frames may not all make it
+        auto capacity = get_usb_link_capacity(get_usb_specification());
+        auto reserved = planner.get_reserved(port);
+        if (capacity && !port.empty() && reserved > capacity)
+            LOG_WARNING("USB root port " << port << " is oversubscribed: " << reserved / 1000000 << " MB/s of " << capacity / 1000000 << " MB/s are streamed through it");
+    }
+
     void uvc_sensor::close()
     {
         std::lock_guard<std::mutex> lock(_configure_lock);
@@ -574,10 +887,13 @@ namespace librealsense
         else if (!_is_opened)
             throw wrong_api_call_sequence_exception("close() failed. UVC device was not opened!");
 
+        _unpack_queues.clear();
         for (auto& profile : _internal_config)
         {
             _device->close(profile);
         }
+        tune_kernel_buffers();
+        usb_bandwidth_planner::instance().release(static_cast<sensor_interface*>(this));
         reset_streaming();
         _power.reset();
         _is_opened = false;
@@ -598,6 +914,9 @@ namespace librealsense
             throw wrong_api_call_sequence_exception("start_streaming(...) failed. UVC device was not opened!");
 
         _source.set_callback(callback);
+        // The queues are stopped by stop(), and kept until close()
+        for (auto&& queue : _unpack_queues)
+            queue->start();
         _is_streaming = true;
         raise_on_before_streaming_changes(true); //Required to be just before actual start allow recording to work
         _device->start_callbacks();
@@ -611,9 +930,49 @@ namespace librealsense
 
         _is_streaming = false;
         _device->stop_callbacks();
+        // Frames still waiting to be unpacked or for the callback are dropped, none is delivered once stopped
+        for (auto&& queue : _unpack_queues)
+            queue->stop();
+        _source.stop_callback_queues();
         raise_on_before_streaming_changes(false);
     }
 
+    void uvc_sensor::deliver_frames(std::vector<frame_holder>& refs, const pixel_format_unpacker& unpacker,
+        unsigned long long frame_counter, rs2_time_t system_time)
+    {
+        auto&& tracer = pipeline_tracer::get();
+        auto time_service = environment::get_instance().get_time_service();
+
+        if (!refs.empty() && refs.front().frame)
+        {
+            update_options_from_metadata(*refs.front().frame);
+            if (auto controls = std::atomic_load(&_frame_controls))
+                controls->on_frame(*refs.front().frame);
+        }
+
+        auto unpacked = time_service->get_time();
+        for (auto&& output : unpacker.outputs)
+            tracer.record(output.stream_desc.type, RS2_PIPELINE_STAGE_UNPACKED, frame_counter, system_time, unpacked);
+
+        // If any frame callbacks were specified, dispatch them now
+        for (auto&& pref : refs)
+        {
+            if (_on_before_frame_callback)
+            {
+                auto callback = _source.begin_callback();
+                auto stream_type = pref->get_stream()->get_stream_type();
+                _on_before_frame_callback(stream_type, pref, std::move(callback));
+            }
+
+            if (pref->get_stream().get())
+            {
+                auto stream_type = pref->get_stream()->get_stream_type();
+                _source.invoke_callback(std::move(pref));
+                tracer.record(stream_type, RS2_PIPELINE_STAGE_DISPATCHED, frame_counter, system_time, time_service->get_time());
+            }
+        }
+    }
+
 
     void uvc_sensor::reset_streaming()
     {
@@ -762,6 +1121,7 @@ namespace librealsense
 
     hid_sensor::~hid_sensor()
     {
+        stop_async_writes();
         try
         {
             if (_is_streaming)
@@ -889,9 +1249,8 @@ namespace librealsense
             auto system_time = environment::get_instance().get_time_service()->get_time();
             auto timestamp_reader = _hid_iio_timestamp_reader.get();
 
-            // TODO:
             static const std::string custom_sensor_name = "custom";
-            auto sensor_name = sensor_data.sensor.name;
+            auto& sensor_name = sensor_data.sensor.name;
             bool is_custom_sensor = false;
             static const uint32_t custom_source_id_offset = 16;
             uint8_t custom_gpio = 0;
@@ -919,11 +1278,13 @@ namespace librealsense
                 return;
             }
 
-            auto mode = _hid_mapping[sensor_name];
-            auto request = *(mode.original_requests.begin());
+            // Sampled at up to a few hundred Hz per sensor, so the mapping is looked up without copying it
+            auto it = _hid_mapping.find(sensor_name);
+            if (it == _hid_mapping.end())
+                return;
+            const auto& mode = it->second;
+            auto& request = *(mode.original_requests.begin());
             auto data_size = sensor_data.fo.frame_size;
-            mode.profile.width = (uint32_t)data_size;
-            mode.profile.height = 1;
 
             // Determine the timestamp for this HID frame
             auto timestamp = timestamp_reader->get_frame_timestamp(mode, sensor_data.fo);
@@ -935,6 +1296,7 @@ namespace librealsense
             additional_data.frame_number = frame_counter;
             additional_data.timestamp_domain = timestamp_reader->get_frame_timestamp_domain(mode, sensor_data.fo);
             additional_data.system_time = system_time;
+            additional_data.traced = true;
             LOG_DEBUG("FrameAccepted," << get_string(request->get_stream_type()) << "," << std::dec << frame_counter
                       << ",Arrived," << std::fixed << system_time
                       << ",TS," << std::fixed << timestamp
@@ -944,12 +1306,19 @@ namespace librealsense
             if (!frame)
             {
                 LOG_INFO("Dropped frame. alloc_frame(...) returned nullptr");
+                report_dropped_frame(*request);
                 return;
             }
             frame->set_stream(request);
 
-            std::vector<byte*> dest{const_cast<byte*>(frame->get_frame_data())};
-            mode.unpacker->unpack(dest.data(),(const byte*)sensor_data.fo.pixels, mode.profile.width, mode.profile.height);
+            auto&& tracer = pipeline_tracer::get();
+            auto time_service = environment::get_instance().get_time_service();
+            auto stream_type = request->get_stream_type();
+            tracer.record(stream_type, RS2_PIPELINE_STAGE_PUBLISHED, frame_counter, system_time, time_service->get_time());
+
+            byte* dest[] = { const_cast<byte*>(frame->get_frame_data()) };
+            mode.unpacker->unpack(dest, (const byte*)sensor_data.fo.pixels, (int)data_size, 1);
+            tracer.record(stream_type, RS2_PIPELINE_STAGE_UNPACKED, frame_counter, system_time, time_service->get_time());
 
             if (_on_before_frame_callback)
             {
@@ -959,6 +1328,7 @@ namespace librealsense
             }
 
             _source.invoke_callback(std::move(frame));
+            tracer.record(stream_type, RS2_PIPELINE_STAGE_DISPATCHED, frame_counter, system_time, time_service->get_time());
         });
 
         _is_streaming = true;
@@ -1040,8 +1410,65 @@ namespace librealsense
         : sensor_base(name, dev),
           _device(move(uvc_device)),
           _user_count(0),
-          _timestamp_reader(std::move(timestamp_reader))
+          _timestamp_reader(std::move(timestamp_reader)),
+          _max_borrowed_frames(DEFAULT_V4L2_FRAME_BUFFERS / 2),
+          _borrowed_frames(std::make_shared<std::atomic<int>>(0)),
+          _lazy_unpacking(lazy_unpacking_off),
+          _kernel_buffers(DEFAULT_V4L2_FRAME_BUFFERS),
+          _buffering_policy(buffering_fixed),
+          _peak_borrowed(std::make_shared<std::atomic<int>>(0)),
+          _missed_frames(std::make_shared<std::atomic<int>>(0))
     {
         register_metadata(RS2_FRAME_METADATA_BACKEND_TIMESTAMP,     make_additional_data_parser(&frame_additional_data::backend_timestamp));
+
+        // At least one kernel buffer must always remain available to the backend
+        register_option(RS2_OPTION_MAX_BORROWED_FRAMES, std::make_shared<ptr_option<int>>(0, DEFAULT_V4L2_FRAME_BUFFERS - 1, 1,
+            DEFAULT_V4L2_FRAME_BUFFERS / 2, &_max_borrowed_frames,
+            "Maximum number of frames allowed to reference backend buffers directly before falling back to copying, 0 to always copy"));
+
+        // Read by the frame callbacks, so a change applies to streams that are already open
+        register_option(RS2_OPTION_LAZY_UNPACKING, std::make_shared<ptr_option<int>>(lazy_unpacking_off, lazy_unpacking_offloaded, 1,
+            lazy_unpacking_off, &_lazy_unpacking,
+            "Convert the frames to the requested format: 0 on arrival, 1 on the first access to their data, 2 ahead of it on worker threads, "
+            "3 on worker threads before delivering them, in order"));
+
+        // Buffers are only allocated with the streams off, so both apply when the streams are next opened
+        register_option(RS2_OPTION_KERNEL_BUFFERS, std::make_shared<ptr_option<int>>(min_kernel_buffers, max_kernel_buffers, 1,
+            DEFAULT_V4L2_FRAME_BUFFERS, &_kernel_buffers,
+            "Number of kernel buffers each stream captures into, more absorb longer scheduling delays at the cost of latency and memory"));
+
+        auto policy = std::make_shared<ptr_option<int>>(buffering_fixed, buffering_throughput_first, 1,
+            buffering_fixed, &_buffering_policy,
+            "How the kernel buffers are sized: as set, adapted favoring latency, or adapted favoring throughput");
+        policy->set_description(buffering_fixed, "Fixed");
+        policy->set_description(buffering_latency_first, "Latency First");
+        policy->set_description(buffering_throughput_first, "Throughput First");
+        register_option(RS2_OPTION_BUFFERING_POLICY, policy);
+    }
+
+    void uvc_sensor::tune_kernel_buffers()
+    {
+        auto missed = _missed_frames->exchange(0);
+        auto peak = _peak_borrowed->exchange(0);
+        if (_buffering_policy == buffering_fixed)
+            return;
+
+        // Beside the frames the application borrows, one buffer is being filled and one waits queued for the next
+        // frame. Missed frames mean the capture ran out of buffers, spare ones only add latency and memory
+        auto latency_first = _buffering_policy == buffering_latency_first;
+        auto buffers = _kernel_buffers;
+        if (missed || (!latency_first && peak + 2 > buffers))
+            buffers += latency_first ? 1 : 2;
+        else if (latency_first && peak + 2 < buffers)
+            --buffers;
+
+        auto lowest = latency_first ? min_kernel_buffers : int(DEFAULT_V4L2_FRAME_BUFFERS);
+        buffers = std::max(lowest, std::min(buffers, max_kernel_buffers));
+        if (buffers != _kernel_buffers)
+        {
+            LOG_INFO(get_info(RS2_CAMERA_INFO_NAME) << ": " << buffers << " kernel buffers from the next open on, "
+                << missed << " frames missed and up to " << peak << " borrowed with " << _kernel_buffers);
+            _kernel_buffers = buffers;
+        }
     }
 }
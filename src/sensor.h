@@ -22,6 +22,9 @@
 
 namespace librealsense
 {
+    class frame_control_queue;
+    class device_cache_entry;
+
     class device;
     class option;
 
@@ -76,6 +79,18 @@ namespace librealsense
         const std::string& get_info(rs2_camera_info info) const override;
         bool supports_info(rs2_camera_info info) const override;
 
+        // Controls applied to given frame numbers of the sensor, created with the first queued control
+        frame_control_queue& get_frame_controls();
+        // Stops the asynchronous option writes and the frame controls, which run against the sensor. Called first
+        // by the destructors of the sensors, while the derived parts the writes may reach are still alive
+        void stop_async_writes();
+
+        memory_account::usage get_memory_usage() const;
+
+        // Bandwidth the profiles take together on the link, bytes per second, from the native streams they are
+        // unpacked from. Profiles unpacked from the same native stream, such as both infrared streams, count it once
+        uint64_t get_bandwidth(const stream_profiles& profiles) const;
+
     protected:
         void raise_on_before_streaming_changes(bool streaming);
         void set_active_streams(const stream_profiles& requests);
@@ -85,8 +100,13 @@ namespace librealsense
                            std::shared_ptr<stream_profile_interface> target) const;
 
         std::vector<request_mapping> resolve_requests(stream_profiles requests);
+        void index_unpackers();
         std::shared_ptr<stream_profile_interface> map_requests(std::shared_ptr<stream_profile_interface> request);
 
+        // Accounts for a frame dropped because the application holds on to the whole frames queue. The application
+        // is notified at most once a second per stream, with the frames dropped since, so it can shed load
+        void report_dropped_frame(const stream_profile_interface& profile);
+
         std::vector<platform::stream_profile> _internal_config;
 
         std::atomic<bool> _is_streaming;
@@ -99,12 +119,25 @@ namespace librealsense
         frame_source _source;
         device* _owner;
         std::vector<platform::stream_profile> _uvc_profiles;
+        std::shared_ptr<frame_control_queue> _frame_controls;
 
     private:
+        struct dropped_frames
+        {
+            uint64_t total = 0;
+            uint64_t unreported = 0;
+            std::chrono::steady_clock::time_point reported_at;
+        };
+
         lazy<stream_profiles> _profiles;
         stream_profiles _active_profiles;
         std::vector<native_pixel_format> _pixel_formats;
+        // The unpackers able to output each stream and format, rebuilt whenever the pixel formats change
+        typedef std::tuple<rs2_stream, int, rs2_format> unpacker_key;
+        std::map<unpacker_key, std::vector<std::pair<native_pixel_format*, pixel_format_unpacker*>>> _unpackers_by_output;
         signal<sensor_base, bool> on_before_streaming_changes;
+        std::mutex _dropped_mutex;
+        std::map<std::pair<rs2_stream, int>, dropped_frames> _dropped;
     };
 
     struct frame_timestamp_reader
@@ -117,7 +150,7 @@ namespace librealsense
         virtual void reset() = 0;
     };
 
-    class hid_sensor : public sensor_base
+    class hid_sensor : public sensor_base, public frame_allocator_interface
     {
     public:
         explicit hid_sensor(std::shared_ptr<platform::hid_device> hid_device,
@@ -137,6 +170,9 @@ namespace librealsense
 
         void stop() override;
 
+        void set_frame_allocator(frame_allocator_ptr allocator) override { _source.set_allocator(std::move(allocator)); }
+        void set_callback_cpus(std::vector<int> cpus) override { _source.set_callback_cpus(std::move(cpus)); }
+
         std::vector<uint8_t> get_custom_report_data(const std::string& custom_sensor_name,
                                                     const std::string& report_name,
                                                     platform::custom_sensor_report_field report_field) const;
@@ -169,7 +205,23 @@ namespace librealsense
         uint32_t fps_to_sampling_frequency(rs2_stream stream, uint32_t fps) const;
     };
 
-    class uvc_sensor : public sensor_base
+    // Values of RS2_OPTION_LAZY_UNPACKING, when the frames whose format needs conversion are unpacked
+    enum lazy_unpacking_modes
+    {
+        lazy_unpacking_off,         // on arrival
+        lazy_unpacking_on_access,   // on the first access to the frame data
+        lazy_unpacking_ahead,       // on the thread pool right after arrival, or on the first access if sooner
+        lazy_unpacking_offloaded    // on the thread pool, which then delivers the frames of each stream in order
+    };
+
+    enum buffering_policies
+    {
+        buffering_fixed,            // the number of kernel buffers set by the user
+        buffering_latency_first,    // as few buffers as the streams get by with
+        buffering_throughput_first  // enough buffers that no frame is missed for lack of one
+    };
+
+    class uvc_sensor : public sensor_base, public frame_allocator_interface
     {
     public:
         explicit uvc_sensor(std::string name, std::shared_ptr<platform::uvc_device> uvc_device,
@@ -193,6 +245,12 @@ namespace librealsense
             return action(*_device);
         }
 
+        // Keeps the device powered up for the whole pass, rather than powering it up for every option
+        std::vector<rs2_option_value> get_options_snapshot() const override
+        {
+            return const_cast<uvc_sensor*>(this)->invoke_powered([this](platform::uvc_device&) { return options_interface::get_options_snapshot(); });
+        }
+
         void register_pu(rs2_option id);
         void try_register_pu(rs2_option id);
 
@@ -200,9 +258,15 @@ namespace librealsense
 
         void stop() override;
 
+        void set_frame_allocator(frame_allocator_ptr allocator) override { _source.set_allocator(std::move(allocator)); }
+        void set_callback_cpus(std::vector<int> cpus) override { _source.set_callback_cpus(std::move(cpus)); }
+
         platform::usb_spec get_usb_specification() const { return _device->get_usb_specification(); }
         std::string get_device_path() const { return _device->get_device_location(); }
 
+        // Lists the profiles from the cache of the device when it has them, set before the profiles are first queried
+        void set_device_cache(std::shared_ptr<device_cache_entry> cache) { _cache = std::move(cache); }
+
     protected:
         stream_profiles init_stream_profiles() override;
 
@@ -215,6 +279,16 @@ namespace librealsense
 
         void reset_streaming();
 
+        // Applies the metadata of the unpacked frames and passes them to the callbacks
+        void deliver_frames(std::vector<frame_holder>& refs, const pixel_format_unpacker& unpacker,
+            unsigned long long frame_counter, rs2_time_t system_time);
+
+        // Records the bandwidth of the streams opened, for the profiles still to be resolved on the same link
+        void reserve_bandwidth();
+
+        // Sizes the kernel buffers of the next session by how the one closing went with its buffers
+        void tune_kernel_buffers();
+
         struct power
         {
             explicit power(std::weak_ptr<uvc_sensor> owner)
@@ -249,5 +323,14 @@ namespace librealsense
         std::vector<platform::extension_unit> _xus;
         std::unique_ptr<power> _power;
         std::unique_ptr<frame_timestamp_reader> _timestamp_reader;
+        int _max_borrowed_frames;
+        std::shared_ptr<std::atomic<int>> _borrowed_frames;
+        int _lazy_unpacking;
+        std::vector<std::shared_ptr<dispatcher>> _unpack_queues; // one per opened mode, for the offloaded unpacking
+        std::shared_ptr<device_cache_entry> _cache;
+        int _kernel_buffers;
+        int _buffering_policy;
+        std::shared_ptr<std::atomic<int>> _peak_borrowed;   // most frames borrowing backend buffers at once
+        std::shared_ptr<std::atomic<int>> _missed_frames;   // frames the capture had no buffer for
     };
 }
@@ -0,0 +1,150 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#include "shared-backend.h"
+#include "types.h"
+
+namespace librealsense
+{
+    namespace
+    {
+        class hub_watcher : public platform::device_watcher
+        {
+        public:
+            explicit hub_watcher(std::shared_ptr<device_watcher_hub> hub) : _hub(std::move(hub)) {}
+            ~hub_watcher() { stop(); }
+
+            void start(platform::device_changed_callback callback) override
+            {
+                stop();
+                _id = _hub->subscribe(std::move(callback));
+                _subscribed = true;
+            }
+
+            void stop() override
+            {
+                if (_subscribed)
+                {
+                    _hub->unsubscribe(_id);
+                    _subscribed = false;
+                }
+            }
+
+        private:
+            std::shared_ptr<device_watcher_hub> _hub;
+            uint64_t _id = 0;
+            bool _subscribed = false;
+        };
+    }
+
+    device_watcher_hub::device_watcher_hub(std::shared_ptr<platform::device_watcher> watcher)
+        : _watcher(std::move(watcher))
+    {
+    }
+
+    device_watcher_hub::~device_watcher_hub()
+    {
+        if (!_subscribers.empty())
+            _watcher->stop();
+    }
+
+    uint64_t device_watcher_hub::subscribe(platform::device_changed_callback callback)
+    {
+        std::lock_guard<std::mutex> control(_control_mutex);
+        bool first = false;
+        uint64_t id = 0;
+        {
+            std::lock_guard<std::mutex> lock(_notify_mutex);
+            first = _subscribers.empty();
+            id = ++_next_id;
+            auto s = std::make_shared<subscriber>();
+            s->callback = std::move(callback);
+            _subscribers[id] = s;
+        }
+        if (first)
+        {
+            // The hub outlives its watcher, which is stopped before the last subscriber leaves
+            _watcher->start([this](platform::backend_device_group old, platform::backend_device_group curr)
+            {
+                notify(old, curr);
+            });
+        }
+        return id;
+    }
+
+    void device_watcher_hub::unsubscribe(uint64_t id)
+    {
+        std::lock_guard<std::mutex> control(_control_mutex);
+        bool last = false;
+        std::shared_ptr<subscriber> s;
+        {
+            std::lock_guard<std::mutex> lock(_notify_mutex);
+            auto it = _subscribers.find(id);
+            if (it == _subscribers.end())
+                return;
+            s = it->second;
+            _subscribers.erase(it);
+            last = _subscribers.empty();
+        }
+
+        // Waits for a callback running on another thread, a subscriber leaving from its own callback returns right away
+        s->active = false;
+        if (s->runner.load() != std::this_thread::get_id())
+            std::lock_guard<std::mutex> wait(s->running);
+
+        if (last)
+            _watcher->stop();
+    }
+
+    std::shared_ptr<platform::device_watcher> device_watcher_hub::create_watcher()
+    {
+        return std::make_shared<hub_watcher>(shared_from_this());
+    }
+
+    void device_watcher_hub::notify(const platform::backend_device_group& old, const platform::backend_device_group& curr)
+    {
+        // The subscribers are called outside of the lock, so that a callback may subscribe or unsubscribe
+        std::vector<std::shared_ptr<subscriber>> subscribers;
+        {
+            std::lock_guard<std::mutex> lock(_notify_mutex);
+            for (auto&& s : _subscribers)
+                subscribers.push_back(s.second);
+        }
+
+        for (auto&& s : subscribers)
+        {
+            std::lock_guard<std::mutex> running(s->running);
+            if (!s->active)
+                continue;
+
+            s->runner = std::this_thread::get_id();
+            try
+            {
+                s->callback(old, curr);
+            }
+            catch (const std::exception& e)
+            {
+                LOG_ERROR("Device change handler failed: " << e.what());
+            }
+            s->runner = std::thread::id();
+        }
+    }
+
+    shared_backend shared_backend::get()
+    {
+        static std::mutex mutex;
+        static std::weak_ptr<platform::backend> backend;
+        static std::weak_ptr<device_watcher_hub> watchers;
+
+        std::lock_guard<std::mutex> lock(mutex);
+        shared_backend result{ backend.lock(), watchers.lock() };
+        if (!result.backend || !result.watchers)
+        {
+            result.backend = platform::create_backend();
+            result.watchers = std::make_shared<device_watcher_hub>(result.backend->create_device_watcher());
+            backend = result.backend;
+            watchers = result.watchers;
+        }
+        return result;
+    }
+}
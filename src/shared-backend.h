@@ -0,0 +1,57 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "backend.h"
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace librealsense
+{
+    // One platform device watcher feeding any number of subscribers. The watcher runs while there is a subscriber
+    class device_watcher_hub : public std::enable_shared_from_this<device_watcher_hub>
+    {
+    public:
+        explicit device_watcher_hub(std::shared_ptr<platform::device_watcher> watcher);
+        ~device_watcher_hub();
+
+        uint64_t subscribe(platform::device_changed_callback callback);
+        // Returns once the callback of the subscriber is no longer running
+        void unsubscribe(uint64_t id);
+
+        // A watcher to hand to one client of the hub
+        std::shared_ptr<platform::device_watcher> create_watcher();
+
+    private:
+        struct subscriber
+        {
+            platform::device_changed_callback callback;
+            std::mutex running;                 // held while the callback runs
+            std::atomic<std::thread::id> runner{ std::thread::id() };  // the thread running the callback, if any
+            std::atomic<bool> active{ true };
+        };
+
+        void notify(const platform::backend_device_group& old, const platform::backend_device_group& curr);
+
+        std::shared_ptr<platform::device_watcher> _watcher;
+        std::mutex _control_mutex;  // serializes starting and stopping the watcher
+        std::mutex _notify_mutex;   // guards the subscribers, not held while calling them
+        std::map<uint64_t, std::shared_ptr<subscriber>> _subscribers;
+        uint64_t _next_id = 0;
+    };
+
+    // The backend and device watcher shared by the standard contexts of the process, alive as long as one of them is
+    struct shared_backend
+    {
+        std::shared_ptr<platform::backend> backend;
+        std::shared_ptr<device_watcher_hub> watchers;
+
+        static shared_backend get();
+    };
+}
@@ -48,6 +48,11 @@ namespace librealsense
         _unique_id = unique_id::generate_id();
     }
 
+    software_sensor::~software_sensor()
+    {
+        stop_async_writes();
+    }
+
     std::shared_ptr<matcher> software_device::create_matcher(const frame_holder& frame) const
     {
         std::vector<stream_interface*> profiles;
@@ -191,29 +196,47 @@ namespace librealsense
     void software_sensor::set_metadata(rs2_frame_metadata_value key, rs2_metadata_type value)
     {
         _metadata_map[key] = value;
+        update_metadata_header();
     }
 
-    void software_sensor::on_video_frame(rs2_software_video_frame software_frame)
+    void software_sensor::set_metadata(const rs2_frame_metadata_value* keys, const rs2_metadata_type* values, size_t count)
     {
-        frame_additional_data data;
-        data.timestamp = software_frame.timestamp;
-        data.timestamp_domain = software_frame.domain;
-        data.frame_number = software_frame.frame_number;
+        for (size_t i = 0; i < count; i++)
+            _metadata_map[keys[i]] = values[i];
+        update_metadata_header();
+    }
 
-        data.metadata_size = 0;
+    void software_sensor::update_metadata_header()
+    {
+        _metadata_header.metadata_size = 0;
         for (auto i : _metadata_map)
         {
             auto size_of_enum = sizeof(rs2_frame_metadata_value);
             auto size_of_data = sizeof(rs2_metadata_type);
-            if (data.metadata_size + size_of_enum + size_of_data > 255)
+            if (_metadata_header.metadata_size + size_of_enum + size_of_data > MAX_META_DATA_SIZE)
             {
                 continue; //stop adding metadata to frame
             }
-            memcpy(data.metadata_blob.data() + data.metadata_size, &i.first, size_of_enum);
-            data.metadata_size += static_cast<uint32_t>(size_of_enum);
-            memcpy(data.metadata_blob.data() + data.metadata_size, &i.second, size_of_data);
-            data.metadata_size += static_cast<uint32_t>(size_of_data);
+            memcpy(_metadata_header.metadata_blob.data() + _metadata_header.metadata_size, &i.first, size_of_enum);
+            _metadata_header.metadata_size += static_cast<uint32_t>(size_of_enum);
+            memcpy(_metadata_header.metadata_blob.data() + _metadata_header.metadata_size, &i.second, size_of_data);
+            _metadata_header.metadata_size += static_cast<uint32_t>(size_of_data);
         }
+    }
+
+    frame_additional_data software_sensor::frame_data(rs2_time_t timestamp, rs2_timestamp_domain domain, int frame_number) const
+    {
+        frame_additional_data data = _metadata_header;
+        data.timestamp = timestamp;
+        data.timestamp_domain = domain;
+        data.frame_number = frame_number;
+        return data;
+    }
+
+    // The frames adopt the buffers of the caller, which the deleter releases with the frame
+    void software_sensor::on_video_frame(rs2_software_video_frame software_frame)
+    {
+        auto data = frame_data(software_frame.timestamp, software_frame.domain, software_frame.frame_number);
 
         rs2_extension extension = software_frame.profile->profile->get_stream_type() == RS2_STREAM_DEPTH ?
             RS2_EXTENSION_DEPTH_FRAME : RS2_EXTENSION_VIDEO_FRAME;
@@ -225,7 +248,7 @@ namespace librealsense
             return;
         }
         auto vid_profile = dynamic_cast<video_stream_profile_interface*>(software_frame.profile->profile);
-        auto vid_frame = dynamic_cast<video_frame*>(frame);
+        auto vid_frame = frame_cast<video_frame>(frame);
         vid_frame->assign(vid_profile->get_width(), vid_profile->get_height(), software_frame.stride, software_frame.bpp * 8);
 
         frame->set_stream(std::dynamic_pointer_cast<stream_profile_interface>(software_frame.profile->profile->shared_from_this()));
@@ -233,28 +256,17 @@ namespace librealsense
             software_frame.deleter(software_frame.pixels);
         }, software_frame.pixels });
 
-        auto sd = dynamic_cast<software_device*>(_owner);
-        sd->register_extrinsic(*vid_profile, _unique_id);
+        if (_registered_streams.insert(vid_profile->get_unique_id()).second)
+        {
+            auto sd = dynamic_cast<software_device*>(_owner);
+            sd->register_extrinsic(*vid_profile, _unique_id);
+        }
         _source.invoke_callback(frame);
     }
 
     void software_sensor::on_motion_frame(rs2_software_motion_frame software_frame)
     {
-        frame_additional_data data;
-        data.timestamp = software_frame.timestamp;
-        data.timestamp_domain = software_frame.domain;
-        data.frame_number = software_frame.frame_number;
-
-        data.metadata_size = 0;
-        for (auto i : _metadata_map)
-        {
-            auto size_of_enum = sizeof(rs2_frame_metadata_value);
-            auto size_of_data = sizeof(rs2_metadata_type);
-            memcpy(data.metadata_blob.data() + data.metadata_size, &i.first, size_of_enum);
-            data.metadata_size += static_cast<uint32_t>(size_of_enum);
-            memcpy(data.metadata_blob.data() + data.metadata_size, &i.second, size_of_data);
-            data.metadata_size += static_cast<uint32_t>(size_of_data);
-        }
+        auto data = frame_data(software_frame.timestamp, software_frame.domain, software_frame.frame_number);
 
         auto frame = _source.alloc_frame(RS2_EXTENSION_MOTION_FRAME, 0, data, false);
         if (!frame)
@@ -271,21 +283,7 @@ namespace librealsense
 
     void software_sensor::on_pose_frame(rs2_software_pose_frame software_frame)
     {
-        frame_additional_data data;
-        data.timestamp = software_frame.timestamp;
-        data.timestamp_domain = software_frame.domain;
-        data.frame_number = software_frame.frame_number;
-
-        data.metadata_size = 0;
-        for (auto i : _metadata_map)
-        {
-            auto size_of_enum = sizeof(rs2_frame_metadata_value);
-            auto size_of_data = sizeof(rs2_metadata_type);
-            memcpy(data.metadata_blob.data() + data.metadata_size, &i.first, size_of_enum);
-            data.metadata_size += static_cast<uint32_t>(size_of_enum);
-            memcpy(data.metadata_blob.data() + data.metadata_size, &i.second, size_of_data);
-            data.metadata_size += static_cast<uint32_t>(size_of_data);
-        }
+        auto data = frame_data(software_frame.timestamp, software_frame.domain, software_frame.frame_number);
 
         auto frame = _source.alloc_frame(RS2_EXTENSION_POSE_FRAME, 0, data, false);
         if (!frame)
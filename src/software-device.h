@@ -39,6 +39,7 @@ namespace librealsense
     {
     public:
         software_sensor(std::string name, software_device* owner);
+        ~software_sensor();
 
         std::shared_ptr<stream_profile_interface> add_video_stream(rs2_video_stream video_stream);
         std::shared_ptr<stream_profile_interface> add_motion_stream(rs2_motion_stream motion_stream);
@@ -58,10 +59,18 @@ namespace librealsense
         void add_read_only_option(rs2_option option, float val);
         void update_read_only_option(rs2_option option, float val);
         void set_metadata(rs2_frame_metadata_value key, rs2_metadata_type value);
+        void set_metadata(const rs2_frame_metadata_value* keys, const rs2_metadata_type* values, size_t count);
     private:
         friend class software_device;
+
+        // Serializes the metadata map into the header copied into every injected frame
+        void update_metadata_header();
+        frame_additional_data frame_data(rs2_time_t timestamp, rs2_timestamp_domain domain, int frame_number) const;
+
         stream_profiles _profiles;
         std::map<rs2_frame_metadata_value, rs2_metadata_type> _metadata_map;
+        frame_additional_data _metadata_header;
+        std::set<int> _registered_streams;  // Video streams already added to the extrinsics group of the sensor
         int _unique_id;
     };
     MAP_EXTENSION(RS2_EXTENSION_SOFTWARE_SENSOR, software_sensor);
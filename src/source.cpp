@@ -4,15 +4,19 @@
 #include "source.h"
 #include "option.h"
 #include "environment.h"
+#include "thread-scheduling.h"
+#include "stream-statistics.h"
+#include "profiling.h"
 
 namespace librealsense
 {
     class frame_queue_size : public option_base
     {
     public:
-        frame_queue_size(std::atomic<uint32_t>* ptr, const option_range& opt_range)
+        frame_queue_size(std::atomic<uint32_t>* ptr, const option_range& opt_range,
+            const char* description = "Max number of frames you can hold at a given time. Increasing this number will reduce frame drops but increase latency, and vice versa")
             : option_base(opt_range),
-              _ptr(ptr)
+              _ptr(ptr), _description(description)
         {}
 
         void set(float value) override
@@ -28,12 +32,34 @@ namespace librealsense
 
         bool is_enabled() const override { return true; }
 
-        const char* get_description() const override
+        const char* get_description() const override { return _description; }
+
+    private:
+        std::atomic<uint32_t>* _ptr;
+        const char* _description;
+    };
+
+    class frame_pool_counter : public readonly_option
+    {
+    public:
+        frame_pool_counter(std::function<uint64_t()> counter, std::string desc)
+            : _counter(std::move(counter)), _desc(std::move(desc))
+        {}
+
+        float query() const override { return static_cast<float>(_counter()); }
+
+        option_range get_range() const override
         {
-            return "Max number of frames you can hold at a given time. Increasing this number will reduce frame drops but increase latency, and vice versa";
+            return { 0, static_cast<float>((std::numeric_limits<uint32_t>::max)()), 1, 0 };
         }
+
+        bool is_enabled() const override { return true; }
+
+        const char* get_description() const override { return _desc.c_str(); }
+
     private:
-        std::atomic<uint32_t>* _ptr;
+        std::function<uint64_t()> _counter;
+        std::string _desc;
     };
 
     std::shared_ptr<option> frame_source::get_published_size_option()
@@ -41,10 +67,60 @@ namespace librealsense
         return std::make_shared<frame_queue_size>(&_max_publish_list_size, option_range{ 0, 32, 1, 16 });
     }
 
+    std::shared_ptr<option> frame_source::get_overflow_limit_option()
+    {
+        return std::make_shared<frame_queue_size>(&_overflow_limit_mb, option_range{ 0, 4096, 1, 0 },
+            "Memory in MB the frames held beyond the frames queue size may take before frames are dropped, 0 drops them right away");
+    }
+
+    std::shared_ptr<option> frame_source::get_dropped_frames_option()
+    {
+        return std::make_shared<frame_pool_counter>([this]() { return _dropped_frames.load(); },
+            "Number of frames dropped since the sensor was created, because the application held on to too many frames");
+    }
+
+    std::shared_ptr<option> frame_source::get_pool_hits_option()
+    {
+        return std::make_shared<frame_pool_counter>([this]() { return get_pool_stats().hits; },
+            "Number of frames allocated from recycled buffers");
+    }
+
+    std::shared_ptr<option> frame_source::get_pool_misses_option()
+    {
+        return std::make_shared<frame_pool_counter>([this]() { return get_pool_stats().misses; },
+            "Number of frames that required a new buffer allocation");
+    }
+
+    frame_pool_stats frame_source::get_pool_stats() const
+    {
+        std::lock_guard<std::mutex> lock(_callback_mutex);
+        frame_pool_stats total;
+        for (auto&& kvp : _archive)
+        {
+            if (!kvp.second) continue;
+            auto stats = kvp.second->get_pool_stats();
+            total.hits += stats.hits;
+            total.misses += stats.misses;
+        }
+        return total;
+    }
+
+    std::shared_ptr<option> frame_source::get_callback_queue_size_option()
+    {
+        return std::make_shared<frame_queue_size>(&_callback_queue_size, option_range{ 0, 64, 1, 0 },
+            "Frames each stream may have waiting for the callback, which is then called on worker threads, in parallel "
+            "for the streams, and the oldest frame of a stream is dropped when its queue is full. 0 calls it on the thread the frames arrive on");
+    }
+
     frame_source::frame_source(uint32_t max_publish_list_size)
             : _callback(nullptr, [](rs2_frame_callback*) {}),
               _max_publish_list_size(max_publish_list_size),
-              _ts(environment::get_instance().get_time_service())
+              _overflow_limit_mb(0),
+              _dropped_frames(0),
+              _ts(environment::get_instance().get_time_service()),
+              _memory(std::make_shared<memory_account>()),
+              _callback_cpus_version(0),
+              _callback_queue_size(0)
     {}
 
     void frame_source::init(std::shared_ptr<metadata_parser_map> metadata_parsers)
@@ -59,20 +135,74 @@ namespace librealsense
                                                RS2_EXTENSION_MOTION_FRAME,
                                                RS2_EXTENSION_POSE_FRAME };
 
+        // Composite frames, point clouds and poses address their storage directly
+        std::vector<rs2_extension> allocatable { RS2_EXTENSION_VIDEO_FRAME,
+                                                 RS2_EXTENSION_DEPTH_FRAME,
+                                                 RS2_EXTENSION_DISPARITY_FRAME,
+                                                 RS2_EXTENSION_MOTION_FRAME };
+
         for (auto type : supported)
         {
-            _archive[type] = make_archive(type, &_max_publish_list_size, _ts, metadata_parsers);
+            _archive[type] = make_archive(type, &_max_publish_list_size, &_overflow_limit_mb, _ts, metadata_parsers);
+            _archive[type]->set_memory_account(_memory);
+            if (_allocator && std::find(allocatable.begin(), allocatable.end(), type) != allocatable.end())
+                _archive[type]->set_allocator(_allocator);
         }
     }
 
+    void frame_source::set_allocator(frame_allocator_ptr allocator)
+    {
+        std::lock_guard<std::mutex> lock(_callback_mutex);
+        _allocator = std::move(allocator);
+    }
+
+    bool frame_source::has_allocator() const
+    {
+        std::lock_guard<std::mutex> lock(_callback_mutex);
+        return _allocator != nullptr;
+    }
+
+    void frame_source::set_memory_account(std::shared_ptr<memory_account> account)
+    {
+        std::lock_guard<std::mutex> lock(_callback_mutex);
+        _memory = std::move(account);
+    }
+
+    memory_account::usage frame_source::get_memory_usage() const
+    {
+        std::lock_guard<std::mutex> lock(_callback_mutex);
+        return _memory->get_usage();
+    }
+
+    void frame_source::set_callback_cpus(std::vector<int> cpus)
+    {
+        std::lock_guard<std::mutex> lock(_callback_mutex);
+        _callback_cpus = std::move(cpus);
+        ++_callback_cpus_version;
+    }
+
     callback_invocation_holder frame_source::begin_callback()
     {
         return _archive[RS2_EXTENSION_VIDEO_FRAME]->begin_callback();
 //        return _archive[RS2_EXTENSION_DEPTH_FRAME]->begin_callback();
     }
 
+    void frame_source::stop_callback_queues()
+    {
+        // Stopped outside of the lock, a callback in progress may be invoking the next frame meanwhile
+        std::map<int, std::shared_ptr<dispatcher>> queues;
+        {
+            std::lock_guard<std::mutex> lock(_callback_mutex);
+            std::swap(queues, _callback_queues);
+        }
+        for (auto&& queue : queues)
+            queue.second->stop();
+    }
+
     void frame_source::reset()
     {
+        stop_callback_queues();
+
         std::lock_guard<std::mutex> lock(_callback_mutex);
         _callback.reset();
         for (auto&& kvp : _archive)
@@ -85,7 +215,10 @@ namespace librealsense
     {
         auto it = _archive.find(type);
         if (it == _archive.end()) throw wrong_api_call_sequence_exception("Requested frame type is not supported!");
-        return it->second->alloc_and_track(size, additional_data, requires_memory);
+        auto frame = it->second->alloc_and_track(size, additional_data, requires_memory);
+        if (!frame)
+            ++_dropped_frames;
+        return frame;
     }
 
     void frame_source::set_sensor(std::shared_ptr<sensor_interface> s)
@@ -108,15 +241,80 @@ namespace librealsense
         return _callback;
     }
     void frame_source::invoke_callback(frame_holder frame) const
+    {
+        if (!frame)
+            return;
+
+        auto stream = frame->get_stream();
+        std::shared_ptr<dispatcher> queue;
+        if (stream)
+        {
+            std::lock_guard<std::mutex> lock(_callback_mutex);
+            auto it = _callback_queues.find(stream->get_unique_id());
+            if (it != _callback_queues.end())
+                queue = it->second;
+            // A stream keeps its queue once it has one, so no frame overtakes the ones queued before
+            else if (auto size = _callback_queue_size.load())
+            {
+                queue = std::make_shared<dispatcher>(size);
+                queue->start();
+                _callback_queues[stream->get_unique_id()] = queue;
+            }
+        }
+        if (!queue)
+            return deliver(std::move(frame));
+
+        // Frames replaced by newer ones in a full queue, or left in it at reset, are counted as dropped
+        struct pending_frame
+        {
+            frame_holder frame;
+            ~pending_frame()
+            {
+                if (frame)
+                    stream_statistics::instance().dropped(frame.frame, RS2_FRAME_DROP_REASON_QUEUE);
+            }
+        };
+        auto pending = std::make_shared<pending_frame>();
+        pending->frame = std::move(frame);
+        queue->invoke([this, pending](dispatcher::cancellable_timer)
+        {
+            deliver(std::move(pending->frame));
+        });
+    }
+
+    void frame_source::deliver(frame_holder frame) const
     {
         if (frame)
         {
             auto callback = frame.frame->get_owner()->begin_callback();
+
+            // A thread delivering the frames of several sources follows the one it delivered last
+            if (auto version = _callback_cpus_version.load())
+            {
+                static thread_local std::pair<const frame_source*, unsigned int> applied(nullptr, 0);
+                if (applied.first != this || applied.second != version)
+                {
+                    std::vector<int> cpus;
+                    {
+                        std::lock_guard<std::mutex> lock(_callback_mutex);
+                        cpus = _callback_cpus;
+                    }
+                    if (!cpus.empty())
+                        thread_scheduling::set_cpus(cpus, "rs-capture");
+                    applied = { this, version };
+                }
+            }
+
+            if (auto stream = frame->get_stream())
+                stream_statistics::instance().delivered(stream->get_unique_id());
+
             try
             {
                 frame->log_callback_start(_ts ? _ts->get_time() : 0);
                 if (_callback)
                 {
+                    LRS_PROFILE_ZONE("user callback");
+                    LRS_PROFILE_FRAME(frame->get_frame_number());
                     frame_interface* ref = nullptr;
                     std::swap(frame.frame, ref);
                     _callback->on_frame((rs2_frame*)ref);
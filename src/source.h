@@ -24,13 +24,24 @@ namespace librealsense
         void reset();
 
         std::shared_ptr<option> get_published_size_option();
+        std::shared_ptr<option> get_overflow_limit_option();
+        std::shared_ptr<option> get_dropped_frames_option();
+        std::shared_ptr<option> get_pool_hits_option();
+        std::shared_ptr<option> get_pool_misses_option();
+        std::shared_ptr<option> get_callback_queue_size_option();
+
+        frame_pool_stats get_pool_stats() const;
 
         frame_interface* alloc_frame(rs2_extension type, size_t size, frame_additional_data additional_data, bool requires_memory) const;
 
         void set_callback(frame_callback_ptr callback);
         frame_callback_ptr get_callback() const;
 
+        // Calls the callback on the calling thread, or with a callback queue size set, queues the frame for the
+        // strand of its stream, so the streams are delivered in parallel and each in order
         void invoke_callback(frame_holder frame) const;
+        // Drops the frames still queued for the callback and waits for the callbacks in progress
+        void stop_callback_queues();
 
         void flush() const;
 
@@ -40,15 +51,39 @@ namespace librealsense
 
         void set_sensor(std::shared_ptr<sensor_interface> s);
 
+        // Takes effect on the next init(). Only frame types whose content is accessed
+        // through frame_interface::get_frame_data are backed by the allocator
+        void set_allocator(frame_allocator_ptr allocator);
+        bool has_allocator() const;
+
+        // Each thread invoking the callback is moved to the cores before its next frame, once per change
+        void set_callback_cpus(std::vector<int> cpus);
+
+        // Counts the frame memory of the source, takes effect on the next init()
+        void set_memory_account(std::shared_ptr<memory_account> account);
+        memory_account::usage get_memory_usage() const;
+
     private:
         friend class syncer_process_unit;
 
+        void deliver(frame_holder frame) const;
+
         mutable std::mutex _callback_mutex;
 
         std::map<rs2_extension, std::shared_ptr<archive_interface>> _archive;
 
         std::atomic<uint32_t> _max_publish_list_size;
+        std::atomic<uint32_t> _overflow_limit_mb;
+        mutable std::atomic<uint64_t> _dropped_frames;
         frame_callback_ptr _callback;
+        frame_allocator_ptr _allocator;
         std::shared_ptr<platform::time_service> _ts;
+        std::shared_ptr<memory_account> _memory;
+        std::vector<int> _callback_cpus;
+        std::atomic<unsigned int> _callback_cpus_version;
+
+        // Frames each stream may have waiting for the callback, 0 to call it on the thread the frames arrive on
+        std::atomic<uint32_t> _callback_queue_size;
+        mutable std::map<int, std::shared_ptr<dispatcher>> _callback_queues; // By stream unique id
     };
 }
@@ -0,0 +1,73 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#include "stream-statistics.h"
+#include "archive.h"
+
+namespace librealsense
+{
+    stream_statistics& stream_statistics::instance()
+    {
+        static stream_statistics statistics;
+        return statistics;
+    }
+
+    stream_statistics::counters& stream_statistics::get_counters(int stream_id)
+    {
+        // The counters of a stream are never removed, so they are used outside of the lock
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto& c = _streams[stream_id];
+        if (!c)
+            c.reset(new counters());
+        return *c;
+    }
+
+    void stream_statistics::delivered(int stream_id)
+    {
+        get_counters(stream_id).delivered.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void stream_statistics::dropped(int stream_id, rs2_frame_drop_reason reason, uint64_t frames)
+    {
+        if (frames)
+            get_counters(stream_id).dropped[reason].fetch_add(frames, std::memory_order_relaxed);
+    }
+
+    void stream_statistics::dropped(const frame_interface* frame, rs2_frame_drop_reason reason)
+    {
+        if (!frame)
+            return;
+        if (auto composite = dynamic_cast<const composite_frame*>(frame))
+        {
+            for (size_t i = 0; i < composite->get_embedded_frames_count(); ++i)
+                dropped(composite->get_frame(static_cast<int>(i)), reason);
+            return;
+        }
+        if (auto stream = frame->get_stream())
+            dropped(stream->get_unique_id(), reason);
+    }
+
+    rs2_stream_statistics stream_statistics::get(int stream_id) const
+    {
+        rs2_stream_statistics result{};
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto it = _streams.find(stream_id);
+        if (it == _streams.end())
+            return result;
+        result.delivered = it->second->delivered.load(std::memory_order_relaxed);
+        for (int i = 0; i < RS2_FRAME_DROP_REASON_COUNT; ++i)
+            result.dropped[i] = it->second->dropped[i].load(std::memory_order_relaxed);
+        return result;
+    }
+
+    void stream_statistics::reset(int stream_id)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto it = _streams.find(stream_id);
+        if (it == _streams.end())
+            return;
+        it->second->delivered = 0;
+        for (auto&& d : it->second->dropped)
+            d = 0;
+    }
+}
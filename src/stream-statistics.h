@@ -0,0 +1,53 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "../include/librealsense2/h/rs_types.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace librealsense
+{
+    class frame_interface;
+
+    // Frames delivered and dropped per stream, by the unique id of the stream, since the library was loaded or the
+    // stream was reset. Process-wide, so the places frames are dropped in don't need to know the sensor they came from
+    class stream_statistics
+    {
+    public:
+        static stream_statistics& instance();
+
+        void delivered(int stream_id);
+        void dropped(int stream_id, rs2_frame_drop_reason reason, uint64_t frames = 1);
+        // Every frame of a frameset counts
+        void dropped(const frame_interface* frame, rs2_frame_drop_reason reason);
+
+        rs2_stream_statistics get(int stream_id) const;
+        void reset(int stream_id);
+
+    private:
+        stream_statistics() = default;
+
+        struct counters
+        {
+            counters()
+            {
+                for (auto&& d : dropped)
+                    d = 0;
+            }
+
+            std::atomic<uint64_t> delivered{ 0 };
+            std::atomic<uint64_t> dropped[RS2_FRAME_DROP_REASON_COUNT];
+        };
+
+        counters& get_counters(int stream_id);
+
+        mutable std::mutex _mutex;
+        std::unordered_map<int, std::unique_ptr<counters>> _streams;
+    };
+}
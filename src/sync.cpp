@@ -4,6 +4,8 @@
 #include "proc/synthetic-stream.h"
 #include "sync.h"
 #include "environment.h"
+#include "stream-statistics.h"
+#include "profiling.h"
 
 namespace librealsense
 {
@@ -12,7 +14,7 @@ namespace librealsense
     std::string frame_to_string(frame_holder& f)
     {
         std::stringstream s;
-        auto composite = dynamic_cast<composite_frame*>(f.frame);
+        auto composite = frame_cast<composite_frame>(f.frame);
         if(composite)
         {
             for (int i = 0; i < composite->get_embedded_frames_count(); i++)
@@ -94,9 +96,7 @@ namespace librealsense
 
     void identity_matcher::dispatch(frame_holder f, syncronization_environment env)
     {
-        std::stringstream s;
-        s <<_name<<"--> "<< f->get_stream()->get_stream_type() << " " << f->get_frame_number() << ", "<<std::fixed<< f->get_frame_timestamp()<<"\n";
-        LOG_DEBUG(s.str());
+        LOG_DEBUG(_name << "--> " << f->get_stream()->get_stream_type() << " " << f->get_frame_number() << ", " << std::fixed << f->get_frame_timestamp());
 
         sync(std::move(f), env);
     }
@@ -114,6 +114,14 @@ namespace librealsense
         return s.str();
     }
 
+    std::string streams_to_string(const matcher& m)
+    {
+        std::stringstream s;
+        for (auto&& stream : m.get_streams_types())
+            s << stream << " ";
+        return s.str();
+    }
+
     composite_matcher::composite_matcher(std::vector<std::shared_ptr<matcher>> matchers, std::string name)
     {
         for (auto&& matcher : matchers)
@@ -124,7 +132,7 @@ namespace librealsense
                 {
                     sync(std::move(f), env);
                 });
-                _matchers[stream] = matcher;
+                set_matcher(stream, matcher);
                 _streams_id.push_back(stream);
             }
             for (auto&& stream : matcher->get_streams_types())
@@ -136,11 +144,74 @@ namespace librealsense
         _name = create_composite_name(matchers, name);
     }
 
+    std::shared_ptr<matcher> composite_matcher::get_matcher(stream_id stream) const
+    {
+        for (auto&& m : _matchers)
+            if (m.first == stream)
+                return m.second;
+        return nullptr;
+    }
+
+    void composite_matcher::set_matcher(stream_id stream, std::shared_ptr<matcher> m)
+    {
+        std::shared_ptr<matcher> replaced;
+        auto it = std::find_if(_matchers.begin(), _matchers.end(), [&](const std::pair<stream_id, std::shared_ptr<matcher>>& e) { return e.first == stream; });
+        if (it == _matchers.end())
+            _matchers.emplace_back(stream, std::move(m));
+        else
+        {
+            replaced = std::move(it->second);
+            it->second = std::move(m);
+        }
+
+        // Forget the state of a matcher once no stream refers to it, its address may be reused by the next one
+        if (replaced && std::none_of(_matchers.begin(), _matchers.end(), [&](const std::pair<stream_id, std::shared_ptr<matcher>>& e) { return e.second == replaced; }))
+        {
+            _slots.erase(std::remove_if(_slots.begin(), _slots.end(), [&](const matcher_slot& slot) { return slot.m == replaced.get(); }), _slots.end());
+        }
+    }
+
+    composite_matcher::matcher_slot& composite_matcher::get_slot(matcher* m)
+    {
+        for (auto&& slot : _slots)
+            if (slot.m == m)
+                return slot;
+        _slots.emplace_back(m);
+        return _slots.back();
+    }
+
+    void composite_matcher::enqueue(matcher_slot& slot, frame_holder f)
+    {
+        slot.queued = true;
+        if (!slot.accepting)
+            return;
+
+        // Blocking frames are never dropped, they are only produced as fast as they are consumed
+        auto is_blocking = f.is_blocking();
+        slot.frames.push_back(std::move(f));
+        if (!is_blocking && slot.frames.size() > QUEUE_MAX_SIZE)
+            slot.frames.pop_front();
+    }
+
+    void composite_matcher::clear(matcher_slot& slot)
+    {
+        slot.queued = true;
+        slot.accepting = false;
+        slot.frames.clear();
+    }
+
+    void composite_matcher::remove(matcher_slot& slot)
+    {
+        slot.queued = false;
+        slot.accepting = true;
+        slot.frames.clear();
+    }
+
     void composite_matcher::dispatch(frame_holder f, syncronization_environment env)
     {
-        std::stringstream s;
-        s <<"DISPATCH "<<_name<<"--> "<< frame_to_string(f) <<"\n";
-        LOG_DEBUG(s.str());
+        LRS_PROFILE_ZONE("sync dispatch");
+        LRS_PROFILE_FRAME(f->get_frame_number());
+        LOG_DEBUG("DISPATCH " << _name << "--> " << frame_to_string(f));
 
         clean_inactive_streams(f);
         auto matcher = find_matcher(f);
@@ -173,7 +244,7 @@ namespace librealsense
             if (dev)
             {
                 dev_exist = true;
-                matcher = _matchers[stream_id];
+                matcher = get_matcher(stream_id);
                 if (!matcher)
                 {
                     matcher = dev->create_matcher(frame);
@@ -186,11 +257,7 @@ namespace librealsense
 
                     for (auto stream : matcher->get_streams())
                     {
-                        if (_matchers[stream])
-                        {
-                            _frames_queue.erase(_matchers[stream].get());
-                        }
-                        _matchers[stream] = matcher;
+                        set_matcher(stream, matcher);
                         _streams_id.push_back(stream);
 
                     }
@@ -207,27 +274,24 @@ namespace librealsense
 
                 else if(!matcher->get_active())
                 {
-
                      matcher->set_active(true);
-                     _frames_queue[matcher.get()].start();
+                     auto& slot = get_slot(matcher.get());
+                     slot.queued = true;
+                     slot.accepting = true;
                 }
             }
         }
 
         if(!dev_exist)
         {
-            matcher = _matchers[stream_id];
+            matcher = get_matcher(stream_id);
             // We don't know what device this frame came from, so just store it under device NULL with ID matcher
             if (!matcher)
             {
-                if (_matchers[stream_id])
-                {
-                    _frames_queue.erase(_matchers[stream_id].get());
-                }
-                 _matchers[stream_id] = std::make_shared<identity_matcher>(stream_id, stream_type);
+                matcher = std::make_shared<identity_matcher>(stream_id, stream_type);
+                set_matcher(stream_id, matcher);
                 _streams_id.push_back(stream_id);
                 _streams_type.push_back(stream_type);
-                matcher = _matchers[stream_id];
 
                 matcher->set_callback([&](frame_holder f, syncronization_environment env)
                 {
@@ -239,79 +303,66 @@ namespace librealsense
     }
 
 
-    std::string composite_matcher::frames_to_string(std::vector<librealsense::matcher*> matchers)
+    std::string composite_matcher::frames_to_string(const std::vector<matcher_slot*>& slots)
     {
         std::string str;
-        for (auto m : matchers)
+        for (auto slot : slots)
         {
-            frame_holder* f;
-            if(_frames_queue[m].peek(&f))
-                str += frame_to_string(*f);
+            if (!slot->frames.empty())
+                str += frame_to_string(slot->frames.front());
         }
         return str;
     }
 
     void composite_matcher::sync(frame_holder f, syncronization_environment env)
     {
-        std::stringstream s;
-        s <<"SYNC "<<_name<<"--> "<< frame_to_string(f)<<"\n";
-        LOG_DEBUG(s.str());
+        LOG_DEBUG("SYNC " << _name << "--> " << frame_to_string(f));
 
         update_next_expected(f);
         auto matcher = find_matcher(f);
-        _frames_queue[matcher.get()].enqueue(std::move(f));
+        enqueue(get_slot(matcher.get()), std::move(f));
 
-        std::vector<frame_holder*> frames_arrived;
-        std::vector<librealsense::matcher*> frames_arrived_matchers;
-        std::vector<librealsense::matcher*> synced_frames;
-        std::vector<librealsense::matcher*> missing_streams;
+        // The slots are not added or removed until the loop ends, so the pointers stay valid
+        std::vector<matcher_slot*> frames_arrived;
+        std::vector<matcher_slot*> synced_frames;
+        std::vector<matcher_slot*> missing_streams;
 
         do
         {
-            std::stringstream s;
             auto old_frames = false;
 
             synced_frames.clear();
             missing_streams.clear();
-            frames_arrived_matchers.clear();
             frames_arrived.clear();
 
-
-            for (auto s = _frames_queue.begin(); s != _frames_queue.end(); s++)
+            for (auto&& slot : _slots)
             {
-                frame_holder* f;
-                if (s->second.peek(&f))
-                {
-                    frames_arrived.push_back(f);
-                    frames_arrived_matchers.push_back(s->first);
-                }
+                if (!slot.queued)
+                    continue;
+                if (!slot.frames.empty())
+                    frames_arrived.push_back(&slot);
                 else
-                {
-                    missing_streams.push_back(s->first);
-                }
+                    missing_streams.push_back(&slot);
             }
 
             if (frames_arrived.size() == 0)
                 break;
 
-            frame_holder* curr_sync;
-            if (frames_arrived.size() > 0)
-            {
-                curr_sync = frames_arrived[0];
-                synced_frames.push_back(frames_arrived_matchers[0]);
-            }
+            auto curr_sync = frames_arrived[0];
+            synced_frames.push_back(curr_sync);
 
-            for (auto i = 1; i < frames_arrived.size(); i++)
+            for (size_t i = 1; i < frames_arrived.size(); i++)
             {
-                if (are_equivalent(*curr_sync, *frames_arrived[i]))
+                auto&& candidate = frames_arrived[i]->frames.front();
+                if (are_equivalent(curr_sync->frames.front(), candidate))
                 {
-                    synced_frames.push_back(frames_arrived_matchers[i]);
+                    synced_frames.push_back(frames_arrived[i]);
                 }
-                else if (is_smaller_than(*frames_arrived[i], *curr_sync))
+                else if (is_smaller_than(candidate, curr_sync->frames.front()))
                 {
                     old_frames = true;
                     synced_frames.clear();
-                    synced_frames.push_back(frames_arrived_matchers[i]);
+                    synced_frames.push_back(frames_arrived[i]);
                     curr_sync = frames_arrived[i];
                 }
                 else
@@ -322,52 +373,37 @@ namespace librealsense
 
             if (!old_frames)
             {
-                for (auto i : missing_streams)
+                for (auto missing : missing_streams)
                 {
-                    if (!skip_missing_stream(synced_frames, i))
+                    if (!skip_missing_stream(synced_frames, *missing))
                     {
-                        s <<  _name<<" "<<frames_to_string(synced_frames )<<" Wait for missing stream: ";
-
-                        for (auto&& stream : i->get_streams())
-                            s << stream<<" next expected "<<std::fixed<< _next_expected[i];
+                        LOG_DEBUG(_name << " " << frames_to_string(synced_frames) << " Wait for missing stream: "
+                            << streams_to_string(*missing->m) << "next expected " << std::fixed << missing->next_expected);
                         synced_frames.clear();
-                        LOG_DEBUG(s.str());
                         break;
                     }
                     else
                     {
-                        std::stringstream s;
-                        s << _name << " " << frames_to_string(synced_frames) << " Skipped missing stream: ";
-                        for (auto&& stream : i->get_streams())
-                            s << stream << " next expected " << std::fixed << _next_expected[i]<<" ";
-                        LOG_DEBUG(s.str());
+                        LOG_DEBUG(_name << " " << frames_to_string(synced_frames) << " Skipped missing stream: "
+                            << streams_to_string(*missing->m) << "next expected " << std::fixed << missing->next_expected);
+                        for (auto stream : missing->m->get_streams())
+                            stream_statistics::instance().dropped(stream, RS2_FRAME_DROP_REASON_SYNC);
                     }
-
                 }
             }
-            else
-            {
-                s << _name << " old frames: ";
-            }
+
             if (synced_frames.size())
             {
-                std::vector<frame_holder> match;
-                match.reserve(synced_frames.size());
+                if (old_frames)
+                    LOG_DEBUG(_name << " old frames: --> " << frames_to_string(synced_frames));
 
-                for (auto index : synced_frames)
-                {
-                    frame_holder frame;
-                    _frames_queue[index].dequeue(&frame);
-                    if (old_frames)
-                    {
-                        s  << "--> " << frame_to_string(frame) << "\n";
-                    }
-                    match.push_back(std::move(frame));
-                }
+                composite_frame_builder match;
 
-                if (old_frames)
+                for (auto slot : synced_frames)
                 {
-                    LOG_DEBUG(s.str());
+                    match.push_back(std::move(slot->frames.front()));
+                    slot->frames.pop_front();
+                    slot->accepting = true;
                 }
 
                 std::sort(match.begin(), match.end(), [](const frame_holder& f1, const frame_holder& f2)
@@ -376,11 +412,9 @@ namespace librealsense
                 });
 
 
-                frame_holder composite = env.source->allocate_composite_frame(std::move(match));
+                frame_holder composite = env.source->allocate_composite_frame(match);
                 if (composite.frame)
                 {
-                    s <<"SYNCED "<<_name<<"--> "<< frame_to_string(composite)<<"\n";
-
                     auto cb = begin_callback();
                     _callback(std::move(composite), env);
                 }
@@ -395,7 +429,7 @@ namespace librealsense
 
     void frame_number_composite_matcher::update_last_arrived(frame_holder& f, matcher* m)
     {
-        _last_arrived[m] =f->get_frame_number();
+        get_slot(m).last_arrived = static_cast<double>(f->get_frame_number());
     }
 
     bool frame_number_composite_matcher::are_equivalent(frame_holder& a, frame_holder& b)
@@ -408,42 +442,27 @@ namespace librealsense
     }
     void frame_number_composite_matcher::clean_inactive_streams(frame_holder& f)
     {
-        std::vector<stream_id> inactive_matchers;
-        for(auto m: _matchers)
+        for (auto&& slot : _slots)
         {
-            if (_last_arrived[m.second.get()] && (fabs((long long)f->get_frame_number() - (long long)_last_arrived[m.second.get()])) > 5)
+            if (slot.last_arrived && (fabs((long long)f->get_frame_number() - (long long)slot.last_arrived)) > 5)
             {
-                std::stringstream s;
-                s << "clean inactive stream in "<<_name;
-                for (auto stream : m.second->get_streams_types())
-                {
-                    s << stream << " ";
-                }
-                LOG_DEBUG(s.str());
+                LOG_DEBUG("clean inactive stream in " << _name << streams_to_string(*slot.m));
 
-                inactive_matchers.push_back(m.first);
-                m.second->set_active(false);
+                slot.m->set_active(false);
+                clear(slot);
             }
         }
-
-        for(auto id: inactive_matchers)
-        {
-            _frames_queue[_matchers[id].get()].clear();
-        }
     }
 
-    bool frame_number_composite_matcher::skip_missing_stream(std::vector<matcher*> synced, matcher* missing)
+    bool frame_number_composite_matcher::skip_missing_stream(const std::vector<matcher_slot*>& synced, matcher_slot& missing)
     {
-        frame_holder* synced_frame;
-
-         if(!missing->get_active())
-             return true;
-
-        _frames_queue[synced[0]].peek(&synced_frame);
+        if (!missing.m->get_active())
+            return true;
 
-        auto next_expected = _next_expected[missing];
+        auto&& synced_frame = synced[0]->frames.front();
+        auto next_expected = missing.next_expected;
 
-        if((*synced_frame)->get_frame_number() - next_expected > 4 || (*synced_frame)->get_frame_number() < next_expected)
+        if(synced_frame->get_frame_number() - next_expected > 4 || synced_frame->get_frame_number() < next_expected)
         {
             return true;
         }
@@ -453,7 +472,7 @@ namespace librealsense
     void frame_number_composite_matcher::update_next_expected(const frame_holder& f)
     {
         auto matcher = find_matcher(f);
-        _next_expected[matcher.get()] = f.frame->get_frame_number()+1.;
+        get_slot(matcher.get()).next_expected = f.frame->get_frame_number()+1.;
     }
 
     std::pair<double, double> extract_timestamps(frame_holder & a, frame_holder & b)
@@ -497,13 +516,14 @@ namespace librealsense
 
     void timestamp_composite_matcher::update_last_arrived(frame_holder& f, matcher* m)
     {
+        auto& slot = get_slot(m);
         if(f->supports_frame_metadata(RS2_FRAME_METADATA_ACTUAL_FPS))
-            _fps[m] = (uint32_t)f->get_frame_metadata(RS2_FRAME_METADATA_ACTUAL_FPS);
+            slot.fps = (uint32_t)f->get_frame_metadata(RS2_FRAME_METADATA_ACTUAL_FPS);
 
         else
-            _fps[m] = f->get_stream()->get_framerate();
+            slot.fps = f->get_stream()->get_framerate();
 
-        _last_arrived[m] = environment::get_instance().get_time_service()->get_time();
+        slot.last_arrived = environment::get_instance().get_time_service()->get_time();
     }
 
     unsigned int timestamp_composite_matcher::get_fps(const frame_holder & f)
@@ -524,9 +544,11 @@ namespace librealsense
 
         auto matcher = find_matcher(f);
 
-        _next_expected[matcher.get()] = f.frame->get_frame_timestamp() + gap;
-        _next_expected_domain[matcher.get()] = f.frame->get_frame_timestamp_domain();
-        LOG_DEBUG(_name << frame_to_string(const_cast<frame_holder&>(f))<<"fps " <<fps<<" gap " <<gap<<" next_expected: "<< _next_expected[matcher.get()]);
+        auto& slot = get_slot(matcher.get());
+        slot.next_expected = f.frame->get_frame_timestamp() + gap;
+        slot.next_expected_domain = f.frame->get_frame_timestamp_domain();
+        slot.has_next_expected_domain = true;
+        LOG_DEBUG(_name << frame_to_string(const_cast<frame_holder&>(f))<<"fps " <<fps<<" gap " <<gap<<" next_expected: "<< slot.next_expected);
 
     }
 
@@ -534,62 +556,46 @@ namespace librealsense
     {
         if (f.is_blocking())
             return;
-        std::vector<stream_id> dead_matchers;
         auto now = environment::get_instance().get_time_service()->get_time();
-        for(auto m: _matchers)
+        for (auto&& slot : _slots)
         {
-            auto threshold = _fps[m.second.get()] ? (1000 / _fps[m.second.get()]) * 5 : 500; //if frame of a specific stream didn't arrive for time equivalence to 5 frames duration
-                                                                                             //this stream will be marked as "not active" in order to not stack the other streams
-            if(_last_arrived[m.second.get()] && (now - _last_arrived[m.second.get()]) > threshold)
+            auto threshold = slot.fps ? (1000 / slot.fps) * 5 : 500; //if frame of a specific stream didn't arrive for time equivalence to 5 frames duration
+                                                                     //this stream will be marked as "not active" in order to not stack the other streams
+            if(slot.last_arrived && (now - slot.last_arrived) > threshold)
             {
-                std::stringstream s;
-                s << "clean inactive stream in "<<_name;
-                for (auto stream : m.second->get_streams_types())
-                {
-                    s << stream << " ";
-                }
-                LOG_DEBUG(s.str());
+                LOG_DEBUG("clean inactive stream in " << _name << streams_to_string(*slot.m));
 
-                dead_matchers.push_back(m.first);
-                m.second->set_active(false);
+                slot.m->set_active(false);
+                remove(slot);
             }
         }
-
-        for(auto id: dead_matchers)
-        {
-            _frames_queue[_matchers[id].get()].clear();
-            _frames_queue.erase(_matchers[id].get());
-        }
     }
 
-    bool timestamp_composite_matcher::skip_missing_stream(std::vector<matcher*> synced, matcher* missing)
+    bool timestamp_composite_matcher::skip_missing_stream(const std::vector<matcher_slot*>& synced, matcher_slot& missing)
     {
-        if(!missing->get_active())
+        if(!missing.m->get_active())
             return true;
 
-        frame_holder* synced_frame;
-
-        _frames_queue[synced[0]].peek(&synced_frame);
+        auto&& synced_frame = synced[0]->frames.front();
 
-        auto next_expected = _next_expected[missing];
+        auto next_expected = missing.next_expected;
 
-        auto it = _next_expected_domain.find(missing);
-        if (it != _next_expected_domain.end())
+        if (missing.has_next_expected_domain)
         {
-            if (it->second != (*synced_frame)->get_frame_timestamp_domain())
+            if (missing.next_expected_domain != synced_frame->get_frame_timestamp_domain())
             {
                 return false;
             }
         }
-        auto gap = 1000.f/ (float)get_fps(*synced_frame);
+        auto gap = 1000.f/ (float)get_fps(synced_frame);
         //next expected of the missing stream didn't updated yet
-        if((*synced_frame)->get_frame_timestamp() > next_expected && abs((*synced_frame)->get_frame_timestamp()- next_expected)<gap*10)
+        if(synced_frame->get_frame_timestamp() > next_expected && abs(synced_frame->get_frame_timestamp()- next_expected)<gap*10)
         {
             LOG_DEBUG("next expected of the missing stream didn't updated yet");
             return false;
         }
 
-        return !are_equivalent((*synced_frame)->get_frame_timestamp(), next_expected, get_fps(*synced_frame));
+        return !are_equivalent(synced_frame->get_frame_timestamp(), next_expected, get_fps(synced_frame));
     }
 
     bool timestamp_composite_matcher::are_equivalent(double a, double b, int fps)
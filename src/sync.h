@@ -8,6 +8,7 @@
 
 #include <stdint.h>
 #include <vector>
+#include <deque>
 #include <mutex>
 #include <memory>
 
@@ -111,28 +112,55 @@ namespace librealsense
 
     class composite_matcher : public matcher
     {
+    protected:
+        // Synchronization state of one child matcher. A composite has only a handful of children, so the slots
+        // are scanned linearly instead of looked up in several trees for every frame. The frames need no locking
+        // of their own, all access happens under the lock of the syncer that owns the top-level matcher
+        struct matcher_slot
+        {
+            explicit matcher_slot(matcher* m) : m(m) {}
+
+            matcher* m;
+            std::deque<frame_holder> frames;
+            bool queued = false;        // Takes part in matching, an empty queue is then a missing stream
+            bool accepting = true;      // Cleared with the frames of an inactive stream until it is restarted
+            double next_expected = 0;
+            bool has_next_expected_domain = false;
+            rs2_timestamp_domain next_expected_domain = RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK;
+            double last_arrived = 0;
+            unsigned int fps = 0;
+        };
+
     public:
         composite_matcher(std::vector<std::shared_ptr<matcher>> matchers, std::string name);
 
 
         virtual bool are_equivalent(frame_holder& a, frame_holder& b) = 0;
         virtual bool is_smaller_than(frame_holder& a, frame_holder& b) = 0;
-        virtual bool skip_missing_stream(std::vector<matcher*> synced, matcher* missing)  = 0;
+        virtual bool skip_missing_stream(const std::vector<matcher_slot*>& synced, matcher_slot& missing) = 0;
         virtual void clean_inactive_streams(frame_holder& f) = 0;
         virtual void update_last_arrived(frame_holder& f, matcher* m) = 0;
 
         void dispatch(frame_holder f, syncronization_environment env) override;
-        std::string frames_to_string(std::vector<librealsense::matcher*> matchers);
+        std::string frames_to_string(const std::vector<matcher_slot*>& slots);
         void sync(frame_holder f, syncronization_environment env) override;
         std::shared_ptr<matcher> find_matcher(const frame_holder& f);
 
     protected:
         virtual void update_next_expected(const frame_holder& f) = 0;
 
-        std::map<matcher*, single_consumer_frame_queue<frame_holder>> _frames_queue;
-        std::map<stream_id, std::shared_ptr<matcher>> _matchers;
-        std::map<matcher*, double> _next_expected;
-        std::map<matcher*, rs2_timestamp_domain> _next_expected_domain;
+        matcher_slot& get_slot(matcher* m);
+        void enqueue(matcher_slot& slot, frame_holder f);
+        // Drops the queued frames and refuses new ones until the stream is restarted
+        void clear(matcher_slot& slot);
+        // Drops the queued frames and stops waiting for the stream
+        void remove(matcher_slot& slot);
+
+        std::shared_ptr<matcher> get_matcher(stream_id stream) const;
+        void set_matcher(stream_id stream, std::shared_ptr<matcher> m);
+
+        std::vector<std::pair<stream_id, std::shared_ptr<matcher>>> _matchers;
+        std::deque<matcher_slot> _slots;
     };
 
     class frame_number_composite_matcher : public composite_matcher
@@ -142,12 +170,9 @@ namespace librealsense
         virtual void update_last_arrived(frame_holder& f, matcher* m) override;
         bool are_equivalent(frame_holder& a, frame_holder& b) override;
         bool is_smaller_than(frame_holder& a, frame_holder& b) override;
-        bool skip_missing_stream(std::vector<matcher*> synced, matcher* missing) override;
+        bool skip_missing_stream(const std::vector<matcher_slot*>& synced, matcher_slot& missing) override;
         void clean_inactive_streams(frame_holder& f) override;
         void update_next_expected(const frame_holder& f) override;
-
-    private:
-         std::map<matcher*,unsigned long long> _last_arrived;
     };
 
     class timestamp_composite_matcher : public composite_matcher
@@ -158,14 +183,11 @@ namespace librealsense
         bool is_smaller_than(frame_holder& a, frame_holder& b) override;
         virtual void update_last_arrived(frame_holder& f, matcher* m) override;
         void clean_inactive_streams(frame_holder& f) override;
-        bool skip_missing_stream(std::vector<matcher*> synced, matcher* missing) override;
+        bool skip_missing_stream(const std::vector<matcher_slot*>& synced, matcher_slot& missing) override;
         void update_next_expected(const frame_holder & f) override;
 
     private:
         unsigned int get_fps(const frame_holder & f);
         bool are_equivalent(double a, double b, int fps);
-        std::map<matcher*, double> _last_arrived;
-        std::map<matcher*, unsigned int> _fps;
-
     };
 }
@@ -0,0 +1,208 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#include "thread-scheduling.h"
+#include "concurrency.h"
+#include "types.h"
+#include "../third-party/json.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace librealsense
+{
+    namespace
+    {
+        std::string category_key(rs2_thread_category category)
+        {
+            std::string key = get_string(category);
+            std::transform(key.begin(), key.end(), key.begin(), ::tolower);
+            return key;
+        }
+
+        void validate(const thread_schedule& schedule)
+        {
+            if (schedule.priority < 0 || schedule.priority > 99)
+                throw invalid_value_exception(to_string() << "thread priority " << schedule.priority << " is out of range [0, 99]");
+            for (auto&& cpu : schedule.cpus)
+            {
+                if (cpu < 0)
+                    throw invalid_value_exception(to_string() << "invalid core " << cpu);
+            }
+        }
+
+        void set_thread_name(const char* name)
+        {
+#if defined(__linux__)
+            // Linux limits the names to 15 characters
+            std::string truncated(name, std::min<size_t>(strlen(name), 15));
+            pthread_setname_np(pthread_self(), truncated.c_str());
+#elif defined(__APPLE__)
+            pthread_setname_np(name);
+#else
+            (void)name;
+#endif
+        }
+
+        void set_thread_cpus(const std::vector<int>& cpus, const char* name)
+        {
+#ifdef _WIN32
+            DWORD_PTR mask = 0;
+            for (auto&& cpu : cpus)
+            {
+                if (cpu < static_cast<int>(sizeof(DWORD_PTR) * 8))
+                    mask |= DWORD_PTR(1) << cpu;
+            }
+            if (!mask || !SetThreadAffinityMask(GetCurrentThread(), mask))
+                LOG_WARNING(name << ": could not set the thread affinity, error " << GetLastError());
+#elif defined(__linux__)
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            for (auto&& cpu : cpus)
+            {
+                if (cpu < CPU_SETSIZE)
+                    CPU_SET(cpu, &set);
+            }
+            if (sched_setaffinity(0, sizeof(set), &set) != 0)
+                LOG_WARNING(name << ": could not set the thread affinity, error " << errno);
+#else
+            LOG_WARNING(name << ": thread affinity is not supported on this platform");
+#endif
+        }
+
+        void set_thread_priority(int priority, const char* name)
+        {
+#ifdef _WIN32
+            auto level = priority >= 90 ? THREAD_PRIORITY_TIME_CRITICAL : priority >= 50 ? THREAD_PRIORITY_HIGHEST : THREAD_PRIORITY_ABOVE_NORMAL;
+            if (!SetThreadPriority(GetCurrentThread(), level))
+                LOG_WARNING(name << ": could not raise the thread priority, error " << GetLastError());
+#else
+            sched_param param{};
+            param.sched_priority = std::max(sched_get_priority_min(SCHED_FIFO), std::min(priority, sched_get_priority_max(SCHED_FIFO)));
+            // Usually fails with EPERM, unless the process has CAP_SYS_NICE or a real-time limit
+            if (auto error = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param))
+                LOG_WARNING(name << ": could not set SCHED_FIFO priority " << priority << ", error " << error);
+#endif
+        }
+    }
+
+    thread_scheduling& thread_scheduling::instance()
+    {
+        static thread_scheduling instance;
+        return instance;
+    }
+
+    thread_scheduling::thread_scheduling()
+    {
+        static const char* file_var_name = "LRS_THREAD_SCHEDULING";
+        auto file = getenv(file_var_name);
+        if (!file)
+            return;
+
+        try
+        {
+            std::ifstream in(file);
+            if (!in)
+                throw io_exception(to_string() << "could not open " << file);
+            std::stringstream content;
+            content << in.rdbuf();
+            load(content.str());
+        }
+        catch (const std::exception& e)
+        {
+            LOG_ERROR("Ignoring the thread scheduling of " << file_var_name << ": " << e.what());
+        }
+    }
+
+    void thread_scheduling::configure(rs2_thread_category category, thread_schedule schedule)
+    {
+        validate(schedule);
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _schedules[category] = std::move(schedule);
+        }
+        // The pool workers are long lived, they pick the change up instead of waiting for a restart
+        if (category == RS2_THREAD_CATEGORY_DISPATCHER)
+            thread_pool::instance()->reschedule();
+    }
+
+    thread_schedule thread_scheduling::get(rs2_thread_category category) const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _schedules[category];
+    }
+
+    void thread_scheduling::load(const std::string& json)
+    {
+        nlohmann::json j;
+        try
+        {
+            j = nlohmann::json::parse(json);
+        }
+        catch (const std::exception& e)
+        {
+            throw invalid_value_exception(to_string() << "invalid thread scheduling JSON: " << e.what());
+        }
+        if (!j.is_object())
+            throw invalid_value_exception("thread scheduling JSON must be an object of thread categories");
+
+        // Every entry is validated before any is applied
+        std::vector<std::pair<rs2_thread_category, thread_schedule>> schedules;
+        for (auto it = j.begin(); it != j.end(); ++it)
+        {
+            auto category = RS2_THREAD_CATEGORY_COUNT;
+            for (int i = 0; i < RS2_THREAD_CATEGORY_COUNT; ++i)
+            {
+                if (it.key() == category_key(static_cast<rs2_thread_category>(i)))
+                    category = static_cast<rs2_thread_category>(i);
+            }
+            if (category == RS2_THREAD_CATEGORY_COUNT)
+                throw invalid_value_exception(to_string() << "unknown thread category \"" << it.key() << "\"");
+
+            auto&& value = it.value();
+            thread_schedule schedule;
+            try
+            {
+                if (value.count("cpus"))
+                    schedule.cpus = value["cpus"].get<std::vector<int>>();
+                if (value.count("priority"))
+                    schedule.priority = value["priority"].get<int>();
+            }
+            catch (const std::exception& e)
+            {
+                throw invalid_value_exception(to_string() << "invalid schedule of \"" << it.key() << "\": " << e.what());
+            }
+            validate(schedule);
+            schedules.emplace_back(category, std::move(schedule));
+        }
+
+        for (auto&& s : schedules)
+            configure(s.first, std::move(s.second));
+    }
+
+    void thread_scheduling::set_cpus(const std::vector<int>& cpus, const char* name)
+    {
+        set_thread_cpus(cpus, name);
+    }
+
+    void thread_scheduling::apply(rs2_thread_category category, const char* name)
+    {
+        set_thread_name(name);
+
+        auto schedule = instance().get(category);
+        if (!schedule.cpus.empty())
+            set_thread_cpus(schedule.cpus, name);
+        if (schedule.priority > 0)
+            set_thread_priority(schedule.priority, name);
+    }
+}
@@ -0,0 +1,47 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "../include/librealsense2/h/rs_types.h"
+
+#include <array>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace librealsense
+{
+    struct thread_schedule
+    {
+        std::vector<int> cpus;  // cores the threads may run on, empty leaves the affinity to the operating system
+        int priority = 0;       // SCHED_FIFO priority from 1 to 99, 0 leaves the scheduling policy of the thread unchanged
+    };
+
+    // Process-wide scheduling of the threads the library starts, per category. A thread applies the schedule
+    // of its category when it starts, so changes reach the threads of the streams started after them.
+    // The initial settings come from the JSON file LRS_THREAD_SCHEDULING points to, if any
+    class thread_scheduling
+    {
+    public:
+        static thread_scheduling& instance();
+
+        void configure(rs2_thread_category category, thread_schedule schedule);
+        thread_schedule get(rs2_thread_category category) const;
+
+        // Object of categories, each with optional "cpus" and "priority", e.g. {"capture": {"cpus": [2, 3], "priority": 80}}
+        void load(const std::string& json);
+
+        // Names the calling thread and applies the schedule of its category, called first thing by the library threads
+        static void apply(rs2_thread_category category, const char* name);
+
+        // Restricts the calling thread to the cores, the name is only used to report failures
+        static void set_cpus(const std::vector<int>& cpus, const char* name);
+
+    private:
+        thread_scheduling();
+
+        mutable std::mutex _mutex;
+        std::array<thread_schedule, RS2_THREAD_CATEGORY_COUNT> _schedules;
+    };
+}
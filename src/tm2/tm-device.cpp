@@ -149,8 +149,10 @@ namespace librealsense
     }
 
     tm2_sensor::tm2_sensor(tm2_device* owner, perc::TrackingDevice* dev)
-        : sensor_base("Tracking Module", owner), _tm_dev(dev), _dispatcher(10)
+        : sensor_base("Tracking Module", owner), _tm_dev(dev), _dispatcher(10), _direct_pose(false)
     {
+        register_option(RS2_OPTION_LOW_LATENCY_POSE, std::make_shared<ptr_option<int>>(0, 1, 1, 0, &_low_latency_pose,
+            "Deliver the poses on the USB thread receiving them, the pose callback must then return quickly. Applied when streaming starts"));
         register_metadata(RS2_FRAME_METADATA_ACTUAL_EXPOSURE, std::make_shared<md_tm2_parser>(RS2_FRAME_METADATA_ACTUAL_EXPOSURE));
         register_metadata(RS2_FRAME_METADATA_TEMPERATURE    , std::make_shared<md_tm2_parser>(RS2_FRAME_METADATA_TEMPERATURE));
         //Replacing md parser for RS2_FRAME_METADATA_TIME_OF_ARRIVAL
@@ -159,6 +161,7 @@ namespace librealsense
 
     tm2_sensor::~tm2_sensor()
     {
+        stop_async_writes();
         if (!_tm_dev)
             return;
 
@@ -560,6 +563,21 @@ namespace librealsense
 
         _dispatcher.start();
         _source.set_callback(callback);
+
+        _pose_profiles.clear();
+        for (auto&& p : get_stream_profiles())
+        {
+            //TODO - assuming single profile per motion stream
+            if (p->get_stream_type() != RS2_STREAM_POSE)
+                continue;
+            auto index = static_cast<size_t>(p->get_stream_index());
+            if (_pose_profiles.size() <= index)
+                _pose_profiles.resize(index + 1);
+            _pose_profiles[index] = p;
+        }
+        _latest_pose.reset();
+        _direct_pose = _low_latency_pose != 0;
+
         raise_on_before_streaming_changes(true);
         auto status = _tm_dev->Start(this, &_tm_active_profiles);
         if (status != Status::SUCCESS)
@@ -589,6 +607,7 @@ namespace librealsense
             throw wrong_api_call_sequence_exception("stop_streaming() failed. TM2 device is not streaming!");
         
         _dispatcher.stop();
+        _source.stop_callback_queues();
         
         if (_loopback)
         {
@@ -604,6 +623,16 @@ namespace librealsense
         _is_streaming = false;
     }
 
+    bool tm2_sensor::get_latest_pose(rs2_pose& pose, rs2_time_t& timestamp) const
+    {
+        timestamped_pose latest;
+        if (!_latest_pose.load(latest))
+            return false;
+        pose = latest.pose;
+        timestamp = latest.timestamp;
+        return true;
+    }
+
     rs2_intrinsics tm2_sensor::get_intrinsics(const stream_profile& profile) const
     {
         rs2_intrinsics result;
@@ -721,6 +750,7 @@ namespace librealsense
         else
         {
             LOG_WARNING("Dropped frame. alloc_frame(...) returned nullptr");
+            report_dropped_frame(*profile);
             return;
         }
         _source.invoke_callback(std::move(frame));
@@ -767,19 +797,21 @@ namespace librealsense
 
         frame_additional_data additional_data(ts_ms.count(), frame_num++, system_ts_ms.count(), sizeof(frame_md), (uint8_t*)&frame_md, tm_frame.arrivalTimeStamp, 0, 0, false);
 
-        // Find the frame stream profile
+        timestamped_pose latest;
+        latest.pose.translation = { tm_frame.translation.x, tm_frame.translation.y, tm_frame.translation.z };
+        latest.pose.velocity = { tm_frame.velocity.x, tm_frame.velocity.y, tm_frame.velocity.z };
+        latest.pose.acceleration = { tm_frame.acceleration.x, tm_frame.acceleration.y, tm_frame.acceleration.z };
+        latest.pose.rotation = { tm_frame.rotation.i, tm_frame.rotation.j, tm_frame.rotation.k, tm_frame.rotation.r };
+        latest.pose.angular_velocity = { tm_frame.angularVelocity.x, tm_frame.angularVelocity.y, tm_frame.angularVelocity.z };
+        latest.pose.angular_acceleration = { tm_frame.angularAcceleration.x, tm_frame.angularAcceleration.y, tm_frame.angularAcceleration.z };
+        latest.pose.tracker_confidence = tm_frame.trackerConfidence;
+        latest.pose.mapper_confidence = tm_frame.mapperConfidence;
+        latest.timestamp = ts_ms.count();
+        _latest_pose.store(latest);
+
         std::shared_ptr<stream_profile_interface> profile = nullptr;
-        auto profiles = get_stream_profiles();
-        for (auto&& p : profiles)
-        {
-            //TODO - assuming single profile per motion stream
-            if (p->get_stream_type() == RS2_STREAM_POSE &&
-                p->get_stream_index() == tm_frame.sourceIndex)
-            {
-                profile = p;
-                break;
-            }
-        }
+        if (tm_frame.sourceIndex < _pose_profiles.size())
+            profile = _pose_profiles[tm_frame.sourceIndex];
         if (profile == nullptr)
         {
             LOG_WARNING("Dropped frame. No valid profile");
@@ -808,6 +840,7 @@ namespace librealsense
         else
         {
             LOG_INFO("Dropped frame. alloc_frame(...) returned nullptr");
+            report_dropped_frame(*profile);
             return;
         }
         _source.invoke_callback(std::move(frame));
@@ -909,6 +942,7 @@ namespace librealsense
         else
         {
             LOG_WARNING("Dropped frame. alloc_frame(...) returned nullptr");
+            report_dropped_frame(*profile);
             return;
         }
         _source.invoke_callback(std::move(frame));
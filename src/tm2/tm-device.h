@@ -8,6 +8,7 @@
 #include "../device.h"
 #include "../core/video.h"
 #include "../core/motion.h"
+#include "../concurrency.h"
 #include "TrackingManager.h"
 #include "../media/playback/playback_device.h"
 
@@ -44,7 +45,7 @@ namespace librealsense
         std::shared_ptr<tm2_sensor> _sensor;
     };
 
-    class tm2_sensor : public sensor_base, public video_sensor_interface, public perc::TrackingDevice::Listener
+    class tm2_sensor : public sensor_base, public video_sensor_interface, public pose_sensor_interface, public perc::TrackingDevice::Listener
     {
     public:
         tm2_sensor(tm2_device* owner, perc::TrackingDevice* dev);
@@ -58,6 +59,7 @@ namespace librealsense
         void stop() override;
         rs2_intrinsics get_intrinsics(const stream_profile& profile) const override;
         rs2_motion_device_intrinsic get_motion_intrinsics(const motion_stream_profile_interface& profile) const;
+        bool get_latest_pose(rs2_pose& pose, rs2_time_t& timestamp) const override;
 
         // Tracking listener
         ////////////////////
@@ -65,6 +67,7 @@ namespace librealsense
         void onAccelerometerFrame(perc::TrackingData::AccelerometerFrame& tm_frame) override;
         void onGyroFrame(perc::TrackingData::GyroFrame& tm_frame) override;
         void onPoseFrame(perc::TrackingData::PoseFrame& tm_frame) override;
+        bool directPoseFrames() override { return _direct_pose; }
         void onControllerDiscoveryEventFrame(perc::TrackingData::ControllerDiscoveryEventFrame& frame) override;
         void onControllerDisconnectedEventFrame(perc::TrackingData::ControllerDisconnectedEventFrame& frame) override;
         void onControllerFrame(perc::TrackingData::ControllerFrame& frame) override;
@@ -90,5 +93,17 @@ namespace librealsense
         std::shared_ptr<playback_device> _loopback;
         perc::TrackingData::Profile _tm_supported_profiles;
         perc::TrackingData::Profile _tm_active_profiles;
+
+        struct timestamped_pose
+        {
+            rs2_pose pose;
+            rs2_time_t timestamp;
+        };
+
+        int _low_latency_pose = 0;
+        std::atomic<bool> _direct_pose;
+        // Indexed by the source of the poses, resolved when streaming starts rather than on every pose
+        std::vector<std::shared_ptr<stream_profile_interface>> _pose_profiles;
+        seqlock<timestamped_pose> _latest_pose;
     };
 }
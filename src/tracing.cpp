@@ -0,0 +1,204 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#include "tracing.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <tuple>
+#include <vector>
+
+namespace librealsense
+{
+    int latency_histogram::bucket_of(uint64_t us)
+    {
+        if (us < sub_buckets)
+            return static_cast<int>(us);
+
+        int exponent = sub_bucket_bits;
+        while (exponent < max_exponent && (us >> (exponent + 1)))
+            ++exponent;
+        if (us >> (max_exponent + 1))
+            return bucket_count - 1;
+
+        auto sub = static_cast<int>(us >> (exponent - sub_bucket_bits)) & (sub_buckets - 1);
+        return (exponent - sub_bucket_bits + 1) * sub_buckets + sub;
+    }
+
+    double latency_histogram::bucket_middle(int bucket)
+    {
+        if (bucket < sub_buckets)
+            return bucket;
+
+        auto shift = bucket / sub_buckets - 1;
+        auto lower = static_cast<uint64_t>(sub_buckets + bucket % sub_buckets) << shift;
+        return lower + (uint64_t(1) << shift) / 2.0;
+    }
+
+    void latency_histogram::record(double ms)
+    {
+        auto us = static_cast<uint64_t>(std::max(ms, 0.) * 1000.);
+
+        _buckets[bucket_of(us)].fetch_add(1, std::memory_order_relaxed);
+        _sum_us.fetch_add(us, std::memory_order_relaxed);
+
+        auto max = _max_us.load(std::memory_order_relaxed);
+        while (us > max && !_max_us.compare_exchange_weak(max, us, std::memory_order_relaxed)) {}
+
+        // Counted last, so readers never see more frames than the buckets hold
+        _count.fetch_add(1, std::memory_order_release);
+    }
+
+    void latency_histogram::reset()
+    {
+        for (auto&& b : _buckets)
+            b.store(0, std::memory_order_relaxed);
+        _count.store(0, std::memory_order_relaxed);
+        _sum_us.store(0, std::memory_order_relaxed);
+        _max_us.store(0, std::memory_order_relaxed);
+    }
+
+    rs2_pipeline_stage_stats latency_histogram::get_stats() const
+    {
+        rs2_pipeline_stage_stats stats{};
+        auto count = _count.load(std::memory_order_acquire);
+        if (!count)
+            return stats;
+
+        auto max_ms = _max_us.load(std::memory_order_relaxed) / 1000.;
+        stats.frames = count;
+        stats.average_latency_ms = static_cast<float>(_sum_us.load(std::memory_order_relaxed) / 1000. / count);
+        stats.max_latency_ms = static_cast<float>(max_ms);
+
+        const std::pair<float rs2_pipeline_stage_stats::*, double> percentiles[] = {
+            { &rs2_pipeline_stage_stats::p50_latency_ms, 0.5 },
+            { &rs2_pipeline_stage_stats::p90_latency_ms, 0.9 },
+            { &rs2_pipeline_stage_stats::p99_latency_ms, 0.99 },
+        };
+
+        uint64_t seen = 0;
+        int next = 0;
+        for (int i = 0; i < bucket_count && next < 3; i++)
+        {
+            seen += _buckets[i].load(std::memory_order_relaxed);
+            while (next < 3 && seen >= percentiles[next].second * count)
+            {
+                stats.*percentiles[next].first = static_cast<float>(std::min(bucket_middle(i) / 1000., max_ms));
+                ++next;
+            }
+        }
+        // Frames recorded while scanning may not have reached their bucket yet
+        for (; next < 3; next++)
+            stats.*percentiles[next].first = stats.max_latency_ms;
+        return stats;
+    }
+
+    pipeline_tracer& pipeline_tracer::get()
+    {
+        static pipeline_tracer instance;
+        return instance;
+    }
+
+    void pipeline_tracer::record(rs2_stream stream, rs2_pipeline_stage stage, unsigned long long frame_number, rs2_time_t arrival, rs2_time_t now)
+    {
+        if (!is_valid(stream) || !is_valid(stage))
+            return;
+
+        auto latency = now - arrival;
+        _histograms[stream][stage].record(latency);
+        if (stream != RS2_STREAM_ANY)
+            _histograms[RS2_STREAM_ANY][stage].record(latency);
+
+        auto n = _next_event.fetch_add(1, std::memory_order_relaxed);
+        auto&& e = _events[n % ring_size];
+        e.sequence.store(2 * n + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        e.frame_number.store(frame_number, std::memory_order_relaxed);
+        e.arrival.store(arrival, std::memory_order_relaxed);
+        e.time.store(now, std::memory_order_relaxed);
+        e.stream_and_stage.store(static_cast<uint32_t>(stream) << 8 | static_cast<uint32_t>(stage), std::memory_order_relaxed);
+        e.sequence.store(2 * n + 2, std::memory_order_release);
+    }
+
+    rs2_pipeline_stage_stats pipeline_tracer::get_stats(rs2_stream stream, rs2_pipeline_stage stage) const
+    {
+        if (!is_valid(stream))
+            throw invalid_value_exception(to_string() << "Invalid stream type " << stream);
+        if (!is_valid(stage))
+            throw invalid_value_exception(to_string() << "Invalid pipeline stage " << stage);
+        return _histograms[stream][stage].get_stats();
+    }
+
+    void pipeline_tracer::reset()
+    {
+        for (auto&& stream : _histograms)
+            for (auto&& h : stream)
+                h.reset();
+        for (auto&& e : _events)
+            e.sequence.store(0, std::memory_order_relaxed);
+    }
+
+    void pipeline_tracer::export_trace(const std::string& file_path) const
+    {
+        struct point { rs2_time_t time; rs2_pipeline_stage stage; };
+        // Events of one frame share the stream, the frame number and the arrival time
+        std::map<std::tuple<rs2_stream, unsigned long long, rs2_time_t>, std::vector<point>> frames;
+
+        for (auto&& e : _events)
+        {
+            auto sequence = e.sequence.load(std::memory_order_acquire);
+            if (!sequence || sequence & 1)
+                continue;
+
+            auto frame_number = e.frame_number.load(std::memory_order_relaxed);
+            auto arrival = e.arrival.load(std::memory_order_relaxed);
+            auto time = e.time.load(std::memory_order_relaxed);
+            auto stream_and_stage = e.stream_and_stage.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (e.sequence.load(std::memory_order_relaxed) != sequence)
+                continue;
+
+            auto stream = static_cast<rs2_stream>(stream_and_stage >> 8);
+            auto stage = static_cast<rs2_pipeline_stage>(stream_and_stage & 0xff);
+            frames[std::make_tuple(stream, frame_number, arrival)].push_back({ time, stage });
+        }
+
+        std::ofstream out(file_path);
+        if (!out)
+            throw io_exception(to_string() << "Could not open " << file_path << " for writing");
+
+        out << std::fixed << std::setprecision(3) << "{\"traceEvents\":[";
+        bool first = true;
+        auto write_event = [&](const char* phase, const std::string& name, rs2_stream stream, int id, rs2_time_t ms)
+        {
+            out << (first ? "\n" : ",\n") << "{\"ph\":\"" << phase << "\",\"name\":\"" << name
+                << "\",\"cat\":\"" << get_string(stream) << "\",\"id\":" << id
+                << ",\"pid\":1,\"tid\":" << static_cast<int>(stream) << ",\"ts\":" << ms * 1000. << "}";
+            first = false;
+        };
+
+        int id = 0;
+        for (auto&& f : frames)
+        {
+            auto stream = std::get<0>(f.first);
+            auto arrival = std::get<2>(f.first);
+            auto&& points = f.second;
+            std::sort(points.begin(), points.end(), [](const point& a, const point& b) { return a.time < b.time; });
+
+            std::string name = to_string() << get_string(stream) << " #" << std::get<1>(f.first);
+            write_event("b", name, stream, id, arrival);
+            auto start = arrival;
+            for (auto&& p : points)
+            {
+                write_event("b", get_string(p.stage), stream, id, start);
+                write_event("e", get_string(p.stage), stream, id, p.time);
+                start = p.time;
+            }
+            write_event("e", name, stream, id, start);
+            ++id;
+        }
+        out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+    }
+}
@@ -0,0 +1,75 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "types.h"
+
+#include <array>
+#include <atomic>
+#include <string>
+
+namespace librealsense
+{
+    // Lock-free histogram of latencies, kept in microseconds with 32 sub-buckets per power of two
+    // (in the manner of HdrHistogram) so percentiles are accurate to about 3% up to two minutes
+    class latency_histogram
+    {
+    public:
+        static const int sub_bucket_bits = 5;
+        static const int sub_buckets = 1 << sub_bucket_bits;
+        static const int max_exponent = 27;
+        static const int bucket_count = (max_exponent - sub_bucket_bits + 2) * sub_buckets;
+
+        latency_histogram() { reset(); }
+
+        void record(double ms);
+        void reset();
+        rs2_pipeline_stage_stats get_stats() const;
+
+        static int bucket_of(uint64_t us);
+        static double bucket_middle(int bucket);
+
+    private:
+        std::array<std::atomic<uint32_t>, bucket_count> _buckets;
+        std::atomic<uint64_t> _count;
+        std::atomic<uint64_t> _sum_us;
+        std::atomic<uint64_t> _max_us;
+    };
+
+    // Always-on latency tracing of the frames coming from sensors. Every stage a frame reaches is added
+    // to the histograms of its stream and of RS2_STREAM_ANY, and to a ring of recent events for trace export
+    class pipeline_tracer
+    {
+    public:
+        static pipeline_tracer& get();
+
+        // arrival and now are system times in milliseconds, as in frame_additional_data::system_time
+        void record(rs2_stream stream, rs2_pipeline_stage stage, unsigned long long frame_number, rs2_time_t arrival, rs2_time_t now);
+
+        rs2_pipeline_stage_stats get_stats(rs2_stream stream, rs2_pipeline_stage stage) const;
+        void reset();
+
+        // Chrome trace event format, one asynchronous slice per frame nesting one slice per stage
+        void export_trace(const std::string& file_path) const;
+
+    private:
+        pipeline_tracer() = default;
+
+        static const size_t ring_size = 8192;
+
+        struct trace_event
+        {
+            // Odd while the event is being written, the readers skip events that change under them
+            std::atomic<uint64_t> sequence;
+            std::atomic<uint64_t> frame_number;
+            std::atomic<double> arrival;
+            std::atomic<double> time;
+            std::atomic<uint32_t> stream_and_stage;
+        };
+
+        std::array<std::array<latency_histogram, RS2_PIPELINE_STAGE_COUNT>, RS2_STREAM_COUNT> _histograms;
+        std::array<trace_event, ring_size> _events;
+        std::atomic<uint64_t> _next_event{ 0 };
+    };
+}
@@ -178,6 +178,7 @@ namespace librealsense
             CASE(TM2)
             CASE(SOFTWARE_DEVICE)
             CASE(SOFTWARE_SENSOR)
+            CASE(POSE_SENSOR)
         default: assert(!is_valid(value)); return UNKNOWN_VALUE;
         }
 #undef CASE
@@ -197,6 +198,48 @@ namespace librealsense
 #undef CASE
     }
 
+    const char* get_string(rs2_record_write_policy value)
+    {
+#define CASE(X) STRCASE(RECORD_WRITE_POLICY, X)
+        switch (value)
+        {
+            CASE(DROP)
+            CASE(BLOCK)
+        default: assert(!is_valid(value)); return UNKNOWN_VALUE;
+        }
+#undef CASE
+    }
+
+    const char* get_string(rs2_frame_control_state value)
+    {
+#define CASE(X) STRCASE(FRAME_CONTROL_STATE, X)
+        switch (value)
+        {
+            CASE(APPLIED)
+            CASE(WRITTEN)
+            CASE(SUPERSEDED)
+            CASE(NOT_CONFIRMED)
+            CASE(FAILED)
+        default: assert(!is_valid(value)); return UNKNOWN_VALUE;
+        }
+#undef CASE
+    }
+
+    const char* get_string(rs2_pipeline_stage value)
+    {
+#define CASE(X) STRCASE(PIPELINE_STAGE, X)
+        switch (value)
+        {
+            CASE(PUBLISHED)
+            CASE(UNPACKED)
+            CASE(SYNCED)
+            CASE(DISPATCHED)
+            CASE(RELEASED)
+        default: assert(!is_valid(value)); return UNKNOWN_VALUE;
+        }
+#undef CASE
+    }
+
     const char* get_string(rs2_log_severity value)
     {
 #define CASE(X) STRCASE(LOG_SEVERITY, X)
@@ -265,6 +308,44 @@ namespace librealsense
             CASE(STREAM_FORMAT_FILTER)
             CASE(STREAM_INDEX_FILTER)
             CASE(EMITTER_ON_OFF)
+            CASE(FRAME_POOL_HITS)
+            CASE(FRAME_POOL_MISSES)
+            CASE(MAX_BORROWED_FRAMES)
+            CASE(PROCESSING_THREADS)
+            CASE(SPARSE_POINTCLOUD)
+            CASE(POINTCLOUD_STRIDE)
+            CASE(HISTOGRAM_EQUALIZATION_INTERVAL)
+            CASE(GLOBAL_TIME_ENABLED)
+            CASE(AUTO_EXPOSURE_SAMPLE_STRIDE)
+            CASE(AUTO_EXPOSURE_SKIP_FRAMES)
+            CASE(SYNC_MATCH_KEY)
+            CASE(FRAMES_DROPPED)
+            CASE(FRAMES_QUEUE_MEMORY_LIMIT)
+            CASE(LOW_LATENCY_POSE)
+            CASE(DISPARITY_FIXED_POINT)
+            CASE(LAZY_UNPACKING)
+            CASE(CROP_LEFT)
+            CASE(CROP_TOP)
+            CASE(CROP_RIGHT)
+            CASE(CROP_BOTTOM)
+            CASE(VOXEL_SIZE)
+            CASE(NORMAL_MAX_DEPTH_CHANGE)
+            CASE(KERNEL_BUFFERS)
+            CASE(BUFFERING_POLICY)
+            CASE(POINTCLOUD_COLORS)
+            CASE(POINTCLOUD_WORLD_FRAME)
+            CASE(CALLBACK_QUEUE_SIZE)
+        CASE(RATE_DIVISOR)
+        CASE(TARGET_FPS)
+        CASE(TSDF_TRUNCATION_DISTANCE)
+        CASE(TSDF_MAX_WEIGHT)
+        CASE(MESH_MAX_DEPTH_STEP)
+        CASE(POINTCLOUD_TILE_TOLERANCE)
+        CASE(GRID_CELL_SIZE)
+        CASE(GRID_CELLS)
+        CASE(GRID_OCCUPANCY)
+        CASE(OBSTACLE_MIN_HEIGHT)
+        CASE(OBSTACLE_MAX_HEIGHT)
         default: assert(!is_valid(value)); return UNKNOWN_VALUE;
         }
 #undef CASE
@@ -279,6 +360,13 @@ namespace librealsense
             CASE(Z16)
             CASE(DISPARITY16)
             CASE(DISPARITY32)
+            CASE(Y8I)
+            CASE(Z16_RVL)
+            CASE(MJPEG)
+            CASE(MESH_INDICES)
+            CASE(DEPTH_STATISTICS)
+            CASE(HEIGHT_MAP)
+            CASE(OCCUPANCY_GRID)
             CASE(XYZ32F)
             CASE(YUYV)
             CASE(RGB8)
@@ -382,6 +470,7 @@ namespace librealsense
         {
             CASE(HARDWARE_CLOCK)
             CASE(SYSTEM_TIME)
+            CASE(GLOBAL_TIME)
         default: assert(!is_valid(value)); return UNKNOWN_VALUE;
         }
 #undef CASE
@@ -398,6 +487,7 @@ namespace librealsense
             CASE(HARDWARE_EVENT)
             CASE(UNKNOWN_ERROR)
             CASE(FIRMWARE_UPDATE_RECOMMENDED)
+            CASE(FRAMES_DROPPED)
         default: assert(!is_valid(value)); return UNKNOWN_VALUE;
         }
 #undef CASE
@@ -415,6 +505,59 @@ namespace librealsense
         default: assert(!is_valid(value)); return UNKNOWN_VALUE;
         }
 
+#undef CASE
+    }
+    const char* get_string(rs2_frame_queue_policy value)
+    {
+#define CASE(X) STRCASE(FRAME_QUEUE_POLICY, X)
+        switch (value)
+        {
+            CASE(MUTEX)
+            CASE(LOCK_FREE)
+        default: assert(!is_valid(value)); return UNKNOWN_VALUE;
+        }
+#undef CASE
+    }
+
+    const char* get_string(rs2_broadcast_policy value)
+    {
+#define CASE(X) STRCASE(BROADCAST_POLICY, X)
+        switch (value)
+        {
+            CASE(DROP_OLDEST)
+            CASE(BLOCK)
+        default: assert(!is_valid(value)); return UNKNOWN_VALUE;
+        }
+#undef CASE
+    }
+
+    const char* get_string(rs2_thread_category value)
+    {
+#define CASE(X) STRCASE(THREAD_CATEGORY, X)
+        switch (value)
+        {
+            CASE(CAPTURE)
+            CASE(HID)
+            CASE(DISPATCHER)
+            CASE(PLAYBACK)
+        default: assert(!is_valid(value)); return UNKNOWN_VALUE;
+        }
+#undef CASE
+    }
+
+    const char* get_string(rs2_frame_drop_reason value)
+    {
+#define CASE(X) STRCASE(FRAME_DROP_REASON, X)
+        switch (value)
+        {
+            CASE(CAPTURE)
+            CASE(INCOMPLETE)
+            CASE(DEVICE)
+            CASE(MEMORY)
+            CASE(QUEUE)
+            CASE(SYNC)
+        default: assert(!is_valid(value)); return UNKNOWN_VALUE;
+        }
 #undef CASE
     }
     std::string firmware_version::to_string() const
@@ -578,15 +721,15 @@ namespace librealsense
     void notifications_processor::set_callback(notifications_callback_ptr callback)
     {
 
+        // Stopping waits for a notification in progress, the previous callback is not invoked after this returns
         _dispatcher.stop();
 
-        std::lock_guard<std::mutex> lock(_callback_mutex);
-        _callback = std::move(callback);
+        std::atomic_store(&_callback, std::move(callback));
         _dispatcher.start();
     }
     notifications_callback_ptr notifications_processor::get_callback() const
     {
-        return _callback;
+        return std::atomic_load(&_callback);
     }
 
     void copy(void* dst, void const* src, size_t size)
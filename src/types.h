@@ -21,6 +21,7 @@
 #include <vector>                           // For vector
 #include <sstream>                          // For ostringstream
 #include <mutex>                            // For mutex, unique_lock
+#include <atomic>                           // For atomic
 #include <memory>                           // For unique_ptr
 #include <map>
 #include <limits>
@@ -129,14 +130,24 @@ namespace librealsense
 
     void log_to_console(rs2_log_severity min_severity);
     void log_to_file(rs2_log_severity min_severity, const char * file_path);
+    // Writes the last lines sent to the console or to the log file
+    void dump_log_history(const char * file_path);
+    // Messages are formatted only when some log destination accepts their severity
+    bool is_log_enabled(rs2_log_severity severity);
+    bool is_debug_log_enabled();
+    // Queues a formatted message, the logging thread writes it. Fatal messages are written by the caller
+    void log_message(rs2_log_severity severity, const char * file, int line, std::string&& message);
 
 #if BUILD_EASYLOGGINGPP
 
-#define LOG_DEBUG(...)   do { CLOG(DEBUG   ,"librealsense") << __VA_ARGS__; } while(false)
-#define LOG_INFO(...)    do { CLOG(INFO    ,"librealsense") << __VA_ARGS__; } while(false)
-#define LOG_WARNING(...) do { CLOG(WARNING ,"librealsense") << __VA_ARGS__; } while(false)
-#define LOG_ERROR(...)   do { CLOG(ERROR   ,"librealsense") << __VA_ARGS__; } while(false)
-#define LOG_FATAL(...)   do { CLOG(FATAL   ,"librealsense") << __VA_ARGS__; } while(false)
+#define LRS_LOG(SEVERITY, ...) do { if (librealsense::is_log_enabled(SEVERITY)) { std::ostringstream log_ss; log_ss << __VA_ARGS__; \
+                                    librealsense::log_message(SEVERITY, __FILE__, __LINE__, log_ss.str()); } } while(false)
+
+#define LOG_DEBUG(...)   LRS_LOG(RS2_LOG_SEVERITY_DEBUG, __VA_ARGS__)
+#define LOG_INFO(...)    LRS_LOG(RS2_LOG_SEVERITY_INFO,  __VA_ARGS__)
+#define LOG_WARNING(...) LRS_LOG(RS2_LOG_SEVERITY_WARN,  __VA_ARGS__)
+#define LOG_ERROR(...)   LRS_LOG(RS2_LOG_SEVERITY_ERROR, __VA_ARGS__)
+#define LOG_FATAL(...)   LRS_LOG(RS2_LOG_SEVERITY_FATAL, __VA_ARGS__)
 
 #else // BUILD_EASYLOGGINGPP
 
@@ -325,17 +336,10 @@ namespace librealsense
         lazy(lazy&& other) noexcept
         {
             std::lock_guard<std::mutex> lock(other._mtx);
-            if (!other._was_init)
-            {
-                _init = move(other._init);
-                _was_init = false;
-            }
-            else
-            {
-                _init = move(other._init);
-                _was_init = true;
-                _ptr = move(other._ptr);
-            }
+            _init = move(other._init);
+            _ptr = move(other._ptr);
+            _value.store(_ptr.get(), std::memory_order_release);
+            other._value.store(nullptr, std::memory_order_release);
         }
 
         lazy& operator=(std::function<T()> func) noexcept
@@ -343,21 +347,18 @@ namespace librealsense
             return *this = lazy<T>(std::move(func));
         }
 
+        // Replaces the value, which the pointers handed out before no longer refer to
         lazy& operator=(lazy&& other) noexcept
         {
+            if (this == &other)
+                return *this;
+
             std::lock_guard<std::mutex> lock1(_mtx);
             std::lock_guard<std::mutex> lock2(other._mtx);
-            if (!other._was_init)
-            {
-                _init = move(other._init);
-                _was_init = false;
-            }
-            else
-            {
-                _init = move(other._init);
-                _was_init = true;
-                _ptr = move(other._ptr);
-            }
+            _init = move(other._init);
+            _ptr = move(other._ptr);
+            _value.store(_ptr.get(), std::memory_order_release);
+            other._value.store(nullptr, std::memory_order_release);
 
             return *this;
         }
@@ -365,17 +366,22 @@ namespace librealsense
     private:
         T* operate() const
         {
+            // Published once initialized, and swapped under the lock by a reassignment, so the reads of an
+            // initialized value take no lock and never see the value being replaced half way
+            if (auto value = _value.load(std::memory_order_acquire))
+                return value;
+
             std::lock_guard<std::mutex> lock(_mtx);
-            if (!_was_init)
+            if (!_ptr)
             {
                 _ptr = std::unique_ptr<T>(new T(_init()));
-                _was_init = true;
+                _value.store(_ptr.get(), std::memory_order_release);
             }
             return _ptr.get();
         }
 
         mutable std::mutex _mtx;
-        mutable bool _was_init = false;
+        mutable std::atomic<T*> _value{ nullptr };
         std::function<T()> _init;
         mutable std::unique_ptr<T> _ptr;
     };
@@ -446,7 +452,14 @@ namespace librealsense
     RS2_ENUM_HELPERS(rs2_log_severity, LOG_SEVERITY)
     RS2_ENUM_HELPERS(rs2_notification_category, NOTIFICATION_CATEGORY)
     RS2_ENUM_HELPERS(rs2_playback_status, PLAYBACK_STATUS)
+    RS2_ENUM_HELPERS(rs2_record_write_policy, RECORD_WRITE_POLICY)
+    RS2_ENUM_HELPERS(rs2_frame_control_state, FRAME_CONTROL_STATE)
+    RS2_ENUM_HELPERS(rs2_pipeline_stage, PIPELINE_STAGE)
     RS2_ENUM_HELPERS(rs2_matchers, MATCHER)
+    RS2_ENUM_HELPERS(rs2_frame_queue_policy, FRAME_QUEUE_POLICY)
+    RS2_ENUM_HELPERS(rs2_broadcast_policy, BROADCAST_POLICY)
+    RS2_ENUM_HELPERS(rs2_thread_category, THREAD_CATEGORY)
+    RS2_ENUM_HELPERS(rs2_frame_drop_reason, FRAME_DROP_REASON)
     ////////////////////////////////////////////
     // World's tiniest linear algebra library //
     ////////////////////////////////////////////
@@ -748,13 +761,15 @@ namespace librealsense
         R reader;
         W writer;
         bool active;
+        bool dirty;
 
-        struct_interface(R r, W w) : reader(r), writer(w), active(false) {}
+        struct_interface(R r, W w) : reader(r), writer(w), active(false), dirty(false) {}
 
         void activate() { if (!active) { struct_ = reader(); active = true; } }
         template<class U> double get(U T::* field) { activate(); return static_cast<double>(struct_.*field); }
-        template<class U, class V> void set(U T::* field, V value) { activate(); struct_.*field = static_cast<U>(value); }
-        void commit() { if (active) writer(struct_); }
+        template<class U, class V> void set(U T::* field, V value) { activate(); struct_.*field = static_cast<U>(value); dirty = true; }
+        // Writes the structure once for all the fields set since the last commit
+        void commit() { if (active && dirty) { writer(struct_); dirty = false; } }
     };
 
     template<class T, class R, class W>
@@ -854,6 +869,35 @@ namespace librealsense
         void release() override { delete this; }
     };
 
+    class frame_allocator : public rs2_frame_allocator
+    {
+        rs2_frame_allocate_ptr alloc_ptr;
+        rs2_frame_deallocate_ptr dealloc_ptr;
+        void * user;
+    public:
+        frame_allocator(rs2_frame_allocate_ptr alloc, rs2_frame_deallocate_ptr dealloc, void * user)
+            : alloc_ptr(alloc), dealloc_ptr(dealloc), user(user) {}
+
+        void* allocate(size_t size) override
+        {
+            try { return alloc_ptr(static_cast<int>(size), user); }
+            catch (...)
+            {
+                LOG_ERROR("Received an execption from frame allocator!");
+            }
+            return nullptr;
+        }
+        void deallocate(void* buffer, size_t size) override
+        {
+            try { dealloc_ptr(buffer, static_cast<int>(size), user); }
+            catch (...)
+            {
+                LOG_ERROR("Received an execption from frame deallocator!");
+            }
+        }
+        void release() override { delete this; }
+    };
+
     typedef void(*notifications_callback_function_ptr)(rs2_notification * notification, void * user);
 
     class notifications_callback : public rs2_notifications_callback
@@ -907,6 +951,7 @@ namespace librealsense
     typedef std::shared_ptr<rs2_frame_processor_callback> frame_processor_callback_ptr;
     typedef std::shared_ptr<rs2_notifications_callback> notifications_callback_ptr;
     typedef std::shared_ptr<rs2_devices_changed_callback> devices_changed_callback_ptr;
+    typedef std::shared_ptr<rs2_frame_allocator> frame_allocator_ptr;
 
     using internal_callback = std::function<void(rs2_device_list* removed, rs2_device_list* added)>;
     class devices_changed_callback_internal : public rs2_devices_changed_callback
@@ -963,8 +1008,7 @@ namespace librealsense
         void raise_notification(const notification);
 
     private:
-        notifications_callback_ptr _callback;
-        std::mutex _callback_mutex;
+        notifications_callback_ptr _callback;   // Read and replaced atomically, the dispatch path takes no lock
         dispatcher _dispatcher;
     };
     ////////////////////////////////////////
@@ -1281,45 +1325,49 @@ namespace librealsense
         frame_continuation(const frame_continuation &) = delete;
         frame_continuation & operator=(const frame_continuation &) = delete;
     public:
-        frame_continuation() : continuation([]() {}) {}
+        // An empty continuation holds no callable, so that the frames without one don't pay for assigning it
+        frame_continuation() {}
 
-        explicit frame_continuation(std::function<void()> continuation, const void* protected_data) : continuation(continuation), protected_data(protected_data) {}
+        explicit frame_continuation(std::function<void()> continuation, const void* protected_data) : continuation(std::move(continuation)), protected_data(protected_data) {}
 
 
         frame_continuation(frame_continuation && other) : continuation(std::move(other.continuation)), protected_data(other.protected_data)
         {
-            other.continuation = []() {};
+            other.continuation = nullptr;
             other.protected_data = nullptr;
         }
 
         void operator()()
         {
-            continuation();
-            continuation = []() {};
+            if (continuation)
+            {
+                continuation();
+                continuation = nullptr;
+            }
             protected_data = nullptr;
         }
 
         void reset()
         {
             protected_data = nullptr;
-            continuation = [](){};
+            continuation = nullptr;
         }
 
         const void* get_data() const { return protected_data; }
 
         frame_continuation & operator=(frame_continuation && other)
         {
-            continuation();
+            if (continuation) continuation();
             protected_data = other.protected_data;
-            continuation = other.continuation;
-            other.continuation = []() {};
+            continuation = std::move(other.continuation);
+            other.continuation = nullptr;
             other.protected_data = nullptr;
             return *this;
         }
 
         ~frame_continuation()
         {
-            continuation();
+            if (continuation) continuation();
         }
 
     };
@@ -1422,50 +1470,53 @@ namespace librealsense
     };
 
 
+    // Subscribers are kept in an immutable list, replaced as a whole by subscribe and unsubscribe.
+    // Raising takes a reference to the current list, it never waits for the writers or for other raises
     template<typename HostingClass, typename... Args>
     class signal
     {
         friend HostingClass;
+        typedef std::vector<std::pair<int, std::function<void(Args...)>>> subscribers;
     public:
         signal()
+            : m_subscribers(std::make_shared<const subscribers>())
         {
         }
 
         signal(signal&& other)
+            : m_subscribers(other.take())
         {
-            std::lock_guard<std::mutex> locker(other.m_mutex);
-            m_subscribers = std::move(other.m_subscribers);
-
-            other.m_subscribers.clear();
         }
 
         signal& operator=(signal&& other)
         {
-            std::lock_guard<std::mutex> locker(other.m_mutex);
-            m_subscribers = std::move(other.m_subscribers);
-
-            other.m_subscribers.clear();
+            auto moved = other.take();
+            std::lock_guard<std::mutex> locker(m_mutex);
+            std::atomic_store(&m_subscribers, moved);
             return *this;
         }
 
         int subscribe(const std::function<void(Args...)>& func)
         {
             std::lock_guard<std::mutex> locker(m_mutex);
+            auto current = std::atomic_load(&m_subscribers);
 
-            int token = -1;
-            for (int i = 0; i < (std::numeric_limits<int>::max)(); i++)
+            // The list is sorted by token, the first gap is the lowest free token
+            int token = 0;
+            auto it = current->begin();
+            for (; it != current->end() && it->first == token; ++it)
             {
-                if (m_subscribers.find(i) == m_subscribers.end())
-                {
-                    token = i;
-                    break;
-                }
+                if (token == (std::numeric_limits<int>::max)())
+                    return -1;
+                ++token;
             }
 
-            if (token != -1)
-            {
-                m_subscribers.emplace(token, func);
-            }
+            auto next = std::make_shared<subscribers>();
+            next->reserve(current->size() + 1);
+            next->insert(next->end(), current->begin(), it);
+            next->emplace_back(token, func);
+            next->insert(next->end(), it, current->end());
+            std::atomic_store(&m_subscribers, std::shared_ptr<const subscribers>(std::move(next)));
 
             return token;
         }
@@ -1473,16 +1524,20 @@ namespace librealsense
         bool unsubscribe(int token)
         {
             std::lock_guard<std::mutex> locker(m_mutex);
+            auto current = std::atomic_load(&m_subscribers);
 
-            bool retVal = false;
-            typename std::map<int, std::function<void(Args...)>>::iterator it = m_subscribers.find(token);
-            if (it != m_subscribers.end())
-            {
-                m_subscribers.erase(token);
-                retVal = true;
-            }
+            auto it = std::find_if(current->begin(), current->end(),
+                [token](const typename subscribers::value_type& s) { return s.first == token; });
+            if (it == current->end())
+                return false;
 
-            return retVal;
+            auto next = std::make_shared<subscribers>();
+            next->reserve(current->size() - 1);
+            next->insert(next->end(), current->begin(), it);
+            next->insert(next->end(), std::next(it), current->end());
+            std::atomic_store(&m_subscribers, std::shared_ptr<const subscribers>(std::move(next)));
+
+            return true;
         }
 
         int operator+=(const std::function<void(Args...)>& func)
@@ -1499,34 +1554,24 @@ namespace librealsense
         signal(const signal& other);            // non construction-copyable
         signal& operator=(const signal&);       // non copyable
 
-        bool raise(Args... args)
+        std::shared_ptr<const subscribers> take()
         {
-            std::vector<std::function<void(Args...)>> functions;
-            bool retVal = false;
+            std::lock_guard<std::mutex> locker(m_mutex);
+            return std::atomic_exchange(&m_subscribers, std::make_shared<const subscribers>());
+        }
 
-            std::unique_lock<std::mutex> locker(m_mutex);
-            if (m_subscribers.size() > 0)
-            {
-                typename std::map<int, std::function<void(Args...)>>::iterator it = m_subscribers.begin();
-                while (it != m_subscribers.end())
-                {
-                    functions.emplace_back(it->second);
-                    ++it;
-                }
-            }
-            locker.unlock();
+        // Subscribers removed during the raise may still be invoked by it, like with the copy it used to take
+        bool raise(Args... args)
+        {
+            auto functions = std::atomic_load(&m_subscribers);
+            if (functions->empty())
+                return false;
 
-            if (functions.size() > 0)
+            for (auto&& s : *functions)
             {
-                for (auto func : functions)
-                {
-                    func(std::forward<Args>(args)...);
-                }
-
-                retVal = true;
+                s.second(std::forward<Args>(args)...);
             }
-
-            return retVal;
+            return true;
         }
 
         bool operator()(Args... args)
@@ -1534,8 +1579,8 @@ namespace librealsense
             return raise(std::forward<Args>(args)...);
         }
 
-        std::mutex m_mutex;
-        std::map<int, std::function<void(Args...)>> m_subscribers;
+        std::mutex m_mutex;     // Serializes the writers of the list
+        std::shared_ptr<const subscribers> m_subscribers;
     };
 
     template <typename T>
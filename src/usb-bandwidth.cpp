@@ -0,0 +1,132 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#include "usb-bandwidth.h"
+#include "sensor.h"
+#include "image.h"
+#include "core/video.h"
+
+#include <algorithm>
+#include <cctype>
+
+namespace librealsense
+{
+    uint64_t get_usb_link_capacity(platform::usb_spec spec)
+    {
+        // What's left of the signalling rate once the protocol takes its share, with the isochronous and bulk
+        // transfers of a few cameras on the same link
+        if (spec >= platform::usb3_type)
+            return 400000000;   // 5 Gbps, SuperSpeed on the ports the devices negotiate
+        if (spec >= platform::usb2_type)
+            return 40000000;    // 480 Mbps
+        if (spec >= platform::usb1_type)
+            return 1000000;     // 12 Mbps
+        return 0;
+    }
+
+    std::string get_usb_root_port(const std::string& device_path)
+    {
+        // The sysfs path of a device lists the USB tree down to it, e.g. .../usb2/2-3/2-3.1/2-3.1:1.0/..., where the
+        // first "<bus>-<port>" entry after the root hub is the root port
+        size_t begin = 0;
+        while (begin < device_path.size())
+        {
+            auto end = device_path.find('/', begin);
+            if (end == std::string::npos)
+                end = device_path.size();
+            auto entry = device_path.substr(begin, end - begin);
+            begin = end + 1;
+
+            auto dash = entry.find('-');
+            if (dash == 0 || dash == std::string::npos || dash + 1 >= entry.size())
+                continue;
+            if (!std::all_of(entry.begin(), entry.begin() + dash, [](char c) { return isdigit(static_cast<unsigned char>(c)) != 0; }))
+                continue;
+            auto port_end = entry.find_first_not_of("0123456789", dash + 1);
+            if (port_end == dash + 1)
+                continue;
+            return entry.substr(0, port_end);
+        }
+        return "";
+    }
+
+    uint64_t estimate_bandwidth(const stream_profile_interface& profile)
+    {
+        auto vid = dynamic_cast<const video_stream_profile_interface*>(&profile);
+        if (!vid || profile.get_format() == RS2_FORMAT_ANY)
+            return 0; // motion streams are too small to matter
+        return static_cast<uint64_t>(get_image_size(vid->get_width(), vid->get_height(), profile.get_format())) * profile.get_framerate();
+    }
+
+    uint64_t estimate_bandwidth(const sensor_interface& sensor, const std::vector<std::shared_ptr<stream_profile_interface>>& profiles)
+    {
+        if (auto base = dynamic_cast<const sensor_base*>(&sensor))
+            return base->get_bandwidth(profiles);
+
+        uint64_t total = 0;
+        for (auto&& p : profiles)
+            total += estimate_bandwidth(*p);
+        return total;
+    }
+
+    usb_bandwidth_planner& usb_bandwidth_planner::instance()
+    {
+        static usb_bandwidth_planner planner;
+        return planner;
+    }
+
+    void usb_bandwidth_planner::reserve(const void* owner, const std::string& port, uint64_t bytes_per_second)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _reservations[owner] = { port, bytes_per_second };
+    }
+
+    void usb_bandwidth_planner::release(const void* owner)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _reservations.erase(owner);
+    }
+
+    uint64_t usb_bandwidth_planner::get_reserved(const std::string& port, const std::vector<const void*>& excluded) const
+    {
+        if (port.empty())
+            return 0;
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        uint64_t total = 0;
+        for (auto&& r : _reservations)
+        {
+            if (r.second.port == port && std::find(excluded.begin(), excluded.end(), r.first) == excluded.end())
+                total += r.second.bytes_per_second;
+        }
+        return total;
+    }
+
+    bool usb_bandwidth_planner::get_available(device_interface& dev, float utilization, uint64_t& available) const
+    {
+        std::string port;
+        uint64_t capacity = 0;
+        std::vector<const void*> own;
+        for (size_t i = 0; i < dev.get_sensors_count(); ++i)
+        {
+            auto&& sensor = dev.get_sensor(i);
+            own.push_back(&sensor);
+            if (auto uvc = dynamic_cast<uvc_sensor*>(&sensor))
+            {
+                // The slowest sensor of the device bounds the link, a USB2 link reports the lower specification
+                auto sensor_capacity = get_usb_link_capacity(uvc->get_usb_specification());
+                if (sensor_capacity && (!capacity || sensor_capacity < capacity))
+                    capacity = sensor_capacity;
+                if (port.empty())
+                    port = get_usb_root_port(uvc->get_device_path());
+            }
+        }
+        if (!capacity)
+            return false;
+
+        auto usable = static_cast<uint64_t>(capacity * static_cast<double>(utilization));
+        auto reserved = get_reserved(port, own);
+        available = usable > reserved ? usable - reserved : 0;
+        return true;
+    }
+}
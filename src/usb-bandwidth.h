@@ -0,0 +1,65 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "backend.h"
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace librealsense
+{
+    class device_interface;
+    class sensor_interface;
+    class stream_profile_interface;
+
+    // Payload a link of the USB specification carries in practice, bytes per second. 0 when the specification is
+    // unknown, such as for devices that don't stream over USB
+    uint64_t get_usb_link_capacity(platform::usb_spec spec);
+
+    // The root port a device is connected through, as "<bus>-<port>". Devices behind the same root port, through
+    // hubs or not, share its bandwidth. Empty when the path of the device doesn't tell, the device then gets a link
+    // of its own
+    std::string get_usb_root_port(const std::string& device_path);
+
+    // Payload of a stream profile in its own format, bytes per second, for streams whose native format is unknown
+    uint64_t estimate_bandwidth(const stream_profile_interface& profile);
+
+    // Bandwidth of the profiles of a sensor together, from their native formats when the sensor knows them
+    uint64_t estimate_bandwidth(const sensor_interface& sensor, const std::vector<std::shared_ptr<stream_profile_interface>>& profiles);
+
+    // Process-wide record of the bandwidth taken by the open sensors on every root port
+    class usb_bandwidth_planner
+    {
+    public:
+        static usb_bandwidth_planner& instance();
+
+        // Replaces what the owner reserved before. Sensors reserve as their sensor_interface
+        void reserve(const void* owner, const std::string& port, uint64_t bytes_per_second);
+        void release(const void* owner);
+
+        // What's reserved on a port by all but the given owners
+        uint64_t get_reserved(const std::string& port, const std::vector<const void*>& excluded = {}) const;
+
+        // The bandwidth a device has left on its link for new streams, the fraction of the link capacity given
+        // by the utilization, less what the other open sensors on the same root port take. The sensors of the
+        // device itself are not counted against it. False when the link of the device is unknown
+        bool get_available(device_interface& dev, float utilization, uint64_t& available) const;
+
+    private:
+        usb_bandwidth_planner() = default;
+
+        struct reservation
+        {
+            std::string port;
+            uint64_t bytes_per_second;
+        };
+
+        mutable std::mutex _mutex;
+        std::map<const void*, reservation> _reservations;
+    };
+}
@@ -40,7 +40,14 @@ namespace librealsense
         public:
             virtual ~sensor_events() = default;
 
-            explicit sensor_events(hid_callback callback) : m_cRef(0), _callback(callback) {}
+            // A sink per sensor, which knows the type and name of its sensor instead of querying them on every report
+            sensor_events(hid_callback callback, const std::string& name, const SENSOR_TYPE_ID& type)
+                : m_cRef(0), _callback(callback), _type(type)
+            {
+                _data.sensor.name = name;
+                _data.fo.metadata_size = HID_METADATA_SIZE;
+                _data.fo.frame_size = sizeof(hid_sensor_data);
+            }
 
             STDMETHODIMP QueryInterface(REFIID iid, void** ppv)
             {
@@ -105,10 +112,6 @@ namespace librealsense
                     return E_INVALIDARG;
                 }
 
-                BSTR fName{};
-                SYSTEMTIME time;
-                report->GetTimestamp(&time);
-
                 PROPVARIANT var = {};
                 // Custom timestamp low
                 auto hr = (report->GetSensorValue(SENSOR_DATA_TYPE_CUSTOM_VALUE1, &var));
@@ -119,16 +122,9 @@ namespace librealsense
                 CHECK_HR(report->GetSensorValue(SENSOR_DATA_TYPE_CUSTOM_VALUE2, &var));
                 auto customTimestampHigh = var.ulVal;
 
-                /* Retrieve sensor type - Sensor types are more specific groupings than sensor categories. Sensor type IDs are GUIDs that are defined in Sensors.h */
-
-                SENSOR_TYPE_ID type{};
-
-                CHECK_HR(pSensor->GetType(&type));
-
                 double rawX, rawY, rawZ;
 
-
-                if (type == SENSOR_TYPE_ACCELEROMETER_3D)
+                if (_type == SENSOR_TYPE_ACCELEROMETER_3D)
                 {
                     CHECK_HR(report->GetSensorValue(SENSOR_DATA_TYPE_ACCELERATION_X_G, &var));
                     rawX = var.dblVal;
@@ -145,7 +141,7 @@ namespace librealsense
                     rawY *= accelerator_transform_factor;
                     rawZ *= accelerator_transform_factor;
                 }
-                else if (type == SENSOR_TYPE_GYROMETER_3D)
+                else if (_type == SENSOR_TYPE_GYROMETER_3D)
                 {
                     // Raw X
                     CHECK_HR(report->GetSensorValue(SENSOR_DATA_TYPE_ANGULAR_VELOCITY_X_DEGREES_PER_SECOND, &var));
@@ -173,7 +169,6 @@ namespace librealsense
 
                 PropVariantClear(&var);
 
-                sensor_data d;
                 hid_sensor_data data;
 
                 data.x = rawX;
@@ -182,14 +177,9 @@ namespace librealsense
                 data.ts_low = customTimestampLow;
                 data.ts_high = customTimestampHigh;
 
-                pSensor->GetFriendlyName(&fName);
-                d.sensor.name = CW2A(fName);
-
-                d.fo.pixels = &data;
-                d.fo.metadata = &data.ts_low;
-                d.fo.metadata_size = HID_METADATA_SIZE;
-                d.fo.frame_size = sizeof(data);
-                _callback(d);
+                _data.fo.pixels = &data;
+                _data.fo.metadata = &data.ts_low;
+                _callback(_data);
 
                 return S_OK;
             }
@@ -235,6 +225,8 @@ namespace librealsense
         private:
             long m_cRef;
             hid_callback _callback;
+            SENSOR_TYPE_ID _type;
+            sensor_data _data; // Reports of a sensor arrive one at a time
         };
 
         void wmf_hid_device::open(const std::vector<hid_profile>&iio_profiles)
@@ -296,14 +288,11 @@ namespace librealsense
 
         void wmf_hid_device::start_capture(hid_callback callback)
         {
-            // Hack, start default profile
-            _cb = new sensor_events(callback);
-            ISensorEvents* sensorEvents = nullptr;
-            CHECK_HR(_cb->QueryInterface(IID_PPV_ARGS(&sensorEvents)));
-
             for (auto& sensor : _opened_sensors)
             {
-                CHECK_HR(sensor->start_capture(sensorEvents));
+                CComPtr<ISensorEvents> sink = new sensor_events(callback, sensor->get_sensor_name(), sensor->get_type());
+                CHECK_HR(sensor->start_capture(sink));
+                _sinks.push_back(sink);
             }
         }
 
@@ -313,7 +302,7 @@ namespace librealsense
             {
                 sensor->stop_capture();
             }
-            _cb = nullptr;
+            _sinks.clear();
         }
 
         std::vector<hid_sensor> wmf_hid_device::get_sensors()
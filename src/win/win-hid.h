@@ -23,13 +23,21 @@ namespace librealsense
                 auto res = pISensor->GetFriendlyName(&fName);
                 if (FAILED(res))
                 {
-                    fName = L"Unidentified HID Sensor";
+                    _name = "Unidentified HID Sensor";
+                }
+                else
+                {
+                    _name = CW2A(fName);
+                    SysFreeString(fName);
                 }
 
-                _name = CW2A(fName);
+                /* Sensor types are more specific groupings than sensor categories, defined in Sensors.h */
+                if (FAILED(pISensor->GetType(&_type)))
+                    _type = GUID_NULL;
             };
 
             const std::string& get_sensor_name() const { return _name; }
+            const SENSOR_TYPE_ID& get_type() const { return _type; }
             const CComPtr<ISensor>& get_sensor() const { return _pISensor; }
 
             HRESULT start_capture(ISensorEvents* sensorEvents)
@@ -47,6 +55,7 @@ namespace librealsense
             hid_device_info _hid_device_info;
             CComPtr<ISensor> _pISensor;
             std::string _name;
+            SENSOR_TYPE_ID _type;
         };
 
         class wmf_hid_device : public hid_device
@@ -68,7 +77,7 @@ namespace librealsense
             std::vector<std::shared_ptr<wmf_hid_sensor>> _opened_sensors;    // Vector of all opened sensors of this device (subclass of _connected_sensors)
             std::vector<std::shared_ptr<wmf_hid_sensor>> _streaming_sensors; // Vector of all streaming sensors of this device (subclass of _connected_sensors)
 
-            CComPtr<ISensorEvents> _cb = nullptr;
+            std::vector<CComPtr<ISensorEvents>> _sinks; // Event sink of every streaming sensor
         };
     }
 }
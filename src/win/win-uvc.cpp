@@ -149,6 +149,34 @@ namespace librealsense
             }
 #endif // METADATA_SUPPORT
 
+        // Locks the frame data of a sample. Lock copies 2D buffers into a contiguous buffer of its own, so buffers
+        // whose rows are already contiguous and top-down are locked in place through IMF2DBuffer instead
+        static bool lock_frame_buffer(IMFMediaBuffer* buffer, uint32_t height, byte** data, DWORD* length, IMF2DBuffer** locked_2d)
+        {
+            CComPtr<IMF2DBuffer> buffer_2d = nullptr;
+            if (SUCCEEDED(buffer->QueryInterface(IID_PPV_ARGS(&buffer_2d))))
+            {
+                BYTE* scanline0 = nullptr;
+                LONG pitch = 0;
+                DWORD contiguous_length = 0;
+                if (SUCCEEDED(buffer_2d->GetContiguousLength(&contiguous_length)) &&
+                    SUCCEEDED(buffer_2d->Lock2D(&scanline0, &pitch)))
+                {
+                    if (pitch > 0 && DWORD(pitch) * height == contiguous_length)
+                    {
+                        *data = scanline0;
+                        *length = contiguous_length;
+                        *locked_2d = buffer_2d.Detach();
+                        return true;
+                    }
+                    buffer_2d->Unlock2D();
+                }
+            }
+
+            DWORD max_length{};
+            return SUCCEEDED(buffer->Lock(data, &max_length, length));
+        }
+
         STDMETHODIMP source_reader_callback::QueryInterface(REFIID iid, void** ppv)
         {
 #pragma warning( push )
@@ -196,9 +224,14 @@ namespace librealsense
                     CComPtr<IMFMediaBuffer> buffer = nullptr;
                     if (SUCCEEDED(sample->GetBufferByIndex(0, &buffer)))
                     {
-                        byte* byte_buffer=nullptr;
-                        DWORD max_length{}, current_length{};
-                        if (SUCCEEDED(buffer->Lock(&byte_buffer, &max_length, &current_length)))
+                        auto& stream = owner->_streams[dwStreamIndex];
+                        std::lock_guard<std::mutex> lock(owner->_streams_mutex);
+                        auto profile = stream.profile;
+
+                        byte* byte_buffer = nullptr;
+                        DWORD current_length{};
+                        CComPtr<IMF2DBuffer> buffer_2d = nullptr;
+                        if (lock_frame_buffer(buffer, profile.height, &byte_buffer, &current_length, &buffer_2d))
                         {
                             byte* metadata = nullptr;
                             uint8_t metadata_size = 0;
@@ -207,14 +240,17 @@ namespace librealsense
 #endif
                             try
                             {
-                                auto& stream = owner->_streams[dwStreamIndex];
-                                std::lock_guard<std::mutex> lock(owner->_streams_mutex);
-                                auto profile = stream.profile;
-                                frame_object f{ current_length, metadata_size, byte_buffer, metadata, monotonic_to_realtime(llTimestamp/10000.f) };
+                                frame_object f{ current_length, metadata_size, byte_buffer, metadata, monotonic_to_realtime(llTimestamp/10000.f), -1 };
 
-                                auto continuation = [buffer, this]()
+                                // The frames referencing the buffer hold the sample too, since the source reader
+                                // recycles the buffers of the samples it gets back
+                                CComPtr<IMFSample> held_sample = sample;
+                                auto continuation = [held_sample, buffer, buffer_2d]()
                                 {
-                                    buffer->Unlock();
+                                    if (buffer_2d)
+                                        buffer_2d->Unlock2D();
+                                    else
+                                        buffer->Unlock();
                                 };
 
                                 stream.callback(profile, f, continuation);
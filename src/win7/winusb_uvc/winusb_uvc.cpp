@@ -13,6 +13,8 @@
 #include <vector>
 #include <thread>
 #include <atomic>
+#include <algorithm>
+#include <memory>
 
 // Data structures for Backend-Frontend queue:
 struct frame;
@@ -809,8 +811,11 @@ void winusb_uvc_swap_buffers(winusb_uvc_stream_handle_t *strmh) {
     strmh->pts = 0;
 }
 
+// The payloads are read into the buffer of their transfer. A complete frame is handed over by swapping the
+// transfer buffer with the pixels of a pooled frame, which then takes its place for the next read
 void winusb_uvc_process_payload(winusb_uvc_stream_handle_t *strmh, 
-    uint8_t *payload, size_t payload_len, frames_archive* archive, frames_queue* queue) {
+    std::vector<uint8_t>& payload_buffer, size_t payload_len, frames_archive* archive, frames_queue* queue) {
+    uint8_t *payload = payload_buffer.data();
     uint8_t header_len;
     uint8_t header_info;
     size_t data_len;
@@ -893,12 +898,13 @@ void winusb_uvc_process_payload(winusb_uvc_stream_handle_t *strmh,
             if (frame_p)
             {
                 frame_ptr fp(frame_p, &cleanup_frame);
-                
-                memcpy(fp->pixels.data(), payload, data_len + header_len);
+
+                fp->pixels.swap(payload_buffer);
+                payload_buffer.resize(fp->pixels.size());
 
                 LOG_DEBUG("Passing packet to user CB with size " << data_len + header_len);
                 librealsense::platform::frame_object fo{ data_len, header_len, 
-                    fp->pixels.data() + header_len , fp->pixels.data() };
+                    fp->pixels.data() + header_len , fp->pixels.data(), 0, -1 };
                 fp->fo = fo;
 
                 queue->enqueue(std::move(fp));
@@ -911,10 +917,40 @@ void winusb_uvc_process_payload(winusb_uvc_stream_handle_t *strmh,
     }
 }
 
+// Number of reads kept pending on the streaming pipe. Completed reads are processed while the
+// others are filled, so the pipe is never left without a request. LRS_WINUSB_TRANSFERS overrides the default
+#define WINUSB_UVC_NUM_TRANSFERS 4
+#define WINUSB_UVC_MAX_TRANSFERS 32
+
+static int winusb_uvc_num_transfers()
+{
+    static const char* transfers_var_name = "LRS_WINUSB_TRANSFERS";
+    auto content = getenv(transfers_var_name);
+    if (!content)
+        return WINUSB_UVC_NUM_TRANSFERS;
+
+    auto count = strtol(content, nullptr, 10);
+    return static_cast<int>(std::max(1L, std::min(count, static_cast<long>(WINUSB_UVC_MAX_TRANSFERS))));
+}
+
+struct stream_transfer
+{
+    stream_transfer(size_t size)
+        : event(CreateEvent(nullptr, TRUE, FALSE, nullptr)), buffer(size, 0), pending(false)
+    {
+        memset(&overlapped, 0, sizeof(overlapped));
+    }
+
+    OVERLAPPED overlapped;
+    safe_handle event;
+    std::vector<uint8_t> buffer;
+    bool pending;
+};
+
 void stream_thread(winusb_uvc_stream_context *strctx)
 {
-    PUCHAR buffer = (PUCHAR)malloc(strctx->maxPayloadTransferSize);
-    memset(buffer, 0, sizeof(strctx->maxPayloadTransferSize));
+    auto handle = strctx->stream->stream_if->associateHandle;
+    auto endpoint = static_cast<UCHAR>(strctx->endpoint);
 
     frames_archive archive;
     std::atomic_bool keep_sending_callbacks = true;
@@ -945,27 +981,63 @@ void stream_thread(winusb_uvc_stream_context *strctx)
         }
     });
 
-    do {
-        DWORD transferred;
-        if (!WinUsb_ReadPipe(strctx->stream->stream_if->associateHandle,
-            strctx->endpoint,
-            buffer,
-            strctx->maxPayloadTransferSize,
-            &transferred,
-            NULL)) 
-            {
-                printf("WinUsb_ReadPipe Error: %d\n" + GetLastError());
-                break;
-            }
+    std::vector<std::unique_ptr<stream_transfer>> transfers;
+    for (auto i = 0; i < winusb_uvc_num_transfers(); i++)
+        transfers.emplace_back(new stream_transfer(strctx->maxPayloadTransferSize));
+
+    auto submit = [&](stream_transfer& transfer)
+    {
+        ResetEvent(transfer.event.GetHandle());
+        memset(&transfer.overlapped, 0, sizeof(transfer.overlapped));
+        transfer.overlapped.hEvent = transfer.event.GetHandle();
+        if (!WinUsb_ReadPipe(handle, endpoint, transfer.buffer.data(), static_cast<ULONG>(transfer.buffer.size()),
+            nullptr, &transfer.overlapped) && GetLastError() != ERROR_IO_PENDING)
+        {
+            LOG_ERROR("WinUsb_ReadPipe failed, error " << GetLastError());
+            return false;
+        }
+        transfer.pending = true;
+        return true;
+    };
+
+    // The reads of a pipe complete in the order they were submitted, so they are waited on in turn
+    bool streaming = true;
+    for (auto&& transfer : transfers)
+        streaming = streaming && submit(*transfer);
+
+    for (size_t next = 0; streaming && strctx->stream->running; )
+    {
+        auto&& transfer = *transfers[next];
+        if (WaitForSingleObject(transfer.event.GetHandle(), 100) == WAIT_TIMEOUT)
+            continue;
+
+        ULONG transferred = 0;
+        transfer.pending = false;
+        if (!WinUsb_GetOverlappedResult(handle, &transfer.overlapped, &transferred, FALSE))
+        {
+            LOG_ERROR("WinUsb_ReadPipe completed with error " << GetLastError());
+            break;
+        }
 
         LOG_DEBUG("Packet received with size " << transferred);
-        winusb_uvc_process_payload(strctx->stream, buffer, transferred, &archive, &queue);
-    } while (strctx->stream->running);
+        winusb_uvc_process_payload(strctx->stream, transfer.buffer, transferred, &archive, &queue);
+
+        streaming = submit(transfer);
+        next = (next + 1) % transfers.size();
+    }
+
+    // Cancel the pending reads, their buffers must outlive them
+    WinUsb_AbortPipe(handle, endpoint);
+    for (auto&& transfer : transfers)
+    {
+        ULONG transferred = 0;
+        if (transfer->pending)
+            WinUsb_GetOverlappedResult(handle, &transfer->overlapped, &transferred, TRUE);
+    }
 
     // reseting pipe after use
-    auto ret = WinUsb_ResetPipe(strctx->stream->stream_if->associateHandle, strctx->endpoint);
+    auto ret = WinUsb_ResetPipe(handle, endpoint);
 
-    free(buffer);
     free(strctx);
 
     queue.clear();
@@ -25,6 +25,15 @@ namespace perc
             */
             virtual void onPoseFrame(OUT TrackingData::PoseFrame& pose) {}
 
+            /**
+            * @brief directPoseFrames
+            *        When true, onPoseFrame is called on the USB thread receiving the pose instead of the completion
+            *        queue thread. The listener must then return quickly, since the IMU samples wait behind it
+            *
+            * @return true to receive the poses on the USB thread
+            */
+            virtual bool directPoseFrames() { return false; }
+
             /**
             * @brief onVideoFrame
             *        The function will be called once TrackingDevice has a new video (color / depth / fisheye) frame
@@ -2836,7 +2836,6 @@ namespace perc {
                 {
                     interrupt_message_get_pose poseMsg = *((interrupt_message_get_pose*)header);
                     auto pose = poseMessageToClass(poseMsg.pose, poseMsg.bIndex, poseMsg.pose.llNanoseconds + mTM2CorrelatedTimeStampShift);
-                    std::shared_ptr<CompleteTask> ptr = std::make_shared<PoseCompleteTask>(mListener, pose, this);
 
                     /* Pose must arrive every 5 msec */
                     int64_t offsetMsec = (pose.timestamp - sixdofPrevFrame[pose.sourceIndex].prevFrameTimeStamp) / ms2ns(MAX_6DOF_TIMEDIFF_MSEC);
@@ -2856,6 +2855,14 @@ namespace perc {
 
                     sixdofPrevFrame[pose.sourceIndex].prevFrameTimeStamp = pose.timestamp;
 
+                    auto listener = mListener;
+                    if (listener && listener->directPoseFrames())
+                    {
+                        listener->onPoseFrame(pose);
+                        break;
+                    }
+
+                    std::shared_ptr<CompleteTask> ptr = std::make_shared<PoseCompleteTask>(mListener, pose, this);
                     mTaskHandler->addTask(ptr);
                     break;
                 }
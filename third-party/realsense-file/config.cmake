@@ -3,5 +3,5 @@ set(BOOST_DIR ${CMAKE_CURRENT_LIST_DIR}/boost)
 set(LZ4_DIR ${CMAKE_CURRENT_LIST_DIR}/lz4)
 
 set(BOOST_INCLUDE_PATH ${BOOST_DIR}/)
-set(LZ4_INCLUDE_PATH ${LZ4_DIR}/lib/)
+set(LZ4_INCLUDE_PATH ${LZ4_DIR}/)
 include(${ROSBAG_DIR}/config.cmake)
\ No newline at end of file
@@ -6,6 +6,7 @@
 #define STD_MSGS_MESSAGE_UINT8MULTIARRAY_H
 
 
+#include <memory>
 #include <string>
 #include <vector>
 #include <map>
@@ -45,15 +46,15 @@ struct UInt8MultiArray_
 
 
 
-  typedef boost::shared_ptr< ::std_msgs::UInt8MultiArray_<ContainerAllocator> > Ptr;
-  typedef boost::shared_ptr< ::std_msgs::UInt8MultiArray_<ContainerAllocator> const> ConstPtr;
+  typedef std::shared_ptr< ::std_msgs::UInt8MultiArray_<ContainerAllocator> > Ptr;
+  typedef std::shared_ptr< ::std_msgs::UInt8MultiArray_<ContainerAllocator> const> ConstPtr;
 
 }; // struct UInt8MultiArray_
 
 typedef ::std_msgs::UInt8MultiArray_<std::allocator<void> > UInt8MultiArray;
 
-typedef boost::shared_ptr< ::std_msgs::UInt8MultiArray > UInt8MultiArrayPtr;
-typedef boost::shared_ptr< ::std_msgs::UInt8MultiArray const> UInt8MultiArrayConstPtr;
+typedef std::shared_ptr< ::std_msgs::UInt8MultiArray > UInt8MultiArrayPtr;
+typedef std::shared_ptr< ::std_msgs::UInt8MultiArray const> UInt8MultiArrayConstPtr;
 
 // constants requiring out of line definition
 
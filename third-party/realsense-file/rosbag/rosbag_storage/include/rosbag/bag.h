@@ -39,6 +39,7 @@
 #include "macros.h"
 
 #include "buffer.h"
+#include "chunk_compressor.h"
 #include "chunked_file.h"
 #include "constants.h"
 #include "exceptions.h"
@@ -52,11 +53,14 @@
 
 //#include "ros/subscription_callback_helper.h"
 
+#include <deque>
 #include <ios>
 #include <map>
+#include <memory>
 #include <queue>
 #include <set>
 #include <stdexcept>
+#include <type_traits>
 
 #include <boost/format.hpp>
 //#include <boost/iterator/iterator_facade.hpp>
@@ -80,11 +84,13 @@ typedef bagmode::BagMode BagMode;
 class MessageInstance;
 class View;
 class Query;
+class TopicIndex;
 
 class ROSBAG_DECL Bag
 {
     friend class MessageInstance;
     friend class View;
+    friend class TopicIndex;
 
 public:
     Bag();
@@ -123,6 +129,8 @@ public:
     std::tuple<std::string, uint64_t, uint64_t> getCompressionInfo() const;
     void            setChunkThreshold(uint32_t chunk_threshold);  //!< Set the threshold for creating new chunks
     uint32_t        getChunkThreshold() const;                    //!< Get the threshold for creating new chunks
+    void            setCompressionThreads(uint32_t threads);      //!< Compress LZ4 chunks on a pool of worker threads, 0 compresses them while writing
+    uint32_t        getCompressionThreads() const;                //!< Get the number of chunk compression threads
 
     //! Write a message into the bag file
     /*!
@@ -201,12 +209,13 @@ private:
     void appendConnectionRecordToBuffer(Buffer& buf, ConnectionInfo const* connection_info);
     template<class T>
     void writeMessageDataRecord(uint32_t conn_id, rs2rosinternal::Time const& time, T const& msg);
-    void writeIndexRecords();
+    void writeIndexRecords(std::map<uint32_t, std::multiset<IndexEntry> > const& indexes);
     void writeConnectionRecords();
     void writeChunkInfoRecords();
     void startWritingChunk(rs2rosinternal::Time time);
     void writeChunkHeader(CompressionType compression, uint32_t compressed_size, uint32_t uncompressed_size);
     void stopWritingChunk();
+    void writePendingChunks(size_t max_pending);
 
     // Reading
 
@@ -223,6 +232,7 @@ private:
 
     rs2rosinternal::Header readMessageDataHeader(IndexEntry const& index_entry);
     uint32_t    readMessageDataSize(IndexEntry const& index_entry) const;
+    bool        readMessageDataFileRange(IndexEntry const& index_entry, uint64_t& offset, uint32_t& size) const;
 
     template<typename Stream>
     void readMessageDataIntoStream(IndexEntry const& index_entry, Stream& stream) const;
@@ -287,9 +297,23 @@ private:
 
     // Current chunk
     bool      chunk_open_;
+    bool      chunk_deferred_;             //!< the current chunk is only assembled in outgoing_chunk_buffer_ and compressed by compressor_
     ChunkInfo curr_chunk_info_;
     uint64_t  curr_chunk_data_pos_;
 
+    // Chunks handed to the compressor, written to file in order once compressed
+    struct PendingChunk
+    {
+        ChunkInfo                                      info;
+        std::map<uint32_t, std::multiset<IndexEntry> > indexes;
+        uint32_t                                       uncompressed_size;
+        std::future<std::vector<char> >                compressed;
+    };
+
+    uint32_t                         compression_threads_;
+    std::unique_ptr<ChunkCompressor> compressor_;
+    std::deque<PendingChunk>         pending_chunks_;
+
     std::map<std::string, uint32_t>                topic_connection_ids_;
     std::map<rs2rosinternal::M_string, uint32_t>              header_connection_ids_;
     std::map<uint32_t, ConnectionInfo*>            connections_;
@@ -555,8 +579,11 @@ void Bag::doWrite(std::string const& topic, rs2rosinternal::Time const& time, T
 
         std::multiset<IndexEntry>& chunk_connection_index = curr_chunk_connection_indexes_[connection_info->id];
         chunk_connection_index.insert(chunk_connection_index.end(), index_entry);
-        std::multiset<IndexEntry>& connection_index = connection_indexes_[connection_info->id];
-        connection_index.insert(connection_index.end(), index_entry);
+        // A deferred chunk has no position yet, it is indexed once it is written
+        if (!chunk_deferred_) {
+            std::multiset<IndexEntry>& connection_index = connection_indexes_[connection_info->id];
+            connection_index.insert(connection_index.end(), index_entry);
+        }
 
         // Increment the connection count
         curr_chunk_info_.connection_counts[connection_info->id]++;
@@ -588,12 +615,27 @@ void Bag::writeMessageDataRecord(uint32_t conn_id, rs2rosinternal::Time const& t
     // Assemble message in memory first, because we need to write its length
     uint32_t msg_ser_len = rs2rosinternal::serialization::serializationLength(msg);
 
-    record_buffer_.setSize(msg_ser_len);
+    // todo: use better abstraction than appendHeaderToBuffer
+    appendHeaderToBuffer(outgoing_chunk_buffer_, header);
+    appendDataLengthToBuffer(outgoing_chunk_buffer_, msg_ser_len);
 
-    rs2rosinternal::serialization::OStream s(record_buffer_.getData(), msg_ser_len);
+    uint32_t offset = outgoing_chunk_buffer_.getSize();
+    outgoing_chunk_buffer_.setSize(outgoing_chunk_buffer_.getSize() + msg_ser_len);
 
-    // todo: serialize into the outgoing_chunk_buffer & remove record_buffer_
-    rs2rosinternal::serialization::serialize(s, msg);
+    // The message is serialized once, into the outgoing chunk, and written to the file from there. A message
+    // instance may read its data from the outgoing chunk, it is assembled aside first
+    uint8_t* data = outgoing_chunk_buffer_.getData() + offset;
+    if (std::is_same<T, MessageInstance>::value) {
+        record_buffer_.setSize(msg_ser_len);
+        rs2rosinternal::serialization::OStream s(record_buffer_.getData(), msg_ser_len);
+        rs2rosinternal::serialization::serialize(s, msg);
+        data = outgoing_chunk_buffer_.getData() + offset;
+        memcpy(data, record_buffer_.getData(), msg_ser_len);
+    }
+    else {
+        rs2rosinternal::serialization::OStream s(data, msg_ser_len);
+        rs2rosinternal::serialization::serialize(s, msg);
+    }
 
     // We do an extra seek here since writing our data record may
     // have indirectly moved our file-pointer if it was a
@@ -606,15 +648,7 @@ void Bag::writeMessageDataRecord(uint32_t conn_id, rs2rosinternal::Time const& t
 
     writeHeader(header);
     writeDataLength(msg_ser_len);
-    write((char*) record_buffer_.getData(), msg_ser_len);
-
-    // todo: use better abstraction than appendHeaderToBuffer
-    appendHeaderToBuffer(outgoing_chunk_buffer_, header);
-    appendDataLengthToBuffer(outgoing_chunk_buffer_, msg_ser_len);
-
-    uint32_t offset = outgoing_chunk_buffer_.getSize();
-    outgoing_chunk_buffer_.setSize(outgoing_chunk_buffer_.getSize() + msg_ser_len);
-    memcpy(outgoing_chunk_buffer_.getData() + offset, record_buffer_.getData(), msg_ser_len);
+    write((char*) data, msg_ser_len);
 
     // Update the current chunk time range
     if (time > curr_chunk_info_.end_time)
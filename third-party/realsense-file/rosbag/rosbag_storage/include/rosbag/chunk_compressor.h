@@ -0,0 +1,47 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#ifndef ROSBAG_CHUNK_COMPRESSOR_H
+#define ROSBAG_CHUNK_COMPRESSOR_H
+
+#include <stdint.h>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "macros.h"
+
+namespace rosbag {
+
+//! Compresses whole chunks on a pool of worker threads
+/*!
+ * Chunks are compressed independently into the same LZ4 frame format that LZ4Stream writes,
+ * so the bag can keep writing messages while earlier chunks are being compressed.
+ */
+class ROSBAG_DECL ChunkCompressor
+{
+public:
+    explicit ChunkCompressor(uint32_t threads);
+    ~ChunkCompressor();
+
+    //! Queue a chunk for compression. The future yields the compressed data or rethrows the compression error
+    std::future<std::vector<char>> compress(std::vector<char> data);
+
+private:
+    static std::vector<char> compressLz4(std::vector<char> const& data);
+    void run();
+
+    std::vector<std::thread>                  workers_;
+    std::deque<std::packaged_task<void()>>    tasks_;
+    std::mutex                                mutex_;
+    std::condition_variable                   cv_;
+    bool                                      stopping_;
+};
+
+} // namespace rosbag
+
+#endif
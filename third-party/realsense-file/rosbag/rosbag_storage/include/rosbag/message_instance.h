@@ -59,6 +59,7 @@ class Bag;
 class ROSBAG_DECL MessageInstance
 {
     friend class View;
+    friend class TopicIndex;
   
 public:
     rs2rosinternal::Time   const& getTime()              const;
@@ -93,6 +94,12 @@ public:
     //! Size of serialized message
     uint32_t size() const;
 
+    //! Position and size of the serialized message in the bag file
+    /*!
+     * returns false if the message is not stored verbatim in the file (e.g. its chunk is compressed)
+     */
+    bool getFileRange(uint64_t& offset, uint32_t& size) const;
+
 private:
     MessageInstance(ConnectionInfo const* connection_info, IndexEntry const& index, Bag const& bag);
 
@@ -0,0 +1,65 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#ifndef ROSBAG_TOPIC_INDEX_H
+#define ROSBAG_TOPIC_INDEX_H
+
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "rosbag/bag.h"
+#include "rosbag/message_instance.h"
+#include "rosbag/structures.h"
+#include "rosbag/macros.h"
+
+namespace rosbag {
+
+//! Time index over the messages of a single topic
+/*!
+ * Looks messages up directly in the connection indexes the bag reads when it is opened,
+ * so finding the messages at a given time is a binary search instead of building a View.
+ * The index is valid for as long as the bag stays open for reading.
+ */
+class ROSBAG_DECL TopicIndex
+{
+public:
+    TopicIndex();
+
+    //! Index every topic of the bag in a single pass over its connections
+    static std::map<std::string, TopicIndex> build(Bag const& bag);
+
+    //! Messages stamped exactly at the given time
+    std::vector<MessageInstance> getMessages(rs2rosinternal::Time const& time) const;
+
+    //! Latest message stamped in [start_time, end_time], or null if there is none
+    std::shared_ptr<MessageInstance> getLastMessage(rs2rosinternal::Time const& start_time, rs2rosinternal::Time const& end_time) const;
+
+    //! Up to count messages, starting with the one at the given position in time order
+    /*!
+     * Only the index is read, the messages are read from the bag once they are instantiated
+     */
+    std::vector<MessageInstance> getMessages(size_t first, size_t count) const;
+
+    //! Number of indexed messages
+    size_t size() const;
+
+    //! Data type of the topic, empty if there are no messages
+    std::string getDataType() const;
+
+    //! Times of the first and last messages, TIME_MAX and TIME_MIN if there are none
+    rs2rosinternal::Time getBeginTime() const;
+    rs2rosinternal::Time getEndTime() const;
+
+private:
+    typedef std::pair<ConnectionInfo const*, std::multiset<IndexEntry> const*> Connection;
+
+    Bag const*              bag_;
+    std::vector<Connection> connections_;
+};
+
+} // namespace rosbag
+
+#endif
@@ -71,7 +71,9 @@ Bag::Bag() :
     connection_count_(0),
     chunk_count_(0),
     chunk_open_(false),
+    chunk_deferred_(false),
     curr_chunk_data_pos_(0),
+    compression_threads_(0),
     current_buffer_(0),
     decompressed_chunk_(0)
 {
@@ -87,7 +89,9 @@ Bag::Bag(string const& filename, uint32_t mode) :
     connection_count_(0),
     chunk_count_(0),
     chunk_open_(false),
+    chunk_deferred_(false),
     curr_chunk_data_pos_(0),
+    compression_threads_(0),
     current_buffer_(0),
     decompressed_chunk_(0)
 {
@@ -166,6 +170,7 @@ void Bag::close() {
         closeWrite();
 
     file_.close();
+    compressor_.reset();
 
     topic_connection_ids_.clear();
     header_connection_ids_.clear();
@@ -194,6 +199,18 @@ void Bag::setChunkThreshold(uint32_t chunk_threshold) {
     chunk_threshold_ = chunk_threshold;
 }
 
+uint32_t Bag::getCompressionThreads() const { return compression_threads_; }
+
+void Bag::setCompressionThreads(uint32_t threads) {
+    if (file_.isOpen() && chunk_open_)
+        stopWritingChunk();
+    if (file_.isOpen())
+        writePendingChunks(0);
+
+    compression_threads_ = threads;
+    compressor_.reset(threads > 0 ? new ChunkCompressor(threads) : nullptr);
+}
+
 CompressionType Bag::getCompression() const { return compression_; }
 
 std::tuple<std::string, uint64_t, uint64_t> Bag::getCompressionInfo() const
@@ -297,6 +314,7 @@ void Bag::startWriting() {
 void Bag::stopWriting() {
     if (chunk_open_)
         stopWritingChunk();
+    writePendingChunks(0);
 
     seek(0, std::ios::end);
 
@@ -442,7 +460,9 @@ void Bag::readFileHeaderRecord() {
 }
 
 uint32_t Bag::getChunkOffset() const {
-    if (compression_ == compression::Uncompressed)
+    if (chunk_deferred_)
+        return outgoing_chunk_buffer_.getSize();
+    else if (compression_ == compression::Uncompressed)
         return static_cast<uint32_t>(file_.getOffset() - curr_chunk_data_pos_);
     else
         return file_.getCompressedBytesIn();
@@ -454,6 +474,14 @@ void Bag::startWritingChunk(Time time) {
     curr_chunk_info_.start_time = time;
     curr_chunk_info_.end_time   = time;
 
+    // With a compressor, the records are only assembled in memory and the whole chunk is compressed once it is full
+    if (compression_ == compression::LZ4 && compressor_) {
+        outgoing_chunk_buffer_.setSize(0);
+        chunk_deferred_ = true;
+        chunk_open_ = true;
+        return;
+    }
+
     // Write the chunk header, with a place-holder for the data sizes (we'll fill in when the chunk is finished)
     writeChunkHeader(compression_, 0, 0);
 
@@ -467,6 +495,26 @@ void Bag::startWritingChunk(Time time) {
 }
 
 void Bag::stopWritingChunk() {
+    if (chunk_deferred_) {
+        PendingChunk chunk;
+        chunk.info = curr_chunk_info_;
+        chunk.indexes.swap(curr_chunk_connection_indexes_);
+        chunk.uncompressed_size = outgoing_chunk_buffer_.getSize();
+
+        char* data = (char*) outgoing_chunk_buffer_.getData();
+        chunk.compressed = compressor_->compress(std::vector<char>(data, data + chunk.uncompressed_size));
+        pending_chunks_.push_back(std::move(chunk));
+
+        outgoing_chunk_buffer_.setSize(0);
+        curr_chunk_info_.connection_counts.clear();
+        chunk_deferred_ = false;
+        chunk_open_ = false;
+
+        // Write out the chunks that are done, and bound the memory held by the ones still being compressed
+        writePendingChunks(2 * compression_threads_);
+        return;
+    }
+
     // Add this chunk to the index
     chunks_.push_back(curr_chunk_info_);
 
@@ -483,7 +531,7 @@ void Bag::stopWritingChunk() {
 
     // Write out the indexes and clear them
     seek(end_of_chunk_pos);
-    writeIndexRecords();
+    writeIndexRecords(curr_chunk_connection_indexes_);
     curr_chunk_connection_indexes_.clear();
 
     // Clear the connection counts
@@ -493,6 +541,35 @@ void Bag::stopWritingChunk() {
     chunk_open_ = false;
 }
 
+void Bag::writePendingChunks(size_t max_pending) {
+    while (!pending_chunks_.empty()) {
+        if (pending_chunks_.size() <= max_pending &&
+            pending_chunks_.front().compressed.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+            break;
+
+        PendingChunk chunk = std::move(pending_chunks_.front());
+        pending_chunks_.pop_front();
+        std::vector<char> compressed = chunk.compressed.get();
+
+        seek(0, std::ios::end);
+        chunk.info.pos = file_.getOffset();
+        writeChunkHeader(compression::LZ4, static_cast<uint32_t>(compressed.size()), chunk.uncompressed_size);
+        write(compressed.data(), compressed.size());
+        file_size_ = file_.getOffset();
+
+        // Now that the chunk has a position, add it and its messages to the index
+        chunks_.push_back(chunk.info);
+        for (map<uint32_t, multiset<IndexEntry> >::const_iterator i = chunk.indexes.begin(); i != chunk.indexes.end(); i++) {
+            multiset<IndexEntry>& connection_index = connection_indexes_[i->first];
+            foreach(IndexEntry e, i->second) {
+                e.chunk_pos = chunk.info.pos;
+                connection_index.insert(connection_index.end(), e);
+            }
+        }
+        writeIndexRecords(chunk.indexes);
+    }
+}
+
 void Bag::writeChunkHeader(CompressionType compression, uint32_t compressed_size, uint32_t uncompressed_size) {
     ChunkHeader chunk_header;
     switch (compression) {
@@ -534,8 +611,8 @@ void Bag::readChunkHeader(ChunkHeader& chunk_header) const {
 
 // Index records
 
-void Bag::writeIndexRecords() {
-    for (map<uint32_t, multiset<IndexEntry> >::const_iterator i = curr_chunk_connection_indexes_.begin(); i != curr_chunk_connection_indexes_.end(); i++) {
+void Bag::writeIndexRecords(map<uint32_t, multiset<IndexEntry> > const& indexes) {
+    for (map<uint32_t, multiset<IndexEntry> >::const_iterator i = indexes.begin(); i != indexes.end(); i++) {
         uint32_t                    connection_id = i->first;
         multiset<IndexEntry> const& index         = i->second;
 
@@ -921,6 +998,38 @@ uint32_t Bag::readMessageDataSize(IndexEntry const& index_entry) const {
     }
 }
 
+bool Bag::readMessageDataFileRange(IndexEntry const& index_entry, uint64_t& offset, uint32_t& size) const {
+    // Only messages of a completed, uncompressed 2.0 chunk are stored verbatim in the file
+    if (version_ != 200 || curr_chunk_info_.pos == index_entry.chunk_pos)
+        return false;
+
+    seek(index_entry.chunk_pos);
+    ChunkHeader chunk_header;
+    readChunkHeader(chunk_header);
+    if (chunk_header.compression != COMPRESSION_NONE)
+        return false;
+
+    seek(file_.getOffset() + index_entry.offset);
+    uint8_t op = 0xFF;
+    rs2rosinternal::Header header;
+    uint32_t data_size;
+    do {
+        if (!readHeader(header) || !readDataLength(data_size))
+            throw BagFormatException("Error reading MSG_DATA record");
+        readField(*header.getValues(), OP_FIELD_NAME, true, &op);
+        if (op == OP_MSG_DEF || op == OP_CONNECTION)
+            seek(data_size, std::ios::cur);
+    }
+    while (op == OP_MSG_DEF || op == OP_CONNECTION);
+
+    if (op != OP_MSG_DATA)
+        throw BagFormatException("Expected MSG_DATA op not found");
+
+    offset = file_.getOffset();
+    size = data_size;
+    return true;
+}
+
 void Bag::writeChunkInfoRecords() {
     foreach(ChunkInfo const& chunk_info, chunks_) {
         // Write the chunk info header
@@ -1155,7 +1264,12 @@ std::string Bag::toHeaderString(Time const* field) const {
 // Low-level I/O
 
 void Bag::write(string const& s)                  { write(s.c_str(), s.length()); }
-void Bag::write(char const* s, std::streamsize n) { file_.write((char*) s, n);    }
+void Bag::write(char const* s, std::streamsize n) {
+    // The records of a deferred chunk are already assembled in outgoing_chunk_buffer_
+    if (chunk_deferred_)
+        return;
+    file_.write((char*) s, n);
+}
 
 void Bag::read(char* b, std::streamsize n) const  { file_.read(b, n);             }
 void Bag::seek(uint64_t pos, int origin) const    { file_.seek(pos, origin);      }
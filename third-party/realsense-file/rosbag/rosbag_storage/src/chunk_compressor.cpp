@@ -0,0 +1,78 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#include "rosbag/chunk_compressor.h"
+#include "rosbag/exceptions.h"
+#include "../../roslz4/include/roslz4/lz4s.h"
+
+namespace rosbag {
+
+ChunkCompressor::ChunkCompressor(uint32_t threads) : stopping_(false) {
+    for (uint32_t i = 0; i < threads; i++)
+        workers_.emplace_back([this]() { run(); });
+}
+
+ChunkCompressor::~ChunkCompressor() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    for (auto&& worker : workers_)
+        worker.join();
+}
+
+std::future<std::vector<char>> ChunkCompressor::compress(std::vector<char> data) {
+    auto task = std::make_shared<std::packaged_task<std::vector<char>()>>(
+        std::bind(&ChunkCompressor::compressLz4, std::move(data)));
+    auto result = task->get_future();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        tasks_.emplace_back([task]() { (*task)(); });
+    }
+    cv_.notify_one();
+    return result;
+}
+
+void ChunkCompressor::run() {
+    while (true) {
+        std::packaged_task<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this]() { return stopping_ || !tasks_.empty(); });
+            // Queued chunks are still compressed when stopping, the bag waits for all of them before closing
+            if (tasks_.empty())
+                return;
+            task = std::move(tasks_.front());
+            tasks_.pop_front();
+        }
+        task();
+    }
+}
+
+std::vector<char> ChunkCompressor::compressLz4(std::vector<char> const& data) {
+    // Same block size as LZ4Stream; the output bound covers incompressible blocks plus the frame overhead
+    const int block_size_id = 6;
+    const size_t block_size = roslz4_blockSizeFromIndex(block_size_id);
+    size_t bound = data.size() + data.size() / 255 + (data.size() / block_size + 1) * 32 + 64;
+
+    std::vector<char> compressed;
+    while (true) {
+        compressed.resize(bound);
+        unsigned int compressed_size = static_cast<unsigned int>(compressed.size());
+        int ret = roslz4_buffToBuffCompress(const_cast<char*>(data.data()), static_cast<unsigned int>(data.size()),
+                                            compressed.data(), &compressed_size, block_size_id);
+        switch (ret) {
+        case ROSLZ4_OK:
+            compressed.resize(compressed_size);
+            return compressed;
+        case ROSLZ4_OUTPUT_SMALL: bound *= 2; break;
+        case ROSLZ4_MEMORY_ERROR: throw BagIOException("ROSLZ4_MEMORY_ERROR: insufficient memory available");
+        case ROSLZ4_PARAM_ERROR: throw BagIOException("ROSLZ4_PARAM_ERROR: bad block size");
+        case ROSLZ4_ERROR: throw BagIOException("ROSLZ4_ERROR: compression error");
+        default: throw BagException("Unhandled return code");
+        }
+    }
+}
+
+} // namespace rosbag
@@ -0,0 +1,136 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#include "rosbag/topic_index.h"
+
+#include <iterator>
+
+using std::map;
+using std::multiset;
+using std::string;
+using std::vector;
+using rs2rosinternal::Time;
+
+namespace rosbag {
+
+TopicIndex::TopicIndex() : bag_(NULL) { }
+
+map<string, TopicIndex> TopicIndex::build(Bag const& bag) {
+    if ((bag.getMode() & bagmode::Read) != bagmode::Read)
+        throw BagException("Bag not opened for reading");
+
+    map<string, TopicIndex> indexes;
+    for (map<uint32_t, ConnectionInfo*>::const_iterator i = bag.connections_.begin(); i != bag.connections_.end(); i++) {
+        ConnectionInfo const* connection = i->second;
+
+        map<uint32_t, multiset<IndexEntry> >::const_iterator j = bag.connection_indexes_.find(connection->id);
+        if (j == bag.connection_indexes_.end())
+            continue;
+
+        TopicIndex& index = indexes[connection->topic];
+        index.bag_ = &bag;
+        index.connections_.push_back(Connection(connection, &j->second));
+    }
+    return indexes;
+}
+
+vector<MessageInstance> TopicIndex::getMessages(Time const& time) const {
+    vector<MessageInstance> messages;
+    for (vector<Connection>::const_iterator i = connections_.begin(); i != connections_.end(); i++) {
+        multiset<IndexEntry> const& index = *i->second;
+        IndexEntry key = { time, 0, 0 };
+        for (multiset<IndexEntry>::const_iterator e = index.lower_bound(key); e != index.end() && e->time == time; e++)
+            messages.push_back(MessageInstance(i->first, *e, *bag_));
+    }
+    return messages;
+}
+
+std::shared_ptr<MessageInstance> TopicIndex::getLastMessage(Time const& start_time, Time const& end_time) const {
+    ConnectionInfo const* last_connection = NULL;
+    IndexEntry const* last = NULL;
+    for (vector<Connection>::const_iterator i = connections_.begin(); i != connections_.end(); i++) {
+        multiset<IndexEntry> const& index = *i->second;
+        IndexEntry key = { end_time, 0, 0 };
+        multiset<IndexEntry>::const_iterator e = index.upper_bound(key);
+        if (e == index.begin())
+            continue;
+        --e;
+        if (e->time < start_time)
+            continue;
+        if (last == NULL || last->time < e->time) {
+            last_connection = i->first;
+            last = &*e;
+        }
+    }
+
+    if (last == NULL)
+        return std::shared_ptr<MessageInstance>();
+    return std::shared_ptr<MessageInstance>(new MessageInstance(last_connection, *last, *bag_));
+}
+
+vector<MessageInstance> TopicIndex::getMessages(size_t first, size_t count) const {
+    vector<MessageInstance> messages;
+    if (connections_.size() == 1) {
+        multiset<IndexEntry> const& index = *connections_.front().second;
+        if (first >= index.size())
+            return messages;
+        multiset<IndexEntry>::const_iterator e = index.begin();
+        std::advance(e, first);
+        for (; e != index.end() && messages.size() < count; e++)
+            messages.push_back(MessageInstance(connections_.front().first, *e, *bag_));
+        return messages;
+    }
+
+    // Topics written from several connections are merged by time
+    vector<multiset<IndexEntry>::const_iterator> cursors;
+    for (vector<Connection>::const_iterator i = connections_.begin(); i != connections_.end(); i++)
+        cursors.push_back(i->second->begin());
+
+    for (size_t position = 0; messages.size() < count; position++) {
+        size_t next = cursors.size();
+        for (size_t i = 0; i < cursors.size(); i++) {
+            if (cursors[i] == connections_[i].second->end())
+                continue;
+            if (next == cursors.size() || cursors[i]->time < cursors[next]->time)
+                next = i;
+        }
+        if (next == cursors.size())
+            break;
+        if (position >= first)
+            messages.push_back(MessageInstance(connections_[next].first, *cursors[next], *bag_));
+        cursors[next]++;
+    }
+    return messages;
+}
+
+string TopicIndex::getDataType() const {
+    for (vector<Connection>::const_iterator i = connections_.begin(); i != connections_.end(); i++)
+        if (!i->second->empty())
+            return i->first->datatype;
+    return string();
+}
+
+Time TopicIndex::getBeginTime() const {
+    Time begin = rs2rosinternal::TIME_MAX;
+    for (vector<Connection>::const_iterator i = connections_.begin(); i != connections_.end(); i++)
+        if (!i->second->empty() && i->second->begin()->time < begin)
+            begin = i->second->begin()->time;
+    return begin;
+}
+
+Time TopicIndex::getEndTime() const {
+    Time end = rs2rosinternal::TIME_MIN;
+    for (vector<Connection>::const_iterator i = connections_.begin(); i != connections_.end(); i++)
+        if (!i->second->empty() && end < i->second->rbegin()->time)
+            end = i->second->rbegin()->time;
+    return end;
+}
+
+size_t TopicIndex::size() const {
+    size_t count = 0;
+    for (vector<Connection>::const_iterator i = connections_.begin(); i != connections_.end(); i++)
+        count += i->second->size();
+    return count;
+}
+
+} // namespace rosbag
@@ -9,6 +9,17 @@
 #include <thread>
 #include <string>
 #include <sstream>
+#include <fstream>
+#include <functional>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <algorithm>
+#include <cstring>
+#include <cstdio>
+#include <ctime>
+#include <exception>
+#include <memory>
 
 #include "librealsense2/rs.hpp"
 
@@ -19,10 +30,228 @@ namespace rs2 {
 
             typedef unsigned long long frame_number_t;
 
+            // Destination of the converted files, either the file system or a single archive
+            class output_sink {
+            public:
+                virtual ~output_sink() = default;
+
+                virtual void write(const std::string& name, const std::string& data) = 0;
+                virtual bool is_archive() const { return false; }
+                virtual void close() {}
+            };
+
+            class file_sink : public output_sink {
+            public:
+                void write(const std::string& name, const std::string& data) override
+                {
+                    std::ofstream fs(name, std::ios::binary | std::ios::trunc);
+
+                    if (!fs) {
+                        throw std::runtime_error("cannot write " + name);
+                    }
+
+                    fs.write(data.data(), data.size());
+                }
+            };
+
+            // Appends the files to a ustar archive, so long recordings don't produce millions of small files.
+            // The writes of the workers are serialized, the entries are in the order of completion
+            class tar_sink : public output_sink {
+                std::mutex _mutex;
+                std::ofstream _file;
+                std::string _fileName;
+
+                static void octal(char* field, size_t size, unsigned long long value)
+                {
+                    std::snprintf(field, size, "%0*llo", static_cast<int>(size - 1), value);
+                }
+
+            public:
+                tar_sink(const std::string& fileName)
+                    : _file(fileName, std::ios::binary | std::ios::trunc)
+                    , _fileName(fileName)
+                {
+                    if (!_file) {
+                        throw std::runtime_error("cannot create " + fileName);
+                    }
+                }
+
+                ~tar_sink()
+                {
+                    close();
+                }
+
+                bool is_archive() const override
+                {
+                    return true;
+                }
+
+                void write(const std::string& path, const std::string& data) override
+                {
+                    struct {
+                        char name[100], mode[8], uid[8], gid[8], size[12], mtime[12], chksum[8], typeflag, linkname[100];
+                        char magic[6], version[2], uname[32], gname[32], devmajor[8], devminor[8], prefix[155], pad[12];
+                    } header;
+                    static_assert(sizeof(header) == 512, "tar header must be a block");
+                    std::memset(&header, 0, sizeof(header));
+
+                    // Names longer than 100 characters are split on a directory into the prefix field
+                    auto start = path.find_first_not_of("./");
+                    auto name = start != std::string::npos ? path.substr(start) : path;
+                    std::string prefix;
+                    if (name.size() > sizeof(header.name)) {
+                        auto split = name.rfind('/', sizeof(header.prefix));
+                        if (split == std::string::npos || name.size() - split - 1 > sizeof(header.name)) {
+                            throw std::runtime_error("file name too long for the archive: " + name);
+                        }
+                        prefix = name.substr(0, split);
+                        name = name.substr(split + 1);
+                    }
+
+                    std::memcpy(header.name, name.data(), name.size());
+                    std::memcpy(header.prefix, prefix.data(), prefix.size());
+                    octal(header.mode, sizeof(header.mode), 0644);
+                    octal(header.uid, sizeof(header.uid), 0);
+                    octal(header.gid, sizeof(header.gid), 0);
+                    octal(header.size, sizeof(header.size), data.size());
+                    octal(header.mtime, sizeof(header.mtime), static_cast<unsigned long long>(std::time(nullptr)));
+                    header.typeflag = '0';
+                    std::memcpy(header.magic, "ustar", 6);
+                    std::memcpy(header.version, "00", 2);
+
+                    std::memset(header.chksum, ' ', sizeof(header.chksum));
+                    unsigned int checksum = 0;
+                    for (size_t i = 0; i < sizeof(header); i++) {
+                        checksum += reinterpret_cast<const unsigned char*>(&header)[i];
+                    }
+                    std::snprintf(header.chksum, sizeof(header.chksum), "%06o", checksum);
+
+                    static const char padding[512] = {};
+
+                    std::lock_guard<std::mutex> lock(_mutex);
+                    _file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+                    _file.write(data.data(), data.size());
+                    _file.write(padding, (512 - data.size() % 512) % 512);
+
+                    if (!_file) {
+                        throw std::runtime_error("cannot write " + _fileName);
+                    }
+                }
+
+                void close() override
+                {
+                    std::lock_guard<std::mutex> lock(_mutex);
+
+                    if (_file.is_open()) {
+                        // The end of the archive is marked by two empty blocks
+                        static const char end[1024] = {};
+                        _file.write(end, sizeof(end));
+                        _file.close();
+                    }
+                }
+            };
+
+            // Runs the encoding of the converters, with a bound on the tasks in flight.
+            // Every task holds its frames, so the bound also limits the memory and the frames kept from the playback
+            class worker_pool {
+                std::vector<std::thread> _threads;
+                std::deque<std::function<void()>> _tasks;
+                std::mutex _mutex;
+                std::condition_variable _taskAvailable;
+                std::condition_variable _taskDone;
+                size_t _maxInFlight;
+                size_t _inFlight = 0;
+                bool _stopping = false;
+                std::exception_ptr _error;
+
+                void run()
+                {
+                    while (true) {
+                        std::function<void()> task;
+                        {
+                            std::unique_lock<std::mutex> lock(_mutex);
+                            _taskAvailable.wait(lock, [this] { return _stopping || !_tasks.empty(); });
+
+                            if (_tasks.empty()) {
+                                return;
+                            }
+
+                            task = std::move(_tasks.front());
+                            _tasks.pop_front();
+                        }
+
+                        try {
+                            task();
+                        }
+                        catch (...) {
+                            std::lock_guard<std::mutex> lock(_mutex);
+                            if (!_error) {
+                                _error = std::current_exception();
+                            }
+                        }
+
+                        {
+                            std::lock_guard<std::mutex> lock(_mutex);
+                            _inFlight--;
+                        }
+                        _taskDone.notify_all();
+                    }
+                }
+
+            public:
+                worker_pool(unsigned int threads)
+                    : _maxInFlight(2 * std::max(threads, 1U))
+                {
+                    for (unsigned int i = 0; i < std::max(threads, 1U); i++) {
+                        _threads.emplace_back([this] { run(); });
+                    }
+                }
+
+                ~worker_pool()
+                {
+                    {
+                        std::lock_guard<std::mutex> lock(_mutex);
+                        _stopping = true;
+                    }
+                    _taskAvailable.notify_all();
+
+                    for_each(_threads.begin(), _threads.end(),
+                        [] (std::thread& t) {
+                            t.join();
+                        });
+                }
+
+                // Blocks while the pool is full, which throttles the playback to the encoding rate
+                void submit(std::function<void()> task)
+                {
+                    std::unique_lock<std::mutex> lock(_mutex);
+                    _taskDone.wait(lock, [this] { return _inFlight < _maxInFlight; });
+
+                    _inFlight++;
+                    _tasks.push_back(std::move(task));
+                    lock.unlock();
+
+                    _taskAvailable.notify_one();
+                }
+
+                // Waits for all the submitted tasks, and reports the first failure
+                void wait()
+                {
+                    std::unique_lock<std::mutex> lock(_mutex);
+                    _taskDone.wait(lock, [this] { return _inFlight == 0; });
+
+                    if (_error) {
+                        auto error = _error;
+                        _error = nullptr;
+                        std::rethrow_exception(error);
+                    }
+                }
+            };
+
             class converter_base {
             protected:
-                std::thread _worker;
-                std::vector<std::thread> _subWorkers;
+                std::shared_ptr<worker_pool> _pool;
+                std::shared_ptr<output_sink> _sink;
                 std::unordered_map<int, std::unordered_set<frame_number_t>> _framesMap;
 
             protected:
@@ -42,30 +271,37 @@ namespace rs2 {
                     return result;
                 }
 
-                template <typename F> void start_worker(const F& f)
+                // The task owns copies of the frames it encodes, the frameset is not kept past convert()
+                template <typename F> void submit(const F& f)
                 {
-                    _worker = std::thread(f);
-                }
+                    if (!_pool) {
+                        _pool = std::make_shared<worker_pool>(1);
+                    }
 
-                template <typename F> void add_sub_worker(const F& f)
-                {
-                    _subWorkers.emplace_back(f);
+                    _pool->submit(f);
                 }
 
-                void wait_sub_workers()
+                void write(const std::string& name, const std::string& data)
                 {
-                    for_each(_subWorkers.begin(), _subWorkers.end(),
-                        [] (std::thread& t) {
-                            t.join();
-                        });
+                    if (!_sink) {
+                        _sink = std::make_shared<file_sink>();
+                    }
 
-                    _subWorkers.clear();
+                    _sink->write(name, data);
                 }
 
             public:
+                virtual ~converter_base() = default;
+
                 virtual void convert(rs2::frameset& frameset) = 0;
                 virtual std::string name() const = 0;
 
+                void set_output(std::shared_ptr<worker_pool> pool, std::shared_ptr<output_sink> sink)
+                {
+                    _pool = pool;
+                    _sink = sink;
+                }
+
                 virtual std::string get_statistics()
                 {
                     std::stringstream result;
@@ -84,7 +320,9 @@ namespace rs2 {
 
                 void wait()
                 {
-                    _worker.join();
+                    if (_pool) {
+                        _pool->wait();
+                    }
                 }
             };
 
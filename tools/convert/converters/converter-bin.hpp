@@ -73,47 +73,37 @@ namespace rs2 {
 
                 void convert(rs2::frameset& frameset) override
                 {
-                    start_worker(
-                        [this, &frameset] {
-                            for (size_t i = 0; i < frameset.size(); i++) {
-                                rs2::depth_frame frame = frameset[i].as<rs2::depth_frame>();
-
-                                if (frame && (_streamType == rs2_stream::RS2_STREAM_ANY || frame.get_profile().stream_type() == _streamType)) {
-                                    if (frames_map_get_and_set(frame.get_profile().stream_type(), frame.get_frame_number())) {
-                                        continue;
-                                    }
+                    for (size_t i = 0; i < frameset.size(); i++) {
+                        rs2::depth_frame frame = frameset[i].as<rs2::depth_frame>();
 
-                                    std::stringstream filename;
-                                    filename << _filePath
-                                        << "_" << frame.get_profile().stream_name()
-                                        << "_" << frame.get_frame_number()
-                                        << ".bin";
-
-                                    std::string filenameS = filename.str();
-
-                                    add_sub_worker(
-                                        [filenameS, frame] {
-                                            std::ofstream fs(filenameS, std::ios::binary | std::ios::trunc);
-
-                                            if (fs) {
-                                                uint8_t buffer[4];
-
-                                                for (int y = 0; y < frame.get_height(); y++) {
-                                                    for (int x = 0; x < frame.get_width(); x++) {
-                                                        fs.write(
-                                                            static_cast<const char *>(to_ieee754_32(frame.get_distance(x, y), buffer))
-                                                            , sizeof buffer);
-                                                    }
-                                                }
-
-                                                fs.flush();
-                                            }
-                                        });
-                                }
+                        if (frame && (_streamType == rs2_stream::RS2_STREAM_ANY || frame.get_profile().stream_type() == _streamType)) {
+                            if (frames_map_get_and_set(frame.get_profile().stream_type(), frame.get_frame_number())) {
+                                continue;
                             }
 
-                            wait_sub_workers();
-                        });
+                            std::stringstream filename;
+                            filename << _filePath
+                                << "_" << frame.get_profile().stream_name()
+                                << "_" << frame.get_frame_number()
+                                << ".bin";
+
+                            std::string filenameS = filename.str();
+
+                            submit(
+                                [this, filenameS, frame] {
+                                    std::string data(4 * frame.get_width() * frame.get_height(), '\0');
+                                    auto buffer = reinterpret_cast<uint8_t*>(&data[0]);
+
+                                    for (int y = 0; y < frame.get_height(); y++) {
+                                        for (int x = 0; x < frame.get_width(); x++, buffer += 4) {
+                                            to_ieee754_32(frame.get_distance(x, y), buffer);
+                                        }
+                                    }
+
+                                    write(filenameS, data);
+                                });
+                        }
+                    }
                 }
             };
 
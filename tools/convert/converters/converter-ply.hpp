@@ -5,6 +5,9 @@
 #define __RS_CONVERTER_CONVERTER_PLY_H
 
 
+#include <cstdio>
+#include <iterator>
+
 #include "../converter.hpp"
 
 
@@ -29,29 +32,45 @@ namespace rs2 {
 
                 void convert(rs2::frameset& frameset) override
                 {
-                    start_worker(
-                        [this, &frameset] {
-                            auto frameDepth = frameset.get_depth_frame();
-                            auto frameColor = frameset.get_color_frame();
+                    auto frameDepth = frameset.get_depth_frame();
+                    auto frameColor = frameset.get_color_frame();
 
-                            if (frameDepth && frameColor) {
-                                if (frames_map_get_and_set(rs2_stream::RS2_STREAM_ANY, frameDepth.get_frame_number())) {
-                                    return;
-                                }
+                    if (frameDepth && frameColor) {
+                        if (frames_map_get_and_set(rs2_stream::RS2_STREAM_ANY, frameDepth.get_frame_number())) {
+                            return;
+                        }
+
+                        std::stringstream filename;
+                        filename << _filePath
+                            << "_" << frameDepth.get_frame_number()
+                            << ".ply";
+
+                        std::string filenameS = filename.str();
 
+                        submit(
+                            [this, filenameS, frameDepth, frameColor] {
                                 rs2::pointcloud pc;
                                 pc.map_to(frameColor);
 
                                 auto points = pc.calculate(frameDepth);
 
-                                std::stringstream filename;
-                                filename << _filePath
-                                    << "_" << frameDepth.get_frame_number()
-                                    << ".ply";
+                                if (!_sink || !_sink->is_archive()) {
+                                    points.export_to_ply(filenameS, frameColor);
+                                    return;
+                                }
+
+                                // The export can only write to a file, it goes through a temporary one into the archive
+                                auto tempName = filenameS + ".tmp";
+                                points.export_to_ply(tempName, frameColor);
+
+                                std::ifstream fs(tempName, std::ios::binary);
+                                std::string data((std::istreambuf_iterator<char>(fs)), std::istreambuf_iterator<char>());
+                                fs.close();
+                                std::remove(tempName.c_str());
 
-                                points.export_to_ply(filename.str(), frameColor);
-                            }
-                        });
+                                write(filenameS, data);
+                            });
+                    }
                 }
             };
 
@@ -32,6 +32,8 @@ int main(int argc, char** argv) try
     ValueArg<string> outputFilenameBin("b", "output-bin", "output BIN (depth matrix) file(s) path", false, "", "bin-path");
     SwitchArg switchDepth("d", "depth", "convert depth frames (default - all supported)", false);
     SwitchArg switchColor("c", "color", "convert color frames (default - all supported)", false);
+    ValueArg<string> outputArchive("a", "archive", "write all the output files into a single tar archive", false, "", "tar-file");
+    ValueArg<unsigned int> threads("j", "threads", "number of encoding threads (default - number of cores)", false, thread::hardware_concurrency(), "threads");
 
     cmd.add(inputFilename);
     cmd.add(outputFilenamePng);
@@ -41,6 +43,8 @@ int main(int argc, char** argv) try
     cmd.add(outputFilenameBin);
     cmd.add(switchDepth);
     cmd.add(switchColor);
+    cmd.add(outputArchive);
+    cmd.add(threads);
     cmd.parse(argc, argv);
 
     vector<shared_ptr<rs2::tools::converter::converter_base>> converters;
@@ -86,6 +90,21 @@ int main(int argc, char** argv) try
         throw runtime_error("output not defined");
     }
 
+    // All the converters share the encoding threads and the output
+    auto pool = make_shared<rs2::tools::converter::worker_pool>(threads.getValue());
+    shared_ptr<rs2::tools::converter::output_sink> sink;
+    if (outputArchive.isSet()) {
+        sink = make_shared<rs2::tools::converter::tar_sink>(outputArchive.getValue());
+    }
+    else {
+        sink = make_shared<rs2::tools::converter::file_sink>();
+    }
+
+    for_each(converters.begin(), converters.end(),
+        [&pool, &sink] (shared_ptr<rs2::tools::converter::converter_base>& converter) {
+            converter->set_output(pool, sink);
+        });
+
     auto pipe = make_shared<rs2::pipeline>();
     rs2::config cfg;
     cfg.enable_device_from_file(inputFilename.getValue());
@@ -115,17 +134,21 @@ int main(int argc, char** argv) try
 
         frameNumber = frameset[0].get_frame_number();
 
+        // The encoding is queued to the pool, the next frameset is read while the previous ones are encoded
         for_each(converters.begin(), converters.end(),
             [&frameset] (shared_ptr<rs2::tools::converter::converter_base>& converter) {
                 converter->convert(frameset);
             });
-
-        for_each(converters.begin(), converters.end(),
-            [] (shared_ptr<rs2::tools::converter::converter_base>& converter) {
-                converter->wait();
-            });
     }
 
+    for_each(converters.begin(), converters.end(),
+        [] (shared_ptr<rs2::tools::converter::converter_base>& converter) {
+            converter->wait();
+        });
+
+    pipe->stop();
+    sink->close();
+
     cout << endl;
 
     for_each(converters.begin(), converters.end(),
@@ -3,6 +3,7 @@
 // Minimalistic command-line collect & analyze bandwidth/performance tool for Realsense Cameras.
 // The data is gathered and serialized in csv-compatible format for offline analysis.
 // Extract and store frame headers info for video streams; for IMU&Tracking streams also store the actual data
+// For long captures the records can be streamed into a binary log instead, optionally with the raw frame payloads
 // The utility is configured with command-line keys and requires user-provided config file to run
 // See rs-data-collect.h for config examples
 
@@ -19,6 +20,139 @@ using namespace TCLAP;
 using namespace rs_data_collect;
 
 
+bool record_ring::push(const void* record, size_t record_size, const void* payload, size_t payload_size)
+{
+    auto size = record_size + payload_size;
+    auto head = _head.load(std::memory_order_relaxed);
+    auto tail = _tail.load(std::memory_order_acquire);
+    if (_buffer.size() - (head - tail) < size)
+    {
+        dropped++;
+        return false;
+    }
+
+    copy_in(head, record, record_size);
+    copy_in(head + record_size, payload, payload_size);
+    _head.store(head + size, std::memory_order_release);
+    return true;
+}
+
+size_t record_ring::drain(std::ostream& out)
+{
+    auto tail = _tail.load(std::memory_order_relaxed);
+    auto head = _head.load(std::memory_order_acquire);
+    auto size = static_cast<size_t>(head - tail);
+    if (!size)
+        return 0;
+
+    auto pos = static_cast<size_t>(tail % _buffer.size());
+    auto first = std::min(size, _buffer.size() - pos);
+    out.write(reinterpret_cast<const char*>(_buffer.data() + pos), first);
+    if (first < size)
+        out.write(reinterpret_cast<const char*>(_buffer.data()), size - first);
+
+    _tail.store(head, std::memory_order_release);
+    return size;
+}
+
+void record_ring::copy_in(uint64_t pos, const void* src, size_t size)
+{
+    auto offset = static_cast<size_t>(pos % _buffer.size());
+    auto first = std::min(size, _buffer.size() - offset);
+    auto bytes = static_cast<const uint8_t*>(src);
+    std::copy(bytes, bytes + first, _buffer.data() + offset);
+    std::copy(bytes + first, bytes + size, _buffer.data());
+}
+
+binary_logger::binary_logger(const std::string& filename, const std::vector<rs2::stream_profile>& profiles,
+    size_t ring_size, bool raw_payload) : _file(filename, std::ios::binary), _raw_payload(raw_payload)
+{
+    if (!_file.is_open())
+        throw runtime_error(stringify() << "Cannot open the requested output file " << filename << ", please check permissions");
+
+    binary_file_header header{ BINARY_FILE_MAGIC, BINARY_FORMAT_VERSION, static_cast<uint32_t>(profiles.size()) };
+    _file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    for (auto&& profile : profiles)
+    {
+        binary_stream_header stream{ static_cast<uint32_t>(profile.stream_type()), static_cast<uint32_t>(profile.stream_index()),
+            static_cast<uint32_t>(profile.format()), static_cast<uint32_t>(profile.fps()), 0, 0 };
+        if (auto vp = profile.as<rs2::video_stream_profile>())
+        {
+            stream.width = vp.width();
+            stream.height = vp.height();
+        }
+        _file.write(reinterpret_cast<const char*>(&stream), sizeof(stream));
+        _rings[std::make_pair(profile.stream_type(), profile.stream_index())].reset(new record_ring(ring_size));
+    }
+
+    _flusher = std::thread([this]() { flush_loop(); });
+}
+
+binary_logger::~binary_logger()
+{
+    close();
+}
+
+// Size of the frame buffer, the public API exposes it for video frames only
+static uint32_t frame_data_size(const rs2::frame& f)
+{
+    if (auto vf = f.as<rs2::video_frame>())
+        return static_cast<uint32_t>(vf.get_stride_in_bytes() * vf.get_height());
+    if (f.is<rs2::motion_frame>())
+        return sizeof(rs2_vector);
+    if (f.is<rs2::pose_frame>())
+        return sizeof(rs2_pose);
+    return 0;
+}
+
+void binary_logger::log(const binary_frame_record& record, const rs2::frame& f)
+{
+    auto it = _rings.find(std::make_pair(static_cast<rs2_stream>(record.stream_type), static_cast<int>(record.stream_index)));
+    if (it == _rings.end())
+        return;
+
+    auto& ring = *it->second;
+    ring.received++;
+
+    auto rec = record;
+    rec.payload_size = _raw_payload ? frame_data_size(f) : 0;
+    ring.push(&rec, sizeof(rec), f.get_data(), rec.payload_size);
+}
+
+void binary_logger::close()
+{
+    if (_stopping.exchange(true))
+        return;
+
+    _flusher.join();
+    _file.close();
+}
+
+const record_ring* binary_logger::ring(std::pair<rs2_stream, int> stream) const
+{
+    auto it = _rings.find(stream);
+    return it != _rings.end() ? it->second.get() : nullptr;
+}
+
+void binary_logger::flush_loop()
+{
+    // The rings are drained once more after the stop request, to catch the frames received until the sensors stopped
+    bool last_pass = false;
+    while (!last_pass)
+    {
+        last_pass = _stopping;
+
+        size_t written = 0;
+        for (auto&& kvp : _rings)
+            written += kvp.second->drain(_file);
+        _bytes_written += written;
+
+        if (!written && !last_pass)
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    _file.flush();
+}
+
 data_collector::data_collector(std::shared_ptr<rs2::device> dev,
     ValueArg<int>& timeout, ValueArg<int>& max_frames) : _dev(dev)
 {
@@ -134,11 +268,76 @@ void data_collector::save_data_to_file(const string& out_filename)
     }
 }
 
+void data_collector::start_binary_logging(const string& out_filename, size_t ring_size, bool raw_payload)
+{
+    _binary_log.reset(new binary_logger(out_filename, selected_stream_profiles, ring_size, raw_payload));
+    std::cout << "\nStreaming " << (raw_payload ? "frame records and payloads" : "frame records") << " into " << out_filename
+        << ", " << ring_size / (1024 * 1024) << "MB buffer per stream" << std::endl;
+}
+
+void data_collector::stop_binary_logging()
+{
+    if (!_binary_log)
+        return;
+
+    _binary_log->close();
+
+    std::cout << "\nBinary log completed, " << _binary_log->bytes_written() << " bytes written" << std::endl;
+    for (auto&& kvp : _binary_log->rings())
+    {
+        std::cout << "\t" << rs2_stream_to_string(kvp.first.first) << " " << kvp.first.second << ": "
+            << kvp.second->received << " frames received, " << kvp.second->dropped << " dropped on full buffer" << std::endl;
+    }
+}
+
+uint64_t data_collector::frames_collected(std::pair<rs2_stream, int> stream) const
+{
+    if (_binary_log)
+    {
+        auto ring = _binary_log->ring(stream);
+        return ring ? ring->received.load() : 0;
+    }
+
+    auto it = data_collection.find(stream);
+    return it != data_collection.end() ? it->second.size() : 0;
+}
+
 void data_collector::collect_frame_attributes(rs2::frame f, std::chrono::time_point<std::chrono::high_resolution_clock> start_time)
 {
     auto arrival_time = std::chrono::duration<double, std::milli>(chrono::high_resolution_clock::now() - start_time);
     auto stream_uid = std::make_pair(f.get_profile().stream_type(), f.get_profile().stream_index());
 
+    if (_binary_log)
+    {
+        if (frames_collected(stream_uid) >= _max_frames)
+            return;
+
+        binary_frame_record rec{ BINARY_RECORD_MAGIC,
+            static_cast<uint32_t>(stream_uid.first),
+            static_cast<uint32_t>(stream_uid.second),
+            static_cast<uint32_t>(f.get_frame_timestamp_domain()),
+            f.get_frame_number(),
+            f.get_timestamp(),
+            arrival_time.count() };
+
+        if (auto motion = f.as<rs2::motion_frame>())
+        {
+            auto axes = motion.get_motion_data();
+            rec.params[0] = axes.x; rec.params[1] = axes.y; rec.params[2] = axes.z;
+        }
+
+        if (auto pf = f.as<rs2::pose_frame>())
+        {
+            auto pose = pf.get_pose_data();
+            double params[] = { pose.translation.x, pose.translation.y, pose.translation.z,
+                pose.rotation.x, pose.rotation.y, pose.rotation.z, pose.rotation.w };
+            std::copy(std::begin(params), std::end(params), rec.params);
+        }
+
+        _binary_log->log(rec, f);
+        return;
+    }
+
     if (data_collection[stream_uid].size() < _max_frames)
     {
         frame_record rec{ f.get_frame_number(),
@@ -179,11 +378,14 @@ bool data_collector::collecting(std::chrono::time_point<std::chrono::high_resolu
     }
 
     bool collected_enough_frames = true;
+    bool any_collected = false;
+    for (auto&& profile : selected_stream_profiles)
+        any_collected |= frames_collected(std::make_pair(profile.stream_type(), profile.stream_index())) > 0;
+
     for (auto&& profile : selected_stream_profiles)
     {
-        auto key = std::make_pair(profile.stream_type(), profile.stream_index());
-        if (!data_collection.size() || (data_collection.find(key) != data_collection.end() &&
-            (data_collection[key].size() && data_collection[key].size() < _max_frames)))
+        auto frames = frames_collected(std::make_pair(profile.stream_type(), profile.stream_index()));
+        if (!any_collected || (frames && frames < _max_frames))
         {
             collected_enough_frames = false;
             break;
@@ -291,11 +493,19 @@ int main(int argc, char** argv) try
     ValueArg<int>    max_frames("m", "MaxFrames_Number", "Maximum number of frames-per-stream to receive", false, 100, "");
     ValueArg<string> out_file("f", "FullFilePath", "the file where the data will be saved to", false, "", "");
     ValueArg<string> config_file("c", "ConfigurationFile", "Specify file path with the requested configuration", false, "", "");
+    ValueArg<string> serial("s", "SerialNumber", "Serial number of the device to use, the first device is used by default", false, "", "");
+    SwitchArg        binary("b", "Binary", "Stream the frame records into a binary file during the capture instead of a csv at the end");
+    SwitchArg        raw_payload("r", "RawPayload", "Store the raw frame payloads in the binary file, implies binary mode");
+    ValueArg<int>    ring_size("", "BufferSize", "Size of the binary mode buffer of each stream (in MB)", false, DEF_RING_SIZE_MB, "");
 
     cmd.add(timeout);
     cmd.add(max_frames);
     cmd.add(out_file);
     cmd.add(config_file);
+    cmd.add(serial);
+    cmd.add(binary);
+    cmd.add(raw_payload);
+    cmd.add(ring_size);
     cmd.parse(argc, argv);
 
     std::cout << "Running rs-data-collect: ";
@@ -303,7 +513,8 @@ int main(int argc, char** argv) try
         std::cout << argv[i] << " ";
     std::cout << std::endl << std::endl;
 
-    auto output_file       = out_file.isSet() ? out_file.getValue() : DEF_OUTPUT_FILE_NAME;
+    bool binary_mode       = binary.getValue() || raw_payload.getValue();
+    auto output_file       = out_file.isSet() ? out_file.getValue() : binary_mode ? DEF_BINARY_FILE_NAME : DEF_OUTPUT_FILE_NAME;
 
     bool succeed = false;
     rs2::context ctx;
@@ -313,19 +524,30 @@ int main(int argc, char** argv) try
     {
         list = ctx.query_devices();
 
-        if (0== list.size())
+        std::shared_ptr<rs2::device> dev;
+        for (auto&& d : list)
+        {
+            if (!serial.isSet() || (d.supports(RS2_CAMERA_INFO_SERIAL_NUMBER) && serial.getValue() == d.get_info(RS2_CAMERA_INFO_SERIAL_NUMBER)))
+            {
+                dev = std::make_shared<rs2::device>(d);
+                break;
+            }
+        }
+
+        if (!dev)
         {
-            std::cout << "Connect Realsense Camera to proceed" << std::endl;
+            std::cout << "Connect Realsense Camera " << serial.getValue() << " to proceed" << std::endl;
             std::this_thread::sleep_for(std::chrono::seconds(3));
             continue;
         }
 
-        auto dev = std::make_shared<rs2::device>(list.front());
-
         data_collector  dc(dev,timeout,max_frames);         // Parser and the data aggregator
 
         dc.parse_and_configure(config_file);
 
+        if (binary_mode)
+            dc.start_binary_logging(output_file, static_cast<size_t>(ring_size.getValue()) * 1024 * 1024, raw_payload.getValue());
+
         //data_collection buffer;
         auto start_time = chrono::high_resolution_clock::now();
 
@@ -353,7 +575,10 @@ int main(int argc, char** argv) try
             sensor.close();
         }
 
-        dc.save_data_to_file(output_file);
+        if (binary_mode)
+            dc.stop_binary_logging();
+        else
+            dc.save_data_to_file(output_file);
 
         succeed = true;
     }
@@ -29,6 +29,9 @@ GYRO,1,1,200,MOTION_XYZ32F
 #include <fstream>
 #include <sstream>
 #include <map>
+#include <atomic>
+#include <thread>
+#include <memory>
 
 
 using namespace std;
@@ -38,6 +41,8 @@ namespace rs_data_collect
 {
     const uint64_t  DEF_FRAMES_NUMBER = 100;
     const std::string DEF_OUTPUT_FILE_NAME("frames_data.csv");
+    const std::string DEF_BINARY_FILE_NAME("frames_data.bin");
+    const int DEF_RING_SIZE_MB = 64;
 
     // Split string into token,  trim unreadable characters
     inline std::vector<std::string> tokenize(std::string line, char separator)
@@ -174,6 +179,92 @@ namespace rs_data_collect
         stop_on_any
     };
 
+    // Layout of the binary log: a file header, the description of each stream, then the frame records in arrival order.
+    // All the fields are little-endian, a record is immediately followed by payload_size bytes of the raw frame data
+#pragma pack(push, 1)
+    struct binary_file_header
+    {
+        uint32_t magic;             // 'RSDC'
+        uint32_t version;
+        uint32_t streams;           // Number of binary_stream_header that follow
+    };
+
+    struct binary_stream_header
+    {
+        uint32_t stream_type;
+        uint32_t stream_index;
+        uint32_t format;
+        uint32_t fps;
+        uint32_t width;             // Zero for non-video streams
+        uint32_t height;
+    };
+
+    struct binary_frame_record
+    {
+        uint32_t magic;             // 'RSFR', allows resynchronizing on a truncated file
+        uint32_t stream_type;
+        uint32_t stream_index;
+        uint32_t domain;
+        uint64_t frame_number;
+        double   timestamp;         // Device-based timestamp (msec)
+        double   arrival_time;      // Host arrival timestamp, relative to start streaming (msec)
+        double   params[7];         // Motion or pose data, as in the csv
+        uint32_t payload_size;
+    };
+#pragma pack(pop)
+
+    const uint32_t BINARY_FILE_MAGIC = 0x43445352;      // "RSDC"
+    const uint32_t BINARY_RECORD_MAGIC = 0x52465352;    // "RSFR"
+    const uint32_t BINARY_FORMAT_VERSION = 1;
+
+    // Lock-free byte queue for a single producer (the sensor callback) and a single consumer (the flusher).
+    // Only whole records are pushed, so a record never straddles two drains. When the queue is full the record is dropped
+    // and counted, since blocking the callback would stall the sensor
+    class record_ring
+    {
+    public:
+        explicit record_ring(size_t capacity) : _buffer(capacity) {}
+
+        bool push(const void* record, size_t record_size, const void* payload, size_t payload_size);
+        size_t drain(std::ostream& out);
+
+        std::atomic<uint64_t> received{ 0 };
+        std::atomic<uint64_t> dropped{ 0 };
+
+    private:
+        void copy_in(uint64_t pos, const void* src, size_t size);
+
+        std::vector<uint8_t>    _buffer;
+        std::atomic<uint64_t>   _head{ 0 };     // Total bytes pushed
+        std::atomic<uint64_t>   _tail{ 0 };     // Total bytes drained
+    };
+
+    // Streams the frame records into a file from a background thread, so the memory used does not grow with the capture length
+    class binary_logger
+    {
+    public:
+        binary_logger(const std::string& filename, const std::vector<rs2::stream_profile>& profiles,
+            size_t ring_size, bool raw_payload);
+        ~binary_logger();
+
+        void log(const binary_frame_record& record, const rs2::frame& f);
+        void close();
+
+        const record_ring* ring(std::pair<rs2_stream, int> stream) const;
+        const std::map<std::pair<rs2_stream, int>, std::unique_ptr<record_ring>>& rings() const { return _rings; }
+        uint64_t bytes_written() const { return _bytes_written; }
+
+    private:
+        void flush_loop();
+
+        std::ofstream   _file;
+        std::map<std::pair<rs2_stream, int>, std::unique_ptr<record_ring>> _rings;  // Created up front, never modified while streaming
+        bool            _raw_payload;
+        std::atomic<bool> _stopping{ false };
+        std::atomic<uint64_t> _bytes_written{ 0 };
+        std::thread     _flusher;
+    };
+
     class data_collector
     {
     public:
@@ -184,6 +275,8 @@ namespace rs_data_collect
 
         void parse_and_configure(ValueArg<string>& config_file);
         void save_data_to_file(const string& out_filename);
+        void start_binary_logging(const string& out_filename, size_t ring_size, bool raw_payload);
+        void stop_binary_logging();
         void collect_frame_attributes(rs2::frame f, std::chrono::time_point<std::chrono::high_resolution_clock> start_time);
         bool collecting(std::chrono::time_point<std::chrono::high_resolution_clock> start_time);
 
@@ -238,6 +331,7 @@ namespace rs_data_collect
 
         std::shared_ptr<rs2::device>        _dev;
         std::map<std::pair<rs2_stream, int>, std::vector<frame_record>> data_collection;
+        std::unique_ptr<binary_logger>      _binary_log;
         std::vector<stream_request>         requests_to_go, user_requests;
         std::vector<rs2::sensor>            active_sensors;
         std::vector<rs2::stream_profile>    selected_stream_profiles;
@@ -250,5 +344,8 @@ namespace rs_data_collect
 
         // Assign the user configuration to the selected device
         bool configure_sensors();
+
+        // Frames received so far for the stream, from either the csv buffers or the binary log
+        uint64_t frames_collected(std::pair<rs2_stream, int> stream) const;
     };
 }
@@ -7,6 +7,11 @@
 #include <vector>
 #include <mutex>
 #include <array>
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <thread>
 #include <imgui.h>
 #include <librealsense2/rsutil.h>
 #include <librealsense2/rs.hpp>
@@ -16,6 +21,101 @@ namespace rs2
 {
     namespace depth_quality
     {
+        // Runs the ranges of a job on a fixed set of threads, the calling thread included. Each metrics_model owns one,
+        // an application scoring several cameras at once gives each camera its own
+        class worker_pool
+        {
+        public:
+            // 0 selects the number of hardware threads
+            explicit worker_pool(unsigned threads = 0)
+            {
+                if (!threads)
+                    threads = std::max(1u, std::thread::hardware_concurrency());
+                for (unsigned i = 1; i < threads; ++i)
+                    _threads.emplace_back([this, i]() { work(i); });
+            }
+
+            ~worker_pool()
+            {
+                {
+                    std::lock_guard<std::mutex> lock(_m);
+                    _active = false;
+                }
+                _wake.notify_all();
+                for (auto&& t : _threads)
+                    t.join();
+            }
+
+            unsigned size() const { return unsigned(_threads.size()) + 1; }
+
+            // Splits [0, count) into size() ranges and calls body(range, begin, end) for each, returns once all are done
+            void for_ranges(size_t count, std::function<void(unsigned, size_t, size_t)> body)
+            {
+                auto n = size();
+                std::function<void(unsigned)> job = [&](unsigned i) { body(i, count * i / n, count * (i + 1) / n); };
+                if (n == 1)
+                    return job(0);
+
+                {
+                    std::lock_guard<std::mutex> lock(_m);
+                    _job = &job;
+                    _busy = n - 1;
+                    _error = nullptr;
+                    ++_generation;
+                }
+                _wake.notify_all();
+
+                std::exception_ptr error;
+                try { job(0); }
+                catch (...) { error = std::current_exception(); }
+
+                std::unique_lock<std::mutex> lock(_m);
+                _done.wait(lock, [&]() { return _busy == 0; });
+                _job = nullptr;
+                if (!error) error = _error;
+                if (error)
+                    std::rethrow_exception(error);
+            }
+
+        private:
+            worker_pool(const worker_pool&) = delete;
+            worker_pool& operator=(const worker_pool&) = delete;
+
+            void work(unsigned index)
+            {
+                unsigned long long seen = 0;
+                std::unique_lock<std::mutex> lock(_m);
+                while (true)
+                {
+                    _wake.wait(lock, [&]() { return !_active || _generation != seen; });
+                    if (!_active)
+                        return;
+                    seen = _generation;
+
+                    auto job = _job;
+                    lock.unlock();
+                    std::exception_ptr error;
+                    try { (*job)(index); }
+                    catch (...) { error = std::current_exception(); }
+                    lock.lock();
+
+                    if (error && !_error)
+                        _error = error;
+                    if (--_busy == 0)
+                        _done.notify_all();
+                }
+            }
+
+            std::vector<std::thread>        _threads;
+            std::mutex                      _m;
+            std::condition_variable         _wake, _done;
+            std::function<void(unsigned)>*  _job = nullptr;
+            std::exception_ptr              _error;
+            unsigned long long              _generation = 0;
+            unsigned                        _busy = 0;
+            bool                            _active = true;
+        };
+
         struct snapshot_metrics
         {
             int width;
@@ -52,7 +152,8 @@ namespace rs2
             const float plane_fit_to_ground_truth_mm,
             const float distance_mm,
             bool record,
-            std::vector<single_metric_data>& samples)>;
+            std::vector<single_metric_data>& samples,
+            worker_pool& pool)>;
 
         inline plane plane_from_point_and_normal(const rs2::float3& point, const rs2::float3& normal)
         {
@@ -60,24 +161,49 @@ namespace rs2
         }
 
         //Based on: http://www.ilikebigbits.com/blog/2015/3/2/plane-from-points
-        inline plane plane_from_points(const std::vector<rs2::float3> points)
+        // The sums are reduced per range of points on the pool, in double precision
+        inline plane plane_from_points(const std::vector<rs2::float3>& points, worker_pool& pool)
         {
             if (points.size() < 3) throw std::runtime_error("Not enough points to calculate plane");
 
-            rs2::float3 sum = { 0,0,0 };
-            for (auto point : points) sum = sum + point;
+            std::vector<std::array<double, 6>> partial(pool.size());
+            pool.for_ranges(points.size(), [&](unsigned r, size_t begin, size_t end)
+            {
+                double x = 0, y = 0, z = 0;
+                for (size_t i = begin; i < end; ++i)
+                {
+                    x += points[i].x;
+                    y += points[i].y;
+                    z += points[i].z;
+                }
+                partial[r] = { { x, y, z } };
+            });
 
-            rs2::float3 centroid = sum / float(points.size());
+            double sum[3] = { 0, 0, 0 };
+            for (auto&& p : partial)
+                for (int i = 0; i < 3; ++i) sum[i] += p[i];
+            rs2::float3 centroid = { float(sum[0] / points.size()), float(sum[1] / points.size()), float(sum[2] / points.size()) };
+
+            pool.for_ranges(points.size(), [&](unsigned r, size_t begin, size_t end)
+            {
+                double xx = 0, xy = 0, xz = 0, yy = 0, yz = 0, zz = 0;
+                for (size_t i = begin; i < end; ++i)
+                {
+                    rs2::float3 temp = points[i] - centroid;
+                    xx += temp.x * temp.x;
+                    xy += temp.x * temp.y;
+                    xz += temp.x * temp.z;
+                    yy += temp.y * temp.y;
+                    yz += temp.y * temp.z;
+                    zz += temp.z * temp.z;
+                }
+                partial[r] = { { xx, xy, xz, yy, yz, zz } };
+            });
 
             double xx = 0, xy = 0, xz = 0, yy = 0, yz = 0, zz = 0;
-            for (auto point : points) {
-                rs2::float3 temp = point - centroid;
-                xx += temp.x * temp.x;
-                xy += temp.x * temp.y;
-                xz += temp.x * temp.z;
-                yy += temp.y * temp.y;
-                yz += temp.y * temp.z;
-                zz += temp.z * temp.z;
+            for (auto&& p : partial)
+            {
+                xx += p[0]; xy += p[1]; xz += p[2]; yy += p[3]; yz += p[4]; zz += p[5];
             }
 
             double det_x = yy*zz - yz*yz;
@@ -110,6 +236,147 @@ namespace rs2
             return plane_from_point_and_normal(centroid, dir.normalize());
         }
 
+        inline plane plane_from_points(const std::vector<rs2::float3>& points)
+        {
+            worker_pool single(1);
+            return plane_from_points(points, single);
+        }
+
+        // Deprojects the valid pixels of the ROI, in row order. Each range of rows is deprojected on its own thread
+        inline std::vector<rs2::float3> roi_points(const rs2::video_frame& frame, float units, const rs2_intrinsics* intrin,
+            const rs2::region_of_interest& roi, worker_pool& pool)
+        {
+            auto pixels = (const uint16_t*)frame.get_data();
+            const auto w = frame.get_width();
+            const int rows = std::max(0, roi.max_y - roi.min_y);
+            const int columns = std::max(0, roi.max_x - roi.min_x);
+
+            std::vector<std::vector<rs2::float3>> partial(pool.size());
+            pool.for_ranges(rows, [&](unsigned r, size_t begin, size_t end)
+            {
+                auto& out = partial[r];
+                out.reserve((end - begin) * columns);
+
+                // The pixel direction does not depend on the depth, deprojecting at 1 gives the factors of each pixel
+                std::vector<float> x_factors(columns), y_factors(columns);
+                for (size_t j = begin; j < end; ++j)
+                {
+                    const int y = roi.min_y + int(j);
+                    for (int i = 0; i < columns; ++i)
+                    {
+                        float pixel[2] = { float(roi.min_x + i), float(y) };
+                        float point[3];
+                        rs2_deproject_pixel_to_point(point, intrin, pixel, 1.f);
+                        x_factors[i] = point[0];
+                        y_factors[i] = point[1];
+                    }
+
+                    auto row = pixels + y * w + roi.min_x;
+                    for (int i = 0; i < columns; ++i)
+                    {
+                        if (auto depth_raw = row[i])
+                        {
+                            auto distance = depth_raw * units;
+                            out.push_back({ distance * x_factors[i], distance * y_factors[i], distance });
+                        }
+                    }
+                }
+            });
+
+            std::vector<rs2::float3> points;
+            size_t total = 0;
+            for (auto&& p : partial) total += p.size();
+            points.reserve(total);
+            for (auto&& p : partial) points.insert(points.end(), p.begin(), p.end());
+            return points;
+        }
+
+        struct plane_fit_metrics
+        {
+            float fill_rate;            // Percentage of the ROI pixels with depth
+            float rms_error_mm;         // Plane fit RMS error (spatial noise)
+            float rms_error_percent;    // The same, as a percentage of the distance
+            float subpixel_rms;         // In pixels
+            float z_accuracy;           // Median error to the ground truth as a percentage of it, 0 without ground truth
+        };
+
+        // The plane fit metrics of the points of a ROI. The 0.5% nearest and farthest points are left out as outliers,
+        // the others are evaluated in ranges on the pool. Without a plane fit only the fill rate is set
+        inline plane_fit_metrics calculate_plane_fit_metrics(const std::vector<rs2::float3>& points, const plane p,
+            const rs2::region_of_interest roi, const float baseline_mm, const float focal_length_pixels, const float depth_units,
+            const int ground_truth_mm, const bool plane_fit, const float plane_fit_to_ground_truth_mm, const float distance_mm,
+            worker_pool& pool)
+        {
+            static const float TO_MM = 1000.f;
+            static const float TO_PERCENT = 100.f;
+
+            plane_fit_metrics result{};
+            result.fill_rate = points.size() / float((roi.max_x - roi.min_x)*(roi.max_y - roi.min_y)) * TO_PERCENT;
+            if (!plane_fit || points.empty())
+                return result;
+
+            const float bf_factor = baseline_mm * focal_length_pixels * depth_units; // also convert point units from mm to meter
+
+            // Remove outliers [below 0.5% and above 99.5%), partitioning by depth is enough to find them
+            std::vector<rs2::float3> points_set = points;
+            size_t outliers = points_set.size() / 200;
+            auto by_depth = [](const rs2::float3& a, const rs2::float3& b) { return a.z < b.z; };
+            if (outliers)
+            {
+                std::nth_element(points_set.begin(), points_set.begin() + outliers, points_set.end(), by_depth);
+                std::nth_element(points_set.begin() + outliers, points_set.end() - outliers, points_set.end(), by_depth);
+            }
+            const auto first = points_set.data() + outliers;
+            const size_t count = points_set.size() - 2 * outliers;
+
+            // Convert Z values into Depth values by aligning the Fitted plane with the Ground Truth (GT) plane
+            // Calculate distance and disparity of Z values to the fitted plane.
+            // Use the rotated plane fit to calculate GT errors
+            std::vector<float> gt_errors(ground_truth_mm ? count : 0);
+            std::vector<std::array<double, 2>> partial(pool.size());
+            pool.for_ranges(count, [&](unsigned r, size_t begin, size_t end)
+            {
+                double sq_distances = 0, sq_disparities = 0;
+                for (size_t i = begin; i < end; ++i)
+                {
+                    auto point = first[i];
+                    // Find distance from point to the reconstructed plane
+                    auto dist2plane = p.a*point.x + p.b*point.y + p.c*point.z + p.d;
+                    // Project the point to plane in 3D and find distance to the intersection point
+                    rs2::float3 plane_intersect = { float(point.x - dist2plane*p.a),
+                                                    float(point.y - dist2plane*p.b),
+                                                    float(point.z - dist2plane*p.c) };
+
+                    auto distance = dist2plane * TO_MM;
+                    auto disparity = bf_factor / point.length() - bf_factor / plane_intersect.length();
+                    sq_distances += distance * distance;
+                    sq_disparities += disparity * disparity;
+                    // The negative dist2plane represents a point closer to the camera than the fitted plane
+                    if (ground_truth_mm) gt_errors[i] = plane_fit_to_ground_truth_mm + (dist2plane * TO_MM);
+                }
+                partial[r] = { { sq_distances, sq_disparities } };
+            });
+
+            double plane_fit_err_sqr_sum = 0, total_sq_disparity_diff = 0;
+            for (auto&& s : partial)
+            {
+                plane_fit_err_sqr_sum += s[0];
+                total_sq_disparity_diff += s[1];
+            }
+
+            if (ground_truth_mm && count)
+            {
+                std::nth_element(gt_errors.begin(), gt_errors.begin() + count / 2, gt_errors.end());
+                result.z_accuracy = TO_PERCENT * (gt_errors[count / 2] / ground_truth_mm);
+            }
+
+            // Sub-pixel RMS for Stereo-based Depth sensors, and Plane Fit RMS (Spatial Noise) mm
+            result.subpixel_rms = static_cast<float>(std::sqrt(total_sq_disparity_diff / count));
+            result.rms_error_mm = static_cast<float>(std::sqrt(plane_fit_err_sqr_sum / count));
+            result.rms_error_percent = TO_PERCENT * (result.rms_error_mm / distance_mm);
+            return result;
+        }
+
         inline double evaluate_pixel(const plane& p, const rs2_intrinsics* intrin, float x, float y, float distance, float3& output)
         {
             float pixel[2] = { x, y };
@@ -145,43 +412,21 @@ namespace rs2
             bool plane_fit_present,
             std::vector<single_metric_data>& samples,
             bool record,
-            callback_type callback)
+            callback_type callback,
+            worker_pool& pool)
         {
-            auto pixels = (const uint16_t*)frame.get_data();
             const auto w = frame.get_width();
             const auto h = frame.get_height();
 
             snapshot_metrics result{ w, h, roi, {} };
 
-            std::mutex m;
-
-            std::vector<rs2::float3> roi_pixels;
-
-//#pragma omp parallel for - TODO optimization envisaged
-            for (int y = roi.min_y; y < roi.max_y; ++y)
-                for (int x = roi.min_x; x < roi.max_x; ++x)
-                {
-                    auto depth_raw = pixels[y*w + x];
-
-                    if (depth_raw)
-                    {
-                        // units is float
-                        float pixel[2] = { float(x), float(y) };
-                        float point[3];
-                        auto distance = depth_raw * units;
-
-                        rs2_deproject_pixel_to_point(point, intrin, pixel, distance);
-
-                        std::lock_guard<std::mutex> lock(m);
-                        roi_pixels.push_back({ point[0], point[1], point[2] });
-                    }
-                }
+            std::vector<rs2::float3> roi_pixels = roi_points(frame, units, intrin, roi, pool);
 
             if (roi_pixels.size() < 3) { // Not enough pixels in RoI to fit a plane
                 return result;
             }
 
-            plane p = plane_from_points(roi_pixels);
+            plane p = plane_from_points(roi_pixels, pool);
 
             if (p == plane{ 0, 0, 0, 0 }) { // The points in RoI don't span a valid plane
                 return result;
@@ -205,7 +450,7 @@ namespace rs2
             result.angle = static_cast<float>(std::acos(std::abs(p.c)) / M_PI * 180.);
 
             callback(roi_pixels, p, roi, baseline_mm, intrin->fx, ground_truth_mm, plane_fit_present,
-                plane_fit_to_gt_offset_mm, result.distance, record, samples);
+                plane_fit_to_gt_offset_mm, result.distance, record, samples, pool);
 
             // Calculate normal
             auto n = float3{ p.a, p.b, p.c };
@@ -731,7 +731,7 @@ namespace rs2
                 frameset f;
                 if (_pipe.poll_for_frames(&f))
                 {
-                    _viewer_model.ppf.frames_queue[f.get_profile().unique_id()].enqueue(f);
+                    _viewer_model.ppf.enqueue(f.get_profile().unique_id(), f);
                 }
                 frame dpt = _viewer_model.handle_ready_frames(viewer_rect, win, 1, _error_message);
                 if (dpt)
@@ -929,7 +929,7 @@ namespace rs2
 
                             std::tie(gt_mm, plane_fit_set) = get_inputs();
 
-                            auto metrics = analyze_depth_image(f, su, baseline, &intrin, roi, gt_mm, plane_fit_set, sample, _recorder.is_recording(), callback);
+                            auto metrics = analyze_depth_image(f, su, baseline, &intrin, roi, gt_mm, plane_fit_set, sample, _recorder.is_recording(), callback, _pool);
 
                             {
                                 std::lock_guard<std::mutex> lock(_m);
@@ -316,6 +316,7 @@ namespace rs2
             metrics_model(const metrics_model&);
 
             frame_queue             _frame_queue;
+            worker_pool             _pool;              // Computes the metrics of each frame of the worker thread
             std::thread             _worker_thread;
 
             rs2_intrinsics          _depth_intrinsic;
@@ -7,6 +7,8 @@
 #include <map>
 #include <set>
 #include <cstring>
+#include <chrono>
+#include <thread>
 
 #include "tclap/CmdLine.h"
 
@@ -163,18 +165,27 @@ int main(int argc, char** argv) try
     SwitchArg show_options("o", "option", "Show all supported options per subdevice");
     SwitchArg show_modes("m", "modes", "Show all supported stream modes per subdevice");
     SwitchArg show_calibration_data("c", "calib_data", "Show extrinsic and intrinsic of all subdevices");
+    SwitchArg startup_time("t", "startup_time", "Measure the time to enumerate and open the devices, one by one and concurrently");
     cmd.add(compact_view_arg);
     cmd.add(show_options);
     cmd.add(show_modes);
     cmd.add(show_calibration_data);
+    cmd.add(startup_time);
 
     cmd.parse(argc, argv);
 
     log_to_console(RS2_LOG_SEVERITY_ERROR);
 
+    using clock = chrono::high_resolution_clock;
+    auto elapsed_ms = [](clock::time_point start) {
+        return chrono::duration_cast<chrono::duration<double, milli>>(clock::now() - start).count();
+    };
+
     // Obtain a list of devices currently present on the system
+    auto query_start = clock::now();
     context ctx;
     auto devices = ctx.query_devices();
+    auto query_time = elapsed_ms(query_start);
     size_t device_count = devices.size();
     if (!device_count)
     {
@@ -182,6 +193,48 @@ int main(int argc, char** argv) try
         return EXIT_SUCCESS;
     }
 
+    if (startup_time.getValue())
+    {
+        cout << left << setw(30) << "Query devices" << fixed << setprecision(1) << query_time << " ms" << endl;
+
+        // Opening a device reads its identity over the firmware monitor, which dominates startup on multi-camera rigs
+        auto sequential_start = clock::now();
+        for (auto i = 0; i < device_count; ++i)
+        {
+            auto device_start = clock::now();
+            auto dev = devices[i];
+            auto name = string(dev.get_info(RS2_CAMERA_INFO_NAME)) + " " + dev.get_info(RS2_CAMERA_INFO_SERIAL_NUMBER);
+            cout << left << setw(30) << name << elapsed_ms(device_start) << " ms" << endl;
+        }
+        cout << left << setw(30) << "Open one by one" << elapsed_ms(sequential_start) << " ms" << endl;
+
+        auto concurrent_start = clock::now();
+        vector<thread> openers;
+        vector<string> errors(device_count);
+        for (auto i = 0; i < device_count; ++i)
+        {
+            openers.emplace_back([&devices, &errors, i]() {
+                try
+                {
+                    auto dev = devices[i];
+                }
+                catch (const error& e)
+                {
+                    errors[i] = e.what();
+                }
+            });
+        }
+        for (auto&& opener : openers)
+            opener.join();
+        cout << left << setw(30) << "Open concurrently" << elapsed_ms(concurrent_start) << " ms" << endl;
+
+        for (auto&& e : errors)
+            if (!e.empty())
+                cerr << "Failed to open a device: " << e << endl;
+
+        return EXIT_SUCCESS;
+    }
+
     if (compact_view_arg.getValue())
     {
         cout << left << setw(30) << "Device Name"
@@ -1,16 +1,36 @@
 #include "fw-log-data.h"
-#include <sstream>
-#include <iomanip>
-#include <locale>
+#include <cstdio>
 #include <string>
 
 using namespace std;
 
-# define SET_WIDTH_AND_FILL(num, element) \
-setfill(' ') << setw(num) << left << element \
-
 namespace fw_logger
 {
+    // Left aligned columns, as with std::left and std::setw, longer values are not cut
+    static void append_column(string* dest, const char* value, size_t length, size_t width)
+    {
+        dest->append(value, length);
+        if (length < width)
+            dest->append(width - length, ' ');
+    }
+
+    static void append_column(string* dest, const string& value, size_t width)
+    {
+        append_column(dest, value.data(), value.size(), width);
+    }
+
+    static void append_column(string* dest, uint64_t value, size_t width)
+    {
+        char digits[20];
+        auto n = sizeof(digits);
+        do
+        {
+            digits[--n] = char('0' + value % 10);
+            value /= 10;
+        } while (value);
+        append_column(dest, digits + n, sizeof(digits) - n, width);
+    }
+
     fw_log_data::fw_log_data(void)
     {
         magic_number = 0;
@@ -37,19 +57,26 @@ namespace fw_logger
 
     string fw_log_data::to_string()
     {
-        stringstream fmt;
-
-        fmt << SET_WIDTH_AND_FILL(6, sequence)
-            << SET_WIDTH_AND_FILL(30, file_name)
-            << SET_WIDTH_AND_FILL(6, group_id)
-            << SET_WIDTH_AND_FILL(15, thread_name)
-            << SET_WIDTH_AND_FILL(6, severity)
-            << SET_WIDTH_AND_FILL(6, line)
-            << SET_WIDTH_AND_FILL(15, timestamp)
-            << SET_WIDTH_AND_FILL(15, delta)
-            << SET_WIDTH_AND_FILL(30, message);
-
-        auto str = fmt.str();
+        string str;
+        append_to(&str);
         return str;
     }
+
+    void fw_log_data::append_to(string* dest) const
+    {
+        // The delta is printed as a stream would print a double
+        char delta_str[32];
+        auto delta_length = snprintf(delta_str, sizeof(delta_str), "%g", delta);
+
+        dest->reserve(dest->size() + 129 + message.size());
+        append_column(dest, sequence, 6);
+        append_column(dest, file_name, 30);
+        append_column(dest, group_id, 6);
+        append_column(dest, thread_name, 15);
+        append_column(dest, severity, 6);
+        append_column(dest, line, 6);
+        append_column(dest, timestamp, 15);
+        append_column(dest, delta_str, delta_length > 0 ? size_t(delta_length) : 0, 15);
+        append_column(dest, message, 30);
+    }
 }
@@ -84,5 +84,7 @@ namespace fw_logger
         std::string thread_name;
 
         std::string to_string();
+        // Appends the columns of the line, for callers that format many lines into one buffer
+        void append_to(std::string* dest) const;
     };
 }
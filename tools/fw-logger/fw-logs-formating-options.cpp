@@ -80,6 +80,73 @@ namespace fw_logger
     bool fw_logs_formating_options::initialize_from_xml()
     {
         fw_logs_xml_helper fw_logs_xml(_xml_full_file_path);
-        return fw_logs_xml.build_log_meta_data(this);
+        auto res = fw_logs_xml.build_log_meta_data(this);
+        compile();
+        return res;
+    }
+
+    static const string& unknown_name()
+    {
+        static const string name = "Unknown";
+        return name;
+    }
+
+    void fw_logs_formating_options::compile()
+    {
+        _events.clear();
+        _format_ops.clear();
+        _format_pool.clear();
+        _file_names.clear();
+        _thread_names.clear();
+
+        // The ids are the bit fields of the log header, the tables are bounded by their widths
+        for (auto&& event : _fw_logs_event_list)
+        {
+            if (event.first < 0 || event.first > 0xffff) continue;
+            if (size_t(event.first) >= _events.size())
+                _events.resize(event.first + 1);
+
+            auto& compiled = _events[event.first];
+            compiled.first_op = uint32_t(_format_ops.size());
+            string_formatter::compile(event.second.line, event.second.num_of_params, &_format_pool, &_format_ops);
+            compiled.op_count = uint32_t(_format_ops.size()) - compiled.first_op;
+            compiled.valid = true;
+        }
+
+        for (auto&& file : _fw_logs_file_names_list)
+        {
+            if (file.first < 0 || file.first > 0x7ff) continue;
+            if (size_t(file.first) >= _file_names.size())
+                _file_names.resize(file.first + 1, unknown_name());
+            _file_names[file.first] = file.second;
+        }
+
+        for (auto&& thread : _fw_logs_thread_names_list)
+        {
+            if (thread.first < 0 || thread.first > 0x7) continue;
+            if (size_t(thread.first) >= _thread_names.size())
+                _thread_names.resize(thread.first + 1, unknown_name());
+            _thread_names[thread.first] = thread.second;
+        }
+    }
+
+    bool fw_logs_formating_options::get_event_format(uint32_t id, const format_op** ops, size_t* count) const
+    {
+        if (id >= _events.size() || !_events[id].valid)
+            return false;
+
+        *ops = _format_ops.data() + _events[id].first_op;
+        *count = _events[id].op_count;
+        return true;
+    }
+
+    const string& fw_logs_formating_options::get_file_name(uint32_t id) const
+    {
+        return id < _file_names.size() ? _file_names[id] : unknown_name();
+    }
+
+    const string& fw_logs_formating_options::get_thread_name(uint32_t thread_id) const
+    {
+        return thread_id < _thread_names.size() ? _thread_names[thread_id] : unknown_name();
     }
 }
@@ -1,7 +1,9 @@
 #pragma once
 #include <unordered_map>
 #include <string>
+#include <vector>
 #include <stdint.h>
+#include "string-formatter.h"
 
 #ifdef ANDROID
 #include "../../common/android_helpers.h"
@@ -32,8 +34,29 @@ namespace fw_logger
         bool get_thread_name(uint32_t thread_id, std::string* thread_name) const;
         bool initialize_from_xml();
 
+        // The compiled tables, indexed by the ids of the log header. Unknown ids have no ops and the "Unknown" name
+        bool get_event_format(uint32_t id, const format_op** ops, size_t* count) const;
+        const std::string& get_file_name(uint32_t id) const;
+        const std::string& get_thread_name(uint32_t thread_id) const;
+        const std::string& get_format_pool() const { return _format_pool; }
+
     private:
         friend fw_logs_xml_helper;
+        // Flattens the lists read from the XML, so that formatting a log costs no lookup or parsing
+        void compile();
+
+        struct compiled_event
+        {
+            uint32_t first_op = 0;
+            uint32_t op_count = 0;
+            bool valid = false;
+        };
+        std::vector<compiled_event> _events;
+        std::vector<format_op> _format_ops;
+        std::string _format_pool;
+        std::vector<std::string> _file_names;
+        std::vector<std::string> _thread_names;
+
         std::unordered_map<int, fw_log_event> _fw_logs_event_list;
         std::unordered_map<int, std::string> _fw_logs_file_names_list;
         std::unordered_map<int, std::string> _fw_logs_thread_names_list;
@@ -1,8 +1,8 @@
 #include "fw-logs-parser.h"
-#include <regex>
 #include <sstream>
 #include "string-formatter.h"
 #include "stdint.h"
+#include <cstring>
 
 using namespace std;
 
@@ -22,36 +22,35 @@ namespace fw_logger
     }
 
     vector<string> fw_logs_parser::get_fw_log_lines(const fw_logs_binary_data& fw_logs_data_binary)
+    {
+        return get_fw_log_lines(fw_logs_data_binary.logs_buffer.data(), fw_logs_data_binary.logs_buffer.size());
+    }
+
+    vector<string> fw_logs_parser::get_fw_log_lines(const uint8_t* logs, size_t size)
     {
         vector<string> string_vector;
-        int num_of_lines = int(fw_logs_data_binary.logs_buffer.size()) / sizeof(fw_log_binary);
-        auto temp_pointer = reinterpret_cast<fw_log_binary const*>(fw_logs_data_binary.logs_buffer.data());
+        auto num_of_lines = size / sizeof(fw_log_binary);
+        string_vector.reserve(num_of_lines);
 
-        for (int i = 0; i < num_of_lines; i++)
-        {
-            string line;
-            auto log = const_cast<char*>(reinterpret_cast<char const*>(temp_pointer));
-            line = generate_log_line(log);
-            string_vector.push_back(line);
-            temp_pointer++;
-        }
+        for (size_t i = 0; i < num_of_lines; i++)
+            string_vector.push_back(generate_log_line(reinterpret_cast<const char*>(logs + i * sizeof(fw_log_binary))));
         return string_vector;
     }
 
-    string fw_logs_parser::generate_log_line(char* fw_logs)
+    string fw_logs_parser::generate_log_line(const char* fw_logs)
     {
-        fw_log_data log_data;
-        fill_log_data(fw_logs, &log_data);
+        fill_log_data(fw_logs, &_log_data);
 
-        return log_data.to_string();
+        string line;
+        _log_data.append_to(&line);
+        return line;
     }
 
     void fw_logs_parser::fill_log_data(const char* fw_logs, fw_log_data* log_data)
     {
-        string_formatter reg_exp;
-        fw_log_event log_event_data;
-
-        auto* log_binary = reinterpret_cast<const fw_log_binary*>(fw_logs);
+        fw_log_binary binary;
+        memcpy(&binary, fw_logs, sizeof(binary)); // The records of a file or a response buffer are not aligned
+        auto* log_binary = &binary;
 
         //parse first DWORD
         log_data->magic_number = static_cast<uint32_t>(log_binary->dword1.bits.magic_number);
@@ -85,12 +84,23 @@ namespace fw_logger
         }
 
         _last_timestamp = log_data->timestamp;
-        _fw_logs_formating_options.get_event_data(log_data->event_id, &log_event_data);
         uint32_t params[3] = { log_data->p1, log_data->p2, log_data->p3 };
-        reg_exp.generate_message(log_event_data.line, log_event_data.num_of_params, params, &log_data->message);
+        const format_op* ops = nullptr;
+        size_t count = 0;
+        log_data->message.clear();
+        if (_fw_logs_formating_options.get_event_format(log_data->event_id, &ops, &count))
+        {
+            string_formatter::format(ops, count, _fw_logs_formating_options.get_format_pool(), params, &log_data->message);
+        }
+        else
+        {
+            string_formatter reg_exp;
+            fw_log_event log_event_data;
+            _fw_logs_formating_options.get_event_data(log_data->event_id, &log_event_data);
+            reg_exp.generate_message(log_event_data.line, log_event_data.num_of_params, params, &log_data->message);
+        }
 
-        _fw_logs_formating_options.get_file_name(log_data->file_id, &log_data->file_name);
-        _fw_logs_formating_options.get_thread_name(static_cast<uint32_t>(log_binary->dword1.bits.thread_id),
-                                                  &log_data->thread_name);
+        log_data->file_name = _fw_logs_formating_options.get_file_name(log_data->file_id);
+        log_data->thread_name = _fw_logs_formating_options.get_thread_name(static_cast<uint32_t>(log_binary->dword1.bits.thread_id));
     }
 }
@@ -12,11 +12,14 @@ namespace fw_logger
         explicit fw_logs_parser(std::string xml_full_file_path);
         ~fw_logs_parser(void);
         std::vector<std::string> get_fw_log_lines(const fw_logs_binary_data& fw_logs_data_binary);
+        // Formats the whole logs of the buffer, a stream of fw_log_binary records as received or as saved in a file
+        std::vector<std::string> get_fw_log_lines(const uint8_t* logs, size_t size);
 
     private:
-        std::string generate_log_line(char* fw_logs);
+        std::string generate_log_line(const char* fw_logs);
         void fill_log_data(const char* fw_logs, fw_log_data* log_data);
         uint64_t _last_timestamp;
+        fw_log_data _log_data; // Reused between lines, keeping the capacity of its strings
 
         fw_logs_formating_options _fw_logs_formating_options;
         const double _timestamp_factor;
@@ -44,11 +44,48 @@ string datetime_string()
     return string(buffer);
 }
 
+// Each poll sends several log requests at once, the device is locked and powered up once for all of them
+const int fw_logs_requests_per_poll = 4;
+const size_t fw_logs_response_header_size = 4;
+
+int parse_binary_file(fw_logs_parser& parser, const string& path)
+{
+    ifstream in(path, ios::binary);
+    if (!in.good())
+    {
+        cerr << "Failed to open " << path << endl;
+        return EXIT_FAILURE;
+    }
+
+    // The file holds the records as the device sent them, the lines are formatted by chunks of records
+    vector<uint8_t> buffer(sizeof(fw_log_binary) * 4096);
+    string out;
+    while (in)
+    {
+        in.read(reinterpret_cast<char*>(buffer.data()), buffer.size());
+        auto size = static_cast<size_t>(in.gcount());
+        if (!size) break;
+
+        out.clear();
+        for (auto& line : parser.get_fw_log_lines(buffer.data(), size - size % sizeof(fw_log_binary)))
+        {
+            out += line;
+            out += '\n';
+        }
+        cout << out;
+    }
+    return EXIT_SUCCESS;
+}
+
 int main(int argc, char* argv[])
 {
     CmdLine cmd("librealsense rs-fw-logger example tool", ' ', RS2_API_VERSION_STR);
     ValueArg<string> xml_arg("l", "load", "Full file path of HW Logger Events XML file", false, "", "Load HW Logger Events XML file");
+    ValueArg<string> binary_arg("b", "binary", "Save the raw logs to a file, to be formatted later with --parse", false, "", "Binary output file");
+    ValueArg<string> parse_arg("p", "parse", "Format the raw logs of a file saved with --binary, using the XML file, and exit", false, "", "Binary input file");
     cmd.add(xml_arg);
+    cmd.add(binary_arg);
+    cmd.add(parse_arg);
     cmd.parse(argc, argv);
 
     log_to_file(RS2_LOG_SEVERITY_WARN, "librealsense.log");
@@ -67,6 +104,27 @@ int main(int argc, char* argv[])
         }
     }
 
+    if (!parse_arg.getValue().empty())
+    {
+        if (!use_xml_file)
+        {
+            cerr << "Formatting a binary file requires the HW Logger Events XML file" << endl;
+            return EXIT_FAILURE;
+        }
+        return parse_binary_file(*fw_log_parser, parse_arg.getValue());
+    }
+
+    ofstream binary_out;
+    if (!binary_arg.getValue().empty())
+    {
+        binary_out.open(binary_arg.getValue(), ios::binary | ios::app);
+        if (!binary_out.good())
+        {
+            cerr << "Failed to open " << binary_arg.getValue() << endl;
+            return EXIT_FAILURE;
+        }
+    }
+
     context ctx;
     device_hub hub(ctx);
 
@@ -84,41 +142,63 @@ int main(int argc, char* argv[])
             input = {0x14, 0x00, 0xab, 0xcd, op_code, 0x00, 0x00, 0x00,
                      0xf4, 0x01, 0x00, 0x00, 0x00,    0x00, 0x00, 0x00,
                      0x00, 0x00, 0x00, 0x00, 0x00,    0x00, 0x00, 0x00};
+            vector<vector<uint8_t>> requests(fw_logs_requests_per_poll, input);
 
             cout << "Device Name: " << dev.get_info(RS2_CAMERA_INFO_NAME) << endl <<
                     "Device Location: " << dev.get_info(RS2_CAMERA_INFO_PHYSICAL_PORT) << endl << endl;
 
             setvbuf(stdout, NULL, _IONBF, 0); // unbuffering stdout
 
+            auto debug = dev.as<debug_protocol>();
+            string out;
             while (hub.is_connected(dev))
             {
                 this_thread::sleep_for(chrono::milliseconds(100));
 
-                auto raw_data = dev.as<debug_protocol>().send_and_receive_raw_data(input);
-                vector<string> fw_log_lines = {""};
-                if (raw_data.size() <= 4)
-                    continue;
-
-                if (use_xml_file)
+                out.clear();
+                for (auto& raw_data : debug.send_and_receive_raw_data(requests))
                 {
-                    fw_logs_binary_data fw_logs_binary_data = {raw_data};
-                    fw_logs_binary_data.logs_buffer.erase(fw_logs_binary_data.logs_buffer.begin(),fw_logs_binary_data.logs_buffer.begin()+4);
-                    fw_log_lines = fw_log_parser->get_fw_log_lines(fw_logs_binary_data);
-                    for (auto& elem : fw_log_lines)
-                        elem = datetime_string() + "  " + elem;
+                    if (raw_data.size() <= fw_logs_response_header_size)
+                        continue;
+
+                    auto logs = raw_data.data() + fw_logs_response_header_size;
+                    auto logs_size = raw_data.size() - fw_logs_response_header_size;
+
+                    // Raw logs are saved as they are, formatting them is left for later
+                    if (binary_out.is_open())
+                    {
+                        binary_out.write(reinterpret_cast<const char*>(logs), logs_size);
+                        continue;
+                    }
+
+                    if (use_xml_file)
+                    {
+                        auto time = datetime_string();
+                        for (auto& line : fw_log_parser->get_fw_log_lines(logs, logs_size))
+                        {
+                            out += time;
+                            out += "  ";
+                            out += line;
+                            out += '\n';
+                        }
+                    }
+                    else
+                    {
+                        out += datetime_string();
+                        out += "  FW_Log_Data:";
+                        for (size_t i = 0; i < raw_data.size(); ++i)
+                        {
+                            out += hexify(raw_data[i]);
+                            out += ' ';
+                        }
+                        out += '\n';
+                    }
                 }
-                else
-                {
-                    stringstream sstr;
-                    sstr << datetime_string() << "  FW_Log_Data:";
-                    for (size_t i = 0; i < raw_data.size(); ++i)
-                        sstr << hexify(raw_data[i]) << " ";
 
-                    fw_log_lines.push_back(sstr.str());
-                }
-
-                for (auto& line : fw_log_lines)
-                    cout << line << endl;
+                if (binary_out.is_open())
+                    binary_out.flush();
+                else
+                    cout << out;
             }
         }
         catch (const error & e)
@@ -1,7 +1,4 @@
 #include "string-formatter.h"
-#include <regex>
-#include <sstream>
-#include <iomanip>
 
 using namespace std;
 
@@ -16,53 +13,85 @@ namespace fw_logger
     {
     }
 
-    bool string_formatter::generate_message(const string& source, int num_of_params, const uint32_t* params, string* dest)
+    void string_formatter::compile(const string& source, int num_of_params, string* pool, vector<format_op>* ops)
     {
-        map<string, string> exp_replace_map;
-
-        if (params == nullptr && num_of_params > 0) return false;
-
-        for (int i = 0; i < num_of_params; i++)
+        auto literal_start = size_t(0);
+        auto add_literal = [&](size_t end)
         {
-            string regular_exp[2];
-            string replacement[2];
-            stringstream st_regular_exp[2];
-            stringstream st_replacement[2];
-
-            st_regular_exp[0] << "\\{\\b(" << i << ")\\}";
-            regular_exp[0] = st_regular_exp[0].str();
-
-            st_replacement[0] << params[i];
-            replacement[0] = st_replacement[0].str();
-
-            exp_replace_map[regular_exp[0]] = replacement[0];
-
-
-            st_regular_exp[1] << "\\{\\b(" << i << "):x\\}";
-            regular_exp[1] = st_regular_exp[1].str();
-
-            st_replacement[1] << hex << setw(2) << setfill('0') << params[i];
-            replacement[1] = st_replacement[1].str();
-
-            exp_replace_map[regular_exp[1]] = replacement[1];
+            if (end == literal_start) return;
+            if (!ops->empty() && ops->back().param < 0 && ops->back().offset + ops->back().length == pool->size())
+                ops->back().length += uint32_t(end - literal_start);
+            else
+                ops->push_back({ uint32_t(pool->size()), uint32_t(end - literal_start), -1, false });
+            pool->append(source, literal_start, end - literal_start);
+        };
+
+        for (auto i = source.find('{'); i != string::npos; i = source.find('{', i + 1))
+        {
+            auto j = i + 1;
+            auto param = 0;
+            while (j < source.size() && source[j] >= '0' && source[j] <= '9')
+                param = param * 10 + (source[j++] - '0');
+            if (j == i + 1 || j == source.size() || param >= num_of_params)
+                continue;
+
+            auto hex = source.compare(j, 3, ":x}") == 0;
+            if (!hex && source[j] != '}')
+                continue;
+
+            add_literal(i);
+            ops->push_back({ 0, 0, param, hex });
+            i = j + (hex ? 2 : 0);
+            literal_start = i + 1;
         }
-
-        return replace_params(source, exp_replace_map, dest);
+        add_literal(source.size());
     }
 
-    bool string_formatter::replace_params(const string& source, const map<string, string>& exp_replace_map, string* dest) const
+    void string_formatter::format(const format_op* ops, size_t count, const string& pool, const uint32_t* params, string* dest)
     {
-        string source_temp(source);
-
-        for (auto exp_replace_it = exp_replace_map.begin(); exp_replace_it != exp_replace_map.end(); exp_replace_it++)
+        char digits[10];
+        for (size_t i = 0; i < count; ++i)
         {
-            string destTemp;
-            regex e(exp_replace_it->first);
-            regex_replace(back_inserter(destTemp), source_temp.begin(), source_temp.end(), e, exp_replace_it->second);
-            source_temp = destTemp;
-
+            auto& op = ops[i];
+            if (op.param < 0)
+            {
+                dest->append(pool, op.offset, op.length);
+                continue;
+            }
+
+            auto value = params[op.param];
+            auto n = 0;
+            if (op.hex)
+            {
+                // At least two hex digits, as the firmware tools print them
+                do
+                {
+                    digits[n++] = "0123456789abcdef"[value & 0xf];
+                    value >>= 4;
+                } while (value || n < 2);
+            }
+            else
+            {
+                do
+                {
+                    digits[n++] = char('0' + value % 10);
+                    value /= 10;
+                } while (value);
+            }
+            while (n)
+                dest->push_back(digits[--n]);
         }
-        *dest = source_temp;
+    }
+
+    bool string_formatter::generate_message(const string& source, int num_of_params, const uint32_t* params, string* dest)
+    {
+        if (params == nullptr && num_of_params > 0) return false;
+
+        string pool;
+        vector<format_op> ops;
+        compile(source, num_of_params, &pool, &ops);
+        dest->clear();
+        format(ops.data(), ops.size(), pool, params, dest);
         return true;
     }
 }
@@ -1,19 +1,30 @@
 #pragma once
 #include <string>
-#include <map>
+#include <vector>
 #include <stdint.h>
 
 namespace fw_logger
 {
+    // One step of a compiled format line: a run of literal text of the pool, or the value of a parameter
+    struct format_op
+    {
+        uint32_t offset;
+        uint32_t length;
+        int param;      // -1 for literal text
+        bool hex;
+    };
+
     class string_formatter
     {
     public:
         string_formatter(void);
         ~string_formatter(void);
 
-        bool generate_message(const std::string& source, int num_of_params, const uint32_t* params, std::string* dest);
+        // Splits the line into ops once, "{i}" is replaced with the decimal value of parameter i and "{i:x}" with its hex value.
+        // The literal text is appended to the pool and the ops to the list
+        static void compile(const std::string& source, int num_of_params, std::string* pool, std::vector<format_op>* ops);
+        static void format(const format_op* ops, size_t count, const std::string& pool, const uint32_t* params, std::string* dest);
 
-    private:
-        bool replace_params(const std::string& source, const std::map<std::string, std::string>& exp_replace_map, std::string* dest) const;
+        bool generate_message(const std::string& source, int num_of_params, const uint32_t* params, std::string* dest);
     };
 }
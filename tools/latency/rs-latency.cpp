@@ -0,0 +1,186 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+// Command-line tool reporting the glass-to-callback latency of each stream, see rs-latency.h for the stages.
+// The streams are configured with the same file format as rs-data-collect, or the default profiles of every sensor
+
+#include <librealsense2/rs.hpp>
+#include "rs-latency.h"
+#include "tclap/CmdLine.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+using namespace TCLAP;
+
+struct stream_request
+{
+    rs2_stream stream;
+    int width, height, fps;
+    rs2_format format;
+    int index;
+};
+
+template<class T>
+static bool parse_enum(std::string str, T count, const char* (*to_string)(T), T& value)
+{
+    std::transform(str.begin(), str.end(), str.begin(), ::tolower);
+    for (int i = 0; i < static_cast<int>(count); i++)
+    {
+        std::string name = to_string(static_cast<T>(i));
+        std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+        if (name == str)
+        {
+            value = static_cast<T>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+// STREAM,WIDTH,HEIGHT,FPS,FORMAT[,INDEX] per line, lines not starting with a letter are comments
+static std::vector<stream_request> parse_configuration(const std::string& filename)
+{
+    std::ifstream file(filename);
+    if (!file)
+        throw std::runtime_error("Configuration file " + filename + " was not found");
+
+    std::vector<stream_request> requests;
+    std::string line;
+    while (std::getline(file, line))
+    {
+        if (line.empty() || !std::isalpha(static_cast<unsigned char>(line[0])))
+            continue;
+
+        std::vector<std::string> tokens;
+        std::stringstream ss(line);
+        std::string token;
+        while (std::getline(ss, token, ','))
+            tokens.push_back(token.substr(0, token.find_last_not_of("\t\r ") + 1));
+
+        stream_request r{};
+        if (tokens.size() < 5 ||
+            !parse_enum(tokens[0], RS2_STREAM_COUNT, rs2_stream_to_string, r.stream) ||
+            !parse_enum(tokens[4], RS2_FORMAT_COUNT, rs2_format_to_string, r.format))
+        {
+            std::cout << "Invalid syntax in configuration line " << line << std::endl;
+            continue;
+        }
+        r.width = std::stoi(tokens[1]);
+        r.height = std::stoi(tokens[2]);
+        r.fps = std::stoi(tokens[3]);
+        r.index = tokens.size() > 5 ? std::stoi(tokens[5]) : 0;
+        requests.push_back(r);
+    }
+    return requests;
+}
+
+static bool matches(const rs2::stream_profile& p, const stream_request& r)
+{
+    if (p.stream_type() != r.stream || p.format() != r.format || p.fps() != r.fps || p.stream_index() != r.index)
+        return false;
+    if (auto vp = p.as<rs2::video_stream_profile>())
+        return vp.width() == r.width && vp.height() == r.height;
+    return true;
+}
+
+int main(int argc, char** argv) try
+{
+    rs2::log_to_file(RS2_LOG_SEVERITY_WARN);
+
+    CmdLine cmd("librealsense rs-latency tool", ' ');
+    ValueArg<std::string> config_file("c", "ConfigurationFile", "Stream configuration file, in the rs-data-collect format. The default profiles are used without it", false, "", "");
+    ValueArg<int> timeout("t", "Timeout", "Duration of the measurement (in seconds)", false, 10, "");
+    ValueArg<int> interval("i", "Interval", "Print an intermediate report every given number of seconds", false, 0, "");
+    ValueArg<std::string> out_file("f", "FullFilePath", "Save the final report as csv into the given file", false, "", "");
+    SwitchArg device_clock("d", "DeviceClock", "Keep the hardware timestamps in the device clock instead of enabling the global time");
+
+    cmd.add(config_file);
+    cmd.add(timeout);
+    cmd.add(interval);
+    cmd.add(out_file);
+    cmd.add(device_clock);
+    cmd.parse(argc, argv);
+
+    rs2::context ctx;
+    auto list = ctx.query_devices();
+    if (list.size() == 0)
+        throw std::runtime_error("No RealSense device connected");
+    auto dev = list.front();
+
+    std::vector<stream_request> requests;
+    if (config_file.isSet())
+        requests = parse_configuration(config_file.getValue());
+
+    rs_latency::latency_monitor monitor;
+    std::vector<rs2::sensor> sensors;
+    for (auto&& sensor : dev.query_sensors())
+    {
+        std::vector<rs2::stream_profile> selected;
+        for (auto&& p : sensor.get_stream_profiles())
+        {
+            auto requested = config_file.isSet() ?
+                std::any_of(requests.begin(), requests.end(), [&](const stream_request& r) { return matches(p, r); }) :
+                p.is_default();
+            if (requested)
+                selected.push_back(p);
+        }
+        if (selected.empty())
+            continue;
+
+        if (sensor.supports(RS2_OPTION_GLOBAL_TIME_ENABLED))
+            sensor.set_option(RS2_OPTION_GLOBAL_TIME_ENABLED, device_clock.getValue() ? 0.f : 1.f);
+
+        for (auto&& p : selected)
+            std::cout << "Streaming " << p.stream_name() << " " << p.format() << " " << p.fps() << "fps" << std::endl;
+        sensor.open(selected);
+        sensors.push_back(sensor);
+    }
+    if (sensors.empty())
+        throw std::runtime_error("None of the requested profiles is supported by " + std::string(dev.get_info(RS2_CAMERA_INFO_NAME)));
+
+    for (auto&& sensor : sensors)
+        sensor.start([&monitor](rs2::frame f) { monitor.on_frame(f); });
+
+    auto start = std::chrono::steady_clock::now();
+    auto last_report = start;
+    while (std::chrono::steady_clock::now() - start < std::chrono::seconds(timeout.getValue()))
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        if (interval.getValue() > 0 && std::chrono::steady_clock::now() - last_report >= std::chrono::seconds(interval.getValue()))
+        {
+            last_report = std::chrono::steady_clock::now();
+            rs_latency::latency_monitor::print(std::cout, monitor.report());
+            std::cout << std::endl;
+        }
+    }
+
+    for (auto&& sensor : sensors)
+    {
+        sensor.stop();
+        sensor.close();
+    }
+
+    auto reports = monitor.report();
+    rs_latency::latency_monitor::print(std::cout, reports);
+    if (out_file.isSet())
+    {
+        std::ofstream csv(out_file.getValue());
+        if (!csv)
+            throw std::runtime_error("Cannot open the output file " + out_file.getValue());
+        rs_latency::latency_monitor::write_csv(csv, reports);
+    }
+    return EXIT_SUCCESS;
+}
+catch (const rs2::error & e)
+{
+    std::cerr << "RealSense error calling " << e.get_failed_function() << "(" << e.get_failed_args() << "):\n    " << e.what() << std::endl;
+    return EXIT_FAILURE;
+}
+catch (const std::exception & e)
+{
+    std::cerr << e.what() << std::endl;
+    return EXIT_FAILURE;
+}
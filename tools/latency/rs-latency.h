@@ -0,0 +1,261 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2018 Intel Corporation. All Rights Reserved.
+// Glass-to-callback latency of the frames of each stream, split into the stages the frame metadata reveals:
+//   readout   - end of exposure to the frame timestamp, both taken by the device clock
+//   transport - frame timestamp to the backend (kernel) timestamp of the host
+//   backend   - backend timestamp to the arrival in librealsense
+//   dispatch  - arrival in librealsense to the user callback
+// The transport stage needs the device clock mapped to the host clock. With RS2_OPTION_GLOBAL_TIME_ENABLED
+// the frame timestamps are in the host clock and the stage is absolute; otherwise the offset between the clocks
+// is taken from the fastest frame, so the stage only shows how much slower the other frames were.
+// The time of arrival metadata is in whole milliseconds, which bounds the resolution of the backend and dispatch stages.
+// The header only depends on the public API and can be used as is by applications: call latency_monitor::on_frame
+// from the frame callbacks and collect the reports periodically.
+
+#pragma once
+
+#include <librealsense2/rs.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+namespace rs_latency
+{
+    enum latency_stage
+    {
+        stage_readout,
+        stage_transport,
+        stage_backend,
+        stage_dispatch,
+        stage_total,
+        stage_count
+    };
+
+    inline const char* stage_name(latency_stage stage)
+    {
+        static const char* names[] = { "readout", "transport", "backend", "dispatch", "total" };
+        return names[stage];
+    }
+
+    // Latencies in milliseconds
+    struct distribution
+    {
+        size_t samples = 0;
+        double mean = 0, p50 = 0, p90 = 0, p99 = 0, max = 0;
+
+        static distribution of(std::vector<double> values)
+        {
+            distribution d;
+            if (values.empty())
+                return d;
+
+            std::sort(values.begin(), values.end());
+            auto rank = [&](double p) { return values[std::min(values.size() - 1, static_cast<size_t>(std::ceil(p * values.size())) - 1)]; };
+            d.samples = values.size();
+            for (auto v : values)
+                d.mean += v;
+            d.mean /= values.size();
+            d.p50 = rank(0.5);
+            d.p90 = rank(0.9);
+            d.p99 = rank(0.99);
+            d.max = values.back();
+            return d;
+        }
+    };
+
+    struct stream_report
+    {
+        rs2_stream stream;
+        int index;
+        unsigned long long frames = 0;
+        unsigned long long dropped = 0;        // gaps in the frame numbers
+        bool transport_is_absolute = false;    // the device timestamps were in the host clock
+        double hardware_jitter_ms = 0;         // standard deviation of the interval between frame timestamps
+        double host_jitter_ms = 0;             // standard deviation of the interval between callbacks
+        distribution stages[stage_count];
+    };
+
+    class latency_monitor
+    {
+    public:
+        // Call from the frame callback, the time of the call is the callback stage
+        void on_frame(const rs2::frame& f)
+        {
+            auto now = std::chrono::duration<double, std::milli>(std::chrono::system_clock::now().time_since_epoch()).count();
+            if (auto fs = f.as<rs2::frameset>())
+            {
+                for (auto&& sub : fs)
+                    record(sub, now);
+            }
+            else
+                record(f, now);
+        }
+
+        // Reports of all the streams seen, optionally starting over
+        std::vector<stream_report> report(bool reset = false)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            std::vector<stream_report> reports;
+            for (auto&& kvp : _streams)
+                reports.push_back(make_report(kvp.first, kvp.second));
+            if (reset)
+                _streams.clear();
+            return reports;
+        }
+
+        static void print(std::ostream& out, const std::vector<stream_report>& reports)
+        {
+            out << std::fixed << std::setprecision(3);
+            for (auto&& r : reports)
+            {
+                out << rs2_stream_to_string(r.stream) << " " << r.index << ": " << r.frames << " frames, " << r.dropped << " dropped, jitter "
+                    << r.hardware_jitter_ms << "ms (device) " << r.host_jitter_ms << "ms (host)"
+                    << (r.transport_is_absolute ? "" : ", transport relative to the fastest frame") << "\n"
+                    << "    stage          mean       p50       p90       p99       max  [ms]\n";
+                for (int s = 0; s < stage_count; s++)
+                {
+                    auto&& d = r.stages[s];
+                    if (!d.samples)
+                        continue;
+                    out << "    " << std::left << std::setw(10) << stage_name(static_cast<latency_stage>(s)) << std::right
+                        << std::setw(10) << d.mean << std::setw(10) << d.p50 << std::setw(10) << d.p90
+                        << std::setw(10) << d.p99 << std::setw(10) << d.max << "\n";
+                }
+            }
+        }
+
+        static void write_csv(std::ostream& out, const std::vector<stream_report>& reports)
+        {
+            out << "Stream,Index,Frames,Dropped,Device Jitter (ms),Host Jitter (ms),Stage,Absolute,Samples,Mean (ms),P50 (ms),P90 (ms),P99 (ms),Max (ms)\n";
+            out << std::fixed << std::setprecision(3);
+            for (auto&& r : reports)
+                for (int s = 0; s < stage_count; s++)
+                {
+                    auto&& d = r.stages[s];
+                    out << rs2_stream_to_string(r.stream) << "," << r.index << "," << r.frames << "," << r.dropped << ","
+                        << r.hardware_jitter_ms << "," << r.host_jitter_ms << "," << stage_name(static_cast<latency_stage>(s)) << ","
+                        << (s != stage_transport || r.transport_is_absolute) << "," << d.samples << ","
+                        << d.mean << "," << d.p50 << "," << d.p90 << "," << d.p99 << "," << d.max << "\n";
+                }
+        }
+
+    private:
+        static double unknown() { return std::numeric_limits<double>::quiet_NaN(); }
+
+        // Times of one frame in milliseconds, NaN when the metadata is not available
+        struct frame_times
+        {
+            double exposure_end;    // device clock
+            double frame_timestamp; // device clock
+            double host_timestamp;  // frame timestamp in the host clock, when the device provides it
+            double backend;
+            double arrival;
+            double callback;
+        };
+
+        struct stream_data
+        {
+            std::vector<frame_times> frames;
+            unsigned long long last_frame_number = 0;
+            unsigned long long dropped = 0;
+        };
+
+        static double metadata(const rs2::frame& f, rs2_frame_metadata_value md, double scale)
+        {
+            return f.supports_frame_metadata(md) ? f.get_frame_metadata(md) * scale : unknown();
+        }
+
+        void record(const rs2::frame& f, double now)
+        {
+            frame_times t;
+            t.frame_timestamp = metadata(f, RS2_FRAME_METADATA_FRAME_TIMESTAMP, 1e-3);
+            // The sensor timestamp is the middle of the exposure
+            t.exposure_end = metadata(f, RS2_FRAME_METADATA_SENSOR_TIMESTAMP, 1e-3) + metadata(f, RS2_FRAME_METADATA_ACTUAL_EXPOSURE, 1e-3) / 2;
+            t.host_timestamp = f.get_frame_timestamp_domain() == RS2_TIMESTAMP_DOMAIN_GLOBAL_TIME ? f.get_timestamp() : unknown();
+            t.backend = metadata(f, RS2_FRAME_METADATA_BACKEND_TIMESTAMP, 1);
+            t.arrival = metadata(f, RS2_FRAME_METADATA_TIME_OF_ARRIVAL, 1);
+            t.callback = now;
+
+            auto profile = f.get_profile();
+            auto frame_number = f.get_frame_number();
+
+            std::lock_guard<std::mutex> lock(_mutex);
+            auto&& data = _streams[std::make_pair(profile.stream_type(), profile.stream_index())];
+            if (!data.frames.empty() && frame_number > data.last_frame_number + 1)
+                data.dropped += frame_number - data.last_frame_number - 1;
+            data.last_frame_number = frame_number;
+            data.frames.push_back(t);
+        }
+
+        static double interval_jitter(const std::vector<frame_times>& frames, double frame_times::* time)
+        {
+            std::vector<double> intervals;
+            for (size_t i = 1; i < frames.size(); i++)
+            {
+                auto d = frames[i].*time - frames[i - 1].*time;
+                if (!std::isnan(d))
+                    intervals.push_back(d);
+            }
+            if (intervals.size() < 2)
+                return 0;
+
+            double mean = 0, var = 0;
+            for (auto d : intervals) mean += d;
+            mean /= intervals.size();
+            for (auto d : intervals) var += (d - mean) * (d - mean);
+            return std::sqrt(var / (intervals.size() - 1));
+        }
+
+        static stream_report make_report(std::pair<rs2_stream, int> id, const stream_data& data)
+        {
+            stream_report r;
+            r.stream = id.first;
+            r.index = id.second;
+            r.frames = data.frames.size();
+            r.dropped = data.dropped;
+            r.hardware_jitter_ms = interval_jitter(data.frames, &frame_times::frame_timestamp);
+            r.host_jitter_ms = interval_jitter(data.frames, &frame_times::callback);
+
+            // Without the host time of the frames, the clocks are aligned on the fastest transport seen
+            r.transport_is_absolute = !data.frames.empty() &&
+                std::all_of(data.frames.begin(), data.frames.end(), [](const frame_times& t) { return !std::isnan(t.host_timestamp); });
+            double clock_offset = std::numeric_limits<double>::max();
+            if (!r.transport_is_absolute)
+                for (auto&& t : data.frames)
+                    if (!std::isnan(t.backend - t.frame_timestamp))
+                        clock_offset = std::min(clock_offset, t.backend - t.frame_timestamp);
+
+            std::vector<double> stages[stage_count];
+            for (auto&& t : data.frames)
+            {
+                auto host_frame = r.transport_is_absolute ? t.host_timestamp : t.frame_timestamp + clock_offset;
+                double values[stage_count] = {
+                    t.frame_timestamp - t.exposure_end,
+                    t.backend - host_frame,
+                    t.arrival - t.backend,
+                    t.callback - t.arrival,
+                    unknown()
+                };
+                if (r.transport_is_absolute)
+                    values[stage_total] = t.callback - (host_frame - values[stage_readout]);
+
+                for (int s = 0; s < stage_count; s++)
+                    if (!std::isnan(values[s]))
+                        stages[s].push_back(values[s]);
+            }
+            for (int s = 0; s < stage_count; s++)
+                r.stages[s] = distribution::of(std::move(stages[s]));
+            return r;
+        }
+
+        std::mutex _mutex;
+        std::map<std::pair<rs2_stream, int>, stream_data> _streams;
+    };
+}
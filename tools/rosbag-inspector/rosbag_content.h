@@ -4,9 +4,15 @@
 #pragma once
 
 #include <string>
+#include <map>
+#include <set>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 #include "../../third-party/realsense-file/rosbag/rosbag_storage/include/rosbag/bag.h"
 #include "../../third-party/realsense-file/rosbag/rosbag_storage/include/rosbag/view.h"
+#include "../../third-party/realsense-file/rosbag/rosbag_storage/include/rosbag/topic_index.h"
 
 #include "print_helpers.h"
 
@@ -26,17 +32,33 @@ namespace rosbag_inspector
         uint64_t uncompressed;
     };
 
+    // What the index tells about a topic, without reading its messages
+    struct topic_summary
+    {
+        std::string data_type;
+        size_t messages;
+    };
+
+    struct message_text
+    {
+        std::chrono::nanoseconds time;
+        std::string content;
+    };
+
+    // Opening a bag reads only its connection and chunk index, the summaries are computed from the index records.
+    // Message contents are read on demand, a page at a time, on a thread of the bag: the bag is only read from that thread
     struct rosbag_content
     {
+        static const size_t page_size = 10;
+
         rosbag_content(const std::string& file)
         {
             bag.open(file);
+            topic_indexes = rosbag::TopicIndex::build(bag);
 
-            rosbag::View entire_bag_view(bag);
-
-            for (auto&& m : entire_bag_view)
+            for (auto&& topic : topic_indexes)
             {
-                topics_to_message_types[m.getTopic()].push_back(m.getDataType());
+                topics_to_summaries[topic.first] = { topic.second.getDataType(), topic.second.size() };
             }
 
             path = bag.getFileName();
@@ -49,77 +71,121 @@ namespace rosbag_inspector
             std::reverse(file_name.begin(), file_name.end());
 
             version = tmpstringstream() << bag.getMajorVersion() << "." << bag.getMinorVersion();
-            file_duration = get_duration(bag);
+            file_duration = get_duration();
             size = 1.0 * bag.getSize() / (1024LL * 1024LL);
             compression_info = bag.getCompressionInfo();
-        }
 
-        rosbag_content(const rosbag_content& other)
-        {
-            bag.open(other.path);
-            cache = other.cache;
-            file_duration = other.file_duration;
-            file_name = other.file_name;
-            path = other.path;
-            version = other.version;
-            size = other.size;
-            compression_info = other.compression_info;
-            topics_to_message_types = other.topics_to_message_types;
-        }
-        rosbag_content(rosbag_content&& other)
-        {
-            other.bag.close();
-            bag.open(other.path);
-            cache = other.cache;
-            file_duration = other.file_duration;
-            file_name = other.file_name;
-            path = other.path;
-            version = other.version;
-            size = other.size;
-            compression_info = other.compression_info;
-            topics_to_message_types = other.topics_to_message_types;
-
-            other.cache.clear();
-            other.file_duration = std::chrono::nanoseconds::zero();
-            other.file_name.clear();
-            other.path.clear();
-            other.version.clear();
-            other.size = 0;
-            other.compression_info.compressed = 0;
-            other.compression_info.uncompressed = 0;
-            other.compression_info.compression_type = "";
-            other.topics_to_message_types.clear();
+            reader = std::thread([this]() { read_pages(); });
         }
-        std::string instanciate_and_cache(const rosbag::MessageInstance& m, uint64_t count)
+
+        rosbag_content(const rosbag_content& other) = delete;
+        rosbag_content& operator=(const rosbag_content& other) = delete;
+
+        ~rosbag_content()
         {
-            auto key = std::make_tuple(m.getCallerId(), m.getDataType(), m.getMD5Sum(), m.getTopic(), m.getTime(), count);
-            if (cache.find(key) != cache.end())
             {
-                return cache[key];
+                std::lock_guard<std::mutex> lock(pages_mutex);
+                stopping = true;
             }
-            std::ostringstream oss;
-            oss << m;
-            cache[key] = oss.str();
-            return oss.str();
+            pages_cv.notify_one();
+            reader.join();
         }
 
-        std::chrono::nanoseconds get_duration(const rosbag::Bag& bag)
+        // Fills the texts of the messages of the topic from the given position, as far as they are read.
+        // The missing ones are requested, returns false while they are being read
+        bool get_messages(const std::string& topic, size_t first, size_t count, std::vector<message_text>& messages)
         {
-            rosbag::View only_frames(bag, [](rosbag::ConnectionInfo const* info) {
-                std::regex exp(R"RRR(/device_\d+/sensor_\d+/.*_\d+/(image|imu))RRR");
-                return std::regex_search(info->topic, exp);
-            });
-            return std::chrono::nanoseconds((only_frames.getEndTime() - only_frames.getBeginTime()).toNSec());
+            messages.clear();
+            std::lock_guard<std::mutex> lock(pages_mutex);
+            auto available = topics_to_summaries.count(topic) ? topics_to_summaries[topic].messages : 0;
+            for (auto i = first; i < first + count && i < available; ++i)
+            {
+                auto it = cache.find(std::make_pair(topic, i));
+                if (it == cache.end())
+                {
+                    auto page = std::make_pair(topic, i - i % page_size);
+                    if (requested.insert(page).second)
+                    {
+                        pending.push_back(page);
+                        pages_cv.notify_one();
+                    }
+                    return false;
+                }
+                messages.push_back(it->second);
+            }
+            return true;
         }
 
-        std::map<std::tuple<std::string, std::string, std::string, std::string, rs2rosinternal::Time, uint64_t>, std::string> cache;
         std::chrono::nanoseconds file_duration;
         std::string file_name;
         std::string path;
         std::string version;
         double size;
         rosbag_inspector::compression_info compression_info;
-        std::map<std::string, std::vector<std::string>> topics_to_message_types;
+        std::map<std::string, topic_summary> topics_to_summaries;
+
+    private:
+        void read_pages()
+        {
+            std::unique_lock<std::mutex> lock(pages_mutex);
+            while (true)
+            {
+                pages_cv.wait(lock, [this]() { return stopping || !pending.empty(); });
+                if (stopping)
+                    return;
+
+                // The latest request is the page the user is looking at
+                auto page = pending.back();
+                pending.pop_back();
+                lock.unlock();
+
+                std::vector<std::pair<size_t, message_text>> texts;
+                auto position = page.second;
+                try
+                {
+                    for (auto&& m : topic_indexes.at(page.first).getMessages(page.second, page_size))
+                    {
+                        std::ostringstream oss;
+                        oss << m;
+                        texts.push_back({ position++, { std::chrono::nanoseconds(m.getTime().toNSec()), oss.str() } });
+                    }
+                }
+                catch (const std::exception& e)
+                {
+                    for (; position < page.second + page_size; ++position)
+                        texts.push_back({ position, { std::chrono::nanoseconds::zero(), std::string("Failed to read message: ") + e.what() } });
+                }
+
+                lock.lock();
+                for (auto&& text : texts)
+                    cache[std::make_pair(page.first, text.first)] = std::move(text.second);
+            }
+        }
+
+        std::chrono::nanoseconds get_duration() const
+        {
+            std::regex exp(R"RRR(/device_\d+/sensor_\d+/.*_\d+/(image|imu))RRR");
+            auto begin = rs2rosinternal::TIME_MAX;
+            auto end = rs2rosinternal::TIME_MIN;
+            for (auto&& topic : topic_indexes)
+            {
+                if (!topic.second.size() || !std::regex_search(topic.first, exp))
+                    continue;
+                begin = std::min(begin, topic.second.getBeginTime());
+                end = std::max(end, topic.second.getEndTime());
+            }
+            return begin < end ? std::chrono::nanoseconds((end - begin).toNSec()) : std::chrono::nanoseconds::zero();
+        }
+
         rosbag::Bag bag;
+        std::map<std::string, rosbag::TopicIndex> topic_indexes;
+
+        std::mutex pages_mutex;
+        std::condition_variable pages_cv;
+        std::map<std::pair<std::string, size_t>, message_text> cache;
+        std::set<std::pair<std::string, size_t>> requested;
+        std::vector<std::pair<std::string, size_t>> pending;
+        bool stopping = false;
+        std::thread reader;
     };
 }
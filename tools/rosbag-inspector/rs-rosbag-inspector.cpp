@@ -239,56 +239,53 @@ void draw_bag_content(rosbag_content& bag, int flags)
     ImGui::Text("\t%s", std::string(tmpstringstream() << std::left << std::setw(20) << "compressed: " << bag.compression_info.uncompressed).c_str());
     if (ImGui::CollapsingHeader("Topics"))
     {
-        for (auto&& topic_to_message_type : bag.topics_to_message_types)
+        for (auto&& topic_to_summary : bag.topics_to_summaries)
         {
-            std::string topic = topic_to_message_type.first;
-            std::vector<std::string> messages_types = topic_to_message_type.second;
+            std::string topic = topic_to_summary.first;
+            const topic_summary& summary = topic_to_summary.second;
             std::ostringstream oss;
             int max_topic_len = 100;
             oss << std::left << std::setw(max_topic_len) << topic
-                << " " << std::left << std::setw(10) << messages_types.size() << std::setw(6) << std::string(" msg") + (messages_types.size() > 1 ? "s" : "")
-                << ": " << std::left << std::setw(40) << messages_types.front() << std::endl;
+                << " " << std::left << std::setw(10) << summary.messages << std::setw(6) << std::string(" msg") + (summary.messages > 1 ? "s" : "")
+                << ": " << std::left << std::setw(40) << summary.data_type << std::endl;
             std::string line = oss.str();
             auto pos = ImGui::GetCursorPos();
             ImGui::SetCursorPos({ pos.x + 20, pos.y });
             if (ImGui::CollapsingHeader(line.c_str()))
             {
-                rosbag::View messages(bag.bag, rosbag::TopicQuery(topic));
-                uint64_t count = 0;
-                constexpr uint64_t num_next_items_to_show = 10;
+                constexpr uint64_t num_next_items_to_show = rosbag_content::page_size;
                 num_topics_to_show[topic] = std::max(num_topics_to_show[topic], num_next_items_to_show);
                 uint64_t max = num_topics_to_show[topic];
                 auto win_pos = ImGui::GetWindowPos();
                 ImGui::SetWindowPos({ win_pos.x + 20, win_pos.y });
+
+                // Only the messages on display are read, each page once
+                std::vector<message_text> messages;
+                bool loaded = bag.get_messages(topic, 0, max, messages);
                 for (auto&& m : messages)
                 {
-                    count++;
                     ImGui::Columns(2, "Message", true);
                     ImGui::Separator();
                     ImGui::Text("Timestamp"); ImGui::NextColumn();
                     ImGui::Text("Content"); ImGui::NextColumn();
                     ImGui::Separator();
-                    ImGui::Text("%s", pretty_time(std::chrono::nanoseconds(m.getTime().toNSec())).c_str()); ImGui::NextColumn();
-                    ImGui::Text("%s", bag.instanciate_and_cache(m, count).c_str());
+                    ImGui::Text("%s", pretty_time(m.time).c_str()); ImGui::NextColumn();
+                    ImGui::Text("%s", m.content.c_str());
                     ImGui::Columns(1);
                     ImGui::Separator();
-                    if (count >= max)
+                }
+                if (!loaded)
+                {
+                    ImGui::Text("Loading...");
+                }
+                else if (summary.messages > max)
+                {
+                    ImGui::Text("... %d more messages", int(summary.messages - max));
+                    ImGui::SameLine();
+                    std::string label = tmpstringstream() << "Show More ##" << topic;
+                    if (ImGui::Button(label.c_str()))
                     {
-                        int left = messages.size() - max;
-                        if (left > 0)
-                        {
-                            ImGui::Text("... %d more messages", left);
-                            ImGui::SameLine();
-                            std::string label = tmpstringstream() << "Show More ##" << topic;
-                            if (ImGui::Button(label.c_str()))
-                            {
-                                num_topics_to_show[topic] += 10;
-                            }
-                            else
-                            {
-                                break;
-                            }
-                        }
+                        num_topics_to_show[topic] += rosbag_content::page_size;
                     }
                 }
                 ImGui::SetWindowPos(win_pos);
@@ -0,0 +1,102 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2015 Intel Corporation. All Rights Reserved.
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Tests of the librealsense core sensors against fake backend devices. Kept apart from unit-tests-internal.cpp,
+// since the names of the core classes clash with the public API classes that file uses
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+#include "catch/catch.hpp"
+#include <../src/sensor.h>
+#include <../src/software-device.h>
+#include <../src/image.h>
+
+using namespace librealsense;  // An internal namespace not acessible via the public API
+
+TEST_CASE("UVC sensor unpacks the frames again once restarted", "[software-device]")
+{
+    // Streams the frames the test pushes, as the capture thread of a backend would
+    struct fake_uvc_device : platform::uvc_device
+    {
+        void probe_and_commit(platform::stream_profile p, platform::frame_callback callback, int) override { profile = p; this->callback = callback; }
+        void stream_on(std::function<void(const notification&)>) override {}
+        void start_callbacks() override { streaming = true; }
+        void stop_callbacks() override { streaming = false; }
+        void close(platform::stream_profile) override { callback = nullptr; }
+        void set_power_state(platform::power_state state) override { power = state; }
+        platform::power_state get_power_state() const override { return power; }
+        void init_xu(const platform::extension_unit&) override {}
+        bool set_xu(const platform::extension_unit&, uint8_t, const uint8_t*, int) override { return false; }
+        bool get_xu(const platform::extension_unit&, uint8_t, uint8_t*, int) const override { return false; }
+        platform::control_range get_xu_range(const platform::extension_unit&, uint8_t, int) const override { return {}; }
+        bool get_pu(rs2_option, int32_t&) const override { return false; }
+        bool set_pu(rs2_option, int32_t) override { return false; }
+        platform::control_range get_pu_range(rs2_option) const override { return {}; }
+        std::vector<platform::stream_profile> get_profiles() const override { return { { W, H, 30, 'YUY2' } }; }
+        void lock() const override {}
+        void unlock() const override {}
+        std::string get_device_location() const override { return ""; }
+        platform::usb_spec get_usb_specification() const override { return platform::usb3_type; }
+
+        void push(const std::vector<uint8_t>& pixels)
+        {
+            if (streaming && callback)
+                callback(profile, { pixels.size(), 0, pixels.data(), nullptr, 0, -1, 0, 0 }, []() {});
+        }
+
+        const uint32_t W = 64, H = 48;
+        platform::stream_profile profile;
+        platform::frame_callback callback;
+        std::atomic<bool> streaming{ false };
+        platform::power_state power = platform::D3;
+    };
+
+    struct counting_reader : frame_timestamp_reader
+    {
+        double get_frame_timestamp(const request_mapping&, const platform::frame_object&) override { return double(++counter); }
+        unsigned long long get_frame_counter(const request_mapping&, const platform::frame_object&) const override { return counter; }
+        rs2_timestamp_domain get_frame_timestamp_domain(const request_mapping&, const platform::frame_object&) const override { return RS2_TIMESTAMP_DOMAIN_SYSTEM_TIME; }
+        void reset() override { counter = 0; }
+
+        unsigned long long counter = 0;
+    };
+
+    software_device owner;
+    auto uvc = std::make_shared<fake_uvc_device>();
+    auto sensor = std::make_shared<uvc_sensor>("Fake", uvc, std::unique_ptr<frame_timestamp_reader>(new counting_reader()), &owner);
+    sensor->register_pixel_format(pf_yuy2);
+    sensor->get_option(RS2_OPTION_LAZY_UNPACKING).set(3);
+
+    auto profiles = sensor->get_stream_profiles();
+    auto rgb = std::find_if(profiles.begin(), profiles.end(),
+        [](std::shared_ptr<stream_profile_interface> p) { return p->get_format() == RS2_FORMAT_RGB8; });
+    REQUIRE(rgb != profiles.end());
+    sensor->open({ *rgb });
+
+    std::mutex m;
+    std::condition_variable cv;
+    int received = 0;
+    auto on_frame = [&](frame_interface* f)
+    {
+        frame_holder holder(f);
+        std::lock_guard<std::mutex> lock(m);
+        ++received;
+        cv.notify_all();
+    };
+
+    std::vector<uint8_t> pixels(uvc->W * uvc->H * 2, 0x80);
+    for (int run = 1; run <= 2; ++run)
+    {
+        sensor->start({ new internal_frame_callback<decltype(on_frame)>(on_frame), [](rs2_frame_callback* c) { c->release(); } });
+        uvc->push(pixels);
+
+        std::unique_lock<std::mutex> lock(m);
+        REQUIRE(cv.wait_for(lock, std::chrono::seconds(5), [&]() { return received == run; }));
+        lock.unlock();
+        sensor->stop();
+    }
+    sensor->close();
+}
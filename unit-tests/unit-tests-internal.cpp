@@ -20,6 +20,20 @@
 #include <../src/proc/disparity-transform.h>
 #include <../src/proc/spatial-filter.h>
 #include <../src/proc/temporal-filter.h>
+#include <../src/metadata-parser.h>
+#include <../src/proc/rvl-codec.h>
+#include <../src/proc/occlusion-filter.h>
+#include <../src/tracing.h>
+#include <../src/thread-scheduling.h>
+#include <../src/numa-allocator.h>
+#include <../src/memory-accounting.h>
+#include <../src/device-cache.h>
+#include <../src/usb-bandwidth.h>
+#include <../src/stream-statistics.h>
+#include <../src/shared-backend.h>
+#ifdef RS2_USE_CUDA
+#include <../src/cuda/cuda-pointcloud.cuh>
+#endif
 
 using namespace rs2;
 using namespace librealsense;  // An internal namespace not acessible via the public API
@@ -4403,8 +4417,1443 @@ TEST_CASE("Syncer clean_inactive_streams by frame number with software-device de
 }
 
 void dev_changed(rs2_device_list* removed_devs, rs2_device_list* added_devs, void* ptr) {}
+TEST_CASE("Multi-device syncer matches frame counters across devices", "[software-device]")
+{
+    const int W = 64;
+    const int H = 48;
+    const int BPP = 2;
+    rs2_intrinsics intrinsics{ W, H, 0, 0, 0, 0, RS2_DISTORTION_NONE ,{ 0,0,0,0,0 } };
+
+    // Two cameras on one trigger, whose frame counters started apart
+    software_device dev_a, dev_b;
+    auto sa = dev_a.add_sensor("software_sensor");
+    auto sb = dev_b.add_sensor("software_sensor");
+    sa.add_video_stream({ RS2_STREAM_DEPTH, 0, 0, W, H, 30, BPP, RS2_FORMAT_Z16, intrinsics });
+    sb.add_video_stream({ RS2_STREAM_DEPTH, 0, 1, W, H, 30, BPP, RS2_FORMAT_Z16, intrinsics });
+    auto depth_a = sa.get_stream_profiles()[0];
+    auto depth_b = sb.get_stream_profiles()[0];
+
+    multi_device_syncer sync(10);
+    sync.set_option(RS2_OPTION_FRAMES_QUEUE_SIZE, 32);
+    sa.open(depth_a);
+    sb.open(depth_b);
+    sa.start(sync);
+    sb.start(sync);
+
+    std::vector<uint8_t> pixels(W * H * BPP, 0);
+    auto send = [&](software_sensor& s, rs2::stream_profile p, int number)
+    {
+        s.on_video_frame({ pixels.data(), [](void*) {}, W * BPP, BPP, 0, RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, number, p });
+    };
+    send(sa, depth_a, 100);
+    send(sb, depth_b, 7);
+    send(sa, depth_a, 101);
+    send(sb, depth_b, 8);
+    // the second camera misses a trigger
+    send(sa, depth_a, 102);
+    send(sa, depth_a, 103);
+    send(sb, depth_b, 10);
+
+    std::vector<std::pair<int, int>> expected = { { 100, 7 }, { 101, 8 }, { 103, 10 } };
+    for (auto&& e : expected)
+    {
+        frameset fs;
+        REQUIRE_NOTHROW(fs = sync.wait_for_frames(5000));
+        REQUIRE(fs.size() == 2);
+
+        std::pair<int, int> numbers;
+        for (auto f : fs)
+        {
+            if (f.get_profile().unique_id() == depth_a.unique_id())
+                numbers.first = int(f.get_frame_number());
+            else
+                numbers.second = int(f.get_frame_number());
+        }
+        REQUIRE(numbers == e);
+    }
+
+    sa.stop();
+    sb.stop();
+    sa.close();
+    sb.close();
+}
+
+TEST_CASE("Software device frames adopt the injected buffers", "[software-device]")
+{
+    const int W = 64;
+    const int H = 48;
+    const int BPP = 2;
+    rs2_intrinsics intrinsics{ W, H, 0, 0, 0, 0, RS2_DISTORTION_NONE ,{ 0,0,0,0,0 } };
+
+    software_device dev;
+    auto s = dev.add_sensor("software_sensor");
+    s.add_video_stream({ RS2_STREAM_DEPTH, 0, 0, W, H, 30, BPP, RS2_FORMAT_Z16, intrinsics });
+    auto depth = s.get_stream_profiles()[0];
+
+    rs2_frame_metadata_value keys[] = { RS2_FRAME_METADATA_FRAME_COUNTER, RS2_FRAME_METADATA_ACTUAL_EXPOSURE };
+    rs2_metadata_type values[] = { 42, 8500 };
+    s.set_metadata(keys, values, 2);
+
+    frame_queue q(4);
+    s.open(depth);
+    s.start(q);
+
+    static std::atomic<int> released(0);
+    released = 0;
+    auto pixels = new uint16_t[W * H];
+    s.on_video_frame({ pixels, [](void* p) { delete[] static_cast<uint16_t*>(p); released++; },
+        W * BPP, BPP, 0, RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, 1, depth });
+
+    {
+        rs2::frame f;
+        REQUIRE(q.poll_for_frame(&f));
+        REQUIRE(f.get_data() == pixels);
+        for (int i = 0; i < 2; i++)
+        {
+            REQUIRE(f.supports_frame_metadata(keys[i]));
+            REQUIRE(f.get_frame_metadata(keys[i]) == values[i]);
+        }
+        REQUIRE(released == 0);
+    }
+    REQUIRE(released == 1);
+
+    s.stop();
+    s.close();
+}
+
+TEST_CASE("Serialized frames are recreated on a software device", "[software-device]")
+{
+    const int W = 64;
+    const int H = 48;
+    const int BPP = 2;
+    rs2_intrinsics intrinsics{ W, H, 31.5f, 23.5f, 50, 50, RS2_DISTORTION_BROWN_CONRADY ,{ 0.1f,0,0,0,0 } };
+
+    software_device sender;
+    auto s = sender.add_sensor("software_sensor");
+    s.add_video_stream({ RS2_STREAM_DEPTH, 0, 0, W, H, 30, BPP, RS2_FORMAT_Z16, intrinsics });
+    auto depth = s.get_stream_profiles()[0];
+    rs2_frame_metadata_value keys[] = { RS2_FRAME_METADATA_FRAME_COUNTER, RS2_FRAME_METADATA_ACTUAL_EXPOSURE };
+    rs2_metadata_type values[] = { 42, 8500 };
+    s.set_metadata(keys, values, 2);
+
+    frame_queue sent(4);
+    s.open(depth);
+    s.start(sent);
+    auto pixels = new uint16_t[W * H];
+    for (int i = 0; i < W * H; i++)
+        pixels[i] = static_cast<uint16_t>(i);
+    s.on_video_frame({ pixels, [](void* p) { delete[] static_cast<uint16_t*>(p); },
+        W * BPP, BPP, 1234.5, RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, 7, depth });
+    rs2::frame original;
+    REQUIRE(sent.poll_for_frame(&original));
+
+    // The payload segment points into the frame, the message is their concatenation
+    frame_serializer serializer;
+    auto segments = serializer.serialize(original);
+    REQUIRE(segments.size() == 2);
+    REQUIRE(segments[1].data == original.get_data());
+    REQUIRE(segments[1].size == W * H * BPP);
+    std::vector<uint8_t> message;
+    for (auto&& segment : segments)
+        message.insert(message.end(), static_cast<const uint8_t*>(segment.data), static_cast<const uint8_t*>(segment.data) + segment.size);
+
+    software_device receiver;
+    frame_queue received(4);
+    {
+        frame_deserializer deserializer(receiver, received);
+        deserializer.deserialize(message.data(), message.size());
+        REQUIRE_THROWS(deserializer.deserialize(message.data(), message.size() / 2));
+
+        // A payload shorter than the frame its header describes. The payload size ends the frame header, right
+        // before the two metadata entries of a 32 bits key and a 64 bits value
+        auto truncated = message;
+        auto payload_size_offset = message.size() - W * H * BPP - 2 * (sizeof(int32_t) + sizeof(int64_t)) - sizeof(uint64_t);
+        uint64_t short_size = W * H * BPP / 2;
+        memcpy(truncated.data() + payload_size_offset, &short_size, sizeof(short_size));
+        truncated.resize(truncated.size() - short_size);
+        REQUIRE_THROWS(deserializer.deserialize(truncated.data(), truncated.size()));
+
+        // Another sender reusing the unique id of the stream for frames of another size
+        software_device other;
+        auto o = other.add_sensor("software_sensor");
+        o.add_video_stream({ RS2_STREAM_DEPTH, 0, 0, W / 2, H / 2, 30, BPP, RS2_FORMAT_Z16, intrinsics });
+        frame_queue resized(1);
+        o.open(o.get_stream_profiles()[0]);
+        o.start(resized);
+        std::vector<uint16_t> half(W * H / 4);
+        o.on_video_frame({ half.data(), [](void*) {}, W / 2 * BPP, BPP, 1, RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, 1, o.get_stream_profiles()[0] });
+        rs2::frame small;
+        REQUIRE(resized.poll_for_frame(&small));
+        frame_serializer resized_serializer;
+        std::vector<uint8_t> resized_message;
+        for (auto&& segment : resized_serializer.serialize(small))
+            resized_message.insert(resized_message.end(), static_cast<const uint8_t*>(segment.data), static_cast<const uint8_t*>(segment.data) + segment.size);
+        REQUIRE_THROWS(deserializer.deserialize(resized_message.data(), resized_message.size()));
+        small = rs2::frame();
+        o.stop();
+        o.close();
+
+        rs2::frame f;
+        REQUIRE(received.poll_for_frame(&f));
+        REQUIRE(f.is<rs2::depth_frame>());
+        REQUIRE(f.get_data() != original.get_data());
+        REQUIRE(memcmp(f.get_data(), original.get_data(), W * H * BPP) == 0);
+        REQUIRE(f.get_frame_number() == 7);
+        REQUIRE(f.get_timestamp() == 1234.5);
+        REQUIRE(f.get_profile().stream_type() == RS2_STREAM_DEPTH);
+        REQUIRE(f.get_profile().format() == RS2_FORMAT_Z16);
+        auto received_intrinsics = f.get_profile().as<video_stream_profile>().get_intrinsics();
+        REQUIRE(received_intrinsics.fx == intrinsics.fx);
+        REQUIRE(received_intrinsics.coeffs[0] == intrinsics.coeffs[0]);
+        for (int i = 0; i < 2; i++)
+            REQUIRE(f.get_frame_metadata(keys[i]) == values[i]);
+    }
+
+    s.stop();
+    s.close();
+}
+
+TEST_CASE("Extrinsics lookups follow new registrations", "[software-device]")
+{
+    rs2_intrinsics intrinsics{ 64, 48, 0, 0, 0, 0, RS2_DISTORTION_NONE ,{ 0,0,0,0,0 } };
+
+    software_device dev;
+    auto s = dev.add_sensor("software_sensor");
+    auto a = s.add_video_stream({ RS2_STREAM_DEPTH, 0, 0, 64, 48, 30, 2, RS2_FORMAT_Z16, intrinsics });
+    auto b = s.add_video_stream({ RS2_STREAM_INFRARED, 1, 1, 64, 48, 30, 1, RS2_FORMAT_Y8, intrinsics });
+    auto c = s.add_video_stream({ RS2_STREAM_COLOR, 0, 2, 64, 48, 30, 3, RS2_FORMAT_RGB8, intrinsics });
+
+    rs2_extrinsics a_to_b = { { 1,0,0, 0,1,0, 0,0,1 }, { 0.05f, 0, 0 } };
+    rs2_extrinsics b_to_c = { { 1,0,0, 0,1,0, 0,0,1 }, { 0, 0.01f, 0 } };
+    a.register_extrinsics_to(b, a_to_b);
+    b.register_extrinsics_to(c, b_to_c);
+
+    // Repeated lookups, across two edges and backwards
+    for (int i = 0; i < 3; i++)
+    {
+        auto e = a.get_extrinsics_to(c);
+        REQUIRE(e.translation[0] == Approx(0.05f));
+        REQUIRE(e.translation[1] == Approx(0.01f));
+        REQUIRE(c.get_extrinsics_to(a).translation[0] == Approx(-0.05f));
+    }
+
+    // A direct edge registered later takes over
+    rs2_extrinsics a_to_c = { { 1,0,0, 0,1,0, 0,0,1 }, { 0, 0, 0.1f } };
+    a.register_extrinsics_to(c, a_to_c);
+    auto e = a.get_extrinsics_to(c);
+    REQUIRE(e.translation[0] == Approx(0.f));
+    REQUIRE(e.translation[2] == Approx(0.1f));
+}
+
 TEST_CASE("C API Compilation", "[live]") {
     rs2_error* e;
     REQUIRE_NOTHROW(rs2_set_devices_changed_callback(NULL, dev_changed, NULL, &e));
     REQUIRE(e != nullptr);
 }
+
+// Scalar reference for the YUV 4:2:2 unpackers, matching the arithmetic of the generic code in image.cpp
+static void yuv_to_rgb_reference(int y, int u, int v, uint8_t rgb[3])
+{
+    auto clamp = [](int x) { return static_cast<uint8_t>(x < 0 ? 0 : (x > 255 ? 255 : x)); };
+    int c = y - 16, d = u - 128, e = v - 128;
+    rgb[0] = clamp((298 * c + 409 * e + 128) >> 8);
+    rgb[1] = clamp((298 * c - 100 * d - 208 * e + 128) >> 8);
+    rgb[2] = clamp((298 * c + 516 * d + 128) >> 8);
+}
+
+static std::vector<byte> unpack_with(const native_pixel_format& pf, rs2_format format, const std::vector<byte>& source, int width, int height, size_t out_bytes, int plane = 0)
+{
+    for (auto&& unpacker : pf.unpackers)
+    {
+        if (unpacker.outputs.back().format != format)
+            continue;
+
+        std::vector<byte> planes[2] = { std::vector<byte>(out_bytes), std::vector<byte>(out_bytes) };
+        byte * dest[] = { planes[0].data(), planes[1].data() };
+        unpacker.unpack(dest, source.data(), width, height);
+        return planes[plane];
+    }
+    FAIL("Unpacker not found");
+    return {};
+}
+
+TEST_CASE("Vectorized unpackers match the scalar reference", "[unpack]")
+{
+    std::srand(42);
+    auto random_bytes = [](size_t size) {
+        std::vector<byte> data(size);
+        for (auto&& b : data) b = static_cast<byte>(std::rand());
+        return data;
+    };
+
+    // Sizes chosen to exercise both the full-width vector loops and the scalar tails
+    const std::vector<std::pair<int, int>> sizes = { { 640, 480 }, { 648, 2 }, { 37, 3 } };
+    for (auto&& size : sizes)
+    {
+        auto w = size.first, h = size.second, n = w * h;
+        CAPTURE(w);
+        CAPTURE(h);
+
+        // Y8I splits into left and right Y8
+        {
+            auto src = random_bytes(n * 2);
+            auto l = unpack_with(pf_y8i, RS2_FORMAT_Y8, src, w, h, n, 0);
+            auto r = unpack_with(pf_y8i, RS2_FORMAT_Y8, src, w, h, n, 1);
+            auto lr = unpack_with(pf_y8i, RS2_FORMAT_Y8I, src, w, h, n * 2);
+            REQUIRE(lr == src);
+            for (int i = 0; i < n; ++i)
+            {
+                REQUIRE(l[i] == src[i * 2]);
+                REQUIRE(r[i] == src[i * 2 + 1]);
+            }
+        }
+
+        // Y12I splits into left and right Y16
+        {
+            auto src = random_bytes(n * 3);
+            auto l = unpack_with(pf_y12i, RS2_FORMAT_Y16, src, w, h, n * 2, 0);
+            auto r = unpack_with(pf_y12i, RS2_FORMAT_Y16, src, w, h, n * 2, 1);
+            auto l16 = reinterpret_cast<const uint16_t*>(l.data());
+            auto r16 = reinterpret_cast<const uint16_t*>(r.data());
+            for (int i = 0; i < n; ++i)
+            {
+                int rv = (src[i * 3 + 1] & 0xF) << 8 | src[i * 3];
+                int lv = src[i * 3 + 2] << 4 | src[i * 3 + 1] >> 4;
+                REQUIRE(l16[i] == static_cast<uint16_t>(lv << 6 | lv >> 4));
+                REQUIRE(r16[i] == static_cast<uint16_t>(rv << 6 | rv >> 4));
+            }
+        }
+
+        // Y16 / Y8 bit-depth conversions
+        {
+            auto src = random_bytes(n * 2);
+            auto src16 = reinterpret_cast<const uint16_t*>(src.data());
+            auto y16 = unpack_with(pf_y16, RS2_FORMAT_Y16, src, w, h, n * 2);
+            auto y8 = unpack_with(pf_sr300_invi, RS2_FORMAT_Y8, src, w, h, n);
+            auto y16_from_y8 = unpack_with(pf_f200_invi, RS2_FORMAT_Y16, src, w, h, n * 2);
+            for (int i = 0; i < n; ++i)
+            {
+                REQUIRE(reinterpret_cast<const uint16_t*>(y16.data())[i] == static_cast<uint16_t>(src16[i] << 6));
+                REQUIRE(y8[i] == static_cast<uint8_t>(src16[i] >> 2));
+                REQUIRE(reinterpret_cast<const uint16_t*>(y16_from_y8.data())[i] == (src[i] | src[i] << 8));
+            }
+        }
+
+        // SR300 INZI splits into Z16 and IR
+        {
+            auto src = random_bytes(n * 4);
+            auto src16 = reinterpret_cast<const uint16_t*>(src.data());
+            auto z = unpack_with(pf_sr300_inzi, RS2_FORMAT_Y8, src, w, h, n * 2, 0);
+            auto ir = unpack_with(pf_sr300_inzi, RS2_FORMAT_Y8, src, w, h, n * 2, 1);
+            REQUIRE(std::equal(z.begin(), z.end(), src.begin() + n * 2));
+            for (int i = 0; i < n; ++i)
+                REQUIRE(ir[i] == static_cast<uint8_t>(src16[i] >> 2));
+        }
+
+        // L500 images are rotated by 270 degrees, the confidence nibbles become two rows per source column
+        {
+            auto src = random_bytes(n * 2);
+            auto src16 = reinterpret_cast<const uint16_t*>(src.data());
+            auto z = unpack_with(pf_z16_l500, RS2_FORMAT_Z16, src, w, h, n * 2);
+            auto ir = unpack_with(pf_y8_l500, RS2_FORMAT_Y8, src, w, h, n);
+            auto c = unpack_with(pf_confidence_l500, RS2_FORMAT_RAW8, src, w, h, n * 2);
+            auto z16 = reinterpret_cast<const uint16_t*>(z.data());
+            for (int i = 0; i < h; ++i)
+            {
+                for (int j = 0; j < w; ++j)
+                {
+                    auto rotated = (w - 1 - j) * h + i;
+                    REQUIRE(z16[rotated] == src16[i * w + j]);
+                    REQUIRE(ir[rotated] == src[i * w + j]);
+                    REQUIRE(c[(w - 1 - j) * 2 * h + i] == static_cast<byte>(src[i * w + j] << 4));
+                    REQUIRE(c[((w - 1 - j) * 2 + 1) * h + i] == (src[i * w + j] & 0xf0));
+                }
+            }
+        }
+
+        // BGR swaps to RGB
+        {
+            auto src = random_bytes(n * 3);
+            auto rgb = unpack_with(pf_rgb888, RS2_FORMAT_RGB8, src, w, h, n * 3);
+            for (int i = 0; i < n; ++i)
+            {
+                REQUIRE(rgb[i * 3] == src[i * 3 + 2]);
+                REQUIRE(rgb[i * 3 + 1] == src[i * 3 + 1]);
+                REQUIRE(rgb[i * 3 + 2] == src[i * 3]);
+            }
+        }
+
+        // YUY2 and UYVY color conversion, only defined for multiples of 16 pixels
+        if (n % 16 == 0)
+        {
+            auto src = random_bytes(n * 2);
+            auto yuy2 = unpack_with(pf_yuy2, RS2_FORMAT_RGBA8, src, w, h, n * 4);
+            auto uyvy = unpack_with(pf_uyvyl, RS2_FORMAT_BGR8, src, w, h, n * 3);
+            auto y16 = unpack_with(pf_yuy2, RS2_FORMAT_Y16, src, w, h, n * 2);
+            for (int i = 0; i < n; ++i)
+            {
+                auto pair = src.data() + (i / 2) * 4;
+                uint8_t expected[3];
+
+                // The SSE and AVX2 kernels truncate intermediate products, within two levels of the reference
+                yuv_to_rgb_reference(pair[(i % 2) * 2], pair[1], pair[3], expected);
+                for (int c = 0; c < 3; ++c)
+                    REQUIRE(std::abs(yuy2[i * 4 + c] - expected[c]) <= 2);
+                REQUIRE(yuy2[i * 4 + 3] == 255);
+                REQUIRE(reinterpret_cast<const uint16_t*>(y16.data())[i] == pair[(i % 2) * 2] << 8);
+
+                yuv_to_rgb_reference(pair[(i % 2) * 2 + 1], pair[0], pair[2], expected);
+                for (int c = 0; c < 3; ++c)
+                    REQUIRE(std::abs(uyvy[i * 3 + c] - expected[2 - c]) <= 2);
+            }
+        }
+    }
+}
+
+TEST_CASE("Lock-free queue keeps the newest items", "[concurrency]")
+{
+    lock_free_queue<int> q(3);
+    for (int i = 0; i < 10; ++i)
+        q.enqueue(std::move(i));
+    REQUIRE(q.size() == 3);
+
+    int item = -1;
+    for (int expected = 7; expected < 10; ++expected)
+    {
+        REQUIRE(q.try_dequeue(&item));
+        REQUIRE(item == expected);
+    }
+    REQUIRE_FALSE(q.try_dequeue(&item));
+    REQUIRE_FALSE(q.dequeue(&item, 10));
+
+    // Items of every producer arrive in order, even when some are dropped
+    const int producers = 3, items = 10000;
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p)
+        threads.emplace_back([&q, p]() { for (int i = 0; i < items; ++i) q.enqueue(p * items + i); });
+
+    std::vector<int> last(producers, -1);
+    int received = 0;
+    while (q.dequeue(&item, 100))
+    {
+        auto p = item / items, i = item % items;
+        REQUIRE(i > last[p]);
+        last[p] = i;
+        ++received;
+    }
+    for (auto&& t : threads)
+        t.join();
+    while (q.try_dequeue(&item))
+        ++received;
+    REQUIRE(received > 0);
+    REQUIRE(received <= producers * items);
+
+    q.clear();
+    q.enqueue(1);
+    REQUIRE(q.size() == 0);
+}
+
+TEST_CASE("Queue consumers spin before they sleep", "[concurrency]")
+{
+    auto total = [](const wait_control& wait)
+    {
+        unsigned long long count = 0;
+        for (int i = 0; i < wait_control::latency_buckets; ++i)
+            count += wait.latency_count(i);
+        return count;
+    };
+
+    // By default the consumers sleep until they're signaled, items already queued are taken without a wait
+    single_consumer_queue<int> blocking(4);
+    blocking.enqueue(1);
+    int item = -1;
+    REQUIRE(blocking.dequeue(&item, 10));
+    REQUIRE(total(blocking.get_wait_control()) == 0);
+
+    // Without a strategy, the wakeups are only timed once asked for
+    std::thread unmeasured([&blocking]() { std::this_thread::sleep_for(std::chrono::milliseconds(10)); blocking.enqueue(2); });
+    REQUIRE(blocking.dequeue(&item, 1000));
+    unmeasured.join();
+    REQUIRE(item == 2);
+    REQUIRE(total(blocking.get_wait_control()) == 0);
+
+    blocking.get_wait_control().measure();
+    std::thread late([&blocking]() { std::this_thread::sleep_for(std::chrono::milliseconds(10)); blocking.enqueue(5); });
+    REQUIRE(blocking.dequeue(&item, 1000));
+    late.join();
+    REQUIRE(item == 5);
+    REQUIRE(blocking.get_wait_control().wakeups(wait_control::sleeping) == 1);
+    REQUIRE(total(blocking.get_wait_control()) == 1);
+
+    // With a strategy long enough to cover the producer, the wakeup happens before the consumer sleeps
+    auto wait = std::make_shared<wait_control>();
+    wait->set_strategy(std::chrono::seconds(1), std::chrono::seconds(1));
+    single_consumer_queue<int> spinning(4, wait);
+    lock_free_queue<int> lock_free(4, wait);
+
+    std::thread producer([&]()
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        spinning.enqueue(3);
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        lock_free.enqueue(4);
+    });
+    REQUIRE(spinning.dequeue(&item, 5000));
+    REQUIRE(item == 3);
+    REQUIRE(lock_free.dequeue(&item, 5000));
+    REQUIRE(item == 4);
+    producer.join();
+
+    REQUIRE(wait->wakeups(wait_control::spinning) + wait->wakeups(wait_control::yielding) == 2);
+    REQUIRE(wait->wakeups(wait_control::sleeping) == 0);
+    REQUIRE(total(*wait) == 2);
+
+    wait->reset();
+    REQUIRE(total(*wait) == 0);
+}
+
+TEST_CASE("Broadcast queue delivers every item to every subscriber", "[concurrency]")
+{
+    // Items are shared between the subscribers like frames, the ring and every reader hold a reference
+    struct shared_item
+    {
+        std::shared_ptr<int> value;
+        shared_item clone() const { return *this; }
+    };
+
+    broadcast_queue<shared_item> q(4);
+    auto lossy = q.subscribe(false);
+    shared_item item;
+    REQUIRE_FALSE(q.try_dequeue(lossy, &item));
+
+    for (int i = 0; i < 10; ++i)
+        q.enqueue({ std::make_shared<int>(i) });
+
+    // Subscribers only receive the items enqueued after they subscribed
+    auto late = q.subscribe(false);
+    REQUIRE_FALSE(q.try_dequeue(late, &item));
+
+    broadcast_queue<shared_item>::statistics stats;
+    REQUIRE(q.get_statistics(lossy, &stats));
+    REQUIRE(stats.dropped == 6);
+    REQUIRE(stats.lag == 4);
+    REQUIRE(stats.max_lag == 4);
+    for (int expected = 6; expected < 10; ++expected)
+    {
+        REQUIRE(q.try_dequeue(lossy, &item));
+        REQUIRE(*item.value == expected);
+        REQUIRE(item.value.use_count() == 2);
+    }
+    REQUIRE_FALSE(q.dequeue(lossy, &item, 10));
+    REQUIRE(q.get_statistics(lossy, &stats));
+    REQUIRE(stats.received == 4);
+    REQUIRE(stats.lag == 0);
+
+    // A blocking subscriber holds the producer back instead of losing items
+    auto blocking = q.subscribe(true);
+    const int items = 1000;
+    std::thread producer([&]() { for (int i = 0; i < items; ++i) q.enqueue({ std::make_shared<int>(i) }); });
+    for (int expected = 0; expected < items; ++expected)
+    {
+        REQUIRE(q.dequeue(blocking, &item, 1000));
+        REQUIRE(*item.value == expected);
+    }
+    producer.join();
+    REQUIRE(q.get_statistics(blocking, &stats));
+    REQUIRE(stats.received == items);
+    REQUIRE(stats.dropped == 0);
+    REQUIRE(stats.max_lag <= 4);
+
+    REQUIRE(q.get_statistics(late, &stats));
+    REQUIRE(stats.dropped == items - 4);
+    REQUIRE(stats.lag == 4);
+
+    // Leaving wakes the reader up, and its identifier is no longer known
+    while (q.try_dequeue(late, &item));
+    std::atomic<int> woken(-1);
+    std::thread reader([&]() { shared_item last; woken = q.dequeue(late, &last, 5000); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    q.unsubscribe(late);
+    reader.join();
+    REQUIRE(woken == 0);
+    REQUIRE_FALSE(q.get_statistics(late, &stats));
+
+    q.clear();
+    REQUIRE(q.get_statistics(lossy, &stats));
+    REQUIRE(stats.lag == 0);
+    REQUIRE_FALSE(q.try_dequeue(blocking, &item));
+}
+
+TEST_CASE("Seqlock readers never see a torn value", "[concurrency]")
+{
+    struct pair { int first, second; };
+    seqlock<pair> latest;
+    pair value{};
+    REQUIRE_FALSE(latest.load(value));
+
+    std::atomic<bool> done(false);
+    std::thread writer([&]() {
+        for (int i = 1; i <= 100000; ++i)
+            latest.store({ i, -i });
+        done = true;
+    });
+
+    int last = 0;
+    while (!done)
+    {
+        if (latest.load(value))
+        {
+            REQUIRE(value.second == -value.first);
+            REQUIRE(value.first >= last);
+            last = value.first;
+        }
+    }
+    writer.join();
+    REQUIRE(latest.load(value));
+    REQUIRE(value.first == 100000);
+
+    latest.reset();
+    REQUIRE_FALSE(latest.load(value));
+}
+
+TEST_CASE("Dispatchers share the thread pool as ordered strands", "[concurrency]")
+{
+    auto pool = std::make_shared<thread_pool>(2);
+
+    // Items of every dispatcher run one at a time and in order, on no more threads than the pool needs
+    const int dispatchers = 16, items = 200;
+    std::vector<std::unique_ptr<dispatcher>> strands;
+    std::vector<std::vector<int>> received(dispatchers);
+    std::vector<std::atomic<int>> in_flight(dispatchers);
+    std::atomic<bool> overlapped(false);
+    for (int d = 0; d < dispatchers; ++d)
+    {
+        in_flight[d] = 0;
+        strands.emplace_back(new dispatcher(items, pool));
+        strands.back()->start();
+    }
+    for (int i = 0; i < items; ++i)
+    {
+        for (int d = 0; d < dispatchers; ++d)
+        {
+            strands[d]->invoke([&, d, i](dispatcher::cancellable_timer)
+            {
+                if (in_flight[d]++) overlapped = true;
+                received[d].push_back(i);
+                in_flight[d]--;
+            });
+        }
+    }
+    for (auto&& s : strands)
+        REQUIRE(s->flush());
+    REQUIRE_FALSE(overlapped);
+    for (auto&& r : received)
+    {
+        REQUIRE(r.size() == items);
+        REQUIRE(std::is_sorted(r.begin(), r.end()));
+    }
+
+    // Sleeping items do not hold back the other dispatchers
+    auto start = std::chrono::steady_clock::now();
+    std::atomic<int> woken(0);
+    for (int d = 0; d < 4; ++d)
+        strands[d]->invoke([&](dispatcher::cancellable_timer t) { t.try_sleep(300); woken++; });
+    for (int d = 0; d < 4; ++d)
+        REQUIRE(strands[d]->flush());
+    REQUIRE(woken == 4);
+    REQUIRE(std::chrono::steady_clock::now() - start < std::chrono::milliseconds(1000));
+
+    // Stopping cancels the timer of the item in progress and drops the queued ones
+    std::atomic<int> ran(0);
+    std::atomic<bool> cancelled(false);
+    strands[0]->invoke([&](dispatcher::cancellable_timer t) { ran++; cancelled = !t.try_sleep(10000); });
+    strands[0]->invoke([&](dispatcher::cancellable_timer t) { ran++; });
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    strands[0]->stop();
+    REQUIRE(ran == 1);
+    REQUIRE(cancelled);
+    strands.clear();
+}
+
+TEST_CASE("Dispatcher timers wake up at their deadline", "[concurrency]")
+{
+    using namespace std::chrono;
+    dispatcher d(10);
+    d.start();
+
+    // Absolute deadlines 10ms apart, as playback paces its frames, are met without drifting
+    const int deadlines = 50;
+    std::vector<nanoseconds> lateness;
+    std::atomic<bool> woken(true);
+    auto base = steady_clock::now();
+    d.invoke([&](dispatcher::cancellable_timer t)
+    {
+        for (int i = 1; i <= deadlines; ++i)
+        {
+            auto deadline = base + milliseconds(10 * i);
+            if (!t.try_sleep_until(deadline)) woken = false;
+            lateness.push_back(steady_clock::now() - deadline);
+        }
+    });
+    REQUIRE(d.flush());
+    REQUIRE(woken);
+    REQUIRE(lateness.size() == deadlines);
+    std::sort(lateness.begin(), lateness.end());
+    REQUIRE(lateness.front() >= nanoseconds(0));
+    // The median, since a loaded machine may preempt the thread now and then
+    REQUIRE(lateness[deadlines / 2] < milliseconds(1));
+
+    // Stopping cancels the wait
+    std::atomic<bool> cancelled(false);
+    d.invoke([&](dispatcher::cancellable_timer t) { cancelled = !t.try_sleep_until(steady_clock::now() + seconds(10)); });
+    std::this_thread::sleep_for(milliseconds(100));
+    d.stop();
+    REQUIRE(cancelled);
+}
+
+class counting_md_parser : public librealsense::md_attribute_parser_base
+{
+public:
+    counting_md_parser(rs2_metadata_type value, bool supported) : _value(value), _supported(supported) {}
+
+    rs2_metadata_type get(const librealsense::frame& frm) const override
+    {
+        ++gets;
+        if (!_supported) throw librealsense::invalid_value_exception("unsupported");
+        return _value;
+    }
+    bool supports(const librealsense::frame& frm) const override { ++checks; return _supported; }
+
+    mutable int gets = 0;
+    mutable int checks = 0;
+
+private:
+    rs2_metadata_type _value;
+    bool _supported;
+};
+
+TEST_CASE("Frame metadata is parsed once per frame", "[metadata]")
+{
+    auto counter = std::make_shared<counting_md_parser>(42, true);
+    auto missing = std::make_shared<counting_md_parser>(0, false);
+    auto parsers = std::make_shared<librealsense::metadata_parser_map>();
+    (*parsers)[RS2_FRAME_METADATA_FRAME_COUNTER] = counter;
+    (*parsers)[RS2_FRAME_METADATA_GAIN_LEVEL] = missing;
+
+    librealsense::frame f;
+    f.metadata_parsers = parsers;
+
+    for (auto i = 0; i < 3; ++i)
+    {
+        REQUIRE(f.supports_frame_metadata(RS2_FRAME_METADATA_FRAME_COUNTER));
+        REQUIRE(f.get_frame_metadata(RS2_FRAME_METADATA_FRAME_COUNTER) == 42);
+        REQUIRE_FALSE(f.supports_frame_metadata(RS2_FRAME_METADATA_GAIN_LEVEL));
+        REQUIRE_FALSE(f.supports_frame_metadata(RS2_FRAME_METADATA_ACTUAL_EXPOSURE));
+    }
+    REQUIRE(counter->checks == 1);
+    REQUIRE(counter->gets == 1);
+    REQUIRE(missing->gets == 0);
+
+    // Unsupported attributes still report the parser's error
+    REQUIRE_THROWS(f.get_frame_metadata(RS2_FRAME_METADATA_GAIN_LEVEL));
+
+    // A new timestamp may change derived attributes, so the frame is parsed again
+    f.set_timestamp(1);
+    REQUIRE(f.get_frame_metadata(RS2_FRAME_METADATA_FRAME_COUNTER) == 42);
+    REQUIRE(counter->gets == 2);
+
+    std::vector<rs2_metadata_type> values(::RS2_FRAME_METADATA_COUNT);
+    std::vector<int> supported(::RS2_FRAME_METADATA_COUNT);
+    auto count = rs2_get_frame_metadata_all((rs2_frame*)(librealsense::frame_interface*)&f, values.data(), supported.data(), ::RS2_FRAME_METADATA_COUNT, nullptr);
+    REQUIRE(count == 1);
+    REQUIRE(supported[RS2_FRAME_METADATA_FRAME_COUNTER] == 1);
+    REQUIRE(values[RS2_FRAME_METADATA_FRAME_COUNTER] == 42);
+    REQUIRE(supported[RS2_FRAME_METADATA_GAIN_LEVEL] == 0);
+}
+
+TEST_CASE("Internal metadata attributes are parsed on demand", "[metadata]")
+{
+    auto counter = std::make_shared<counting_md_parser>(42, true);
+    auto width = std::make_shared<counting_md_parser>(640, true);
+    auto parsers = std::make_shared<librealsense::metadata_parser_map>();
+    (*parsers)[RS2_FRAME_METADATA_FRAME_COUNTER] = counter;
+    (*parsers)[(rs2_frame_metadata_value)librealsense::RS2_FRAME_METADATA_WIDTH] = width;
+
+    librealsense::frame f;
+    f.metadata_parsers = parsers;
+
+    // The internal attribute is left out of the decoded attributes, and parsed on every query
+    REQUIRE(f.get_frame_metadata(RS2_FRAME_METADATA_FRAME_COUNTER) == 42);
+    REQUIRE(width->checks == 0);
+    REQUIRE(width->gets == 0);
+    for (auto i = 1; i <= 2; ++i)
+    {
+        REQUIRE(f.supports_frame_metadata((rs2_frame_metadata_value)librealsense::RS2_FRAME_METADATA_WIDTH));
+        REQUIRE(f.get_frame_metadata((rs2_frame_metadata_value)librealsense::RS2_FRAME_METADATA_WIDTH) == 640);
+        REQUIRE(width->gets == i);
+    }
+    REQUIRE(f.get_frame_metadata(RS2_FRAME_METADATA_FRAME_COUNTER) == 42);
+    REQUIRE(counter->gets == 1);
+}
+
+class value_option : public librealsense::option
+{
+public:
+    explicit value_option(float& value) : _value(value) {}
+
+    void set(float value) override { _value = value; }
+    float query() const override { return _value; }
+    librealsense::option_range get_range() const override { return{ 0.f, 10.f, 1.f, 1.f }; }
+    bool is_enabled() const override { return true; }
+    const char* get_description() const override { return "Value"; }
+    void enable_recording(std::function<void(const librealsense::option&)>) override {}
+
+private:
+    float& _value;
+};
+
+TEST_CASE("Frame extension flags follow the frame types", "[frame]")
+{
+    librealsense::frame base;
+    librealsense::video_frame video;
+    librealsense::depth_frame depth;
+    librealsense::disparity_frame disparity;
+    librealsense::composite_frame composite;
+    librealsense::points points;
+    librealsense::motion_frame motion;
+    librealsense::pose_frame pose;
+
+    std::vector<librealsense::frame_interface*> frames = { &base, &video, &depth, &disparity, &composite, &points, &motion, &pose };
+    for (auto f : frames)
+    {
+        REQUIRE((librealsense::frame_cast<librealsense::video_frame>(f) != nullptr) == (dynamic_cast<librealsense::video_frame*>(f) != nullptr));
+        REQUIRE((librealsense::frame_cast<librealsense::depth_frame>(f) != nullptr) == (dynamic_cast<librealsense::depth_frame*>(f) != nullptr));
+        REQUIRE((librealsense::frame_cast<librealsense::disparity_frame>(f) != nullptr) == (dynamic_cast<librealsense::disparity_frame*>(f) != nullptr));
+        REQUIRE((librealsense::frame_cast<librealsense::composite_frame>(f) != nullptr) == (dynamic_cast<librealsense::composite_frame*>(f) != nullptr));
+        REQUIRE((librealsense::frame_cast<librealsense::points>(f) != nullptr) == (dynamic_cast<librealsense::points*>(f) != nullptr));
+        REQUIRE((librealsense::frame_cast<librealsense::motion_frame>(f) != nullptr) == (dynamic_cast<librealsense::motion_frame*>(f) != nullptr));
+        REQUIRE((librealsense::frame_cast<librealsense::pose_frame>(f) != nullptr) == (dynamic_cast<librealsense::pose_frame*>(f) != nullptr));
+        REQUIRE_FALSE(f->is_extendable_to(RS2_EXTENSION_DEBUG));
+    }
+    REQUIRE(librealsense::frame_cast<librealsense::depth_frame>(&disparity) == &disparity);
+
+    // The flags belong to the frame type, moving the content of a frame doesn't carry them
+    video = std::move(depth);
+    REQUIRE_FALSE(video.is_extendable_to(RS2_EXTENSION_DEPTH_FRAME));
+    REQUIRE(depth.is_extendable_to(RS2_EXTENSION_DEPTH_FRAME));
+}
+
+// Hidden benchmark, run with [frame-cast]: prints the time of an extension check through dynamic_cast and through the frame flags
+TEST_CASE("Frame extension checks against dynamic_cast", "[frame-cast][.]")
+{
+    typedef std::chrono::high_resolution_clock clock;
+    librealsense::depth_frame depth;
+    librealsense::composite_frame composite;
+    std::vector<librealsense::frame_interface*> frames = { &depth, &composite };
+
+    // Each processing block of a chain checks each frame a few times, so a million checks are a few seconds at 1000 frames per second
+    const int checks = 1000000;
+    size_t hits = 0;
+    auto start = clock::now();
+    for (int i = 0; i < checks; ++i)
+        hits += dynamic_cast<librealsense::disparity_frame*>(frames[i & 1]) != nullptr;
+    auto dynamic_ms = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+
+    start = clock::now();
+    for (int i = 0; i < checks; ++i)
+        hits += librealsense::frame_cast<librealsense::disparity_frame>(frames[i & 1]) != nullptr;
+    auto flags_ms = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+
+    REQUIRE(hits == 0);
+    std::cout << checks << " extension checks: " << dynamic_ms << " ms through dynamic_cast, " << flags_ms << " ms through the frame flags" << std::endl;
+}
+
+TEST_CASE("Frames beyond the queue size fit in the overflow memory limit", "[frame]")
+{
+    librealsense::frame_source source(2);
+    source.init(std::make_shared<librealsense::metadata_parser_map>());
+    auto dropped = source.get_dropped_frames_option();
+    auto limit = source.get_overflow_limit_option();
+
+    const size_t size = 400 * 1024;
+    std::vector<librealsense::frame_holder> held;
+    auto alloc = [&]() {
+        librealsense::frame_holder f(source.alloc_frame(RS2_EXTENSION_VIDEO_FRAME, size, librealsense::frame_additional_data(), true));
+        auto ok = f.frame != nullptr;
+        if (ok) held.push_back(std::move(f));
+        return ok;
+    };
+
+    REQUIRE(alloc());
+    REQUIRE(alloc());
+    REQUIRE_FALSE(alloc());
+    REQUIRE(dropped->query() == 1);
+
+    // Two more frames of 400KB fit in 1MB, the third doesn't
+    limit->set(1);
+    REQUIRE(alloc());
+    REQUIRE(alloc());
+    REQUIRE_FALSE(alloc());
+    REQUIRE(dropped->query() == 2);
+
+    // Releasing a frame beyond the queue size makes room for another one
+    held.pop_back();
+    REQUIRE(alloc());
+    REQUIRE(dropped->query() == 2);
+
+    held.clear();
+    source.flush();
+}
+
+TEST_CASE("Framesets give their references away once nobody else observes them", "[frame]")
+{
+    librealsense::frame_source source(8);
+    source.init(std::make_shared<librealsense::metadata_parser_map>());
+    librealsense::synthetic_source synthetic(source);
+
+    auto make_set = [&]() {
+        librealsense::composite_frame_builder frames;
+        for (int i = 0; i < 2; ++i)
+            frames.push_back(librealsense::frame_holder(source.alloc_frame(RS2_EXTENSION_VIDEO_FRAME, 16, librealsense::frame_additional_data(), true)));
+        return librealsense::frame_holder(synthetic.allocate_composite_frame(frames));
+    };
+
+    // A set shared with another holder adds a reference to the frames taken out of it
+    {
+        auto set = make_set();
+        auto shared = set.clone();
+        auto composite = dynamic_cast<librealsense::composite_frame*>(set.frame);
+        REQUIRE(composite);
+        auto first = composite->take_frame(0);
+        REQUIRE(first.frame == composite->get_frame(0));
+        REQUIRE_FALSE(first->is_uniquely_owned());
+    }
+
+    // A set only the caller holds hands its frames over, and doesn't release them again
+    {
+        auto set = make_set();
+        auto composite = dynamic_cast<librealsense::composite_frame*>(set.frame);
+        std::vector<librealsense::frame_holder> taken;
+        for (int i = 0; i < 2; ++i)
+            taken.push_back(composite->take_frame(i));
+        REQUIRE(composite->get_frame(0) == nullptr);
+        set = librealsense::frame_holder();
+        for (auto&& f : taken)
+        {
+            REQUIRE(f->is_uniquely_owned());
+            REQUIRE(f->get_frame_data());
+        }
+    }
+
+    source.flush();
+}
+
+TEST_CASE("NUMA frame allocator recycles its buffers", "[concurrency]")
+{
+    // The placement itself depends on the machine, the buffers are usable and reused either way
+    auto node = get_numa_node("/sys/devices/system/cpu");
+    REQUIRE(node >= -1);
+    REQUIRE(get_numa_node("/no/such/device") == -1);
+    REQUIRE(get_numa_node_cpus(-1).empty());
+
+    std::unique_ptr<numa_frame_allocator, void(*)(rs2_frame_allocator*)> allocator(
+        new numa_frame_allocator(node < 0 ? 0 : node, true), [](rs2_frame_allocator* p) { p->release(); });
+
+    for (auto size : { size_t(640 * 480 * 2), size_t(1920 * 1080 * 2) })
+    {
+        auto buffer = static_cast<uint8_t*>(allocator->allocate(size));
+        REQUIRE(buffer);
+        std::fill(buffer, buffer + size, uint8_t(0xab));
+        REQUIRE(buffer[size - 1] == 0xab);
+        allocator->deallocate(buffer, size);
+
+        // Any request rounding to the same pages gets the buffer back
+        auto reused = allocator->allocate(size - 1);
+        REQUIRE(reused == buffer);
+        auto other = allocator->allocate(size);
+        REQUIRE(other);
+        REQUIRE(other != buffer);
+        allocator->deallocate(reused, size - 1);
+        allocator->deallocate(other, size);
+    }
+}
+
+TEST_CASE("Memory budget trims pooled buffers before it refuses", "[memory]")
+{
+    // Frames of other tests may still be alive, the budget is set relative to them once their pools are freed
+    auto& budget = memory_budget::instance();
+    budget.set_limit(1);
+    budget.set_limit(0);
+    auto global = memory_account::global();
+    auto base = global->get_usage();
+
+    auto ctx = std::make_shared<memory_account>();
+    auto sensor = std::make_shared<memory_account>(ctx);
+    sensor->update(1000, 0);
+    sensor->update(-400, 400);
+    REQUIRE(sensor->get_usage().in_use == 600);
+    REQUIRE(sensor->get_usage().pooled == 400);
+    REQUIRE(ctx->get_usage().in_use == 600);
+    REQUIRE(global->get_usage().in_use == base.in_use + 600);
+
+    struct pool : memory_trimmer
+    {
+        std::shared_ptr<memory_account> account;
+        size_t bytes = 400;
+        size_t trim() override
+        {
+            auto freed = bytes;
+            account->update(0, -static_cast<int64_t>(freed));
+            bytes = 0;
+            return freed;
+        }
+    } pooled;
+    pooled.account = sensor;
+
+    budget.add(&pooled);
+    budget.set_limit(base.in_use + base.pooled + 1200);
+    REQUIRE(budget.reserve(200));
+    REQUIRE(pooled.bytes == 400);
+
+    // The pooled buffers make room for the new one, the frames alive don't
+    REQUIRE(budget.reserve(500));
+    REQUIRE(pooled.bytes == 0);
+    REQUIRE(sensor->get_usage().pooled == 0);
+    REQUIRE_FALSE(budget.reserve(700));
+    sensor->drop();
+    REQUIRE(ctx->get_usage().dropped == 1);
+
+    budget.set_limit(0);
+    REQUIRE(budget.reserve(1ull << 40));
+    budget.remove(&pooled);
+    sensor->update(-600, 0);
+    REQUIRE(global->get_usage().in_use == base.in_use);
+}
+
+TEST_CASE("Device cache keeps tables and profiles until the device changes", "[device-cache]")
+{
+    auto& cache = device_cache::instance();
+    auto directory = cache.get_directory();
+    cache.set_directory(".");
+    const std::string file = "./unit-test-0001-5.11.6.250.json";
+    std::remove(file.c_str());
+
+    int fetches = 0;
+    const std::vector<uint8_t> table{ 1, 2, 3, 4 };
+    const std::vector<platform::stream_profile> profiles{ { 640, 480, 30, 0x5a313620 }, { 1280, 720, 15, 0x59382020 } };
+    auto fetch_table = [&]() { ++fetches; return table; };
+    auto fetch_profiles = [&]() { ++fetches; return profiles; };
+
+    {
+        auto entry = cache.open("unit-test-0001", "5.11.6.250", { 7, 7, 7 });
+        REQUIRE(entry);
+        REQUIRE(entry->get_table(25, fetch_table) == table);
+        REQUIRE(entry->get_profiles("Stereo Module", fetch_profiles).size() == 2);
+        REQUIRE(entry->get_table(25, fetch_table) == table);
+        REQUIRE(fetches == 2);
+    }
+
+    // A later process reads both from the file
+    {
+        auto entry = cache.open("unit-test-0001", "5.11.6.250", { 7, 7, 7 });
+        REQUIRE(entry->get_table(25, fetch_table) == table);
+        auto cached = entry->get_profiles("Stereo Module", fetch_profiles);
+        REQUIRE(cached.size() == 2);
+        REQUIRE(cached[1] == profiles[1]);
+        REQUIRE(fetches == 2);
+
+        // Tables that fail validation are fetched again
+        REQUIRE(entry->get_table(25, fetch_table, [](const std::vector<uint8_t>&) { return false; }) == table);
+        REQUIRE(fetches == 3);
+
+        // Tables the device may have written are fetched again, also by a later process, the profiles are kept
+        entry->invalidate_tables();
+        REQUIRE(entry->get_profiles("Stereo Module", fetch_profiles).size() == 2);
+        REQUIRE(fetches == 3);
+        REQUIRE(entry->get_table(25, fetch_table) == table);
+        REQUIRE(fetches == 4);
+        entry->invalidate_tables();
+    }
+    {
+        auto entry = cache.open("unit-test-0001", "5.11.6.250", { 7, 7, 7 });
+        REQUIRE(entry->get_table(25, fetch_table) == table);
+        REQUIRE(fetches == 5);
+    }
+
+    // The device reports something else, the entry starts over
+    {
+        auto entry = cache.open("unit-test-0001", "5.11.6.250", { 7, 7, 8 });
+        REQUIRE(entry->get_table(25, fetch_table) == table);
+        REQUIRE(fetches == 6);
+    }
+
+    cache.set_directory("");
+    REQUIRE_FALSE(cache.open("unit-test-0001", "5.11.6.250", { 7, 7, 8 }));
+    cache.set_directory(directory);
+    std::remove(file.c_str());
+}
+
+TEST_CASE("Thread scheduling is loaded from JSON", "[concurrency]")
+{
+    auto& scheduling = librealsense::thread_scheduling::instance();
+    auto capture = scheduling.get(RS2_THREAD_CATEGORY_CAPTURE);
+    auto playback = scheduling.get(RS2_THREAD_CATEGORY_PLAYBACK);
+
+    scheduling.load(R"({"capture": {"cpus": [1, 3], "priority": 80}, "playback": {"cpus": [0]}})");
+    REQUIRE(scheduling.get(RS2_THREAD_CATEGORY_CAPTURE).cpus == std::vector<int>({ 1, 3 }));
+    REQUIRE(scheduling.get(RS2_THREAD_CATEGORY_CAPTURE).priority == 80);
+    REQUIRE(scheduling.get(RS2_THREAD_CATEGORY_PLAYBACK).cpus == std::vector<int>({ 0 }));
+    REQUIRE(scheduling.get(RS2_THREAD_CATEGORY_PLAYBACK).priority == 0);
+
+    // A single invalid entry rejects the whole configuration
+    REQUIRE_THROWS_AS(scheduling.load(R"({"hid": {"priority": 20}, "capture": {"priority": 120}})"), librealsense::invalid_value_exception);
+    REQUIRE_THROWS_AS(scheduling.load(R"({"render": {"priority": 20}})"), librealsense::invalid_value_exception);
+    REQUIRE_THROWS_AS(scheduling.load("[1, 2]"), librealsense::invalid_value_exception);
+    REQUIRE(scheduling.get(RS2_THREAD_CATEGORY_HID).priority == 0);
+    REQUIRE(scheduling.get(RS2_THREAD_CATEGORY_CAPTURE).priority == 80);
+
+    scheduling.configure(RS2_THREAD_CATEGORY_CAPTURE, capture);
+    scheduling.configure(RS2_THREAD_CATEGORY_PLAYBACK, playback);
+}
+
+TEST_CASE("Cached options notify their observers on change", "[options]")
+{
+    float value = 1.f;
+    librealsense::options_container options;
+    options.register_option(RS2_OPTION_GAIN, std::make_shared<value_option>(value));
+
+    std::vector<float> notified;
+    options.add_option_observer(RS2_OPTION_GAIN, [&](float val) { notified.push_back(val); });
+    options.enable_option_cache(RS2_OPTION_GAIN, true);
+
+    REQUIRE(options.get_option(RS2_OPTION_GAIN).query() == 1.f);
+
+    // Reads are served from the cache until the option is set through the container
+    value = 5.f;
+    REQUIRE(options.get_option(RS2_OPTION_GAIN).query() == 1.f);
+    options.get_option(RS2_OPTION_GAIN).set(3.f);
+    REQUIRE(value == 3.f);
+    REQUIRE(options.get_option(RS2_OPTION_GAIN).query() == 3.f);
+    options.get_option(RS2_OPTION_GAIN).set(3.f);
+
+    REQUIRE(notified == std::vector<float>({ 1.f, 3.f }));
+
+    options.enable_option_cache(RS2_OPTION_GAIN, false);
+    value = 7.f;
+    REQUIRE(options.get_option(RS2_OPTION_GAIN).query() == 7.f);
+}
+
+TEST_CASE("Occlusion z-buffer keeps the nearest point of every texel", "[occlusion]")
+{
+    rs2_intrinsics depth_intrin{ 64, 64 }, texel_intrin{ 32, 32 };
+    occlusion_filter filter;
+    filter.set_mode(occlusion_exhaustic_search);
+    filter.set_depth_intrinsics(depth_intrin);
+    filter.set_texel_intrinsics(texel_intrin);
+
+    // Every 2x2 block of depth pixels lands on one texel, the nearest of each block sits at a varying position
+    const size_t count = 64 * 64;
+    std::vector<float3> points(count);
+    std::vector<float2> pixels(count), uv(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        size_t x = i % 64, y = i / 64;
+        auto nearest = ((x / 2 + y / 2) % 4) == ((x % 2) + 2 * (y % 2));
+        points[i] = { 0.f, 0.f, nearest ? 1.f : 2.f };
+        pixels[i] = { x / 2 + 0.5f, y / 2 + 0.5f };
+        uv[i] = { 0.5f, 0.5f };
+    }
+
+    for (unsigned threads : { 1u, 4u })
+    {
+        parallel_executor executor(threads);
+        auto result = uv;
+        filter.process(points.data(), result.data(), pixels, executor);
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (points[i].z == 1.f)
+                REQUIRE(result[i].x == 0.5f);
+            else
+                REQUIRE(result[i].x == 0.f);
+        }
+    }
+}
+
+TEST_CASE("Occlusion scratch buffers stop allocating in steady state", "[occlusion]")
+{
+    rs2_intrinsics depth_intrin{ 64, 64 }, large_texels{ 32, 32 }, small_texels{ 16, 16 };
+    occlusion_filter filter;
+    filter.set_mode(occlusion_exhaustic_search);
+    filter.set_depth_intrinsics(depth_intrin);
+
+    const size_t count = 64 * 64;
+    std::vector<float3> points(count, float3{ 0.f, 0.f, 1.f });
+    std::vector<float2> pixels(count, float2{ 1.5f, 1.5f }), uv(count);
+    parallel_executor executor(4);
+
+    // The z-buffer grows to the largest texture once, switching to a smaller one afterwards reuses it
+    filter.set_texel_intrinsics(large_texels);
+    filter.process(points.data(), uv.data(), pixels, executor);
+    auto allocations = scratch_allocations().load();
+    for (int i = 0; i < 10; ++i)
+    {
+        filter.set_texel_intrinsics(i % 2 ? large_texels : small_texels);
+        filter.process(points.data(), uv.data(), pixels, executor);
+    }
+    REQUIRE(scratch_allocations().load() == allocations);
+
+    scratch_buffer<int> buffer;
+    auto data = buffer.get(100);
+    REQUIRE(buffer.get(50) == data);
+    REQUIRE(buffer.capacity() == 100);
+    REQUIRE(scratch_allocations().load() == allocations + 1);
+}
+
+TEST_CASE("RVL depth codec is lossless", "[rvl]")
+{
+    // Depth-like content: smooth surfaces separated by holes, plus a row of extreme deltas
+    const int width = 640, height = 480;
+    std::vector<uint16_t> depth(width * height);
+    std::srand(7);
+    for (int y = 0; y < height; ++y)
+        for (int x = 0; x < width; ++x)
+        {
+            auto& d = depth[y * width + x];
+            if ((x / 40 + y / 30) % 5 == 0)
+                d = 0;
+            else if (y == 100)
+                d = (x % 2) ? 0xFFFF : 1;
+            else
+                d = static_cast<uint16_t>(1000 + x + y / 2 + std::rand() % 3);
+        }
+
+    std::vector<uint8_t> encoded;
+    rvl_encode(depth.data(), depth.size(), encoded);
+    REQUIRE(encoded.size() <= rvl_max_encoded_size(depth.size()));
+    REQUIRE(encoded.size() * 3 < depth.size() * sizeof(uint16_t));
+
+    std::vector<uint16_t> decoded(depth.size(), 1);
+    REQUIRE(rvl_decode(encoded.data(), encoded.size(), decoded.data(), decoded.size()));
+    REQUIRE(decoded == depth);
+
+    // Truncated input and mismatching sizes are reported rather than decoded
+    REQUIRE_FALSE(rvl_decode(encoded.data(), encoded.size() / 2, decoded.data(), decoded.size()));
+    REQUIRE_FALSE(rvl_decode(encoded.data(), encoded.size(), decoded.data(), decoded.size() * 2));
+
+    // Empty and all-zero images
+    std::vector<uint16_t> zeros(1000, 0);
+    rvl_encode(zeros.data(), zeros.size(), encoded);
+    REQUIRE(encoded.size() == sizeof(uint32_t));
+    REQUIRE(rvl_decode(encoded.data(), encoded.size(), decoded.data(), zeros.size()));
+    REQUIRE(std::equal(zeros.begin(), zeros.end(), decoded.begin()));
+    rvl_encode(nullptr, 0, encoded);
+    REQUIRE(encoded.empty());
+}
+
+TEST_CASE("Latency histogram percentiles", "[tracing]")
+{
+    // Bucket boundaries stay within the relative precision of the histogram
+    for (uint64_t us : { 0ull, 31ull, 32ull, 33ull, 1000ull, 65535ull, 1ull << 27, (1ull << 28) - 1 })
+    {
+        auto middle = latency_histogram::bucket_middle(latency_histogram::bucket_of(us));
+        REQUIRE(std::abs(middle - us) <= 0.5 + us / 64.);
+    }
+    REQUIRE(latency_histogram::bucket_of(1ull << 40) == latency_histogram::bucket_count - 1);
+
+    latency_histogram h;
+    REQUIRE(h.get_stats().frames == 0);
+
+    // 1ms to 100ms in steps of 0.1ms
+    for (int i = 10; i <= 1000; i++)
+        h.record(i / 10.);
+    auto stats = h.get_stats();
+    REQUIRE(stats.frames == 991);
+    REQUIRE(stats.average_latency_ms == Approx(50.5).epsilon(0.001));
+    REQUIRE(stats.p50_latency_ms == Approx(50.5).epsilon(0.03));
+    REQUIRE(stats.p90_latency_ms == Approx(90.1).epsilon(0.03));
+    REQUIRE(stats.p99_latency_ms == Approx(99.1).epsilon(0.03));
+    REQUIRE(stats.max_latency_ms == Approx(100.f));
+    REQUIRE(stats.p99_latency_ms <= stats.max_latency_ms);
+
+    h.reset();
+    REQUIRE(h.get_stats().frames == 0);
+}
+
+#ifdef RS2_USE_CUDA
+// Hidden benchmark, run with [cuda]: checks the CUDA paths against the host arithmetic and prints the time per frame of both
+TEST_CASE("CUDA unpack and deprojection against the host paths", "[cuda][.]")
+{
+    typedef std::chrono::high_resolution_clock clock;
+    auto ms_per_frame = [](std::function<void()> run) {
+        const int frames = 30;
+        run(); // Allocates the staging buffers
+        auto start = clock::now();
+        for (int i = 0; i < frames; ++i) run();
+        return std::chrono::duration<double, std::milli>(clock::now() - start).count() / frames;
+    };
+
+    std::srand(11);
+    const std::vector<std::pair<int, int>> sizes = { { 424, 240 }, { 640, 480 }, { 848, 480 }, { 1280, 720 }, { 1920, 1080 } };
+    for (auto&& size : sizes)
+    {
+        auto w = size.first, h = size.second, n = w * h;
+        CAPTURE(w);
+        CAPTURE(h);
+
+        std::vector<byte> yuy2(n * 2);
+        for (auto&& b : yuy2) b = static_cast<byte>(std::rand());
+        std::vector<byte> rgb, expected(n * 3);
+
+        auto cuda_unpack = ms_per_frame([&]() { rgb = unpack_with(pf_yuy2, RS2_FORMAT_RGB8, yuy2, w, h, n * 3); });
+        auto host_unpack = ms_per_frame([&]() {
+            for (int i = 0; i < n; ++i)
+            {
+                auto pair = yuy2.data() + (i / 2) * 4;
+                yuv_to_rgb_reference(pair[(i % 2) * 2], pair[1], pair[3], expected.data() + i * 3);
+            }
+        });
+        REQUIRE(rgb == expected);
+
+        rs2_intrinsics intrin = { w, h, w / 2.f, h / 2.f, w * 0.9f, w * 0.9f, RS2_DISTORTION_NONE, { 0, 0, 0, 0, 0 } };
+        std::vector<uint16_t> depth(n);
+        for (auto&& d : depth) d = static_cast<uint16_t>(std::rand() % 8000);
+        std::vector<float> points(n * 3), host_points(n * 3);
+
+        auto cuda_points = ms_per_frame([&]() { rscuda::deproject_depth_cuda(points.data(), intrin, depth.data(), 0.001f); });
+        auto host_deproject = ms_per_frame([&]() {
+            for (int i = 0; i < n; ++i)
+            {
+                const float pixel[] = { float(i % w), float(i / w) };
+                rs2_deproject_pixel_to_point(host_points.data() + i * 3, &intrin, pixel, 0.001f * depth[i]);
+            }
+        });
+        for (int i = 0; i < n * 3; ++i)
+            REQUIRE(std::abs(points[i] - host_points[i]) <= 1e-5f + 1e-5f * std::abs(host_points[i]));
+
+        std::cout << w << "x" << h << ": YUY2 to RGB8 " << cuda_unpack << " ms on CUDA, " << host_unpack << " ms on the host; "
+            << "deprojection " << cuda_points << " ms on CUDA, " << host_deproject << " ms on the host" << std::endl;
+    }
+}
+#endif // RS2_USE_CUDA
+
+TEST_CASE("USB bandwidth is shared by the devices behind a root port", "[usb-bandwidth]")
+{
+    REQUIRE(get_usb_root_port("/sys/devices/pci0000:00/0000:00:14.0/usb2/2-3/2-3.1/2-3.1:1.0/video4linux/video0") == "2-3");
+    REQUIRE(get_usb_root_port("/sys/devices/pci0000:00/0000:00:14.0/usb2/2-4/2-4:1.0/video4linux/video2") == "2-4");
+    REQUIRE(get_usb_root_port("\\\\?\\usb#vid_8086&pid_0b07&mi_00#6&2b3e5d1d&0&0000#{e5323777-f976-4f5b-9b55-b94699c46e44}").empty());
+
+    REQUIRE(get_usb_link_capacity(platform::usb3_2_type) > get_usb_link_capacity(platform::usb2_1_type));
+    REQUIRE(get_usb_link_capacity(platform::usb_undefined) == 0);
+
+    auto&& planner = usb_bandwidth_planner::instance();
+    int first, second, other;
+    planner.reserve(&first, "unit-test-1", 100);
+    planner.reserve(&second, "unit-test-1", 50);
+    planner.reserve(&other, "unit-test-2", 400);
+    REQUIRE(planner.get_reserved("unit-test-1") == 150);
+    REQUIRE(planner.get_reserved("unit-test-1", { &first }) == 50);
+
+    // Reopening replaces what was reserved
+    planner.reserve(&second, "unit-test-1", 20);
+    REQUIRE(planner.get_reserved("unit-test-1") == 120);
+
+    planner.release(&first);
+    planner.release(&second);
+    planner.release(&other);
+    REQUIRE(planner.get_reserved("unit-test-1") == 0);
+    REQUIRE(planner.get_reserved("unit-test-2") == 0);
+
+    // A device without a known port shares its link with nobody
+    REQUIRE(planner.get_reserved("") == 0);
+}
+
+TEST_CASE("Frames dropped are counted by stream and reason", "[concurrency]")
+{
+    // Queues tell which items they drop for newer ones
+    std::vector<int> dropped;
+    single_consumer_queue<int> queue(2);
+    queue.set_on_drop([&](int& i) { dropped.push_back(i); });
+    lock_free_queue<int> lock_free(2);
+    lock_free.set_on_drop([&](int& i) { dropped.push_back(i); });
+    for (int i = 0; i < 4; ++i)
+    {
+        queue.enqueue(int(i));
+        lock_free.enqueue(int(i + 10));
+    }
+    REQUIRE(dropped == std::vector<int>({ 0, 10, 1, 11 }));
+
+    const int stream = -1234; // not the id of a real stream
+    auto&& statistics = stream_statistics::instance();
+    statistics.reset(stream);
+    REQUIRE(statistics.get(stream).delivered == 0);
+
+    for (int i = 0; i < 5; ++i)
+        statistics.delivered(stream);
+    statistics.dropped(stream, RS2_FRAME_DROP_REASON_CAPTURE, 2);
+    statistics.dropped(stream, RS2_FRAME_DROP_REASON_DEVICE);
+    statistics.dropped(stream, RS2_FRAME_DROP_REASON_QUEUE, 0);
+
+    auto counters = statistics.get(stream);
+    REQUIRE(counters.delivered == 5);
+    REQUIRE(counters.dropped[RS2_FRAME_DROP_REASON_CAPTURE] == 2);
+    REQUIRE(counters.dropped[RS2_FRAME_DROP_REASON_DEVICE] == 1);
+    REQUIRE(counters.dropped[RS2_FRAME_DROP_REASON_QUEUE] == 0);
+    REQUIRE(statistics.get(stream + 1).delivered == 0);
+
+    statistics.reset(stream);
+    counters = statistics.get(stream);
+    REQUIRE(counters.delivered == 0);
+    REQUIRE(counters.dropped[RS2_FRAME_DROP_REASON_CAPTURE] == 0);
+}
+
+TEST_CASE("Contexts share one device watcher", "[context]")
+{
+    struct fake_watcher : platform::device_watcher
+    {
+        void start(platform::device_changed_callback callback) override { ++starts; this->callback = callback; }
+        void stop() override { ++stops; callback = nullptr; }
+
+        int starts = 0, stops = 0;
+        platform::device_changed_callback callback;
+    };
+
+    auto watcher = std::make_shared<fake_watcher>();
+    auto hub = std::make_shared<device_watcher_hub>(watcher);
+
+    int first_events = 0, second_events = 0;
+    auto first = hub->create_watcher();
+    auto second = hub->create_watcher();
+    first->start([&](platform::backend_device_group, platform::backend_device_group) { ++first_events; });
+    second->start([&](platform::backend_device_group, platform::backend_device_group) { ++second_events; });
+    REQUIRE(watcher->starts == 1);
+
+    watcher->callback({}, {});
+    REQUIRE(first_events == 1);
+    REQUIRE(second_events == 1);
+
+    // Restarting a client keeps the platform watcher running
+    first->start([&](platform::backend_device_group, platform::backend_device_group) { first_events += 10; });
+    watcher->callback({}, {});
+    REQUIRE(first_events == 11);
+    REQUIRE(second_events == 2);
+    REQUIRE(watcher->starts == 1);
+    REQUIRE(watcher->stops == 0);
+
+    first->stop();
+    watcher->callback({}, {});
+    REQUIRE(first_events == 11);
+    REQUIRE(second_events == 3);
+
+    second.reset();
+    REQUIRE(watcher->stops == 1);
+    REQUIRE(!watcher->callback);
+
+    // A subscriber may leave from its own callback
+    auto third = hub->create_watcher();
+    int third_events = 0;
+    third->start([&](platform::backend_device_group, platform::backend_device_group) { ++third_events; third->stop(); });
+    auto callback = watcher->callback; // Reset by the platform watcher stopping
+    callback({}, {});
+    REQUIRE(third_events == 1);
+    REQUIRE(watcher->stops == 2);
+}
@@ -5008,6 +5008,48 @@ TEST_CASE("software-device motion stream", "[software-device]")
 
 }
 
+TEST_CASE("software-device options snapshot", "[software-device]")
+{
+    rs2::software_device dev;
+
+    auto sensor = dev.add_sensor("Synthetic");
+    sensor.add_read_only_option(RS2_OPTION_ASIC_TEMPERATURE, 40.f);
+    sensor.add_read_only_option(RS2_OPTION_DEPTH_UNITS, 0.001f);
+
+    auto snapshot = sensor.get_options_snapshot();
+    REQUIRE(snapshot.size() == 2);
+    // Ordered by option id
+    REQUIRE(snapshot[0].id == RS2_OPTION_ASIC_TEMPERATURE);
+    REQUIRE(snapshot[1].id == RS2_OPTION_DEPTH_UNITS);
+    for (auto&& value : snapshot)
+    {
+        REQUIRE(value.has_value);
+        REQUIRE(value.is_read_only);
+        REQUIRE(value.value == sensor.get_option(value.id));
+    }
+}
+
+TEST_CASE("software-device asynchronous option writes", "[software-device]")
+{
+    rs2::software_device dev;
+
+    auto sensor = dev.add_sensor("Synthetic");
+    sensor.add_read_only_option(RS2_OPTION_DEPTH_UNITS, 0.001f);
+
+    // Every write completes, coalesced or not, with the outcome of the write that sent its value
+    std::vector<std::future<void>> writes;
+    for (int i = 0; i < 5; ++i)
+        writes.push_back(sensor.set_option_async(RS2_OPTION_DEPTH_UNITS, 0.001f * (i + 1)));
+    for (auto&& write : writes)
+    {
+        REQUIRE(write.wait_for(std::chrono::seconds(5)) == std::future_status::ready);
+        REQUIRE_THROWS_AS(write.get(), rs2::error);
+    }
+    REQUIRE(sensor.get_option(RS2_OPTION_DEPTH_UNITS) == 0.001f);
+
+    REQUIRE_THROWS_AS(sensor.set_option_async(RS2_OPTION_EXPOSURE, 1.f), rs2::error);
+}
+
 TEST_CASE("Record software-device", "[software-device][record]")
 {
     const int W = 640;
@@ -5100,3 +5142,168 @@ TEST_CASE("Record software-device", "[software-device][record]")
         pose_frame.timestamp == recorded_pose.get_timestamp()));
 }
 
+
+TEST_CASE("Record software-device in the native format", "[software-device][record]")
+{
+    const int W = 640;
+    const int H = 480;
+    const int BPP = 2;
+
+    std::string folder_name = get_folder_path(special_folder::temp_folder);
+    const std::string filename = folder_name + "recording.rsn";
+
+    rs2::software_device dev;
+
+    auto sensor = dev.add_sensor("Synthetic");
+    rs2_intrinsics depth_intrinsics = { W, H, (float)W / 2, H / 2, (float)W, (float)H,
+        RS2_DISTORTION_BROWN_CONRADY ,{ 0,0,0,0,0 } };
+    rs2_video_stream video_stream = { RS2_STREAM_DEPTH, 0, 0, W, H, 60, BPP, RS2_FORMAT_Z16, depth_intrinsics };
+    auto depth_stream_profile = sensor.add_video_stream(video_stream);
+
+    rs2_motion_device_intrinsic motion_intrinsics = { { 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1 },{ 2, 2, 2 },{ 3, 3 ,3 } };
+    rs2_motion_stream motion_stream = { RS2_STREAM_ACCEL, 0, 1, 200, RS2_FORMAT_MOTION_RAW, motion_intrinsics };
+    auto motion_stream_profile = sensor.add_motion_stream(motion_stream);
+
+    rs2_pose_stream pose_stream = { RS2_STREAM_POSE, 0, 2, 200, RS2_FORMAT_6DOF };
+    auto pose_stream_profile = sensor.add_pose_stream(pose_stream);
+
+    rs2::syncer sync;
+    std::vector<stream_profile> stream_profiles;
+    stream_profiles.push_back(depth_stream_profile);
+    stream_profiles.push_back(motion_stream_profile);
+    stream_profiles.push_back(pose_stream_profile);
+
+    std::vector<uint8_t> pixels(W * H * BPP, 100);
+    rs2_software_video_frame video_frame = { pixels.data(), [](void*) {},W*BPP, BPP, 10000, RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, 0, depth_stream_profile };
+    float motion_data[3] = { 1, 1, 1 };
+    rs2_software_motion_frame motion_frame = { motion_data, [](void*) {}, 20000, RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, 0, motion_stream_profile };
+    rs2_software_pose_frame::pose_frame_info pose_info = { { 1, 1, 1 },{ 2, 2, 2 },{ 3, 3, 3 },{ 4, 4 ,4 ,4 },{ 5, 5, 5 },{ 6, 6 ,6 }, 0, 0 };
+    rs2_software_pose_frame pose_frame = { &pose_info, [](void*) {}, 30000, RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK , 0, pose_stream_profile };
+
+    //Record software device, the depth frame is compressed
+    {
+        recorder recorder(filename, dev, true);
+        sensor.open(stream_profiles);
+        sensor.start(sync);
+        sensor.on_video_frame(video_frame);
+        sensor.on_motion_frame(motion_frame);
+        sensor.on_pose_frame(pose_frame);
+    }
+
+    rs2::context ctx;
+
+    if (!make_context(SECTION_FROM_TEST_NAME, &ctx))
+        return;
+    auto player_dev = ctx.load_device(filename);
+    player_dev.set_real_time(false);
+    syncer player_sync;
+    auto s = player_dev.query_sensors()[0];
+    REQUIRE(s.get_stream_profiles().size() == 3);
+    REQUIRE_NOTHROW(s.open(s.get_stream_profiles()));
+    REQUIRE_NOTHROW(s.start(player_sync));
+    rs2::frameset fset;
+    rs2::frame recorded_depth, recorded_accel, recorded_pose;
+    while (player_sync.try_wait_for_frames(&fset))
+    {
+        if (fset.first_or_default(RS2_STREAM_DEPTH))
+            recorded_depth = fset.first_or_default(RS2_STREAM_DEPTH);
+        if (fset.first_or_default(RS2_STREAM_ACCEL))
+            recorded_accel = fset.first_or_default(RS2_STREAM_ACCEL);
+        if (fset.first_or_default(RS2_STREAM_POSE))
+            recorded_pose = fset.first_or_default(RS2_STREAM_POSE);
+    }
+
+    REQUIRE(recorded_depth);
+    REQUIRE(recorded_accel);
+    REQUIRE(recorded_pose);
+
+    REQUIRE(((memcmp(video_frame.pixels, recorded_depth.get_data(), W * H * BPP) == 0) &&
+        video_frame.frame_number == recorded_depth.get_frame_number() &&
+        video_frame.domain == recorded_depth.get_frame_timestamp_domain() &&
+        video_frame.timestamp == recorded_depth.get_timestamp()));
+
+    REQUIRE(((memcmp(motion_frame.data, recorded_accel.get_data(), sizeof(float) * 3) == 0) &&
+        motion_frame.frame_number == recorded_accel.get_frame_number() &&
+        motion_frame.domain == recorded_accel.get_frame_timestamp_domain() &&
+        motion_frame.timestamp == recorded_accel.get_timestamp()));
+
+    REQUIRE(((memcmp(pose_frame.data, recorded_pose.get_data(), sizeof(rs2_software_pose_frame::pose_frame_info)) == 0) &&
+        pose_frame.frame_number == recorded_pose.get_frame_number() &&
+        pose_frame.domain == recorded_pose.get_frame_timestamp_domain() &&
+        pose_frame.timestamp == recorded_pose.get_timestamp()));
+}
+
+TEST_CASE("Record software-device in segments", "[software-device][record]")
+{
+    const int W = 640;
+    const int H = 480;
+    const int BPP = 2;
+
+    std::string folder_name = get_folder_path(special_folder::temp_folder);
+    const std::string filename = folder_name + "segments.bag";
+
+    rs2::software_device dev;
+
+    auto sensor = dev.add_sensor("Synthetic");
+    rs2_intrinsics depth_intrinsics = { W, H, (float)W / 2, H / 2, (float)W, (float)H,
+        RS2_DISTORTION_BROWN_CONRADY ,{ 0,0,0,0,0 } };
+    rs2_video_stream video_stream = { RS2_STREAM_DEPTH, 0, 0, W, H, 60, BPP, RS2_FORMAT_Z16, depth_intrinsics };
+    auto depth_stream_profile = sensor.add_video_stream(video_stream);
+
+    rs2_motion_device_intrinsic motion_intrinsics = { { 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1 },{ 2, 2, 2 },{ 3, 3 ,3 } };
+    rs2_motion_stream motion_stream = { RS2_STREAM_ACCEL, 0, 1, 200, RS2_FORMAT_MOTION_RAW, motion_intrinsics };
+    auto motion_stream_profile = sensor.add_motion_stream(motion_stream);
+
+    rs2::syncer sync;
+    std::vector<stream_profile> stream_profiles;
+    stream_profiles.push_back(depth_stream_profile);
+    stream_profiles.push_back(motion_stream_profile);
+
+    std::vector<uint8_t> pixels(W * H * BPP, 100);
+    rs2_software_video_frame video_frame = { pixels.data(), [](void*) {},W*BPP, BPP, 10000, RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, 0, depth_stream_profile };
+    float motion_data[3] = { 1, 1, 1 };
+    rs2_software_motion_frame motion_frame = { motion_data, [](void*) {}, 20000, RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, 0, motion_stream_profile };
+
+    //Every segment holds a single frame
+    {
+        recorder recorder(filename, dev);
+        recorder.set_segment_limits(1, 0);
+        sensor.open(stream_profiles);
+        sensor.start(sync);
+        sensor.on_video_frame(video_frame);
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        sensor.on_motion_frame(motion_frame);
+    }
+    REQUIRE(std::ifstream(folder_name + "segments.001.bag").good());
+    REQUIRE_FALSE(std::ifstream(folder_name + "segments.002.bag").good());
+
+    rs2::context ctx;
+
+    if (!make_context(SECTION_FROM_TEST_NAME, &ctx))
+        return;
+    auto player_dev = ctx.load_device(filename);
+    player_dev.set_real_time(false);
+    REQUIRE(player_dev.as<playback>().get_duration() >= std::chrono::milliseconds(10));
+    syncer player_sync;
+    auto s = player_dev.query_sensors()[0];
+    REQUIRE_NOTHROW(s.open(s.get_stream_profiles()));
+    REQUIRE_NOTHROW(s.start(player_sync));
+    rs2::frameset fset;
+    rs2::frame recorded_depth, recorded_accel;
+    while (player_sync.try_wait_for_frames(&fset))
+    {
+        if (fset.first_or_default(RS2_STREAM_DEPTH))
+            recorded_depth = fset.first_or_default(RS2_STREAM_DEPTH);
+        if (fset.first_or_default(RS2_STREAM_ACCEL))
+            recorded_accel = fset.first_or_default(RS2_STREAM_ACCEL);
+    }
+
+    REQUIRE(recorded_depth);
+    REQUIRE(recorded_accel);
+
+    REQUIRE(((memcmp(video_frame.pixels, recorded_depth.get_data(), W * H * BPP) == 0) &&
+        video_frame.timestamp == recorded_depth.get_timestamp()));
+
+    REQUIRE(((memcmp(motion_frame.data, recorded_accel.get_data(), sizeof(float) * 3) == 0) &&
+        motion_frame.timestamp == recorded_accel.get_timestamp()));
+}
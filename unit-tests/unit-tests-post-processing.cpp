@@ -8,6 +8,7 @@
 #include "unit-tests-post-processing.h"
 #include "../include/librealsense2/rs_advanced_mode.hpp"
 #include <librealsense2/hpp/rs_frame.hpp>
+#include <librealsense2/rsutil.h>
 #include <cmath>
 #include <iostream>
 #include <chrono>
@@ -339,6 +340,897 @@ TEST_CASE("Post-Processing Filters metadata validation", "[software-device][post
     }
 }
 
+TEST_CASE("Pointcloud matches the reference deprojection", "[software-device][post-processing-filters]")
+{
+    rs2::context ctx;
+
+    if (make_context(SECTION_FROM_TEST_NAME, &ctx))
+    {
+        // The vectorized (SSE / NEON) deprojection and texture mapping must agree with rsutil
+        const int width = 848, height = 480, color_width = 1280, color_height = 720;
+        rs2_intrinsics depth_intrinsics = { width, height, 423.7f, 238.1f, 421.3f, 421.3f, RS2_DISTORTION_BROWN_CONRADY, { 0,0,0,0,0 } };
+        rs2_intrinsics color_intrinsics = { color_width, color_height, 641.2f, 362.5f, 922.f, 921.f, RS2_DISTORTION_MODIFIED_BROWN_CONRADY,
+            { 0.05f, -0.1f, 0.001f, -0.002f, 0.01f } };
+        rs2_extrinsics depth_to_color = { { 0.9999f, 0.0031f, -0.0121f, -0.0032f, 0.9999f, -0.0042f, 0.0121f, 0.0042f, 0.9999f },
+            { 0.0148f, 0.0002f, 0.0003f } };
+
+        software_stream depth(z16_stream(depth_intrinsics));
+        software_stream color({ RS2_STREAM_COLOR, 0, 1, color_width, color_height, 30, 3, RS2_FORMAT_RGB8, color_intrinsics });
+        depth.profile.register_extrinsics_to(color.profile, depth_to_color);
+
+        std::vector<uint16_t> depth_pixels(width * height);
+        std::vector<uint8_t> color_pixels(color_width * color_height * 3);
+        for (size_t i = 0; i < depth_pixels.size(); ++i)
+            depth_pixels[i] = (i % 7) ? uint16_t(300 + (i * 37) % 6000) : 0;
+
+        rs2::pointcloud pc;
+        pc.map_to(color.push(color_pixels.data()));
+        rs2::points points = pc.calculate(depth.push(depth_pixels.data()));
+        REQUIRE(points.size() == depth_pixels.size());
+
+        auto vertices = points.get_vertices();
+        auto tex_coords = points.get_texture_coordinates();
+        for (int y = 0; y < height; ++y)
+        {
+            for (int x = 0; x < width; ++x)
+            {
+                auto i = y * width + x;
+                if (!depth_pixels[i])
+                {
+                    REQUIRE(vertices[i].z == 0);
+                    continue;
+                }
+
+                float pixel[2] = { float(x), float(y) }, point[3], color_point[3], color_pixel[2];
+                rs2_deproject_pixel_to_point(point, &depth_intrinsics, pixel, 0.001f * depth_pixels[i]);
+                REQUIRE(std::abs(vertices[i].x - point[0]) < 1e-5f);
+                REQUIRE(std::abs(vertices[i].y - point[1]) < 1e-5f);
+                REQUIRE(std::abs(vertices[i].z - point[2]) < 1e-5f);
+
+                rs2_transform_point_to_point(color_point, &depth_to_color, point);
+                rs2_project_point_to_pixel(color_pixel, &color_intrinsics, color_point);
+                REQUIRE(std::abs(tex_coords[i].u * color_width - color_pixel[0]) < 0.01f);
+                REQUIRE(std::abs(tex_coords[i].v * color_height - color_pixel[1]) < 0.01f);
+            }
+        }
+    }
+}
+
+TEST_CASE("Voxel grid and normals of a tilted plane", "[software-device][post-processing-filters]")
+{
+    rs2::context ctx;
+
+    if (make_context(SECTION_FROM_TEST_NAME, &ctx))
+    {
+        const int width = 640, height = 480;
+        rs2_intrinsics intrinsics = { width, height, 320.f, 240.f, 380.f, 380.f, RS2_DISTORTION_NONE, { 0,0,0,0,0 } };
+        software_stream stream(z16_stream(intrinsics));
+
+        // The plane z = 1 + 0.5 x, seen along the ray of every pixel
+        std::vector<uint16_t> pixels(width * height);
+        for (int y = 0; y < height; ++y)
+            for (int x = 0; x < width; ++x)
+                pixels[y * width + x] = uint16_t(std::round(1000.f / (1.f - 0.5f * (x - intrinsics.ppx) / intrinsics.fx)));
+        pixels[100 * width + 100] = 0;
+        auto depth = stream.push(pixels.data());
+
+        rs2::pointcloud pc;
+        rs2::points points = pc.calculate(depth);
+
+        rs2::voxel_grid_filter voxels(0.05f);
+        rs2::points merged = voxels.process(points);
+        REQUIRE(merged.size() > 0);
+        REQUIRE(merged.size() < points.size() / 10);
+        for (size_t i = 0; i < merged.size(); ++i)
+        {
+            auto v = merged.get_vertices()[i];
+            REQUIRE(std::abs(v.z - (1.f + 0.5f * v.x)) < 0.01f);
+        }
+
+        rs2::normal_estimation normals;
+        rs2::video_frame estimated = normals.process(points);
+        REQUIRE(estimated.get_profile().format() == RS2_FORMAT_XYZ32F);
+        REQUIRE(estimated.get_width() == width);
+        REQUIRE(estimated.get_height() == height);
+
+        auto n = static_cast<const rs2::vertex*>(estimated.get_data());
+        const float expected[3] = { 0.5f / std::sqrt(1.25f), 0.f, -1.f / std::sqrt(1.25f) };
+        for (int y = 2; y < height - 2; y += 11)
+        {
+            for (int x = 2; x < width - 2; x += 13)
+            {
+                auto& normal = n[y * width + x];
+                CAPTURE(x);
+                CAPTURE(y);
+                REQUIRE(std::abs(normal.x - expected[0]) < 0.05f);
+                REQUIRE(std::abs(normal.y - expected[1]) < 0.05f);
+                REQUIRE(std::abs(normal.z - expected[2]) < 0.05f);
+            }
+        }
+        auto& hole = n[100 * width + 100];
+        REQUIRE(hole.x == 0.f);
+        REQUIRE(hole.y == 0.f);
+        REQUIRE(hole.z == 0.f);
+    }
+}
+
+TEST_CASE("Mesh generator leaves out depth steps", "[software-device][post-processing-filters]")
+{
+    rs2::context ctx;
+
+    if (make_context(SECTION_FROM_TEST_NAME, &ctx))
+    {
+        const int width = 64, height = 48;
+        software_stream stream;
+
+        // Two walls, one meter apart, meeting between the columns 31 and 32. One pixel has no depth
+        std::vector<uint16_t> pixels(width * height);
+        for (int y = 0; y < height; ++y)
+            for (int x = 0; x < width; ++x)
+                pixels[y * width + x] = x < 32 ? 1000 : 2000;
+        pixels[10 * width + 10] = 0;
+        auto depth = stream.push(pixels.data());
+
+        // Every square of pixels but the column across the step and the four squares around the hole
+        const int expected = 2 * ((width - 2) * (height - 1) - 4);
+        rs2::pointcloud pc;
+        rs2::mesh_generator mesh(0.1f);
+        for (int sparse = 0; sparse <= 2; sparse += 2)
+        {
+            pc.set_option(RS2_OPTION_SPARSE_POINTCLOUD, float(sparse));
+            rs2::points points = pc.calculate(depth);
+            rs2::video_frame faces = mesh.process(points);
+            REQUIRE(faces.get_profile().format() == RS2_FORMAT_MESH_INDICES);
+            REQUIRE(faces.get_width() == expected);
+            REQUIRE(faces.get_height() == 1);
+
+            auto indices = static_cast<const uint32_t*>(faces.get_data());
+            auto vertices = points.get_vertices();
+            for (int i = 0; i < 3 * expected; i += 3)
+            {
+                for (int j = 0; j < 3; ++j)
+                {
+                    REQUIRE(indices[i + j] < points.size());
+                    REQUIRE(vertices[indices[i + j]].z > 0.f);
+                }
+                REQUIRE(std::abs(vertices[indices[i]].z - vertices[indices[i + 1]].z) < 0.1f);
+                REQUIRE(std::abs(vertices[indices[i]].z - vertices[indices[i + 2]].z) < 0.1f);
+            }
+        }
+    }
+}
+
+TEST_CASE("Depth statistics measure regions of interest", "[software-device][post-processing-filters]")
+{
+    rs2::context ctx;
+
+    if (make_context(SECTION_FROM_TEST_NAME, &ctx))
+    {
+        const int width = 64, height = 48;
+        software_stream stream;
+
+        // A ramp of depths along the rows, a centimeter per column, with every fourth pixel of the left half missing
+        std::vector<uint16_t> pixels(width * height);
+        for (int y = 0; y < height; ++y)
+            for (int x = 0; x < width; ++x)
+                pixels[y * width + x] = (x < 32 && x % 4 == 0) ? 0 : uint16_t(1005 + 10 * x);
+        auto depth = stream.push(pixels.data());
+
+        rs2::depth_statistics statistics;
+        statistics.set_option(RS2_OPTION_MIN_DISTANCE, 1.f);
+        statistics.set_option(RS2_OPTION_MAX_DISTANCE, 1.64f);
+        statistics.add_roi({ 0, 0, 31, height - 1 });
+        statistics.add_roi({ 32, 10, width + 10, 19 });
+        for_each_thread_count(statistics, [&]()
+        {
+            rs2::video_frame out = statistics.process(depth);
+            REQUIRE(out.get_profile().format() == RS2_FORMAT_DEPTH_STATISTICS);
+            auto stats = rs2::depth_statistics::get_statistics(out);
+            REQUIRE(stats.size() == 2);
+
+            REQUIRE(stats[0].pixels == 32 * height);
+            REQUIRE(stats[0].valid_pixels == 24 * height);
+            REQUIRE(stats[0].fill_rate == Approx(0.75f));
+            REQUIRE(stats[0].min_depth == Approx(1.015f));
+            REQUIRE(stats[0].max_depth == Approx(1.315f));
+
+            // The second region is cut to the frame
+            REQUIRE(stats[1].max_x == width - 1);
+            REQUIRE(stats[1].pixels == 32 * 10);
+            REQUIRE(stats[1].fill_rate == 1.f);
+            REQUIRE(stats[1].mean_depth == Approx(1.48f));
+            REQUIRE(stats[1].median_depth == Approx(1.475f));
+
+            // Bins of 10 depth units, a column of the ramp in the middle of each
+            unsigned int binned = 0;
+            for (int b = 0; b < RS2_DEPTH_STATISTICS_HISTOGRAM_BINS; ++b)
+            {
+                REQUIRE(stats[1].histogram[b] == (b >= 32 ? 10u : 0u));
+                binned += stats[0].histogram[b];
+            }
+            REQUIRE(binned == stats[0].valid_pixels);
+        });
+
+        // Without any region the whole frame is measured
+        statistics.clear_rois();
+        rs2::video_frame whole = statistics.process(depth);
+        auto stats = rs2::depth_statistics::get_statistics(whole);
+        REQUIRE(stats.size() == 1);
+        REQUIRE(stats[0].pixels == width * height);
+        REQUIRE(stats[0].valid_pixels == (width - 8) * height);
+    }
+}
+
+TEST_CASE("Height map bins depth into a ground grid", "[software-device][post-processing-filters]")
+{
+    rs2::context ctx;
+
+    if (make_context(SECTION_FROM_TEST_NAME, &ctx))
+    {
+        const int width = 64, height = 48;
+        software_stream stream;
+
+        // Looking down on the floor from 2 meters, at a box half a meter high in the middle of the image
+        std::vector<uint16_t> pixels(width * height);
+        for (int y = 0; y < height; ++y)
+            for (int x = 0; x < width; ++x)
+                pixels[y * width + x] = (x >= 24 && x < 40 && y >= 16 && y < 32) ? 1500 : 2000;
+        auto depth = stream.push(pixels.data());
+
+        const int cells = 16;
+        rs2::height_map map;
+        map.set_ground({ { 1, 0, 0, 0, -1, 0, 0, 0, -1 }, { 0, 0, 2 } });
+        map.set_option(RS2_OPTION_GRID_CELL_SIZE, 0.25f);
+        map.set_option(RS2_OPTION_GRID_CELLS, float(cells));
+
+        // The cell under the box, one of the floor, and one out of view
+        const int box = 8 * cells + 8, floor = 3 * cells + 2, unseen = 0;
+        std::vector<float> heights;
+        for_each_thread_count(map, [&]()
+        {
+            rs2::video_frame out = map.process(depth);
+            REQUIRE(out.get_profile().format() == RS2_FORMAT_HEIGHT_MAP);
+            REQUIRE(out.get_width() == cells);
+            REQUIRE(out.get_height() == cells);
+
+            auto h = static_cast<const float*>(out.get_data());
+            REQUIRE(h[box] == Approx(0.5f));
+            REQUIRE(std::abs(h[floor]) < 0.001f);
+            REQUIRE(std::isnan(h[unseen]));
+            if (heights.empty())
+                heights.assign(h, h + cells * cells);
+            for (int c = 0; c < cells * cells; ++c)
+                REQUIRE((std::isnan(h[c]) ? std::isnan(heights[c]) : h[c] == heights[c]));
+        });
+
+        map.set_option(RS2_OPTION_GRID_OCCUPANCY, 1.f);
+        rs2::video_frame grid = map.process(depth);
+        REQUIRE(grid.get_profile().format() == RS2_FORMAT_OCCUPANCY_GRID);
+        auto occupancy = static_cast<const uint8_t*>(grid.get_data());
+        for (int c = 0; c < cells * cells; ++c)
+        {
+            auto expected = std::isnan(heights[c]) ? RS2_OCCUPANCY_UNKNOWN : heights[c] >= 0.1f ? RS2_OCCUPANCY_OCCUPIED : RS2_OCCUPANCY_FREE;
+            REQUIRE(occupancy[c] == expected);
+        }
+        REQUIRE(occupancy[box] == RS2_OCCUPANCY_OCCUPIED);
+        REQUIRE(occupancy[floor] == RS2_OCCUPANCY_FREE);
+
+        // Below the top of the box, the box is left out and hides the floor under it
+        map.set_option(RS2_OPTION_OBSTACLE_MAX_HEIGHT, 0.4f);
+        grid = map.process(depth);
+        occupancy = static_cast<const uint8_t*>(grid.get_data());
+        REQUIRE(occupancy[box] == RS2_OCCUPANCY_UNKNOWN);
+        REQUIRE(occupancy[floor] == RS2_OCCUPANCY_FREE);
+    }
+}
+
+TEST_CASE("Pointcloud outputs the changed tiles", "[software-device][post-processing-filters]")
+{
+    rs2::context ctx;
+
+    if (make_context(SECTION_FROM_TEST_NAME, &ctx))
+    {
+        const int width = 64, height = 48, tile = 16;
+        software_stream stream;
+
+        rs2::pointcloud pc;
+        pc.set_option(RS2_OPTION_SPARSE_POINTCLOUD, 3.f);
+        pc.set_option(RS2_OPTION_POINTCLOUD_TILE_TOLERANCE, 10.f);
+
+        std::vector<uint16_t> pixels(width * height, 1000);
+        int number = 0;
+        auto calculate = [&]() { return pc.calculate(stream.push(pixels.data(), ++number)); };
+
+        // The first frame has all of the tiles, an unchanged one none
+        REQUIRE(calculate().size() == width * height);
+        REQUIRE(calculate().size() == 0);
+
+        // Changes within the tolerance are left out, a pixel losing its depth is not
+        pixels[20 * width + 40] = 1005;
+        REQUIRE(calculate().size() == 0);
+        pixels[20 * width + 40] = 0;
+        rs2::points changed = calculate();
+        REQUIRE(changed.size() == tile * tile);
+        auto indices = changed.get_pixel_indices();
+        REQUIRE(indices);
+        for (size_t i = 0; i < changed.size(); ++i)
+        {
+            REQUIRE(indices[i] / width / tile == 1);
+            REQUIRE(indices[i] % width / tile == 2);
+            REQUIRE((changed.get_vertices()[i].z == 0.f) == (indices[i] == 20 * width + 40));
+        }
+
+        pc.refresh_tiles();
+        REQUIRE(calculate().size() == width * height);
+        REQUIRE(calculate().size() == 0);
+    }
+}
+
+TEST_CASE("TSDF integrator extracts the surface of a plane", "[software-device][post-processing-filters]")
+{
+    rs2::context ctx;
+
+    if (make_context(SECTION_FROM_TEST_NAME, &ctx))
+    {
+        const int width = 320, height = 240;
+        software_stream stream(z16_stream({ width, height, 160.f, 120.f, 190.f, 190.f, RS2_DISTORTION_NONE, { 0,0,0,0,0 } }));
+
+        // A wall facing the camera at one meter
+        std::vector<uint16_t> pixels(width * height, 1000);
+        rs2::tsdf_integrator integrator(0.02f, 0.08f);
+        rs2::tsdf_integrator moved(0.02f, 0.08f);
+        rs2_pose pose = {};
+        pose.translation.z = 0.5f;
+        pose.rotation.w = 1.f;
+        moved.set_pose(pose);
+
+        for (int i = 1; i <= 3; ++i)
+        {
+            auto depth = stream.push(pixels.data(), i);
+
+            rs2::points surface = integrator.process(depth);
+            REQUIRE(surface.size() > 1000);
+            for (size_t j = 0; j < surface.size(); ++j)
+                REQUIRE(std::abs(surface.get_vertices()[j].z - 1.f) < 0.01f);
+
+            // The same wall, seen from half a meter further along the world z
+            rs2::points moved_surface = moved.process(depth);
+            REQUIRE(moved_surface.size() > 1000);
+            for (size_t j = 0; j < moved_surface.size(); ++j)
+                REQUIRE(std::abs(moved_surface.get_vertices()[j].z - 1.5f) < 0.01f);
+        }
+
+        integrator.reset();
+        integrator.set_option(RS2_OPTION_MAX_DISTANCE, 0.5f);
+        rs2::points beyond = integrator.process(stream.push(pixels.data(), 4));
+        REQUIRE(beyond.size() == 0);
+    }
+}
+
+TEST_CASE("Multi-target align matches an align block per target", "[software-device][post-processing-filters]")
+{
+    rs2::context ctx;
+
+    if (make_context(SECTION_FROM_TEST_NAME, &ctx))
+    {
+        const int width = 320, height = 240;
+        rs2_intrinsics depth_intrinsics = { width, height, 160.f, 120.f, 190.f, 190.f, RS2_DISTORTION_NONE, { 0,0,0,0,0 } };
+        rs2_intrinsics ir_intrinsics = { 424, 240, 212.f, 120.f, 200.f, 200.f, RS2_DISTORTION_NONE, { 0,0,0,0,0 } };
+        rs2_intrinsics color_intrinsics = { 640, 480, 321.f, 238.f, 600.f, 600.f, RS2_DISTORTION_INVERSE_BROWN_CONRADY, { 0,0,0,0,0 } };
+
+        software_stream depth(z16_stream(depth_intrinsics));
+        software_stream ir({ RS2_STREAM_INFRARED, 1, 1, 424, 240, 30, 1, RS2_FORMAT_Y8, ir_intrinsics });
+        software_stream color({ RS2_STREAM_COLOR, 0, 2, 640, 480, 30, 3, RS2_FORMAT_RGB8, color_intrinsics });
+        depth.profile.register_extrinsics_to(ir.profile, { { 1,0,0,0,1,0,0,0,1 }, { 0.f, 0.f, 0.f } });
+        depth.profile.register_extrinsics_to(color.profile, { { 1,0,0,0,1,0,0,0,1 }, { 0.015f, 0.f, 0.001f } });
+
+        std::vector<uint16_t> depth_pixels(width * height);
+        for (int i = 0; i < width * height; ++i)
+            depth_pixels[i] = (i % 17) ? uint16_t(500 + (i * 7) % 1500) : 0;
+        std::vector<uint8_t> ir_pixels(424 * 240, 128), color_pixels(640 * 480 * 3, 64);
+        std::vector<rs2::frame> inputs = { depth.push(depth_pixels.data()), ir.push(ir_pixels.data()), color.push(color_pixels.data()) };
+
+        rs2::processing_block combine([&](rs2::frame, rs2::frame_source& source) { source.frame_ready(source.allocate_composite_frame(inputs)); });
+        rs2::frame_queue sets;
+        combine.start(sets);
+        combine.invoke(inputs[0]);
+        rs2::frameset set = sets.wait_for_frame();
+        REQUIRE(set.size() == 3);
+
+        REQUIRE_THROWS(rs2::multi_align({}));
+        REQUIRE_THROWS(rs2::multi_align({ RS2_STREAM_COLOR, RS2_STREAM_DEPTH }));
+
+        rs2::multi_align aligner({ RS2_STREAM_COLOR, RS2_STREAM_INFRARED });
+        rs2::frameset aligned = aligner.process(set);
+
+        std::vector<rs2::frame> depths;
+        for (auto&& f : aligned)
+            if (f.get_profile().stream_type() == RS2_STREAM_DEPTH)
+                depths.push_back(f);
+        REQUIRE(depths.size() == 2);
+
+        int index = 0;
+        for (auto stream : { RS2_STREAM_COLOR, RS2_STREAM_INFRARED })
+        {
+            rs2::align single(stream);
+            auto expected = single.process(set).first(RS2_STREAM_DEPTH).as<rs2::video_frame>();
+            auto actual = depths[index++].as<rs2::video_frame>();
+            REQUIRE(actual.get_width() == expected.get_width());
+            REQUIRE(actual.get_height() == expected.get_height());
+            REQUIRE(actual.get_profile().as<rs2::video_stream_profile>().get_intrinsics().fx ==
+                expected.get_profile().as<rs2::video_stream_profile>().get_intrinsics().fx);
+            auto size = expected.get_width() * expected.get_height() * 2;
+            REQUIRE(!memcmp(actual.get_data(), expected.get_data(), size));
+        }
+    }
+}
+
+TEST_CASE("Align to depth is the same on any number of threads", "[software-device][post-processing-filters]")
+{
+    rs2::context ctx;
+
+    if (make_context(SECTION_FROM_TEST_NAME, &ctx))
+    {
+        const int width = 320, height = 240;
+        rs2_intrinsics depth_intrinsics = { width, height, 160.f, 120.f, 190.f, 190.f, RS2_DISTORTION_NONE, { 0,0,0,0,0 } };
+        rs2_intrinsics color_intrinsics = { 640, 480, 321.f, 238.f, 300.f, 300.f, RS2_DISTORTION_INVERSE_BROWN_CONRADY, { 0,0,0,0,0 } };
+
+        software_stream depth(z16_stream(depth_intrinsics));
+        software_stream color({ RS2_STREAM_COLOR, 0, 1, 640, 480, 30, 3, RS2_FORMAT_RGB8, color_intrinsics });
+        depth.profile.register_extrinsics_to(color.profile, { { 1,0,0,0,1,0,0,0,1 }, { 0.015f, 0.f, 0.001f } });
+
+        std::vector<uint16_t> depth_pixels(width * height);
+        for (int i = 0; i < width * height; ++i)
+            depth_pixels[i] = (i % 13) ? uint16_t(400 + (i * 11) % 2000) : 0;
+        std::vector<uint8_t> color_pixels(640 * 480 * 3);
+        for (size_t i = 0; i < color_pixels.size(); ++i)
+            color_pixels[i] = uint8_t(i % 251);
+        std::vector<rs2::frame> inputs = { depth.push(depth_pixels.data()), color.push(color_pixels.data()) };
+
+        rs2::processing_block combine([&](rs2::frame, rs2::frame_source& source) { source.frame_ready(source.allocate_composite_frame(inputs)); });
+        rs2::frame_queue sets;
+        combine.start(sets);
+        combine.invoke(inputs[0]);
+        rs2::frameset set = sets.wait_for_frame();
+
+        std::vector<uint8_t> expected;
+        rs2::align aligner(RS2_STREAM_DEPTH);
+        for_each_thread_count(aligner, [&]()
+        {
+            auto aligned = aligner.process(set).first(RS2_STREAM_COLOR).as<rs2::video_frame>();
+            REQUIRE(aligned.get_width() == width);
+            REQUIRE(aligned.get_height() == height);
+
+            auto data = static_cast<const uint8_t*>(aligned.get_data());
+            std::vector<uint8_t> pixels(data, data + width * height * 3);
+            if (expected.empty())
+            {
+                // Pixels without depth stay black, the others come from the color image
+                expected = pixels;
+                REQUIRE(std::count(pixels.begin(), pixels.end(), 0) < int(pixels.size() / 4));
+                for (int i = 0; i < width * height; i += 13)
+                    REQUIRE((pixels[i * 3] | pixels[i * 3 + 1] | pixels[i * 3 + 2]) == 0);
+            }
+            REQUIRE(pixels == expected);
+        });
+    }
+}
+
+TEST_CASE("Batched color to depth pixel search matches rsutil", "[post-processing-filters]")
+{
+    const int width = 848, height = 480, color_width = 1280, color_height = 720;
+    rs2_intrinsics depth_intrinsics = { width, height, 423.7f, 238.1f, 421.3f, 421.3f, RS2_DISTORTION_INVERSE_BROWN_CONRADY,
+        { 0.01f, -0.02f, 0.001f, 0.001f, 0.f } };
+    rs2_intrinsics color_intrinsics = { color_width, color_height, 641.2f, 362.5f, 922.f, 921.f, RS2_DISTORTION_INVERSE_BROWN_CONRADY,
+        { 0.05f, -0.1f, 0.001f, -0.002f, 0.01f } };
+    rs2_extrinsics depth_to_color = { { 0.9999f, 0.0031f, -0.0121f, -0.0032f, 0.9999f, -0.0042f, 0.0121f, 0.0042f, 0.9999f },
+        { 0.0148f, 0.0002f, 0.0003f } };
+    rs2_extrinsics color_to_depth = { { 0.9999f, -0.0032f, 0.0121f, 0.0031f, 0.9999f, 0.0042f, -0.0121f, -0.0042f, 0.9999f },
+        { -0.0148f, -0.0002f, -0.0003f } };
+
+    std::vector<uint16_t> depth(width * height);
+    for (size_t i = 0; i < depth.size(); ++i)
+        depth[i] = (i % 5) ? uint16_t(400 + (i * 13) % 3000) : 0;
+
+    std::vector<float> color_pixels, expected;
+    for (int y = 0; y < color_height; y += 37)
+    {
+        for (int x = 0; x < color_width; x += 41)
+        {
+            float pixel[2] = { x + 0.25f, y + 0.75f }, to_pixel[2] = { -1.f, -1.f };
+            rs2_project_color_pixel_to_depth_pixel(to_pixel, depth.data(), 0.001f, 0.1f, 10.f,
+                &depth_intrinsics, &color_intrinsics, &color_to_depth, &depth_to_color, pixel);
+            color_pixels.insert(color_pixels.end(), pixel, pixel + 2);
+            expected.insert(expected.end(), to_pixel, to_pixel + 2);
+        }
+    }
+
+    std::vector<float> depth_pixels(color_pixels.size());
+    rs2_error* e = nullptr;
+    rs2_project_color_pixels_to_depth_pixels(depth_pixels.data(), depth.data(), 0.001f, 0.1f, 10.f,
+        &depth_intrinsics, &color_intrinsics, &color_to_depth, &depth_to_color, color_pixels.data(), int(color_pixels.size() / 2), &e);
+    REQUIRE(e == nullptr);
+    REQUIRE(depth_pixels == expected);
+}
+
+TEST_CASE("Depth refinement matches the chained filters", "[software-device][post-processing-filters]")
+{
+    rs2::context ctx;
+
+    if (make_context(SECTION_FROM_TEST_NAME, &ctx))
+    {
+        const int width = 848, height = 480;
+        software_stream stream(z16_stream({ width, height, 423.7f, 238.1f, 421.3f, 421.3f, RS2_DISTORTION_BROWN_CONRADY, { 0,0,0,0,0 } }));
+        stream.sensor.add_read_only_option(RS2_OPTION_STEREO_BASELINE, 0.05f);
+
+        // Separate stages for each path, the temporal filters keep their own history
+        rs2::decimation_filter dec[2];
+        rs2::disparity_transform to_disparity[2] = { rs2::disparity_transform(true), rs2::disparity_transform(true) };
+        rs2::spatial_filter spatial[2];
+        rs2::temporal_filter temporal[2];
+        rs2::disparity_transform to_depth[2] = { rs2::disparity_transform(false), rs2::disparity_transform(false) };
+        rs2::depth_refine refine(&dec[1], &to_disparity[1], &spatial[1], &temporal[1], &to_depth[1]);
+        refine.set_option(RS2_OPTION_PROCESSING_THREADS, 0);
+        for (auto& s : spatial)
+            s.set_option(RS2_OPTION_HOLES_FILL, 2);
+
+        std::vector<uint16_t> pixels(width * height);
+        for (int n = 1; n <= 3; n++)
+        {
+            for (size_t i = 0; i < pixels.size(); ++i)
+                pixels[i] = ((i + n) % 11) ? uint16_t(400 + (i * 37 + n * 5) % 3000) : 0;
+            auto depth = stream.push(pixels.data(), n);
+
+            auto chained = to_depth[0].process(temporal[0].process(spatial[0].process(to_disparity[0].process(dec[0].process(depth)))));
+            auto fused = refine.process(depth);
+
+            auto expected = chained.as<rs2::video_frame>();
+            auto actual = fused.as<rs2::video_frame>();
+            REQUIRE(actual);
+            REQUIRE(actual.get_profile().format() == RS2_FORMAT_Z16);
+            REQUIRE(actual.get_width() == expected.get_width());
+            REQUIRE(actual.get_height() == expected.get_height());
+            REQUIRE(actual.is<rs2::depth_frame>());
+            REQUIRE(0 == memcmp(actual.get_data(), expected.get_data(), expected.get_height() * expected.get_stride_in_bytes()));
+        }
+    }
+}
+
+TEST_CASE("Processed depth frames measure distances on their own", "[software-device][post-processing-filters]")
+{
+    rs2::context ctx;
+
+    if (make_context(SECTION_FROM_TEST_NAME, &ctx))
+    {
+        const int width = 640, height = 480;
+        software_stream stream(z16_stream({ width, height, 320.f, 240.f, 380.f, 380.f, RS2_DISTORTION_BROWN_CONRADY, { 0,0,0,0,0 } }));
+        stream.sensor.add_read_only_option(RS2_OPTION_STEREO_BASELINE, 0.05f);
+
+        std::vector<uint16_t> pixels(width * height);
+        for (size_t i = 0; i < pixels.size(); ++i)
+            pixels[i] = (i % 7) ? uint16_t(300 + (i * 31) % 4000) : 0;
+        auto depth = stream.push(pixels.data());
+
+        rs2::disparity_transform to_disparity(true);
+        rs2::disparity_transform to_depth(false);
+        rs2::depth_frame disparity = to_disparity.process(depth);
+        rs2::depth_frame restored = to_depth.process(disparity);
+        REQUIRE(disparity.is<rs2::disparity_frame>());
+        REQUIRE(restored.get_profile().format() == RS2_FORMAT_Z16);
+
+        // The input is released, the processed frames do not hold on to it
+        depth = rs2::frame();
+        for (int y = 0; y < height; y += 13)
+        {
+            for (int x = 0; x < width; x += 17)
+            {
+                auto expected = pixels[y * width + x] * 0.001f;
+                CAPTURE(x);
+                CAPTURE(y);
+                REQUIRE(disparity.get_distance(x, y) == Approx(expected).epsilon(0.001));
+                REQUIRE(restored.get_distance(x, y) == Approx(expected).epsilon(0.001));
+            }
+        }
+    }
+}
+
+TEST_CASE("Threshold-crop keeps the band and the region", "[software-device][post-processing-filters]")
+{
+    rs2::context ctx;
+
+    if (make_context(SECTION_FROM_TEST_NAME, &ctx))
+    {
+        const int width = 640, height = 480;
+        rs2_intrinsics intrinsics = { width, height, 320.f, 240.f, 380.f, 380.f, RS2_DISTORTION_BROWN_CONRADY, { 0,0,0,0,0 } };
+
+        software_stream stream(z16_stream(intrinsics));
+
+        std::vector<uint16_t> pixels(width * height);
+        for (size_t i = 0; i < pixels.size(); ++i)
+            pixels[i] = uint16_t((i * 37) % 5000);
+        auto depth = stream.push(pixels.data());
+
+        rs2::threshold_crop threshold(0.3f, 3.f);
+        threshold.set_region(0.25f, 0.25f, 0.75f, 0.75f);
+        rs2::video_frame cropped = threshold.process(depth);
+        REQUIRE(cropped.get_width() == width / 2);
+        REQUIRE(cropped.get_height() == height / 2);
+
+        auto out = cropped.get_profile().as<rs2::video_stream_profile>().get_intrinsics();
+        REQUIRE(out.width == width / 2);
+        REQUIRE(out.height == height / 2);
+        REQUIRE(out.ppx == intrinsics.ppx - width / 4);
+        REQUIRE(out.ppy == intrinsics.ppy - height / 4);
+        REQUIRE(out.fx == intrinsics.fx);
+
+        auto data = static_cast<const uint16_t*>(cropped.get_data());
+        for (int y = 0; y < height / 2; ++y)
+        {
+            for (int x = 0; x < width / 2; ++x)
+            {
+                auto in = pixels[(y + height / 4) * width + x + width / 4];
+                REQUIRE(data[y * width / 2 + x] == ((in >= 300 && in <= 3000) ? in : 0));
+            }
+        }
+    }
+}
+
+TEST_CASE("Rate limiter keeps one of N frames and caps the rate", "[software-device][post-processing-filters]")
+{
+    rs2::context ctx;
+
+    if (make_context(SECTION_FROM_TEST_NAME, &ctx))
+    {
+        const int width = 64, height = 48;
+        auto depth_stream = z16_stream();
+        depth_stream.fps = 90;
+        software_stream stream(depth_stream);
+
+        rs2::rate_limiter one_of_three(3);
+        rs2::rate_limiter capped(1, 15.f);
+        std::vector<unsigned long long> kept_one_of_three, kept_capped;
+
+        std::vector<uint16_t> pixels(width * height, 1000);
+        for (int i = 0; i < 90; ++i)
+        {
+            // 90fps with a jitter of a tenth of the interval
+            double timestamp = i * 1000. / 90 + ((i % 3) - 1) * 1.1;
+            auto depth = stream.push(pixels.data(), i + 1, timestamp);
+
+            if (auto out = one_of_three.process(depth))
+                kept_one_of_three.push_back(out.get_frame_number());
+            if (auto out = capped.process(depth))
+                kept_capped.push_back(out.get_frame_number());
+        }
+
+        REQUIRE(kept_one_of_three.size() == 30);
+        for (size_t i = 0; i < kept_one_of_three.size(); ++i)
+            REQUIRE(kept_one_of_three[i] == 3 * i + 1);
+
+        REQUIRE(kept_capped.size() == 15);
+        for (size_t i = 0; i < kept_capped.size(); ++i)
+            REQUIRE(kept_capped[i] == 6 * i + 1);
+    }
+}
+
+TEST_CASE("Decimation of color formats averages the patches", "[software-device][post-processing-filters]")
+{
+    rs2::context ctx;
+
+    if (make_context(SECTION_FROM_TEST_NAME, &ctx))
+    {
+        const int width = 130, height = 47, scale = 3;
+        rs2_intrinsics intrinsics = { width, height, 65.f, 23.f, 80.f, 80.f, RS2_DISTORTION_NONE, { 0,0,0,0,0 } };
+
+        for (auto format : { RS2_FORMAT_RGB8, RS2_FORMAT_YUYV })
+        {
+            const int bpp = format == RS2_FORMAT_RGB8 ? 3 : 2;
+            software_stream stream({ RS2_STREAM_COLOR, 0, 0, width, height, 30, bpp, format, intrinsics });
+
+            std::vector<uint8_t> pixels(width * height * bpp);
+            for (size_t i = 0; i < pixels.size(); ++i)
+                pixels[i] = uint8_t((i * 7919) >> 3);
+
+            rs2::decimation_filter dec;
+            dec.set_option(RS2_OPTION_STREAM_FILTER, RS2_STREAM_COLOR);
+            dec.set_option(RS2_OPTION_STREAM_FORMAT_FILTER, format);
+            dec.set_option(RS2_OPTION_FILTER_MAGNITUDE, scale);
+            dec.set_option(RS2_OPTION_PROCESSING_THREADS, 4);
+            rs2::video_frame out = dec.process(stream.push(pixels.data()));
+            auto data = static_cast<const uint8_t*>(out.get_data());
+
+            // Channel c of pixel x in row y, each chroma sample of YUYV covering the two pixels of its pair
+            auto sample = [&](int x, int y, int c)
+            {
+                if (format == RS2_FORMAT_RGB8)
+                    return pixels[(y * width + x) * 3 + c];
+                if (c == 0)
+                    return pixels[(y * width + x) * 2];
+                return pixels[(y * width + (x & ~1)) * 2 + (c == 1 ? 1 : 3)];
+            };
+
+            // YUYV is decimated by whole pairs, the odd last column is left out
+            const int out_width = (width / scale) & (format == RS2_FORMAT_YUYV ? ~1 : ~0), out_height = height / scale;
+            for (int y = 0; y < out_height; ++y)
+            {
+                for (int x = 0; x < out_width; ++x)
+                {
+                    for (int c = 0; c < 3; ++c)
+                    {
+                        // The output chroma of a YUYV pair is the one of its first pixel
+                        if (format == RS2_FORMAT_YUYV && c > 0 && (x & 1))
+                            continue;
+                        int sum = 0;
+                        for (int n = 0; n < scale; ++n)
+                            for (int m = 0; m < scale; ++m)
+                                sum += sample(x * scale + m, y * scale + n, c);
+
+                        auto offset = format == RS2_FORMAT_RGB8 ? (y * out.get_width() + x) * 3 + c
+                            : (y * out.get_width() + x) * 2 + (c == 0 ? 0 : c == 1 ? 1 : 3);
+                        REQUIRE(int(data[offset]) == sum / (scale * scale));
+                    }
+                }
+            }
+        }
+    }
+}
+
+// 'a' and 'b' are set up the same, 'a' gets the only reference to its input and 'b' a shared one
+void require_in_place(rs2::filter& a, rs2::filter& b, rs2::frame depth)
+{
+    // The frames of the decimation are the library's own, the software frame wraps the caller's pixels
+    rs2::decimation_filter dec;
+    dec.set_option(RS2_OPTION_FILTER_MAGNITUDE, 1);
+    auto owned = dec.process(depth);
+    auto shared = dec.process(depth);
+    auto data = owned.get_data();
+    auto size = shared.as<rs2::video_frame>().get_height() * shared.as<rs2::video_frame>().get_stride_in_bytes();
+
+    auto in_place = a.process(std::move(owned));
+    auto copied = b.process(shared);
+    REQUIRE(in_place.get_data() == data);
+    REQUIRE(copied.get_data() != shared.get_data());
+    REQUIRE(in_place.get_profile().format() == copied.get_profile().format());
+    REQUIRE(0 == memcmp(in_place.get_data(), copied.get_data(), size));
+
+    auto copy = std::vector<uint8_t>((const uint8_t*)depth.get_data(), (const uint8_t*)depth.get_data() + size);
+    auto filtered = b.process(depth);
+    REQUIRE(filtered.get_data() != depth.get_data());
+    REQUIRE(0 == memcmp(depth.get_data(), copy.data(), size));
+}
+
+TEST_CASE("Depth filters work in place on frames they own", "[software-device][post-processing-filters]")
+{
+    rs2::context ctx;
+
+    if (make_context(SECTION_FROM_TEST_NAME, &ctx))
+    {
+        const int width = 640, height = 480;
+        software_stream stream(z16_stream({ width, height, 320.f, 240.f, 380.f, 380.f, RS2_DISTORTION_BROWN_CONRADY, { 0,0,0,0,0 } }));
+
+        std::vector<uint16_t> pixels(width * height);
+        for (size_t i = 0; i < pixels.size(); ++i)
+            pixels[i] = (i % 5) ? uint16_t(500 + (i * 29) % 2500) : 0;
+        auto depth = stream.push(pixels.data());
+
+        rs2::spatial_filter spatial[2];
+        require_in_place(spatial[0], spatial[1], depth);
+        rs2::temporal_filter temporal[2];
+        require_in_place(temporal[0], temporal[1], depth);
+        rs2::hole_filling_filter fill_from_left[2] = { rs2::hole_filling_filter(0), rs2::hole_filling_filter(0) };
+        require_in_place(fill_from_left[0], fill_from_left[1], depth);
+    }
+}
+
+TEST_CASE("YUY2 decoder converts the frames it outputs", "[software-device][post-processing-filters]")
+{
+    rs2::context ctx;
+
+    if (make_context(SECTION_FROM_TEST_NAME, &ctx))
+    {
+        const int width = 640, height = 480;
+        rs2_intrinsics intrinsics = { width, height, 320.f, 240.f, 600.f, 600.f, RS2_DISTORTION_NONE, { 0,0,0,0,0 } };
+        software_stream stream({ RS2_STREAM_COLOR, 0, 0, width, height, 30, 2, RS2_FORMAT_YUYV, intrinsics });
+
+        // Gray pixels, alternating between black and white
+        std::vector<uint8_t> pixels(width * height * 2);
+        for (size_t i = 0; i < pixels.size(); i += 2)
+        {
+            pixels[i] = ((i / 2) % 3) ? 16 : 235;
+            pixels[i + 1] = 128;
+        }
+        auto color = stream.push(pixels.data());
+
+        REQUIRE_THROWS(rs2::yuy2_decoder(RS2_FORMAT_Z16));
+
+        rs2::yuy2_decoder to_rgb(RS2_FORMAT_RGB8), to_bgra(RS2_FORMAT_BGRA8);
+        rs2::video_frame rgb = to_rgb.process(color), bgra = to_bgra.process(color);
+        REQUIRE(rgb.get_profile().format() == RS2_FORMAT_RGB8);
+        REQUIRE(bgra.get_profile().format() == RS2_FORMAT_BGRA8);
+        REQUIRE(rgb.get_frame_number() == color.get_frame_number());
+
+        auto rgb_pixels = static_cast<const uint8_t*>(rgb.get_data());
+        auto bgra_pixels = static_cast<const uint8_t*>(bgra.get_data());
+        // The vectorized unpackers may round differently by one level
+        for (int i = 0; i < width * height; ++i)
+        {
+            int expected = (i % 3) ? 0 : 255;
+            for (int c = 0; c < 3; ++c)
+            {
+                REQUIRE(std::abs(rgb_pixels[i * 3 + c] - expected) <= 1);
+                REQUIRE(std::abs(bgra_pixels[i * 4 + c] - expected) <= 1);
+            }
+            REQUIRE(bgra_pixels[i * 4 + 3] == 255);
+        }
+
+        // The conversion is kept with the frame
+        REQUIRE(rgb.get_data() == rgb_pixels);
+    }
+}
+
+TEST_CASE("IMU fusion interpolates accel and gyro onto the output timestamps", "[software-device][post-processing-filters]")
+{
+    rs2::context ctx;
+
+    if (make_context(SECTION_FROM_TEST_NAME, &ctx))
+    {
+        rs2_motion_device_intrinsic intrinsics = { { 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0 },{ 0, 0, 0 },{ 0, 0, 0 } };
+
+        REQUIRE_THROWS(rs2::imu_fusion(-1.f));
+
+        struct fused { double accel_time, gyro_time; rs2_vector accel, gyro; bool same_fps; };
+
+        for (auto rate : { 0.f, 200.f })
+        {
+            software_stream accel_stream({ RS2_STREAM_ACCEL, 0, 0, 250, RS2_FORMAT_MOTION_XYZ32F, intrinsics });
+            software_stream gyro_stream({ RS2_STREAM_GYRO, 0, 1, 400, RS2_FORMAT_MOTION_XYZ32F, intrinsics });
+
+            // The outputs are read as they come, the pools of the sensors and of the block are not exhausted
+            rs2::imu_fusion fusion(rate);
+            std::vector<fused> output;
+            auto fuse = [&](rs2::frame f)
+            {
+                fusion(f);
+                rs2::frameset fs;
+                while (fusion.poll_for_frames(&fs))
+                {
+                    auto accel = fs.first(RS2_STREAM_ACCEL).as<rs2::motion_frame>();
+                    auto gyro = fs.first(RS2_STREAM_GYRO).as<rs2::motion_frame>();
+                    output.push_back({ accel.get_timestamp(), gyro.get_timestamp(), accel.get_motion_data(), gyro.get_motion_data(),
+                        fs.size() == 2 && accel.get_profile().fps() == gyro.get_profile().fps() });
+                }
+            };
+
+            // Accel every 4ms and gyro every 2.5ms, both linear in time so that the interpolation is exact
+            std::vector<std::array<float, 3>> samples;
+            samples.reserve(100);
+            for (int accel = 0, gyro = 0; accel <= 25 || gyro <= 40;)
+            {
+                auto is_accel = accel <= 25 && accel * 4.0 <= gyro * 2.5;
+                double t = is_accel ? accel * 4.0 : gyro * 2.5;
+                samples.push_back(is_accel ? std::array<float, 3>{ float(t), 1.f, -float(t) } : std::array<float, 3>{ 2 * float(t), 0.f, 0.f });
+                fuse(is_accel ? accel_stream.push(samples.back().data(), accel++, t) : gyro_stream.push(samples.back().data(), gyro++, t));
+            }
+
+            // The output starts and ends where both streams have samples, at 0 and 100ms
+            auto period = rate > 0.f ? 5.0 : 2.5;
+            REQUIRE(output.size() == size_t(100.0 / period) + 1);
+            for (size_t i = 0; i < output.size(); ++i)
+            {
+                auto expected = i * period;
+                auto&& o = output[i];
+                REQUIRE(o.same_fps);
+                REQUIRE(o.accel_time == Approx(expected));
+                REQUIRE(o.gyro_time == Approx(expected));
+                REQUIRE(o.accel.x == Approx(expected));
+                REQUIRE(o.accel.y == Approx(1.f));
+                REQUIRE(o.accel.z == Approx(-expected));
+                REQUIRE(o.gyro.x == Approx(2 * expected));
+            }
+        }
+    }
+}
+
 bool is_subset(rs2::frameset full, rs2::frameset sub)
 {
     if (!sub.is<rs2::frameset>())
@@ -560,3 +1452,229 @@ TEST_CASE("Post-Processing processing pipe", "[post-processing-filters]")
     REQUIRE_THROWS(is_subset(full_pipe, original));
     pipe.stop();
 }
+
+TEST_CASE("Processing graph pipelines its stages", "[software-device][post-processing-filters]")
+{
+    rs2::context ctx;
+
+    if (make_context(SECTION_FROM_TEST_NAME, &ctx))
+    {
+        const int width = 16, height = 16, frames = 12, stages = 3;
+        software_stream input(z16_stream({ width, height, 8.f, 8.f, 10.f, 10.f, RS2_DISTORTION_NONE, { 0,0,0,0,0 } }), frames);
+        std::vector<uint16_t> pixels(width * height);
+        for (int i = 1; i <= frames; ++i)
+            input.inject(pixels.data(), i, i);
+
+        // Every stage takes 20ms, a serial chain would need stages * frames * 20ms
+        std::vector<rs2::processing_block> blocks;
+        for (int s = 0; s < stages; ++s)
+        {
+            blocks.emplace_back([](rs2::frame f, const rs2::frame_source& source)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                source.frame_ready(f);
+            });
+        }
+
+        rs2::processing_graph graph(frames);
+        std::vector<int> nodes;
+        for (auto&& b : blocks)
+            nodes.push_back(graph.add(b));
+        for (int s = 1; s < stages; ++s)
+            graph.connect(nodes[s - 1], nodes[s]);
+        REQUIRE_THROWS(graph.connect(nodes.back(), nodes.front()));
+
+        rs2::frame_queue output(frames);
+        graph.start(output);
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 1; i <= frames; ++i)
+            graph.invoke(input.queue.wait_for_frame());
+
+        for (int i = 1; i <= frames; ++i)
+        {
+            rs2::frame f;
+            REQUIRE_NOTHROW(f = output.wait_for_frame());
+            REQUIRE(f.get_frame_number() == i);
+        }
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        REQUIRE(elapsed < std::chrono::milliseconds(stages * frames * 20 * 3 / 4));
+        graph.stop();
+
+        for (auto node : nodes)
+        {
+            auto stats = graph.get_stats(node);
+            REQUIRE(stats.frames == frames);
+            REQUIRE(stats.dropped == 0);
+            REQUIRE(stats.average_latency_ms >= 15.f);
+        }
+    }
+}
+
+// Throughput of the processed frames, compared to the baselines stored in the test data folder (from unit-tests/resources).
+// A configuration fails when it runs slower than its baseline by more than LRS_PERF_THRESHOLD percent, 10 by default.
+// With LRS_PERF_UPDATE_BASELINE set the measurements replace the baselines instead
+class perf_baselines
+{
+public:
+    perf_baselines() : _path(get_folder_path(special_folder::temp_folder) + "ppf_performance_baseline.csv"), _threshold(10.)
+    {
+        if (auto threshold = getenv("LRS_PERF_THRESHOLD"))
+            _threshold = atof(threshold);
+        _update = getenv("LRS_PERF_UPDATE_BASELINE") != nullptr;
+
+        std::ifstream in(_path);
+        std::string line;
+        while (std::getline(in, line))
+        {
+            auto comma = line.rfind(',');
+            if (line.empty() || line[0] == '#' || comma == std::string::npos)
+                continue;
+            _fps[line.substr(0, comma)] = atof(line.substr(comma + 1).c_str());
+        }
+    }
+
+    ~perf_baselines()
+    {
+        if (!_update)
+            return;
+        std::ofstream out(_path);
+        out << "# Frames per second of the post-processing throughput tests, by test name" << std::endl;
+        for (auto&& b : _fps)
+            out << b.first << "," << b.second << std::endl;
+    }
+
+    void check(const std::string& name, double fps)
+    {
+        auto it = _fps.find(name);
+        if (_update || it == _fps.end())
+        {
+            WARN(name << ": " << fps << " fps" << (_update ? "" : ", no baseline"));
+            _fps[name] = fps;
+            return;
+        }
+
+        CAPTURE(name);
+        CAPTURE(fps);
+        CAPTURE(it->second);
+        REQUIRE(fps >= it->second * (1. - _threshold / 100.));
+    }
+
+private:
+    std::string _path;
+    double _threshold;
+    bool _update;
+    std::map<std::string, double> _fps;
+};
+
+// Runs f until it has run for a second and at least 30 times, returns the calls per second
+template<class F>
+double measure_fps(F f)
+{
+    const auto min_duration = std::chrono::seconds(1);
+    const int min_calls = 30;
+
+    f(); // warm-up, the first call allocates the buffers of the blocks
+    int calls = 0;
+    auto start = std::chrono::steady_clock::now();
+    auto elapsed = std::chrono::steady_clock::duration::zero();
+    while (calls < min_calls || elapsed < min_duration)
+    {
+        f();
+        ++calls;
+        elapsed = std::chrono::steady_clock::now() - start;
+    }
+    return calls / std::chrono::duration<double>(elapsed).count();
+}
+
+TEST_CASE("Post-Processing Filters throughput", "[software-device][post-processing-filters][performance][.]")
+{
+    rs2::context ctx;
+    if (!make_context(SECTION_FROM_TEST_NAME, &ctx))
+        return;
+
+    perf_baselines baselines;
+    ppf_test_config test_cfg;
+    for (auto& ppf_test : ppf_test_cases)
+    {
+        CAPTURE(ppf_test.first);
+        if (!load_test_configuration(ppf_test.first, test_cfg))
+            continue;
+
+        post_processing_filters ppf;
+        REQUIRE_NOTHROW(ppf.configure(test_cfg));
+
+        int width = test_cfg.input_res_x;
+        int height = test_cfg.input_res_y;
+        software_stream stream(z16_stream({ width, height, width / 2.f, height / 2.f,
+            test_cfg.focal_length, test_cfg.focal_length, RS2_DISTORTION_BROWN_CONRADY, { 0,0,0,0,0 } }));
+        stream.sensor.set_read_only_option(RS2_OPTION_DEPTH_UNITS, test_cfg.depth_units);
+        stream.sensor.add_read_only_option(RS2_OPTION_STEREO_BASELINE, test_cfg.stereo_baseline);
+
+        // The recorded sequence is fed in a loop, as fast as the filters take it
+        int frame_number = 0;
+        auto fps = measure_fps([&]()
+        {
+            auto i = frame_number % test_cfg._input_frames.size();
+            ++frame_number;
+            auto filtered = ppf.process(stream.push(test_cfg._input_frames[i].data(), frame_number));
+            REQUIRE(filtered);
+        });
+        baselines.check("ppf/" + ppf_test.second, fps);
+    }
+}
+
+TEST_CASE("Align and pointcloud throughput from recording", "[software-device][post-processing-filters][performance][.]")
+{
+    rs2::context ctx;
+    if (!make_context(SECTION_FROM_TEST_NAME, &ctx, "2.13.0"))
+        return;
+
+    std::string folder_name = get_folder_path(special_folder::temp_folder);
+    const std::string filename = folder_name + "single_depth_color_640x480.bag";
+    REQUIRE(file_exists(filename));
+    auto dev = ctx.load_device(filename);
+    dev.as<rs2::playback>().set_real_time(false);
+
+    // A depth and color pair from the recording, processed again and again
+    rs2::syncer sync;
+    for (auto s : dev.query_sensors())
+    {
+        REQUIRE_NOTHROW(s.open(s.get_stream_profiles().front()));
+        REQUIRE_NOTHROW(s.start(sync));
+    }
+    rs2::frame depth, color;
+    for (int i = 0; i < 100 && !(depth && color); i++)
+    {
+        rs2::frameset frames;
+        if (!sync.try_wait_for_frames(&frames, 1000))
+            break;
+        if (auto d = frames.get_depth_frame()) depth = d;
+        if (auto c = frames.get_color_frame()) color = c;
+    }
+    REQUIRE(depth);
+    REQUIRE(color);
+    for (auto s : dev.query_sensors())
+    {
+        s.stop();
+        s.close();
+    }
+
+    perf_baselines baselines;
+    std::vector<rs2::frame> inputs = { depth, color };
+    rs2::processing_block combine([&](rs2::frame, rs2::frame_source& source) { source.frame_ready(source.allocate_composite_frame(inputs)); });
+    rs2::frame_queue pairs(1);
+    combine.start(pairs);
+    combine.invoke(depth);
+    rs2::frameset frames = pairs.wait_for_frame();
+    REQUIRE(frames.size() == 2);
+
+    rs2::align to_color(RS2_STREAM_COLOR);
+    rs2::align to_depth(RS2_STREAM_DEPTH);
+    rs2::pointcloud pc;
+
+    baselines.check("align/depth_to_color", measure_fps([&]() { REQUIRE(to_color.process(frames)); }));
+    baselines.check("align/color_to_depth", measure_fps([&]() { REQUIRE(to_depth.process(frames)); }));
+    baselines.check("pointcloud/calculate", measure_fps([&]() { REQUIRE(pc.calculate(depth)); }));
+    pc.map_to(color);
+    baselines.check("pointcloud/calculate_textured", measure_fps([&]() { REQUIRE(pc.calculate(depth)); }));
+}
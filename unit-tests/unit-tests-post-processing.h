@@ -385,3 +385,83 @@ inline bool profile_diffs(const std::string& plot_name, std::vector<T>& distance
 
     return ((fabs(max_val) <= outlier) && (standard_deviation <= max_allowed_std));
 }
+
+// The Z16 stream of a depth sensor in millimeters, by default a small pinhole one
+inline rs2_video_stream z16_stream(rs2_intrinsics intrinsics = { 64, 48, 32.f, 24.f, 40.f, 40.f, RS2_DISTORTION_NONE, { 0,0,0,0,0 } })
+{
+    return { RS2_STREAM_DEPTH, 0, 0, intrinsics.width, intrinsics.height, 30, 2, RS2_FORMAT_Z16, intrinsics };
+}
+
+// A sensor of a software device streaming a single profile into a queue, the input of the processing blocks under test
+struct software_stream
+{
+    rs2::software_device dev;
+    rs2::software_sensor sensor;
+    rs2::stream_profile profile;
+    rs2::frame_queue queue;
+
+    explicit software_stream(rs2_video_stream stream = z16_stream(), unsigned int capacity = 1)
+        : sensor(dev.add_sensor(rs2_stream_to_string(stream.type))),
+          profile(sensor.add_video_stream(stream)),
+          queue(capacity),
+          _bpp(stream.bpp), _stride(stream.width * stream.bpp)
+    {
+        if (stream.fmt == RS2_FORMAT_Z16)
+            sensor.add_read_only_option(RS2_OPTION_DEPTH_UNITS, 0.001f);
+        start();
+    }
+
+    explicit software_stream(rs2_motion_stream stream, unsigned int capacity = 1)
+        : sensor(dev.add_sensor(rs2_stream_to_string(stream.type))),
+          profile(sensor.add_motion_stream(stream)),
+          queue(capacity),
+          _bpp(0), _stride(0)
+    {
+        start();
+    }
+
+    // Injects the pixels, or the motion sample, as the frame 'number' without waiting for it
+    void inject(const void* data, int number, double timestamp)
+    {
+        if (_stride)
+            sensor.on_video_frame({ const_cast<void*>(data), [](void*) {}, _stride, _bpp, timestamp, RS2_TIMESTAMP_DOMAIN_SYSTEM_TIME, number, profile });
+        else
+            sensor.on_motion_frame({ const_cast<void*>(data), [](void*) {}, timestamp, RS2_TIMESTAMP_DOMAIN_SYSTEM_TIME, number, profile });
+    }
+
+    // Injects the data and waits for its frame
+    rs2::frame push(const void* data, int number, double timestamp)
+    {
+        inject(data, number, timestamp);
+        rs2::frame f;
+        REQUIRE_NOTHROW(f = queue.wait_for_frame());
+        return f;
+    }
+
+    // The same, timestamped in milliseconds by the frame number
+    rs2::frame push(const void* data, int number = 1)
+    {
+        return push(data, number, number);
+    }
+
+private:
+    void start()
+    {
+        sensor.open(profile);
+        sensor.start(queue);
+    }
+
+    int _bpp, _stride;
+};
+
+// Runs 'check' with the block on one thread, on several, and on all of the hardware threads
+template<class F>
+void for_each_thread_count(rs2::options& block, F check)
+{
+    for (auto threads : { 1, 4, 0 })
+    {
+        CAPTURE(threads);
+        block.set_option(RS2_OPTION_PROCESSING_THREADS, float(threads));
+        check();
+    }
+}
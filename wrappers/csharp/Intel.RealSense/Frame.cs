@@ -7,6 +7,8 @@ namespace Intel.RealSense
     public class Frame : IDisposable
     {
         internal HandleRef m_instance;
+        // Incremented each time the pool hands the object out again, so that stale references can be told apart
+        internal uint m_generation;
         public static readonly FramePool<Frame> Pool = new FramePool<Frame>(ptr => new Frame(ptr));
 
         public IntPtr NativePtr { get { return m_instance.Handle; } }
@@ -67,8 +69,10 @@ namespace Intel.RealSense
 
         public virtual void Release()
         {
-            if (m_instance.Handle != IntPtr.Zero)
-                NativeMethods.rs2_release_frame(m_instance.Handle);
+            // Only frames that held a native frame go back to the pool, a second release must not pool them twice
+            if (m_instance.Handle == IntPtr.Zero)
+                return;
+            NativeMethods.rs2_release_frame(m_instance.Handle);
             m_instance = new HandleRef(this, IntPtr.Zero);
             Pool.Release(this);
         }
@@ -244,8 +248,9 @@ namespace Intel.RealSense
         public override void Release()
         {
             //base.Release();
-            if (m_instance.Handle != IntPtr.Zero)
-                NativeMethods.rs2_release_frame(m_instance.Handle);
+            if (m_instance.Handle == IntPtr.Zero)
+                return;
+            NativeMethods.rs2_release_frame(m_instance.Handle);
             m_instance = new HandleRef(this, IntPtr.Zero);
             Pool.Release(this);
         }
@@ -268,8 +273,9 @@ namespace Intel.RealSense
         public override void Release()
         {
             //base.Release();
-            if (m_instance.Handle != IntPtr.Zero)
-                NativeMethods.rs2_release_frame(m_instance.Handle);
+            if (m_instance.Handle == IntPtr.Zero)
+                return;
+            NativeMethods.rs2_release_frame(m_instance.Handle);
             m_instance = new HandleRef(this, IntPtr.Zero);
             Pool.Release(this);
         }
@@ -367,8 +373,9 @@ namespace Intel.RealSense
         public override void Release()
         {
             //base.Release();
-            if (m_instance.Handle != IntPtr.Zero)
-                NativeMethods.rs2_release_frame(m_instance.Handle);
+            if (m_instance.Handle == IntPtr.Zero)
+                return;
+            NativeMethods.rs2_release_frame(m_instance.Handle);
             m_instance = new HandleRef(this, IntPtr.Zero);
             Pool.Release(this);
         }
@@ -395,6 +402,9 @@ namespace Intel.RealSense
                 T f = stack.Pop();
                 f.m_instance = new HandleRef(f, ptr);
                 f.disposedValue = false;
+                f.m_generation++;
+                // Pooled frames don't run their finalizer, the frames handed out release their native frame again
+                GC.ReRegisterForFinalize(f);
                 //NativeMethods.rs2_keep_frame(ptr);
                 return f;
             }
@@ -402,6 +412,7 @@ namespace Intel.RealSense
 
         public void Release(T t)
         {
+            GC.SuppressFinalize(t);
             lock (locker)
             {
                 stack.Push(t);
@@ -175,6 +175,7 @@ namespace Intel.RealSense
                 // TODO: set large fields to null.
 
                 disposables.ForEach(d => d?.Dispose());
+                ReleaseEnumerated();
 
                 Release();
 
@@ -201,8 +202,9 @@ namespace Intel.RealSense
 
         public void Release()
         {
-            if (m_instance.Handle != IntPtr.Zero)
-                NativeMethods.rs2_release_frame(m_instance.Handle);
+            if (m_instance.Handle == IntPtr.Zero)
+                return;
+            NativeMethods.rs2_release_frame(m_instance.Handle);
             m_instance = new HandleRef(this, IntPtr.Zero);
             Pool.Release(this);
         }
@@ -212,6 +214,24 @@ namespace Intel.RealSense
         {
             disposables.Add(disposable);
         }
+
+        // The frames handed out by the enumerator are released with the set, instead of waiting for their finalizer.
+        // Frames disposed and recycled by the pool meanwhile are recognized by their generation and left alone
+        internal readonly List<KeyValuePair<Frame, uint>> enumerated = new List<KeyValuePair<Frame, uint>>();
+        internal void TrackEnumerated(Frame frame)
+        {
+            enumerated.Add(new KeyValuePair<Frame, uint>(frame, frame.m_generation));
+        }
+
+        internal void ReleaseEnumerated()
+        {
+            foreach (var e in enumerated)
+            {
+                if (e.Key.m_generation == e.Value && !e.Key.disposedValue)
+                    e.Key.Dispose();
+            }
+            enumerated.Clear();
+        }
     }
 
     public static class FrameSetExtensions {
@@ -239,6 +259,8 @@ namespace Intel.RealSense
                     f.m_enum.Reset();
                     //f.m_disposable = new EmptyDisposable();
                     f.disposables.Clear();
+                    f.enumerated.Clear();
+                    GC.ReRegisterForFinalize(f);
                     return f;
                 }
                 else
@@ -251,6 +273,7 @@ namespace Intel.RealSense
 
         public void Release(FrameSet t)
         {
+            GC.SuppressFinalize(t);
             lock (locker)
             {
                 stack.Push(t);
@@ -303,6 +326,7 @@ namespace Intel.RealSense
                 object error;
                 var ptr = NativeMethods.rs2_extract_frame(fs.m_instance.Handle, index, out error);
                 current = Frame.CreateFrame(ptr);
+                fs.TrackEnumerated(current);
                 index++;
                 return true;
             }
@@ -5,6 +5,8 @@
 #include <memory>
 #include <vector>
 #include <array>
+#include <algorithm>
+#include <cstring>
 #include <type_traits>
 
 namespace std
@@ -168,6 +170,11 @@ namespace MatlabParamParser
     template <typename T> static typename std::enable_if<!is_basic_type<T>::value && !traits_trampoline::use_cells<T>::value, mxArray*>::type wrap_array(const T* var, size_t length);
     template <typename T> static typename std::enable_if<!is_basic_type<T>::value && traits_trampoline::use_cells<T>::value, mxArray*>::type wrap_array(const T* var, size_t length);
     template <typename T> static typename std::enable_if<is_basic_type<T>::value, mxArray*>::type wrap_array(const T* var, size_t length);
+
+    // Interleaved pixels as a height x width (x channels) array, written directly in MATLAB's column-major layout
+    template <typename T> static mxArray* wrap_image(const T* data, size_t width, size_t height, size_t channels, size_t stride);
+    // Fills the column-major planes of an array from interleaved rows of stride bytes
+    template <typename T> static void deinterleave(T* out, const void* in, size_t width, size_t height, size_t channels, size_t stride);
 };
 
 #include "rs2_type_traits.h"
@@ -332,9 +339,47 @@ template <typename T> static typename std::enable_if<is_basic_type<T>::value, mx
 {
     auto cells = mxCreateNumericMatrix(1, length, MatlabParamParser::mx_wrapper<T>::value::value, mxREAL);
     auto ptr = static_cast<typename mx_wrapper<T>::type*>(mxGetData(cells));
-    for (int x = 0; x < length; ++x)
-        ptr[x] = typename mx_wrapper<T>::type(var[x]);
+    if (std::is_same<T, typename mx_wrapper<T>::type>::value)
+        memcpy(ptr, var, length * sizeof(T));
+    else
+        for (int x = 0; x < length; ++x)
+            ptr[x] = typename mx_wrapper<T>::type(var[x]);
+
+    return cells;
+}
+
+template <typename T> void MatlabParamParser::deinterleave(T* out, const void* in, size_t width, size_t height, size_t channels, size_t stride)
+{
+    // Transposed in tiles that stay in the cache, since the rows are read across and the columns written down
+    const size_t tile = 32;
+    auto rows = static_cast<const uint8_t*>(in);
+    for (size_t y0 = 0; y0 < height; y0 += tile)
+    {
+        auto y1 = std::min(height, y0 + tile);
+        for (size_t x0 = 0; x0 < width; x0 += tile)
+        {
+            auto x1 = std::min(width, x0 + tile);
+            for (size_t c = 0; c < channels; ++c)
+            {
+                for (size_t x = x0; x < x1; ++x)
+                {
+                    auto column = out + (c * width + x) * height;
+                    auto src = rows + (x * channels + c) * sizeof(T);
+                    for (size_t y = y0; y < y1; ++y)
+                        column[y] = *reinterpret_cast<const T*>(src + y * stride);
+                }
+            }
+        }
+    }
+}
 
+template <typename T> mxArray* MatlabParamParser::wrap_image(const T* data, size_t width, size_t height, size_t channels, size_t stride)
+{
+    using wrapper_t = mx_wrapper<T>;
+    static_assert(std::is_same<T, typename wrapper_t::type>::value, "wrap_image expects a type MATLAB stores as is");
+    mwSize dims[] = { height, width, channels };
+    auto cells = mxCreateNumericArray(channels > 1 ? 3 : 2, dims, wrapper_t::value::value, mxREAL);
+    deinterleave(static_cast<T*>(mxGetData(cells)), data, width, height, channels, stride);
     return cells;
 }
 #include "types.h"
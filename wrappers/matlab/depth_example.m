@@ -25,10 +25,8 @@ function depth_example()
     % Colorize depth frame
     color = colorizer.colorize(depth);
 
-    % Get actual data and convert into a format imshow can use
-    % (Color data arrives as [R, G, B, R, G, B, ...] vector)
-    data = color.get_data();
-    img = permute(reshape(data',[3,color.get_width(),color.get_height()]),[3 2 1]);
+    % Get the image as a height x width x 3 array imshow can use
+    img = color.get_image();
 
     % Display image
     imshow(img);
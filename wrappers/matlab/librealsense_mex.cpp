@@ -341,6 +341,32 @@ void make_factory(){
             auto thiz = MatlabParamParser::parse<rs2::video_frame>(inv[0]);
             outv[0] = MatlabParamParser::wrap(thiz.get_bytes_per_pixel());
         });
+        video_frame_factory.record("get_image", 1, 1, [](int outc, mxArray* outv[], int inc, const mxArray* inv[])
+        {
+            auto thiz = MatlabParamParser::parse<rs2::video_frame>(inv[0]);
+            size_t width = thiz.get_width(), height = thiz.get_height(), stride = thiz.get_stride_in_bytes();
+            auto data = thiz.get_data();
+
+            switch (thiz.get_profile().format()) {
+            case RS2_FORMAT_Z16: case RS2_FORMAT_DISPARITY16:
+            case RS2_FORMAT_Y16: case RS2_FORMAT_RAW16:
+                outv[0] = MatlabParamParser::wrap_image(static_cast<const uint16_t*>(data), width, height, 1, stride);
+                break;
+            case RS2_FORMAT_DISPARITY32:
+                outv[0] = MatlabParamParser::wrap_image(static_cast<const float*>(data), width, height, 1, stride);
+                break;
+            case RS2_FORMAT_XYZ32F:
+                outv[0] = MatlabParamParser::wrap_image(static_cast<const float*>(data), width, height, 3, stride);
+                break;
+            case RS2_FORMAT_RAW10:
+                mexWarnMsgTxt("Raw10 data provided as packed unsigned bytes.");
+                outv[0] = MatlabParamParser::wrap_image(static_cast<const uint8_t*>(data), stride, height, 1, stride);
+                break;
+            default:
+                // Every byte of a pixel gets its own channel, such as the 3 of RGB8 and BGR8 or the 4 of RGBA8
+                outv[0] = MatlabParamParser::wrap_image(static_cast<const uint8_t*>(data), width, height, thiz.get_bytes_per_pixel(), stride);
+            }
+        });
         factory->record(video_frame_factory);
     }
     {
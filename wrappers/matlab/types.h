@@ -218,23 +218,15 @@ template <> mxArray* MatlabParamParser::wrap_array<rs2::vertex>(const rs2::verte
 {
     using wrapper_t = mx_wrapper<float>;
     auto cells = mxCreateNumericMatrix(length, 3, wrapper_t::value::value, mxREAL);
-    auto ptr = static_cast<typename wrapper_t::type*>(mxGetData(cells));
-    for (int x = 0; x < length; ++x) {
-        ptr[0 * length + x] = wrapper_t::type(var[x].x);
-        ptr[1 * length + x] = wrapper_t::type(var[x].y);
-        ptr[2 * length + x] = wrapper_t::type(var[x].z);
-    }
+    // A length x 1 image of 3 channels has the layout of a length x 3 matrix
+    deinterleave(static_cast<float*>(mxGetData(cells)), var, 1, length, 3, sizeof(rs2::vertex));
     return cells;
 }
 template <> mxArray* MatlabParamParser::wrap_array<rs2::texture_coordinate>(const rs2::texture_coordinate* var, size_t length)
 {
     using wrapper_t = mx_wrapper<float>;
     auto cells = mxCreateNumericMatrix(length, 2, wrapper_t::value::value, mxREAL);
-    auto ptr = static_cast<typename wrapper_t::type*>(mxGetData(cells));
-    for (int x = 0; x < length; ++x) {
-        ptr[0 * length + x] = wrapper_t::type(var[x].u);
-        ptr[1 * length + x] = wrapper_t::type(var[x].v);
-    }
+    deinterleave(static_cast<float*>(mxGetData(cells)), var, 1, length, 2, sizeof(rs2::texture_coordinate));
     return cells;
 }
 
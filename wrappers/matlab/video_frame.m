@@ -24,5 +24,10 @@ classdef video_frame < realsense.frame
         function bpp = get_bytes_per_pixel(this)
             bpp = realsense.librealsense_mex('rs2::video_frame', 'get_bytes_per_pixel', this.objectHandle);
         end
+        % Pixels as a height x width array, or height x width x channels for formats of several channels
+        % such as RGB8, typed after the format and ready for imshow without reshaping
+        function img = get_image(this)
+            img = realsense.librealsense_mex('rs2::video_frame', 'get_image', this.objectHandle);
+        end
     end
 end
\ No newline at end of file
@@ -5764,6 +5764,12 @@ const timestamp_domain = {
    * to the OS system clock <br>Equivalent to its uppercase counterpart.
    */
   timestamp_domain_system_time: 'system-time',
+  /**
+   * String literal of <code>'global-time'</code>. <br>Frame timestamp was measured in relation
+   * to the camera clock and mapped onto the OS system clock <br>Equivalent to its uppercase
+   * counterpart.
+   */
+  timestamp_domain_global_time: 'global-time',
 
   /**
    * Frame timestamp was measured in relation to the camera clock <br>Equivalent to its lowercase
@@ -5777,6 +5783,12 @@ const timestamp_domain = {
    * @type {Integer}
    */
   TIMESTAMP_DOMAIN_SYSTEM_TIME: RS2.RS2_TIMESTAMP_DOMAIN_SYSTEM_TIME,
+  /**
+   * Frame timestamp was measured in relation to the camera clock and mapped onto the OS system
+   * clock <br>Equivalent to its lowercase counterpart.
+   * @type {Integer}
+   */
+  TIMESTAMP_DOMAIN_GLOBAL_TIME: RS2.RS2_TIMESTAMP_DOMAIN_GLOBAL_TIME,
   /**
    * Number of enumeration values. Not a valid input: intended to be used in for-loops.
    * @type {Integer}
@@ -5796,6 +5808,8 @@ const timestamp_domain = {
         return this.timestamp_domain_hardware_clock;
       case this.TIMESTAMP_DOMAIN_SYSTEM_TIME:
         return this.timestamp_domain_system_time;
+      case this.TIMESTAMP_DOMAIN_GLOBAL_TIME:
+        return this.timestamp_domain_global_time;
       default:
         throw new TypeError('timestamp_domain.timestampDomainToString() expects a valid value as the 1st argument'); // eslint-disable-line
     }
@@ -627,6 +627,49 @@ class RSStreamProfile : public Nan::ObjectWrap {
 Nan::Persistent<v8::Function> RSStreamProfile::constructor_;
 
 ///////////////////////////////////////////////////////////////////////////////
+// Array buffer referencing the memory of a frame without copying it. The
+// buffer holds a reference of the frame, released once V8 collects the buffer
+class FrameMemoryReference {
+ public:
+  static v8::Local<v8::ArrayBuffer> NewArrayBuffer(rs2_frame* frame,
+      void* data, size_t length) {
+    rs2_error* error = nullptr;
+    rs2_frame_add_ref(frame, &error);
+    if (error) {
+      rs2_free_error(error);
+      return v8::ArrayBuffer::New(v8::Isolate::GetCurrent(), 0);
+    }
+
+    auto array_buffer = v8::ArrayBuffer::New(v8::Isolate::GetCurrent(), data,
+        length, v8::ArrayBufferCreationMode::kExternalized);
+    auto reference = new FrameMemoryReference(frame, length);
+    reference->handle_.Reset(array_buffer);
+    reference->handle_.SetWeak(reference, Release,
+        Nan::WeakCallbackType::kParameter);
+    // Tells the collector about the memory held, so that the frames are
+    // returned at a steady pace
+    Nan::AdjustExternalMemory(static_cast<int>(length));
+    return array_buffer;
+  }
+
+ private:
+  FrameMemoryReference(rs2_frame* frame, size_t length)
+      : frame_(frame), length_(length) {}
+
+  static void Release(
+      const Nan::WeakCallbackInfo<FrameMemoryReference>& info) {
+    auto reference = info.GetParameter();
+    reference->handle_.Reset();
+    rs2_release_frame(reference->frame_);
+    Nan::AdjustExternalMemory(-static_cast<int>(reference->length_));
+    delete reference;
+  }
+
+  rs2_frame* frame_;
+  size_t length_;
+  Nan::Persistent<v8::ArrayBuffer> handle_;
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////
 //                                                                           //
@@ -836,10 +879,8 @@ class RSFrame : public Nan::ObjectWrap {
     const auto height = GetNativeResult<int>(rs2_get_frame_height, &me->error_,
         me->frame_, &me->error_);
     const auto length = stride * height;
-    auto array_buffer = v8::ArrayBuffer::New(
-        v8::Isolate::GetCurrent(),
-        static_cast<uint8_t*>(const_cast<void*>(buffer)), length,
-        v8::ArrayBufferCreationMode::kExternalized);
+    auto array_buffer = FrameMemoryReference::NewArrayBuffer(me->frame_,
+        const_cast<void*>(buffer), length);
     info.GetReturnValue().Set(array_buffer);
   }
 
@@ -1056,16 +1097,11 @@ class RSFrame : public Nan::ObjectWrap {
         &me->error_, me->frame_, &me->error_);
     if (!vertices || !count) return;
 
-    uint32_t step = 3 * sizeof(float);
-    uint32_t len = count * step;
-    auto vertex_buf = static_cast<uint8_t*>(malloc(len));
-
-    for (size_t i = 0; i < count; i++) {
-      memcpy(vertex_buf+i*step, vertices[i].xyz, step);
-    }
-    auto array_buffer = v8::ArrayBuffer::New(
-        v8::Isolate::GetCurrent(), vertex_buf, len,
-        v8::ArrayBufferCreationMode::kInternalized);
+    // The vertices are packed, viewed in place
+    static_assert(sizeof(rs2_vertex) == 3 * sizeof(float),
+        "rs2_vertex must be packed");
+    auto array_buffer = FrameMemoryReference::NewArrayBuffer(me->frame_,
+        vertices, count * sizeof(rs2_vertex));
 
     info.GetReturnValue().Set(v8::Float32Array::New(array_buffer, 0, 3*count));
   }
@@ -1111,10 +1147,7 @@ class RSFrame : public Nan::ObjectWrap {
     if (array_buffer->ByteLength() < length) return;
 
     auto contents = array_buffer->GetContents();
-    uint8_t* vertex_buf = static_cast<uint8_t*>(contents.Data());
-    for (size_t i = 0; i < count; i++) {
-      memcpy(vertex_buf+i*step, vertBuf[i].xyz, step);
-    }
+    memcpy(contents.Data(), vertBuf, length);
     info.GetReturnValue().Set(Nan::True());
   }
 
@@ -1130,16 +1163,10 @@ class RSFrame : public Nan::ObjectWrap {
         &me->error_, me->frame_, &me->error_);
     if (!coords || !count) return;
 
-    uint32_t step = 2 * sizeof(int);
-    uint32_t len = count * step;
-    auto texcoord_buf = static_cast<uint8_t*>(malloc(len));
-
-    for (size_t i = 0; i < count; ++i) {
-      memcpy(texcoord_buf + i * step, coords[i].ij, step);
-    }
-    auto array_buffer = v8::ArrayBuffer::New(
-        v8::Isolate::GetCurrent(), texcoord_buf, len,
-        v8::ArrayBufferCreationMode::kInternalized);
+    static_assert(sizeof(rs2_pixel) == 2 * sizeof(int),
+        "rs2_pixel must be packed");
+    auto array_buffer = FrameMemoryReference::NewArrayBuffer(me->frame_,
+        coords, count * sizeof(rs2_pixel));
 
     info.GetReturnValue().Set(v8::Int32Array::New(array_buffer, 0, 2*count));
   }
@@ -1161,10 +1188,7 @@ class RSFrame : public Nan::ObjectWrap {
     if (array_buffer->ByteLength() < length) return;
 
     auto contents = array_buffer->GetContents();
-    uint8_t* texcoord_buf = static_cast<uint8_t*>(contents.Data());
-    for (size_t i = 0; i < count; ++i) {
-      memcpy(texcoord_buf + i * step, coords[i].ij, step);
-    }
+    memcpy(contents.Data(), coords, length);
     info.GetReturnValue().Set(Nan::True());
   }
 
@@ -4718,6 +4742,7 @@ void InitModule(v8::Local<v8::Object> exports) {
   // rs2_timestamp_domain
   _FORCE_SET_ENUM(RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK);
   _FORCE_SET_ENUM(RS2_TIMESTAMP_DOMAIN_SYSTEM_TIME);
+  _FORCE_SET_ENUM(RS2_TIMESTAMP_DOMAIN_GLOBAL_TIME);
   _FORCE_SET_ENUM(RS2_TIMESTAMP_DOMAIN_COUNT);
 
   // rs2_recording_mode
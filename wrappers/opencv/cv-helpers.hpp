@@ -7,6 +7,116 @@
 #include <opencv2/opencv.hpp>   // Include OpenCV API
 #include <exception>
 
+namespace rs2
+{
+    // Allocator of the matrices sharing the memory of a frame. The frame is held by the UMatData of the
+    // matrix, so it stays alive as long as any copy of the matrix, ROI or UMat mapped from it does
+    class frame_mat_allocator : public cv::MatAllocator
+    {
+    public:
+#if CV_VERSION_MAJOR >= 4
+        typedef cv::AccessFlag access_flags;
+#else
+        typedef int access_flags;
+#endif
+
+        cv::UMatData* wrap(const rs2::frame& f, size_t size) const
+        {
+            auto u = new cv::UMatData(this);
+            u->data = u->origdata = (uchar*)f.get_data();
+            u->size = size;
+            u->userdata = new rs2::frame(f);
+            return u;
+        }
+
+        // Matrices created or reallocated through this allocator own their memory, like any other
+        cv::UMatData* allocate(int dims, const int* sizes, int type, void* data, size_t* step,
+            access_flags flags, cv::UMatUsageFlags usage) const override
+        {
+            return cv::Mat::getStdAllocator()->allocate(dims, sizes, type, data, step, flags, usage);
+        }
+
+        bool allocate(cv::UMatData* u, access_flags flags, cv::UMatUsageFlags usage) const override
+        {
+            return cv::Mat::getStdAllocator()->allocate(u, flags, usage);
+        }
+
+        void deallocate(cv::UMatData* u) const override
+        {
+            if (!u)
+                return;
+            CV_Assert(u->urefcount >= 0);
+            CV_Assert(u->refcount >= 0);
+            if (u->refcount == 0)
+            {
+                delete static_cast<rs2::frame*>(u->userdata);
+                delete u;
+            }
+        }
+
+        static const frame_mat_allocator& instance()
+        {
+            static frame_mat_allocator allocator;
+            return allocator;
+        }
+    };
+
+    inline int mat_type(rs2_format format)
+    {
+        switch (format)
+        {
+        case RS2_FORMAT_Z16:
+        case RS2_FORMAT_Y16:
+        case RS2_FORMAT_RAW16:
+            return CV_16UC1;
+        case RS2_FORMAT_Y8:
+        case RS2_FORMAT_RAW8:
+            return CV_8UC1;
+        case RS2_FORMAT_YUYV:
+        case RS2_FORMAT_UYVY:
+            return CV_8UC2;
+        case RS2_FORMAT_RGB8:
+        case RS2_FORMAT_BGR8:
+            return CV_8UC3;
+        case RS2_FORMAT_RGBA8:
+        case RS2_FORMAT_BGRA8:
+            return CV_8UC4;
+        case RS2_FORMAT_DISPARITY32:
+            return CV_32FC1;
+        case RS2_FORMAT_XYZ32F:
+            return CV_32FC3;
+        default:
+            throw std::runtime_error(std::string("Frame format ") + rs2_format_to_string(format) + " has no matching cv::Mat type");
+        }
+    }
+
+    // Wraps a video frame as a cv::Mat without copying, keeping the frame alive for the lifetime of the matrix.
+    // The pixels keep the channel order of the stream, RGB8 is not swapped to BGR like frame_to_mat does.
+    // The frame memory belongs to the library, the matrix should not be written to
+    inline cv::Mat to_mat(const rs2::frame& f)
+    {
+        auto vf = f.as<rs2::video_frame>();
+        if (!vf)
+            throw std::runtime_error("Only video frames can be wrapped as cv::Mat");
+
+        const int type = mat_type(vf.get_profile().format());
+        const size_t step = vf.get_stride_in_bytes();
+        cv::Mat m(vf.get_height(), vf.get_width(), type, (void*)vf.get_data(), step);
+        m.allocator = &frame_mat_allocator::instance();
+        m.u = frame_mat_allocator::instance().wrap(f, step * vf.get_height());
+        m.addref();
+        return m;
+    }
+
+    // Maps a video frame into a cv::UMat. With OpenCL the device may use the frame memory in place, when its
+    // driver supports host pointers, otherwise the frame is uploaded on first use. Frames of the GPU processing
+    // blocks are read through the host copy, the library does not share their buffers with OpenCL
+    inline cv::UMat to_umat(const rs2::frame& f, frame_mat_allocator::access_flags access = cv::ACCESS_READ)
+    {
+        return to_mat(f).getUMat(access);
+    }
+}
+
 // Convert rs2::frame to cv::Mat
 cv::Mat frame_to_mat(const rs2::frame& f)
 {
@@ -608,6 +608,21 @@ OniFrame* Rs2Device::createOniFrame(rs2_frame* frame, Rs2Stream* stream, Rs2Stre
 		return nullptr;
 	}
 	
+	// OpenNI only hands drivers the buffers of its own frame pool (StreamServices::acquireFrame), so the data is
+	// copied once, and depth is clamped during that copy rather than in a second pass over the buffer
+	if (stream->getOniType() == ONI_SENSOR_DEPTH) // HACK: clamp depth to OpenNI hardcoded max value
+	{
+		NAMED_PROFILER("_copyClampDepth");
+		const uint16_t* src = (const uint16_t*)frameData;
+		uint16_t* dst = (uint16_t*)oniFrame->data;
+		const size_t count = frameSize / sizeof(uint16_t);
+		for (size_t i = 0; i < count; ++i)
+		{
+			const uint16_t depth = src[i];
+			dst[i] = (depth < ONI_MAX_DEPTH) ? depth : (uint16_t)(ONI_MAX_DEPTH - 1);
+		}
+	}
+	else
 	{
 		NAMED_PROFILER("_copyFrameData");
 		memcpy(oniFrame->data, frameData, frameSize);
@@ -620,16 +635,6 @@ void Rs2Device::submitOniFrame(OniFrame* oniFrame, Rs2Stream* stream)
 {
 	SCOPED_PROFILER;
 
-	if (stream->getOniType() == ONI_SENSOR_DEPTH) // HACK: clamp depth to OpenNI hardcoded max value
-	{
-		NAMED_PROFILER("_clampDepth");
-		uint16_t* depth = (uint16_t*)oniFrame->data;
-		for (int i = 0; i < oniFrame->width * oniFrame->height; ++i)
-		{
-			if (*depth >= ONI_MAX_DEPTH) { *depth = ONI_MAX_DEPTH - 1; }
-			++depth;
-		}
-	}
 	{
 		NAMED_PROFILER("StreamServices::raiseNewFrame");
 		stream->raiseNewFrame(oniFrame);
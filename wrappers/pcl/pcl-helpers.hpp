@@ -0,0 +1,119 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include <librealsense2/rs.hpp> // Include RealSense Cross Platform API
+#include <pcl/point_types.h>    // Include PCL point types
+#include <pcl/point_cloud.h>
+
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace rs2
+{
+    namespace pcl_detail
+    {
+        // Runs body(begin, end) over [0, count), split into one contiguous range per thread
+        template<class T>
+        void for_ranges(size_t count, unsigned threads, T body)
+        {
+            threads = std::max(1u, std::min<unsigned>(threads, unsigned(count / 4096) + 1));
+            if (threads == 1)
+            {
+                body(size_t(0), count);
+                return;
+            }
+
+            std::vector<std::thread> workers;
+            const size_t chunk = (count + threads - 1) / threads;
+            for (unsigned t = 1; t < threads; ++t)
+                workers.emplace_back(body, std::min(count, t * chunk), std::min(count, (t + 1) * chunk));
+            body(size_t(0), std::min(count, chunk));
+            for (auto&& w : workers)
+                w.join();
+        }
+
+        inline void init_cloud(const rs2::points& points, uint32_t& width, uint32_t& height, bool& is_dense)
+        {
+            auto sp = points.get_profile().as<rs2::video_stream_profile>();
+            width = static_cast<uint32_t>(sp.width());
+            height = static_cast<uint32_t>(sp.height());
+            is_dense = false;
+        }
+    }
+
+    // Copies the vertices into an organized cloud, resized once and filled over the given number of threads.
+    // Points without depth keep the zero vertex the pointcloud block gives them
+    inline pcl::PointCloud<pcl::PointXYZ>::Ptr to_pcl(const rs2::points& points, unsigned threads = 1)
+    {
+        pcl::PointCloud<pcl::PointXYZ>::Ptr cloud(new pcl::PointCloud<pcl::PointXYZ>);
+        pcl_detail::init_cloud(points, cloud->width, cloud->height, cloud->is_dense);
+        cloud->points.resize(points.size());
+
+        const rs2::vertex* vertices = points.get_vertices();
+        pcl::PointXYZ* out = cloud->points.data();
+        pcl_detail::for_ranges(points.size(), threads, [=](size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; ++i)
+            {
+                out[i].x = vertices[i].x;
+                out[i].y = vertices[i].y;
+                out[i].z = vertices[i].z;
+            }
+        });
+        return cloud;
+    }
+
+    // Same as above, with the color of every point sampled from the texture at its texture coordinates, the nearest
+    // pixel like the pointcloud example does. The texture must be RGB8, BGR8, RGBA8 or BGRA8
+    inline pcl::PointCloud<pcl::PointXYZRGB>::Ptr to_pcl(const rs2::points& points, const rs2::video_frame& texture, unsigned threads = 1)
+    {
+        int r_offset, b_offset;
+        switch (texture.get_profile().format())
+        {
+        case RS2_FORMAT_RGB8:
+        case RS2_FORMAT_RGBA8:
+            r_offset = 0; b_offset = 2; break;
+        case RS2_FORMAT_BGR8:
+        case RS2_FORMAT_BGRA8:
+            r_offset = 2; b_offset = 0; break;
+        default:
+            throw std::runtime_error(std::string("Texture format ") + rs2_format_to_string(texture.get_profile().format()) + " is not supported");
+        }
+
+        pcl::PointCloud<pcl::PointXYZRGB>::Ptr cloud(new pcl::PointCloud<pcl::PointXYZRGB>);
+        pcl_detail::init_cloud(points, cloud->width, cloud->height, cloud->is_dense);
+        cloud->points.resize(points.size());
+
+        const rs2::vertex* vertices = points.get_vertices();
+        const rs2::texture_coordinate* coords = points.get_texture_coordinates();
+        const auto pixels = reinterpret_cast<const uint8_t*>(texture.get_data());
+        const int width = texture.get_width();
+        const int height = texture.get_height();
+        const int bpp = texture.get_bytes_per_pixel();
+        const int stride = texture.get_stride_in_bytes();
+        pcl::PointXYZRGB* out = cloud->points.data();
+
+        pcl_detail::for_ranges(points.size(), threads, [=](size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; ++i)
+            {
+                auto& p = out[i];
+                p.x = vertices[i].x;
+                p.y = vertices[i].y;
+                p.z = vertices[i].z;
+
+                const int x = std::min(std::max(int(coords[i].u * width + .5f), 0), width - 1);
+                const int y = std::min(std::max(int(coords[i].v * height + .5f), 0), height - 1);
+                const uint8_t* pixel = pixels + y * stride + x * bpp;
+                p.r = pixel[r_offset];
+                p.g = pixel[1];
+                p.b = pixel[b_offset];
+            }
+        });
+        return cloud;
+    }
+}
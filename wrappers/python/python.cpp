@@ -23,6 +23,11 @@ Copyright(c) 2017 Intel Corporation. All Rights Reserved. */
 #include "../include/librealsense2/hpp/rs_export.hpp"
 #include "../include/librealsense2/rs_advanced_mode.hpp"
 #include "../include/librealsense2/rsutil.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
 #define NAME pyrealsense2
 #define SNAME "pyrealsense2"
 // hacky little bit of half-functions to make .def(BIND_DOWNCAST) look nice for binding as/is functions
@@ -101,6 +106,162 @@ std::string array_to_string(const T(&arr)[N])
 namespace py = pybind11;
 using namespace pybind11::literals;
 
+// Frame callbacks run on the library threads, and each would take the GIL for every frame. The batcher
+// queues the frames natively instead and hands them to Python in batches from a single delivery thread,
+// either to a callback or to the asyncio futures returned by get_batch_async
+class frame_batcher
+{
+public:
+    frame_batcher(size_t batch_size, unsigned int max_latency_ms, unsigned int capacity)
+        : _queue(capacity), _batch_size(std::max<size_t>(batch_size, 1)), _max_latency(max_latency_ms)
+    {
+        _thread = std::thread([this]() { deliver(); });
+    }
+
+    ~frame_batcher()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stopping = true;
+        }
+        _cv.notify_all();
+
+        // The last reference may be dropped by a library thread, without the GIL
+        py::gil_scoped_acquire gil;
+        {
+            py::gil_scoped_release release;
+            _thread.join();
+        }
+        _callback = py::object();
+        _awaiters.clear();
+    }
+
+    // Called by the library threads, does not take the GIL
+    void enqueue(rs2::frame f) const { _queue.enqueue(std::move(f)); }
+
+    // Waits for the first frame up to the timeout, then for up to batch_size frames within the latency bound.
+    // Returns an empty batch on timeout. Must not be mixed with the callback or the asyncio delivery
+    std::vector<rs2::frame> wait_for_batch(unsigned int timeout_ms) const
+    {
+        std::vector<rs2::frame> batch;
+        rs2::frame f;
+        if (!_queue.try_wait_for_frame(&f, timeout_ms))
+            return batch;
+        batch.push_back(std::move(f));
+
+        auto deadline = std::chrono::steady_clock::now() + _max_latency;
+        while (batch.size() < _batch_size)
+        {
+            rs2::frame next;
+            auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+            auto received = remaining > 0 ? _queue.try_wait_for_frame(&next, static_cast<unsigned int>(remaining)) : _queue.poll_for_frame(&next);
+            if (!received)
+                break;
+            batch.push_back(std::move(next));
+        }
+        return batch;
+    }
+
+    // Must be called with the GIL held, as the methods below
+    void start(py::function callback)
+    {
+        _callback = std::move(callback);
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _has_callback = true;
+        }
+        _cv.notify_all();
+    }
+
+    void stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _has_callback = false;
+        }
+        _callback = py::object();
+    }
+
+    py::object get_batch_async(py::object loop)
+    {
+        auto future = loop.attr("create_future")();
+        _awaiters.emplace_back(loop, future);
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            ++_awaiting;
+        }
+        _cv.notify_all();
+        return future;
+    }
+
+private:
+    void deliver()
+    {
+        while (true)
+        {
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _cv.wait(lock, [this]() { return _stopping || _has_callback || _awaiting > 0; });
+                if (_stopping)
+                    return;
+            }
+
+            auto batch = wait_for_batch(100);
+            if (batch.empty())
+                continue;
+
+            py::gil_scoped_acquire gil;
+            try
+            {
+                auto frames = py::cast(std::move(batch));
+                if (!resolve_awaiter(frames) && _callback)
+                    _callback(frames);
+            }
+            catch (py::error_already_set& e)
+            {
+                e.restore();
+                PyErr_Print();
+            }
+        }
+    }
+
+    // Completes the oldest awaiter that was not cancelled, on its event loop
+    bool resolve_awaiter(const py::object& frames)
+    {
+        while (!_awaiters.empty())
+        {
+            auto awaiter = std::move(_awaiters.front());
+            _awaiters.pop_front();
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                --_awaiting;
+            }
+            if (awaiter.second.attr("done")().cast<bool>())
+                continue;
+
+            awaiter.first.attr("call_soon_threadsafe")(awaiter.second.attr("set_result"), frames);
+            return true;
+        }
+        return false;
+    }
+
+    rs2::frame_queue _queue;
+    size_t _batch_size;
+    std::chrono::milliseconds _max_latency;
+
+    std::mutex _mutex;
+    std::condition_variable _cv;
+    bool _stopping = false;
+    bool _has_callback = false;
+    size_t _awaiting = 0;
+
+    // Only accessed with the GIL held
+    py::object _callback;
+    std::deque<std::pair<py::object, py::object>> _awaiters;
+
+    std::thread _thread;
+};
+
 PYBIND11_MODULE(NAME, m) {
     m.doc() = "Library for accessing Intel RealSenseTM cameras";
 
@@ -312,8 +473,21 @@ PYBIND11_MODULE(NAME, m) {
 
 
     /* rs2_frame.hpp */
+    // Structured views over the frame memory, so that NumPy exposes named fields without copying
+    static const std::string vertex_format = "T{f:x:f:y:f:z:}";
+    static const std::string texture_coordinate_format = "T{f:u:f:v:}";
+    static const std::string pose_format = "T{(3)f:translation:(3)f:velocity:(3)f:acceleration:(4)f:rotation:"
+        "(3)f:angular_velocity:(3)f:angular_acceleration:I:tracker_confidence:I:mapper_confidence:}";
+
     auto get_frame_data = [](const rs2::frame& self) ->  BufData
     {
+        if (auto pf = self.as<rs2::pose_frame>())
+            return BufData(const_cast<void*>(pf.get_data()), sizeof(rs2_pose), pose_format, 1);
+        if (auto mf = self.as<rs2::motion_frame>())
+            return BufData(const_cast<void*>(mf.get_data()), sizeof(float), std::string("@f"), 3);
+        if (auto points = self.as<rs2::points>())
+            return BufData(const_cast<rs2::vertex*>(points.get_vertices()), sizeof(rs2::vertex), vertex_format, points.size());
+
         if (auto vf = self.as<rs2::video_frame>()) {
             std::map<size_t, std::string> bytes_per_pixel_to_format = { { 1, std::string("@B") },{ 2, std::string("@H") },{ 3, std::string("@I") },{ 4, std::string("@I") } };
             switch (vf.get_profile().format()) {
@@ -359,7 +533,9 @@ PYBIND11_MODULE(NAME, m) {
         .def(BIND_DOWNCAST(frame, points))
         .def(BIND_DOWNCAST(frame, frameset))
         .def(BIND_DOWNCAST(frame, video_frame))
-        .def(BIND_DOWNCAST(frame, depth_frame));
+        .def(BIND_DOWNCAST(frame, depth_frame))
+        .def(BIND_DOWNCAST(frame, motion_frame))
+        .def(BIND_DOWNCAST(frame, pose_frame));
 
     py::class_<rs2::video_frame, rs2::frame> video_frame(m, "video_frame");
     video_frame.def(py::init<rs2::frame>())
@@ -393,6 +569,13 @@ PYBIND11_MODULE(NAME, m) {
     motion_frame.def(py::init<rs2::frame>())
         .def("get_motion_data", &rs2::motion_frame::get_motion_data, "Returns motion info of frame.");
 
+    py::class_<rs2::pose_frame, rs2::frame> pose_frame(m, "pose_frame");
+    pose_frame.def(py::init<rs2::frame>())
+        .def("get_pose_data", [](const rs2::pose_frame& self) -> BufData
+        {
+            return BufData(const_cast<void*>(self.get_data()), sizeof(rs2_pose), pose_format, 1);
+        }, "Returns a structured view of the pose of the frame, without copying it.", py::keep_alive<0, 1>());
+
     py::class_<rs2::vertex> vertex(m, "vertex");
     vertex.def_readwrite("x", &rs2::vertex::x)
         .def_readwrite("y", &rs2::vertex::y)
@@ -424,7 +607,7 @@ PYBIND11_MODULE(NAME, m) {
             auto verts = const_cast<rs2::vertex*>(self.get_vertices());
             switch (dims) {
             case 1:
-                return BufData(verts, sizeof(rs2::vertex), "@fff", self.size());
+                return BufData(verts, sizeof(rs2::vertex), vertex_format, self.size());
             case 2:
                 return BufData(verts, sizeof(float), "@f", 3, self.size());
             }
@@ -434,12 +617,12 @@ PYBIND11_MODULE(NAME, m) {
             auto tex = const_cast<rs2::texture_coordinate*>(self.get_texture_coordinates());
             switch (dims) {
             case 1:
-                return BufData(tex, sizeof(rs2::texture_coordinate), "@ff", self.size());
+                return BufData(tex, sizeof(rs2::texture_coordinate), texture_coordinate_format, self.size());
             case 2:
                 return BufData(tex, sizeof(float), "@f", 2, self.size());
             }
         }, py::keep_alive<0, 1>(), "dims"_a=1)
-        .def("export_to_ply", &rs2::points::export_to_ply)
+        .def("export_to_ply", &rs2::points::export_to_ply, "fname"_a, "texture"_a, "with_faces"_a = true)
         .def("size", &rs2::points::size);
 
     py::class_<rs2::frameset, rs2::frame> frameset(m, "composite_frame");
@@ -468,7 +651,7 @@ PYBIND11_MODULE(NAME, m) {
 
     /* rs2_processing.hpp */
     py::class_<rs2::filter_interface> filter_interface(m, "filter_interface");
-    filter_interface.def("process", &rs2::filter_interface::process, "frame"_a);
+    filter_interface.def("process", &rs2::filter_interface::process, "frame"_a, py::call_guard<py::gil_scoped_release>());
 
     // Base class for options interface. Should be used via sensor
     py::class_<rs2::options> options(m, "options");
@@ -501,8 +684,8 @@ PYBIND11_MODULE(NAME, m) {
                     "developers who are not using async APIs.")
                .def(py::init<>())
                .def("enqueue", &rs2::frame_queue::enqueue, "Enqueue a new frame into a queue.", "f"_a)
-               .def("wait_for_frame", [](const rs2::frame_queue& self, unsigned int timeout_ms) { py::gil_scoped_release(); self.wait_for_frame(timeout_ms); }, "Wait until a new frame "
-                    "becomes available in the queue and dequeue it.", "timeout_ms"_a = 5000)
+               .def("wait_for_frame", &rs2::frame_queue::wait_for_frame, "Wait until a new frame "
+                    "becomes available in the queue and dequeue it.", "timeout_ms"_a = 5000, py::call_guard<py::gil_scoped_release>())
                .def("poll_for_frame", [](const rs2::frame_queue &self)
                     {
                         rs2::frame frame;
@@ -514,10 +697,23 @@ PYBIND11_MODULE(NAME, m) {
                         rs2::frame frame;
                         auto success = self.try_wait_for_frame(&frame, timeout_ms);
                         return std::make_tuple(success, frame);
-                    }, "timeout_ms"_a=5000)
+                    }, "timeout_ms"_a=5000, py::call_guard<py::gil_scoped_release>())
                .def("__call__", &rs2::frame_queue::operator())
                .def("capacity", &rs2::frame_queue::capacity);
 
+    py::class_<frame_batcher, std::shared_ptr<frame_batcher>> frame_batcher_py(m, "frame_batcher");
+    frame_batcher_py.def(py::init<size_t, unsigned int, unsigned int>(), "Queue the frames of a sensor or a pipeline "
+                    "natively and deliver them to Python in batches of up to batch_size frames, waiting at most "
+                    "max_latency_ms for a batch to fill.", "batch_size"_a = 1, "max_latency_ms"_a = 10, "capacity"_a = 32)
+                    .def("start", &frame_batcher::start, "Deliver the batches to callback, as lists of frames, "
+                         "from a single thread.", "callback"_a)
+                    .def("stop", &frame_batcher::stop, "Stop delivering the batches to the callback.")
+                    .def("wait_for_batch", &frame_batcher::wait_for_batch, "Wait for the next batch, empty on "
+                         "timeout.", "timeout_ms"_a = 5000, py::call_guard<py::gil_scoped_release>())
+                    .def("get_batch_async", &frame_batcher::get_batch_async, "Return an asyncio future resolved "
+                         "with the next batch on the given event loop.", "loop"_a)
+                    .def("__call__", &frame_batcher::enqueue, "f"_a);
+
     // Not binding frame_processor_callback, templated
     py::class_<rs2::processing_block, rs2::options> processing_block(m, "processing_block");
     processing_block.def("__init__", [](rs2::processing_block &self, std::function<void(rs2::frame, rs2::frame_source&)> processing_function) {
@@ -541,13 +737,13 @@ PYBIND11_MODULE(NAME, m) {
   
     pointcloud.def(py::init<>())
         .def(py::init<rs2_stream, int>(), "stream"_a, "index"_a = 0)
-        .def("calculate", &rs2::pointcloud::calculate, "depth"_a)
+        .def("calculate", &rs2::pointcloud::calculate, "depth"_a, py::call_guard<py::gil_scoped_release>())
         .def("map_to", &rs2::pointcloud::map_to, "mapped"_a);
 
     py::class_<rs2::syncer> syncer(m, "syncer");
     syncer.def(py::init<int>(), "queue_size"_a = 1)
         .def("wait_for_frames", &rs2::syncer::wait_for_frames, "Wait until a coherent set "
-            "of frames becomes available", "timeout_ms"_a = 5000)
+            "of frames becomes available", "timeout_ms"_a = 5000, py::call_guard<py::gil_scoped_release>())
         .def("poll_for_frames", [](const rs2::syncer &self)
         {
             rs2::frameset frames;
@@ -559,18 +755,18 @@ PYBIND11_MODULE(NAME, m) {
             rs2::frameset fs;
             auto success = self.try_wait_for_frames(&fs, timeout_ms);
             return std::make_tuple(success, fs);
-        }, "timeout_ms"_a = 5000);
+        }, "timeout_ms"_a = 5000, py::call_guard<py::gil_scoped_release>());
         /*.def("__call__", &rs2::syncer::operator(), "frame"_a)*/
 
     py::class_<rs2::colorizer, rs2::filter> colorizer(m, "colorizer");
     colorizer.def(py::init<>())
         .def(py::init<float>(), "color_scheme"_a)
-        .def("colorize", &rs2::colorizer::colorize, "depth"_a)
+        .def("colorize", &rs2::colorizer::colorize, "depth"_a, py::call_guard<py::gil_scoped_release>())
         /*.def("__call__", &rs2::colorizer::operator())*/;
 
     py::class_<rs2::align, rs2::filter> align(m, "align");
     align.def(py::init<rs2_stream>(), "align_to"_a)
-        .def("process", (rs2::frameset (rs2::align::*)(rs2::frameset)) &rs2::align::process, "frames"_a);
+        .def("process", (rs2::frameset (rs2::align::*)(rs2::frameset)) &rs2::align::process, "frames"_a, py::call_guard<py::gil_scoped_release>());
 
     py::class_<rs2::decimation_filter, rs2::filter> decimation_filter(m, "decimation_filter");
     decimation_filter.def(py::init<>())
@@ -719,6 +915,11 @@ PYBIND11_MODULE(NAME, m) {
         .def("start", [](const rs2::sensor& self, std::function<void(rs2::frame)> callback)
     { self.start(callback); }, "Start passing frames into user provided callback.", "callback"_a)
         .def("start", [](const rs2::sensor& self, rs2::frame_queue& queue) { self.start(queue); })
+        .def("start", [](const rs2::sensor& self, std::shared_ptr<frame_batcher> batcher)
+    {
+        std::weak_ptr<frame_batcher> weak = batcher;
+        self.start([weak](rs2::frame f) { if (auto b = weak.lock()) b->enqueue(std::move(f)); });
+    }, "Start passing frames into the batcher, which delivers them to Python in batches.", "batcher"_a)
         .def("stop", [](const rs2::sensor& self) { py::gil_scoped_release lock; self.stop(); }, "Stop streaming.")
         .def("get_stream_profiles", &rs2::sensor::get_stream_profiles, "Check if physical sensor is supported.")
         .def_property_readonly("profiles", &rs2::sensor::get_stream_profiles, "Check if physical sensor is supported.")
@@ -745,8 +946,23 @@ PYBIND11_MODULE(NAME, m) {
         .def(py::init([]() { return rs2::pipeline(rs2::context()); }))
         .def("start", (rs2::pipeline_profile(rs2::pipeline::*)(const rs2::config&)) &rs2::pipeline::start, "config")
         .def("start", (rs2::pipeline_profile(rs2::pipeline::*)()) &rs2::pipeline::start)
+        .def("start", [](rs2::pipeline& self, std::function<void(rs2::frame)> callback) { return self.start(callback); }, "callback"_a)
+        .def("start", [](rs2::pipeline& self, const rs2::config& config, std::function<void(rs2::frame)> callback)
+        {
+            return self.start(config, callback);
+        }, "config"_a, "callback"_a)
+        .def("start", [](rs2::pipeline& self, std::shared_ptr<frame_batcher> batcher)
+        {
+            std::weak_ptr<frame_batcher> weak = batcher;
+            return self.start([weak](rs2::frame f) { if (auto b = weak.lock()) b->enqueue(std::move(f)); });
+        }, "batcher"_a)
+        .def("start", [](rs2::pipeline& self, const rs2::config& config, std::shared_ptr<frame_batcher> batcher)
+        {
+            std::weak_ptr<frame_batcher> weak = batcher;
+            return self.start(config, [weak](rs2::frame f) { if (auto b = weak.lock()) b->enqueue(std::move(f)); });
+        }, "config"_a, "batcher"_a)
         .def("stop", &rs2::pipeline::stop)
-        .def("wait_for_frames", &rs2::pipeline::wait_for_frames, "timeout_ms"_a = 5000)
+        .def("wait_for_frames", &rs2::pipeline::wait_for_frames, "timeout_ms"_a = 5000, py::call_guard<py::gil_scoped_release>())
         .def("poll_for_frames", [](const rs2::pipeline &self)
         {
             rs2::frameset frames;
@@ -758,7 +974,7 @@ PYBIND11_MODULE(NAME, m) {
             rs2::frameset fs;
             auto success = self.try_wait_for_frames(&fs, timeout_ms);
             return std::make_tuple(success, fs);
-        }, "timeout_ms"_a = 5000)
+        }, "timeout_ms"_a = 5000, py::call_guard<py::gil_scoped_release>())
         .def("get_active_profile", &rs2::pipeline::get_active_profile);
 
     struct pipeline_wrapper //Workaround to allow python implicit conversion of pipeline to std::shared_ptr<rs2_pipeline>
@@ -2,12 +2,40 @@
 using System;
 using System.Collections;
 using System.Collections.Generic;
+using System.Runtime.InteropServices;
 using System.Threading;
 using UnityEngine;
 using UnityEngine.Events;
 
 public class RsStreamTextureRenderer : MonoBehaviour
 {
+    // The native plugin writing the frames into the texture on the render thread, see wrappers/unity/native
+    private static class NativeTexture
+    {
+        const string dllName = "realsense2-unity";
+
+        [DllImport(dllName)]
+        public static extern int rs_unity_is_supported();
+
+        [DllImport(dllName)]
+        public static extern int rs_unity_create_texture_slot();
+
+        [DllImport(dllName)]
+        public static extern void rs_unity_destroy_texture_slot(int slot);
+
+        [DllImport(dllName)]
+        public static extern void rs_unity_set_texture(int slot, IntPtr texture);
+
+        [DllImport(dllName)]
+        public static extern void rs_unity_push_frame(int slot, IntPtr frame);
+
+        [DllImport(dllName)]
+        public static extern int rs_unity_get_frame_size(int slot, out int width, out int height);
+
+        [DllImport(dllName)]
+        public static extern IntPtr rs_unity_get_render_event_func();
+    }
+
     private static TextureFormat Convert(Format lrsFormat)
     {
         switch (lrsFormat)
@@ -47,6 +75,9 @@ public class RsStreamTextureRenderer : MonoBehaviour
 
     public FilterMode filterMode = FilterMode.Point;
 
+    [Tooltip("Write the frames into the texture on the render thread with the native plugin, when the graphics API supports it")]
+    public bool nativeUpload = true;
+
     protected Texture2D texture;
 
 
@@ -56,6 +87,10 @@ public class RsStreamTextureRenderer : MonoBehaviour
     FrameQueue q;
     Predicate<Frame> matcher;
 
+    // -1 while the frames are uploaded from the main thread
+    int nativeSlot = -1;
+    IntPtr renderEvent;
+
     void Start()
     {
         Source.OnStart += OnStartStreaming;
@@ -64,6 +99,8 @@ public class RsStreamTextureRenderer : MonoBehaviour
 
     void OnDestroy()
     {
+        DestroyNativeSlot();
+
         if (texture != null)
         {
             Destroy(texture);
@@ -79,6 +116,7 @@ public class RsStreamTextureRenderer : MonoBehaviour
     protected void OnStopStreaming()
     {
         Source.OnNewSample -= OnNewSample;
+        DestroyNativeSlot();
         // RsDevice.Instance.OnNewSampleSet -= OnNewSampleSet;
 
         // e.Set();
@@ -102,12 +140,55 @@ public class RsStreamTextureRenderer : MonoBehaviour
 
         matcher = new Predicate<Frame>(Matches);
 
+        if (nativeUpload)
+            CreateNativeSlot();
+
         Source.OnNewSample += OnNewSample;
         // e.Reset();
 
         // RsDevice.Instance.OnNewSampleSet += OnNewSampleSet;
     }
 
+    private void CreateNativeSlot()
+    {
+        // Direct3D has no 24 bit format, Unity converts these textures on the way
+        if (_format == Format.Rgb8)
+            return;
+
+        try
+        {
+            if (NativeTexture.rs_unity_is_supported() == 0)
+            {
+                Debug.LogFormat(this, "Native texture upload is not supported with {0}, uploading from the main thread", SystemInfo.graphicsDeviceType);
+                return;
+            }
+            renderEvent = NativeTexture.rs_unity_get_render_event_func();
+            nativeSlot = NativeTexture.rs_unity_create_texture_slot();
+        }
+        catch (DllNotFoundException)
+        {
+            Debug.Log("The native texture plugin is missing, uploading from the main thread", this);
+        }
+    }
+
+    private void DestroyNativeSlot()
+    {
+        if (nativeSlot < 0)
+            return;
+        NativeTexture.rs_unity_destroy_texture_slot(nativeSlot);
+        nativeSlot = -1;
+    }
+
+    private void Enqueue(Frame f)
+    {
+        // The slot keeps its own reference, the frame is released as usual
+        var slot = nativeSlot;
+        if (slot >= 0)
+            NativeTexture.rs_unity_push_frame(slot, f.NativePtr);
+        else
+            q.Enqueue(f);
+    }
+
     private bool Matches(Frame f)
     {
         using (var p = f.Profile)
@@ -125,7 +206,7 @@ public class RsStreamTextureRenderer : MonoBehaviour
                 using (var f = fs.FirstOrDefault<VideoFrame>(matcher))
                 {
                     if (f != null)
-                        q.Enqueue(f);
+                        Enqueue(f);
                     return;
                 }
             }
@@ -142,7 +223,7 @@ public class RsStreamTextureRenderer : MonoBehaviour
 
             using (frame)
             {
-                q.Enqueue(frame);
+                Enqueue(frame);
             }
         }
         catch (Exception e)
@@ -156,12 +237,31 @@ public class RsStreamTextureRenderer : MonoBehaviour
     bool HasTextureConflict(VideoFrame vf)
     {
         using (var p = vf.Profile)
+            return HasTextureConflict(vf.Width, vf.Height, p.Format);
+    }
+
+    bool HasTextureConflict(int width, int height, Format format)
+    {
+        return !texture ||
+            texture.width != width ||
+            texture.height != height ||
+            Convert(format) != texture.format;
+    }
+
+    void CreateTexture(int width, int height, Format format)
+    {
+        if (texture != null)
         {
-            return !texture ||
-                texture.width != vf.Width ||
-                texture.height != vf.Height ||
-                Convert(p.Format) != texture.format;
+            Destroy(texture);
         }
+
+        texture = new Texture2D(width, height, Convert(format), false, true)
+        {
+            wrapMode = TextureWrapMode.Clamp,
+            filterMode = filterMode
+        };
+
+        textureBinding.Invoke(texture);
     }
 
     protected void Update()
@@ -169,6 +269,12 @@ public class RsStreamTextureRenderer : MonoBehaviour
         // if (e.WaitOne(0, false))
         // return;
 
+        if (nativeSlot >= 0)
+        {
+            UpdateNative();
+            return;
+        }
+
         if (q != null)
         {
             Frame frame;
@@ -178,22 +284,31 @@ public class RsStreamTextureRenderer : MonoBehaviour
         }
     }
 
-    private void ProcessFrame(VideoFrame frame)
+    // Allocates nothing per frame, the upload itself runs on the render thread
+    private void UpdateNative()
     {
-        if (HasTextureConflict(frame))
+        int width, height;
+        if (NativeTexture.rs_unity_get_frame_size(nativeSlot, out width, out height) == 0)
+            return;
+
+        if (HasTextureConflict(width, height, _format))
         {
-            if (texture != null)
-            {
-                Destroy(texture);
-            }
+            NativeTexture.rs_unity_set_texture(nativeSlot, IntPtr.Zero);
+            CreateTexture(width, height, _format);
+            // The native texture exists once the pixels were applied once
+            texture.Apply();
+            NativeTexture.rs_unity_set_texture(nativeSlot, texture.GetNativeTexturePtr());
+        }
 
-            texture = new Texture2D(frame.Width, frame.Height, Convert(frame.Profile.Format), false, true)
-            {
-                wrapMode = TextureWrapMode.Clamp,
-                filterMode = filterMode
-            };
+        GL.IssuePluginEvent(renderEvent, nativeSlot);
+    }
 
-            textureBinding.Invoke(texture);
+    private void ProcessFrame(VideoFrame frame)
+    {
+        if (HasTextureConflict(frame))
+        {
+            using (var p = frame.Profile)
+                CreateTexture(frame.Width, frame.Height, p.Format);
         }
 
         texture.LoadRawTextureData(frame.Data, frame.Stride * frame.Height);
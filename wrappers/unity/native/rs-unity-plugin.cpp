@@ -0,0 +1,224 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+// Native rendering plugin of the Unity wrapper. Frames are handed over from the frame callbacks and written
+// straight into the native texture on Unity's render thread, without a managed copy or a stall of the main loop
+
+#include <librealsense2/rs.h>
+
+#include "IUnityInterface.h"
+#include "IUnityGraphics.h"
+#include "IUnityGraphicsD3D11.h"
+
+#include <d3d11.h>
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+    // A texture fed by a stream. Frames are pushed from any thread and only the newest pending one is kept, while
+    // the render thread uploads the one it took out, so pushing never waits for an upload (double buffering)
+    struct texture_slot
+    {
+        std::mutex mutex;
+        ID3D11Texture2D* texture = nullptr;
+        rs2_frame* pending = nullptr;
+        int width = 0;
+        int height = 0;
+
+        ~texture_slot()
+        {
+            if (pending) rs2_release_frame(pending);
+            if (texture) texture->Release();
+        }
+    };
+
+    IUnityInterfaces* unity_interfaces = nullptr;
+    IUnityGraphics* unity_graphics = nullptr;
+
+    std::mutex device_mutex;
+    ID3D11Device* device = nullptr;
+
+    std::mutex slots_mutex;
+    std::vector<std::shared_ptr<texture_slot>> slots;
+
+    std::shared_ptr<texture_slot> get_slot(int id)
+    {
+        std::lock_guard<std::mutex> lock(slots_mutex);
+        if (id < 0 || id >= static_cast<int>(slots.size()))
+            return nullptr;
+        return slots[id];
+    }
+
+    void UNITY_INTERFACE_API on_graphics_device_event(UnityGfxDeviceEventType type)
+    {
+        std::lock_guard<std::mutex> lock(device_mutex);
+        if (type == kUnityGfxDeviceEventInitialize && unity_graphics->GetRenderer() == kUnityGfxRendererD3D11)
+            device = unity_interfaces->Get<IUnityGraphicsD3D11>()->GetDevice();
+        else if (type == kUnityGfxDeviceEventShutdown)
+            device = nullptr;
+    }
+
+    // Of the formats Unity creates for the textures of the wrapper, 0 for the others
+    int bytes_per_pixel(DXGI_FORMAT format)
+    {
+        switch (format)
+        {
+        case DXGI_FORMAT_R8G8B8A8_UNORM:
+        case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:
+        case DXGI_FORMAT_R8G8B8A8_TYPELESS:
+        case DXGI_FORMAT_B8G8R8A8_UNORM:
+        case DXGI_FORMAT_B8G8R8A8_UNORM_SRGB:
+        case DXGI_FORMAT_B8G8R8A8_TYPELESS:
+        case DXGI_FORMAT_R32_FLOAT:
+            return 4;
+        case DXGI_FORMAT_R16_UNORM:
+        case DXGI_FORMAT_R16_TYPELESS:
+            return 2;
+        case DXGI_FORMAT_A8_UNORM:
+        case DXGI_FORMAT_R8_UNORM:
+            return 1;
+        default:
+            return 0;
+        }
+    }
+
+    void upload(ID3D11Texture2D* texture, rs2_frame* frame)
+    {
+        // Frames that don't match the texture are skipped, the texture is replaced by the main thread meanwhile
+        D3D11_TEXTURE2D_DESC desc;
+        texture->GetDesc(&desc);
+        if (static_cast<int>(desc.Width) != rs2_get_frame_width(frame, nullptr) ||
+            static_cast<int>(desc.Height) != rs2_get_frame_height(frame, nullptr) ||
+            bytes_per_pixel(desc.Format) * 8 != rs2_get_frame_bits_per_pixel(frame, nullptr))
+            return;
+
+        std::lock_guard<std::mutex> lock(device_mutex);
+        if (!device)
+            return;
+        ID3D11DeviceContext* context = nullptr;
+        device->GetImmediateContext(&context);
+        context->UpdateSubresource(texture, 0, nullptr, rs2_get_frame_data(frame, nullptr),
+            rs2_get_frame_stride_in_bytes(frame, nullptr), 0);
+        context->Release();
+    }
+
+    void UNITY_INTERFACE_API on_render_event(int id)
+    {
+        auto slot = get_slot(id);
+        if (!slot)
+            return;
+
+        rs2_frame* frame = nullptr;
+        ID3D11Texture2D* texture = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(slot->mutex);
+            if (!slot->pending || !slot->texture)
+                return;
+            std::swap(frame, slot->pending);
+            texture = slot->texture;
+            texture->AddRef();
+        }
+
+        upload(texture, frame);
+        texture->Release();
+        rs2_release_frame(frame);
+    }
+}
+
+extern "C" void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API UnityPluginLoad(IUnityInterfaces* interfaces)
+{
+    unity_interfaces = interfaces;
+    unity_graphics = interfaces->Get<IUnityGraphics>();
+    unity_graphics->RegisterDeviceEventCallback(on_graphics_device_event);
+    // The device was created before the plugin was loaded
+    on_graphics_device_event(kUnityGfxDeviceEventInitialize);
+}
+
+extern "C" void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API UnityPluginUnload()
+{
+    unity_graphics->UnregisterDeviceEventCallback(on_graphics_device_event);
+    std::lock_guard<std::mutex> lock(slots_mutex);
+    slots.clear();
+}
+
+// Whether frames can be uploaded on the render thread, only with Direct3D 11 for now
+extern "C" int UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API rs_unity_is_supported()
+{
+    std::lock_guard<std::mutex> lock(device_mutex);
+    return device != nullptr;
+}
+
+// The id of a new texture slot, which is also the event id to issue for its uploads
+extern "C" int UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API rs_unity_create_texture_slot()
+{
+    std::lock_guard<std::mutex> lock(slots_mutex);
+    for (size_t i = 0; i < slots.size(); ++i)
+    {
+        if (!slots[i])
+        {
+            slots[i] = std::make_shared<texture_slot>();
+            return static_cast<int>(i);
+        }
+    }
+    slots.push_back(std::make_shared<texture_slot>());
+    return static_cast<int>(slots.size() - 1);
+}
+
+// Frames still in the slot are released, uploads already issued for it are ignored
+extern "C" void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API rs_unity_destroy_texture_slot(int id)
+{
+    std::lock_guard<std::mutex> lock(slots_mutex);
+    if (id >= 0 && id < static_cast<int>(slots.size()))
+        slots[id].reset();
+}
+
+// The native pointer of the texture to write, from Texture.GetNativeTexturePtr, or null to detach it
+extern "C" void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API rs_unity_set_texture(int id, void* texture)
+{
+    if (auto slot = get_slot(id))
+    {
+        auto d3d_texture = static_cast<ID3D11Texture2D*>(texture);
+        if (d3d_texture) d3d_texture->AddRef();
+        std::lock_guard<std::mutex> lock(slot->mutex);
+        std::swap(slot->texture, d3d_texture);
+        if (d3d_texture) d3d_texture->Release();
+    }
+}
+
+// Callable from any thread, the slot keeps its own reference of the frame and replaces a frame not uploaded yet
+extern "C" void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API rs_unity_push_frame(int id, rs2_frame* frame)
+{
+    auto slot = get_slot(id);
+    if (!slot || !frame)
+        return;
+
+    rs2_frame_add_ref(frame, nullptr);
+    auto width = rs2_get_frame_width(frame, nullptr);
+    auto height = rs2_get_frame_height(frame, nullptr);
+    std::lock_guard<std::mutex> lock(slot->mutex);
+    std::swap(slot->pending, frame);
+    slot->width = width;
+    slot->height = height;
+    if (frame) rs2_release_frame(frame);
+}
+
+// The size of the last frame pushed, so the main thread can match the texture to it. 0 before the first frame
+extern "C" int UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API rs_unity_get_frame_size(int id, int* width, int* height)
+{
+    auto slot = get_slot(id);
+    if (!slot)
+        return 0;
+    std::lock_guard<std::mutex> lock(slot->mutex);
+    *width = slot->width;
+    *height = slot->height;
+    return slot->width > 0 && slot->height > 0;
+}
+
+// To pass to GL.IssuePluginEvent or CommandBuffer.IssuePluginEvent with the id of a slot
+extern "C" UnityRenderingEvent UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API rs_unity_get_render_event_func()
+{
+    return on_render_event;
+}
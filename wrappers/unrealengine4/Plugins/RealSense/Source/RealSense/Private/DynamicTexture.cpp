@@ -51,13 +51,13 @@ FDynamicTexture::~FDynamicTexture()
 
 	for (FTextureUpdateData* Tud : TudPool)
 	{
-		if (Tud->Data) FMemory::Free(Tud->Data);
-		FMemory::Free(Tud);
+		if (Tud->Buffer) FMemory::Free(Tud->Buffer);
+		delete Tud;
 	}
 	TudPool.clear();
 }
 
-FTextureUpdateData* FDynamicTexture::AllocBuffer()
+FTextureUpdateData* FDynamicTexture::AllocUpdateData()
 {
 	SCOPED_PROFILER;
 
@@ -72,18 +72,40 @@ FTextureUpdateData* FDynamicTexture::AllocBuffer()
 		}
 	}
 
-	auto Tud = (FTextureUpdateData*)FMemory::Malloc(sizeof(FTextureUpdateData), PLATFORM_CACHE_LINE_SIZE);
+	auto Tud = new FTextureUpdateData();
 	Tud->Context = this;
-	Tud->DataSize = Width * Height * Bpp;
-	Tud->Data = FMemory::Malloc(Tud->DataSize, PLATFORM_CACHE_LINE_SIZE);
-	Tud->Stride = Width * Bpp;
 	Tud->Width = Width;
 	Tud->Height = Height;
 
 	return Tud;
 }
 
-void FDynamicTexture::EnqueUpdateCommand(FTextureUpdateData* Tud)
+void FDynamicTexture::ReleaseUpdateData(FTextureUpdateData* Tud)
+{
+	Tud->Frame = rs2::frame();
+	Tud->Data = nullptr;
+
+	FScopeLock Lock(&TudMx);
+	TudPool.push_back(Tud);
+}
+
+FTextureUpdateData* FDynamicTexture::AllocBuffer()
+{
+	SCOPED_PROFILER;
+
+	auto Tud = AllocUpdateData();
+	if (!Tud->Buffer)
+	{
+		Tud->DataSize = Width * Height * Bpp;
+		Tud->Buffer = FMemory::Malloc(Tud->DataSize, PLATFORM_CACHE_LINE_SIZE);
+	}
+	Tud->Data = Tud->Buffer;
+	Tud->Stride = Width * Bpp;
+
+	return Tud;
+}
+
+bool FDynamicTexture::EnqueUpdateCommand(FTextureUpdateData* Tud)
 {
 	SCOPED_PROFILER;
 
@@ -94,16 +116,21 @@ void FDynamicTexture::EnqueUpdateCommand(FTextureUpdateData* Tud)
 	{
 		REALSENSE_ERR(TEXT("EnqueUpdateCommand: invalid thread"));
 	}
-	else if (TextureObject && TextureObject->Resource)
+	else if (TextureObject && TextureObject->Resource && !IsRenderBehind())
 	{
 		CommandCounter.Increment();
+		PendingUpdates.Increment();
 		ENQUEUE_UNIQUE_RENDER_COMMAND_ONEPARAMETER(
 			UpdateTextureCmd,
 			FTextureUpdateData*, Tud, Tud,
 		{
 			Tud->Context->RenderCmd_UpdateTexture(Tud);
 		});
+		return true;
 	}
+
+	ReleaseUpdateData(Tud);
+	return false;
 }
 
 void FDynamicTexture::Update(const rs2::video_frame& Frame)
@@ -121,29 +148,16 @@ void FDynamicTexture::Update(const rs2::video_frame& Frame)
 		return;
 	}
 
-	auto* Tud = AllocBuffer();
-	CopyData(Tud, Frame);
-	EnqueUpdateCommand(Tud);
-}
-
-void FDynamicTexture::CopyData(FTextureUpdateData* Tud, const rs2::video_frame& Frame)
-{
-	SCOPED_PROFILER;
-
-	const auto fw = Frame.get_width();
-	const auto fh = Frame.get_height();
-	const auto fbpp = Frame.get_bytes_per_pixel();
-	const auto fs = Frame.get_stride_in_bytes();
-
-	uint8_t* Dst = (uint8_t*)Tud->Data;
-	const uint8_t* Src = (const uint8_t*)Frame.get_data();
-
-	for (int y = 0; y < fh; ++y)
+	if (IsRenderBehind())
 	{
-		FMemory::Memcpy(Dst, Src, fw * fbpp);
-		Dst += (fw * fbpp);
-		Src += fs;
+		return;
 	}
+
+	auto* Tud = AllocUpdateData();
+	Tud->Frame = Frame;
+	Tud->Data = Frame.get_data();
+	Tud->Stride = Frame.get_stride_in_bytes();
+	EnqueUpdateCommand(Tud);
 }
 
 void FDynamicTexture::RenderCmd_CreateTexture()
@@ -192,10 +206,7 @@ void FDynamicTexture::RenderCmd_UpdateTexture(FTextureUpdateData* Tud)
 		);
 	}
 
-	{
-		FScopeLock Lock(&TudMx);
-		TudPool.push_back(Tud);
-	}
-
+	ReleaseUpdateData(Tud);
+	PendingUpdates.Decrement();
 	CommandCounter.Decrement();
 }
@@ -2,12 +2,14 @@
 
 struct FTextureUpdateData
 {
-	class FDynamicTexture* Context;
-	void* Data;
-	uint32 DataSize;
-	uint32 Stride;
-	uint32 Width;
-	uint32 Height;
+	class FDynamicTexture* Context = nullptr;
+	rs2::frame Frame; // the source of Data when the frame is uploaded as is, held until the render thread is done
+	void* Buffer = nullptr; // owned, allocated on demand for the pixels written by the caller
+	const void* Data = nullptr;
+	uint32 DataSize = 0;
+	uint32 Stride = 0;
+	uint32 Width = 0;
+	uint32 Height = 0;
 };
 
 class FDynamicTexture
@@ -19,6 +21,7 @@ private:
 
 	std::vector<FTextureUpdateData*> TudPool;
 	FThreadSafeCounter CommandCounter;
+	FThreadSafeCounter PendingUpdates;
 
 	FCriticalSection StateMx;
 	FCriticalSection TudMx;
@@ -31,19 +34,30 @@ private:
 
 private:
 
+	FTextureUpdateData* AllocUpdateData();
+	void ReleaseUpdateData(FTextureUpdateData* Tud);
+
 	void RenderCmd_CreateTexture();
 	void RenderCmd_UpdateTexture(FTextureUpdateData* Tud);
 
 public:
 
+	// Updates queued to the render thread beyond which new frames are dropped, so a render thread running behind
+	// doesn't pile up frames; the texture catches up with the newest frame instead
+	static const int MaxPendingUpdates = 2;
+
 	FDynamicTexture(FString Name, int Width, int Height, EPixelFormat Format, TextureCompressionSettings Compression);
 	virtual ~FDynamicTexture();
 
+	// Update data with a buffer of the size of the texture for the caller to write
 	FTextureUpdateData* AllocBuffer();
-	void EnqueUpdateCommand(FTextureUpdateData* Tud);
+	bool EnqueUpdateCommand(FTextureUpdateData* Tud);
 
+	// Uploads straight from the frame buffer, with its stride, the frame is referenced until the upload is done
 	void Update(const rs2::video_frame& Frame);
-	void CopyData(FTextureUpdateData* Tud, const rs2::video_frame& Frame);
+
+	// Whether frames would be dropped, so their processing can be skipped
+	bool IsRenderBehind() const { return PendingUpdates.GetValue() >= MaxPendingUpdates; }
 
 	inline UTexture2D* GetTextureObject() { return TextureObject; }
 	int GetWidth() const { return Width; }
@@ -244,6 +244,9 @@ void ARealSenseInspector::Stop()
 		RsAlign.Reset();
 		RsPoints.Reset();
 		RsPointCloud.Reset();
+		PclMeshData.Empty();
+		PclRenderPoints = 0;
+		PclNumSections = 0;
 
 		REALSENSE_TRACE(TEXT("Flush rendering commands"));
 		{
@@ -380,11 +383,11 @@ void ARealSenseInspector::ProcessFrameset(rs2::frameset* Frameset)
 			DepthRawDtex->Update(DepthFrame);
 		}
 
-		if (bEnableColorizedDepth && DepthColorizedDtex.Get())
+		if (bEnableColorizedDepth && DepthColorizedDtex.Get() && !DepthColorizedDtex->IsRenderBehind())
 		{
 			NAMED_PROFILER("UpdateDepthColorized");
 			auto* Tud = DepthColorizedDtex->AllocBuffer();
-			rs2_utils::colorize_depth((rs2_utils::depth_pixel*)Tud->Data, DepthFrame, (int)DepthColormap, DepthMin, DepthMax, DepthScale, bEqualizeHistogram);
+			rs2_utils::colorize_depth((rs2_utils::depth_pixel*)Tud->Buffer, DepthFrame, (int)DepthColormap, DepthMin, DepthMax, DepthScale, bEqualizeHistogram);
 			DepthColorizedDtex->EnqueUpdateCommand(Tud);
 		}
 
@@ -417,6 +420,7 @@ void ARealSenseInspector::ProcessFrameset(rs2::frameset* Frameset)
 
 	if (PclScopedMx.IsLocked())
 	{
+		FillPointCloud();
 		PclScopedMx.Unlock();
 		PclFramesetId = FramesetId;
 		PclCalculateFlag = false;
@@ -464,152 +468,133 @@ void ARealSenseInspector::Tick(float DeltaSeconds)
 	}
 }
 
-void ARealSenseInspector::UpdatePointCloud()
+// Runs on the worker under PointCloudMx. The layout of the sections only depends on the number of points and the
+// density, so the indices are written once and only the vertices change from a frame to the next. Invalid points
+// are collapsed quads rather than left out, which would shift the layout
+void ARealSenseInspector::FillPointCloud()
 {
 	SCOPED_PROFILER;
 
 	const size_t NumPoints = RsPoints->size();
 	const size_t DensityPoints = (size_t)FMath::RoundToInt(NumPoints * FMath::Clamp(PclDensity, 0.0f, 1.0f));
-	if (!DensityPoints) { PclMesh->SetVisibility(false); return;  }
+	const size_t Step = DensityPoints ? (size_t)FMath::RoundToInt(NumPoints / (float)DensityPoints) : 0;
+	const size_t RenderPoints = Step ? (NumPoints + Step - 1) / Step : 0;
+	const size_t SectionPoints = MAX_BUFFER_U16 / 6;
+	const size_t NumSections = (RenderPoints + SectionPoints - 1) / SectionPoints;
 
-	const size_t Step = (size_t)FMath::RoundToInt(NumPoints / (float)DensityPoints);
-	if (!Step) { PclMesh->SetVisibility(false); return; }
+	if (RenderPoints != PclRenderPoints)
+	{
+		NAMED_PROFILER("AllocMeshSections");
+		PclMeshData.Empty();
+		for (size_t SectionId = 0; SectionId < NumSections; ++SectionId)
+		{
+			const int32 Points = (int32)FMath::Min(SectionPoints, RenderPoints - SectionId * SectionPoints);
+			auto Section = MakeUnique<FMeshSection>();
+			Section->PclVertices.SetNumUninitialized(Points * 4, false);
+			Section->PclIndices.SetNumUninitialized(Points * 6, false);
+			for (int32 i = 0; i < Points; ++i)
+			{
+				FPointCloudVertex* V = &Section->PclVertices[i * 4];
+				for (int k = 0; k < 4; ++k)
+				{
+					V[k].Normal = FVector(-1, 0, 0);
+					V[k].Tangent = FVector(0, 0, 1);
+				}
 
-	const size_t RenderPoints = (NumPoints / Step);
-	const size_t RenderVertices = RenderPoints * 4;
-	const size_t RenderIndices = RenderPoints * 6;
-	const size_t MaxBufferIndices = (MAX_BUFFER_U16 / 6) * 6;
-	const size_t NumSections = (RenderIndices / MaxBufferIndices) + (RenderIndices % MaxBufferIndices ? 1 : 0);
+				int32* I = &Section->PclIndices[i * 6];
+				const int32 VertexId = i * 4;
+				I[0] = VertexId + 0;
+				I[1] = VertexId + 2;
+				I[2] = VertexId + 1;
+				I[3] = VertexId + 0;
+				I[4] = VertexId + 3;
+				I[5] = VertexId + 2;
+			}
+			PclMeshData.Add(SectionId, MoveTemp(Section));
+		}
+		PclRenderPoints = RenderPoints;
+		PclLayoutChanged = true;
+	}
 
-	#if 1
+	#if 0
 	REALSENSE_TRACE(TEXT(
-		"PCL Id=%zu NumPoints=%zu "
-		"RenderPoints=%zu RenderVertices=%zu RenderIndices=%zu NumSections=%zu "
-		"Density=%.3f Step=%zu"), 
-		PclFramesetId, NumPoints,
-		RenderPoints, RenderVertices, RenderIndices, NumSections,
-		PclDensity, Step
+		"PCL Id=%zu NumPoints=%zu RenderPoints=%zu NumSections=%zu Density=%.3f Step=%zu"),
+		FramesetId, NumPoints, RenderPoints, NumSections, PclDensity, Step
 	);
 	#endif
 
 	const rs2::vertex* SrcVertices = RsPoints->get_vertices();
 	const rs2::texture_coordinate* SrcTexcoords = RsPoints->get_texture_coordinates();
-
-	FPointCloudVertex PV[4];
 	const float Size = (PclVoxelSize * 0.5f);
-	size_t SectionId = 0;
-	size_t PointId = 0;
-	size_t VertexId = 0;
-	size_t IndexId = 0;
-	size_t NumInvalid = 0;
+	const float Scale = 100.0f * PclScale; // meters to mm
 
-	while (PointId < NumPoints && SectionId < NumSections)
+	NAMED_PROFILER("FillMeshBuffers");
+	size_t PointId = 0;
+	for (size_t SectionId = 0; SectionId < NumSections; ++SectionId)
 	{
-		if (!PclMeshData.Contains(SectionId))
-		{
-			NAMED_PROFILER("AllocMeshSection");
-			PclMeshData.Add(SectionId, MakeUnique<FMeshSection>());
-			PclMeshData[SectionId]->PclVertices.SetNumUninitialized(MAX_BUFFER_U16, false);
-			PclMeshData[SectionId]->PclIndices.SetNumUninitialized(MAX_BUFFER_U16, false);
-		}
-
-		if (!PclMesh->DoesSectionExist(SectionId))
-		{
-			NAMED_PROFILER("CreateMeshSection");
-			PclMesh->CreateMeshSection(SectionId, PclMeshData[SectionId]->PclVertices, PclMeshData[SectionId]->PclIndices, false, EUpdateFrequency::Frequent);
-			PclMesh->SetMaterial(SectionId, PclMaterial);
-		}
+		FMeshSection& Section = *PclMeshData[SectionId];
+		FPointCloudVertex* Dst = Section.PclVertices.GetData();
+		const int32 NumVertices = Section.PclVertices.Num();
+		Section.Bounds = FBox(ForceInit);
 
-		FPointCloudVertex* DstVertices = &(PclMeshData[SectionId]->PclVertices[0]);
-		int32* DstIndices = &(PclMeshData[SectionId]->PclIndices[0]);
-		VertexId = 0;
-		IndexId = 0;
-
-		{NAMED_PROFILER("FillMeshBuffers");
-		while (PointId < NumPoints && IndexId + 6 <= MaxBufferIndices)
+		for (int32 VertexId = 0; VertexId < NumVertices; VertexId += 4, PointId += Step, Dst += 4)
 		{
 			const auto V = SrcVertices[PointId];
 			if (!V.z)
 			{
-				PointId += Step;
-				NumInvalid++;
+				Dst[0].Position = Dst[1].Position = Dst[2].Position = Dst[3].Position = FVector::ZeroVector;
 				continue;
 			}
 
 			// the positive x-axis points to the right
 			// the positive y-axis points down
 			// the positive z-axis points forward
-			const FVector Pos = FVector(V.z, V.x, -V.y) * 100.0f * PclScale; // meters to mm
-
-			PV[0].Position = FVector(Pos.X, Pos.Y - Size, Pos.Z - Size);
-			PV[1].Position = FVector(Pos.X, Pos.Y - Size, Pos.Z + Size);
-			PV[2].Position = FVector(Pos.X, Pos.Y + Size, Pos.Z + Size);
-			PV[3].Position = FVector(Pos.X, Pos.Y + Size, Pos.Z - Size);
-
-			PV[0].Normal = FVector(-1, 0, 0);
-			PV[1].Normal = FVector(-1, 0, 0);
-			PV[2].Normal = FVector(-1, 0, 0);
-			PV[3].Normal = FVector(-1, 0, 0);
+			const FVector Pos = FVector(V.z, V.x, -V.y) * Scale;
+			Section.Bounds += Pos;
 
-			PV[0].Tangent = FVector(0, 0, 1);
-			PV[1].Tangent = FVector(0, 0, 1);
-			PV[2].Tangent = FVector(0, 0, 1);
-			PV[3].Tangent = FVector(0, 0, 1);
+			Dst[0].Position = FVector(Pos.X, Pos.Y - Size, Pos.Z - Size);
+			Dst[1].Position = FVector(Pos.X, Pos.Y - Size, Pos.Z + Size);
+			Dst[2].Position = FVector(Pos.X, Pos.Y + Size, Pos.Z + Size);
+			Dst[3].Position = FVector(Pos.X, Pos.Y + Size, Pos.Z - Size);
 
 			const auto T = SrcTexcoords[PointId];
-			PV[0].UV0 = FVector2D(T.u, T.v);
-			PV[1].UV0 = FVector2D(T.u, T.v);
-			PV[2].UV0 = FVector2D(T.u, T.v);
-			PV[3].UV0 = FVector2D(T.u, T.v);
-
-			DstVertices[0] = PV[0];
-			DstVertices[1] = PV[1];
-			DstVertices[2] = PV[2];
-			DstVertices[3] = PV[3];
-
-			DstIndices[0] = VertexId + 0;
-			DstIndices[1] = VertexId + 2;
-			DstIndices[2] = VertexId + 1;
-			DstIndices[3] = VertexId + 0;
-			DstIndices[4] = VertexId + 3;
-			DstIndices[5] = VertexId + 2;
-
-			DstVertices += 4;
-			DstIndices += 6;
-			VertexId += 4;
-			IndexId += 6;
-			PointId += Step;
-		}}
-
-		if (IndexId > 0)
-		{
-			#if 0
-			REALSENSE_TRACE(TEXT("section id=%zu points=%zu vert=%zu ind=%zu total=%zu invalid=%zu"),
-				SectionId, VertexId / 4, VertexId, IndexId, PointId, NumInvalid);
-			#endif
+			Dst[0].UV0 = Dst[1].UV0 = Dst[2].UV0 = Dst[3].UV0 = FVector2D(T.u, T.v);
+		}
+		Section.Bounds = Section.Bounds.ExpandBy(Size);
+	}
+	PclNumSections = (int32)NumSections;
+}
 
-			NAMED_PROFILER("UpdateMeshSection");
-			PclMeshData[SectionId]->PclVertices.SetNumUninitialized(VertexId, false);
-			PclMeshData[SectionId]->PclIndices.SetNumUninitialized(IndexId, false);
-			PclMesh->UpdateMeshSection(SectionId, PclMeshData[SectionId]->PclVertices, PclMeshData[SectionId]->PclIndices); // TODO: SLOW AS HELL
-			PclMesh->SetMeshSectionVisible(SectionId, true);
+// Runs on the game thread under PointCloudMx, streams the vertices filled by the worker into the mesh sections
+void ARealSenseInspector::UpdatePointCloud()
+{
+	SCOPED_PROFILER;
 
-			SectionId++;
-		}
+	if (PclLayoutChanged)
+	{
+		NAMED_PROFILER("ClearMeshSections");
+		PclMesh->ClearAllMeshSections();
+		PclLayoutChanged = false;
 	}
 
-	const auto NumMeshSections = PclMesh->GetNumSections();
-	if (NumMeshSections > SectionId)
+	for (int32 SectionId = 0; SectionId < PclNumSections; ++SectionId)
 	{
-		for (size_t i = SectionId; i < NumMeshSections; ++i)
+		FMeshSection& Section = *PclMeshData[SectionId];
+		if (!PclMesh->DoesSectionExist(SectionId))
+		{
+			NAMED_PROFILER("CreateMeshSection");
+			PclMesh->CreateMeshSection(SectionId, Section.PclVertices, Section.PclIndices, Section.Bounds, false, EUpdateFrequency::Frequent);
+			PclMesh->SetMaterial(SectionId, PclMaterial);
+		}
+		else
 		{
-			//REALSENSE_TRACE(TEXT("hide id=%zu"), i);
-			PclMesh->SetMeshSectionVisible(i, false);
+			NAMED_PROFILER("UpdateMeshSection");
+			PclMesh->UpdateMeshSectionPrimaryBuffer(SectionId, Section.PclVertices, Section.Bounds);
 		}
+		PclMesh->SetMeshSectionVisible(SectionId, true);
 	}
 
-	//REALSENSE_TRACE(TEXT("total=%zu invalid=%zu"), PointId, NumInvalid);
-	PclMesh->SetVisibility(SectionId != 0);
+	PclMesh->SetVisibility(PclNumSections != 0);
 }
 
 void ARealSenseInspector::SetPointCloudMaterial(int SectionId, UMaterialInterface* Material)
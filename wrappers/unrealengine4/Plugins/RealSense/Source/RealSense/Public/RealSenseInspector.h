@@ -144,6 +144,7 @@ private:
 	void PollFrames();
 	void WaitFrames();
 	void ProcessFrameset(class rs2::frameset* Frameset);
+	void FillPointCloud();
 	void UpdatePointCloud();
 	void EnsureProfileSupported(class URealSenseDevice* Device, ERealSenseStreamType StreamType, ERealSenseFormatType Format, FRealSenseStreamMode Mode);
 
@@ -163,12 +164,16 @@ private:
 	{
 		TArray<FPointCloudVertex> PclVertices;
 		TArray<int32> PclIndices;
+		FBox Bounds;
 	};
 
 	TUniquePtr<class rs2::pointcloud> RsPointCloud;
 	TUniquePtr<class rs2::points> RsPoints;
 	TMap< int32, TUniquePtr<FMeshSection> > PclMeshData;
 	int PclFramesetId = 0;
+	size_t PclRenderPoints = 0;
+	int32 PclNumSections = 0;
+	bool PclLayoutChanged = false;
 	float PclRenderAccum = 0;
 	volatile int PclCalculateFlag = false;
 	volatile int PclReadyFlag = false;